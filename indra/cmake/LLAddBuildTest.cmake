@@ -275,6 +275,63 @@ FUNCTION(LL_ADD_INTEGRATION_TEST
 
 ENDFUNCTION(LL_ADD_INTEGRATION_TEST)
 
+#*****************************************************************************
+#   LL_ADD_BENCHMARK
+#*****************************************************************************
+FUNCTION(LL_ADD_BENCHMARK
+        benchname
+        library_dependencies
+        )
+  # Builds BENCHMARK_${benchname} from tests/${benchname}_benchmark.cpp and the
+  # harness in test/llbenchmark.cpp. Unlike integration tests, benchmarks are
+  # not run after building: timings from a busy build machine mean nothing.
+  # Build the run_benchmarks target to run them all and write their results
+  # to ${CMAKE_BINARY_DIR}/benchmarks/${benchname}.json.
+  add_executable(BENCHMARK_${benchname}
+          tests/${benchname}_benchmark.cpp
+          ${CMAKE_SOURCE_DIR}/test/llbenchmark.cpp
+          ${CMAKE_SOURCE_DIR}/test/llbenchmark.h
+          )
+  set_target_properties(BENCHMARK_${benchname}
+          PROPERTIES
+          RUNTIME_OUTPUT_DIRECTORY "${EXE_STAGING_DIR}"
+          )
+
+  # The following come from the INTEGRATION_TEST_xxxx target above.
+  if (WINDOWS)
+    set_target_properties(BENCHMARK_${benchname}
+            PROPERTIES
+            LINK_FLAGS "/debug /NODEFAULTLIB:LIBCMT /SUBSYSTEM:CONSOLE"
+            )
+  endif ()
+
+  if (DARWIN)
+    set_target_properties(BENCHMARK_${benchname}
+            PROPERTIES
+            XCODE_ATTRIBUTE_CODE_SIGN_IDENTITY "-")
+  endif ()
+
+  target_link_libraries(BENCHMARK_${benchname} ${library_dependencies})
+  target_include_directories(BENCHMARK_${benchname} PRIVATE ${LIBS_OPEN_DIR}/test )
+
+  SET_TEST_PATH(LD_LIBRARY_PATH)
+  LL_TEST_COMMAND(BENCHMARK_CMD "${LD_LIBRARY_PATH}"
+                  $<TARGET_FILE:BENCHMARK_${benchname}>
+                  --json=${CMAKE_BINARY_DIR}/benchmarks/${benchname}.json)
+
+  add_custom_target(RUN_BENCHMARK_${benchname}
+          COMMAND ${CMAKE_COMMAND} -E make_directory ${CMAKE_BINARY_DIR}/benchmarks
+          COMMAND ${BENCHMARK_CMD}
+          DEPENDS BENCHMARK_${benchname}
+          USES_TERMINAL
+          )
+
+  if (NOT TARGET run_benchmarks)
+    add_custom_target(run_benchmarks)
+  endif ()
+  add_dependencies(run_benchmarks RUN_BENCHMARK_${benchname})
+ENDFUNCTION(LL_ADD_BENCHMARK)
+
 #*****************************************************************************
 #   SET_TEST_PATH
 #*****************************************************************************
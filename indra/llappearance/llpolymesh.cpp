@@ -764,6 +764,11 @@ LLPolyMesh::LLPolyMesh(LLPolyMeshSharedData *shared_data, LLPolyMesh *reference_
     mFaceVertexCount = 0;
     mFaceVertexOffset = 0;
 
+    mVertexSerial = 0;
+    mDirtySerial = 0;
+    mDirtyFirst = 0;
+    mDirtyLast = 0;
+
     if (shared_data->isLOD() && reference_mesh)
     {
         mCoords = reference_mesh->mCoords;
@@ -987,6 +992,52 @@ void LLPolyMesh::initializeForMorph()
     {
         mClothingWeights[i].clear();
     }
+
+    if (mSharedData->mNumVertices > 0)
+    {
+        dirtyVertices(0, mSharedData->mNumVertices - 1);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// dirtyVertices()
+//-----------------------------------------------------------------------------
+void LLPolyMesh::dirtyVertices(U32 first, U32 last)
+{
+    llassert(first <= last);
+    if (mDirtySerial == mVertexSerial)
+    {
+        mDirtyFirst = first;
+        mDirtyLast = last;
+    }
+    else
+    {
+        mDirtyFirst = llmin(mDirtyFirst, first);
+        mDirtyLast = llmax(mDirtyLast, last);
+    }
+    ++mVertexSerial;
+}
+
+//-----------------------------------------------------------------------------
+// getDirtyVertices()
+//-----------------------------------------------------------------------------
+bool LLPolyMesh::getDirtyVertices(U32 serial, U32& first, U32& last) const
+{
+    if (serial == mVertexSerial || serial < mDirtySerial)
+    {
+        return false;
+    }
+    first = mDirtyFirst;
+    last = mDirtyLast;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// clearDirtyVertices()
+//-----------------------------------------------------------------------------
+void LLPolyMesh::clearDirtyVertices()
+{
+    mDirtySerial = mVertexSerial;
 }
 
 //-----------------------------------------------------------------------------
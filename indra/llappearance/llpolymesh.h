@@ -318,6 +318,16 @@ public:
 
     bool    isLOD() { return mSharedData && mSharedData->isLOD(); }
 
+    // Vertex change tracking, so uploads can skip vertices no morph touched.
+    // LOD meshes share the vertex data of their reference mesh, so these
+    // should be called on getReferenceMesh().
+    void    dirtyVertices(U32 first, U32 last);
+    U32     getVertexSerial() const { return mVertexSerial; }
+    // Returns false if nothing changed after serial, or if the dirty range
+    // doesn't cover every change made after it.
+    bool    getDirtyVertices(U32 serial, U32& first, U32& last) const;
+    void    clearDirtyVertices();
+
     void setAvatar(LLAvatarAppearance* avatarp) { mAvatarp = avatarp; }
     LLAvatarAppearance* getAvatar() { return mAvatarp; }
 
@@ -356,6 +366,13 @@ protected:
 
     LLPolyMesh              *mReferenceMesh;
 
+    // bumped on every vertex change; the dirty range covers all changes
+    // made after mDirtySerial
+    U32                     mVertexSerial;
+    U32                     mDirtySerial;
+    U32                     mDirtyFirst;
+    U32                     mDirtyLast;
+
     // global mesh list
     typedef std::map<std::string, LLPolyMeshSharedData*> LLPolyMeshSharedDataTable;
     static LLPolyMeshSharedDataTable sGlobalSharedMeshList;
@@ -583,9 +583,14 @@ void LLPolyMorphTarget::apply( ESex avatar_sex )
 
         F32 *maskWeightArray = (mVertMask) ? mVertMask->getMorphMaskWeights() : NULL;
 
+        U32 first_vert = U32_MAX;
+        U32 last_vert = 0;
+
         for(U32 vert_index_morph = 0; vert_index_morph < mMorphData->mNumIndices; vert_index_morph++)
         {
             S32 vert_index_mesh = mMorphData->mVertexIndices[vert_index_morph];
+            first_vert = llmin(first_vert, (U32)vert_index_mesh);
+            last_vert = llmax(last_vert, (U32)vert_index_mesh);
 
             F32 maskWeight = 1.f;
             if (maskWeightArray)
@@ -640,6 +645,11 @@ void LLPolyMorphTarget::apply( ESex avatar_sex )
             tex_coords[vert_index_mesh] += mMorphData->mTexCoords[vert_index_morph] * delta_weight * maskWeight;
         }
 
+        if (first_vert <= last_vert)
+        {
+            mMesh->dirtyVertices(first_vert, last_vert);
+        }
+
         // now apply volume changes
         for(LLPolyVolumeMorph& volume_morph : mVolumeMorphs)
         {
@@ -689,10 +699,15 @@ void    LLPolyMorphTarget::applyMask(const U8 *maskTextureData, S32 width, S32 h
             clothing_mask.setElement<2>();
 
 
+            U32 first_vert = U32_MAX;
+            U32 last_vert = 0;
+
             for(U32 vert = 0; vert < mMorphData->mNumIndices; vert++)
             {
                 F32 lastMaskWeight = mLastWeight * maskWeights[vert];
                 S32 out_vert = mMorphData->mVertexIndices[vert];
+                first_vert = llmin(first_vert, (U32)out_vert);
+                last_vert = llmax(last_vert, (U32)out_vert);
 
                 // remove effect of existing masked morph
                 LLVector4a t;
@@ -720,6 +735,11 @@ void    LLPolyMorphTarget::applyMask(const U8 *maskTextureData, S32 width, S32 h
                     clothing_weight->setSelectWithMask(clothing_mask, t, *clothing_weight);
                 }
             }
+
+            if (first_vert <= last_vert)
+            {
+                mMesh->dirtyVertices(first_vert, last_vert);
+            }
         }
     }
 
@@ -29,6 +29,7 @@
 #include "lltexlayerparams.h"
 
 #include "llavatarappearance.h"
+#include "llglslshader.h"
 #include "llimagetga.h"
 #include "llquantize.h"
 #include "lltexlayer.h"
@@ -126,7 +127,8 @@ LLTexLayerParamAlpha::LLTexLayerParamAlpha(LLTexLayerInterface* layer)
     mNeedsCreateTexture(false),
     mStaticImageInvalid(false),
     mAvgDistortionVec(1.f, 1.f, 1.f),
-    mCachedEffectiveWeight(0.f)
+    mCachedEffectiveWeight(0.f),
+    mCachedWeightApplied(false)
 {
     sInstances.push_front(this);
 }
@@ -139,7 +141,8 @@ LLTexLayerParamAlpha::LLTexLayerParamAlpha(LLAvatarAppearance* appearance)
     mNeedsCreateTexture(false),
     mStaticImageInvalid(false),
     mAvgDistortionVec(1.f, 1.f, 1.f),
-    mCachedEffectiveWeight(0.f)
+    mCachedEffectiveWeight(0.f),
+    mCachedWeightApplied(false)
 {
     sInstances.push_front(this);
 }
@@ -152,7 +155,8 @@ LLTexLayerParamAlpha::LLTexLayerParamAlpha(const LLTexLayerParamAlpha& pOther)
     mNeedsCreateTexture(pOther.mNeedsCreateTexture.load()),
     mStaticImageInvalid(pOther.mStaticImageInvalid),
     mAvgDistortionVec(pOther.mAvgDistortionVec),
-    mCachedEffectiveWeight(pOther.mCachedEffectiveWeight)
+    mCachedEffectiveWeight(pOther.mCachedEffectiveWeight),
+    mCachedWeightApplied(pOther.mCachedWeightApplied)
 {
     sInstances.push_front(this);
 }
@@ -322,12 +326,17 @@ bool LLTexLayerParamAlpha::render(S32 x, S32 y, S32 width, S32 height)
             }
         }
 
+        // With the ramp shader the mask is uploaded once as is and the domain and
+        // weight are applied while drawing, so weight changes don't touch the texture.
+        const bool use_ramp_shader = gAlphaRampProgram.isComplete();
+
         const S32 image_tga_width = mStaticImageTGA->getWidth();
         const S32 image_tga_height = mStaticImageTGA->getHeight();
         if (!mCachedProcessedTexture ||
             (mCachedProcessedTexture->getWidth() != image_tga_width) ||
             (mCachedProcessedTexture->getHeight() != image_tga_height) ||
-            (weight_changed))
+            (use_ramp_shader == mCachedWeightApplied) ||
+            (weight_changed && !use_ramp_shader))
         {
             mCachedEffectiveWeight = effective_weight;
 
@@ -342,10 +351,18 @@ bool LLTexLayerParamAlpha::render(S32 x, S32 y, S32 width, S32 height)
                 mCachedProcessedTexture->setExplicitFormat(GL_ALPHA8, GL_ALPHA);
             }
 
-            // Applies domain and effective weight to data as it is decoded. Also resizes the raw image if needed.
             mStaticImageRaw = NULL;
             mStaticImageRaw = new LLImageRaw;
-            mStaticImageTGA->decodeAndProcess(mStaticImageRaw, info->mDomain, effective_weight);
+            if (use_ramp_shader)
+            {
+                mStaticImageTGA->decode(mStaticImageRaw, 0.f);
+            }
+            else
+            {
+                // Applies domain and effective weight to data as it is decoded. Also resizes the raw image if needed.
+                mStaticImageTGA->decodeAndProcess(mStaticImageRaw, info->mDomain, effective_weight);
+            }
+            mCachedWeightApplied = !use_ramp_shader;
             mNeedsCreateTexture = true;
             LL_DEBUGS() << "Built Cached Alpha: " << info->mStaticImageFileName << ": (" << mStaticImageRaw->getWidth() << ", " << mStaticImageRaw->getHeight() << ") " << "Domain: " << info->mDomain << " Weight: " << effective_weight << LL_ENDL;
         }
@@ -362,10 +379,43 @@ bool LLTexLayerParamAlpha::render(S32 x, S32 y, S32 width, S32 height)
                     mCachedProcessedTexture->setAddressMode(LLTexUnit::TAM_CLAMP);
                 }
 
+                LLGLSLShader* prev_shader = LLGLSLShader::sCurBoundShaderPtr;
+                if (use_ramp_shader)
+                {
+                    // Same ramp as LLImageTGA::decodeAndProcess()
+                    static LLStaticHashedString sAlphaRamp("alpha_ramp");
+                    gGL.flush();
+                    gAlphaRampProgram.bind();
+                    if (info->mDomain > 0.f)
+                    {
+                        F32 scale = 1.f / info->mDomain;
+                        F32 offset = (1.f - info->mDomain) * llclampf(1.f - effective_weight);
+                        gAlphaRampProgram.uniform3f(sAlphaRamp, scale, -(scale * offset), 0.f);
+                    }
+                    else
+                    {
+                        const U8 threshold = (U8)(0xFF * llclampf(1.f - effective_weight));
+                        gAlphaRampProgram.uniform3f(sAlphaRamp, 0.f, 0.f, ((F32)threshold - 0.5f) / 255.f);
+                    }
+                }
+
                 gGL.getTexUnit(0)->bind(mCachedProcessedTexture);
                 gl_rect_2d_simple_tex(width, height);
                 gGL.getTexUnit(0)->unbind(LLTexUnit::TT_TEXTURE);
                 stop_glerror();
+
+                if (use_ramp_shader)
+                {
+                    gGL.flush();
+                    if (prev_shader)
+                    {
+                        prev_shader->bind();
+                    }
+                    else
+                    {
+                        gAlphaRampProgram.unbind();
+                    }
+                }
             }
         }
 
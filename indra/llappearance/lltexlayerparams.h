@@ -115,6 +115,7 @@ private:
     bool                    mStaticImageInvalid;
     LL_ALIGN_16(LLVector4a              mAvgDistortionVec);
     F32                     mCachedEffectiveWeight;
+    bool                    mCachedWeightApplied;   // mCachedProcessedTexture already has the weight baked in
 
 public:
     // Global list of instances for gathering statistics
@@ -80,6 +80,8 @@ public:
     bool isValid() const                { return mValid; }
     bool isDone() const                 { return mDone; }
     const LLUUID &getUUID() const       { return mUUID; }
+    // The decoded WAV image, once the file write has finished
+    std::vector<U8>& getWAVBuffer()     { return mWAVBuffer; }
 
 protected:
     virtual ~LLVorbisDecodeState();
@@ -767,6 +769,8 @@ bool tryFinishAudio(const LLUUID &decode_id, LLPointer<LLVorbisDecodeState> deco
     if (valid)
     {
         adp->setHasWAVLoadFailed(false);
+        // The image is still in memory, keep it so the first play doesn't read it back
+        gAudiop->cacheDecodedWAV(decode_id, std::move(decode_state->getWAVBuffer()));
     }
 
     return true;
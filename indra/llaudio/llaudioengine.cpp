@@ -39,6 +39,11 @@
 #include "lldir.h"
 #include "llaudiodecodemgr.h"
 #include "llassetstorage.h"
+#include "llfile.h"
+#include "llmemtag.h"
+
+#include <algorithm>
+#include <iterator>
 
 
 // necessary for grabbing sounds from sim (implemented in viewer)
@@ -102,9 +107,13 @@ void LLAudioEngine::setDefaults()
     // the if statement in setMasterGain to execute when the viewer starts up.
     mInternalGain = -1.f;
     mNextWindUpdate = 0.f;
+    mVoiceCutoff = -1.f;
 
     mStreamingAudioImpl = NULL;
 
+    mDecodedWAVBytes = 0;
+    mDecodedCacheSize = 0;
+
     for (U32 i = 0; i < LLAudioEngine::AUDIO_TYPE_COUNT; i++)
         mSecondaryGain[i] = 1.0f;
 }
@@ -163,6 +172,9 @@ void LLAudioEngine::shutdown()
         delete mBuffers[i];
         mBuffers[i] = NULL;
     }
+
+    mDecodedCacheSize = 0;
+    trimDecodedCache();
 }
 
 
@@ -222,6 +234,51 @@ std::string LLAudioEngine::getInternetStreamURL()
 }
 
 
+void LLAudioEngine::rankVoices()
+{
+    // Sources with forced priority (previews, UI) are always heard and take channels first
+    mVoiceRank.clear();
+    size_t voices = LL_MAX_AUDIO_CHANNELS;
+    for (source_map::value_type& src_pair : mAllSources)
+    {
+        LLAudioSource *sourcep = src_pair.second;
+        if (sourcep->isForcedPriority())
+        {
+            sourcep->setVirtual(false);
+            voices -= llmin(voices, (size_t)1);
+        }
+        else if (!sourcep->isMuted())
+        {
+            mVoiceRank.push_back(sourcep);
+        }
+    }
+
+    if (mVoiceRank.size() <= voices)
+    {
+        mVoiceCutoff = -1.f;
+        for (LLAudioSource *sourcep : mVoiceRank)
+        {
+            sourcep->setVirtual(false);
+        }
+        return;
+    }
+
+    // Only the order across the cutoff matters.  Ties go by ID, so a flood of identical
+    // sounds doesn't trade places from one frame to the next.
+    auto cutoff = mVoiceRank.begin() + voices;
+    std::nth_element(mVoiceRank.begin(), cutoff, mVoiceRank.end(),
+                     [](const LLAudioSource *a, const LLAudioSource *b)
+                     {
+                         return a->getPriority() > b->getPriority() ||
+                                (a->getPriority() == b->getPriority() && a->getID() < b->getID());
+                     });
+    mVoiceCutoff = voices ? (*(cutoff - 1))->getPriority() : F32_MAX;
+    for (auto it = mVoiceRank.begin(); it != mVoiceRank.end(); ++it)
+    {
+        (*it)->setVirtual(it >= cutoff);
+    }
+}
+
 void LLAudioEngine::updateChannels()
 {
     S32 i;
@@ -251,8 +308,6 @@ void LLAudioEngine::idle()
         }
     }
 
-    F32 max_priority = -1.f;
-    LLAudioSource *max_sourcep = NULL; // Maximum priority source without a channel
     source_map::iterator iter;
     for (iter = mAllSources.begin(); iter != mAllSources.end();)
     {
@@ -270,9 +325,20 @@ void LLAudioEngine::idle()
             continue;
         }
 
-        if (sourcep->isMuted())
+        // Move on to the next source
+        iter++;
+    }
+
+    // Decide which sources can be heard before handing out channels
+    rankVoices();
+
+    F32 max_priority = -1.f;
+    LLAudioSource *max_sourcep = NULL; // Maximum priority source without a channel
+    for (source_map::value_type& src_pair : mAllSources)
+    {
+        LLAudioSource *sourcep = src_pair.second;
+        if (sourcep->isMuted() || sourcep->isVirtual())
         {
-            ++iter;
             continue;
         }
 
@@ -285,9 +351,6 @@ void LLAudioEngine::idle()
                 max_sourcep = sourcep;
             }
         }
-
-        // Move on to the next source
-        iter++;
     }
 
     // Now, do priority-based organization of audio sources.
@@ -343,6 +406,10 @@ void LLAudioEngine::idle()
 
             // Reset the timer so the source doesn't die.
             sourcep->mAgeTimer.reset();
+            if (sourcep->isVirtual())
+            {
+                continue;
+            }
             // Make sure we have the buffer set up if we just decoded the data
             if (sourcep->mCurrentDatap)
             {
@@ -1300,6 +1367,7 @@ LLAudioSource::LLAudioSource(const LLUUID& id, const LLUUID& owner_id, const F32
     mQueueSounds(false),
     mPlayedOnce(false),
     mCorrupted(false),
+    mVirtual(false),
     mType(type),
     mChannelp(NULL),
     mCurrentDatap(NULL),
@@ -1412,6 +1480,16 @@ void LLAudioSource::setChannel(LLAudioChannel *channelp)
 }
 
 
+void LLAudioSource::setVirtual(bool is_virtual)
+{
+    if (mVirtual && !is_virtual && mCurrentDatap && gAudiop)
+    {
+        // Now loud enough to be heard, start the decode play() skipped
+        gAudiop->updateBufferForData(mCurrentDatap, mCurrentDatap->getID());
+    }
+    mVirtual = is_virtual;
+}
+
 void LLAudioSource::update()
 {
     if(mCorrupted)
@@ -1426,7 +1504,11 @@ void LLAudioSource::update()
         {
             // Hack - try and load the sound.  Will do this as a callback
             // on decode later.
-            if (adp->getBuffer())
+            if (isVirtual())
+            {
+                // not until it can be heard
+            }
+            else if (adp->getBuffer())
             {
                 play(adp->getID());
             }
@@ -1564,6 +1646,17 @@ bool LLAudioSource::play(const LLUUID &audio_uuid)
         return false;
     }
 
+    if (!isForcedPriority())
+    {
+        updatePriority();
+        mVirtual = getPriority() < gAudiop->getVoiceCutoff();
+        if (mVirtual)
+        {
+            // Too quiet to get a channel, rankVoices() loads it if that changes
+            return false;
+        }
+    }
+
     bool has_buffer = gAudiop->updateBufferForData(adp, audio_uuid);
     if (!has_buffer)
     {
@@ -1967,7 +2060,17 @@ bool LLAudioData::load()
     wav_path= gDirUtilp->getExpandedFilename(LL_PATH_FS_SOUND_CACHE,uuid_str) + ".dsf";
     // </FS:Ansariel>
 
-    mHasWAVLoadFailed = !mBufferp->loadWAV(wav_path);
+    LLAudioEngine::wav_data_ptr_t wav = gAudiop->getDecodedWAV(mID, wav_path);
+    if (wav && mBufferp->loadWAVData(wav->data(), wav->size()))
+    {
+        mHasWAVLoadFailed = false;
+    }
+    else
+    {
+        // Let loadWAV() deal with a bad file the way it always has
+        gAudiop->removeDecodedWAV(mID);
+        mHasWAVLoadFailed = !mBufferp->loadWAV(wav_path);
+    }
     if (mHasWAVLoadFailed)
     {
         // Hrm.  Right now, let's unset the buffer, since it's empty.
@@ -2002,6 +2105,88 @@ bool LLAudioData::load()
     return true;
 }
 
+static LLMemTag sDecodedAudioMemTag("Decoded audio");
+
+void LLAudioEngine::setDecodedCacheSize(size_t bytes)
+{
+    mDecodedCacheSize = bytes;
+    trimDecodedCache();
+}
+
+void LLAudioEngine::cacheDecodedWAV(const LLUUID &uuid, std::vector<U8>&& wav)
+{
+    if (mDecodedCacheSize)
+    {
+        insertDecodedWAV(uuid, std::move(wav));
+    }
+}
+
+LLAudioEngine::wav_data_ptr_t LLAudioEngine::getDecodedWAV(const LLUUID &uuid, const std::string& wav_path)
+{
+    auto found = mDecodedWAVIndex.find(uuid);
+    if (found != mDecodedWAVIndex.end())
+    {
+        mDecodedWAVs.splice(mDecodedWAVs.begin(), mDecodedWAVs, found->second);
+        return found->second->mData;
+    }
+
+    if (!mDecodedCacheSize)
+    {
+        return NULL;
+    }
+
+    // Decoded by an earlier session, or dropped from memory since
+    llifstream file(wav_path.c_str(), std::ios::in | std::ios::binary);
+    if (!file.is_open())
+    {
+        return NULL;
+    }
+    std::vector<U8> wav((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (wav.empty())
+    {
+        return NULL;
+    }
+    return insertDecodedWAV(uuid, std::move(wav));
+}
+
+void LLAudioEngine::removeDecodedWAV(const LLUUID &uuid)
+{
+    auto found = mDecodedWAVIndex.find(uuid);
+    if (found != mDecodedWAVIndex.end())
+    {
+        size_t size = found->second->mData->size();
+        mDecodedWAVBytes -= size;
+        sDecodedAudioMemTag.disclaim(size);
+        mDecodedWAVs.erase(found->second);
+        mDecodedWAVIndex.erase(found);
+    }
+}
+
+LLAudioEngine::wav_data_ptr_t LLAudioEngine::insertDecodedWAV(const LLUUID &uuid, std::vector<U8>&& wav)
+{
+    removeDecodedWAV(uuid);
+
+    wav_data_ptr_t data = std::make_shared<const std::vector<U8> >(std::move(wav));
+    // A sound bigger than the whole cache would only push everything else out
+    if (data->size() <= mDecodedCacheSize)
+    {
+        mDecodedWAVs.push_front({ uuid, data });
+        mDecodedWAVIndex[uuid] = mDecodedWAVs.begin();
+        mDecodedWAVBytes += data->size();
+        sDecodedAudioMemTag.claim(data->size());
+        trimDecodedCache();
+    }
+    return data;
+}
+
+void LLAudioEngine::trimDecodedCache()
+{
+    while (mDecodedWAVBytes > mDecodedCacheSize && !mDecodedWAVs.empty())
+    {
+        removeDecodedWAV(mDecodedWAVs.back().mID);
+    }
+}
+
 // <FS:ND> Protect against corrupted sounds
 
 const U32 ND_MAX_SOUNDRETRIES = 25;
@@ -2082,5 +2267,6 @@ void LLAudioEngine::removeAudioData(const LLUUID& audio_uuid)
 
         mAllData.erase(audio_uuid);
     }
+    removeDecodedWAV(audio_uuid);
 }
 // </FS:Ansariel>
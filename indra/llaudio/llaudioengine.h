@@ -31,6 +31,8 @@
 #include <list>
 #include <map>
 #include <array>
+#include <memory>
+#include <vector>
 
 #include "v3math.h"
 #include "v3dmath.h"
@@ -180,6 +182,21 @@ public:
     bool hasDecodedFile(const LLUUID &uuid);
     bool hasLocalFile(const LLUUID &uuid);
 
+    // Lowest priority among the sources that can be heard as of the last idle(), -1 while
+    // there are fewer sources than channels.  A new source below it starts out virtual.
+    F32 getVoiceCutoff() const { return mVoiceCutoff; }
+
+    // Decoded sounds are kept in memory as complete WAV images, up to the given size with
+    // the least recently played dropped first, so a sound that plays again is loaded into
+    // its buffer without reading the sound cache.  0 keeps nothing in memory.
+    typedef std::shared_ptr<const std::vector<U8> > wav_data_ptr_t;
+    void setDecodedCacheSize(size_t bytes);
+    void cacheDecodedWAV(const LLUUID &uuid, std::vector<U8>&& wav);
+    // The decoded WAV image of uuid, read from wav_path if it isn't in memory yet.
+    // NULL when the cache is off or the file can't be read.
+    wav_data_ptr_t getDecodedWAV(const LLUUID &uuid, const std::string& wav_path);
+    void removeDecodedWAV(const LLUUID &uuid);
+
     bool updateBufferForData(LLAudioData *adp, const LLUUID &audio_uuid = LLUUID::null);
 
 
@@ -217,6 +234,7 @@ protected:
     virtual void setInternalGain(F32 gain) = 0;
 
     void commitDeferredChanges();
+    void rankVoices();
 
     virtual void allocateListener() = 0;
 
@@ -256,6 +274,10 @@ protected:
 
     std::array<LLAudioChannel*, LL_MAX_AUDIO_CHANNELS> mChannels;
 
+    // Sources competing for channels, ranked by rankVoices() every idle()
+    std::vector<LLAudioSource*> mVoiceRank;
+    F32 mVoiceCutoff;
+
     // Buffers needs to change into a different data structure, as the number of buffers
     // that we have active should be limited by RAM usage, not count.
     std::array<LLAudioBuffer*, LL_MAX_AUDIO_BUFFERS> mBuffers;
@@ -275,6 +297,21 @@ private:
     void setDefaults();
     LLStreamingAudioInterface *mStreamingAudioImpl;
 
+    struct DecodedWAV
+    {
+        LLUUID mID;
+        wav_data_ptr_t mData;
+    };
+    typedef std::list<DecodedWAV> decoded_wav_list_t;
+
+    wav_data_ptr_t insertDecodedWAV(const LLUUID &uuid, std::vector<U8>&& wav);
+    void trimDecodedCache();
+
+    decoded_wav_list_t mDecodedWAVs;    // most recently played first
+    std::map<LLUUID, decoded_wav_list_t::iterator> mDecodedWAVIndex;
+    size_t mDecodedWAVBytes;
+    size_t mDecodedCacheSize;
+
     // <FS:ND> Protect against corrupted sounds
 
     std::map<LLUUID,U32> mCorruptData;
@@ -346,6 +383,10 @@ public:
     // NaCl End
     bool isDone() const;
     bool isMuted() const { return mSourceMuted; }
+    // Virtual sources rank below the loudest LL_MAX_AUDIO_CHANNELS sources.  They keep
+    // aging as usual but aren't loaded, decoded or given a channel until they rank high
+    // enough again, so a flood of sounds costs the mixer nothing.
+    bool isVirtual() const { return mVirtual; }
 
     LLAudioData *getCurrentData();
     LLAudioData *getQueuedData();
@@ -367,6 +408,7 @@ public:
 protected:
     void setChannel(LLAudioChannel *channelp);
     LLAudioChannel *getChannel() const                      { return mChannelp; }
+    void setVirtual(bool is_virtual);
     // NaCl - Sound Explorer
     static void logSoundPlay(const LLUUID& id, LLVector3d position, S32 type, const LLUUID& assetid, const LLUUID& ownerid, const LLUUID& sourceid, bool is_trigger, bool is_looped);
     static void logSoundStop(const LLUUID& id);
@@ -387,6 +429,7 @@ protected:
     bool            mQueueSounds;
     bool            mPlayedOnce;
     bool            mCorrupted;
+    bool            mVirtual;
     S32             mType;
     LLVector3d      mPositionGlobal;
     LLVector3       mVelocity;
@@ -505,6 +548,8 @@ class LLAudioBuffer
 public:
     virtual ~LLAudioBuffer() {};
     virtual bool loadWAV(const std::string& filename) = 0;
+    // Same as loadWAV(), from a WAV image in memory
+    virtual bool loadWAVData(const U8* data, size_t size) = 0;
     virtual U32 getLength() = 0;
 
     friend class LLAudioEngine;
@@ -848,6 +848,38 @@ bool LLAudioBufferFMODSTUDIO::loadWAV(const std::string& filename)
     return true;
 }
 
+bool LLAudioBufferFMODSTUDIO::loadWAVData(const U8* data, size_t size)
+{
+    if (!data || !size)
+    {
+        return false;
+    }
+
+    if (mSoundp)
+    {
+        // If there's already something loaded in this buffer, clean it up.
+        Check_FMOD_Error(mSoundp->release(), "FMOD::Sound::release");
+        mSoundp = NULL;
+    }
+
+    // FMOD_OPENMEMORY copies the samples, data only has to live through this call
+    FMOD_MODE base_mode = FMOD_LOOP_NORMAL | FMOD_OPENMEMORY;
+    FMOD_CREATESOUNDEXINFO exinfo;
+    memset(&exinfo, 0, sizeof(exinfo));
+    exinfo.cbsize = sizeof(exinfo);
+    exinfo.length = (unsigned int)size;
+    exinfo.suggestedsoundtype = FMOD_SOUND_TYPE_WAV;
+    FMOD_RESULT result = getSystem()->createSound((const char*)data, base_mode, &exinfo, &mSoundp);
+
+    if (result != FMOD_OK)
+    {
+        LL_WARNS() << "Could not load data from memory: " << FMOD_ErrorString(result) << LL_ENDL;
+        return false;
+    }
+
+    return true;
+}
+
 
 U32 LLAudioBufferFMODSTUDIO::getLength()
 {
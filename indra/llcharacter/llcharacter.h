@@ -32,6 +32,7 @@
 //-----------------------------------------------------------------------------
 #include <string>
 
+#include "llflatskeleton.h"
 #include "lljoint.h"
 #include "llmotioncontroller.h"
 #include "llvisualparam.h"
@@ -168,6 +169,9 @@ public:
 
     LLMotionController& getMotionController() { return mMotionController; }
 
+    // flattened view of the joint hierarchy, if attached to the root joint
+    LLFlatSkeleton& getFlatSkeleton() { return mFlatSkeleton; }
+
     // Releases all motion instances which should result in
     // no cached references to character joint data.  This is
     // useful if a character wants to rebuild it's skeleton.
@@ -296,6 +300,7 @@ public:
 
 protected:
     LLMotionController  mMotionController;
+    LLFlatSkeleton      mFlatSkeleton;
 
     typedef std::map<std::string, void *> animation_data_map_t;
     animation_data_map_t mAnimationData;
@@ -0,0 +1,211 @@
+/**
+ * @file llflatskeleton.cpp
+ * @brief LLFlatSkeleton class implementation
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llflatskeleton.h"
+
+#include "lljoint.h"
+
+// rotation and translation only, as LLMatrix4::initAll with unit scale
+static void set_rigid(LLMatrix4a& mat, const LLQuaternion& q, const LLVector3& pos)
+{
+    F32 xx = q.mQ[VX] * q.mQ[VX];
+    F32 xy = q.mQ[VX] * q.mQ[VY];
+    F32 xz = q.mQ[VX] * q.mQ[VZ];
+    F32 xw = q.mQ[VX] * q.mQ[VW];
+    F32 yy = q.mQ[VY] * q.mQ[VY];
+    F32 yz = q.mQ[VY] * q.mQ[VZ];
+    F32 yw = q.mQ[VY] * q.mQ[VW];
+    F32 zz = q.mQ[VZ] * q.mQ[VZ];
+    F32 zw = q.mQ[VZ] * q.mQ[VW];
+
+    mat.mMatrix[0].set(1.f - 2.f * (yy + zz), 2.f * (xy + zw), 2.f * (xz - yw), 0.f);
+    mat.mMatrix[1].set(2.f * (xy - zw), 1.f - 2.f * (xx + zz), 2.f * (yz + xw), 0.f);
+    mat.mMatrix[2].set(2.f * (xz + yw), 2.f * (yz - xw), 1.f - 2.f * (xx + yy), 0.f);
+    mat.mMatrix[3].set(pos.mV[VX], pos.mV[VY], pos.mV[VZ], 1.f);
+}
+
+LLFlatSkeleton::~LLFlatSkeleton()
+{
+    detach();
+}
+
+void LLFlatSkeleton::attach(LLJoint* root)
+{
+    if (root == mRoot)
+    {
+        return;
+    }
+
+    detach();
+
+    if (root)
+    {
+        if (root->mFlatSkeleton)
+        {
+            root->mFlatSkeleton->detach();
+        }
+        mRoot = root;
+        mRoot->mFlatSkeleton = this;
+        mNeedsRebuild = true;
+    }
+}
+
+void LLFlatSkeleton::detach()
+{
+    if (mRoot)
+    {
+        mRoot->mFlatSkeleton = nullptr;
+        mRoot = nullptr;
+    }
+
+    mJoints.clear();
+    mParents.clear();
+    mState.clear();
+    mLocal.clear();
+    mRigid.clear();
+    mWorld.clear();
+    mNeedsRebuild = true;
+}
+
+void LLFlatSkeleton::rebuild()
+{
+    mNeedsRebuild = false;
+    mJoints.clear();
+    mParents.clear();
+
+    // depth first, so every parent comes before its children
+    std::vector<std::pair<LLJoint*, S32> > stack;
+    stack.emplace_back(mRoot, -1);
+    while (!stack.empty())
+    {
+        LLJoint* joint = stack.back().first;
+        S32 parent = stack.back().second;
+        stack.pop_back();
+
+        S32 index = (S32)mJoints.size();
+        mJoints.push_back(joint);
+        mParents.push_back(parent);
+
+        for (auto iter = joint->mChildren.rbegin(); iter != joint->mChildren.rend(); ++iter)
+        {
+            if (*iter)
+            {
+                stack.emplace_back(*iter, index);
+            }
+        }
+    }
+
+    mState.resize(mJoints.size());
+    mLocal.resize(mJoints.size());
+    mRigid.resize(mJoints.size());
+    mWorld.resize(mJoints.size());
+}
+
+void LLFlatSkeleton::update()
+{
+    if (!mRoot)
+    {
+        return;
+    }
+
+    if (mNeedsRebuild)
+    {
+        rebuild();
+    }
+
+    const S32 count = (S32)mJoints.size();
+    for (S32 i = 0; i < count; ++i)
+    {
+        LLJoint* joint = mJoints[i];
+        S32 parent = mParents[i];
+
+        if (!joint->mUpdateXform || (parent >= 0 && mState[parent] == STATE_SKIPPED))
+        {
+            mState[i] = STATE_SKIPPED;
+            mWorld[i] = joint->mWorldMatrix;
+            continue;
+        }
+
+        if (!(joint->mDirtyFlags & LLJoint::MATRIX_DIRTY))
+        {
+            mState[i] = STATE_CLEAN;
+            mWorld[i] = joint->mWorldMatrix;
+            continue;
+        }
+
+        LLJoint::sNumUpdates++;
+
+        LLXformMatrix& xform = joint->mXform;
+        LLVector3 world_pos;
+        LLQuaternion world_rot;
+
+        if (parent < 0)
+        { // the root may hang off a transform that isn't a joint
+            xform.update();
+            world_pos = xform.getWorldPosition();
+            world_rot = xform.getWorldRotation();
+            set_rigid(mRigid[i], world_rot, world_pos);
+        }
+        else
+        {
+            LLJoint* parent_joint = mJoints[parent];
+            LLXformMatrix& parent_xform = parent_joint->mXform;
+            if (mState[parent] == STATE_CLEAN)
+            { // parent was already up to date, take its transform from the joint
+                set_rigid(mRigid[parent], parent_xform.getWorldRotation(), parent_xform.getWorldPosition());
+                mState[parent] = STATE_UPDATED;
+            }
+
+            LLVector3 pos = xform.getPosition();
+            if (parent_xform.getScaleChildOffset())
+            {
+                pos.scaleVec(parent_xform.getScale());
+            }
+            set_rigid(mLocal[i], xform.getRotation(), pos);
+            matMulUnsafe(mLocal[i], mRigid[parent], mRigid[i]);
+
+            world_pos.set(mRigid[i].mMatrix[3].getF32ptr());
+            world_rot = xform.getRotation() * parent_xform.getWorldRotation();
+        }
+
+        const LLVector3& scale = xform.getScale();
+        LLMatrix4a& world = mWorld[i];
+        world.mMatrix[0] = mRigid[i].mMatrix[0];
+        world.mMatrix[0].mul(scale.mV[VX]);
+        world.mMatrix[1] = mRigid[i].mMatrix[1];
+        world.mMatrix[1].mul(scale.mV[VY]);
+        world.mMatrix[2] = mRigid[i].mMatrix[2];
+        world.mMatrix[2].mul(scale.mV[VZ]);
+        world.mMatrix[3] = mRigid[i].mMatrix[3];
+
+        xform.setWorldTransform(world_pos, world_rot, world.asMatrix4());
+        joint->mWorldMatrix = world;
+        joint->mDirtyFlags = 0x0;
+        mState[i] = STATE_UPDATED;
+    }
+}
@@ -0,0 +1,90 @@
+/**
+ * @file llflatskeleton.h
+ * @brief LLFlatSkeleton class declaration
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLFLATSKELETON_H
+#define LL_LLFLATSKELETON_H
+
+#include "llmath.h"
+#include "llmatrix4a.h"
+
+#include <vector>
+
+class LLJoint;
+
+// A joint hierarchy flattened into parent-first arrays. Once attached to a root
+// joint, LLJoint::updateWorldMatrixChildren() on that root becomes one linear
+// pass over the arrays instead of a recursive walk. Results are written back to
+// the joints, so the LLJoint accessors are unchanged, and are also available here
+// as contiguous world matrices indexed like getJoint().
+class LLFlatSkeleton
+{
+public:
+    LLFlatSkeleton() = default;
+    ~LLFlatSkeleton();
+
+    LLFlatSkeleton(const LLFlatSkeleton&) = delete;
+    LLFlatSkeleton& operator=(const LLFlatSkeleton&) = delete;
+
+    // route world matrix updates of the hierarchy under root through this skeleton
+    void attach(LLJoint* root);
+    void detach();
+    LLJoint* getRoot() const { return mRoot; }
+
+    // the hierarchy changed shape, flatten it again before the next update
+    void invalidate() { mNeedsRebuild = true; }
+
+    // recompute world matrices of joints with MATRIX_DIRTY set
+    void update();
+
+    S32 getNumJoints() const { return (S32)mJoints.size(); }
+    LLJoint* getJoint(S32 index) const { return mJoints[index]; }
+    // index of the parent of joint index, -1 for the root
+    S32 getParent(S32 index) const { return mParents[index]; }
+    // world matrices as of the last update(), same as LLJoint::getWorldMatrix4a()
+    const LLMatrix4a* getWorldMatrices() const { return mWorld.data(); }
+
+private:
+    enum EState : U8
+    {
+        STATE_CLEAN,    // joint was up to date, mRigid not filled in
+        STATE_UPDATED,  // mRigid and mWorld filled in this update
+        STATE_SKIPPED   // joint or an ancestor has mUpdateXform off
+    };
+
+    void rebuild();
+
+    LLJoint* mRoot = nullptr;
+    bool mNeedsRebuild = true;
+
+    std::vector<LLJoint*> mJoints;
+    std::vector<S32> mParents;
+    std::vector<U8> mState;
+    std::vector<LLMatrix4a> mLocal; // local rotation and translation
+    std::vector<LLMatrix4a> mRigid; // world rotation and translation, no scale
+    std::vector<LLMatrix4a> mWorld; // world matrix including the joint's own scale
+};
+
+#endif // LL_LLFLATSKELETON_H
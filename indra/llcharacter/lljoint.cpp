@@ -30,6 +30,7 @@
 #include "linden_common.h"
 
 #include "lljoint.h"
+#include "llflatskeleton.h"
 
 #include "llmath.h"
 #include <boost/algorithm/string.hpp>
@@ -52,7 +53,7 @@ JointKey JointKey::construct(const std::string& aName)
 }
 // </FS:ND>
 
-S32 LLJoint::sNumUpdates = 0;
+std::atomic<S32> LLJoint::sNumUpdates{ 0 };
 S32 LLJoint::sNumTouches = 0;
 
 template <class T>
@@ -122,6 +123,7 @@ void LLJoint::init()
 {
     mName = "unnamed";
     mParent = NULL;
+    mFlatSkeleton = NULL;
     mXform.setScaleChildOffset(true);
     mXform.setScale(LLVector3(1.0f, 1.0f, 1.0f));
     mDirtyFlags = MATRIX_DIRTY | ROTATION_DIRTY | POSITION_DIRTY;
@@ -168,6 +170,11 @@ LLJoint::LLJoint(const std::string &name, LLJoint *parent) :
 //-----------------------------------------------------------------------------
 LLJoint::~LLJoint()
 {
+    if (mFlatSkeleton)
+    {
+        mFlatSkeleton->detach();
+    }
+
     if (mParent)
     {
         mParent->removeChild( this );
@@ -293,6 +300,7 @@ void LLJoint::addChild(LLJoint* joint)
     joint->mXform.setParent(&mXform);
     joint->mParent = this;
     joint->touch();
+    invalidateFlatSkeleton();
 }
 
 
@@ -309,6 +317,7 @@ void LLJoint::removeChild(LLJoint* joint)
         joint->mXform.setParent(NULL);
         joint->mParent = NULL;
         joint->touch();
+        invalidateFlatSkeleton();
     }
 }
 
@@ -329,6 +338,19 @@ void LLJoint::removeAllChildren()
         }
     }
     mChildren.clear();
+    invalidateFlatSkeleton();
+}
+
+//--------------------------------------------------------------------
+// invalidateFlatSkeleton()
+//--------------------------------------------------------------------
+void LLJoint::invalidateFlatSkeleton()
+{
+    LLJoint* root = getRoot();
+    if (root->mFlatSkeleton)
+    {
+        root->mFlatSkeleton->invalidate();
+    }
 }
 
 
@@ -986,6 +1008,12 @@ void LLJoint::updateWorldMatrixChildren()
 {
     if (!this->mUpdateXform) return;
 
+    if (mFlatSkeleton)
+    {
+        mFlatSkeleton->update();
+        return;
+    }
+
     if (mDirtyFlags & MATRIX_DIRTY)
     {
         updateWorldMatrix();
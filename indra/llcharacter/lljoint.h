@@ -30,6 +30,7 @@
 //-----------------------------------------------------------------------------
 // Header Files
 //-----------------------------------------------------------------------------
+#include <atomic>
 #include <string>
 #include <list>
 
@@ -40,6 +41,8 @@
 #include "xform.h"
 #include "llmatrix4a.h"
 
+class LLFlatSkeleton;
+
 //<FS:ND> Query by JointKey rather than just a string, the key can be a U32 index for faster lookup
 struct JointKey
 {
@@ -153,6 +156,13 @@ protected:
     // parent joint
     LLJoint *mParent;
 
+    // set on the root joint of a hierarchy updated by an LLFlatSkeleton
+    LLFlatSkeleton* mFlatSkeleton;
+    friend class LLFlatSkeleton;
+
+    // tell the LLFlatSkeleton of this hierarchy (if any) that its shape changed
+    void invalidateFlatSkeleton();
+
     LLVector3       mDefaultPosition;
     LLVector3       mDefaultScale;
 
@@ -175,7 +185,7 @@ public:
 
     // debug statics
     static S32      sNumTouches;
-    static S32      sNumUpdates;
+    static std::atomic<S32> sNumUpdates; // updateWorldMatrix may run on worker threads
     typedef std::set<std::string> debug_joint_name_t;
     static debug_joint_name_t s_debugJointNames;
     static void setDebugJointNames(const debug_joint_name_t& names);
@@ -99,23 +99,23 @@ U32 LLKeyframeMotion::JointMotionList::dumpDiagInfo()
         if (joint_motion_p->mUsage & LLJointState::SCALE)
         {
             LL_INFOS() << "\t" << joint_motion_p->mScaleCurve.mNumKeys << " scale keys at "
-            << joint_motion_p->mScaleCurve.mNumKeys * sizeof(ScaleKey) << " bytes" << LL_ENDL;
+            << joint_motion_p->mScaleCurve.mNumKeys * (sizeof(F32) + sizeof(LLVector3)) << " bytes" << LL_ENDL;
 
-            total_size += joint_motion_p->mScaleCurve.mNumKeys * sizeof(ScaleKey);
+            total_size += joint_motion_p->mScaleCurve.mNumKeys * (sizeof(F32) + sizeof(LLVector3));
         }
         if (joint_motion_p->mUsage & LLJointState::ROT)
         {
             LL_INFOS() << "\t" << joint_motion_p->mRotationCurve.mNumKeys << " rotation keys at "
-            << joint_motion_p->mRotationCurve.mNumKeys * sizeof(RotationKey) << " bytes" << LL_ENDL;
+            << joint_motion_p->mRotationCurve.mNumKeys * (sizeof(F32) + sizeof(QuantizedKey)) << " bytes" << LL_ENDL;
 
-            total_size += joint_motion_p->mRotationCurve.mNumKeys * sizeof(RotationKey);
+            total_size += joint_motion_p->mRotationCurve.mNumKeys * (sizeof(F32) + sizeof(QuantizedKey));
         }
         if (joint_motion_p->mUsage & LLJointState::POS)
         {
             LL_INFOS() << "\t" << joint_motion_p->mPositionCurve.mNumKeys << " position keys at "
-            << joint_motion_p->mPositionCurve.mNumKeys * sizeof(PositionKey) << " bytes" << LL_ENDL;
+            << joint_motion_p->mPositionCurve.mNumKeys * (sizeof(F32) + sizeof(QuantizedKey)) << " bytes" << LL_ENDL;
 
-            total_size += joint_motion_p->mPositionCurve.mNumKeys * sizeof(PositionKey);
+            total_size += joint_motion_p->mPositionCurve.mNumKeys * (sizeof(F32) + sizeof(QuantizedKey));
         }
     }
     LL_INFOS() << "Size: " << total_size << " bytes" << LL_ENDL;
@@ -130,6 +130,61 @@ U32 LLKeyframeMotion::JointMotionList::dumpDiagInfo()
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+// find_key()
+// Returns the index of the first key at or after time. Playback normally only
+// moves forward by a key or two per frame, so start from the cursor left by
+// the previous evaluation and fall back to a binary search.
+//-----------------------------------------------------------------------------
+static U32 find_key(const std::vector<F32>& times, F32 time, U32& cursor)
+{
+    const U32 count = static_cast<U32>(times.size());
+    U32 right = llmin(cursor, count);
+
+    if (right < count && times[right] < time)
+    {
+        const U32 max_steps = 4;
+        U32 steps = 0;
+        while (right < count && times[right] < time && steps++ < max_steps)
+        {
+            ++right;
+        }
+        if (right < count && times[right] < time)
+        {
+            right = static_cast<U32>(std::lower_bound(times.begin() + right, times.end(), time) - times.begin());
+        }
+    }
+    else if (right > 0 && times[right - 1] >= time)
+    {
+        // looped or restarted
+        right = static_cast<U32>(std::lower_bound(times.begin(), times.begin() + right, time) - times.begin());
+    }
+
+    cursor = right;
+    return right;
+}
+
+//-----------------------------------------------------------------------------
+// sort_keys()
+// Orders keys by time, keeping only the last of any keys that share a time.
+//-----------------------------------------------------------------------------
+static void sort_keys(std::vector<LLKeyframeMotion::QuantizedKey>& keys)
+{
+    std::stable_sort(keys.begin(), keys.end(),
+        [](const LLKeyframeMotion::QuantizedKey& a, const LLKeyframeMotion::QuantizedKey& b) { return a.mTime < b.mTime; });
+
+    size_t unique = 0;
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        if (i + 1 < keys.size() && keys[i + 1].mTime == keys[i].mTime)
+        {
+            continue;
+        }
+        keys[unique++] = keys[i];
+    }
+    keys.resize(unique);
+}
+
 //-----------------------------------------------------------------------------
 // ScaleCurve::ScaleCurve()
 //-----------------------------------------------------------------------------
@@ -144,51 +199,41 @@ LLKeyframeMotion::ScaleCurve::ScaleCurve()
 //-----------------------------------------------------------------------------
 LLKeyframeMotion::ScaleCurve::~ScaleCurve()
 {
-    mKeys.clear();
+    mKeyTimes.clear();
+    mKeyScales.clear();
     mNumKeys = 0;
 }
 
 //-----------------------------------------------------------------------------
 // getValue()
 //-----------------------------------------------------------------------------
-LLVector3 LLKeyframeMotion::ScaleCurve::getValue(F32 time, F32 duration)
+LLVector3 LLKeyframeMotion::ScaleCurve::getValue(F32 time, F32 duration, U32& cursor) const
 {
     LLVector3 value;
 
-    if (mKeys.empty())
+    if (mKeyTimes.empty())
     {
         value.clearVec();
         return value;
     }
 
-    key_map_t::iterator right = mKeys.lower_bound(time);
-    if (right == mKeys.end())
+    U32 right = find_key(mKeyTimes, time, cursor);
+    if (right == mKeyTimes.size())
     {
         // Past last key
-        --right;
-        value = right->second.mScale;
+        value = mKeyScales[right - 1];
     }
-    else if (right == mKeys.begin() || right->first == time)
+    else if (right == 0 || mKeyTimes[right] == time)
     {
         // Before first key or exactly on a key
-        value = right->second.mScale;
+        value = mKeyScales[right];
     }
     else
     {
         // Between two keys
-        key_map_t::iterator left = right; --left;
-        F32 index_before = left->first;
-        F32 index_after = right->first;
-        ScaleKey& scale_before = left->second;
-        ScaleKey& scale_after = right->second;
-        if (right == mKeys.end())
-        {
-            scale_after = mLoopInKey;
-            index_after = duration;
-        }
-
-        F32 u = (time - index_before) / (index_after - index_before);
-        value = interp(u, scale_before, scale_after);
+        U32 left = right - 1;
+        F32 u = (time - mKeyTimes[left]) / (mKeyTimes[right] - mKeyTimes[left]);
+        value = interp(u, mKeyScales[left], mKeyScales[right]);
     }
     return value;
 }
@@ -196,17 +241,17 @@ LLVector3 LLKeyframeMotion::ScaleCurve::getValue(F32 time, F32 duration)
 //-----------------------------------------------------------------------------
 // interp()
 //-----------------------------------------------------------------------------
-LLVector3 LLKeyframeMotion::ScaleCurve::interp(F32 u, ScaleKey& before, ScaleKey& after)
+LLVector3 LLKeyframeMotion::ScaleCurve::interp(F32 u, const LLVector3& before, const LLVector3& after) const
 {
     switch (mInterpolationType)
     {
     case IT_STEP:
-        return before.mScale;
+        return before;
 
     default:
     case IT_LINEAR:
     case IT_SPLINE:
-        return lerp(before.mScale, after.mScale, u);
+        return lerp(before, after, u);
     }
 }
 
@@ -224,51 +269,70 @@ LLKeyframeMotion::RotationCurve::RotationCurve()
 //-----------------------------------------------------------------------------
 LLKeyframeMotion::RotationCurve::~RotationCurve()
 {
-    mKeys.clear();
+    mKeyTimes.clear();
+    mKeyRotations.clear();
     mNumKeys = 0;
 }
 
+//-----------------------------------------------------------------------------
+// RotationCurve::getKeyRotation()
+//-----------------------------------------------------------------------------
+LLQuaternion LLKeyframeMotion::RotationCurve::getKeyRotation(U32 index) const
+{
+    const QuantizedKey& key = mKeyRotations[index];
+    LLVector3 rot_vec(U16_to_F32(key.mValue[VX], -1.f, 1.f),
+                      U16_to_F32(key.mValue[VY], -1.f, 1.f),
+                      U16_to_F32(key.mValue[VZ], -1.f, 1.f));
+    LLQuaternion rot;
+    rot.unpackFromVector3(rot_vec);
+    return rot;
+}
+
+//-----------------------------------------------------------------------------
+// RotationCurve::setKeys()
+//-----------------------------------------------------------------------------
+void LLKeyframeMotion::RotationCurve::setKeys(std::vector<QuantizedKey>& keys)
+{
+    sort_keys(keys);
+
+    mKeyTimes.resize(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        mKeyTimes[i] = keys[i].mTime;
+    }
+    mKeyRotations.swap(keys);
+}
+
 //-----------------------------------------------------------------------------
 // RotationCurve::getValue()
 //-----------------------------------------------------------------------------
-LLQuaternion LLKeyframeMotion::RotationCurve::getValue(F32 time, F32 duration)
+LLQuaternion LLKeyframeMotion::RotationCurve::getValue(F32 time, F32 duration, U32& cursor) const
 {
     LLQuaternion value;
 
-    if (mKeys.empty())
+    if (mKeyTimes.empty())
     {
         value = LLQuaternion::DEFAULT;
         return value;
     }
 
-    key_map_t::iterator right = mKeys.lower_bound(time);
-    if (right == mKeys.end())
+    U32 right = find_key(mKeyTimes, time, cursor);
+    if (right == mKeyTimes.size())
     {
         // Past last key
-        --right;
-        value = right->second.mRotation;
+        value = getKeyRotation(right - 1);
     }
-    else if (right == mKeys.begin() || right->first == time)
+    else if (right == 0 || mKeyTimes[right] == time)
     {
         // Before first key or exactly on a key
-        value = right->second.mRotation;
+        value = getKeyRotation(right);
     }
     else
     {
         // Between two keys
-        key_map_t::iterator left = right; --left;
-        F32 index_before = left->first;
-        F32 index_after = right->first;
-        RotationKey& rot_before = left->second;
-        RotationKey& rot_after = right->second;
-        if (right == mKeys.end())
-        {
-            rot_after = mLoopInKey;
-            index_after = duration;
-        }
-
-        F32 u = (time - index_before) / (index_after - index_before);
-        value = interp(u, rot_before, rot_after);
+        U32 left = right - 1;
+        F32 u = (time - mKeyTimes[left]) / (mKeyTimes[right] - mKeyTimes[left]);
+        value = interp(u, getKeyRotation(left), getKeyRotation(right));
     }
     return value;
 }
@@ -276,17 +340,17 @@ LLQuaternion LLKeyframeMotion::RotationCurve::getValue(F32 time, F32 duration)
 //-----------------------------------------------------------------------------
 // interp()
 //-----------------------------------------------------------------------------
-LLQuaternion LLKeyframeMotion::RotationCurve::interp(F32 u, RotationKey& before, RotationKey& after)
+LLQuaternion LLKeyframeMotion::RotationCurve::interp(F32 u, const LLQuaternion& before, const LLQuaternion& after) const
 {
     switch (mInterpolationType)
     {
     case IT_STEP:
-        return before.mRotation;
+        return before;
 
     default:
     case IT_LINEAR:
     case IT_SPLINE:
-        return nlerp(u, before.mRotation, after.mRotation);
+        return nlerp(u, before, after);
     }
 }
 
@@ -305,51 +369,67 @@ LLKeyframeMotion::PositionCurve::PositionCurve()
 //-----------------------------------------------------------------------------
 LLKeyframeMotion::PositionCurve::~PositionCurve()
 {
-    mKeys.clear();
+    mKeyTimes.clear();
+    mKeyPositions.clear();
     mNumKeys = 0;
 }
 
+//-----------------------------------------------------------------------------
+// PositionCurve::getKeyPosition()
+//-----------------------------------------------------------------------------
+LLVector3 LLKeyframeMotion::PositionCurve::getKeyPosition(U32 index) const
+{
+    const QuantizedKey& key = mKeyPositions[index];
+    return LLVector3(U16_to_F32(key.mValue[VX], -LL_MAX_PELVIS_OFFSET, LL_MAX_PELVIS_OFFSET),
+                     U16_to_F32(key.mValue[VY], -LL_MAX_PELVIS_OFFSET, LL_MAX_PELVIS_OFFSET),
+                     U16_to_F32(key.mValue[VZ], -LL_MAX_PELVIS_OFFSET, LL_MAX_PELVIS_OFFSET));
+}
+
+//-----------------------------------------------------------------------------
+// PositionCurve::setKeys()
+//-----------------------------------------------------------------------------
+void LLKeyframeMotion::PositionCurve::setKeys(std::vector<QuantizedKey>& keys)
+{
+    sort_keys(keys);
+
+    mKeyTimes.resize(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        mKeyTimes[i] = keys[i].mTime;
+    }
+    mKeyPositions.swap(keys);
+}
+
 //-----------------------------------------------------------------------------
 // PositionCurve::getValue()
 //-----------------------------------------------------------------------------
-LLVector3 LLKeyframeMotion::PositionCurve::getValue(F32 time, F32 duration)
+LLVector3 LLKeyframeMotion::PositionCurve::getValue(F32 time, F32 duration, U32& cursor) const
 {
     LLVector3 value;
 
-    if (mKeys.empty())
+    if (mKeyTimes.empty())
     {
         value.clearVec();
         return value;
     }
 
-    key_map_t::iterator right = mKeys.lower_bound(time);
-    if (right == mKeys.end())
+    U32 right = find_key(mKeyTimes, time, cursor);
+    if (right == mKeyTimes.size())
     {
         // Past last key
-        --right;
-        value = right->second.mPosition;
+        value = getKeyPosition(right - 1);
     }
-    else if (right == mKeys.begin() || right->first == time)
+    else if (right == 0 || mKeyTimes[right] == time)
     {
         // Before first key or exactly on a key
-        value = right->second.mPosition;
+        value = getKeyPosition(right);
     }
     else
     {
         // Between two keys
-        key_map_t::iterator left = right; --left;
-        F32 index_before = left->first;
-        F32 index_after = right->first;
-        PositionKey& pos_before = left->second;
-        PositionKey& pos_after = right->second;
-        if (right == mKeys.end())
-        {
-            pos_after = mLoopInKey;
-            index_after = duration;
-        }
-
-        F32 u = (time - index_before) / (index_after - index_before);
-        value = interp(u, pos_before, pos_after);
+        U32 left = right - 1;
+        F32 u = (time - mKeyTimes[left]) / (mKeyTimes[right] - mKeyTimes[left]);
+        value = interp(u, getKeyPosition(left), getKeyPosition(right));
     }
 
     llassert(value.isFinite());
@@ -360,16 +440,16 @@ LLVector3 LLKeyframeMotion::PositionCurve::getValue(F32 time, F32 duration)
 //-----------------------------------------------------------------------------
 // interp()
 //-----------------------------------------------------------------------------
-LLVector3 LLKeyframeMotion::PositionCurve::interp(F32 u, PositionKey& before, PositionKey& after)
+LLVector3 LLKeyframeMotion::PositionCurve::interp(F32 u, const LLVector3& before, const LLVector3& after) const
 {
     switch (mInterpolationType)
     {
     case IT_STEP:
-        return before.mPosition;
+        return before;
     default:
     case IT_LINEAR:
     case IT_SPLINE:
-        return lerp(before.mPosition, after.mPosition, u);
+        return lerp(before, after, u);
     }
 }
 
@@ -383,7 +463,7 @@ LLVector3 LLKeyframeMotion::PositionCurve::interp(F32 u, PositionKey& before, Po
 //-----------------------------------------------------------------------------
 // JointMotion::update()
 //-----------------------------------------------------------------------------
-void LLKeyframeMotion::JointMotion::update(LLJointState* joint_state, F32 time, F32 duration)
+void LLKeyframeMotion::JointMotion::update(LLJointState* joint_state, JointMotionCursor& cursor, F32 time, F32 duration) const
 {
     // this value being 0 is the cause of https://jira.lindenlab.com/browse/SL-22678 but I haven't
     // managed to get a stack to see how it got here. Testing for 0 here will stop the crash.
@@ -399,7 +479,7 @@ void LLKeyframeMotion::JointMotion::update(LLJointState* joint_state, F32 time,
     //-------------------------------------------------------------------------
     if ((usage & LLJointState::SCALE) && mScaleCurve.mNumKeys)
     {
-        joint_state->setScale( mScaleCurve.getValue( time, duration ) );
+        joint_state->setScale( mScaleCurve.getValue( time, duration, cursor.mScaleKey ) );
     }
 
     //-------------------------------------------------------------------------
@@ -407,7 +487,7 @@ void LLKeyframeMotion::JointMotion::update(LLJointState* joint_state, F32 time,
     //-------------------------------------------------------------------------
     if ((usage & LLJointState::ROT) && mRotationCurve.mNumKeys)
     {
-        joint_state->setRotation( mRotationCurve.getValue( time, duration ) );
+        joint_state->setRotation( mRotationCurve.getValue( time, duration, cursor.mRotationKey ) );
     }
 
     //-------------------------------------------------------------------------
@@ -415,7 +495,7 @@ void LLKeyframeMotion::JointMotion::update(LLJointState* joint_state, F32 time,
     //-------------------------------------------------------------------------
     if ((usage & LLJointState::POS) && mPositionCurve.mNumKeys)
     {
-        joint_state->setPosition( mPositionCurve.getValue( time, duration ) );
+        joint_state->setPosition( mPositionCurve.getValue( time, duration, cursor.mPositionKey ) );
     }
 }
 
@@ -557,6 +637,7 @@ LLMotion::LLMotionInitStatus LLKeyframeMotion::onInitialize(LLCharacter *charact
                 mJointStates.push_back(new LLJointState);
             }
         }
+        mJointCursors.assign(mJointMotionList->getNumJointMotions(), JointMotionCursor());
         mAssetStatus = ASSET_LOADED;
         setupPose();
         return STATUS_SUCCESS;
@@ -738,9 +819,11 @@ bool LLKeyframeMotion::onUpdate(F32 time, U8* joint_mask)
 void LLKeyframeMotion::applyKeyframes(F32 time)
 {
     llassert_always (mJointMotionList->getNumJointMotions() <= mJointStates.size());
+    llassert_always (mJointMotionList->getNumJointMotions() <= mJointCursors.size());
     for (U32 i=0; i<mJointMotionList->getNumJointMotions(); i++)
     {
         mJointMotionList->getJointMotion(i)->update(mJointStates[i],
+                                                      mJointCursors[i],
                                                       time,
                                                       mJointMotionList->mDuration );
     }
@@ -1455,6 +1538,7 @@ bool LLKeyframeMotion::deserialize(LLDataPacker& dp, const LLUUID& asset_id, boo
     joint_motion_list->mJointMotionArray.reserve(num_motions);
     mJointStates.clear();
     mJointStates.reserve(num_motions);
+    mJointCursors.assign(num_motions, JointMotionCursor());
 
     //-------------------------------------------------------------------------
     // initialize joint motions
@@ -1562,6 +1646,7 @@ bool LLKeyframeMotion::deserialize(LLDataPacker& dp, const LLUUID& asset_id, boo
         // scan rotation curve keys
         //---------------------------------------------------------------------
         RotationCurve *rCurve = &joint_motion->mRotationCurve;
+        std::vector<QuantizedKey> rot_keys;
 
         for (S32 k = 0; k < joint_motion->mRotationCurve.mNumKeys; k++)
         {
@@ -1601,7 +1686,7 @@ bool LLKeyframeMotion::deserialize(LLDataPacker& dp, const LLUUID& asset_id, boo
             RotationKey rot_key;
             rot_key.mTime = time;
             LLVector3 rot_angles;
-            U16 x, y, z;
+            U16 x = 0, y = 0, z = 0;
 
             if (old_version)
             {
@@ -1620,6 +1705,11 @@ bool LLKeyframeMotion::deserialize(LLDataPacker& dp, const LLUUID& asset_id, boo
 
                 LLQuaternion::Order ro = StringToOrder("ZYX");
                 rot_key.mRotation = mayaQ(rot_angles.mV[VX], rot_angles.mV[VY], rot_angles.mV[VZ], ro);
+
+                LLVector3 rot_vec = rot_key.mRotation.packToVector3();
+                x = F32_to_U16(rot_vec.mV[VX], -1.f, 1.f);
+                y = F32_to_U16(rot_vec.mV[VY], -1.f, 1.f);
+                z = F32_to_U16(rot_vec.mV[VZ], -1.f, 1.f);
             }
             else
             {
@@ -1663,14 +1753,21 @@ bool LLKeyframeMotion::deserialize(LLDataPacker& dp, const LLUUID& asset_id, boo
                 return false;
             }
 
-            rCurve->mKeys[time] = rot_key;
+            QuantizedKey quantized_key;
+            quantized_key.mTime = time;
+            quantized_key.mValue[VX] = x;
+            quantized_key.mValue[VY] = y;
+            quantized_key.mValue[VZ] = z;
+            rot_keys.push_back(quantized_key);
         }
 
-        if (joint_motion->mRotationCurve.mNumKeys > joint_motion->mRotationCurve.mKeys.size())
+        rCurve->setKeys(rot_keys);
+
+        if (joint_motion->mRotationCurve.mNumKeys > (S32)joint_motion->mRotationCurve.getNumKeys())
         {
             rotation_duplicates++;
             LL_INFOS() << "Motion " << asset() << " had duplicated rotation keys that were removed: "
-                << joint_motion->mRotationCurve.mNumKeys << " > " << joint_motion->mRotationCurve.mKeys.size()
+                << joint_motion->mRotationCurve.mNumKeys << " > " << joint_motion->mRotationCurve.getNumKeys()
                 << " (" << rotation_duplicates << ")" << LL_ENDL;
         }
 
@@ -1694,11 +1791,13 @@ bool LLKeyframeMotion::deserialize(LLDataPacker& dp, const LLUUID& asset_id, boo
         // scan position curve keys
         //---------------------------------------------------------------------
         PositionCurve *pCurve = &joint_motion->mPositionCurve;
+        std::vector<QuantizedKey> pos_keys;
         bool is_pelvis = joint_motion->mJointName == "mPelvis";
         for (S32 k = 0; k < joint_motion->mPositionCurve.mNumKeys; k++)
         {
             U16 time_short;
             PositionKey pos_key;
+            QuantizedKey quantized_key;
 
             if (old_version)
             {
@@ -1736,6 +1835,10 @@ bool LLKeyframeMotion::deserialize(LLDataPacker& dp, const LLUUID& asset_id, boo
                 pos_key.mPosition.mV[VY] = llclamp( pos_key.mPosition.mV[VY], -LL_MAX_PELVIS_OFFSET, LL_MAX_PELVIS_OFFSET);
                 pos_key.mPosition.mV[VZ] = llclamp( pos_key.mPosition.mV[VZ], -LL_MAX_PELVIS_OFFSET, LL_MAX_PELVIS_OFFSET);
 
+                quantized_key.mValue[VX] = F32_to_U16(pos_key.mPosition.mV[VX], -LL_MAX_PELVIS_OFFSET, LL_MAX_PELVIS_OFFSET);
+                quantized_key.mValue[VY] = F32_to_U16(pos_key.mPosition.mV[VY], -LL_MAX_PELVIS_OFFSET, LL_MAX_PELVIS_OFFSET);
+                quantized_key.mValue[VZ] = F32_to_U16(pos_key.mPosition.mV[VZ], -LL_MAX_PELVIS_OFFSET, LL_MAX_PELVIS_OFFSET);
+
             }
             else
             {
@@ -1763,6 +1866,10 @@ bool LLKeyframeMotion::deserialize(LLDataPacker& dp, const LLUUID& asset_id, boo
                 pos_key.mPosition.mV[VX] = U16_to_F32(x, -LL_MAX_PELVIS_OFFSET, LL_MAX_PELVIS_OFFSET);
                 pos_key.mPosition.mV[VY] = U16_to_F32(y, -LL_MAX_PELVIS_OFFSET, LL_MAX_PELVIS_OFFSET);
                 pos_key.mPosition.mV[VZ] = U16_to_F32(z, -LL_MAX_PELVIS_OFFSET, LL_MAX_PELVIS_OFFSET);
+
+                quantized_key.mValue[VX] = x;
+                quantized_key.mValue[VY] = y;
+                quantized_key.mValue[VZ] = z;
             }
 
             if (!pos_key.mPosition.isFinite())
@@ -1772,7 +1879,8 @@ bool LLKeyframeMotion::deserialize(LLDataPacker& dp, const LLUUID& asset_id, boo
                 return false;
             }
 
-            pCurve->mKeys[pos_key.mTime] = pos_key;
+            quantized_key.mTime = pos_key.mTime;
+            pos_keys.push_back(quantized_key);
 
             if (is_pelvis)
             {
@@ -1780,11 +1888,13 @@ bool LLKeyframeMotion::deserialize(LLDataPacker& dp, const LLUUID& asset_id, boo
             }
         }
 
-        if (joint_motion->mPositionCurve.mNumKeys > joint_motion->mPositionCurve.mKeys.size())
+        pCurve->setKeys(pos_keys);
+
+        if (joint_motion->mPositionCurve.mNumKeys > (S32)joint_motion->mPositionCurve.getNumKeys())
         {
             position_duplicates++;
             LL_INFOS() << "Motion " << asset() << " had duplicated position keys that were removed: "
-                << joint_motion->mPositionCurve.mNumKeys << " > " << joint_motion->mPositionCurve.mKeys.size()
+                << joint_motion->mPositionCurve.mNumKeys << " > " << joint_motion->mPositionCurve.getNumKeys()
                 << " (" << position_duplicates << ")" << LL_ENDL;
         }
 
@@ -2082,49 +2192,38 @@ bool LLKeyframeMotion::serialize(LLDataPacker& dp) const
         JointMotion* joint_motionp = mJointMotionList->getJointMotion(i);
         success &= dp.packString(joint_motionp->mJointName, "joint_name");
         success &= dp.packS32(joint_motionp->mPriority, "joint_priority");
-        success &= dp.packS32(static_cast<S32>(joint_motionp->mRotationCurve.mKeys.size()), "num_rot_keys");
+        const RotationCurve& rot_curve = joint_motionp->mRotationCurve;
+        const PositionCurve& pos_curve = joint_motionp->mPositionCurve;
+        success &= dp.packS32(static_cast<S32>(rot_curve.getNumKeys()), "num_rot_keys");
 
         LL_DEBUGS("BVH") << "Joint " << i
             << " name: " << joint_motionp->mJointName
-            << " Rotation keys: " << joint_motionp->mRotationCurve.mKeys.size()
-            << " Position keys: " << joint_motionp->mPositionCurve.mKeys.size() << LL_ENDL;
-        for (RotationCurve::key_map_t::value_type& rot_pair : joint_motionp->mRotationCurve.mKeys)
+            << " Rotation keys: " << rot_curve.getNumKeys()
+            << " Position keys: " << pos_curve.getNumKeys() << LL_ENDL;
+        for (U32 k = 0; k < rot_curve.getNumKeys(); k++)
         {
-            RotationKey& rot_key = rot_pair.second;
+            // keys are kept in their packed form, so they go out as they came in
+            const QuantizedKey& rot_key = rot_curve.mKeyRotations[k];
             U16 time_short = F32_to_U16(rot_key.mTime, 0.f, mJointMotionList->mDuration);
             success &= dp.packU16(time_short, "time");
+            success &= dp.packU16(rot_key.mValue[VX], "rot_angle_x");
+            success &= dp.packU16(rot_key.mValue[VY], "rot_angle_y");
+            success &= dp.packU16(rot_key.mValue[VZ], "rot_angle_z");
 
-            LLVector3 rot_angles = rot_key.mRotation.packToVector3();
-
-            U16 x, y, z;
-            rot_angles.quantize16(-1.f, 1.f, -1.f, 1.f);
-            x = F32_to_U16(rot_angles.mV[VX], -1.f, 1.f);
-            y = F32_to_U16(rot_angles.mV[VY], -1.f, 1.f);
-            z = F32_to_U16(rot_angles.mV[VZ], -1.f, 1.f);
-            success &= dp.packU16(x, "rot_angle_x");
-            success &= dp.packU16(y, "rot_angle_y");
-            success &= dp.packU16(z, "rot_angle_z");
-
-            LL_DEBUGS("BVH") << "  rot: t " << rot_key.mTime << " angles " << rot_angles.mV[VX] <<","<< rot_angles.mV[VY] <<","<< rot_angles.mV[VZ] << LL_ENDL;
+            LL_DEBUGS("BVH") << "  rot: t " << rot_key.mTime << " angles " << rot_key.mValue[VX] <<","<< rot_key.mValue[VY] <<","<< rot_key.mValue[VZ] << LL_ENDL;
         }
 
-        success &= dp.packS32(static_cast<S32>(joint_motionp->mPositionCurve.mKeys.size()), "num_pos_keys");
-        for (PositionCurve::key_map_t::value_type& pos_pair : joint_motionp->mPositionCurve.mKeys)
+        success &= dp.packS32(static_cast<S32>(pos_curve.getNumKeys()), "num_pos_keys");
+        for (U32 k = 0; k < pos_curve.getNumKeys(); k++)
         {
-            PositionKey& pos_key = pos_pair.second;
+            const QuantizedKey& pos_key = pos_curve.mKeyPositions[k];
             U16 time_short = F32_to_U16(pos_key.mTime, 0.f, mJointMotionList->mDuration);
             success &= dp.packU16(time_short, "time");
+            success &= dp.packU16(pos_key.mValue[VX], "pos_x");
+            success &= dp.packU16(pos_key.mValue[VY], "pos_y");
+            success &= dp.packU16(pos_key.mValue[VZ], "pos_z");
 
-            U16 x, y, z;
-            pos_key.mPosition.quantize16(-LL_MAX_PELVIS_OFFSET, LL_MAX_PELVIS_OFFSET, -LL_MAX_PELVIS_OFFSET, LL_MAX_PELVIS_OFFSET);
-            x = F32_to_U16(pos_key.mPosition.mV[VX], -LL_MAX_PELVIS_OFFSET, LL_MAX_PELVIS_OFFSET);
-            y = F32_to_U16(pos_key.mPosition.mV[VY], -LL_MAX_PELVIS_OFFSET, LL_MAX_PELVIS_OFFSET);
-            z = F32_to_U16(pos_key.mPosition.mV[VZ], -LL_MAX_PELVIS_OFFSET, LL_MAX_PELVIS_OFFSET);
-            success &= dp.packU16(x, "pos_x");
-            success &= dp.packU16(y, "pos_y");
-            success &= dp.packU16(z, "pos_z");
-
-            LL_DEBUGS("BVH") << "  pos: t " << pos_key.mTime << " pos " << pos_key.mPosition.mV[VX] <<","<< pos_key.mPosition.mV[VY] <<","<< pos_key.mPosition.mV[VZ] << LL_ENDL;
+            LL_DEBUGS("BVH") << "  pos: t " << pos_key.mTime << " pos " << pos_key.mValue[VX] <<","<< pos_key.mValue[VY] <<","<< pos_key.mValue[VZ] << LL_ENDL;
         }
     }
 
@@ -2369,9 +2468,10 @@ void LLKeyframeMotion::setLoopIn(F32 in_point)
             rot_curve->mLoopInKey.mTime = mJointMotionList->mLoopInPoint;
             scale_curve->mLoopInKey.mTime = mJointMotionList->mLoopInPoint;
 
-            pos_curve->mLoopInKey.mPosition = pos_curve->getValue(mJointMotionList->mLoopInPoint, mJointMotionList->mDuration);
-            rot_curve->mLoopInKey.mRotation = rot_curve->getValue(mJointMotionList->mLoopInPoint, mJointMotionList->mDuration);
-            scale_curve->mLoopInKey.mScale = scale_curve->getValue(mJointMotionList->mLoopInPoint, mJointMotionList->mDuration);
+            JointMotionCursor cursor;
+            pos_curve->mLoopInKey.mPosition = pos_curve->getValue(mJointMotionList->mLoopInPoint, mJointMotionList->mDuration, cursor.mPositionKey);
+            rot_curve->mLoopInKey.mRotation = rot_curve->getValue(mJointMotionList->mLoopInPoint, mJointMotionList->mDuration, cursor.mRotationKey);
+            scale_curve->mLoopInKey.mScale = scale_curve->getValue(mJointMotionList->mLoopInPoint, mJointMotionList->mDuration, cursor.mScaleKey);
         }
     }
 }
@@ -2398,9 +2498,10 @@ void LLKeyframeMotion::setLoopOut(F32 out_point)
             rot_curve->mLoopOutKey.mTime = mJointMotionList->mLoopOutPoint;
             scale_curve->mLoopOutKey.mTime = mJointMotionList->mLoopOutPoint;
 
-            pos_curve->mLoopOutKey.mPosition = pos_curve->getValue(mJointMotionList->mLoopOutPoint, mJointMotionList->mDuration);
-            rot_curve->mLoopOutKey.mRotation = rot_curve->getValue(mJointMotionList->mLoopOutPoint, mJointMotionList->mDuration);
-            scale_curve->mLoopOutKey.mScale = scale_curve->getValue(mJointMotionList->mLoopOutPoint, mJointMotionList->mDuration);
+            JointMotionCursor cursor;
+            pos_curve->mLoopOutKey.mPosition = pos_curve->getValue(mJointMotionList->mLoopOutPoint, mJointMotionList->mDuration, cursor.mPositionKey);
+            rot_curve->mLoopOutKey.mRotation = rot_curve->getValue(mJointMotionList->mLoopOutPoint, mJointMotionList->mDuration, cursor.mRotationKey);
+            scale_curve->mLoopOutKey.mScale = scale_curve->getValue(mJointMotionList->mLoopOutPoint, mJointMotionList->mDuration, cursor.mScaleKey);
         }
     }
 }
@@ -317,6 +317,35 @@ public:
         LLVector3   mPosition;
     };
 
+    //-------------------------------------------------------------------------
+    // QuantizedKey
+    // a rotation or position key as stored in the animation asset, with each
+    // component packed into 16 bits
+    //-------------------------------------------------------------------------
+    class QuantizedKey
+    {
+    public:
+        QuantizedKey() { mTime = 0.0f; mValue[VX] = mValue[VY] = mValue[VZ] = 0; }
+
+        F32         mTime;
+        U16         mValue[3];
+    };
+
+    //-------------------------------------------------------------------------
+    // JointMotionCursor
+    // per motion instance search position into each of a joint's curves, so
+    // the shared curves themselves stay immutable once loaded
+    //-------------------------------------------------------------------------
+    class JointMotionCursor
+    {
+    public:
+        JointMotionCursor() { mScaleKey = 0; mRotationKey = 0; mPositionKey = 0; }
+
+        U32         mScaleKey;
+        U32         mRotationKey;
+        U32         mPositionKey;
+    };
+
     //-------------------------------------------------------------------------
     // ScaleCurve
     //-------------------------------------------------------------------------
@@ -325,15 +354,16 @@ public:
     public:
         ScaleCurve();
         ~ScaleCurve();
-        LLVector3 getValue(F32 time, F32 duration);
-        LLVector3 interp(F32 u, ScaleKey& before, ScaleKey& after);
-
-        InterpolationType   mInterpolationType;
-        S32                 mNumKeys;
-        typedef std::map<F32, ScaleKey> key_map_t;
-        key_map_t           mKeys;
-        ScaleKey            mLoopInKey;
-        ScaleKey            mLoopOutKey;
+        LLVector3 getValue(F32 time, F32 duration, U32& cursor) const;
+        LLVector3 interp(F32 u, const LLVector3& before, const LLVector3& after) const;
+        U32 getNumKeys() const { return static_cast<U32>(mKeyTimes.size()); }
+
+        InterpolationType       mInterpolationType;
+        S32                     mNumKeys;
+        std::vector<F32>        mKeyTimes;
+        std::vector<LLVector3>  mKeyScales;
+        ScaleKey                mLoopInKey;
+        ScaleKey                mLoopOutKey;
     };
 
     //-------------------------------------------------------------------------
@@ -344,15 +374,18 @@ public:
     public:
         RotationCurve();
         ~RotationCurve();
-        LLQuaternion getValue(F32 time, F32 duration);
-        LLQuaternion interp(F32 u, RotationKey& before, RotationKey& after);
-
-        InterpolationType   mInterpolationType;
-        S32                 mNumKeys;
-        typedef std::map<F32, RotationKey> key_map_t;
-        key_map_t       mKeys;
-        RotationKey     mLoopInKey;
-        RotationKey     mLoopOutKey;
+        LLQuaternion getValue(F32 time, F32 duration, U32& cursor) const;
+        LLQuaternion interp(F32 u, const LLQuaternion& before, const LLQuaternion& after) const;
+        LLQuaternion getKeyRotation(U32 index) const;
+        void setKeys(std::vector<QuantizedKey>& keys);
+        U32 getNumKeys() const { return static_cast<U32>(mKeyTimes.size()); }
+
+        InterpolationType           mInterpolationType;
+        S32                         mNumKeys;
+        std::vector<F32>            mKeyTimes;
+        std::vector<QuantizedKey>   mKeyRotations;
+        RotationKey                 mLoopInKey;
+        RotationKey                 mLoopOutKey;
     };
 
     //-------------------------------------------------------------------------
@@ -363,15 +396,18 @@ public:
     public:
         PositionCurve();
         ~PositionCurve();
-        LLVector3 getValue(F32 time, F32 duration);
-        LLVector3 interp(F32 u, PositionKey& before, PositionKey& after);
-
-        InterpolationType   mInterpolationType;
-        S32                 mNumKeys;
-        typedef std::map<F32, PositionKey> key_map_t;
-        key_map_t       mKeys;
-        PositionKey     mLoopInKey;
-        PositionKey     mLoopOutKey;
+        LLVector3 getValue(F32 time, F32 duration, U32& cursor) const;
+        LLVector3 interp(F32 u, const LLVector3& before, const LLVector3& after) const;
+        LLVector3 getKeyPosition(U32 index) const;
+        void setKeys(std::vector<QuantizedKey>& keys);
+        U32 getNumKeys() const { return static_cast<U32>(mKeyTimes.size()); }
+
+        InterpolationType           mInterpolationType;
+        S32                         mNumKeys;
+        std::vector<F32>            mKeyTimes;
+        std::vector<QuantizedKey>   mKeyPositions;
+        PositionKey                 mLoopInKey;
+        PositionKey                 mLoopOutKey;
     };
 
     //-------------------------------------------------------------------------
@@ -387,7 +423,7 @@ public:
         U32             mUsage;
         LLJoint::JointPriority  mPriority;
 
-        void update(LLJointState* joint_state, F32 time, F32 duration);
+        void update(LLJointState* joint_state, JointMotionCursor& cursor, F32 time, F32 duration) const;
     };
 
     //-------------------------------------------------------------------------
@@ -426,6 +462,7 @@ public:
 protected:
     JointMotionList*                mJointMotionList;
     std::vector<LLPointer<LLJointState> > mJointStates;
+    std::vector<JointMotionCursor>  mJointCursors;
     LLJoint*                        mPelvisp;
     LLCharacter*                    mCharacter;
     typedef std::list<JointConstraint*> constraint_list_t;
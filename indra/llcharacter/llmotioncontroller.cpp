@@ -132,6 +132,7 @@ LLMotionController::LLMotionController()
       mUpdateFactor(1.f), // <FS:Ansariel> Fix impostered animation speed based on a fix by Henri Beauchamp
       mCharacter(NULL),
       mAnimTime(0.f),
+      mClockTime(0.f),
       mPrevTimerElapsed(0.f),
       mLastTime(0.0f),
       mHasRunOnce(false),
@@ -267,7 +268,15 @@ void LLMotionController::deactivateStoppedMotions()
 //-----------------------------------------------------------------------------
 void LLMotionController::setTimeStep(F32 step)
 {
+    if (step == mTimeStep)
+    {
+        return;
+    }
+
     mTimeStep = step;
+    // start a new quantum on the next update; never let animation time run backwards
+    mTimeStepCount = 0;
+    mClockTime = llmax(mClockTime, mAnimTime);
 
     if (step != 0.f)
     {
@@ -821,10 +830,9 @@ void LLMotionController::updateLoadingMotions()
 void LLMotionController::updateMotions(bool force_update)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_AVATAR;
-    // SL-763: "Distant animated objects run at super fast speed"
-    // The use_quantum optimization or possibly the associated code in setTimeStamp()
-    // does not work as implemented.
-    // Currently setting mTimeStep to nonzero is disabled elsewhere.
+    // SL-763: "Distant animated objects run at super fast speed" was caused by
+    // advancing from the quantized mAnimTime, which jumps a whole quantum ahead
+    // on every new keyframe; time now advances on mClockTime instead.
     bool use_quantum = (mTimeStep != 0.f);
 
     // Always update mPrevTimerElapsed
@@ -841,8 +849,9 @@ void LLMotionController::updateMotions(bool force_update)
     {
         // <FS:Ansariel> Fix impostered animation speed based on a fix by Henri Beauchamp
         //F32 update_time = mAnimTime + delta_time * mTimeFactor;
-        F32 update_time = mAnimTime + delta_time * mTimeFactor * mUpdateFactor;
+        F32 update_time = mClockTime + delta_time * mTimeFactor * mUpdateFactor;
         // </FS:Ansariel>
+        mClockTime = update_time;
         if (use_quantum)
         {
             F32 time_interval = fmodf(update_time, mTimeStep);
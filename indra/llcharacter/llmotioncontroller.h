@@ -223,6 +223,7 @@ protected:
     LLFrameTimer        mTimer;
     F32                 mPrevTimerElapsed;
     F32                 mAnimTime;
+    F32                 mClockTime;     // animation time before time step quantization
     F32                 mLastTime;
     bool                mHasRunOnce;
     bool                mPaused;
@@ -38,7 +38,8 @@ LLSD LL::CommonControl::access(const LLSD& params)
                      });
         LLSD rparams{ params };
         rparams["reply"] = reply.getName();
-        LLEventPumps::instance().obtain("LLViewerControl").post(rparams);
+        static LLCachedEventPump sViewerControl("LLViewerControl");
+        sViewerControl.post(rparams);
     }
     // LLViewerControlListener responds immediately. If it's listening at all,
     // it will already have set response.
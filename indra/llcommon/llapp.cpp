@@ -348,6 +348,11 @@ void LLApp::setErrorHandler(LLAppErrorHandler handler)
 // static
 void LLApp::runErrorHandler()
 {
+    // the last lines before a crash are the interesting ones; give the log
+    // writer a moment to finish its batch, but it may be the thread that crashed
+    static const F32 LOG_FLUSH_TIMEOUT = 0.5f;
+    LLError::flushAsyncLog(false, LOG_FLUSH_TIMEOUT);
+
     if (LLApp::sErrorHandler)
     {
         LLApp::sErrorHandler();
@@ -31,11 +31,18 @@
 #include "llerrorcontrol.h"
 #include "llsdutil.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cctype>
 #ifdef __GNUC__
 # include <cxxabi.h>
 #endif // __GNUC__
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #include <sstream>
+#include <thread>
 #if !LL_WINDOWS
 # include <syslog.h>
 # include <unistd.h>
@@ -557,6 +564,9 @@ namespace
         void invalidateCallSites();
 
         SettingsConfigPtr getSettingsConfig();
+        // Without touching the reference count, for async logging from any thread.  The
+        // settings are only replaced by initForApplication() and the unit tests.
+        SettingsConfig* peekSettingsConfig() { return mSettingsConfig.get(); }
 
         void resetSettingsConfig();
         LLError::SettingsStoragePtr saveAndResetSettingsConfig();
@@ -1224,16 +1234,21 @@ namespace
         return out.str();
     }
 
-    void writeToRecorders(const LLError::CallSite& site, const std::string& message)
+    std::string logTime(const SettingsConfig& s)
+    {
+        return s.mTimeFunction != NULL ? s.mTimeFunction() : std::string();
+    }
+
+    void writeToRecorders(SettingsConfig& s, const LLError::CallSite& site, const std::string& message,
+                          const std::string& time)
     {
         LL_PROFILE_ZONE_SCOPED_CATEGORY_LOGGING;
         LLError::ELevel level = site.mLevel;
-        SettingsConfigPtr s = Globals::getInstance()->getSettingsConfig();
 
         std::string escaped_message;
 
-        std::unique_lock lock(s->mRecorderMutex); LL_PROFILE_MUTEX_LOCK(s->mRecorderMutex);
-        for (LLError::RecorderPtr& r : s->mRecorders)
+        std::unique_lock lock(s.mRecorderMutex); LL_PROFILE_MUTEX_LOCK(s.mRecorderMutex);
+        for (LLError::RecorderPtr& r : s.mRecorders)
         {
             // <FS:Ansariel> Crash fix
             //if (!r->enabled())
@@ -1244,9 +1259,9 @@ namespace
 
             std::ostringstream message_stream;
 
-            if (r->wantsTime() && s->mTimeFunction != NULL)
+            if (r->wantsTime())
             {
-                message_stream << s->mTimeFunction();
+                message_stream << time;
             }
             message_stream << " ";
 
@@ -1290,6 +1305,240 @@ namespace
             r->recordMessage(level, message_stream.str());
         }
     }
+
+    // One thread's log lines waiting for the writer thread.  Only the owning thread pushes
+    // and only the drain pops, so neither side takes a lock.
+    class AsyncLogBuffer
+    {
+    public:
+        static constexpr U32 CAPACITY = 1024;
+
+        struct Record
+        {
+            const LLError::CallSite* mSite = NULL;
+            std::string mTime;
+            std::string mMessage;
+        };
+
+        bool push(const LLError::CallSite& site, std::string& time, std::string& message)
+        {
+            U32 tail = mTail.load(std::memory_order_relaxed);
+            if (tail - mHead.load(std::memory_order_acquire) >= CAPACITY)
+            {
+                return false;
+            }
+            Record& record = mRecords[tail % CAPACITY];
+            record.mSite = &site;
+            record.mTime = std::move(time);
+            record.mMessage = std::move(message);
+            mTail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool pop(Record& record)
+        {
+            U32 head = mHead.load(std::memory_order_relaxed);
+            if (head == mTail.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+            // moving out leaves the slot without a buffer, so a burst of long lines
+            // doesn't stay allocated
+            Record& slot = mRecords[head % CAPACITY];
+            record.mSite = slot.mSite;
+            record.mTime = std::move(slot.mTime);
+            record.mMessage = std::move(slot.mMessage);
+            mHead.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool empty() const
+        {
+            return mHead.load(std::memory_order_acquire) == mTail.load(std::memory_order_acquire);
+        }
+
+        U32 size() const
+        {
+            return mTail.load(std::memory_order_relaxed) - mHead.load(std::memory_order_relaxed);
+        }
+
+        std::atomic<bool> mOrphaned{ false };   // the owning thread has exited
+
+    private:
+        Record mRecords[CAPACITY];
+        std::atomic<U32> mHead{ 0 };
+        std::atomic<U32> mTail{ 0 };
+    };
+
+    struct AsyncLogBufferHolder
+    {
+        std::shared_ptr<AsyncLogBuffer> mBuffer;
+
+        ~AsyncLogBufferHolder()
+        {
+            if (mBuffer)
+            {
+                mBuffer->mOrphaned = true;
+            }
+        }
+    };
+
+    // Formats and writes the lines queued by LLError::Log::flush() while async logging is
+    // on.  Lines of one thread stay in order, lines of different threads are only ordered
+    // by their timestamps.
+    class AsyncLogWriter
+    {
+    public:
+        // leaked on purpose, threads may still log after static destructors ran
+        static AsyncLogWriter& instance()
+        {
+            static AsyncLogWriter* writer = new AsyncLogWriter;
+            return *writer;
+        }
+
+        bool isRunning() const { return mRunning.load(std::memory_order_relaxed); }
+        U64 getDropped() const { return mDropped.load(std::memory_order_relaxed); }
+
+        void start()
+        {
+            if (mRunning.exchange(true))
+            {
+                return;
+            }
+            mThread = std::thread([this]()
+                                  {
+                                      LL_PROFILER_SET_THREAD_NAME("Log writer");
+                                      run();
+                                  });
+        }
+
+        void stop()
+        {
+            if (!mRunning.exchange(false))
+            {
+                return;
+            }
+            mWake.notify_one();
+            if (mThread.joinable())
+            {
+                mThread.join();
+            }
+            drain(true);
+        }
+
+        // false if the calling thread's queue is full and the line was dropped
+        bool push(const LLError::CallSite& site, std::string& time, std::string& message)
+        {
+            AsyncLogBuffer& buffer = getThreadBuffer();
+            if (!buffer.push(site, time, message))
+            {
+                mDropped.fetch_add(1, std::memory_order_relaxed);
+                mWake.notify_one();
+                return false;
+            }
+            if (buffer.size() >= AsyncLogBuffer::CAPACITY / 2)
+            {
+                mWake.notify_one();
+            }
+            return true;
+        }
+
+        // Write every queued line.  Without wait, give up after max_wait rather
+        // than block for good, crash handlers can't know what the crashed thread
+        // was holding.  False if it gave up.
+        bool drain(bool wait, std::chrono::milliseconds max_wait = std::chrono::milliseconds::zero())
+        {
+            std::unique_lock<std::timed_mutex> drain_lock(mDrainMutex, std::defer_lock);
+            std::unique_lock<std::timed_mutex> buffers_lock(mBuffersMutex, std::defer_lock);
+            if (wait)
+            {
+                drain_lock.lock();
+                buffers_lock.lock();
+            }
+            else
+            {
+                // the writer thread holds the drain lock while it writes a batch
+                const auto deadline = std::chrono::steady_clock::now() + max_wait;
+                if (!drain_lock.try_lock_until(deadline) || !buffers_lock.try_lock_until(deadline))
+                {
+                    return false;
+                }
+            }
+            mDraining = mBuffers;
+            buffers_lock.unlock();
+
+            SettingsConfig* s = Globals::getInstance()->peekSettingsConfig();
+            AsyncLogBuffer::Record record;
+            bool orphans = false;
+            for (const std::shared_ptr<AsyncLogBuffer>& buffer : mDraining)
+            {
+                // a thread's last line is queued before it is marked orphaned
+                orphans |= buffer->mOrphaned.load(std::memory_order_acquire);
+                while (buffer->pop(record))
+                {
+                    writeToRecorders(*s, *record.mSite, record.mMessage, record.mTime);
+                }
+            }
+            mDraining.clear();
+
+            if (orphans && wait)
+            {
+                std::lock_guard<std::timed_mutex> lock(mBuffersMutex);
+                mBuffers.erase(std::remove_if(mBuffers.begin(), mBuffers.end(),
+                                              [](const std::shared_ptr<AsyncLogBuffer>& buffer)
+                                              { return buffer->mOrphaned && buffer->empty(); }),
+                               mBuffers.end());
+            }
+
+            U64 dropped = getDropped();
+            if (wait && dropped != mReportedDropped)
+            {
+                // queued like any other line, it shows up with the next batch
+                LL_WARNS("Logging") << dropped - mReportedDropped
+                                    << " log lines dropped, the logging threads outran the log writer" << LL_ENDL;
+                mReportedDropped = dropped;
+            }
+            return true;
+        }
+
+    private:
+        AsyncLogBuffer& getThreadBuffer()
+        {
+            thread_local AsyncLogBufferHolder holder;
+            if (!holder.mBuffer)
+            {
+                holder.mBuffer = std::make_shared<AsyncLogBuffer>();
+                std::lock_guard<std::timed_mutex> lock(mBuffersMutex);
+                mBuffers.push_back(holder.mBuffer);
+            }
+            return *holder.mBuffer;
+        }
+
+        void run()
+        {
+            // wake up now and then even without a full queue, lines shouldn't wait long
+            static const std::chrono::milliseconds WRITE_INTERVAL(50);
+            while (isRunning())
+            {
+                {
+                    std::unique_lock<std::mutex> lock(mWakeMutex);
+                    mWake.wait_for(lock, WRITE_INTERVAL);
+                }
+                drain(true);
+            }
+        }
+
+        std::timed_mutex mBuffersMutex;
+        std::vector<std::shared_ptr<AsyncLogBuffer>> mBuffers;
+        std::timed_mutex mDrainMutex;
+        std::vector<std::shared_ptr<AsyncLogBuffer>> mDraining;     // under mDrainMutex
+        U64 mReportedDropped = 0;                                   // under mDrainMutex
+        std::mutex mWakeMutex;
+        std::condition_variable mWake;
+        std::atomic<bool> mRunning{ false };
+        std::atomic<U64> mDropped{ 0 };
+        std::thread mThread;
+    };
 }
 
 namespace {
@@ -1407,6 +1656,17 @@ namespace LLError
     void Log::flush(const std::ostringstream& out, const CallSite& site)
     {
         LL_PROFILE_ZONE_SCOPED_CATEGORY_LOGGING;
+        AsyncLogWriter& async_writer = AsyncLogWriter::instance();
+        if (async_writer.isRunning() && !site.mPrintOnce && site.mLevel != LEVEL_ERROR)
+        {
+            // nothing shared to look up or update, queue it without contending for the
+            // log mutex, which drops the line when another thread holds it
+            std::string message = out.str();
+            std::string time = logTime(*Globals::getInstance()->peekSettingsConfig());
+            async_writer.push(site, time, message);
+            return;
+        }
+
         std::unique_lock lock(*getLogMutex(), std::try_to_lock); LL_PROFILE_MUTEX_LOCK(*getLogMutex());
         if (!lock)
         {
@@ -1445,7 +1705,19 @@ namespace LLError
             message = message_stream.str();
         }
 
-        writeToRecorders(site, message);
+        if (site.mLevel == LEVEL_ERROR)
+        {
+            // what was queued before happened before, and we may not come back
+            async_writer.drain(true);
+        }
+        else if (async_writer.isRunning())
+        {
+            std::string time = logTime(*s);
+            async_writer.push(site, time, message);
+            return;
+        }
+
+        writeToRecorders(*s, site, message, logTime(*s));
 
         if (site.mLevel == LEVEL_ERROR)
         {
@@ -1511,6 +1783,33 @@ namespace LLError
         return f;
     }
 
+    void setAsyncLogging(bool async)
+    {
+        if (async)
+        {
+            AsyncLogWriter::instance().start();
+        }
+        else
+        {
+            AsyncLogWriter::instance().stop();
+        }
+    }
+
+    bool getAsyncLogging()
+    {
+        return AsyncLogWriter::instance().isRunning();
+    }
+
+    bool flushAsyncLog(bool wait, F32 max_wait_seconds)
+    {
+        return AsyncLogWriter::instance().drain(wait, std::chrono::milliseconds((S64)(max_wait_seconds * 1000.f)));
+    }
+
+    U64 getDroppedLogCount()
+    {
+        return AsyncLogWriter::instance().getDropped();
+    }
+
     int shouldLogCallCount()
     {
         SettingsConfigPtr s = Globals::getInstance()->getSettingsConfig();
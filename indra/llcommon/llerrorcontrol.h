@@ -136,6 +136,19 @@ namespace LLError
         // The function is use to return the current time, formatted for
         // display by those error recorders that want the time included.
 
+    LL_COMMON_API void setAsyncLogging(bool async);
+    LL_COMMON_API bool getAsyncLogging();
+        // With async logging, a log call only queues its message for a
+        // background thread that formats it and passes it to the recorders.
+        // Each thread queues up to a fixed number of lines, more are dropped
+        // and counted. LL_ERRS still writes synchronously, after everything
+        // queued before it. Turning it off writes out what is queued.
+    LL_COMMON_API bool flushAsyncLog(bool wait = true, F32 max_wait_seconds = 0.f);
+        // Write out every queued line now. With wait false, block on the log
+        // writer for at most max_wait_seconds, for crash handlers. Returns
+        // false if it gave up.
+    LL_COMMON_API U64 getDroppedLogCount();
+
 
 
     class LL_COMMON_API Recorder
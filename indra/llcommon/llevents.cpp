@@ -58,10 +58,13 @@
 #include "llerror.h"
 #include "llsdutil.h"
 #include "llexception.h"
+#include "lltrace.h"
 #if LL_MSVC
 #pragma warning (disable : 4702)
 #endif
 
+static LLTrace::CountStatHandle<> sEventPumpPosts("eventpumpposts", "Events posted to LLEventStream pumps");
+
 /*****************************************************************************
 *   LLEventPumps
 *****************************************************************************/
@@ -224,7 +227,8 @@ void LLEventPumps::reset(bool log_pumps)
     {
         if (log_pumps)
         {
-            LL_INFOS() << "Resetting pump " << pair.first << LL_ENDL;
+            LL_INFOS() << "Resetting pump " << pair.first << " after "
+                       << pair.second->getPostCount() << " posts" << LL_ENDL;
         }
         pair.second->reset();
     }
@@ -306,6 +310,7 @@ std::string LLEventPumps::registerNew(const LLEventPump& pump, const std::string
 
 void LLEventPumps::unregister(const LLEventPump& pump)
 {
+    ++mGeneration;
     // Remove this instance from mPumpMap
     PumpMap::iterator found = mPumpMap.find(pump.getName());
     if (found != mPumpMap.end())
@@ -628,6 +633,14 @@ bool LLEventStream::post(const LLSD& event)
     // LLStandardSignal object will live at least until post() returns, even
     // if 'this' gets destroyed during the call.
     std::shared_ptr<LLStandardSignal> signal(mSignal);
+    mPostCount.fetch_add(1, std::memory_order_relaxed);
+    LLTrace::add(sEventPumpPosts, 1);
+    // Plenty of pumps are posted to whether or not anybody listens. Invoking
+    // an empty signal still sets up its slot iteration, skip that.
+    if (signal->empty())
+    {
+        return false;
+    }
     // Let caller know if any one listener handled the event. This is mostly
     // useful when using LLEventStream as a listener for an upstream
     // LLEventPump.
@@ -682,6 +695,26 @@ void LLEventMailDrop::discard()
     mEventHistory.clear();
 }
 
+/*****************************************************************************
+ *   LLCachedEventPump
+ *****************************************************************************/
+LLEventPump& LLCachedEventPump::get()
+{
+    LLEventPumps* registry = mRegistry.get();
+    if (! registry)
+    {
+        registry = LLEventPumps::getInstance();
+        mRegistry = registry->getHandle();
+        mPump = nullptr;
+    }
+    if (! mPump || mGeneration != registry->mGeneration)
+    {
+        mPump = &registry->obtain(mName);
+        mGeneration = registry->mGeneration;
+    }
+    return *mPump;
+}
+
 /*****************************************************************************
 *   LLListenerOrPumpName
 *****************************************************************************/
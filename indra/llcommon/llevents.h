@@ -32,6 +32,7 @@
 #if ! defined(LL_LLEVENTS_H)
 #define LL_LLEVENTS_H
 
+#include <atomic>
 #include <string>
 #include <map>
 #include <set>
@@ -331,6 +332,7 @@ public:
 
 private:
     friend class LLEventPump;
+    friend class LLCachedEventPump;
     /**
      * Register a new LLEventPump instance (internal)
      */
@@ -371,6 +373,9 @@ testable:
     // obtain() must create the instance
     typedef std::map<std::string, std::string> InstanceTypes;
     InstanceTypes mTypes;
+    // Bumped whenever an LLEventPump goes away, so LLCachedEventPump knows
+    // when the instance it remembers might be gone.
+    U32 mGeneration = 0;
 };
 
 /*****************************************************************************
@@ -584,6 +589,9 @@ public:
     /// flush queued events
     virtual void flush() {}
 
+    /// Number of events posted to this pump since it was created
+    U64 getPostCount() const { return mPostCount.load(std::memory_order_relaxed); }
+
 private:
     friend class LLEventPumps;
     virtual void clear();
@@ -608,6 +616,8 @@ protected:
 
     /// valve open?
     bool mEnabled;
+    /// see getPostCount()
+    std::atomic<U64> mPostCount{ 0 };
     /// Map of named listeners. This tracks the listeners that actually exist
     /// at this moment. When we stopListening(), we discard the entry from
     /// this map.
@@ -683,6 +693,35 @@ private:
     EventList mEventHistory;
 };
 
+/*****************************************************************************
+*   LLCachedEventPump
+*****************************************************************************/
+/**
+ * LLCachedEventPump remembers the LLEventPump found for a name, so code that
+ * posts to the same pump over and over doesn't look the name up in
+ * LLEventPumps every time:
+ * @code
+ * static LLCachedEventPump sPump("ConversationsEvents");
+ * sPump.post(event);
+ * @endcode
+ * The name is looked up again, with obtain(), after any LLEventPump has been
+ * destroyed, so this is safe with pumps that come and go.
+ */
+class LL_COMMON_API LLCachedEventPump
+{
+public:
+    LLCachedEventPump(const std::string& name): mName(name) {}
+
+    LLEventPump& get();
+    bool post(const LLSD& event) { return get().post(event); }
+
+private:
+    std::string mName;
+    LLHandle<LLEventPumps> mRegistry;
+    LLEventPump* mPump = nullptr;
+    U32 mGeneration = 0;
+};
+
 /*****************************************************************************
 *   LLReqID
 *****************************************************************************/
@@ -0,0 +1,221 @@
+/**
+ * @file llflathashmap.h
+ * @brief Open addressed hash map stored in one flat array
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+
+#ifndef LL_LLFLATHASHMAP_H
+#define LL_LLFLATHASHMAP_H
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+// A hash map for lookup heavy tables of small keys and values, such as
+// LLUUID or U64 ids to pointers.  Entries live in one array and collisions
+// probe the next slots (linear probing), so a lookup touches one or two
+// cache lines instead of chasing tree or bucket list pointers.
+//
+// The hash is spread with a Fibonacci multiply before use, so the plain
+// std::hash of integers, and LLUUID::getDigest64(), both work as is.
+// Erasing shifts the following entries back instead of leaving tombstones,
+// so heavy insert/erase churn doesn't slow lookups down over time.
+//
+// KEY and VALUE must be default constructible.  Unlike std::map, pointers
+// returned by find() and operator[] are invalidated by the next insertion
+// or erase.
+template <typename KEY, typename VALUE, typename HASH = std::hash<KEY> >
+class LLFlatHashMap
+{
+public:
+    LLFlatHashMap() = default;
+
+    size_t size() const { return mSize; }
+    bool empty() const { return mSize == 0; }
+
+    void clear()
+    {
+        mSlots.clear();
+        mSize = 0;
+        mShift = 64;
+    }
+
+    // Make room for count entries without growing again
+    void reserve(size_t count)
+    {
+        size_t capacity = MIN_CAPACITY;
+        while (count * 4 > capacity * 3)
+        {
+            capacity *= 2;
+        }
+        if (capacity > mSlots.size())
+        {
+            rehash(capacity);
+        }
+    }
+
+    // NULL when key isn't in the map
+    VALUE* find(const KEY& key)
+    {
+        return const_cast<VALUE*>(static_cast<const LLFlatHashMap*>(this)->find(key));
+    }
+
+    const VALUE* find(const KEY& key) const
+    {
+        if (!mSize)
+        {
+            return nullptr;
+        }
+        for (size_t i = home(key); mSlots[i].mUsed; i = next(i))
+        {
+            if (mSlots[i].mKey == key)
+            {
+                return &mSlots[i].mValue;
+            }
+        }
+        return nullptr;
+    }
+
+    bool contains(const KEY& key) const { return find(key) != nullptr; }
+
+    // Like std::map, inserts a default constructed value if key is missing
+    VALUE& operator[](const KEY& key)
+    {
+        // at most three quarters full, beyond that probe runs get long
+        if ((mSize + 1) * 4 > mSlots.size() * 3)
+        {
+            rehash(mSlots.empty() ? MIN_CAPACITY : mSlots.size() * 2);
+        }
+        size_t i = home(key);
+        for (; mSlots[i].mUsed; i = next(i))
+        {
+            if (mSlots[i].mKey == key)
+            {
+                return mSlots[i].mValue;
+            }
+        }
+        Slot& slot = mSlots[i];
+        slot.mUsed = true;
+        slot.mKey = key;
+        ++mSize;
+        return slot.mValue;
+    }
+
+    // Returns false if key wasn't in the map
+    bool erase(const KEY& key)
+    {
+        if (!mSize)
+        {
+            return false;
+        }
+        size_t hole = home(key);
+        while (!(mSlots[hole].mUsed && mSlots[hole].mKey == key))
+        {
+            if (!mSlots[hole].mUsed)
+            {
+                return false;
+            }
+            hole = next(hole);
+        }
+
+        // Pull back every following entry of the probe run that may live in
+        // the hole, i.e. whose home slot isn't between the hole and itself
+        const size_t mask = mSlots.size() - 1;
+        for (size_t i = next(hole); mSlots[i].mUsed; i = next(i))
+        {
+            if (((i - home(mSlots[i].mKey)) & mask) >= ((i - hole) & mask))
+            {
+                mSlots[hole] = std::move(mSlots[i]);
+                hole = i;
+            }
+        }
+        mSlots[hole] = Slot();
+        --mSize;
+        return true;
+    }
+
+    // Calls func(key, value) for every entry, in no particular order.  func
+    // must not insert or erase.
+    template <typename FUNC>
+    void forEach(FUNC&& func)
+    {
+        for (Slot& slot : mSlots)
+        {
+            if (slot.mUsed)
+            {
+                func(slot.mKey, slot.mValue);
+            }
+        }
+    }
+
+private:
+    static constexpr size_t MIN_CAPACITY = 16;
+
+    struct Slot
+    {
+        KEY mKey = KEY();
+        VALUE mValue = VALUE();
+        bool mUsed = false;
+    };
+
+    size_t home(const KEY& key) const
+    {
+        return (size_t)(((U64)HASH()(key) * 0x9E3779B97F4A7C15ULL) >> mShift);
+    }
+
+    size_t next(size_t i) const
+    {
+        return (i + 1) & (mSlots.size() - 1);
+    }
+
+    void rehash(size_t capacity)
+    {
+        std::vector<Slot> old;
+        old.swap(mSlots);
+        mSlots.resize(capacity);
+        mShift = 64;
+        for (size_t c = capacity; c > 1; c >>= 1)
+        {
+            --mShift;
+        }
+        for (Slot& slot : old)
+        {
+            if (slot.mUsed)
+            {
+                size_t i = home(slot.mKey);
+                while (mSlots[i].mUsed)
+                {
+                    i = next(i);
+                }
+                mSlots[i] = std::move(slot);
+            }
+        }
+    }
+
+    std::vector<Slot> mSlots;   // size is zero or a power of two
+    size_t mSize = 0;
+    U32 mShift = 64;            // 64 - log2(mSlots.size())
+};
+
+#endif // LL_LLFLATHASHMAP_H
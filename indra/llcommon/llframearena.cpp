@@ -0,0 +1,146 @@
+/**
+ * @file llframearena.cpp
+ * @brief Linear allocator for render loop data that lives no longer than a frame
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+
+#include "linden_common.h"
+
+#include "llframearena.h"
+
+#include <algorithm>
+#include <mutex>
+
+namespace
+{
+    struct Registry
+    {
+        std::mutex mMutex;
+        std::vector<const std::atomic<size_t>*> mReserved;
+        std::vector<std::atomic<size_t>*> mPeaks;
+    };
+
+    // Leaked on purpose, threads can still exit after static destructors ran
+    Registry& get_registry()
+    {
+        static Registry* registry = new Registry;
+        return *registry;
+    }
+
+    template <typename T>
+    void erase_value(std::vector<T>& vec, T value)
+    {
+        vec.erase(std::remove(vec.begin(), vec.end(), value), vec.end());
+    }
+}
+
+// static
+LLFrameArena& LLFrameArena::get()
+{
+    thread_local LLFrameArena arena;
+    return arena;
+}
+
+LLFrameArena::LLFrameArena()
+{
+    Registry& registry = get_registry();
+    std::lock_guard<std::mutex> lock(registry.mMutex);
+    registry.mReserved.push_back(&mReserved);
+    registry.mPeaks.push_back(&mPeak);
+}
+
+LLFrameArena::~LLFrameArena()
+{
+    Registry& registry = get_registry();
+    std::lock_guard<std::mutex> lock(registry.mMutex);
+    erase_value(registry.mReserved, (const std::atomic<size_t>*)&mReserved);
+    erase_value(registry.mPeaks, &mPeak);
+}
+
+void* LLFrameArena::allocate(size_t bytes, size_t alignment)
+{
+    while (true)
+    {
+        if (mBlock < mBlocks.size())
+        {
+            Block& block = mBlocks[mBlock];
+            uintptr_t start = (uintptr_t)block.mData.get() + mOffset;
+            uintptr_t aligned = (start + alignment - 1) & ~(uintptr_t)(alignment - 1);
+            size_t end = mOffset + (aligned - start) + bytes;
+            if (end <= block.mSize)
+            {
+                mUsed += end - mOffset;
+                mOffset = end;
+                if (mUsed > mPeak.load(std::memory_order_relaxed))
+                {
+                    mPeak.store(mUsed, std::memory_order_relaxed);
+                }
+                return (void*)aligned;
+            }
+
+            // the rest of this block is left unused until the arena rewinds past it
+            mUsed += block.mSize - mOffset;
+            ++mBlock;
+            mOffset = 0;
+            continue;
+        }
+
+        size_t size = llmax(BLOCK_SIZE, bytes + alignment);
+        mBlocks.push_back({ std::unique_ptr<char[]>(new char[size]), size });
+        mReserved.store(mReserved.load(std::memory_order_relaxed) + size, std::memory_order_relaxed);
+    }
+}
+
+void LLFrameArena::endFrame()
+{
+    mBlock = 0;
+    mOffset = 0;
+    mUsed = 0;
+}
+
+// static
+size_t LLFrameArena::getPeakBytes()
+{
+    Registry& registry = get_registry();
+    std::lock_guard<std::mutex> lock(registry.mMutex);
+    size_t bytes = 0;
+    for (std::atomic<size_t>* peak : registry.mPeaks)
+    {
+        bytes += peak->exchange(0, std::memory_order_relaxed);
+    }
+    return bytes;
+}
+
+// static
+size_t LLFrameArena::getReservedBytes()
+{
+    Registry& registry = get_registry();
+    std::lock_guard<std::mutex> lock(registry.mMutex);
+    size_t bytes = 0;
+    for (const std::atomic<size_t>* reserved : registry.mReserved)
+    {
+        bytes += reserved->load(std::memory_order_relaxed);
+    }
+    return bytes;
+}
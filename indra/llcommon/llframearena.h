@@ -0,0 +1,146 @@
+/**
+ * @file llframearena.h
+ * @brief Linear allocator for render loop data that lives no longer than a frame
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+
+#ifndef LL_LLFRAMEARENA_H
+#define LL_LLFRAMEARENA_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Hands out memory by bumping a pointer through blocks that are kept from frame to frame,
+// for the temporary containers of the render loop on the main thread, e.g.
+//
+//     LLFrameArena::Scope scope;
+//     LLFrameVector<LLVector3> points;
+//     ...
+//
+// Nothing is freed on its own: leaving a Scope rewinds the arena to where it was when the
+// scope was entered, and LLAppViewer rewinds it to the start with endFrame() once a frame
+// is done.  Memory must not be used after its scope ended.  The arena is thread_local so
+// a stray use from another thread can't corrupt the main thread's, but only the render
+// loop allocates from it.
+class LL_COMMON_API LLFrameArena
+{
+public:
+    static constexpr size_t BLOCK_SIZE = 256 * 1024;
+
+    // The calling thread's arena
+    static LLFrameArena& get();
+
+    LLFrameArena(const LLFrameArena&) = delete;
+    LLFrameArena& operator=(const LLFrameArena&) = delete;
+
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+    // Rewind to the start once the frame is done
+    void endFrame();
+
+    size_t getUsedBytes() const { return mUsed; }
+
+    class Scope
+    {
+    public:
+        Scope(LLFrameArena& arena = LLFrameArena::get())
+        :   mArena(arena),
+            mBlock(arena.mBlock),
+            mOffset(arena.mOffset),
+            mUsed(arena.mUsed)
+        {}
+
+        ~Scope()
+        {
+            mArena.mBlock = mBlock;
+            mArena.mOffset = mOffset;
+            mArena.mUsed = mUsed;
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        LLFrameArena& mArena;
+        size_t mBlock;
+        size_t mOffset;
+        size_t mUsed;
+    };
+
+    // Sum over all threads of the most each arena held at once since the last call
+    static size_t getPeakBytes();
+    // Sum over all threads of the blocks the arenas keep
+    static size_t getReservedBytes();
+
+private:
+    LLFrameArena();
+    ~LLFrameArena();
+
+    struct Block
+    {
+        std::unique_ptr<char[]> mData;
+        size_t mSize;
+    };
+
+    std::vector<Block> mBlocks;
+    size_t mBlock = 0;      // block being filled
+    size_t mOffset = 0;     // in that block
+    size_t mUsed = 0;       // bytes handed out, with alignment padding
+
+    // only this thread writes them, getPeakBytes() also resets mPeak
+    std::atomic<size_t> mPeak{ 0 };
+    std::atomic<size_t> mReserved{ 0 };
+};
+
+// For the standard containers.  Freeing is left to the scope or frame, a container that
+// grows wastes its old storage until then, reserve() when the size is known.
+template <typename T>
+class LLFrameArenaAllocator
+{
+public:
+    typedef T value_type;
+
+    LLFrameArenaAllocator(): mArena(&LLFrameArena::get()) {}
+    template <typename U>
+    LLFrameArenaAllocator(const LLFrameArenaAllocator<U>& other): mArena(other.mArena) {}
+
+    T* allocate(size_t count) { return (T*)mArena->allocate(count * sizeof(T), alignof(T)); }
+    void deallocate(T*, size_t) {}
+
+    template <typename U>
+    bool operator==(const LLFrameArenaAllocator<U>& other) const { return mArena == other.mArena; }
+    template <typename U>
+    bool operator!=(const LLFrameArenaAllocator<U>& other) const { return mArena != other.mArena; }
+
+private:
+    template <typename U> friend class LLFrameArenaAllocator;
+    LLFrameArena* mArena;
+};
+
+template <typename T>
+using LLFrameVector = std::vector<T, LLFrameArenaAllocator<T> >;
+
+#endif // LL_LLFRAMEARENA_H
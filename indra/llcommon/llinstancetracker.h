@@ -56,6 +56,88 @@ namespace LLInstanceTrackerPrivate
     };
 
     void logerrs(const char* cls, const std::string&, const std::string&, const std::string&);
+
+    /**
+     * The vector a snapshot copies its instances into. When the snapshot is
+     * done the buffer goes back to a per-thread pool for the next snapshot
+     * of the same tracker, so walks repeated every frame stop allocating once
+     * the pool has warmed up.
+     */
+    template <typename ITEM>
+    class RecycledVector
+    {
+    public:
+        typedef std::vector<ITEM> vector_t;
+        typedef typename vector_t::iterator iterator;
+
+        RecycledVector()
+        {
+            std::vector<vector_t>* spares = getSpares();
+            if (spares && ! spares->empty())
+            {
+                mData.swap(spares->back());
+                spares->pop_back();
+            }
+        }
+        RecycledVector(RecycledVector&&) = default;
+        RecycledVector& operator=(RecycledVector&&) = default;
+
+        ~RecycledVector()
+        {
+            std::vector<vector_t>* spares = getSpares();
+            if (spares && mData.capacity() && spares->size() < MAX_SPARES)
+            {
+                // clear() drops our weak_ptrs but keeps the buffer
+                mData.clear();
+                spares->push_back(std::move(mData));
+            }
+        }
+
+        template <typename RANGE>
+        void fill(const RANGE& range)
+        {
+            // not assign(): ITEM may be a pair with a const KEY, which can
+            // be constructed but not assigned
+            mData.reserve(range.size());
+            for (const auto& item : range)
+            {
+                mData.emplace_back(item);
+            }
+        }
+
+        iterator begin() { return mData.begin(); }
+        iterator end()   { return mData.end(); }
+
+    private:
+        // enough for snapshots nested a few levels deep
+        static constexpr size_t MAX_SPARES = 4;
+
+        static std::vector<vector_t>* getSpares()
+        {
+            // Plain pointers rather than a thread_local vector: a snapshot
+            // taken while this thread's thread_locals are being destroyed
+            // must find no pool, not a destroyed one.
+            thread_local std::vector<vector_t>* spares = nullptr;
+            thread_local bool finished = false;
+            if (! spares && ! finished)
+            {
+                struct Owner
+                {
+                    ~Owner()
+                    {
+                        delete spares;
+                        spares = nullptr;
+                        finished = true;
+                    }
+                };
+                thread_local Owner owner;
+                spares = new std::vector<vector_t>();
+            }
+            return spares;
+        }
+
+        vector_t mData;
+    };
 } // namespace LLInstanceTrackerPrivate
 
 /*****************************************************************************
@@ -140,11 +222,11 @@ public:
         }
 
     public:
-        snapshot_of():
+        snapshot_of()
+        {
             // populate our vector with a snapshot of (locked!) InstanceMap
             // note, this assigns pair<KEY, shared_ptr> to pair<KEY, weak_ptr>
-            mData(mLock->mMap.begin(), mLock->mMap.end())
-        {
+            mData.fill(mLock->mMap);
             // release the lock once we've populated mData
             mLock.unlock();
         }
@@ -187,7 +269,7 @@ public:
         std::shared_ptr<LockStatic> mLockp{std::make_shared<LockStatic>()};
         LockStatic& mLock{*mLockp};
 #endif // LL_WINDOWS
-        VectorType mData;
+        LLInstanceTrackerPrivate::RecycledVector<typename VectorType::value_type> mData;
     };
     using snapshot = snapshot_of<T>;
 
@@ -407,11 +489,11 @@ public:
         }
 
     public:
-        snapshot_of():
+        snapshot_of()
+        {
             // populate our vector with a snapshot of (locked!) InstanceSet
             // note, this assigns stored shared_ptrs to weak_ptrs for snapshot
-            mData(mLock->mSet.begin(), mLock->mSet.end())
-        {
+            mData.fill(mLock->mSet);
             // release the lock once we've populated mData
             mLock.unlock();
         }
@@ -451,7 +533,7 @@ public:
         std::shared_ptr<LockStatic> mLockp{std::make_shared<LockStatic>()};
         LockStatic& mLock{*mLockp};
 #endif // LL_WINDOWS
-        VectorType mData;
+        LLInstanceTrackerPrivate::RecycledVector<typename VectorType::value_type> mData;
     };
     using snapshot = snapshot_of<T>;
 
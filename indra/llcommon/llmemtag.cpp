@@ -0,0 +1,155 @@
+/**
+ * @file llmemtag.cpp
+ * @brief Per subsystem accounting of heap use
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llmemtag.h"
+
+#include <algorithm>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    struct ThreadCounters;
+
+    struct Registry
+    {
+        std::mutex mMutex;
+        std::vector<ThreadCounters*> mThreads;
+        S64 mRetired[LLMemTag::MAX_TAGS] = {};      // left behind by threads that exited
+        const LLMemTag* mTags[LLMemTag::MAX_TAGS] = {};
+        std::atomic<U32> mTagCount{ 0 };
+    };
+
+    // Leaked on purpose, threads can still exit after static destructors ran
+    Registry& get_registry()
+    {
+        static Registry* registry = new Registry;
+        return *registry;
+    }
+
+    struct ThreadCounters
+    {
+        std::atomic<S64> mBytes[LLMemTag::MAX_TAGS]{};
+
+        ThreadCounters()
+        {
+            Registry& registry = get_registry();
+            std::lock_guard<std::mutex> lock(registry.mMutex);
+            registry.mThreads.push_back(this);
+        }
+
+        ~ThreadCounters()
+        {
+            Registry& registry = get_registry();
+            std::lock_guard<std::mutex> lock(registry.mMutex);
+            for (U32 i = 0; i < LLMemTag::MAX_TAGS; ++i)
+            {
+                registry.mRetired[i] += mBytes[i].load(std::memory_order_relaxed);
+            }
+            registry.mThreads.erase(std::remove(registry.mThreads.begin(), registry.mThreads.end(), this),
+                                    registry.mThreads.end());
+        }
+    };
+}
+
+LLMemTag::LLMemTag(const char* name)
+:   mName(name)
+{
+    Registry& registry = get_registry();
+    U32 index = registry.mTagCount.fetch_add(1);
+    // too many tags share the last one rather than crash during static initialization
+    llassert(index < MAX_TAGS);
+    mIndex = llmin(index, MAX_TAGS - 1);
+    if (index < MAX_TAGS)
+    {
+        registry.mTags[index] = this;
+    }
+}
+
+S64 LLMemTag::getBytes() const
+{
+    Registry& registry = get_registry();
+    std::lock_guard<std::mutex> lock(registry.mMutex);
+    S64 bytes = registry.mRetired[mIndex];
+    for (ThreadCounters* counters : registry.mThreads)
+    {
+        bytes += counters->mBytes[mIndex].load(std::memory_order_relaxed);
+    }
+    return bytes;
+}
+
+// static
+U32 LLMemTag::getTagCount()
+{
+    return llmin(get_registry().mTagCount.load(), MAX_TAGS);
+}
+
+// static
+const LLMemTag* LLMemTag::getTag(U32 index)
+{
+    return index < getTagCount() ? get_registry().mTags[index] : NULL;
+}
+
+// static
+const LLMemTag* LLMemTag::find(const std::string& name)
+{
+    for (U32 i = 0; i < getTagCount(); ++i)
+    {
+        if (name == getTag(i)->getName())
+        {
+            return getTag(i);
+        }
+    }
+    return NULL;
+}
+
+// static
+void LLMemTag::logUsage(const std::string& reason)
+{
+    std::vector<std::pair<S64, const char*> > usage;
+    for (U32 i = 0; i < getTagCount(); ++i)
+    {
+        const LLMemTag* tag = getTag(i);
+        usage.emplace_back(tag->getBytes(), tag->getName());
+    }
+    std::sort(usage.rbegin(), usage.rend());
+
+    LL_INFOS("Memory") << "Heap use by subsystem (" << reason << "):" << LL_ENDL;
+    for (const auto& entry : usage)
+    {
+        LL_INFOS("Memory") << "    " << entry.second << ": " << entry.first / 1024 << " KB" << LL_ENDL;
+    }
+}
+
+// static
+std::atomic<S64>* LLMemTag::getThreadCounters()
+{
+    thread_local ThreadCounters counters;
+    return counters.mBytes;
+}
@@ -0,0 +1,80 @@
+/**
+ * @file llmemtag.h
+ * @brief Per subsystem accounting of heap use
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLMEMTAG_H
+#define LL_LLMEMTAG_H
+
+#include <atomic>
+#include <string>
+
+// Names a subsystem whose heap use we want to see separately, e.g.
+//
+//     static LLMemTag sImageMemTag("Images");
+//     ...
+//     sImageMemTag.claim(size);     // after allocating
+//     sImageMemTag.disclaim(size);  // after freeing
+//
+// Tags are declared statically, like LLTrace stat handles.  Every thread keeps its own
+// counters, so claim() is a plain add on memory no other thread writes; getBytes() sums
+// all threads.  Memory may be freed on another thread than it was claimed on, only the
+// sum is meaningful.
+class LL_COMMON_API LLMemTag
+{
+public:
+    static constexpr U32 MAX_TAGS = 32;
+
+    LLMemTag(const char* name);
+
+    LLMemTag(const LLMemTag&) = delete;
+    LLMemTag& operator=(const LLMemTag&) = delete;
+
+    void claim(S64 bytes) const
+    {
+        std::atomic<S64>& counter = getThreadCounters()[mIndex];
+        // only this thread writes its counters, other threads only read them
+        counter.store(counter.load(std::memory_order_relaxed) + bytes, std::memory_order_relaxed);
+    }
+    void disclaim(S64 bytes) const { claim(-bytes); }
+
+    const char* getName() const { return mName; }
+    // Bytes currently claimed by all threads together
+    S64 getBytes() const;
+
+    static U32 getTagCount();
+    static const LLMemTag* getTag(U32 index);
+    static const LLMemTag* find(const std::string& name);
+
+    // Log every tag's total, largest first
+    static void logUsage(const std::string& reason);
+
+private:
+    static std::atomic<S64>* getThreadCounters();
+
+    const char* mName;
+    U32 mIndex;
+};
+
+#endif // LL_LLMEMTAG_H
@@ -123,6 +123,9 @@ namespace
         eSSE4_1_Features = 38,
         eSSE4_2_Features = 39,
         eSSE4a_Features = 40,
+        eAVX_Features = 41,
+        eAVX2_Features = 42,
+        eFMA_Features = 43,
     };
 
     const char* cpu_feature_names[] =
@@ -170,6 +173,9 @@ namespace
         "SSE4.1 Instructions",
         "SSE4.2 Instructions",
         "SSE4a Instructions",
+        "AVX Instructions",
+        "AVX2 Instructions",
+        "FMA3 Instructions",
     };
 
     std::string intel_CPUFamilyName(int composed_family)
@@ -283,6 +289,21 @@ public:
         return hasExtension(cpu_feature_names[eSSE4a_Features]);
     }
 
+    bool hasAVX() const
+    {
+        return hasExtension(cpu_feature_names[eAVX_Features]);
+    }
+
+    bool hasAVX2() const
+    {
+        return hasExtension(cpu_feature_names[eAVX2_Features]);
+    }
+
+    bool hasFMA() const
+    {
+        return hasExtension(cpu_feature_names[eFMA_Features]);
+    }
+
     bool hasAltivec() const
     {
         return hasExtension("Altivec");
@@ -572,6 +593,20 @@ private:
                     setExtension(cpu_feature_names[eSSE4_2_Features]);
                 }
 
+                // AVX needs OSXSAVE too, and the OS has to save the YMM
+                // registers on context switches.
+                if ((cpu_info[2] & 0x18000000) == 0x18000000
+                    && (_xgetbv(0) & 0x6) == 0x6)
+                {
+                    setExtension(cpu_feature_names[eAVX_Features]);
+                }
+
+                // FMA works on the YMM registers as well
+                if ((cpu_info[2] & 0x1000) && hasAVX())
+                {
+                    setExtension(cpu_feature_names[eFMA_Features]);
+                }
+
                 unsigned int feature_info = (unsigned int) cpu_info[3];
                 for(unsigned int index = 0, bit = 1; index < eSSE3_Features; ++index, bit <<= 1)
                 {
@@ -581,6 +616,15 @@ private:
                     }
                 }
             }
+            else if (i == 7)
+            {
+                // Leaf 7 has sub-leaves, ask for the first one
+                __cpuidex(cpu_info, 7, 0);
+                if ((cpu_info[1] & 0x20) && hasAVX())
+                {
+                    setExtension(cpu_feature_names[eAVX2_Features]);
+                }
+            }
         }
 
         // Calling __cpuid with 0x80000000 as the InfoType argument
@@ -789,6 +833,29 @@ private:
             // Not supposed to happen?
             setExtension(cpu_feature_names[eSSE4a_Features]);
         }
+
+        if (cpu_features_str.find(" AVX1.0 ") != std::string::npos)
+        {
+            setExtension(cpu_feature_names[eAVX_Features]);
+        }
+
+        if (cpu_features_str.find(" FMA ") != std::string::npos && hasAVX())
+        {
+            setExtension(cpu_feature_names[eFMA_Features]);
+        }
+
+        char leaf7_features[1024];
+        len = sizeof(leaf7_features);
+        memset(leaf7_features, 0, len);
+        sysctlbyname("machdep.cpu.leaf7_features", (void*)leaf7_features, &len, NULL, 0);
+
+        std::string leaf7_features_str(leaf7_features);
+        leaf7_features_str = " " + leaf7_features_str + " ";
+
+        if (leaf7_features_str.find(" AVX2 ") != std::string::npos && hasAVX())
+        {
+            setExtension(cpu_feature_names[eAVX2_Features]);
+        }
     }
 };
 
@@ -922,6 +989,21 @@ private:
         {
             setExtension(cpu_feature_names[eSSE4a_Features]);
         }
+
+        if (flags.find(" avx ") != std::string::npos)
+        {
+            setExtension(cpu_feature_names[eAVX_Features]);
+        }
+
+        if (flags.find(" avx2 ") != std::string::npos)
+        {
+            setExtension(cpu_feature_names[eAVX2_Features]);
+        }
+
+        if (flags.find(" fma ") != std::string::npos)
+        {
+            setExtension(cpu_feature_names[eFMA_Features]);
+        }
     }
 
     std::string getCPUFeatureDescription() const
@@ -985,6 +1067,9 @@ bool LLProcessorInfo::hasSSE3S() const { return mImpl->hasSSE3S(); }
 bool LLProcessorInfo::hasSSE41() const { return mImpl->hasSSE41(); }
 bool LLProcessorInfo::hasSSE42() const { return mImpl->hasSSE42(); }
 bool LLProcessorInfo::hasSSE4a() const { return mImpl->hasSSE4a(); }
+bool LLProcessorInfo::hasAVX() const { return mImpl->hasAVX(); }
+bool LLProcessorInfo::hasAVX2() const { return mImpl->hasAVX2(); }
+bool LLProcessorInfo::hasFMA() const { return mImpl->hasFMA(); }
 bool LLProcessorInfo::hasAltivec() const { return mImpl->hasAltivec(); }
 std::string LLProcessorInfo::getCPUFamilyName() const { return mImpl->getCPUFamilyName(); }
 std::string LLProcessorInfo::getCPUBrandName() const { return mImpl->getCPUBrandName(); }
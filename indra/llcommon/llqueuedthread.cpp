@@ -246,11 +246,17 @@ bool LLQueuedThread::addRequest(QueuedRequest* req)
     unlockData();
 
     llassert(!mDataLock->isSelfLocked());
-    mRequestQueue.post([this, req]() { processRequest(req); });
+    postRequest(req);
 
     return true;
 }
 
+// virtual
+void LLQueuedThread::postRequest(QueuedRequest* req)
+{
+    mRequestQueue.post([this, req]() { processRequest(req); });
+}
+
 // MAIN thread
 bool LLQueuedThread::waitForResult(LLQueuedThread::handle_t handle, bool auto_complete)
 {
@@ -136,6 +136,8 @@ private:
 protected:
     handle_t generateHandle();
     bool addRequest(QueuedRequest* req);
+    // Hand an added request to whatever runs it, by default this thread's queue
+    virtual void postRequest(QueuedRequest* req);
     void processRequest(QueuedRequest* req);
     void incQueue();
 
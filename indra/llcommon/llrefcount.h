@@ -34,7 +34,14 @@ class LLMutex;
 
 //----------------------------------------------------------------------------
 // RefCount objects should generally only be accessed by way of LLPointer<>'s
-// see llthread.h for LLThreadSafeRefCount
+//
+// LLRefCount is a plain, non-atomic count: copying an LLPointer to it costs
+// an increment, not a locked instruction.  Use it for types that are only
+// ever referenced from one thread, which is most of the viewer's scene
+// (LLViewerObject, LLDrawable, LLVOCacheEntry...).  Types whose pointers are
+// copied or released on several threads must derive from
+// LLThreadSafeRefCount (below) instead, at the cost of an atomic operation
+// per LLPointer copy.
 //----------------------------------------------------------------------------
 
 //nonsense but recognizable value for freed LLRefCount (aids in debugging)
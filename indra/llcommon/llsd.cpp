@@ -34,9 +34,11 @@
 #include "llerror.h"
 #include "../llmath/llmath.h"
 #include "llformat.h"
+#include "llmemory.h"
 #include "llsdserialize.h"
 #include "stringize.h"
 
+#include <atomic>
 #include <limits>
 
 // Defend against a caller forcibly passing a negative number into an unsigned
@@ -186,6 +188,10 @@ public:
 
     static U32 sAllocationCount;
     static U32 sOutstandingCount;
+
+    // Pooled inside an LLSD::PoolScope, see below
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr);
 };
 
 #ifdef NAME_UNNAMED_NAMESPACE
@@ -746,6 +752,126 @@ namespace
     }
 }
 
+#ifdef NAME_UNNAMED_NAMESPACE
+namespace LLSDUnnamedNamespace
+#else
+namespace
+#endif
+{
+    // Impl blocks carry a header holding their pool size class, 0 for heap
+    // blocks, so that a tree can be destroyed on any thread whatever mode it
+    // was built in.  A block freed on another thread simply joins that
+    // thread's free list.
+    constexpr size_t IMPL_HEADER_SIZE = 16;    // keeps the default new alignment
+    constexpr size_t IMPL_POOL_GRANULARITY = 16;
+    constexpr size_t IMPL_POOL_CLASSES = 10;   // blocks up to 160 bytes, headers included
+    constexpr size_t IMPL_POOL_SLAB_SIZE = 64 * 1024;
+
+    class ImplPool
+    {
+    public:
+        void* allocate(size_t size_class)
+        {
+            if (FreeBlock* block = mFreeLists[size_class])
+            {
+                mFreeLists[size_class] = block->mNext;
+                return block;
+            }
+
+            size_t bytes = size_class * IMPL_POOL_GRANULARITY;
+            if ((size_t)(mEnd - mNext) < bytes)
+            {
+                // the tail of the previous slab is abandoned
+                mNext = (U8*)ll_aligned_malloc_16(IMPL_POOL_SLAB_SIZE);
+                mEnd = mNext + IMPL_POOL_SLAB_SIZE;
+            }
+            void* block = mNext;
+            mNext += bytes;
+            return block;
+        }
+
+        void free(void* ptr, size_t size_class)
+        {
+            FreeBlock* block = (FreeBlock*)ptr;
+            block->mNext = mFreeLists[size_class];
+            mFreeLists[size_class] = block;
+        }
+
+    private:
+        struct FreeBlock
+        {
+            FreeBlock* mNext;
+        };
+
+        FreeBlock* mFreeLists[IMPL_POOL_CLASSES + 1] = {};
+        U8* mNext = nullptr;
+        U8* mEnd = nullptr;
+    };
+
+    ImplPool& get_impl_pool()
+    {
+        // never destroyed, blocks from a thread can be freed after it exited
+        static thread_local ImplPool* pool = new ImplPool;
+        return *pool;
+    }
+
+    thread_local S32 sPoolScopeDepth = 0;
+    std::atomic<bool> sPoolingEnabled { true };
+}
+
+LLSD::PoolScope::PoolScope()
+{
+    ++sPoolScopeDepth;
+}
+
+LLSD::PoolScope::~PoolScope()
+{
+    --sPoolScopeDepth;
+}
+
+// static
+void LLSD::setPoolingEnabled(bool enabled)
+{
+    sPoolingEnabled = enabled;
+}
+
+// static
+void* LLSD::Impl::operator new(size_t size)
+{
+    size_t size_class = (size + IMPL_HEADER_SIZE + IMPL_POOL_GRANULARITY - 1) / IMPL_POOL_GRANULARITY;
+    U8* block;
+    if (sPoolScopeDepth > 0 && size_class <= IMPL_POOL_CLASSES && sPoolingEnabled.load(std::memory_order_relaxed))
+    {
+        block = (U8*)get_impl_pool().allocate(size_class);
+    }
+    else
+    {
+        size_class = 0;
+        block = (U8*)::operator new(size + IMPL_HEADER_SIZE);
+    }
+    *(size_t*)block = size_class;
+    return block + IMPL_HEADER_SIZE;
+}
+
+// static
+void LLSD::Impl::operator delete(void* ptr)
+{
+    if (!ptr)
+    {
+        return;
+    }
+    U8* block = (U8*)ptr - IMPL_HEADER_SIZE;
+    size_t size_class = *(size_t*)block;
+    if (size_class)
+    {
+        get_impl_pool().free(block, size_class);
+    }
+    else
+    {
+        ::operator delete(block);
+    }
+}
+
 LLSD::Impl::Impl()
     : mUseCount(0)
 {
@@ -420,6 +420,11 @@ public:
         bool isBinary() const       { return type() == TypeBinary; }
         bool isMap() const          { return type() == TypeMap; }
         bool isArray() const        { return type() == TypeArray; }
+
+        /// True if this and other share one value, as a copy does until
+        /// either of them is modified.  Unlike llsd_equals() this doesn't
+        /// look at the contents, so it's cheap enough to detect changes.
+        bool sharesValueWith(const LLSD& other) const { return impl == other.impl; }
     //@}
 
     /** @name Automatic Cast Protection
@@ -463,6 +468,29 @@ private:
 public:
 
     static std::string      typeString(Type type);      // Return human-readable type as a string
+
+    /** @name Pooled Allocation */
+    //@{
+        /**
+         * While a PoolScope lives on a thread, the values created on that
+         * thread come from per thread free lists instead of the heap, so
+         * building a large tree costs pointer bumps and destroying it costs
+         * list pushes.  The parsers in LLSDSerialize open one around each
+         * parse.  Values may outlive the scope and be destroyed on any
+         * thread; pooled memory is kept for reuse, not returned.
+         */
+        class PoolScope
+        {
+        public:
+            PoolScope();
+            ~PoolScope();
+            PoolScope(const PoolScope&) = delete;
+            PoolScope& operator=(const PoolScope&) = delete;
+        };
+
+        /// Process wide switch for PoolScope, on by default
+        static void setPoolingEnabled(bool enabled);
+    //@}
 };
 
 struct llsd_select_bool
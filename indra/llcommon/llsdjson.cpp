@@ -36,6 +36,9 @@
 #include "../llmath/llmath.h"
 
 #include <boost/json/src.hpp>
+#include <boost/json/basic_parser_impl.hpp>
+
+#include <istream>
 
 //=========================================================================
 LLSD LlsdFromJson(const boost::json::value& val)
@@ -78,6 +81,182 @@ LLSD LlsdFromJson(const boost::json::value& val)
     return result;
 }
 
+//=========================================================================
+namespace
+{
+    // boost::json::basic_parser handler building the LLSD as the text is
+    // parsed, so large responses skip the boost::json::value DOM and the
+    // second pass converting it.
+    class LLSDJsonHandler
+    {
+    public:
+        constexpr static std::size_t max_object_size = std::size_t(-1);
+        constexpr static std::size_t max_array_size = std::size_t(-1);
+        constexpr static std::size_t max_key_size = std::size_t(-1);
+        constexpr static std::size_t max_string_size = std::size_t(-1);
+
+        typedef boost::json::error_code error_code;
+        typedef boost::json::string_view string_view;
+
+        LLSD mResult;
+
+        bool on_document_begin(error_code&) { return true; }
+        bool on_document_end(error_code&) { return true; }
+
+        bool on_object_begin(error_code&)
+        {
+            LLSD* value = beginValue();
+            *value = LLSD::emptyMap();
+            mStack.push_back(value);
+            return true;
+        }
+
+        bool on_object_end(std::size_t, error_code&)
+        {
+            mStack.pop_back();
+            return true;
+        }
+
+        bool on_array_begin(error_code&)
+        {
+            LLSD* value = beginValue();
+            *value = LLSD::emptyArray();
+            mStack.push_back(value);
+            return true;
+        }
+
+        bool on_array_end(std::size_t, error_code&)
+        {
+            mStack.pop_back();
+            return true;
+        }
+
+        bool on_key_part(string_view s, std::size_t, error_code&)
+        {
+            mKey.append(s.data(), s.size());
+            return true;
+        }
+
+        bool on_key(string_view s, std::size_t, error_code&)
+        {
+            mKey.append(s.data(), s.size());
+            return true;
+        }
+
+        bool on_string_part(string_view s, std::size_t, error_code&)
+        {
+            mString.append(s.data(), s.size());
+            return true;
+        }
+
+        bool on_string(string_view s, std::size_t, error_code&)
+        {
+            mString.append(s.data(), s.size());
+            *beginValue() = std::move(mString);
+            mString.clear();
+            return true;
+        }
+
+        bool on_number_part(string_view, error_code&) { return true; }
+
+        bool on_int64(std::int64_t i, string_view, error_code&)
+        {
+            *beginValue() = LLSD(i);
+            return true;
+        }
+
+        bool on_uint64(std::uint64_t u, string_view, error_code&)
+        {
+            *beginValue() = LLSD((std::int64_t)u);
+            return true;
+        }
+
+        bool on_double(double d, string_view, error_code&)
+        {
+            *beginValue() = LLSD(d);
+            return true;
+        }
+
+        bool on_bool(bool b, error_code&)
+        {
+            *beginValue() = LLSD(b);
+            return true;
+        }
+
+        bool on_null(error_code&)
+        {
+            beginValue();
+            return true;
+        }
+
+        bool on_comment_part(string_view, error_code&) { return true; }
+        bool on_comment(string_view, error_code&) { return true; }
+
+    private:
+        // Slot for the next value, in the innermost open object or array
+        LLSD* beginValue()
+        {
+            if (mStack.empty())
+            {
+                return &mResult;
+            }
+            LLSD& parent = *mStack.back();
+            if (parent.isMap())
+            {
+                LLSD* value = &parent[mKey];
+                mKey.clear();
+                return value;
+            }
+            parent.append(LLSD());
+            return &parent[parent.size() - 1];
+        }
+
+        std::vector<LLSD*> mStack;
+        std::string mKey;
+        std::string mString;
+    };
+
+    typedef boost::json::basic_parser<LLSDJsonHandler> json_llsd_parser;
+
+    LLSD finish_json_parse(json_llsd_parser& parser, boost::json::error_code& ec)
+    {
+        if (!ec)
+        {
+            parser.write_some(false, nullptr, 0, ec);
+        }
+        if (ec)
+        {
+            return LLSD();
+        }
+        return std::move(parser.handler().mResult);
+    }
+}
+
+LLSD LlsdFromJson(std::istream& stream, boost::json::error_code& ec)
+{
+    ec = {};
+    json_llsd_parser parser{ boost::json::parse_options() };
+    char buffer[8192];
+    while (!ec && stream)
+    {
+        stream.read(buffer, sizeof(buffer));
+        std::size_t count = (std::size_t)stream.gcount();
+        if (count)
+        {
+            parser.write_some(true, buffer, count, ec);
+        }
+    }
+    return finish_json_parse(parser, ec);
+}
+
+LLSD LlsdFromJson(std::string_view json, boost::json::error_code& ec)
+{
+    ec = {};
+    json_llsd_parser parser{ boost::json::parse_options() };
+    parser.write_some(true, json.data(), json.size(), ec);
+    return finish_json_parse(parser, ec);
+}
+
 //=========================================================================
 boost::json::value LlsdToJson(const LLSD &val)
 {
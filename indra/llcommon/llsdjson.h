@@ -27,8 +27,10 @@
 #ifndef LL_LLSDJSON_H
 #define LL_LLSDJSON_H
 
+#include <iosfwd>
 #include <map>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "stdtypes.h"
@@ -55,6 +57,12 @@
 /// Order is preserved for an array but not for objects.
 LLSD LlsdFromJson(const boost::json::value &val);
 
+/// Parse JSON text straight into LLSD, with the conversions above, without
+/// building a boost::json::value first.  On failure ec is set and the result
+/// is undefined.
+LLSD LlsdFromJson(std::istream& stream, boost::json::error_code& ec);
+LLSD LlsdFromJson(std::string_view json, boost::json::error_code& ec);
+
 /// Convert an LLSD object into Parsed JSON object maintaining member names and
 /// array indexs.
 ///
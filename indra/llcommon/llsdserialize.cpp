@@ -376,11 +376,115 @@ static const char BINARY_TRUE_SERIAL = '1';
 static const char BINARY_FALSE_SERIAL = '0';
 
 
+/**
+ * LLSDSubtreeListener
+ */
+LLSDSubtreeListener::LLSDSubtreeListener(S32 depth, callback_t callback)
+    : mDepth(depth), mCallback(callback), mCurrentDepth(0)
+{
+}
+
+LLSD* LLSDSubtreeListener::beginValue()
+{
+    // array elements are never preceded by a key
+    std::string key;
+    key.swap(mKey);
+    if(mCurrentDepth < mDepth)
+    {
+        return NULL;
+    }
+    if(mCurrentDepth == mDepth)
+    {
+        mSubtreeKey.swap(key);
+        mSubtree.clear();
+        return &mSubtree;
+    }
+    LLSD& parent = *mStack.back();
+    if(parent.isMap())
+    {
+        return &parent[key];
+    }
+    parent.append(LLSD());
+    return &parent[parent.size() - 1];
+}
+
+void LLSDSubtreeListener::endContainer()
+{
+    --mCurrentDepth;
+    if(mCurrentDepth >= mDepth)
+    {
+        mStack.pop_back();
+        if(mCurrentDepth == mDepth)
+        {
+            mCallback(mSubtreeKey, mSubtree);
+            mSubtree.clear();
+        }
+    }
+}
+
+// virtual
+void LLSDSubtreeListener::beginMap()
+{
+    LLSD* slot = beginValue();
+    ++mCurrentDepth;
+    if(slot)
+    {
+        *slot = LLSD::emptyMap();
+        mStack.push_back(slot);
+    }
+}
+
+// virtual
+void LLSDSubtreeListener::key(const std::string& key)
+{
+    mKey = key;
+}
+
+// virtual
+void LLSDSubtreeListener::endMap()
+{
+    endContainer();
+}
+
+// virtual
+void LLSDSubtreeListener::beginArray()
+{
+    LLSD* slot = beginValue();
+    ++mCurrentDepth;
+    if(slot)
+    {
+        *slot = LLSD::emptyArray();
+        mStack.push_back(slot);
+    }
+}
+
+// virtual
+void LLSDSubtreeListener::endArray()
+{
+    endContainer();
+}
+
+// virtual
+void LLSDSubtreeListener::value(const LLSD& value)
+{
+    LLSD* slot = beginValue();
+    if(slot)
+    {
+        *slot = value;
+        if(mCurrentDepth == mDepth)
+        {
+            mCallback(mSubtreeKey, mSubtree);
+            mSubtree.clear();
+        }
+    }
+}
+
+
 /**
  * LLSDParser
  */
 LLSDParser::LLSDParser()
-    : mCheckLimits(true), mMaxBytesLeft(0), mParseLines(false)
+    : mCheckLimits(true), mMaxBytesLeft(0), mParseLines(false), mListener(NULL)
 {
 }
 
@@ -392,6 +496,7 @@ S32 LLSDParser::parse(std::istream& istr, LLSD& data, llssize max_bytes, S32 max
 {
     mCheckLimits = LLSDSerialize::SIZE_UNLIMITED != max_bytes;
     mMaxBytesLeft = max_bytes;
+    LLSD::PoolScope pool_scope;
     return doParse(istr, data, max_depth);
 }
 
@@ -401,9 +506,29 @@ S32 LLSDParser::parseLines(std::istream& istr, LLSD& data)
 {
     mCheckLimits = false;
     mParseLines = true;
+    LLSD::PoolScope pool_scope;
     return doParse(istr, data);
 }
 
+S32 LLSDParser::parse(std::istream& istr, LLSDParseListener& listener, llssize max_bytes, S32 max_depth)
+{
+    // only empty containers end up in data
+    LLSD data;
+    mListener = &listener;
+    S32 parse_count = parse(istr, data, max_bytes, max_depth);
+    mListener = NULL;
+    return parse_count;
+}
+
+S32 LLSDParser::parseLines(std::istream& istr, LLSDParseListener& listener)
+{
+    LLSD data;
+    mListener = &listener;
+    S32 parse_count = parseLines(istr, data);
+    mListener = NULL;
+    return parse_count;
+}
+
 
 int LLSDParser::get(std::istream& istr) const
 {
@@ -731,6 +856,10 @@ S32 LLSDNotationParser::doParse(std::istream& istr, LLSD& data, S32 max_depth) c
     {
         data.clear();
     }
+    else if(mListener && !data.isMap() && !data.isArray())
+    {
+        mListener->value(data);
+    }
     return parse_count;
 }
 
@@ -743,6 +872,10 @@ S32 LLSDNotationParser::parseMap(std::istream& istr, LLSD& map, S32 max_depth) c
     char c = get(istr);
     if(c == '{')
     {
+        if(mListener)
+        {
+            mListener->beginMap();
+        }
         // eat commas, white
         bool found_name = false;
         std::string name;
@@ -769,6 +902,10 @@ S32 LLSDNotationParser::parseMap(std::istream& istr, LLSD& map, S32 max_depth) c
                     continue;
                 }
                 putback(istr, c);
+                if(mListener)
+                {
+                    mListener->key(name);
+                }
                 LLSD child;
                 S32 count = doParse(istr, child, max_depth);
                 if(count > 0)
@@ -776,7 +913,10 @@ S32 LLSDNotationParser::parseMap(std::istream& istr, LLSD& map, S32 max_depth) c
                     // There must be a value for every key, thus
                     // child_count must be greater than 0.
                     parse_count += count;
-                    map.insert(name, child);
+                    if(!mListener)
+                    {
+                        map.insert(name, child);
+                    }
                 }
                 else
                 {
@@ -791,6 +931,10 @@ S32 LLSDNotationParser::parseMap(std::istream& istr, LLSD& map, S32 max_depth) c
             map.clear();
             return PARSE_FAILURE;
         }
+        if(mListener)
+        {
+            mListener->endMap();
+        }
     }
     return parse_count;
 }
@@ -804,6 +948,10 @@ S32 LLSDNotationParser::parseArray(std::istream& istr, LLSD& array, S32 max_dept
     char c = get(istr);
     if(c == '[')
     {
+        if(mListener)
+        {
+            mListener->beginArray();
+        }
         // eat commas, white
         c = get(istr);
         while((c != ']') && istr.good())
@@ -823,7 +971,10 @@ S32 LLSDNotationParser::parseArray(std::istream& istr, LLSD& array, S32 max_dept
             else
             {
                 parse_count += count;
-                array.append(child);
+                if(!mListener)
+                {
+                    array.append(child);
+                }
             }
             c = get(istr);
         }
@@ -831,6 +982,10 @@ S32 LLSDNotationParser::parseArray(std::istream& istr, LLSD& array, S32 max_dept
         {
             return PARSE_FAILURE;
         }
+        if(mListener)
+        {
+            mListener->endArray();
+        }
     }
     return parse_count;
 }
@@ -1180,12 +1335,20 @@ S32 LLSDBinaryParser::doParse(std::istream& istr, LLSD& data, S32 max_depth) con
     {
         data.clear();
     }
+    else if(mListener && !data.isMap() && !data.isArray())
+    {
+        mListener->value(data);
+    }
     return parse_count;
 }
 
 S32 LLSDBinaryParser::parseMap(std::istream& istr, LLSD& map, S32 max_depth) const
 {
     map = LLSD::emptyMap();
+    if(mListener)
+    {
+        mListener->beginMap();
+    }
     U32 value_nbo = 0;
     read(istr, (char*)&value_nbo, sizeof(U32));      /*Flawfinder: ignore*/
     S32 size = (S32)ntohl(value_nbo);
@@ -1212,6 +1375,10 @@ S32 LLSDBinaryParser::parseMap(std::istream& istr, LLSD& map, S32 max_depth) con
             break;
         }
         }
+        if(mListener)
+        {
+            mListener->key(name);
+        }
         LLSD child;
         S32 child_count = doParse(istr, child, max_depth);
         if(child_count > 0)
@@ -1219,7 +1386,10 @@ S32 LLSDBinaryParser::parseMap(std::istream& istr, LLSD& map, S32 max_depth) con
             // There must be a value for every key, thus child_count
             // must be greater than 0.
             parse_count += child_count;
-            map.insert(name, child);
+            if(!mListener)
+            {
+                map.insert(name, child);
+            }
         }
         else
         {
@@ -1234,12 +1404,20 @@ S32 LLSDBinaryParser::parseMap(std::istream& istr, LLSD& map, S32 max_depth) con
         // as were said to be there.
         return PARSE_FAILURE;
     }
+    if(mListener)
+    {
+        mListener->endMap();
+    }
     return parse_count;
 }
 
 S32 LLSDBinaryParser::parseArray(std::istream& istr, LLSD& array, S32 max_depth) const
 {
     array = LLSD::emptyArray();
+    if(mListener)
+    {
+        mListener->beginArray();
+    }
     U32 value_nbo = 0;
     read(istr, (char*)&value_nbo, sizeof(U32));      /*Flawfinder: ignore*/
     S32 size = (S32)ntohl(value_nbo);
@@ -1261,7 +1439,10 @@ S32 LLSDBinaryParser::parseArray(std::istream& istr, LLSD& array, S32 max_depth)
         if(child_count)
         {
             parse_count += child_count;
-            array.append(child);
+            if(!mListener)
+            {
+                array.append(child);
+            }
         }
         ++count;
         c = istr.peek();
@@ -1273,6 +1454,10 @@ S32 LLSDBinaryParser::parseArray(std::istream& istr, LLSD& array, S32 max_depth)
         // as were said to be there.
         return PARSE_FAILURE;
     }
+    if(mListener)
+    {
+        mListener->endArray();
+    }
     return parse_count;
 }
 
@@ -1280,18 +1465,16 @@ bool LLSDBinaryParser::parseString(
     std::istream& istr,
     std::string& value) const
 {
-    // *FIX: This is memory inefficient.
     U32 value_nbo = 0;
     read(istr, (char*)&value_nbo, sizeof(U32));      /*Flawfinder: ignore*/
     S32 size = (S32)ntohl(value_nbo);
     if(mCheckLimits && (size > mMaxBytesLeft)) return false;
     if(size < 0) return false;
-    std::vector<char> buf;
+    value.resize(size);
     if(size)
     {
-        buf.resize(size);
-        account(fullread(istr, &buf[0], size));
-        value.assign(buf.begin(), buf.end());
+        // read straight into the string
+        account(fullread(istr, &value[0], size));
     }
     return true;
 }
@@ -1540,106 +1723,125 @@ LLSDBinaryFormatter::~LLSDBinaryFormatter()
 // virtual
 S32 LLSDBinaryFormatter::format_impl(const LLSD& data, std::ostream& ostr,
                                      EFormatterOptions options, U32 level) const
+{
+    std::string buffer;
+    S32 format_count = formatBuffer(data, buffer);
+    ostr.write(buffer.data(), buffer.size());
+    return format_count;
+}
+
+namespace
+{
+    inline void append_bytes(std::string& buffer, const void* data, size_t size)
+    {
+        buffer.append((const char*)data, size);
+    }
+
+    inline void append_size(std::string& buffer, size_t size)
+    {
+        U32 size_nbo = htonl(static_cast<u_long>(size));
+        append_bytes(buffer, &size_nbo, sizeof(U32));
+    }
+}
+
+S32 LLSDBinaryFormatter::formatBuffer(const LLSD& data, std::string& buffer) const
 {
     S32 format_count = 1;
     switch(data.type())
     {
     case LLSD::TypeMap:
     {
-        ostr.put('{');
-        U32 size_nbo = htonl(static_cast<u_long>(data.size()));
-        ostr.write((const char*)(&size_nbo), sizeof(U32));
+        buffer.push_back('{');
+        append_size(buffer, data.size());
         LLSD::map_const_iterator iter = data.beginMap();
         LLSD::map_const_iterator end = data.endMap();
         for(; iter != end; ++iter)
         {
-            ostr.put('k');
-            formatString((*iter).first, ostr);
-            format_count += format_impl((*iter).second, ostr, options, level+1);
+            buffer.push_back('k');
+            formatString((*iter).first, buffer);
+            format_count += formatBuffer((*iter).second, buffer);
         }
-        ostr.put('}');
+        buffer.push_back('}');
         break;
     }
 
     case LLSD::TypeArray:
     {
-        ostr.put('[');
-        U32 size_nbo = htonl(static_cast<u_long>(data.size()));
-        ostr.write((const char*)(&size_nbo), sizeof(U32));
+        buffer.push_back('[');
+        append_size(buffer, data.size());
         LLSD::array_const_iterator iter = data.beginArray();
         LLSD::array_const_iterator end = data.endArray();
         for(; iter != end; ++iter)
         {
-            format_count += format_impl(*iter, ostr, options, level+1);
+            format_count += formatBuffer(*iter, buffer);
         }
-        ostr.put(']');
+        buffer.push_back(']');
         break;
     }
 
     case LLSD::TypeUndefined:
-        ostr.put('!');
+        buffer.push_back('!');
         break;
 
     case LLSD::TypeBoolean:
-        if(data.asBoolean()) ostr.put(BINARY_TRUE_SERIAL);
-        else ostr.put(BINARY_FALSE_SERIAL);
+        if(data.asBoolean()) buffer.push_back(BINARY_TRUE_SERIAL);
+        else buffer.push_back(BINARY_FALSE_SERIAL);
         break;
 
     case LLSD::TypeInteger:
     {
-        ostr.put('i');
+        buffer.push_back('i');
         U32 value_nbo = htonl(data.asInteger());
-        ostr.write((const char*)(&value_nbo), sizeof(U32));
+        append_bytes(buffer, &value_nbo, sizeof(U32));
         break;
     }
 
     case LLSD::TypeReal:
     {
-        ostr.put('r');
+        buffer.push_back('r');
         F64 value_nbo = ll_htond(data.asReal());
-        ostr.write((const char*)(&value_nbo), sizeof(F64));
+        append_bytes(buffer, &value_nbo, sizeof(F64));
         break;
     }
 
     case LLSD::TypeUUID:
     {
-        ostr.put('u');
+        buffer.push_back('u');
         LLUUID temp = data.asUUID();
-        ostr.write((const char*)(&(temp.mData)), UUID_BYTES);
+        append_bytes(buffer, temp.mData, UUID_BYTES);
         break;
     }
 
     case LLSD::TypeString:
-        ostr.put('s');
-        formatString(data.asStringRef(), ostr);
+        buffer.push_back('s');
+        formatString(data.asStringRef(), buffer);
         break;
 
     case LLSD::TypeDate:
     {
-        ostr.put('d');
+        buffer.push_back('d');
         F64 value = data.asReal();
-        ostr.write((const char*)(&value), sizeof(F64));
+        append_bytes(buffer, &value, sizeof(F64));
         break;
     }
 
     case LLSD::TypeURI:
-        ostr.put('l');
-        formatString(data.asString(), ostr);
+        buffer.push_back('l');
+        formatString(data.asString(), buffer);
         break;
 
     case LLSD::TypeBinary:
     {
-        ostr.put('b');
-        const std::vector<U8>& buffer = data.asBinary();
-        U32 size_nbo = htonl(static_cast<u_long>(buffer.size()));
-        ostr.write((const char*)(&size_nbo), sizeof(U32));
-        if(buffer.size()) ostr.write((const char*)&buffer[0], buffer.size());
+        buffer.push_back('b');
+        const std::vector<U8>& binary = data.asBinary();
+        append_size(buffer, binary.size());
+        if(binary.size()) append_bytes(buffer, binary.data(), binary.size());
         break;
     }
 
     default:
         // *NOTE: This should never happen.
-        ostr.put('!');
+        buffer.push_back('!');
         break;
     }
     return format_count;
@@ -1647,11 +1849,10 @@ S32 LLSDBinaryFormatter::format_impl(const LLSD& data, std::ostream& ostr,
 
 void LLSDBinaryFormatter::formatString(
     const std::string& string,
-    std::ostream& ostr) const
+    std::string& buffer) const
 {
-    U32 size_nbo = htonl(static_cast<u_long>(string.size()));
-    ostr.write((const char*)(&size_nbo), sizeof(U32));
-    ostr.write(string.c_str(), string.size());
+    append_size(buffer, string.size());
+    buffer.append(string);
 }
 
 /**
@@ -1807,15 +2008,13 @@ llssize deserialize_string_raw(
     {
         // We probably have a valid raw string. determine
         // the size, and read it.
-        // *FIX: This is memory inefficient.
         auto len = strtol(buf + 1, NULL, 0);
         if((max_bytes>0)&&(len>max_bytes)) return LLSDParser::PARSE_FAILURE;
-        std::vector<char> buf;
+        if(len < 0) return LLSDParser::PARSE_FAILURE;
+        value.resize(len);
         if(len)
         {
-            buf.resize(len);
-            count += fullread(istr, (char *)&buf[0], len);
-            value.assign(buf.begin(), buf.end());
+            count += fullread(istr, &value[0], len);
         }
         c = istr.get();
         ++count;
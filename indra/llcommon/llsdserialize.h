@@ -34,6 +34,70 @@
 #include "llrefcount.h"
 #include "llsd.h"
 
+#include <functional>
+#include <vector>
+
+/**
+ * @class LLSDParseListener
+ * @brief Receives the contents of a stream as it is parsed.
+ *
+ * Passed to LLSDParser::parse() instead of an LLSD, so that very large
+ * documents (AIS folder listings, search results) can be consumed one
+ * element at a time without materializing the whole tree.  Every map
+ * member is announced by key() before its value; scalars arrive through
+ * value().  The defaults ignore everything.
+ */
+class LL_COMMON_API LLSDParseListener
+{
+public:
+    virtual ~LLSDParseListener() {}
+
+    virtual void beginMap() {}
+    virtual void key(const std::string& key) {}
+    virtual void endMap() {}
+    virtual void beginArray() {}
+    virtual void endArray() {}
+    virtual void value(const LLSD& value) {}
+};
+
+/**
+ * @class LLSDSubtreeListener
+ * @brief Assembles each value found at one depth and hands it on.
+ *
+ * The root value is at depth 0, its members or elements at depth 1 and
+ * so on.  Each value at the requested depth is built into an LLSD, passed
+ * to the callback with its map key (empty for array elements) and then
+ * dropped, so only one item is held at a time.  Shallower containers are
+ * never built.
+ */
+class LL_COMMON_API LLSDSubtreeListener : public LLSDParseListener
+{
+public:
+    typedef std::function<void(const std::string& key, const LLSD& value)> callback_t;
+
+    LLSDSubtreeListener(S32 depth, callback_t callback);
+
+    virtual void beginMap();
+    virtual void key(const std::string& key);
+    virtual void endMap();
+    virtual void beginArray();
+    virtual void endArray();
+    virtual void value(const LLSD& value);
+
+private:
+    // Slot for the next value inside the subtree, or nullptr above it
+    LLSD* beginValue();
+    void endContainer();
+
+    const S32 mDepth;
+    callback_t mCallback;
+    S32 mCurrentDepth;
+    std::string mKey;               // last key seen at any depth
+    std::string mSubtreeKey;        // key of the subtree being built
+    LLSD mSubtree;
+    std::vector<LLSD*> mStack;      // open containers inside mSubtree
+};
+
 /**
  * @class LLSDParser
  * @brief Abstract base class for LLSD parsers.
@@ -79,11 +143,21 @@ public:
      */
     S32 parse(std::istream& istr, LLSD& data, llssize max_bytes, S32 max_depth = -1);
 
+    /**
+     * @brief Parse a stream, reporting its contents to a listener.
+     *
+     * Same as the above, but nothing is kept: containers are announced
+     * as they open and close and values as they are read.  On failure
+     * the listener may have seen part of the document.
+     */
+    S32 parse(std::istream& istr, LLSDParseListener& listener, llssize max_bytes, S32 max_depth = -1);
+
     /** Like parse(), but uses a different call (istream.getline()) to read by lines
      *  This API is better suited for XML, where the parse cannot tell
      *  where the document actually ends.
      */
     S32 parseLines(std::istream& istr, LLSD& data);
+    S32 parseLines(std::istream& istr, LLSDParseListener& listener);
 
     /**
      * @brief Resets the parser so parse() or parseLines() can be called again for another <llsd> chunk.
@@ -211,6 +285,14 @@ protected:
      * @brief Use line-based reading to get text
      */
     bool mParseLines;
+
+    /**
+     * @brief Receives the contents instead of data when set.
+     *
+     * Containers are still created in data, but nothing is added to
+     * them.
+     */
+    LLSDParseListener* mListener;
 };
 
 /**
@@ -651,15 +733,26 @@ protected:
     S32 format_impl(const LLSD& data, std::ostream& ostr, EFormatterOptions options,
                     U32 level) const override;
 
+    /**
+     * @brief Appends the serialization of data to buffer.
+     *
+     * format_impl() hands the stream a whole tree in one write, per
+     * value stream calls cost far more than the copying.
+     * @param data The data to write.
+     * @param buffer The destination buffer.
+     * @return Returns The number of LLSD objects formatted out
+     */
+    S32 formatBuffer(const LLSD& data, std::string& buffer) const;
+
     /**
      * @brief Helper method to serialize strings
      *
      * This method serializes a network byte order size and the raw
      * string contents.
      * @param string The string to write.
-     * @param ostr The destination stream for the data.
+     * @param buffer The destination buffer.
      */
-    void formatString(const std::string& string, std::ostream& ostr) const;
+    void formatString(const std::string& string, std::string& buffer) const;
 };
 
 
@@ -274,6 +274,8 @@ public:
 
     void reset();
 
+    void setListener(LLSDParseListener* listener) { mListener = listener; }
+
 private:
     void startElementHandler(const XML_Char* name, const XML_Char** attributes);
     void endElementHandler(const XML_Char* name);
@@ -288,6 +290,9 @@ private:
 
     void startSkipping();
 
+    // Holds the value of an element in listener mode
+    LLSD* pushListenerValue();
+
     enum Element {
         ELEMENT_LLSD,
         ELEMENT_UNDEF,
@@ -328,11 +333,14 @@ private:
 
     std::string mCurrentKey;        // Current XML <tag>
     std::string mCurrentContent;    // String data between <tag> and </tag>
+
+    LLSDParseListener* mListener;   // reported to instead of building mResult
+    std::deque<LLSD> mListenerValues;
 };
 
 
 LLSDXMLParser::Impl::Impl(bool emit_errors)
-    : mEmitErrors(emit_errors)
+    : mEmitErrors(emit_errors), mListener(NULL)
 {
     mParser = XML_ParserCreate(NULL);
     reset();
@@ -528,6 +536,7 @@ void LLSDXMLParser::Impl::reset()
     mGracefullStop = false;
 
     mStack.clear();
+    mListenerValues.clear();
     while( !mStackElements.empty() )
         mStackElements.pop();
 
@@ -542,6 +551,12 @@ void LLSDXMLParser::Impl::reset()
 }
 
 
+LLSD* LLSDXMLParser::Impl::pushListenerValue()
+{
+    mListenerValues.emplace_back();
+    return &mListenerValues.back();
+}
+
 void LLSDXMLParser::Impl::startSkipping()
 {
     mSkipping = true;
@@ -664,7 +679,7 @@ void LLSDXMLParser::Impl::startElementHandler(const XML_Char* name, const XML_Ch
 
     if (mStack.empty())
     {
-        mStack.push_back(&mResult);
+        mStack.push_back(mListener ? pushListenerValue() : &mResult);
     }
     else if (mStack.back()->isMap())
     {
@@ -674,18 +689,33 @@ void LLSDXMLParser::Impl::startElementHandler(const XML_Char* name, const XML_Ch
             return startSkipping();
         }
 
-        LLSD& map = *mStack.back();
-        LLSD& newElement = map[mCurrentKey];
-        mStack.push_back(&newElement);
+        if (mListener)
+        {
+            mListener->key(mCurrentKey);
+            mStack.push_back(pushListenerValue());
+        }
+        else
+        {
+            LLSD& map = *mStack.back();
+            LLSD& newElement = map[mCurrentKey];
+            mStack.push_back(&newElement);
+        }
 
         mCurrentKey.clear();
     }
     else if (mStack.back()->isArray())
     {
-        LLSD& array = *mStack.back();
-        array.append(LLSD());
-        LLSD& newElement = array[array.size()-1];
-        mStack.push_back(&newElement);
+        if (mListener)
+        {
+            mStack.push_back(pushListenerValue());
+        }
+        else
+        {
+            LLSD& array = *mStack.back();
+            array.append(LLSD());
+            LLSD& newElement = array[array.size()-1];
+            mStack.push_back(&newElement);
+        }
     }
     else {
         // improperly nested value in a non-structure
@@ -698,10 +728,18 @@ void LLSDXMLParser::Impl::startElementHandler(const XML_Char* name, const XML_Ch
     {
         case ELEMENT_MAP:
             *mStack.back() = LLSD::emptyMap();
+            if (mListener)
+            {
+                mListener->beginMap();
+            }
             break;
 
         case ELEMENT_ARRAY:
             *mStack.back() = LLSD::emptyArray();
+            if (mListener)
+            {
+                mListener->beginArray();
+            }
             break;
 
         default:
@@ -843,6 +881,23 @@ void LLSDXMLParser::Impl::endElementHandler(const XML_Char* name)
             break;
     }
 
+    if (mListener)
+    {
+        if (element == ELEMENT_MAP)
+        {
+            mListener->endMap();
+        }
+        else if (element == ELEMENT_ARRAY)
+        {
+            mListener->endArray();
+        }
+        else
+        {
+            mListener->value(value);
+        }
+        mListenerValues.pop_back();
+    }
+
     mCurrentContent.clear();
 }
 
@@ -971,6 +1026,7 @@ S32 LLSDXMLParser::doParse(std::istream& input, LLSD& data, S32 max_depth) const
     XML_Timer timer( &parseTime );
     #endif  // XML_PARSER_PERFORMANCE_TESTS
 
+    impl.setListener(mListener);
     if (mParseLines)
     {
         // Use line-based reading (faster code)
@@ -0,0 +1,253 @@
+/**
+ * @file llslabpool.h
+ * @brief Fixed size block allocator carving blocks out of larger slabs
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLSLABPOOL_H
+#define LL_LLSLABPOOL_H
+
+#include "llmemory.h"
+#include "llmemtag.h"
+
+#include <mutex>
+#include <vector>
+
+// Hands out 16 byte aligned blocks of one size from slabs allocated in
+// bulk.  Freed blocks go on a free list for reuse; the slabs themselves
+// are only released, all at once, when the pool is destroyed, so every
+// block must have been freed (or be abandoned on purpose) by then.
+//
+// Slabs start small and double up to max_slab_blocks, so that the many
+// pools that only ever hold a handful of blocks stay cheap.  If a tag is
+// given, the slabs are claimed on it.
+//
+// Not thread safe:  each pool must only be used by one thread at a time.
+class LLSlabPool
+{
+public:
+    LLSlabPool(size_t block_size, U32 max_slab_blocks = 256, const LLMemTag* tag = nullptr)
+    :   mBlockSize((block_size + 15) & ~(size_t)15),
+        mMaxSlabBlocks(max_slab_blocks),
+        mTag(tag)
+    {
+        llassert(block_size >= sizeof(FreeBlock));
+    }
+
+    ~LLSlabPool()
+    {
+        for (void* slab : mSlabs)
+        {
+            ll_aligned_free_16(slab);
+        }
+        if (mTag)
+        {
+            mTag->disclaim(mReserved);
+        }
+    }
+
+    LLSlabPool(const LLSlabPool&) = delete;
+    LLSlabPool& operator=(const LLSlabPool&) = delete;
+
+    void* allocate()
+    {
+        ++mAllocated;
+        if (mFreeList)
+        {
+            FreeBlock* block = mFreeList;
+            mFreeList = block->mNext;
+            return block;
+        }
+        if (mNext == mEnd)
+        {
+            allocateSlab();
+        }
+        void* block = mNext;
+        mNext += mBlockSize;
+        return block;
+    }
+
+    void free(void* ptr)
+    {
+        if (ptr)
+        {
+            llassert(mAllocated > 0);
+            --mAllocated;
+            FreeBlock* block = (FreeBlock*)ptr;
+            block->mNext = mFreeList;
+            mFreeList = block;
+        }
+    }
+
+    size_t getBlockSize() const { return mBlockSize; }
+    // Blocks currently handed out
+    U32 getAllocatedCount() const { return mAllocated; }
+    // Bytes held in slabs, used or not
+    size_t getReservedBytes() const { return mReserved; }
+
+private:
+    struct FreeBlock
+    {
+        FreeBlock* mNext;
+    };
+
+    void allocateSlab()
+    {
+        U32 blocks = llmin(mMaxSlabBlocks, 8U << llmin((U32)mSlabs.size(), 5U));
+        size_t bytes = blocks * mBlockSize;
+        mNext = (U8*)ll_aligned_malloc_16(bytes);
+        mEnd = mNext + bytes;
+        mSlabs.push_back(mNext);
+        mReserved += bytes;
+        if (mTag)
+        {
+            mTag->claim(bytes);
+        }
+    }
+
+    const size_t mBlockSize;
+    const U32 mMaxSlabBlocks;
+    const LLMemTag* mTag;
+    std::vector<void*> mSlabs;
+    FreeBlock* mFreeList = nullptr;
+    U8* mNext = nullptr;
+    U8* mEnd = nullptr;
+    U32 mAllocated = 0;
+    size_t mReserved = 0;
+};
+
+// An LLSlabPool behind a mutex, to back the class operator new/delete of objects that
+// may be created or released on any thread.  Sizes larger than the block size (classes
+// derived from the pooled one) go to the heap.
+class LLLockedSlabPool
+{
+public:
+    LLLockedSlabPool(size_t block_size, U32 max_slab_blocks = 256, const LLMemTag* tag = nullptr)
+    :   mPool(block_size, max_slab_blocks, tag)
+    {
+    }
+
+    void* allocate(size_t size)
+    {
+        if (size > mPool.getBlockSize())
+        {
+            return ::operator new(size);
+        }
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mPool.allocate();
+    }
+
+    void free(void* ptr, size_t size)
+    {
+        if (size > mPool.getBlockSize())
+        {
+            ::operator delete(ptr);
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mMutex);
+        mPool.free(ptr);
+    }
+
+private:
+    std::mutex mMutex;
+    LLSlabPool mPool;
+};
+
+// One LLSlabPool per block size, to back the class operator new/delete of a class whose
+// subclasses differ in size.  Each subclass size gets its own pool the first time it is
+// allocated; there are only ever a few, so finding the pool is a short linear search.
+// All pools claim their slabs on the same tag.
+//
+// Not thread safe, like LLSlabPool.
+class LLSizedSlabPools
+{
+public:
+    LLSizedSlabPools(const LLMemTag* tag = nullptr, U32 max_slab_blocks = 256)
+    :   mTag(tag),
+        mMaxSlabBlocks(max_slab_blocks)
+    {
+    }
+
+    ~LLSizedSlabPools()
+    {
+        for (LLSlabPool* pool : mPools)
+        {
+            delete pool;
+        }
+    }
+
+    LLSizedSlabPools(const LLSizedSlabPools&) = delete;
+    LLSizedSlabPools& operator=(const LLSizedSlabPools&) = delete;
+
+    void* allocate(size_t size)
+    {
+        return getPool(size).allocate();
+    }
+
+    void free(void* ptr, size_t size)
+    {
+        getPool(size).free(ptr);
+    }
+
+    // Blocks currently handed out, of all sizes
+    U32 getAllocatedCount() const
+    {
+        U32 count = 0;
+        for (const LLSlabPool* pool : mPools)
+        {
+            count += pool->getAllocatedCount();
+        }
+        return count;
+    }
+
+    size_t getReservedBytes() const
+    {
+        size_t bytes = 0;
+        for (const LLSlabPool* pool : mPools)
+        {
+            bytes += pool->getReservedBytes();
+        }
+        return bytes;
+    }
+
+private:
+    LLSlabPool& getPool(size_t size)
+    {
+        size_t block_size = (size + 15) & ~(size_t)15;
+        for (LLSlabPool* pool : mPools)
+        {
+            if (pool->getBlockSize() == block_size)
+            {
+                return *pool;
+            }
+        }
+        mPools.push_back(new LLSlabPool(size, mMaxSlabBlocks, mTag));
+        return *mPools.back();
+    }
+
+    const LLMemTag* mTag;
+    const U32 mMaxSlabBlocks;
+    std::vector<LLSlabPool*> mPools;
+};
+
+#endif // LL_LLSLABPOOL_H
@@ -41,7 +41,10 @@ static ThreadRecorder* sMasterThreadRecorder = NULL;
 ///////////////////////////////////////////////////////////////////////
 
 ThreadRecorder::ThreadRecorder()
-:   mParentRecorder(NULL)
+:   mParentRecorder(NULL),
+    mBackSlot(0),
+    mFrontSlot(1),
+    mSharedSlot(2)
 {
     init();
 }
@@ -89,7 +92,10 @@ void ThreadRecorder::init()
 
 
 ThreadRecorder::ThreadRecorder( ThreadRecorder& parent )
-:   mParentRecorder(&parent)
+:   mParentRecorder(&parent),
+    mBackSlot(0),
+    mFrontSlot(1),
+    mSharedSlot(2)
 {
     init();
     mParentRecorder->addChildRecorder(this);
@@ -267,10 +273,15 @@ void ThreadRecorder::pushToParent()
 #if LL_TRACE_ENABLED
     if (ThreadRecorder* recorder = LLTrace::get_thread_recorder())
     {
-        LLMutexLock lock(&mSharedRecordingMutex);
         recorder->bringUpToDate(&mThreadRecordingBuffers);
-        mSharedRecordingBuffers.append(mThreadRecordingBuffers);
+        mHandoffBuffers[mBackSlot].append(mThreadRecordingBuffers);
         mThreadRecordingBuffers.reset();
+
+        // if the parent hasn't taken the last hand-off yet, keep accumulating into ours
+        if (!(mSharedSlot.load(std::memory_order_acquire) & HANDOFF_FULL))
+        {
+            mBackSlot = mSharedSlot.exchange(mBackSlot | HANDOFF_FULL, std::memory_order_acq_rel);
+        }
     }
 #endif
 }
@@ -287,9 +298,14 @@ void ThreadRecorder::pullFromChildren()
         target_recording_buffers.sync();
         for (LLTrace::ThreadRecorder* rec : mChildThreadRecorders)
         {
-            LLMutexLock lock(&(rec->mSharedRecordingMutex));
-            target_recording_buffers.merge(rec->mSharedRecordingBuffers);
-            rec->mSharedRecordingBuffers.reset();
+            if (rec->mSharedSlot.load(std::memory_order_acquire) & HANDOFF_FULL)
+            {
+                // trade our empty slot for the full one
+                U32 full = rec->mSharedSlot.exchange(rec->mFrontSlot, std::memory_order_acq_rel) & ~HANDOFF_FULL;
+                rec->mFrontSlot = full;
+                target_recording_buffers.merge(rec->mHandoffBuffers[full]);
+                rec->mHandoffBuffers[full].reset();
+            }
         }
     }
 #endif
@@ -33,6 +33,8 @@
 #include "llmutex.h"
 #include "lltraceaccumulators.h"
 
+#include <atomic>
+
 namespace LLTrace
 {
     class LL_COMMON_API ThreadRecorder
@@ -55,6 +57,8 @@ namespace LLTrace
 
         // call this periodically to gather stats data from child threads
         void pullFromChildren();
+        // call this periodically on a child thread to hand its data to the parent,
+        // never blocks
         void pushToParent();
 
         TimeBlockTreeNode* getTimeBlockTreeNode(size_t index);
@@ -85,10 +89,19 @@ namespace LLTrace
 
         child_thread_recorder_list_t    mChildThreadRecorders;  // list of child thread recorders associated with this master
         LLMutex                         mChildListMutex;        // protects access to child list
-        LLMutex                         mSharedRecordingMutex;
-        AccumulatorBufferGroup          mSharedRecordingBuffers;
         ThreadRecorder*                 mParentRecorder;
 
+        // Triple buffered hand-off of a child's data to its parent.  The child accumulates
+        // into mHandoffBuffers[mBackSlot] and publishes it in mSharedSlot once the parent has
+        // emptied the previously published slot; the parent trades its empty
+        // mHandoffBuffers[mFrontSlot] for a full one.  Each side only acts on the state the
+        // other side left it in, so neither ever waits.
+        static constexpr U32            HANDOFF_FULL = 0x4;
+        AccumulatorBufferGroup          mHandoffBuffers[3];
+        U32                             mBackSlot;              // child thread only
+        U32                             mFrontSlot;             // parent thread only
+        std::atomic<U32>                mSharedSlot;            // slot index | HANDOFF_FULL
+
     };
 
     ThreadRecorder* get_thread_recorder();
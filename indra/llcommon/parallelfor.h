@@ -0,0 +1,108 @@
+/**
+ * @file   parallelfor.h
+ * @date   2024-11-04
+ * @brief  parallel_for() spreads a loop across the threads of a ThreadPool
+ *         and waits for it to finish.
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Copyright (c) 2024, Linden Research, Inc.
+ * $/LicenseInfo$
+ */
+
+#if ! defined(LL_PARALLELFOR_H)
+#define LL_PARALLELFOR_H
+
+#include "threadpool.h"
+#include "workqueue.h"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace LL
+{
+
+    /**
+     * parallel_for() calls func(i) for every i in [0, count), spreading the
+     * calls across the worker threads of the ThreadPool named pool_name (for
+     * instance "General"). The calling thread claims indices as well, so the
+     * loop always completes even if every worker is busy, or if the pool
+     * does not exist or has been closed. parallel_for() returns only when
+     * every call has finished.
+     *
+     * Indices are handed out in runs of grain to amortize the atomic
+     * bookkeeping for cheap loop bodies. func must be safe to call
+     * concurrently for distinct indices and must not throw.
+     *
+     * With a WorkStealingPool each worker is handed its share in its own
+     * lane, so forking the loop takes no lock at all.
+     */
+    template <typename FUNC>
+    void parallel_for(const std::string& pool_name, size_t count, FUNC&& func, size_t grain = 1)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        grain = std::max<size_t>(grain, 1);
+        size_t chunks = (count + grain - 1) / grain;
+
+        // Work items still sitting in the queue after we return must not
+        // touch anything on our stack: they only reach func by claiming an
+        // index, and every index is claimed before we return.
+        struct State
+        {
+            std::atomic<size_t> mNext{ 0 };
+            std::atomic<size_t> mDone{ 0 };
+            size_t mCount{ 0 };
+            size_t mGrain{ 1 };
+            std::function<void(size_t)> mFunc;
+
+            void run()
+            {
+                for (size_t begin = mNext.fetch_add(mGrain); begin < mCount; begin = mNext.fetch_add(mGrain))
+                {
+                    size_t end = std::min(begin + mGrain, mCount);
+                    for (size_t i = begin; i < end; ++i)
+                    {
+                        mFunc(i);
+                    }
+                    mDone.fetch_add(end - begin);
+                }
+            }
+        };
+
+        auto state = std::make_shared<State>();
+        state->mCount = count;
+        state->mGrain = grain;
+        state->mFunc = std::ref(func);
+
+        auto queue = WorkQueueBase::getInstance(pool_name);
+        if (queue && chunks > 1)
+        {
+            auto lanes = std::dynamic_pointer_cast<WorkStealingQueue>(queue);
+            size_t helpers = std::min(ThreadPoolBase::getWidth(pool_name, 0), chunks - 1);
+            for (size_t i = 0; i < helpers; ++i)
+            {
+                auto work = [state]() { state->run(); };
+                if (!(lanes ? lanes->postToLane(i, work) : queue->post(work)))
+                {
+                    break;
+                }
+            }
+        }
+
+        state->run();
+
+        while (state->mDone.load() < count)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+} // namespace LL
+
+#endif /* ! defined(LL_PARALLELFOR_H) */
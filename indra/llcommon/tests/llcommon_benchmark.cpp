@@ -0,0 +1,406 @@
+/**
+ * @file   llcommon_benchmark.cpp
+ * @date   2026-10-15
+ * @brief  Benchmarks of LLSD, LLUUID, LLStringUtil and LLSDSerialize
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+#include "llbenchmark.h"
+
+#include "llflathashmap.h"
+#include "llsd.h"
+#include "llsdserialize.h"
+#include "llsdutil.h"
+#include "llstring.h"
+#include "lluuid.h"
+
+#include <map>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    const U32 UUID_COUNT = 4096;
+
+    std::vector<LLUUID> make_uuids(U32 count)
+    {
+        std::vector<LLUUID> ids(count);
+        for (LLUUID& id : ids)
+        {
+            id.generate();
+        }
+        return ids;
+    }
+
+    // Roughly what the viewer gets for one object in an ObjectProperties
+    // style capability response
+    LLSD make_object()
+    {
+        LLUUID id;
+        id.generate();
+        LLSD object;
+        object["ObjectID"] = id;
+        object["OwnerID"] = id;
+        object["Name"] = "Object with a reasonably long name";
+        object["Description"] = "A description that is a little longer than the name of the object";
+        object["CreationDate"] = LLDate::now();
+        object["SalePrice"] = 250;
+        object["Flags"] = (S32)0x12345678;
+        object["Scale"] = 1.5;
+        object["ForSale"] = true;
+        LLSD textures;
+        for (U32 i = 0; i < 8; ++i)
+        {
+            id.generate();
+            textures.append(id);
+        }
+        object["TextureIDs"] = textures;
+        return object;
+    }
+
+    // A response with many objects, used by the serializer benchmarks
+    LLSD make_document()
+    {
+        LLSD document;
+        for (U32 i = 0; i < 100; ++i)
+        {
+            document["ObjectData"].append(make_object());
+        }
+        return document;
+    }
+
+    const char* const SAMPLE_TEXT = "   Second Life Viewer: The Quick Brown Fox Jumps Over The Lazy Dog, 1234567890   ";
+}
+
+/*****************************************************************************
+*   LLSD
+*****************************************************************************/
+static void llsd_build_map(llbenchmark::State& state)
+{
+    while (state.keepRunning())
+    {
+        llbenchmark::doNotOptimize(make_object());
+    }
+    state.setItemsProcessed(state.getIterations());
+}
+LL_BENCHMARK(llsd_build_map);
+
+static void llsd_map_lookup(llbenchmark::State& state)
+{
+    const LLSD object = make_object();
+    const char* const keys[] = { "ObjectID", "Name", "SalePrice", "Flags", "Scale", "TextureIDs", "Missing" };
+    while (state.keepRunning())
+    {
+        for (const char* key : keys)
+        {
+            llbenchmark::doNotOptimize(object[key]);
+        }
+    }
+    state.setItemsProcessed(state.getIterations() * LL_ARRAY_SIZE(keys));
+}
+LL_BENCHMARK(llsd_map_lookup);
+
+static void llsd_array_append(llbenchmark::State& state)
+{
+    while (state.keepRunning())
+    {
+        LLSD array = LLSD::emptyArray();
+        for (S32 i = 0; i < 256; ++i)
+        {
+            array.append(i);
+        }
+        llbenchmark::doNotOptimize(array);
+    }
+    state.setItemsProcessed(state.getIterations() * 256);
+}
+LL_BENCHMARK(llsd_array_append);
+
+static void llsd_copy_document(llbenchmark::State& state)
+{
+    // LLSD copies share, only the deep copy does any work
+    const LLSD document = make_document();
+    while (state.keepRunning())
+    {
+        llbenchmark::doNotOptimize(llsd_clone(document));
+    }
+}
+LL_BENCHMARK(llsd_copy_document);
+
+/*****************************************************************************
+*   LLUUID
+*****************************************************************************/
+static void lluuid_hash(llbenchmark::State& state)
+{
+    const std::vector<LLUUID> ids = make_uuids(UUID_COUNT);
+    std::hash<LLUUID> hasher;
+    while (state.keepRunning())
+    {
+        size_t sum = 0;
+        for (const LLUUID& id : ids)
+        {
+            sum += hasher(id);
+        }
+        llbenchmark::doNotOptimize(sum);
+    }
+    state.setItemsProcessed(state.getIterations() * UUID_COUNT);
+}
+LL_BENCHMARK(lluuid_hash);
+
+static void lluuid_unordered_map_find(llbenchmark::State& state)
+{
+    const std::vector<LLUUID> ids = make_uuids(UUID_COUNT);
+    std::unordered_map<LLUUID, U32> map;
+    for (U32 i = 0; i < UUID_COUNT; i += 2)
+    {
+        map[ids[i]] = i;
+    }
+    while (state.keepRunning())
+    {
+        U32 found = 0;
+        for (const LLUUID& id : ids)
+        {
+            found += (U32)map.count(id);
+        }
+        llbenchmark::doNotOptimize(found);
+    }
+    state.setItemsProcessed(state.getIterations() * UUID_COUNT);
+}
+LL_BENCHMARK(lluuid_unordered_map_find);
+
+static void lluuid_to_string(llbenchmark::State& state)
+{
+    const std::vector<LLUUID> ids = make_uuids(256);
+    std::string str;
+    while (state.keepRunning())
+    {
+        for (const LLUUID& id : ids)
+        {
+            id.toString(str);
+            llbenchmark::doNotOptimize(str);
+        }
+    }
+    state.setItemsProcessed(state.getIterations() * ids.size());
+}
+LL_BENCHMARK(lluuid_to_string);
+
+static void lluuid_from_string(llbenchmark::State& state)
+{
+    std::vector<std::string> strings;
+    for (const LLUUID& id : make_uuids(256))
+    {
+        strings.push_back(id.asString());
+    }
+    LLUUID id;
+    while (state.keepRunning())
+    {
+        for (const std::string& str : strings)
+        {
+            id.set(str);
+            llbenchmark::doNotOptimize(id);
+        }
+    }
+    state.setItemsProcessed(state.getIterations() * strings.size());
+}
+LL_BENCHMARK(lluuid_from_string);
+
+/*****************************************************************************
+*   LLStringUtil
+*****************************************************************************/
+static void llstringutil_trim(llbenchmark::State& state)
+{
+    const std::string sample(SAMPLE_TEXT);
+    while (state.keepRunning())
+    {
+        std::string str(sample);
+        LLStringUtil::trim(str);
+        llbenchmark::doNotOptimize(str);
+    }
+}
+LL_BENCHMARK(llstringutil_trim);
+
+static void llstringutil_to_lower(llbenchmark::State& state)
+{
+    const std::string sample(SAMPLE_TEXT);
+    while (state.keepRunning())
+    {
+        std::string str(sample);
+        LLStringUtil::toLower(str);
+        llbenchmark::doNotOptimize(str);
+    }
+    state.setBytesProcessed(state.getIterations() * sample.size());
+}
+LL_BENCHMARK(llstringutil_to_lower);
+
+static void llstringutil_compare_insensitive(llbenchmark::State& state)
+{
+    const std::string lhs(SAMPLE_TEXT);
+    std::string rhs(SAMPLE_TEXT);
+    LLStringUtil::toUpper(rhs);
+    while (state.keepRunning())
+    {
+        llbenchmark::doNotOptimize(LLStringUtil::compareInsensitive(lhs, rhs));
+    }
+}
+LL_BENCHMARK(llstringutil_compare_insensitive);
+
+static void llstringutil_get_tokens(llbenchmark::State& state)
+{
+    const std::string sample("stand|stand 1|stand 2|walk|run|sit|sit on ground|fly|hover|land|jump|turn left|turn right");
+    std::vector<std::string> tokens;
+    while (state.keepRunning())
+    {
+        tokens.clear();
+        LLStringUtil::getTokens(sample, tokens, "|");
+        llbenchmark::doNotOptimize(tokens);
+    }
+    state.setBytesProcessed(state.getIterations() * sample.size());
+}
+LL_BENCHMARK(llstringutil_get_tokens);
+
+static void llstringutil_format(llbenchmark::State& state)
+{
+    const std::string sample("[NAME] paid you L$[AMOUNT] for [ITEM] at [REGION] ([X], [Y], [Z])");
+    LLStringUtil::format_map_t args;
+    args["[NAME]"] = "Resident Name";
+    args["[AMOUNT]"] = "250";
+    args["[ITEM]"] = "An item with a name";
+    args["[REGION]"] = "Some Region";
+    args["[X]"] = "128";
+    args["[Y]"] = "64";
+    args["[Z]"] = "22";
+    while (state.keepRunning())
+    {
+        std::string str(sample);
+        LLStringUtil::format(str, args);
+        llbenchmark::doNotOptimize(str);
+    }
+}
+LL_BENCHMARK(llstringutil_format);
+
+/*****************************************************************************
+*   LLSDSerialize
+*****************************************************************************/
+template <typename WRITE>
+static void serialize(llbenchmark::State& state, WRITE write)
+{
+    const LLSD document = make_document();
+    size_t bytes = 0;
+    while (state.keepRunning())
+    {
+        std::ostringstream out;
+        write(document, out);
+        bytes = out.tellp();
+        llbenchmark::doNotOptimize(out);
+    }
+    state.setBytesProcessed(state.getIterations() * bytes);
+}
+
+template <typename WRITE, typename READ>
+static void deserialize(llbenchmark::State& state, WRITE write, READ read)
+{
+    std::ostringstream out;
+    write(make_document(), out);
+    const std::string data = out.str();
+    while (state.keepRunning())
+    {
+        std::istringstream in(data);
+        LLSD document;
+        read(document, in, data.size());
+        llbenchmark::doNotOptimize(document);
+    }
+    state.setBytesProcessed(state.getIterations() * data.size());
+}
+
+static void write_xml(const LLSD& sd, std::ostream& out)      { LLSDSerialize::toXML(sd, out); }
+static void write_notation(const LLSD& sd, std::ostream& out) { LLSDSerialize::toNotation(sd, out); }
+static void write_binary(const LLSD& sd, std::ostream& out)   { LLSDSerialize::toBinary(sd, out); }
+
+static void read_xml(LLSD& sd, std::istream& in, size_t)            { LLSDSerialize::fromXML(sd, in); }
+static void read_notation(LLSD& sd, std::istream& in, size_t size)  { LLSDSerialize::fromNotation(sd, in, size); }
+static void read_binary(LLSD& sd, std::istream& in, size_t size)    { LLSDSerialize::fromBinary(sd, in, size); }
+
+static void llsdserialize_to_xml(llbenchmark::State& state)          { serialize(state, write_xml); }
+static void llsdserialize_to_notation(llbenchmark::State& state)     { serialize(state, write_notation); }
+static void llsdserialize_to_binary(llbenchmark::State& state)       { serialize(state, write_binary); }
+static void llsdserialize_from_xml(llbenchmark::State& state)        { deserialize(state, write_xml, read_xml); }
+static void llsdserialize_from_notation(llbenchmark::State& state)   { deserialize(state, write_notation, read_notation); }
+static void llsdserialize_from_binary(llbenchmark::State& state)     { deserialize(state, write_binary, read_binary); }
+LL_BENCHMARK(llsdserialize_to_xml);
+LL_BENCHMARK(llsdserialize_to_notation);
+LL_BENCHMARK(llsdserialize_to_binary);
+LL_BENCHMARK(llsdserialize_from_xml);
+LL_BENCHMARK(llsdserialize_from_notation);
+LL_BENCHMARK(llsdserialize_from_binary);
+
+/*****************************************************************************
+*   LLFlatHashMap
+*****************************************************************************/
+static bool contains(const std::map<LLUUID, U32>& map, const LLUUID& id)      { return map.find(id) != map.end(); }
+static bool contains(const LLFlatHashMap<LLUUID, U32>& map, const LLUUID& id) { return map.contains(id); }
+
+// An object update flood: mostly lookups of known objects, with some
+// objects killed and others created
+template <typename MAP>
+static void object_updates(llbenchmark::State& state)
+{
+    const U32 objects = 50000;
+    const U32 updates = 65536;
+    const std::vector<LLUUID> ids = make_uuids(objects);
+    std::vector<U32> picks(updates);
+    for (U32 i = 0; i < updates; ++i)
+    {
+        picks[i] = (i * 2654435761u) % objects;
+    }
+    MAP map;
+    for (U32 i = 0; i < objects; ++i)
+    {
+        map[ids[i]] = i;
+    }
+    while (state.keepRunning())
+    {
+        U32 found = 0;
+        for (U32 i = 0; i < updates; ++i)
+        {
+            const LLUUID& id = ids[picks[i]];
+            if (i % 16 == 0)
+            {
+                // kill and recreate
+                map.erase(id);
+                map[id] = i;
+            }
+            else
+            {
+                found += contains(map, id) ? 1 : 0;
+            }
+        }
+        llbenchmark::doNotOptimize(found);
+    }
+    state.setItemsProcessed(state.getIterations() * updates);
+}
+
+static void std_map_object_updates(llbenchmark::State& state)         { object_updates<std::map<LLUUID, U32>>(state); }
+static void llflathashmap_object_updates(llbenchmark::State& state)   { object_updates<LLFlatHashMap<LLUUID, U32>>(state); }
+LL_BENCHMARK(std_map_object_updates);
+LL_BENCHMARK(llflathashmap_object_updates);
@@ -921,6 +921,39 @@ namespace tut
     }
 }
 
+namespace
+{
+    std::string writeAsyncReturningLocation()
+    {
+        LL_INFOS("Async") << "queued one" << LL_ENDL;
+        LL_WARNS("Async") << "queued two" << LL_ENDL;
+        int this_line = __LINE__; CATCH(LL_ERRS("Async"), "fatal");
+        return locationString(this_line);
+    }
+}
+
+namespace tut
+{
+    template<> template<>
+    void ErrorTestObject::test<19>()
+        // async logging keeps the order and writes queued lines before LL_ERRS
+    {
+        LLError::setAsyncLogging(true);
+        std::string location = writeAsyncReturningLocation();
+        LL_INFOS("Async") << "after" << LL_ENDL;
+        LLError::flushAsyncLog();
+        LLError::setAsyncLogging(false);
+
+        ensure("fatal callback called", fatalWasCalled);
+        ensure_message_field_equals(0, MSG_FIELD, "queued one");
+        ensure_message_field_equals(1, MSG_FIELD, "queued two");
+        ensure_message_field_equals(2, LOCATION_FIELD, location);
+        ensure_message_field_equals(2, MSG_FIELD, "fatal");
+        ensure_message_field_equals(3, MSG_FIELD, "after");
+        ensure_message_count(4);
+    }
+}
+
 /* Tests left:
     handling of classes without LOG_CLASS
 
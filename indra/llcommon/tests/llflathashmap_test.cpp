@@ -0,0 +1,112 @@
+/**
+ * @file llflathashmap_test.cpp
+ * @brief Tests and benchmark of LLFlatHashMap
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+
+#include "linden_common.h"
+#include "../test/lltut.h"
+
+#include "../llflathashmap.h"
+#include "stringize.h"
+
+#include <map>
+#include <random>
+
+namespace tut
+{
+    struct flathashmap
+    {
+        std::mt19937_64 mRandom{ 97531 };
+    };
+
+    typedef test_group<flathashmap> flathashmap_t;
+    typedef flathashmap_t::object flathashmap_object_t;
+    tut::flathashmap_t tut_flathashmap("LLFlatHashMap");
+
+    template<> template<>
+    void flathashmap_object_t::test<1>()
+    {
+        set_test_name("basic operations");
+        LLFlatHashMap<U64, S32> map;
+        ensure("empty", map.empty());
+        ensure("find in empty map", !map.find(7));
+        ensure("erase from empty map", !map.erase(7));
+
+        map[7] = 70;
+        map[8] = 80;
+        ensure_equals("size", map.size(), (size_t)2);
+        ensure_equals("find 7", *map.find(7), 70);
+        ensure("contains 8", map.contains(8));
+        ensure_equals("default value", map[9], 0);
+        ensure("erase 7", map.erase(7));
+        ensure("7 gone", !map.find(7));
+        ensure_equals("8 kept", *map.find(8), 80);
+
+        map.clear();
+        ensure("cleared", map.empty() && !map.find(8));
+    }
+
+    template<> template<>
+    void flathashmap_object_t::test<2>()
+    {
+        set_test_name("matches std::map under churn");
+        // small keys collide and make long probe runs, which erase must keep intact
+        LLFlatHashMap<U64, U64> map;
+        std::map<U64, U64> expected;
+        for (U32 i = 0; i < 200000; ++i)
+        {
+            U64 key = mRandom() % 5000;
+            switch (mRandom() % 3)
+            {
+            case 0:
+                map[key] = i;
+                expected[key] = i;
+                break;
+            case 1:
+                ensure_equals(STRINGIZE("erase " << key), map.erase(key), expected.erase(key) > 0);
+                break;
+            default:
+            {
+                const U64* value = map.find(key);
+                auto it = expected.find(key);
+                ensure_equals(STRINGIZE("find " << key), value != nullptr, it != expected.end());
+                if (value)
+                {
+                    ensure_equals(STRINGIZE("value of " << key), *value, it->second);
+                }
+            }
+            }
+        }
+        ensure_equals("size", map.size(), expected.size());
+
+        size_t seen = 0;
+        map.forEach([&](U64 key, U64 value)
+                    {
+                        ensure_equals("forEach value", value, expected[key]);
+                        ++seen;
+                    });
+        ensure_equals("forEach count", seen, expected.size());
+    }
+}
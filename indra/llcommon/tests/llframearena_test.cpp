@@ -0,0 +1,92 @@
+/**
+ * @file   llframearena_test.cpp
+ * @date   2026-10-15
+ * @brief  Test for llframearena.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Copyright (c) 2026, Linden Research, Inc.
+ * $/LicenseInfo$
+ */
+
+// Precompiled header
+#include "linden_common.h"
+// associated header
+#include "llframearena.h"
+// STL headers
+#include <thread>
+// std headers
+// external library headers
+// other Linden headers
+#include "../test/lltut.h"
+
+/*****************************************************************************
+*   TUT
+*****************************************************************************/
+namespace tut
+{
+    struct llframearena_data
+    {
+    };
+    typedef test_group<llframearena_data> llframearena_group;
+    typedef llframearena_group::object object;
+    llframearena_group llframearenagrp("llframearena");
+
+    template<> template<>
+    void object::test<1>()
+    {
+        set_test_name("scope rewinds");
+        LLFrameArena& arena = LLFrameArena::get();
+        size_t start = arena.getUsedBytes();
+        void* first;
+        {
+            LLFrameArena::Scope scope;
+            first = arena.allocate(100);
+            ensure("allocated", arena.getUsedBytes() >= start + 100);
+            void* aligned = arena.allocate(8, 64);
+            ensure_equals("aligned", (uintptr_t)aligned % 64, 0);
+        }
+        ensure_equals("rewound", arena.getUsedBytes(), start);
+        LLFrameArena::Scope scope;
+        ensure_equals("same memory again", arena.allocate(100), first);
+    }
+
+    template<> template<>
+    void object::test<2>()
+    {
+        set_test_name("containers");
+        LLFrameArena::Scope scope;
+        LLFrameVector<S32> vec;
+        for (S32 i = 0; i < 100000; ++i)
+        {
+            vec.push_back(i);
+        }
+        ensure_equals("size", vec.size(), 100000);
+        ensure_equals("last", vec.back(), 99999);
+        // larger than a block
+        ensure("spans blocks", LLFrameArena::get().getUsedBytes() > LLFrameArena::BLOCK_SIZE);
+    }
+
+    template<> template<>
+    void object::test<3>()
+    {
+        set_test_name("threads");
+        LLFrameArena::getPeakBytes();
+        void* main_memory;
+        {
+            LLFrameArena::Scope scope;
+            main_memory = LLFrameArena::get().allocate(1000);
+        }
+        void* other_memory = NULL;
+        std::thread other([&other_memory]()
+                          {
+                              LLFrameArena::Scope scope;
+                              other_memory = LLFrameArena::get().allocate(500);
+                          });
+        other.join();
+        ensure("own arena", main_memory != other_memory);
+        // the exited thread's arena is gone with it
+        size_t peak = LLFrameArena::getPeakBytes();
+        ensure("main thread peak", peak >= 1000 && peak < 1000 + alignof(std::max_align_t));
+        ensure_equals("peak reset", LLFrameArena::getPeakBytes(), 0);
+    }
+} // namespace tut
@@ -0,0 +1,62 @@
+/**
+ * @file   llmemtag_test.cpp
+ * @date   2026-10-15
+ * @brief  Test for llmemtag.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Copyright (c) 2026, Linden Research, Inc.
+ * $/LicenseInfo$
+ */
+
+// Precompiled header
+#include "linden_common.h"
+// associated header
+#include "llmemtag.h"
+// STL headers
+#include <thread>
+// std headers
+// external library headers
+// other Linden headers
+#include "../test/lltut.h"
+
+static LLMemTag sTestMemTag("llmemtag test");
+
+/*****************************************************************************
+*   TUT
+*****************************************************************************/
+namespace tut
+{
+    struct llmemtag_data
+    {
+    };
+    typedef test_group<llmemtag_data> llmemtag_group;
+    typedef llmemtag_group::object object;
+    llmemtag_group llmemtaggrp("llmemtag");
+
+    template<> template<>
+    void object::test<1>()
+    {
+        set_test_name("find");
+        ensure_equals("find by name", LLMemTag::find("llmemtag test"), &sTestMemTag);
+        ensure("unknown name", ! LLMemTag::find("no such tag"));
+    }
+
+    template<> template<>
+    void object::test<2>()
+    {
+        set_test_name("threads");
+        S64 start = sTestMemTag.getBytes();
+        sTestMemTag.claim(1000);
+        std::thread other([]()
+                          {
+                              sTestMemTag.claim(500);
+                              // freeing what the main thread claimed
+                              sTestMemTag.disclaim(200);
+                          });
+        other.join();
+        // the exited thread's counts are kept
+        ensure_equals("sum of threads", sTestMemTag.getBytes() - start, 1300);
+        sTestMemTag.disclaim(1300);
+        ensure_equals("all freed", sTestMemTag.getBytes(), start);
+    }
+} // namespace tut
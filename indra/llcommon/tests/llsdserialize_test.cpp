@@ -47,6 +47,7 @@ typedef U32 uint32_t;
 #include "boost/range.hpp"
 
 #include "llsd.h"
+#include "llsdjson.h"
 #include "llsdserialize.h"
 #include "llsdutil.h"
 #include "llformat.h"
@@ -57,7 +58,9 @@ typedef U32 uint32_t;
 #include "../test/namedtempfile.h"
 #include "stringize.h"
 #include "StringVec.h"
+#include <chrono>
 #include <functional>
+#include <thread>
 
 typedef std::function<void(const LLSD& data, std::ostream& str)> FormatterFunction;
 typedef std::function<bool(std::istream& istr, LLSD& data, llssize max_bytes)> ParserFunction;
@@ -2194,4 +2197,411 @@ namespace tut
                         { return LLSDSerialize::fromBinary(data, istr, max_bytes) > 0; });
     }
 |*==========================================================================*/
+
+    struct TestLLSDPooledParsing
+    {
+        // Notation for a message sized tree of nested maps and arrays
+        std::string makeNotation(S32 count)
+        {
+            std::ostringstream str;
+            str << "[";
+            for (S32 i = 0; i < count; ++i)
+            {
+                str << (i ? "," : "") << "{'id':i" << i << ",'name':'object " << i
+                    << "','pos':[r1.5,r2.5,r" << i << "],'flags':{'phantom':true}}";
+            }
+            str << "]";
+            return str.str();
+        }
+
+        void ensureTree(const std::string& msg, const LLSD& tree, S32 count)
+        {
+            ensure_equals(msg + " size", tree.size(), (size_t)count);
+            for (S32 i = 0; i < count; ++i)
+            {
+                const LLSD& entry = tree[i];
+                ensure_equals(msg + " id", entry["id"].asInteger(), i);
+                ensure_equals(msg + " name", entry["name"].asString(), llformat("object %d", i));
+                ensure_equals(msg + " pos", entry["pos"][2].asReal(), (F64)i);
+                ensure(msg + " flags", entry["flags"]["phantom"].asBoolean());
+            }
+        }
+    };
+
+    typedef tut::test_group<TestLLSDPooledParsing> TestLLSDPooledParsingGroup;
+    typedef TestLLSDPooledParsingGroup::object TestLLSDPooledParsingObject;
+    TestLLSDPooledParsingGroup gTestLLSDPooledParsingGroup("llsd pooled parsing");
+
+    template<> template<>
+    void TestLLSDPooledParsingObject::test<1>()
+    {
+        set_test_name("pooled values outlive the parse and survive edits");
+        std::istringstream istr(makeNotation(500));
+        LLSD tree;
+        ensure("parse", LLSDSerialize::fromNotation(tree, istr, LLSDSerialize::SIZE_UNLIMITED) > 0);
+        ensureTree("parsed", tree, 500);
+
+        // values created outside the scope mix with pooled ones
+        LLSD copy = tree;
+        copy[0]["name"] = "renamed";
+        copy.append(LLSD::emptyMap());
+        ensure_equals("shared", tree[0]["name"].asString(), "renamed");
+        tree.clear();
+        ensure_equals("copy size", copy.size(), (size_t)501);
+
+        // pooled blocks are reused by the next parse
+        std::istringstream istr2(makeNotation(500));
+        LLSD tree2;
+        ensure("reparse", LLSDSerialize::fromNotation(tree2, istr2, LLSDSerialize::SIZE_UNLIMITED) > 0);
+        ensureTree("reparsed", tree2, 500);
+    }
+
+    template<> template<>
+    void TestLLSDPooledParsingObject::test<2>()
+    {
+        set_test_name("pooled values destroyed on another thread");
+        std::vector<LLSD> trees(4);
+        std::vector<std::thread> threads;
+        for (LLSD& tree : trees)
+        {
+            threads.emplace_back([this, &tree]()
+                {
+                    std::istringstream istr(makeNotation(200));
+                    LLSDSerialize::fromNotation(tree, istr, LLSDSerialize::SIZE_UNLIMITED);
+                });
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+        for (const LLSD& tree : trees)
+        {
+            ensureTree("threaded", tree, 200);
+        }
+        // the parsing threads are gone, their blocks go on this thread's lists
+        trees.clear();
+
+        std::istringstream istr(makeNotation(200));
+        LLSD tree;
+        LLSDSerialize::fromNotation(tree, istr, LLSDSerialize::SIZE_UNLIMITED);
+        ensureTree("after", tree, 200);
+    }
+
+    template<> template<>
+    void TestLLSDPooledParsingObject::test<3>()
+    {
+        set_test_name("pooling disabled");
+        LLSD::setPoolingEnabled(false);
+        std::istringstream istr(makeNotation(50));
+        LLSD tree;
+        LLSDSerialize::fromNotation(tree, istr, LLSDSerialize::SIZE_UNLIMITED);
+        LLSD::setPoolingEnabled(true);
+        ensureTree("unpooled", tree, 50);
+    }
+
+    // Writes every event it receives as notation-like text
+    class EventRecorder : public LLSDParseListener
+    {
+    public:
+        std::ostringstream mEvents;
+
+        virtual void beginMap()                     { mEvents << "{"; }
+        virtual void key(const std::string& key)    { mEvents << key << ":"; }
+        virtual void endMap()                       { mEvents << "}"; }
+        virtual void beginArray()                   { mEvents << "["; }
+        virtual void endArray()                     { mEvents << "]"; }
+        virtual void value(const LLSD& value)       { mEvents << value.asString() << ","; }
+    };
+
+    struct TestLLSDParseListener
+    {
+        LLSD makeDocument()
+        {
+            LLSD items = LLSD::emptyMap();
+            for (S32 i = 0; i < 3; ++i)
+            {
+                LLSD item;
+                item["name"] = llformat("item %d", i);
+                item["flags"] = LLSD().with(0, i).with(1, true);
+                items[llformat("id%d", i)] = item;
+            }
+            LLSD doc;
+            doc["_embedded"]["items"] = items;
+            doc["version"] = 7;
+            doc["empty"] = LLSD::emptyArray();
+            return doc;
+        }
+
+        std::string expected()
+        {
+            return "{_embedded:{items:{"
+                "id0:{flags:[0,true,]name:item 0,}"
+                "id1:{flags:[1,true,]name:item 1,}"
+                "id2:{flags:[2,true,]name:item 2,}"
+                "}}empty:[]version:7,}";
+        }
+
+        void ensureEvents(const std::string& msg, LLSDParser* parser, const std::string& serialized)
+        {
+            LLPointer<LLSDParser> keep(parser);
+            std::istringstream istr(serialized);
+            EventRecorder recorder;
+            S32 count = parser->parse(istr, recorder, serialized.size());
+            ensure(msg + " parsed", count > 0);
+            ensure_equals(msg, recorder.mEvents.str(), expected());
+        }
+    };
+
+    typedef tut::test_group<TestLLSDParseListener> TestLLSDParseListenerGroup;
+    typedef TestLLSDParseListenerGroup::object TestLLSDParseListenerObject;
+    TestLLSDParseListenerGroup gTestLLSDParseListenerGroup("llsd parse listener");
+
+    template<> template<>
+    void TestLLSDParseListenerObject::test<1>()
+    {
+        set_test_name("same events from every format");
+        LLSD doc = makeDocument();
+
+        std::ostringstream notation;
+        LLSDSerialize::toNotation(doc, notation);
+        ensureEvents("notation", new LLSDNotationParser, notation.str());
+
+        std::ostringstream binary;
+        LLSDSerialize::toBinary(doc, binary);
+        ensureEvents("binary", new LLSDBinaryParser, binary.str());
+
+        std::ostringstream xml;
+        LLSDSerialize::toXML(doc, xml);
+        ensureEvents("xml", new LLSDXMLParser, xml.str());
+    }
+
+    template<> template<>
+    void TestLLSDParseListenerObject::test<2>()
+    {
+        set_test_name("subtrees at a depth");
+        std::ostringstream notation;
+        LLSDSerialize::toNotation(makeDocument(), notation);
+
+        std::vector<std::string> keys;
+        LLSD items = LLSD::emptyMap();
+        LLSDSubtreeListener listener(3,
+            [&keys, &items](const std::string& key, const LLSD& value)
+            {
+                keys.push_back(key);
+                items[key] = value;
+            });
+        std::istringstream istr(notation.str());
+        LLPointer<LLSDParser> parser = new LLSDNotationParser;
+        ensure("parsed", parser->parse(istr, listener, notation.str().size()) > 0);
+        ensure_equals("count", keys.size(), (size_t)3);
+        ensure_equals("first", keys[0], "id0");
+        ensure("items", llsd_equals(items, makeDocument()["_embedded"]["items"]));
+
+        // array elements come without a key
+        keys.clear();
+        LLSDSubtreeListener elements(5,
+            [&keys](const std::string& key, const LLSD& value)
+            {
+                keys.push_back(key + ":" + value.asString());
+            });
+        std::istringstream istr2(notation.str());
+        ensure("reparsed", parser->parse(istr2, elements, notation.str().size()) > 0);
+        ensure_equals("depth 5", keys.size(), (size_t)6);
+        ensure_equals("element", keys[0], ":0");
+        ensure_equals("last", keys[5], ":true");
+    }
+
+    struct TestLLSDFastPaths
+    {
+        // Representative payloads: an inventory folder, a set of material
+        // overrides and a map item reply
+        LLSD makeInventory(S32 count)
+        {
+            LLSD items = LLSD::emptyArray();
+            for (S32 i = 0; i < count; ++i)
+            {
+                LLSD item;
+                item["item_id"] = LLUUID::generateNewID();
+                item["parent_id"] = LLUUID::generateNewID();
+                item["asset_id"] = LLUUID::generateNewID();
+                item["name"] = llformat("Object %d with a typical name", i);
+                item["desc"] = "(No Description)";
+                item["type"] = 6;
+                item["inv_type"] = 6;
+                item["flags"] = i;
+                item["created_at"] = 1700000000 + i;
+                item["permissions"]["owner_mask"] = 0x7fffffff;
+                item["permissions"]["next_owner_mask"] = 0x82000;
+                items.append(item);
+            }
+            return items;
+        }
+
+        LLSD makeMaterials(S32 count)
+        {
+            LLSD materials = LLSD::emptyArray();
+            for (S32 i = 0; i < count; ++i)
+            {
+                LLSD material;
+                material["id"] = LLUUID::generateNewID();
+                material["base_color"] = LLSD().with(0, 1.0).with(1, 0.5).with(2, 0.25).with(3, 1.0);
+                material["metallic"] = 0.1 * (i % 10);
+                material["roughness"] = 0.7;
+                material["data"] = LLSD::Binary(256, (U8)i);
+                materials.append(material);
+            }
+            return materials;
+        }
+
+        LLSD makeMapItems(S32 count)
+        {
+            LLSD items = LLSD::emptyArray();
+            for (S32 i = 0; i < count; ++i)
+            {
+                LLSD item;
+                item["x"] = 256000 + i;
+                item["y"] = 256000 - i;
+                item["id"] = LLUUID::generateNewID();
+                item["extra"] = i % 16;
+                item["name"] = llformat("Region %d", i);
+                items.append(item);
+            }
+            return items;
+        }
+
+        // JSON has no UUID or binary type, keep what survives the round trip
+        LLSD toJsonCompatible(const LLSD& sd)
+        {
+            if (sd.isMap())
+            {
+                LLSD result = LLSD::emptyMap();
+                for (const auto& pair : llsd::inMap(sd))
+                {
+                    if (!pair.second.isBinary())
+                    {
+                        result[pair.first] = toJsonCompatible(pair.second);
+                    }
+                }
+                return result;
+            }
+            if (sd.isArray())
+            {
+                LLSD result = LLSD::emptyArray();
+                for (const LLSD& element : llsd::inArray(sd))
+                {
+                    result.append(toJsonCompatible(element));
+                }
+                return result;
+            }
+            if (sd.isUUID())
+            {
+                return sd.asString();
+            }
+            return sd;
+        }
+
+        F64 elapsedMs(std::chrono::steady_clock::time_point start)
+        {
+            return std::chrono::duration<F64, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+    };
+
+    typedef tut::test_group<TestLLSDFastPaths> TestLLSDFastPathsGroup;
+    typedef TestLLSDFastPathsGroup::object TestLLSDFastPathsObject;
+    TestLLSDFastPathsGroup gTestLLSDFastPathsGroup("llsd fast paths");
+
+    template<> template<>
+    void TestLLSDFastPathsObject::test<1>()
+    {
+        set_test_name("direct JSON parse matches the boost::json path");
+        LLSD doc = toJsonCompatible(makeInventory(200));
+        doc = LLSD().with(0, doc).with(1, "quote \" and \\ backslash").with(2, 1.5).with(3, LLSD());
+        std::string json = boost::json::serialize(LlsdToJson(doc));
+
+        LLSD expected = LlsdFromJson(boost::json::parse(json));
+
+        boost::json::error_code ec;
+        LLSD direct = LlsdFromJson(std::string_view(json), ec);
+        ensure("string ok", !ec);
+        ensure("string", llsd_equals(direct, expected));
+
+        // larger than one read, so tokens straddle buffers
+        std::istringstream istr(json);
+        LLSD streamed = LlsdFromJson(istr, ec);
+        ensure("stream ok", !ec);
+        ensure("stream", llsd_equals(streamed, expected));
+
+        LlsdFromJson(std::string_view("{\"a\": [1, 2"), ec);
+        ensure("truncated", bool(ec));
+        LlsdFromJson(std::string_view("{\"a\": 1} x"), ec);
+        ensure("trailing garbage", bool(ec));
+    }
+
+    template<> template<>
+    void TestLLSDFastPathsObject::test<2>()
+    {
+        set_test_name("binary round trip of representative payloads");
+        for (const LLSD& payload : { makeInventory(50), makeMaterials(50), makeMapItems(50) })
+        {
+            std::ostringstream ostr;
+            LLSDSerialize::toBinary(payload, ostr);
+            std::istringstream istr(ostr.str());
+            LLSD parsed;
+            ensure("parsed", LLSDSerialize::fromBinary(parsed, istr, ostr.str().size()) > 0);
+            ensure("equal", llsd_equals(parsed, payload));
+        }
+    }
+
+    template<> template<>
+    void TestLLSDFastPathsObject::test<3>()
+    {
+        // Benchmark.  Only logs, the numbers depend too much on the machine
+        // to assert on them.
+        const S32 REPEAT = 20;
+        struct Payload { const char* mName; LLSD mData; };
+        for (const Payload& payload : { Payload{ "inventory", makeInventory(2000) },
+                                        Payload{ "materials", makeMaterials(500) },
+                                        Payload{ "map items", makeMapItems(5000) } })
+        {
+            std::string binary;
+            auto start = std::chrono::steady_clock::now();
+            for (S32 i = 0; i < REPEAT; ++i)
+            {
+                std::ostringstream ostr;
+                LLSDSerialize::toBinary(payload.mData, ostr);
+                binary = ostr.str();
+            }
+            F64 format_binary = elapsedMs(start);
+
+            start = std::chrono::steady_clock::now();
+            for (S32 i = 0; i < REPEAT; ++i)
+            {
+                std::istringstream istr(binary);
+                LLSD parsed;
+                LLSDSerialize::fromBinary(parsed, istr, binary.size());
+            }
+            F64 parse_binary = elapsedMs(start);
+
+            std::string json = boost::json::serialize(LlsdToJson(toJsonCompatible(payload.mData)));
+            start = std::chrono::steady_clock::now();
+            for (S32 i = 0; i < REPEAT; ++i)
+            {
+                LLSD parsed = LlsdFromJson(boost::json::parse(json));
+            }
+            F64 parse_json_dom = elapsedMs(start);
+
+            start = std::chrono::steady_clock::now();
+            for (S32 i = 0; i < REPEAT; ++i)
+            {
+                boost::json::error_code ec;
+                LLSD parsed = LlsdFromJson(std::string_view(json), ec);
+            }
+            F64 parse_json_direct = elapsedMs(start);
+
+            LL_INFOS() << payload.mName << " x" << REPEAT << ": binary " << binary.size() / 1024 << "KB"
+                       << " format " << format_binary << "ms, parse " << parse_binary << "ms;"
+                       << " json " << json.size() / 1024 << "KB"
+                       << " via boost::json::value " << parse_json_dom << "ms, direct " << parse_json_direct << "ms" << LL_ENDL;
+        }
+    }
 }
@@ -0,0 +1,115 @@
+/**
+ * @file llslabpool_test.cpp
+ * @brief Tests for LLSlabPool
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+#include "../test/lltut.h"
+
+#include "../llslabpool.h"
+
+#include <set>
+
+namespace tut
+{
+    struct slabpool
+    {
+    };
+
+    typedef test_group<slabpool> slabpool_t;
+    typedef slabpool_t::object slabpool_object_t;
+    tut::slabpool_t tut_slabpool("LLSlabPool");
+
+    template<> template<>
+    void slabpool_object_t::test<1>()
+    {
+        set_test_name("distinct aligned blocks");
+        LLSlabPool pool(40);
+        ensure_equals("rounded block size", pool.getBlockSize(), (size_t)48);
+
+        std::set<U8*> blocks;
+        for (U32 i = 0; i < 1000; ++i)
+        {
+            U8* block = (U8*)pool.allocate();
+            ensure("aligned", ((uintptr_t)block & 15) == 0);
+            memset(block, 0xAB, pool.getBlockSize());
+            ensure("distinct", blocks.insert(block).second);
+        }
+        ensure_equals("allocated", pool.getAllocatedCount(), 1000U);
+        ensure("reserved", pool.getReservedBytes() >= 1000 * pool.getBlockSize());
+
+        // blocks must not overlap
+        U8* prev = nullptr;
+        for (U8* block : blocks)
+        {
+            ensure("overlap", !prev || block >= prev + pool.getBlockSize());
+            prev = block;
+        }
+    }
+
+    template<> template<>
+    void slabpool_object_t::test<2>()
+    {
+        set_test_name("freed blocks are reused");
+        LLSlabPool pool(64);
+        void* a = pool.allocate();
+        void* b = pool.allocate();
+        size_t reserved = pool.getReservedBytes();
+
+        pool.free(a);
+        pool.free(b);
+        ensure_equals("none allocated", pool.getAllocatedCount(), 0U);
+        ensure("b reused first", pool.allocate() == b);
+        ensure("then a", pool.allocate() == a);
+        ensure_equals("no new slab", pool.getReservedBytes(), reserved);
+
+        pool.free(nullptr);
+        ensure_equals("free(nullptr) is a no-op", pool.getAllocatedCount(), 2U);
+    }
+
+    template<> template<>
+    void slabpool_object_t::test<3>()
+    {
+        set_test_name("sized pools and tags");
+        static LLMemTag tag("llslabpool test");
+        {
+            LLSizedSlabPools pools(&tag);
+            void* a = pools.allocate(40);
+            void* b = pools.allocate(100);
+            void* c = pools.allocate(44);
+            ensure("aligned", ((uintptr_t)a & 15) == 0 && ((uintptr_t)b & 15) == 0);
+            ensure_equals("allocated", pools.getAllocatedCount(), 3U);
+            ensure_equals("slabs claimed", tag.getBytes(), (S64)pools.getReservedBytes());
+
+            // 40 and 44 round to the same block size, so share a pool
+            pools.free(a, 40);
+            ensure("same pool", pools.allocate(44) == a);
+            pools.free(a, 44);
+            pools.free(b, 100);
+            pools.free(c, 44);
+            ensure_equals("none allocated", pools.getAllocatedCount(), 0U);
+        }
+        ensure_equals("slabs disclaimed", tag.getBytes(), (S64)0);
+    }
+}
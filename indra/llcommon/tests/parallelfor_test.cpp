@@ -0,0 +1,118 @@
+/**
+ * @file   parallelfor_test.cpp
+ * @date   2024-11-04
+ * @brief  Test for parallelfor.
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Copyright (c) 2024, Linden Research, Inc.
+ * $/LicenseInfo$
+ */
+
+// Precompiled header
+#include "linden_common.h"
+// associated header
+#include "parallelfor.h"
+// STL headers
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+// std headers
+// external library headers
+// other Linden headers
+#include "../test/lltut.h"
+#include "stringize.h"
+
+using namespace LL;
+
+/*****************************************************************************
+*   TUT
+*****************************************************************************/
+namespace tut
+{
+    struct parallelfor_data
+    {
+    };
+    typedef test_group<parallelfor_data> parallelfor_group;
+    typedef parallelfor_group::object object;
+    parallelfor_group parallelforgrp("parallelfor");
+
+    template<> template<>
+    void object::test<1>()
+    {
+        set_test_name("no pool");
+        // with no ThreadPool by that name, everything runs on this thread
+        std::vector<int> visited(100, 0);
+        parallel_for("parallelfor_nopool", visited.size(),
+                     [&visited](size_t i){ ++visited[i]; });
+        for (size_t i = 0; i < visited.size(); ++i)
+        {
+            ensure_equals(STRINGIZE("index " << i), visited[i], 1);
+        }
+    }
+
+    template<> template<>
+    void object::test<2>()
+    {
+        set_test_name("pool");
+        ThreadPool pool("parallelfor_pool", 3, 1024, false);
+        pool.start();
+
+        std::vector<std::atomic<int>> visited(1000);
+        for (auto& v : visited)
+        {
+            v = 0;
+        }
+        parallel_for("parallelfor_pool", visited.size(),
+                     [&visited](size_t i){ ++visited[i]; }, 7);
+        for (size_t i = 0; i < visited.size(); ++i)
+        {
+            ensure_equals(STRINGIZE("index " << i), visited[i].load(), 1);
+        }
+
+        pool.close();
+    }
+
+    template<> template<>
+    void object::test<3>()
+    {
+        set_test_name("empty");
+        bool called = false;
+        parallel_for("parallelfor_nopool", 0, [&called](size_t){ called = true; });
+        ensure("called with no work", ! called);
+    }
+
+    template<> template<>
+    void object::test<4>()
+    {
+        set_test_name("work stealing pool");
+        WorkStealingPool pool("parallelfor_stealing", 4, 1024, false);
+        pool.start();
+
+        // uneven loop bodies, so idle workers have something to steal
+        std::vector<std::atomic<int>> visited(2000);
+        for (auto& v : visited)
+        {
+            v = 0;
+        }
+        for (int pass = 0; pass < 10; ++pass)
+        {
+            parallel_for("parallelfor_stealing", visited.size(),
+                         [&visited](size_t i)
+                         {
+                             if (i % 97 == 0)
+                             {
+                                 std::this_thread::sleep_for(std::chrono::microseconds(50));
+                             }
+                             ++visited[i];
+                         }, 3);
+        }
+        for (size_t i = 0; i < visited.size(); ++i)
+        {
+            ensure_equals(STRINGIZE("index " << i), visited[i].load(), 10);
+        }
+
+        pool.close();
+        ensure("drained", pool.getQueue().done());
+    }
+} // namespace tut
@@ -0,0 +1,135 @@
+/**
+ * @file   workfuture_test.cpp
+ * @date   2026-10-15
+ * @brief  Test for workfuture.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Copyright (c) 2026, Linden Research, Inc.
+ * $/LicenseInfo$
+ */
+
+// Precompiled header
+#include "linden_common.h"
+// associated header
+#include "workfuture.h"
+// STL headers
+#include <string>
+#include <vector>
+// std headers
+// external library headers
+// other Linden headers
+#include "../test/lltut.h"
+#include "../test/catch_and_store_what_in.h"
+#include "llcoros.h"
+#include "lleventcoro.h"
+#include "stringize.h"
+
+using namespace LL;
+using namespace std::literals::string_literals; // s suffix
+
+/*****************************************************************************
+*   TUT
+*****************************************************************************/
+namespace tut
+{
+    struct workfuture_data
+    {
+        WorkQueue queue{"workfuture"};
+    };
+    typedef test_group<workfuture_data> workfuture_group;
+    typedef workfuture_group::object object;
+    workfuture_group workfuturegrp("workfuture");
+
+    template<> template<>
+    void object::test<1>()
+    {
+        set_test_name("get");
+        // waiting on this thread's main coroutine must throw
+        auto future{ postFuture("workfuture", [](){ return 17; }) };
+        auto what{ catch_what<WorkQueueBase::Error>([&future](){ future.get(); }) };
+        ensure(STRINGIZE("should mention get: " << what),
+               what.find("get()") != std::string::npos);
+        queue.runPending();
+
+        int result = 0;
+        LLCoros::instance().launch(
+            "workfuture get",
+            [&result]()
+            {
+                auto future{ postFuture("workfuture", [](){ return 42; }) };
+                result = future.get();
+            });
+        llcoro::suspend();
+        ensure_equals("ran too soon", result, 0);
+        queue.runOne();
+        llcoro::suspend();
+        ensure_equals("bad get() result", result, 42);
+    }
+
+    template<> template<>
+    void object::test<2>()
+    {
+        set_test_name("when_all");
+        std::vector<int> results;
+        std::string what;
+        LLCoros::instance().launch(
+            "workfuture when_all",
+            [&results, &what]()
+            {
+                std::vector<WorkFuture<int>> futures;
+                for (int i = 0; i < 3; ++i)
+                {
+                    futures.push_back(postFuture("workfuture", [i](){ return i * 10; }));
+                }
+                results = when_all(futures);
+
+                std::vector<WorkFuture<void>> voids;
+                voids.push_back(postFuture("workfuture", [](){}));
+                voids.push_back(postFuture("workfuture", [](){ LLTHROW(LLException("second")); }));
+                what = catch_what<LLException>([&voids](){ when_all(voids); });
+            });
+        llcoro::suspend();
+        queue.runPending();
+        llcoro::suspend();
+        ensure_equals("results", results.size(), (size_t)3);
+        for (int i = 0; i < 3; ++i)
+        {
+            ensure_equals(STRINGIZE("result " << i), results[i], i * 10);
+        }
+        queue.runPending();
+        llcoro::suspend();
+        ensure_equals("exception", what, "second");
+    }
+
+    template<> template<>
+    void object::test<3>()
+    {
+        set_test_name("when_any and cancel");
+        WorkQueue other{"workfuture_other"};
+        size_t first = 99;
+        std::string result;
+        std::string what;
+        LLCoros::instance().launch(
+            "workfuture when_any",
+            [&first, &result, &what]()
+            {
+                CancelToken token;
+                std::vector<WorkFuture<std::string>> futures;
+                futures.push_back(postFuture("workfuture", [](){ return "slow"s; }, token));
+                futures.push_back(postFuture("workfuture_other", [](){ return "fast"s; }, token));
+                first = when_any(futures);
+                result = futures[first].get();
+                // the loser has not started yet, so it is dropped
+                token.cancel();
+                what = catch_what<CancelToken::Cancelled>([&futures](){ futures[0].get(); });
+            });
+        llcoro::suspend();
+        other.runOne();
+        llcoro::suspend();
+        ensure_equals("first", first, (size_t)1);
+        ensure_equals("result", result, "fast");
+        queue.runOne();
+        llcoro::suspend();
+        ensure_not("should have been cancelled", what.empty());
+    }
+} // namespace tut
@@ -15,8 +15,10 @@
 #include "workqueue.h"
 // STL headers
 // std headers
+#include <algorithm>
 #include <chrono>
 #include <deque>
+#include <vector>
 // external library headers
 // other Linden headers
 #include "../test/lltut.h"
@@ -236,4 +238,42 @@ namespace tut
         ensure_equals("didn't run coroutine", stored, "ran");
         ensure("void waitForResult() didn't return", done);
     }
+
+    template<> template<>
+    void object::test<7>()
+    {
+        set_test_name("WorkStealingQueue");
+        WorkStealingQueue lanes("lanes", 4, 3);
+        ensure_equals("lanes", lanes.getLanes(), (size_t)3);
+        ensure("findable", WorkQueueBase::getInstance("lanes") == lanes.getWeak().lock());
+
+        // this thread claims a lane on first pop, so the items are stolen
+        // from the others whatever lane they went to
+        std::vector<int> ran;
+        for (int i = 0; i < 4; ++i)
+        {
+            ensure(STRINGIZE("post " << i), lanes.postToLane(i, [&ran, i](){ ran.push_back(i); }));
+        }
+        ensure("tryPost beyond capacity", ! lanes.tryPost([](){}));
+        ensure_equals("size", lanes.size(), (size_t)4);
+        lanes.runPending();
+        ensure_equals("ran all", ran.size(), (size_t)4);
+        std::sort(ran.begin(), ran.end());
+        for (int i = 0; i < 4; ++i)
+        {
+            ensure_equals(STRINGIZE("ran " << i), ran[i], i);
+        }
+
+        // work posted by a worker goes to its own lane
+        bool nested{ false };
+        lanes.post([&lanes, &nested](){ lanes.post([&nested](){ nested = true; }); });
+        lanes.runOne();
+        ensure("nested ran too soon", ! nested);
+        lanes.close();
+        ensure("post after close", ! lanes.post([](){}));
+        ensure("not drained", ! lanes.done());
+        lanes.runUntilClose();
+        ensure("nested didn't run", nested);
+        ensure("drained", lanes.done());
+    }
 } // namespace tut
@@ -136,6 +136,28 @@ namespace LL
     /// ThreadPool is shorthand for using the simpler WorkQueue
     using ThreadPool = ThreadPoolUsing<WorkQueue>;
 
+    /**
+     * WorkStealingPool gives each of its threads its own lane of a
+     * WorkStealingQueue, for pools running many small tasks. Submitters can
+     * steer work to a worker with getQueue().postToLane().
+     */
+    struct WorkStealingPool: public ThreadPoolBase
+    {
+        using queue_t = WorkStealingQueue;
+
+        WorkStealingPool(const std::string& name,
+                         size_t threads=1,
+                         size_t capacity=1024*1024,
+                         bool auto_shutdown = true):
+            ThreadPoolBase(name, threads,
+                           new queue_t(name, capacity, getConfiguredWidth(name, threads)),
+                           auto_shutdown)
+        {}
+        ~WorkStealingPool() override {}
+
+        queue_t& getQueue() { return static_cast<queue_t&>(*mQueue); }
+    };
+
 } // namespace LL
 
 #endif /* ! defined(LL_THREADPOOL_H) */
@@ -0,0 +1,302 @@
+/**
+ * @file   workfuture.h
+ * @date   2026-10-15
+ * @brief  Awaitable WorkQueue tasks for coroutines: postFuture(),
+ *         when_all(), when_any() and CancelToken.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Copyright (c) 2026, Linden Research, Inc.
+ * $/LicenseInfo$
+ */
+
+#if ! defined(LL_WORKFUTURE_H)
+#define LL_WORKFUTURE_H
+
+#include "llcoros.h"
+#include "llexception.h"
+#include "workqueue.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace LL
+{
+
+    /**
+     * CancelToken is a cheaply copied handle on a shared cancellation flag.
+     * Pass one to postFuture() to drop tasks that have not started yet when
+     * cancel() is called; a task that accepts a const CancelToken& is also
+     * handed the token so a long computation can poll it.
+     */
+    class CancelToken
+    {
+    public:
+        struct Cancelled: public LLContinueError
+        {
+            Cancelled(): LLContinueError("WorkFuture task cancelled") {}
+        };
+
+        CancelToken(): mFlag(std::make_shared<std::atomic<bool>>(false)) {}
+
+        void cancel() const { mFlag->store(true); }
+        bool isCancelled() const { return mFlag->load(); }
+        /// throw Cancelled if cancel() has been called
+        void check() const
+        {
+            if (isCancelled())
+            {
+                LLTHROW(Cancelled());
+            }
+        }
+
+    private:
+        std::shared_ptr<std::atomic<bool>> mFlag;
+    };
+
+    /// Shared between a WorkFuture and the task posted by postFuture()
+    template <typename T>
+    struct WorkFutureState
+    {
+        WorkFutureState(const CancelToken& token): mToken(token) {}
+
+        template <typename CALLABLE>
+        void run(CALLABLE& callable)
+        {
+            try
+            {
+                mToken.check();
+                if constexpr (std::is_void_v<T>)
+                {
+                    invoke(callable);
+                    mPromise.set_value();
+                }
+                else
+                {
+                    mPromise.set_value(invoke(callable));
+                }
+            }
+            catch (...)
+            {
+                mPromise.set_exception(std::current_exception());
+            }
+            finish();
+        }
+
+        template <typename CALLABLE>
+        T invoke(CALLABLE& callable)
+        {
+            if constexpr (std::is_invocable_v<CALLABLE&, const CancelToken&>)
+            {
+                return callable(mToken);
+            }
+            else
+            {
+                return callable();
+            }
+        }
+
+        void finish()
+        {
+            std::vector<std::function<void()>> listeners;
+            {
+                LLCoros::LockType lock(mMutex);
+                mDone = true;
+                listeners.swap(mListeners);
+            }
+            for (const auto& listener : listeners)
+            {
+                listener();
+            }
+        }
+
+        CancelToken mToken;
+        LLCoros::Promise<T> mPromise;
+        LLCoros::Mutex mMutex;
+        std::atomic<bool> mDone{ false };
+        std::vector<std::function<void()>> mListeners;
+    };
+
+    /// Same convention as WorkQueueBase::checkCoroutine(): waiting on a
+    /// thread's default coroutine would stall the loop that services it.
+    inline void checkAwaitingCoroutine(const std::string& method)
+    {
+        if (LLCoros::getName().empty())
+        {
+            LLTHROW(WorkQueueBase::Error("Do not call " + method + " from a thread's default coroutine"));
+        }
+    }
+
+    /**
+     * WorkFuture is the result of a task posted with postFuture(). A
+     * coroutine calling get() is suspended until the task has run on its
+     * WorkQueue, then receives its return value or its exception. As with
+     * waitForResult(), a thread's default coroutine may not wait.
+     *
+     * Unlike WorkQueueBase::waitForResult(), posting and waiting are
+     * separate steps, so one coroutine can start several independent tasks
+     * and then wait for all of them (when_all()) or the first of them
+     * (when_any()) without blocking its thread's main loop.
+     */
+    template <typename T>
+    class WorkFuture
+    {
+    public:
+        WorkFuture() = default;
+        /// see postFuture()
+        explicit WorkFuture(const std::shared_ptr<WorkFutureState<T>>& state):
+            mState(state),
+            mFuture(LLCoros::getFuture(state->mPromise))
+        {}
+
+        bool valid() const { return mFuture.valid(); }
+        /// true once the task has finished, successfully or not
+        bool isReady() const { return mState && mState->mDone.load(); }
+        const CancelToken& getToken() const { return mState->mToken; }
+        /// Cancel the task if it has not started yet. Shares the token
+        /// passed to postFuture(), so this cancels its siblings as well.
+        void cancel() const { mState->mToken.cancel(); }
+
+        /// Suspend the calling coroutine until the task has finished
+        void wait()
+        {
+            checkAwaitingCoroutine("WorkFuture::wait()");
+            LLCoros::TempStatus st("waiting for WorkFuture");
+            mFuture.wait();
+        }
+
+        /// Suspend the calling coroutine until the task has finished and
+        /// return its result, or rethrow its exception. Call only once.
+        T get()
+        {
+            checkAwaitingCoroutine("WorkFuture::get()");
+            LLCoros::TempStatus st("waiting for WorkFuture");
+            return mFuture.get();
+        }
+
+        /// Call func once the task has finished: right away if it already
+        /// has, otherwise on the thread that ran it
+        void onDone(const std::function<void()>& func) const
+        {
+            {
+                LLCoros::LockType lock(mState->mMutex);
+                if (! mState->mDone)
+                {
+                    mState->mListeners.push_back(func);
+                    return;
+                }
+            }
+            func();
+        }
+
+    private:
+        std::shared_ptr<WorkFutureState<T>> mState;
+        LLCoros::Future<T> mFuture;
+    };
+
+    /**
+     * Post callable to the target WorkQueue and return a WorkFuture for its
+     * result. callable may take no arguments, or a const CancelToken& which
+     * receives token. Throws WorkQueueBase::Closed if target is gone or
+     * closed.
+     */
+    template <typename CALLABLE>
+    auto postFuture(WorkQueueBase::weak_t target, CALLABLE&& callable,
+                    const CancelToken& token = CancelToken())
+    {
+        using callable_t = std::decay_t<CALLABLE>;
+        using result_t = std::conditional_t<std::is_invocable_v<callable_t&, const CancelToken&>,
+                                            std::invoke_result<callable_t&, const CancelToken&>,
+                                            std::invoke_result<callable_t&>>;
+        using value_t = typename result_t::type;
+
+        auto state{ std::make_shared<WorkFutureState<value_t>>(token) };
+        WorkFuture<value_t> future(state);
+        auto tptr{ target.lock() };
+        if (! tptr ||
+            ! tptr->post([state, callable = std::forward<CALLABLE>(callable)]()
+                         mutable { state->run(callable); }))
+        {
+            LLTHROW(WorkQueueBase::Closed());
+        }
+        return future;
+    }
+
+    /// Post callable to the WorkQueue (or ThreadPool) named queue
+    template <typename CALLABLE>
+    auto postFuture(const std::string& queue, CALLABLE&& callable,
+                    const CancelToken& token = CancelToken())
+    {
+        return postFuture(WorkQueueBase::weak_t(WorkQueueBase::getInstance(queue)),
+                          std::forward<CALLABLE>(callable), token);
+    }
+
+    /**
+     * Suspend the calling coroutine until every one of futures has finished
+     * and return their results in order. If any task threw, the first such
+     * exception (in order) is rethrown, after all have finished.
+     */
+    template <typename T>
+    std::vector<T> when_all(std::vector<WorkFuture<T>>& futures)
+    {
+        for (auto& future : futures)
+        {
+            future.wait();
+        }
+        std::vector<T> results;
+        results.reserve(futures.size());
+        for (auto& future : futures)
+        {
+            results.push_back(future.get());
+        }
+        return results;
+    }
+
+    inline void when_all(std::vector<WorkFuture<void>>& futures)
+    {
+        for (auto& future : futures)
+        {
+            future.wait();
+        }
+        for (auto& future : futures)
+        {
+            future.get();
+        }
+    }
+
+    /**
+     * Suspend the calling coroutine until the first of futures has finished
+     * and return its index; call get() on it for the result. The other
+     * tasks keep running unless the caller cancels them.
+     */
+    template <typename T>
+    size_t when_any(const std::vector<WorkFuture<T>>& futures)
+    {
+        if (futures.empty())
+        {
+            LLTHROW(WorkQueueBase::Error("when_any() of no futures"));
+        }
+        auto fired{ std::make_shared<std::atomic<bool>>(false) };
+        auto first{ std::make_shared<LLCoros::Promise<size_t>>() };
+        auto index{ LLCoros::getFuture(*first) };
+        checkAwaitingCoroutine("when_any()");
+        for (size_t i = 0; i < futures.size(); ++i)
+        {
+            futures[i].onDone([fired, first, i]()
+                              {
+                                  if (! fired->exchange(true))
+                                  {
+                                      first->set_value(i);
+                                  }
+                              });
+        }
+        LLCoros::TempStatus st("waiting for when_any()");
+        return index.get();
+    }
+
+} // namespace LL
+
+#endif /* ! defined(LL_WORKFUTURE_H) */
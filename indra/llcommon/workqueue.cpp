@@ -14,8 +14,13 @@
 // associated header
 #include "workqueue.h"
 // STL headers
+#include <atomic>
+#include <thread>
+#include <vector>
 // std headers
 // external library headers
+#include "concurrentqueue.h"
+#include "lightweightsemaphore.h"
 // other Linden headers
 #include "llcoros.h"
 #include LLCOROS_MUTEX_HEADER
@@ -243,3 +248,152 @@ bool LL::WorkSchedule::tryPop_(Work& work)
 {
     return mQueue.tryPop(work);
 }
+
+/*****************************************************************************
+*   WorkStealingQueue
+*****************************************************************************/
+struct LL::WorkStealingQueue::Lanes
+{
+    Lanes(size_t lanes, size_t capacity):
+        mLanes(lanes),
+        mCapacity(capacity)
+    {}
+
+    std::vector<moodycamel::ConcurrentQueue<Work>> mLanes;
+    // One count per queued item, plus the wakeup passed along by close()
+    moodycamel::LightweightSemaphore mItems;
+    std::atomic<size_t> mSize{ 0 };
+    std::atomic<size_t> mNextPost{ 0 };
+    std::atomic<size_t> mNextWorker{ 0 };
+    std::atomic<bool> mClosed{ false };
+    size_t mCapacity;
+};
+
+namespace
+{
+    // Lane of the current thread, claimed the first time it takes work
+    struct WorkerLane
+    {
+        const void* mOwner{ nullptr };
+        size_t mLane{ 0 };
+    };
+    thread_local WorkerLane sWorkerLane;
+}
+
+LL::WorkStealingQueue::WorkStealingQueue(const std::string& name, size_t capacity, size_t lanes):
+    super(name),
+    mLanes(std::make_unique<Lanes>(lanes ? lanes : std::max(1u, std::thread::hardware_concurrency()),
+                                   capacity))
+{
+}
+
+LL::WorkStealingQueue::~WorkStealingQueue()
+{
+}
+
+void LL::WorkStealingQueue::close()
+{
+    if (! mLanes->mClosed.exchange(true))
+    {
+        // Wake one waiting worker, each passes the wakeup on as it leaves
+        mLanes->mItems.signal();
+    }
+}
+
+size_t LL::WorkStealingQueue::size()
+{
+    return mLanes->mSize.load();
+}
+
+bool LL::WorkStealingQueue::isClosed()
+{
+    return mLanes->mClosed.load();
+}
+
+bool LL::WorkStealingQueue::done()
+{
+    return mLanes->mClosed.load() && mLanes->mSize.load() == 0;
+}
+
+size_t LL::WorkStealingQueue::getLanes() const
+{
+    return mLanes->mLanes.size();
+}
+
+bool LL::WorkStealingQueue::post(const Work& callable)
+{
+    if (sWorkerLane.mOwner == mLanes.get())
+    {
+        // keep work spawned by a worker local to it
+        return postToLane(sWorkerLane.mLane, callable);
+    }
+    return postToLane(mLanes->mNextPost.fetch_add(1), callable);
+}
+
+bool LL::WorkStealingQueue::tryPost(const Work& callable)
+{
+    if (mLanes->mSize.load() >= mLanes->mCapacity)
+    {
+        return false;
+    }
+    return post(callable);
+}
+
+bool LL::WorkStealingQueue::postToLane(size_t lane, const Work& callable)
+{
+    if (mLanes->mClosed.load())
+    {
+        return false;
+    }
+    mLanes->mLanes[lane % mLanes->mLanes.size()].enqueue(callable);
+    ++mLanes->mSize;
+    mLanes->mItems.signal();
+    return true;
+}
+
+bool LL::WorkStealingQueue::take(Work& work)
+{
+    if (sWorkerLane.mOwner != mLanes.get())
+    {
+        sWorkerLane.mOwner = mLanes.get();
+        sWorkerLane.mLane = mLanes->mNextWorker.fetch_add(1) % mLanes->mLanes.size();
+    }
+
+    // Holding a count guarantees an item is queued somewhere (unless it's
+    // the close() wakeup), but another thread may be racing us for any
+    // particular one: keep looking until we get one.
+    const size_t lanes = mLanes->mLanes.size();
+    for (;;)
+    {
+        for (size_t i = 0; i < lanes; ++i)
+        {
+            if (mLanes->mLanes[(sWorkerLane.mLane + i) % lanes].try_dequeue(work))
+            {
+                --mLanes->mSize;
+                return true;
+            }
+        }
+        if (done())
+        {
+            mLanes->mItems.signal();
+            return false;
+        }
+        std::this_thread::yield();
+    }
+}
+
+LL::WorkStealingQueue::Work LL::WorkStealingQueue::pop_()
+{
+    mLanes->mItems.wait();
+    Work work;
+    if (! take(work))
+    {
+        LLTHROW(Closed());
+    }
+    return work;
+}
+
+bool LL::WorkStealingQueue::tryPop_(Work& work)
+{
+    return mLanes->mItems.tryWait() && take(work);
+}
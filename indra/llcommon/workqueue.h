@@ -20,6 +20,7 @@
 #include <chrono>
 #include <exception>                // std::current_exception
 #include <functional>               // std::function
+#include <memory>                   // std::unique_ptr
 #include <string>
 
 namespace LL
@@ -354,6 +355,72 @@ namespace LL
         bool tryPop_(Work&) override;
     };
 
+/*****************************************************************************
+*   WorkStealingQueue: per-worker lanes, idle workers steal
+*****************************************************************************/
+    /**
+     * WorkStealingQueue divides its work among lock-free lanes, one per
+     * worker thread, instead of one mutex-guarded queue, so that many
+     * workers running fine-grained tasks don't serialize on the queue lock.
+     * A worker takes work from its own lane first and steals from the other
+     * lanes when its own is empty.
+     *
+     * Work posted by a worker goes to its own lane. Other threads spread
+     * their posts round-robin, or name a lane with postToLane() to keep
+     * related tasks on one worker. Order is only kept within a lane.
+     *
+     * capacity only limits tryPost(): post() never blocks.
+     */
+    class WorkStealingQueue: public LLInstanceTrackerSubclass<WorkStealingQueue, WorkQueueBase>
+    {
+    private:
+        using super = LLInstanceTrackerSubclass<WorkStealingQueue, WorkQueueBase>;
+
+    public:
+        /**
+         * lanes should match the number of worker threads; 0 means one per
+         * hardware thread.
+         */
+        WorkStealingQueue(const std::string& name = std::string(), size_t capacity=1024,
+                          size_t lanes=0);
+        ~WorkStealingQueue() override;
+
+        void close() override;
+        /// approximate, see WorkQueue::size()
+        size_t size() override;
+        bool isClosed() override;
+        bool done() override;
+
+        /*---------------------- fire and forget API -----------------------*/
+
+        /**
+         * post work, unless the queue is closed
+         */
+        bool post(const Work&) override;
+
+        /**
+         * post work, unless the queue is closed or full
+         */
+        bool tryPost(const Work&) override;
+
+        /**
+         * post work to lane (modulo getLanes()), as a hint that the worker
+         * owning that lane should run it, unless the queue is closed
+         */
+        bool postToLane(size_t lane, const Work&);
+
+        size_t getLanes() const;
+
+    private:
+        struct Lanes;
+        std::unique_ptr<Lanes> mLanes;
+
+        Work pop_() override;
+        bool tryPop_(Work&) override;
+        // after acquiring an item count, find the item
+        bool take(Work& work);
+    };
+
     /**
      * BackJack is, in effect, a hand-rolled lambda, binding a WorkSchedule, a
      * CALLABLE that returns bool, a TimePoint and an interval at which to
@@ -134,6 +134,13 @@ constexpr HttpTime HTTP_RETRY_BACKOFF_MIN_DEFAULT = 1000000UL; // 1 sec
 constexpr HttpTime HTTP_RETRY_BACKOFF_MAX_DEFAULT = 50000006UL; // 5 sec
 constexpr HttpTime HTTP_RETRY_BACKOFF_MAX = 20000000UL; // 20 sec
 
+// Ready queues are served earliest deadline first.  Requests without
+// a queue deadline of their own are ordered as if they had this one
+// (but never expire), so a steady stream of short deadlines can't
+// starve them.
+constexpr unsigned int HTTP_QUEUE_DEADLINE_DEFAULT = 10000U; // 10 sec, in ms
+constexpr unsigned int HTTP_QUEUE_DEADLINE_MAX = 3600000U; // 1 hour, in ms
+
 constexpr int HTTP_REDIRECTS_DEFAULT = 10;
 
 // Timeout value used for both connect and protocol exchange.
@@ -149,10 +156,23 @@ constexpr int HTTP_CONNECTION_LIMIT_DEFAULT = 8;
 constexpr int HTTP_CONNECTION_LIMIT_MIN = 1;
 constexpr int HTTP_CONNECTION_LIMIT_MAX = 256;
 
+// Largest response body, by Content-Length, allocated as a single
+// block up front
+constexpr size_t HTTP_BODY_RESERVE_MAX = 16U * 1024U * 1024U;
+
+// Threads giving libcurl cycles, including the worker thread
+constexpr int HTTP_TRANSPORT_THREADS_DEFAULT = 1;
+constexpr int HTTP_TRANSPORT_THREADS_MIN = 1;
+constexpr int HTTP_TRANSPORT_THREADS_MAX = 8;
+
 // Pipelining limits
 constexpr long HTTP_PIPELINING_DEFAULT = 0L;
 constexpr long HTTP_PIPELINING_MAX = 20L;
 
+// HTTP/2 multiplexing limits (streams per connection)
+constexpr long HTTP_MULTIPLEX_DEFAULT = 0L;
+constexpr long HTTP_MULTIPLEX_MAX = 100L;
+
 // Miscellaneous defaults
 constexpr bool HTTP_USE_RETRY_AFTER_DEFAULT = true;
 constexpr long HTTP_THROTTLE_RATE_DEFAULT = 0L;
@@ -64,7 +64,10 @@ HttpLibcurl::HttpLibcurl(HttpService * service)
       mPolicyCount(0),
       mMultiHandles(NULL),
       mActiveHandles(NULL),
-      mDirtyPolicy(NULL)
+      mDirtyPolicy(NULL),
+      mPerformRound(0),
+      mPerformPending(0),
+      mPerformExit(false)
 {}
 
 
@@ -78,6 +81,8 @@ HttpLibcurl::~HttpLibcurl()
 
 void HttpLibcurl::shutdown()
 {
+    stopPerformThreads();
+
     while (! mActiveOps.empty())
     {
         HttpOpRequest::ptr_t op(* mActiveOps.begin());
@@ -111,7 +116,7 @@ void HttpLibcurl::shutdown()
 }
 
 
-void HttpLibcurl::start(int policy_count)
+void HttpLibcurl::start(int policy_count, int thread_count)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_NETWORK;
     llassert_always(policy_count <= HTTP_POLICY_CLASS_LIMIT);
@@ -133,6 +138,92 @@ void HttpLibcurl::start(int policy_count)
         mDirtyPolicy[policy_class] = false;
         policyUpdated(policy_class);
     }
+
+    // No point in threads that would have no class to serve
+    thread_count = llclamp(thread_count, 1, policy_count);
+    mPerformExit = false;
+    for (int shard(1); shard < thread_count; ++shard)
+    {
+        mPerformThreads.emplace_back(&HttpLibcurl::performThread, this, shard);
+    }
+}
+
+
+void HttpLibcurl::stopPerformThreads()
+{
+    if (mPerformThreads.empty())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mPerformMutex);
+        mPerformExit = true;
+    }
+    mPerformStart.notify_all();
+    for (std::thread & thread : mPerformThreads)
+    {
+        thread.join();
+    }
+    mPerformThreads.clear();
+}
+
+
+void HttpLibcurl::performThread(unsigned int shard)
+{
+    const std::string name("HttpTransport" + std::to_string(shard));
+    LL_PROFILER_SET_THREAD_NAME(name.c_str());
+
+    U32 round(0);
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mPerformMutex);
+            mPerformStart.wait(lock, [&]() { return mPerformExit || mPerformRound != round; });
+            if (mPerformExit)
+            {
+                return;
+            }
+            round = mPerformRound;
+        }
+
+        performShard(shard);
+
+        {
+            std::lock_guard<std::mutex> lock(mPerformMutex);
+            if (0 == --mPerformPending)
+            {
+                mPerformDone.notify_one();
+            }
+        }
+    }
+}
+
+
+void HttpLibcurl::performShard(unsigned int shard)
+{
+    const unsigned int shards(static_cast<unsigned int>(mPerformThreads.size()) + 1);
+    for (unsigned int policy_class(shard); policy_class < mPolicyCount; policy_class += shards)
+    {
+        if (mMultiHandles[policy_class] && mActiveHandles[policy_class])
+        {
+            performClass(policy_class);
+        }
+    }
+}
+
+
+void HttpLibcurl::performClass(unsigned int policy_class)
+{
+    int running(0);
+    CURLMcode status(CURLM_CALL_MULTI_PERFORM);
+    do
+    {
+        LL_PROFILE_ZONE_NAMED_CATEGORY_NETWORK("httppt - curl_multi_perform");
+        running = 0;
+        status = curl_multi_perform(mMultiHandles[policy_class], &running);
+    }
+    while (0 != running && CURLM_CALL_MULTI_PERFORM == status);
 }
 
 
@@ -147,7 +238,39 @@ HttpService::ELoopSpeed HttpLibcurl::processTransport()
     LL_PROFILE_ZONE_SCOPED_CATEGORY_NETWORK;
     HttpService::ELoopSpeed ret(HttpService::REQUEST_SLEEP);
 
-    // Give libcurl some cycles to do I/O & callbacks
+    // Give libcurl some cycles to do I/O & callbacks.  Helpers only
+    // touch their classes' multi handles and the requests on them,
+    // and only until they report back.
+    const unsigned int shards(static_cast<unsigned int>(mPerformThreads.size()) + 1);
+    bool helpers_needed(false);
+    for (unsigned int policy_class(0); policy_class < mPolicyCount; ++policy_class)
+    {
+        if (policy_class % shards && mMultiHandles[policy_class] && mActiveHandles[policy_class])
+        {
+            helpers_needed = true;
+            break;
+        }
+    }
+    if (helpers_needed)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mPerformMutex);
+            ++mPerformRound;
+            mPerformPending = shards - 1;
+        }
+        mPerformStart.notify_all();
+
+        performShard(0);
+
+        std::unique_lock<std::mutex> lock(mPerformMutex);
+        mPerformDone.wait(lock, [&]() { return 0 == mPerformPending; });
+    }
+    else
+    {
+        performShard(0);
+    }
+
+    // Complete requests, serially on this thread
     for (unsigned int policy_class(0); policy_class < mPolicyCount; ++policy_class)
     {
         if (! mMultiHandles[policy_class])
@@ -166,16 +289,6 @@ HttpService::ELoopSpeed HttpLibcurl::processTransport()
             continue;
         }
 
-        int running(0);
-        CURLMcode status(CURLM_CALL_MULTI_PERFORM);
-        do
-        {
-            LL_PROFILE_ZONE_NAMED_CATEGORY_NETWORK("httppt - curl_multi_perform");
-            running = 0;
-            status = curl_multi_perform(mMultiHandles[policy_class], &running);
-        }
-        while (0 != running && CURLM_CALL_MULTI_PERFORM == status);
-
         // Run completion on anything done
         CURLMsg * msg(NULL);
         int msgs_in_queue(0);
@@ -541,7 +654,26 @@ void HttpLibcurl::policyUpdated(unsigned int policy_class)
         policy.stallPolicy(policy_class, false);
         mDirtyPolicy[policy_class] = false;
 
-        if (options.mPipelining > 1)
+        if (options.mMultiplex > 1)
+        {
+            // HTTP/2 streams on shared connections.  Servers that only
+            // speak HTTP/1.1 get one request per connection.
+            check_curl_multi_setopt(multi_handle,
+                                     CURLMOPT_PIPELINING,
+                                     long(CURLPIPE_MULTIPLEX));
+#if LIBCURL_VERSION_NUM >= 0x074300
+            check_curl_multi_setopt(multi_handle,
+                                     CURLMOPT_MAX_CONCURRENT_STREAMS,
+                                     long(options.mMultiplex));
+#endif
+            check_curl_multi_setopt(multi_handle,
+                                     CURLMOPT_MAX_HOST_CONNECTIONS,
+                                     long(options.mPerHostConnectionLimit));
+            check_curl_multi_setopt(multi_handle,
+                                     CURLMOPT_MAX_TOTAL_CONNECTIONS,
+                                     long(options.mConnectionLimit));
+        }
+        else if (options.mPipelining > 1)
         {
             // We'll try to do pipelining on this multihandle
             check_curl_multi_setopt(multi_handle,
@@ -32,7 +32,10 @@
 #include <curl/curl.h>
 #include <curl/multi.h>
 
+#include <condition_variable>
+#include <mutex>
 #include <set>
+#include <thread>
 
 #include "httprequest.h"
 #include "_httpservice.h"
@@ -52,7 +55,11 @@ class HttpHeaders;
 ///
 /// Threading:  Single-threaded.  Other than for construction/destruction,
 /// all methods are expected to be invoked in a single thread, typically
-/// a worker thread of some sort.
+/// a worker thread of some sort.  With more than one transport thread,
+/// processTransport() hands the curl_multi_perform() calls of some
+/// policy classes to helper threads and waits for them, so libcurl
+/// callbacks (body and header writes) may run on those threads.
+/// Everything else, including completion, stays on the calling thread.
 
 class HttpLibcurl
 {
@@ -86,10 +93,13 @@ public:
 
     /// One-time call to set the number of policy classes to be
     /// serviced and to create the resources for each.  Value
-    /// must agree with HttpPolicy::setPolicies() call.
+    /// must agree with HttpPolicy::setPolicies() call.  Classes
+    /// are divided round-robin among thread_count threads for
+    /// curl_multi_perform(), the caller of processTransport()
+    /// being the first of them.
     ///
     /// Threading:  called by init thread.
-    void start(int policy_count);
+    void start(int policy_count, int thread_count = 1);
 
     /// Synchronously stop libcurl operations.  All active requests
     /// are canceled and removed from libcurl's handling.  Easy
@@ -144,6 +154,16 @@ public:
         }
 
 protected:
+    /// Run curl_multi_perform() on one class's multi handle or on
+    /// all active classes of one transport thread.
+    void performClass(unsigned int policy_class);
+    void performShard(unsigned int shard);
+
+    /// Body of the helper transport threads, running performShard()
+    /// once per round started by processTransport().
+    void performThread(unsigned int shard);
+    void stopPerformThreads();
+
     /// Invoked when libcurl has indicated a request has been processed
     /// to completion and we need to move the request to a new state.
     bool completeRequest(CURLM * multi_handle, CURL * handle, CURLcode status);
@@ -216,6 +236,15 @@ protected:
     int *               mActiveHandles;     // Active count per policy class
     bool *              mDirtyPolicy;       // Dirty policy update waiting for stall (per pc)
 
+    // Helper transport threads, empty when the worker does all transport
+    std::vector<std::thread> mPerformThreads;
+    std::mutex          mPerformMutex;
+    std::condition_variable mPerformStart;  // New round or exit, helpers wait
+    std::condition_variable mPerformDone;   // Last helper of round finished
+    U32                 mPerformRound;
+    U32                 mPerformPending;    // Helpers still running this round
+    bool                mPerformExit;
+
 }; // end class HttpLibcurl
 
 }  // end namespace LLCore
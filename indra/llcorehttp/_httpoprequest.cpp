@@ -145,6 +145,7 @@ HttpOpRequest::HttpOpRequest()
       mCurlTemp(NULL),
       mCurlTempLen(0),
       mReplyBody(NULL),
+      mReplySinkState(0),
       mReplyOffset(0),
       mReplyLength(0),
       mReplyFullLength(0),
@@ -155,6 +156,10 @@ HttpOpRequest::HttpOpRequest()
       mPolicyRetryLimit(HTTP_RETRY_COUNT_DEFAULT),
       mPolicyMinRetryBackoff(HttpTime(HTTP_RETRY_BACKOFF_MIN_DEFAULT)),
       mPolicyMaxRetryBackoff(HttpTime(HTTP_RETRY_BACKOFF_MAX_DEFAULT)),
+      mPolicyQueueDeadline(0U),
+      mPolicyEnqueuedAt(HttpTime(0)),
+      mPolicyDeadline(HttpTime(0)),
+      mPolicyExpires(false),
       mCallbackSSLVerify(NULL)
 {
     // *NOTE:  As members are added, retry initialization/cleanup
@@ -458,6 +463,8 @@ void HttpOpRequest::setupCommon(HttpRequest::policy_t policy_id,
 
         mPolicyMinRetryBackoff = llclamp(options->getMinBackoff(), HttpTime(0), HTTP_RETRY_BACKOFF_MAX);
         mPolicyMaxRetryBackoff = llclamp(options->getMaxBackoff(), mPolicyMinRetryBackoff, HTTP_RETRY_BACKOFF_MAX);
+        mPolicyQueueDeadline = llmin(options->getQueueDeadline(), HTTP_QUEUE_DEADLINE_MAX);
+        mReplySink = options->getBodySink();
     }
 }
 
@@ -488,6 +495,7 @@ HttpStatus HttpOpRequest::prepareRequest(HttpService * service)
         mReplyBody->release();
         mReplyBody = NULL;
     }
+    mReplySinkState = 0;
     mReplyOffset = 0;
     mReplyLength = 0;
     mReplyFullLength = 0;
@@ -728,7 +736,17 @@ HttpStatus HttpOpRequest::prepareRequest(HttpService * service)
     {
         xfer_timeout = timeout;
     }
-    if (cpolicy.mPipelining > 1L)
+    if (cpolicy.mMultiplex > 1L)
+    {
+        // Streams share the connection's bandwidth, so allow the same
+        // extra transfer time as pipelining.  Ask for HTTP/2 and wait
+        // for a connection that can multiplex rather than opening
+        // a new one for every request.
+        xfer_timeout *= 2L;
+        check_curl_easy_setopt(mCurlHandle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+        check_curl_easy_setopt(mCurlHandle, CURLOPT_PIPEWAIT, 1L);
+    }
+    else if (cpolicy.mPipelining > 1L)
     {
         // Pipelining affects both connection and transfer timeout values.
         // Requests that are added to a pipeling immediately have completed
@@ -799,12 +817,42 @@ size_t HttpOpRequest::writeCallback(void * data, size_t size, size_t nmemb, void
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_NETWORK;
     HttpOpRequest::ptr_t op(HttpOpRequest::fromHandle<HttpOpRequest>(userdata));
+    const size_t req_size(size * nmemb);
+
+    if (op->mReplySink && ! op->mReplySinkState)
+    {
+        // Headers are in by the first body write, only successful
+        // bodies go to the sink
+        long http_status(0);
+        curl_off_t content_length(-1);
+        curl_easy_getinfo(op->mCurlHandle, CURLINFO_RESPONSE_CODE, &http_status);
+        curl_easy_getinfo(op->mCurlHandle, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &content_length);
+        op->mReplySinkState = (http_status >= 200 && http_status < 300) ? 1 : -1;
+        if (op->mReplySinkState > 0 && ! op->mReplySink->begin(content_length > 0 ? size_t(content_length) : 0))
+        {
+            return 0;   // Aborts the transfer
+        }
+    }
+    if (op->mReplySinkState > 0)
+    {
+        HTTPStats::instance().recordDataDown(req_size);
+        return op->mReplySink->write(static_cast<char *>(data), req_size) ? req_size : 0;
+    }
 
     if (! op->mReplyBody)
     {
         op->mReplyBody = new BufferArray();
+
+        // Keep bodies of known length in one block so consumers
+        // can use them in place (BufferArray::getContiguous())
+        curl_off_t content_length(-1);
+        if (CURLE_OK == curl_easy_getinfo(op->mCurlHandle, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &content_length)
+            && content_length > curl_off_t(BufferArray::BLOCK_ALLOC_SIZE)
+            && content_length <= curl_off_t(HTTP_BODY_RESERVE_MAX))
+        {
+            op->mReplyBody->reserve(size_t(content_length));
+        }
     }
-    const size_t req_size(size * nmemb);
     const size_t write_size(op->mReplyBody->append(static_cast<char *>(data), req_size));
     HTTPStats::instance().recordDataDown(write_size);
     return write_size;
@@ -212,6 +212,8 @@ public:
     // Result data
     HttpStatus          mStatus;
     BufferArray *       mReplyBody;
+    HttpBodySink::ptr_t mReplySink;         // From options, takes 2xx bodies
+    int                 mReplySinkState;    // Per attempt:  0 undecided, 1 to sink, -1 to mReplyBody
     off_t               mReplyOffset;
     size_t              mReplyLength;
     size_t              mReplyFullLength;
@@ -226,6 +228,10 @@ public:
     int                 mPolicyRetryLimit;
     HttpTime            mPolicyMinRetryBackoff; // initial delay between retries (mcs)
     HttpTime            mPolicyMaxRetryBackoff;
+    unsigned int        mPolicyQueueDeadline;   // ms, 0 if none
+    HttpTime            mPolicyEnqueuedAt;
+    HttpTime            mPolicyDeadline;        // ready queue order (mcs)
+    bool                mPolicyExpires;         // cancel once mPolicyDeadline passes
 };  // end class HttpOpRequest
 
 
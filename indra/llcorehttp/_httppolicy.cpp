@@ -146,6 +146,10 @@ void HttpPolicy::addOp(const HttpOpRequest::ptr_t &op)
 
     op->mPolicyRetries = 0;
     op->mPolicy503Retries = 0;
+    op->mPolicyEnqueuedAt = totalTime();
+    op->mPolicyExpires = op->mPolicyQueueDeadline > 0;
+    op->mPolicyDeadline = op->mPolicyEnqueuedAt
+        + HttpTime(op->mPolicyExpires ? op->mPolicyQueueDeadline : HTTP_QUEUE_DEADLINE_DEFAULT) * 1000;
     mClasses[policy_class]->mReadyQueue.push(op);
 }
 
@@ -238,6 +242,21 @@ HttpService::ELoopSpeed HttpPolicy::processReadyQueue()
             continue;
         }
 
+        // Expired requests are at the front by construction.  Drop
+        // them even when the class is saturated so the requester
+        // hears about it promptly.
+        while (! readyq.empty() && readyq.top()->mPolicyExpires && readyq.top()->mPolicyDeadline <= now)
+        {
+            HttpOpRequest::ptr_t op(readyq.top());
+            readyq.pop();
+
+            LL_DEBUGS(LOG_CORE) << "HTTP request " << op->getHandle()
+                                << " canceled after " << ((now - op->mPolicyEnqueuedAt) / HttpTime(1000))
+                                << "ms in the ready queue of class " << policy_class
+                                << LL_ENDL;
+            op->cancel();
+        }
+
         const bool throttle_enabled(state.mOptions.mThrottleRate > 0L);
         const bool throttle_current(throttle_enabled && now < state.mThrottleEnd);
 
@@ -249,7 +268,10 @@ HttpService::ELoopSpeed HttpPolicy::processReadyQueue()
         }
 
         int active(transport.getActiveCountInClass(policy_class));
-        int active_limit(state.mOptions.mPipelining > 1L
+        int active_limit(state.mOptions.mMultiplex > 1L
+                         ? (state.mOptions.mPerHostConnectionLimit
+                            * state.mOptions.mMultiplex)
+                         : state.mOptions.mPipelining > 1L
                          ? (state.mOptions.mPerHostConnectionLimit
                             * state.mOptions.mPipelining)
                          : state.mOptions.mConnectionLimit);
@@ -295,6 +317,7 @@ HttpService::ELoopSpeed HttpPolicy::processReadyQueue()
                 HttpOpRequest::ptr_t op(readyq.top());
                 readyq.pop();
 
+                HTTPStats::instance().recordQueueLatency(policy_class, now - op->mPolicyEnqueuedAt);
                 op->stageFromReady(mService);
                 op.reset();
 
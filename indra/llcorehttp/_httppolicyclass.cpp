@@ -37,6 +37,7 @@ HttpPolicyClass::HttpPolicyClass()
     : mConnectionLimit(HTTP_CONNECTION_LIMIT_DEFAULT),
       mPerHostConnectionLimit(HTTP_CONNECTION_LIMIT_DEFAULT),
       mPipelining(HTTP_PIPELINING_DEFAULT),
+      mMultiplex(HTTP_MULTIPLEX_DEFAULT),
       mThrottleRate(HTTP_THROTTLE_RATE_DEFAULT)
 {}
 
@@ -52,6 +53,7 @@ HttpPolicyClass & HttpPolicyClass::operator=(const HttpPolicyClass & other)
         mConnectionLimit = other.mConnectionLimit;
         mPerHostConnectionLimit = other.mPerHostConnectionLimit;
         mPipelining = other.mPipelining;
+        mMultiplex = other.mMultiplex;
         mThrottleRate = other.mThrottleRate;
     }
     return *this;
@@ -62,6 +64,7 @@ HttpPolicyClass::HttpPolicyClass(const HttpPolicyClass & other)
     : mConnectionLimit(other.mConnectionLimit),
       mPerHostConnectionLimit(other.mPerHostConnectionLimit),
       mPipelining(other.mPipelining),
+      mMultiplex(other.mMultiplex),
       mThrottleRate(other.mThrottleRate)
 {}
 
@@ -82,6 +85,10 @@ HttpStatus HttpPolicyClass::set(HttpRequest::EPolicyOption opt, long value)
         mPipelining = llclamp(value, 0L, HTTP_PIPELINING_MAX);
         break;
 
+    case HttpRequest::PO_HTTP2_MULTIPLEX:
+        mMultiplex = llclamp(value, 0L, HTTP_MULTIPLEX_MAX);
+        break;
+
     case HttpRequest::PO_THROTTLE_RATE:
         mThrottleRate = llclamp(value, 0L, 1000000L);
         break;
@@ -110,6 +117,10 @@ HttpStatus HttpPolicyClass::get(HttpRequest::EPolicyOption opt, long * value) co
         *value = mPipelining;
         break;
 
+    case HttpRequest::PO_HTTP2_MULTIPLEX:
+        *value = mMultiplex;
+        break;
+
     case HttpRequest::PO_THROTTLE_RATE:
         *value = mThrottleRate;
         break;
@@ -63,6 +63,7 @@ public:
     long                        mConnectionLimit;
     long                        mPerHostConnectionLimit;
     long                        mPipelining;
+    long                        mMultiplex;
     long                        mThrottleRate;
 };  // end class HttpPolicyClass
 
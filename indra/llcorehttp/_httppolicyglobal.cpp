@@ -36,7 +36,8 @@ namespace LLCore
 HttpPolicyGlobal::HttpPolicyGlobal()
     : mConnectionLimit(HTTP_CONNECTION_LIMIT_DEFAULT),
       mTrace(HTTP_TRACE_OFF),
-      mUseLLProxy(0)
+      mUseLLProxy(0),
+      mTransportThreads(HTTP_TRANSPORT_THREADS_DEFAULT)
 {}
 
 
@@ -54,6 +55,7 @@ HttpPolicyGlobal & HttpPolicyGlobal::operator=(const HttpPolicyGlobal & other)
         mHttpProxy = other.mHttpProxy;
         mTrace = other.mTrace;
         mUseLLProxy = other.mUseLLProxy;
+        mTransportThreads = other.mTransportThreads;
     }
     return *this;
 }
@@ -75,6 +77,10 @@ HttpStatus HttpPolicyGlobal::set(HttpRequest::EPolicyOption opt, long value)
         mUseLLProxy = llclamp(value, 0L, 1L);
         break;
 
+    case HttpRequest::PO_TRANSPORT_THREADS:
+        mTransportThreads = llclamp(value, long(HTTP_TRANSPORT_THREADS_MIN), long(HTTP_TRANSPORT_THREADS_MAX));
+        break;
+
     default:
         return HttpStatus(HttpStatus::LLCORE, HE_INVALID_ARG);
     }
@@ -140,6 +146,10 @@ HttpStatus HttpPolicyGlobal::get(HttpRequest::EPolicyOption opt, long * value) c
         *value = mUseLLProxy;
         break;
 
+    case HttpRequest::PO_TRANSPORT_THREADS:
+        *value = mTransportThreads;
+        break;
+
     default:
         return HttpStatus(HttpStatus::LLCORE, HE_INVALID_ARG);
     }
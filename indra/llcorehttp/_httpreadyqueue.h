@@ -49,7 +49,10 @@ namespace LLCore
 /// implements a std::priority_queue interface but on std::deque
 /// behavior to eliminate sensitivity to priority.  In the future,
 /// this will likely become the only behavior or it may become
-/// a run-time election.
+/// a run-time election.  Requests are kept in mPolicyDeadline
+/// order, earliest first, FIFO among equals.  As most requests
+/// get the default deadline relative to their arrival, insertion
+/// is normally a push_back.
 ///
 /// Threading:  not thread-safe.  Expected to be used entirely by
 /// a single thread, typically a worker thread of some sort.
@@ -100,7 +103,12 @@ public:
 
     void push(const value_type & v)
         {
-            push_back(v);
+            iterator pos(end());
+            while (pos != begin() && (*(pos - 1))->mPolicyDeadline > v->mPolicyDeadline)
+            {
+                --pos;
+            }
+            insert(pos, v);
         }
 
 #endif // LLCORE_HTTP_READY_QUEUE_IGNORES_PRIORITY
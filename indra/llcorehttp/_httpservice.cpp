@@ -62,8 +62,10 @@ const HttpService::OptionDescriptor HttpService::sOptionDesc[] =
     {   true,       true,       true,       false,      false   },      // PO_LLPROXY
     {   true,       true,       true,       false,      false   },      // PO_TRACE
     {   true,       true,       false,      true,       false   },      // PO_ENABLE_PIPELINING
+    {   true,       true,       false,      true,       false   },      // PO_HTTP2_MULTIPLEX
     {   true,       true,       false,      true,       false   },      // PO_THROTTLE_RATE
-    {   false,      false,      true,       false,      true    }       // PO_SSL_VERIFY_CALLBACK
+    {   false,      false,      true,       false,      true    },      // PO_SSL_VERIFY_CALLBACK
+    {   true,       false,      true,       false,      false   }       // PO_TRANSPORT_THREADS
 };
 HttpService * HttpService::sInstance(NULL);
 volatile HttpService::EState HttpService::sState(NOT_INITIALIZED);
@@ -210,7 +212,7 @@ void HttpService::startThread()
 
     // Push current policy definitions, enable policy & transport components
     mPolicy->start();
-    mTransport->start(mLastPolicy + 1);
+    mTransport->start(mLastPolicy + 1, mPolicy->getGlobalOptions().mTransportThreads);
 
     mThread = new LLCoreInt::HttpThread(boost::bind(&HttpService::threadRun, this, _1));
     sState = RUNNING;
@@ -28,6 +28,8 @@
 #include "llexception.h"
 #include "llmemory.h"
 
+#include <mutex>
+
 
 // BufferArray is a list of chunks, each a BufferArray::Block, of contiguous
 // data presented as a single array.  Chunks are at least BufferArray::BLOCK_ALLOC_SIZE
@@ -40,6 +42,12 @@
 // all take position arguments.  Single write/shared read isn't supported
 // directly and any such attempts have to be serialized outside of this
 // implementation.
+//
+// Blocks of the standard size are recycled through a small shared pool
+// rather than going back to the heap.  Bodies are filled on the transport
+// threads and released on whatever thread consumed them, so the pool is
+// locked, but taking the lock once per 64KB is cheap next to allocating
+// and faulting in fresh pages for every response.
 
 namespace LLCore
 {
@@ -51,25 +59,19 @@ namespace LLCore
 
 class BufferArray::Block
 {
-public:
-    ~Block();
-
-    void operator delete(void *);
-    void operator delete(void *, size_t len);
-
 protected:
     Block(size_t len);
+    ~Block();
 
     Block(const Block &);                       // Not defined
     void operator=(const Block &);              // Not defined
 
-    // Allocate the block with the additional space for the
-    // buffered data at the end of the object.
-    void * operator new(size_t len, size_t addl_len);
-
 public:
-    // Only public entry to get a block.
+    // Only public entries to get and release a block.  Memory
+    // is allocated with the additional space for the buffered
+    // data at the end of the object.
     static Block * alloc(size_t len);
+    static void free(Block * block);
 
 public:
     size_t mUsed;
@@ -82,6 +84,55 @@ public:
 };
 
 
+namespace
+{
+
+// Free list of standard size blocks, see above
+class BlockPool
+{
+public:
+    static const size_t MAX_FREE = 64;          // 4MB of idle blocks
+
+    void * allocate()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (! mFree.empty())
+            {
+                void * mem(mFree.back());
+                mFree.pop_back();
+                return mem;
+            }
+        }
+        return NULL;
+    }
+
+    bool free(void * mem)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mFree.size() >= MAX_FREE)
+        {
+            return false;
+        }
+        mFree.push_back(mem);
+        return true;
+    }
+
+    // Never destroyed, bodies may be released during static destruction
+    static BlockPool & instance()
+    {
+        static BlockPool * pool(new BlockPool);
+        return *pool;
+    }
+
+private:
+    std::mutex          mMutex;
+    std::vector<void *> mFree;
+};
+
+}  // end anonymous namespace
+
+
 // ==================================
 // BufferArray Definitions
 // ==================================
@@ -103,7 +154,7 @@ BufferArray::~BufferArray()
          it != mBlocks.end();
          ++it)
     {
-        delete *it;
+        Block::free(*it);
         *it = NULL;
     }
     mBlocks.clear();
@@ -177,6 +228,7 @@ void * BufferArray::appendBufferAlloc(size_t len)
         mBlocks.reserve(mBlocks.size() + 5);
     }
     Block * block = Block::alloc((std::max)(BLOCK_ALLOC_SIZE, len));
+    memset(block->mData, 0, len);
     block->mUsed = len;
     mBlocks.push_back(block);
     mLen += len;
@@ -184,6 +236,51 @@ void * BufferArray::appendBufferAlloc(size_t len)
 }
 
 
+void BufferArray::reserve(size_t len)
+{
+    if (! mBlocks.empty())
+    {
+        const Block & last(*mBlocks.back());
+        if (last.mAlloced - last.mUsed >= len)
+        {
+            return;
+        }
+    }
+
+    if (mBlocks.size() >= mBlocks.capacity())
+    {
+        mBlocks.reserve(mBlocks.size() + 5);
+    }
+    try
+    {
+        mBlocks.push_back(Block::alloc((std::max)(BLOCK_ALLOC_SIZE, len)));
+    }
+    catch (std::bad_alloc&)
+    {
+        // Not fatal, append() will fall back to standard blocks
+        LL_WARNS() << "Unable to reserve " << len << " bytes in BufferArray" << LL_ENDL;
+    }
+}
+
+
+char * BufferArray::getContiguous(size_t pos, size_t len)
+{
+    size_t offset(0);
+    int block(findBlock(pos, &offset));
+    if (block < 0)
+    {
+        return NULL;
+    }
+
+    Block & b(*mBlocks[block]);
+    if (b.mUsed - offset < len)
+    {
+        return NULL;
+    }
+    return &b.mData[offset];
+}
+
+
 size_t BufferArray::read(size_t pos, void * dst, size_t len)
 {
     char * c_dst(static_cast<char *>(dst));
@@ -326,9 +423,7 @@ bool BufferArray::getBlockStartEnd(int block, const char ** start, const char **
 BufferArray::Block::Block(size_t len)
     : mUsed(0),
       mAlloced(len)
-{
-    memset(mData, 0, len);
-}
+{}
 
 
 BufferArray::Block::~Block()
@@ -338,30 +433,29 @@ BufferArray::Block::~Block()
 }
 
 
-void * BufferArray::Block::operator new(size_t len, size_t addl_len)
-{
-    void * mem = new char[len + addl_len + sizeof(void *)];
-    return mem;
-}
-
-
-void BufferArray::Block::operator delete(void * mem)
-{
-    char * cmem = static_cast<char *>(mem);
-    delete [] cmem;
-}
-
-
-void BufferArray::Block::operator delete(void * mem, size_t)
+BufferArray::Block * BufferArray::Block::alloc(size_t len)
 {
-    operator delete(mem);
+    void * mem(NULL);
+    if (BLOCK_ALLOC_SIZE == len)
+    {
+        mem = BlockPool::instance().allocate();
+    }
+    if (! mem)
+    {
+        mem = new char[sizeof(Block) + len + sizeof(void *)];
+    }
+    return new (mem) Block(len);
 }
 
 
-BufferArray::Block * BufferArray::Block::alloc(size_t len)
+void BufferArray::Block::free(Block * block)
 {
-    Block * block = new (len) Block(len);
-    return block;
+    const bool standard(BLOCK_ALLOC_SIZE == block->mAlloced);
+    block->~Block();
+    if (! standard || ! BlockPool::instance().free(block))
+    {
+        delete [] reinterpret_cast<char *>(block);
+    }
 }
 
 
@@ -103,6 +103,13 @@ public:
     ///                 of BufferArray of 'len' size.
     void * appendBufferAlloc(size_t len);
 
+    /// Makes sure the next 'len' bytes appended land in a single
+    /// block, without changing the size of the instance.  Used
+    /// when the final length is known up front (Content-Length)
+    /// so the whole body can later be used in place, see
+    /// getContiguous().
+    void reserve(size_t len);
+
     /// Current count of bytes in BufferArray instance.
     size_t size() const
         {
@@ -120,6 +127,13 @@ public:
     /// size of the instance or do a mix of both.
     size_t write(size_t pos, const void * src, size_t len);
 
+    /// Returns a pointer to 'len' bytes at 'pos' if they are stored
+    /// contiguously, letting the caller decode or inflate them in
+    /// place rather than read() them into a buffer of its own.
+    /// NULL if the range is out of bounds or spans blocks.  The
+    /// pointer is valid until the instance is modified or released.
+    char * getContiguous(size_t pos, size_t len);
+
 protected:
     int findBlock(size_t pos, size_t * ret_offset);
 
@@ -0,0 +1,74 @@
+/**
+ * @file httpbodysink.h
+ * @brief Public-facing declarations for the HttpBodySink interface
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef _LLCORE_HTTP_BODY_SINK_H_
+#define _LLCORE_HTTP_BODY_SINK_H_
+
+
+#include <memory>
+
+
+namespace LLCore
+{
+
+
+/// Receives the body of a successful (2xx) response as it arrives
+/// instead of having it collected in a BufferArray, so that large
+/// downloads can be spooled to disk without ever being held whole in
+/// memory.  Attach one with HttpOptions::setBodySink().  The response
+/// then carries no body; error responses still get one as usual.
+///
+/// Each call also serves as a progress notification.
+///
+/// Threading:  methods are called on an HTTP transport thread.  The
+/// consumer may look at the sink's results once the request's
+/// HttpHandler has been called.
+class HttpBodySink
+{
+public:
+    typedef std::shared_ptr<HttpBodySink> ptr_t;
+
+    virtual ~HttpBodySink()
+        {}
+
+    /// A successful response body is starting.  'expected' is
+    /// its Content-Length, 0 if unknown.  Called again when the
+    /// request is retried, in which case anything written by the
+    /// failed attempt must be discarded.
+    ///
+    /// @return         False to fail the request.
+    virtual bool begin(size_t expected) = 0;
+
+    /// The next piece of the body.
+    ///
+    /// @return         False to fail the request.
+    virtual bool write(const char * data, size_t len) = 0;
+};  // end class HttpBodySink
+
+
+}  // end namespace LLCore
+
+#endif  // _LLCORE_HTTP_BODY_SINK_H_
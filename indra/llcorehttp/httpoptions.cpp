@@ -42,6 +42,7 @@ HttpOptions::HttpOptions() :
     mRetries(HTTP_RETRY_COUNT_DEFAULT),
     mMinRetryBackoff(HTTP_RETRY_BACKOFF_MIN_DEFAULT),
     mMaxRetryBackoff(HTTP_RETRY_BACKOFF_MAX_DEFAULT),
+    mQueueDeadline(0U),
     mUseRetryAfter(HTTP_USE_RETRY_AFTER_DEFAULT),
     mFollowRedirects(true),
     mVerifyPeer(sDefaultVerifyPeer),
@@ -95,6 +96,16 @@ void HttpOptions::setMaxBackoff(HttpTime delay)
     mMaxRetryBackoff = delay;
 }
 
+void HttpOptions::setQueueDeadline(unsigned int milliseconds)
+{
+    mQueueDeadline = milliseconds;
+}
+
+void HttpOptions::setBodySink(const HttpBodySink::ptr_t & sink)
+{
+    mBodySink = sink;
+}
+
 void HttpOptions::setUseRetryAfter(bool use_retry)
 {
     mUseRetryAfter = use_retry;
@@ -28,6 +28,7 @@
 #define _LLCORE_HTTP_OPTIONS_H_
 
 
+#include "httpbodysink.h"
 #include "httpcommon.h"
 #include "_refcounted.h"
 
@@ -126,6 +127,19 @@ public:
         return mMaxRetryBackoff;
     }
 
+    /// Sets how long, in milliseconds, the request may wait in its
+    /// policy class's ready queue before being dispatched.  Requests
+    /// are dispatched earliest deadline first and are canceled, with
+    /// a cancel status, if still queued when the deadline passes.
+    /// Meant for requests that lose their value quickly.  0 leaves
+    /// the request in FIFO order without expiring.
+    // Default:  0
+    void                setQueueDeadline(unsigned int milliseconds);
+    unsigned int        getQueueDeadline() const
+    {
+        return mQueueDeadline;
+    }
+
     // Default:  true
     void                setUseRetryAfter(bool use_retry);
     bool                getUseRetryAfter() const
@@ -178,6 +192,16 @@ public:
         return mNoBody;
     }
 
+    /// Delivers successful response bodies to the sink as they
+    /// arrive rather than collecting them for the response, see
+    /// HttpBodySink.
+    /// Default: none
+    void                setBodySink(const HttpBodySink::ptr_t & sink);
+    const HttpBodySink::ptr_t & getBodySink() const
+    {
+        return mBodySink;
+    }
+
     /// Sets default behavior for verifying that the name in the
     /// security certificate matches the name of the host contacted.
     /// Defaults false if not set, but should be set according to
@@ -201,12 +225,14 @@ protected:
     unsigned int        mRetries;
     HttpTime            mMinRetryBackoff;
     HttpTime            mMaxRetryBackoff;
+    unsigned int        mQueueDeadline;
     bool                mUseRetryAfter;
     bool                mFollowRedirects;
     bool                mVerifyPeer;
     bool                mVerifyHost;
     int                 mDNSCacheTimeout;
     bool                mNoBody;
+    HttpBodySink::ptr_t mBodySink;
 
     static bool         sDefaultVerifyPeer;
 
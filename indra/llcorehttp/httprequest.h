@@ -217,6 +217,18 @@ public:
         /// Per-class only
         PO_PIPELINING_DEPTH,
 
+        /// If greater than 1, requests in this class ask for HTTP/2
+        /// (over TLS, falling back to HTTP/1.1 when the server does
+        /// not negotiate it) and are multiplexed as concurrent
+        /// streams on a shared connection.  Value gives the maximum
+        /// number of streams per connection.  Takes precedence over
+        /// PO_PIPELINING_DEPTH when both are set.  Multiplexed
+        /// streams complete independently so the out-of-order reply
+        /// problems of HTTP/1.1 pipelining don't apply.
+        ///
+        /// Per-class only
+        PO_HTTP2_MULTIPLEX,
+
         /// Controls whether client-side throttling should be
         /// performed on this policy class.  Positive values
         /// enable throttling and specify the request rate
@@ -232,6 +244,17 @@ public:
         /// Global only
         PO_SSL_VERIFY_CALLBACK,
 
+        /// Long value giving the number of threads that give libcurl
+        /// cycles.  Policy classes are divided among them, each
+        /// thread running I/O and body callbacks for its classes'
+        /// multi handles (and so connection caches).  Policy and
+        /// request completion stay on the worker thread, which
+        /// also counts as the first of these.  Default is 1, all
+        /// transport on the worker thread.
+        ///
+        /// Global only, must be set before the worker thread starts
+        PO_TRANSPORT_THREADS,
+
         PO_LAST  // Always at end
     };
 
@@ -42,6 +42,7 @@ HTTPStats::~HTTPStats()
 void HTTPStats::resetStats()
 {
     mResutCodes.clear();
+    mQueueLatency.clear();
     mDataDown.reset();
     mDataUp.reset();
     mRequests = 0;
@@ -101,6 +102,14 @@ void HTTPStats::dumpStats()
         out << (*it).first << " " << (*it).second << std::endl;
     }
 
+    out << std::endl;
+    out << "Ready queue latency (ms):" << std::endl << "class count mean max" << std::endl;
+    for (const auto& latency : mQueueLatency)
+    {
+        out << latency.first << " " << latency.second.getCount() << " " << latency.second.getMean()
+            << " " << latency.second.getMaxValue() << std::endl;
+    }
+
     LL_WARNS("HTTPCore") << out.str() << LL_ENDL;
 }
 
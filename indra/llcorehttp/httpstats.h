@@ -33,6 +33,8 @@
 #include "llsingleton.h"
 #include "llsd.h"
 
+#include <mutex>
+
 namespace LLCore
 {
     class HTTPStats final : public LLSimpleton<HTTPStats>
@@ -45,13 +47,17 @@ namespace LLCore
 
         typedef LLStatsAccumulator StatsAccumulator;
 
+        // Called from libcurl callbacks, which may run on any of the
+        // transport threads (see HttpRequest::PO_TRANSPORT_THREADS)
         void    recordDataDown(size_t bytes)
         {
+            std::lock_guard<std::mutex> lock(mDataMutex);
             mDataDown.push((F32)bytes);
         }
 
         void    recordDataUp(size_t bytes)
         {
+            std::lock_guard<std::mutex> lock(mDataMutex);
             mDataUp.push((F32)bytes);
         }
 
@@ -59,14 +65,22 @@ namespace LLCore
 
         void    recordResultCode(S32 code);
 
+        // Time a request spent in its class's ready queue, in microseconds
+        void    recordQueueLatency(S32 policy_class, U64 usecs)
+        {
+            mQueueLatency[policy_class].push((F32)usecs / 1000.f);
+        }
+
         void    dumpStats();
     private:
+        std::mutex       mDataMutex;
         StatsAccumulator mDataDown;
         StatsAccumulator mDataUp;
 
         S32              mRequests;
 
         std::map<S32, S32> mResutCodes;
+        std::map<S32, StatsAccumulator> mQueueLatency;  // ms, by policy class
     };
 
 
@@ -48,6 +48,7 @@
 #endif
 #include "test_httpheaders.hpp"
 #include "test_httprequestqueue.hpp"
+#include "test_httpreadyqueue.hpp"
 #include "_httpservice.h"
 
 #include "llproxy.h"
@@ -29,6 +29,7 @@
 #include "bufferarray.h"
 
 #include <iostream>
+#include <vector>
 
 
 using namespace LLCore;
@@ -374,6 +375,59 @@ void BufferArrayTestObjectType::test<8>()
     ba->release();
 }
 
+template <> template <>
+void BufferArrayTestObjectType::test<9>()
+{
+    set_test_name("BufferArray reserve and getContiguous");
+
+    // create a new ref counted object with an implicit reference
+    BufferArray * ba = new BufferArray();
+
+    // reserve a body larger than a standard block
+    const size_t body_len(BufferArray::BLOCK_ALLOC_SIZE * 3 + 17);
+    ba->reserve(body_len);
+    ensure("Reserve doesn't change size", 0 == ba->size());
+
+    std::vector<char> body(body_len);
+    for (size_t i(0); i < body_len; ++i)
+    {
+        body[i] = char(i * 7);
+    }
+
+    // arrives in odd sized pieces, as from libcurl
+    for (size_t pos(0); pos < body_len; pos += 16000)
+    {
+        const size_t len((std::min)(size_t(16000), body_len - pos));
+        ensure("Append of piece", len == ba->append(&body[pos], len));
+    }
+    ensure("Body length correct", body_len == ba->size());
+
+    char * data(ba->getContiguous(0, body_len));
+    ensure("Reserved body is contiguous", NULL != data);
+    ensure("Contiguous content correct", 0 == memcmp(data, &body[0], body_len));
+    ensure("Offset view correct", ba->getContiguous(100, body_len - 100) == data + 100);
+    ensure("Range beyond end rejected", NULL == ba->getContiguous(100, body_len));
+    ensure("Position beyond end rejected", NULL == ba->getContiguous(body_len, 1));
+
+    // without a reserve, large bodies span standard blocks
+    BufferArray * ba2 = new BufferArray();
+    ba2->append(&body[0], body_len);
+    ensure("Unreserved body spans blocks", NULL == ba2->getContiguous(0, body_len));
+    ensure("First block is contiguous", NULL != ba2->getContiguous(0, BufferArray::BLOCK_ALLOC_SIZE));
+
+    // release the implicit references, recycling standard blocks
+    ba2->release();
+    ba->release();
+
+    // recycled blocks behave like new ones
+    BufferArray * ba3 = new BufferArray();
+    ba3->append(&body[0], body_len);
+    std::vector<char> buffer(body_len);
+    ensure("Read from recycled blocks", body_len == ba3->read(0, &buffer[0], body_len));
+    ensure("Recycled content correct", 0 == memcmp(&buffer[0], &body[0], body_len));
+    ba3->release();
+}
+
 }  // end namespace tut
 
 
@@ -0,0 +1,92 @@
+/**
+ * @file test_httpreadyqueue.hpp
+ * @brief unit tests for the LLCore::HttpReadyQueue class
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+#ifndef TEST_LLCORE_HTTP_READYQUEUE_H_
+#define TEST_LLCORE_HTTP_READYQUEUE_H_
+
+#include "_httpreadyqueue.h"
+
+#include <iostream>
+
+
+using namespace LLCoreInt;
+
+
+
+namespace tut
+{
+
+struct HttpReadyqueueTestData
+{
+    // the test objects inherit from this so the member functions and variables
+    // can be referenced directly inside of the test functions.
+
+    LLCore::HttpOpRequest::ptr_t makeOp(LLCore::HttpTime deadline)
+    {
+        LLCore::HttpOpRequest::ptr_t op(new LLCore::HttpOpRequest());
+        op->mPolicyDeadline = deadline;
+        return op;
+    }
+};
+
+typedef test_group<HttpReadyqueueTestData> HttpReadyqueueTestGroupType;
+typedef HttpReadyqueueTestGroupType::object HttpReadyqueueTestObjectType;
+HttpReadyqueueTestGroupType HttpReadyqueueTestGroup("HttpReadyqueue Tests");
+
+template <> template <>
+void HttpReadyqueueTestObjectType::test<1>()
+{
+    set_test_name("HttpReadyQueue earliest deadline first");
+
+#if LLCORE_HTTP_READY_QUEUE_IGNORES_PRIORITY
+    LLCore::HttpReadyQueue readyq;
+
+    LLCore::HttpOpRequest::ptr_t late(makeOp(LLCore::HttpTime(3000)));
+    LLCore::HttpOpRequest::ptr_t first(makeOp(LLCore::HttpTime(2000)));
+    LLCore::HttpOpRequest::ptr_t second(makeOp(LLCore::HttpTime(2000)));
+    LLCore::HttpOpRequest::ptr_t urgent(makeOp(LLCore::HttpTime(1000)));
+
+    readyq.push(late);
+    readyq.push(first);
+    readyq.push(second);
+    readyq.push(urgent);
+
+    ensure("Four queued", 4 == readyq.size());
+    ensure("Earliest deadline first", readyq.top() == urgent);
+    readyq.pop();
+    ensure("Equal deadlines keep arrival order", readyq.top() == first);
+    readyq.pop();
+    ensure("Then the other equal one", readyq.top() == second);
+    readyq.pop();
+    ensure("Latest deadline last", readyq.top() == late);
+    readyq.pop();
+    ensure("Empty", readyq.empty());
+#endif
+}
+
+}  // end namespace tut
+
+
+#endif  // TEST_LLCORE_HTTP_READYQUEUE_H_
@@ -34,6 +34,7 @@
 #include "llapp.h"
 #include "llassettype.h"
 #include "lldir.h"
+#include "llfile.h"
 #include <boost/filesystem.hpp>
 #include <chrono>
 
@@ -51,6 +52,41 @@ static const std::string CACHE_FILENAME_PREFIX("sl_cache");
 
 std::string LLDiskCache::sCacheDir;
 
+/**
+ * The journal of catalog changes, kept in the cache folder. The name must
+ * not contain CACHE_FILENAME_PREFIX or clearCache() would delete it.
+ */
+static const std::string JOURNAL_FILENAME("catalog.journal");
+static const char JOURNAL_MAGIC[8] = { 'L', 'L', 'D', 'C', 'A', 'T', '0', '2' };
+
+/**
+ * Reads are only written to the journal once an hour per file, for the same
+ * reason LLFileSystem::updateFileAccessTime() only touched files that often
+ * (SL-14582): the purge order doesn't need more and it spares the disk.
+ */
+static const std::time_t JOURNAL_TOUCH_INTERVAL = 60 * 60;
+
+/**
+ * The journal is compacted into one record per file once it holds this many
+ * more records than twice the number of files.
+ */
+static const size_t JOURNAL_SLACK = 4096;
+
+static_assert(sizeof(LLUUID) == UUID_BYTES, "journal records hold raw UUIDs");
+
+/**
+ * Pack segments live in their own folder so neither the scan for cache
+ * files nor clearCache() see them. A segment is mapped in steps of
+ * PACK_SEGMENT_GROWTH up to PACK_SEGMENT_SIZE, then a new one is started.
+ */
+static const std::string PACK_DIRNAME("pack");
+static const size_t PACK_SEGMENT_SIZE = 64 * 1024 * 1024;
+static const size_t PACK_SEGMENT_GROWTH = 4 * 1024 * 1024;
+// Files written less than this long ago may still be being written
+static const std::time_t PACK_MIN_AGE = 60;
+// Bounds the work of one purge pass
+static const size_t PACK_FILES_PER_PASS = 2000;
+
 // <FS:Ansariel> Optimize asset simple disk cache
 static const char* subdirs = "0123456789abcdef";
 
@@ -61,9 +97,11 @@ LLDiskCache::LLDiskCache(const std::string& cache_dir,
                          ,const F32 highwater_mark_percent
                          ,const F32 lowwater_mark_percent
 // </FS:Beq>
+                         ,const bool read_only
                          ) :
     mMaxSizeBytes(max_size_bytes),
-    mEnableCacheDebugInfo(enable_cache_debug_info)
+    mEnableCacheDebugInfo(enable_cache_debug_info),
+    mReadOnly(read_only)
 {
     sCacheDir = cache_dir;
     LLFile::mkdir(cache_dir);
@@ -75,11 +113,34 @@ LLDiskCache::LLDiskCache(const std::string& cache_dir,
         LLFile::mkdir(dirname);
     }
     // </FS:Ansariel>
+    LLFile::mkdir(getPackDir());
+
+    bool clean = loadCatalog();
+    openSegments();
+    if (clean)
+    {
+        LLMutexLock lock(&mCatalogMutex);
+        journal(JOURNAL_OPENED, LLUUID::null);
+    }
+    else
+    {
+        // first run, the last session crashed, or the first instance is still
+        // running: find out what is in the folder the slow way
+        scanCacheDir();
+    }
     // <FS:Beq> add static assets into the new cache after clear.
     // Only missing entries are copied on init, skiplist is setup
     // For everything we populate FS specific assets to allow future updates
     prepopulateCacheWithStatic();
     // </FS:Beq>
+    flushJournal();
+}
+
+LLDiskCache::~LLDiskCache()
+{
+    flushJournal(true);
+    LLMutexLock lock(&mCatalogMutex);
+    closeSegments();
 }
 
 // WARNING: purge() is called by LLPurgeDiskCacheThread. As such it must
@@ -112,218 +173,123 @@ LLDiskCache::LLDiskCache(const std::string& cache_dir,
 // asset will have to be re-requested.
 void LLDiskCache::purge()
 {
-    if (mEnableCacheDebugInfo)
-    {
-        LL_INFOS() << "Total dir size before purge is " << dirFileSize(sCacheDir) << LL_ENDL;
-    }
-
-    boost::system::error_code ec;
     auto start_time = std::chrono::high_resolution_clock::now();
+    const std::time_t now = std::time(nullptr);
 
-    typedef std::pair<std::time_t, std::pair<uintmax_t, std::string>> file_info_t;
-    std::vector<file_info_t> file_info;
-
-#if LL_WINDOWS
-    std::wstring cache_path(utf8str_to_utf16str(sCacheDir));
-#else
-    std::string cache_path(sCacheDir);
-#endif
-    uintmax_t file_size_total = 0; // <FS:Beq/> try to make simple cache less naive.
-    
-    if (boost::filesystem::is_directory(cache_path, ec) && !ec.failed())
+    typedef std::pair<std::time_t, LLUUID> file_age_t;
+    std::vector<std::string> victims;
+    std::vector<std::string> debug_lines;
+    uintmax_t file_size_total = 0;
+    uintmax_t deleted_size_total = 0;
+    size_t file_count = 0;
+    S32 del = 0;
+    S32 skip = 0;
     {
-        // <FS:Ansariel> Optimize asset simple disk cache
-        //boost::filesystem::directory_iterator iter(cache_path, ec);
-        //while (iter != boost::filesystem::directory_iterator() && !ec.failed())
-        boost::filesystem::recursive_directory_iterator iter(cache_path, ec);
-        while (iter != boost::filesystem::recursive_directory_iterator() && !ec.failed())
-        // </FS:Ansariel>
-        {
-            if (boost::filesystem::is_regular_file(*iter, ec) && !ec.failed())
-            {
-                if ((*iter).path().string().find(CACHE_FILENAME_PREFIX) != std::string::npos)
-                {
-                    uintmax_t file_size = boost::filesystem::file_size(*iter, ec);
-                    if (ec.failed())
-                    {
-                        continue;
-                    }
-                    const std::string file_path = (*iter).path().string();
-                    const std::time_t file_time = boost::filesystem::last_write_time(*iter, ec);
-                    if (ec.failed())
-                    {
-                        continue;
-                    }
-                    file_size_total += file_size; // <FS:Beq/> try to make simple cache less naive.
+        LLMutexLock lock(&mCatalogMutex);
+        file_size_total = mCatalogBytes;
+        file_count = mCatalog.size();
 
-                    file_info.push_back(file_info_t(file_time, { file_size, file_path }));
-                }
-            }
-            iter.increment(ec);
+        // <FS:Beq> add high water/low water thresholds to reduce the churn in the cache.
+        LL_DEBUGS("LLDiskCache") << "Cache is " << (int)(((F32)file_size_total)/mMaxSizeBytes*100.0) << "% full" << LL_ENDL;
+        if (file_size_total < mMaxSizeBytes * (mHighPercent/100))
+        {
+            // Nothing to do here
+            LL_DEBUGS("LLDiskCache") << "Not exceded high water - do nothing" << LL_ENDL;
+            file_count = 0;
         }
     }
 
-    // <FS:Beq> add high water/low water thresholds to reduce the churn in the cache.
-    LL_DEBUGS("LLDiskCache") << "Cache is " << (int)(((F32)file_size_total)/mMaxSizeBytes*100.0) << "% full" << LL_ENDL;
-    if( file_size_total < mMaxSizeBytes * (mHighPercent/100) )
-    {
-        // Nothing to do here 
-        LL_DEBUGS("LLDiskCache") << "Not exceded high water - do nothing" << LL_ENDL;
-        return;
-    }
-    // If we reach here we are above the trigger level so we must purge until we've removed enough to take us down to the low water mark.
-    // </FS:Beq>
-    std::sort(file_info.begin(), file_info.end(), [](file_info_t& x, file_info_t& y)
-    {
-        return x.first < y.first; // <FS:Beq/> sort oldest to newest, to we can remove the oldest files first.
-    });
-
-
-    // <FS:Beq> add high water/low water thresholds to reduce the churn in the cache.
-    auto target_size = (uintmax_t)(mMaxSizeBytes * (mLowPercent/100));
-    LL_INFOS() << "Purging cache to a maximum of " << target_size << " bytes" << LL_ENDL;
-    // </FS:Beq>
-
-    // <FS:Beq> Extra accounting to track the retention of static assets
-    //std::vector<bool> file_removed;
-    enum class purge_action { delete_file=0, keep_file, skip_file };
-    std::map<std::string,purge_action> file_removed;
-    auto keep{file_info.size()};
-    auto del{0};
-    auto skip{0};
-    // </FS:Beq>
-    // <FS:Beq> revised purge logic to track amount removed not retained to shortern loop
-    // uintmax_t file_size_total = 0;
-    // if (mEnableCacheDebugInfo)
-    // {
-    //     file_removed.reserve(file_info.size());
-    // }
-    // uintmax_t file_size_total = 0;
-    // for (file_info_t& entry : file_info)
-    // {
-    //     file_size_total += entry.second.first;
-
-    //     bool should_remove = file_size_total > mMaxSizeBytes;
-    //     if (mEnableCacheDebugInfo)
-    //     {
-    //         file_removed.push_back(should_remove);
-    //     }
-    uintmax_t deleted_size_total = 0;
-    for (const file_info_t& entry : file_info)
+    if (file_count)
     {
-        // first check if we still need to delete more files
-        bool should_remove = (file_size_total - deleted_size_total) > target_size;
+        // If we reach here we are above the trigger level so we must purge until we've removed enough to take us down to the low water mark.
+        auto target_size = (uintmax_t)(mMaxSizeBytes * (mLowPercent/100));
+        LL_INFOS("LLDiskCache") << "Purging cache to a maximum of " << target_size << " bytes" << LL_ENDL;
 
-        // <FS> Make sure static assets are not eliminated
-        auto action{ should_remove ? purge_action::delete_file : purge_action::keep_file };
-        if (!should_remove)
+        LLMutexLock lock(&mCatalogMutex);
+        std::vector<file_age_t> file_ages;
+        file_ages.reserve(mCatalog.size());
+        for (const auto& item : mCatalog)
         {
-            break;
+            file_ages.emplace_back(item.second.mLastAccess, item.first);
         }
+        // oldest first
+        std::sort(file_ages.begin(), file_ages.end());
 
-        auto this_file_size = entry.second.first;
-        deleted_size_total += this_file_size;
-        auto uuid_as_string = gDirUtilp->getBaseFileName(entry.second.second, true);
-        uuid_as_string      = uuid_as_string.substr(CACHE_FILENAME_PREFIX.size() + 1, 36);  // skip "sl_cache_" and trailing "_N"
-        // LL_INFOS() << "checking UUID=" <<uuid_as_string<< LL_ENDL;
-        if (std::find(mSkipList.begin(), mSkipList.end(), uuid_as_string) != mSkipList.end())
+        for (const file_age_t& file_age : file_ages)
         {
-            // this is one of our protected items so no purging
-            should_remove = false;
-            action = purge_action::skip_file;
-            boost::filesystem::last_write_time(entry.second.second, ec);  // force these to the front of the list next time so that purge size works 
-            skip++;
-        }
-        else{
-            del++;
-        }
-        keep--;
-        if (mEnableCacheDebugInfo)
-        {
-            file_removed.emplace(entry.second.second, action);
-        }
-    // </FS>
-        if (should_remove)
-        {
-            boost::filesystem::remove(entry.second.second, ec);
-            if (ec.failed())
+            if (mCatalogBytes <= target_size)
             {
-                LL_WARNS() << "Failed to delete cache file " << entry.second.second << ": " << ec.message() << LL_ENDL;
+                break;
             }
-        }
-    }
-// <FS:Beq> update the debug logging to be more useful
-    auto end_time = std::chrono::high_resolution_clock::now();
-    auto execute_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
-// </FS:Beq>
-    if (mEnableCacheDebugInfo)
-    {
-        // <FS:Beq> update the debug logging to be more useful
-        // auto end_time = std::chrono::high_resolution_clock::now();
-        // auto execute_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
-        // </FS:Beq>
-
-        // Log afterward so it doesn't affect the time measurement
-        // Logging thousands of file results can take hundreds of milliseconds
-        uintmax_t deleted_so_far{ 0 }; // <FS:Beq/> update the debug logging to be more useful
-        for (size_t i = 0; i < file_info.size(); ++i)
-        {
-            const file_info_t& entry = file_info[i];
-            // <FS> Static asset stuff
-            deleted_so_far += entry.second.first; // <FS:Beq/> update the debug logging to be more useful
-            //const bool removed = file_removed[i];
-            //const std::string action = removed ? "DELETE:" : "KEEP:";
-            std::string action{};
-
-            // Check if the file exists in the map
-            auto& filename{ entry.second.second };
-            if (file_removed.find(filename) != file_removed.end()) {
-            // File found in the map, retrieve the corresponding enum value
-            switch (file_removed[filename])
+
+            auto it = mCatalog.find(file_age.second);
+            const std::string path = metaDataToFilepath(it->first, it->second.mType);
+            // <FS> Make sure static assets are not eliminated
+            if (std::find(mSkipList.begin(), mSkipList.end(), it->first.asString()) != mSkipList.end())
             {
-                case purge_action::delete_file:
-                    action = "DELETE";
-                    del++;
-                break;
-                case purge_action::skip_file:
-                    action = "STATIC";
-                    skip++;
-                break;
-                default:
-                // Handle any unexpected enum value
-                    action = "UNKNOWN";
-                break;
+                // this is one of our protected items so no purging, move it to the back of the queue
+                it->second.mLastAccess = now;
+                skip++;
+                if (mEnableCacheDebugInfo)
+                {
+                    debug_lines.push_back(llformat("STATIC  %lld  %llu  %s", (long long)file_age.first,
+                                                   (unsigned long long)it->second.mSize, path.c_str()));
+                }
+                continue;
             }
+            // </FS>
+
+            deleted_size_total += it->second.mSize;
+            mCatalogBytes -= it->second.mSize;
+            if (mEnableCacheDebugInfo)
+            {
+                debug_lines.push_back(llformat("DELETE  %lld  %llu  %s (%llu/%llu)", (long long)file_age.first,
+                                               (unsigned long long)it->second.mSize, path.c_str(),
+                                               (unsigned long long)mCatalogBytes, (unsigned long long)mMaxSizeBytes));
             }
-            else 
+            if (it->second.mSegment)
             {
-                action = "KEEP";
-            }            
-            // </FS>
+                // compactSegments() reclaims the space
+                releasePacked(it->second);
+            }
+            else
+            {
+                victims.push_back(path);
+            }
+            journal(JOURNAL_REMOVE, it->first);
+            mCatalog.erase(it);
+            del++;
+        }
+    }
 
-            // have to do this because of LL_INFO/LL_END weirdness
-            std::ostringstream line;
+    // Interaction through the filesystem is safe, see above; the catalog is
+    // already updated so the files can go without holding its lock
+    for (const std::string& path : victims)
+    {
+        LLFile::remove(path, ENOENT);
+    }
+    packSmallFiles();
+    compactSegments();
+    flushJournal();
 
-            line << action << "  ";
-            line << entry.first << "  ";
-            line << entry.second.first << "  ";
-            line << entry.second.second;
-            line << " (" << file_size_total - deleted_so_far << "/" << mMaxSizeBytes << ")"; // <FS:Beq/> update the debug logging to be more useful
-            LL_INFOS() << line.str() << LL_ENDL;
-        }
-// <FS:Beq> make the summary stats more easily enabled.
+    if (!file_count)
+    {
+        return;
     }
-    // <FS:Beq> update the debug logging to be more useful
-        // LL_INFOS() << "Total dir size after purge is " << dirFileSize(sCacheDir) << LL_ENDL;
-        // LL_INFOS() << "Cache purge took " << execute_time << " ms to execute for " << file_info.size() << " files" << LL_ENDL;
 
-    auto newCacheSize = updateCacheSize(file_size_total - deleted_size_total); 
-    LL_INFOS("LLDiskCache") << "Total dir size after purge is " << newCacheSize << LL_ENDL; 
-    LL_INFOS("LLDiskCache") << "Cache purge took " << execute_time << " ms to execute for " << file_info.size() << " files" << LL_ENDL;
-// </FS:Beq>
-    LL_INFOS("LLDiskCache") << "Deleted: " << del << " Skipped: " << skip << " Kept: " << keep << LL_ENDL;    // <FS:Beq/> Extra accounting to track the retention of static assets
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto execute_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+
+    // Log afterward so it doesn't affect the time measurement
+    // Logging thousands of file results can take hundreds of milliseconds
+    for (const std::string& line : debug_lines)
+    {
+        LL_INFOS("LLDiskCache") << line << LL_ENDL;
+    }
+    LL_INFOS("LLDiskCache") << "Total cache size after purge is " << file_size_total - deleted_size_total << LL_ENDL;
+    LL_INFOS("LLDiskCache") << "Cache purge took " << execute_time << " ms to execute for " << file_count << " files" << LL_ENDL;
+    LL_INFOS("LLDiskCache") << "Deleted: " << del << " Skipped: " << skip << " Kept: " << file_count - del << LL_ENDL;    // <FS:Beq/> Extra accounting to track the retention of static assets
     LL_INFOS("LLDiskCache") << "Total of " << deleted_size_total << " bytes removed." << LL_ENDL;    // <FS:Beq/> Extra accounting to track the retention of static assets
-    // } <FS:Beq/> this bracket was moved up a few lines.
 }
 
 const std::string LLDiskCache::metaDataToFilepath(const LLUUID& id, LLAssetType::EType at)
@@ -335,8 +301,14 @@ const std::string LLDiskCache::getCacheInfo()
 {
     std::ostringstream cache_info;
 
+    uintmax_t cache_size = 0;
+    {
+        LLMutexLock lock(&mCatalogMutex);
+        cache_size = mCatalogBytes;
+    }
+
     F32 max_in_mb = (F32)mMaxSizeBytes / (1024.0f * 1024.0f);
-    F32 percent_used = ((F32)dirFileSize(sCacheDir) / (F32)mMaxSizeBytes) * 100.0f;
+    F32 percent_used = ((F32)cache_size / (F32)mMaxSizeBytes) * 100.0f;
 
     cache_info << std::fixed;
     cache_info << std::setprecision(1);
@@ -380,6 +352,14 @@ void LLDiskCache::prepopulateCacheWithStatic()
                     {
                         LL_WARNS("LLDiskCache") << "Failed to copy " << from_asset_file << " to " << to_asset_file << LL_ENDL;
                     }
+                    else
+                    {
+                        llstat file_stat;
+                        if (LLFile::stat(to_asset_file, &file_stat) == 0)
+                        {
+                            fileWritten(uuid, LLAssetType::AT_UNKNOWN, file_stat.st_size, true);
+                        }
+                    }
                 }
                 if (std::find(mSkipList.begin(), mSkipList.end(), uuid_as_string) == mSkipList.end())
                 {
@@ -432,9 +412,23 @@ void LLDiskCache::clearCache()
             }
             iter.increment(ec);
         }
+
+        {
+            LLMutexLock lock(&mCatalogMutex);
+            mCatalog.clear();
+            mCatalogBytes = 0;
+            mPendingRecords.clear();
+            mJournalRewrite = true;
+
+            closeSegments();
+            boost::filesystem::remove_all(getPackDir(), ec);
+            LLFile::mkdir(getPackDir());
+        }
+
         // <FS:Beq> add static assets into the new cache after clear
     LL_INFOS() << "prepopulating new cache " << LL_ENDL;
         prepopulateCacheWithStatic();
+        flushJournal();
     }
     LL_INFOS() << "Cleared cache " << sCacheDir << LL_ENDL;
 }
@@ -473,66 +467,622 @@ void LLDiskCache::removeOldVFSFiles()
     }
 }
 
-// <FS:Beq> Lets not scan every single time if we can avoid it eh?
-// uintmax_t LLDiskCache::dirFileSize(const std::string& dir)
-// {
-uintmax_t LLDiskCache::updateCacheSize(const uintmax_t newsize)
+void LLDiskCache::fileAccessed(const LLUUID& id)
+{
+    const std::time_t now = std::time(nullptr);
+
+    LLMutexLock lock(&mCatalogMutex);
+    auto it = mCatalog.find(id);
+    if (it != mCatalog.end())
+    {
+        it->second.mLastAccess = now;
+        if (now - it->second.mJournaledAccess > JOURNAL_TOUCH_INTERVAL)
+        {
+            journal(JOURNAL_TOUCH, id, &it->second);
+        }
+    }
+}
+
+void LLDiskCache::fileWritten(const LLUUID& id, LLAssetType::EType at, uintmax_t size, bool exact_size)
+{
+    const std::time_t now = std::time(nullptr);
+
+    LLMutexLock lock(&mCatalogMutex);
+    auto it = mCatalog.try_emplace(id, CatalogEntry{ 0, now, 0, now, at, 0, 0 }).first;
+    CatalogEntry& entry = it->second;
+    if (entry.mSegment)
+    {
+        // LLFileSystem unpacks before writing, someone wrote to the file directly
+        releasePacked(entry);
+        entry.mSize = 0;
+    }
+    mCatalogBytes -= entry.mSize;
+    // a write into the middle of an existing file doesn't tell us its size
+    entry.mSize = exact_size ? size : llmax(size, entry.mSize);
+    mCatalogBytes += entry.mSize;
+    entry.mLastAccess = now;
+    entry.mLastWrite = now;
+    entry.mType = at;
+    journal(JOURNAL_ADD, id, &entry);
+}
+
+void LLDiskCache::fileRenamed(const LLUUID& old_id, const LLUUID& new_id, LLAssetType::EType new_at)
+{
+    LLMutexLock lock(&mCatalogMutex);
+    auto it = mCatalog.find(old_id);
+    if (it == mCatalog.end())
+    {
+        return;
+    }
+
+    CatalogEntry entry = it->second;
+    mCatalog.erase(it);
+    journal(JOURNAL_REMOVE, old_id);
+
+    entry.mType = new_at;
+    auto replaced = mCatalog.find(new_id);
+    if (replaced != mCatalog.end())
+    {
+        mCatalogBytes -= replaced->second.mSize;
+        if (replaced->second.mSegment)
+        {
+            releasePacked(replaced->second);
+        }
+    }
+    auto result = mCatalog.insert_or_assign(new_id, entry);
+    journal(JOURNAL_ADD, new_id, &result.first->second);
+}
+
+void LLDiskCache::fileRemoved(const LLUUID& id)
 {
-    mStoredCacheSize = newsize;
-    mLastScanTime = system_clock::now();
-    return mStoredCacheSize;
+    LLMutexLock lock(&mCatalogMutex);
+    auto it = mCatalog.find(id);
+    if (it != mCatalog.end())
+    {
+        mCatalogBytes -= it->second.mSize;
+        if (it->second.mSegment)
+        {
+            releasePacked(it->second);
+        }
+        mCatalog.erase(it);
+        journal(JOURNAL_REMOVE, id);
+    }
 }
 
-uintmax_t LLDiskCache::dirFileSize(const std::string& dir, bool force)
+bool LLDiskCache::isPacked(const LLUUID& id)
 {
-    using namespace std::chrono;
-    const seconds cache_duration{ 120 };// A rather arbitrary number. it takes 5 seconds+ on a fast drive to scan 80K+ items. purge runs every minute and will update. so 120 should mean we never need a superfluous cache scan.
+    LLMutexLock lock(&mCatalogMutex);
+    auto it = mCatalog.find(id);
+    return it != mCatalog.end() && it->second.mSegment;
+}
 
-    const auto current_time = system_clock::now();
+S32 LLDiskCache::getPackedSize(const LLUUID& id)
+{
+    LLMutexLock lock(&mCatalogMutex);
+    auto it = mCatalog.find(id);
+    return it != mCatalog.end() && it->second.mSegment ? (S32)it->second.mSize : -1;
+}
 
-    const auto time_difference = duration_cast<seconds>(current_time - mLastScanTime);
+bool LLDiskCache::readPacked(const LLUUID& id, S32 offset, U8* buffer, S32 bytes, S32& bytes_read)
+{
+    LL_PROFILE_ZONE_SCOPED;
+    LLMutexLock lock(&mCatalogMutex);
+    auto it = mCatalog.find(id);
+    if (it == mCatalog.end() || !it->second.mSegment)
+    {
+        return false;
+    }
 
-    // Check if the cached result can be used
-    if( !force && time_difference < cache_duration )
+    const CatalogEntry& entry = it->second;
+    auto segment = mSegments.find(entry.mSegment);
+    bytes_read = 0;
+    if (segment != mSegments.end() && offset >= 0 && (uintmax_t)offset < entry.mSize)
     {
-        LL_DEBUGS("LLDiskCache") << "Using cached result: " << mStoredCacheSize << LL_ENDL;
-        return mStoredCacheSize;
+        bytes_read = llmin(bytes, (S32)(entry.mSize - offset));
+        memcpy(buffer, segment->second->mFile.getData() + entry.mOffset + offset, bytes_read);
+    }
+    return true;
+}
+
+void LLDiskCache::unpack(const LLUUID& id, LLAssetType::EType at, bool keep_data)
+{
+    LLMutexLock lock(&mCatalogMutex);
+    auto it = mCatalog.find(id);
+    if (it == mCatalog.end() || !it->second.mSegment)
+    {
+        return;
+    }
+
+    CatalogEntry& entry = it->second;
+    bool kept = false;
+    auto segment = mSegments.find(entry.mSegment);
+    if (keep_data && segment != mSegments.end())
+    {
+        LLFILE* file = LLFile::fopen(metaDataToFilepath(id, at), "wb");
+        if (file)
+        {
+            kept = fwrite(segment->second->mFile.getData() + entry.mOffset, 1, (size_t)entry.mSize, file) == entry.mSize;
+            kept = (fclose(file) == 0) && kept;
+        }
+    }
+
+    releasePacked(entry);
+    if (!kept)
+    {
+        mCatalogBytes -= entry.mSize;
+        entry.mSize = 0;
+    }
+    entry.mLastWrite = std::time(nullptr);
+    journal(JOURNAL_ADD, id, &entry);
+}
+
+// static
+std::string LLDiskCache::getPackDir()
+{
+    return sCacheDir + gDirUtilp->getDirDelimiter() + PACK_DIRNAME;
+}
+
+// static
+std::string LLDiskCache::getSegmentPath(U16 segment)
+{
+    return getPackDir() + gDirUtilp->getDirDelimiter() + llformat("segment_%05u.pack", (U32)segment);
+}
+
+void LLDiskCache::openSegments()
+{
+    LLMutexLock lock(&mCatalogMutex);
+
+    // what the catalog expects of each segment
+    for (const auto& item : mCatalog)
+    {
+        if (item.second.mSegment)
+        {
+            auto& segment = mSegments[item.second.mSegment];
+            if (!segment)
+            {
+                segment = std::make_unique<PackSegment>();
+            }
+            segment->mUsed = llmax(segment->mUsed, (size_t)(item.second.mOffset + item.second.mSize));
+            segment->mLiveBytes += (size_t)item.second.mSize;
+        }
+    }
+
+    for (auto it = mSegments.begin(); it != mSegments.end(); )
+    {
+        const std::string path = getSegmentPath(it->first);
+        PackSegment& segment = *it->second;
+        if (!gDirUtilp->fileExists(path) || !segment.mFile.open(path, 0) || segment.mFile.getSize() < segment.mUsed)
+        {
+            LL_WARNS("LLDiskCache") << "Pack segment " << path << " is missing or short, forgetting its files" << LL_ENDL;
+            segment.mFile.close();
+            it = mSegments.erase(it);
+        }
+        else
+        {
+            mActiveSegment = it->first;
+            ++it;
+        }
+    }
+
+    // forget files whose segment is gone
+    for (auto it = mCatalog.begin(); it != mCatalog.end(); )
+    {
+        if (it->second.mSegment && !mSegments.count(it->second.mSegment))
+        {
+            mCatalogBytes -= it->second.mSize;
+            it = mCatalog.erase(it);
+            mJournalRewrite = true;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    // and delete segments nothing refers to
+    std::vector<std::string> orphans;
+    for (const std::string& filename : gDirUtilp->getFilesInDir(getPackDir()))
+    {
+        U32 number = 0;
+        if (sscanf(filename.c_str(), "segment_%5u.pack", &number) != 1 || !mSegments.count((U16)number))
+        {
+            orphans.push_back(getPackDir() + gDirUtilp->getDirDelimiter() + filename);
+        }
+    }
+    for (const std::string& path : orphans)
+    {
+        LLFile::remove(path, ENOENT);
+    }
+}
+
+void LLDiskCache::closeSegments()
+{
+    for (auto& segment : mSegments)
+    {
+        segment.second->mFile.close();
+    }
+    mSegments.clear();
+    mActiveSegment = 0;
+}
+
+bool LLDiskCache::appendPacked(const U8* data, U32 size, U16& segment_number, U32& offset)
+{
+    auto active = mSegments.find(mActiveSegment);
+    if (active == mSegments.end() || active->second->mUsed + size > PACK_SEGMENT_SIZE)
+    {
+        // segment numbers only grow, 0 means a file of its own
+        U16 number = mSegments.empty() ? 1 : mSegments.rbegin()->first + 1;
+        if (number == 0)
+        {
+            return false;
+        }
+        auto segment = std::make_unique<PackSegment>();
+        if (!segment->mFile.open(getSegmentPath(number), PACK_SEGMENT_GROWTH))
+        {
+            LL_WARNS("LLDiskCache") << "Could not create pack segment " << getSegmentPath(number) << LL_ENDL;
+            return false;
+        }
+        active = mSegments.emplace(number, std::move(segment)).first;
+        mActiveSegment = number;
+    }
+
+    PackSegment& segment = *active->second;
+    if (segment.mUsed + size > segment.mFile.getSize() &&
+        !segment.mFile.resize(llmin(PACK_SEGMENT_SIZE, segment.mUsed + size + PACK_SEGMENT_GROWTH)))
+    {
+        return false;
+    }
+
+    segment_number = active->first;
+    offset = (U32)segment.mUsed;
+    memcpy(segment.mFile.getData() + segment.mUsed, data, size);
+    segment.mUsed += size;
+    segment.mLiveBytes += size;
+    return true;
+}
+
+void LLDiskCache::releasePacked(CatalogEntry& entry)
+{
+    auto segment = mSegments.find(entry.mSegment);
+    if (segment != mSegments.end())
+    {
+        segment->second->mLiveBytes -= llmin(segment->second->mLiveBytes, (size_t)entry.mSize);
+    }
+    entry.mSegment = 0;
+    entry.mOffset = 0;
+}
+
+void LLDiskCache::packSmallFiles()
+{
+    if (!mPackMaxFileSize)
+    {
+        return;
+    }
+    LL_PROFILE_ZONE_SCOPED;
+
+    const std::time_t now = std::time(nullptr);
+    std::vector<std::pair<LLUUID, CatalogEntry>> candidates;
+    {
+        LLMutexLock lock(&mCatalogMutex);
+        for (const auto& item : mCatalog)
+        {
+            const CatalogEntry& entry = item.second;
+            if (!entry.mSegment && entry.mSize > 0 && entry.mSize <= mPackMaxFileSize &&
+                now - entry.mLastWrite > PACK_MIN_AGE)
+            {
+                candidates.emplace_back(item);
+                if (candidates.size() >= PACK_FILES_PER_PASS)
+                {
+                    break;
+                }
+            }
+        }
+    }
+
+    size_t packed = 0;
+    std::vector<U8> data;
+    for (const auto& candidate : candidates)
+    {
+        const std::string path = metaDataToFilepath(candidate.first, candidate.second.mType);
+        data.resize((size_t)candidate.second.mSize);
+        LLFILE* file = LLFile::fopen(path, "rb");
+        if (!file)
+        {
+            continue;
+        }
+        bool read = fread(data.data(), 1, data.size(), file) == data.size();
+        fclose(file);
+        if (!read)
+        {
+            continue;
+        }
+
+        LLMutexLock lock(&mCatalogMutex);
+        auto it = mCatalog.find(candidate.first);
+        // skip files written or removed while we read them
+        if (it == mCatalog.end() || it->second.mSegment ||
+            it->second.mSize != candidate.second.mSize || it->second.mLastWrite != candidate.second.mLastWrite)
+        {
+            continue;
+        }
+        if (!appendPacked(data.data(), (U32)data.size(), it->second.mSegment, it->second.mOffset))
+        {
+            break;
+        }
+        journal(JOURNAL_ADD, it->first, &it->second);
+        // still under the lock, so a writer unpacks first instead of losing its file
+        LLFile::remove(path, ENOENT);
+        ++packed;
+    }
+
+    if (packed)
+    {
+        LLMutexLock lock(&mCatalogMutex);
+        mSegments[mActiveSegment]->mFile.flush();
+        LL_DEBUGS("LLDiskCache") << "Packed " << packed << " small files" << LL_ENDL;
+    }
+}
+
+void LLDiskCache::compactSegments()
+{
+    LL_PROFILE_ZONE_SCOPED;
+
+    if (mReadOnly)
+    {
+        // moving files would leave the catalog of the first instance behind
+        return;
+    }
+
+    // the emptiest segment that is at most half full of live files
+    U16 number = 0;
+    {
+        LLMutexLock lock(&mCatalogMutex);
+        size_t least_live = PACK_SEGMENT_SIZE;
+        for (const auto& segment : mSegments)
+        {
+            if (segment.first != mActiveSegment && segment.second->mLiveBytes * 2 <= segment.second->mUsed &&
+                segment.second->mLiveBytes < least_live)
+            {
+                number = segment.first;
+                least_live = segment.second->mLiveBytes;
+            }
+        }
+    }
+    if (!number)
+    {
+        return;
+    }
+
+    std::vector<LLUUID> moving;
+    {
+        LLMutexLock lock(&mCatalogMutex);
+        for (const auto& item : mCatalog)
+        {
+            if (item.second.mSegment == number)
+            {
+                moving.push_back(item.first);
+            }
+        }
+    }
+
+    // one file at a time so readers aren't held up
+    for (const LLUUID& id : moving)
+    {
+        LLMutexLock lock(&mCatalogMutex);
+        auto it = mCatalog.find(id);
+        if (it == mCatalog.end() || it->second.mSegment != number)
+        {
+            continue;
+        }
+        const U8* data = mSegments[number]->mFile.getData() + it->second.mOffset;
+        CatalogEntry& entry = it->second;
+        U16 new_segment = 0;
+        U32 new_offset = 0;
+        if (!appendPacked(data, (U32)entry.mSize, new_segment, new_offset))
+        {
+            return;
+        }
+        releasePacked(entry);
+        entry.mSegment = new_segment;
+        entry.mOffset = new_offset;
+        journal(JOURNAL_ADD, id, &entry);
+    }
+
+    // the journal must know where the files went before their old copies go
+    {
+        LLMutexLock lock(&mCatalogMutex);
+        mSegments[mActiveSegment]->mFile.flush();
+    }
+    flushJournal();
+
+    LLMutexLock lock(&mCatalogMutex);
+    auto segment = mSegments.find(number);
+    if (segment != mSegments.end() && !segment->second->mLiveBytes)
+    {
+        segment->second->mFile.close();
+        mSegments.erase(segment);
+        LLFile::remove(getSegmentPath(number), ENOENT);
+        LL_DEBUGS("LLDiskCache") << "Compacted pack segment " << number << LL_ENDL;
+    }
+}
+
+void LLDiskCache::journal(EJournalOp op, const LLUUID& id, CatalogEntry* entry)
+{
+    if (entry)
+    {
+        entry->mJournaledAccess = entry->mLastAccess;
+    }
+    if (!mReadOnly)
+    {
+        appendRecord(mPendingRecords, op, id, entry);
+    }
+}
+
+// static
+void LLDiskCache::appendRecord(std::vector<JournalRecord>& records, EJournalOp op, const LLUUID& id,
+                               const CatalogEntry* entry)
+{
+    JournalRecord record = {};
+    record.mID = id;
+    record.mOp = op;
+    if (entry)
+    {
+        record.mSize = entry->mSize;
+        record.mTime = entry->mLastAccess;
+        record.mType = entry->mType;
+        record.mOffset = entry->mOffset;
+        record.mSegment = entry->mSegment;
+    }
+    records.push_back(record);
+}
+
+// static
+std::string LLDiskCache::getJournalPath()
+{
+    return sCacheDir + gDirUtilp->getDirDelimiter() + JOURNAL_FILENAME;
+}
+
+bool LLDiskCache::loadCatalog()
+{
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    LLFILE* file = LLFile::fopen(getJournalPath(), "rb");
+    if (!file)
+    {
+        return false;
+    }
+
+    char magic[sizeof(JOURNAL_MAGIC)];
+    bool valid = fread(magic, sizeof(magic), 1, file) == 1 && memcmp(magic, JOURNAL_MAGIC, sizeof(magic)) == 0;
+    bool closed = false;
+    size_t record_count = 0;
+
+    LLMutexLock lock(&mCatalogMutex);
+    std::vector<JournalRecord> records(1024);
+    size_t count = 0;
+    while (valid && (count = fread(records.data(), sizeof(JournalRecord), records.size(), file)) > 0)
+    {
+        record_count += count;
+        for (size_t i = 0; i < count && valid; ++i)
+        {
+            const JournalRecord& record = records[i];
+            closed = false;
+            switch (record.mOp)
+            {
+            case JOURNAL_ADD:
+            {
+                CatalogEntry& entry = mCatalog.try_emplace(record.mID, CatalogEntry{ 0, 0, 0, 0, LLAssetType::AT_NONE, 0, 0 }).first->second;
+                mCatalogBytes -= entry.mSize;
+                entry.mSize = record.mSize;
+                entry.mLastAccess = entry.mJournaledAccess = (std::time_t)record.mTime;
+                entry.mType = (LLAssetType::EType)record.mType;
+                entry.mOffset = record.mOffset;
+                entry.mSegment = record.mSegment;
+                mCatalogBytes += entry.mSize;
+                break;
+            }
+            case JOURNAL_TOUCH:
+            {
+                auto it = mCatalog.find(record.mID);
+                if (it != mCatalog.end())
+                {
+                    it->second.mLastAccess = it->second.mJournaledAccess = (std::time_t)record.mTime;
+                }
+                break;
+            }
+            case JOURNAL_REMOVE:
+            {
+                auto it = mCatalog.find(record.mID);
+                if (it != mCatalog.end())
+                {
+                    mCatalogBytes -= it->second.mSize;
+                    mCatalog.erase(it);
+                }
+                break;
+            }
+            case JOURNAL_OPENED:
+                break;
+            case JOURNAL_CLOSED:
+                closed = true;
+                break;
+            default:
+                valid = false;
+                break;
+            }
+        }
+    }
+    // a write torn by a crash leaves part of a record at the end, appending to it would misalign the rest
+    valid = valid && ftell(file) == (long)(sizeof(JOURNAL_MAGIC) + record_count * sizeof(JournalRecord));
+    fclose(file);
+
+    if (!valid)
+    {
+        LL_INFOS("LLDiskCache") << "Cache catalog is damaged, rescanning the cache" << LL_ENDL;
+        mCatalog.clear();
+        mCatalogBytes = 0;
+        return false;
+    }
+    if (!closed)
+    {
+        // files of their own may have come and gone unrecorded, but packed files
+        // are only journaled once they are in their segment
+        LL_INFOS("LLDiskCache") << "Cache catalog was not closed, rescanning the cache" << LL_ENDL;
+        return false;
+    }
+
+    mJournalRecords = record_count;
+    mJournalRewrite = record_count > 2 * mCatalog.size() + JOURNAL_SLACK;
+
+    auto execute_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start_time).count();
+    LL_INFOS("LLDiskCache") << "Loaded cache catalog of " << mCatalog.size() << " files, " << mCatalogBytes
+                            << " bytes in " << execute_time << " ms" << LL_ENDL;
+    return true;
+}
+
+void LLDiskCache::scanCacheDir()
+{
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    {
+        LLMutexLock lock(&mCatalogMutex);
+        for (auto it = mCatalog.begin(); it != mCatalog.end(); )
+        {
+            if (it->second.mSegment)
+            {
+                ++it;
+            }
+            else
+            {
+                mCatalogBytes -= it->second.mSize;
+                it = mCatalog.erase(it);
+            }
+        }
+        mPendingRecords.clear();
+        mJournalRewrite = true;
     }
-// </FS:Beq>
-    uintmax_t total_file_size = 0;
 
-    /**
-     * There may be a better way that works directly on the folder (similar to
-     * right clicking on a folder in the OS and asking for size vs right clicking
-     * on all files and adding up manually) but this is very fast - less than 100ms
-     * for 10,000 files in my testing so, so long as it's not called frequently,
-     * it should be okay. Note that's it's only currently used for logging/debugging
-     * so if performance is ever an issue, optimizing this or removing it altogether,
-     * is an easy win.
-     */
     boost::system::error_code ec;
 #if LL_WINDOWS
-    std::wstring dir_path(utf8str_to_utf16str(dir));
+    std::wstring cache_path(utf8str_to_utf16str(sCacheDir));
 #else
-    std::string dir_path(dir);
+    std::string cache_path(sCacheDir);
 #endif
-    if (boost::filesystem::is_directory(dir_path, ec) && !ec.failed())
+    if (boost::filesystem::is_directory(cache_path, ec) && !ec.failed())
     {
         // <FS:Ansariel> Optimize asset simple disk cache
-        //boost::filesystem::directory_iterator iter(dir_path, ec);
-        //while (iter != boost::filesystem::directory_iterator() && !ec.failed())
-        boost::filesystem::recursive_directory_iterator iter(dir_path, ec);
+        boost::filesystem::recursive_directory_iterator iter(cache_path, ec);
         while (iter != boost::filesystem::recursive_directory_iterator() && !ec.failed())
-            // </FS:Ansariel>
+        // </FS:Ansariel>
         {
             if (boost::filesystem::is_regular_file(*iter, ec) && !ec.failed())
             {
                 if ((*iter).path().string().find(CACHE_FILENAME_PREFIX) != std::string::npos)
                 {
                     uintmax_t file_size = boost::filesystem::file_size(*iter, ec);
+                    std::time_t file_time = ec.failed() ? 0 : boost::filesystem::last_write_time(*iter, ec);
                     if (!ec.failed())
                     {
-                        total_file_size += file_size;
+                        addScannedFile((*iter).path().string(), file_size, file_time);
                     }
                 }
             }
@@ -540,10 +1090,103 @@ uintmax_t LLDiskCache::dirFileSize(const std::string& dir, bool force)
         }
     }
 
-// <FS:Beq> Lets not scan every single time if we can avoid it eh?
-    // return total_file_size;
-    return updateCacheSize(total_file_size);
-// </FS:Beq>
+    auto execute_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start_time).count();
+    LLMutexLock lock(&mCatalogMutex);
+    LL_INFOS("LLDiskCache") << "Scanned " << mCatalog.size() << " cache files, " << mCatalogBytes
+                            << " bytes in " << execute_time << " ms" << LL_ENDL;
+}
+
+void LLDiskCache::addScannedFile(const std::string& path, uintmax_t size, std::time_t time)
+{
+    // "sl_cache_<uuid>_0"
+    std::string base_name = gDirUtilp->getBaseFileName(path, true);
+    if (base_name.size() < CACHE_FILENAME_PREFIX.size() + 1 + UUID_STR_LENGTH - 1)
+    {
+        return;
+    }
+    std::string uuid_as_string = base_name.substr(CACHE_FILENAME_PREFIX.size() + 1, UUID_STR_LENGTH - 1);
+    if (!LLUUID::validate(uuid_as_string))
+    {
+        return;
+    }
+
+    LLMutexLock lock(&mCatalogMutex);
+    auto result = mCatalog.try_emplace(LLUUID(uuid_as_string), CatalogEntry{ size, time, time, 0, LLAssetType::AT_NONE, 0, 0 });
+    if (result.second)
+    {
+        mCatalogBytes += size;
+    }
+}
+
+void LLDiskCache::flushJournal(bool closing)
+{
+    if (mReadOnly)
+    {
+        // the journal is the first instance's, it would lose its records
+        return;
+    }
+
+    LLMutexLock journal_lock(&mJournalMutex);
+
+    std::vector<JournalRecord> records;
+    bool rewrite = false;
+    {
+        LLMutexLock lock(&mCatalogMutex);
+        rewrite = mJournalRewrite ||
+                  mJournalRecords + mPendingRecords.size() > 2 * mCatalog.size() + JOURNAL_SLACK;
+        if (rewrite)
+        {
+            // everything pending is part of the snapshot
+            mPendingRecords.clear();
+            records.reserve(mCatalog.size() + 1);
+            for (auto& item : mCatalog)
+            {
+                item.second.mJournaledAccess = item.second.mLastAccess;
+                appendRecord(records, JOURNAL_ADD, item.first, &item.second);
+            }
+            mJournalRewrite = false;
+        }
+        else
+        {
+            records.swap(mPendingRecords);
+        }
+    }
+
+    if (!rewrite && records.empty() && (!closing || mJournalClosed))
+    {
+        return;
+    }
+    if (closing)
+    {
+        appendRecord(records, JOURNAL_CLOSED, LLUUID::null, nullptr);
+    }
+
+    const std::string journal_path = getJournalPath();
+    const std::string write_path = rewrite ? journal_path + ".tmp" : journal_path;
+    bool success = false;
+    LLFILE* file = LLFile::fopen(write_path, rewrite ? "wb" : "ab");
+    if (file)
+    {
+        success = (!rewrite || fwrite(JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC), 1, file) == 1) &&
+                  (records.empty() || fwrite(records.data(), sizeof(JournalRecord), records.size(), file) == records.size());
+        success = (fclose(file) == 0) && success;
+    }
+    if (success && rewrite)
+    {
+        LLFile::remove(journal_path, ENOENT);
+        success = LLFile::rename(write_path, journal_path) == 0;
+    }
+
+    if (!success)
+    {
+        LL_WARNS("LLDiskCache") << "Failed to write cache catalog " << write_path << LL_ENDL;
+        LLMutexLock lock(&mCatalogMutex);
+        mJournalRewrite = true;
+        return;
+    }
+
+    mJournalRecords = rewrite ? records.size() : mJournalRecords + records.size();
+    mJournalClosed = closing;
 }
 
 LLPurgeDiskCacheThread::LLPurgeDiskCacheThread() :
@@ -559,4 +1202,5 @@ void LLPurgeDiskCacheThread::run()
     {
         LLDiskCache::instance().purge();
     }
+    LLDiskCache::instance().flushJournal(true);
 }
@@ -22,12 +22,20 @@
                     that identifies the type of asset being stored.
         .asset      A file extension of .asset is used to help
                     identify this as a Viewer asset file
- * 2/ The time of last access for a file can be updated instantly
- *    for file reads and automatically as part of the file writes.
- * 3/ The purge algorithm collects a list of all files in the
- *    directory, sorts them by date of last access (write) and then
- *    deletes any files based on age until the total size of all
- *    the files is less than the maximum size specified.
+ * 2/ The size and time of last access of every file are kept in
+ *    an in-memory catalog, updated as LLFileSystem reads, writes,
+ *    renames and removes files. Changes are appended to a journal
+ *    in the cache folder so the catalog survives a restart without
+ *    scanning the folder; the directory is only scanned again when
+ *    the viewer did not shut down cleanly.
+ * 3/ The purge algorithm sorts the catalog by time of last access
+ *    and deletes the oldest files until the total size of all the
+ *    files is less than the low water mark.
+ * 3a/ Small files that are no longer being written are moved into
+ *    large append-only pack segments by the purge thread and read
+ *    back through a memory mapping, saving a file open per asset.
+ *    Segments that are mostly dead space are compacted by moving
+ *    what is left into the newest segment.
  * 4/ An LLSingleton idiom is used since there will only ever be
  *    a single cache and we want to access it from numerous places.
  * 5/ Performance on my modest system seems very acceptable. For
@@ -63,7 +71,14 @@
 #define _LLDISKCACHE
 
 #include "llsingleton.h"
+#include "llassettype.h"
+#include "llmappedfile.h"
+#include "llmutex.h"
+#include "lluuid.h"
 #include <chrono>
+#include <map>
+#include <memory>
+#include <unordered_map>
 using namespace std::chrono;
 
 
@@ -104,11 +119,18 @@ class LLDiskCache :
                     /**
                      * A floating point percentage of the max_size_bytes which the cache purge will aim to reach once triggered.
                      */
-                    const F32 lowwater_mark_percent
+                    const F32 lowwater_mark_percent,
                     // </FS:Beq>
+                    /**
+                     * Set for a second viewer instance sharing the cache
+                     * folder: the catalog journal belongs to the first
+                     * instance, so it is read but never written or
+                     * compacted, and neither are the pack segments
+                     */
+                    const bool read_only
                     );
 
-        virtual ~LLDiskCache() = default;
+        virtual ~LLDiskCache();
 
     public:
         /**
@@ -120,6 +142,35 @@ class LLDiskCache :
          */
         static const std::string metaDataToFilepath(const LLUUID& id, LLAssetType::EType at);
 
+        /**
+         * Catalog updates, called by LLFileSystem from any thread. Reads
+         * only touch the catalog in memory; the journal is written by
+         * the purge thread.
+         */
+        void fileAccessed(const LLUUID& id);
+        void fileWritten(const LLUUID& id, LLAssetType::EType at, uintmax_t size, bool exact_size);
+        void fileRenamed(const LLUUID& old_id, const LLUUID& new_id, LLAssetType::EType new_at);
+        void fileRemoved(const LLUUID& id);
+
+        /**
+         * Access to files kept in a pack segment rather than a file of
+         * their own. LLFileSystem checks these before touching the file.
+         * unpack() must be called before writing: keep_data moves the
+         * packed bytes back into a file of their own, otherwise they are
+         * dropped as the file is about to be overwritten.
+         */
+        bool isPacked(const LLUUID& id);
+        S32 getPackedSize(const LLUUID& id); // -1 if not packed
+        bool readPacked(const LLUUID& id, S32 offset, U8* buffer, S32 bytes, S32& bytes_read);
+        void unpack(const LLUUID& id, LLAssetType::EType at, bool keep_data);
+
+        /**
+         * Append catalog changes to the journal, compacting it when it
+         * has grown much bigger than the catalog. When closing, mark the
+         * journal as complete so the next session can trust it.
+         */
+        void flushJournal(bool closing = false);
+
         /**
          * Purge the oldest items in the cache so that the combined size of all files
          * is no bigger than mMaxSizeBytes.
@@ -158,22 +209,101 @@ class LLDiskCache :
         void setHighWaterPercentage(F32 HiPct) { mHighPercent = llclamp(HiPct, mLowPercent, 100.0);  };
         void setLowWaterPercentage(F32 LowPct) { mLowPercent = llclamp(LowPct, 0.0, mHighPercent);  };
         // </FS:Beq>
+        // Files up to this size are moved into pack segments, 0 to stop packing
+        void setPackMaxFileSize(U32 size) { mPackMaxFileSize = size; }
 
     private:
+        struct CatalogEntry
+        {
+            uintmax_t mSize;
+            std::time_t mLastAccess;
+            std::time_t mJournaledAccess;   // last access time the journal knows about
+            std::time_t mLastWrite;         // this session only
+            LLAssetType::EType mType;
+            U32 mOffset;                    // in the pack segment
+            U16 mSegment;                   // 0 for a file of its own
+        };
+
+        struct PackSegment
+        {
+            LLMappedFile mFile;
+            size_t mUsed = 0;       // bytes appended so far
+            size_t mLiveBytes = 0;  // bytes of files still in the catalog
+        };
+
+        enum EJournalOp : U8
+        {
+            JOURNAL_ADD = 1,
+            JOURNAL_TOUCH,
+            JOURNAL_REMOVE,
+            JOURNAL_OPENED,
+            JOURNAL_CLOSED
+        };
+
+        struct JournalRecord
+        {
+            LLUUID mID;
+            U64 mSize;
+            S64 mTime;
+            S32 mType;
+            U32 mOffset;
+            U16 mSegment;
+            U8 mOp;
+            U8 mPad;
+        };
+
+        /**
+         * Load the catalog from the journal. Returns false if there is no
+         * journal, it can't be read, or the last session didn't close it;
+         * in the last case the packed files are still known.
+         */
+        bool loadCatalog();
+        /**
+         * Rebuild the catalog of files of their own from the cache folder.
+         * Slow on a big cache, only done when the journal can't be trusted.
+         */
+        void scanCacheDir();
         /**
-         * Utility function to gather the total size the files in a given
-         * directory. Primarily used here to determine the directory size
-         * before and after the cache purge
+         * Map the pack segments the catalog refers to, forget files in
+         * segments that are gone and delete segments nothing refers to.
          */
-        uintmax_t updateCacheSize(const uintmax_t newsize); // <FS:Beq/> enable time based caching of dirfilesize except when force is true.
-        uintmax_t dirFileSize(const std::string& dir, bool force = false); // <FS:Beq/> enable time based caching of dirfilesize except when force is true.
+        void openSegments();
+        // move small files into pack segments, a bounded number per call
+        void packSmallFiles();
+        // move what is left of a mostly dead segment into the newest one
+        void compactSegments();
+        // callers hold mCatalogMutex
+        bool appendPacked(const U8* data, U32 size, U16& segment, U32& offset);
+        void releasePacked(CatalogEntry& entry);
+        void closeSegments();
+        static std::string getPackDir();
+        static std::string getSegmentPath(U16 segment);
+        void addScannedFile(const std::string& path, uintmax_t size, std::time_t time);
+        // callers hold mCatalogMutex
+        void journal(EJournalOp op, const LLUUID& id, CatalogEntry* entry = nullptr);
+        static void appendRecord(std::vector<JournalRecord>& records, EJournalOp op, const LLUUID& id,
+                                 const CatalogEntry* entry);
+        static std::string getJournalPath();
 
         /**
-         * cache the directory size cos it takes forever to calculate it
-         * 
+         * The catalog of cached files, the records not yet written to the
+         * journal and the total size of all files, under mCatalogMutex
          */
-        uintmax_t mStoredCacheSize{ 0 };
-        time_point<system_clock> mLastScanTime{ };
+        std::unordered_map<LLUUID, CatalogEntry> mCatalog;
+        std::vector<JournalRecord> mPendingRecords;
+        uintmax_t mCatalogBytes{ 0 };
+        LLMutex mCatalogMutex;
+
+        // pack segments by number, under mCatalogMutex
+        std::map<U16, std::unique_ptr<PackSegment>> mSegments;
+        U16 mActiveSegment{ 0 };
+        U32 mPackMaxFileSize{ 0 };
+
+        // serializes writing the journal file
+        LLMutex mJournalMutex;
+        size_t mJournalRecords{ 0 };
+        bool mJournalClosed{ false };
+        bool mJournalRewrite{ false };  // under mCatalogMutex
 
     private:
         /**
@@ -200,6 +330,11 @@ class LLDiskCache :
          * various parts of the code
          */
         bool mEnableCacheDebugInfo;
+
+        /**
+         * Another instance owns the journal and the pack segments
+         */
+        bool mReadOnly;
         
         std::vector<std::string> mSkipList;  // <FS:Beq/> Vector of "static" untouchable assets that should never be purged
 };
@@ -56,17 +56,23 @@ LLFileSystem::LLFileSystem(const LLUUID& file_id, const LLAssetType::EType file_
     // we decided to follow Henri's suggestion and move the code to update the last access time here.
     if (mode == LLFileSystem::READ)
     {
-        // build the filename (TODO: we do this in a few places - perhaps we should factor into a single function)
-        const std::string filename = LLDiskCache::metaDataToFilepath(mFileID, mFileType);
-
         // update the last access time for the file if it exists - this is required
         // even though we are reading and not writing because this is the
         // way the cache works - it relies on a valid "last accessed time" for
-        // each file so it knows how to remove the oldest, unused files
-        bool exists = gDirUtilp->fileExists(filename);
-        if (exists)
+        // each file so it knows how to remove the oldest, unused files.
+        // The disk cache keeps it in its catalog, no need to touch the file
+        if (LLDiskCache::instanceExists())
         {
-            updateFileAccessTime(filename);
+            LLDiskCache::getInstance()->fileAccessed(mFileID);
+        }
+        else
+        {
+            // build the filename (TODO: we do this in a few places - perhaps we should factor into a single function)
+            const std::string filename = LLDiskCache::metaDataToFilepath(mFileID, mFileType);
+            if (gDirUtilp->fileExists(filename))
+            {
+                updateFileAccessTime(filename);
+            }
         }
     }
 }
@@ -75,6 +81,15 @@ LLFileSystem::LLFileSystem(const LLUUID& file_id, const LLAssetType::EType file_
 bool LLFileSystem::getExists(const LLUUID& file_id, const LLAssetType::EType file_type)
 {
     LL_PROFILE_ZONE_SCOPED;
+    if (LLDiskCache::instanceExists())
+    {
+        S32 packed_size = LLDiskCache::getInstance()->getPackedSize(file_id);
+        if (packed_size >= 0)
+        {
+            return packed_size > 0;
+        }
+    }
+
     const std::string filename = LLDiskCache::metaDataToFilepath(file_id, file_type);
 
     // <FS:Ansariel> IO-streams replacement
@@ -100,7 +115,19 @@ bool LLFileSystem::removeFile(const LLUUID& file_id, const LLAssetType::EType fi
     LL_PROFILE_ZONE_COLOR(tracy::Color::Gold); // <FS:Beq> measure cache performance
     const std::string filename = LLDiskCache::metaDataToFilepath(file_id, file_type);
 
-    LLFile::remove(filename.c_str(), suppress_error);
+    if (!LLDiskCache::instanceExists())
+    {
+        LLFile::remove(filename.c_str(), suppress_error);
+    }
+    else
+    {
+        // a packed file has no file of its own to remove
+        if (!LLDiskCache::getInstance()->isPacked(file_id))
+        {
+            LLFile::remove(filename.c_str(), suppress_error);
+        }
+        LLDiskCache::getInstance()->fileRemoved(file_id);
+    }
 
     return true;
 }
@@ -116,7 +143,12 @@ bool LLFileSystem::renameFile(const LLUUID& old_file_id, const LLAssetType::ETyp
     // Rename needs the new file to not exist.
     LLFileSystem::removeFile(new_file_id, new_file_type, ENOENT);
 
-    if (LLFile::rename(old_filename, new_filename) != 0)
+    if (LLDiskCache::instanceExists() && LLDiskCache::getInstance()->isPacked(old_file_id))
+    {
+        // only the catalog knows the packed file by its id
+        LLDiskCache::getInstance()->fileRenamed(old_file_id, new_file_id, new_file_type);
+    }
+    else if (LLFile::rename(old_filename, new_filename) != 0)
     {
         // We would like to return false here indicating the operation
         // failed but the original code does not and doing so seems to
@@ -124,6 +156,10 @@ bool LLFileSystem::renameFile(const LLUUID& old_file_id, const LLAssetType::ETyp
         //return false;
         LL_WARNS() << "Failed to rename " << old_file_id << " to " << new_file_id << " reason: " << strerror(errno) << LL_ENDL;
     }
+    else if (LLDiskCache::instanceExists())
+    {
+        LLDiskCache::getInstance()->fileRenamed(old_file_id, new_file_id, new_file_type);
+    }
 
     return true;
 }
@@ -132,6 +168,15 @@ bool LLFileSystem::renameFile(const LLUUID& old_file_id, const LLAssetType::ETyp
 S32 LLFileSystem::getFileSize(const LLUUID& file_id, const LLAssetType::EType file_type)
 {
     LL_PROFILE_ZONE_COLOR(tracy::Color::Gold); // <FS:Beq> measure cache performance
+    if (LLDiskCache::instanceExists())
+    {
+        S32 packed_size = LLDiskCache::getInstance()->getPackedSize(file_id);
+        if (packed_size >= 0)
+        {
+            return packed_size;
+        }
+    }
+
     const std::string filename = LLDiskCache::metaDataToFilepath(file_id, file_type);
 
     S32 file_size = 0;
@@ -157,6 +202,13 @@ bool LLFileSystem::read(U8* buffer, S32 bytes)
     LL_PROFILE_ZONE_COLOR(tracy::Color::Gold); // <FS:Beq> measure cache performance
     bool success = false;
 
+    if (LLDiskCache::instanceExists() &&
+        LLDiskCache::getInstance()->readPacked(mFileID, mPosition, buffer, bytes, mBytesRead))
+    {
+        mPosition += mBytesRead;
+        return mBytesRead > 0;
+    }
+
     const std::string filename = LLDiskCache::metaDataToFilepath(mFileID, mFileType);
 
     // <FS:Ansariel> IO-streams replacement
@@ -223,7 +275,16 @@ bool LLFileSystem::write(const U8* buffer, S32 bytes)
     LL_PROFILE_ZONE_COLOR(tracy::Color::Gold); // <FS:Beq> measure cache performance
     const std::string filename = LLDiskCache::metaDataToFilepath(mFileID, mFileType);
 
+    if (LLDiskCache::instanceExists())
+    {
+        // a full write replaces the file, anything else needs what is there
+        LLDiskCache::getInstance()->unpack(mFileID, mFileType, mMode != WRITE);
+    }
+
     bool success = false;
+    // whether the file was written, and whether mPosition is now its size
+    bool written = false;
+    bool exact_size = true;
 
     // <FS:Ansariel> IO-streams replacement
     //if (mMode == APPEND)
@@ -282,6 +343,7 @@ bool LLFileSystem::write(const U8* buffer, S32 bytes)
             mPosition = ftell(ofs);
             fclose(ofs);
             success = (bytes_written == bytes);
+            written = true;
         }
     }
     else if (mMode == READ_WRITE)
@@ -295,6 +357,8 @@ bool LLFileSystem::write(const U8* buffer, S32 bytes)
                 mPosition = ftell(ofs);
                 fclose(ofs);
                 success = (bytes_written == bytes);
+                written = true;
+                exact_size = false;
             }
         }
         else
@@ -306,6 +370,7 @@ bool LLFileSystem::write(const U8* buffer, S32 bytes)
                 mPosition = ftell(ofs);
                 fclose(ofs);
                 success = (bytes_written == bytes);
+                written = true;
             }
         }
     }
@@ -318,10 +383,16 @@ bool LLFileSystem::write(const U8* buffer, S32 bytes)
             mPosition = ftell(ofs);
             fclose(ofs);
             success = (bytes_written == bytes);
+            written = true;
         }
     }
     // </FS:Ansariel>
 
+    if (written && LLDiskCache::instanceExists())
+    {
+        LLDiskCache::getInstance()->fileWritten(mFileID, mFileType, mPosition, exact_size);
+    }
+
     return success;
 }
 
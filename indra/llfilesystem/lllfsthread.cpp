@@ -28,6 +28,7 @@
 #include "lllfsthread.h"
 #include "llstl.h"
 #include "llapr.h"
+#include "llfile.h"
 
 //============================================================================
 
@@ -36,10 +37,10 @@
 //============================================================================
 // Run on MAIN thread
 //static
-void LLLFSThread::initClass(bool local_is_threaded)
+void LLLFSThread::initClass(bool local_is_threaded, U32 io_threads)
 {
     llassert(sLocal == NULL);
-    sLocal = new LLLFSThread(local_is_threaded);
+    sLocal = new LLLFSThread(local_is_threaded, io_threads);
 }
 
 //static
@@ -64,26 +65,108 @@ void LLLFSThread::cleanupClass()
 
 //----------------------------------------------------------------------------
 
-LLLFSThread::LLLFSThread(bool threaded) :
+LLLFSThread::LLLFSThread(bool threaded, U32 io_threads) :
     LLQueuedThread("LFS", threaded)
 {
     if(!mLocalAPRFilePoolp)
     {
         mLocalAPRFilePoolp = new LLVolatileAPRPool() ;
     }
+
+    io_threads = llmax(io_threads, 1U);
+    for (U32 i = 0; i < io_threads; ++i)
+    {
+        mIOThreads.emplace_back([this, i, io_threads]()
+            {
+                std::string name = llformat("LFS IO %u/%u", i + 1, io_threads);
+                LL_PROFILER_SET_THREAD_NAME(name.c_str());
+                runIO();
+            });
+    }
 }
 
 LLLFSThread::~LLLFSThread()
 {
+    stopIO();
     // mLocalAPRFilePoolp cleanup in LLThread
     // ~LLQueuedThread() will be called here
 }
 
+// virtual
+void LLLFSThread::postRequest(QueuedRequest* req)
+{
+    {
+        std::lock_guard<std::mutex> lock(mIOMutex);
+        mIOQueue.push(static_cast<Request*>(req));
+    }
+    mIOCondition.notify_one();
+}
+
+// Runs on each I/O thread
+void LLLFSThread::runIO()
+{
+    while (true)
+    {
+        Request* req = NULL;
+        {
+            std::unique_lock<std::mutex> lock(mIOMutex);
+            mIOCondition.wait(lock, [this]() { return mIOQuitting || !mIOQueue.empty(); });
+            if (mIOQueue.empty())
+            {
+                // quitting and nothing left
+                return;
+            }
+            req = mIOQueue.top();
+            mIOQueue.pop();
+            ++mIOInFlight;
+        }
+
+        // aborts instead once we are quitting
+        processRequest(req);
+
+        std::lock_guard<std::mutex> lock(mIOMutex);
+        --mIOInFlight;
+    }
+}
+
+void LLLFSThread::stopIO()
+{
+    {
+        std::lock_guard<std::mutex> lock(mIOMutex);
+        mIOQuitting = true;
+    }
+    mIOCondition.notify_all();
+    for (std::thread& thread : mIOThreads)
+    {
+        if (thread.joinable())
+        {
+            thread.join();
+        }
+    }
+    mIOThreads.clear();
+}
+
+// virtual
+size_t LLLFSThread::getPending()
+{
+    std::lock_guard<std::mutex> lock(mIOMutex);
+    return LLQueuedThread::getPending() + mIOQueue.size() + mIOInFlight;
+}
+
+// virtual
+void LLLFSThread::shutdown()
+{
+    setQuitting();
+    // the I/O threads abort what is still queued
+    stopIO();
+    LLQueuedThread::shutdown();
+}
+
 //----------------------------------------------------------------------------
 
 LLLFSThread::handle_t LLLFSThread::read(const std::string& filename,    /* Flawfinder: ignore */
                                         U8* buffer, S32 offset, S32 numbytes,
-                                        Responder* responder)
+                                        Responder* responder, U32 priority)
 {
     LL_PROFILE_ZONE_SCOPED;
     handle_t handle = generateHandle();
@@ -91,7 +174,7 @@ LLLFSThread::handle_t LLLFSThread::read(const std::string& filename,    /* Flawf
     Request* req = new Request(this, handle,
                                FILE_READ, filename,
                                buffer, offset, numbytes,
-                               responder);
+                               responder, priority);
 
     bool res = addRequest(req);
     if (!res)
@@ -104,7 +187,7 @@ LLLFSThread::handle_t LLLFSThread::read(const std::string& filename,    /* Flawf
 
 LLLFSThread::handle_t LLLFSThread::write(const std::string& filename,
                                          U8* buffer, S32 offset, S32 numbytes,
-                                         Responder* responder)
+                                         Responder* responder, U32 priority)
 {
     LL_PROFILE_ZONE_SCOPED;
     handle_t handle = generateHandle();
@@ -112,7 +195,7 @@ LLLFSThread::handle_t LLLFSThread::write(const std::string& filename,
     Request* req = new Request(this, handle,
                                FILE_WRITE, filename,
                                buffer, offset, numbytes,
-                               responder);
+                               responder, priority);
 
     bool res = addRequest(req);
     if (!res)
@@ -129,7 +212,7 @@ LLLFSThread::Request::Request(LLLFSThread* thread,
                               handle_t handle,
                               operation_t op, const std::string& filename,
                               U8* buffer, S32 offset, S32 numbytes,
-                              Responder* responder) :
+                              Responder* responder, U32 priority) :
     QueuedRequest(handle, FLAG_AUTO_COMPLETE),
     mThread(thread),
     mOperation(op),
@@ -138,6 +221,7 @@ LLLFSThread::Request::Request(LLLFSThread* thread,
     mOffset(offset),
     mBytes(numbytes),
     mBytesRead(0),
+    mPriority(priority),
     mResponder(responder)
 {
     if (numbytes <= 0)
@@ -176,6 +260,9 @@ void LLLFSThread::Request::deleteRequest()
     LLQueuedThread::QueuedRequest::deleteRequest();
 }
 
+// Runs on one of the I/O threads. Every request opens its own LLFILE
+// rather than using the thread's APR pool, which isn't safe to allocate
+// from on several threads at once.
 bool LLLFSThread::Request::processRequest()
 {
     LL_PROFILE_ZONE_SCOPED;
@@ -183,9 +270,8 @@ bool LLLFSThread::Request::processRequest()
     if (mOperation ==  FILE_READ)
     {
         llassert(mOffset >= 0);
-        LLAPRFile infile ; // auto-closes
-        infile.open(mFileName, LL_APR_RB, mThread->getLocalAPRFilePool());
-        if (!infile.getFileHandle())
+        LLUniqueFile infile(LLFile::fopen(mFileName, "rb")); // auto-closes
+        if (!infile)
         {
             LL_WARNS() << "LLLFS: Unable to read file: " << mFileName << LL_ENDL;
             mBytesRead = 0; // fail
@@ -193,22 +279,23 @@ bool LLLFSThread::Request::processRequest()
         }
         S32 off;
         if (mOffset < 0)
-            off = infile.seek(APR_END, 0);
+            off = fseek(infile, 0, SEEK_END);
         else
-            off = infile.seek(APR_SET, mOffset);
-        llassert_always(off >= 0);
-        mBytesRead = infile.read(mBuffer, mBytes );
+            off = fseek(infile, mOffset, SEEK_SET);
+        llassert_always(off == 0);
+        mBytesRead = (S32)fread(mBuffer, 1, mBytes, infile);
         complete = true;
 //      LL_INFOS() << "LLLFSThread::READ:" << mFileName << " Bytes: " << mBytesRead << LL_ENDL;
     }
     else if (mOperation ==  FILE_WRITE)
     {
-        apr_int32_t flags = APR_CREATE|APR_WRITE|APR_BINARY;
-        if (mOffset < 0)
-            flags |= APR_APPEND;
-        LLAPRFile outfile ; // auto-closes
-        outfile.open(mFileName, flags, mThread->getLocalAPRFilePool());
-        if (!outfile.getFileHandle())
+        // create if needed, never truncate
+        LLUniqueFile outfile(LLFile::fopen(mFileName, mOffset < 0 ? "ab" : "r+b")); // auto-closes
+        if (!outfile && mOffset >= 0)
+        {
+            outfile = LLFile::fopen(mFileName, "wb");
+        }
+        if (!outfile)
         {
             LL_WARNS() << "LLLFS: Unable to write file: " << mFileName << LL_ENDL;
             mBytesRead = 0; // fail
@@ -216,15 +303,14 @@ bool LLLFSThread::Request::processRequest()
         }
         if (mOffset >= 0)
         {
-            S32 seek = outfile.seek(APR_SET, mOffset);
-            if (seek < 0)
+            if (fseek(outfile, mOffset, SEEK_SET) != 0)
             {
                 LL_WARNS() << "LLLFS: Unable to write file (seek failed): " << mFileName << LL_ENDL;
                 mBytesRead = 0; // fail
                 return true;
             }
         }
-        mBytesRead = outfile.write(mBuffer, mBytes );
+        mBytesRead = (S32)fwrite(mBuffer, 1, mBytes, outfile);
         complete = true;
 //      LL_INFOS() << "LLLFSThread::WRITE:" << mFileName << " Bytes: " << mBytesRead << "/" << mBytes << " Offset:" << mOffset << LL_ENDL;
     }
@@ -27,16 +27,25 @@
 #ifndef LL_LLLFSTHREAD_H
 #define LL_LLLFSTHREAD_H
 
+#include <condition_variable>
+#include <mutex>
 #include <queue>
 #include <string>
 #include <map>
 #include <set>
+#include <thread>
+#include <vector>
 
 #include "llpointer.h"
 #include "llqueuedthread.h"
 
 //============================================================================
 // Threaded Local File System
+//
+// Reads and writes run on a pool of I/O threads so that several requests
+// are in flight at once, which a fast SSD needs to reach its throughput.
+// Queued requests are started highest priority first, in order of
+// submission within a priority.
 //============================================================================
 
 class LLLFSThread : public LLQueuedThread
@@ -50,6 +59,14 @@ public:
         FILE_REMOVE
     };
 
+    enum priority_t {
+        PRIORITY_LOW = 0,
+        PRIORITY_NORMAL = 50,
+        PRIORITY_HIGH = 100
+    };
+
+    static constexpr U32 DEFAULT_IO_THREADS = 4;
+
     //------------------------------------------------------------------------
 public:
 
@@ -71,8 +88,12 @@ public:
                 handle_t handle,
                 operation_t op, const std::string& filename,
                 U8* buffer, S32 offset, S32 numbytes,
-                Responder* responder);
+                Responder* responder, U32 priority = PRIORITY_NORMAL);
 
+        U32 getPriority() const
+        {
+            return mPriority;
+        }
         S32 getBytes()
         {
             return mBytes;
@@ -108,28 +129,59 @@ public:
         S32 mOffset;    // offset into file, -1 = append (WRITE only)
         S32 mBytes;     // bytes to read from file, -1 = all
         S32 mBytesRead; // bytes read from file
+        U32 mPriority;
 
         LLPointer<Responder> mResponder;
     };
 
     //------------------------------------------------------------------------
 public:
-    LLLFSThread(bool threaded = true);
+    LLLFSThread(bool threaded = true, U32 io_threads = DEFAULT_IO_THREADS);
     ~LLLFSThread();
 
     // Return a Request handle
     handle_t read(const std::string& filename,  /* Flawfinder: ignore */
                   U8* buffer, S32 offset, S32 numbytes,
-                  Responder* responder);
+                  Responder* responder, U32 priority = PRIORITY_NORMAL);
     handle_t write(const std::string& filename,
                    U8* buffer, S32 offset, S32 numbytes,
-                   Responder* responder);
+                   Responder* responder, U32 priority = PRIORITY_NORMAL);
+
+    /*virtual*/ size_t getPending();
+    /*virtual*/ void shutdown();
 
     // static initializers
-    static void initClass(bool local_is_threaded = true); // Setup sLocal
+    static void initClass(bool local_is_threaded = true, U32 io_threads = DEFAULT_IO_THREADS); // Setup sLocal
     static S32 updateClass(U32 ms_elapsed);
     static void cleanupClass();     // Delete sLocal
 
+protected:
+    /*virtual*/ void postRequest(QueuedRequest* req);
+
+private:
+    void runIO();
+    void stopIO();
+
+    struct request_less
+    {
+        bool operator()(const Request* lhs, const Request* rhs) const
+        {
+            // highest priority first, then lowest handle (oldest) first
+            if (lhs->getPriority() != rhs->getPriority())
+            {
+                return lhs->getPriority() < rhs->getPriority();
+            }
+            return lhs->getHashKey() > rhs->getHashKey();
+        }
+    };
+
+    std::priority_queue<Request*, std::vector<Request*>, request_less> mIOQueue;
+    std::mutex mIOMutex;
+    std::condition_variable mIOCondition;
+    size_t mIOInFlight = 0;
+    bool mIOQuitting = false;
+    std::vector<std::thread> mIOThreads;
+
 public:
     static LLLFSThread* sLocal;     // Default local file thread
 };
@@ -0,0 +1,206 @@
+/**
+ * @file llmappedfile.cpp
+ * @brief Read/write memory mapping of a file
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llmappedfile.h"
+
+#if LL_WINDOWS
+#include "llwin32headerslean.h"
+#else
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+LLMappedFile::LLMappedFile()
+    : mData(nullptr),
+      mSize(0),
+#if LL_WINDOWS
+      mFile(INVALID_HANDLE_VALUE),
+      mMapping(nullptr)
+#else
+      mFile(-1)
+#endif
+{
+}
+
+LLMappedFile::~LLMappedFile()
+{
+    close();
+}
+
+bool LLMappedFile::open(const std::string& filename, size_t min_size)
+{
+    close();
+
+#if LL_WINDOWS
+    llutf16string utf16filename = utf8str_to_utf16str(filename);
+    HANDLE file = CreateFileW((LPCWSTR)utf16filename.c_str(), GENERIC_READ | GENERIC_WRITE,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        LL_WARNS() << "Can't open " << filename << " for mapping, error: " << GetLastError() << LL_ENDL;
+        return false;
+    }
+    mFile = file;
+#else
+    mFile = ::open(filename.c_str(), O_RDWR | O_CREAT, 0644);
+    if (mFile < 0)
+    {
+        LL_WARNS() << "Can't open " << filename << " for mapping, errno: " << errno << LL_ENDL;
+        return false;
+    }
+#endif
+
+    if (!map(min_size))
+    {
+        LL_WARNS() << "Can't map " << min_size << " bytes of " << filename << LL_ENDL;
+        close();
+        return false;
+    }
+    return true;
+}
+
+void LLMappedFile::close()
+{
+    unmap();
+#if LL_WINDOWS
+    if (mFile != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle((HANDLE)mFile);
+        mFile = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (mFile >= 0)
+    {
+        ::close(mFile);
+        mFile = -1;
+    }
+#endif
+}
+
+bool LLMappedFile::resize(size_t min_size)
+{
+    unmap();
+    return map(min_size);
+}
+
+void LLMappedFile::flush()
+{
+    if (mData)
+    {
+#if LL_WINDOWS
+        FlushViewOfFile(mData, 0);
+#else
+        msync(mData, mSize, MS_ASYNC);
+#endif
+    }
+}
+
+bool LLMappedFile::map(size_t min_size)
+{
+#if LL_WINDOWS
+    if (mFile == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx((HANDLE)mFile, &file_size))
+    {
+        return false;
+    }
+    size_t size = llmax(min_size, (size_t)file_size.QuadPart);
+    if (size == 0)
+    {
+        return false;
+    }
+
+    // Creating the mapping grows the file to size
+    U64 size64 = (U64)size;
+    HANDLE mapping = CreateFileMappingW((HANDLE)mFile, NULL, PAGE_READWRITE,
+                                        (DWORD)(size64 >> 32), (DWORD)(size64 & 0xffffffff), NULL);
+    if (!mapping)
+    {
+        return false;
+    }
+    void* data = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (!data)
+    {
+        CloseHandle(mapping);
+        return false;
+    }
+    mMapping = mapping;
+#else
+    if (mFile < 0)
+    {
+        return false;
+    }
+    struct stat file_stat;
+    if (fstat(mFile, &file_stat) != 0)
+    {
+        return false;
+    }
+    size_t size = llmax(min_size, (size_t)file_stat.st_size);
+    if (size == 0)
+    {
+        return false;
+    }
+    if ((size_t)file_stat.st_size < size && ftruncate(mFile, (off_t)size) != 0)
+    {
+        return false;
+    }
+
+    void* data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, mFile, 0);
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+#endif
+
+    mData = (U8*)data;
+    mSize = size;
+    return true;
+}
+
+void LLMappedFile::unmap()
+{
+    if (mData)
+    {
+#if LL_WINDOWS
+        UnmapViewOfFile(mData);
+        CloseHandle((HANDLE)mMapping);
+        mMapping = nullptr;
+#else
+        munmap(mData, mSize);
+#endif
+        mData = nullptr;
+        mSize = 0;
+    }
+}
@@ -0,0 +1,76 @@
+/**
+ * @file llmappedfile.h
+ * @brief Read/write memory mapping of a file
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLMAPPEDFILE_H
+#define LL_LLMAPPEDFILE_H
+
+// Maps a whole file into memory for reading and writing. Writes go straight
+// to the page cache and reach the disk whenever the OS flushes them (or on
+// flush()/close()).
+//
+// On Windows a mapped view isn't coherent with ReadFile()/WriteFile(), so
+// while a file is mapped all access to it should go through the mapping.
+// Not thread safe: callers serialize open(), resize() and close() against
+// any access to getData().
+
+class LLMappedFile
+{
+public:
+    LLMappedFile();
+    ~LLMappedFile();
+
+    // Opens (creating if needed) and maps filename, growing the file to at
+    // least min_size bytes. A file larger than min_size is mapped whole.
+    bool open(const std::string& filename, size_t min_size);
+    void close();
+
+    // Grows the file and remaps it. Pointers from getData() are invalid
+    // afterwards, even on failure.
+    bool resize(size_t min_size);
+
+    // Schedules dirty pages to be written back, doesn't wait for the disk.
+    void flush();
+
+    bool isOpen() const { return mData != nullptr; }
+    U8* getData() const { return mData; }
+    size_t getSize() const { return mSize; }
+
+private:
+    bool map(size_t min_size);
+    void unmap();
+
+private:
+    U8* mData;
+    size_t mSize;
+#if LL_WINDOWS
+    void* mFile;    // HANDLE
+    void* mMapping; // HANDLE
+#else
+    int mFile;
+#endif
+};
+
+#endif // LL_LLMAPPEDFILE_H
@@ -39,7 +39,9 @@
 #include "llimagejpeg.h"
 #include "llimagepng.h"
 #include "llimagedxt.h"
+#include "llimagekernels.h"
 #include "llmemory.h"
+#include "llmemtag.h"
 
 #include <boost/preprocessor.hpp>
 
@@ -571,7 +573,14 @@ static void bilinear_scale(const U8 *src, U32 srcW, U32 srcH, U32 srcCh, U32 src
         bilinear_scale<3>(src, srcW, srcH, srcStride, dst, dstW, dstH, dstStride);
         break;
     case 4:
-        bilinear_scale<4>(src, srcW, srcH, srcStride, dst, dstW, dstH, dstStride);
+        if (dstW < srcW && dstH < srcH && LLImageKernels::getISA() != LLImageKernels::ISA_SCALAR)
+        {
+            LLImageKernels::bilinearDownscale4(src, srcW, srcH, srcStride, dst, dstW, dstH, dstStride);
+        }
+        else
+        {
+            bilinear_scale<4>(src, srcW, srcH, srcStride, dst, dstW, dstH, dstStride);
+        }
         break;
     default:
         llassert(!"Implement if need");
@@ -668,12 +677,22 @@ void LLImageBase::sanityCheck()
     }
 }
 
+static LLMemTag sImageMemTag("Images");
+
+void LLImageBase::accountData()
+{
+    S32 size = mData ? mDataSize : 0;
+    sImageMemTag.claim(size - mAccountedSize);
+    mAccountedSize = size;
+}
+
 // virtual
 void LLImageBase::deleteData()
 {
     ll_aligned_free_16(mData);
     mDataSize = 0;
     mData = NULL;
+    accountData();
 }
 
 // virtual
@@ -730,6 +749,7 @@ U8* LLImageBase::allocateData(S32 size)
         addAllocationError();
     }
     mDataSize = size;
+    accountData();
 
     return mData;
 }
@@ -752,6 +772,7 @@ U8* LLImageBase::reallocateData(S32 size)
     mData = new_datap;
     mDataSize = size;
     mBadBufferAllocation = false;
+    accountData();
     return mData;
 }
 
@@ -1066,15 +1087,7 @@ bool LLImageRaw::optimizeAwayAlpha()
         // alpha channel is all 255, make a new copy of data without alpha channel
         U8* new_data = (U8*) ll_aligned_malloc_16(getWidth() * getHeight() * 3);
 
-        for (U32 i = 0; i < pixels; ++i)
-        {
-            U32 di = i * 3;
-            U32 si = i * 4;
-            for (U32 j = 0; j < 3; ++j)
-            {
-                new_data[di+j] = data[si+j];
-            }
-        }
+        LLImageKernels::copy4onto3(data, new_data, pixels);
 
         setDataAndSize(new_data, getWidth(), getHeight(), 3);
 
@@ -1420,6 +1433,18 @@ void LLImageRaw::tint( const LLColor3& color )
     }
 }
 
+void LLImageRaw::premultiplyAlpha()
+{
+    LLImageDataLock lock(this);
+
+    if (getComponents() != 4 || isBufferInvalid())
+    {
+        return;
+    }
+
+    LLImageKernels::premultiplyAlpha(getData(), getWidth() * getHeight());
+}
+
 LLPointer<LLImageRaw> LLImageRaw::duplicate()
 {
     if(getNumRefs() < 2)
@@ -1535,17 +1560,7 @@ void LLImageRaw::copyUnscaled4onto3( const LLImageRaw* src )
     llassert( (3 == dst->getComponents()) && (4 == src->getComponents()) );
     llassert( (src->getWidth() == dst->getWidth()) && (src->getHeight() == dst->getHeight()) );
 
-    S32 pixels = getWidth() * getHeight();
-    const U8* src_data = src->getData();
-    U8* dst_data = dst->getData();
-    for( S32 i=0; i<pixels; i++ )
-    {
-        dst_data[0] = src_data[0];
-        dst_data[1] = src_data[1];
-        dst_data[2] = src_data[2];
-        src_data += 4;
-        dst_data += 3;
-    }
+    LLImageKernels::copy4onto3(src->getData(), dst->getData(), getWidth() * getHeight());
 }
 
 
@@ -1560,18 +1575,7 @@ void LLImageRaw::copyUnscaled3onto4( const LLImageRaw* src )
     llassert( 4 == dst->getComponents() );
     llassert( (src->getWidth() == dst->getWidth()) && (src->getHeight() == dst->getHeight()) );
 
-    S32 pixels = getWidth() * getHeight();
-    const U8* src_data = src->getData();
-    U8* dst_data = dst->getData();
-    for( S32 i=0; i<pixels; i++ )
-    {
-        dst_data[0] = src_data[0];
-        dst_data[1] = src_data[1];
-        dst_data[2] = src_data[2];
-        dst_data[3] = 255;
-        src_data += 3;
-        dst_data += 4;
-    }
+    LLImageKernels::copy3onto4(src->getData(), dst->getData(), getWidth() * getHeight());
 }
 
 
@@ -2210,7 +2214,8 @@ LLImageFormatted::LLImageFormatted(S8 codec)
       mDecoding(0),
       mDecoded(0),
       mDiscardLevel(-1),
-      mLevels(0)
+      mLevels(0),
+      mCodecThreads(1)
 {
 }
 
@@ -2593,67 +2598,24 @@ S8 LLImageFormatted::getCodec() const
     return mCodec;
 }
 
-static void avg4_colors4(const U8* a, const U8* b, const U8* c, const U8* d, U8* dst)
-{
-    dst[0] = (U8)(((U32)(a[0]) + b[0] + c[0] + d[0])>>2);
-    dst[1] = (U8)(((U32)(a[1]) + b[1] + c[1] + d[1])>>2);
-    dst[2] = (U8)(((U32)(a[2]) + b[2] + c[2] + d[2])>>2);
-    dst[3] = (U8)(((U32)(a[3]) + b[3] + c[3] + d[3])>>2);
-}
-
-static void avg4_colors3(const U8* a, const U8* b, const U8* c, const U8* d, U8* dst)
-{
-    dst[0] = (U8)(((U32)(a[0]) + b[0] + c[0] + d[0])>>2);
-    dst[1] = (U8)(((U32)(a[1]) + b[1] + c[1] + d[1])>>2);
-    dst[2] = (U8)(((U32)(a[2]) + b[2] + c[2] + d[2])>>2);
-}
-
-static void avg4_colors2(const U8* a, const U8* b, const U8* c, const U8* d, U8* dst)
-{
-    dst[0] = (U8)(((U32)(a[0]) + b[0] + c[0] + d[0])>>2);
-    dst[1] = (U8)(((U32)(a[1]) + b[1] + c[1] + d[1])>>2);
-}
-
 void LLImageBase::setDataAndSize(U8 *data, S32 size)
 {
     ll_assert_aligned(data, 16);
     mData = data;
     mDataSize = size;
+    accountData();
 }
 
 //static
 void LLImageBase::generateMip(const U8* indata, U8* mipdata, S32 width, S32 height, S32 nchannels)
 {
     llassert(width > 0 && height > 0);
-    U8* data = mipdata;
-    S32 in_width = width*2;
-    for (S32 h=0; h<height; h++)
+    if (nchannels < 1 || nchannels > 4)
     {
-        for (S32 w=0; w<width; w++)
-        {
-            switch(nchannels)
-            {
-              case 4:
-                avg4_colors4(indata, indata+4, indata+4*in_width, indata+4*in_width+4, data);
-                break;
-              case 3:
-                avg4_colors3(indata, indata+3, indata+3*in_width, indata+3*in_width+3, data);
-                break;
-              case 2:
-                avg4_colors2(indata, indata+2, indata+2*in_width, indata+2*in_width+2, data);
-                break;
-              case 1:
-                *(U8*)data = (U8)(((U32)(indata[0]) + indata[1] + indata[in_width] + indata[in_width+1])>>2);
-                break;
-              default:
-                LL_WARNS() << "generateMmip called with bad num channels: " << nchannels << LL_ENDL;
-                return;
-            }
-            indata += nchannels*2;
-            data += nchannels;
-        }
-        indata += nchannels*in_width; // skip odd lines
+        LL_WARNS() << "generateMmip called with bad num channels: " << nchannels << LL_ENDL;
+        return;
     }
+    LLImageKernels::boxDownsample2x(indata, mipdata, width, height, nchannels);
 }
 
 
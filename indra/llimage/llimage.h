@@ -163,8 +163,12 @@ public:
     //static LLTrace::MemStatHandle sMemStat;
 
 private:
+    // Keep the "Images" LLMemTag in step with mData
+    void accountData();
+
     U8 *mData;
     S32 mDataSize;
+    S32 mAccountedSize = 0;
 
     U16 mWidth;
     U16 mHeight;
@@ -256,6 +260,9 @@ public:
     // Multiply this raw image by the given color
     void tint( const LLColor3& color );
 
+    // Multiply the color channels of an RGBA image by its alpha
+    void premultiplyAlpha();
+
     // Copy operations
 
     //duplicate this raw image if refCount > 1.
@@ -385,6 +392,9 @@ public:
     S8 getDiscardLevel() const { return mDiscardLevel; }
     S8 getLevels() const { return mLevels; }
     void setLevels(S8 nlevels) { mLevels = nlevels; }
+    // How many threads a codec that can split one decode or encode may use (J2C only)
+    void setCodecThreads(S32 threads) { mCodecThreads = threads; }
+    S32 getCodecThreads() const { return mCodecThreads; }
 
     // setLastError needs to be deferred for J2C images since it may be called from a DLL
     virtual void resetLastError();
@@ -399,6 +409,7 @@ protected:
     S8 mDecoded;  // unused, but changing LLImage layout requires recompiling static Mac/Linux libs. 2009-01-30 JC
     S8 mDiscardLevel;   // Current resolution level worked on. 0 = full res, 1 = half res, 2 = quarter res, etc...
     S8 mLevels;         // Number of resolution levels in that image. Min is 1. 0 means unknown.
+    S32 mCodecThreads;
 
 public:
     static S32 sGlobalFormattedMemory;
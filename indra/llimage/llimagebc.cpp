@@ -0,0 +1,499 @@
+/**
+ * @file llimagebc.cpp
+ * @brief Block compression (BC1/BC3) of raw images for GPU upload
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llimagebc.h"
+
+#include "llmath.h"
+
+#include <vector>
+
+namespace
+{
+    U16 pack_565(const F32* color)
+    {
+        U32 r = (U32)llclamp(ll_round(color[0] * (31.f / 255.f)), 0, 31);
+        U32 g = (U32)llclamp(ll_round(color[1] * (63.f / 255.f)), 0, 63);
+        U32 b = (U32)llclamp(ll_round(color[2] * (31.f / 255.f)), 0, 31);
+        return (U16)((r << 11) | (g << 5) | b);
+    }
+
+    void unpack_565(U16 packed, S32* color)
+    {
+        S32 r = (packed >> 11) & 31;
+        S32 g = (packed >> 5) & 63;
+        S32 b = packed & 31;
+        color[0] = (r << 3) | (r >> 2);
+        color[1] = (g << 2) | (g >> 4);
+        color[2] = (b << 3) | (b >> 2);
+    }
+
+    void write_u16(U8* out, U16 value)
+    {
+        out[0] = (U8)(value & 0xff);
+        out[1] = (U8)(value >> 8);
+    }
+
+    // Best of the four palette entries between c0 and c1 for each pixel,
+    // as 2 bit indices. Sets error to the total squared error.
+    U32 match_colors(const U8* rgba, U16 c0, U16 c1, S32& error)
+    {
+        error = 0;
+        S32 palette[4][3];
+        unpack_565(c0, palette[0]);
+        unpack_565(c1, palette[1]);
+        for (S32 c = 0; c < 3; ++c)
+        {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+
+        U32 indices = 0;
+        for (S32 i = 0; i < 16; ++i)
+        {
+            U32 best = 0;
+            S32 best_dist = S32_MAX;
+            for (U32 p = 0; p < 4; ++p)
+            {
+                S32 dr = rgba[i * 4 + 0] - palette[p][0];
+                S32 dg = rgba[i * 4 + 1] - palette[p][1];
+                S32 db = rgba[i * 4 + 2] - palette[p][2];
+                S32 dist = dr * dr + dg * dg + db * db;
+                if (dist < best_dist)
+                {
+                    best_dist = dist;
+                    best = p;
+                }
+            }
+            indices |= best << (i * 2);
+            error += best_dist;
+        }
+        return indices;
+    }
+
+    // 8 byte color block: two 565 endpoints along the block's principal
+    // axis and 2 bit palette indices, always in four color mode.
+    void encode_color_block(const U8* rgba, U8* out)
+    {
+        F32 mean[3] = { 0.f, 0.f, 0.f };
+        for (S32 i = 0; i < 16; ++i)
+        {
+            for (S32 c = 0; c < 3; ++c)
+            {
+                mean[c] += rgba[i * 4 + c];
+            }
+        }
+        for (S32 c = 0; c < 3; ++c)
+        {
+            mean[c] /= 16.f;
+        }
+
+        // covariance, upper triangle
+        F32 cov[6] = { 0.f, 0.f, 0.f, 0.f, 0.f, 0.f };
+        for (S32 i = 0; i < 16; ++i)
+        {
+            F32 r = rgba[i * 4 + 0] - mean[0];
+            F32 g = rgba[i * 4 + 1] - mean[1];
+            F32 b = rgba[i * 4 + 2] - mean[2];
+            cov[0] += r * r;
+            cov[1] += r * g;
+            cov[2] += r * b;
+            cov[3] += g * g;
+            cov[4] += g * b;
+            cov[5] += b * b;
+        }
+
+        // a few power iterations are plenty to find the principal axis
+        F32 axis[3] = { 1.f, 1.f, 1.f };
+        for (S32 iter = 0; iter < 4; ++iter)
+        {
+            F32 x = axis[0] * cov[0] + axis[1] * cov[1] + axis[2] * cov[2];
+            F32 y = axis[0] * cov[1] + axis[1] * cov[3] + axis[2] * cov[4];
+            F32 z = axis[0] * cov[2] + axis[1] * cov[4] + axis[2] * cov[5];
+            F32 len = llmax(fabsf(x), llmax(fabsf(y), fabsf(z)));
+            if (len < F_APPROXIMATELY_ZERO)
+            {
+                // flat block, fall back to luminance
+                axis[0] = 0.299f;
+                axis[1] = 0.587f;
+                axis[2] = 0.114f;
+                break;
+            }
+            axis[0] = x / len;
+            axis[1] = y / len;
+            axis[2] = z / len;
+        }
+
+        S32 min_idx = 0;
+        S32 max_idx = 0;
+        F32 min_dot = F32_MAX;
+        F32 max_dot = -F32_MAX;
+        for (S32 i = 0; i < 16; ++i)
+        {
+            F32 dot = rgba[i * 4 + 0] * axis[0] + rgba[i * 4 + 1] * axis[1] + rgba[i * 4 + 2] * axis[2];
+            if (dot < min_dot)
+            {
+                min_dot = dot;
+                min_idx = i;
+            }
+            if (dot > max_dot)
+            {
+                max_dot = dot;
+                max_idx = i;
+            }
+        }
+
+        // inset the endpoints slightly, the extremes are rarely the best fit
+        F32 hi[3];
+        F32 lo[3];
+        for (S32 c = 0; c < 3; ++c)
+        {
+            F32 h = rgba[max_idx * 4 + c];
+            F32 l = rgba[min_idx * 4 + c];
+            F32 inset = (h - l) / 16.f;
+            hi[c] = h - inset;
+            lo[c] = l + inset;
+        }
+
+        U16 c0 = pack_565(hi);
+        U16 c1 = pack_565(lo);
+        S32 error = 0;
+        U32 indices = match_colors(rgba, c0, c1, error);
+
+        // one least squares pass over the chosen indices usually tightens
+        // the endpoints; keep it only if it actually helps
+        if (c0 != c1)
+        {
+            static const F32 weights[4] = { 1.f, 0.f, 2.f / 3.f, 1.f / 3.f };
+            F32 aa = 0.f, ab = 0.f, bb = 0.f;
+            F32 ax[3] = { 0.f, 0.f, 0.f };
+            F32 bx[3] = { 0.f, 0.f, 0.f };
+            for (S32 i = 0; i < 16; ++i)
+            {
+                F32 a = weights[(indices >> (i * 2)) & 3];
+                F32 b = 1.f - a;
+                aa += a * a;
+                ab += a * b;
+                bb += b * b;
+                for (S32 c = 0; c < 3; ++c)
+                {
+                    ax[c] += a * rgba[i * 4 + c];
+                    bx[c] += b * rgba[i * 4 + c];
+                }
+            }
+
+            F32 det = aa * bb - ab * ab;
+            if (fabsf(det) > F_APPROXIMATELY_ZERO)
+            {
+                for (S32 c = 0; c < 3; ++c)
+                {
+                    hi[c] = (ax[c] * bb - bx[c] * ab) / det;
+                    lo[c] = (bx[c] * aa - ax[c] * ab) / det;
+                }
+                U16 r0 = pack_565(hi);
+                U16 r1 = pack_565(lo);
+                S32 refined_error = 0;
+                U32 refined = match_colors(rgba, r0, r1, refined_error);
+                if (refined_error < error)
+                {
+                    c0 = r0;
+                    c1 = r1;
+                    indices = refined;
+                }
+            }
+        }
+
+        if (c0 < c1)
+        {
+            // four color mode needs c0 > c1; swapping the endpoints swaps
+            // index 0 with 1 and 2 with 3
+            std::swap(c0, c1);
+            indices ^= 0x55555555;
+        }
+
+        write_u16(out, c0);
+        write_u16(out + 2, c1);
+
+        out[4] = (U8)(indices & 0xff);
+        out[5] = (U8)((indices >> 8) & 0xff);
+        out[6] = (U8)((indices >> 16) & 0xff);
+        out[7] = (U8)(indices >> 24);
+    }
+
+    // 8 byte alpha block: two endpoints and 3 bit indices into the eight
+    // value palette between them.
+    void encode_alpha_block(const U8* rgba, U8* out)
+    {
+        S32 a0 = 0;
+        S32 a1 = 255;
+        for (S32 i = 0; i < 16; ++i)
+        {
+            a0 = llmax(a0, (S32)rgba[i * 4 + 3]);
+            a1 = llmin(a1, (S32)rgba[i * 4 + 3]);
+        }
+
+        out[0] = (U8)a0;
+        out[1] = (U8)a1;
+
+        U64 indices = 0;
+        if (a0 != a1)
+        {
+            S32 palette[8];
+            palette[0] = a0;
+            palette[1] = a1;
+            for (S32 p = 2; p < 8; ++p)
+            {
+                palette[p] = ((8 - p) * a0 + (p - 1) * a1) / 7;
+            }
+
+            for (S32 i = 0; i < 16; ++i)
+            {
+                U64 best = 0;
+                S32 best_dist = S32_MAX;
+                for (S32 p = 0; p < 8; ++p)
+                {
+                    S32 dist = abs((S32)rgba[i * 4 + 3] - palette[p]);
+                    if (dist < best_dist)
+                    {
+                        best_dist = dist;
+                        best = p;
+                    }
+                }
+                indices |= best << (i * 3);
+            }
+        }
+
+        for (S32 b = 0; b < 6; ++b)
+        {
+            out[2 + b] = (U8)((indices >> (b * 8)) & 0xff);
+        }
+    }
+
+    // 2x2 box filter, clamping at the edges so 1 pixel wide levels work
+    void downsample(const U8* src, S32 src_width, S32 src_height, U8* dst, S32 dst_width, S32 dst_height)
+    {
+        for (S32 y = 0; y < dst_height; ++y)
+        {
+            const U8* row0 = src + llmin(y * 2, src_height - 1) * src_width * 4;
+            const U8* row1 = src + llmin(y * 2 + 1, src_height - 1) * src_width * 4;
+            for (S32 x = 0; x < dst_width; ++x)
+            {
+                S32 x0 = llmin(x * 2, src_width - 1) * 4;
+                S32 x1 = llmin(x * 2 + 1, src_width - 1) * 4;
+                for (S32 c = 0; c < 4; ++c)
+                {
+                    *dst++ = (U8)((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) >> 2);
+                }
+            }
+        }
+    }
+}
+
+LLImageBC::LLImageBC()
+    : LLImageBase(),
+      mFormat(FORMAT_NONE),
+      mNumMips(0),
+      mTopMipOffset(0)
+{
+}
+
+//static
+S32 LLImageBC::getMipBytes(EFormat format, S32 width, S32 height)
+{
+    S32 blocks = ((width + 3) / 4) * ((height + 3) / 4);
+    return blocks * (format == FORMAT_BC1 ? 8 : 16);
+}
+
+//static
+void LLImageBC::encodeBlockBC1(const U8* rgba, U8* out)
+{
+    encode_color_block(rgba, out);
+}
+
+//static
+void LLImageBC::encodeBlockBC3(const U8* rgba, U8* out)
+{
+    encode_alpha_block(rgba, out);
+    encode_color_block(rgba, out + 8);
+}
+
+//static
+S32 LLImageBC::getChainBytes(EFormat format, S32 width, S32 height, S32* num_mips)
+{
+    S32 mips = 0;
+    S32 total_bytes = 0;
+    for (S32 w = width, h = height; ; w = llmax(w / 2, 1), h = llmax(h / 2, 1))
+    {
+        total_bytes += getMipBytes(format, w, h);
+        ++mips;
+        if (w == 1 && h == 1)
+        {
+            break;
+        }
+    }
+    if (num_mips)
+    {
+        *num_mips = mips;
+    }
+    return total_bytes;
+}
+
+const U8* LLImageBC::getTopMipData() const
+{
+    const U8* data = getData();
+    return data ? data + mTopMipOffset : nullptr;
+}
+
+bool LLImageBC::encode(const LLImageRaw* raw_image)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
+
+    if (!raw_image)
+    {
+        return false;
+    }
+
+    LLImageDataSharedLock lock_in(raw_image);
+
+    const S32 components = raw_image->getComponents();
+    const S32 width = raw_image->getWidth();
+    const S32 height = raw_image->getHeight();
+    const U8* src = raw_image->getData();
+    if (!src || (components != 3 && components != 4) || width < 4 || height < 4)
+    {
+        return false;
+    }
+
+    // work in RGBA so both formats share the block encoder
+    std::vector<U8> level(width * height * 4);
+    bool has_alpha = false;
+    for (S32 i = 0; i < width * height; ++i)
+    {
+        level[i * 4 + 0] = src[i * components + 0];
+        level[i * 4 + 1] = src[i * components + 1];
+        level[i * 4 + 2] = src[i * components + 2];
+        level[i * 4 + 3] = components == 4 ? src[i * components + 3] : 255;
+        has_alpha |= level[i * 4 + 3] != 255;
+    }
+
+    EFormat format = has_alpha ? FORMAT_BC3 : FORMAT_BC1;
+
+    S32 num_mips = 0;
+    S32 total_bytes = getChainBytes(format, width, height, &num_mips);
+
+    LLImageDataLock lock_out(this);
+
+    U8* out = allocateDataSize(width, height, has_alpha ? 4 : 3, total_bytes);
+    if (!out)
+    {
+        return false;
+    }
+
+    // largest level goes last
+    S32 offset = total_bytes - getMipBytes(format, width, height);
+    mTopMipOffset = offset;
+
+    const S32 block_bytes = format == FORMAT_BC1 ? 8 : 16;
+    std::vector<U8> next;
+    U8 block[64];
+    S32 w = width;
+    S32 h = height;
+    for (S32 mip = 0; mip < num_mips; ++mip)
+    {
+        U8* dst = out + offset;
+        for (S32 by = 0; by < h; by += 4)
+        {
+            for (S32 bx = 0; bx < w; bx += 4)
+            {
+                for (S32 y = 0; y < 4; ++y)
+                {
+                    const U8* row = &level[llmin(by + y, h - 1) * w * 4];
+                    for (S32 x = 0; x < 4; ++x)
+                    {
+                        memcpy(block + (y * 4 + x) * 4, row + llmin(bx + x, w - 1) * 4, 4);
+                    }
+                }
+
+                if (format == FORMAT_BC1)
+                {
+                    encodeBlockBC1(block, dst);
+                }
+                else
+                {
+                    encodeBlockBC3(block, dst);
+                }
+                dst += block_bytes;
+            }
+        }
+
+        if (mip + 1 < num_mips)
+        {
+            S32 next_w = llmax(w / 2, 1);
+            S32 next_h = llmax(h / 2, 1);
+            next.resize(next_w * next_h * 4);
+            downsample(level.data(), w, h, next.data(), next_w, next_h);
+            level.swap(next);
+            w = next_w;
+            h = next_h;
+            offset -= getMipBytes(format, w, h);
+        }
+    }
+    llassert(offset == 0);
+
+    mFormat = format;
+    mNumMips = num_mips;
+    return true;
+}
+
+bool LLImageBC::assign(EFormat format, S32 width, S32 height, const U8* data, S32 data_size)
+{
+    if ((format != FORMAT_BC1 && format != FORMAT_BC3) || width < 4 || height < 4 || !data)
+    {
+        return false;
+    }
+
+    S32 num_mips = 0;
+    S32 total_bytes = getChainBytes(format, width, height, &num_mips);
+    if (total_bytes != data_size)
+    {
+        return false;
+    }
+
+    LLImageDataLock lock(this);
+
+    U8* out = allocateDataSize(width, height, format == FORMAT_BC3 ? 4 : 3, total_bytes);
+    if (!out)
+    {
+        return false;
+    }
+    memcpy(out, data, total_bytes);
+
+    mFormat = format;
+    mNumMips = num_mips;
+    mTopMipOffset = total_bytes - getMipBytes(format, width, height);
+    return true;
+}
@@ -0,0 +1,82 @@
+/**
+ * @file llimagebc.h
+ * @brief Block compression (BC1/BC3) of raw images for GPU upload
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLIMAGEBC_H
+#define LL_LLIMAGEBC_H
+
+#include "llimage.h"
+
+// Block compressed copy of an LLImageRaw and its full mip chain, meant to be
+// uploaded in place of the raw data. Opaque images are stored as BC1 (DXT1,
+// 4 bits per pixel), images with alpha as BC3 (DXT5, 8 bits per pixel).
+//
+// Mips are laid out smallest first, the way LLImageGL::setImage() expects
+// data with mips, so getTopMipData() points at the full size level with the
+// smaller levels stored before it. Each level is max(1, previous / 2) in
+// both dimensions, down to 1x1.
+
+class LLImageBC : public LLImageBase
+{
+protected:
+    ~LLImageBC() = default;
+
+public:
+    enum EFormat
+    {
+        FORMAT_NONE = 0,
+        FORMAT_BC1,
+        FORMAT_BC3,
+    };
+
+    LLImageBC();
+
+    // Compresses raw_image (3 or 4 components, both dimensions at least 4).
+    // Returns false and leaves this image empty if raw_image can't be
+    // compressed.
+    bool encode(const LLImageRaw* raw_image);
+
+    // Copies a chain previously produced by encode(), e.g. read back from
+    // disk. Returns false if data_size doesn't match a full chain.
+    bool assign(EFormat format, S32 width, S32 height, const U8* data, S32 data_size);
+
+    EFormat getFormat() const { return mFormat; }
+    S32 getNumMips() const { return mNumMips; }
+    const U8* getTopMipData() const;
+
+    static S32 getMipBytes(EFormat format, S32 width, S32 height);
+    static S32 getChainBytes(EFormat format, S32 width, S32 height, S32* num_mips = nullptr);
+
+    // Encode one 4x4 block of RGBA pixels (64 bytes, row major)
+    static void encodeBlockBC1(const U8* rgba, U8* out); // 8 bytes out
+    static void encodeBlockBC3(const U8* rgba, U8* out); // 16 bytes out
+
+private:
+    EFormat mFormat;
+    S32 mNumMips;
+    S32 mTopMipOffset;
+};
+
+#endif // LL_LLIMAGEBC_H
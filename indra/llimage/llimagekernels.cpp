@@ -0,0 +1,829 @@
+/**
+ * @file llimagekernels.cpp
+ * @brief Vectorized pixel kernels for LLImageRaw
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llimagekernels.h"
+
+#include "llprocessor.h"
+
+#include <emmintrin.h>
+#include <immintrin.h>
+
+#include <vector>
+
+// The AVX2 functions are compiled for AVX2 on their own, so the rest of the
+// file still runs on SSE2 only machines. MSVC doesn't need this, it lets any
+// function use any intrinsic.
+#if defined(__GNUC__) && !defined(__AVX2__)
+#define LL_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define LL_TARGET_AVX2
+#endif
+
+namespace
+{
+    using namespace LLImageKernels;
+
+    EISA detect_best_isa()
+    {
+        LLProcessorInfo info;
+        if (info.hasAVX2())
+        {
+            return ISA_AVX2;
+        }
+        if (info.hasSSE2())
+        {
+            return ISA_SSE2;
+        }
+        return ISA_SCALAR;
+    }
+
+    EISA& best_isa()
+    {
+        static EISA isa = detect_best_isa();
+        return isa;
+    }
+
+    EISA& current_isa()
+    {
+        static EISA isa = best_isa();
+        return isa;
+    }
+
+    inline U8 fractional_mult(U8 a, U8 b)
+    {
+        // Same rounding as LLImageRaw::fastFractionalMult()
+        U32 i = a * b + 128;
+        return U8((i + (i >> 8)) >> 8);
+    }
+
+    inline U32 load_u32(const U8* p)
+    {
+        U32 v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    inline void store_u32(U8* p, U32 v)
+    {
+        memcpy(p, &v, sizeof(v));
+    }
+
+    //------------------------------------------------------------------------
+    // Area filter taps for one axis of bilinearDownscale4(). These are the
+    // same weights scale_info<> in llimage.cpp computes for a downscale, laid
+    // out so every output has the same number of taps. Missing taps repeat
+    // the last source index with a weight of 0, so they only read pixels the
+    // generic scaler reads as well.
+    //------------------------------------------------------------------------
+    struct DownscaleTaps
+    {
+        U32 mCount = 0;
+        std::vector<S32> mIndex;
+        std::vector<S32> mWeight;
+
+        DownscaleTaps(U32 src_size, U32 dst_size)
+        {
+            std::vector<std::vector<S32> > weights(dst_size);
+            std::vector<S32> first(dst_size);
+
+            S32 inc = (src_size << 16) / dst_size;
+            S32 cp = ((dst_size << 14) / src_size) + 1;
+            S32 val = 0;
+            for (U32 i = 0; i < dst_size; ++i, val += inc)
+            {
+                first[i] = llmax(0, val >> 16);
+
+                S32 ap = ((0x100 - ((val >> 8) & 0xff)) * cp) >> 8;
+                std::vector<S32>& w = weights[i];
+                w.push_back(ap);
+                S32 j = (1 << 14) - ap;
+                for (; j > cp; j -= cp)
+                {
+                    w.push_back(cp);
+                }
+                if (j > 0)
+                {
+                    w.push_back(j);
+                }
+                mCount = llmax(mCount, (U32)w.size());
+            }
+
+            mIndex.resize(dst_size * mCount);
+            mWeight.resize(dst_size * mCount, 0);
+            for (U32 i = 0; i < dst_size; ++i)
+            {
+                const std::vector<S32>& w = weights[i];
+                for (U32 k = 0; k < mCount; ++k)
+                {
+                    U32 tap = llmin(k, (U32)w.size() - 1);
+                    mIndex[i * mCount + k] = first[i] + tap;
+                    if (k < w.size())
+                    {
+                        mWeight[i * mCount + k] = w[k];
+                    }
+                }
+            }
+        }
+    };
+
+    //------------------------------------------------------------------------
+    // Scalar
+    //------------------------------------------------------------------------
+
+    void copy3onto4_scalar(const U8* src, U8* dst, U32 pixels)
+    {
+        for (U32 i = 0; i < pixels; ++i)
+        {
+            dst[0] = src[0];
+            dst[1] = src[1];
+            dst[2] = src[2];
+            dst[3] = 255;
+            src += 3;
+            dst += 4;
+        }
+    }
+
+    void copy4onto3_scalar(const U8* src, U8* dst, U32 pixels)
+    {
+        for (U32 i = 0; i < pixels; ++i)
+        {
+            dst[0] = src[0];
+            dst[1] = src[1];
+            dst[2] = src[2];
+            src += 4;
+            dst += 3;
+        }
+    }
+
+    void premultiply_scalar(U8* rgba, U32 pixels)
+    {
+        for (U32 i = 0; i < pixels; ++i, rgba += 4)
+        {
+            U8 alpha = rgba[3];
+            rgba[0] = fractional_mult(rgba[0], alpha);
+            rgba[1] = fractional_mult(rgba[1], alpha);
+            rgba[2] = fractional_mult(rgba[2], alpha);
+        }
+    }
+
+    // Averages pixels 2x2 blocks starting at top and bottom into dst
+    void box_row_scalar(const U8* top, const U8* bottom, U8* dst, U32 pixels, U32 components)
+    {
+        for (U32 x = 0; x < pixels; ++x)
+        {
+            for (U32 c = 0; c < components; ++c)
+            {
+                dst[c] = (U8)(((U32)top[c] + top[components + c] + bottom[c] + bottom[components + c]) >> 2);
+            }
+            top += components * 2;
+            bottom += components * 2;
+            dst += components;
+        }
+    }
+
+    void box_downsample_scalar(const U8* src, U8* dst, U32 width, U32 height, U32 components)
+    {
+        U32 src_stride = width * 2 * components;
+        for (U32 y = 0; y < height; ++y)
+        {
+            const U8* top = src + (y * 2) * src_stride;
+            box_row_scalar(top, top + src_stride, dst + y * width * components, width, components);
+        }
+    }
+
+    void downscale_scalar(const U8* src, U32 src_stride, U8* dst, U32 dst_w, U32 dst_h, U32 dst_stride,
+                          const DownscaleTaps& xtaps, const DownscaleTaps& ytaps)
+    {
+        std::vector<S32> comp(dst_w * 4);
+        for (U32 y = 0; y < dst_h; ++y)
+        {
+            std::fill(comp.begin(), comp.end(), 0);
+            for (U32 t = 0; t < ytaps.mCount; ++t)
+            {
+                S32 wy = ytaps.mWeight[y * ytaps.mCount + t];
+                if (!wy)
+                {
+                    continue;
+                }
+                const U8* row = src + ytaps.mIndex[y * ytaps.mCount + t] * src_stride;
+                for (U32 x = 0; x < dst_w; ++x)
+                {
+                    S32 cx[4] = { 0, 0, 0, 0 };
+                    for (U32 k = 0; k < xtaps.mCount; ++k)
+                    {
+                        const U8* pix = row + xtaps.mIndex[x * xtaps.mCount + k] * 4;
+                        S32 wx = xtaps.mWeight[x * xtaps.mCount + k];
+                        for (U32 c = 0; c < 4; ++c)
+                        {
+                            cx[c] += pix[c] * wx;
+                        }
+                    }
+                    for (U32 c = 0; c < 4; ++c)
+                    {
+                        comp[x * 4 + c] += (cx[c] >> 5) * wy;
+                    }
+                }
+            }
+
+            U8* dptr = dst + y * dst_stride;
+            for (U32 i = 0; i < dst_w * 4; ++i)
+            {
+                dptr[i] = (comp[i] >> 23) & 0xff;
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------
+    // SSE2
+    //------------------------------------------------------------------------
+
+    // Low 32 bits of a * b for each lane. SSE2 has no _mm_mullo_epi32.
+    inline __m128i mullo32_sse2(__m128i a, __m128i b)
+    {
+        __m128i even = _mm_mul_epu32(a, b);
+        __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+        return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                                  _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+    }
+
+    // Stores the low 12 bytes of v
+    inline void store12(U8* dst, __m128i v)
+    {
+        _mm_storel_epi64((__m128i*)dst, v);
+        store_u32(dst + 8, (U32)_mm_cvtsi128_si32(_mm_srli_si128(v, 8)));
+    }
+
+    void copy3onto4_sse2(const U8* src, U8* dst, U32 pixels)
+    {
+        // Pixel n moves from byte 3n to byte 4n, so it's shifted up n bytes
+        const __m128i mask0 = _mm_setr_epi32(0x00ffffff, 0, 0, 0);
+        const __m128i mask1 = _mm_setr_epi32(0, 0x00ffffff, 0, 0);
+        const __m128i mask2 = _mm_setr_epi32(0, 0, 0x00ffffff, 0);
+        const __m128i mask3 = _mm_setr_epi32(0, 0, 0, 0x00ffffff);
+        const __m128i alpha = _mm_set1_epi32((int)0xff000000);
+
+        U32 i = 0;
+        // Each load reads 16 bytes but only uses 12
+        for (; i + 6 <= pixels; i += 4, src += 12, dst += 16)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*)src);
+            __m128i out = _mm_or_si128(_mm_and_si128(v, mask0), _mm_and_si128(_mm_slli_si128(v, 1), mask1));
+            out = _mm_or_si128(out, _mm_and_si128(_mm_slli_si128(v, 2), mask2));
+            out = _mm_or_si128(out, _mm_and_si128(_mm_slli_si128(v, 3), mask3));
+            _mm_storeu_si128((__m128i*)dst, _mm_or_si128(out, alpha));
+        }
+        copy3onto4_scalar(src, dst, pixels - i);
+    }
+
+    void copy4onto3_sse2(const U8* src, U8* dst, U32 pixels)
+    {
+        const __m128i mask0 = _mm_setr_epi32(0x00ffffff, 0, 0, 0);
+        const __m128i mask1 = _mm_setr_epi32(0, 0x00ffffff, 0, 0);
+        const __m128i mask2 = _mm_setr_epi32(0, 0, 0x00ffffff, 0);
+        const __m128i mask3 = _mm_setr_epi32(0, 0, 0, 0x00ffffff);
+
+        U32 i = 0;
+        for (; i + 4 <= pixels; i += 4, src += 16, dst += 12)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*)src);
+            __m128i out = _mm_or_si128(_mm_and_si128(v, mask0), _mm_srli_si128(_mm_and_si128(v, mask1), 1));
+            out = _mm_or_si128(out, _mm_srli_si128(_mm_and_si128(v, mask2), 2));
+            out = _mm_or_si128(out, _mm_srli_si128(_mm_and_si128(v, mask3), 3));
+            store12(dst, out);
+        }
+        copy4onto3_scalar(src, dst, pixels - i);
+    }
+
+    // c * a / 255 rounded, for 16 bit lanes holding 8 bit values
+    inline __m128i fractional_mult_sse2(__m128i c, __m128i a)
+    {
+        __m128i i = _mm_add_epi16(_mm_mullo_epi16(c, a), _mm_set1_epi16(128));
+        return _mm_srli_epi16(_mm_add_epi16(i, _mm_srli_epi16(i, 8)), 8);
+    }
+
+    // Alpha of each pixel in the color lanes and 255 in the alpha lane, for
+    // 16 bit lanes holding two RGBA pixels
+    inline __m128i alpha_multiplier_sse2(__m128i px)
+    {
+        const __m128i alpha_lanes = _mm_setr_epi16(0, 0, 0, -1, 0, 0, 0, -1);
+        __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(px, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        return _mm_or_si128(_mm_andnot_si128(alpha_lanes, a), _mm_and_si128(alpha_lanes, _mm_set1_epi16(255)));
+    }
+
+    void premultiply_sse2(U8* rgba, U32 pixels)
+    {
+        const __m128i zero = _mm_setzero_si128();
+
+        U32 i = 0;
+        for (; i + 4 <= pixels; i += 4, rgba += 16)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*)rgba);
+            __m128i lo = _mm_unpacklo_epi8(v, zero);
+            __m128i hi = _mm_unpackhi_epi8(v, zero);
+            lo = fractional_mult_sse2(lo, alpha_multiplier_sse2(lo));
+            hi = fractional_mult_sse2(hi, alpha_multiplier_sse2(hi));
+            _mm_storeu_si128((__m128i*)rgba, _mm_packus_epi16(lo, hi));
+        }
+        premultiply_scalar(rgba, pixels - i);
+    }
+
+    // Returns the number of output pixels done, the rest is left to the caller
+    U32 box_row_sse2(const U8* top, const U8* bottom, U8* dst, U32 pixels, U32 components)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        U32 x = 0;
+
+        switch (components)
+        {
+        case 4:
+            for (; x + 4 <= pixels; x += 4, top += 32, bottom += 32, dst += 16)
+            {
+                for (U32 half = 0; half < 2; ++half)
+                {
+                    __m128i t = _mm_loadu_si128((const __m128i*)(top + half * 16));
+                    __m128i b = _mm_loadu_si128((const __m128i*)(bottom + half * 16));
+                    // [p0 p1] and [p2 p3], summed vertically
+                    __m128i s01 = _mm_add_epi16(_mm_unpacklo_epi8(t, zero), _mm_unpacklo_epi8(b, zero));
+                    __m128i s23 = _mm_add_epi16(_mm_unpackhi_epi8(t, zero), _mm_unpackhi_epi8(b, zero));
+                    __m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(s01, s23), _mm_unpackhi_epi64(s01, s23));
+                    sum = _mm_srli_epi16(sum, 2);
+                    _mm_storel_epi64((__m128i*)(dst + half * 8), _mm_packus_epi16(sum, sum));
+                }
+            }
+            break;
+        case 2:
+            for (; x + 4 <= pixels; x += 4, top += 16, bottom += 16, dst += 8)
+            {
+                __m128i t = _mm_loadu_si128((const __m128i*)top);
+                __m128i b = _mm_loadu_si128((const __m128i*)bottom);
+                __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(t, zero), _mm_unpacklo_epi8(b, zero));
+                __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(t, zero), _mm_unpackhi_epi8(b, zero));
+                // Pixel pairs share a 64 bit lane, add the upper pixel onto the lower one
+                lo = _mm_shuffle_epi32(_mm_add_epi16(lo, _mm_srli_epi64(lo, 32)), _MM_SHUFFLE(3, 1, 2, 0));
+                hi = _mm_shuffle_epi32(_mm_add_epi16(hi, _mm_srli_epi64(hi, 32)), _MM_SHUFFLE(3, 1, 2, 0));
+                __m128i sum = _mm_srli_epi16(_mm_unpacklo_epi64(lo, hi), 2);
+                _mm_storel_epi64((__m128i*)dst, _mm_packus_epi16(sum, sum));
+            }
+            break;
+        case 1:
+            {
+                const __m128i low_byte = _mm_set1_epi16(0xff);
+                for (; x + 8 <= pixels; x += 8, top += 16, bottom += 16, dst += 8)
+                {
+                    __m128i t = _mm_loadu_si128((const __m128i*)top);
+                    __m128i b = _mm_loadu_si128((const __m128i*)bottom);
+                    __m128i sum = _mm_add_epi16(_mm_add_epi16(_mm_and_si128(t, low_byte), _mm_srli_epi16(t, 8)),
+                                                _mm_add_epi16(_mm_and_si128(b, low_byte), _mm_srli_epi16(b, 8)));
+                    sum = _mm_srli_epi16(sum, 2);
+                    _mm_storel_epi64((__m128i*)dst, _mm_packus_epi16(sum, sum));
+                }
+            }
+            break;
+        default:
+            // 3 channels don't line up with SSE2 lanes, leave them to the scalar loop
+            break;
+        }
+        return x;
+    }
+
+    void box_downsample_sse2(const U8* src, U8* dst, U32 width, U32 height, U32 components)
+    {
+        U32 src_stride = width * 2 * components;
+        for (U32 y = 0; y < height; ++y)
+        {
+            const U8* top = src + (y * 2) * src_stride;
+            const U8* bottom = top + src_stride;
+            U8* out = dst + y * width * components;
+            U32 done = box_row_sse2(top, bottom, out, width, components);
+            box_row_scalar(top + done * components * 2, bottom + done * components * 2, out + done * components,
+                           width - done, components);
+        }
+    }
+
+    inline __m128i load_pixel_sse2(const U8* pix)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i v = _mm_cvtsi32_si128((int)load_u32(pix));
+        return _mm_unpacklo_epi16(_mm_unpacklo_epi8(v, zero), zero);
+    }
+
+    // Horizontal taps for output pixel x of one source row
+    inline __m128i downscale_taps_sse2(const U8* row, const DownscaleTaps& xtaps, U32 x)
+    {
+        const S32* index = &xtaps.mIndex[x * xtaps.mCount];
+        const S32* weight = &xtaps.mWeight[x * xtaps.mCount];
+        __m128i cx = _mm_setzero_si128();
+        for (U32 k = 0; k < xtaps.mCount; ++k)
+        {
+            // Pixel values and weights fit in 16 bits, so madd gives the 32 bit products
+            cx = _mm_add_epi32(cx, _mm_madd_epi16(load_pixel_sse2(row + index[k] * 4), _mm_set1_epi32(weight[k])));
+        }
+        return cx;
+    }
+
+    inline void downscale_store_sse2(const S32* comp, U8* dptr, U32 pixels)
+    {
+        const __m128i low_byte = _mm_set1_epi32(0xff);
+        U32 x = 0;
+        for (; x + 4 <= pixels; x += 4)
+        {
+            __m128i a = _mm_and_si128(_mm_srai_epi32(_mm_loadu_si128((const __m128i*)(comp + x * 4)), 23), low_byte);
+            __m128i b = _mm_and_si128(_mm_srai_epi32(_mm_loadu_si128((const __m128i*)(comp + x * 4 + 4)), 23), low_byte);
+            __m128i c = _mm_and_si128(_mm_srai_epi32(_mm_loadu_si128((const __m128i*)(comp + x * 4 + 8)), 23), low_byte);
+            __m128i d = _mm_and_si128(_mm_srai_epi32(_mm_loadu_si128((const __m128i*)(comp + x * 4 + 12)), 23), low_byte);
+            _mm_storeu_si128((__m128i*)(dptr + x * 4), _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+        }
+        for (U32 i = x * 4; i < pixels * 4; ++i)
+        {
+            dptr[i] = (comp[i] >> 23) & 0xff;
+        }
+    }
+
+    void downscale_sse2(const U8* src, U32 src_stride, U8* dst, U32 dst_w, U32 dst_h, U32 dst_stride,
+                        const DownscaleTaps& xtaps, const DownscaleTaps& ytaps)
+    {
+        std::vector<S32> comp(dst_w * 4);
+        for (U32 y = 0; y < dst_h; ++y)
+        {
+            std::fill(comp.begin(), comp.end(), 0);
+            for (U32 t = 0; t < ytaps.mCount; ++t)
+            {
+                S32 wy = ytaps.mWeight[y * ytaps.mCount + t];
+                if (!wy)
+                {
+                    continue;
+                }
+                const U8* row = src + ytaps.mIndex[y * ytaps.mCount + t] * src_stride;
+                const __m128i wy4 = _mm_set1_epi32(wy);
+                for (U32 x = 0; x < dst_w; ++x)
+                {
+                    __m128i cx = _mm_srai_epi32(downscale_taps_sse2(row, xtaps, x), 5);
+                    __m128i* acc = (__m128i*)&comp[x * 4];
+                    _mm_storeu_si128(acc, _mm_add_epi32(_mm_loadu_si128(acc), mullo32_sse2(cx, wy4)));
+                }
+            }
+            downscale_store_sse2(comp.data(), dst + y * dst_stride, dst_w);
+        }
+    }
+
+    //------------------------------------------------------------------------
+    // AVX2
+    //------------------------------------------------------------------------
+
+    LL_TARGET_AVX2 inline __m256i load_2x128(const U8* lo, const U8* hi)
+    {
+        return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)lo)),
+                                       _mm_loadu_si128((const __m128i*)hi), 1);
+    }
+
+    LL_TARGET_AVX2 inline __m256i expand3to4_avx2(__m256i v)
+    {
+        // Spreads the low 12 bytes of each lane out to 4 pixels with a zero fourth byte
+        const __m256i expand = _mm256_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+                                                0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+        return _mm256_shuffle_epi8(v, expand);
+    }
+
+    LL_TARGET_AVX2 void copy3onto4_avx2(const U8* src, U8* dst, U32 pixels)
+    {
+        const __m256i alpha = _mm256_set1_epi32((int)0xff000000);
+
+        U32 i = 0;
+        // The upper lane reads 16 bytes from byte 12 but only uses 12
+        for (; i + 10 <= pixels; i += 8, src += 24, dst += 32)
+        {
+            __m256i v = expand3to4_avx2(load_2x128(src, src + 12));
+            _mm256_storeu_si256((__m256i*)dst, _mm256_or_si256(v, alpha));
+        }
+        copy3onto4_sse2(src, dst, pixels - i);
+    }
+
+    LL_TARGET_AVX2 void copy4onto3_avx2(const U8* src, U8* dst, U32 pixels)
+    {
+        const __m256i pack = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+                                              0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+        U32 i = 0;
+        for (; i + 8 <= pixels; i += 8, src += 32, dst += 24)
+        {
+            __m256i v = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)src), pack);
+            // The lower store spills 4 bytes that the upper store overwrites
+            _mm_storeu_si128((__m128i*)dst, _mm256_castsi256_si128(v));
+            store12(dst + 12, _mm256_extracti128_si256(v, 1));
+        }
+        copy4onto3_sse2(src, dst, pixels - i);
+    }
+
+    LL_TARGET_AVX2 inline __m256i fractional_mult_avx2(__m256i c, __m256i a)
+    {
+        __m256i i = _mm256_add_epi16(_mm256_mullo_epi16(c, a), _mm256_set1_epi16(128));
+        return _mm256_srli_epi16(_mm256_add_epi16(i, _mm256_srli_epi16(i, 8)), 8);
+    }
+
+    LL_TARGET_AVX2 inline __m256i alpha_multiplier_avx2(__m256i px)
+    {
+        const __m256i alpha_lanes = _mm256_setr_epi16(0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0, -1);
+        __m256i a = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(px, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        return _mm256_or_si256(_mm256_andnot_si256(alpha_lanes, a), _mm256_and_si256(alpha_lanes, _mm256_set1_epi16(255)));
+    }
+
+    LL_TARGET_AVX2 void premultiply_avx2(U8* rgba, U32 pixels)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+
+        U32 i = 0;
+        for (; i + 8 <= pixels; i += 8, rgba += 32)
+        {
+            __m256i v = _mm256_loadu_si256((const __m256i*)rgba);
+            // unpack and pack work within lanes, so the pixel order survives
+            __m256i lo = _mm256_unpacklo_epi8(v, zero);
+            __m256i hi = _mm256_unpackhi_epi8(v, zero);
+            lo = fractional_mult_avx2(lo, alpha_multiplier_avx2(lo));
+            hi = fractional_mult_avx2(hi, alpha_multiplier_avx2(hi));
+            _mm256_storeu_si256((__m256i*)rgba, _mm256_packus_epi16(lo, hi));
+        }
+        premultiply_sse2(rgba, pixels - i);
+    }
+
+    // 2x2 averages of 8 RGBA pixels from each row, as 4 packed RGBA pixels
+    LL_TARGET_AVX2 inline __m128i box_quad4_avx2(__m256i t, __m256i b)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        // Lanes hold [p0 p1 | p4 p5] and [p2 p3 | p6 p7]
+        __m256i s01 = _mm256_add_epi16(_mm256_unpacklo_epi8(t, zero), _mm256_unpacklo_epi8(b, zero));
+        __m256i s23 = _mm256_add_epi16(_mm256_unpackhi_epi8(t, zero), _mm256_unpackhi_epi8(b, zero));
+        __m256i sum = _mm256_add_epi16(_mm256_unpacklo_epi64(s01, s23), _mm256_unpackhi_epi64(s01, s23));
+        sum = _mm256_srli_epi16(sum, 2);
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(sum, sum), _MM_SHUFFLE(3, 1, 2, 0));
+        return _mm256_castsi256_si128(packed);
+    }
+
+    LL_TARGET_AVX2 U32 box_row_avx2(const U8* top, const U8* bottom, U8* dst, U32 pixels, U32 components)
+    {
+        U32 x = 0;
+
+        switch (components)
+        {
+        case 4:
+            for (; x + 4 <= pixels; x += 4, top += 32, bottom += 32, dst += 16)
+            {
+                __m256i t = _mm256_loadu_si256((const __m256i*)top);
+                __m256i b = _mm256_loadu_si256((const __m256i*)bottom);
+                _mm_storeu_si128((__m128i*)dst, box_quad4_avx2(t, b));
+            }
+            break;
+        case 3:
+            {
+                const __m128i pack = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+                // Reads 16 bytes from byte 12 of the 24 used, so keep 2 spare source pixels
+                for (; x + 5 <= pixels; x += 4, top += 24, bottom += 24, dst += 12)
+                {
+                    __m256i t = expand3to4_avx2(load_2x128(top, top + 12));
+                    __m256i b = expand3to4_avx2(load_2x128(bottom, bottom + 12));
+                    store12(dst, _mm_shuffle_epi8(box_quad4_avx2(t, b), pack));
+                }
+            }
+            break;
+        case 1:
+            {
+                const __m256i low_byte = _mm256_set1_epi16(0xff);
+                for (; x + 16 <= pixels; x += 16, top += 32, bottom += 32, dst += 16)
+                {
+                    __m256i t = _mm256_loadu_si256((const __m256i*)top);
+                    __m256i b = _mm256_loadu_si256((const __m256i*)bottom);
+                    __m256i sum = _mm256_add_epi16(_mm256_add_epi16(_mm256_and_si256(t, low_byte), _mm256_srli_epi16(t, 8)),
+                                                   _mm256_add_epi16(_mm256_and_si256(b, low_byte), _mm256_srli_epi16(b, 8)));
+                    sum = _mm256_srli_epi16(sum, 2);
+                    __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(sum, sum), _MM_SHUFFLE(3, 1, 2, 0));
+                    _mm_storeu_si128((__m128i*)dst, _mm256_castsi256_si128(packed));
+                }
+            }
+            break;
+        default:
+            break;
+        }
+
+        return x + box_row_sse2(top, bottom, dst, pixels - x, components);
+    }
+
+    LL_TARGET_AVX2 void box_downsample_avx2(const U8* src, U8* dst, U32 width, U32 height, U32 components)
+    {
+        U32 src_stride = width * 2 * components;
+        for (U32 y = 0; y < height; ++y)
+        {
+            const U8* top = src + (y * 2) * src_stride;
+            const U8* bottom = top + src_stride;
+            U8* out = dst + y * width * components;
+            U32 done = box_row_avx2(top, bottom, out, width, components);
+            box_row_scalar(top + done * components * 2, bottom + done * components * 2, out + done * components,
+                           width - done, components);
+        }
+    }
+
+    LL_TARGET_AVX2 void downscale_avx2(const U8* src, U32 src_stride, U8* dst, U32 dst_w, U32 dst_h, U32 dst_stride,
+                                       const DownscaleTaps& xtaps, const DownscaleTaps& ytaps)
+    {
+        std::vector<S32> comp(dst_w * 4);
+        const U32 taps = xtaps.mCount;
+        for (U32 y = 0; y < dst_h; ++y)
+        {
+            std::fill(comp.begin(), comp.end(), 0);
+            for (U32 t = 0; t < ytaps.mCount; ++t)
+            {
+                S32 wy = ytaps.mWeight[y * ytaps.mCount + t];
+                if (!wy)
+                {
+                    continue;
+                }
+                const U8* row = src + ytaps.mIndex[y * ytaps.mCount + t] * src_stride;
+                const __m256i wy8 = _mm256_set1_epi32(wy);
+
+                // Two output pixels at a time, one per 128 bit lane
+                U32 x = 0;
+                for (; x + 2 <= dst_w; x += 2)
+                {
+                    const S32* index = &xtaps.mIndex[x * taps];
+                    const S32* weight = &xtaps.mWeight[x * taps];
+                    __m256i cx = _mm256_setzero_si256();
+                    for (U32 k = 0; k < taps; ++k)
+                    {
+                        __m128i px = _mm_unpacklo_epi32(_mm_cvtsi32_si128((int)load_u32(row + index[k] * 4)),
+                                                        _mm_cvtsi32_si128((int)load_u32(row + index[taps + k] * 4)));
+                        __m256i w = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_set1_epi32(weight[k])),
+                                                            _mm_set1_epi32(weight[taps + k]), 1);
+                        cx = _mm256_add_epi32(cx, _mm256_madd_epi16(_mm256_cvtepu8_epi32(px), w));
+                    }
+                    __m256i* acc = (__m256i*)&comp[x * 4];
+                    _mm256_storeu_si256(acc, _mm256_add_epi32(_mm256_loadu_si256(acc),
+                                                              _mm256_mullo_epi32(_mm256_srai_epi32(cx, 5), wy8)));
+                }
+                for (; x < dst_w; ++x)
+                {
+                    __m128i cx = _mm_srai_epi32(downscale_taps_sse2(row, xtaps, x), 5);
+                    __m128i* acc = (__m128i*)&comp[x * 4];
+                    _mm_storeu_si128(acc, _mm_add_epi32(_mm_loadu_si128(acc), mullo32_sse2(cx, _mm256_castsi256_si128(wy8))));
+                }
+            }
+
+            const __m256i low_byte = _mm256_set1_epi32(0xff);
+            U8* dptr = dst + y * dst_stride;
+            U32 x = 0;
+            for (; x + 8 <= dst_w; x += 8)
+            {
+                const S32* c = &comp[x * 4];
+                __m256i a = _mm256_and_si256(_mm256_srai_epi32(_mm256_loadu_si256((const __m256i*)c), 23), low_byte);
+                __m256i b = _mm256_and_si256(_mm256_srai_epi32(_mm256_loadu_si256((const __m256i*)(c + 8)), 23), low_byte);
+                __m256i d = _mm256_and_si256(_mm256_srai_epi32(_mm256_loadu_si256((const __m256i*)(c + 16)), 23), low_byte);
+                __m256i e = _mm256_and_si256(_mm256_srai_epi32(_mm256_loadu_si256((const __m256i*)(c + 24)), 23), low_byte);
+                // packs work within lanes, the permute puts the pixels back in order
+                __m256i packed = _mm256_packus_epi16(_mm256_packs_epi32(a, b), _mm256_packs_epi32(d, e));
+                packed = _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+                _mm256_storeu_si256((__m256i*)(dptr + x * 4), packed);
+            }
+            downscale_store_sse2(&comp[x * 4], dptr + x * 4, dst_w - x);
+        }
+    }
+}
+
+namespace LLImageKernels
+{
+    EISA getISA()
+    {
+        return current_isa();
+    }
+
+    EISA getBestISA()
+    {
+        return best_isa();
+    }
+
+    void setISA(EISA isa)
+    {
+        current_isa() = isa < best_isa() ? isa : best_isa();
+    }
+
+    const char* getISAName(EISA isa)
+    {
+        switch (isa)
+        {
+        case ISA_AVX2:
+            return "AVX2";
+        case ISA_SSE2:
+            return "SSE2";
+        default:
+            return "scalar";
+        }
+    }
+
+    void copy3onto4(const U8* src, U8* dst, U32 pixels)
+    {
+        switch (current_isa())
+        {
+        case ISA_AVX2:
+            copy3onto4_avx2(src, dst, pixels);
+            break;
+        case ISA_SSE2:
+            copy3onto4_sse2(src, dst, pixels);
+            break;
+        default:
+            copy3onto4_scalar(src, dst, pixels);
+            break;
+        }
+    }
+
+    void copy4onto3(const U8* src, U8* dst, U32 pixels)
+    {
+        switch (current_isa())
+        {
+        case ISA_AVX2:
+            copy4onto3_avx2(src, dst, pixels);
+            break;
+        case ISA_SSE2:
+            copy4onto3_sse2(src, dst, pixels);
+            break;
+        default:
+            copy4onto3_scalar(src, dst, pixels);
+            break;
+        }
+    }
+
+    void premultiplyAlpha(U8* rgba, U32 pixels)
+    {
+        switch (current_isa())
+        {
+        case ISA_AVX2:
+            premultiply_avx2(rgba, pixels);
+            break;
+        case ISA_SSE2:
+            premultiply_sse2(rgba, pixels);
+            break;
+        default:
+            premultiply_scalar(rgba, pixels);
+            break;
+        }
+    }
+
+    void boxDownsample2x(const U8* src, U8* dst, U32 width, U32 height, U32 components)
+    {
+        llassert(components >= 1 && components <= 4);
+
+        switch (current_isa())
+        {
+        case ISA_AVX2:
+            box_downsample_avx2(src, dst, width, height, components);
+            break;
+        case ISA_SSE2:
+            box_downsample_sse2(src, dst, width, height, components);
+            break;
+        default:
+            box_downsample_scalar(src, dst, width, height, components);
+            break;
+        }
+    }
+
+    void bilinearDownscale4(const U8* src, U32 src_w, U32 src_h, U32 src_stride,
+                            U8* dst, U32 dst_w, U32 dst_h, U32 dst_stride)
+    {
+        llassert(dst_w > 0 && dst_w < src_w && dst_h > 0 && dst_h < src_h);
+
+        DownscaleTaps xtaps(src_w, dst_w);
+        DownscaleTaps ytaps(src_h, dst_h);
+
+        switch (current_isa())
+        {
+        case ISA_AVX2:
+            downscale_avx2(src, src_stride, dst, dst_w, dst_h, dst_stride, xtaps, ytaps);
+            break;
+        case ISA_SSE2:
+            downscale_sse2(src, src_stride, dst, dst_w, dst_h, dst_stride, xtaps, ytaps);
+            break;
+        default:
+            downscale_scalar(src, src_stride, dst, dst_w, dst_h, dst_stride, xtaps, ytaps);
+            break;
+        }
+    }
+}
@@ -0,0 +1,82 @@
+/**
+ * @file llimagekernels.h
+ * @brief Vectorized pixel kernels for LLImageRaw
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLIMAGEKERNELS_H
+#define LL_LLIMAGEKERNELS_H
+
+// Inner loops of the LLImageRaw scaling and conversion code, with scalar,
+// SSE2 and AVX2 versions. The best version the CPU supports (according to
+// LLProcessorInfo) is picked the first time a kernel is called. All versions
+// produce exactly the same output, so callers don't need to care which one
+// runs.
+
+namespace LLImageKernels
+{
+    enum EISA
+    {
+        ISA_SCALAR = 0,
+        ISA_SSE2,
+        ISA_AVX2,
+    };
+
+    // Version currently in use
+    EISA getISA();
+
+    // Best version this CPU and build support
+    EISA getBestISA();
+
+    // Use isa (clamped to getBestISA()) from now on. Meant for tests and
+    // benchmarks; not safe to call while other threads run kernels.
+    void setISA(EISA isa);
+
+    const char* getISAName(EISA isa);
+
+    // RGB to RGBA with alpha 255, pixel count pixels. src and dst must not overlap.
+    void copy3onto4(const U8* src, U8* dst, U32 pixels);
+
+    // RGBA to RGB, dropping alpha. src and dst must not overlap.
+    void copy4onto3(const U8* src, U8* dst, U32 pixels);
+
+    // Multiplies the color of each RGBA pixel by its alpha, in place,
+    // rounding to nearest.
+    void premultiplyAlpha(U8* rgba, U32 pixels);
+
+    // Averages each 2x2 block of src into one pixel of dst, exactly like
+    // LLImageBase::generateMip(). width and height are the size of dst;
+    // src is (width * 2) x (height * 2). components is 1 to 4.
+    void boxDownsample2x(const U8* src, U8* dst, U32 width, U32 height, U32 components);
+
+    // Area filtered RGBA downscale used by LLImageRaw::scale() when both
+    // dimensions shrink (dst_w < src_w and dst_h < src_h). Matches the
+    // generic fixed point scaler in llimage.cpp bit for bit. The scalar
+    // version is only a reference for the others and is slower than the
+    // generic scaler, so callers should use that one when getISA() is
+    // ISA_SCALAR.
+    void bilinearDownscale4(const U8* src, U32 src_w, U32 src_h, U32 src_stride,
+                            U8* dst, U32 dst_w, U32 dst_h, U32 dst_stride);
+}
+
+#endif // LL_LLIMAGEKERNELS_H
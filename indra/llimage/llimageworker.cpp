@@ -30,6 +30,8 @@
 #include "llimagedxt.h"
 #include "threadpool.h"
 
+#include <algorithm>
+
 /*--------------------------------------------------------------------------*/
 class ImageRequest
 {
@@ -44,6 +46,10 @@ public:
     /*virtual*/ bool processRequest();
     /*virtual*/ void finishRequest(bool completed);
 
+    S32 getDiscardLevel() const { return mDiscardLevel; }
+    // Threads beyond the calling one the codec may use, see setMaxCodecThreads()
+    void setSpareThreads(U32 threads) { mSpareThreads = threads; }
+
 private:
     // LLPointers stored in ImageRequest MUST be LLPointer instances rather
     // than references: we need to increment the refcount when storing these.
@@ -51,6 +57,7 @@ private:
     LLPointer<LLImageFormatted> mFormattedImage;
     S32 mDiscardLevel;
     U32 mRequestId;
+    U32 mSpareThreads;
     bool mNeedsAux;
     // output
     LLPointer<LLImageRaw> mDecodedImageRaw;
@@ -65,7 +72,10 @@ private:
 
 // MAIN THREAD
 LLImageDecodeThread::LLImageDecodeThread(bool /*threaded*/)
-    : mDecodeCount(0)
+    : mCancelPriority(0.f),
+      mMaxCodecThreads(1),
+      mActiveDecodes(0),
+      mDecodeCount(0)
 {
     mThreadPool.reset(new LL::ThreadPool("ImageDecode", 8));
     mThreadPool->start();
@@ -73,7 +83,24 @@ LLImageDecodeThread::LLImageDecodeThread(bool /*threaded*/)
 
 //virtual
 LLImageDecodeThread::~LLImageDecodeThread()
-{}
+{
+    // the pool's threads may still be in decodeNext()
+    mThreadPool.reset();
+}
+
+namespace
+{
+    // Priority per decoded pixel: each discard level is a quarter of the
+    // pixels of the one below it
+    F32 decode_key(F32 priority, S32 discard)
+    {
+        return priority * (F32)(1 << (2 * llclamp(discard, 0, MAX_DISCARD_LEVEL)));
+    }
+
+    // Smaller decodes are over before extra codec threads would pay for
+    // starting up
+    const S32 MIN_CODEC_THREAD_PIXELS = 1024 * 1024;
+}
 
 // MAIN THREAD
 // virtual
@@ -85,14 +112,16 @@ size_t LLImageDecodeThread::update(F32 max_time_ms)
 
 size_t LLImageDecodeThread::getPending()
 {
-    return mThreadPool->getQueue().size();
+    LLMutexLock lock(&mQueueMutex);
+    return mQueued.size();
 }
 
 LLImageDecodeThread::handle_t LLImageDecodeThread::decodeImage(
     const LLPointer<LLImageFormatted>& image,
     S32 discard,
     bool needs_aux,
-    const LLPointer<LLImageDecodeThread::Responder>& responder)
+    const LLPointer<LLImageDecodeThread::Responder>& responder,
+    F32 priority)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
 
@@ -100,23 +129,124 @@ LLImageDecodeThread::handle_t LLImageDecodeThread::decodeImage(
     if (decode_id == 0)
         decode_id = ++mDecodeCount;
 
-    // Instantiate the ImageRequest right in the lambda, why not?
-    bool posted = mThreadPool->getQueue().post(
-        [req = ImageRequest(image, discard, needs_aux, responder, decode_id)]
-        () mutable
-        {
-            auto done = req.processRequest();
-            req.finishRequest(done);
-        });
+    {
+        LLMutexLock lock(&mQueueMutex);
+        QueuedRequest& queued = mQueued[decode_id];
+        queued.mRequest.reset(new ImageRequest(image, discard, needs_aux, responder, decode_id));
+        queued.mKey = decode_key(priority, discard);
+        queued.mSerial = 0;
+        mHeap.push_back({ queued.mKey, decode_id, 0 });
+        std::push_heap(mHeap.begin(), mHeap.end());
+    }
+
+    // One work item per request. Each one decodes whatever is at the top of
+    // the queue when it runs, not necessarily the request that posted it.
+    bool posted = mThreadPool->getQueue().post([this]() { decodeNext(); });
     if (! posted)
     {
         LL_DEBUGS() << "Tried to start decoding on shutdown" << LL_ENDL;
+        LLMutexLock lock(&mQueueMutex);
+        mQueued.erase(decode_id);
         return 0;
     }
 
     return decode_id;
 }
 
+bool LLImageDecodeThread::setPriority(handle_t handle, F32 priority)
+{
+    std::unique_ptr<ImageRequest> cancelled;
+    {
+        LLMutexLock lock(&mQueueMutex);
+        auto iter = mQueued.find(handle);
+        if (iter == mQueued.end())
+        {
+            return true; // already started or done
+        }
+
+        QueuedRequest& queued = iter->second;
+        if (priority <= mCancelPriority)
+        {
+            cancelled = std::move(queued.mRequest);
+            mQueued.erase(iter);
+        }
+        else
+        {
+            F32 key = decode_key(priority, queued.mRequest->getDiscardLevel());
+            if (key == queued.mKey)
+            {
+                return true;
+            }
+            queued.mKey = key;
+            ++queued.mSerial;
+            mHeap.push_back({ key, handle, queued.mSerial });
+            std::push_heap(mHeap.begin(), mHeap.end());
+            if (mHeap.size() > mQueued.size() * 4 + 64)
+            {
+                rebuildQueue();
+            }
+            return true;
+        }
+    }
+    // released outside the lock, drops the image and responder references
+    cancelled.reset();
+    return false;
+}
+
+void LLImageDecodeThread::rebuildQueue()
+{
+    mHeap.clear();
+    mHeap.reserve(mQueued.size());
+    for (auto& queued : mQueued)
+    {
+        mHeap.push_back({ queued.second.mKey, queued.first, queued.second.mSerial });
+    }
+    std::make_heap(mHeap.begin(), mHeap.end());
+}
+
+// WORKER THREAD
+void LLImageDecodeThread::decodeNext()
+{
+    std::unique_ptr<ImageRequest> request;
+    U32 spare_threads = 0;
+    {
+        LLMutexLock lock(&mQueueMutex);
+        while (!request && !mHeap.empty())
+        {
+            std::pop_heap(mHeap.begin(), mHeap.end());
+            HeapEntry top = mHeap.back();
+            mHeap.pop_back();
+
+            auto iter = mQueued.find(top.mHandle);
+            if (iter != mQueued.end() && iter->second.mSerial == top.mSerial)
+            {
+                request = std::move(iter->second.mRequest);
+                mQueued.erase(iter);
+            }
+        }
+
+        if (request)
+        {
+            // Workers that are neither decoding nor about to pick up a queued
+            // request. This is the highest priority request, so it gets them.
+            U32 active = ++mActiveDecodes;
+            U32 width = (U32)mThreadPool->getWidth();
+            U32 idle = width > active ? width - active : 0;
+            U32 queued = (U32)mQueued.size();
+            spare_threads = llmin(idle > queued ? idle - queued : 0, mMaxCodecThreads - 1);
+        }
+    }
+
+    // nothing left if requests were cancelled
+    if (request)
+    {
+        request->setSpareThreads(spare_threads);
+        bool done = request->processRequest();
+        request->finishRequest(done);
+        --mActiveDecodes;
+    }
+}
+
 void LLImageDecodeThread::shutdown()
 {
     mThreadPool->close();
@@ -139,7 +269,8 @@ ImageRequest::ImageRequest(const LLPointer<LLImageFormatted>& image,
       mDecodedRaw(false),
       mDecodedAux(false),
       mResponder(responder),
-      mRequestId(request_id)
+      mRequestId(request_id),
+      mSpareThreads(0)
 {
 }
 
@@ -186,6 +317,9 @@ bool ImageRequest::processRequest()
             {
                 mFormattedImage->setDiscardLevel(mDiscardLevel);
             }
+            S32 discard = llmax(mDiscardLevel, 0);
+            S32 pixels = (mFormattedImage->getWidth() >> discard) * (mFormattedImage->getHeight() >> discard);
+            mFormattedImage->setCodecThreads(pixels >= MIN_CODEC_THREAD_PIXELS ? 1 + mSpareThreads : 1);
             mDecodedImageRaw = new LLImageRaw(mFormattedImage->getWidth(),
                                               mFormattedImage->getHeight(),
                                               mFormattedImage->getComponents());
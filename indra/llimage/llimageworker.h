@@ -28,9 +28,15 @@
 #define LL_LLIMAGEWORKER_H
 
 #include "llimage.h"
+#include "llmutex.h"
 #include "llpointer.h"
 #include "threadpool_fwd.h"
 
+#include <unordered_map>
+#include <vector>
+
+class ImageRequest;
+
 class LLImageDecodeThread
 {
 public:
@@ -48,15 +54,65 @@ public:
 
     // meant to resemble LLQueuedThread::handle_t
     typedef U32 handle_t;
+
+    // Requests are decoded highest priority first rather than in the order
+    // they were made. priority is the caller's measure of how much the image
+    // matters (the fetcher uses the texture's on screen size); it's weighed
+    // against the cost of the discard level, so coarse levels get ahead of
+    // full resolution decodes of similar priority.
     handle_t decodeImage(const LLPointer<LLImageFormatted>& image,
                          S32 discard, bool needs_aux,
-                         const LLPointer<Responder>& responder);
+                         const LLPointer<Responder>& responder,
+                         F32 priority = 0.f);
+
+    // Moves a queued request up or down the queue. If priority is at or below
+    // the cancel priority the request is dropped instead, its responder is
+    // never called and this returns false. Requests that already started
+    // decoding run to completion either way.
+    bool setPriority(handle_t handle, F32 priority);
+    void setCancelPriority(F32 priority) { mCancelPriority = priority; }
+
+    // Lets a codec that can split one decode (OpenJPEG) use up to max_threads
+    // threads on a large image while decode workers would otherwise sit idle,
+    // e.g. for the one big texture in front of the camera. 1 turns this off.
+    void setMaxCodecThreads(U32 max_threads) { mMaxCodecThreads = llmax(max_threads, 1U); }
+
     size_t getPending();
     size_t update(F32 max_time_ms);
     S32 getTotalDecodeCount() { return mDecodeCount; }
     void shutdown();
 
 private:
+    void decodeNext();
+    void rebuildQueue(); // mQueueMutex must be locked
+
+    struct QueuedRequest
+    {
+        std::unique_ptr<ImageRequest> mRequest;
+        F32 mKey;
+        U32 mSerial;
+    };
+    struct HeapEntry
+    {
+        F32 mKey;
+        handle_t mHandle;
+        U32 mSerial; // stale once it doesn't match the request's
+        bool operator<(const HeapEntry& rhs) const
+        {
+            // max heap on key, older requests first on ties
+            return mKey < rhs.mKey || (mKey == rhs.mKey && mHandle > rhs.mHandle);
+        }
+    };
+
+    // Re-prioritizing pushes a new heap entry and leaves the old one to be
+    // skipped when it comes up, so mHeap may hold more entries than mQueued.
+    LLMutex mQueueMutex;
+    std::unordered_map<handle_t, QueuedRequest> mQueued;
+    std::vector<HeapEntry> mHeap;
+    F32 mCancelPriority;
+    U32 mMaxCodecThreads;
+    LLAtomicU32 mActiveDecodes;
+
     // As of SL-17483, LLImageDecodeThread is no longer itself an
     // LLQueuedThread - instead this is the API by which we submit work to the
     // "ImageDecode" ThreadPool.
@@ -0,0 +1,252 @@
+/**
+ * @file llimagekernels_test.cpp
+ * @brief Tests and micro-benchmark for the LLImageRaw pixel kernels
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+// Class to test
+#include "../llimagekernels.h"
+#include "stringize.h"
+// Tut header
+#include "../test/lltut.h"
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+namespace tut
+{
+    using namespace LLImageKernels;
+
+    struct imagekernels_test
+    {
+        std::mt19937 mRandom;
+        EISA mSavedISA;
+
+        imagekernels_test()
+        :   mRandom(1234),
+            mSavedISA(getISA())
+        {
+        }
+
+        ~imagekernels_test()
+        {
+            setISA(mSavedISA);
+        }
+
+        std::vector<U8> randomBytes(U32 count)
+        {
+            std::vector<U8> bytes(count);
+            for (U8& b : bytes)
+            {
+                b = (U8)mRandom();
+            }
+            return bytes;
+        }
+
+        // Every ISA this machine supports, scalar first
+        std::vector<EISA> isas() const
+        {
+            std::vector<EISA> result;
+            for (S32 isa = ISA_SCALAR; isa <= getBestISA(); ++isa)
+            {
+                result.push_back((EISA)isa);
+            }
+            return result;
+        }
+
+        // Milliseconds per call of func, best of a few runs
+        template <typename FUNC>
+        F64 time(FUNC func)
+        {
+            F64 best = 0.0;
+            for (S32 run = 0; run < 5; ++run)
+            {
+                auto start = std::chrono::steady_clock::now();
+                func();
+                F64 ms = std::chrono::duration<F64, std::milli>(std::chrono::steady_clock::now() - start).count();
+                best = (run == 0) ? ms : llmin(best, ms);
+            }
+            return best;
+        }
+    };
+
+    typedef test_group<imagekernels_test> imagekernels_t;
+    typedef imagekernels_t::object imagekernels_object_t;
+    tut::imagekernels_t tut_imagekernels("LLImageKernels");
+
+    template<> template<>
+    void imagekernels_object_t::test<1>()
+    {
+        // 3 <-> 4 channel conversions, including sizes that leave a scalar tail
+        for (U32 pixels : { 0u, 1u, 5u, 6u, 9u, 10u, 31u, 257u })
+        {
+            std::vector<U8> rgb = randomBytes(pixels * 3);
+            std::vector<U8> expected(pixels * 4);
+            for (U32 i = 0; i < pixels; ++i)
+            {
+                expected[i * 4] = rgb[i * 3];
+                expected[i * 4 + 1] = rgb[i * 3 + 1];
+                expected[i * 4 + 2] = rgb[i * 3 + 2];
+                expected[i * 4 + 3] = 255;
+            }
+
+            for (EISA isa : isas())
+            {
+                setISA(isa);
+                std::vector<U8> rgba(pixels * 4);
+                copy3onto4(rgb.data(), rgba.data(), pixels);
+                ensure(STRINGIZE(getISAName(isa) << " copy3onto4 of " << pixels), rgba == expected);
+
+                std::vector<U8> back(pixels * 3);
+                copy4onto3(rgba.data(), back.data(), pixels);
+                ensure(STRINGIZE(getISAName(isa) << " copy4onto3 of " << pixels), back == rgb);
+            }
+        }
+    }
+
+    template<> template<>
+    void imagekernels_object_t::test<2>()
+    {
+        // premultiplied alpha, rounded to nearest
+        for (U32 pixels : { 1u, 4u, 7u, 8u, 67u })
+        {
+            std::vector<U8> rgba = randomBytes(pixels * 4);
+            std::vector<U8> expected = rgba;
+            for (U32 i = 0; i < pixels; ++i)
+            {
+                for (U32 c = 0; c < 3; ++c)
+                {
+                    expected[i * 4 + c] = (U8)((rgba[i * 4 + c] * rgba[i * 4 + 3] + 127) / 255);
+                }
+            }
+
+            for (EISA isa : isas())
+            {
+                setISA(isa);
+                std::vector<U8> result = rgba;
+                premultiplyAlpha(result.data(), pixels);
+                ensure(STRINGIZE(getISAName(isa) << " premultiplyAlpha of " << pixels), result == expected);
+            }
+        }
+    }
+
+    template<> template<>
+    void imagekernels_object_t::test<3>()
+    {
+        // 2x2 box filter for every channel count
+        for (U32 components = 1; components <= 4; ++components)
+        {
+            for (U32 width : { 1u, 3u, 4u, 5u, 17u, 64u })
+            {
+                const U32 height = 3;
+                std::vector<U8> src = randomBytes(width * 2 * height * 2 * components);
+                std::vector<U8> expected(width * height * components);
+                for (U32 y = 0; y < height; ++y)
+                {
+                    const U8* top = &src[y * 2 * width * 2 * components];
+                    const U8* bottom = top + width * 2 * components;
+                    for (U32 i = 0; i < width * components; ++i)
+                    {
+                        U32 x = i / components;
+                        U32 c = i % components;
+                        U32 left = x * 2 * components + c;
+                        expected[y * width * components + i] =
+                            (U8)((top[left] + top[left + components] + bottom[left] + bottom[left + components]) >> 2);
+                    }
+                }
+
+                for (EISA isa : isas())
+                {
+                    setISA(isa);
+                    std::vector<U8> result(expected.size());
+                    boxDownsample2x(src.data(), result.data(), width, height, components);
+                    ensure(STRINGIZE(getISAName(isa) << " boxDownsample2x " << components << " channels, width " << width),
+                           result == expected);
+                }
+            }
+        }
+    }
+
+    template<> template<>
+    void imagekernels_object_t::test<4>()
+    {
+        // The vector downscales must match the scalar reference exactly
+        const U32 sizes[][4] = {
+            { 2, 2, 1, 1 },
+            { 256, 256, 128, 128 },
+            { 300, 200, 299, 199 },
+            { 1000, 37, 13, 11 },
+            { 129, 511, 65, 64 },
+        };
+        for (const U32* size : sizes)
+        {
+            U32 src_w = size[0], src_h = size[1], dst_w = size[2], dst_h = size[3];
+            std::vector<U8> src = randomBytes(src_w * src_h * 4);
+
+            std::vector<U8> expected(dst_w * dst_h * 4);
+            setISA(ISA_SCALAR);
+            bilinearDownscale4(src.data(), src_w, src_h, src_w * 4, expected.data(), dst_w, dst_h, dst_w * 4);
+
+            for (EISA isa : isas())
+            {
+                setISA(isa);
+                std::vector<U8> result(expected.size());
+                bilinearDownscale4(src.data(), src_w, src_h, src_w * 4, result.data(), dst_w, dst_h, dst_w * 4);
+                ensure(STRINGIZE(getISAName(isa) << " bilinearDownscale4 " << src_w << "x" << src_h
+                                 << " -> " << dst_w << "x" << dst_h), result == expected);
+            }
+        }
+    }
+
+    template<> template<>
+    void imagekernels_object_t::test<5>()
+    {
+        // Micro-benchmark: only logs, the numbers depend too much on the
+        // machine to assert on them.
+        const U32 size = 1024;
+        std::vector<U8> rgba = randomBytes(size * size * 4);
+        std::vector<U8> rgb = randomBytes(size * size * 3);
+        std::vector<U8> out(size * size * 4);
+
+        for (EISA isa : isas())
+        {
+            setISA(isa);
+            F64 to4 = time([&]() { copy3onto4(rgb.data(), out.data(), size * size); });
+            F64 to3 = time([&]() { copy4onto3(rgba.data(), out.data(), size * size); });
+            F64 premult = time([&]() { std::vector<U8> tmp = rgba; premultiplyAlpha(tmp.data(), size * size); });
+            F64 box = time([&]() { boxDownsample2x(rgba.data(), out.data(), size / 2, size / 2, 4); });
+            F64 box3 = time([&]() { boxDownsample2x(rgb.data(), out.data(), size / 2, size / 2, 3); });
+            F64 scale = time([&]() { bilinearDownscale4(rgba.data(), size, size, size * 4, out.data(), 700, 500, 700 * 4); });
+
+            LL_INFOS() << getISAName(isa) << " " << size << "x" << size << " (ms):"
+                       << " copy3onto4 " << to4
+                       << " copy4onto3 " << to3
+                       << " premultiplyAlpha " << premult
+                       << " boxDownsample2x RGBA " << box
+                       << " RGB " << box3
+                       << " bilinearDownscale4 " << scale << LL_ENDL;
+        }
+    }
+}
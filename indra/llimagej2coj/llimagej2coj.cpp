@@ -336,13 +336,21 @@ public:
         return true;
     }
 
-    bool decode(U8* data, U32 dataSize, U32* channels, U8 discard_level)
+    bool decode(U8* data, U32 dataSize, U32* channels, U8 discard_level, S32 threads = 1)
     {
         parameters.flags &= ~OPJ_DPARAMETERS_DUMP_FLAG;
 
         decoder = opj_create_decompress(OPJ_CODEC_J2K);
         opj_setup_decoder(decoder, &parameters);
 
+#if OPJ_VERSION_MAJOR > 2 || (OPJ_VERSION_MAJOR == 2 && OPJ_VERSION_MINOR >= 3)
+        // code blocks of one image decoded in parallel, see LLImageDecodeThread::setMaxCodecThreads()
+        if (threads > 1 && opj_has_thread_support())
+        {
+            opj_codec_set_threads(decoder, threads);
+        }
+#endif
+
         opj_set_info_handler(decoder, opj_info, this);
         opj_set_warning_handler(decoder, opj_warn, this);
         opj_set_error_handler(decoder, opj_error, this);
@@ -487,7 +495,7 @@ public:
         comment_text = nullptr;
     }
 
-    bool encode(const LLImageRaw& rawImageIn, LLImageJ2C &compressedImageOut)
+    bool encode(const LLImageRaw& rawImageIn, LLImageJ2C &compressedImageOut, S32 threads = 1)
     {
         LLImageDataSharedLock lockIn(&rawImageIn);
         LLImageDataLock lockOut(&compressedImageOut);
@@ -550,6 +558,14 @@ public:
             return false;
         }
 
+#if OPJ_VERSION_MAJOR > 2 || (OPJ_VERSION_MAJOR == 2 && OPJ_VERSION_MINOR >= 4)
+        // encoder side threading appeared in 2.4, code blocks are compressed in parallel
+        if (threads > 1 && opj_has_thread_support())
+        {
+            opj_codec_set_threads(encoder, threads);
+        }
+#endif
+
         opj_set_info_handler(encoder, opj_info, this);
         opj_set_warning_handler(encoder, opj_warn, this);
         opj_set_error_handler(encoder, opj_error, this);
@@ -828,7 +844,7 @@ bool LLImageJ2COJ::decodeImpl(LLImageJ2C &base, LLImageRaw &raw_image, F32 decod
     U32 image_channels = 0;
     S32 data_size = base.getDataSize();
     S32 max_bytes = (base.getMaxBytes() ? base.getMaxBytes() : data_size);
-    bool decoded = decoder.decode(base.getData(), max_bytes, &image_channels, base.mDiscardLevel);
+    bool decoded = decoder.decode(base.getData(), max_bytes, &image_channels, base.mDiscardLevel, base.getCodecThreads());
 
     // set correct channel count early so failed decodes don't miss it...
     S32 channels = (S32)image_channels - first_channel;
@@ -914,7 +930,7 @@ bool LLImageJ2COJ::decodeImpl(LLImageJ2C &base, LLImageRaw &raw_image, F32 decod
 bool LLImageJ2COJ::encodeImpl(LLImageJ2C &base, const LLImageRaw &raw_image, const char* comment_text, F32 encode_time, bool reversible)
 {
     JPEG2KEncode encode(comment_text, reversible);
-    bool encoded = encode.encode(raw_image, base);
+    bool encoded = encode.encode(raw_image, base, base.getCodecThreads());
     if (encoded)
     {
         LL_WARNS() << "Openjpeg encoding implementation isn't complete, returning false" << LL_ENDL;
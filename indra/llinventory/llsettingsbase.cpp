@@ -335,6 +335,15 @@ LLSD LLSettingsBase::interpolateSDValue(const std::string& key_name, const LLSD
     return new_value;
 }
 
+LLSD& LLSettingsBase::interpolateSDMap(BlendPlan &plan, const LLSettingsBase &other, BlendFactor mix) const
+{
+    if (!plan.isBuilt())
+    {
+        plan.build(mSettings, other.mSettings, other.getParameterMap(), getSkipInterpolateKeys(), getSlerpKeys());
+    }
+    return plan.evaluate(mix);
+}
+
 LLSettingsBase::stringset_t LLSettingsBase::getSkipInterpolateKeys() const
 {
     static stringset_t skipSet;
@@ -681,6 +690,286 @@ bool LLSettingsBase::Validator::verifyStringLength(LLSD &value, U32, S32 length)
     return true;
 }
 
+//=========================================================================
+void LLSettingsBase::BlendPlan::validate(const LLSD &initial, const LLSD &final)
+{
+    if (!mInitial.sharesValueWith(initial) || !mFinal.sharesValueWith(final))
+    {
+        clear();
+        mInitial = initial;
+        mFinal = final;
+    }
+}
+
+void LLSettingsBase::BlendPlan::clear()
+{
+    mBuilt = false;
+    mInitial.clear();
+    mFinal.clear();
+    mResult.clear();
+    mFrom.clear();
+    mDelta.clear();
+    mValues.clear();
+    mLeaves.clear();
+    mSlerps.clear();
+    mSwitches.clear();
+    mTopLevel.clear();
+}
+
+void LLSettingsBase::BlendPlan::build(const LLSD &settings, const LLSD &other, const parammapping_t &defaults,
+                                      const stringset_t &skip, const stringset_t &slerps)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_ENVIRONMENT;
+
+    mLeaves.clear();
+    mSlerps.clear();
+    mSwitches.clear();
+    mTopLevel.clear();
+
+    std::vector<Pending> pending;
+    buildMap(mResult, settings, other, defaults, skip, slerps, pending);
+
+    size_t count = (pending.size() + 3) / 4;
+    std::vector<F32> from(count * 4, 0.f);
+    std::vector<F32> delta(count * 4, 0.f);
+    mLeaves.reserve(pending.size());
+    for (size_t i = 0; i < pending.size(); ++i)
+    {
+        from[i] = pending[i].mFrom;
+        delta[i] = pending[i].mTo - pending[i].mFrom;
+        mLeaves.push_back({ pending[i].mNode, pending[i].mInteger });
+    }
+
+    mFrom.resize(count);
+    mDelta.resize(count);
+    mValues.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        mFrom[i].loadua(&from[i * 4]);
+        mDelta[i].loadua(&delta[i * 4]);
+    }
+
+    mBuilt = true;
+}
+
+// Same walk as interpolateSDMap(), recording what to do rather than doing it
+void LLSettingsBase::BlendPlan::buildMap(LLSD &out, const LLSD &settings, const LLSD &other, const parammapping_t &defaults,
+                                         const stringset_t &skip, const stringset_t &slerps, std::vector<Pending> &pending)
+{
+    // stays undefined if nothing is written, like interpolateSDMap()'s result
+    out.clear();
+
+    for (LLSD::map_const_iterator it = settings.beginMap(); it != settings.endMap(); ++it)
+    {
+        const std::string &key_name = (*it).first;
+        const LLSD &value = (*it).second;
+
+        if (skip.find(key_name) != skip.end())
+            continue;
+
+        LLSD other_value;
+        if (other.has(key_name))
+        {
+            other_value = other[key_name];
+        }
+        else
+        {
+            parammapping_t::const_iterator def_iter = defaults.find(key_name);
+            if (def_iter != defaults.end())
+            {
+                other_value = def_iter->second.getDefaultValue();
+            }
+            else if (value.type() == LLSD::TypeMap)
+            {
+                other_value = LLSD::emptyMap();
+            }
+            else
+            {
+                out[key_name] = value;
+                continue;
+            }
+        }
+
+        buildValue(out[key_name], key_name, value, other_value, defaults, skip, slerps, pending);
+    }
+
+    if (settings.has(SETTING_FLAGS))
+    {
+        U32 flags = (U32)settings[SETTING_FLAGS].asInteger();
+        if (other.has(SETTING_FLAGS))
+            flags |= (U32)other[SETTING_FLAGS].asInteger();
+
+        out[SETTING_FLAGS] = LLSD::Integer(flags);
+    }
+
+    for (LLSD::map_const_iterator it = other.beginMap(); it != other.endMap(); ++it)
+    {
+        const std::string &key_name = (*it).first;
+
+        if (skip.find(key_name) != skip.end())
+            continue;
+
+        if (settings.has(key_name))
+            continue;
+
+        parammapping_t::const_iterator def_iter = defaults.find(key_name);
+        if (def_iter != defaults.end())
+        {
+            buildValue(out[key_name], key_name, def_iter->second.getDefaultValue(), (*it).second, defaults, skip, slerps, pending);
+        }
+        else if ((*it).second.type() == LLSD::TypeMap)
+        {
+            buildValue(out[key_name], key_name, LLSD::emptyMap(), (*it).second, defaults, skip, slerps, pending);
+        }
+    }
+
+    for (LLSD::map_const_iterator it = other.beginMap(); it != other.endMap(); ++it)
+    {
+        if (skip.find((*it).first) == skip.end())
+            continue;
+
+        if (!settings.has((*it).first))
+            continue;
+
+        LLSD &node = out[(*it).first];
+        node = (*it).second;
+        if (&out == &mResult)
+        {
+            mTopLevel.emplace_back((*it).first, &node);
+        }
+    }
+}
+
+// Same cases as interpolateSDValue()
+void LLSettingsBase::BlendPlan::buildValue(LLSD &out, const std::string &key_name, const LLSD &value, const LLSD &other_value,
+                                           const parammapping_t &defaults, const stringset_t &skip, const stringset_t &slerps,
+                                           std::vector<Pending> &pending)
+{
+    LLSD::Type setting_type = value.type();
+
+    if (other_value.type() != setting_type)
+    {
+        LL_WARNS("SETTINGS") << "Setting lerp between mismatched types for '" << key_name << "'." << LL_ENDL;
+    }
+
+    switch (setting_type)
+    {
+        case LLSD::TypeInteger:
+        case LLSD::TypeReal:
+            // a fresh value rather than a copy of value, which evaluate() would have to replace
+            if (setting_type == LLSD::TypeInteger)
+                out = LLSD::Integer(value.asInteger());
+            else
+                out = LLSD::Real(value.asReal());
+            pending.push_back({ &out, (F32)value.asReal(), (F32)other_value.asReal(), setting_type == LLSD::TypeInteger });
+            break;
+        case LLSD::TypeMap:
+            buildMap(out, value, other_value, defaults, skip, slerps, pending);
+            break;
+
+        case LLSD::TypeArray:
+            if (slerps.find(key_name) != slerps.end())
+            {
+                Slerp slerp;
+                slerp.mFrom = LLQuaternion(value);
+                slerp.mTo = LLQuaternion(other_value);
+                out = slerp.mFrom.getValue();
+                for (S32 i = 0; i < 4; ++i)
+                {
+                    slerp.mElements[i] = &out[i];
+                }
+                mSlerps.push_back(slerp);
+            }
+            else
+            {
+                size_t len = std::max(value.size(), other_value.size());
+
+                // size the array first, its elements move while it grows
+                out = LLSD::emptyArray();
+                for (size_t i = 0; i < len; ++i)
+                {
+                    out.append(LLSD::Real(0.0));
+                }
+                for (size_t i = 0; i < len; ++i)
+                {
+                    pending.push_back({ &out[i], (F32)value[i].asReal(), (F32)other_value[i].asReal(), false });
+                }
+            }
+            break;
+
+        case LLSD::TypeUUID:
+            out = value.asUUID();
+            break;
+
+        default:
+            out = value;
+            mSwitches.push_back({ &out, value, other_value });
+            break;
+    }
+}
+
+LLSD& LLSettingsBase::BlendPlan::evaluate(BlendFactor mix)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_ENVIRONMENT;
+    llassert(mBuilt);
+    llassert(mix >= 0.0f && mix <= 1.0f);
+
+    // the same a + (b - a) * u as lerp(), four numbers at a time
+    LLVector4a factor;
+    factor.splat((F32)mix);
+    for (size_t i = 0; i < mValues.size(); ++i)
+    {
+        mValues[i].setMul(mDelta[i], factor);
+        mValues[i].add(mFrom[i]);
+    }
+
+    // each leaf holds its own number, so these assign in place
+    for (size_t i = 0; i < mLeaves.size(); ++i)
+    {
+        F32 value = mValues[i / 4][(S32)(i % 4)];
+        if (mLeaves[i].mInteger)
+        {
+            *mLeaves[i].mNode = LLSD::Integer(llroundf(value));
+        }
+        else
+        {
+            *mLeaves[i].mNode = LLSD::Real(value);
+        }
+    }
+
+    for (const Slerp &slerp_entry : mSlerps)
+    {
+        LLQuaternion q = slerp((F32)mix, slerp_entry.mFrom, slerp_entry.mTo);
+        for (S32 i = 0; i < 4; ++i)
+        {
+            *slerp_entry.mElements[i] = LLSD::Real(q.mQ[i]);
+        }
+    }
+
+    for (const Switch &entry : mSwitches)
+    {
+        *entry.mNode = (mix > BREAK_POINT) ? entry.mTo : entry.mFrom;
+    }
+
+    return mResult;
+}
+
+void LLSettingsBase::BlendPlan::setReal(const std::string &key, LLSD::Real value)
+{
+    for (auto &entry : mTopLevel)
+    {
+        if (entry.first == key)
+        {
+            *entry.second = value;
+            return;
+        }
+    }
+
+    LLSD &node = mResult[key];
+    node = value;
+    mTopLevel.emplace_back(key, &node);
+}
+
 //=========================================================================
 void LLSettingsBlender::update(const LLSettingsBase::BlendFactor& blendf)
 {
@@ -703,8 +992,11 @@ F64 LLSettingsBlender::setBlendFactor(const LLSettingsBase::BlendFactor& blendf_
 
     if (mTarget)
     {
-        mTarget->replaceSettings(mInitial->getSettings());
-        mTarget->blend(mFinal, blendf);
+        // the plan is worked out again only when the end points change
+        LLSD initial = mInitial->getSettings();
+        mPlan.validate(initial, mFinal->getSettings());
+        mTarget->replaceSettings(initial);
+        mTarget->blendPlanned(mFinal, blendf, mPlan);
     }
     else
     {
@@ -35,6 +35,8 @@
 
 #include "llsd.h"
 #include "llsdutil.h"
+#include "llmath.h"
+#include "llvector4a.h"
 #include "v2math.h"
 #include "v3math.h"
 #include "v4math.h"
@@ -96,6 +98,8 @@ public:
 
     typedef PTR_NAMESPACE::shared_ptr<LLSettingsBase> ptr_t;
 
+    class BlendPlan;
+
     virtual ~LLSettingsBase() { };
 
     //---------------------------------------------------------------------
@@ -260,6 +264,9 @@ public:
     }
 
     virtual void    blend(const ptr_t &end, BlendFactor blendf) = 0;
+    // Same as blend(), with the settings maps interpolated through plan (see BlendPlan)
+    // by the types that blend every frame
+    virtual void    blendPlanned(const ptr_t &end, BlendFactor blendf, BlendPlan &plan) { blend(end, blendf); }
 
     virtual bool    validate();
 
@@ -341,6 +348,9 @@ protected:
     // return interpolated and combined LLSD map
     LLSD    interpolateSDMap(const LLSD &settings, const LLSD &other, const parammapping_t& defaults, BlendFactor mix) const;
     LLSD    interpolateSDValue(const std::string& name, const LLSD &value, const LLSD &other, const parammapping_t& defaults, BlendFactor mix, const stringset_t& slerps) const;
+    // interpolateSDMap() of mSettings and other's settings through plan, which is built
+    // on first use.  Returns the plan's result tree.
+    LLSD&   interpolateSDMap(BlendPlan &plan, const LLSettingsBase &other, BlendFactor mix) const;
 
     /// when lerping between settings, some may require special handling.
     /// Get a list of these key to be skipped by the default settings lerp.
@@ -383,6 +393,85 @@ private:
 };
 
 
+// interpolateSDMap() of one pair of settings maps, worked out once and replayed for each
+// blend factor.  interpolateSDMap() looks up every key of both maps and builds a new tree
+// on each call, which a blender does every frame for the sky and the water.  The plan
+// walks the maps once, packs the numbers it finds into vectors of four and remembers the
+// leaves of its result tree, so evaluate() is a vector lerp and a store into each leaf.
+// Nothing is allocated while nobody else holds on to the leaves.
+//
+// evaluate() overwrites the tree in place, so a copy of it changes along with it.
+// llsd_clone() the result to keep a snapshot.
+class LLSettingsBase::BlendPlan
+{
+public:
+    BlendPlan() : mBuilt(false) { }
+
+    // Forget the plan unless it was built for initial and final, the settings of the
+    // blend's end points.  A copy keeps its value shared until either side is modified,
+    // so any change to the end points is seen without looking at their contents.
+    void    validate(const LLSD &initial, const LLSD &final);
+    void    clear();
+    bool    isBuilt() const { return mBuilt; }
+
+    void    build(const LLSD &settings, const LLSD &other, const parammapping_t &defaults,
+                  const stringset_t &skip, const stringset_t &slerps);
+    LLSD&   evaluate(BlendFactor mix);
+
+    // Overwrite a top level value the plan doesn't interpolate, e.g. one on the skip list
+    void    setReal(const std::string &key, LLSD::Real value);
+
+private:
+    struct Leaf
+    {
+        LLSD*   mNode;
+        bool    mInteger;
+    };
+
+    struct Slerp
+    {
+        LLSD*           mElements[4];
+        LLQuaternion    mFrom;
+        LLQuaternion    mTo;
+    };
+
+    struct Switch
+    {
+        LLSD*   mNode;
+        LLSD    mFrom;
+        LLSD    mTo;
+    };
+
+    struct Pending
+    {
+        LLSD*   mNode;
+        F32     mFrom;
+        F32     mTo;
+        bool    mInteger;
+    };
+
+    void    buildMap(LLSD &out, const LLSD &settings, const LLSD &other, const parammapping_t &defaults,
+                     const stringset_t &skip, const stringset_t &slerps, std::vector<Pending> &pending);
+    void    buildValue(LLSD &out, const std::string &key, const LLSD &value, const LLSD &other,
+                       const parammapping_t &defaults, const stringset_t &skip, const stringset_t &slerps,
+                       std::vector<Pending> &pending);
+
+    LLSD    mInitial;
+    LLSD    mFinal;
+    LLSD    mResult;
+
+    // from and to - from of every number, four to a vector, padded with zeros
+    std::vector<LLVector4a> mFrom;
+    std::vector<LLVector4a> mDelta;
+    std::vector<LLVector4a> mValues;
+    std::vector<Leaf>       mLeaves;
+    std::vector<Slerp>      mSlerps;
+    std::vector<Switch>     mSwitches;
+    std::vector<std::pair<std::string, LLSD*> > mTopLevel;
+
+    bool    mBuilt;
+};
+
 class LLSettingsBlender : public PTR_NAMESPACE::enable_shared_from_this<LLSettingsBlender>
 {
     LOG_CLASS(LLSettingsBlender);
@@ -463,6 +552,8 @@ protected:
     LLSettingsBase::ptr_t   mTarget;
     LLSettingsBase::ptr_t   mInitial;
     LLSettingsBase::ptr_t   mFinal;
+
+    LLSettingsBase::BlendPlan mPlan;
 };
 
 class LLSettingsBlenderTimeDelta : public LLSettingsBlender
@@ -448,6 +448,16 @@ void LLSettingsSky::replaceWithSky(LLSettingsSky::ptr_t pother)
 }
 
 void LLSettingsSky::blend(const LLSettingsBase::ptr_t &end, F64 blendf)
+{
+    blendSettings(end, blendf, NULL);
+}
+
+void LLSettingsSky::blendPlanned(const LLSettingsBase::ptr_t &end, F64 blendf, BlendPlan &plan)
+{
+    blendSettings(end, blendf, &plan);
+}
+
+void LLSettingsSky::blendSettings(const LLSettingsBase::ptr_t &end, F64 blendf, BlendPlan *plan)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_ENVIRONMENT;
     llassert(getSettingsType() == end->getSettingsType());
@@ -499,9 +509,18 @@ void LLSettingsSky::blend(const LLSettingsBase::ptr_t &end, F64 blendf)
             cloud_shadow = lerp((F32)mSettings[SETTING_CLOUD_SHADOW].asReal(), (F32)other->mSettings[SETTING_CLOUD_SHADOW].asReal(), (F32)blendf);
         }
 
-        LLSD blenddata = interpolateSDMap(mSettings, other->mSettings, other->getParameterMap(), blendf);
-        blenddata[SETTING_CLOUD_SHADOW] = LLSD::Real(cloud_shadow);
-        replaceSettings(blenddata);
+        if (plan)
+        {
+            LLSD &blenddata = interpolateSDMap(*plan, *other, blendf);
+            plan->setReal(SETTING_CLOUD_SHADOW, cloud_shadow);
+            replaceSettings(blenddata);
+        }
+        else
+        {
+            LLSD blenddata = interpolateSDMap(mSettings, other->mSettings, other->getParameterMap(), blendf);
+            blenddata[SETTING_CLOUD_SHADOW] = LLSD::Real(cloud_shadow);
+            replaceSettings(blenddata);
+        }
         mNextSunTextureId = other->getSunTextureId();
         mNextMoonTextureId = other->getMoonTextureId();
         mNextCloudTextureId = cloud_noise_id_next;
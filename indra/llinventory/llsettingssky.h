@@ -119,6 +119,7 @@ public:
 
     // Settings status
     virtual void blend(const LLSettingsBase::ptr_t &end, F64 blendf) SETTINGS_OVERRIDE;
+    virtual void blendPlanned(const LLSettingsBase::ptr_t &end, F64 blendf, BlendPlan &plan) SETTINGS_OVERRIDE;
 
     virtual void replaceSettings(LLSD settings) SETTINGS_OVERRIDE;
 
@@ -356,6 +357,9 @@ protected:
     LLUUID      mNextHaloTextureId;
 
 private:
+    // blend() and blendPlanned(), plan may be NULL
+    void        blendSettings(const LLSettingsBase::ptr_t &end, F64 blendf, BlendPlan *plan);
+
     static LLSD rayleighConfigDefault();
     static LLSD absorptionConfigDefault();
     static LLSD mieConfigDefault();
@@ -181,12 +181,28 @@ LLSD LLSettingsWater::translateLegacySettings(LLSD legacy)
 }
 
 void LLSettingsWater::blend(const LLSettingsBase::ptr_t &end, F64 blendf)
+{
+    blendSettings(end, blendf, NULL);
+}
+
+void LLSettingsWater::blendPlanned(const LLSettingsBase::ptr_t &end, F64 blendf, BlendPlan &plan)
+{
+    blendSettings(end, blendf, &plan);
+}
+
+void LLSettingsWater::blendSettings(const LLSettingsBase::ptr_t &end, F64 blendf, BlendPlan *plan)
 {
     LLSettingsWater::ptr_t other = PTR_NAMESPACE::static_pointer_cast<LLSettingsWater>(end);
     if (other)
     {
-        LLSD blenddata = interpolateSDMap(mSettings, other->mSettings, other->getParameterMap(), blendf);
-        replaceSettings(blenddata);
+        if (plan)
+        {
+            replaceSettings(interpolateSDMap(*plan, *other, blendf));
+        }
+        else
+        {
+            replaceSettings(interpolateSDMap(mSettings, other->mSettings, other->getParameterMap(), blendf));
+        }
         mNextNormalMapID = other->getNormalMapID();
         mNextTransparentTextureID = other->getTransparentTextureID();
     }
@@ -63,6 +63,7 @@ public:
 
     // Settings status
     virtual void blend(const LLSettingsBase::ptr_t &end, F64 blendf) SETTINGS_OVERRIDE;
+    virtual void blendPlanned(const LLSettingsBase::ptr_t &end, F64 blendf, BlendPlan &plan) SETTINGS_OVERRIDE;
 
     virtual void replaceSettings(LLSD settings) SETTINGS_OVERRIDE;
     void replaceWithWater(LLSettingsWater::ptr_t other);
@@ -244,6 +245,9 @@ protected:
     LLUUID    mNextTransparentTextureID;
     LLUUID    mNextNormalMapID;
 
+private:
+    // blend() and blendPlanned(), plan may be NULL
+    void      blendSettings(const LLSettingsBase::ptr_t &end, F64 blendf, BlendPlan *plan);
 };
 
 #endif
@@ -296,6 +296,100 @@ S32 LLCamera::AABBInRegionFrustumNoFarClip(const LLVector4a& center, const LLVec
     return AABBInFrustumNoFarClip(center, radius, mRegionPlanes);
 }
 
+// Same tests as AABBInFrustum(...), on four boxes per pass with their x, y and z
+// in separate registers. The arithmetic is done in the same order as LLVector4a::dot3()
+// so every box gets exactly the answer the one box version would give.
+void LLCamera::AABBsInFrustum(const LLVector4a* centers, const LLVector4a* radii, S32* results, U32 count,
+                              const LLPlane* planes, bool no_far_clip)
+{
+    if(!planes)
+    {
+        //use agent space
+        planes = mAgentPlanes;
+    }
+
+    U32 max_planes = llmin(mPlaneCount, (U32) AGENT_PLANE_USER_CLIP_NUM);       // mAgentPlanes[] size is 7
+    for (U32 first = 0; first < count; first += 4)
+    {
+        // gather four boxes, repeating the last one to fill a short batch
+        LLQuad c[4], r[4];
+        for (U32 j = 0; j < 4; j++)
+        {
+            U32 idx = llmin(first + j, count - 1);
+            c[j] = centers[idx];
+            r[j] = radii[idx];
+        }
+        // c[0] now holds the four x, c[1] the four y and c[2] the four z, same for r
+        _MM_TRANSPOSE4_PS(c[0], c[1], c[2], c[3]);
+        _MM_TRANSPOSE4_PS(r[0], r[1], r[2], r[3]);
+        const LLVector4a cx(c[0]), cy(c[1]), cz(c[2]);
+        const LLVector4a rx(r[0]), ry(r[1]), rz(r[2]);
+
+        U32 outside = 0;
+        U32 partial = 0;
+        for (U32 i = 0; i < max_planes && outside != 0xF; i++)
+        {
+            U8 mask = mPlaneMask[i];
+            if (mask >= PLANE_MASK_NUM || (no_far_clip && i == 5))
+            {
+                continue;
+            }
+
+            const LLPlane& p(planes[i]);
+            const LLVector4a& scaler = sFrustumScaler[mask];
+            LLVector4a a, b, cc, d;
+            a.splat(p[0]);
+            b.splat(p[1]);
+            cc.splat(p[2]);
+            d.splat(-p[3]);
+
+            // rscale = radius * scaler, per axis for all four boxes
+            LLVector4a sx, sy, sz;
+            sx.splat<0>(scaler);
+            sy.splat<1>(scaler);
+            sz.splat<2>(scaler);
+            sx.mul(rx);
+            sy.mul(ry);
+            sz.mul(rz);
+
+            LLVector4a x, y, z, dist;
+            x.setSub(cx, sx);
+            y.setSub(cy, sy);
+            z.setSub(cz, sz);
+            x.mul(a);
+            y.mul(b);
+            z.mul(cc);
+            dist.setAdd(x, y);
+            dist.add(z);
+            outside |= dist.greaterThan(d).getGatheredBits();
+
+            x.setAdd(cx, sx);
+            y.setAdd(cy, sy);
+            z.setAdd(cz, sz);
+            x.mul(a);
+            y.mul(b);
+            z.mul(cc);
+            dist.setAdd(x, y);
+            dist.add(z);
+            partial |= dist.greaterThan(d).getGatheredBits();
+        }
+
+        for (U32 j = 0; j < 4 && first + j < count; j++)
+        {
+            U32 bit = 1 << j;
+            results[first + j] = (outside & bit) ? 0 : ((partial & bit) ? 1 : 2);
+        }
+    }
+}
+
+//exactly same as the function AABBsInFrustum(...)
+//except uses mRegionPlanes instead of mAgentPlanes.
+void LLCamera::AABBsInRegionFrustum(const LLVector4a* centers, const LLVector4a* radii, S32* results, U32 count,
+                                    bool no_far_clip)
+{
+    AABBsInFrustum(centers, radii, results, count, mRegionPlanes, no_far_clip);
+}
+
 int LLCamera::sphereInFrustumQuick(const LLVector3 &sphere_center, const F32 radius)
 {
     LLVector3 dist = sphere_center-mFrustCenter;
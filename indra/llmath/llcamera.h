@@ -201,6 +201,12 @@ public:
     S32 AABBInRegionFrustum(const LLVector4a& center, const LLVector4a& radius);
     S32 AABBInFrustumNoFarClip(const LLVector4a& center, const LLVector4a& radius, const LLPlane* planes = NULL);
     S32 AABBInRegionFrustumNoFarClip(const LLVector4a& center, const LLVector4a& radius);
+    // Cull count boxes four at a time, results[i] is what AABBInFrustum(centers[i], radii[i], planes)
+    // (AABBInFrustumNoFarClip() if no_far_clip) returns.
+    void AABBsInFrustum(const LLVector4a* centers, const LLVector4a* radii, S32* results, U32 count,
+                        const LLPlane* planes = NULL, bool no_far_clip = false);
+    void AABBsInRegionFrustum(const LLVector4a* centers, const LLVector4a* radii, S32* results, U32 count,
+                              bool no_far_clip = false);
 
     //does a quick 'n dirty sphere-sphere check
     S32 sphereInFrustumQuick(const LLVector3 &sphere_center, const F32 radius);
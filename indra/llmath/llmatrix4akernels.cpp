@@ -0,0 +1,200 @@
+/**
+ * @file llmatrix4akernels.cpp
+ * @brief Batched LLMatrix4a products and transforms
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+
+#include "linden_common.h"
+
+#include "llmatrix4akernels.h"
+
+#include "llmath.h"
+#include "llmatrix4a.h"
+#include "llprocessor.h"
+
+#include <immintrin.h>
+
+// The AVX2 functions are compiled for AVX2 and FMA on their own, so the rest
+// of the file still runs on SSE2 only machines. MSVC doesn't need this, it
+// lets any function use any intrinsic.
+#if defined(__GNUC__) && !(defined(__AVX2__) && defined(__FMA__))
+#define LL_TARGET_AVX2_FMA __attribute__((target("avx2,fma")))
+#else
+#define LL_TARGET_AVX2_FMA
+#endif
+
+namespace
+{
+    using namespace LLMatrix4aKernels;
+
+    EISA detect_best_isa()
+    {
+        LLProcessorInfo info;
+        if (info.hasAVX2() && info.hasFMA())
+        {
+            return ISA_AVX2_FMA;
+        }
+        return ISA_SSE2;
+    }
+
+    EISA& best_isa()
+    {
+        static EISA isa = detect_best_isa();
+        return isa;
+    }
+
+    EISA& current_isa()
+    {
+        static EISA isa = best_isa();
+        return isa;
+    }
+
+    void mat_mul_sse2(const LLMatrix4a* a, const LLMatrix4a* b, LLMatrix4a* res, U32 count)
+    {
+        for (U32 i = 0; i < count; ++i)
+        {
+            matMulUnsafe(a[i], b[i], res[i]);
+        }
+    }
+
+    void affine_transform_sse2(const LLMatrix4a& m, const LLVector4a* in, LLVector4a* out, U32 count)
+    {
+        for (U32 i = 0; i < count; ++i)
+        {
+            m.affineTransformSSE(in[i], out[i]);
+        }
+    }
+
+    // Rows of b (or columns of a transform) splatted into both 128 bit lanes
+    struct Rows256
+    {
+        __m256 mRow[4];
+    };
+
+    LL_TARGET_AVX2_FMA inline Rows256 load_rows(const LLMatrix4a& m)
+    {
+        Rows256 rows;
+        for (U32 r = 0; r < 4; ++r)
+        {
+            rows.mRow[r] = _mm256_broadcast_ps((const __m128*)m.mMatrix[r].getF32ptr());
+        }
+        return rows;
+    }
+
+    // Two row vectors (one per lane) times the matrix in rows
+    LL_TARGET_AVX2_FMA inline __m256 row_pair_mul(__m256 v, const Rows256& rows)
+    {
+        __m256 res = _mm256_mul_ps(_mm256_permute_ps(v, _MM_SHUFFLE(0, 0, 0, 0)), rows.mRow[0]);
+        res = _mm256_fmadd_ps(_mm256_permute_ps(v, _MM_SHUFFLE(1, 1, 1, 1)), rows.mRow[1], res);
+        res = _mm256_fmadd_ps(_mm256_permute_ps(v, _MM_SHUFFLE(2, 2, 2, 2)), rows.mRow[2], res);
+        return _mm256_fmadd_ps(_mm256_permute_ps(v, _MM_SHUFFLE(3, 3, 3, 3)), rows.mRow[3], res);
+    }
+
+    LL_TARGET_AVX2_FMA void mat_mul_avx2_fma(const LLMatrix4a* a, const LLMatrix4a* b, LLMatrix4a* res, U32 count)
+    {
+        for (U32 i = 0; i < count; ++i)
+        {
+            Rows256 rows = load_rows(b[i]);
+            const F32* src = a[i].mMatrix[0].getF32ptr();
+            F32* dst = res[i].mMatrix[0].getF32ptr();
+            // rows 0-1 and 2-3 of a, each pair in one register
+            _mm256_storeu_ps(dst, row_pair_mul(_mm256_loadu_ps(src), rows));
+            _mm256_storeu_ps(dst + 8, row_pair_mul(_mm256_loadu_ps(src + 8), rows));
+        }
+    }
+
+    LL_TARGET_AVX2_FMA void affine_transform_avx2_fma(const LLMatrix4a& m, const LLVector4a* in, LLVector4a* out, U32 count)
+    {
+        Rows256 rows = load_rows(m);
+        U32 i = 0;
+        for (; i + 2 <= count; i += 2)
+        {
+            __m256 v = _mm256_loadu_ps(in[i].getF32ptr());
+            // the w of in is ignored, the translation row is added as is
+            __m256 res = _mm256_fmadd_ps(_mm256_permute_ps(v, _MM_SHUFFLE(0, 0, 0, 0)), rows.mRow[0], rows.mRow[3]);
+            res = _mm256_fmadd_ps(_mm256_permute_ps(v, _MM_SHUFFLE(1, 1, 1, 1)), rows.mRow[1], res);
+            res = _mm256_fmadd_ps(_mm256_permute_ps(v, _MM_SHUFFLE(2, 2, 2, 2)), rows.mRow[2], res);
+            _mm256_storeu_ps(out[i].getF32ptr(), res);
+        }
+        if (i < count)
+        {
+            m.affineTransformSSE(in[i], out[i]);
+        }
+    }
+}
+
+namespace LLMatrix4aKernels
+{
+    EISA getISA()
+    {
+        return current_isa();
+    }
+
+    EISA getBestISA()
+    {
+        return best_isa();
+    }
+
+    void setISA(EISA isa)
+    {
+        current_isa() = isa < best_isa() ? isa : best_isa();
+    }
+
+    const char* getISAName(EISA isa)
+    {
+        switch (isa)
+        {
+        case ISA_AVX2_FMA:
+            return "AVX2+FMA";
+        default:
+            return "SSE2";
+        }
+    }
+
+    void matMulArray(const LLMatrix4a* a, const LLMatrix4a* b, LLMatrix4a* res, U32 count)
+    {
+        switch (current_isa())
+        {
+        case ISA_AVX2_FMA:
+            mat_mul_avx2_fma(a, b, res, count);
+            break;
+        default:
+            mat_mul_sse2(a, b, res, count);
+            break;
+        }
+    }
+
+    void affineTransformArray(const LLMatrix4a& m, const LLVector4a* in, LLVector4a* out, U32 count)
+    {
+        switch (current_isa())
+        {
+        case ISA_AVX2_FMA:
+            affine_transform_avx2_fma(m, in, out, count);
+            break;
+        default:
+            affine_transform_sse2(m, in, out, count);
+            break;
+        }
+    }
+}
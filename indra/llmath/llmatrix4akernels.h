@@ -0,0 +1,68 @@
+/**
+ * @file llmatrix4akernels.h
+ * @brief Batched LLMatrix4a products and transforms
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+
+#ifndef LL_LLMATRIX4AKERNELS_H
+#define LL_LLMATRIX4AKERNELS_H
+
+class LLMatrix4a;
+class LLVector4a;
+
+// Loops over LLMatrix4a::affineTransform() and matMul() for callers with many
+// vectors or matrices at once, with an SSE2 version and an AVX2 + FMA version
+// that works on two rows or two vectors per instruction. The best version the
+// CPU supports (according to LLProcessorInfo) is picked the first time a
+// kernel is called. The FMA version rounds once per multiply-add, so its
+// results can differ from the SSE2 ones in the last bit.
+
+namespace LLMatrix4aKernels
+{
+    enum EISA
+    {
+        ISA_SSE2 = 0,
+        ISA_AVX2_FMA,
+    };
+
+    // Version currently in use
+    EISA getISA();
+
+    // Best version this CPU and build support
+    EISA getBestISA();
+
+    // Use isa (clamped to getBestISA()) from now on. Meant for tests and
+    // benchmarks; not safe to call while other threads run kernels.
+    void setISA(EISA isa);
+
+    const char* getISAName(EISA isa);
+
+    // res[i] = a[i] * b[i], like matMul(). res must not overlap a or b.
+    void matMulArray(const LLMatrix4a* a, const LLMatrix4a* b, LLMatrix4a* res, U32 count);
+
+    // out[i] = m.affineTransform(in[i]). out must not overlap in.
+    void affineTransformArray(const LLMatrix4a& m, const LLVector4a* in, LLVector4a* out, U32 count);
+}
+
+#endif // LL_LLMATRIX4AKERNELS_H
@@ -30,6 +30,7 @@
 #include "lltreenode.h"
 #include "v3math.h"
 #include "llvector4a.h"
+#include "llslabpool.h"
 #include <vector>
 
 #include "nd/ndoctreelog.h"
@@ -114,7 +115,8 @@ public:
                     BaseType* parent,
                     U8 octant = NO_CHILD_NODES)
     :   mParent((oct_node*)parent),
-        mOctant(octant)
+        mOctant(octant),
+        mPool(parent ? ((oct_node*)parent)->mPool : nullptr)
     {
         llassert(size[0] >= gOctreeMinSize*0.5f);
 
@@ -146,7 +148,7 @@ public:
 
         for (U32 i = 0; i < getChildCount(); i++)
         {
-            delete getChild(i);
+            deleteNode(getChild(i));
         }
     }
 
@@ -158,6 +160,16 @@ public:
     inline void setSize(const LLVector4a& size)         { mSize = size; }
     inline oct_node* getNodeAt(T* data)                 { return getNodeAt(data->getPositionGroup(), data->getBinRadius()); }
     inline U8 getOctant() const                         { return mOctant; }
+
+    // Allocate the nodes of this (still empty) tree from pool rather than
+    // the heap.  pool blocks must fit an oct_node and pool must outlive
+    // every node but this one, which is allocated by the caller.
+    void setPool(LLSlabPool* pool)
+    {
+        llassert(getChildCount() == 0);
+        llassert(!pool || pool->getBlockSize() >= sizeof(oct_node));
+        mPool = pool;
+    }
     inline const oct_node*  getOctParent() const        { return (const oct_node*) getParent(); }
     inline oct_node* getOctParent()                     { return (oct_node*) getParent(); }
 
@@ -418,7 +430,7 @@ public:
 
                 llassert(size[0] >= gOctreeMinSize*0.5f);
                 //make the new kid
-                child = new oct_node(center, size, this);
+                child = createChild(center, size);
                 addChild(child);
 
                 child->insert(data);
@@ -575,7 +587,7 @@ public:
         for (U32 i = 0; i < getChildCount(); i++)
         {
             mChild[i]->destroy();
-            delete mChild[i];
+            deleteNode(mChild[i]);
         }
     }
 
@@ -637,7 +649,7 @@ public:
         if (destroy)
         {
             mChild[index]->destroy();
-            delete mChild[index];
+            deleteNode(mChild[index]);
         }
 
         --mChildCount;
@@ -682,6 +694,28 @@ public:
     }
 
 protected:
+    oct_node* createChild(const LLVector4a& center, const LLVector4a& size)
+    {
+        if (mPool)
+        {
+            return ::new (mPool->allocate()) oct_node(center, size, this);
+        }
+        return new oct_node(center, size, this);
+    }
+
+    static void deleteNode(oct_node* node)
+    {
+        if (LLSlabPool* pool = node->mPool)
+        {
+            node->~LLOctreeNode();
+            pool->free(node);
+        }
+        else
+        {
+            delete node;
+        }
+    }
+
     typedef enum
     {
         CENTER = 0,
@@ -697,6 +731,7 @@ protected:
 
     oct_node* mParent;
     U8 mOctant;
+    LLSlabPool* mPool;
 
     oct_node* mChild[8];
     U8 mChildMap[8];
@@ -747,7 +782,7 @@ public:
 
             //destroy child
             child->clearChildren();
-            delete child;
+            oct_node::deleteNode(child);
 
             return false;
         }
@@ -840,7 +875,7 @@ public:
                 llassert(size[0] >= gOctreeMinSize);
 
                 //copy our children to a new branch
-                oct_node* newnode = new oct_node(center, size, this);
+                oct_node* newnode = this->createChild(center, size);
 
                 for (U32 i = 0; i < this->getChildCount(); i++)
                 {
@@ -52,6 +52,7 @@
 #include "llmeshoptimizer.h"
 #include "lltimer.h"
 #include "llvolumeoctree.h"
+#include "llvolumebvh.h"
 
 #include "mikktspace/mikktspace.hh"
 
@@ -370,6 +371,146 @@ bool LLTriangleRayIntersectTwoSided(const LLVector4a& vert0, const LLVector4a& v
     return true;
 }
 
+void LLTrianglePacket4::clear()
+{
+    for (U32 i = 0; i < 3; ++i)
+    {
+        mVert0[i].clear();
+        mEdge1[i].clear();
+        mEdge2[i].clear();
+    }
+}
+
+void LLTrianglePacket4::setTriangle(U32 lane, const LLVector4a& vert0, const LLVector4a& vert1, const LLVector4a& vert2)
+{
+    llassert(lane < 4);
+
+    LLVector4a edge1;
+    edge1.setSub(vert1, vert0);
+    LLVector4a edge2;
+    edge2.setSub(vert2, vert0);
+
+    for (U32 i = 0; i < 3; ++i)
+    {
+        mVert0[i].getF32ptr()[lane] = vert0[i];
+        mEdge1[i].getF32ptr()[lane] = edge1[i];
+        mEdge2[i].getF32ptr()[lane] = edge2[i];
+    }
+}
+
+// Moller-Trumbore as in LLTriangleRayIntersect(), with one triangle per lane
+U32 LLTriangleRayIntersect4(const LLTrianglePacket4& packet, const LLVector4a& orig, const LLVector4a& dir,
+                            LLVector4a& intersection_a, LLVector4a& intersection_b, LLVector4a& intersection_t)
+{
+    LLVector4a dx, dy, dz;
+    dx.splat(dir, 0);
+    dy.splat(dir, 1);
+    dz.splat(dir, 2);
+
+    const LLVector4a* e1 = packet.mEdge1;
+    const LLVector4a* e2 = packet.mEdge2;
+
+    LLVector4a tmp;
+
+    /* pvec = dir x edge2 */
+    LLVector4a px, py, pz;
+    px.setMul(dy, e2[2]);
+    tmp.setMul(dz, e2[1]);
+    px.sub(tmp);
+    py.setMul(dz, e2[0]);
+    tmp.setMul(dx, e2[2]);
+    py.sub(tmp);
+    pz.setMul(dx, e2[1]);
+    tmp.setMul(dy, e2[0]);
+    pz.sub(tmp);
+
+    /* det = edge1 . pvec */
+    LLVector4a det;
+    det.setMul(e1[0], px);
+    tmp.setMul(e1[1], py);
+    det.add(tmp);
+    tmp.setMul(e1[2], pz);
+    det.add(tmp);
+
+    U32 mask = det.greaterEqual(LLVector4a::getEpsilon()).getGatheredBits();
+    if (!mask)
+    {
+        return 0;
+    }
+
+    /* tvec = orig - vert0 */
+    LLVector4a tx, ty, tz;
+    tx.splat(orig, 0);
+    tx.sub(packet.mVert0[0]);
+    ty.splat(orig, 1);
+    ty.sub(packet.mVert0[1]);
+    tz.splat(orig, 2);
+    tz.sub(packet.mVert0[2]);
+
+    /* u = tvec . pvec */
+    LLVector4a u;
+    u.setMul(tx, px);
+    tmp.setMul(ty, py);
+    u.add(tmp);
+    tmp.setMul(tz, pz);
+    u.add(tmp);
+
+    mask &= u.greaterEqual(LLVector4a::getZero()).getGatheredBits();
+    mask &= u.lessEqual(det).getGatheredBits();
+    if (!mask)
+    {
+        return 0;
+    }
+
+    /* qvec = tvec x edge1 */
+    LLVector4a qx, qy, qz;
+    qx.setMul(ty, e1[2]);
+    tmp.setMul(tz, e1[1]);
+    qx.sub(tmp);
+    qy.setMul(tz, e1[0]);
+    tmp.setMul(tx, e1[2]);
+    qy.sub(tmp);
+    qz.setMul(tx, e1[1]);
+    tmp.setMul(ty, e1[0]);
+    qz.sub(tmp);
+
+    /* v = dir . qvec */
+    LLVector4a v;
+    v.setMul(dx, qx);
+    tmp.setMul(dy, qy);
+    v.add(tmp);
+    tmp.setMul(dz, qz);
+    v.add(tmp);
+
+    LLVector4a sum_uv;
+    sum_uv.setAdd(u, v);
+
+    mask &= v.greaterEqual(LLVector4a::getZero()).getGatheredBits();
+    mask &= sum_uv.lessEqual(det).getGatheredBits();
+    if (!mask)
+    {
+        return 0;
+    }
+
+    /* t = edge2 . qvec */
+    LLVector4a t;
+    t.setMul(e2[0], qx);
+    tmp.setMul(e2[1], qy);
+    t.add(tmp);
+    tmp.setMul(e2[2], qz);
+    t.add(tmp);
+
+    // lanes that missed may have a zero determinant, divide those by one instead
+    LLVector4a safe_det;
+    safe_det.setSelectWithMask(det.greaterEqual(LLVector4a::getEpsilon()), det, LLVector4a(1.f));
+
+    intersection_a.setDiv(u, safe_det);
+    intersection_b.setDiv(v, safe_det);
+    intersection_t.setDiv(t, safe_det);
+
+    return mask;
+}
+
 //-------------------------------------------------------------------
 // statics
 //-------------------------------------------------------------------
@@ -1969,6 +2110,8 @@ LLProfile::~LLProfile()
 
 
 S32 LLVolume::sNumMeshPoints = 0;
+U32 LLVolumeFace::sMeshletMinTriangles = 0;
+bool LLVolumeFace::sUseBVH = false;
 
 LLVolume::LLVolume(const LLVolumeParams &params, const F32 detail, const bool generate_single_face, const bool is_unique)
     : mParams(params)
@@ -2091,8 +2234,8 @@ bool LLVolume::generate()
         }
     }
 
-    bool regenPath = mPathp->generate(mParams.getPathParams(), path_detail, split);
-    bool regenProf = mProfilep->generate(mParams.getProfileParams(), mPathp->isOpen(),profile_detail, split);
+    bool regenPath = LLVolumeShapeCache::generatePath(*mPathp, mParams.getPathParams(), path_detail, split);
+    bool regenProf = LLVolumeShapeCache::generateProfile(*mProfilep, mParams.getProfileParams(), mPathp->isOpen(), profile_detail, split);
 
     if (regenPath || regenProf )
     {
@@ -2729,6 +2872,209 @@ bool LLVolume::unpackVolumeFacesInternal(const LLSD& mdl)
     return true;
 }
 
+namespace
+{
+    constexpr U32 OPTIMIZED_FACES_MAGIC = 0x46564c4c; // "LLVF" when little endian
+    constexpr U32 OPTIMIZED_FACES_VERSION = 2;
+
+    enum
+    {
+        OPTIMIZED_FACE_TANGENTS = 0x1,
+        OPTIMIZED_FACE_WEIGHTS = 0x2
+    };
+
+    struct OptimizedFacesHeader
+    {
+        U32 mMagic;
+        U32 mVersion;
+        U32 mFaceCount;
+    };
+
+    struct OptimizedFaceHeader
+    {
+        S32 mNumVertices;
+        S32 mNumIndices;
+        S32 mNumMeshlets;
+        U32 mFlags;
+        F32 mNormalizedScale[3];
+        F32 mExtents[12];           // min, max, center
+        F32 mTexCoordExtents[4];
+    };
+
+    // positions and normals, then texture coordinates padded to 16 bytes,
+    // the layout of LLVolumeFace::resizeVertices()
+    S32 vertex_block_size(S32 num_verts)
+    {
+        return (S32)sizeof(LLVector4a) * 2 * num_verts + ((num_verts * (S32)sizeof(LLVector2) + 0xF) & ~0xF);
+    }
+
+    void append_bytes(std::vector<U8>& out, const void* data, size_t size)
+    {
+        const U8* bytes = (const U8*)data;
+        out.insert(out.end(), bytes, bytes + size);
+    }
+
+    bool read_bytes(const U8*& cur, const U8* end, void* dst, size_t size)
+    {
+        if ((size_t)(end - cur) < size)
+        {
+            return false;
+        }
+        memcpy(dst, cur, size);
+        cur += size;
+        return true;
+    }
+}
+
+bool LLVolume::packOptimizedFaces(std::vector<U8>& out) const
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_VOLUME;
+
+    size_t total = sizeof(OptimizedFacesHeader);
+    for (const LLVolumeFace& face : mVolumeFaces)
+    {
+        if (!face.mOptimized)
+        {
+            return false;
+        }
+        total += sizeof(OptimizedFaceHeader) + vertex_block_size(face.mNumVertices)
+            + (face.mTangents ? sizeof(LLVector4a) * face.mNumVertices : 0)
+            + (face.mWeights ? sizeof(LLVector4a) * face.mNumVertices : 0)
+            + sizeof(U16) * face.mNumIndices
+            + (face.mMeshlets ? sizeof(LLMeshOptimizer::Meshlet) * face.mMeshlets->size() : 0);
+    }
+
+    out.clear();
+    out.reserve(total);
+
+    OptimizedFacesHeader header = { OPTIMIZED_FACES_MAGIC, OPTIMIZED_FACES_VERSION, (U32)mVolumeFaces.size() };
+    append_bytes(out, &header, sizeof(header));
+
+    for (const LLVolumeFace& face : mVolumeFaces)
+    {
+        OptimizedFaceHeader face_header;
+        face_header.mNumVertices = face.mNumVertices;
+        face_header.mNumIndices = face.mNumIndices;
+        face_header.mNumMeshlets = face.mMeshlets ? (S32)face.mMeshlets->size() : 0;
+        face_header.mFlags = (face.mTangents ? OPTIMIZED_FACE_TANGENTS : 0) | (face.mWeights ? OPTIMIZED_FACE_WEIGHTS : 0);
+        memcpy(face_header.mNormalizedScale, face.mNormalizedScale.mV, sizeof(face_header.mNormalizedScale));
+        memcpy(face_header.mExtents, face.mExtents, sizeof(face_header.mExtents));
+        memcpy(face_header.mTexCoordExtents, face.mTexCoordExtents, sizeof(face_header.mTexCoordExtents));
+        append_bytes(out, &face_header, sizeof(face_header));
+
+        if (face.mNumVertices > 0)
+        {
+            append_bytes(out, face.mPositions, vertex_block_size(face.mNumVertices));
+            if (face.mTangents)
+            {
+                append_bytes(out, face.mTangents, sizeof(LLVector4a) * face.mNumVertices);
+            }
+            if (face.mWeights)
+            {
+                append_bytes(out, face.mWeights, sizeof(LLVector4a) * face.mNumVertices);
+            }
+        }
+        if (face.mNumIndices > 0)
+        {
+            append_bytes(out, face.mIndices, sizeof(U16) * face.mNumIndices);
+        }
+        if (face_header.mNumMeshlets > 0)
+        {
+            append_bytes(out, face.mMeshlets->data(), sizeof(LLMeshOptimizer::Meshlet) * face_header.mNumMeshlets);
+        }
+    }
+
+    return true;
+}
+
+bool LLVolume::unpackOptimizedFaces(const U8* data, S32 size)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_VOLUME;
+
+    const U8* cur = data;
+    const U8* end = data + size;
+
+    OptimizedFacesHeader header;
+    if (!data
+        || !read_bytes(cur, end, &header, sizeof(header))
+        || header.mMagic != OPTIMIZED_FACES_MAGIC
+        || header.mVersion != OPTIMIZED_FACES_VERSION
+        || header.mFaceCount == 0
+        || header.mFaceCount > LL_SCULPT_MESH_MAX_FACES)
+    {
+        return false;
+    }
+
+    mVolumeFaces.clear();
+    mVolumeFaces.resize(header.mFaceCount);
+
+    bool ok = true;
+    for (LLVolumeFace& face : mVolumeFaces)
+    {
+        OptimizedFaceHeader face_header;
+        if (!read_bytes(cur, end, &face_header, sizeof(face_header))
+            || face_header.mNumVertices < 0 || face_header.mNumVertices > 65536
+            || face_header.mNumIndices < 0 || face_header.mNumIndices % 3 != 0
+            || face_header.mNumMeshlets < 0 || face_header.mNumMeshlets > face_header.mNumIndices / 3)
+        {
+            ok = false;
+            break;
+        }
+
+        S32 num_verts = face_header.mNumVertices;
+        face.resizeVertices(num_verts);
+        face.resizeIndices(face_header.mNumIndices);
+        if (face.mNumVertices != num_verts || face.mNumIndices != face_header.mNumIndices)
+        {
+            // out of memory
+            ok = false;
+            break;
+        }
+
+        if (num_verts > 0)
+        {
+            ok = read_bytes(cur, end, face.mPositions, vertex_block_size(num_verts));
+            if (ok && (face_header.mFlags & OPTIMIZED_FACE_TANGENTS))
+            {
+                face.allocateTangents(num_verts);
+                ok = face.mTangents && read_bytes(cur, end, face.mTangents, sizeof(LLVector4a) * num_verts);
+            }
+            if (ok && (face_header.mFlags & OPTIMIZED_FACE_WEIGHTS))
+            {
+                face.allocateWeights(num_verts);
+                ok = face.mWeights && read_bytes(cur, end, face.mWeights, sizeof(LLVector4a) * num_verts);
+            }
+        }
+        if (ok && face.mNumIndices > 0)
+        {
+            ok = read_bytes(cur, end, face.mIndices, sizeof(U16) * face.mNumIndices);
+        }
+        if (ok && face_header.mNumMeshlets > 0)
+        {
+            auto meshlets = std::make_shared<LLVolumeFace::meshlet_list_t>(face_header.mNumMeshlets);
+            ok = read_bytes(cur, end, meshlets->data(), sizeof(LLMeshOptimizer::Meshlet) * face_header.mNumMeshlets);
+            face.mMeshlets = meshlets;
+        }
+        if (!ok)
+        {
+            break;
+        }
+
+        face.mNormalizedScale.set(face_header.mNormalizedScale);
+        memcpy(face.mExtents, face_header.mExtents, sizeof(face_header.mExtents));
+        memcpy(face.mTexCoordExtents, face_header.mTexCoordExtents, sizeof(face_header.mTexCoordExtents));
+        face.mOptimized = true;
+    }
+
+    if (!ok || cur != end)
+    {
+        mVolumeFaces.clear();
+        return false;
+    }
+
+    mSculptLevel = 0;  // success!
+    return true;
+}
 
 bool LLVolume::isMeshAssetLoaded()
 {
@@ -4046,6 +4392,19 @@ void LLVolume::generateSilhouetteVertices(std::vector<LLVector3> &vertices,
     }
 }
 
+S32 LLVolume::destroyIdleOctrees(F64 idle_since)
+{
+    S32 count = 0;
+    for (LLVolumeFace& face : mVolumeFaces)
+    {
+        if (face.destroyIdleOctree(idle_since))
+        {
+            ++count;
+        }
+    }
+    return count;
+}
+
 S32 LLVolume::lineSegmentIntersect(const LLVector4a& start, const LLVector4a& end,
                                    S32 face,
                                    LLVector4a* intersection,LLVector2* tex_coord, LLVector4a* normal, LLVector4a* tangent_out)
@@ -4178,15 +4537,17 @@ S32 LLVolume::lineSegmentIntersect(const LLVector4a& start, const LLVector4a& en
                     }
                 }
             }
-            else
+            else if (LLVolumeFace::sUseBVH)
             {
-                if (!face.getOctree())
+                if (face.useBVH()->lineSegmentIntersect(start, dir, face, &closest_t, intersection, tex_coord, normal, tangent_out))
                 {
-                    face.createOctree();
+                    hit_face = i;
                 }
-
+            }
+            else
+            {
                 LLOctreeTriangleRayIntersect intersect(start, dir, &face, &closest_t, intersection, tex_coord, normal, tangent_out);
-                intersect.traverse(face.getOctree());
+                intersect.traverse(face.useOctree());
                 if (intersect.mHitFace)
                 {
                     hit_face = i;
@@ -4877,6 +5238,7 @@ LLVolumeFace& LLVolumeFace::operator=(const LLVolumeFace& src)
 
     mOptimized = src.mOptimized;
     mNormalizedScale = src.mNormalizedScale;
+    mMeshlets = src.mMeshlets;
 
     //delete
     return *this;
@@ -4902,6 +5264,7 @@ void LLVolumeFace::freeData()
 
     ll_aligned_free_16(mIndices);
     mIndices = NULL;
+    mMeshlets.reset();
     ll_aligned_free_16(mTangents);
     mTangents = NULL;
     ll_aligned_free_16(mWeights);
@@ -4915,6 +5278,7 @@ void LLVolumeFace::freeData()
 #endif
 
     destroyOctree();
+    destroyBVH();
 }
 
 bool LLVolumeFace::create(LLVolume* volume, bool partial_build)
@@ -4923,6 +5287,7 @@ bool LLVolumeFace::create(LLVolume* volume, bool partial_build)
 
     //tree for this face is no longer valid
     destroyOctree();
+    destroyBVH();
 
     LL_CHECK_MEMORY
     bool ret = false ;
@@ -5593,6 +5958,17 @@ bool LLVolumeFace::cacheOptimize(bool gen_tangents)
 
     ll_aligned_free_16(src_indices);
 
+    // regroup dense faces into meshlets the renderer can cull, the
+    // clustering keeps most of the vertex cache order within each meshlet
+    if (sMeshletMinTriangles > 0 && (U32)mNumIndices / 3 >= sMeshletMinTriangles)
+    {
+        auto meshlets = std::make_shared<meshlet_list_t>();
+        if (LLMeshOptimizer::buildMeshletsU16(mIndices, mNumIndices, mPositions, mNumVertices, *meshlets))
+        {
+            mMeshlets = meshlets;
+        }
+    }
+
     return true;
 }
 
@@ -5694,6 +6070,49 @@ const LLVolumeOctree* LLVolumeFace::getOctree() const
     return mOctree;
 }
 
+const LLVolumeOctree* LLVolumeFace::useOctree()
+{
+    if (!mOctree)
+    {
+        createOctree();
+    }
+    mOctreeLastUsed = LLTimer::getTotalSeconds();
+    return mOctree;
+}
+
+bool LLVolumeFace::destroyIdleOctree(F64 idle_since)
+{
+    bool destroyed = false;
+    if (mOctree && mOctreeLastUsed < idle_since)
+    {
+        destroyOctree();
+        destroyed = true;
+    }
+    if (mBVH && mBVHLastUsed < idle_since)
+    {
+        destroyBVH();
+        destroyed = true;
+    }
+    return destroyed;
+}
+
+const LLVolumeBVH* LLVolumeFace::useBVH()
+{
+    if (!mBVH)
+    {
+        mBVH = new LLVolumeBVH();
+        mBVH->build(*this);
+    }
+    mBVHLastUsed = LLTimer::getTotalSeconds();
+    return mBVH;
+}
+
+void LLVolumeFace::destroyBVH()
+{
+    delete mBVH;
+    mBVH = nullptr;
+}
+
 
 void LLVolumeFace::swapData(LLVolumeFace& rhs)
 {
@@ -5704,6 +6123,7 @@ void LLVolumeFace::swapData(LLVolumeFace& rhs)
     llswap(rhs.mIndices,mIndices);
     llswap(rhs.mNumVertices, mNumVertices);
     llswap(rhs.mNumIndices, mNumIndices);
+    llswap(rhs.mMeshlets, mMeshlets);
 }
 
 void    LerpPlanarVertex(LLVolumeFace::VertexData& v0,
@@ -6558,6 +6978,7 @@ void LLVolumeFace::allocateJointIndices(S32 num_verts)
 void LLVolumeFace::resizeIndices(S32 num_indices)
 {
     ll_aligned_free_16(mIndices);
+    mMeshlets.reset();
     llassert(num_indices % 3 == 0);
 
     if (num_indices)
@@ -42,6 +42,7 @@ class LLVolumeFace;
 class LLVolume;
 class LLVolumeTriangle;
 class LLVolumeOctree;
+class LLVolumeBVH;
 
 #include "lluuid.h"
 #include "v4color.h"
@@ -60,6 +61,7 @@ class LLVolumeOctree;
 #include "llfile.h"
 #include "llalignedarray.h"
 #include "llrigginginfo.h"
+#include "llmeshoptimizer.h"
 
 //============================================================================
 
@@ -690,6 +692,7 @@ protected:
 class LLProfile
 {
     friend class LLVolume;
+    friend class LLVolumeShapeCache;
 
 public:
     LLProfile()
@@ -757,6 +760,8 @@ protected:
 
 class LLPath
 {
+    friend class LLVolumeShapeCache;
+
 public:
     class PathPt
     {
@@ -920,6 +925,21 @@ public:
     void destroyOctree();
     // Get a reference to the octree, which may be null
     const LLVolumeOctree* getOctree() const;
+    // Get the octree for a raycast, building it on first use.  Octrees
+    // are only needed for picking, so they are built lazily and dropped
+    // again by destroyIdleOctree() once unused for a while.
+    const LLVolumeOctree* useOctree();
+    // Destroy the octree and BVH if they weren't used since idle_since
+    // (LLTimer::getTotalSeconds()), returns true if either was destroyed
+    bool destroyIdleOctree(F64 idle_since);
+
+    // Flattened BVH alternative to the octree, used by
+    // LLVolume::lineSegmentIntersect() when sUseBVH is set.  Built lazily
+    // and freed with the octree.
+    const LLVolumeBVH* useBVH();
+    void destroyBVH();
+    const LLVolumeBVH* getBVH() const { return mBVH; }
+    static bool sUseBVH;
 
     enum
     {
@@ -987,6 +1007,14 @@ public:
     //whether or not face has been cache optimized
     bool mOptimized;
 
+    // Clusters of mIndices with bounds and normal cones for culling,
+    // built by cacheOptimize() for faces of at least sMeshletMinTriangles
+    // triangles (0 disables).  Shared between copies, reset whenever the
+    // index buffer is reallocated.
+    typedef std::vector<LLMeshOptimizer::Meshlet> meshlet_list_t;
+    std::shared_ptr<const meshlet_list_t> mMeshlets;
+    static U32 sMeshletMinTriangles;
+
     // if this is a mesh asset, scale and translation that were applied
     // when encoding the source mesh into a unit cube
     // used for regenerating tangents
@@ -995,6 +1023,9 @@ public:
 private:
     LLVolumeOctree* mOctree;
     LLVolumeTriangle* mOctreeTriangles;
+    F64 mOctreeLastUsed = 0.0;
+    LLVolumeBVH* mBVH = nullptr;
+    F64 mBVHLastUsed = 0.0;
 
     bool createUnCutCubeCap(LLVolume* volume, bool partial_build = false);
     bool createCap(LLVolume* volume, bool partial_build = false);
@@ -1077,6 +1108,10 @@ public:
                              LLVector4a* tangent = nullptr           // return the surface tangent at the intersection point
         );
 
+    // Destroy face octrees not raycast against since idle_since, returns
+    // the number destroyed
+    S32 destroyIdleOctrees(F64 idle_since);
+
     LLFaceID generateFaceMask();
 
     bool isFaceMaskValid(LLFaceID face_mask);
@@ -1120,6 +1155,15 @@ protected:
 public:
     bool unpackVolumeFaces(std::istream& is, S32 size);
     bool unpackVolumeFaces(U8* in_data, S32 size);
+
+    // Binary image of cache optimized faces: vertex block, tangents,
+    // weights, indices and bounds, in host byte order.  Restoring it
+    // skips the inflate, LLSD parse, tangent generation and index
+    // optimization of unpackVolumeFaces().  packOptimizedFaces() fails
+    // if any face isn't optimized; unpackOptimizedFaces() fails on a
+    // version or byte order mismatch or truncated data.
+    bool packOptimizedFaces(std::vector<U8>& out) const;
+    bool unpackOptimizedFaces(const U8* data, S32 size);
 private:
     bool unpackVolumeFacesInternal(const LLSD& mdl);
 
@@ -1169,4 +1213,27 @@ bool LLTriangleRayIntersect(const LLVector4a& vert0, const LLVector4a& vert1, co
 bool LLTriangleRayIntersectTwoSided(const LLVector4a& vert0, const LLVector4a& vert1, const LLVector4a& vert2, const LLVector4a& orig, const LLVector4a& dir,
                             F32& intersection_a, F32& intersection_b, F32& intersection_t);
 
+// Four triangles in SoA layout for LLTriangleRayIntersect4():  lane i of
+// each vector holds an x, y or z of triangle i.  Unset lanes are
+// degenerate and never hit.
+class alignas(16) LLTrianglePacket4
+{
+public:
+    LLTrianglePacket4() { clear(); }
+
+    void clear();
+    void setTriangle(U32 lane, const LLVector4a& vert0, const LLVector4a& vert1, const LLVector4a& vert2);
+
+    LLVector4a mVert0[3];
+    LLVector4a mEdge1[3];   // vert1 - vert0
+    LLVector4a mEdge2[3];   // vert2 - vert0
+};
+
+// LLTriangleRayIntersect() against all four triangles of packet at once.
+// Returns a mask with bit i set if triangle i is hit, in which case lane i
+// of intersection_a/b/t holds its barycentric coordinates and distance
+// along dir.
+U32 LLTriangleRayIntersect4(const LLTrianglePacket4& packet, const LLVector4a& orig, const LLVector4a& dir,
+                            LLVector4a& intersection_a, LLVector4a& intersection_b, LLVector4a& intersection_t);
+
 #endif
@@ -0,0 +1,505 @@
+/**
+ * @file llvolumebvh.cpp
+ * @brief Flattened bounding volume hierarchy for LLVolumeFace raycasts
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+#include "llmath.h"
+
+#include "llvolumebvh.h"
+
+#include "v2math.h"
+
+#include <algorithm>
+#include <future>
+
+U32 LLVolumeBVH::sParallelBuildMinTriangles = 16384;
+
+namespace
+{
+    constexpr U32 LEAF_SIZE = 4;        // one LLTrianglePacket4
+    constexpr U32 SAH_BINS = 16;
+    constexpr U32 MAX_SAH_DEPTH = 48;   // below this, split at the median to bound the depth
+    constexpr U32 MAX_PARALLEL_DEPTH = 3;
+    constexpr U32 STACK_SIZE = 128;
+
+    struct alignas(16) TriangleRef
+    {
+        LLVector4a mMin;
+        LLVector4a mMax;
+        LLVector4a mCentroid;
+        U32 mTriangle;
+    };
+
+    // Half the surface area of the box min .. max
+    F32 half_area(const LLVector4a& min, const LLVector4a& max)
+    {
+        LLVector4a size;
+        size.setSub(max, min);
+        return size[0] * size[1] + size[1] * size[2] + size[2] * size[0];
+    }
+
+    struct Bin
+    {
+        LLVector4a mMin;
+        LLVector4a mMax;
+        U32 mCount = 0;
+
+        void add(const TriangleRef& ref)
+        {
+            if (mCount++ == 0)
+            {
+                mMin = ref.mMin;
+                mMax = ref.mMax;
+            }
+            else
+            {
+                mMin.setMin(mMin, ref.mMin);
+                mMax.setMax(mMax, ref.mMax);
+            }
+        }
+
+        void add(const Bin& bin)
+        {
+            if (bin.mCount == 0)
+            {
+                return;
+            }
+            if (mCount == 0)
+            {
+                mMin = bin.mMin;
+                mMax = bin.mMax;
+            }
+            else
+            {
+                mMin.setMin(mMin, bin.mMin);
+                mMax.setMax(mMax, bin.mMax);
+            }
+            mCount += bin.mCount;
+        }
+    };
+}
+
+class LLVolumeBVH::Builder
+{
+public:
+    Builder(const LLVolumeFace& face, std::vector<TriangleRef>& refs)
+    :   mFace(face),
+        mRefs(refs)
+    {
+    }
+
+    U32 buildNode(U32 begin, U32 end, U32 depth);
+
+    // Append the nodes of a subtree built by another Builder
+    void splice(const Builder& subtree);
+
+    const LLVolumeFace& mFace;
+    std::vector<TriangleRef>& mRefs;
+    std::vector<Node> mNodes;
+    std::vector<LLTrianglePacket4> mPackets;
+    std::vector<U32> mTriangles;
+    U32 mDepth = 0;
+
+private:
+    // Returns the first index of the second half, begin or end if no
+    // split beats a leaf
+    U32 splitSAH(U32 begin, U32 end, const LLVector4a& centroid_min, const LLVector4a& centroid_max, U32& axis);
+    void makeLeaf(Node& node, U32 begin, U32 end);
+};
+
+U32 LLVolumeBVH::Builder::buildNode(U32 begin, U32 end, U32 depth)
+{
+    U32 index = (U32)mNodes.size();
+    mNodes.emplace_back();
+    mDepth = llmax(mDepth, depth + 1);
+
+    LLVector4a min = mRefs[begin].mMin;
+    LLVector4a max = mRefs[begin].mMax;
+    LLVector4a centroid_min = mRefs[begin].mCentroid;
+    LLVector4a centroid_max = centroid_min;
+    for (U32 i = begin + 1; i < end; ++i)
+    {
+        min.setMin(min, mRefs[i].mMin);
+        max.setMax(max, mRefs[i].mMax);
+        centroid_min.setMin(centroid_min, mRefs[i].mCentroid);
+        centroid_max.setMax(centroid_max, mRefs[i].mCentroid);
+    }
+    mNodes[index].mExtents[0] = min;
+    mNodes[index].mExtents[1] = max;
+
+    if (end - begin <= LEAF_SIZE)
+    {
+        makeLeaf(mNodes[index], begin, end);
+        return index;
+    }
+
+    U32 axis = 0;
+    U32 mid = begin;
+    if (depth < MAX_SAH_DEPTH)
+    {
+        mid = splitSAH(begin, end, centroid_min, centroid_max, axis);
+    }
+    if (mid == begin || mid == end)
+    { // no useful SAH split (coincident centroids or too deep), split at the median of the widest axis
+        LLVector4a extent;
+        extent.setSub(centroid_max, centroid_min);
+        axis = (extent[0] >= extent[1] && extent[0] >= extent[2]) ? 0 : (extent[1] >= extent[2] ? 1 : 2);
+        mid = begin + (end - begin) / 2;
+        std::nth_element(mRefs.begin() + begin, mRefs.begin() + mid, mRefs.begin() + end,
+                         [axis](const TriangleRef& a, const TriangleRef& b) { return a.mCentroid[axis] < b.mCentroid[axis]; });
+    }
+    mNodes[index].mCount = 0;
+    mNodes[index].mAxis = axis;
+
+    if (depth < MAX_PARALLEL_DEPTH && end - mid >= LLVolumeBVH::sParallelBuildMinTriangles / 2)
+    { // build the second child on another thread while this one builds the first
+        Builder subtree(mFace, mRefs);
+        std::future<void> result = std::async(std::launch::async, [&subtree, mid, end, depth]()
+            {
+                subtree.buildNode(mid, end, depth + 1);
+            });
+        buildNode(begin, mid, depth + 1);
+        result.get();
+        mNodes[index].mFirst = (U32)mNodes.size();
+        splice(subtree);
+    }
+    else
+    {
+        buildNode(begin, mid, depth + 1);
+        mNodes[index].mFirst = (U32)mNodes.size();
+        buildNode(mid, end, depth + 1);
+    }
+
+    return index;
+}
+
+U32 LLVolumeBVH::Builder::splitSAH(U32 begin, U32 end, const LLVector4a& centroid_min, const LLVector4a& centroid_max, U32& axis)
+{
+    LLVector4a extent;
+    extent.setSub(centroid_max, centroid_min);
+
+    // a leaf costs one packet test per four triangles
+    F32 best_cost = half_area(mNodes.back().mExtents[0], mNodes.back().mExtents[1]) * (F32)((end - begin + LEAF_SIZE - 1) / LEAF_SIZE);
+    U32 best_axis = 3;
+    U32 best_bin = 0;
+
+    for (U32 a = 0; a < 3; ++a)
+    {
+        if (extent[a] <= F_APPROXIMATELY_ZERO)
+        {
+            continue;
+        }
+
+        Bin bins[SAH_BINS];
+        const F32 scale = (F32)SAH_BINS / extent[a];
+        for (U32 i = begin; i < end; ++i)
+        {
+            U32 bin = llmin((U32)((mRefs[i].mCentroid[a] - centroid_min[a]) * scale), SAH_BINS - 1);
+            bins[bin].add(mRefs[i]);
+        }
+
+        // sweep from the right to get the cost of everything above each split
+        F32 right_cost[SAH_BINS];
+        Bin right;
+        for (U32 i = SAH_BINS - 1; i > 0; --i)
+        {
+            right.add(bins[i]);
+            right_cost[i] = right.mCount ? half_area(right.mMin, right.mMax) * (F32)((right.mCount + LEAF_SIZE - 1) / LEAF_SIZE) : 0.f;
+        }
+
+        Bin left;
+        for (U32 i = 0; i < SAH_BINS - 1; ++i)
+        {
+            left.add(bins[i]);
+            if (left.mCount == 0 || left.mCount == end - begin)
+            {
+                continue;
+            }
+            F32 cost = half_area(left.mMin, left.mMax) * (F32)((left.mCount + LEAF_SIZE - 1) / LEAF_SIZE) + right_cost[i + 1];
+            if (cost < best_cost)
+            {
+                best_cost = cost;
+                best_axis = a;
+                best_bin = i;
+            }
+        }
+    }
+
+    if (best_axis == 3)
+    {
+        return begin;
+    }
+
+    axis = best_axis;
+    const F32 scale = (F32)SAH_BINS / extent[axis];
+    const F32 origin = centroid_min[axis];
+    auto first_right = std::partition(mRefs.begin() + begin, mRefs.begin() + end,
+        [=](const TriangleRef& ref)
+        {
+            return llmin((U32)((ref.mCentroid[axis] - origin) * scale), SAH_BINS - 1) <= best_bin;
+        });
+    return (U32)(first_right - mRefs.begin());
+}
+
+void LLVolumeBVH::Builder::makeLeaf(Node& node, U32 begin, U32 end)
+{
+    node.mFirst = (U32)mPackets.size();
+    node.mCount = end - begin;
+    node.mAxis = 0;
+
+    LLTrianglePacket4& packet = mPackets.emplace_back();
+    for (U32 lane = 0; lane < LEAF_SIZE; ++lane)
+    {
+        if (begin + lane < end)
+        {
+            U32 tri = mRefs[begin + lane].mTriangle;
+            const U16* idx = mFace.mIndices + tri * 3;
+            packet.setTriangle(lane, mFace.mPositions[idx[0]], mFace.mPositions[idx[1]], mFace.mPositions[idx[2]]);
+            mTriangles.push_back(tri);
+        }
+        else
+        {
+            mTriangles.push_back(0);
+        }
+    }
+}
+
+void LLVolumeBVH::Builder::splice(const Builder& subtree)
+{
+    const U32 node_offset = (U32)mNodes.size();
+    const U32 packet_offset = (U32)mPackets.size();
+
+    for (const Node& node : subtree.mNodes)
+    {
+        Node& copy = mNodes.emplace_back(node);
+        copy.mFirst += copy.mCount ? packet_offset : node_offset;
+    }
+    mPackets.insert(mPackets.end(), subtree.mPackets.begin(), subtree.mPackets.end());
+    mTriangles.insert(mTriangles.end(), subtree.mTriangles.begin(), subtree.mTriangles.end());
+    mDepth = llmax(mDepth, subtree.mDepth);
+}
+
+void LLVolumeBVH::build(const LLVolumeFace& face)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_VOLUME;
+
+    mNodes.clear();
+    mPackets.clear();
+    mTriangles.clear();
+    mDepth = 0;
+
+    const U32 num_triangles = face.mNumIndices / 3;
+    if (num_triangles == 0)
+    {
+        return;
+    }
+
+    std::vector<TriangleRef> refs(num_triangles);
+    for (U32 i = 0; i < num_triangles; ++i)
+    {
+        const U16* idx = face.mIndices + i * 3;
+        const LLVector4a& v0 = face.mPositions[idx[0]];
+        const LLVector4a& v1 = face.mPositions[idx[1]];
+        const LLVector4a& v2 = face.mPositions[idx[2]];
+
+        TriangleRef& ref = refs[i];
+        ref.mMin.setMin(v0, v1);
+        ref.mMin.setMin(ref.mMin, v2);
+        ref.mMax.setMax(v0, v1);
+        ref.mMax.setMax(ref.mMax, v2);
+        ref.mCentroid.setAdd(ref.mMin, ref.mMax);
+        ref.mCentroid.mul(0.5f);
+        ref.mTriangle = i;
+    }
+
+    Builder builder(face, refs);
+    // a leaf per LEAF_SIZE triangles and as many inner nodes
+    builder.mNodes.reserve(num_triangles / 2 + 1);
+    builder.mPackets.reserve(num_triangles / LEAF_SIZE + 1);
+    builder.mTriangles.reserve(num_triangles + LEAF_SIZE);
+    builder.buildNode(0, num_triangles, 0);
+
+    mNodes.swap(builder.mNodes);
+    mPackets.swap(builder.mPackets);
+    mTriangles.swap(builder.mTriangles);
+    mDepth = builder.mDepth;
+}
+
+bool LLVolumeBVH::lineSegmentIntersect(const LLVector4a& start, const LLVector4a& dir, const LLVolumeFace& face,
+                                       F32* closest_t, LLVector4a* intersection, LLVector2* tex_coord,
+                                       LLVector4a* normal, LLVector4a* tangent) const
+{
+    if (mNodes.empty())
+    {
+        return false;
+    }
+
+    // huge rather than infinite reciprocals keep the slab test free of 0 * inf
+    LLVector4a inv_dir;
+    for (U32 i = 0; i < 3; ++i)
+    {
+        F32 d = dir[i];
+        inv_dir.getF32ptr()[i] = fabsf(d) > 1e-20f ? 1.f / d : (d < 0.f ? -1e30f : 1e30f);
+    }
+    inv_dir.getF32ptr()[3] = 0.f;
+
+    const U32 dir_negative[3] = { dir[0] < 0.f, dir[1] < 0.f, dir[2] < 0.f };
+
+    U32 hit_triangle = 0;
+    F32 hit_a = 0.f;
+    F32 hit_b = 0.f;
+    F32 hit_t = *closest_t;
+    bool hit = false;
+
+    U32 stack[STACK_SIZE];
+    U32 stack_size = 0;
+    stack[stack_size++] = 0;
+
+    while (stack_size > 0)
+    {
+        const U32 index = stack[--stack_size];
+        const Node& node = mNodes[index];
+
+        LLVector4a t0, t1, near_t, far_t;
+        t0.setSub(node.mExtents[0], start);
+        t0.mul(inv_dir);
+        t1.setSub(node.mExtents[1], start);
+        t1.mul(inv_dir);
+        near_t.setMin(t0, t1);
+        far_t.setMax(t0, t1);
+
+        F32 enter = llmax(near_t[0], near_t[1], near_t[2]);
+        F32 exit = llmin(far_t[0], far_t[1], far_t[2]);
+        if (enter > exit || exit < 0.f || enter > llmin(hit_t, 1.f))
+        {
+            continue;
+        }
+
+        if (node.mCount > 0)
+        {
+            LLVector4a a, b, t;
+            U32 mask = LLTriangleRayIntersect4(mPackets[node.mFirst], start, dir, a, b, t);
+            for (U32 lane = 0; mask; ++lane, mask >>= 1)
+            {
+                if ((mask & 1) &&
+                    t[lane] >= 0.f &&   // if hit is after start
+                    t[lane] <= 1.f &&   // and before end
+                    t[lane] < hit_t)    // and this hit is closer
+                {
+                    hit = true;
+                    hit_t = t[lane];
+                    hit_a = a[lane];
+                    hit_b = b[lane];
+                    hit_triangle = mTriangles[node.mFirst * LEAF_SIZE + lane];
+                }
+            }
+        }
+        else
+        { // visit the child nearer the start first
+            U32 first = index + 1;
+            U32 second = node.mFirst;
+            if (dir_negative[node.mAxis])
+            {
+                std::swap(first, second);
+            }
+            llassert(stack_size + 2 <= STACK_SIZE);
+            stack[stack_size++] = second;
+            stack[stack_size++] = first;
+        }
+    }
+
+    if (!hit)
+    {
+        return false;
+    }
+
+    *closest_t = hit_t;
+
+    if (intersection != NULL)
+    {
+        LLVector4a intersect = dir;
+        intersect.mul(hit_t);
+        intersect.add(start);
+        *intersection = intersect;
+    }
+
+    U32 idx0 = face.mIndices[hit_triangle * 3];
+    U32 idx1 = face.mIndices[hit_triangle * 3 + 1];
+    U32 idx2 = face.mIndices[hit_triangle * 3 + 2];
+
+    if (tex_coord != NULL && face.mTexCoords)
+    {
+        LLVector2* tc = (LLVector2*) face.mTexCoords;
+        *tex_coord = ((1.f - hit_a - hit_b) * tc[idx0] +
+            hit_a * tc[idx1] +
+            hit_b * tc[idx2]);
+    }
+
+    if (normal != NULL && face.mNormals)
+    {
+        LLVector4a n1, n2, n3;
+        n1 = face.mNormals[idx0];
+        n1.mul(1.f - hit_a - hit_b);
+
+        n2 = face.mNormals[idx1];
+        n2.mul(hit_a);
+
+        n3 = face.mNormals[idx2];
+        n3.mul(hit_b);
+
+        n1.add(n2);
+        n1.add(n3);
+
+        *normal = n1;
+    }
+
+    if (tangent != NULL && face.mTangents)
+    {
+        LLVector4a t1, t2, t3;
+        t1 = face.mTangents[idx0];
+        t1.mul(1.f - hit_a - hit_b);
+
+        t2 = face.mTangents[idx1];
+        t2.mul(hit_a);
+
+        t3 = face.mTangents[idx2];
+        t3.mul(hit_b);
+
+        t1.add(t2);
+        t1.add(t3);
+
+        *tangent = t1;
+    }
+
+    return true;
+}
+
+size_t LLVolumeBVH::getMemoryUsage() const
+{
+    return sizeof(*this) +
+        mNodes.capacity() * sizeof(Node) +
+        mPackets.capacity() * sizeof(LLTrianglePacket4) +
+        mTriangles.capacity() * sizeof(U32);
+}
@@ -0,0 +1,85 @@
+/**
+ * @file llvolumebvh.h
+ * @brief Flattened bounding volume hierarchy for LLVolumeFace raycasts
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLVOLUMEBVH_H
+#define LL_LLVOLUMEBVH_H
+
+#include "llvector4a.h"
+#include "llvolume.h"
+
+#include <vector>
+
+// Triangle BVH for one LLVolumeFace, an alternative to LLVolumeOctree for
+// raycasts.  Built with binned SAH splits into a single node array in
+// depth first order:  an inner node's first child directly follows it and
+// mFirst is the index of its second child.  Leaves hold up to four
+// triangles as one LLTrianglePacket4.  Large faces build their subtrees
+// on several threads.
+//
+// The BVH copies the vertex positions it needs, so it remains valid only
+// until the face's positions or indices change.
+class LLVolumeBVH
+{
+public:
+    struct alignas(16) Node
+    {
+        LLVector4a mExtents[2];     // min, max
+        U32 mFirst;                 // inner:  second child, leaf:  packet
+        U32 mCount;                 // 0 for inner nodes, else triangles in the packet
+        U32 mAxis;                  // split axis of inner nodes
+        U32 mPad;
+    };
+
+    LLVolumeBVH() = default;
+
+    void build(const LLVolumeFace& face);
+
+    // Same contract as LLOctreeTriangleRayIntersect:  finds the closest hit
+    // of the segment start .. start + dir nearer than *closest_t, updates
+    // *closest_t and fills in whichever outputs are non-null.  Returns
+    // true if such a hit was found.
+    bool lineSegmentIntersect(const LLVector4a& start, const LLVector4a& dir, const LLVolumeFace& face,
+                              F32* closest_t, LLVector4a* intersection, LLVector2* tex_coord,
+                              LLVector4a* normal, LLVector4a* tangent) const;
+
+    bool isEmpty() const { return mNodes.empty(); }
+    U32 getNodeCount() const { return (U32)mNodes.size(); }
+    U32 getDepth() const { return mDepth; }
+    size_t getMemoryUsage() const;
+
+    // Faces with at least this many triangles build on several threads
+    static U32 sParallelBuildMinTriangles;
+
+private:
+    class Builder;
+
+    std::vector<Node> mNodes;
+    std::vector<LLTrianglePacket4> mPackets;
+    std::vector<U32> mTriangles;    // four triangle indices per packet
+    U32 mDepth = 0;
+};
+
+#endif // LL_LLVOLUMEBVH_H
@@ -28,6 +28,9 @@
 #include "llvolumemgr.h"
 #include "llvolume.h"
 
+#include <mutex>
+#include <tuple>
+
 
 const F32 BASE_THRESHOLD = 0.03f;
 
@@ -208,6 +211,27 @@ void LLVolumeMgr::dump()
         mDataMutex->unlock();
     }
     LL_INFOS() << "Average usage of LODs " << avg << LL_ENDL;
+    LL_INFOS() << "Shape cache hits " << LLVolumeShapeCache::sHits << ", misses " << LLVolumeShapeCache::sMisses << LL_ENDL;
+}
+
+S32 LLVolumeMgr::destroyIdleOctrees(F64 idle_since)
+{
+    S32 count = 0;
+    if (mDataMutex)
+    {
+        mDataMutex->lock();
+    }
+    for (volume_lod_group_map_t::iterator iter = mVolumeLODGroups.begin(),
+             end = mVolumeLODGroups.end();
+         iter != end; iter++)
+    {
+        count += iter->second->destroyIdleOctrees(idle_since);
+    }
+    if (mDataMutex)
+    {
+        mDataMutex->unlock();
+    }
+    return count;
 }
 
 void LLVolumeMgr::useMutex()
@@ -379,6 +403,19 @@ S32 LLVolumeLODGroup::getVolumeDetailFromScale(const F32 detail)
     return 3;
 }
 
+S32 LLVolumeLODGroup::destroyIdleOctrees(F64 idle_since)
+{
+    S32 count = 0;
+    for (S32 i = 0; i < NUM_LODS; i++)
+    {
+        if (mVolumeLODs[i].notNull())
+        {
+            count += mVolumeLODs[i]->destroyIdleOctrees(idle_since);
+        }
+    }
+    return count;
+}
+
 F32 LLVolumeLODGroup::dump()
 {
     F32 usage = 0.f;
@@ -406,3 +443,237 @@ std::ostream& operator<<(std::ostream& s, const LLVolumeLODGroup& volgroup)
     return s;
 }
 
+
+//============================================================================
+// LLVolumeShapeCache
+
+U32 LLVolumeShapeCache::sMaxEntries = 1024;
+std::atomic<U32> LLVolumeShapeCache::sHits(0);
+std::atomic<U32> LLVolumeShapeCache::sMisses(0);
+
+namespace
+{
+    template <class T>
+    void copy_points(LLAlignedArray<T, 64>& dst, const LLAlignedArray<T, 64>& src)
+    {
+        dst.resize(src.size());
+        if (src.size() > 0)
+        {
+            memcpy(dst.mArray, src.mArray, sizeof(T) * src.size());
+        }
+    }
+
+    struct ProfileKey
+    {
+        LLProfileParams mParams;
+        bool mPathOpen;
+        F32 mDetail;
+        S32 mSplit;
+
+        bool operator<(const ProfileKey& rhs) const
+        {
+            if (mParams < rhs.mParams)
+            {
+                return true;
+            }
+            if (rhs.mParams < mParams)
+            {
+                return false;
+            }
+            return std::tie(mPathOpen, mDetail, mSplit) < std::tie(rhs.mPathOpen, rhs.mDetail, rhs.mSplit);
+        }
+    };
+
+    struct PathKey
+    {
+        LLPathParams mParams;
+        F32 mDetail;
+        S32 mSplit;
+
+        bool operator<(const PathKey& rhs) const
+        {
+            if (mParams < rhs.mParams)
+            {
+                return true;
+            }
+            if (rhs.mParams < mParams)
+            {
+                return false;
+            }
+            return std::tie(mDetail, mSplit) < std::tie(rhs.mDetail, rhs.mSplit);
+        }
+    };
+
+    struct ProfileData
+    {
+        LLAlignedArray<LLVector4a, 64> mProfile;
+        std::vector<LLProfile::Face> mFaces;
+        bool mOpen;
+        bool mConcave;
+        S32 mTotalOut;
+        S32 mTotal;
+    };
+
+    struct PathData
+    {
+        LLAlignedArray<LLPath::PathPt, 64> mPath;
+        bool mOpen;
+        S32 mTotal;
+        F32 mStep;
+    };
+
+    // Least recently used entries are dropped once there are more than
+    // LLVolumeShapeCache::sMaxEntries
+    template <class KEY, class DATA>
+    class ShapeMap
+    {
+    public:
+        std::shared_ptr<const DATA> find(const KEY& key)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            typename map_t::iterator iter = mMap.find(key);
+            if (iter == mMap.end())
+            {
+                return nullptr;
+            }
+            iter->second.mLastUsed = ++mClock;
+            return iter->second.mData;
+        }
+
+        void insert(const KEY& key, std::shared_ptr<const DATA> data)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            Entry& entry = mMap[key];
+            entry.mData = data;
+            entry.mLastUsed = ++mClock;
+
+            while (mMap.size() > LLVolumeShapeCache::sMaxEntries)
+            {
+                typename map_t::iterator oldest = mMap.begin();
+                for (typename map_t::iterator iter = mMap.begin(); iter != mMap.end(); ++iter)
+                {
+                    if (iter->second.mLastUsed < oldest->second.mLastUsed)
+                    {
+                        oldest = iter;
+                    }
+                }
+                mMap.erase(oldest);
+            }
+        }
+
+        void clear()
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mMap.clear();
+        }
+
+    private:
+        struct Entry
+        {
+            std::shared_ptr<const DATA> mData;
+            U64 mLastUsed = 0;
+        };
+        typedef std::map<KEY, Entry> map_t;
+
+        std::mutex mMutex;
+        map_t mMap;
+        U64 mClock = 0;
+    };
+
+    ShapeMap<ProfileKey, ProfileData> sProfiles;
+    ShapeMap<PathKey, PathData> sPaths;
+}
+
+//static
+bool LLVolumeShapeCache::generateProfile(LLProfile& profile, const LLProfileParams& params, bool path_open, F32 detail, S32 split)
+{
+    if (!profile.mDirty)
+    {
+        return false;
+    }
+
+    if (sMaxEntries == 0)
+    {
+        return profile.generate(params, path_open, detail, split);
+    }
+
+    ProfileKey key{ params, path_open, detail, split };
+    std::shared_ptr<const ProfileData> data = sProfiles.find(key);
+    if (data)
+    {
+        ++sHits;
+        copy_points(profile.mProfile, data->mProfile);
+        profile.mFaces = data->mFaces;
+        profile.mOpen = data->mOpen;
+        profile.mConcave = data->mConcave;
+        profile.mTotalOut = data->mTotalOut;
+        profile.mTotal = data->mTotal;
+        profile.mDirty = false;
+        return true;
+    }
+
+    ++sMisses;
+    if (!profile.generate(params, path_open, detail, split))
+    {
+        return false;
+    }
+
+    std::shared_ptr<ProfileData> entry = std::make_shared<ProfileData>();
+    copy_points(entry->mProfile, profile.mProfile);
+    entry->mFaces = profile.mFaces;
+    entry->mOpen = profile.mOpen;
+    entry->mConcave = profile.mConcave;
+    entry->mTotalOut = profile.mTotalOut;
+    entry->mTotal = profile.mTotal;
+    sProfiles.insert(key, entry);
+    return true;
+}
+
+//static
+bool LLVolumeShapeCache::generatePath(LLPath& path, const LLPathParams& params, F32 detail, S32 split)
+{
+    if (!path.mDirty)
+    {
+        return false;
+    }
+
+    // flexible paths are moved around by their owner after generation
+    if (sMaxEntries == 0 || params.getCurveType() == LL_PCODE_PATH_FLEXIBLE)
+    {
+        return path.generate(params, detail, split);
+    }
+
+    PathKey key{ params, detail, split };
+    std::shared_ptr<const PathData> data = sPaths.find(key);
+    if (data)
+    {
+        ++sHits;
+        copy_points(path.mPath, data->mPath);
+        path.mOpen = data->mOpen;
+        path.mTotal = data->mTotal;
+        path.mStep = data->mStep;
+        path.mDirty = false;
+        return true;
+    }
+
+    ++sMisses;
+    if (!path.generate(params, detail, split))
+    {
+        return false;
+    }
+
+    std::shared_ptr<PathData> entry = std::make_shared<PathData>();
+    copy_points(entry->mPath, path.mPath);
+    entry->mOpen = path.mOpen;
+    entry->mTotal = path.mTotal;
+    entry->mStep = path.mStep;
+    sPaths.insert(key, entry);
+    return true;
+}
+
+//static
+void LLVolumeShapeCache::clear()
+{
+    sProfiles.clear();
+    sPaths.clear();
+}
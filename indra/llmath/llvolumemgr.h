@@ -27,6 +27,7 @@
 #ifndef LL_LLVOLUMEMGR_H
 #define LL_LLVOLUMEMGR_H
 
+#include <atomic>
 #include <map>
 
 #include "llvolume.h"
@@ -61,6 +62,9 @@ public:
 
     const LLVolumeParams* getVolumeParams() const { return &mVolumeParams; };
 
+    // See LLVolume::destroyIdleOctrees()
+    S32 destroyIdleOctrees(F64 idle_since);
+
     F32 dump();
     friend std::ostream& operator<<(std::ostream& s, const LLVolumeLODGroup& volgroup);
 
@@ -92,6 +96,10 @@ public:
 
     void dump();
 
+    // Free the raycast octrees of faces not picked since idle_since
+    // (LLTimer::getTotalSeconds()), returns the number freed
+    S32 destroyIdleOctrees(F64 idle_since);
+
     // manually call this for mutex magic
     void useMutex();
 
@@ -109,4 +117,26 @@ protected:
     LLMutex* mDataMutex;
 };
 
+// Memoized LLProfile and LLPath point sets, keyed by their params,
+// detail and split.  Volumes with different LLVolumeParams often share
+// one half of the shape (editing a linkset changes one path or profile
+// parameter at a time), and copying the points is much cheaper than
+// generating them.  Entries are immutable and the cache locks itself,
+// so volumes can be generated on any thread.
+class LLVolumeShapeCache
+{
+public:
+    // Same contract as LLProfile::generate() and LLPath::generate() for
+    // non-sculpted shapes:  returns true if the points were (re)generated
+    static bool generateProfile(LLProfile& profile, const LLProfileParams& params, bool path_open, F32 detail, S32 split);
+    static bool generatePath(LLPath& path, const LLPathParams& params, F32 detail, S32 split);
+
+    static void clear();
+
+    // Entries kept per shape type, least recently used ones are dropped first
+    static U32 sMaxEntries;
+    static std::atomic<U32> sHits;
+    static std::atomic<U32> sMisses;
+};
+
 #endif // LL_LLVOLUMEMGR_H
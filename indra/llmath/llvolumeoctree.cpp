@@ -84,6 +84,31 @@ LLVolumeOctreeListener::~LLVolumeOctreeListener()
 
 }
 
+void LLVolumeOctreeListener::buildPackets(const LLOctreeNode<LLVolumeTriangle, LLVolumeTriangle*>* node)
+{
+    mPackets.clear();
+    mPackets.reserve((node->getElementCount() + 3) / 4);
+
+    U32 lane = 4;
+    for (LLOctreeNode<LLVolumeTriangle, LLVolumeTriangle*>::const_element_iter iter = node->getDataBegin();
+         iter != node->getDataEnd(); ++iter)
+    {
+        if (lane == 4)
+        {
+            mPackets.emplace_back();
+            std::fill_n(mPackets.back().mTri, 4, nullptr);
+            lane = 0;
+        }
+
+        const LLVolumeTriangle* tri = *iter;
+        TrianglePacket& packet = mPackets.back();
+        packet.mTris.setTriangle(lane, *tri->mV[0], *tri->mV[1], *tri->mV[2]);
+        packet.mTri[lane++] = tri;
+    }
+
+    mPacketsDirty = false;
+}
+
 void LLVolumeOctreeListener::handleChildAddition(const LLOctreeNode<LLVolumeTriangle, LLVolumeTriangle*>* parent,
     LLOctreeNode<LLVolumeTriangle, LLVolumeTriangle*>* child)
 {
@@ -122,84 +147,94 @@ void LLOctreeTriangleRayIntersect::traverse(const LLOctreeNode<LLVolumeTriangle,
 
 void LLOctreeTriangleRayIntersect::visit(const LLOctreeNode<LLVolumeTriangle, LLVolumeTriangle*>* node)
 {
-    for (typename LLOctreeNode<LLVolumeTriangle, LLVolumeTriangle*>::const_element_iter iter =
-            node->getDataBegin(); iter != node->getDataEnd(); ++iter)
+    LLVolumeOctreeListener* vl = (LLVolumeOctreeListener*) node->getListener(0);
+    if (vl->mPacketsDirty)
     {
-        const LLVolumeTriangle* tri = *iter;
-
-        F32 a, b, t;
+        vl->buildPackets(node);
+    }
 
-        if (LLTriangleRayIntersect(*tri->mV[0], *tri->mV[1], *tri->mV[2],
-                mStart, mDir, a, b, t))
+    for (const LLVolumeOctreeListener::TrianglePacket& packet : vl->mPackets)
+    {
+        LLVector4a a, b, t;
+        U32 mask = LLTriangleRayIntersect4(packet.mTris, mStart, mDir, a, b, t);
+        for (U32 lane = 0; mask; ++lane, mask >>= 1)
         {
-            if ((t >= 0.f) &&      // if hit is after start
-                (t <= 1.f) &&      // and before end
-                (t < *mClosestT))   // and this hit is closer
+            if (mask & 1)
             {
-                *mClosestT = t;
-                mHitFace = true;
-                mHitTriangle = tri;
-                if (mIntersection != NULL)
-                {
-                    LLVector4a intersect = mDir;
-                    intersect.mul(*mClosestT);
-                    intersect.add(mStart);
-                    *mIntersection = intersect;
-                }
+                hitTriangle(packet.mTri[lane], a[lane], b[lane], t[lane]);
+            }
+        }
+    }
+}
 
-                U32 idx0 = tri->mIndex[0];
-                U32 idx1 = tri->mIndex[1];
-                U32 idx2 = tri->mIndex[2];
+void LLOctreeTriangleRayIntersect::hitTriangle(const LLVolumeTriangle* tri, F32 a, F32 b, F32 t)
+{
+    if ((t >= 0.f) &&      // if hit is after start
+        (t <= 1.f) &&      // and before end
+        (t < *mClosestT))   // and this hit is closer
+    {
+        *mClosestT = t;
+        mHitFace = true;
+        mHitTriangle = tri;
+        if (mIntersection != NULL)
+        {
+            LLVector4a intersect = mDir;
+            intersect.mul(*mClosestT);
+            intersect.add(mStart);
+            *mIntersection = intersect;
+        }
 
-                if (mTexCoord != NULL && mFace->mTexCoords)
-                {
-                    LLVector2* tc = (LLVector2*) mFace->mTexCoords;
-                    *mTexCoord = ((1.f - a - b)  * tc[idx0] +
-                        a              * tc[idx1] +
-                        b              * tc[idx2]);
+        U32 idx0 = tri->mIndex[0];
+        U32 idx1 = tri->mIndex[1];
+        U32 idx2 = tri->mIndex[2];
 
-                }
+        if (mTexCoord != NULL && mFace->mTexCoords)
+        {
+            LLVector2* tc = (LLVector2*) mFace->mTexCoords;
+            *mTexCoord = ((1.f - a - b)  * tc[idx0] +
+                a              * tc[idx1] +
+                b              * tc[idx2]);
 
-                if (mNormal != NULL && mFace->mNormals)
-                {
-                    LLVector4a* norm = mFace->mNormals;
+        }
 
-                    LLVector4a n1,n2,n3;
-                    n1 = norm[idx0];
-                    n1.mul(1.f-a-b);
+        if (mNormal != NULL && mFace->mNormals)
+        {
+            LLVector4a* norm = mFace->mNormals;
 
-                    n2 = norm[idx1];
-                    n2.mul(a);
+            LLVector4a n1,n2,n3;
+            n1 = norm[idx0];
+            n1.mul(1.f-a-b);
 
-                    n3 = norm[idx2];
-                    n3.mul(b);
+            n2 = norm[idx1];
+            n2.mul(a);
 
-                    n1.add(n2);
-                    n1.add(n3);
+            n3 = norm[idx2];
+            n3.mul(b);
 
-                    *mNormal        = n1;
-                }
+            n1.add(n2);
+            n1.add(n3);
 
-                if (mTangent != NULL && mFace->mTangents)
-                {
-                    LLVector4a* tangents = mFace->mTangents;
+            *mNormal        = n1;
+        }
 
-                    LLVector4a t1,t2,t3;
-                    t1 = tangents[idx0];
-                    t1.mul(1.f-a-b);
+        if (mTangent != NULL && mFace->mTangents)
+        {
+            LLVector4a* tangents = mFace->mTangents;
 
-                    t2 = tangents[idx1];
-                    t2.mul(a);
+            LLVector4a t1,t2,t3;
+            t1 = tangents[idx0];
+            t1.mul(1.f-a-b);
 
-                    t3 = tangents[idx2];
-                    t3.mul(b);
+            t2 = tangents[idx1];
+            t2.mul(a);
 
-                    t1.add(t2);
-                    t1.add(t3);
+            t3 = tangents[idx2];
+            t3.mul(b);
 
-                    *mTangent = t1;
-                }
-            }
+            t1.add(t2);
+            t1.add(t3);
+
+            *mTangent = t1;
         }
     }
 }
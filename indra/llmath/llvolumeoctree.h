@@ -93,14 +93,26 @@ public:
     virtual void handleChildAddition(const LLOctreeNode<LLVolumeTriangle, LLVolumeTriangle*>* parent, LLOctreeNode<LLVolumeTriangle, LLVolumeTriangle*>* child);
     virtual void handleStateChange(const LLTreeNode<LLVolumeTriangle>* node) { }
     virtual void handleChildRemoval(const LLOctreeNode<LLVolumeTriangle, LLVolumeTriangle*>* parent, const LLOctreeNode<LLVolumeTriangle, LLVolumeTriangle*>* child) { }
-    virtual void handleInsertion(const LLTreeNode<LLVolumeTriangle>* node, LLVolumeTriangle* tri) { }
-    virtual void handleRemoval(const LLTreeNode<LLVolumeTriangle>* node, LLVolumeTriangle* tri) { }
+    virtual void handleInsertion(const LLTreeNode<LLVolumeTriangle>* node, LLVolumeTriangle* tri) { mPacketsDirty = true; }
+    virtual void handleRemoval(const LLTreeNode<LLVolumeTriangle>* node, LLVolumeTriangle* tri) { mPacketsDirty = true; }
     virtual void handleDestruction(const LLTreeNode<LLVolumeTriangle>* node) { }
 
+    // Regroup the node's triangles into mPackets
+    void buildPackets(const LLOctreeNode<LLVolumeTriangle, LLVolumeTriangle*>* node);
 
 public:
     LL_ALIGN_16(LLVector4a mBounds[2]); // bounding box (center, size) of this node and all its children (tight fit to objects)
     LL_ALIGN_16(LLVector4a mExtents[2]); // extents (min, max) of this node and all its children
+
+    // This node's triangles four at a time for LLTriangleRayIntersect4(),
+    // built by the first raycast that reaches the node
+    struct TrianglePacket
+    {
+        LLTrianglePacket4 mTris;
+        const LLVolumeTriangle* mTri[4];
+    };
+    std::vector<TrianglePacket> mPackets;
+    bool mPacketsDirty = true;
 };
 
 class LLOctreeTriangleRayIntersect : public LLOctreeTraveler<LLVolumeTriangle, LLVolumeTriangle*>
@@ -126,6 +138,10 @@ public:
     void traverse(const LLOctreeNode<LLVolumeTriangle, LLVolumeTriangle*>* node);
 
     virtual void visit(const LLOctreeNode<LLVolumeTriangle, LLVolumeTriangle*>* node);
+
+private:
+    // Record tri as the hit if it is within the segment and closer than any so far
+    void hitTriangle(const LLVolumeTriangle* tri, F32 a, F32 b, F32 t);
 };
 
 class LLVolumeOctreeValidate : public LLOctreeTraveler<LLVolumeTriangle, LLVolumeTriangle*>
@@ -0,0 +1,111 @@
+/**
+ * @file llcamera_test.cpp
+ * @brief Tests and benchmark of LLCamera batch frustum culling
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+#include "llmath.h"
+// Class to test
+#include "../llcamera.h"
+#include "stringize.h"
+// Tut header
+#include "../test/lltut.h"
+
+#include <random>
+#include <vector>
+
+namespace tut
+{
+    struct camera_test
+    {
+        std::mt19937 mRandom;
+        LLCamera mCamera;
+        std::vector<LLVector4a> mCenters;
+        std::vector<LLVector4a> mRadii;
+
+        camera_test() : mRandom(1357)
+        {
+            // a frustum looking down -z, near plane at 1m and far plane at 20m
+            const F32 xs[4] = { -1.f, 1.f, 1.f, -1.f };
+            const F32 ys[4] = { -1.f, -1.f, 1.f, 1.f };
+            LLVector3 frust[8];
+            for (U32 i = 0; i < 8; ++i)
+            {
+                F32 dist = i < 4 ? 1.f : 20.f;
+                frust[i].set(xs[i % 4] * dist, ys[i % 4] * dist, -dist);
+            }
+            mCamera.calcAgentFrustumPlanes(frust);
+        }
+
+        // Boxes in and around the frustum, so all three answers come up
+        void makeBoxes(U32 count)
+        {
+            std::uniform_real_distribution<F32> pos(-25.f, 25.f);
+            std::uniform_real_distribution<F32> size(0.1f, 4.f);
+            mCenters.resize(count);
+            mRadii.resize(count);
+            for (U32 i = 0; i < count; ++i)
+            {
+                mCenters[i].set(pos(mRandom), pos(mRandom), pos(mRandom) - 10.f);
+                mRadii[i].set(size(mRandom), size(mRandom), size(mRandom));
+            }
+        }
+    };
+
+    typedef test_group<camera_test> camera_t;
+    typedef camera_t::object camera_object_t;
+    tut::camera_t tut_camera("LLCamera");
+
+    template<> template<>
+    void camera_object_t::test<1>()
+    {
+        // The batch must give exactly the one box answers, including for
+        // counts that don't fill the last batch of four
+        for (U32 count : { 1u, 3u, 4u, 7u, 4003u })
+        {
+            makeBoxes(count);
+            for (bool no_far_clip : { false, true })
+            {
+                std::vector<S32> results(count, -1);
+                mCamera.AABBsInFrustum(mCenters.data(), mRadii.data(), results.data(), count, NULL, no_far_clip);
+
+                U32 seen[3] = { 0, 0, 0 };
+                for (U32 i = 0; i < count; ++i)
+                {
+                    S32 expected = no_far_clip ? mCamera.AABBInFrustumNoFarClip(mCenters[i], mRadii[i])
+                                               : mCamera.AABBInFrustum(mCenters[i], mRadii[i]);
+                    ensure_equals(STRINGIZE(count << " boxes, far clip " << !no_far_clip << ", box " << i),
+                                  results[i], expected);
+                    ++seen[expected];
+                }
+                if (count > 1000)
+                {
+                    ensure("outside boxes", seen[0] > 0);
+                    ensure("partial boxes", seen[1] > 0);
+                    ensure("inside boxes", seen[2] > 0);
+                }
+            }
+        }
+    }
+}
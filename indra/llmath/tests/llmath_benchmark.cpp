@@ -0,0 +1,448 @@
+/**
+ * @file   llmath_benchmark.cpp
+ * @date   2026-10-15
+ * @brief  Benchmarks of LLVector4a, LLMatrix4a and LLOctree
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+#include "llbenchmark.h"
+
+#include "llcamera.h"
+#include "llmath.h"
+#include "llmatrix4a.h"
+#include "llmatrix4akernels.h"
+#include "lloctree.h"
+#include "m4math.h"
+#include "llvector4a.h"
+
+#include <random>
+#include <vector>
+
+namespace
+{
+    const U32 VECTOR_COUNT = 4096;
+    const U32 MATRIX_COUNT = 1024;
+    const U32 ELEMENT_COUNT = 16384;
+
+    std::mt19937 sRandom(1357);
+
+    F32 random_f32(F32 range)
+    {
+        return std::uniform_real_distribution<F32>(-range, range)(sRandom);
+    }
+
+    std::vector<LLVector4a> random_vectors(U32 count)
+    {
+        std::vector<LLVector4a> vecs(count);
+        for (LLVector4a& vec : vecs)
+        {
+            vec.set(random_f32(1.f), random_f32(1.f), random_f32(1.f), 1.f);
+        }
+        return vecs;
+    }
+
+    std::vector<LLMatrix4a> random_matrices(U32 count)
+    {
+        std::vector<LLMatrix4a> mats(count);
+        for (LLMatrix4a& mat : mats)
+        {
+            for (U32 r = 0; r < 4; ++r)
+            {
+                mat.mMatrix[r].set(random_f32(1.f), random_f32(1.f), random_f32(1.f), random_f32(1.f));
+            }
+        }
+        return mats;
+    }
+
+    // Runs the batched matrix kernels with one instruction set, then goes
+    // back to the one they had
+    class ScopedISA
+    {
+    public:
+        ScopedISA(LLMatrix4aKernels::EISA isa)
+        :   mSaved(LLMatrix4aKernels::getISA())
+        {
+            LLMatrix4aKernels::setISA(isa);
+        }
+
+        ~ScopedISA()
+        {
+            LLMatrix4aKernels::setISA(mSaved);
+        }
+
+    private:
+        LLMatrix4aKernels::EISA mSaved;
+    };
+
+    // Stand-in for a drawable or a volume triangle in the octrees of the
+    // viewer: a position and a radius
+    class alignas(16) Element
+    {
+    public:
+        Element(const LLVector4a& position, F32 radius)
+        :   mPositionGroup(position),
+            mBinRadius(radius)
+        {}
+
+        const LLVector4a& getPositionGroup() const { return mPositionGroup; }
+        const F32& getBinRadius() const { return mBinRadius; }
+        S32 getBinIndex() const { return mBinIndex; }
+        void setBinIndex(S32 index) const { mBinIndex = index; }
+
+    private:
+        LLVector4a mPositionGroup;
+        F32 mBinRadius;
+        mutable S32 mBinIndex = -1;
+    };
+
+    typedef LLOctreeNode<Element, Element*> element_node_t;
+    typedef LLOctreeRoot<Element, Element*> element_root_t;
+
+    // A region worth of small things, and a few big ones
+    std::vector<Element> random_elements(U32 count)
+    {
+        std::vector<Element> elements;
+        elements.reserve(count);
+        for (U32 i = 0; i < count; ++i)
+        {
+            LLVector4a position(128.f + random_f32(128.f), 128.f + random_f32(128.f), 32.f + random_f32(32.f));
+            elements.emplace_back(position, i % 64 ? 0.5f + random_f32(0.4f) : 8.f);
+        }
+        return elements;
+    }
+
+    element_root_t* make_octree()
+    {
+        // same defaults as OctreeMaxNodeCapacity and OctreeMinimumNodeSize
+        gOctreeMaxCapacity = 128;
+        gOctreeMinSize = 0.01f;
+        return new element_root_t(LLVector4a(128.f, 128.f, 128.f), LLVector4a(256.f, 256.f, 256.f), NULL);
+    }
+
+    // A frustum looking down -z, near plane at 1m and far plane at 20m
+    LLCamera make_camera()
+    {
+        const F32 xs[4] = { -1.f, 1.f, 1.f, -1.f };
+        const F32 ys[4] = { -1.f, -1.f, 1.f, 1.f };
+        LLVector3 frust[8];
+        for (U32 i = 0; i < 8; ++i)
+        {
+            F32 dist = i < 4 ? 1.f : 20.f;
+            frust[i].set(xs[i % 4] * dist, ys[i % 4] * dist, -dist);
+        }
+        LLCamera camera;
+        camera.calcAgentFrustumPlanes(frust);
+        return camera;
+    }
+
+    // Boxes in and around that frustum, so all three answers come up
+    void random_boxes(U32 count, std::vector<LLVector4a>& centers, std::vector<LLVector4a>& radii)
+    {
+        centers.resize(count);
+        radii.resize(count);
+        for (U32 i = 0; i < count; ++i)
+        {
+            centers[i].set(random_f32(25.f), random_f32(25.f), random_f32(25.f) - 10.f);
+            radii[i].set(2.05f + random_f32(1.95f), 2.05f + random_f32(1.95f), 2.05f + random_f32(1.95f));
+        }
+    }
+
+    class CountElements : public LLOctreeTraveler<Element, Element*>
+    {
+    public:
+        void visit(const element_node_t* node) override
+        {
+            mCount += node->getElementCount();
+        }
+
+        U32 mCount = 0;
+    };
+}
+
+/*****************************************************************************
+*   LLVector4a
+*****************************************************************************/
+static void vector4a_dot3(llbenchmark::State& state)
+{
+    const std::vector<LLVector4a> a = random_vectors(VECTOR_COUNT);
+    const std::vector<LLVector4a> b = random_vectors(VECTOR_COUNT);
+    while (state.keepRunning())
+    {
+        LLSimdScalar sum = LLSimdScalar::getZero();
+        for (U32 i = 0; i < VECTOR_COUNT; ++i)
+        {
+            sum += a[i].dot3(b[i]);
+        }
+        llbenchmark::doNotOptimize(sum);
+    }
+    state.setItemsProcessed(state.getIterations() * VECTOR_COUNT);
+}
+LL_BENCHMARK(vector4a_dot3);
+
+static void vector4a_cross3(llbenchmark::State& state)
+{
+    const std::vector<LLVector4a> a = random_vectors(VECTOR_COUNT);
+    const std::vector<LLVector4a> b = random_vectors(VECTOR_COUNT);
+    std::vector<LLVector4a> res(VECTOR_COUNT);
+    while (state.keepRunning())
+    {
+        for (U32 i = 0; i < VECTOR_COUNT; ++i)
+        {
+            res[i].setCross3(a[i], b[i]);
+        }
+        llbenchmark::doNotOptimize(res);
+    }
+    state.setItemsProcessed(state.getIterations() * VECTOR_COUNT);
+}
+LL_BENCHMARK(vector4a_cross3);
+
+static void vector4a_normalize3fast(llbenchmark::State& state)
+{
+    const std::vector<LLVector4a> in = random_vectors(VECTOR_COUNT);
+    std::vector<LLVector4a> res(VECTOR_COUNT);
+    while (state.keepRunning())
+    {
+        for (U32 i = 0; i < VECTOR_COUNT; ++i)
+        {
+            res[i] = in[i];
+            res[i].normalize3fast();
+        }
+        llbenchmark::doNotOptimize(res);
+    }
+    state.setItemsProcessed(state.getIterations() * VECTOR_COUNT);
+}
+LL_BENCHMARK(vector4a_normalize3fast);
+
+/*****************************************************************************
+*   LLMatrix4a
+*****************************************************************************/
+static void matrix4a_matmul(llbenchmark::State& state)
+{
+    const std::vector<LLMatrix4a> a = random_matrices(MATRIX_COUNT);
+    const std::vector<LLMatrix4a> b = random_matrices(MATRIX_COUNT);
+    std::vector<LLMatrix4a> res(MATRIX_COUNT);
+    while (state.keepRunning())
+    {
+        for (U32 i = 0; i < MATRIX_COUNT; ++i)
+        {
+            matMul(a[i], b[i], res[i]);
+        }
+        llbenchmark::doNotOptimize(res);
+    }
+    state.setItemsProcessed(state.getIterations() * MATRIX_COUNT);
+}
+LL_BENCHMARK(matrix4a_matmul);
+
+static void matrix4_multiply(llbenchmark::State& state)
+{
+    // the scalar LLMatrix4 the batched kernels replace
+    const std::vector<LLMatrix4a> a = random_matrices(MATRIX_COUNT);
+    const std::vector<LLMatrix4a> b = random_matrices(MATRIX_COUNT);
+    std::vector<LLMatrix4> a_scalar, b_scalar;
+    for (U32 i = 0; i < MATRIX_COUNT; ++i)
+    {
+        a_scalar.emplace_back(a[i].getF32ptr());
+        b_scalar.emplace_back(b[i].getF32ptr());
+    }
+    std::vector<LLMatrix4> res(MATRIX_COUNT);
+    while (state.keepRunning())
+    {
+        for (U32 i = 0; i < MATRIX_COUNT; ++i)
+        {
+            res[i] = a_scalar[i];
+            res[i] *= b_scalar[i];
+        }
+        llbenchmark::doNotOptimize(res);
+    }
+    state.setItemsProcessed(state.getIterations() * MATRIX_COUNT);
+}
+LL_BENCHMARK(matrix4_multiply);
+
+static void matmul_array(llbenchmark::State& state, LLMatrix4aKernels::EISA isa)
+{
+    ScopedISA scoped_isa(isa);
+    const std::vector<LLMatrix4a> a = random_matrices(MATRIX_COUNT);
+    const std::vector<LLMatrix4a> b = random_matrices(MATRIX_COUNT);
+    std::vector<LLMatrix4a> res(MATRIX_COUNT);
+    while (state.keepRunning())
+    {
+        LLMatrix4aKernels::matMulArray(a.data(), b.data(), res.data(), MATRIX_COUNT);
+        llbenchmark::doNotOptimize(res);
+    }
+    state.setItemsProcessed(state.getIterations() * MATRIX_COUNT);
+}
+
+static void matrix4a_matmul_array(llbenchmark::State& state)      { matmul_array(state, LLMatrix4aKernels::getBestISA()); }
+static void matrix4a_matmul_array_sse2(llbenchmark::State& state) { matmul_array(state, LLMatrix4aKernels::ISA_SSE2); }
+LL_BENCHMARK(matrix4a_matmul_array);
+LL_BENCHMARK(matrix4a_matmul_array_sse2);
+
+static void matrix4a_affine_transform(llbenchmark::State& state)
+{
+    const LLMatrix4a mat = random_matrices(1)[0];
+    const std::vector<LLVector4a> in = random_vectors(VECTOR_COUNT);
+    std::vector<LLVector4a> out(VECTOR_COUNT);
+    while (state.keepRunning())
+    {
+        for (U32 i = 0; i < VECTOR_COUNT; ++i)
+        {
+            mat.affineTransform(in[i], out[i]);
+        }
+        llbenchmark::doNotOptimize(out);
+    }
+    state.setItemsProcessed(state.getIterations() * VECTOR_COUNT);
+}
+LL_BENCHMARK(matrix4a_affine_transform);
+
+static void affine_transform_array(llbenchmark::State& state, LLMatrix4aKernels::EISA isa)
+{
+    ScopedISA scoped_isa(isa);
+    const LLMatrix4a mat = random_matrices(1)[0];
+    const std::vector<LLVector4a> in = random_vectors(VECTOR_COUNT);
+    std::vector<LLVector4a> out(VECTOR_COUNT);
+    while (state.keepRunning())
+    {
+        LLMatrix4aKernels::affineTransformArray(mat, in.data(), out.data(), VECTOR_COUNT);
+        llbenchmark::doNotOptimize(out);
+    }
+    state.setItemsProcessed(state.getIterations() * VECTOR_COUNT);
+}
+
+static void matrix4a_affine_transform_array(llbenchmark::State& state)      { affine_transform_array(state, LLMatrix4aKernels::getBestISA()); }
+static void matrix4a_affine_transform_array_sse2(llbenchmark::State& state) { affine_transform_array(state, LLMatrix4aKernels::ISA_SSE2); }
+LL_BENCHMARK(matrix4a_affine_transform_array);
+LL_BENCHMARK(matrix4a_affine_transform_array_sse2);
+
+/*****************************************************************************
+*   LLCamera
+*****************************************************************************/
+static void camera_aabb_in_frustum(llbenchmark::State& state)
+{
+    LLCamera camera = make_camera();
+    std::vector<LLVector4a> centers, radii;
+    random_boxes(ELEMENT_COUNT, centers, radii);
+    while (state.keepRunning())
+    {
+        S32 sum = 0;
+        for (U32 i = 0; i < ELEMENT_COUNT; ++i)
+        {
+            sum += camera.AABBInFrustum(centers[i], radii[i]);
+        }
+        llbenchmark::doNotOptimize(sum);
+    }
+    state.setItemsProcessed(state.getIterations() * ELEMENT_COUNT);
+}
+LL_BENCHMARK(camera_aabb_in_frustum);
+
+static void camera_aabbs_in_frustum(llbenchmark::State& state)
+{
+    LLCamera camera = make_camera();
+    std::vector<LLVector4a> centers, radii;
+    random_boxes(ELEMENT_COUNT, centers, radii);
+    std::vector<S32> results(ELEMENT_COUNT);
+    while (state.keepRunning())
+    {
+        camera.AABBsInFrustum(centers.data(), radii.data(), results.data(), ELEMENT_COUNT);
+        llbenchmark::doNotOptimize(results);
+    }
+    state.setItemsProcessed(state.getIterations() * ELEMENT_COUNT);
+}
+LL_BENCHMARK(camera_aabbs_in_frustum);
+
+/*****************************************************************************
+*   LLOctree
+*****************************************************************************/
+static void octree_insert(llbenchmark::State& state)
+{
+    std::vector<Element> elements = random_elements(ELEMENT_COUNT);
+    while (state.keepRunning())
+    {
+        element_root_t* root = make_octree();
+        for (Element& element : elements)
+        {
+            root->insert(&element);
+        }
+
+        state.pauseTiming();
+        for (Element& element : elements)
+        {
+            root->remove(&element);
+        }
+        delete root;
+        state.resumeTiming();
+    }
+    state.setItemsProcessed(state.getIterations() * ELEMENT_COUNT);
+}
+LL_BENCHMARK(octree_insert);
+
+static void octree_remove(llbenchmark::State& state)
+{
+    std::vector<Element> elements = random_elements(ELEMENT_COUNT);
+    while (state.keepRunning())
+    {
+        state.pauseTiming();
+        element_root_t* root = make_octree();
+        for (Element& element : elements)
+        {
+            root->insert(&element);
+        }
+        state.resumeTiming();
+
+        for (Element& element : elements)
+        {
+            root->remove(&element);
+        }
+
+        state.pauseTiming();
+        delete root;
+        state.resumeTiming();
+    }
+    state.setItemsProcessed(state.getIterations() * ELEMENT_COUNT);
+}
+LL_BENCHMARK(octree_remove);
+
+static void octree_traverse(llbenchmark::State& state)
+{
+    std::vector<Element> elements = random_elements(ELEMENT_COUNT);
+    element_root_t* root = make_octree();
+    for (Element& element : elements)
+    {
+        root->insert(&element);
+    }
+
+    while (state.keepRunning())
+    {
+        CountElements counter;
+        counter.traverse(root);
+        llbenchmark::doNotOptimize(counter.mCount);
+    }
+    state.setItemsProcessed(state.getIterations() * ELEMENT_COUNT);
+
+    for (Element& element : elements)
+    {
+        root->remove(&element);
+    }
+    delete root;
+}
+LL_BENCHMARK(octree_traverse);
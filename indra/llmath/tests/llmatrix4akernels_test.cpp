@@ -0,0 +1,163 @@
+/**
+ * @file llmatrix4akernels_test.cpp
+ * @brief Tests and benchmark of the batched LLMatrix4a kernels
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+
+#include "linden_common.h"
+#include "llmath.h"
+// Class to test
+#include "../llmatrix4akernels.h"
+#include "../llmatrix4a.h"
+#include "stringize.h"
+// Tut header
+#include "../test/lltut.h"
+
+#include <random>
+#include <vector>
+
+namespace tut
+{
+    using namespace LLMatrix4aKernels;
+
+    struct matrix4akernels_test
+    {
+        std::mt19937 mRandom;
+        EISA mSavedISA;
+
+        matrix4akernels_test()
+        :   mRandom(2468),
+            mSavedISA(getISA())
+        {
+        }
+
+        ~matrix4akernels_test()
+        {
+            setISA(mSavedISA);
+        }
+
+        F32 randomF32()
+        {
+            return std::uniform_real_distribution<F32>(-2.f, 2.f)(mRandom);
+        }
+
+        std::vector<LLMatrix4a> randomMatrices(U32 count)
+        {
+            std::vector<LLMatrix4a> mats(count);
+            for (LLMatrix4a& mat : mats)
+            {
+                for (U32 r = 0; r < 4; ++r)
+                {
+                    mat.mMatrix[r].set(randomF32(), randomF32(), randomF32(), randomF32());
+                }
+            }
+            return mats;
+        }
+
+        std::vector<LLVector4a> randomVectors(U32 count)
+        {
+            std::vector<LLVector4a> vecs(count);
+            for (LLVector4a& vec : vecs)
+            {
+                vec.set(randomF32(), randomF32(), randomF32(), 1.f);
+            }
+            return vecs;
+        }
+
+        // Every ISA this machine supports, SSE2 first
+        std::vector<EISA> isas() const
+        {
+            std::vector<EISA> result;
+            for (S32 isa = ISA_SSE2; isa <= getBestISA(); ++isa)
+            {
+                result.push_back((EISA)isa);
+            }
+            return result;
+        }
+
+        // FMA rounds differently, so compare with a tolerance
+        void ensureClose(const std::string& msg, const LLVector4a& a, const LLVector4a& b)
+        {
+            for (U32 i = 0; i < 4; ++i)
+            {
+                ensure(STRINGIZE(msg << " element " << i << ": " << a[i] << " vs " << b[i]),
+                       fabsf(a[i] - b[i]) <= 1.e-5f * llmax(1.f, fabsf(b[i])));
+            }
+        }
+    };
+
+    typedef test_group<matrix4akernels_test> matrix4akernels_t;
+    typedef matrix4akernels_t::object matrix4akernels_object_t;
+    tut::matrix4akernels_t tut_matrix4akernels("LLMatrix4aKernels");
+
+    template<> template<>
+    void matrix4akernels_object_t::test<1>()
+    {
+        // products match matMul()
+        const U32 count = 37;
+        std::vector<LLMatrix4a> a = randomMatrices(count);
+        std::vector<LLMatrix4a> b = randomMatrices(count);
+
+        for (EISA isa : isas())
+        {
+            setISA(isa);
+            std::vector<LLMatrix4a> res(count);
+            matMulArray(a.data(), b.data(), res.data(), count);
+            for (U32 i = 0; i < count; ++i)
+            {
+                LLMatrix4a expected;
+                matMul(a[i], b[i], expected);
+                for (U32 r = 0; r < 4; ++r)
+                {
+                    ensureClose(STRINGIZE(getISAName(isa) << " matMulArray " << i << " row " << r),
+                                res[i].mMatrix[r], expected.mMatrix[r]);
+                }
+            }
+        }
+    }
+
+    template<> template<>
+    void matrix4akernels_object_t::test<2>()
+    {
+        // transforms match affineTransform(), including odd counts
+        LLMatrix4a m = randomMatrices(1)[0];
+        for (U32 count : { 0u, 1u, 2u, 5u, 64u })
+        {
+            std::vector<LLVector4a> in = randomVectors(count);
+            for (EISA isa : isas())
+            {
+                setISA(isa);
+                std::vector<LLVector4a> out(count);
+                affineTransformArray(m, in.data(), out.data(), count);
+                for (U32 i = 0; i < count; ++i)
+                {
+                    LLVector4a expected;
+                    m.affineTransform(in[i], expected);
+                    ensureClose(STRINGIZE(getISAName(isa) << " affineTransformArray " << i << " of " << count),
+                                out[i], expected);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,120 @@
+/**
+ * @file llvolume_test.cpp
+ * @brief Tests for the packet ray-triangle intersection
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+#include "../test/lltut.h"
+#include "../llvolume.h"
+#include "stringize.h"
+
+#include <random>
+
+namespace tut
+{
+    struct volume_test
+    {
+        std::mt19937 mRandom;
+
+        volume_test() : mRandom(4321) {}
+
+        LLVector4a randomPoint(F32 range)
+        {
+            std::uniform_real_distribution<F32> dist(-range, range);
+            return LLVector4a(dist(mRandom), dist(mRandom), dist(mRandom));
+        }
+    };
+
+    typedef test_group<volume_test> volume_test_t;
+    typedef volume_test_t::object volume_test_object_t;
+    tut::volume_test_t tut_volume_test("LLVolume");
+
+    template<> template<>
+    void volume_test_object_t::test<1>()
+    {
+        // LLTriangleRayIntersect4 must agree with LLTriangleRayIntersect lane by lane
+        S32 hits = 0;
+        for (S32 i = 0; i < 2000; ++i)
+        {
+            LLVector4a verts[4][3];
+            LLTrianglePacket4 packet;
+            U32 count = 1 + i % 4;   // partially filled packets too
+            for (U32 lane = 0; lane < count; ++lane)
+            {
+                for (U32 v = 0; v < 3; ++v)
+                {
+                    verts[lane][v] = randomPoint(1.f);
+                }
+                packet.setTriangle(lane, verts[lane][0], verts[lane][1], verts[lane][2]);
+            }
+
+            LLVector4a start = randomPoint(2.f);
+            LLVector4a dir;
+            dir.setSub(randomPoint(0.5f), start);
+
+            LLVector4a a, b, t;
+            U32 mask = LLTriangleRayIntersect4(packet, start, dir, a, b, t);
+            ensure_equals(STRINGIZE("unused lanes of " << count), mask >> count, 0U);
+
+            for (U32 lane = 0; lane < count; ++lane)
+            {
+                F32 ea, eb, et;
+                bool expected = LLTriangleRayIntersect(verts[lane][0], verts[lane][1], verts[lane][2], start, dir, ea, eb, et);
+                bool hit = (mask >> lane) & 1;
+                ensure_equals(STRINGIZE("hit of test " << i << " lane " << lane), hit, expected);
+                if (hit)
+                {
+                    ++hits;
+                    ensure_approximately_equals("a", a[lane], ea, 16);
+                    ensure_approximately_equals("b", b[lane], eb, 16);
+                    ensure_approximately_equals("t", t[lane], et, 16);
+                }
+            }
+        }
+
+        // make sure the rays are not all misses
+        ensure("some hits", hits > 50);
+    }
+
+    template<> template<>
+    void volume_test_object_t::test<2>()
+    {
+        // single-sided:  a hit from the front misses from the back
+        LLTrianglePacket4 packet;
+        LLVector4a v0(0.f, 0.f, 0.f), v1(1.f, 0.f, 0.f), v2(0.f, 1.f, 0.f);
+        packet.setTriangle(2, v0, v1, v2);
+
+        LLVector4a a, b, t;
+        LLVector4a start(0.25f, 0.25f, 1.f);
+        LLVector4a dir(0.f, 0.f, -2.f);
+        ensure_equals("front", LLTriangleRayIntersect4(packet, start, dir, a, b, t), 1U << 2);
+        ensure_approximately_equals("t", t[2], 0.5f, 20);
+        ensure_approximately_equals("a", a[2], 0.25f, 20);
+        ensure_approximately_equals("b", b[2], 0.25f, 20);
+
+        start.set(0.25f, 0.25f, -1.f);
+        dir.set(0.f, 0.f, 2.f);
+        ensure_equals("back", LLTriangleRayIntersect4(packet, start, dir, a, b, t), 0U);
+    }
+}
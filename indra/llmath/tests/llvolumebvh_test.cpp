@@ -0,0 +1,245 @@
+/**
+ * @file llvolumebvh_test.cpp
+ * @brief Tests and benchmark of LLVolumeBVH against the face octree
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+#include "llmath.h"
+// Class to test
+#include "../llvolumebvh.h"
+#include "../llvolumeoctree.h"
+#include "stringize.h"
+// Tut header
+#include "../test/lltut.h"
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+namespace tut
+{
+    struct volumebvh_test
+    {
+        std::mt19937 mRandom;
+
+        volumebvh_test() : mRandom(2468) {}
+
+        F32 random(F32 range)
+        {
+            return std::uniform_real_distribution<F32>(-range, range)(mRandom);
+        }
+
+        // A soup of small clustered triangles inside the unit cube, standing
+        // in for a dense mesh face
+        void makeSoup(LLVolumeFace& face, U32 triangles)
+        {
+            face.resizeVertices(triangles * 3);
+            face.resizeIndices(triangles * 3);
+            for (U32 i = 0; i < triangles * 3; ++i)
+            {
+                if (i % 3 == 0)
+                {
+                    face.mPositions[i].set(random(0.45f), random(0.45f), random(0.45f));
+                }
+                else
+                {
+                    face.mPositions[i].set(random(0.04f), random(0.04f), random(0.04f));
+                    face.mPositions[i].add(face.mPositions[i - i % 3]);
+                }
+                face.mNormals[i].set(0.f, 0.f, 1.f);
+                face.mTexCoords[i].set(0.f, 0.f);
+                face.mIndices[i] = (U16)i;
+            }
+            face.mExtents[0].splat(-0.5f);
+            face.mExtents[1].splat(0.5f);
+        }
+
+        // Random segments crossing the unit cube
+        void makeRays(std::vector<LLVector4a>& starts, std::vector<LLVector4a>& dirs, U32 count)
+        {
+            starts.resize(count);
+            dirs.resize(count);
+            for (U32 i = 0; i < count; ++i)
+            {
+                starts[i].set(random(1.5f), random(1.5f), random(1.5f));
+                LLVector4a end(random(0.5f), random(0.5f), random(0.5f));
+                dirs[i].setSub(end, starts[i]);
+                dirs[i].mul(2.f);
+            }
+        }
+
+        F64 elapsedMs(std::chrono::steady_clock::time_point start)
+        {
+            return std::chrono::duration<F64, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+    };
+
+    // Approximate heap footprint of a face octree
+    class OctreeMemory : public LLOctreeTraveler<LLVolumeTriangle, LLVolumeTriangle*>
+    {
+    public:
+        size_t mBytes = 0;
+
+        virtual void visit(const LLOctreeNode<LLVolumeTriangle, LLVolumeTriangle*>* node)
+        {
+            const LLVolumeOctreeListener* listener = (const LLVolumeOctreeListener*) node->getListener(0);
+            mBytes += sizeof(*node) + sizeof(*listener) +
+                node->getElementCount() * sizeof(LLVolumeTriangle*) +
+                listener->mPackets.capacity() * sizeof(LLVolumeOctreeListener::TrianglePacket);
+        }
+    };
+
+    typedef test_group<volumebvh_test> volumebvh_t;
+    typedef volumebvh_t::object volumebvh_object_t;
+    tut::volumebvh_t tut_volumebvh("LLVolumeBVH");
+
+    template<> template<>
+    void volumebvh_object_t::test<1>()
+    {
+        // The BVH must find the same closest hits as the octree, serial and
+        // parallel builds alike
+        U32 saved_min = LLVolumeBVH::sParallelBuildMinTriangles;
+        for (U32 triangles : { 1u, 4u, 5u, 37u, 2000u, 20000u })
+        {
+            for (U32 parallel_min : { 1000000u, 512u })
+            {
+                LLVolumeBVH::sParallelBuildMinTriangles = parallel_min;
+
+                LLVolumeFace face;
+                makeSoup(face, triangles);
+                face.createOctree();
+
+                LLVolumeBVH bvh;
+                bvh.build(face);
+                ensure(STRINGIZE("depth of " << triangles), bvh.getDepth() < 64);
+
+                std::vector<LLVector4a> starts, dirs;
+                makeRays(starts, dirs, 1000);
+                for (U32 i = 0; i < starts.size(); ++i)
+                {
+                    F32 octree_t = 2.f;
+                    LLVector4a octree_point;
+                    LLOctreeTriangleRayIntersect intersect(starts[i], dirs[i], &face, &octree_t, &octree_point, NULL, NULL, NULL);
+                    intersect.traverse(face.getOctree());
+
+                    F32 bvh_t = 2.f;
+                    LLVector4a bvh_point;
+                    bool hit = bvh.lineSegmentIntersect(starts[i], dirs[i], face, &bvh_t, &bvh_point, NULL, NULL, NULL);
+
+                    std::string desc = STRINGIZE(triangles << " triangles, parallel " << parallel_min << ", ray " << i);
+                    ensure_equals(desc, hit, intersect.mHitFace);
+                    if (hit)
+                    {
+                        ensure_approximately_equals(desc.c_str(), bvh_t, octree_t, 16);
+                    }
+                }
+            }
+        }
+        LLVolumeBVH::sParallelBuildMinTriangles = saved_min;
+    }
+
+    template<> template<>
+    void volumebvh_object_t::test<2>()
+    {
+        // hits behind the segment start or beyond closest_t are ignored
+        LLVolumeFace face;
+        makeSoup(face, 1);
+        face.mPositions[0].set(-0.5f, -0.5f, 0.f);
+        face.mPositions[1].set(0.5f, -0.5f, 0.f);
+        face.mPositions[2].set(0.f, 0.5f, 0.f);
+
+        LLVolumeBVH bvh;
+        bvh.build(face);
+
+        LLVector4a start(0.f, 0.f, 1.f);
+        LLVector4a dir(0.f, 0.f, -2.f);
+        F32 closest_t = 0.4f;
+        ensure("beyond closest", !bvh.lineSegmentIntersect(start, dir, face, &closest_t, NULL, NULL, NULL, NULL));
+
+        closest_t = 2.f;
+        LLVector4a normal;
+        ensure("hit", bvh.lineSegmentIntersect(start, dir, face, &closest_t, NULL, NULL, &normal, NULL));
+        ensure_approximately_equals("t", closest_t, 0.5f, 16);
+        ensure_approximately_equals("normal", normal[2], 1.f, 16);
+
+        start.set(0.f, 0.f, 0.5f);
+        dir.set(0.f, 0.f, 1.f);
+        closest_t = 2.f;
+        ensure("pointing away", !bvh.lineSegmentIntersect(start, dir, face, &closest_t, NULL, NULL, NULL, NULL));
+    }
+
+    template<> template<>
+    void volumebvh_object_t::test<3>()
+    {
+        // Benchmark against LLVolumeOctree.  Only logs, the numbers depend
+        // too much on the machine to assert on them.
+        for (U32 triangles : { 1000u, 5000u, 21000u })
+        {
+            LLVolumeFace face;
+            makeSoup(face, triangles);
+
+            std::vector<LLVector4a> starts, dirs;
+            makeRays(starts, dirs, 20000);
+
+            auto start = std::chrono::steady_clock::now();
+            face.createOctree();
+            F64 octree_build = elapsedMs(start);
+
+            start = std::chrono::steady_clock::now();
+            U32 octree_hits = 0;
+            for (U32 i = 0; i < starts.size(); ++i)
+            {
+                F32 closest_t = 2.f;
+                LLOctreeTriangleRayIntersect intersect(starts[i], dirs[i], &face, &closest_t, NULL, NULL, NULL, NULL);
+                intersect.traverse(face.getOctree());
+                octree_hits += intersect.mHitFace;
+            }
+            F64 octree_query = elapsedMs(start);
+
+            OctreeMemory memory;
+            memory.traverse(face.getOctree());
+            memory.mBytes += triangles * sizeof(LLVolumeTriangle);
+
+            start = std::chrono::steady_clock::now();
+            LLVolumeBVH bvh;
+            bvh.build(face);
+            F64 bvh_build = elapsedMs(start);
+
+            start = std::chrono::steady_clock::now();
+            U32 bvh_hits = 0;
+            for (U32 i = 0; i < starts.size(); ++i)
+            {
+                F32 closest_t = 2.f;
+                bvh_hits += bvh.lineSegmentIntersect(starts[i], dirs[i], face, &closest_t, NULL, NULL, NULL, NULL);
+            }
+            F64 bvh_query = elapsedMs(start);
+
+            LL_INFOS() << triangles << " triangles, " << starts.size() << " rays:"
+                       << " octree build " << octree_build << "ms, ~" << memory.mBytes / 1024 << "KB, queries " << octree_query << "ms;"
+                       << " BVH build " << bvh_build << "ms, " << bvh.getMemoryUsage() / 1024 << "KB, "
+                       << bvh.getNodeCount() << " nodes, depth " << bvh.getDepth() << ", queries " << bvh_query << "ms" << LL_ENDL;
+            ensure_equals(STRINGIZE("hits of " << triangles), bvh_hits, octree_hits);
+        }
+    }
+}
@@ -150,6 +150,14 @@ public:
     const LLMatrix4&    getWorldMatrix() const      { return mWorldMatrix; }
     void setWorldMatrix (const LLMatrix4& mat)   { mWorldMatrix = mat; }
 
+    // set the world transform computed by the caller instead of by updateMatrix()
+    void setWorldTransform(const LLVector3& pos, const LLQuaternion& rot, const LLMatrix4& mat)
+    {
+        mWorldPosition = pos;
+        mWorldRotation = rot;
+        mWorldMatrix = mat;
+    }
+
     void init()
     {
         mWorldMatrix.setIdentity();
@@ -339,3 +339,87 @@ U64 LLMeshOptimizer::simplify(U16 *destination,
     }
 }
 
+
+//static
+bool LLMeshOptimizer::buildMeshletsU16(U16 *indices,
+                                       U64 index_count,
+                                       const LLVector4a *vertex_positions,
+                                       U64 vertex_count,
+                                       std::vector<Meshlet>& meshlets)
+{
+    meshlets.clear();
+    if (index_count < 3 || index_count % 3 != 0)
+    {
+        return false;
+    }
+
+    // favor clusters with a tight normal cone, they are what gets culled
+    const F32 cone_weight = 0.25f;
+
+    try
+    {
+        size_t max_meshlets = meshopt_buildMeshletsBound(index_count, MESHLET_MAX_VERTICES, MESHLET_MAX_TRIANGLES);
+        std::vector<meshopt_Meshlet> clusters(max_meshlets);
+        std::vector<unsigned int> cluster_vertices(max_meshlets * MESHLET_MAX_VERTICES);
+        std::vector<unsigned char> cluster_triangles(max_meshlets * MESHLET_MAX_TRIANGLES * 3);
+        std::vector<unsigned int> indices32(indices, indices + index_count);
+
+        size_t count = meshopt_buildMeshlets(clusters.data(),
+            cluster_vertices.data(),
+            cluster_triangles.data(),
+            indices32.data(),
+            index_count,
+            (const float*)vertex_positions,
+            vertex_count,
+            sizeof(LLVector4a),
+            MESHLET_MAX_VERTICES,
+            MESHLET_MAX_TRIANGLES,
+            cone_weight);
+
+        meshlets.resize(count);
+        U32 offset = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const meshopt_Meshlet& cluster = clusters[i];
+            const unsigned int* verts = &cluster_vertices[cluster.vertex_offset];
+            const unsigned char* tris = &cluster_triangles[cluster.triangle_offset];
+
+            Meshlet& meshlet = meshlets[i];
+            meshlet.mIndexOffset = offset;
+            meshlet.mIndexCount = cluster.triangle_count * 3;
+            for (U32 j = 0; j < meshlet.mIndexCount; ++j)
+            {
+                indices32[offset + j] = verts[tris[j]];
+            }
+            offset += meshlet.mIndexCount;
+
+            meshopt_Bounds bounds = meshopt_computeMeshletBounds(verts, tris, cluster.triangle_count,
+                (const float*)vertex_positions, vertex_count, sizeof(LLVector4a));
+            for (U32 k = 0; k < 3; ++k)
+            {
+                meshlet.mCenter[k] = bounds.center[k];
+                meshlet.mConeAxis[k] = bounds.cone_axis[k];
+            }
+            meshlet.mRadius = bounds.radius;
+            meshlet.mConeCutoff = bounds.cone_cutoff;
+        }
+
+        if (offset != index_count)
+        { // should not happen, every triangle lands in exactly one meshlet
+            meshlets.clear();
+            return false;
+        }
+
+        for (U64 i = 0; i < index_count; ++i)
+        {
+            indices[i] = (U16)indices32[i];
+        }
+    }
+    catch (std::bad_alloc&)
+    {
+        meshlets.clear();
+        return false;
+    }
+
+    return true;
+}
@@ -28,12 +28,32 @@
 
 #include "linden_common.h"
 
+#include <vector>
+
 class LLVector4a;
 class LLVector2;
 
 class LLMeshOptimizer
 {
 public:
+    // A cluster of up to MESHLET_MAX_TRIANGLES triangles, stored as a
+    // contiguous range of the index buffer it was built from
+    struct Meshlet
+    {
+        U32 mIndexOffset;
+        U32 mIndexCount;
+        // bounding sphere
+        F32 mCenter[3];
+        F32 mRadius;
+        // normal cone: every triangle faces away from a viewer at v when
+        // dot(center - v, axis) >= cutoff * |center - v| + radius
+        F32 mConeAxis[3];
+        F32 mConeCutoff;
+    };
+
+    static constexpr U64 MESHLET_MAX_VERTICES = 64;
+    static constexpr U64 MESHLET_MAX_TRIANGLES = 124;
+
     LLMeshOptimizer();
     ~LLMeshOptimizer();
 
@@ -150,6 +170,17 @@ public:
         F32 target_error,
         bool sloppy,
         F32* result_error);
+
+    // Clusters the triangles of indices into meshlets and rewrites
+    // indices so each meshlet's triangles are contiguous.  The meshlet
+    // bounds are in the space of vertex_positions.
+    // Returns false and leaves indices untouched on failure.
+    static bool buildMeshletsU16(
+        U16 *indices,
+        U64 index_count,
+        const LLVector4a *vertex_positions,
+        U64 vertex_count,
+        std::vector<Meshlet>& meshlets);
 private:
 };
 
@@ -57,6 +57,13 @@ const F64 TEMP_CACHE_ENTRY_LIFETIME = 60.0;
 // Maximum time an unrefreshed cache entry is allowed.
 const F64 MAX_UNREFRESHED_TIME = 20.0 * 60.0;
 
+// People API request URLs, see requestNamesViaCapability().
+// Apache can handle URLs of 4096 chars, but let's be conservative
+const U32 NAME_URL_MAX = 4096;
+const U32 NAME_URL_SEND_THRESHOLD = 3500;
+// Roughly a dozen ids, where failing requests stop shrinking
+const U32 NAME_URL_MIN_THRESHOLD = 500;
+
 // Send bulk lookup requests a few times a second at most.
 // Only need per-frame timing resolution.
 static LLFrameTimer sRequestTimer;
@@ -117,6 +124,7 @@ LLAvatarNameCache::LLAvatarNameCache()
     mRunning = false;
 
     mUsePeopleAPI = true;
+    mRequestURLThreshold = NAME_URL_SEND_THRESHOLD;
 
     sHttpRequest = LLCore::HttpRequest::ptr_t(new LLCore::HttpRequest());
     sHttpHeaders = LLCore::HttpHeaders::ptr_t(new LLCore::HttpHeaders());
@@ -188,6 +196,7 @@ void LLAvatarNameCache::requestAvatarNameCache_(std::string url, std::vector<LLU
             {
                 workqueue->post([=]()
                     {
+                        LLAvatarNameCache::getInstance()->adjustRequestSize(success);
                         if (!success)
                         {   // on any sort of failure add dummy records for any agent IDs
                             // in this request that we do not have cached already
@@ -291,7 +300,7 @@ void LLAvatarNameCache::handleAvNameCacheSuccess(const LLSD &data, const LLSD &h
 // Provide some fallback for agents that return errors
 void LLAvatarNameCache::handleAgentError(const LLUUID& agent_id)
 {
-    std::map<LLUUID,LLAvatarName>::iterator existing = mCache.find(agent_id);
+    cache_t::iterator existing = mCache.find(agent_id);
     if (existing == mCache.end())
     {
         // <FS:Ansariel> Don't re-request names for agents with null uuid.
@@ -335,7 +344,7 @@ void LLAvatarNameCache::processName(const LLUUID& agent_id, const LLAvatarName&
 
     bool updated_account = true; // assume obsolete value for new arrivals by default
 
-    std::map<LLUUID, LLAvatarName>::iterator it = mCache.find(agent_id);
+    cache_t::iterator it = mCache.find(agent_id);
     if (it != mCache.end()
         && (*it).second.getAccountName() == av_name.getAccountName())
     {
@@ -377,9 +386,7 @@ void LLAvatarNameCache::requestNamesViaCapability()
     // URL format is like:
     // http://pdp60.lindenlab.com:8000/agents/?ids=3941037e-78ab-45f0-b421-bd6e77c1804d&ids=0012809d-7d2d-4c24-9609-af1230a37715&ids=0019aaba-24af-4f0a-aa72-6457953cf7f0
     //
-    // Apache can handle URLs of 4096 chars, but let's be conservative
-    static const U32 NAME_URL_MAX = 4096;
-    static const U32 NAME_URL_SEND_THRESHOLD = 3500;
+    // The batch is cut at mRequestURLThreshold, see adjustRequestSize()
 
     std::string url;
     url.reserve(NAME_URL_MAX);
@@ -414,7 +421,7 @@ void LLAvatarNameCache::requestNamesViaCapability()
         // mark request as pending
         mPendingQueue[agent_id] = now;
 
-        if (url.size() > NAME_URL_SEND_THRESHOLD)
+        if (url.size() > mRequestURLThreshold)
         {
             break;
         }
@@ -432,6 +439,27 @@ void LLAvatarNameCache::requestNamesViaCapability()
     }
 }
 
+void LLAvatarNameCache::adjustRequestSize(bool success)
+{
+    // A failed batch (typically a timeout or a 5xx from an overloaded
+    // service) is retried in smaller batches, successes grow them back.
+    U32 threshold = mRequestURLThreshold;
+    if (success)
+    {
+        threshold = llmin(threshold + threshold / 4, NAME_URL_SEND_THRESHOLD);
+    }
+    else
+    {
+        threshold = llmax(threshold / 2, NAME_URL_MIN_THRESHOLD);
+    }
+
+    if (threshold != mRequestURLThreshold)
+    {
+        LL_DEBUGS("AvNameCache") << "request URL threshold " << mRequestURLThreshold << " -> " << threshold << LL_ENDL;
+        mRequestURLThreshold = threshold;
+    }
+}
+
 void LLAvatarNameCache::legacyNameCallback(const LLUUID& agent_id,
                                            const std::string& full_name,
                                            bool is_group)
@@ -442,7 +470,7 @@ void LLAvatarNameCache::legacyNameCallback(const LLUUID& agent_id,
     // Retrieve the name and set it to never (or almost never...) expire: when we are using the legacy
     // protocol, we do not get an expiration date for each name and there's no reason to ask the
     // data again and again so we set the expiration time to the largest value admissible.
-    std::map<LLUUID,LLAvatarName>::iterator av_record = LLAvatarNameCache::getInstance()->mCache.find(agent_id);
+    cache_t::iterator av_record = LLAvatarNameCache::getInstance()->mCache.find(agent_id);
     LLAvatarName& av_name = av_record->second;
     av_name.setExpires(MAX_UNREFRESHED_TIME);
 }
@@ -496,10 +524,12 @@ void LLAvatarNameCache::clearCache()
 
 bool LLAvatarNameCache::importFile(std::istream& istr)
 {
+    // deserialize() picks the format from the header, so caches written
+    // as XML by older viewers still load
     LLSD data;
-    if (LLSDParser::PARSE_FAILURE == LLSDSerialize::fromXMLDocument(data, istr))
+    if (!LLSDSerialize::deserialize(data, istr, LLSDSerialize::SIZE_UNLIMITED) || !data.isMap())
     {
-        LL_WARNS("AvNameCache") << "avatar name cache data xml parse failed" << LL_ENDL;
+        LL_WARNS("AvNameCache") << "avatar name cache data parse failed" << LL_ENDL;
         return false;
     }
 
@@ -509,6 +539,7 @@ bool LLAvatarNameCache::importFile(std::istream& istr)
 
     LLUUID agent_id;
     LLAvatarName av_name;
+    mCache.reserve(mCache.size() + agents.size());
     LLSD::map_const_iterator it = agents.beginMap();
     for ( ; it != agents.endMap(); ++it)
     {
@@ -544,7 +575,9 @@ void LLAvatarNameCache::exportFile(std::ostream& ostr)
     LL_INFOS("AvNameCache") << "LLAvatarNameCache returning " << agents.size() << LL_ENDL;
     LLSD data;
     data["agents"] = agents;
-    LLSDSerialize::toPrettyXML(data, ostr);
+    // binary is several times smaller and faster to parse than pretty XML,
+    // which matters once the cache holds 100k names
+    LLSDSerialize::serialize(data, ostr, LLSDSerialize::LLSD_BINARY);
 }
 
 void LLAvatarNameCache::setNameLookupURL(const std::string& name_lookup_url)
@@ -637,7 +670,7 @@ void LLAvatarNameCache::eraseUnrefreshed()
                                          << " user '" << av_name.getAccountName() << "' "
                                          << "expired " << now - av_name.mExpires << " secs ago"
                                          << LL_ENDL;
-                mCache.erase(it++);
+                it = mCache.erase(it);
                 expired++;
             }
             else
@@ -669,7 +702,7 @@ bool LLAvatarNameCache::getName(const LLUUID& agent_id, LLAvatarName *av_name)
     if (mRunning)
     {
         // ...only do immediate lookups when cache is running
-        std::map<LLUUID,LLAvatarName>::iterator it = mCache.find(agent_id);
+        cache_t::iterator it = mCache.find(agent_id);
         if (it != mCache.end())
         {
             *av_name = it->second;
@@ -733,7 +766,7 @@ LLAvatarNameCache::callback_connection_t LLAvatarNameCache::getNameCallback(cons
     if (mRunning)
     {
         // ...only do immediate lookups when cache is running
-        std::map<LLUUID,LLAvatarName>::iterator it = mCache.find(agent_id);
+        cache_t::iterator it = mCache.find(agent_id);
         if (it != mCache.end())
         {
             LLAvatarName& av_name = it->second;
@@ -845,8 +878,8 @@ void LLAvatarNameCache::insert(const LLUUID& agent_id, const LLAvatarName& av_na
 
 LLUUID LLAvatarNameCache::findIdByName(const std::string& name)
 {
-    std::map<LLUUID, LLAvatarName>::iterator it;
-    std::map<LLUUID, LLAvatarName>::iterator end = mCache.end();
+    cache_t::iterator it;
+    cache_t::iterator end = mCache.end();
     for (it = mCache.begin(); it != end; ++it)
     {
         if (it->second.getUserName() == name)
@@ -32,6 +32,7 @@
 #include "llsingleton.h"
 #include <boost/signals2.hpp>
 #include <set>
+#include <unordered_map>
 
 class LLSD;
 class LLUUID;
@@ -52,7 +53,8 @@ public:
     }
     // </FS:Ansariel>
 
-    // Import/export the name cache to file.
+    // Import/export the name cache to file. Export writes binary LLSD,
+    // import reads binary or the XML older viewers wrote.
     bool importFile(std::istream& istr);
     void exportFile(std::ostream& ostr);
 
@@ -159,6 +161,7 @@ private:
 
     // This is a coroutine.
     static void requestAvatarNameCache_(std::string url, std::vector<LLUUID> agentIds);
+    void adjustRequestSize(bool success);
 
     void handleAvNameCacheSuccess(const LLSD &data, const LLSD &httpResult);
 
@@ -192,20 +195,24 @@ private:
 
     // Agent IDs that have been requested, but with no reply.
     // Maps agent ID to frame time request was made.
-    typedef std::map<LLUUID, F64> pending_queue_t;
+    typedef std::unordered_map<LLUUID, F64> pending_queue_t;
     pending_queue_t mPendingQueue;
 
     // Callbacks to fire when we received a name.
     // May have multiple callbacks for a single ID, which are
     // represented as multiple slots bound to the signal.
     // Avoid copying signals via pointers.
-    typedef std::map<LLUUID, callback_signal_t*> signal_map_t;
+    typedef std::unordered_map<LLUUID, callback_signal_t*> signal_map_t;
     signal_map_t mSignalMap;
 
     // The cache at last, i.e. avatar names we know about.
-    typedef std::map<LLUUID, LLAvatarName> cache_t;
+    typedef std::unordered_map<LLUUID, LLAvatarName> cache_t;
     cache_t mCache;
 
+    // URL length at which a People API request is sent. Shrinks when
+    // requests fail and grows back while they succeed.
+    U32 mRequestURLThreshold;
+
     // Time when unrefreshed cached names were checked last.
     F64 mLastExpireCheck;
 
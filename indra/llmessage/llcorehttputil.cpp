@@ -585,18 +585,16 @@ LLSD HttpCoroJSONHandler::handleSuccess(LLCore::HttpResponse * response, LLCore:
 
     LLCore::BufferArrayStream bas(body);
 
+    // Parse straight into LLSD, skipping the intermediate JSON structure
     boost::system::error_code ec;
-    boost::json::value jsonRoot = boost::json::parse(bas, ec);
+    LLSD parsed = LlsdFromJson(bas, ec);
     if(ec.failed())
     {   // deserialization failed.  Record the reason and pass back an empty map for markup.
         status = LLCore::HttpStatus(499, std::string(ec.what()));
         return result;
     }
 
-    // Convert the JSON structure to LLSD
-    result = LlsdFromJson(jsonRoot);
-
-    return result;
+    return parsed;
 }
 
 LLSD HttpCoroJSONHandler::parseBody(LLCore::HttpResponse *response, bool &success)
@@ -611,15 +609,14 @@ LLSD HttpCoroJSONHandler::parseBody(LLCore::HttpResponse *response, bool &succes
     LLCore::BufferArrayStream bas(body);
 
     boost::system::error_code ec;
-    boost::json::value jsonRoot = boost::json::parse(bas, ec);
+    LLSD parsed = LlsdFromJson(bas, ec);
     if (ec.failed())
     {
         success = false;
         return LLSD();
     }
 
-    // Convert the JSON structure to LLSD
-    return LlsdFromJson(jsonRoot);
+    return parsed;
 }
 
 //========================================================================
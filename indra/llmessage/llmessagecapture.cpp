@@ -0,0 +1,359 @@
+/**
+ * @file llmessagecapture.cpp
+ * @brief Recording of received messages to a file, and replay of such a
+ * recording through the message system
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llmessagecapture.h"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+#include "llsdserialize.h"
+#include "lltimer.h"
+#include "message.h"
+
+static const char CAPTURE_MAGIC[8] = { 'L', 'L', 'M', 'S', 'G', 'C', 'A', 'P' };
+
+// type, usec, ip, port, size
+static const size_t RECORD_HEADER_SIZE = sizeof(U8) + sizeof(U64) + 3 * sizeof(U32);
+
+//-----------------------------------------------------------------------------
+// LLMessageCapture
+//-----------------------------------------------------------------------------
+
+LLMessageCapture::LLMessageCapture(const region_lookup_t& region_lookup)
+:   mStartUsec(0),
+    mRecordCount(0),
+    mRegionLookup(region_lookup)
+{
+}
+
+LLMessageCapture::~LLMessageCapture()
+{
+    close();
+}
+
+bool LLMessageCapture::open(const std::string& filename)
+{
+    close();
+    mFile.open(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!mFile.is_open())
+    {
+        LL_WARNS("Messaging") << "Could not open message capture " << filename << LL_ENDL;
+        return false;
+    }
+
+    mFile.write(CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC));
+    U32 version = VERSION;
+    mFile.write((const char*)&version, sizeof(version));
+    mStartUsec = totalTime();
+    mRecordCount = 0;
+    mKnownSenders.clear();
+    LL_INFOS("Messaging") << "Capturing received messages to " << filename << LL_ENDL;
+    return true;
+}
+
+void LLMessageCapture::close()
+{
+    if (mFile.is_open())
+    {
+        LL_INFOS("Messaging") << "Message capture closed after " << mRecordCount << " records" << LL_ENDL;
+        mFile.close();
+    }
+}
+
+void LLMessageCapture::recordPacket(const LLHost& sender, const U8* data, S32 size)
+{
+    if (!mFile.is_open() || size <= 0)
+    {
+        return;
+    }
+
+    if (!mKnownSenders.count(sender))
+    {
+        U64 handle = mRegionLookup ? mRegionLookup(sender) : 0;
+        if (handle)
+        {
+            writeRecord(RECORD_REGION, sender, (const U8*)&handle, sizeof(handle));
+            mKnownSenders.insert(sender);
+        }
+    }
+    writeRecord(RECORD_PACKET, sender, data, size);
+}
+
+void LLMessageCapture::recordEvent(const std::string& name, const LLSD& message)
+{
+    if (!mFile.is_open())
+    {
+        return;
+    }
+
+    std::ostringstream str;
+    str << name << '\0';
+    LLSDSerialize::toBinary(message, str);
+    const std::string data = str.str();
+    writeRecord(RECORD_EVENT, LLHost(message["sender"].asString()), (const U8*)data.data(), (U32)data.size());
+}
+
+void LLMessageCapture::writeRecord(ERecordType type, const LLHost& sender, const U8* data, U32 size)
+{
+    U8 record_type = (U8)type;
+    U64 usec = totalTime() - mStartUsec;
+    U32 ip = sender.getAddress();
+    U32 port = sender.getPort();
+    mFile.write((const char*)&record_type, sizeof(record_type));
+    mFile.write((const char*)&usec, sizeof(usec));
+    mFile.write((const char*)&ip, sizeof(ip));
+    mFile.write((const char*)&port, sizeof(port));
+    mFile.write((const char*)&size, sizeof(size));
+    mFile.write((const char*)data, size);
+    ++mRecordCount;
+}
+
+//-----------------------------------------------------------------------------
+// LLMessageReplay
+//-----------------------------------------------------------------------------
+
+LLMessageReplay::LLMessageReplay()
+:   mNextRecord(0),
+    mMaxSpeed(false),
+    mStartUsec(0),
+    mEndUsec(0),
+    mDropped(0)
+{
+}
+
+bool LLMessageReplay::load(const std::string& filename)
+{
+    llifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+    if (!file.is_open())
+    {
+        LL_WARNS("Messaging") << "Could not open message capture " << filename << LL_ENDL;
+        return false;
+    }
+    mData.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    U32 version = 0;
+    const size_t start = sizeof(CAPTURE_MAGIC) + sizeof(version);
+    if (mData.size() < start || memcmp(mData.data(), CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC)))
+    {
+        LL_WARNS("Messaging") << filename << " is not a message capture" << LL_ENDL;
+        return false;
+    }
+    memcpy(&version, &mData[sizeof(CAPTURE_MAGIC)], sizeof(version));
+    if (version != LLMessageCapture::VERSION)
+    {
+        LL_WARNS("Messaging") << filename << " is a version " << version << " message capture, expected "
+                              << LLMessageCapture::VERSION << LL_ENDL;
+        return false;
+    }
+
+    mRecords.clear();
+    mSenderRegions.clear();
+    size_t offset = start;
+    while (offset + RECORD_HEADER_SIZE <= mData.size())
+    {
+        Record record;
+        U32 ip, port;
+        const U8* header = &mData[offset];
+        memcpy(&record.mType, header, sizeof(U8));
+        memcpy(&record.mUsec, header + 1, sizeof(U64));
+        memcpy(&ip, header + 9, sizeof(U32));
+        memcpy(&port, header + 13, sizeof(U32));
+        memcpy(&record.mSize, header + 17, sizeof(U32));
+        record.mSender = LLHost(ip, port);
+        record.mOffset = offset + RECORD_HEADER_SIZE;
+        if (record.mOffset + record.mSize > mData.size())
+        {
+            // the viewer quit while writing, keep what is complete
+            LL_WARNS("Messaging") << filename << " is truncated" << LL_ENDL;
+            break;
+        }
+        offset = record.mOffset + record.mSize;
+
+        if (record.mType == LLMessageCapture::RECORD_REGION && record.mSize == sizeof(U64))
+        {
+            U64 handle;
+            memcpy(&handle, &mData[record.mOffset], sizeof(handle));
+            mSenderRegions[record.mSender] = handle;
+        }
+        else if (record.mType == LLMessageCapture::RECORD_PACKET || record.mType == LLMessageCapture::RECORD_EVENT)
+        {
+            mRecords.push_back(record);
+        }
+    }
+
+    LL_INFOS("Messaging") << "Loaded " << mRecords.size() << " messages from " << mSenderRegions.size()
+                          << " regions from " << filename << LL_ENDL;
+    return true;
+}
+
+void LLMessageReplay::start(const region_host_t& region_host, bool max_speed)
+{
+    mRegionHost = region_host;
+    mMaxSpeed = max_speed;
+    mNextRecord = 0;
+    mSenderHosts.clear();
+    mStats.clear();
+    mDropped = 0;
+    mStartUsec = totalTime();
+    mEndUsec = 0;
+}
+
+bool LLMessageReplay::isDue(const Record& record) const
+{
+    return mMaxSpeed || totalTime() - mStartUsec >= record.mUsec;
+}
+
+bool LLMessageReplay::mapSender(const LLHost& recorded, LLHost& current)
+{
+    auto found = mSenderHosts.find(recorded);
+    if (found != mSenderHosts.end())
+    {
+        current = found->second;
+        return true;
+    }
+
+    // look again each time until the region connects
+    auto region = mSenderRegions.find(recorded);
+    if (region == mSenderRegions.end() || !mRegionHost)
+    {
+        return false;
+    }
+    current = mRegionHost(region->second);
+    if (!current.isOk())
+    {
+        return false;
+    }
+    mSenderHosts[recorded] = current;
+    return true;
+}
+
+S32 LLMessageReplay::nextPacket(U8* buffer, S32 max_size, LLHost& sender)
+{
+    // events are left for dispatchEvents(), outside of checkMessages
+    while (!isDone() && mRecords[mNextRecord].mType == LLMessageCapture::RECORD_PACKET)
+    {
+        const Record& record = mRecords[mNextRecord];
+        if (!isDue(record))
+        {
+            return 0;
+        }
+        ++mNextRecord;
+
+        if (!mapSender(record.mSender, sender) || (S32)record.mSize > max_size)
+        {
+            ++mDropped;
+            continue;
+        }
+        memcpy(buffer, &mData[record.mOffset], record.mSize);
+        return (S32)record.mSize;
+    }
+    return 0;
+}
+
+void LLMessageReplay::dispatchEvents()
+{
+    while (!isDone() && mRecords[mNextRecord].mType == LLMessageCapture::RECORD_EVENT)
+    {
+        const Record& record = mRecords[mNextRecord];
+        if (!isDue(record))
+        {
+            return;
+        }
+        ++mNextRecord;
+
+        const char* data = (const char*)&mData[record.mOffset];
+        const char* name_end = (const char*)memchr(data, '\0', record.mSize);
+        LLHost sender;
+        if (!name_end || !mapSender(record.mSender, sender))
+        {
+            ++mDropped;
+            continue;
+        }
+
+        std::string name(data, name_end);
+        size_t llsd_size = record.mSize - (name_end + 1 - data);
+        std::istringstream str(std::string(name_end + 1, llsd_size));
+        LLSD message;
+        if (LLSDSerialize::fromBinary(message, str, llsd_size) == LLSDParser::PARSE_FAILURE)
+        {
+            ++mDropped;
+            continue;
+        }
+        message["sender"] = sender.getIPandPort();
+
+        U64 start = totalTime();
+        LLMessageSystem::dispatch(name, message);
+        addTime("event " + name, (U32)llsd_size, totalTime() - start);
+    }
+    // called every frame, which also notes when the replay ran out
+    if (isDone() && !mEndUsec)
+    {
+        mEndUsec = totalTime();
+    }
+}
+
+void LLMessageReplay::addTime(const std::string& name, U32 bytes, U64 usec)
+{
+    Stat& stat = mStats[name];
+    ++stat.mCount;
+    stat.mBytes += bytes;
+    stat.mUsec += usec;
+}
+
+void LLMessageReplay::logReport() const
+{
+    U32 count = 0;
+    U64 bytes = 0;
+    U64 usec = 0;
+    std::vector<std::pair<U64, std::string> > by_time;
+    for (const auto& entry : mStats)
+    {
+        count += entry.second.mCount;
+        bytes += entry.second.mBytes;
+        usec += entry.second.mUsec;
+        by_time.emplace_back(entry.second.mUsec, entry.first);
+    }
+    std::sort(by_time.rbegin(), by_time.rend());
+
+    F64 elapsed = (F64)((mEndUsec ? mEndUsec : (U64)totalTime()) - mStartUsec) / 1000000.0;
+    LL_INFOS("Messaging") << "Replayed " << count << " messages, " << bytes / 1024 << " KB in "
+                          << llformat("%.2f", elapsed) << " s (" << mDropped << " dropped, "
+                          << (mMaxSpeed ? "maximum speed" : "recorded speed") << "): "
+                          << llformat("%.0f", elapsed > 0.0 ? count / elapsed : 0.0) << " messages/s, "
+                          << llformat("%.1f", (F64)usec / 1000.0) << " ms on the main thread" << LL_ENDL;
+    LL_INFOS("Messaging") << llformat("    %-36s %8s %10s %10s %8s", "Message", "Count", "KB", "Total ms", "Avg us") << LL_ENDL;
+    for (const auto& entry : by_time)
+    {
+        const Stat& stat = mStats.find(entry.second)->second;
+        LL_INFOS("Messaging") << llformat("    %-36s %8u %10llu %10.2f %8.1f", entry.second.c_str(), stat.mCount,
+                                          (unsigned long long)(stat.mBytes / 1024), (F64)stat.mUsec / 1000.0,
+                                          (F64)stat.mUsec / stat.mCount) << LL_ENDL;
+    }
+}
@@ -0,0 +1,149 @@
+/**
+ * @file llmessagecapture.h
+ * @brief Recording of received messages to a file, and replay of such a
+ * recording through the message system
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLMESSAGECAPTURE_H
+#define LL_LLMESSAGECAPTURE_H
+
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "llfile.h"
+#include "llhost.h"
+#include "llsd.h"
+
+// A capture file is the magic "LLMSGCAP", a U32 version, then records of
+//   U8 type, U64 usec since the capture started, U32 ip, U32 port,
+//   U32 size, size bytes of data
+// all in host byte order, it is meant to be replayed on the machine that
+// recorded it.  Packets are stored as received, before zero code expansion
+// and with their appended acks.  Events are the message name, a NUL and
+// the message as binary LLSD.  A region record ties a sender to the U64
+// handle of its region, so the replay can find the region again when the
+// simulators have moved to other hosts.
+class LLMessageCapture
+{
+public:
+    enum ERecordType
+    {
+        RECORD_PACKET = 0,
+        RECORD_EVENT = 1,
+        RECORD_REGION = 2
+    };
+
+    static const U32 VERSION = 1;
+
+    // Returns the region handle of a sender, or 0 when it isn't a region (yet)
+    typedef std::function<U64(const LLHost&)> region_lookup_t;
+
+    LLMessageCapture(const region_lookup_t& region_lookup);
+    ~LLMessageCapture();
+
+    bool open(const std::string& filename);
+    void close();
+    bool isOpen() const { return mFile.is_open(); }
+
+    void recordPacket(const LLHost& sender, const U8* data, S32 size);
+    void recordEvent(const std::string& name, const LLSD& message);
+
+    U32 getRecordCount() const { return mRecordCount; }
+
+private:
+    void writeRecord(ERecordType type, const LLHost& sender, const U8* data, U32 size);
+
+    llofstream mFile;
+    U64 mStartUsec;
+    U32 mRecordCount;
+    region_lookup_t mRegionLookup;
+    std::set<LLHost> mKnownSenders;     // senders that already have a region record
+};
+
+// Feeds a capture back to the message system: packets through
+// LLMessageSystem::checkMessages, events through LLMessageSystem::dispatch,
+// either at the pace they were recorded or as fast as the viewer takes
+// them.  Recorded senders are mapped to the current host of the same
+// region, messages of regions that aren't connected are dropped.
+class LLMessageReplay
+{
+public:
+    // Returns the current host of a region handle, or an invalid host
+    typedef std::function<LLHost(U64)> region_host_t;
+
+    LLMessageReplay();
+
+    bool load(const std::string& filename);
+    void start(const region_host_t& region_host, bool max_speed);
+    bool isDone() const { return mNextRecord >= mRecords.size(); }
+
+    // Copies the next due packet to buffer, returns its size or 0 when no
+    // packet is due.  Called by checkMessages, from the main thread.
+    S32 nextPacket(U8* buffer, S32 max_size, LLHost& sender);
+
+    // Dispatches the events that are due, up to the next due packet
+    void dispatchEvents();
+
+    // Main thread time spent on a replayed message
+    void addTime(const std::string& name, U32 bytes, U64 usec);
+
+    void logReport() const;
+
+private:
+    struct Record
+    {
+        U8 mType;
+        U64 mUsec;
+        LLHost mSender;
+        size_t mOffset;     // in mData
+        U32 mSize;
+    };
+
+    struct Stat
+    {
+        U32 mCount = 0;
+        U64 mBytes = 0;
+        U64 mUsec = 0;
+    };
+
+    bool isDue(const Record& record) const;
+    bool mapSender(const LLHost& recorded, LLHost& current);
+
+    std::vector<U8> mData;
+    std::vector<Record> mRecords;
+    size_t mNextRecord;
+    std::map<LLHost, U64> mSenderRegions;   // from the region records
+    std::map<LLHost, LLHost> mSenderHosts;  // recorded to current, once found
+    region_host_t mRegionHost;
+    bool mMaxSpeed;
+    U64 mStartUsec;
+    U64 mEndUsec;
+    U32 mDropped;
+    std::map<std::string, Stat> mStats;
+};
+
+#endif // LL_LLMESSAGECAPTURE_H
@@ -36,13 +36,95 @@
 #endif
 
 // linden library includes
+#include "concurrentqueue.h"
 #include "llerror.h"
+#include "llthread.h"
 #include "lltimer.h"
 #include "llproxy.h"
 #include "llrand.h"
 #include "message.h"
 #include "u64.h"
 
+// Receives packets into pooled buffers as soon as they arrive
+class LLPacketReceiveThread : public LLThread
+{
+public:
+    // Packets received but not yet taken by the main thread, beyond which new ones are dropped
+    static constexpr size_t MAX_QUEUED_PACKETS = 4096;
+    // How often a thread waiting for packets checks whether it should quit
+    static constexpr U32 WAIT_MS = 50;
+
+    LLPacketReceiveThread(S32 socket)
+    :   LLThread("Packet receive"),
+        mSocket(socket),
+        mDropped(0)
+    {
+    }
+
+    ~LLPacketReceiveThread()
+    {
+        shutdown();
+
+        LLPacketBuffer* packetp = NULL;
+        while (mReceived.try_dequeue(packetp))
+        {
+            delete packetp;
+        }
+        while (mFree.try_dequeue(packetp))
+        {
+            delete packetp;
+        }
+    }
+
+    void run() override
+    {
+        while (!isQuitting())
+        {
+            S32 ready = wait_for_packet(mSocket, WAIT_MS);
+            if (ready < 0)
+            {
+                // don't spin on a broken socket
+                ms_sleep(WAIT_MS);
+                continue;
+            }
+
+            // drain everything the kernel holds
+            while (ready > 0 && !isQuitting())
+            {
+                LLPacketBuffer* packetp = NULL;
+                if (mFree.try_dequeue(packetp))
+                {
+                    packetp->init(mSocket);
+                }
+                else
+                {
+                    packetp = new LLPacketBuffer(mSocket);
+                }
+
+                if (packetp->getSize() <= 0)
+                {
+                    mFree.enqueue(packetp);
+                    ready = 0;
+                }
+                else if (mReceived.size_approx() >= MAX_QUEUED_PACKETS)
+                {
+                    mFree.enqueue(packetp);
+                    mDropped++;
+                }
+                else
+                {
+                    mReceived.enqueue(packetp);
+                }
+            }
+        }
+    }
+
+    S32 mSocket;
+    moodycamel::ConcurrentQueue<LLPacketBuffer*> mReceived;
+    moodycamel::ConcurrentQueue<LLPacketBuffer*> mFree;
+    std::atomic<U32> mDropped;
+};
+
 ///////////////////////////////////////////////////////////
 LLPacketRing::LLPacketRing () :
     mUseInThrottle(false),
@@ -68,6 +150,8 @@ LLPacketRing::~LLPacketRing ()
 ///////////////////////////////////////////////////////////
 void LLPacketRing::cleanup ()
 {
+    stopReceiveThread();
+
     LLPacketBuffer *packetp;
 
     while (!mReceiveQueue.empty())
@@ -85,6 +169,99 @@ void LLPacketRing::cleanup ()
     }
 }
 
+///////////////////////////////////////////////////////////
+void LLPacketRing::startReceiveThread(S32 socket)
+{
+    if (!mReceiveThread)
+    {
+        LL_INFOS("Messaging") << "Receiving packets on a separate thread" << LL_ENDL;
+        mReceiveThread = std::make_unique<LLPacketReceiveThread>(socket);
+        mReceiveThread->start();
+    }
+}
+
+void LLPacketRing::stopReceiveThread()
+{
+    // packets already queued up in the throttle ring stay there
+    mReceiveThread.reset();
+}
+
+LLPacketBuffer* LLPacketRing::pullPacket(S32 socket)
+{
+    LLPacketBuffer* packetp = NULL;
+    if (mReceiveThread)
+    {
+        mReceiveThread->mReceived.try_dequeue(packetp);
+        return packetp;
+    }
+
+    packetp = new LLPacketBuffer(socket);
+    if (packetp->getSize() <= 0)
+    {
+        delete packetp;
+        packetp = NULL;
+    }
+    return packetp;
+}
+
+void LLPacketRing::releasePacket(LLPacketBuffer* packetp)
+{
+    if (mReceiveThread)
+    {
+        mReceiveThread->mFree.enqueue(packetp);
+    }
+    else
+    {
+        delete packetp;
+    }
+}
+
+S32 LLPacketRing::receiveFromThread(char* datap)
+{
+    U32 dropped = mReceiveThread->mDropped.exchange(0);
+    if (dropped)
+    {
+        LL_WARNS("Messaging") << "Receive thread threw away " << dropped << " packets, main thread is not keeping up" << LL_ENDL;
+    }
+
+    LLPacketBuffer* packetp = pullPacket(0);
+    if (!packetp)
+    {
+        return 0;
+    }
+
+    S32 packet_size = packetp->getSize();
+    const char* data = packetp->getData();
+    mLastSender = packetp->getHost();
+    mLastReceivingIF = packetp->getReceivingInterface();
+
+    if (LLProxy::isSOCKSProxyEnabled())
+    {
+        if (packet_size > SOCKS_HEADER_SIZE)
+        {
+            // *FIX We are assuming ATYP is 0x01 (IPv4), not 0x03 (hostname) or 0x04 (IPv6)
+            const proxywrap_t* header = static_cast<const proxywrap_t*>(static_cast<const void*>(data));
+            mLastSender.setAddress(header->addr);
+            mLastSender.setPort(ntohs(header->port));
+
+            data += SOCKS_HEADER_SIZE;
+            packet_size -= SOCKS_HEADER_SIZE; // The unwrapped packet size
+        }
+        else
+        {
+            packet_size = 0;
+        }
+    }
+
+    if (packet_size > 0)
+    {
+        memcpy(datap, data, packet_size);
+    }
+    releasePacket(packetp);
+
+    return packet_size;
+}
+
 ///////////////////////////////////////////////////////////
 void LLPacketRing::dropPackets (U32 num_to_drop)
 {
@@ -144,7 +321,7 @@ S32 LLPacketRing::receiveFromRing (S32 socket, char *datap)
     // need to set sender IP/port!!
     mLastSender = packetp->getHost();
     mLastReceivingIF = packetp->getReceivingInterface();
-    delete packetp;
+    releasePacket(packetp);
 
     this->mInBufferLength -= packet_size;
 
@@ -161,59 +338,32 @@ S32 LLPacketRing::receivePacket (S32 socket, char *datap)
     // If using the throttle, simulate a limited size input buffer.
     if (mUseInThrottle)
     {
-        bool done = false;
-
         // push any current net packet (if any) onto delay ring
-        while (!done)
+        while (LLPacketBuffer* packetp = pullPacket(socket))
         {
-            LLPacketBuffer *packetp;
-            packetp = new LLPacketBuffer(socket);
+            mActualBitsIn += packetp->getSize() * 8;
 
-            if (packetp->getSize())
+            // Fake packet loss
+            if (mDropPercentage && (ll_frand(100.f) < mDropPercentage))
             {
-                mActualBitsIn += packetp->getSize() * 8;
-
-                // Fake packet loss
-                if (mDropPercentage && (ll_frand(100.f) < mDropPercentage))
-                {
-                    mPacketsToDrop++;
-                }
-
-                if (mPacketsToDrop)
-                {
-                    delete packetp;
-                    packetp = NULL;
-                    packet_size = 0;
-                    mPacketsToDrop--;
-                }
+                mPacketsToDrop++;
             }
 
-            // If we faked packet loss, then we don't have a packet
-            // to use for buffer overflow testing
-            if (packetp)
+            if (mPacketsToDrop)
             {
-                if (mInBufferLength + packetp->getSize() > mMaxBufferLength)
-                {
-                    // Toss it.
-                    LL_WARNS() << "Throwing away packet, overflowing buffer" << LL_ENDL;
-                    delete packetp;
-                    packetp = NULL;
-                }
-                else if (packetp->getSize())
-                {
-                    mReceiveQueue.push(packetp);
-                    mInBufferLength += packetp->getSize();
-                }
-                else
-                {
-                    delete packetp;
-                    packetp = NULL;
-                    done = true;
-                }
+                releasePacket(packetp);
+                mPacketsToDrop--;
+            }
+            else if (mInBufferLength + packetp->getSize() > mMaxBufferLength)
+            {
+                // Toss it.
+                LL_WARNS() << "Throwing away packet, overflowing buffer" << LL_ENDL;
+                releasePacket(packetp);
             }
             else
             {
-                // No packetp, keep going? - no packetp == faked packet loss
+                mReceiveQueue.push(packetp);
+                mInBufferLength += packetp->getSize();
             }
         }
 
@@ -221,6 +371,10 @@ S32 LLPacketRing::receivePacket (S32 socket, char *datap)
         // throttled bandwidth settings.
         packet_size = receiveFromRing(socket, datap);
     }
+    else if (mReceiveThread)
+    {
+        packet_size = receiveFromThread(datap);
+    }
     else
     {
         // no delay, pull straight from net
@@ -251,19 +405,20 @@ S32 LLPacketRing::receivePacket (S32 socket, char *datap)
         }
 
         mLastReceivingIF = ::get_receiving_interface();
+    }
 
-        if (packet_size)  // did we actually get a packet?
+    // the throttle ring simulates packet loss as packets enter it
+    if (!mUseInThrottle && packet_size)  // did we actually get a packet?
+    {
+        if (mDropPercentage && (ll_frand(100.f) < mDropPercentage))
         {
-            if (mDropPercentage && (ll_frand(100.f) < mDropPercentage))
-            {
-                mPacketsToDrop++;
-            }
+            mPacketsToDrop++;
+        }
 
-            if (mPacketsToDrop)
-            {
-                packet_size = 0;
-                mPacketsToDrop--;
-            }
+        if (mPacketsToDrop)
+        {
+            packet_size = 0;
+            mPacketsToDrop--;
         }
     }
 
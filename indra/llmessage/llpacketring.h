@@ -28,6 +28,7 @@
 #ifndef LL_LLPACKETRING_H
 #define LL_LLPACKETRING_H
 
+#include <memory>
 #include <queue>
 
 #include "llhost.h"
@@ -36,6 +37,8 @@
 #include "llthrottle.h"
 #include "net.h"
 
+class LLPacketReceiveThread;
+
 class LLPacketRing
 {
 public:
@@ -55,6 +58,12 @@ public:
 
     bool sendPacket(int h_socket, char * send_buffer, S32 buf_size, LLHost host);
 
+    // Drain the socket on a thread of its own, so that packets don't back up in the kernel
+    // buffer (and get dropped) while the main thread hitches.  receivePacket() then takes
+    // the packets that thread received, in order.  Must be stopped before the socket closes.
+    void startReceiveThread(S32 socket);
+    void stopReceiveThread();
+
     inline LLHost getLastSender();
     inline LLHost getLastReceivingInterface();
 
@@ -85,6 +94,13 @@ protected:
 
 private:
     bool sendPacketImpl(int h_socket, const char * send_buffer, S32 buf_size, LLHost host);
+
+    // Next packet from the receive thread or straight from the socket, NULL if there is none
+    LLPacketBuffer* pullPacket(S32 socket);
+    void releasePacket(LLPacketBuffer* packetp);
+    S32 receiveFromThread(char* datap);
+
+    std::unique_ptr<LLPacketReceiveThread> mReceiveThread;
 };
 
 
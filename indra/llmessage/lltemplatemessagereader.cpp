@@ -40,11 +40,17 @@
 
 #include "nd/ndexceptions.h" // <FS:ND/> For ndxran
 
+static bool sZeroCopy = false;
+
+// Stands in for fixed size variables that run off the end of the packet
+static const U8 sZeroes[MAX_BUFFER_SIZE] = {};
+
 LLTemplateMessageReader::LLTemplateMessageReader(message_template_number_map_t&
                                                  number_template_map) :
     mReceiveSize(0),
     mCurrentRMessageTemplate(NULL),
     mCurrentRMessageData(NULL),
+    mZeroCopyMessage(false),
     mMessageNumbers(number_template_map)
 {
 }
@@ -63,6 +69,94 @@ void LLTemplateMessageReader::clearMessage()
     mCurrentRMessageTemplate = NULL;
     delete mCurrentRMessageData;
     mCurrentRMessageData = NULL;
+    mZeroCopyMessage = false;
+    mBlockRefs.clear();
+    mVarRefs.clear();
+}
+
+//static
+void LLTemplateMessageReader::setZeroCopy(bool zero_copy)
+{
+    sZeroCopy = zero_copy;
+}
+
+//static
+bool LLTemplateMessageReader::getZeroCopy()
+{
+    return sZeroCopy;
+}
+
+S32 LLTemplateMessageReader::findVarRef(const char* blockname, const char* varname, S32 blocknum,
+                                        const LLMessageVariable*& var, const VarRef*& ref) const
+{
+    const LLMessageTemplate::message_block_map_t& blocks = mCurrentRMessageTemplate->mMemberBlocks;
+    LLMessageTemplate::message_block_map_t::const_iterator block_iter = blocks.find((char*)blockname);
+    if (block_iter == blocks.end())
+    {
+        return LL_BLOCK_NOT_IN_MESSAGE;
+    }
+
+    const BlockRef& block = mBlockRefs[block_iter - blocks.begin()];
+    if (blocknum < 0 || blocknum >= block.mRepeat)
+    {
+        return LL_BLOCK_NOT_IN_MESSAGE;
+    }
+
+    const LLMessageBlock::message_variable_map_t& vars = (*block_iter)->mMemberVariables;
+    LLMessageBlock::message_variable_map_t::const_iterator var_iter = vars.find(varname);
+    if (var_iter == vars.end())
+    {
+        return LL_VARIABLE_NOT_IN_BLOCK;
+    }
+
+    var = *var_iter;
+    ref = &mVarRefs[block.mFirstVar + blocknum * vars.size() + (var_iter - vars.begin())];
+    return 0;
+}
+
+void LLTemplateMessageReader::getVarRefData(const char* blockname, const char* varname, void* datap,
+                                            S32 size, S32 blocknum, S32 max_size)
+{
+    const LLMessageVariable* var = NULL;
+    const VarRef* ref = NULL;
+    S32 status = findVarRef(blockname, varname, blocknum, var, ref);
+    if (status == LL_BLOCK_NOT_IN_MESSAGE)
+    {
+        LL_ERRS() << "Block " << blockname << " #" << blocknum
+            << " not in message " << getMessageName() << LL_ENDL;
+        return;
+    }
+    if (status == LL_VARIABLE_NOT_IN_BLOCK)
+    {
+        LL_ERRS() << "Variable "<< varname << " not in message "
+            << getMessageName() << " block " << blockname << LL_ENDL;
+        return;
+    }
+
+    if (size && size != ref->mSize)
+    {
+        LL_ERRS() << "Msg " << getMessageName()
+            << " variable " << varname
+            << " is size " << ref->mSize
+            << " but copying into buffer of size " << size
+            << LL_ENDL;
+        return;
+    }
+
+    S32 copy_size = ref->mSize;
+    if (max_size < copy_size)
+    {
+        LL_WARNS() << "Msg " << getMessageName()
+            << " variable " << varname
+            << " is size " << ref->mSize
+            << " but truncated to max size of " << max_size
+            << LL_ENDL;
+        copy_size = max_size;
+    }
+    if (copy_size > 0)
+    {
+        htolememcpy(datap, ref->mData, var->getType(), copy_size);
+    }
 }
 
 void LLTemplateMessageReader::getData(const char *blockname, const char *varname, void *datap, S32 size, S32 blocknum, S32 max_size)
@@ -74,6 +168,12 @@ void LLTemplateMessageReader::getData(const char *blockname, const char *varname
         return;
     }
 
+    if (mZeroCopyMessage)
+    {
+        getVarRefData(blockname, varname, datap, size, blocknum, max_size);
+        return;
+    }
+
     if (!mCurrentRMessageData)
     {
         LL_ERRS() << "Invalid mCurrentMessageData in getData!" << LL_ENDL;
@@ -159,6 +259,13 @@ S32 LLTemplateMessageReader::getNumberOfBlocks(const char *blockname)
         return -1;
     }
 
+    if (mZeroCopyMessage)
+    {
+        const LLMessageTemplate::message_block_map_t& blocks = mCurrentRMessageTemplate->mMemberBlocks;
+        LLMessageTemplate::message_block_map_t::const_iterator iter = blocks.find((char*)blockname);
+        return iter == blocks.end() ? 0 : mBlockRefs[iter - blocks.begin()].mRepeat;
+    }
+
     if (!mCurrentRMessageData)
     {
         LL_ERRS() << "Invalid mCurrentRMessageData in getData!" << LL_ENDL;
@@ -186,6 +293,32 @@ S32 LLTemplateMessageReader::getSize(const char *blockname, const char *varname)
         return LL_MESSAGE_ERROR;
     }
 
+    if (mZeroCopyMessage)
+    {
+        const LLMessageVariable* var = NULL;
+        const VarRef* ref = NULL;
+        S32 status = findVarRef(blockname, varname, 0, var, ref);
+        if (status == LL_BLOCK_NOT_IN_MESSAGE)
+        {   // don't crash
+            LL_INFOS() << "Block " << blockname << " not in message "
+                << getMessageName() << LL_ENDL;
+            return status;
+        }
+        if (status == LL_VARIABLE_NOT_IN_BLOCK)
+        {   // don't crash
+            LL_INFOS() << "Variable " << varname << " not in message "
+                << getMessageName() << " block " << blockname << LL_ENDL;
+            return status;
+        }
+        if (mCurrentRMessageTemplate->mMemberBlocks[(char*)blockname]->mType != MBT_SINGLE)
+        {   // This is a serious error - crash
+            LL_ERRS() << "Block " << blockname << " isn't type MBT_SINGLE,"
+                " use getSize with blocknum argument!" << LL_ENDL;
+            return LL_MESSAGE_ERROR;
+        }
+        return ref->mSize;
+    }
+
     if (!mCurrentRMessageData)
     {   // This is a serious error - crash
         LL_ERRS() << "Invalid mCurrentRMessageData in getData!" << LL_ENDL;
@@ -234,6 +367,26 @@ S32 LLTemplateMessageReader::getSize(const char *blockname, S32 blocknum, const
         return LL_MESSAGE_ERROR;
     }
 
+    if (mZeroCopyMessage)
+    {
+        const LLMessageVariable* var = NULL;
+        const VarRef* ref = NULL;
+        S32 status = findVarRef(blockname, varname, blocknum, var, ref);
+        if (status == LL_BLOCK_NOT_IN_MESSAGE)
+        {   // don't crash
+            LL_INFOS() << "Block " << blockname << " #" << blocknum << " not in message "
+                << getMessageName() << LL_ENDL;
+            return status;
+        }
+        if (status == LL_VARIABLE_NOT_IN_BLOCK)
+        {   // don't crash
+            LL_INFOS() << "Variable " << varname << " not in message "
+                << getMessageName() << " block " << blockname << LL_ENDL;
+            return status;
+        }
+        return ref->mSize;
+    }
+
     if (!mCurrentRMessageData)
     {   // This is a serious error - crash
         LL_ERRS() << "Invalid mCurrentRMessageData in getData!" << LL_ENDL;
@@ -532,25 +685,97 @@ void LLTemplateMessageReader::logRanOffEndOfPacket( const LLHost& host, const S3
 
 static LLTrace::BlockTimerStatHandle FTM_PROCESS_MESSAGES("Process Messages");
 
-// decode a given message
-bool LLTemplateMessageReader::decodeData(const U8* buffer, const LLHost& sender )
+// <FS:Beq> storage for Tracy tag
+#ifdef TRACY_ENABLE
+static char msgstr[36];
+#endif
+// </FS:Beq>
+
+// how many of this block?
+bool LLTemplateMessageReader::readRepeatNumber(const LLMessageBlock& block, const U8* buffer, S32& decode_pos, U8& repeat_number) const
 {
-    LL_RECORD_BLOCK_TIME(FTM_PROCESS_MESSAGES);
+    if (block.mType == MBT_SINGLE)
+    {
+        // just one
+        repeat_number = 1;
+    }
+    else if (block.mType == MBT_MULTIPLE)
+    {
+        // a known number
+        repeat_number = block.mNumber;
+    }
+    else if (block.mType == MBT_VARIABLE)
+    {
+        // need to read the number from the message
+        // repeat number is a single byte
+        if (decode_pos >= mReceiveSize)
+        {
+            // commented out - hetgrid says that missing variable blocks
+            // at end of message are legal
+            // logRanOffEndOfPacket(sender, decode_pos, 1);
 
-    llassert( mReceiveSize >= 0 );
-    llassert( mCurrentRMessageTemplate);
+            // default to 0 repeats
+            repeat_number = 0;
+        }
+        else
+        {
+            repeat_number = buffer[decode_pos];
+            decode_pos++;
+        }
+    }
+    else
+    {
+        LL_ERRS() << "Unknown block type" << LL_ENDL;
+        return false;
+    }
+    return true;
+}
+
+// Reads the size header of a variable size variable, leaving decode_pos at its data
+U32 LLTemplateMessageReader::readVariableSize(const LLMessageVariable& var, const U8* buffer, S32& decode_pos, const LLHost& sender)
+{
+    // variable, get the number of bytes to read from the template
+    S32 data_size = var.getSize();
+    U8 tsizeb = 0;
+    U16 tsizeh = 0;
+    U32 tsize = 0;
+
+    if ((decode_pos + data_size) > mReceiveSize)
+    {
+        logRanOffEndOfPacket(sender, decode_pos, data_size);
+
+        // default to 0 length variable blocks
+        tsize = 0;
+    }
+    else
+    {
+        switch(data_size)
+        {
+        case 1:
+            htolememcpy(&tsizeb, &buffer[decode_pos], MVT_U8, 1);
+            tsize = tsizeb;
+            break;
+        case 2:
+            htolememcpy(&tsizeh, &buffer[decode_pos], MVT_U16, 2);
+            tsize = tsizeh;
+            break;
+        case 4:
+            htolememcpy(&tsize, &buffer[decode_pos], MVT_U32, 4);
+            break;
+        default:
+            LL_ERRS() << "Attempting to read variable field with unknown size of " << data_size << LL_ENDL;
+            break;
+        }
+    }
+    decode_pos += data_size;
+    return tsize;
+}
+
+// copy every variable of the message into a new LLMsgData
+bool LLTemplateMessageReader::decodeMsgData(const U8* buffer, S32 decode_pos, const LLHost& sender)
+{
     llassert( !mCurrentRMessageData );
     delete mCurrentRMessageData; // just to make sure
-	// <FS:Beq> storage for Tracy tag
-	#ifdef TRACY_ENABLE
-	static char msgstr[36];
-	#endif
-    // </FS:Beq>    
-
-    // The offset tells us how may bytes to skip after the end of the
-    // message name.
-    U8 offset = buffer[PHL_OFFSET];
-    S32 decode_pos = LL_PACKET_ID_SIZE + (S32)(mCurrentRMessageTemplate->mFrequency) + offset;
 
     // create base working data set
     mCurrentRMessageData = new LLMsgData(mCurrentRMessageTemplate->mName);
@@ -566,40 +791,8 @@ bool LLTemplateMessageReader::decodeData(const U8* buffer, const LLHost& sender
         U8  repeat_number;
         S32 i;
 
-        // how many of this block?
-
-        if (mbci->mType == MBT_SINGLE)
-        {
-            // just one
-            repeat_number = 1;
-        }
-        else if (mbci->mType == MBT_MULTIPLE)
-        {
-            // a known number
-            repeat_number = mbci->mNumber;
-        }
-        else if (mbci->mType == MBT_VARIABLE)
-        {
-            // need to read the number from the message
-            // repeat number is a single byte
-            if (decode_pos >= mReceiveSize)
-            {
-                // commented out - hetgrid says that missing variable blocks
-                // at end of message are legal
-                // logRanOffEndOfPacket(sender, decode_pos, 1);
-
-                // default to 0 repeats
-                repeat_number = 0;
-            }
-            else
-            {
-                repeat_number = buffer[decode_pos];
-                decode_pos++;
-            }
-        }
-        else
+        if (!readRepeatNumber(*mbci, buffer, decode_pos, repeat_number))
         {
-            LL_ERRS() << "Unknown block type" << LL_ENDL;
             return false;
         }
 
@@ -645,40 +838,7 @@ bool LLTemplateMessageReader::decodeData(const U8* buffer, const LLHost& sender
                 // what type of variable?
                 if (mvci.getType() == MVT_VARIABLE)
                 {
-                    // variable, get the number of bytes to read from the template
-                    S32 data_size = mvci.getSize();
-                    U8 tsizeb = 0;
-                    U16 tsizeh = 0;
-                    U32 tsize = 0;
-
-                    if ((decode_pos + data_size) > mReceiveSize)
-                    {
-                        logRanOffEndOfPacket(sender, decode_pos, data_size);
-
-                        // default to 0 length variable blocks
-                        tsize = 0;
-                    }
-                    else
-                    {
-                        switch(data_size)
-                        {
-                        case 1:
-                            htolememcpy(&tsizeb, &buffer[decode_pos], MVT_U8, 1);
-                            tsize = tsizeb;
-                            break;
-                        case 2:
-                            htolememcpy(&tsizeh, &buffer[decode_pos], MVT_U16, 2);
-                            tsize = tsizeh;
-                            break;
-                        case 4:
-                            htolememcpy(&tsize, &buffer[decode_pos], MVT_U32, 4);
-                            break;
-                        default:
-                            LL_ERRS() << "Attempting to read variable field with unknown size of " << data_size << LL_ENDL;
-                            break;
-                        }
-                    }
-                    decode_pos += data_size;
+                    U32 tsize = readVariableSize(mvci, buffer, decode_pos, sender);
 
                     cur_data_block->addData(mvci.getName(), &buffer[decode_pos], tsize, mvci.getType());
                     decode_pos += tsize;
@@ -716,6 +876,99 @@ bool LLTemplateMessageReader::decodeData(const U8* buffer, const LLHost& sender
         LL_DEBUGS() << "Empty message '" << mCurrentRMessageTemplate->mName << "' (no blocks)" << LL_ENDL;
         return false;
     }
+    return true;
+}
+
+// only record where each variable is, the getters decode them from the buffer
+bool LLTemplateMessageReader::decodeVarRefs(const U8* buffer, S32 decode_pos, const LLHost& sender)
+{
+    LL_PROFILE_ZONE_NAMED_CATEGORY_NETWORK("RefFromTemplate");
+    mBlockRefs.clear();
+    mVarRefs.clear();
+    S32 total_repeats = 0;
+
+    for (const LLMessageBlock* mbci : mCurrentRMessageTemplate->mMemberBlocks)
+    {
+        U8 repeat_number;
+        if (!readRepeatNumber(*mbci, buffer, decode_pos, repeat_number))
+        {
+            return false;
+        }
+
+        #ifdef TRACY_ENABLE
+        strncpy(msgstr, mbci->mName, 35);
+        #endif
+
+        mBlockRefs.push_back({ (U32)mVarRefs.size(), repeat_number });
+        total_repeats += repeat_number;
+
+        for (S32 i = 0; i < repeat_number; i++)
+        {
+            for (const LLMessageVariable* mvci : mbci->mMemberVariables)
+            {
+                VarRef ref;
+                if (mvci->getType() == MVT_VARIABLE)
+                {
+                    U32 tsize = readVariableSize(*mvci, buffer, decode_pos, sender);
+
+                    // never point past the packet, the getters read lazily
+                    S32 available = llmax(mReceiveSize - decode_pos, 0);
+                    ref.mSize = llmin((S32)tsize, available);
+                    ref.mData = ref.mSize ? &buffer[decode_pos] : sZeroes;
+                    decode_pos += tsize;
+                }
+                else
+                {
+                    ref.mSize = mvci->getSize();
+                    if ((decode_pos + ref.mSize) > mReceiveSize)
+                    {
+                        logRanOffEndOfPacket(sender, decode_pos, ref.mSize);
+
+                        // default to 0s.
+                        llassert(ref.mSize <= MAX_BUFFER_SIZE);
+                        ref.mData = sZeroes;
+                    }
+                    else
+                    {
+                        ref.mData = &buffer[decode_pos];
+                    }
+                    decode_pos += ref.mSize;
+                }
+                mVarRefs.push_back(ref);
+            }
+        }
+    }
+
+    if (!total_repeats && !mCurrentRMessageTemplate->mMemberBlocks.empty())
+    {
+        LL_DEBUGS() << "Empty message '" << mCurrentRMessageTemplate->mName << "' (no blocks)" << LL_ENDL;
+        return false;
+    }
+
+    mZeroCopyMessage = true;
+    return true;
+}
+
+// decode a given message
+bool LLTemplateMessageReader::decodeData(const U8* buffer, const LLHost& sender )
+{
+    LL_RECORD_BLOCK_TIME(FTM_PROCESS_MESSAGES);
+
+    llassert( mReceiveSize >= 0 );
+    llassert( mCurrentRMessageTemplate);
+    mZeroCopyMessage = false;
+
+    // The offset tells us how may bytes to skip after the end of the
+    // message name.
+    U8 offset = buffer[PHL_OFFSET];
+    S32 decode_pos = LL_PACKET_ID_SIZE + (S32)(mCurrentRMessageTemplate->mFrequency) + offset;
+
+    bool decoded = sZeroCopy ? decodeVarRefs(buffer, decode_pos, sender)
+                             : decodeMsgData(buffer, decode_pos, sender);
+    if (!decoded)
+    {
+        return false;
+    }
 
     {
         // <FS:Beq> Tracy Message processing
@@ -848,5 +1101,36 @@ void LLTemplateMessageReader::copyToBuilder(LLMessageBuilder& builder) const
     {
         return;
     }
+    if (mZeroCopyMessage)
+    {
+        LLMsgData data(mCurrentRMessageTemplate->mName);
+        fillMsgData(data);
+        builder.copyFromMessageData(data);
+        return;
+    }
     builder.copyFromMessageData(*mCurrentRMessageData);
 }
+
+// Builds the LLMsgData a copying decode would have made, for the rare users that need one
+void LLTemplateMessageReader::fillMsgData(LLMsgData& data) const
+{
+    U32 block_index = 0;
+    for (const LLMessageBlock* mbci : mCurrentRMessageTemplate->mMemberBlocks)
+    {
+        const BlockRef& block = mBlockRefs[block_index++];
+        const VarRef* ref = mVarRefs.data() + block.mFirstVar;
+        for (S32 i = 0; i < block.mRepeat; i++)
+        {
+            LLMsgBlkData* block_data = new LLMsgBlkData(mbci->mName, block.mRepeat);
+            block_data->mName = mbci->mName + i;
+            data.addBlock(block_data);
+
+            for (const LLMessageVariable* mvci : mbci->mMemberVariables)
+            {
+                block_data->addVariable(mvci->getName(), mvci->getType());
+                block_data->addData(mvci->getName(), ref->mData, ref->mSize, mvci->getType());
+                ++ref;
+            }
+        }
+    }
+}
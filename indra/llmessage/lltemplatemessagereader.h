@@ -30,8 +30,11 @@
 #include "llmessagereader.h"
 
 #include <map>
+#include <vector>
 
+class LLMessageBlock;
 class LLMessageTemplate;
+class LLMessageVariable;
 class LLMsgData;
 
 class LLTemplateMessageReader : public LLMessageReader
@@ -106,7 +109,28 @@ public:
     bool isBanned(bool trusted_source) const;
     bool isUdpBanned() const;
 
+    // Decode variables straight out of the packet buffer when a handler asks for
+    // them, instead of copying every variable into an LLMsgData before dispatch
+    // (MessageZeroCopyDecode).  The buffer passed to readMessage must then stay
+    // untouched until the next clearMessage.
+    static void setZeroCopy(bool zero_copy);
+    static bool getZeroCopy();
+
 private:
+    // Where one variable of the current message lives in the packet buffer
+    struct VarRef
+    {
+        const U8* mData;
+        S32 mSize;
+    };
+
+    // One template block of the current message, its variables are mRepeat
+    // runs of the template variables starting at mVarRefs[mFirstVar]
+    struct BlockRef
+    {
+        U32 mFirstVar;
+        S32 mRepeat;
+    };
 
     void getData(const char *blockname, const char *varname, void *datap,
                  S32 size = 0, S32 blocknum = 0, S32 max_size = S32_MAX);
@@ -117,10 +141,27 @@ private:
     void logRanOffEndOfPacket( const LLHost& host, const S32 where, const S32 wanted );
 
     bool decodeData(const U8* buffer, const LLHost& sender );
+    bool decodeMsgData(const U8* buffer, S32 decode_pos, const LLHost& sender);
+    bool decodeVarRefs(const U8* buffer, S32 decode_pos, const LLHost& sender);
+
+    bool readRepeatNumber(const LLMessageBlock& block, const U8* buffer, S32& decode_pos, U8& repeat_number) const;
+    U32 readVariableSize(const LLMessageVariable& var, const U8* buffer, S32& decode_pos, const LLHost& sender);
+
+    // Zero copy lookups, return 0, LL_BLOCK_NOT_IN_MESSAGE or LL_VARIABLE_NOT_IN_BLOCK
+    S32 findVarRef(const char* blockname, const char* varname, S32 blocknum,
+                   const LLMessageVariable*& var, const VarRef*& ref) const;
+    void getVarRefData(const char* blockname, const char* varname, void* datap,
+                       S32 size, S32 blocknum, S32 max_size);
+    void fillMsgData(LLMsgData& data) const;
 
     S32 mReceiveSize;
     LLMessageTemplate* mCurrentRMessageTemplate;
     LLMsgData* mCurrentRMessageData;
+
+    // Per message arena of the zero copy decode, cleared but never shrunk
+    bool mZeroCopyMessage;
+    std::vector<BlockRef> mBlockRefs;   // by template block index
+    std::vector<VarRef> mVarRefs;
     message_template_number_map_t& mMessageNumbers;
 };
 
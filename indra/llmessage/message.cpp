@@ -39,6 +39,7 @@
 #include <iomanip>
 #include <iterator>
 #include <sstream>
+#include <unordered_map>
 
 #include "llapr.h"
 #include "apr_portable.h"
@@ -54,6 +55,7 @@
 #include "llhttpnodeadapter.h"
 #include "llmd5.h"
 #include "llmessagebuilder.h"
+#include "llmessagecapture.h"
 #include "llmessageconfig.h"
 #include "lltemplatemessagedispatcher.h"
 #include "llpumpio.h"
@@ -191,6 +193,9 @@ void LLMessageSystem::init()
     mTimingCallback = NULL;
     mTimingCallbackData = NULL;
 
+    mCapture = NULL;
+    mReplay = NULL;
+
     mMessageBuilder = NULL;
     LockMessageReader(mMessageReader, NULL);
 }
@@ -330,6 +335,7 @@ LLMessageSystem::~LLMessageSystem()
 
     if (!mbError)
     {
+        mPacketRing.stopReceiveThread();
         end_net(mSocket);
     }
     mSocket = 0;
@@ -516,13 +522,28 @@ bool LLMessageSystem::checkMessages(LockMessageChecker&, S64 frame_count )
 
         U8* buffer = mTrueReceiveBuffer;
 
-        mTrueReceiveSize = mPacketRing.receivePacket(mSocket, (char *)mTrueReceiveBuffer);
+        LLHost replay_sender;
+        mTrueReceiveSize = mReplay ? mReplay->nextPacket(mTrueReceiveBuffer, MAX_BUFFER_SIZE, replay_sender) : 0;
+        const bool replayed = mTrueReceiveSize > 0;
+        if (replayed)
+        {
+            mLastSender = replay_sender;
+            mLastReceivingIF = LLHost();
+        }
+        else
+        {
+            mTrueReceiveSize = mPacketRing.receivePacket(mSocket, (char *)mTrueReceiveBuffer);
+            mLastSender = mPacketRing.getLastSender();
+            mLastReceivingIF = mPacketRing.getLastReceivingInterface();
+            if (mCapture)
+            {
+                mCapture->recordPacket(mLastSender, mTrueReceiveBuffer, mTrueReceiveSize);
+            }
+        }
         // If you want to dump all received packets into SecondLife.log, uncomment this
         //dumpPacketToLog();
 
         receive_size = mTrueReceiveSize;
-        mLastSender = mPacketRing.getLastSender();
-        mLastReceivingIF = mPacketRing.getLastReceivingInterface();
 
         if (receive_size < (S32) LL_MINIMUM_VALID_PACKET_SIZE)
         {
@@ -691,10 +712,18 @@ bool LLMessageSystem::checkMessages(LockMessageChecker&, S64 frame_count )
 
                 // valid_packet = mTemplateMessageReader->readMessage(buffer, host);
 
+                const char* msg_name = mTemplateMessageReader->getMessageName();
+                U64 read_start = replayed ? (U64)totalTime() : 0;
+
                 try { valid_packet = mTemplateMessageReader->readMessage(buffer, host); }
                 catch( nd::exceptions::xran &ex ) { LL_WARNS() << ex.what() << LL_ENDL; }
 
                 // </FS:ND>
+
+                if (replayed)
+                {
+                    mReplay->addTime(msg_name, mTrueReceiveSize, totalTime() - read_start);
+                }
             }
 
             // It's possible that the circuit went away, because ANY message can disable the circuit
@@ -2056,25 +2085,43 @@ void LLMessageSystem::dispatch(
     const LLSD& message,
     LLHTTPNode::ResponsePtr responsep)
 {
-    if ((gMessageSystem->mMessageTemplates.find
-            (LLMessageStringTable::getInstance()->getString(msg_name.c_str())) ==
-                gMessageSystem->mMessageTemplates.end()) &&
-        !LLMessageConfig::isValidMessage(msg_name))
+    // A message name always resolves to the same handler and context, so the
+    // validity check and the path traversal only run the first time a name is
+    // seen. Event queue bursts dispatch the same few names over and over.
+    struct DispatchEntry
     {
-        LL_WARNS("Messaging") << "Ignoring unknown message " << msg_name << LL_ENDL;
-        responsep->notFound("Invalid message name");
-        return;
-    }
+        const LLHTTPNode* mHandler;
+        LLSD mContext;
+    };
+    static std::unordered_map<std::string, DispatchEntry> dispatch_table;
 
-    std::string path = "/message/" + msg_name;
-    LLSD context;
-    const LLHTTPNode* handler = messageRootNode().traverse(path, context);
-    if (!handler)
+    auto found = dispatch_table.find(msg_name);
+    if (found == dispatch_table.end())
     {
-        LL_WARNS("Messaging")   << "LLMessageService::dispatch > no handler for "
-                << path << LL_ENDL;
-        return;
+        if ((gMessageSystem->mMessageTemplates.find
+                (LLMessageStringTable::getInstance()->getString(msg_name.c_str())) ==
+                    gMessageSystem->mMessageTemplates.end()) &&
+            !LLMessageConfig::isValidMessage(msg_name))
+        {
+            LL_WARNS("Messaging") << "Ignoring unknown message " << msg_name << LL_ENDL;
+            responsep->notFound("Invalid message name");
+            return;
+        }
+
+        std::string path = "/message/" + msg_name;
+        LLSD context;
+        const LLHTTPNode* handler = messageRootNode().traverse(path, context);
+        if (!handler)
+        {
+            LL_WARNS("Messaging")   << "LLMessageService::dispatch > no handler for "
+                    << path << LL_ENDL;
+            return;
+        }
+        found = dispatch_table.emplace(msg_name, DispatchEntry{ handler, context }).first;
     }
+
+    const LLHTTPNode* handler = found->second.mHandler;
+    const LLSD& context = found->second.mContext;
     // enable this for output of message names
     LL_DEBUGS("Messaging") << "< \"" << msg_name << "\"" << LL_ENDL;
     LL_DEBUGS("Messaging") << "context: " << context << LL_ENDL;
@@ -160,6 +160,8 @@ class LLQuaternion;
 class LLSD;
 class LLUUID;
 class LLMessageSystem;
+class LLMessageCapture;
+class LLMessageReplay;
 class LLPumpIO;
 
 // message system exceptional condition handlers.
@@ -373,6 +375,9 @@ public:
     bool isOK() const { return !mbError; }
     S32 getErrorCode() const { return mErrorCode; }
 
+    // Receive packets on a thread of their own, see LLPacketRing::startReceiveThread
+    void startReceiveThread() { if (isOK()) mPacketRing.startReceiveThread(mSocket); }
+
     // Read file and build message templates filename must point to a
     // valid string which specifies the path of a valid linden
     // template.
@@ -822,6 +827,13 @@ public:
     // is read: use with caution!
     void receivedMessageFromTrustedSender();
 
+    // Record received packets to a capture, and take packets from a replay
+    // before the socket, see llmessagecapture.h.  Not owned, NULL to stop.
+    void setCapture(LLMessageCapture* capture) { mCapture = capture; }
+    LLMessageCapture* getCapture() const { return mCapture; }
+    void setReplay(LLMessageReplay* replay) { mReplay = replay; }
+    LLMessageReplay* getReplay() const { return mReplay; }
+
     // <FS:Ansariel> Restore original LLMessageSystem HTTP options for OpenSim
     void setIsInSecondLife(bool in_second_life) { mIsInSecondLife = in_second_life; }
 
@@ -893,6 +905,9 @@ private:
     msg_timing_callback mTimingCallback;
     void* mTimingCallbackData;
 
+    LLMessageCapture* mCapture;
+    LLMessageReplay* mReplay;
+
     void init(); // ctor shared initialisation.
 
     LLHost mLastSender;
@@ -35,6 +35,7 @@
 #include "llwin32headerslean.h"
 #else
     #include <sys/types.h>
+    #include <sys/select.h>
     #include <sys/socket.h>
     #include <netinet/in.h>
     #include <arpa/inet.h>
@@ -112,6 +113,20 @@ U32 get_receiving_interface_ip(void)
     return gsnReceivingIFAddr;
 }
 
+S32 wait_for_packet(int hSocket, U32 timeout_ms)
+{
+    fd_set read_set;
+    FD_ZERO(&read_set);
+    FD_SET(hSocket, &read_set);
+
+    struct timeval timeout;
+    timeout.tv_sec = timeout_ms / 1000;
+    timeout.tv_usec = (timeout_ms % 1000) * 1000;
+
+    // the first argument is ignored on Windows
+    return select(hSocket + 1, &read_set, NULL, NULL, &timeout);
+}
+
 const char* u32_to_ip_string(U32 ip)
 {
     static char buffer[MAXADDRSTR];  /* Flawfinder: ignore */
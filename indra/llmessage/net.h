@@ -43,6 +43,10 @@ void    end_net(S32& socket_out);
 // returns size of packet or -1 in case of error
 S32     receive_packet(int hSocket, char * receiveBuffer);
 
+// Waits up to timeout_ms for a packet to arrive.  Returns > 0 if one can be received,
+// 0 on timeout or < 0 in case of error.
+S32     wait_for_packet(int hSocket, U32 timeout_ms);
+
 bool    send_packet(int hSocket, const char *sendBuffer, int size, U32 recipient, int nPort);   // Returns true on success.
 
 //void  get_sender(char * tmp);
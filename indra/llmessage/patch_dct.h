@@ -89,6 +89,8 @@ void get_patch_group_header(LLGroupHeader *gopp);
 void set_group_of_patch_header(LLGroupHeader *gopp);
 void init_patch_decompressor(S32 size);
 void decompress_patch(F32 *patch, S32 *cpatch, LLPatchHeader *ph);
+// Same without the group header set by set_group_of_patch_header, safe to call from any thread
+void decompress_patch(F32 *patch, S32 *cpatch, const LLPatchHeader *ph, S32 size, S32 stride);
 void decompress_patchv(LLVector3 *v, S32 *cpatch, LLPatchHeader *ph);
 
 #endif
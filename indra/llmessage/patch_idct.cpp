@@ -24,38 +24,59 @@
  * $/LicenseInfo$
  */
 
+
 #include "linden_common.h"
 
 #include "llmath.h"
 //#include "vmath.h"
 #include "v3math.h"
+#include "llvector4a.h"
 #include "patch_dct.h"
 
-LLGroupHeader   *gGOPP;
+// Per thread, so that land patches can be decompressed off the main thread
+// while wind and clouds are decompressed on it
+thread_local LLGroupHeader  *gGOPP;
 
 void set_group_of_patch_header(LLGroupHeader *gopp)
 {
     gGOPP = gopp;
 }
 
-F32 gPatchDequantizeTable[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE];
-void build_patch_dequantize_table(S32 size)
+// Dequantize, inverse cosine and zigzag tables for one patch size.  Built once
+// for each size and never changed afterwards, so any thread may read them.
+struct LLPatchDecompressTables
+{
+    LLPatchDecompressTables(S32 size);
+
+    void buildDequantizeTable(S32 size);
+    void setupICosines(S32 size);
+    void buildDecopyMatrix(S32 size);
+
+    LL_ALIGN_16(F32 mDequantize[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE]);
+    LL_ALIGN_16(F32 mICosines[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE]);
+    S32 mDeCopy[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE];
+};
+
+LLPatchDecompressTables::LLPatchDecompressTables(S32 size)
+{
+    buildDequantizeTable(size);
+    setupICosines(size);
+    buildDecopyMatrix(size);
+}
+
+void LLPatchDecompressTables::buildDequantizeTable(S32 size)
 {
     S32 i, j;
     for (j = 0; j < size; j++)
     {
         for (i = 0; i < size; i++)
         {
-            gPatchDequantizeTable[j*size + i] = (1.f + 2.f*(i+j));
+            mDequantize[j*size + i] = (1.f + 2.f*(i+j));
         }
     }
 }
 
-S32 gCurrentDeSize = 0;
-
-F32 gPatchICosines[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE];
-
-void setup_patch_icosines(S32 size)
+void LLPatchDecompressTables::setupICosines(S32 size)
 {
     S32 n, u;
     F32 oosob = F_PI*0.5f/size;
@@ -64,14 +85,12 @@ void setup_patch_icosines(S32 size)
     {
         for (n = 0; n < size; n++)
         {
-            gPatchICosines[u*size+n] = cosf((2.f*n+1.f)*u*oosob);
+            mICosines[u*size+n] = cosf((2.f*n+1.f)*u*oosob);
         }
     }
 }
 
-S32 gDeCopyMatrix[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE];
-
-void build_decopy_matrix(S32 size)
+void LLPatchDecompressTables::buildDecopyMatrix(S32 size)
 {
     S32 i, j, count;
     bool    b_diag = false;
@@ -84,7 +103,7 @@ void build_decopy_matrix(S32 size)
     while (  (i < size)
            &&(j < size))
     {
-        gDeCopyMatrix[j*size + i] = count;
+        mDeCopy[j*size + i] = count;
 
         count++;
 
@@ -135,494 +154,157 @@ void build_decopy_matrix(S32 size)
     }
 }
 
-void init_patch_decompressor(S32 size)
+static const LLPatchDecompressTables& get_patch_decompress_tables(S32 size)
 {
-    if (size != gCurrentDeSize)
-    {
-        gCurrentDeSize = size;
-        build_patch_dequantize_table(size);
-        setup_patch_icosines(size);
-        build_decopy_matrix(size);
-    }
+    static const LLPatchDecompressTables normal_tables(NORMAL_PATCH_SIZE);
+    static const LLPatchDecompressTables large_tables(LARGE_PATCH_SIZE);
+    llassert(size == NORMAL_PATCH_SIZE || size == LARGE_PATCH_SIZE);
+    return size == LARGE_PATCH_SIZE ? large_tables : normal_tables;
 }
 
-inline void idct_line(F32 *linein, F32 *lineout, S32 line)
+void init_patch_decompressor(S32 size)
 {
-    S32 n;
-    F32 total;
-    F32 *pcp = gPatchICosines;
-
-#ifdef _PATCH_SIZE_16_AND_32_ONLY
-    F32 oosob = 2.f/16.f;
-    S32 line_size = line*NORMAL_PATCH_SIZE;
-    F32 *tlinein, *tpcp;
-
+    // The tables are built on first use, this only makes sure it happens up front
+    get_patch_decompress_tables(size);
+}
 
-    for (n = 0; n < NORMAL_PATCH_SIZE; n++)
-    {
-        tpcp = pcp + n;
-        tlinein = linein + line_size;
-
-        total = OO_SQRT2*(*(tlinein++));
-        total += *(tlinein++)*(*(tpcp += NORMAL_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += NORMAL_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += NORMAL_PATCH_SIZE));
-
-        total += *(tlinein++)*(*(tpcp += NORMAL_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += NORMAL_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += NORMAL_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += NORMAL_PATCH_SIZE));
-
-        total += *(tlinein++)*(*(tpcp += NORMAL_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += NORMAL_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += NORMAL_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += NORMAL_PATCH_SIZE));
-
-        total += *(tlinein++)*(*(tpcp += NORMAL_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += NORMAL_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += NORMAL_PATCH_SIZE));
-        total += *(tlinein)*(*(tpcp += NORMAL_PATCH_SIZE));
-
-        *(lineout + line_size + n) = total*oosob;
-    }
-#else
-    F32 oosob = 2.f/size;
-    S32 size = gGOPP->patch_size;
-    S32 line_size = line*size;
-    S32 u;
+// Separable inverse DCT of a size x size block (16 or 32), in place.
+//
+// Both passes sum rows scaled by one value each, so every output row is
+// built four values at a time:  the column pass scales rows of the block by
+// a cosine, the line pass scales rows of the cosine table by a coefficient.
+// Terms are added in the same order as the scalar transform, so results match
+// it exactly.  The size is a template parameter so the inner loops unroll.
+//
+// Quantization zeroes most high frequencies, so only the first rows and
+// columns of coefficients hold anything:  terms from beyond them are skipped.
+template<S32 size>
+static void idct_patch(F32 *block, const F32 *icosines, S32 rows, S32 cols)
+{
+    LL_ALIGN_16(F32 temp[size*size]);
+    LLVector4a acc[size/4];
+    LLVector4a scale;
+    LLVector4a val;
+    constexpr S32 quads = size/4;
+    S32 n, u, q;
+
+    // columns: temp[n][c] = sum over u of block[u][c]*cos[u][n]
     for (n = 0; n < size; n++)
     {
-        total = OO_SQRT2*linein[line_size];
-        for (u = 1; u < size; u++)
+        scale.splat(OO_SQRT2);
+        for (q = 0; q < quads; q++)
+        {
+            acc[q].load4a(block + q*4);
+            acc[q].mul(scale);
+        }
+        for (u = 1; u < rows; u++)
         {
-            total += linein[line_size + u]*pcp[u*size+n];
+            scale.splat(icosines[u*size + n]);
+            const F32 *row = block + u*size;
+            for (q = 0; q < quads; q++)
+            {
+                val.load4a(row + q*4);
+                val.mul(scale);
+                acc[q].add(val);
+            }
+        }
+        for (q = 0; q < quads; q++)
+        {
+            acc[q].store4a(temp + n*size + q*4);
         }
-        lineout[line_size + n] = total*oosob;
     }
-#endif
-}
-
-inline void idct_line_large_slow(F32 *linein, F32 *lineout, S32 line)
-{
-    S32 n;
-    F32 total;
-    F32 *pcp = gPatchICosines;
-
-    F32 oosob = 2.f/32.f;
-    S32 line_size = line*LARGE_PATCH_SIZE;
-    F32 *tlinein, *tpcp;
 
-
-    for (n = 0; n < LARGE_PATCH_SIZE; n++)
+    // lines: block[l][n] = 2/size * sum over u of temp[l][u]*cos[u][n]
+    LLVector4a oosob;
+    oosob.splat(2.f/size);
+    for (S32 line = 0; line < size; line++)
     {
-        tpcp = pcp + n;
-        tlinein = linein + line_size;
-
-        total = OO_SQRT2*(*(tlinein++));
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein)*(*(tpcp += LARGE_PATCH_SIZE));
-
-        *(lineout + line_size + n) = total*oosob;
+        const F32 *linein = temp + line*size;
+        for (q = 0; q < quads; q++)
+        {
+            acc[q].splat(OO_SQRT2*linein[0]);
+        }
+        for (u = 1; u < cols; u++)
+        {
+            scale.splat(linein[u]);
+            const F32 *row = icosines + u*size;
+            for (q = 0; q < quads; q++)
+            {
+                val.load4a(row + q*4);
+                val.mul(scale);
+                acc[q].add(val);
+            }
+        }
+        for (q = 0; q < quads; q++)
+        {
+            acc[q].mul(oosob);
+            acc[q].store4a(block + line*size + q*4);
+        }
     }
 }
 
-// Nota Bene: assumes that coefficients beyond 128 are 0!
-
-void idct_line_large(F32 *linein, F32 *lineout, S32 line)
-{
-    S32 n;
-    F32 total;
-    F32 *pcp = gPatchICosines;
-
-    F32 oosob = 2.f/32.f;
-    S32 line_size = line*LARGE_PATCH_SIZE;
-    F32 *tlinein, *tpcp;
-    F32 *baselinein = linein + line_size;
-    F32 *baselineout = lineout + line_size;
-
-
-    for (n = 0; n < LARGE_PATCH_SIZE; n++)
-    {
-        tpcp = pcp++;
-        tlinein = baselinein;
-
-        total = OO_SQRT2*(*(tlinein++));
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein++)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein)*(*(tpcp));
-
-        *baselineout++ = total*oosob;
-    }
-}
+S32 gDitherNoise = 128;
 
-inline void idct_column(F32 *linein, F32 *lineout, S32 column)
+// Dequantize and transform cpatch into a size x size block of values
+static void decompress_block(F32 *block, S32 *cpatch, const LLPatchHeader *ph, S32 size, F32 &mult, F32 &addval)
 {
-    S32 n;
-    F32 total;
-    F32 *pcp = gPatchICosines;
+    const LLPatchDecompressTables &tables = get_patch_decompress_tables(size);
 
-#ifdef _PATCH_SIZE_16_AND_32_ONLY
-    F32 *tlinein, *tpcp;
+    F32     range = ph->range;
+    S32     prequant = (ph->quant_wbits >> 4) + 2;
+    S32     quantize = 1<<prequant;
+    F32     hmin = ph->dc_offset;
 
-    for (n = 0; n < NORMAL_PATCH_SIZE; n++)
-    {
-        tpcp = pcp + n;
-        tlinein = linein + column;
-
-        total = OO_SQRT2*(*tlinein);
-        total += *(tlinein += NORMAL_PATCH_SIZE)*(*(tpcp += NORMAL_PATCH_SIZE));
-        total += *(tlinein += NORMAL_PATCH_SIZE)*(*(tpcp += NORMAL_PATCH_SIZE));
-        total += *(tlinein += NORMAL_PATCH_SIZE)*(*(tpcp += NORMAL_PATCH_SIZE));
-
-        total += *(tlinein += NORMAL_PATCH_SIZE)*(*(tpcp += NORMAL_PATCH_SIZE));
-        total += *(tlinein += NORMAL_PATCH_SIZE)*(*(tpcp += NORMAL_PATCH_SIZE));
-        total += *(tlinein += NORMAL_PATCH_SIZE)*(*(tpcp += NORMAL_PATCH_SIZE));
-        total += *(tlinein += NORMAL_PATCH_SIZE)*(*(tpcp += NORMAL_PATCH_SIZE));
-
-        total += *(tlinein += NORMAL_PATCH_SIZE)*(*(tpcp += NORMAL_PATCH_SIZE));
-        total += *(tlinein += NORMAL_PATCH_SIZE)*(*(tpcp += NORMAL_PATCH_SIZE));
-        total += *(tlinein += NORMAL_PATCH_SIZE)*(*(tpcp += NORMAL_PATCH_SIZE));
-        total += *(tlinein += NORMAL_PATCH_SIZE)*(*(tpcp += NORMAL_PATCH_SIZE));
-
-        total += *(tlinein += NORMAL_PATCH_SIZE)*(*(tpcp += NORMAL_PATCH_SIZE));
-        total += *(tlinein += NORMAL_PATCH_SIZE)*(*(tpcp += NORMAL_PATCH_SIZE));
-        total += *(tlinein += NORMAL_PATCH_SIZE)*(*(tpcp += NORMAL_PATCH_SIZE));
-        total += *(tlinein += NORMAL_PATCH_SIZE)*(*(tpcp += NORMAL_PATCH_SIZE));
-
-        *(lineout + (n<<4) + column) = total;
-    }
+    F32     ooq = 1.f/(F32)quantize;
+    const F32   *dq = tables.mDequantize;
+    const S32   *decopy_matrix = tables.mDeCopy;
 
-#else
-    S32 size = gGOPP->patch_size;
-    S32 u;
-    S32 u_size;
+    mult = ooq*range;
+    addval = mult*(F32)(1<<(prequant - 1))+hmin;
 
-    for (n = 0; n < size; n++)
+    // extent of the non zero coefficients
+    S32 rows = 1;
+    S32 cols = 1;
+    for (S32 j = 0; j < size; j++)
     {
-        total = OO_SQRT2*linein[column];
-        for (u = 1; u < size; u++)
+        for (S32 i = 0; i < size; i++)
         {
-            u_size = u*size;
-            total += linein[u_size + column]*pcp[u_size+n];
+            S32 k = j*size + i;
+            S32 c = cpatch[decopy_matrix[k]];
+            block[k] = c*dq[k];
+            if (c)
+            {
+                rows = llmax(rows, j + 1);
+                cols = llmax(cols, i + 1);
+            }
         }
-        lineout[size*n + column] = total;
     }
-#endif
-}
-
-inline void idct_column_large_slow(F32 *linein, F32 *lineout, S32 column)
-{
-    S32 n;
-    F32 total;
-    F32 *pcp = gPatchICosines;
 
-    F32 *tlinein, *tpcp;
-
-    for (n = 0; n < LARGE_PATCH_SIZE; n++)
+    if (size == LARGE_PATCH_SIZE)
     {
-        tpcp = pcp + n;
-        tlinein = linein + column;
-
-        total = OO_SQRT2*(*tlinein);
-        total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-
-        total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-
-        total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-
-        total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-
-        total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-
-        total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-
-        total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-
-        total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-        total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-
-        *(lineout + (n<<5) + column) = total;
-    }
-}
-
-// Nota Bene: assumes that coefficients beyond 128 are 0!
-
-void idct_column_large(F32 *linein, F32 *lineout, S32 column)
-{
-    S32 n, m;
-    F32 total;
-    F32 *pcp = gPatchICosines;
-
-    F32 *tlinein, *tpcp;
-    F32 *baselinein = linein + column;
-    F32 *baselineout = lineout + column;
-
-    for (n = 0; n < LARGE_PATCH_SIZE; n++)
-    {
-        tpcp = pcp++;
-        tlinein = baselinein;
-
-        total = OO_SQRT2*(*tlinein);
-        for (m = 1; m < NORMAL_PATCH_SIZE; m++)
-            total += *(tlinein += LARGE_PATCH_SIZE)*(*(tpcp += LARGE_PATCH_SIZE));
-
-        *(baselineout + (n<<5)) = total;
+        idct_patch<LARGE_PATCH_SIZE>(block, tables.mICosines, rows, cols);
     }
-}
-
-inline void idct_patch(F32 *block)
-{
-    F32 temp[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE];
-
-#ifdef _PATCH_SIZE_16_AND_32_ONLY
-    idct_column(block, temp, 0);
-    idct_column(block, temp, 1);
-    idct_column(block, temp, 2);
-    idct_column(block, temp, 3);
-
-    idct_column(block, temp, 4);
-    idct_column(block, temp, 5);
-    idct_column(block, temp, 6);
-    idct_column(block, temp, 7);
-
-    idct_column(block, temp, 8);
-    idct_column(block, temp, 9);
-    idct_column(block, temp, 10);
-    idct_column(block, temp, 11);
-
-    idct_column(block, temp, 12);
-    idct_column(block, temp, 13);
-    idct_column(block, temp, 14);
-    idct_column(block, temp, 15);
-
-    idct_line(temp, block, 0);
-    idct_line(temp, block, 1);
-    idct_line(temp, block, 2);
-    idct_line(temp, block, 3);
-
-    idct_line(temp, block, 4);
-    idct_line(temp, block, 5);
-    idct_line(temp, block, 6);
-    idct_line(temp, block, 7);
-
-    idct_line(temp, block, 8);
-    idct_line(temp, block, 9);
-    idct_line(temp, block, 10);
-    idct_line(temp, block, 11);
-
-    idct_line(temp, block, 12);
-    idct_line(temp, block, 13);
-    idct_line(temp, block, 14);
-    idct_line(temp, block, 15);
-#else
-    S32 i;
-    S32 size = gGOPP->patch_size;
-    for (i = 0; i < size; i++)
-    {
-        idct_column(block, temp, i);
-    }
-    for (i = 0; i < size; i++)
+    else
     {
-        idct_line(temp, block, i);
+        idct_patch<NORMAL_PATCH_SIZE>(block, tables.mICosines, rows, cols);
     }
-#endif
 }
 
-inline void idct_patch_large(F32 *block)
+void decompress_patch(F32 *patch, S32 *cpatch, LLPatchHeader *ph)
 {
-    F32 temp[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE];
-
-    idct_column_large_slow(block, temp, 0);
-    idct_column_large_slow(block, temp, 1);
-    idct_column_large_slow(block, temp, 2);
-    idct_column_large_slow(block, temp, 3);
-
-    idct_column_large_slow(block, temp, 4);
-    idct_column_large_slow(block, temp, 5);
-    idct_column_large_slow(block, temp, 6);
-    idct_column_large_slow(block, temp, 7);
-
-    idct_column_large_slow(block, temp, 8);
-    idct_column_large_slow(block, temp, 9);
-    idct_column_large_slow(block, temp, 10);
-    idct_column_large_slow(block, temp, 11);
-
-    idct_column_large_slow(block, temp, 12);
-    idct_column_large_slow(block, temp, 13);
-    idct_column_large_slow(block, temp, 14);
-    idct_column_large_slow(block, temp, 15);
-
-    idct_column_large_slow(block, temp, 16);
-    idct_column_large_slow(block, temp, 17);
-    idct_column_large_slow(block, temp, 18);
-    idct_column_large_slow(block, temp, 19);
-
-    idct_column_large_slow(block, temp, 20);
-    idct_column_large_slow(block, temp, 21);
-    idct_column_large_slow(block, temp, 22);
-    idct_column_large_slow(block, temp, 23);
-
-    idct_column_large_slow(block, temp, 24);
-    idct_column_large_slow(block, temp, 25);
-    idct_column_large_slow(block, temp, 26);
-    idct_column_large_slow(block, temp, 27);
-
-    idct_column_large_slow(block, temp, 28);
-    idct_column_large_slow(block, temp, 29);
-    idct_column_large_slow(block, temp, 30);
-    idct_column_large_slow(block, temp, 31);
-
-    idct_line_large_slow(temp, block, 0);
-    idct_line_large_slow(temp, block, 1);
-    idct_line_large_slow(temp, block, 2);
-    idct_line_large_slow(temp, block, 3);
-
-    idct_line_large_slow(temp, block, 4);
-    idct_line_large_slow(temp, block, 5);
-    idct_line_large_slow(temp, block, 6);
-    idct_line_large_slow(temp, block, 7);
-
-    idct_line_large_slow(temp, block, 8);
-    idct_line_large_slow(temp, block, 9);
-    idct_line_large_slow(temp, block, 10);
-    idct_line_large_slow(temp, block, 11);
-
-    idct_line_large_slow(temp, block, 12);
-    idct_line_large_slow(temp, block, 13);
-    idct_line_large_slow(temp, block, 14);
-    idct_line_large_slow(temp, block, 15);
-
-    idct_line_large_slow(temp, block, 16);
-    idct_line_large_slow(temp, block, 17);
-    idct_line_large_slow(temp, block, 18);
-    idct_line_large_slow(temp, block, 19);
-
-    idct_line_large_slow(temp, block, 20);
-    idct_line_large_slow(temp, block, 21);
-    idct_line_large_slow(temp, block, 22);
-    idct_line_large_slow(temp, block, 23);
-
-    idct_line_large_slow(temp, block, 24);
-    idct_line_large_slow(temp, block, 25);
-    idct_line_large_slow(temp, block, 26);
-    idct_line_large_slow(temp, block, 27);
-
-    idct_line_large_slow(temp, block, 28);
-    idct_line_large_slow(temp, block, 29);
-    idct_line_large_slow(temp, block, 30);
-    idct_line_large_slow(temp, block, 31);
+    decompress_patch(patch, cpatch, ph, gGOPP->patch_size, gGOPP->stride);
 }
 
-S32 gDitherNoise = 128;
-
-void decompress_patch(F32 *patch, S32 *cpatch, LLPatchHeader *ph)
+void decompress_patch(F32 *patch, S32 *cpatch, const LLPatchHeader *ph, S32 size, S32 stride)
 {
     S32     i, j;
 
-    F32     block[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE], *tblock = block;
+    LL_ALIGN_16(F32 block[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE]);
+    F32     *tblock;
     F32     *tpatch;
+    F32     mult, addval;
 
-    LLGroupHeader   *gopp = gGOPP;
-    S32     size = gopp->patch_size;
-    F32     range = ph->range;
-    S32     prequant = (ph->quant_wbits >> 4) + 2;
-    S32     quantize = 1<<prequant;
-    F32     hmin = ph->dc_offset;
-    S32     stride = gopp->stride;
-
-    F32     ooq = 1.f/(F32)quantize;
-    F32     *dq = gPatchDequantizeTable;
-    S32     *decopy_matrix = gDeCopyMatrix;
-
-    F32     mult = ooq*range;
-    F32     addval = mult*(F32)(1<<(prequant - 1))+hmin;
-
-    for (i = 0; i < size*size; i++)
-    {
-        *(tblock++) = *(cpatch + *(decopy_matrix++))*(*dq++);
-    }
-
-    if (size == 16)
-    {
-        idct_patch(block);
-    }
-    else
-    {
-        idct_patch_large(block);
-    }
+    decompress_block(block, cpatch, ph, size, mult, addval);
 
     for (j = 0; j < size; j++)
     {
@@ -640,36 +322,16 @@ void decompress_patchv(LLVector3 *v, S32 *cpatch, LLPatchHeader *ph)
 {
     S32     i, j;
 
-    F32         block[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE], *tblock = block;
+    LL_ALIGN_16(F32 block[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE]);
+    F32         *tblock;
     LLVector3   *tvec;
 
     LLGroupHeader   *gopp = gGOPP;
     S32     size = gopp->patch_size;
-    F32     range = ph->range;
-    S32     prequant = (ph->quant_wbits >> 4) + 2;
-    S32     quantize = 1<<prequant;
-    F32     hmin = ph->dc_offset;
     S32     stride = gopp->stride;
+    F32     mult, addval;
 
-    F32     ooq = 1.f/(F32)quantize;
-    F32     *dq = gPatchDequantizeTable;
-    S32     *decopy_matrix = gDeCopyMatrix;
-
-    F32     mult = ooq*range;
-    F32     addval = mult*(F32)(1<<(prequant - 1))+hmin;
-
-//  bool    b_diag = false;
-//  bool    b_right = true;
-
-    for (i = 0; i < size*size; i++)
-    {
-        *(tblock++) = *(cpatch + *(decopy_matrix++))*(*dq++);
-    }
-
-    if (size == 16)
-        idct_patch(block);
-    else
-        idct_patch_large(block);
+    decompress_block(block, cpatch, ph, size, mult, addval);
 
     for (j = 0; j < size; j++)
     {
@@ -681,4 +343,3 @@ void decompress_patchv(LLVector3 *v, S32 *cpatch, LLPatchHeader *ph)
         }
     }
 }
-
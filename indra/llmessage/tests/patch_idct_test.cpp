@@ -0,0 +1,133 @@
+/**
+ * @file patch_idct_test.cpp
+ * @brief Tests of terrain patch decompression
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+
+#include "linden_common.h"
+#include "llmath.h"
+#include "v3math.h"
+// Class to test
+#include "../patch_dct.h"
+#include "stringize.h"
+// Tut header
+#include "../test/lltut.h"
+
+#include <thread>
+#include <vector>
+
+namespace tut
+{
+    struct patch_idct_test
+    {
+        // Smooth terrain like heights, stride values per row
+        void makeHeights(std::vector<F32>& heights, S32 size, S32 stride)
+        {
+            heights.assign(stride*size, 0.f);
+            for (S32 j = 0; j < size; j++)
+            {
+                for (S32 i = 0; i < size; i++)
+                {
+                    heights[j*stride + i] = 22.f + 6.f*sinf(i*0.3f) + 4.f*cosf(j*0.2f) + 0.05f*i*j;
+                }
+            }
+        }
+
+        void compress(std::vector<F32>& heights, std::vector<S32>& cpatch, LLPatchHeader& ph, S32 size, S32 stride)
+        {
+            F32 zmax, zmin;
+            init_patch_compressor(size, stride, 0);
+            prescan_patch(&heights[0], &ph, zmax, zmin);
+            cpatch.assign(size*size, 0);
+            compress_patch(&heights[0], &cpatch[0], &ph, 12);
+        }
+    };
+
+    typedef test_group<patch_idct_test> patch_idct_t;
+    typedef patch_idct_t::object patch_idct_object_t;
+    tut::patch_idct_t tut_patch_idct("patch_idct");
+
+    template<> template<>
+    void patch_idct_object_t::test<1>()
+    {
+        // compressing and decompressing gives back the heights, within quantization error
+        for (S32 size : { (S32)NORMAL_PATCH_SIZE, (S32)LARGE_PATCH_SIZE })
+        {
+            std::vector<F32> heights;
+            std::vector<S32> cpatch;
+            LLPatchHeader ph;
+            makeHeights(heights, size, size);
+            compress(heights, cpatch, ph, size, size);
+
+            LLGroupHeader gopp;
+            gopp.patch_size = size;
+            gopp.stride = size;
+            init_patch_decompressor(size);
+            set_group_of_patch_header(&gopp);
+
+            // the large patch compressor drops more high frequencies
+            F32 tolerance = size == LARGE_PATCH_SIZE ? 0.5f : 0.1f;
+            std::vector<F32> decoded(size*size);
+            decompress_patch(&decoded[0], &cpatch[0], &ph);
+            for (S32 i = 0; i < size*size; i++)
+            {
+                ensure(STRINGIZE("size " << size << " point " << i << ": " << decoded[i] << " vs " << heights[i]),
+                       fabsf(decoded[i] - heights[i]) < tolerance);
+            }
+        }
+    }
+
+    template<> template<>
+    void patch_idct_object_t::test<2>()
+    {
+        // the explicit size and stride variant matches the group header one, from any thread
+        const S32 size = NORMAL_PATCH_SIZE;
+        const S32 stride = 3*size + 1;
+        std::vector<F32> heights;
+        std::vector<S32> cpatch;
+        LLPatchHeader ph;
+        makeHeights(heights, size, size);
+        compress(heights, cpatch, ph, size, size);
+
+        LLGroupHeader gopp;
+        gopp.patch_size = size;
+        gopp.stride = stride;
+        init_patch_decompressor(size);
+        set_group_of_patch_header(&gopp);
+        std::vector<F32> expected(stride*size, -1.f);
+        decompress_patch(&expected[0], &cpatch[0], &ph);
+
+        std::vector<F32> decoded(stride*size, -1.f);
+        std::thread worker([&]()
+        {
+            decompress_patch(&decoded[0], &cpatch[0], &ph, size, stride);
+        });
+        worker.join();
+
+        for (S32 i = 0; i < stride*size; i++)
+        {
+            ensure_equals(STRINGIZE("value " << i), decoded[i], expected[i]);
+        }
+    }
+}
@@ -751,9 +751,14 @@ LLFontGlyphInfo* LLFontFreetype::addGlyphFromFont(const LLFontFreetype *fontp, l
         llassert(false);
     }
 
-    LLImageGL *image_gl = mFontBitmapCachep->getImageGL(bitmap_glyph_type, bitmap_num);
-    LLImageRaw *image_raw = mFontBitmapCachep->getImageRaw(bitmap_glyph_type, bitmap_num);
-    image_gl->setSubImage(image_raw, 0, 0, image_gl->getWidth(), image_gl->getHeight());
+    // Only upload the new glyph, not the whole bitmap.  A line of text full of glyphs we
+    // haven't seen yet (CJK, emoji) used to send the entire atlas to GL for each of them.
+    if (width > 0 && height > 0)
+    {
+        LLImageGL *image_gl = mFontBitmapCachep->getImageGL(bitmap_glyph_type, bitmap_num);
+        LLImageRaw *image_raw = mFontBitmapCachep->getImageRaw(bitmap_glyph_type, bitmap_num);
+        image_gl->setSubImage(image_raw, pos_x, pos_y, width, height, true);
+    }
 
     return gi;
 }
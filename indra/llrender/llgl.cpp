@@ -987,6 +987,9 @@ PFNGLMULTIDRAWARRAYSINDIRECTCOUNTPROC    glMultiDrawArraysIndirectCount = nullpt
 PFNGLMULTIDRAWELEMENTSINDIRECTCOUNTPROC  glMultiDrawElementsIndirectCount = nullptr;
 PFNGLPOLYGONOFFSETCLAMPPROC              glPolygonOffsetClamp = nullptr;
 
+// GL_ARB_sparse_texture
+PFNGLTEXPAGECOMMITMENTARBPROC            glTexPageCommitmentARB = nullptr;
+
 #endif
 
 LLGLManager gGLManager;
@@ -1184,6 +1187,16 @@ bool LLGLManager::initGL()
     // This is called here because it depends on the setting of mIsGF2or4MX, and sets up mHasMultitexture.
     initExtensions();
 
+    if (!mHasTextureCompressionS3TC)
+    { //can't upload BC1/BC3 blocks without S3TC
+        LLImageGL::sBlockCompressTextures = false;
+    }
+
+    if (!mHasSparseTexture || mGLVersion < 4.19f)
+    { //sparse storage is allocated with glTexStorage2D
+        LLImageGL::sSparseTextures = false;
+    }
+
     // <FS:Beq> stop doing this and trust the hardware detection
     // if hardware detection has all failed the this will correct for that
     // U32 old_vram = mVRAM;
@@ -1502,6 +1515,14 @@ void LLGLManager::initExtensions()
 // <FS:Zi> Linux support
 //#if (LL_WINDOWS || LL_LINUX) && !LL_MESA_HEADLESS
     mHasATIMemInfo = ExtensionExists("GL_ATI_meminfo", gGLHExts.mSysExts); //Basic AMD method, also see mHasAMDAssociations
+    mHasTextureCompressionS3TC = ExtensionExists("GL_EXT_texture_compression_s3tc", gGLHExts.mSysExts);
+    mHasSparseTexture = ExtensionExists("GL_ARB_sparse_texture", gGLHExts.mSysExts);
+    // both default to as many compiler threads as the driver likes, nothing to set up
+    mHasParallelShaderCompile = ExtensionExists("GL_KHR_parallel_shader_compile", gGLHExts.mSysExts);
+    if (!mHasParallelShaderCompile)
+    {
+        mHasParallelShaderCompile = ExtensionExists("GL_ARB_parallel_shader_compile", gGLHExts.mSysExts);
+    }
 
     LL_DEBUGS("RenderInit") << "GL Probe: Getting symbols" << LL_ENDL;
 
@@ -1527,6 +1548,13 @@ void LLGLManager::initExtensions()
 
     // WGL_ARB_create_context
     wglCreateContextAttribsARB = (PFNWGLCREATECONTEXTATTRIBSARBPROC)GLH_EXT_GET_PROC_ADDRESS("wglCreateContextAttribsARB");
+
+    // GL_ARB_sparse_texture
+    if (mHasSparseTexture)
+    {
+        glTexPageCommitmentARB = (PFNGLTEXPAGECOMMITMENTARBPROC)GLH_EXT_GET_PROC_ADDRESS("glTexPageCommitmentARB");
+        mHasSparseTexture = glTexPageCommitmentARB != nullptr;
+    }
 // <FS:Zi>
 // #endif
 
@@ -106,6 +106,9 @@ public:
     bool mHasDebugOutput = false;
     bool mHasTransformFeedback = false;
     bool mHasAnisotropic = false;
+    bool mHasTextureCompressionS3TC = false;
+    bool mHasSparseTexture = false;
+    bool mHasParallelShaderCompile = false;
 
     // Vendor-specific extensions
     bool mHasAMDAssociations = false;
@@ -812,6 +812,9 @@ extern PFNGLMULTIDRAWARRAYSINDIRECTCOUNTPROC    glMultiDrawArraysIndirectCount;
 extern PFNGLMULTIDRAWELEMENTSINDIRECTCOUNTPROC  glMultiDrawElementsIndirectCount;
 extern PFNGLPOLYGONOFFSETCLAMPPROC              glPolygonOffsetClamp;
 
+// GL_ARB_sparse_texture
+extern PFNGLTEXPAGECOMMITMENTARBPROC            glTexPageCommitmentARB;
+
 
 #elif LL_DARWIN
 //----------------------------------------------------------------------------
@@ -1087,6 +1090,17 @@ extern void glGetBufferPointervARB (GLenum, GLenum, GLvoid* *);
 #define GL_RENDERBUFFER_FREE_MEMORY_ATI            0x87FD
 #endif
 
+//GL_ARB_sparse_texture constants
+#ifndef GL_ARB_sparse_texture
+#define GL_ARB_sparse_texture
+#define GL_TEXTURE_SPARSE_ARB                      0x91A6
+#define GL_VIRTUAL_PAGE_SIZE_INDEX_ARB             0x91A7
+#define GL_NUM_SPARSE_LEVELS_ARB                   0x91AA
+#define GL_NUM_VIRTUAL_PAGE_SIZES_ARB              0x91A8
+#define GL_VIRTUAL_PAGE_SIZE_X_ARB                 0x9195
+#define GL_VIRTUAL_PAGE_SIZE_Y_ARB                 0x9196
+#endif
+
 #if defined(TRACY_ENABLE) && LL_PROFILER_ENABLE_TRACY_OPENGL
     #include <tracy/TracyOpenGL.hpp>
 #endif
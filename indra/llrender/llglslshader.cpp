@@ -59,6 +59,8 @@ U32 LLGLSLShader::sMaxGLTFNodes = 0;
 bool LLGLSLShader::sProfileEnabled = false;
 std::set<LLGLSLShader*> LLGLSLShader::sInstances;
 LLGLSLShader::defines_map_t LLGLSLShader::sGlobalDefines;
+bool LLGLSLShader::sRetainPrograms = false;
+std::map<LLUUID, GLuint> LLGLSLShader::sRetainedPrograms;
 U64 LLGLSLShader::sTotalTimeElapsed = 0;
 U32 LLGLSLShader::sTotalTrianglesDrawn = 0;
 U64 LLGLSLShader::sTotalSamplesDrawn = 0;
@@ -332,6 +334,27 @@ void LLGLSLShader::unload()
     unloadInternal();
 }
 
+// static
+void LLGLSLShader::releaseRetainedPrograms()
+{
+    for (auto& retained : sRetainedPrograms)
+    {
+        GLuint obj[1024];
+        GLsizei count = 0;
+        glGetAttachedShaders(retained.second, 1024, &count, obj);
+        for (GLsizei i = 0; i < count; i++)
+        {
+            glDetachShader(retained.second, obj[i]);
+            if (glIsShader(obj[i]))
+            {
+                glDeleteShader(obj[i]);
+            }
+        }
+        glDeleteProgram(retained.second);
+    }
+    sRetainedPrograms.clear();
+}
+
 void LLGLSLShader::unloadInternal()
 {
     sInstances.erase(this);
@@ -341,6 +364,12 @@ void LLGLSLShader::unloadInternal()
     mTexture.clear();
     mUniform.clear();
 
+    if (mProgramObject && sRetainPrograms && mShaderHash.notNull() && !sRetainedPrograms.count(mShaderHash))
+    {
+        sRetainedPrograms[mShaderHash] = mProgramObject;
+        mProgramObject = 0;
+    }
+
     if (mProgramObject)
     {
         GLuint obj[1024];
@@ -407,20 +436,31 @@ bool LLGLSLShader::createShader()
 
     mShaderHash = hash();
 
-    // Create program
-    mProgramObject = glCreateProgram();
-    if (mProgramObject == 0)
+    auto retained = sRetainedPrograms.find(mShaderHash);
+    if (retained != sRetainedPrograms.end())
     {
-        // Shouldn't happen if shader related extensions, like ARB_vertex_shader, exist.
-        LL_SHADER_LOADING_WARNS() << "Failed to create handle for shader: " << mName << LL_ENDL;
-        unloadInternal();
-        return false;
+        // nothing this shader depends on changed since it was unloaded
+        mProgramObject = retained->second;
+        sRetainedPrograms.erase(retained);
+        mUsingBinaryProgram = true;
+    }
+    else
+    {
+        // Create program
+        mProgramObject = glCreateProgram();
+        if (mProgramObject == 0)
+        {
+            // Shouldn't happen if shader related extensions, like ARB_vertex_shader, exist.
+            LL_SHADER_LOADING_WARNS() << "Failed to create handle for shader: " << mName << LL_ENDL;
+            unloadInternal();
+            return false;
+        }
+
+        mUsingBinaryProgram =  LLShaderMgr::instance()->loadCachedProgramBinary(this);
     }
 
     bool success = true;
 
-    mUsingBinaryProgram =  LLShaderMgr::instance()->loadCachedProgramBinary(this);
-
     if (!mUsingBinaryProgram)
     {
 #if DEBUG_SHADER_INCLUDES
@@ -983,6 +1023,8 @@ bool LLGLSLShader::mapUniforms()
         "GLTFJoints",       // UB_GLTF_JOINTS
         "GLTFNodes",        // UB_GLTF_NODES
         "GLTFMaterials",    // UB_GLTF_MATERIALS
+        "TreeInstances",    // UB_TREE_INSTANCES
+        "GLTFInstances",    // UB_GLTF_INSTANCES
     };
 
     llassert(LL_ARRAY_SIZE(ubo_names) == NUM_UNIFORM_BLOCKS);
@@ -1037,6 +1079,7 @@ void LLGLSLShader::bind()
             sCurBoundShaderPtr->readProfileQuery();
         }
         LLVertexBuffer::unbind();
+        LLVertexBuffer::sUseSkinCache = false;
         glUseProgram(mProgramObject);
         sCurBoundShader = mProgramObject;
         sCurBoundShaderPtr = this;
@@ -1076,6 +1119,7 @@ void LLGLSLShader::unbind(void)
     LL_PROFILE_ZONE_SCOPED_CATEGORY_SHADER;
     gGL.flush();
     LLVertexBuffer::unbind();
+    LLVertexBuffer::sUseSkinCache = false;
 
     if (sCurBoundShaderPtr)
     {
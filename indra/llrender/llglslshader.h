@@ -57,6 +57,7 @@ public:
     bool attachNothing = false;
     bool hasHeroProbes = false;
     bool isPBRTerrain = false;
+    bool isTerrainHeightfield = false; // displaces the terrain node grid (see LLTerrainHeightfield)
 };
 
 // ============= Structure for caching shader uniforms ===============
@@ -151,6 +152,8 @@ public:
         UB_GLTF_JOINTS,         // "GLTFJoints"
         UB_GLTF_NODES,          // "GLTFNodes"
         UB_GLTF_MATERIALS,      // "GLTFMaterials"
+        UB_TREE_INSTANCES,      // "TreeInstances"
+        UB_GLTF_INSTANCES,      // "GLTFInstances"
         NUM_UNIFORM_BLOCKS
     };
 
@@ -158,6 +161,14 @@ public:
     static std::set<LLGLSLShader*> sInstances;
     static bool sProfileEnabled;
 
+    // While set, unloading a shader keeps its linked program in sRetainedPrograms, keyed by
+    // mShaderHash, and createShader() takes it back instead of compiling when the hash is
+    // unchanged.  Lets a shader reload recompile only the shaders whose inputs changed.
+    static bool sRetainPrograms;
+    static std::map<LLUUID, GLuint> sRetainedPrograms;
+    // Delete the programs nothing took back
+    static void releaseRetainedPrograms();
+
     LLGLSLShader();
     ~LLGLSLShader();
 
@@ -167,6 +178,8 @@ public:
 
     static U32 sMaxGLTFMaterials;
     static U32 sMaxGLTFNodes;
+    // Instances per instanced GLTF draw call, node indices are packed as S32 in a UBO block
+    static constexpr U32 MAX_GLTF_INSTANCES = 256;
 
     static void initProfile();
     static void finishProfile(bool emit_report = true);
@@ -308,6 +321,7 @@ public:
     defines_map_t mDefines;
     static defines_map_t sGlobalDefines;
     LLUUID mShaderHash;
+    // the program was linked before createShader(), from the binary cache or sRetainedPrograms
     bool mUsingBinaryProgram = false;
 
     //statistics for profiling shader performance
@@ -365,6 +379,8 @@ extern LLGLSLShader         gUIProgram;
 extern LLGLSLShader         gSolidColorProgram;
 //Alpha mask shader (declared here so llappearance can access properly)
 extern LLGLSLShader         gAlphaMaskProgram;
+//Alpha ramp shader for avatar alpha params, see LLTexLayerParamAlpha::render
+extern LLGLSLShader         gAlphaRampProgram;
 
 #ifdef LL_PROFILER_ENABLE_RENDER_DOC
 #define LL_SET_SHADER_LABEL(shader) shader.setLabel(#shader)
@@ -41,6 +41,7 @@
 #include "llrender.h"
 #include "llwindow.h"
 #include "llframetimer.h"
+#include <deque>
 #include <unordered_set>
 
 extern LL_COMMON_API bool on_main_thread();
@@ -124,6 +125,160 @@ void LLImageGLMemory::free_cur_tex_image()
 
 using namespace LLImageGLMemory;
 
+// Persistently mapped GL_PIXEL_UNPACK_BUFFER that the LLImageGL thread stages
+// texture uploads through. glTexImage2D then returns as soon as the pixels
+// are in the ring instead of waiting for the driver to copy them, and the
+// transfer to video memory happens asynchronously. Uploads are fenced in
+// batches (one per texture, see fence()) and their space is reused once the
+// fence has signaled.
+class LLPixelUploadRing
+{
+public:
+    LLPixelUploadRing(U32 size)
+    :   mSize(size)
+    {
+#if !LL_DARWIN
+        if (gGLManager.mGLVersion < 4.39f || !glBufferStorage)
+        {
+            return;
+        }
+
+        constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glGenBuffers(1, &mBuffer);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, mBuffer);
+        glBufferStorage(GL_PIXEL_UNPACK_BUFFER, mSize, nullptr, flags);
+        mMapped = (U8*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, mSize, flags);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        stop_glerror();
+
+        if (!mMapped)
+        {
+            LL_WARNS("Texture") << "Failed to map a " << mSize << " byte texture upload ring" << LL_ENDL;
+            glDeleteBuffers(1, &mBuffer);
+            mBuffer = 0;
+        }
+#endif
+    }
+
+    ~LLPixelUploadRing()
+    {
+        for (Batch& batch : mBatches)
+        {
+            glDeleteSync(batch.mFence);
+        }
+
+        if (mBuffer)
+        {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, mBuffer);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            glDeleteBuffers(1, &mBuffer);
+        }
+    }
+
+    bool isValid() const { return mMapped != nullptr; }
+
+    // Copy pixels into the ring and bind it as GL_PIXEL_UNPACK_BUFFER.
+    // On success, offset is what to pass to GL as the pixel pointer, and
+    // unbind() must be called after the upload. Returns false if the
+    // upload doesn't fit, in which case nothing is bound.
+    bool stage(const void* pixels, U32 bytes, const void*& offset)
+    {
+        return stageRows(pixels, bytes, 1, bytes, offset);
+    }
+
+    // Same for rows that are stride bytes apart in pixels, i.e. a rectangle out of a
+    // larger image.  The rows are packed together in the ring.
+    bool stageRows(const void* pixels, U32 row_bytes, U32 rows, U32 stride, const void*& offset)
+    {
+        LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
+        U32 bytes = row_bytes * rows;
+        if (!mMapped || bytes == 0 || bytes > mSize / 2)
+        {
+            return false;
+        }
+
+        // keep each upload aligned for the DMA engine
+        U32 aligned = (bytes + 255) & ~255U;
+        if (mHead + aligned > mSize)
+        { // wrap around, fencing what's been staged before the wrap
+            fence();
+            mHead = 0;
+            mBatchBegin = 0;
+        }
+
+        waitForRegion(mHead, mHead + aligned);
+
+        if (stride == row_bytes)
+        {
+            memcpy(mMapped + mHead, pixels, bytes);
+        }
+        else
+        {
+            for (U32 row = 0; row < rows; ++row)
+            {
+                memcpy(mMapped + mHead + row * row_bytes, (const U8*)pixels + row * stride, row_bytes);
+            }
+        }
+        offset = (const void*)(uintptr_t)mHead;
+        mHead += aligned;
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, mBuffer);
+        return true;
+    }
+
+    void unbind()
+    {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+
+    // Fence everything staged since the last call
+    void fence()
+    {
+        if (mHead != mBatchBegin)
+        {
+            Batch batch;
+            batch.mFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            batch.mBegin = mBatchBegin;
+            batch.mEnd = mHead;
+            mBatches.push_back(batch);
+            mBatchBegin = mHead;
+        }
+    }
+
+private:
+    // Block until the GPU is done reading [begin, end). Batches are retired
+    // in the order they were staged, so only the oldest can be in the way.
+    void waitForRegion(U32 begin, U32 end)
+    {
+        while (!mBatches.empty() && mBatches.front().mBegin < end && begin < mBatches.front().mEnd)
+        {
+            LL_PROFILE_ZONE_NAMED_CATEGORY_TEXTURE("upload ring - wait");
+            Batch& batch = mBatches.front();
+            glClientWaitSync(batch.mFence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+            glDeleteSync(batch.mFence);
+            mBatches.pop_front();
+        }
+    }
+
+    struct Batch
+    {
+        GLsync mFence;
+        U32 mBegin;
+        U32 mEnd;
+    };
+
+    U32 mSize;
+    U32 mBuffer = 0;
+    U8* mMapped = nullptr;
+    U32 mHead = 0;          // where the next upload goes
+    U32 mBatchBegin = 0;    // start of the uploads that haven't been fenced yet
+    std::deque<Batch> mBatches;
+};
+
+// only the LLImageGL thread has one
+static thread_local LLPixelUploadRing* sUploadRing = nullptr;
+
 // static
 U64 LLImageGL::getTextureBytesAllocated()
 {
@@ -140,11 +295,14 @@ bool LLImageGL::sGlobalUseAnisotropic   = false;
 F32 LLImageGL::sLastFrameTime           = 0.f;
 LLImageGL* LLImageGL::sDefaultGLTexture = NULL ;
 bool LLImageGL::sCompressTextures = false;
+bool LLImageGL::sBlockCompressTextures = false;
+bool LLImageGL::sSparseTextures = false;
 std::unordered_set<LLImageGL*> LLImageGL::sImageList;
 
 
 bool LLImageGLThread::sEnabledTextures = false;
 bool LLImageGLThread::sEnabledMedia = false;
+U32 LLImageGLThread::sUploadRingMB = 0;
 
 //****************************************************************************************************
 //The below for texture auditing use only
@@ -682,6 +840,21 @@ void LLImageGL::setExplicitFormat( LLGLint internal_format, LLGLenum primary_for
 
 //----------------------------------------------------------------------------
 
+// glCompressedTexImage2D, staged through the upload ring when there is one
+static void compressed_tex_image(U32 target, S32 miplevel, U32 format, S32 width, S32 height, GLsizei size, const void* data)
+{
+    const void* staged = nullptr;
+    if (data && sUploadRing && sUploadRing->stage(data, (U32)size, staged))
+    {
+        glCompressedTexImage2D(target, miplevel, format, width, height, 0, size, staged);
+        sUploadRing->unbind();
+    }
+    else
+    {
+        glCompressedTexImage2D(target, miplevel, format, width, height, 0, size, data);
+    }
+}
+
 void LLImageGL::setImage(const LLImageRaw* imageraw)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
@@ -698,6 +871,11 @@ bool LLImageGL::setImage(const U8* data_in, bool data_hasmips /* = false */, S32
 
     const bool is_compressed = isCompressed();
 
+    // sparse storage is already allocated and addressed by discard level
+    const LLGLuint target_name = usename != 0 ? (LLGLuint)usename : mTexName;
+    const bool sparse = mSparseName != 0 && target_name == mSparseName;
+    const S32 gl_base = sparse ? mCurrentDiscardLevel : 0;
+
     if (mUseMipMaps)
     {
         //set has mip maps to true before binding image so tex parameters get set properly
@@ -716,10 +894,13 @@ bool LLImageGL::setImage(const U8* data_in, bool data_hasmips /* = false */, S32
 
     if (data_in == nullptr)
     {
-        S32 w = getWidth();
-        S32 h = getHeight();
-        LLImageGL::setManualImage(mTarget, 0, mFormatInternal, w, h,
-            mFormatPrimary, mFormatType, (GLvoid*)data_in, mAllowCompression);
+        if (!sparse)
+        {
+            S32 w = getWidth();
+            S32 h = getHeight();
+            LLImageGL::setManualImage(mTarget, 0, mFormatInternal, w, h,
+                mFormatPrimary, mFormatType, (GLvoid*)data_in, mAllowCompression);
+        }
     }
     else if (mUseMipMaps)
     {
@@ -740,10 +921,30 @@ bool LLImageGL::setImage(const U8* data_in, bool data_hasmips /* = false */, S32
                 {
                     data_in -= dataFormatBytes(mFormatPrimary, w, h); // see above comment
                 }
-                if (is_compressed)
+                if (sparse)
+                {
+                    setSparseImage(gl_base + gl_level, w, h, data_in);
+                    if (!is_compressed)
+                    {
+                        if (gl_level == 0)
+                        {
+                            analyzeAlpha(data_in, w, h);
+                        }
+                        updatePickMask(w, h, data_in);
+                    }
+                }
+                else if (is_compressed)
                 {
                     GLsizei tex_size = (GLsizei)dataFormatBytes(mFormatPrimary, w, h);
-                    glCompressedTexImage2D(mTarget, gl_level, mFormatPrimary, w, h, 0, tex_size, (GLvoid *)data_in);
+                    if (gl_level == 0)
+                    {
+                        free_cur_tex_image();
+                    }
+                    compressed_tex_image(mTarget, gl_level, mFormatPrimary, w, h, tex_size, data_in);
+                    if (gl_level == 0)
+                    {
+                        alloc_tex_image(w, h, mFormatPrimary);
+                    }
                     stop_glerror();
                 }
                 else
@@ -792,15 +993,22 @@ bool LLImageGL::setImage(const U8* data_in, bool data_hasmips /* = false */, S32
                     //use legacy mipmap generation mode (note: making this condional can cause rendering issues)
                     // -- but making it not conditional triggers deprecation warnings when core profile is enabled
                     //      (some rendering issues while core profile is enabled are acceptable at this point in time)
-                    if (!LLRender::sGLCoreProfile)
+                    if (!LLRender::sGLCoreProfile && !sparse)
                     {
                         glTexParameteri(mTarget, GL_GENERATE_MIPMAP, GL_TRUE);
                     }
 
-                    LLImageGL::setManualImage(mTarget, 0, mFormatInternal,
-                                 w, h,
-                                 mFormatPrimary, mFormatType,
-                                 data_in, mAllowCompression);
+                    if (sparse)
+                    {
+                        setSparseImage(gl_base, w, h, data_in);
+                    }
+                    else
+                    {
+                        LLImageGL::setManualImage(mTarget, 0, mFormatInternal,
+                                     w, h,
+                                     mFormatPrimary, mFormatType,
+                                     data_in, mAllowCompression);
+                    }
                     analyzeAlpha(data_in, w, h);
                     stop_glerror();
 
@@ -812,7 +1020,7 @@ bool LLImageGL::setImage(const U8* data_in, bool data_hasmips /* = false */, S32
                         stop_glerror();
                     }
 
-                    if (LLRender::sGLCoreProfile)
+                    if (LLRender::sGLCoreProfile || sparse)
                     {
                         LL_PROFILE_GPU_ZONE("generate mip map");
                         glGenerateMipmap(mTarget);
@@ -901,7 +1109,14 @@ bool LLImageGL::setImage(const U8* data_in, bool data_hasmips /* = false */, S32
                             stop_glerror();
                         }
 
-                        LLImageGL::setManualImage(mTarget, m, mFormatInternal, w, h, mFormatPrimary, mFormatType, cur_mip_data, mAllowCompression);
+                        if (sparse)
+                        {
+                            setSparseImage(gl_base + m, w, h, cur_mip_data);
+                        }
+                        else
+                        {
+                            LLImageGL::setManualImage(mTarget, m, mFormatInternal, w, h, mFormatPrimary, mFormatType, cur_mip_data, mAllowCompression);
+                        }
                         if (m == 0)
                         {
                             analyzeAlpha(data_in, w, h);
@@ -946,7 +1161,9 @@ bool LLImageGL::setImage(const U8* data_in, bool data_hasmips /* = false */, S32
         if (is_compressed)
         {
             GLsizei tex_size = (GLsizei)dataFormatBytes(mFormatPrimary, w, h);
-            glCompressedTexImage2D(mTarget, 0, mFormatPrimary, w, h, 0, tex_size, (GLvoid *)data_in);
+            free_cur_tex_image();
+            compressed_tex_image(mTarget, 0, mFormatPrimary, w, h, tex_size, data_in);
+            alloc_tex_image(w, h, mFormatPrimary);
             stop_glerror();
         }
         else
@@ -1113,7 +1330,17 @@ bool LLImageGL::setSubImage(const U8* datap, S32 data_width, S32 data_height, S3
         stop_glerror();
 
         const bool use_sub_image = should_stagger_image_set(isCompressed());
-        if (!use_sub_image)
+        const void* staged = nullptr;
+        if (sUploadRing
+            && sUploadRing->stageRows(sub_datap, width * getComponents(), height, data_width * getComponents(), staged))
+        {
+            // media updates on the LLImageGL thread, the rows are packed in the ring
+            LL_PROFILE_ZONE_NAMED("glTexSubImage2D from upload ring");
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+            glTexSubImage2D(mTarget, 0, x_pos, y_pos, width, height, mFormatPrimary, mFormatType, staged);
+            sUploadRing->unbind();
+        }
+        else if (!use_sub_image)
         {
             // *TODO: Why does this work here, in setSubImage, but not in
             // setManualImage? Maybe because it only gets called with the
@@ -1368,7 +1595,16 @@ void LLImageGL::setManualImage(U32 target, S32 miplevel, S32 intformat, S32 widt
 
         free_cur_tex_image();
         const bool use_sub_image = should_stagger_image_set(compress);
-        if (!use_sub_image)
+        const void* src = use_scratch ? scratch : pixels;
+        const void* staged = nullptr;
+        if (src && sUploadRing
+            && sUploadRing->stage(src, (U32)(width * height * dataFormatComponents(pixformat) * type_width_from_pixtype(pixtype)), staged))
+        {
+            LL_PROFILE_ZONE_NAMED("glTexImage2D from upload ring");
+            glTexImage2D(target, miplevel, intformat, width, height, 0, pixformat, pixtype, staged);
+            sUploadRing->unbind();
+        }
+        else if (!use_sub_image)
         {
             LL_PROFILE_ZONE_NAMED("glTexImage2D alloc + copy");
             glTexImage2D(target, miplevel, intformat, width, height, 0, pixformat, pixtype, use_scratch ? scratch : pixels);
@@ -1434,7 +1670,7 @@ bool LLImageGL::createGLTexture()
     return true ;
 }
 
-bool LLImageGL::createGLTexture(S32 discard_level, const LLImageRaw* imageraw, S32 usename/*=0*/, bool to_create, S32 category, bool defer_copy, LLGLuint* tex_name)
+bool LLImageGL::createGLTexture(S32 discard_level, const LLImageRaw* imageraw, S32 usename/*=0*/, bool to_create, S32 category, bool defer_copy, LLGLuint* tex_name, const LLImageBC* compressed)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
     checkActiveThread();
@@ -1529,6 +1765,23 @@ bool LLImageGL::createGLTexture(S32 discard_level, const LLImageRaw* imageraw, S
 
     setCategory(category);
     const U8* rawdata = imageraw->getData();
+
+    if (compressed && !defer_copy && !mHasExplicitFormat
+        && compressed->getFormat() != LLImageBC::FORMAT_NONE
+        && compressed->getWidth() == raw_w && compressed->getHeight() == raw_h)
+    {
+        // alpha analysis and the pick mask need the uncompressed pixels
+        analyzeAlpha(rawdata, raw_w, raw_h);
+        updatePickMask(raw_w, raw_h, rawdata);
+
+        mFormatInternal = compressed->getFormat() == LLImageBC::FORMAT_BC1 ? GL_COMPRESSED_RGBA_S3TC_DXT1_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        mFormatPrimary = mFormatInternal;
+        mFormatType = GL_UNSIGNED_BYTE;
+
+        LLImageDataSharedLock lock(compressed);
+        return createGLTexture(discard_level, compressed->getTopMipData(), true, usename, defer_copy, tex_name);
+    }
+
     return createGLTexture(discard_level, rawdata, false, usename, defer_copy, tex_name);
 }
 
@@ -1559,6 +1812,19 @@ bool LLImageGL::createGLTexture(S32 discard_level, const U8* data_in, bool data_
     }
     discard_level = llclamp(discard_level, 0, (S32)mMaxDiscardLevel);
 
+    if (main_thread && !defer_copy && usename == 0 && isSparse() && sparseStorageFits())
+    {
+        LL_PROFILE_ZONE_NAMED_CATEGORY_TEXTURE("cglt - sparse setImage");
+        // commit or release mips in place instead of replacing the texture
+        if (tex_name != nullptr)
+        {
+            *tex_name = mTexName;
+        }
+        commitSparseLevels(discard_level);
+        mLastBindTime = sLastFrameTime;
+        return setImage(data_in, data_hasmips);
+    }
+
     if (main_thread // <--- always force creation of new_texname when not on main thread ...
         && !defer_copy // <--- ... or defer copy is set
         && mTexName != 0 && discard_level == mCurrentDiscardLevel)
@@ -1582,6 +1848,7 @@ bool LLImageGL::createGLTexture(S32 discard_level, const U8* data_in, bool data_
     else
     {
         LLImageGL::generateTextures(1, &new_texname);
+        if (!main_thread || defer_copy || !canUseSparse() || !allocSparseStorage(new_texname, discard_level))
         {
             gGL.getTexUnit(0)->bind(this, false, false, new_texname);
             glTexParameteri(LLTexUnit::getInternalType(mBindTarget), GL_TEXTURE_BASE_LEVEL, 0);
@@ -1632,6 +1899,10 @@ bool LLImageGL::createGLTexture(S32 discard_level, const U8* data_in, bool data_
                 LLImageGL::deleteTextures(1, &old_texname);
             }
             mTexName = new_texname;
+            if (mSparseName != mTexName)
+            {
+                mSparseName = 0;
+            }
         }
     }
 
@@ -1650,6 +1921,11 @@ void LLImageGL::syncToMainThread(LLGLuint new_tex_name)
     LL_PROFILE_ZONE_SCOPED;
     llassert(!on_main_thread());
 
+    if (sUploadRing)
+    { // everything this texture staged is one batch
+        sUploadRing->fence();
+    }
+
     {
         LL_PROFILE_ZONE_NAMED_CATEGORY_TEXTURE("cglt - sync");
         if (gGLManager.mIsNVIDIA)
@@ -1709,6 +1985,10 @@ void LLImageGL::syncTexName(LLGLuint texname)
             LLImageGL::deleteTextures(1, &mTexName);
         }
         mTexName = texname;
+        if (mSparseName != mTexName)
+        {
+            mSparseName = 0;
+        }
     }
 }
 
@@ -1726,7 +2006,7 @@ bool LLImageGL::readBackRaw(S32 discard_level, LLImageRaw* imageraw, bool compre
         return false;
     }
 
-    S32 gl_discard = discard_level - mCurrentDiscardLevel;
+    S32 gl_discard = isSparse() ? discard_level : discard_level - mCurrentDiscardLevel;
 
     //explicitly unbind texture
     gGL.getTexUnit(0)->unbind(mBindTarget);
@@ -1838,6 +2118,7 @@ void LLImageGL::destroyGLTexture()
         LLImageGL::deleteTextures(1, &mTexName);
         mCurrentDiscardLevel = -1 ; //invalidate mCurrentDiscardLevel.
         mTexName = 0;
+        mSparseName = 0;
         mGLTextureCreated = false ;
     }
 }
@@ -2364,6 +2645,12 @@ bool LLImageGL::scaleDown(S32 desired_discard)
         return false;
     }
 
+    if (isSparse())
+    { // the coarser mips are already there, just release the finer ones
+        commitSparseLevels(desired_discard);
+        return true;
+    }
+
     S32 mip = desired_discard - mCurrentDiscardLevel;
 
     S32 desired_width = getWidth(desired_discard);
@@ -2455,6 +2742,191 @@ bool LLImageGL::scaleDown(S32 desired_discard)
 }
 
 
+//----------------------------------------------------------------------------
+// ARB_sparse_texture
+//
+// Large mipmapped textures get virtual storage for their whole mip chain up
+// front, but only the mips at or past the current discard level are backed
+// by video memory. Changing the discard level commits or releases those mips
+// in place instead of allocating a second texture and copying into it, so
+// scaling down is free and loading more detail never holds two copies.
+
+// textures smaller than this don't save enough to be worth the page granularity
+constexpr S32 SPARSE_MIN_SIZE = 1024;
+
+namespace
+{
+    // virtual page size of an internal format, (0, 0) if it can't be sparse
+    std::pair<S32, S32> sparse_page_size(LLGLint internal_format)
+    {
+        static std::unordered_map<LLGLint, std::pair<S32, S32>> page_sizes;
+
+        auto iter = page_sizes.find(internal_format);
+        if (iter != page_sizes.end())
+        {
+            return iter->second;
+        }
+
+        std::pair<S32, S32> size(0, 0);
+#if !LL_DARWIN
+        GLint count = 0;
+        glGetInternalformativ(GL_TEXTURE_2D, internal_format, GL_NUM_VIRTUAL_PAGE_SIZES_ARB, 1, &count);
+        if (count > 0)
+        {
+            glGetInternalformativ(GL_TEXTURE_2D, internal_format, GL_VIRTUAL_PAGE_SIZE_X_ARB, 1, &size.first);
+            glGetInternalformativ(GL_TEXTURE_2D, internal_format, GL_VIRTUAL_PAGE_SIZE_Y_ARB, 1, &size.second);
+        }
+        stop_glerror();
+#endif
+        page_sizes[internal_format] = size;
+        return size;
+    }
+}
+
+bool LLImageGL::canUseSparse() const
+{
+    if (!sSparseTextures || mTarget != GL_TEXTURE_2D || !mUseMipMaps || mFormatSwapBytes || mExternalTexture)
+    {
+        return false;
+    }
+
+    switch (mFormatInternal)
+    {
+    case GL_RGB8:
+    case GL_RGBA8:
+        if (sCompressTextures && mAllowCompression)
+        { // setManualImage() would have picked a driver compressed format
+            return false;
+        }
+        break;
+    case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+        break;
+    default:
+        return false;
+    }
+
+    S32 width = getWidth(0);
+    S32 height = getHeight(0);
+    if (llmax(width, height) < SPARSE_MIN_SIZE)
+    {
+        return false;
+    }
+
+    std::pair<S32, S32> page = sparse_page_size(mFormatInternal);
+    return page.first > 0 && page.second > 0 && width % page.first == 0 && height % page.second == 0;
+}
+
+bool LLImageGL::sparseStorageFits() const
+{
+    return mSparseFormat == mFormatInternal && mSparseWidth == mWidth && mSparseHeight == mHeight;
+}
+
+bool LLImageGL::allocSparseStorage(LLGLuint tex_name, S32 discard_level)
+{
+#if LL_DARWIN
+    return false;
+#else
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
+
+    gGL.getTexUnit(0)->bind(this, false, false, tex_name);
+    glTexParameteri(mTarget, GL_TEXTURE_SPARSE_ARB, GL_TRUE);
+    glTexStorage2D(mTarget, mMaxDiscardLevel + 1, mFormatInternal, getWidth(0), getHeight(0));
+
+    GLint immutable = 0;
+    glGetTexParameteriv(mTarget, GL_TEXTURE_IMMUTABLE_FORMAT, &immutable);
+    if (!immutable)
+    { // the driver turned this one down, tex_name is still usable as a regular texture
+        glTexParameteri(mTarget, GL_TEXTURE_SPARSE_ARB, GL_FALSE);
+        stop_glerror();
+        return false;
+    }
+
+    GLint sparse_levels = 0;
+    glGetTexParameteriv(mTarget, GL_NUM_SPARSE_LEVELS_ARB, &sparse_levels);
+    mSparseLevels = (S8)llclamp(sparse_levels, 0, mMaxDiscardLevel + 1);
+
+    if (mSparseLevels <= mMaxDiscardLevel)
+    { // the mip tail stays resident for the life of the texture
+        glTexPageCommitmentARB(mTarget, mSparseLevels, 0, 0, 0, getWidth(mSparseLevels), getHeight(mSparseLevels), 1, GL_TRUE);
+    }
+
+    for (S32 level = discard_level; level < mSparseLevels; ++level)
+    {
+        glTexPageCommitmentARB(mTarget, level, 0, 0, 0, getWidth(level), getHeight(level), 1, GL_TRUE);
+    }
+
+    glTexParameteri(mTarget, GL_TEXTURE_BASE_LEVEL, discard_level);
+    glTexParameteri(mTarget, GL_TEXTURE_MAX_LEVEL, mMaxDiscardLevel);
+    stop_glerror();
+
+    alloc_tex_image(getWidth(discard_level), getHeight(discard_level), mFormatPrimary);
+
+    mSparseName = tex_name;
+    mSparseFormat = mFormatInternal;
+    mSparseWidth = mWidth;
+    mSparseHeight = mHeight;
+    return true;
+#endif
+}
+
+void LLImageGL::commitSparseLevels(S32 discard_level)
+{
+#if !LL_DARWIN
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
+    llassert(isSparse());
+
+    discard_level = llclamp(discard_level, 0, (S32)mMaxDiscardLevel);
+    S32 current_level = mCurrentDiscardLevel;
+    if (discard_level == current_level)
+    {
+        return;
+    }
+
+    gGL.getTexUnit(0)->bind(this, false, false, mSparseName);
+
+    // commit mips we're about to upload
+    for (S32 level = discard_level; level < llmin(current_level, (S32)mSparseLevels); ++level)
+    {
+        glTexPageCommitmentARB(mTarget, level, 0, 0, 0, getWidth(level), getHeight(level), 1, GL_TRUE);
+    }
+
+    // release mips finer than we want
+    for (S32 level = current_level; level < llmin(discard_level, (S32)mSparseLevels); ++level)
+    {
+        glTexPageCommitmentARB(mTarget, level, 0, 0, 0, getWidth(level), getHeight(level), 1, GL_FALSE);
+    }
+
+    glTexParameteri(mTarget, GL_TEXTURE_BASE_LEVEL, discard_level);
+    stop_glerror();
+
+    free_tex_image(mSparseName);
+    alloc_tex_image(getWidth(discard_level), getHeight(discard_level), mFormatPrimary);
+
+    gGL.getTexUnit(0)->unbind(mBindTarget);
+
+    mCurrentDiscardLevel = discard_level;
+    mTextureMemory = (S64Bytes)getMipBytes(mCurrentDiscardLevel);
+#endif
+}
+
+// upload one mip into storage made by allocSparseStorage(), which must be bound
+void LLImageGL::setSparseImage(S32 gl_level, S32 width, S32 height, const void* pixels)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
+    if (isCompressed())
+    {
+        GLsizei tex_size = (GLsizei)dataFormatBytes(mFormatPrimary, width, height);
+        glCompressedTexSubImage2D(mTarget, gl_level, 0, 0, width, height, mFormatPrimary, tex_size, pixels);
+    }
+    else
+    {
+        glTexSubImage2D(mTarget, gl_level, 0, 0, width, height, mFormatPrimary, mFormatType, pixels);
+    }
+    stop_glerror();
+}
+
+
 //----------------------------------------------------------------------------
 #if LL_IMAGEGL_THREAD_CHECK
 void LLImageGL::checkActiveThread()
@@ -2546,7 +3018,21 @@ void LLImageGLThread::run()
     mWindow->makeContextCurrent(mContext);
     gGL.init(false);
 	LL_PROFILER_GPU_CONTEXT_NS("LLImageGL Context", 17);
+
+    if (sUploadRingMB > 0)
+    {
+        sUploadRing = new LLPixelUploadRing(sUploadRingMB * 1024 * 1024);
+        if (!sUploadRing->isValid())
+        {
+            delete sUploadRing;
+            sUploadRing = nullptr;
+        }
+    }
+
     LL::ThreadPool::run();
+
+    delete sUploadRing;
+    sUploadRing = nullptr;
     gGL.shutdown();
     mWindow->destroySharedContext(mContext);
 }
@@ -29,6 +29,7 @@
 #define LL_LLIMAGEGL_H
 
 #include "llimage.h"
+#include "llimagebc.h"
 
 #include "llgltypes.h"
 #include "llpointer.h"
@@ -124,8 +125,10 @@ public:
     static void setManualImage(U32 target, S32 miplevel, S32 intformat, S32 width, S32 height, U32 pixformat, U32 pixtype, const void *pixels, bool allow_compression = true);
 
     bool createGLTexture() ;
+    // compressed, if given, is a block compressed copy of imageraw that gets
+    // uploaded instead of the raw data (see LLImageBC)
     bool createGLTexture(S32 discard_level, const LLImageRaw* imageraw, S32 usename = 0, bool to_create = true,
-        S32 category = sMaxCategories-1, bool defer_copy = false, LLGLuint* tex_name = nullptr);
+        S32 category = sMaxCategories-1, bool defer_copy = false, LLGLuint* tex_name = nullptr, const LLImageBC* compressed = nullptr);
     bool createGLTexture(S32 discard_level, const U8* data, bool data_hasmips = false, S32 usename = 0, bool defer_copy = false, LLGLuint* tex_name = nullptr);
     void setImage(const LLImageRaw* imageraw);
     bool setImage(const U8* data_in, bool data_hasmips = false, S32 usename = 0);
@@ -224,6 +227,11 @@ public:
     // only works for GL_TEXTURE_2D target
     bool scaleDown(S32 desired_discard);
 
+    // true if mTexName has ARB_sparse_texture storage for the full mip chain
+    // (see sSparseTextures). GL mip levels of sparse textures are discard
+    // levels, with GL_TEXTURE_BASE_LEVEL set to the current discard level.
+    bool isSparse() const { return mSparseName != 0 && mSparseName == mTexName; }
+
 public:
     // Various GL/Rendering options
     S64Bytes mTextureMemory;
@@ -234,6 +242,13 @@ private:
     void freePickMask();
     bool isCompressed();
 
+    // sparse storage helpers
+    bool canUseSparse() const;
+    bool sparseStorageFits() const;
+    bool allocSparseStorage(LLGLuint tex_name, S32 discard_level);
+    void commitSparseLevels(S32 discard_level);
+    void setSparseImage(S32 gl_level, S32 width, S32 height, const void* pixels);
+
     LLPointer<LLImageRaw> mSaveData; // used for destroyGL/restoreGL
     LL::WorkQueue::weak_t mMainQueue;
     U8* mPickMask;  //downsampled bitmap approximation of alpha channel.  NULL if no alpha channel
@@ -256,6 +271,13 @@ private:
 
     bool mAllowCompression;
 
+    // ARB_sparse_texture storage, see allocSparseStorage()
+    LLGLuint mSparseName = 0;       // texture name with sparse storage, 0 if none
+    LLGLint  mSparseFormat = 0;     // internal format of that storage
+    U16      mSparseWidth = 0;      // level 0 size of that storage
+    U16      mSparseHeight = 0;
+    S8       mSparseLevels = 0;     // this level and coarser ones are the mip tail, committed as one
+
 protected:
     LLGLenum mTarget;       // Normally GL_TEXTURE2D, sometimes something else (ex. cube maps)
     LLTexUnit::eTextureType mBindTarget;    // Normally TT_TEXTURE, sometimes something else (ex. cube maps)
@@ -292,6 +314,8 @@ public:
     static LLImageGL* sDefaultGLTexture ;
     static bool sAutomatedTest;
     static bool sCompressTextures;          //use GL texture compression
+    static bool sBlockCompressTextures;     //encode fetched textures to BC1/BC3 on the decode threads
+    static bool sSparseTextures;            //give large mipmapped textures ARB_sparse_texture storage and commit only the mips in use
 #if DEBUG_MISS
     bool mMissed; // Missed on last bind?
     bool getMissed() const { return mMissed; };
@@ -348,6 +372,9 @@ public:
     static bool sEnabledTextures;
     // follows gSavedSettings "RenderGLMultiThreadedMedia"
     static bool sEnabledMedia;
+    // follows gSavedSettings "RenderGLUploadRingMB", size of the persistently
+    // mapped buffer texture uploads are staged through, 0 to upload directly
+    static U32 sUploadRingMB;
 
     LLImageGLThread(LLWindow* window);
 
@@ -214,7 +214,7 @@ bool LLTexUnit::bind(LLTexture* texture, bool for_rendering, bool forceBind)
     stop_glerror();
     if (mIndex >= 0)
     {
-        gGL.flush();
+        gGL.softFlush();
 
         LLImageGL* gl_tex = NULL ;
 
@@ -299,7 +299,7 @@ bool LLTexUnit::bind(LLImageGL* texture, bool for_rendering, bool forceBind, S32
 
     if ((mCurrTexture != texname) || forceBind)
     {
-        gGL.flush();
+        gGL.softFlush();
         stop_glerror();
         activate();
         stop_glerror();
@@ -822,8 +822,10 @@ LLRender::LLRender()
     mLineWidth(1.f), // <FS> Line width OGL core profile fix by Rye Mutt
     // <FS:Ansariel> Don't ignore OpenGL max line width
     mMaxLineWidthSmooth(1.f),
-    mMaxLineWidthAliased(1.f)
+    mMaxLineWidthAliased(1.f),
     // </FS:Ansariel>
+    mUIBatching(false),
+    mScissor()
 {
     for (U32 i = 0; i < LL_NUM_TEXTURE_LAYERS; i++)
     {
@@ -1625,12 +1627,120 @@ void LLRender::end()
         mMode != LLRender::POINTS) ||
         mCount > 2048)
     {
-        flush();
+        softFlush();
+    }
+}
+
+LLPointer<LLVertexBuffer> LLRender::getCachedBuffer(const LLVector4a* vertices, const LLVector2* texcoords,
+    const LLColor4U* colors, U32 count, U32 attribute_mask)
+{
+    HBXXH64 hash;
+
+    {
+        LL_PROFILE_ZONE_NAMED_CATEGORY_VERTEX("vb cache hash");
+
+        hash.update((U8*)vertices, count * sizeof(LLVector4a));
+        if (attribute_mask & LLVertexBuffer::MAP_TEXCOORD0)
+        {
+            hash.update((U8*)texcoords, count * sizeof(LLVector2));
+        }
+
+        if (attribute_mask & LLVertexBuffer::MAP_COLOR)
+        {
+            hash.update((U8*)colors, count * sizeof(LLColor4U));
+        }
+
+        hash.finalize();
+    }
+
+
+    U64 vhash = hash.digest();
+
+    // check the VB cache before making a new vertex buffer
+    // This is a giant hack to deal with (mostly) our terrible UI rendering code
+    // that was built on top of OpenGL immediate mode.  Huge performance wins
+    // can be had by not uploading geometry to VRAM unless absolutely necessary.
+    // Most of our usage of the "immediate mode" style draw calls is actually
+    // sending the same geometry over and over again.
+    // To leverage this, we maintain a running hash of the vertex stream being
+    // built up before a flush, and then check that hash against a VB
+    // cache just before creating a vertex buffer in VRAM
+    std::unordered_map<U64, LLVBCache>::iterator cache = sVBCache.find(vhash);
+
+    LLPointer<LLVertexBuffer> vb;
+
+    if (cache != sVBCache.end())
+    {
+        LL_PROFILE_ZONE_NAMED_CATEGORY_VERTEX("vb cache hit");
+        // cache hit, just use the cached buffer
+        vb = cache->second.vb;
+        cache->second.touched = std::chrono::steady_clock::now();
+    }
+    else
+    {
+        LL_PROFILE_ZONE_NAMED_CATEGORY_VERTEX("vb cache miss");
+        vb = new LLVertexBuffer(attribute_mask);
+        vb->allocateBuffer(count, 0);
+
+        vb->setBuffer();
+
+        vb->setPositionData(vertices);
+
+        if (attribute_mask & LLVertexBuffer::MAP_TEXCOORD0)
+        {
+            vb->setTexCoord0Data(texcoords);
+        }
+
+        if (attribute_mask & LLVertexBuffer::MAP_COLOR)
+        {
+            vb->setColorData(colors);
+        }
+
+#if LL_DARWIN
+        vb->unmapBuffer();
+#endif
+        vb->unbind();
+
+        sVBCache[vhash] = { vb , std::chrono::steady_clock::now() };
+
+        static U32 miss_count = 0;
+        miss_count++;
+        if (miss_count > 1024)
+        {
+            LL_PROFILE_ZONE_NAMED_CATEGORY_VERTEX("vb cache clean");
+            miss_count = 0;
+            auto now = std::chrono::steady_clock::now();
+
+            using namespace std::chrono_literals;
+            // every 1024 misses, clean the cache of any VBs that haven't been touched in the last second
+            for (std::unordered_map<U64, LLVBCache>::iterator iter = sVBCache.begin(); iter != sVBCache.end(); )
+            {
+                if (now - iter->second.touched > 1s)
+                {
+                    iter = sVBCache.erase(iter);
+                }
+                else
+                {
+                    ++iter;
+                }
+            }
+        }
     }
+
+    return vb;
 }
+
 void LLRender::flush()
 {
     STOP_GLERROR;
+    if (!mUISegments.empty())
+    {
+        // the pending vertices share the state the set aside ones were recorded with
+        closeUISegment();
+        submitUIBatch();
+        return;
+    }
+
     if (mCount > 0)
     {
         LL_PROFILE_ZONE_SCOPED_CATEGORY_PIPELINE;
@@ -1677,128 +1787,234 @@ void LLRender::flush()
 
         if (mBuffer)
         {
-
-            HBXXH64 hash;
             U32 attribute_mask = LLGLSLShader::sCurBoundShaderPtr->mAttributeMask;
+            LLPointer<LLVertexBuffer> vb = getCachedBuffer((LLVector4a*)mVerticesp.get(), mTexcoordsp.get(), mColorsp.get(),
+                                                           count, attribute_mask);
 
+            vb->setBuffer();
+
+            // <FS:Ansariel> Remove QUADS rendering mode
+            //if (mMode == LLRender::QUADS && sGLCoreProfile)
+            //{
+            //    vb->drawArrays(LLRender::TRIANGLES, 0, count);
+            //    mQuadCycle = 1;
+            //}
+            //else
+            // </FS:Ansariel>
             {
-                LL_PROFILE_ZONE_NAMED_CATEGORY_VERTEX("vb cache hash");
+                vb->drawArrays(mMode, 0, count);
+            }
+        }
+        else
+        {
+            // mBuffer is present in main thread and not present in an image thread
+            LL_ERRS() << "A flush call from outside main rendering thread" << LL_ENDL;
+        }
 
-                hash.update((U8*)mVerticesp.get(), count * sizeof(LLVector4a));
-                if (attribute_mask & LLVertexBuffer::MAP_TEXCOORD0)
-                {
-                    hash.update((U8*)mTexcoordsp.get(), count * sizeof(LLVector2));
-                }
 
-                if (attribute_mask & LLVertexBuffer::MAP_COLOR)
-                {
-                    hash.update((U8*)mColorsp.get(), count * sizeof(LLColor4U));
-                }
+        mVerticesp[0] = mVerticesp[count];
+        mTexcoordsp[0] = mTexcoordsp[count];
+        mColorsp[0] = mColorsp[count];
 
-                hash.finalize();
-            }
+        mCount = 0;
+    }
+}
 
+void LLRender::softFlush()
+{
+    if (mUIBatching && mMode == LLRender::TRIANGLES && mCurrTextureUnitIndex == 0 && !mUIOffset.empty())
+    {
+        closeUISegment();
+    }
+    else
+    {
+        flush();
+    }
+}
+
+void LLRender::beginUIBatch()
+{
+    flush();
+    glGetIntegerv(GL_SCISSOR_BOX, mScissor.data());
+    mUIBatching = true;
+}
 
-            U64 vhash = hash.digest();
+void LLRender::endUIBatch()
+{
+    flush();
+    mUIBatching = false;
+}
 
-            // check the VB cache before making a new vertex buffer
-            // This is a giant hack to deal with (mostly) our terrible UI rendering code
-            // that was built on top of OpenGL immediate mode.  Huge performance wins
-            // can be had by not uploading geometry to VRAM unless absolutely necessary.
-            // Most of our usage of the "immediate mode" style draw calls is actually
-            // sending the same geometry over and over again.
-            // To leverage this, we maintain a running hash of the vertex stream being
-            // built up before a flush, and then check that hash against a VB
-            // cache just before creating a vertex buffer in VRAM
-            std::unordered_map<U64, LLVBCache>::iterator cache = sVBCache.find(vhash);
+void LLRender::setScissor(S32 x, S32 y, S32 width, S32 height)
+{
+    if (mUIBatching)
+    {
+        softFlush();
+        mScissor = { x, y, width, height };
+    }
+    else
+    {
+        flush();
+    }
+    glScissor(x, y, width, height);
+}
+
+void LLRender::closeUISegment()
+{
+    // number of segments searched for one to join, bounds the cost of the overlap tests
+    constexpr S32 UI_BATCH_SEARCH_DEPTH = 32;
+
+    U32 count = mCount - mCount % 3;
+    if (count > 0)
+    {
+        LL_PROFILE_ZONE_SCOPED_CATEGORY_PIPELINE;
+        sUIVerts += count;
 
-            LLPointer<LLVertexBuffer> vb;
+        LLTexUnit& unit = mTexUnits[0];
+        U32 texture = unit.getCurrType() == LLTexUnit::TT_NONE ? 0 : unit.getCurrTexture();
 
-            if (cache != sVBCache.end())
+        U32 offset = (U32)mUIBatchVertices.size();
+        LLVector2 min(F32_MAX, F32_MAX);
+        LLVector2 max(-F32_MAX, -F32_MAX);
+        for (U32 i = 0; i < count; ++i)
+        {
+            const LLVector3& v = mVerticesp[i];
+            mUIBatchVertices.emplace_back().load3(v.mV);
+            min.set(llmin(min.mV[VX], v.mV[VX]), llmin(min.mV[VY], v.mV[VY]));
+            max.set(llmax(max.mV[VX], v.mV[VX]), llmax(max.mV[VY], v.mV[VY]));
+        }
+        mUIBatchTexCoords.insert(mUIBatchTexCoords.end(), mTexcoordsp.get(), mTexcoordsp.get() + count);
+        mUIBatchColors.insert(mUIBatchColors.end(), mColorsp.get(), mColorsp.get() + count);
+
+        U32 chunk = (U32)mUIBatchChunks.size();
+        mUIBatchChunks.push_back({ offset, count, U32_MAX });
+
+        // Join the latest segment with the same texture and scissor box, unless a segment
+        // drawn after it overlaps these vertices and so has to stay on top of them
+        bool joined = false;
+        S32 lowest = llmax((S32)mUISegments.size() - UI_BATCH_SEARCH_DEPTH, 0);
+        for (S32 i = (S32)mUISegments.size() - 1; i >= lowest; --i)
+        {
+            UIBatchSegment& segment = mUISegments[i];
+            if (segment.mTexture == texture && segment.mScissor == mScissor)
             {
-                LL_PROFILE_ZONE_NAMED_CATEGORY_VERTEX("vb cache hit");
-                // cache hit, just use the cached buffer
-                vb = cache->second.vb;
-                cache->second.touched = std::chrono::steady_clock::now();
+                mUIBatchChunks[segment.mLastChunk].mNext = chunk;
+                segment.mLastChunk = chunk;
+                segment.mCount += count;
+                segment.mMin.set(llmin(segment.mMin.mV[VX], min.mV[VX]), llmin(segment.mMin.mV[VY], min.mV[VY]));
+                segment.mMax.set(llmax(segment.mMax.mV[VX], max.mV[VX]), llmax(segment.mMax.mV[VY], max.mV[VY]));
+                joined = true;
+                break;
             }
-            else
+
+            if (segment.mMin.mV[VX] < max.mV[VX] && min.mV[VX] < segment.mMax.mV[VX] &&
+                segment.mMin.mV[VY] < max.mV[VY] && min.mV[VY] < segment.mMax.mV[VY])
             {
-                LL_PROFILE_ZONE_NAMED_CATEGORY_VERTEX("vb cache miss");
-                vb = new LLVertexBuffer(attribute_mask);
-                vb->allocateBuffer(count, 0);
+                break;
+            }
+        }
 
-                vb->setBuffer();
+        if (!joined)
+        {
+            mUISegments.push_back({ texture, mScissor, min, max, chunk, chunk, count });
+        }
+    }
 
-                vb->setPositionData((LLVector4a*) mVerticesp.get());
+    mVerticesp[0] = mVerticesp[mCount];
+    mTexcoordsp[0] = mTexcoordsp[mCount];
+    mColorsp[0] = mColorsp[mCount];
 
-                if (attribute_mask & LLVertexBuffer::MAP_TEXCOORD0)
-                {
-                    vb->setTexCoord0Data(mTexcoordsp.get());
-                }
+    mCount = 0;
+}
 
-                if (attribute_mask & LLVertexBuffer::MAP_COLOR)
-                {
-                    vb->setColorData(mColorsp.get());
-                }
+void LLRender::submitUIBatch()
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_PIPELINE;
+    llassert(LLGLSLShader::sCurBoundShaderPtr != nullptr);
 
-#if LL_DARWIN
-                vb->unmapBuffer();
-#endif
-                vb->unbind();
+    if (!mBuffer)
+    {
+        LL_ERRS() << "A flush call from outside main rendering thread" << LL_ENDL;
+    }
 
-                sVBCache[vhash] = { vb , std::chrono::steady_clock::now() };
+    U32 total = (U32)mUIBatchVertices.size();
+    mUIDrawVertices.resize(total);
+    mUIDrawTexCoords.resize(total);
+    mUIDrawColors.resize(total);
 
-                static U32 miss_count = 0;
-                miss_count++;
-                if (miss_count > 1024)
-                {
-                    LL_PROFILE_ZONE_NAMED_CATEGORY_VERTEX("vb cache clean");
-                    miss_count = 0;
-                    auto now = std::chrono::steady_clock::now();
+    U32 offset = 0;
+    for (const UIBatchSegment& segment : mUISegments)
+    {
+        for (U32 i = segment.mFirstChunk; i != U32_MAX; i = mUIBatchChunks[i].mNext)
+        {
+            const UIBatchChunk& chunk = mUIBatchChunks[i];
+            std::copy_n(mUIBatchVertices.begin() + chunk.mOffset, chunk.mCount, mUIDrawVertices.begin() + offset);
+            std::copy_n(mUIBatchTexCoords.begin() + chunk.mOffset, chunk.mCount, mUIDrawTexCoords.begin() + offset);
+            std::copy_n(mUIBatchColors.begin() + chunk.mOffset, chunk.mCount, mUIDrawColors.begin() + offset);
+            offset += chunk.mCount;
+        }
+    }
 
-                    using namespace std::chrono_literals;
-                    // every 1024 misses, clean the cache of any VBs that haven't been touched in the last second
-                    for (std::unordered_map<U64, LLVBCache>::iterator iter = sVBCache.begin(); iter != sVBCache.end(); )
-                    {
-                        if (now - iter->second.touched > 1s)
-                        {
-                            iter = sVBCache.erase(iter);
-                        }
-                        else
-                        {
-                            ++iter;
-                        }
-                    }
-                }
-            }
+    // setBuffer() below flushes while there is a batch
+    mUIDraws.swap(mUISegments);
+    mUISegments.clear();
+    mUIBatchChunks.clear();
+    mUIBatchVertices.clear();
+    mUIBatchTexCoords.clear();
+    mUIBatchColors.clear();
 
-            vb->setBuffer();
+    U32 attribute_mask = LLGLSLShader::sCurBoundShaderPtr->mAttributeMask;
+    LLPointer<LLVertexBuffer> vb = getCachedBuffer(mUIDrawVertices.data(), mUIDrawTexCoords.data(), mUIDrawColors.data(),
+                                                   total, attribute_mask);
+    vb->setBuffer();
 
-            // <FS:Ansariel> Remove QUADS rendering mode
-            //if (mMode == LLRender::QUADS && sGLCoreProfile)
-            //{
-            //    vb->drawArrays(LLRender::TRIANGLES, 0, count);
-            //    mQuadCycle = 1;
-            //}
-            //else
-            // </FS:Ansariel>
-            {
-                vb->drawArrays(mMode, 0, count);
-            }
+    if (mCurrTextureUnitIndex != 0)
+    {
+        glActiveTexture(GL_TEXTURE0);
+    }
+
+    LLTexUnit& unit = mTexUnits[0];
+    GLenum target = unit.getCurrType() == LLTexUnit::TT_NONE ? GL_TEXTURE_2D : sGLTextureType[unit.getCurrType()];
+    U32 texture = unit.getCurrType() == LLTexUnit::TT_NONE ? 0 : unit.getCurrTexture();
+    U32 bound_texture = texture;
+    std::array<S32, 4> scissor = mScissor;
+
+    offset = 0;
+    for (const UIBatchSegment& segment : mUIDraws)
+    {
+        if (segment.mTexture != bound_texture)
+        {
+            bound_texture = segment.mTexture;
+            glBindTexture(target, bound_texture);
         }
-        else
+
+        if (segment.mScissor != scissor)
         {
-            // mBuffer is present in main thread and not present in an image thread
-            LL_ERRS() << "A flush call from outside main rendering thread" << LL_ENDL;
+            scissor = segment.mScissor;
+            glScissor(scissor[0], scissor[1], scissor[2], scissor[3]);
         }
 
+        vb->drawArrays(LLRender::TRIANGLES, offset, segment.mCount);
+        offset += segment.mCount;
+        sUICalls++;
+    }
+
+    if (bound_texture != texture)
+    {
+        glBindTexture(target, texture);
+    }
 
-        mVerticesp[0] = mVerticesp[count];
-        mTexcoordsp[0] = mTexcoordsp[count];
-        mColorsp[0] = mColorsp[count];
+    if (scissor != mScissor)
+    {
+        glScissor(mScissor[0], mScissor[1], mScissor[2], mScissor[3]);
+    }
 
-        mCount = 0;
+    if (mCurrTextureUnitIndex != 0)
+    {
+        glActiveTexture(GL_TEXTURE0 + mCurrTextureUnitIndex);
     }
+
+    mUIDraws.clear();
 }
 
 void LLRender::vertex3f(const GLfloat& x, const GLfloat& y, const GLfloat& z)
@@ -1809,7 +2025,7 @@ void LLRender::vertex3f(const GLfloat& x, const GLfloat& y, const GLfloat& z)
         switch (mMode)
         {
             case LLRender::POINTS: flush(); break;
-            case LLRender::TRIANGLES: if (mCount%3==0) flush(); break;
+            case LLRender::TRIANGLES: if (mCount%3==0) softFlush(); break;
             // <FS:Ansariel> Remove QUADS rendering mode
             //case LLRender::QUADS: if(mCount%4 == 0) flush(); break;
             case LLRender::LINES: if (mCount%2 == 0) flush(); break;
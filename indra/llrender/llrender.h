@@ -431,6 +431,22 @@ public:
 
     void flush();
 
+    // Like flush(), but while batching UI triangles the pending vertices are only set
+    // aside, to be drawn with the rest of the batch at the next flush().  For callers
+    // that are about to change nothing but the texture bound to unit 0 or the scissor box.
+    void softFlush();
+
+    // Between beginUIBatch() and endUIBatch(), UI triangles that only differ in the texture
+    // bound to unit 0 or in the scissor box are gathered into one vertex buffer and drawn
+    // grouped by texture and scissor box, as far as overlapping geometry allows.  Any other
+    // state change, and any other vertex buffer being set, draws the batch first.
+    void beginUIBatch();
+    void endUIBatch();
+    bool hasUIBatch() const { return !mUISegments.empty(); }
+
+    // glScissor, soft flushing instead of flushing while batching UI
+    void setScissor(S32 x, S32 y, S32 width, S32 height);
+
     void begin(const GLuint& mode);
     void end();
     void vertex2i(const GLint& x, const GLint& y);
@@ -503,6 +519,32 @@ public:
 private:
     friend class LLLightState;
 
+    // Triangles set aside while batching UI that share a texture and scissor box
+    struct UIBatchSegment
+    {
+        U32 mTexture;           // bound to unit 0, whose texture type can't change within a batch
+        std::array<S32, 4> mScissor;
+        LLVector2 mMin;         // bounds of the vertices in UI coordinates
+        LLVector2 mMax;
+        U32 mFirstChunk;        // vertex ranges in mUIBatchChunks, linked in draw order
+        U32 mLastChunk;
+        U32 mCount;
+    };
+
+    struct UIBatchChunk
+    {
+        U32 mOffset;            // in mUIBatchVertices
+        U32 mCount;
+        U32 mNext;
+    };
+
+    // Vertex buffer holding the given vertices, from sVBCache if possible
+    LLPointer<LLVertexBuffer> getCachedBuffer(const LLVector4a* vertices, const LLVector2* texcoords,
+        const LLColor4U* colors, U32 count, U32 attribute_mask);
+
+    void closeUISegment();
+    void submitUIBatch();
+
     eMatrixMode mMatrixMode;
     U32 mMatIdx[NUM_MATRIX_MODES];
     U32 mMatHash[NUM_MATRIX_MODES];
@@ -540,6 +582,19 @@ private:
     std::vector<LLVector3> mUIOffset;
     std::vector<LLVector3> mUIScale;
 
+    bool mUIBatching;
+    std::array<S32, 4> mScissor;    // last set with setScissor() while batching UI
+    std::vector<UIBatchSegment> mUISegments;
+    std::vector<UIBatchSegment> mUIDraws;   // segments being drawn by submitUIBatch()
+    std::vector<UIBatchChunk> mUIBatchChunks;
+    std::vector<LLVector4a> mUIBatchVertices;
+    std::vector<LLVector2> mUIBatchTexCoords;
+    std::vector<LLColor4U> mUIBatchColors;
+    // mUIBatch* reordered by segment for upload
+    std::vector<LLVector4a> mUIDrawVertices;
+    std::vector<LLVector2> mUIDrawTexCoords;
+    std::vector<LLColor4U> mUIDrawColors;
+
 };
 
 extern F32 gGLModelView[16];
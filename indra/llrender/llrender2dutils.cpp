@@ -384,6 +384,60 @@ void gl_draw_scaled_image_with_border(S32 x, S32 y, S32 border_width, S32 border
     gl_draw_scaled_image_with_border(x, y, width, height, image, color, solid_color, uv_rect, scale_rect, scale_inner);
 }
 
+LLRectf gl_scaled_image_center_rect(S32 width, S32 height, S32 image_pixel_width, S32 image_pixel_height, const LLRectf& uv_outer_rect, const LLRectf& center_rect, bool scale_inner)
+{
+    F32 image_width = (F32)image_pixel_width;
+    F32 image_height = (F32)image_pixel_height;
+
+    F32 uv_width = uv_outer_rect.getWidth();
+    F32 uv_height = uv_outer_rect.getHeight();
+
+    LLRectf uv_center_rect( uv_outer_rect.mLeft + (center_rect.mLeft * uv_width),
+                            uv_outer_rect.mBottom + (center_rect.mTop * uv_height),
+                            uv_outer_rect.mLeft + (center_rect.mRight * uv_width),
+                            uv_outer_rect.mBottom + (center_rect.mBottom * uv_height));
+
+    S32 image_natural_width = ll_round(image_width * uv_width);
+    S32 image_natural_height = ll_round(image_height * uv_height);
+
+    // relative to the outer rect, which need not start at the texture's origin
+    LLRectf draw_center_rect(   (uv_center_rect.mLeft - uv_outer_rect.mLeft) * image_width,
+                                (uv_center_rect.mTop - uv_outer_rect.mBottom) * image_height,
+                                (uv_center_rect.mRight - uv_outer_rect.mLeft) * image_width,
+                                (uv_center_rect.mBottom - uv_outer_rect.mBottom) * image_height);
+
+    if (scale_inner)
+    {
+        // scale center region of image to drawn region
+        draw_center_rect.mRight += width - image_natural_width;
+        draw_center_rect.mTop += height - image_natural_height;
+
+        const F32 border_shrink_width = llmax(0.f, draw_center_rect.mLeft - draw_center_rect.mRight);
+        const F32 border_shrink_height = llmax(0.f, draw_center_rect.mBottom - draw_center_rect.mTop);
+
+        const F32 shrink_width_ratio = center_rect.getWidth() == 1.f ? 0.f : border_shrink_width / ((F32)image_natural_width * (1.f - center_rect.getWidth()));
+        const F32 shrink_height_ratio = center_rect.getHeight() == 1.f ? 0.f : border_shrink_height / ((F32)image_natural_height * (1.f - center_rect.getHeight()));
+
+        const F32 border_shrink_scale = 1.f - llmax(shrink_width_ratio, shrink_height_ratio);
+        draw_center_rect.mLeft *= border_shrink_scale;
+        draw_center_rect.mTop = lerp((F32)height, (F32)draw_center_rect.mTop, border_shrink_scale);
+        draw_center_rect.mRight = lerp((F32)width, (F32)draw_center_rect.mRight, border_shrink_scale);
+        draw_center_rect.mBottom *= border_shrink_scale;
+    }
+    else
+    {
+        // keep center region of image at fixed scale, but in same relative position
+        F32 scale_factor = llmin((F32)width / draw_center_rect.getWidth(), (F32)height / draw_center_rect.getHeight(), 1.f);
+        F32 scaled_width = draw_center_rect.getWidth() * scale_factor;
+        F32 scaled_height = draw_center_rect.getHeight() * scale_factor;
+        draw_center_rect.setCenterAndSize((uv_center_rect.getCenterX() - uv_outer_rect.mLeft) / uv_width * width,
+                                          (uv_center_rect.getCenterY() - uv_outer_rect.mBottom) / uv_height * height,
+                                          scaled_width, scaled_height);
+    }
+
+    return draw_center_rect;
+}
+
 void gl_draw_scaled_image_with_border(S32 x, S32 y, S32 width, S32 height, LLTexture* image, const LLColor4& color, bool solid_color, const LLRectf& uv_outer_rect, const LLRectf& center_rect, bool scale_inner)
 {
     stop_glerror();
@@ -421,43 +475,8 @@ void gl_draw_scaled_image_with_border(S32 x, S32 y, S32 width, S32 height, LLTex
                                 uv_outer_rect.mLeft + (center_rect.mRight * uv_width),
                                 uv_outer_rect.mBottom + (center_rect.mBottom * uv_height));
 
-        F32 image_width = (F32)image->getWidth(0);
-        F32 image_height = (F32)image->getHeight(0);
-
-        S32 image_natural_width = ll_round(image_width * uv_width);
-        S32 image_natural_height = ll_round(image_height * uv_height);
-
-        LLRectf draw_center_rect(   uv_center_rect.mLeft * image_width,
-                                    uv_center_rect.mTop * image_height,
-                                    uv_center_rect.mRight * image_width,
-                                    uv_center_rect.mBottom * image_height);
-
-        if (scale_inner)
-        {
-            // scale center region of image to drawn region
-            draw_center_rect.mRight += width - image_natural_width;
-            draw_center_rect.mTop += height - image_natural_height;
-
-            const F32 border_shrink_width = llmax(0.f, draw_center_rect.mLeft - draw_center_rect.mRight);
-            const F32 border_shrink_height = llmax(0.f, draw_center_rect.mBottom - draw_center_rect.mTop);
-
-            const F32 shrink_width_ratio = center_rect.getWidth() == 1.f ? 0.f : border_shrink_width / ((F32)image_natural_width * (1.f - center_rect.getWidth()));
-            const F32 shrink_height_ratio = center_rect.getHeight() == 1.f ? 0.f : border_shrink_height / ((F32)image_natural_height * (1.f - center_rect.getHeight()));
-
-            const F32 border_shrink_scale = 1.f - llmax(shrink_width_ratio, shrink_height_ratio);
-            draw_center_rect.mLeft *= border_shrink_scale;
-            draw_center_rect.mTop = lerp((F32)height, (F32)draw_center_rect.mTop, border_shrink_scale);
-            draw_center_rect.mRight = lerp((F32)width, (F32)draw_center_rect.mRight, border_shrink_scale);
-            draw_center_rect.mBottom *= border_shrink_scale;
-        }
-        else
-        {
-            // keep center region of image at fixed scale, but in same relative position
-            F32 scale_factor = llmin((F32)width / draw_center_rect.getWidth(), (F32)height / draw_center_rect.getHeight(), 1.f);
-            F32 scaled_width = draw_center_rect.getWidth() * scale_factor;
-            F32 scaled_height = draw_center_rect.getHeight() * scale_factor;
-            draw_center_rect.setCenterAndSize(uv_center_rect.getCenterX() * width, uv_center_rect.getCenterY() * height, scaled_width, scaled_height);
-        }
+        LLRectf draw_center_rect = gl_scaled_image_center_rect(width, height, image->getWidth(0), image->getHeight(0),
+                                                               uv_outer_rect, center_rect, scale_inner);
 
         draw_center_rect.mLeft   = (F32)ll_round(ui_translation.mV[VX] + (F32)draw_center_rect.mLeft * ui_scale.mV[VX]);
         draw_center_rect.mTop    = (F32)ll_round(ui_translation.mV[VY] + (F32)draw_center_rect.mTop * ui_scale.mV[VY]);
@@ -78,6 +78,9 @@ void gl_draw_rotated_image(S32 x, S32 y, F32 degrees, LLTexture* image, const LL
 void gl_draw_scaled_rotated_image(S32 x, S32 y, S32 width, S32 height, F32 degrees, LLTexture* image, const LLColor4& color = UI_VERTEX_COLOR, const LLRectf& uv_rect = LLRectf(0.f, 1.f, 1.f, 0.f), LLRenderTarget* target = NULL);
 void gl_draw_scaled_image_with_border(S32 x, S32 y, S32 border_width, S32 border_height, S32 width, S32 height, LLTexture* image, const LLColor4 &color, bool solid_color = false, const LLRectf& uv_rect = LLRectf(0.f, 1.f, 1.f, 0.f), bool scale_inner = true);
 void gl_draw_scaled_image_with_border(S32 x, S32 y, S32 width, S32 height, LLTexture* image, const LLColor4 &color, bool solid_color = false, const LLRectf& uv_rect = LLRectf(0.f, 1.f, 1.f, 0.f), const LLRectf& scale_rect = LLRectf(0.f, 1.f, 1.f, 0.f), bool scale_inner = true);
+// Where gl_draw_scaled_image_with_border() draws center_rect (a fraction of uv_outer_rect) in a width x height
+// rect, for an image_pixel_width x image_pixel_height texture; uv_outer_rect may be a sub-rect of an atlas page
+LLRectf gl_scaled_image_center_rect(S32 width, S32 height, S32 image_pixel_width, S32 image_pixel_height, const LLRectf& uv_outer_rect, const LLRectf& center_rect, bool scale_inner);
 
 void gl_line_3d( const LLVector3& start, const LLVector3& end, const LLColor4& color);
 
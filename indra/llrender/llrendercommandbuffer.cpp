@@ -0,0 +1,387 @@
+/**
+ * @file llrendercommandbuffer.cpp
+ * @brief Recorded list of render commands, replayed on the GL thread
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llrendercommandbuffer.h"
+
+#include "llglslshader.h"
+#include "llglstates.h"
+#include "llrendertarget.h"
+#include "lltexture.h"
+#include "llvertexbuffer.h"
+
+#include <memory>
+
+extern LL_COMMON_API bool on_main_thread();
+
+LLRenderCommandBuffer::Command& LLRenderCommandBuffer::add(ECommand type, void* object)
+{
+    Command& command = mCommands.emplace_back();
+    command.mType = type;
+    command.mObject = object;
+    memset(command.mArgs, 0, sizeof(command.mArgs));
+    return command;
+}
+
+U32 LLRenderCommandBuffer::addData(const void* data, U32 size)
+{
+    // keep every block 16 byte aligned for the float arrays read back from it
+    U32 offset = (U32)mData.size();
+    mData.resize(offset + ((size + 15) & ~15));
+    memcpy(&mData[offset], data, size);
+    return offset;
+}
+
+void LLRenderCommandBuffer::clear()
+{
+    mCommands.clear();
+    mData.clear();
+}
+
+void LLRenderCommandBuffer::bindShader(LLGLSLShader* shader)
+{
+    add(BIND_SHADER, shader);
+}
+
+void LLRenderCommandBuffer::unbindShader()
+{
+    add(UNBIND_SHADER);
+}
+
+void LLRenderCommandBuffer::uniform1i(U32 index, S32 value)
+{
+    Command& command = add(UNIFORM_1I);
+    command.mArgs[0] = index;
+    command.mArgs[1] = (U32)value;
+}
+
+void LLRenderCommandBuffer::uniform1f(U32 index, F32 value)
+{
+    Command& command = add(UNIFORM_1F);
+    command.mArgs[0] = index;
+    memcpy(&command.mArgs[1], &value, sizeof(value));
+}
+
+void LLRenderCommandBuffer::uniform2fv(U32 index, U32 count, const F32* values)
+{
+    U32 offset = addData(values, count * 2 * sizeof(F32));
+    Command& command = add(UNIFORM_2FV);
+    command.mArgs[0] = index;
+    command.mArgs[1] = count;
+    command.mArgs[2] = offset;
+}
+
+void LLRenderCommandBuffer::uniform3fv(U32 index, U32 count, const F32* values)
+{
+    U32 offset = addData(values, count * 3 * sizeof(F32));
+    Command& command = add(UNIFORM_3FV);
+    command.mArgs[0] = index;
+    command.mArgs[1] = count;
+    command.mArgs[2] = offset;
+}
+
+void LLRenderCommandBuffer::uniform4fv(U32 index, U32 count, const F32* values)
+{
+    U32 offset = addData(values, count * 4 * sizeof(F32));
+    Command& command = add(UNIFORM_4FV);
+    command.mArgs[0] = index;
+    command.mArgs[1] = count;
+    command.mArgs[2] = offset;
+}
+
+void LLRenderCommandBuffer::uniformMatrix4fv(U32 index, U32 count, bool transpose, const F32* values)
+{
+    U32 offset = addData(values, count * 16 * sizeof(F32));
+    Command& command = add(UNIFORM_MATRIX_4FV);
+    command.mArgs[0] = index;
+    command.mArgs[1] = count;
+    command.mArgs[2] = offset;
+    command.mArgs[3] = transpose;
+}
+
+void LLRenderCommandBuffer::bindTexture(U32 index, LLTexture* texture)
+{
+    Command& command = add(BIND_TEXTURE, texture);
+    command.mArgs[0] = index;
+}
+
+void LLRenderCommandBuffer::bindTexture(U32 index, LLRenderTarget* target, bool depth, U32 attachment)
+{
+    Command& command = add(BIND_TARGET_TEXTURE, target);
+    command.mArgs[0] = index;
+    command.mArgs[1] = depth;
+    command.mArgs[2] = attachment;
+}
+
+void LLRenderCommandBuffer::updateBuffer(U32 target, U32 buffer, U32 offset, U32 size, const void* data)
+{
+    U32 data_offset = addData(data, size);
+    Command& command = add(UPDATE_BUFFER);
+    command.mArgs[0] = target;
+    command.mArgs[1] = buffer;
+    command.mArgs[2] = offset;
+    command.mArgs[3] = size;
+    command.mArgs[4] = data_offset;
+}
+
+void LLRenderCommandBuffer::bindBufferBase(U32 target, U32 binding, U32 buffer)
+{
+    Command& command = add(BIND_BUFFER_BASE);
+    command.mArgs[0] = target;
+    command.mArgs[1] = binding;
+    command.mArgs[2] = buffer;
+}
+
+void LLRenderCommandBuffer::bindTarget(LLRenderTarget* target)
+{
+    add(BIND_TARGET, target);
+}
+
+void LLRenderCommandBuffer::flushTarget(LLRenderTarget* target)
+{
+    add(FLUSH_TARGET, target);
+}
+
+void LLRenderCommandBuffer::clearTarget(LLRenderTarget* target, U32 mask)
+{
+    Command& command = add(CLEAR_TARGET, target);
+    command.mArgs[0] = mask;
+}
+
+void LLRenderCommandBuffer::pushCap(U32 cap, bool enabled)
+{
+    Command& command = add(PUSH_CAP);
+    command.mArgs[0] = cap;
+    command.mArgs[1] = enabled;
+}
+
+void LLRenderCommandBuffer::popCap()
+{
+    add(POP_CAP);
+}
+
+void LLRenderCommandBuffer::pushDepthTest(bool enabled, bool write, U32 func)
+{
+    Command& command = add(PUSH_DEPTH_TEST);
+    command.mArgs[0] = enabled;
+    command.mArgs[1] = write;
+    command.mArgs[2] = func;
+}
+
+void LLRenderCommandBuffer::popDepthTest()
+{
+    add(POP_DEPTH_TEST);
+}
+
+void LLRenderCommandBuffer::setColorMask(bool color, bool alpha)
+{
+    Command& command = add(COLOR_MASK);
+    command.mArgs[0] = color;
+    command.mArgs[1] = alpha;
+}
+
+void LLRenderCommandBuffer::setSceneBlendType(LLRender::eBlendType type)
+{
+    Command& command = add(BLEND_TYPE);
+    command.mArgs[0] = type;
+}
+
+void LLRenderCommandBuffer::loadModelMatrix(const F32* matrix)
+{
+    U32 offset = addData(matrix, 16 * sizeof(F32));
+    Command& command = add(LOAD_MODEL_MATRIX);
+    command.mArgs[0] = offset;
+}
+
+void LLRenderCommandBuffer::loadIdentityModelMatrix()
+{
+    add(LOAD_IDENTITY_MODEL_MATRIX);
+}
+
+void LLRenderCommandBuffer::drawArrays(LLVertexBuffer* buffer, U32 mode, U32 first, U32 count)
+{
+    Command& command = add(DRAW_ARRAYS, buffer);
+    command.mArgs[0] = mode;
+    command.mArgs[1] = first;
+    command.mArgs[2] = count;
+}
+
+void LLRenderCommandBuffer::drawRange(LLVertexBuffer* buffer, U32 mode, U32 start, U32 end, U32 count, U32 indices_offset)
+{
+    Command& command = add(DRAW_RANGE, buffer);
+    command.mArgs[0] = mode;
+    command.mArgs[1] = start;
+    command.mArgs[2] = end;
+    command.mArgs[3] = count;
+    command.mArgs[4] = indices_offset;
+}
+
+void LLRenderCommandBuffer::drawInstanced(LLVertexBuffer* buffer, U32 mode, U32 count, U32 indices_offset, U32 instances)
+{
+    Command& command = add(DRAW_INSTANCED, buffer);
+    command.mArgs[0] = mode;
+    command.mArgs[1] = count;
+    command.mArgs[2] = indices_offset;
+    command.mArgs[3] = instances;
+}
+
+void LLRenderCommandBuffer::replay() const
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_PIPELINE;
+    llassert(on_main_thread());
+
+    // state pushed by the recording, released in reverse order on the way out
+    std::vector<std::unique_ptr<LLGLState> > caps;
+    std::vector<std::unique_ptr<LLGLDepthTest> > depth_tests;
+
+    for (const Command& command : mCommands)
+    {
+        const U32* args = command.mArgs;
+        LLGLSLShader* shader = LLGLSLShader::sCurBoundShaderPtr;
+        switch (command.mType)
+        {
+        case BIND_SHADER:
+            ((LLGLSLShader*)command.mObject)->bind();
+            break;
+        case UNBIND_SHADER:
+            LLGLSLShader::unbind();
+            break;
+        case UNIFORM_1I:
+            llassert(shader);
+            shader->uniform1i(args[0], (S32)args[1]);
+            break;
+        case UNIFORM_1F:
+        {
+            llassert(shader);
+            F32 value;
+            memcpy(&value, &args[1], sizeof(value));
+            shader->uniform1f(args[0], value);
+            break;
+        }
+        case UNIFORM_2FV:
+            llassert(shader);
+            shader->uniform2fv(args[0], args[1], (const F32*)&mData[args[2]]);
+            break;
+        case UNIFORM_3FV:
+            llassert(shader);
+            shader->uniform3fv(args[0], args[1], (const F32*)&mData[args[2]]);
+            break;
+        case UNIFORM_4FV:
+            llassert(shader);
+            shader->uniform4fv(args[0], args[1], (const F32*)&mData[args[2]]);
+            break;
+        case UNIFORM_MATRIX_4FV:
+            llassert(shader);
+            shader->uniformMatrix4fv(args[0], args[1], args[3] ? GL_TRUE : GL_FALSE, (const F32*)&mData[args[2]]);
+            break;
+        case BIND_TEXTURE:
+            llassert(shader);
+            shader->bindTexture((S32)args[0], (LLTexture*)command.mObject);
+            break;
+        case BIND_TARGET_TEXTURE:
+            llassert(shader);
+            shader->bindTexture((S32)args[0], (LLRenderTarget*)command.mObject, args[1] != 0, LLTexUnit::TFO_BILINEAR, args[2]);
+            break;
+        case UPDATE_BUFFER:
+            glBindBuffer(args[0], args[1]);
+            glBufferSubData(args[0], args[2], args[3], &mData[args[4]]);
+            glBindBuffer(args[0], 0);
+            break;
+        case BIND_BUFFER_BASE:
+            glBindBufferBase(args[0], args[1], args[2]);
+            break;
+        case BIND_TARGET:
+            ((LLRenderTarget*)command.mObject)->bindTarget();
+            break;
+        case FLUSH_TARGET:
+            ((LLRenderTarget*)command.mObject)->flush();
+            break;
+        case CLEAR_TARGET:
+            ((LLRenderTarget*)command.mObject)->clear(args[0]);
+            break;
+        case PUSH_CAP:
+            caps.emplace_back(new LLGLState(args[0], args[1] ? 1 : 0));
+            break;
+        case POP_CAP:
+            llassert(!caps.empty());
+            caps.pop_back();
+            break;
+        case PUSH_DEPTH_TEST:
+            depth_tests.emplace_back(new LLGLDepthTest(args[0] ? GL_TRUE : GL_FALSE, args[1] ? GL_TRUE : GL_FALSE, args[2]));
+            break;
+        case POP_DEPTH_TEST:
+            llassert(!depth_tests.empty());
+            depth_tests.pop_back();
+            break;
+        case COLOR_MASK:
+            gGL.setColorMask(args[0] != 0, args[1] != 0);
+            break;
+        case BLEND_TYPE:
+            gGL.setSceneBlendType((LLRender::eBlendType)args[0]);
+            break;
+        case LOAD_MODEL_MATRIX:
+            gGL.matrixMode(LLRender::MM_MODELVIEW);
+            gGL.loadMatrix((const F32*)&mData[args[0]]);
+            break;
+        case LOAD_IDENTITY_MODEL_MATRIX:
+            gGL.matrixMode(LLRender::MM_MODELVIEW);
+            gGL.loadIdentity();
+            break;
+        case DRAW_ARRAYS:
+        case DRAW_RANGE:
+        case DRAW_INSTANCED:
+        {
+            // setBuffer skips the rebind when nothing changed since the last draw
+            LLVertexBuffer* buffer = (LLVertexBuffer*)command.mObject;
+            buffer->setBuffer();
+            if (command.mType == DRAW_ARRAYS)
+            {
+                buffer->drawArrays(args[0], args[1], args[2]);
+            }
+            else if (command.mType == DRAW_RANGE)
+            {
+                buffer->drawRange(args[0], args[1], args[2], args[3], args[4]);
+            }
+            else
+            {
+                buffer->drawInstanced(args[0], args[1], args[2], args[3]);
+            }
+            break;
+        }
+        }
+    }
+
+    // innermost first, as if they had gone out of scope
+    while (!depth_tests.empty())
+    {
+        depth_tests.pop_back();
+    }
+    while (!caps.empty())
+    {
+        caps.pop_back();
+    }
+}
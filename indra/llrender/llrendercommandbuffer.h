@@ -0,0 +1,150 @@
+/**
+ * @file llrendercommandbuffer.h
+ * @brief Recorded list of render commands, replayed on the GL thread
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLRENDERCOMMANDBUFFER_H
+#define LL_LLRENDERCOMMANDBUFFER_H
+
+#include "llgl.h"
+#include "llrender.h"
+
+#include <vector>
+
+class LLGLSLShader;
+class LLRenderTarget;
+class LLTexture;
+class LLVertexBuffer;
+
+// A list of draw calls, shader, texture and buffer binds, uniform and buffer updates,
+// render target switches and GL state changes.
+//
+// Recording only appends to the buffer and makes no GL calls, so any thread can record
+// into its own buffer, e.g. one per draw pool or per spatial group.  replay() issues
+// the commands through the usual LLGLSLShader, LLVertexBuffer, LLRender and LLGLState
+// paths on the GL thread, in recorded order.
+//
+// Uniform values and buffer contents are copied when recorded.  Shaders, textures,
+// vertex buffers and render targets are referenced by pointer and must stay alive
+// until the buffer has been replayed or cleared.
+//
+// Uniforms and textures apply to the shader bound by the last bindShader(), and
+// indices are LLShaderMgr uniform indices as for LLGLSLShader::uniform*().
+// State pushed with pushCap() or pushDepthTest() is scoped like LLGLEnable and
+// LLGLDepthTest: popped explicitly, or at the end of replay() at the latest.
+class LLRenderCommandBuffer
+{
+public:
+    // Shaders
+    void bindShader(LLGLSLShader* shader);
+    void unbindShader();
+    void uniform1i(U32 index, S32 value);
+    void uniform1f(U32 index, F32 value);
+    void uniform2fv(U32 index, U32 count, const F32* values);
+    void uniform3fv(U32 index, U32 count, const F32* values);
+    void uniform4fv(U32 index, U32 count, const F32* values);
+    void uniformMatrix4fv(U32 index, U32 count, bool transpose, const F32* values);
+
+    // Textures, by texture uniform index of the bound shader
+    void bindTexture(U32 index, LLTexture* texture);
+    void bindTexture(U32 index, LLRenderTarget* target, bool depth = false, U32 attachment = 0);
+
+    // Uniform and shader storage buffers, target is GL_UNIFORM_BUFFER or GL_SHADER_STORAGE_BUFFER
+    void updateBuffer(U32 target, U32 buffer, U32 offset, U32 size, const void* data);
+    void bindBufferBase(U32 target, U32 binding, U32 buffer);
+
+    // Render targets
+    void bindTarget(LLRenderTarget* target);
+    void flushTarget(LLRenderTarget* target);
+    void clearTarget(LLRenderTarget* target, U32 mask = 0xFFFFFFFF);
+
+    // GL state
+    void pushCap(U32 cap, bool enabled);
+    void popCap();
+    void pushDepthTest(bool enabled, bool write = true, U32 func = GL_LEQUAL);
+    void popDepthTest();
+    void setColorMask(bool color, bool alpha);
+    void setSceneBlendType(LLRender::eBlendType type);
+    void loadModelMatrix(const F32* matrix);
+    void loadIdentityModelMatrix();
+
+    // Draws, start/end/count/offset as for LLVertexBuffer
+    void drawArrays(LLVertexBuffer* buffer, U32 mode, U32 first, U32 count);
+    void drawRange(LLVertexBuffer* buffer, U32 mode, U32 start, U32 end, U32 count, U32 indices_offset);
+    void drawInstanced(LLVertexBuffer* buffer, U32 mode, U32 count, U32 indices_offset, U32 instances);
+
+    // Issue every recorded command, GL thread only
+    void replay() const;
+
+    void clear();
+    bool empty() const { return mCommands.empty(); }
+    U32 size() const { return (U32)mCommands.size(); }
+
+private:
+    enum ECommand : U8
+    {
+        BIND_SHADER,
+        UNBIND_SHADER,
+        UNIFORM_1I,
+        UNIFORM_1F,
+        UNIFORM_2FV,
+        UNIFORM_3FV,
+        UNIFORM_4FV,
+        UNIFORM_MATRIX_4FV,
+        BIND_TEXTURE,
+        BIND_TARGET_TEXTURE,
+        UPDATE_BUFFER,
+        BIND_BUFFER_BASE,
+        BIND_TARGET,
+        FLUSH_TARGET,
+        CLEAR_TARGET,
+        PUSH_CAP,
+        POP_CAP,
+        PUSH_DEPTH_TEST,
+        POP_DEPTH_TEST,
+        COLOR_MASK,
+        BLEND_TYPE,
+        LOAD_MODEL_MATRIX,
+        LOAD_IDENTITY_MODEL_MATRIX,
+        DRAW_ARRAYS,
+        DRAW_RANGE,
+        DRAW_INSTANCED,
+    };
+
+    struct Command
+    {
+        ECommand mType;
+        void* mObject;      // shader, texture, render target or vertex buffer
+        U32 mArgs[5];       // meaning depends on mType, see replay()
+    };
+
+    Command& add(ECommand type, void* object = nullptr);
+    // Copies bytes into mData, returns their offset
+    U32 addData(const void* data, U32 size);
+
+    std::vector<Command> mCommands;
+    std::vector<U8> mData;
+};
+
+#endif // LL_LLRENDERCOMMANDBUFFER_H
@@ -179,6 +179,14 @@ bool LLShaderMgr::attachShaderFeatures(LLGLSLShader * shader)
         return false;
     }
 
+    if (features->isTerrainHeightfield)
+    {
+        if (!shader->attachVertexObject("deferred/terrainHeightfieldUtilV.glsl"))
+        {
+            return false;
+        }
+    }
+
     ///////////////////////////////////////
     // Attach Fragment Shader Features Next
     ///////////////////////////////////////
@@ -553,8 +561,13 @@ GLuint LLShaderMgr::loadShaderFile(const std::string& filename, S32 & shader_lev
     {
         if (major_version >= 4)
         {
-            //set version to 400 or 420
-            if (minor_version >= 20)
+            //set version to 400 or 420, compute shaders need 430
+            if (type == GL_COMPUTE_SHADER)
+            {
+                llassert(minor_version >= 30); // caller must check for GL 4.3
+                shader_code_text[shader_code_count++] = strdup("#version 430\n");
+            }
+            else if (minor_version >= 20)
             {
                 shader_code_text[shader_code_count++] = strdup("#version 420\n");
             }
@@ -866,7 +879,11 @@ GLuint LLShaderMgr::loadShaderFile(const std::string& filename, S32 & shader_lev
         }
     }
 
-    if (error == GL_NO_ERROR)
+    if (error != GL_NO_ERROR)
+    {
+        ret = 0;
+    }
+    else if (!mDeferCompileStatus)
     {
         //check for errors
         GLint success = GL_TRUE;
@@ -883,10 +900,6 @@ GLuint LLShaderMgr::loadShaderFile(const std::string& filename, S32 & shader_lev
             ret = 0;
         }
     }
-    else
-    {
-        ret = 0;
-    }
     stop_glerror();
 
     //free memory
@@ -919,6 +932,57 @@ GLuint LLShaderMgr::loadShaderFile(const std::string& filename, S32 & shader_lev
     return ret;
 }
 
+bool LLShaderMgr::loadShaderFiles(std::vector<ShaderFileLoad>& files, std::map<std::string, std::string>* defines)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_SHADER;
+
+    // asking for a compile status waits for that compile, so ask only after submitting all
+    std::vector<S32> requested_levels;
+    requested_levels.reserve(files.size());
+    mDeferCompileStatus = gGLManager.mHasParallelShaderCompile;
+    for (ShaderFileLoad& file : files)
+    {
+        requested_levels.push_back(file.mShaderLevel);
+        file.mHandle = loadShaderFile(file.mFilename, file.mShaderLevel, file.mType, defines, file.mTextureIndexChannels);
+    }
+    bool deferred = mDeferCompileStatus;
+    mDeferCompileStatus = false;
+
+    bool success = true;
+    for (size_t i = 0; i < files.size(); ++i)
+    {
+        ShaderFileLoad& file = files[i];
+        if (deferred && file.mHandle)
+        {
+            GLint compiled = GL_TRUE;
+            glGetShaderiv(file.mHandle, GL_COMPILE_STATUS, &compiled);
+            if (compiled == GL_FALSE)
+            {
+                // forget the object and load it again the serial way, which logs the source
+                // and falls back to lower shader levels
+                std::map<std::string, GLuint>* objects = file.mType == GL_VERTEX_SHADER ? &mVertexShaderObjects :
+                    file.mType == GL_FRAGMENT_SHADER ? &mFragmentShaderObjects : NULL;
+                if (objects)
+                {
+                    auto it = objects->find(file.mFilename);
+                    if (it != objects->end() && it->second == file.mHandle)
+                    {
+                        objects->erase(it);
+                    }
+                }
+                glDeleteShader(file.mHandle);
+                file.mShaderLevel = requested_levels[i];
+                file.mHandle = loadShaderFile(file.mFilename, file.mShaderLevel, file.mType, defines, file.mTextureIndexChannels);
+            }
+        }
+        if (!file.mHandle)
+        {
+            success = false;
+        }
+    }
+    return success;
+}
+
 bool LLShaderMgr::linkProgramObject(GLuint obj, bool suppress_errors)
 {
     //check for errors
@@ -1428,6 +1492,7 @@ void LLShaderMgr::initAttribsAndUniforms()
 
     mReservedUniforms.push_back("alpha_ramp");
     mReservedUniforms.push_back("paint_map");
+    mReservedUniforms.push_back("heightfield_map");
 
     mReservedUniforms.push_back("detail_0_base_color");
     mReservedUniforms.push_back("detail_1_base_color");
@@ -281,6 +281,7 @@ public:
 
         TERRAIN_ALPHARAMP,                  //  "alpha_ramp"
         TERRAIN_PAINTMAP,                   //  "paint_map"
+        TERRAIN_HEIGHTFIELD,                //  "heightfield_map"
 
         TERRAIN_DETAIL0_BASE_COLOR,                //  "detail_0_base_color" (GLTF)
         TERRAIN_DETAIL1_BASE_COLOR,                //  "detail_1_base_color" (GLTF)
@@ -361,6 +362,19 @@ public:
     bool    validateProgramObject(GLuint obj);
     GLuint loadShaderFile(const std::string& filename, S32 & shader_level, GLenum type, std::map<std::string, std::string>* defines = NULL, S32 texture_index_channels = -1);
 
+    struct ShaderFileLoad
+    {
+        std::string mFilename;
+        S32 mShaderLevel;
+        GLenum mType;
+        S32 mTextureIndexChannels;
+        GLuint mHandle;
+    };
+    // Like loadShaderFile() for each of files, but with GL_KHR_parallel_shader_compile all
+    // compiles are submitted before any result is asked for, so the driver can run them at
+    // once.  Returns false if any file failed, its mHandle is 0.
+    bool loadShaderFiles(std::vector<ShaderFileLoad>& files, std::map<std::string, std::string>* defines = NULL);
+
     // Implemented in the application to actually point to the shader directory.
     virtual std::string getShaderDirPrefix(void) = 0; // Pure Virtual
 
@@ -395,6 +409,9 @@ public:
     bool mShaderCacheEnabled = false;
     std::string mShaderCacheDir;
 
+    // set by loadShaderFiles(), loadShaderFile() then leaves checking the compile to it
+    bool mDeferCompileStatus = false;
+
 protected:
 
     // our parameter manager singleton instance
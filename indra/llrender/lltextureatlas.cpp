@@ -0,0 +1,137 @@
+/**
+ * @file lltextureatlas.cpp
+ * @brief Packs small images into shared textures
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+
+#include "linden_common.h"
+
+#include "lltextureatlas.h"
+
+#include "llimage.h"
+#include "llrender.h"
+
+// Border around each image, copied from its outermost pixels
+static const S32 PADDING = 1;
+
+LLTextureAtlas::LLTextureAtlas(S32 page_size)
+:   mPageSize(page_size)
+{
+}
+
+LLTextureAtlas::~LLTextureAtlas()
+{
+}
+
+void LLTextureAtlas::clear()
+{
+    mPages.clear();
+}
+
+LLGLTexture* LLTextureAtlas::insert(const LLImageRaw* image, S32 width, S32 height, LLRectf& uv_rect)
+{
+    S32 components = image ? image->getComponents() : 0;
+    if (components < 3 || width <= 0 || height <= 0
+        || width > image->getWidth() || height > image->getHeight()
+        || width + 2 * PADDING > mPageSize || height + 2 * PADDING > mPageSize)
+    {
+        return NULL;
+    }
+
+    // only the newest page is filled, older pages had no room left for something
+    S32 pos_x = 0;
+    S32 pos_y = 0;
+    if (mPages.empty() || !allocate(mPages.back(), width + 2 * PADDING, height + 2 * PADDING, pos_x, pos_y))
+    {
+        if (!allocate(addPage(), width + 2 * PADDING, height + 2 * PADDING, pos_x, pos_y))
+        {
+            return NULL;
+        }
+    }
+    Page& page = mPages.back();
+
+    // copy the image and its border, clamping source coordinates to the image's edges
+    const U8* src = image->getData();
+    U8* dst = page.mImageRaw->getData();
+    S32 src_width = image->getWidth();
+    for (S32 y = 0; y < height + 2 * PADDING; ++y)
+    {
+        S32 src_y = llclamp(y - PADDING, 0, height - 1);
+        U8* dst_row = dst + ((pos_y + y) * mPageSize + pos_x) * 4;
+        for (S32 x = 0; x < width + 2 * PADDING; ++x)
+        {
+            S32 src_x = llclamp(x - PADDING, 0, width - 1);
+            const U8* texel = src + (src_y * src_width + src_x) * components;
+            dst_row[x * 4 + 0] = texel[0];
+            dst_row[x * 4 + 1] = texel[1];
+            dst_row[x * 4 + 2] = texel[2];
+            dst_row[x * 4 + 3] = components == 4 ? texel[3] : 255;
+        }
+    }
+    page.mTexture->setSubImage(page.mImageRaw, pos_x, pos_y, width + 2 * PADDING, height + 2 * PADDING);
+
+    F32 scale = 1.f / (F32)mPageSize;
+    uv_rect.setLeftTopAndSize((F32)(pos_x + PADDING) * scale, (F32)(pos_y + PADDING + height) * scale,
+                              (F32)width * scale, (F32)height * scale);
+    return page.mTexture;
+}
+
+bool LLTextureAtlas::allocate(Page& page, S32 width, S32 height, S32& pos_x, S32& pos_y)
+{
+    if (page.mShelfX + width > mPageSize)
+    {
+        // start a new shelf above the current one
+        page.mShelfY += page.mShelfHeight;
+        page.mShelfX = 0;
+        page.mShelfHeight = 0;
+    }
+    if (page.mShelfY + height > mPageSize)
+    {
+        return false;
+    }
+
+    pos_x = page.mShelfX;
+    pos_y = page.mShelfY;
+    page.mShelfX += width;
+    page.mShelfHeight = llmax(page.mShelfHeight, height);
+    return true;
+}
+
+LLTextureAtlas::Page& LLTextureAtlas::addPage()
+{
+    mPages.emplace_back();
+    Page& page = mPages.back();
+    page.mImageRaw = new LLImageRaw(mPageSize, mPageSize, 4);
+    page.mImageRaw->clear(0, 0, 0, 0);
+
+    // sub images are copied into the page as they come, so it must stay uncompressed
+    page.mTexture = new LLGLTexture(mPageSize, mPageSize, 4, false);
+    page.mTexture->getGLTexture()->setAllowCompression(false);
+    page.mTexture->createGLTexture(0, page.mImageRaw);
+
+    gGL.getTexUnit(0)->bind(page.mTexture);
+    page.mTexture->setFilteringOption(LLTexUnit::TFO_BILINEAR);
+    page.mTexture->setAddressMode(LLTexUnit::TAM_CLAMP);
+    return page;
+}
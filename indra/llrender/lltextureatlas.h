@@ -0,0 +1,77 @@
+/**
+ * @file lltextureatlas.h
+ * @brief Packs small images into shared textures
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+
+#ifndef LL_LLTEXTUREATLAS_H
+#define LL_LLTEXTUREATLAS_H
+
+#include <vector>
+#include "llgltexture.h"
+#include "llrect.h"
+
+class LLImageRaw;
+
+// Packs small images into a few large RGBA pages.  Images drawn one after another from the
+// same page don't rebind a texture in between, so LLRender keeps appending them to one batch
+// instead of flushing a draw call per image.
+//
+// Images are placed on shelves, left to right, with a one pixel border copied from their
+// edges so bilinear filtering at the edge of an image doesn't pick up its neighbours.
+// Nothing is ever removed; clear() drops every page at once.
+class LLTextureAtlas
+{
+public:
+    LLTextureAtlas(S32 page_size);
+    ~LLTextureAtlas();
+
+    // Copy the bottom left width x height pixels of image (3 or 4 components) into a page.
+    // Returns the page and sets uv_rect to where the image landed in it, or returns NULL
+    // if the image doesn't fit in a page.
+    LLGLTexture* insert(const LLImageRaw* image, S32 width, S32 height, LLRectf& uv_rect);
+
+    void clear();
+
+    S32 getPageSize() const { return mPageSize; }
+    U32 getNumPages() const { return static_cast<U32>(mPages.size()); }
+
+private:
+    struct Page
+    {
+        LLPointer<LLImageRaw> mImageRaw;
+        LLPointer<LLGLTexture> mTexture;
+        S32 mShelfX = 0;        // next free column on the current shelf
+        S32 mShelfY = 0;        // bottom of the current shelf
+        S32 mShelfHeight = 0;   // tallest image on the current shelf so far
+    };
+
+    bool allocate(Page& page, S32 width, S32 height, S32& pos_x, S32& pos_y);
+    Page& addPage();
+
+    std::vector<Page> mPages;
+    S32 mPageSize;
+};
+
+#endif // LL_LLTEXTUREATLAS_H
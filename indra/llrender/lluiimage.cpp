@@ -63,6 +63,15 @@ S32 LLUIImage::getHeight() const
     return ll_round((F32)mImage->getHeight(0) * mClipRegion.getHeight());
 }
 
+void LLUIImage::setAtlasRegion(LLPointer<LLTexture> atlas, const LLRectf& uv_rect)
+{
+    mAtlasImage = atlas;
+    mAtlasClipRegion.set(uv_rect.mLeft + mClipRegion.mLeft * uv_rect.getWidth(),
+                         uv_rect.mBottom + mClipRegion.mTop * uv_rect.getHeight(),
+                         uv_rect.mLeft + mClipRegion.mRight * uv_rect.getWidth(),
+                         uv_rect.mBottom + mClipRegion.mBottom * uv_rect.getHeight());
+}
+
 void LLUIImage::draw3D(const LLVector3& origin_agent, const LLVector3& x_axis, const LLVector3& y_axis,
                         const LLRect& rect, const LLColor4& color)
 {
@@ -69,6 +69,10 @@ public:
         mScaleStyle = style;
     }
 
+    // Draw from a shared atlas page instead of mImage.  uv_rect is where all of mImage sits
+    // in the page, the clip and scale regions keep referring to mImage.
+    void setAtlasRegion(LLPointer<LLTexture> atlas, const LLRectf& uv_rect);
+
     LL_FORCE_INLINE LLPointer<LLTexture> getImage() { return mImage; }
     LL_FORCE_INLINE const LLPointer<LLTexture>& getImage() const { return mImage; }
 
@@ -106,6 +110,8 @@ protected:
     LLRectf                 mScaleRegion;
     LLRectf                 mClipRegion;
     LLPointer<LLTexture>    mImage;
+    LLPointer<LLTexture>    mAtlasImage;        // drawn instead of mImage when set
+    LLRectf                 mAtlasClipRegion;   // mClipRegion in mAtlasImage
     EScaleStyle             mScaleStyle;
     mutable S32             mCachedW;
     mutable S32             mCachedH;
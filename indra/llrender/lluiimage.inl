@@ -34,10 +34,10 @@ void LLUIImage::draw(S32 x, S32 y, S32 width, S32 height, const LLColor4& color)
     gl_draw_scaled_image_with_border(
         x, y,
         width, height,
-        mImage,
+        mAtlasImage.notNull() ? mAtlasImage : mImage,
         color,
         false,
-        mClipRegion,
+        mAtlasImage.notNull() ? mAtlasClipRegion : mClipRegion,
         mScaleRegion,
         mScaleStyle == SCALE_INNER);
 }
@@ -47,10 +47,10 @@ void LLUIImage::drawSolid(S32 x, S32 y, S32 width, S32 height, const LLColor4& c
     gl_draw_scaled_image_with_border(
         x, y,
         width, height,
-        mImage,
+        mAtlasImage.notNull() ? mAtlasImage : mImage,
         color,
         true,
-        mClipRegion,
+        mAtlasImage.notNull() ? mAtlasClipRegion : mClipRegion,
         mScaleRegion,
         mScaleStyle == SCALE_INNER);
 }
@@ -567,6 +567,200 @@ public:
         mVBOPool.clear();
     }
 };
+
+// Sub-allocates byte ranges of a few large GL buffers so that geometry rebuilds
+// don't constantly create and destroy GL buffer objects.
+// Free ranges are kept per block in an offset-sorted map and coalesced on free.
+class LLVBOArena
+{
+public:
+    static constexpr U32 ALIGNMENT = 64;
+
+    struct Block
+    {
+        GLuint mGLName = 0;
+        U32 mSize = 0;
+        U32 mInUse = 0;
+        std::map<U32, U32> mFree; // offset -> size
+    };
+
+    LLVBOArena(GLenum type, U32 block_size)
+        : mType(type), mBlockSize(block_size)
+    {
+    }
+
+    ~LLVBOArena()
+    {
+        clear();
+    }
+
+    static U32 alignSize(U32 size)
+    {
+        return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    }
+
+    // allocations that would occupy a large fraction of a block go through the regular pool instead
+    bool accepts(U32 size) const
+    {
+        return alignSize(size) <= mBlockSize / 4;
+    }
+
+    bool allocate(U32 size, GLuint& name, U32& offset)
+    {
+        LL_PROFILE_ZONE_SCOPED_CATEGORY_VERTEX;
+        size = alignSize(size);
+
+        for (Block& block : mBlocks)
+        {
+            if (allocateFrom(block, size, offset))
+            {
+                name = block.mGLName;
+                return true;
+            }
+        }
+
+        { // no room in any block, add one
+            LL_PROFILE_ZONE_NAMED_CATEGORY_VERTEX("vbo arena grow");
+            LL_PROFILE_GPU_ZONE("vbo arena alloc");
+            Block block;
+            block.mSize = mBlockSize;
+            block.mGLName = gen_buffer();
+            glBindBuffer(mType, block.mGLName);
+            glBufferData(mType, block.mSize, nullptr, GL_DYNAMIC_DRAW);
+            if (mType == GL_ELEMENT_ARRAY_BUFFER)
+            {
+                LLVertexBuffer::sGLRenderIndices = block.mGLName;
+            }
+            else
+            {
+                LLVertexBuffer::sGLRenderBuffer = block.mGLName;
+            }
+            block.mFree[0] = block.mSize;
+            mBlocks.push_back(block);
+        }
+
+        Block& block = mBlocks.back();
+        if (allocateFrom(block, size, offset))
+        {
+            name = block.mGLName;
+            return true;
+        }
+
+        return false;
+    }
+
+    void free(GLuint name, U32 offset, U32 size)
+    {
+        LL_PROFILE_ZONE_SCOPED_CATEGORY_VERTEX;
+        size = alignSize(size);
+
+        for (auto iter = mBlocks.begin(); iter != mBlocks.end(); ++iter)
+        {
+            Block& block = *iter;
+            if (block.mGLName != name)
+            {
+                continue;
+            }
+
+            llassert(block.mInUse >= size);
+            block.mInUse -= size;
+
+            auto next = block.mFree.lower_bound(offset);
+            llassert(next == block.mFree.end() || next->first >= offset + size);
+
+            // merge with the following free range
+            if (next != block.mFree.end() && next->first == offset + size)
+            {
+                size += next->second;
+                next = block.mFree.erase(next);
+            }
+
+            // merge with the preceding free range
+            if (next != block.mFree.begin())
+            {
+                auto prev = std::prev(next);
+                if (prev->first + prev->second == offset)
+                {
+                    prev->second += size;
+                    size = 0;
+                }
+            }
+
+            if (size)
+            {
+                block.mFree[offset] = size;
+            }
+
+            if (block.mInUse == 0 && mBlocks.size() > 1)
+            { // keep one empty block around, release the rest
+                glDeleteBuffers(1, &block.mGLName);
+                mBlocks.erase(iter);
+            }
+            return;
+        }
+
+        llassert(false); // freed a range of a block we don't own
+    }
+
+    void getStats(LLVertexBuffer::ArenaStats& stats) const
+    {
+        stats = LLVertexBuffer::ArenaStats();
+        for (const Block& block : mBlocks)
+        {
+            stats.mBlocks++;
+            stats.mBytesReserved += block.mSize;
+            stats.mBytesInUse += block.mInUse;
+            for (auto& range : block.mFree)
+            {
+                stats.mFreeRanges++;
+                stats.mLargestFree = llmax(stats.mLargestFree, (U64)range.second);
+            }
+        }
+    }
+
+    U64 getBytesReserved() const
+    {
+        return (U64)mBlocks.size() * mBlockSize;
+    }
+
+    void clear()
+    {
+        for (Block& block : mBlocks)
+        {
+            glDeleteBuffers(1, &block.mGLName);
+        }
+        mBlocks.clear();
+    }
+
+private:
+    // first fit
+    bool allocateFrom(Block& block, U32 size, U32& offset)
+    {
+        for (auto iter = block.mFree.begin(); iter != block.mFree.end(); ++iter)
+        {
+            if (iter->second >= size)
+            {
+                offset = iter->first;
+                U32 remaining = iter->second - size;
+                block.mFree.erase(iter);
+                if (remaining)
+                {
+                    block.mFree[offset + size] = remaining;
+                }
+                block.mInUse += size;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    GLenum mType;
+    U32 mBlockSize;
+    std::vector<Block> mBlocks;
+};
+
+static LLVBOArena* sVBOArena = nullptr;
+static LLVBOArena* sIBOArena = nullptr;
 #endif
 
 static LLVBOPool* sVBOPool = nullptr;
@@ -574,7 +768,35 @@ static LLVBOPool* sVBOPool = nullptr;
 //static
 U64 LLVertexBuffer::getBytesAllocated()
 {
-    return sVBOPool ? sVBOPool->getVramBytesUsed() : 0;
+    U64 bytes = sVBOPool ? sVBOPool->getVramBytesUsed() : 0;
+#if !LL_DARWIN
+    bytes += sVBOArena ? sVBOArena->getBytesReserved() : 0;
+    bytes += sIBOArena ? sIBOArena->getBytesReserved() : 0;
+#endif
+    return bytes;
+}
+
+F32 LLVertexBuffer::ArenaStats::getFragmentation() const
+{
+    U64 free_bytes = mBytesReserved - mBytesInUse;
+    return free_bytes ? 1.f - (F32)mLargestFree / (F32)free_bytes : 0.f;
+}
+
+//static
+void LLVertexBuffer::getArenaStats(ArenaStats& vertex_stats, ArenaStats& index_stats)
+{
+    vertex_stats = ArenaStats();
+    index_stats = ArenaStats();
+#if !LL_DARWIN
+    if (sVBOArena)
+    {
+        sVBOArena->getStats(vertex_stats);
+    }
+    if (sIBOArena)
+    {
+        sIBOArena->getStats(index_stats);
+    }
+#endif
 }
 
 //============================================================================
@@ -582,8 +804,16 @@ U64 LLVertexBuffer::getBytesAllocated()
 //static
 U32 LLVertexBuffer::sGLRenderBuffer = 0;
 U32 LLVertexBuffer::sGLRenderIndices = 0;
+U32 LLVertexBuffer::sGLIndirectBuffer = 0;
+U32 LLVertexBuffer::sGLRenderBufferOffset = 0;
+bool LLVertexBuffer::sUseArena = false;
+U32 LLVertexBuffer::sArenaBlockSize = 32 * 1024 * 1024;
+bool LLVertexBuffer::sPackAttributes = false;
 U32 LLVertexBuffer::sLastMask = 0;
 U32 LLVertexBuffer::sVertexCount = 0;
+bool LLVertexBuffer::sUseSkinCache = false;
+U32 LLVertexBuffer::sSkinCacheStamp = 0;
+U32 LLVertexBuffer::sGLSkinnedBuffer = 0;
 
 
 //NOTE: each component must be AT LEAST 4 bytes in size to avoid a performance penalty on AMD hardware
@@ -831,16 +1061,114 @@ void LLVertexBuffer::drawRange(U32 mode, U32 start, U32 end, U32 count, U32 indi
     gGL.syncMatrices();
     STOP_GLERROR;
     glDrawRangeElements(sGLMode[mode], start, end, count, mIndicesType,
-        (GLvoid*) (indices_offset * (size_t) mIndicesStride));
+        (GLvoid*) (mGLIndicesOffset + indices_offset * (size_t) mIndicesStride));
     STOP_GLERROR;
 }
 
 void LLVertexBuffer::drawRangeFast(U32 mode, U32 start, U32 end, U32 count, U32 indices_offset) const
 {
     glDrawRangeElements(sGLMode[mode], start, end, count, mIndicesType,
-        (GLvoid*)(indices_offset * (size_t)mIndicesStride));
+        (GLvoid*)(mGLIndicesOffset + indices_offset * (size_t)mIndicesStride));
 }
 
+void LLVertexBuffer::drawInstanced(U32 mode, U32 count, U32 indices_offset, U32 instances) const
+{
+    llassert(mGLBuffer == sGLRenderBuffer);
+    llassert(mGLIndices == sGLRenderIndices);
+    llassert(indices_offset + count <= mNumIndices);
+    gGL.syncMatrices();
+    STOP_GLERROR;
+    glDrawElementsInstanced(sGLMode[mode], count, mIndicesType,
+        (GLvoid*)(mGLIndicesOffset + indices_offset * (size_t)mIndicesStride), instances);
+    STOP_GLERROR;
+}
+
+// size of the streamed indirect command buffer, orphaned whenever it fills up
+constexpr U32 INDIRECT_BUFFER_SIZE = 256 * 1024;
+static U32 sIndirectBufferOffset = INDIRECT_BUFFER_SIZE;
+
+//static
+bool LLVertexBuffer::hasMultiDrawIndirect()
+{
+#if LL_DARWIN
+    return false;
+#else
+    return gGLManager.mGLVersion >= 4.29f;
+#endif
+}
+
+void LLVertexBuffer::drawMulti(U32 mode, const std::vector<IndirectDraw>& draws) const
+{
+    llassert(mGLBuffer == sGLRenderBuffer);
+    llassert(mGLIndices == sGLRenderIndices);
+
+    if (draws.empty())
+    {
+        return;
+    }
+
+    gGL.syncMatrices();
+    STOP_GLERROR;
+
+    U32 size = (U32)(draws.size() * sizeof(IndirectDraw));
+
+#if !LL_DARWIN
+    if (hasMultiDrawIndirect() && size <= INDIRECT_BUFFER_SIZE)
+    {
+        LL_PROFILE_ZONE_NAMED_CATEGORY_VERTEX("vb draw multi indirect");
+        if (!sGLIndirectBuffer)
+        {
+            glGenBuffers(1, &sGLIndirectBuffer);
+        }
+
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, sGLIndirectBuffer);
+
+        if (sIndirectBufferOffset + size > INDIRECT_BUFFER_SIZE)
+        { // orphan the buffer instead of waiting on draws still reading from it
+            glBufferData(GL_DRAW_INDIRECT_BUFFER, INDIRECT_BUFFER_SIZE, nullptr, GL_STREAM_DRAW);
+            sIndirectBufferOffset = 0;
+        }
+
+        if (mGLIndicesOffset)
+        { // arena buffer, rebase first index onto this buffer's range
+            thread_local static std::vector<IndirectDraw> rebased;
+            rebased = draws;
+            for (IndirectDraw& draw : rebased)
+            {
+                draw.mFirstIndex += mGLIndicesOffset / mIndicesStride;
+            }
+            glBufferSubData(GL_DRAW_INDIRECT_BUFFER, sIndirectBufferOffset, size, rebased.data());
+        }
+        else
+        {
+            glBufferSubData(GL_DRAW_INDIRECT_BUFFER, sIndirectBufferOffset, size, draws.data());
+        }
+        glMultiDrawElementsIndirect(sGLMode[mode], mIndicesType, (GLvoid*)(size_t)sIndirectBufferOffset, (GLsizei)draws.size(), 0);
+        sIndirectBufferOffset += size;
+
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        STOP_GLERROR;
+        return;
+    }
+#endif
+
+    LL_PROFILE_ZONE_NAMED_CATEGORY_VERTEX("vb draw multi");
+    thread_local static std::vector<GLsizei> counts;
+    thread_local static std::vector<const GLvoid*> offsets;
+
+    counts.resize(draws.size());
+    offsets.resize(draws.size());
+
+    for (size_t i = 0; i < draws.size(); ++i)
+    {
+        llassert(draws[i].mFirstIndex + draws[i].mCount <= mNumIndices);
+        counts[i] = draws[i].mCount;
+        offsets[i] = (GLvoid*)(mGLIndicesOffset + draws[i].mFirstIndex * (size_t)mIndicesStride);
+    }
+
+    glMultiDrawElements(sGLMode[mode], counts.data(), mIndicesType, offsets.data(), (GLsizei)draws.size());
+    STOP_GLERROR;
+}
 
 void LLVertexBuffer::draw(U32 mode, U32 count, U32 indices_offset) const
 {
@@ -866,6 +1194,14 @@ void LLVertexBuffer::initClass(LLWindow* window)
     llassert(sVBOPool == nullptr);
     sVBOPool = new LLVBOPool();
 
+#if !LL_DARWIN
+    if (sUseArena)
+    {
+        sVBOArena = new LLVBOArena(GL_ARRAY_BUFFER, sArenaBlockSize);
+        sIBOArena = new LLVBOArena(GL_ELEMENT_ARRAY_BUFFER, sArenaBlockSize / 4);
+    }
+#endif
+
 #if ENABLE_GL_WORK_QUEUE
     sQueue = new GLWorkQueue();
 
@@ -896,6 +1232,29 @@ void LLVertexBuffer::cleanupClass()
     delete sVBOPool;
     sVBOPool = nullptr;
 
+#if !LL_DARWIN
+    if (sVBOArena)
+    {
+        ArenaStats vertex_stats, index_stats;
+        getArenaStats(vertex_stats, index_stats);
+        LL_INFOS("VertexBuffer") << "VBO arena: " << vertex_stats.mBytesInUse / 1024 << "/" << vertex_stats.mBytesReserved / 1024
+            << " KB in use, fragmentation " << vertex_stats.getFragmentation()
+            << ". IBO arena: " << index_stats.mBytesInUse / 1024 << "/" << index_stats.mBytesReserved / 1024
+            << " KB in use, fragmentation " << index_stats.getFragmentation() << LL_ENDL;
+    }
+    delete sVBOArena;
+    sVBOArena = nullptr;
+    delete sIBOArena;
+    sIBOArena = nullptr;
+#endif
+
+    if (sGLIndirectBuffer)
+    {
+        glDeleteBuffers(1, &sGLIndirectBuffer);
+        sGLIndirectBuffer = 0;
+        sIndirectBufferOffset = INDIRECT_BUFFER_SIZE;
+    }
+
 #if ENABLE_GL_WORK_QUEUE
     sQueue->close();
     for (int i = 0; i < THREAD_COUNT; ++i)
@@ -920,6 +1279,7 @@ LLVertexBuffer::LLVertexBuffer(U32 typemask)
     for (U32 i = 0; i < TYPE_MAX; i++)
     {
         mOffsets[i] = 0;
+        mGLOffsets[i] = 0;
     }
 }
 
@@ -946,6 +1306,44 @@ U32 LLVertexBuffer::calcOffsets(const U32& typemask, U32* offsets, U32 num_verti
     return offset;
 }
 
+//static
+bool LLVertexBuffer::isPackable(U32 typemask)
+{
+    // GPU skinning reads positions, normals and tangents of weighted buffers straight from mGLBuffer as floats
+    constexpr U32 skinned_mask = MAP_WEIGHT | MAP_WEIGHT4 | MAP_CLOTHWEIGHT;
+    return sPackAttributes && !(typemask & skinned_mask) && (typemask & (MAP_NORMAL | MAP_TANGENT));
+}
+
+// size of the given attribute in the packed GL layout
+static U32 packed_type_size(U32 type)
+{
+    if (type == LLVertexBuffer::TYPE_NORMAL || type == LLVertexBuffer::TYPE_TANGENT)
+    {
+        return sizeof(U32);
+    }
+    return LLVertexBuffer::sTypeSize[type];
+}
+
+//static
+U32 LLVertexBuffer::calcPackedOffsets(const U32& typemask, U32* offsets, U32 num_vertices)
+{
+    U32 offset = 0;
+    for (U32 i = 0; i < TYPE_TEXTURE_INDEX; i++)
+    {
+        U32 mask = 1 << i;
+        if ((typemask & mask) && LLVertexBuffer::sTypeSize[i])
+        {
+            offsets[i] = offset;
+            offset += packed_type_size(i) * num_vertices;
+            offset = (offset + 0xF) & ~0xF;
+        }
+    }
+
+    offsets[TYPE_TEXTURE_INDEX] = offsets[TYPE_VERTEX] + 12;
+
+    return offset;
+}
+
 //static
 U32 LLVertexBuffer::calcVertexSize(const U32& typemask)
 {
@@ -993,6 +1391,29 @@ void LLVertexBuffer::genBuffer(U32 size)
         llassert(mMappedData == nullptr);
 
         mSize = size;
+#if !LL_DARWIN
+        if (mPacked)
+        { // the GL side holds the packed layout, mMappedData keeps the float layout for striders
+            if (sVBOArena && sVBOArena->accepts(mGLSize) && sVBOArena->allocate(mGLSize, mGLBuffer, mGLBufferOffset))
+            {
+                mArenaBuffer = true;
+                mPackedData = (U8*)ll_aligned_malloc_16(mGLSize);
+            }
+            else
+            {
+                sVBOPool->allocate(GL_ARRAY_BUFFER, mGLSize, mGLBuffer, mPackedData);
+            }
+            mMappedData = (U8*)ll_aligned_malloc_16(mSize);
+            return;
+        }
+
+        if (sVBOArena && sVBOArena->accepts(mSize) && sVBOArena->allocate(mSize, mGLBuffer, mGLBufferOffset))
+        {
+            mArenaBuffer = true;
+            mMappedData = (U8*)ll_aligned_malloc_16(mSize);
+            return;
+        }
+#endif
         sVBOPool->allocate(GL_ARRAY_BUFFER, mSize, mGLBuffer, mMappedData);
     }
 }
@@ -1008,6 +1429,14 @@ void LLVertexBuffer::genIndices(U32 size)
         llassert(mGLIndices == 0);
         llassert(mMappedIndexData == nullptr);
         mIndicesSize = size;
+#if !LL_DARWIN
+        if (sIBOArena && sIBOArena->accepts(mIndicesSize) && sIBOArena->allocate(mIndicesSize, mGLIndices, mGLIndicesOffset))
+        {
+            mArenaIndices = true;
+            mMappedIndexData = (U8*)ll_aligned_malloc_16(mIndicesSize);
+            return;
+        }
+#endif
         sVBOPool->allocate(GL_ELEMENT_ARRAY_BUFFER, mIndicesSize, mGLIndices, mMappedIndexData);
     }
 }
@@ -1064,13 +1493,43 @@ void LLVertexBuffer::destroyGLBuffer()
     {
         LL_PROFILE_ZONE_SCOPED_CATEGORY_VERTEX;
         //llassert(sVBOPool);
+#if !LL_DARWIN
+        if (mPackedData)
+        {
+            if (mArenaBuffer)
+            {
+                if (sVBOArena)
+                {
+                    sVBOArena->free(mGLBuffer, mGLBufferOffset, mGLSize);
+                }
+                ll_aligned_free_16(mPackedData);
+            }
+            else if (sVBOPool)
+            {
+                sVBOPool->free(GL_ARRAY_BUFFER, mGLSize, mGLBuffer, mPackedData);
+            }
+            ll_aligned_free_16(mMappedData);
+        }
+        else if (mArenaBuffer)
+        {
+            if (sVBOArena)
+            {
+                sVBOArena->free(mGLBuffer, mGLBufferOffset, mSize);
+            }
+            ll_aligned_free_16(mMappedData);
+        }
+        else
+#endif
         if (sVBOPool)
         {
             sVBOPool->free(GL_ARRAY_BUFFER, mSize, mGLBuffer, mMappedData);
         }
 
         mSize = 0;
+        mPackedData = nullptr;
         mGLBuffer = 0;
+        mGLBufferOffset = 0;
+        mArenaBuffer = false;
         mMappedData = nullptr;
     }
 }
@@ -1081,6 +1540,17 @@ void LLVertexBuffer::destroyGLIndices()
     {
         LL_PROFILE_ZONE_SCOPED_CATEGORY_VERTEX;
         //llassert(sVBOPool);
+#if !LL_DARWIN
+        if (mArenaIndices)
+        {
+            if (sIBOArena)
+            {
+                sIBOArena->free(mGLIndices, mGLIndicesOffset, mIndicesSize);
+            }
+            ll_aligned_free_16(mMappedIndexData);
+        }
+        else
+#endif
         if (sVBOPool)
         {
             sVBOPool->free(GL_ELEMENT_ARRAY_BUFFER, mIndicesSize, mGLIndices, mMappedIndexData);
@@ -1088,6 +1558,8 @@ void LLVertexBuffer::destroyGLIndices()
 
         mIndicesSize = 0;
         mGLIndices = 0;
+        mGLIndicesOffset = 0;
+        mArenaIndices = false;
         mMappedIndexData = nullptr;
     }
 }
@@ -1100,8 +1572,26 @@ bool LLVertexBuffer::updateNumVerts(U32 nverts)
 
     U32 needed_size = calcOffsets(mTypeMask, mOffsets, nverts);
 
-    if (needed_size != mSize)
+    bool packed = false;
+    U32 gl_size = needed_size;
+#if !LL_DARWIN
+    packed = isPackable(mTypeMask);
+#endif
+    if (packed)
+    {
+        gl_size = calcPackedOffsets(mTypeMask, mGLOffsets, nverts);
+    }
+    else
+    {
+        memcpy(mGLOffsets, mOffsets, sizeof(mOffsets));
+    }
+
+    if (needed_size != mSize || gl_size != mGLSize || packed != mPacked)
     {
+        // genBuffer allocates by mPacked/mGLSize, so release the old storage first
+        destroyGLBuffer();
+        mPacked = packed;
+        mGLSize = gl_size;
         success &= createGLBuffer(needed_size);
     }
 
@@ -1240,6 +1730,21 @@ U8* LLVertexBuffer::mapIndexBuffer(U32 index, S32 count)
 //  end -- last byte to copy (NOT last byte + 1)
 //  data -- data to be flushed
 //  dst -- mMappedData or mMappedIndexData
+#if !LL_DARWIN
+// glBufferSubData in blocks of at most 8KB
+static void buffer_sub_data(GLenum target, U32 offset, U32 size, const U8* data)
+{
+    constexpr U32 block_size = 8192;
+
+    for (U32 i = 0; i < size; i += block_size)
+    {
+        LL_PROFILE_ZONE_NAMED_CATEGORY_VERTEX("glBufferSubData block");
+        //LL_PROFILE_GPU_ZONE("glBufferSubData");
+        glBufferSubData(target, offset + i, llmin(block_size, size - i), data + i);
+    }
+}
+#endif
+
 void LLVertexBuffer::flush_vbo(GLenum target, U32 start, U32 end, void* data, U8* dst)
 {
 #if LL_DARWIN
@@ -1250,6 +1755,12 @@ void LLVertexBuffer::flush_vbo(GLenum target, U32 start, U32 end, void* data, U8
 #else
     llassert(target == GL_ARRAY_BUFFER ? sGLRenderBuffer == mGLBuffer : sGLRenderIndices == mGLIndices);
 
+    if (mPacked && target == GL_ARRAY_BUFFER)
+    {
+        flushPacked(start, end, (const U8*) data);
+        return;
+    }
+
     // skip mapped data and stream to GPU via glBufferSubData
     if (end != 0)
     {
@@ -1258,23 +1769,83 @@ void LLVertexBuffer::flush_vbo(GLenum target, U32 start, U32 end, void* data, U8
         LL_PROFILE_ZONE_NUM(end);
         LL_PROFILE_ZONE_NUM(end-start);
 
-        constexpr U32 block_size = 8192;
+        U32 base = target == GL_ARRAY_BUFFER ? mGLBufferOffset : mGLIndicesOffset;
+        buffer_sub_data(target, base + start, end - start + 1, (const U8*) data);
+    }
+#endif
+}
+
+#if !LL_DARWIN
+// 4 floats in [-1, 1] to GL_INT_2_10_10_10_REV, normalized.  w only keeps its sign (tangent handedness)
+static U32 pack_snorm_1010102(const F32* v)
+{
+    S32 x = ll_round(llclamp(v[0], -1.f, 1.f) * 511.f);
+    S32 y = ll_round(llclamp(v[1], -1.f, 1.f) * 511.f);
+    S32 z = ll_round(llclamp(v[2], -1.f, 1.f) * 511.f);
+    S32 w = v[3] < 0.f ? -1 : (v[3] > 0.f ? 1 : 0);
+    return (U32)(x & 0x3FF) | ((U32)(y & 0x3FF) << 10) | ((U32)(z & 0x3FF) << 20) | ((U32)(w & 0x3) << 30);
+}
+
+void LLVertexBuffer::flushPacked(U32 start, U32 end, const U8* data)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_VERTEX;
+    llassert(mPackedData);
+
+    if (end == 0)
+    {
+        return;
+    }
+
+    // the range is in the float layout and may span several attributes, each of which is
+    // uploaded separately to its place in the packed layout
+    for (U32 i = 0; i < TYPE_TEXTURE_INDEX; ++i)
+    {
+        if (!(mTypeMask & (1 << i)) || !sTypeSize[i])
+        {
+            continue;
+        }
+
+        U32 src_size = sTypeSize[i];
+        U32 first = llmax(start, mOffsets[i]);
+        U32 last = llmin(end + 1, mOffsets[i] + src_size * mNumVerts);
+        if (first >= last)
+        {
+            continue;
+        }
+
+        const U8* src = data + (first - start);
+        U32 dst_size = packed_type_size(i);
+        if (dst_size == src_size)
+        { // same layout, copy as is
+            buffer_sub_data(GL_ARRAY_BUFFER, mGLBufferOffset + mGLOffsets[i] + (first - mOffsets[i]), last - first, src);
+            continue;
+        }
+
+        U32 index = (first - mOffsets[i]) / src_size;
+        U32 count = (last - mOffsets[i] + src_size - 1) / src_size - index;
+        if ((first - mOffsets[i]) % src_size != 0 || (last - mOffsets[i]) % src_size != 0)
+        { // partial vertices (e.g. a TYPE_TEXTURE_INDEX region running into the next attribute), convert
+          // the whole vertices from the mapped copy
+            src = mMappedData + mOffsets[i] + index * src_size;
+        }
 
-        for (U32 i = start; i <= end; i += block_size)
+        U32 dst_offset = mGLOffsets[i] + index * dst_size;
+        U32* dst = (U32*)(mPackedData + dst_offset);
+        for (U32 j = 0; j < count; ++j)
         {
-            LL_PROFILE_ZONE_NAMED_CATEGORY_VERTEX("glBufferSubData block");
-            //LL_PROFILE_GPU_ZONE("glBufferSubData");
-            U32 tend = llmin(i + block_size, end);
-            U32 size = tend - i + 1;
-            glBufferSubData(target, i, size, (U8*) data + (i-start));
+            dst[j] = pack_snorm_1010102((const F32*)(src + j * src_size));
         }
+        buffer_sub_data(GL_ARRAY_BUFFER, mGLBufferOffset + dst_offset, count * dst_size, (const U8*) dst);
     }
-#endif
 }
+#endif
 
 void LLVertexBuffer::unmapBuffer()
 {
     STOP_GLERROR;
+    // new vertex data invalidates anything skinned from the old data
+    mSkinnedStamp = 0;
+
     struct SortMappedRegion
     {
         bool operator()(const MappedRegion& lhs, const MappedRegion& rhs)
@@ -1536,6 +2107,12 @@ void LLVertexBuffer::setBuffer()
     // a shader must be bound
     llassert(LLGLSLShader::sCurBoundShaderPtr);
 
+    // UI triangles set aside for batching were recorded before whatever this buffer draws
+    if (gGL.hasUIBatch())
+    {
+        gGL.flush();
+    }
+
     U32 data_mask = LLGLSLShader::sCurBoundShaderPtr->mAttributeMask;
 
     // this Vertex Buffer must provide all necessary attributes for currently bound shader
@@ -1543,6 +2120,8 @@ void LLVertexBuffer::setBuffer()
         "Attribute mask mismatch! mTypeMask should be a superset of data_mask.  data_mask: 0x"
                 << std::hex << data_mask << " mTypeMask: 0x" << mTypeMask << " Missing: 0x" << (data_mask & ~mTypeMask) <<  std::dec);
 
+    U32 skinned = sUseSkinCache && sSkinCacheStamp != 0 && mSkinnedStamp == sSkinCacheStamp ? mSkinnedGLBuffer : 0;
+
     if (sGLRenderBuffer != mGLBuffer)
     {
         glBindBuffer(GL_ARRAY_BUFFER, mGLBuffer);
@@ -1550,7 +2129,7 @@ void LLVertexBuffer::setBuffer()
 
         setupVertexBuffer();
     }
-    else if (sLastMask != data_mask)
+    else if (sLastMask != data_mask || sGLRenderBufferOffset != mGLBufferOffset || sGLSkinnedBuffer != skinned)
     {
         setupVertexBuffer();
         sLastMask = data_mask;
@@ -1571,56 +2150,72 @@ void LLVertexBuffer::setupVertexBuffer()
 {
     STOP_GLERROR;
     U8* base = nullptr;
+    base += mGLBufferOffset;
+    sGLRenderBufferOffset = mGLBufferOffset;
 
     U32 data_mask = LLGLSLShader::sCurBoundShaderPtr->mAttributeMask;
 
     if (data_mask & MAP_NORMAL)
     {
         AttributeType loc = TYPE_NORMAL;
-        void* ptr = (void*)(base + mOffsets[TYPE_NORMAL]);
-        glVertexAttribPointer(loc, 3, GL_FLOAT, GL_FALSE, LLVertexBuffer::sTypeSize[TYPE_NORMAL], ptr);
+        void* ptr = (void*)(base + mGLOffsets[TYPE_NORMAL]);
+        if (mPacked)
+        {
+            glVertexAttribPointer(loc, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(U32), ptr);
+        }
+        else
+        {
+            glVertexAttribPointer(loc, 3, GL_FLOAT, GL_FALSE, LLVertexBuffer::sTypeSize[TYPE_NORMAL], ptr);
+        }
     }
     if (data_mask & MAP_TEXCOORD3)
     {
         AttributeType loc = TYPE_TEXCOORD3;
-        void* ptr = (void*)(base + mOffsets[TYPE_TEXCOORD3]);
+        void* ptr = (void*)(base + mGLOffsets[TYPE_TEXCOORD3]);
         glVertexAttribPointer(loc, 2, GL_FLOAT, GL_FALSE, LLVertexBuffer::sTypeSize[TYPE_TEXCOORD3], ptr);
     }
     if (data_mask & MAP_TEXCOORD2)
     {
         AttributeType loc = TYPE_TEXCOORD2;
-        void* ptr = (void*)(base + mOffsets[TYPE_TEXCOORD2]);
+        void* ptr = (void*)(base + mGLOffsets[TYPE_TEXCOORD2]);
         glVertexAttribPointer(loc, 2, GL_FLOAT, GL_FALSE, LLVertexBuffer::sTypeSize[TYPE_TEXCOORD2], ptr);
     }
     if (data_mask & MAP_TEXCOORD1)
     {
         AttributeType loc = TYPE_TEXCOORD1;
-        void* ptr = (void*)(base + mOffsets[TYPE_TEXCOORD1]);
+        void* ptr = (void*)(base + mGLOffsets[TYPE_TEXCOORD1]);
         glVertexAttribPointer(loc, 2, GL_FLOAT, GL_FALSE, LLVertexBuffer::sTypeSize[TYPE_TEXCOORD1], ptr);
     }
     if (data_mask & MAP_TANGENT)
     {
         AttributeType loc = TYPE_TANGENT;
-        void* ptr = (void*)(base + mOffsets[TYPE_TANGENT]);
-        glVertexAttribPointer(loc, 4, GL_FLOAT, GL_FALSE, LLVertexBuffer::sTypeSize[TYPE_TANGENT], ptr);
+        void* ptr = (void*)(base + mGLOffsets[TYPE_TANGENT]);
+        if (mPacked)
+        {
+            glVertexAttribPointer(loc, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(U32), ptr);
+        }
+        else
+        {
+            glVertexAttribPointer(loc, 4, GL_FLOAT, GL_FALSE, LLVertexBuffer::sTypeSize[TYPE_TANGENT], ptr);
+        }
     }
     if (data_mask & MAP_TEXCOORD0)
     {
         AttributeType loc = TYPE_TEXCOORD0;
-        void* ptr = (void*)(base + mOffsets[TYPE_TEXCOORD0]);
+        void* ptr = (void*)(base + mGLOffsets[TYPE_TEXCOORD0]);
         glVertexAttribPointer(loc, 2, GL_FLOAT, GL_FALSE, LLVertexBuffer::sTypeSize[TYPE_TEXCOORD0], ptr);
     }
     if (data_mask & MAP_COLOR)
     {
         AttributeType loc = TYPE_COLOR;
         //bind emissive instead of color pointer if emissive is present
-        void* ptr = (data_mask & MAP_EMISSIVE) ? (void*)(base + mOffsets[TYPE_EMISSIVE]) : (void*)(base + mOffsets[TYPE_COLOR]);
+        void* ptr = (data_mask & MAP_EMISSIVE) ? (void*)(base + mGLOffsets[TYPE_EMISSIVE]) : (void*)(base + mGLOffsets[TYPE_COLOR]);
         glVertexAttribPointer(loc, 4, GL_UNSIGNED_BYTE, GL_TRUE, LLVertexBuffer::sTypeSize[TYPE_COLOR], ptr);
     }
     if (data_mask & MAP_EMISSIVE)
     {
         AttributeType loc = TYPE_EMISSIVE;
-        void* ptr = (void*)(base + mOffsets[TYPE_EMISSIVE]);
+        void* ptr = (void*)(base + mGLOffsets[TYPE_EMISSIVE]);
         glVertexAttribPointer(loc, 4, GL_UNSIGNED_BYTE, GL_TRUE, LLVertexBuffer::sTypeSize[TYPE_EMISSIVE], ptr);
 
         if (!(data_mask & MAP_COLOR))
@@ -1632,39 +2227,62 @@ void LLVertexBuffer::setupVertexBuffer()
     if (data_mask & MAP_WEIGHT)
     {
         AttributeType loc = TYPE_WEIGHT;
-        void* ptr = (void*)(base + mOffsets[TYPE_WEIGHT]);
+        void* ptr = (void*)(base + mGLOffsets[TYPE_WEIGHT]);
         glVertexAttribPointer(loc, 1, GL_FLOAT, GL_FALSE, LLVertexBuffer::sTypeSize[TYPE_WEIGHT], ptr);
     }
     if (data_mask & MAP_WEIGHT4)
     {
         AttributeType loc = TYPE_WEIGHT4;
-        void* ptr = (void*)(base + mOffsets[TYPE_WEIGHT4]);
+        void* ptr = (void*)(base + mGLOffsets[TYPE_WEIGHT4]);
         glVertexAttribPointer(loc, 4, GL_FLOAT, GL_FALSE, LLVertexBuffer::sTypeSize[TYPE_WEIGHT4], ptr);
     }
     if (data_mask & MAP_JOINT)
     {
         AttributeType loc = TYPE_JOINT;
-        void* ptr = (void*)(base + mOffsets[TYPE_JOINT]);
+        void* ptr = (void*)(base + mGLOffsets[TYPE_JOINT]);
         glVertexAttribIPointer(loc, 4, GL_UNSIGNED_SHORT, LLVertexBuffer::sTypeSize[TYPE_JOINT], ptr);
     }
     if (data_mask & MAP_CLOTHWEIGHT)
     {
         AttributeType loc = TYPE_CLOTHWEIGHT;
-        void* ptr = (void*)(base + mOffsets[TYPE_CLOTHWEIGHT]);
+        void* ptr = (void*)(base + mGLOffsets[TYPE_CLOTHWEIGHT]);
         glVertexAttribPointer(loc, 4, GL_FLOAT, GL_TRUE, LLVertexBuffer::sTypeSize[TYPE_CLOTHWEIGHT], ptr);
     }
     if (data_mask & MAP_TEXTURE_INDEX)
     {
         AttributeType loc = TYPE_TEXTURE_INDEX;
-        void* ptr = (void*)(base + mOffsets[TYPE_VERTEX] + 12);
+        void* ptr = (void*)(base + mGLOffsets[TYPE_VERTEX] + 12);
         glVertexAttribIPointer(loc, 1, GL_UNSIGNED_INT, LLVertexBuffer::sTypeSize[TYPE_VERTEX], ptr);
     }
     if (data_mask & MAP_VERTEX)
     {
         AttributeType loc = TYPE_VERTEX;
-        void* ptr = (void*)(base + mOffsets[TYPE_VERTEX]);
+        void* ptr = (void*)(base + mGLOffsets[TYPE_VERTEX]);
         glVertexAttribPointer(loc, 3, GL_FLOAT, GL_FALSE, LLVertexBuffer::sTypeSize[TYPE_VERTEX], ptr);
     }
+
+    sGLSkinnedBuffer = sUseSkinCache && sSkinCacheStamp != 0 && mSkinnedStamp == sSkinCacheStamp ? mSkinnedGLBuffer : 0;
+    if (sGLSkinnedBuffer)
+    { // replace skinned attributes with the pre-skinned copies, everything else still comes from mGLBuffer
+        glBindBuffer(GL_ARRAY_BUFFER, sGLSkinnedBuffer);
+
+        U8* skinned = nullptr;
+        U32 stride = sizeof(LLVector4a);
+        if (data_mask & MAP_VERTEX)
+        {
+            glVertexAttribPointer(TYPE_VERTEX, 3, GL_FLOAT, GL_FALSE, stride, skinned);
+        }
+        if (data_mask & MAP_NORMAL)
+        {
+            glVertexAttribPointer(TYPE_NORMAL, 3, GL_FLOAT, GL_FALSE, stride, skinned + stride * mNumVerts);
+        }
+        if (data_mask & MAP_TANGENT)
+        {
+            glVertexAttribPointer(TYPE_TANGENT, 4, GL_FLOAT, GL_FALSE, stride, skinned + stride * mNumVerts * 2);
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, mGLBuffer);
+    }
     STOP_GLERROR;
 }
 
@@ -89,6 +89,12 @@ public:
     // indexed by the following enum
     static U32 calcOffsets(const U32& typemask, U32* offsets, U32 num_vertices);
 
+    // true if buffers with the given typemask store normals and tangents packed on the GPU (see sPackAttributes)
+    static bool isPackable(U32 typemask);
+
+    //like calcOffsets, but for the packed GL layout, where normals and tangents take 4 bytes each
+    static U32 calcPackedOffsets(const U32& typemask, U32* offsets, U32 num_vertices);
+
     //WARNING -- when updating these enums you MUST
     // 1 - update LLVertexBuffer::sTypeSize
     // 2 - update LLVertexBuffer::vb_type_name
@@ -228,6 +234,14 @@ public:
     U8* getMappedData() const               { return mMappedData; }
     U8* getMappedIndices() const            { return mMappedIndexData; }
     U32 getOffset(AttributeType type) const { return mOffsets[type]; }
+    U32 getGLBuffer() const                 { return mGLBuffer; }
+    U32 getGLBufferOffset() const           { return mGLBufferOffset; }
+
+    // source positions, normals and tangents from skinned instead of this buffer while sUseSkinCache is set
+    // and stamp matches sSkinCacheStamp
+    // skinned holds three arrays of getNumVerts() vec4s: positions, normals, tangents
+    void setSkinnedBuffer(U32 skinned, U32 stamp) { mSkinnedGLBuffer = skinned; mSkinnedStamp = stamp; }
+    U32 getSkinnedStamp() const             { return mSkinnedStamp; }
 
     // these functions assume (and assert on) the current VBO being bound
     // Detailed error checking can be enabled by setting gDebugGL to true
@@ -239,6 +253,44 @@ public:
     // since the last call to syncMatrices, this is much faster than drawRange
     void drawRangeFast(U32 mode, U32 start, U32 end, U32 count, U32 indices_offset) const;
 
+    // draw count indices starting at indices_offset instances times, the shader tells
+    // the instances apart by gl_InstanceID
+    void drawInstanced(U32 mode, U32 count, U32 indices_offset, U32 instances) const;
+
+    // one index range of a multi-draw, laid out as a DrawElementsIndirectCommand
+    struct IndirectDraw
+    {
+        U32 mCount;
+        U32 mInstanceCount;
+        U32 mFirstIndex;
+        S32 mBaseVertex;
+        U32 mBaseInstance;
+    };
+
+    // draw several index ranges of this buffer in a single call
+    // all ranges must share the same GL state (shader, textures, matrices)
+    // uses glMultiDrawElementsIndirect sourced from a streamed indirect command buffer
+    // when available, glMultiDrawElements otherwise
+    void drawMulti(U32 mode, const std::vector<IndirectDraw>& draws) const;
+
+    // true if drawMulti will source its commands from an indirect buffer
+    static bool hasMultiDrawIndirect();
+
+    // usage statistics for the sub-allocated buffer arena (see sUseArena)
+    struct ArenaStats
+    {
+        U64 mBytesReserved = 0; // total size of all arena GL buffers
+        U64 mBytesInUse = 0;    // bytes handed out to vertex buffers
+        U64 mLargestFree = 0;   // largest contiguous free range
+        U32 mFreeRanges = 0;    // number of distinct free ranges
+        U32 mBlocks = 0;        // number of arena GL buffers
+
+        // 0 when all free space is contiguous, approaching 1 as it splinters
+        F32 getFragmentation() const;
+    };
+
+    static void getArenaStats(ArenaStats& vertex_stats, ArenaStats& index_stats);
+
     //for debugging, validate data in given range is valid
     bool validateRange(U32 start, U32 end, U32 count, U32 offset) const;
 
@@ -253,9 +305,18 @@ protected:
     U32     mGLIndices = 0;     // GL IBO handle
     U32     mNumVerts = 0;      // Number of vertices allocated
     U32     mNumIndices = 0;    // Number of indices allocated
+    U32     mGLBufferOffset = 0;    // byte offset of this buffer's vertices within mGLBuffer (non-zero only for arena buffers)
+    U32     mGLIndicesOffset = 0;   // byte offset of this buffer's indices within mGLIndices (non-zero only for arena buffers)
+    bool    mArenaBuffer = false;   // mGLBuffer is a range of an arena buffer
+    bool    mArenaIndices = false;  // mGLIndices is a range of an arena buffer
     U32     mIndicesType = GL_UNSIGNED_SHORT; // type of indices in index buffer
     U32     mIndicesStride = 2;     // size of each index in bytes
     U32     mOffsets[TYPE_MAX]; // byte offsets into mMappedData of each attribute
+    U32     mGLOffsets[TYPE_MAX];   // byte offsets into mGLBuffer of each attribute (same as mOffsets unless mPacked)
+    bool    mPacked = false;        // normals and tangents are stored as 10:10:10:2 in mGLBuffer, see sPackAttributes
+
+    U32     mSkinnedGLBuffer = 0;   // pre-skinned positions, normals and tangents (see setSkinnedBuffer)
+    U32     mSkinnedStamp = 0;
 
     U8* mMappedData = nullptr;  // pointer to currently mapped data (NULL if unmapped)
     U8* mMappedIndexData = nullptr; // pointer to currently mapped indices (NULL if unmapped)
@@ -263,6 +324,8 @@ protected:
     U32     mTypeMask = 0;      // bitmask of present vertex attributes
 
     U32     mSize = 0;          // size in bytes of mMappedData
+    U32     mGLSize = 0;        // size in bytes of this buffer's vertices in mGLBuffer
+    U8*     mPackedData = nullptr;  // staging copy of the packed GL layout (nullptr unless mPacked)
     U32     mIndicesSize = 0;   // size in bytes of mMappedIndexData
 
     std::vector<MappedRegion> mMappedVertexRegions;  // list of mMappedData byte ranges that must be sent to GL
@@ -279,6 +342,9 @@ private:
 
     void flush_vbo(GLenum target, U32 start, U32 end, void* data, U8* dst);
 
+    // flush_vbo for packed buffers: converts the given range of the float layout and uploads it
+    void flushPacked(U32 start, U32 end, const U8* data);
+
     LLVertexBuffer(U32 typemask, U32 usage)
         : LLVertexBuffer(typemask)
     {}
@@ -292,8 +358,26 @@ public:
     static const U32 sGLMode[LLRender::NUM_MODES];
     static U32 sGLRenderBuffer;
     static U32 sGLRenderIndices;
+    static U32 sGLIndirectBuffer;
+    static U32 sGLRenderBufferOffset;
+
+    // sub-allocate buffers from a few large GL buffers instead of creating a GL buffer per LLVertexBuffer
+    // must be set before initClass
+    static bool sUseArena;
+    static U32 sArenaBlockSize;
+
+    // store normals and tangents of unskinned buffers as GL_INT_2_10_10_10_REV on the GPU
+    // instead of 4 floats each; the CPU side copy stays float.  must be set before initClass
+    static bool sPackAttributes;
     static U32 sLastMask;
     static U32 sVertexCount;
+
+    // set while the bound skinned shader expects pre-skinned vertices, reset on shader bind
+    static bool sUseSkinCache;
+    // stamp of skinned buffers that are valid right now, 0 for none
+    static U32 sSkinCacheStamp;
+    // skinned buffer the current attribute pointers were set up from, 0 for none
+    static U32 sGLSkinnedBuffer;
 };
 
 #ifdef LL_PROFILER_ENABLE_RENDER_DOC
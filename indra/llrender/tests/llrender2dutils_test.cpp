@@ -0,0 +1,82 @@
+/**
+ * @file llrender2dutils_test.cpp
+ * @brief Tests for the layout of images drawn with a scale border
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+// Class to test
+#include "../llrender2dutils.h"
+// Tut header
+#include "../test/lltut.h"
+
+namespace tut
+{
+    struct render2dutils_test
+    {
+        // A 64x64 image with a 16 pixel border, whole in its own texture
+        // and at (256, 512) in a 1024x1024 atlas page
+        const LLRectf mCenterRect = LLRectf(0.25f, 0.75f, 0.75f, 0.25f);
+        const LLRectf mWholeRect = LLRectf(0.f, 1.f, 1.f, 0.f);
+        const LLRectf mAtlasRect = LLRectf(256.f / 1024.f, 576.f / 1024.f, 320.f / 1024.f, 512.f / 1024.f);
+
+        void ensureRect(const std::string& msg, const LLRectf& actual, const LLRectf& expected)
+        {
+            ensure_approximately_equals((msg + " left").c_str(), actual.mLeft, expected.mLeft, 8);
+            ensure_approximately_equals((msg + " top").c_str(), actual.mTop, expected.mTop, 8);
+            ensure_approximately_equals((msg + " right").c_str(), actual.mRight, expected.mRight, 8);
+            ensure_approximately_equals((msg + " bottom").c_str(), actual.mBottom, expected.mBottom, 8);
+        }
+    };
+
+    typedef test_group<render2dutils_test> render2dutils_t;
+    typedef render2dutils_t::object render2dutils_object_t;
+    tut::render2dutils_t tut_render2dutils("LLRender2DUtils");
+
+    // Scaled center: the border keeps its size, the center takes the rest
+    template<> template<>
+    void render2dutils_object_t::test<1>()
+    {
+        const LLRectf expected(16.f, 112.f, 112.f, 16.f);
+        ensureRect("whole", gl_scaled_image_center_rect(128, 128, 64, 64, mWholeRect, mCenterRect, true), expected);
+        ensureRect("atlased", gl_scaled_image_center_rect(128, 128, 1024, 1024, mAtlasRect, mCenterRect, true), expected);
+    }
+
+    // Fixed center: the center keeps its size, in the same relative position
+    template<> template<>
+    void render2dutils_object_t::test<2>()
+    {
+        const LLRectf expected(48.f, 80.f, 80.f, 48.f);
+        ensureRect("whole", gl_scaled_image_center_rect(128, 128, 64, 64, mWholeRect, mCenterRect, false), expected);
+        ensureRect("atlased", gl_scaled_image_center_rect(128, 128, 1024, 1024, mAtlasRect, mCenterRect, false), expected);
+    }
+
+    // Fixed center, drawn smaller than the center: it shrinks to fit
+    template<> template<>
+    void render2dutils_object_t::test<3>()
+    {
+        const LLRectf expected(0.f, 24.f, 24.f, 0.f);
+        ensureRect("whole", gl_scaled_image_center_rect(24, 24, 64, 64, mWholeRect, mCenterRect, false), expected);
+        ensureRect("atlased", gl_scaled_image_center_rect(24, 24, 1024, 1024, mAtlasRect, mCenterRect, false), expected);
+    }
+}
@@ -498,8 +498,35 @@ public:
     void addFolder( LLFolderViewFolder* folder);
 
     //WARNING: do not call directly...use the appropriate LLFolderViewModel-derived class instead
-    template<typename SORT_FUNC> void sortFolders(const SORT_FUNC& func) { mFolders.sort(func); }
-    template<typename SORT_FUNC> void sortItems(const SORT_FUNC& func) { mItems.sort(func); }
+    template<typename SORT_FUNC> void sortFolders(const SORT_FUNC& func) { sortChildren(mFolders, func); }
+    template<typename SORT_FUNC> void sortItems(const SORT_FUNC& func) { sortChildren(mItems, func); }
+
+private:
+    // Children are appended by addItem()/addFolder() and most resorts follow
+    // nothing but appends, so only sort what follows the leading run that is
+    // already in order and merge it back.  Both steps are stable, the result
+    // is the same as sorting the whole list.
+    template<typename LIST, typename SORT_FUNC>
+    static void sortChildren(LIST& children, const SORT_FUNC& func)
+    {
+        typename LIST::iterator prev = children.begin();
+        if (prev == children.end())
+        {
+            return;
+        }
+        typename LIST::iterator it = std::next(prev);
+        while (it != children.end() && !func(*it, *prev))
+        {
+            prev = it++;
+        }
+        if (it != children.end())
+        {
+            LIST tail;
+            tail.splice(tail.end(), children, it, children.end());
+            tail.sort(func);
+            children.merge(tail, func);
+        }
+    }
 };
 
 typedef std::deque<LLFolderViewItem*> folder_view_item_deque;
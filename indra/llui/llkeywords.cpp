@@ -503,32 +503,48 @@ LLTrace::BlockTimerStatHandle FTM_SYNTAX_COLORING("Syntax Coloring");
 // Walk through a string, applying the rules specified by the keyword token list and
 // create a list of color segments.
 void LLKeywords::findSegments(std::vector<LLTextSegmentPtr>* seg_list, const LLWString& wtext, LLTextEditor& editor, LLStyleConstSP style)
+{
+    findSegments(seg_list, wtext, editor, style, 0, S32_MAX, nullptr);
+}
+
+S32 LLKeywords::findSegments(std::vector<LLTextSegmentPtr>* seg_list, const LLWString& wtext, LLTextEditor& editor, LLStyleConstSP style,
+                             S32 start, S32 min_end, const std::function<bool(S32)>& can_stop)
 {
     LL_RECORD_BLOCK_TIME(FTM_SYNTAX_COLORING);
     seg_list->clear();
 
-    if( wtext.empty() )
+    S32 text_len = static_cast<S32>(wtext.size()) + 1;
+    if( start >= text_len - 1 )
     {
-        return;
+        return text_len;
     }
 
-    S32 text_len = static_cast<S32>(wtext.size()) + 1;
-
     // <FS:Ansariel> Script editor ignoring font selection
     //seg_list->push_back( new LLNormalTextSegment( style, 0, text_len, editor ) );
     LLStyleSP actual_style = getDefaultStyle(editor);
     actual_style->setColor(style->getColor());
-    seg_list->push_back( new LLNormalTextSegment( actual_style, 0, text_len, editor ) );
+    seg_list->push_back( new LLNormalTextSegment( actual_style, start, text_len, editor ) );
     // </FS:Ansariel>
 
     const llwchar* base = wtext.c_str();
-    const llwchar* cur = base;
+    const llwchar* begin = base + start;
+    const llwchar* cur = begin;
+    S32 end = text_len;
     while( *cur )
     {
-        if( *cur == '\n' || cur == base )
+        if( *cur == '\n' || cur == begin )
         {
             if( *cur == '\n' )
             {
+                // no token is open at a line break, so once the old segments after
+                // it are known to be right there is nothing left to do
+                S32 pos = (S32)(cur - base);
+                if( can_stop && pos >= min_end && can_stop(pos) )
+                {
+                    end = pos;
+                    break;
+                }
+
                 // <FS:Ansariel> Script editor ignoring font selection
                 //LLTextSegmentPtr text_segment = new LLLineBreakTextSegment(style, (S32)(cur - base));
                 LLTextSegmentPtr text_segment = new LLLineBreakTextSegment(getDefaultStyle(editor), (S32)(cur - base));
@@ -736,6 +752,20 @@ void LLKeywords::findSegments(std::vector<LLTextSegmentPtr>* seg_list, const LLW
             }
         }
     }
+
+    if( end < text_len )
+    {
+        // the old segments take over from the line break on
+        if( seg_list->back()->getStart() >= end )
+        {
+            seg_list->pop_back();
+        }
+        else
+        {
+            seg_list->back()->setEnd( end );
+        }
+    }
+    return end;
 }
 
 void LLKeywords::insertSegments(const LLWString& wtext, std::vector<LLTextSegmentPtr>& seg_list, LLKeywordToken* cur_token, S32 text_len, S32 seg_start, S32 seg_end, LLStyleConstSP style, LLTextEditor& editor )
@@ -36,6 +36,7 @@
 #include <map>
 #include <list>
 #include <deque>
+#include <functional>
 #include "llpointer.h"
 
 // <FS:Ansariel> Script editor ignoring font selection
@@ -124,6 +125,16 @@ public:
                              const LLWString& text,
                              class LLTextEditor& editor,
                              LLStyleConstSP style);
+    // Re-color only part of the text, from the line start 'start' on.  Stops at the first
+    // line break at or after min_end for which can_stop(pos) is true, i.e. where the old
+    // segments had no token carry over into the next line, and returns its position.
+    S32         findSegments(std::vector<LLTextSegmentPtr> *seg_list,
+                             const LLWString& text,
+                             class LLTextEditor& editor,
+                             LLStyleConstSP style,
+                             S32 start,
+                             S32 min_end,
+                             const std::function<bool(S32)>& can_stop);
     void        initialize(LLSD SyntaxXML);
     void        processTokens();
 
@@ -82,9 +82,6 @@ void LLScreenClipRect::updateScissorRegion()
 {
     if (sClipRectStack.empty()) return;
 
-    // finish any deferred calls in the old clipping region
-    gGL.flush();
-
     LLRect rect = sClipRectStack.top();
     stop_glerror();
     S32 x,y,w,h;
@@ -92,7 +89,8 @@ void LLScreenClipRect::updateScissorRegion()
     y = llfloor(rect.mBottom * LLUI::getScaleFactor().mV[VY]);
     w = llmax(0, llceil(rect.getWidth() * LLUI::getScaleFactor().mV[VX])) + 1;
     h = llmax(0, llceil(rect.getHeight() * LLUI::getScaleFactor().mV[VY])) + 1;
-    glScissor( x,y,w,h );
+    // finishes any deferred calls in the old clipping region
+    gGL.setScissor( x,y,w,h );
     stop_glerror();
 }
 
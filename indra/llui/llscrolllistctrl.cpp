@@ -122,6 +122,85 @@ struct SortScrollListItem
     const bool mAltSort;
 };
 
+// SortScrollListItem converts both cells to strings on every comparison, which dominates
+// sorting long lists (area search, group members).  Without a sort callback the result
+// only depends on the cell values, so fetch each item's keys once and sort those instead.
+struct KeyedScrollListItem
+{
+    struct Key
+    {
+        std::string mValue;
+        std::string mAltValue;
+        bool mValid;
+    };
+
+    LLScrollListItem* mItem;
+    std::vector<Key> mKeys;     // one per sort order, in the same order
+};
+
+static void sort_items_by_keys(std::deque<LLScrollListItem*>& items, const std::vector<std::pair<S32, bool> >& sort_orders,
+                               bool alternate_sort)
+{
+    std::vector<KeyedScrollListItem> keyed(items.size());
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        keyed[i].mItem = items[i];
+        keyed[i].mKeys.resize(sort_orders.size());
+        for (size_t j = 0; j < sort_orders.size(); ++j)
+        {
+            KeyedScrollListItem::Key& key = keyed[i].mKeys[j];
+            const LLScrollListCell* cell = items[i]->getColumn(sort_orders[j].first);
+            key.mValid = cell != NULL;
+            if (cell)
+            {
+                key.mValue = cell->getValue().asString();
+                if (alternate_sort)
+                {
+                    key.mAltValue = cell->getAltValue().asString();
+                }
+            }
+        }
+    }
+
+    // same rules as SortScrollListItem: the last sort order is the primary one
+    std::stable_sort(keyed.begin(), keyed.end(),
+        [&sort_orders, alternate_sort](const KeyedScrollListItem& i1, const KeyedScrollListItem& i2)
+        {
+            S32 sort_result = 0;
+            for (size_t j = sort_orders.size(); j-- > 0; )
+            {
+                const KeyedScrollListItem::Key& key1 = i1.mKeys[j];
+                const KeyedScrollListItem::Key& key2 = i2.mKeys[j];
+                if (key1.mValid && key2.mValid)
+                {
+                    S32 order = sort_orders[j].second ? 1 : -1;
+                    if (alternate_sort && !key1.mAltValue.empty() && !key2.mAltValue.empty())
+                    {
+                        sort_result = order * LLStringUtil::compareDict(key1.mAltValue, key2.mAltValue);
+                    }
+                    else
+                    {
+                        sort_result = order * LLStringUtil::compareDict(key1.mValue, key2.mValue);
+                    }
+                    if (sort_result != 0)
+                    {
+                        break;
+                    }
+                }
+            }
+            return sort_result < 0;
+        });
+
+    for (size_t i = 0; i < keyed.size(); ++i)
+    {
+        items[i] = keyed[i].mItem;
+    }
+}
+
+// A single row added to a sorted list is put in place rather than sorting the whole list
+// again, up to this many per frame; beyond that one sort is cheaper than many inserts.
+static const U32 MAX_SORTED_INSERTS_PER_FRAME = 32;
+
 //---------------------------------------------------------------------------
 // LLScrollListCtrl
 //---------------------------------------------------------------------------
@@ -206,6 +285,7 @@ LLScrollListCtrl::LLScrollListCtrl(const LLScrollListCtrl::Params& p)
     mTotalColumnPadding(0),
     mSorted(false),
     mSortLazily(p.sort_lazily),     // <FS:Beq> FIRE-30732 deferred sort configurability
+    mSortedInserts(0),
     mDirty(false),
     mOriginalSelection(-1),
     mLastSelected(NULL),
@@ -692,8 +772,19 @@ bool LLScrollListCtrl::addItem( LLScrollListItem* item, EAddPosition pos, bool r
 
         case ADD_DEFAULT:
         case ADD_BOTTOM:
-            mItemList.push_back(item);
-            setNeedsSort();
+            if (hasSortOrder() && isSorted() && mSortedInserts < MAX_SORTED_INSERTS_PER_FRAME)
+            {
+                // after any equal items, as a stable sort would have put it
+                mItemList.insert(std::upper_bound(mItemList.begin(), mItemList.end(), item,
+                                                  SortScrollListItem(mSortColumns, mSortCallback, mAlternateSort)),
+                                 item);
+                ++mSortedInserts;
+            }
+            else
+            {
+                mItemList.push_back(item);
+                setNeedsSort();
+            }
             break;
 
         default:
@@ -1901,6 +1992,7 @@ void LLScrollListCtrl::draw()
 
     // if user specifies sort, make sure it is maintained
     updateSort();
+    mSortedInserts = 0;
 
     if (mNeedsScroll)
     {
@@ -3196,10 +3288,17 @@ void LLScrollListCtrl::updateSort() const
         mLastUpdateFrame=0;
     // </FS:Beq>
         // do stable sort to preserve any previous sorts
-        std::stable_sort(
-            mItemList.begin(),
-            mItemList.end(),
-            SortScrollListItem(mSortColumns,mSortCallback, mAlternateSort));
+        if (mSortCallback)
+        {
+            std::stable_sort(
+                mItemList.begin(),
+                mItemList.end(),
+                SortScrollListItem(mSortColumns,mSortCallback, mAlternateSort));
+        }
+        else
+        {
+            sort_items_by_keys(mItemList, mSortColumns, mAlternateSort);
+        }
 
         mSorted = true;
     }
@@ -3212,10 +3311,17 @@ void LLScrollListCtrl::sortOnce(S32 column, bool ascending)
     sort_column.push_back(std::make_pair(column, ascending));
 
     // do stable sort to preserve any previous sorts
-    std::stable_sort(
-        mItemList.begin(),
-        mItemList.end(),
-        SortScrollListItem(sort_column,mSortCallback,mAlternateSort));
+    if (mSortCallback)
+    {
+        std::stable_sort(
+            mItemList.begin(),
+            mItemList.end(),
+            SortScrollListItem(sort_column,mSortCallback,mAlternateSort));
+    }
+    else
+    {
+        sort_items_by_keys(mItemList, sort_column, mAlternateSort);
+    }
 }
 
 void LLScrollListCtrl::dirtyColumns()
@@ -597,6 +597,7 @@ private:
     bool            mSortLazily;
 
     mutable bool    mSorted;
+    U32             mSortedInserts;     // rows put in place since the last draw
 
     typedef std::map<std::string, LLScrollListColumn*> column_map_t;
     column_map_t mColumns;
@@ -231,6 +231,7 @@ LLTextBase::LLTextBase(const LLTextBase::Params &p)
     mTextSelectedColor(p.text_selected_color),
     mSelectedBGColor(p.bg_selected_color),
     mReflowIndex(S32_MAX),
+    mTextGeneration(0),
     mCursorPos( 0 ),
     mScrollNeeded(false),
     mDesiredXPixel(-1),
@@ -1080,6 +1081,7 @@ S32 LLTextBase::insertStringNoUndo(S32 pos, const LLWString &wstr, LLTextBase::s
     }
 
     getViewModel()->getEditableDisplay().insert(pos, wstr);
+    ++mTextGeneration;
 
     if ( truncate() )
     {
@@ -1142,6 +1144,7 @@ S32 LLTextBase::removeStringNoUndo(S32 pos, S32 length)
     }
 
     getViewModel()->getEditableDisplay().erase(pos, length);
+    ++mTextGeneration;
 
     // recreate default segment in case we erased everything
     createDefaultSegment();
@@ -1161,6 +1164,7 @@ S32 LLTextBase::overwriteCharNoUndo(S32 pos, llwchar wc)
         return 0;
     }
     getViewModel()->getEditableDisplay()[pos] = wc;
+    ++mTextGeneration;
 
     onValueChange(pos, pos + 1);
     needsReflow(pos);
@@ -2586,12 +2590,14 @@ void LLTextBase::appendText(const std::string &new_text, bool prepend_newline, c
 void LLTextBase::setLabel(const LLStringExplicit& label)
 {
     mLabel = label;
+    ++mTextGeneration;
     resetLabel();
 }
 
 bool LLTextBase::setLabelArg(const std::string& key, const LLStringExplicit& text )
 {
     mLabel.setArg(key, text);
+    ++mTextGeneration;
     return true;
 }
 
@@ -2865,6 +2871,7 @@ void LLTextBase::replaceUrl(const std::string &url,
     if (modified)
     {
         getViewModel()->setDisplay(text);
+        ++mTextGeneration;
         // <FS:Ansariel> FIRE-20214: Text gets deselected upon avatar/group name received callback
         //deselect();
         // Make sure we're still within limits
@@ -3848,13 +3855,35 @@ bool LLNormalTextSegment::getDimensionsF32(S32 first_char, S32 num_chars, F32& w
     if (num_chars > 0)
     {
         height = mFontHeight;
+        validateRunCache();
+        if (mRunCache.mWidthStart == mStart + first_char && mRunCache.mWidthChars == num_chars)
+        {
+            width = mRunCache.mWidth;
+            return false;
+        }
         const LLWString &text = getWText();
         // if last character is a newline, then return true, forcing line break
         width = mStyle->getFont()->getWidthF32(text.c_str(), mStart + first_char, num_chars, true);
+        mRunCache.mWidthStart = mStart + first_char;
+        mRunCache.mWidthChars = num_chars;
+        mRunCache.mWidth = width;
     }
     return false;
 }
 
+void LLNormalTextSegment::validateRunCache() const
+{
+    const LLFontGL* font = mStyle->getFont();
+    if (mRunCache.mGeneration != mEditor.getTextGeneration() || mRunCache.mFont != font ||
+        mRunCache.mScaleX != LLFontGL::sScaleX)
+    {
+        mRunCache = RunCache();
+        mRunCache.mGeneration = mEditor.getTextGeneration();
+        mRunCache.mFont = font;
+        mRunCache.mScaleX = LLFontGL::sScaleX;
+    }
+}
+
 S32 LLNormalTextSegment::getOffset(S32 segment_local_x_coord, S32 start_offset, S32 num_chars, bool round) const
 {
     const LLWString &text = getWText();
@@ -3910,12 +3939,35 @@ S32 LLNormalTextSegment::getNumChars(S32 num_pixels, S32 segment_offset, S32 lin
             << getLength() << "\tsegment_offset:\t" << segment_offset << "\tmStart:\t" << mStart << "\tsegments\t" << mEditor.mSegments.size() << LL_ENDL;
     }
 
-    // <FS:Ansariel> Prevent unnecessary calculations
-    //S32 num_chars = mStyle->getFont()->maxDrawableChars( text.c_str() + (segment_offset + mStart),
-    S32 num_chars = mStyle->getFont()->maxDrawableChars(text.c_str() + start_offset,
-                                                (F32)num_pixels,
-                                                max_chars,
-                                                word_wrap_style);
+    // a run that fit before fits in any wider space, which covers most runs when a
+    // window is resized or the layout is redone from an earlier line
+    validateRunCache();
+    if (mRunCache.mFitStart != start_offset || mRunCache.mFitChars != max_chars)
+    {
+        mRunCache.mFitStart = start_offset;
+        mRunCache.mFitChars = max_chars;
+        mRunCache.mFitPixels = S32_MAX;
+    }
+
+    S32 num_chars = 0;
+    if (max_chars > 0 && num_pixels >= mRunCache.mFitPixels)
+    {
+        num_chars = max_chars;
+    }
+    else
+    {
+        // <FS:Ansariel> Prevent unnecessary calculations
+        //S32 num_chars = mStyle->getFont()->maxDrawableChars( text.c_str() + (segment_offset + mStart),
+        num_chars = mStyle->getFont()->maxDrawableChars(text.c_str() + start_offset,
+                                                        (F32)num_pixels,
+                                                        max_chars,
+                                                        word_wrap_style);
+        if (max_chars > 0 && num_chars == max_chars)
+        {
+            // nothing was clipped
+            mRunCache.mFitPixels = llmin(mRunCache.mFitPixels, num_pixels);
+        }
+    }
 
     if (num_chars == 0
         && line_offset == 0
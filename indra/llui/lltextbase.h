@@ -154,6 +154,23 @@ protected:
     virtual     const LLWString&    getWText()  const;
     virtual     const S32           getLength() const;
 
+    // Measurements of the last runs laid out and drawn.  Reflowing after a resize asks
+    // for the same runs again, so they stay valid until the text, the font or the UI
+    // scale change.
+    struct RunCache
+    {
+        U32             mGeneration = 0;
+        const LLFontGL* mFont = NULL;
+        F32             mScaleX = 0.f;
+        S32             mFitStart = -1;
+        S32             mFitChars = 0;
+        S32             mFitPixels = S32_MAX;   // narrowest width known to hold the whole run
+        S32             mWidthStart = -1;
+        S32             mWidthChars = 0;
+        F32             mWidth = 0.f;
+    };
+    void                validateRunCache() const;
+
 protected:
     class LLTextBase&   mEditor;
     LLStyleConstSP      mStyle;
@@ -161,6 +178,7 @@ protected:
     LLKeywordToken*     mToken;
     std::string         mTooltip;
     boost::signals2::connection mImageLoadedConnection;
+    mutable RunCache    mRunCache;
 };
 
 // This text segment is the same as LLNormalTextSegment, the only difference
@@ -480,6 +498,8 @@ public:
 
     // force reflow of text
     void                    needsReflow(S32 index = 0);
+    // Changes whenever the text of the document or its label is modified in place
+    U32                     getTextGeneration() const { return mTextGeneration; }
 
     S32                     getLength() const { return static_cast<S32>(getWText().length()); }
     S32                     getLineCount() const { return static_cast<S32>(mLineInfoList.size()); }
@@ -800,6 +820,7 @@ protected:
 
     // transient state
     S32                         mReflowIndex;       // index at which to start reflow.  S32_MAX indicates no reflow needed.
+    U32                         mTextGeneration;    // see getTextGeneration()
     bool                        mScrollNeeded;      // need to change scroll region because of change to cursor position
     S32                         mScrollIndex;       // index of first character to keep visible in scroll region
 
@@ -29,6 +29,9 @@
 #include <queue>
 
 #include "lldir.h"
+#include "llfile.h"
+#include "llparsedfilecache.h"
+#include "llsdutil.h"
 #include "llui.h"
 #include "lluicolortable.h"
 #include "lluictrlfactory.h"
@@ -377,9 +380,33 @@ void LLUIColorTable::setColor(std::string_view name, const LLColor4& color, stri
 
 bool LLUIColorTable::loadFromFilename(const std::string& filename, string_color_map_t& table)
 {
+    // colors.xml only changes with the skin, reuse what we parsed last time
+    std::string contents = LLFile::getContents(filename);
+    LLSD cached;
+    if (LLParsedFileCache::load(filename, contents, cached))
+    {
+        Params params;
+        for (const LLSD& entry : llsd::inArray(cached))
+        {
+            ColorEntryParams color_entry;
+            color_entry.name = entry["name"].asString();
+            if (entry.has("reference"))
+            {
+                color_entry.color.reference = entry["reference"].asString();
+            }
+            else
+            {
+                color_entry.color.value = LLColor4(entry["value"]);
+            }
+            params.color_entries.add(color_entry);
+        }
+        insertFromParams(params, table);
+        return true;
+    }
+
     LLXMLNodePtr root;
 
-    if(!LLXMLNode::parseFile(filename, root, NULL))
+    if(contents.empty() || !LLXMLNode::parseBuffer(contents.data(), contents.size(), root, NULL))
     {
         LL_WARNS() << "Unable to parse color file " << filename << LL_ENDL;
         return false;
@@ -405,6 +432,25 @@ bool LLUIColorTable::loadFromFilename(const std::string& filename, string_color_
         return false;
     }
 
+    cached = LLSD::emptyArray();
+    for (LLInitParam::ParamIterator<ColorEntryParams>::const_iterator it = params.color_entries.begin();
+         it != params.color_entries.end();
+         ++it)
+    {
+        LLSD entry;
+        entry["name"] = it->name();
+        if (it->color.value.isChosen())
+        {
+            entry["value"] = it->color.value().getValue();
+        }
+        else
+        {
+            entry["reference"] = it->color.reference();
+        }
+        cached.append(entry);
+    }
+    LLParsedFileCache::store(filename, contents, cached);
+
     return true;
 }
 
@@ -31,12 +31,17 @@
 
 #include "llxmlnode.h"
 
+#include <deque>
 #include <fstream>
+#include <set>
+#include <boost/algorithm/string/join.hpp>
 #include <boost/tokenizer.hpp>
 
 // other library includes
+#include "llcallbacklist.h"
 #include "llcontrol.h"
 #include "lldir.h"
+#include "llfile.h"
 #include "v4color.h"
 #include "v3dmath.h"
 #include "llquaternion.h"
@@ -170,6 +175,47 @@ void LLUICtrlFactory::createChildren(LLView* viewp, LLXMLNodePtr node, const wid
 //-----------------------------------------------------------------------------
 // getLayeredXMLNode()
 //-----------------------------------------------------------------------------
+namespace
+{
+    struct CachedXML
+    {
+        LLXMLNodePtr mRoot;
+        std::vector<time_t> mModified;  // of each layer, when parsed
+    };
+
+    // keyed by the layered paths, which name the skin and language
+    std::map<std::string, CachedXML> sXMLCache;
+    std::deque<std::string> sPreloadQueue;
+    std::set<std::string> sPreloaded;
+
+    std::vector<time_t> get_modified_times(const std::vector<std::string>& paths)
+    {
+        std::vector<time_t> modified;
+        for (const std::string& path : paths)
+        {
+            llstat stat_data;
+            modified.push_back(LLFile::stat(path, &stat_data) == 0 ? stat_data.st_mtime : 0);
+        }
+        return modified;
+    }
+
+    // Panels and floaters name the files of their sub-panels in filename attributes
+    void queue_referenced_files(LLXMLNodePtr node)
+    {
+        std::string filename;
+        if (node->getAttributeString("filename", filename) &&
+            LLStringUtil::endsWith(filename, ".xml") &&
+            sPreloaded.insert(filename).second)
+        {
+            sPreloadQueue.push_back(filename);
+        }
+        for (LLXMLNodePtr child = node->getFirstChild(); child.notNull(); child = child->getNextSibling())
+        {
+            queue_referenced_files(child);
+        }
+    }
+}
+
 bool LLUICtrlFactory::getLayeredXMLNode(const std::string &xui_filename, LLXMLNodePtr& root,
                                         LLDir::ESkinConstraint constraint)
 {
@@ -183,7 +229,67 @@ bool LLUICtrlFactory::getLayeredXMLNode(const std::string &xui_filename, LLXMLNo
         paths.push_back(xui_filename);
     }
 
-    return LLXMLNode::getLayeredXMLNode(root, paths);
+    std::string key = boost::algorithm::join(paths, "|");
+    std::vector<time_t> modified = get_modified_times(paths);
+    auto found = sXMLCache.find(key);
+    if (found != sXMLCache.end() && found->second.mModified == modified)
+    {
+        // callers may change the tree they get
+        root = found->second.mRoot->deepCopy();
+        return true;
+    }
+
+    LLXMLNodePtr parsed;
+    if (!LLXMLNode::getLayeredXMLNode(parsed, paths))
+    {
+        root = parsed;
+        return false;
+    }
+    sXMLCache[key] = { parsed, modified };
+    root = parsed->deepCopy();
+    return true;
+}
+
+// static
+void LLUICtrlFactory::preloadXML(const std::vector<std::string>& filenames)
+{
+    bool running = !sPreloadQueue.empty();
+    for (const std::string& filename : filenames)
+    {
+        if (sPreloaded.insert(filename).second)
+        {
+            sPreloadQueue.push_back(filename);
+        }
+    }
+    if (running || sPreloadQueue.empty())
+    {
+        return;
+    }
+
+    doOnIdleRepeating([]()
+    {
+        if (sPreloadQueue.empty())
+        {
+            return true;
+        }
+        std::string filename = sPreloadQueue.front();
+        sPreloadQueue.pop_front();
+
+        LLXMLNodePtr root;
+        if (getLayeredXMLNode(filename, root))
+        {
+            queue_referenced_files(root);
+        }
+        return sPreloadQueue.empty();
+    });
+}
+
+// static
+void LLUICtrlFactory::clearXMLCache()
+{
+    sXMLCache.clear();
+    sPreloadQueue.clear();
+    sPreloaded.clear();
 }
 
 
@@ -191,9 +191,16 @@ fail:
 
     static void createChildren(LLView* viewp, LLXMLNodePtr node, const widget_registry_t&, LLXMLNodePtr output_node = NULL);
 
+    // Parsed files are kept, so the next call for the same file, skin and language only
+    // copies the tree, unless one of the files changed since
     static bool getLayeredXMLNode(const std::string &filename, LLXMLNodePtr& root,
                                   LLDir::ESkinConstraint constraint=LLDir::CURRENT_SKIN);
 
+    // Parse these files, and the files their nodes name, ahead of their first use, one
+    // file per idle frame
+    static void preloadXML(const std::vector<std::string>& filenames);
+    static void clearXMLCache();
+
 private:
     //NOTE: both friend declarations are necessary to keep both gcc and msvc happy
     template <typename T> friend class LLChildRegistry;
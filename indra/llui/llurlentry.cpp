@@ -301,6 +301,7 @@ LLUrlEntryHTTP::LLUrlEntryHTTP()
     // </FS:ND>
     // </FS:Ansariel>
                             boost::regex::perl|boost::regex::icase);
+    mAnchors = { "://" };
     mMenuName = "menu_url_http.xml";
     mTooltip = LLTrans::getString("TooltipHttpUrl");
 }
@@ -343,6 +344,7 @@ LLUrlEntryHTTPLabel::LLUrlEntryHTTPLabel()
     mPattern = boost::regex("\\[(https?|ftp)://\\S+[ \t]+[^\\]]+\\]",
     // </FS:Ansariel>
                             boost::regex::perl|boost::regex::icase);
+    mAnchors = { "://" };
     mMenuName = "menu_url_http.xml";
     mTooltip = LLTrans::getString("TooltipHttpUrl");
 }
@@ -372,6 +374,7 @@ LLUrlEntryHTTPNoProtocol::LLUrlEntryHTTPNoProtocol()
 {
     mPattern = boost::regex("\\b(www|ftp)\\.\\S+\\.([^\\s<]*)?\\b", // i.e. www.FOO.BAR
                 boost::regex::perl|boost::regex::icase);
+    mAnchors = { "www.", "ftp." };
     mMenuName = "menu_url_http.xml";
     mTooltip = LLTrans::getString("TooltipHttpUrl");
 }
@@ -407,6 +410,7 @@ LLUrlEntryInvalidSLURL::LLUrlEntryInvalidSLURL()
     // <FS:Beq> remove legacy Inworldz URI support. restore previous with addition of https
     mPattern = boost::regex("(https?://(maps.secondlife.com|slurl.com)/secondlife/|secondlife://(/app/(worldmap|teleport)/)?)[^ /]+(/-?[0-9]+){1,3}(/?(\\?title|\\?img|\\?msg)=\\S*)?/?",
                                     boost::regex::perl|boost::regex::icase);
+    mAnchors = { "/secondlife/", "secondlife://" };
     mMenuName = "menu_url_http.xml";
     mTooltip = LLTrans::getString("TooltipHttpUrl");
 }
@@ -494,6 +498,7 @@ LLUrlEntrySLURL::LLUrlEntrySLURL()
     // see http://slurl.com/about.php for details on the SLURL format
     mPattern = boost::regex("https?://(maps.secondlife.com|slurl.com)/secondlife/[^ /]+(/\\d+){0,3}(/?(\\?title|\\?img|\\?msg)=\\S*)?/?",
                             boost::regex::perl|boost::regex::icase);
+    mAnchors = { "/secondlife/" };
     mIcon = "Hand";
     mMenuName = "menu_url_slurl.xml";
     mTooltip = LLTrans::getString("TooltipSLURL");
@@ -584,6 +589,7 @@ LLUrlEntrySecondlifeURL::LLUrlEntrySecondlifeURL()
                             "(https?://([-\\w\\.]*\\.)?secondlife\\.io(:\\d{1,5})?))"
                             "\\/\\S*",
         boost::regex::perl|boost::regex::icase);
+    mAnchors = { "secondlife", "lindenlab", "tilia-inc" };
 
     mIcon = "Hand";
     mMenuName = "menu_url_http.xml";
@@ -627,6 +633,7 @@ LLUrlEntrySimpleSecondlifeURL::LLUrlEntrySimpleSecondlifeURL()
                             "|"
                             "https?://([-\\w\\.]*\\.)?secondlifegrid\\.net(?!\\S)",
                             boost::regex::perl|boost::regex::icase);
+    mAnchors = { "secondlife", "lindenlab", "tilia-inc" };
 
     mIcon = "Hand";
     mMenuName = "menu_url_http.xml";
@@ -641,6 +648,7 @@ LLUrlEntryAgent::LLUrlEntryAgent()
 {
     mPattern = boost::regex(APP_HEADER_REGEX "/agent/[\\da-f-]+/\\w+",
                             boost::regex::perl|boost::regex::icase);
+    mAnchors = { "/agent/" };
     mMenuName = "menu_url_agent.xml";
     mIcon = "Generic_Person";
 }
@@ -944,6 +952,7 @@ LLUrlEntryAgentCompleteName::LLUrlEntryAgentCompleteName()
 {
     mPattern = boost::regex(APP_HEADER_REGEX "/agent/[\\da-f-]+/completename",
                             boost::regex::perl|boost::regex::icase);
+    mAnchors = { "/completename" };
 }
 
 std::string LLUrlEntryAgentCompleteName::getName(const LLAvatarName& avatar_name)
@@ -960,6 +969,7 @@ LLUrlEntryAgentLegacyName::LLUrlEntryAgentLegacyName()
 {
     mPattern = boost::regex(APP_HEADER_REGEX "/agent/[\\da-f-]+/legacyname",
                             boost::regex::perl|boost::regex::icase);
+    mAnchors = { "/legacyname" };
 }
 
 std::string LLUrlEntryAgentLegacyName::getName(const LLAvatarName& avatar_name)
@@ -976,6 +986,7 @@ LLUrlEntryAgentDisplayName::LLUrlEntryAgentDisplayName()
 {
     mPattern = boost::regex(APP_HEADER_REGEX "/agent/[\\da-f-]+/displayname",
                             boost::regex::perl|boost::regex::icase);
+    mAnchors = { "/displayname" };
 }
 
 std::string LLUrlEntryAgentDisplayName::getName(const LLAvatarName& avatar_name)
@@ -994,6 +1005,7 @@ LLUrlEntryAgentUserName::LLUrlEntryAgentUserName()
 {
     mPattern = boost::regex(APP_HEADER_REGEX "/agent/[\\da-f-]+/username",
                             boost::regex::perl|boost::regex::icase);
+    mAnchors = { "/username" };
 }
 
 std::string LLUrlEntryAgentUserName::getName(const LLAvatarName& avatar_name)
@@ -1014,6 +1026,7 @@ extern std::string rlvGetAnonym(const LLAvatarName& avName);
 LLUrlEntryAgentRLVAnonymizedName::LLUrlEntryAgentRLVAnonymizedName()
 {
     mPattern = boost::regex(APP_HEADER_REGEX "/agent/[\\da-f-]+/rlvanonym", boost::regex::perl|boost::regex::icase);
+    mAnchors = { "/rlvanonym" };
 }
 
 std::string LLUrlEntryAgentRLVAnonymizedName::getName(const LLAvatarName& avatar_name)
@@ -1031,6 +1044,7 @@ FSUrlEntryAgentSelf::FSUrlEntryAgentSelf() : LLUrlEntryAgent()
 {
     mPattern = boost::regex(APP_HEADER_REGEX "/agentself/[\\da-f-]+/\\w+",
                             boost::regex::perl|boost::regex::icase);
+    mAnchors = { "/agentself/" };
 }
 
 std::string FSUrlEntryAgentSelf::getLabel(const std::string &url, const LLUrlLabelCallback &cb)
@@ -1056,6 +1070,7 @@ LLUrlEntryGroup::LLUrlEntryGroup()
 {
     mPattern = boost::regex(APP_HEADER_REGEX "/group/[\\da-f-]+/\\w+",
                             boost::regex::perl|boost::regex::icase);
+    mAnchors = { "/group/" };
     mMenuName = "menu_url_group.xml";
     mIcon = "Generic_Group";
     mTooltip = LLTrans::getString("TooltipGroupUrl");
@@ -1133,6 +1148,7 @@ LLUrlEntryInventory::LLUrlEntryInventory()
     //x-grid-location-info://lincoln.lindenlab.com/app/inventory/0e346d8b-4433-4d66-a6b0-fd37083abc4c/select?name=name with spaces&param2=value
     mPattern = boost::regex(APP_HEADER_REGEX "/inventory/[\\da-f-]+/\\w+\\S*",
                             boost::regex::perl|boost::regex::icase);
+    mAnchors = { "/inventory/" };
     mMenuName = "menu_url_inventory.xml";
 }
 
@@ -1153,6 +1169,7 @@ LLUrlEntryObjectIM::LLUrlEntryObjectIM()
     mPattern = boost::regex("(hop|secondlife):///app/objectim/[\\da-f-]+\?[^ \t\r\n\v\f]*",
     // </FS:AW>
                             boost::regex::perl|boost::regex::icase);
+    mAnchors = { "/app/objectim/" };
     mMenuName = "menu_url_objectim.xml";
 }
 
@@ -1183,6 +1200,7 @@ LLUrlEntryChat::LLUrlEntryChat()
 {
     mPattern = boost::regex("secondlife:///app/chat/\\d+/\\S+",
         boost::regex::perl|boost::regex::icase);
+    mAnchors = { "/app/chat/" };
     mMenuName = "menu_url_slapp.xml";
     mTooltip = LLTrans::getString("TooltipSLAPP");
 }
@@ -1208,6 +1226,7 @@ LLUrlEntryParcel::LLUrlEntryParcel()
 {
     mPattern = boost::regex(APP_HEADER_REGEX "/parcel/[\\da-f-]+/about",
                             boost::regex::perl|boost::regex::icase);
+    mAnchors = { "/parcel/" };
     mMenuName = "menu_url_parcel.xml";
     mTooltip = LLTrans::getString("TooltipParcelUrl");
 
@@ -1299,6 +1318,7 @@ LLUrlEntryPlace::LLUrlEntryPlace()
 {
     mPattern = boost::regex("((hop://[-\\w\\.\\:\\@]+/)|((x-grid-location-info://[-\\w\\.]+/region/)|(secondlife://)))\\S+/?(\\d+/\\d+/\\d+|\\d+/\\d+)/?", // <AW: hop:// protocol>
                             boost::regex::perl|boost::regex::icase);
+    mAnchors = { "://" };
     mMenuName = "menu_url_slurl.xml";
     mTooltip = LLTrans::getString("TooltipSLURL");
 }
@@ -1347,6 +1367,7 @@ LLUrlEntryRegion::LLUrlEntryRegion()
 {
     mPattern = boost::regex("secondlife:///app/region/[A-Za-z0-9()_%]+(/\\d+)?(/\\d+)?(/\\d+)?/?",
                             boost::regex::perl|boost::regex::icase);
+    mAnchors = { "/app/region/" };
     mMenuName = "menu_url_slurl.xml";
     mTooltip = LLTrans::getString("TooltipSLURL");
 }
@@ -1411,6 +1432,7 @@ LLUrlEntryTeleport::LLUrlEntryTeleport()
 {
     mPattern = boost::regex(APP_HEADER_REGEX "/teleport/\\S+(/\\d+)?(/\\d+)?(/\\d+)?/?\\S*",
                             boost::regex::perl|boost::regex::icase);
+    mAnchors = { "/teleport/" };
     mMenuName = "menu_url_teleport.xml";
     mTooltip = LLTrans::getString("TooltipTeleportUrl");
 }
@@ -1482,6 +1504,7 @@ FSUrlEntryWear::FSUrlEntryWear()
 {
     mPattern = boost::regex("(hop|secondlife):///app/wear_folder/\\S+",
                             boost::regex::perl|boost::regex::icase);
+    mAnchors = { "/app/wear_folder/" };
     mMenuName = "menu_url_slapp.xml";
     mTooltip = LLTrans::getString("TooltipFSUrlEntryWear");
 }
@@ -1500,6 +1523,7 @@ LLUrlEntrySL::LLUrlEntrySL()
 {
     mPattern = boost::regex("(hop|secondlife)://(\\w+)?(:\\d+)?/\\S+", // <AW: hop:// protocol>
                             boost::regex::perl|boost::regex::icase);
+    mAnchors = { "://" };
     mMenuName = "menu_url_slapp.xml";
     mTooltip = LLTrans::getString("TooltipSLAPP");
 }
@@ -1518,6 +1542,7 @@ FSHelpDebugUrlEntrySL::FSHelpDebugUrlEntrySL()
 {
     mPattern = boost::regex("(hop|secondlife):///app/fshelp/showdebug/\\S+",
                             boost::regex::perl|boost::regex::icase);
+    mAnchors = { "/app/fshelp/showdebug/" };
     mMenuName = "menu_url_slapp.xml";
     mTooltip = LLTrans::getString("TooltipFSHelpDebugSLUrl");
 }
@@ -1537,6 +1562,7 @@ LLUrlEntrySLLabel::LLUrlEntrySLLabel()
 {
     mPattern = boost::regex("\\[(hop|secondlife)://\\S+[ \t]+[^\\]]+\\]", // <AW: hop:// protocol>
                             boost::regex::perl|boost::regex::icase);
+    mAnchors = { "://" };
     mMenuName = "menu_url_slapp.xml";
     mTooltip = LLTrans::getString("TooltipSLAPP");
 }
@@ -1586,6 +1612,7 @@ LLUrlEntryWorldMap::LLUrlEntryWorldMap()
 {
     mPattern = boost::regex(APP_HEADER_REGEX "/worldmap/\\S+/?(\\d+)?/?(\\d+)?/?(\\d+)?/?\\S*",
                             boost::regex::perl|boost::regex::icase);
+    mAnchors = { "/worldmap/" };
     mMenuName = "menu_url_map.xml";
     mTooltip = LLTrans::getString("TooltipMapUrl");
 }
@@ -1627,6 +1654,7 @@ LLUrlEntryNoLink::LLUrlEntryNoLink()
 {
     mPattern = boost::regex("<nolink>.*?</nolink>",
                             boost::regex::perl|boost::regex::icase);
+    mAnchors = { "<nolink>" };
 }
 
 std::string LLUrlEntryNoLink::getUrl(const std::string &url) const
@@ -1654,6 +1682,7 @@ LLUrlEntryIcon::LLUrlEntryIcon()
 {
     mPattern = boost::regex("<icon\\s*>\\s*([^<]*)?\\s*</icon\\s*>",
                             boost::regex::perl|boost::regex::icase);
+    mAnchors = { "<icon" };
 }
 
 std::string LLUrlEntryIcon::getUrl(const std::string &url) const
@@ -1683,11 +1712,15 @@ std::string LLUrlEntryIcon::getIcon(const std::string &url)
 //
 LLUrlEntryJira::LLUrlEntryJira()
 {
-    // <FS:CR> Please make sure to sync these with the items in "static bool stringHasJira(const std::string &text)" if you make a change
+    // <FS:CR> Please make sure to sync these with mAnchors below if you make a change
     mPattern = boost::regex("((?:ARVD|BUG|CHOP|CHUIBUG|CTS|DOC|DN|ECC|EXP|FIRE|FITMESH|LEAP|LLSD|MATBUG|MISC|OPEN|PATHBUG|PLAT|PYO|SCR|SH|SINV|SLS|SNOW|SOCIAL|STORM|SUN|SVC|SPOT|SUN|SUP|TPV|VWR|WEB)-\\d+)",
                 // <FS:Ansariel> FIRE-917: Match case to reduce number of false positives
                 //boost::regex::perl|boost::regex::icase);
                 boost::regex::perl);
+    mAnchors = { "arvd-", "bug-", "chop-", "chuibug-", "cts-", "doc-", "dn-", "ecc-", "exp-",
+                 "fire-", "fitmesh-", "leap-", "llsd-", "matbug-", "misc-", "open-", "pathbug-",
+                 "plat-", "pyo-", "scr-", "sh-", "sinv-", "sls-", "snow-", "social-", "storm-",
+                 "sun-", "svc-", "spot-", "sup-", "tpv-", "vwr-", "web-" };
     mMenuName = "menu_url_http.xml";
     mTooltip = LLTrans::getString("TooltipHttpUrl");
 }
@@ -1724,6 +1757,7 @@ LLUrlEntryEmail::LLUrlEntryEmail()
 {
     mPattern = boost::regex("(mailto:)?[\\w\\.\\-]+@[\\w\\.\\-]+\\.[a-z]{2,63}",
                             boost::regex::perl | boost::regex::icase);
+    mAnchors = { "@" };
     mMenuName = "menu_url_email.xml";
     mTooltip = LLTrans::getString("TooltipEmail");
 }
@@ -1754,6 +1788,7 @@ LLUrlEntryExperienceProfile::LLUrlEntryExperienceProfile()
 {
     mPattern = boost::regex(APP_HEADER_REGEX "/experience/[\\da-f-]+/profile",
         boost::regex::perl|boost::regex::icase);
+    mAnchors = { "/experience/" };
     mIcon = "Generic_Experience";
     mMenuName = "menu_url_experience.xml";
 }
@@ -1811,6 +1846,7 @@ LLUrlEntryIPv6::LLUrlEntryIPv6()
     mHostPath = "https?://\\[([a-f0-9:]+:+)+[a-f0-9]+]";
     mPattern = boost::regex(mHostPath + "(:\\d{1,5})?(/\\S*)?",
         boost::regex::perl | boost::regex::icase);
+    mAnchors = { "://[" };
     mMenuName = "menu_url_http.xml";
     mTooltip = LLTrans::getString("TooltipHttpUrl");
 }
@@ -1853,6 +1889,7 @@ LLUrlEntryKeybinding::LLUrlEntryKeybinding()
 {
     mPattern = boost::regex(APP_HEADER_REGEX "/keybinding/\\w+(\\?mode=\\w+)?$",
                             boost::regex::perl | boost::regex::icase);
+    mAnchors = { "/keybinding/" };
     mMenuName = "menu_url_experience.xml";
 
     initLocalization();
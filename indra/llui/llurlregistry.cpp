@@ -29,8 +29,16 @@
 #include "llregex.h"
 #include "llurlregistry.h"
 #include "lluriparser.h"
+#include "hbxxh.h"
 
-#include <boost/algorithm/string/find.hpp> //for boost::ifind_first -KC
+#include <cctype>
+#include <deque>
+
+// entries beyond this many always have their regex run
+static const size_t MAX_ANCHORED_ENTRIES = 64;
+// texts whose matches are remembered, and the longest text worth remembering
+static const size_t MATCH_CACHE_SIZE = 64;
+static const size_t MAX_CACHED_TEXT_LENGTH = 1024;
 
 // default dummy callback that ignores any label updates from the server
 void LLUrlRegistryNullCallback(const std::string &url, const std::string &label, const std::string& icon)
@@ -38,6 +46,9 @@ void LLUrlRegistryNullCallback(const std::string &url, const std::string &label,
 }
 
 LLUrlRegistry::LLUrlRegistry()
+:   mAnchorsDirty(true),
+    mUnanchoredEntries(0),
+    mAnchorColumns(1)
 {
 //  mUrlEntry.reserve(20);
 // [RLVa:KB] - Checked: 2010-11-01 (RLVa-1.2.2a) | Added: RLVa-1.2.2a
@@ -122,10 +133,111 @@ void LLUrlRegistry::registerUrl(LLUrlEntryBase *url, bool force_front)
             mUrlEntry.insert(mUrlEntry.begin(), url);
         else
         mUrlEntry.push_back(url);
+        mAnchorsDirty = true;
+    }
+}
+
+void LLUrlRegistry::buildAnchorMatcher()
+{
+    mAnchorsDirty = false;
+    // entry indices may have moved
+    mMatchCache.assign(MATCH_CACHE_SIZE, CachedMatch());
+
+    // every byte that occurs in an anchor gets its own column, in either case,
+    // the rest share column 0
+    memset(mAnchorColumn, 0, sizeof(mAnchorColumn));
+    mAnchorColumns = 1;
+    for (LLUrlEntryBase* entry : mUrlEntry)
+    {
+        for (const std::string& anchor : entry->getAnchors())
+        {
+            for (char c : anchor)
+            {
+                U8 lower = (U8)std::tolower((U8)c);
+                if (!mAnchorColumn[lower])
+                {
+                    mAnchorColumn[lower] = mAnchorColumn[(U8)std::toupper(lower)] = (U8)mAnchorColumns++;
+                }
+            }
+        }
+    }
+
+    // trie of all anchors, state 0 is the root
+    mUnanchoredEntries = 0;
+    mAnchorNext.assign(mAnchorColumns, 0);
+    mAnchorHits.assign(1, 0);
+    for (size_t i = 0; i < mUrlEntry.size() && i < MAX_ANCHORED_ENTRIES; ++i)
+    {
+        const std::vector<std::string>& anchors = mUrlEntry[i]->getAnchors();
+        if (anchors.empty())
+        {
+            mUnanchoredEntries |= 1ULL << i;
+            continue;
+        }
+        for (const std::string& anchor : anchors)
+        {
+            U32 state = 0;
+            for (char c : anchor)
+            {
+                size_t slot = state * mAnchorColumns + mAnchorColumn[(U8)c];
+                if (!mAnchorNext[slot])
+                {
+                    mAnchorNext[slot] = (U32)mAnchorHits.size();
+                    mAnchorHits.push_back(0);
+                    mAnchorNext.resize(mAnchorNext.size() + mAnchorColumns, 0);
+                }
+                state = mAnchorNext[slot];
+            }
+            mAnchorHits[state] |= 1ULL << i;
+        }
+    }
+
+    // turn the trie into an automaton: a missing transition goes where the longest
+    // suffix that is still an anchor prefix would go, shallowest states first
+    std::vector<U32> fail(mAnchorHits.size(), 0);
+    std::deque<U32> queue;
+    for (U32 column = 0; column < mAnchorColumns; ++column)
+    {
+        if (mAnchorNext[column])
+        {
+            queue.push_back(mAnchorNext[column]);
+        }
+    }
+    while (!queue.empty())
+    {
+        U32 state = queue.front();
+        queue.pop_front();
+        mAnchorHits[state] |= mAnchorHits[fail[state]];
+        for (U32 column = 0; column < mAnchorColumns; ++column)
+        {
+            U32& next = mAnchorNext[state * mAnchorColumns + column];
+            U32 fallback = mAnchorNext[fail[state] * mAnchorColumns + column];
+            if (next)
+            {
+                fail[next] = fallback;
+                queue.push_back(next);
+            }
+            else
+            {
+                next = fallback;
+            }
+        }
+    }
+}
+
+U64 LLUrlRegistry::findAnchoredEntries(const std::string &text) const
+{
+    U64 entries = mUnanchoredEntries;
+    U32 state = 0;
+    for (char c : text)
+    {
+        state = mAnchorNext[state * mAnchorColumns + mAnchorColumn[(U8)c]];
+        entries |= mAnchorHits[state];
     }
+    return entries;
 }
 
-static bool matchRegex(const char *text, boost::regex regex, U32 &start, U32 &end)
+static bool matchRegex(const char *text, const boost::regex& regex, U32 &start, U32 &end)
 {
     boost::cmatch result;
     bool found;
@@ -162,121 +274,99 @@ static bool matchRegex(const char *text, boost::regex regex, U32 &start, U32 &en
     return true;
 }
 
-static bool stringHasUrl(const std::string &text)
-{
-    // fast heuristic test for a URL in a string. This is used
-    // to avoid lots of costly regex calls, BUT it needs to be
-    // kept in sync with the LLUrlEntry regexes we support.
-    return (text.find("://") != std::string::npos ||
-            // text.find("www.") != std::string::npos ||
-            // text.find(".com") != std::string::npos ||
-            // allow ALLCAPS urls -KC
-            boost::ifind_first(text, "www.") ||
-            boost::ifind_first(text, ".com") ||
-            boost::ifind_first(text, ".net") ||
-            boost::ifind_first(text, ".edu") ||
-            boost::ifind_first(text, ".org") ||
-            text.find("<nolink>") != std::string::npos ||
-            text.find("<icon") != std::string::npos ||
-            text.find("@") != std::string::npos);
-}
-
-static bool stringHasJira(const std::string &text)
-{
-    // same as above, but for jiras
-    // <FS:CR> Please make sure to sync these with the items in LLUrlEntryJira::LLUrlEntryJira() if you make a change
-    return (text.find("ARVD") != std::string::npos ||
-            text.find("BUG") != std::string::npos ||
-            text.find("CHOP") != std::string::npos ||
-            text.find("CHUIBUG") != std::string::npos ||
-            text.find("CTS") != std::string::npos ||
-            text.find("DOC") != std::string::npos ||
-            text.find("DN") != std::string::npos ||
-            text.find("ECC") != std::string::npos ||
-            text.find("EXP") != std::string::npos ||
-            text.find("FIRE") != std::string::npos ||
-            text.find("FITMESH") != std::string::npos ||
-            text.find("LEAP") != std::string::npos ||
-            text.find("LLSD") != std::string::npos ||
-            text.find("MATBUG") != std::string::npos ||
-            text.find("MISC") != std::string::npos ||
-            text.find("OPEN") != std::string::npos ||
-            text.find("PATHBUG") != std::string::npos ||
-            text.find("PLAT") != std::string::npos ||
-            text.find("PYO") != std::string::npos ||
-            text.find("SCR") != std::string::npos ||
-            text.find("SH") != std::string::npos ||
-            text.find("SINV") != std::string::npos ||
-            text.find("SLS") != std::string::npos ||
-            text.find("SNOW") != std::string::npos ||
-            text.find("SOCIAL") != std::string::npos ||
-            text.find("STORM") != std::string::npos ||
-            text.find("SUN") != std::string::npos ||
-            text.find("SUP") != std::string::npos ||
-            text.find("SVC") != std::string::npos ||
-            text.find("TPV") != std::string::npos ||
-            text.find("VWR") != std::string::npos ||
-            text.find("WEB") != std::string::npos);
-}
-
 bool LLUrlRegistry::findUrl(const std::string &text, LLUrlMatch &match, const LLUrlLabelCallback &cb, bool is_content_trusted)
 {
+    if (mAnchorsDirty)
+    {
+        buildAnchorMatcher();
+    }
+
     // avoid costly regexes if there is clearly no URL in the text
-    if (! (stringHasUrl(text) || stringHasJira(text)))
+    U64 anchored = findAnchoredEntries(text);
+    if (!anchored && mUrlEntry.size() <= MAX_ANCHORED_ENTRIES)
     {
         return false;
     }
 
-    // find the first matching regex from all url entries in the registry
     U32 match_start = 0, match_end = 0;
     LLUrlEntryBase *match_entry = NULL;
 
-    std::vector<LLUrlEntryBase *>::iterator it;
-    for (it = mUrlEntry.begin(); it != mUrlEntry.end(); ++it)
+    CachedMatch* cached = NULL;
+    if (text.size() <= MAX_CACHED_TEXT_LENGTH)
+    {
+        cached = &mMatchCache[HBXXH64::digest(text.data(), text.size()) % mMatchCache.size()];
+    }
+    if (cached && cached->mTrusted == is_content_trusted && cached->mText == text)
+    {
+        match_entry = cached->mEntry;
+        match_start = cached->mStart;
+        match_end = cached->mEnd;
+    }
+    else
     {
-        //Skip for url entry icon if content is not trusted
-        if((mUrlEntryIcon == *it) && ((text.find("Hand") != std::string::npos) || !is_content_trusted))
+        // find the first matching regex from all url entries in the registry
+        std::vector<LLUrlEntryBase *>::iterator it;
+        for (it = mUrlEntry.begin(); it != mUrlEntry.end(); ++it)
         {
-            continue;
-        }
-
-        LLUrlEntryBase *url_entry = *it;
+            size_t index = it - mUrlEntry.begin();
+            if (index < MAX_ANCHORED_ENTRIES && !(anchored & (1ULL << index)))
+            {
+                continue;
+            }
 
-        U32 start = 0, end = 0;
-        if (matchRegex(text.c_str(), url_entry->getPattern(), start, end))
-        {
-            // does this match occur in the string before any other match
-            if (start < match_start || match_entry == NULL)
+            //Skip for url entry icon if content is not trusted
+            if((mUrlEntryIcon == *it) && ((text.find("Hand") != std::string::npos) || !is_content_trusted))
             {
+                continue;
+            }
+
+            LLUrlEntryBase *url_entry = *it;
 
-                if (mLLUrlEntryInvalidSLURL == *it)
+            U32 start = 0, end = 0;
+            if (matchRegex(text.c_str(), url_entry->getPattern(), start, end))
+            {
+                // does this match occur in the string before any other match
+                if (start < match_start || match_entry == NULL)
                 {
-                    if(url_entry && url_entry->isSLURLvalid(text.substr(start, end - start + 1)))
+
+                    if (mLLUrlEntryInvalidSLURL == *it)
                     {
-                        continue;
+                        if(url_entry && url_entry->isSLURLvalid(text.substr(start, end - start + 1)))
+                        {
+                            continue;
+                        }
                     }
-                }
 
-                if((mUrlEntryHTTPLabel == *it) || (mUrlEntrySLLabel == *it))
-                {
-                    if(url_entry && !url_entry->isWikiLinkCorrect(text.substr(start, end - start + 1)))
+                    if((mUrlEntryHTTPLabel == *it) || (mUrlEntrySLLabel == *it))
                     {
-                        continue;
+                        if(url_entry && !url_entry->isWikiLinkCorrect(text.substr(start, end - start + 1)))
+                        {
+                            continue;
+                        }
                     }
-                }
 
-                match_start = start;
-                match_end = end;
-                match_entry = url_entry;
+                    match_start = start;
+                    match_end = end;
+                    match_entry = url_entry;
 
-                // <FS:Ansariel> Wear folder SLUrl
-                if (mUrlEntryWear == *it)
-                {
-                    break;
+                    // <FS:Ansariel> Wear folder SLUrl
+                    if (mUrlEntryWear == *it)
+                    {
+                        break;
+                    }
+                    // </FS:Ansariel>
                 }
-                // </FS:Ansariel>
             }
         }
+
+        if (cached)
+        {
+            cached->mText = text;
+            cached->mTrusted = is_content_trusted;
+            cached->mEntry = match_entry;
+            cached->mStart = match_start;
+            cached->mEnd = match_end;
+        }
     }
 
     // did we find a match? if so, return its details in the match object
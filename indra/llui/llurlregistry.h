@@ -57,6 +57,12 @@ void LLUrlRegistryNullCallback(const std::string &url,
 /// New Url types can be added to the registry with the registerUrl
 /// method. E.g., to add support for a new secondlife:///app/ Url.
 ///
+/// Rather than run every entry's regex over the text, findUrl() makes
+/// one pass over it looking for the entries' anchors (see
+/// LLUrlEntryBase::getAnchors()) and only runs the regexes of entries
+/// whose anchors occur. The outcome of the last few texts is cached, as
+/// the same text tends to be parsed again on every reflow.
+///
 /// Computing the label for a Url could involve a roundtrip request
 /// to the server (e.g., to find the actual agent or group name).
 /// As such, you can provide a callback method that will get invoked
@@ -94,7 +100,27 @@ public:
     void setKeybindingHandler(LLKeyBindingToStringHandler* handler);
 
 private:
+    // Aho-Corasick automaton over the anchors of all entries
+    void buildAnchorMatcher();
+    U64 findAnchoredEntries(const std::string &text) const;
+
+    struct CachedMatch
+    {
+        std::string mText;
+        bool mTrusted = false;
+        LLUrlEntryBase* mEntry = nullptr;   // nullptr if nothing matched
+        U32 mStart = 0;
+        U32 mEnd = 0;
+    };
+
     std::vector<LLUrlEntryBase *> mUrlEntry;
+    bool mAnchorsDirty;
+    U64 mUnanchoredEntries;             // entries whose regex always runs
+    U32 mAnchorColumns;
+    U8 mAnchorColumn[256];              // byte to column of mAnchorNext
+    std::vector<U32> mAnchorNext;       // state * mAnchorColumns + column to next state
+    std::vector<U64> mAnchorHits;       // state to entries with an anchor ending there
+    std::vector<CachedMatch> mMatchCache;
     LLUrlEntryBase* mUrlEntryTrusted;
     LLUrlEntryBase* mUrlEntryIcon;
     LLUrlEntryBase* mLLUrlEntryInvalidSLURL;
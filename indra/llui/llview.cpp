@@ -58,6 +58,8 @@
 static const S32 LINE_HEIGHT = 15;
 
 S32     LLView::sDepth = 0;
+U32     LLView::sChildLookupHits = 0;
+U32     LLView::sChildLookupSearches = 0;
 bool    LLView::sDebugRects = false;
 bool    LLView::sDebugUnicode = false;
 bool    LLView::sDebugCamera = false;
@@ -309,6 +311,7 @@ void LLView::sendChildToFront(LLView* child)
         {
             mChildList.remove( child );
             mChildList.push_front(child);
+            clearChildLookupCaches();
         }
     }
 }
@@ -324,6 +327,7 @@ void LLView::sendChildToBack(LLView* child)
         {
             mChildList.remove( child );
             mChildList.push_back(child);
+            clearChildLookupCaches();
         }
     }
 }
@@ -349,6 +353,7 @@ bool LLView::addChild(LLView* child, S32 tab_group)
 
     // add to front of child list, as normal
     mChildList.push_front(child);
+    clearChildLookupCaches();
 
     // add to tab order list
     if (tab_group != 0)
@@ -390,6 +395,7 @@ void LLView::removeChild(LLView* child)
         llassert(!child->mInDraw);
         mChildList.remove( child );
         child->mParentView = NULL;
+        clearChildLookupCaches();
         child_tab_order_t::iterator found = mTabOrder.find(child);
         if (found != mTabOrder.end())
         {
@@ -625,6 +631,7 @@ void LLView::deleteAllChildren()
 {
     // clear out the control ordering
     mTabOrder.clear();
+    clearChildLookupCaches();
 
     while (!mChildList.empty())
     {
@@ -1717,29 +1724,65 @@ LLView* LLView::findChildView(std::string_view name, bool recurse) const
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_UI;
 
+    if (recurse && mChildLookupCache)
+    {
+        child_lookup_map_t::const_iterator found = mChildLookupCache->find(name);
+        if (found != mChildLookupCache->end())
+        {
+            ++sChildLookupHits;
+            return found->second;
+        }
+    }
+    ++sChildLookupSearches;
+
+    LLView* resultp = NULL;
     // Look for direct children *first*
     for (LLView* childp : mChildList)
     {
         llassert(childp);
         if (childp->getName() == name)
         {
-            return childp;
+            resultp = childp;
+            break;
         }
     }
-    if (recurse)
+    if (!resultp && recurse)
     {
         // Look inside each child as well.
         for (LLView* childp : mChildList)
         {
             llassert(childp);
-            LLView* viewp = childp->findChildView(name, recurse);
-            if ( viewp )
+            resultp = childp->findChildView(name, recurse);
+            if (resultp)
             {
-                return viewp;
+                break;
             }
         }
     }
-    return NULL;
+
+    // Overrides like LLMenuItemBranchGL find views outside of the tree below us, which
+    // changes to this tree would not invalidate, so only descendants are remembered.
+    // Misses aren't either, the child may just not be built yet.
+    if (recurse && resultp && resultp->hasAncestor(this))
+    {
+        if (!mChildLookupCache)
+        {
+            mChildLookupCache = std::make_unique<child_lookup_map_t>();
+        }
+        mChildLookupCache->emplace(std::string(name), resultp);
+    }
+    return resultp;
+}
+
+void LLView::clearChildLookupCaches()
+{
+    for (LLView* viewp = this; viewp; viewp = viewp->mParentView)
+    {
+        if (viewp->mChildLookupCache)
+        {
+            viewp->mChildLookupCache->clear();
+        }
+    }
 }
 
 bool LLView::parentPointInView(S32 x, S32 y, EHitTestType type) const
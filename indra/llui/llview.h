@@ -49,6 +49,8 @@
 #include "llfocusmgr.h"
 
 #include <list>
+#include <map>
+#include <memory>
 #include <boost/function.hpp>
 #include <boost/noncopyable.hpp>
 
@@ -237,7 +239,7 @@ public:
     void        setFollowsAll()                 { mReshapeFlags |= FOLLOWS_ALL; }
 
     void        setSoundFlags(U8 flags)         { mSoundFlags = flags; }
-    void        setName(std::string name)           { mName = name; }
+    void        setName(std::string name)           { mName = name; clearChildLookupCaches(); }
     void        setUseBoundingRect( bool use_bounding_rect );
     bool        getUseBoundingRect() const;
 
@@ -339,7 +341,7 @@ public:
     LLView*     findPrevSibling(LLView* child);
     LLView*     findNextSibling(LLView* child);
     S32         getChildCount() const           { return (S32)mChildList.size(); }
-    template<class _Pr3> void sortChildren(_Pr3 _Pred) { mChildList.sort(_Pred); }
+    template<class _Pr3> void sortChildren(_Pr3 _Pred) { mChildList.sort(_Pred); clearChildLookupCaches(); }
     bool        hasAncestor(const LLView* parentp) const;
     bool        hasChild(std::string_view childname, bool recurse = false) const;
     bool        childHasKeyboardFocus( std::string_view childname ) const;
@@ -628,6 +630,14 @@ private:
 
     static LLWindow* sWindow;   // All root views must know about their window.
 
+    // Descendants found by name with findChildView(), so the panels that call getChild<>()
+    // every frame don't search their whole tree each time.  Allocated on the first lookup,
+    // and cleared on this view and all its ancestors whenever the tree below them changes.
+    typedef std::map<std::string, LLView*, std::less<>> child_lookup_map_t;
+    mutable std::unique_ptr<child_lookup_map_t> mChildLookupCache;
+
+    void clearChildLookupCaches();
+
     typedef std::map<std::string, LLView*> default_widget_map_t;
     // allocate this map no demand, as it is rarely needed
     mutable LLView* mDefaultWidgets;
@@ -666,6 +676,11 @@ public:
     // Depth in view hierarchy during rendering
     static S32  sDepth;
 
+    // Child lookups answered from the cache, and views searched for lookups that were not,
+    // since the counters were last reset.  Shown with the render info debug text.
+    static U32  sChildLookupHits;
+    static U32  sChildLookupSearches;
+
     // Draw debug rectangles around widgets to help with alignment and spacing
     static bool sDebugRects;
 
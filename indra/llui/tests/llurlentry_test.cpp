@@ -120,6 +120,20 @@ namespace tut
             S32 start = static_cast<U32>(result[0].first - text);
             S32 end = static_cast<U32>(result[0].second - text);
             url = entry.getUrl(std::string(text+start, end-start));
+
+            // the registry skips the regex for text without any of the anchors
+            const std::vector<std::string>& anchors = entry.getAnchors();
+            if (!anchors.empty())
+            {
+                std::string matched(text+start, end-start);
+                LLStringUtil::toLower(matched);
+                bool anchored = false;
+                for (const std::string& anchor : anchors)
+                {
+                    anchored |= matched.find(anchor) != std::string::npos;
+                }
+                ensure(testname + " contains an anchor", anchored);
+            }
         }
         ensure_equals(testname, url, expected);
     }
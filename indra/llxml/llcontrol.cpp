@@ -29,8 +29,11 @@
 #include <iostream>
 #include <fstream>
 #include <algorithm>
+#include <mutex>
+#include <sstream>
 
 #include "llcontrol.h"
+#include "llparsedfilecache.h"
 
 #include "llstl.h"
 
@@ -1093,19 +1096,22 @@ U32 LLControlGroup::saveToFile(const std::string& filename, bool nondefault_only
 U32 LLControlGroup::loadFromFile(const std::string& filename, bool set_default_values, bool save_values)
 {
     LLSD settings;
-    llifstream infile;
-    infile.open(filename.c_str());
-    if(!infile.is_open())
+    std::string contents = LLFile::getContents(filename);
+    if (contents.empty() && !LLFile::isfile(filename))
     {
         LL_WARNS("Settings") << "Cannot find file " << filename << " to load." << LL_ENDL;
         return 0;
     }
 
-    if (LLSDParser::PARSE_FAILURE == LLSDSerialize::fromXML(settings, infile))
+    if (!LLParsedFileCache::load(filename, contents, settings))
     {
-        infile.close();
-        LL_WARNS("Settings") << "Unable to parse LLSD control file " << filename << ". Trying Legacy Method." << LL_ENDL;
-        return loadFromFileLegacy(filename, true, TYPE_STRING);
+        std::istringstream instream(contents);
+        if (LLSDParser::PARSE_FAILURE == LLSDSerialize::fromXML(settings, instream))
+        {
+            LL_WARNS("Settings") << "Unable to parse LLSD control file " << filename << ". Trying Legacy Method." << LL_ENDL;
+            return loadFromFileLegacy(filename, true, TYPE_STRING);
+        }
+        LLParsedFileCache::store(filename, contents, settings);
     }
 
     U32 validitems = 0;
@@ -1246,6 +1252,67 @@ void LLControlGroup::resetToDefaults()
     }
 }
 
+namespace
+{
+    struct BatchedCallbacks
+    {
+        std::mutex mMutex;
+        std::vector<std::pair<std::string, LLControlGroup::batched_callback_t> > mPending;
+    };
+
+    BatchedCallbacks& get_batched_callbacks()
+    {
+        static BatchedCallbacks batched;
+        return batched;
+    }
+}
+
+boost::signals2::connection LLControlGroup::connectBatched(std::string_view name, const std::string& key,
+                                                           const batched_callback_t& callback)
+{
+    LLControlVariable* control = getControl(name);
+    if (!control)
+    {
+        LL_WARNS() << "Control " << name << " not found." << LL_ENDL;
+        return boost::signals2::connection();
+    }
+
+    return control->getCommitSignal()->connect([key, callback](LLControlVariable*, const LLSD&, const LLSD&)
+    {
+        BatchedCallbacks& batched = get_batched_callbacks();
+        std::lock_guard<std::mutex> lock(batched.mMutex);
+        for (const auto& pending : batched.mPending)
+        {
+            if (pending.first == key)
+            {
+                return;
+            }
+        }
+        batched.mPending.emplace_back(key, callback);
+    });
+}
+
+// static
+void LLControlGroup::fireBatchedCallbacks()
+{
+    std::vector<std::pair<std::string, batched_callback_t> > pending;
+    {
+        BatchedCallbacks& batched = get_batched_callbacks();
+        std::lock_guard<std::mutex> lock(batched.mMutex);
+        if (batched.mPending.empty())
+        {
+            return;
+        }
+        pending.swap(batched.mPending);
+    }
+
+    // controls these set queue their callbacks for the next call
+    for (const auto& entry : pending)
+    {
+        entry.second();
+    }
+}
+
 void LLControlGroup::applyToAll(ApplyFunctor* func)
 {
     for (ctrl_name_table_t::iterator iter = mNameTable.begin();
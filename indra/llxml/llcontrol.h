@@ -34,6 +34,7 @@
 #include "llrefcount.h"
 #include "llinstancetracker.h"
 
+#include <functional>
 #include <vector>
 
 #include <boost/bind.hpp>
@@ -317,6 +318,17 @@ public:
 
     bool    controlExists(std::string_view name);
 
+    // Commit signals fire inside every set, so a handler that rebuilds something
+    // expensive runs once per control changed, e.g. once per setting a graphics preset
+    // touches.  A batched callback instead runs once from fireBatchedCallbacks(), after
+    // any of the controls it was connected to under the same key changed.
+    typedef std::function<void()> batched_callback_t;
+    boost::signals2::connection connectBatched(std::string_view name, const std::string& key,
+                                               const batched_callback_t& callback);
+    // Run the callbacks queued since the last call, in the order they were queued.
+    // The viewer calls this once per frame from its main loop.
+    static void fireBatchedCallbacks();
+
     // Returns number of controls loaded, 0 if failed
     // If require_declaration is false, will auto-declare controls it finds
     // as the given type.
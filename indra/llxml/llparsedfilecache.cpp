@@ -0,0 +1,134 @@
+/**
+ * @file llparsedfilecache.cpp
+ * @brief Binary cache of the LLSD parsed from XML files
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llparsedfilecache.h"
+
+#include "hbxxh.h"
+#include "lldir.h"
+#include "llfile.h"
+#include "llsdserialize.h"
+
+#include <cstring>
+#include <sstream>
+
+namespace
+{
+    // bump when the layout of the cache files changes
+    const char CACHE_MAGIC[8] = { 'L', 'L', 'P', 'F', 'C', '0', '0', '1' };
+
+    struct CacheHeader
+    {
+        char mMagic[8];
+        U64 mSourceHash;
+        U64 mSourceSize;
+    };
+
+    std::string sCacheDir;
+}
+
+// static
+void LLParsedFileCache::setDirectory(const std::string& dir)
+{
+    sCacheDir = dir;
+    if (!sCacheDir.empty() && !LLFile::isdir(sCacheDir))
+    {
+        LLFile::mkdir(sCacheDir);
+    }
+}
+
+// static
+std::string LLParsedFileCache::getCachePath(const std::string& source)
+{
+    return gDirUtilp->add(sCacheDir, llformat("%016llx.llsd", (unsigned long long)HBXXH64::digest(source)));
+}
+
+// static
+bool LLParsedFileCache::load(const std::string& source, const std::string& contents, LLSD& parsed)
+{
+    if (sCacheDir.empty() || contents.empty())
+    {
+        return false;
+    }
+
+    std::string cached = LLFile::getContents(getCachePath(source));
+    CacheHeader header;
+    if (cached.size() <= sizeof(header))
+    {
+        return false;
+    }
+    memcpy(&header, cached.data(), sizeof(header));
+    if (memcmp(header.mMagic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+        header.mSourceSize != contents.size() ||
+        header.mSourceHash != HBXXH64::digest(contents))
+    {
+        return false;
+    }
+
+    std::istringstream stream(cached);
+    stream.seekg(sizeof(header));
+    LLSD result;
+    if (LLSDSerialize::fromBinary(result, stream, cached.size() - sizeof(header)) <= 0)
+    {
+        LL_WARNS("Settings") << "Ignoring unreadable cache of " << source << LL_ENDL;
+        return false;
+    }
+    parsed = result;
+    return true;
+}
+
+// static
+void LLParsedFileCache::store(const std::string& source, const std::string& contents, const LLSD& parsed)
+{
+    if (sCacheDir.empty() || contents.empty())
+    {
+        return;
+    }
+
+    CacheHeader header;
+    memcpy(header.mMagic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.mSourceHash = HBXXH64::digest(contents);
+    header.mSourceSize = contents.size();
+
+    std::ostringstream stream;
+    stream.write((const char*)&header, sizeof(header));
+    LLSDSerialize::toBinary(parsed, stream);
+
+    // write aside and rename, another viewer instance may be reading the entry
+    std::string path = getCachePath(source);
+    std::string temp_path = path + ".tmp";
+    {
+        llofstream file(temp_path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            return;
+        }
+        const std::string& data = stream.str();
+        file.write(data.data(), data.size());
+    }
+    LLFile::rename(temp_path, path);
+}
@@ -0,0 +1,62 @@
+/**
+ * @file llparsedfilecache.h
+ * @brief Binary cache of the LLSD parsed from XML files
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLPARSEDFILECACHE_H
+#define LL_LLPARSEDFILECACHE_H
+
+#include "llsd.h"
+
+#include <string>
+
+// Startup parses thousands of settings and colors from XML, although these files
+// rarely change between runs.  LLParsedFileCache keeps what was parsed from a file as
+// binary LLSD, which loads in a single read without any XML parsing.
+//
+//     std::string contents = LLFile::getContents(filename);
+//     LLSD parsed;
+//     if (!LLParsedFileCache::load(filename, contents, parsed))
+//     {
+//         ... parse contents into parsed ...
+//         LLParsedFileCache::store(filename, contents, parsed);
+//     }
+//
+// An entry is only used when the hash of the file contents it was made from matches,
+// so any change to the source falls back to parsing it.
+class LLParsedFileCache
+{
+public:
+    // Directory holding the cache files, created if needed.  Nothing is cached until set.
+    static void setDirectory(const std::string& dir);
+
+    // Fill parsed from the cache entry of source if it was made from these contents
+    static bool load(const std::string& source, const std::string& contents, LLSD& parsed);
+    static void store(const std::string& source, const std::string& contents, const LLSD& parsed);
+
+private:
+    static std::string getCachePath(const std::string& source);
+};
+
+#endif // LL_LLPARSEDFILECACHE_H
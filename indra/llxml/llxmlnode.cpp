@@ -44,11 +44,53 @@
 #include "llstring.h"
 #include "lluuid.h"
 #include "lldir.h"
+#include "llslabpool.h"
 
 // static
 bool LLXMLNode::sStripEscapedStrings = true;
 bool LLXMLNode::sStripWhitespaceValues = false;
 
+namespace
+{
+    // Nodes are thread safe reference counted and may be released on any thread.
+    // Never destroyed, nodes may be released during static destruction.
+    LLLockedSlabPool& get_node_pool()
+    {
+        static LLLockedSlabPool* pool = new LLLockedSlabPool(sizeof(LLXMLNode), 1024);
+        return *pool;
+    }
+
+    LLLockedSlabPool& get_children_pool()
+    {
+        static LLLockedSlabPool* pool = new LLLockedSlabPool(sizeof(LLXMLChildren), 1024);
+        return *pool;
+    }
+}
+
+//static
+void* LLXMLChildren::operator new(size_t size)
+{
+    return get_children_pool().allocate(size);
+}
+
+//static
+void LLXMLChildren::operator delete(void* ptr, size_t size)
+{
+    get_children_pool().free(ptr, size);
+}
+
+//static
+void* LLXMLNode::operator new(size_t size)
+{
+    return get_node_pool().allocate(size);
+}
+
+//static
+void LLXMLNode::operator delete(void* ptr, size_t size)
+{
+    get_node_pool().free(ptr, size);
+}
+
 LLXMLNode::LLXMLNode() :
     mID(""),
     mParser(NULL),
@@ -142,12 +184,13 @@ LLXMLNode::LLXMLNode(const LLXMLNode& rhs) :
 LLXMLNodePtr LLXMLNode::deepCopy()
 {
     LLXMLNodePtr newnode = LLXMLNodePtr(new LLXMLNode(*this));
+    newnode->mLineNumber = mLineNumber;
     if (mChildren.notNull())
     {
-        for (LLXMLChildList::iterator iter = mChildren->map.begin();
-             iter != mChildren->map.end(); ++iter)
+        // walk the list rather than the map, children must stay in document order
+        for (LLXMLNodePtr child = mChildren->head; child.notNull(); child = child->mNext)
         {
-            LLXMLNodePtr temp_ptr_for_gcc(iter->second->deepCopy());
+            LLXMLNodePtr temp_ptr_for_gcc(child->deepCopy());
             newnode->addChild(temp_ptr_for_gcc);
         }
     }
@@ -403,74 +446,76 @@ void XMLCALL StartXMLNode(void *userData,
     U32 pos = 0;
     while (atts[pos] != NULL)
     {
-        std::string attr_name = atts[pos];
-        std::string attr_value = atts[pos+1];
+        // intern the name once, it is needed for the lookup and for the attribute node
+        LLStringTableEntry* attr_name = gStringTable.addStringEntry(atts[pos]);
+        const char* name_str = attr_name->mString;
+        const char* attr_value = atts[pos+1];
 
         // Special cases
-        if ('i' == attr_name[0] && "id" == attr_name)
+        if (!strcmp(name_str, "id"))
         {
             new_node->mID = attr_value;
         }
-        else if ('v' == attr_name[0] && "version" == attr_name)
+        else if (!strcmp(name_str, "version"))
         {
             U32 version_major = 0;
             U32 version_minor = 0;
-            if (sscanf(attr_value.c_str(), "%d.%d", &version_major, &version_minor) > 0)
+            if (sscanf(attr_value, "%d.%d", &version_major, &version_minor) > 0)
             {
                 new_node->mVersionMajor = version_major;
                 new_node->mVersionMinor = version_minor;
             }
         }
-        else if (('s' == attr_name[0] && "size" == attr_name) || ('l' == attr_name[0] && "length" == attr_name))
+        else if (!strcmp(name_str, "size") || !strcmp(name_str, "length"))
         {
             U32 length;
-            if (sscanf(attr_value.c_str(), "%d", &length) > 0)
+            if (sscanf(attr_value, "%d", &length) > 0)
             {
                 new_node->mLength = length;
             }
         }
-        else if ('p' == attr_name[0] && "precision" == attr_name)
+        else if (!strcmp(name_str, "precision"))
         {
             U32 precision;
-            if (sscanf(attr_value.c_str(), "%d", &precision) > 0)
+            if (sscanf(attr_value, "%d", &precision) > 0)
             {
                 new_node->mPrecision = precision;
             }
         }
-        else if ('t' == attr_name[0] && "type" == attr_name)
+        else if (!strcmp(name_str, "type"))
         {
-            if ("boolean" == attr_value)
+            if (!strcmp(attr_value, "boolean"))
             {
                 new_node->mType = LLXMLNode::TYPE_BOOLEAN;
             }
-            else if ("integer" == attr_value)
+            else if (!strcmp(attr_value, "integer"))
             {
                 new_node->mType = LLXMLNode::TYPE_INTEGER;
             }
-            else if ("float" == attr_value)
+            else if (!strcmp(attr_value, "float"))
             {
                 new_node->mType = LLXMLNode::TYPE_FLOAT;
             }
-            else if ("string" == attr_value)
+            else if (!strcmp(attr_value, "string"))
             {
                 new_node->mType = LLXMLNode::TYPE_STRING;
             }
-            else if ("uuid" == attr_value)
+            else if (!strcmp(attr_value, "uuid"))
             {
                 new_node->mType = LLXMLNode::TYPE_UUID;
             }
-            else if ("noderef" == attr_value)
+            else if (!strcmp(attr_value, "noderef"))
             {
                 new_node->mType = LLXMLNode::TYPE_NODEREF;
             }
         }
-        else if ('e' == attr_name[0] && "encoding" == attr_name)
+        else if (!strcmp(name_str, "encoding"))
         {
-            if ("decimal" == attr_value)
+            if (!strcmp(attr_value, "decimal"))
             {
                 new_node->mEncoding = LLXMLNode::ENCODING_DECIMAL;
             }
-            else if ("hex" == attr_value)
+            else if (!strcmp(attr_value, "hex"))
             {
                 new_node->mEncoding = LLXMLNode::ENCODING_HEX;
             }
@@ -482,9 +527,9 @@ void XMLCALL StartXMLNode(void *userData,
 
         // only one attribute child per description
         LLXMLNodePtr attr_node;
-        if (!new_node->getAttribute(attr_name.c_str(), attr_node, false))
+        if (!new_node->getAttribute(attr_name, attr_node, false))
         {
-            attr_node = new LLXMLNode(attr_name.c_str(), true);
+            attr_node = new LLXMLNode(attr_name, true);
             attr_node->setLineNumber(XML_GetCurrentLineNumber(*new_node_ptr->mParser));
         }
         attr_node->setValue(attr_value);
@@ -509,7 +554,7 @@ void XMLCALL EndXMLNode(void *userData,
     // SJB: total hack:
     if (LLXMLNode::sStripWhitespaceValues)
     {
-        std::string value = node->getValue();
+        const std::string& value = node->getValue();
         bool is_empty = true;
         for (std::string::size_type s = 0; s < value.length(); s++)
         {
@@ -522,8 +567,7 @@ void XMLCALL EndXMLNode(void *userData,
         }
         if (is_empty)
         {
-            value.clear();
-            node->setValue(value);
+            node->setValue(LLStringUtil::null);
         }
     }
 }
@@ -533,7 +577,8 @@ void XMLCALL XMLData(void *userData,
                      int len)
 {
     LLXMLNode* current_node = (LLXMLNode *)userData;
-    std::string value = current_node->getValue();
+    // expat hands long text over in many chunks, append in place rather than copying
+    // the whole value for each one
     if (LLXMLNode::sStripEscapedStrings)
     {
         if (s[0] == '\"' && s[len-1] == '\"')
@@ -557,13 +602,11 @@ void XMLCALL XMLData(void *userData,
                     unescaped_string.append(&s[pos], 1);
                 }
             }
-            value.append(unescaped_string);
-            current_node->setValue(value);
+            current_node->appendValue(unescaped_string.data(), unescaped_string.size());
             return;
         }
     }
-    value.append(std::string(s, len));
-    current_node->setValue(value);
+    current_node->appendValue(s, len);
 }
 
 
@@ -2606,6 +2649,15 @@ void LLXMLNode::setValue(const std::string& value)
     mValue = value;
 }
 
+void LLXMLNode::appendValue(const char* value, size_t length)
+{
+    if (TYPE_CONTAINER == mType)
+    {
+        mType = TYPE_UNKNOWN;
+    }
+    mValue.append(value, length);
+}
+
 void LLXMLNode::setDefault(LLXMLNode *default_node)
 {
     mDefault = default_node;
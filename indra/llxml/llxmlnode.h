@@ -85,6 +85,10 @@ class LLVector4U;
 
 struct LLXMLChildren : public LLThreadSafeRefCount
 {
+    // Allocated from a shared pool, see LLXMLNode
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr, size_t size);
+
     LLXMLChildList map;         // Map of children names->pointers
     LLXMLNodePtr head;          // Head of the double-linked list
     LLXMLNodePtr tail;          // Tail of the double-linked list
@@ -118,6 +122,12 @@ protected:
     ~LLXMLNode();
 
 public:
+    // Parsing a file creates a node for every element and every attribute, so nodes come
+    // from a shared slab pool instead of the heap, which keeps a document's nodes close
+    // together and makes building and freeing a tree much cheaper.
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr, size_t size);
+
     LLXMLNode();
     LLXMLNode(const char* name, bool is_attribute);
     LLXMLNode(LLStringTableEntry* name, bool is_attribute);
@@ -283,7 +293,7 @@ public:
     bool deleteChildren(const std::string& name);
     bool deleteChildren(LLStringTableEntry* name);
     void setAttributes(ValueType type, U32 precision, Encoding encoding, U32 length);
-//  void appendValue(const std::string& value); // Unused
+    void appendValue(const char* value, size_t length);
 
     bool fromXMLRPCValue(LLSD& target);
 
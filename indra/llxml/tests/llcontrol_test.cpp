@@ -31,6 +31,8 @@
 #include "stringize.h"
 
 #include "../llcontrol.h"
+#include "../llparsedfilecache.h"
+#include "lldiriterator.h"
 
 #include "../test/lltut.h"
 #include <memory>
@@ -151,4 +153,64 @@ namespace tut
         ensure("listener fired on changed setting", mListenerFired);
     }
 
+    //batched callbacks
+    template<> template<>
+    void control_group_t::test<5>()
+    {
+        mCG->loadFromFile(mTestConfigFile.c_str());
+        mCG->declareU32("OtherSetting", 1, "Second setting for the batched callback test");
+        int calls = 0;
+        mCG->connectBatched("TestSetting", "test", [&calls]() { ++calls; });
+        mCG->connectBatched("OtherSetting", "test", [&calls]() { ++calls; });
+
+        LLControlGroup::fireBatchedCallbacks();
+        ensure_equals("no callback without a change", calls, 0);
+
+        mCG->setU32("TestSetting", 13);
+        mCG->setU32("TestSetting", 14);
+        mCG->setU32("OtherSetting", 2);
+        ensure_equals("callback waits for fireBatchedCallbacks", calls, 0);
+        LLControlGroup::fireBatchedCallbacks();
+        ensure_equals("changes coalesced into one call", calls, 1);
+        LLControlGroup::fireBatchedCallbacks();
+        ensure_equals("queue emptied", calls, 1);
+
+        mCG->setU32("TestSetting", 14);
+        LLControlGroup::fireBatchedCallbacks();
+        ensure_equals("setting the same value queues nothing", calls, 1);
+    }
+
+    //parsed file cache
+    template<> template<>
+    void control_group_t::test<6>()
+    {
+        std::string cache_dir = mTestConfigDir + "cache";
+        LLParsedFileCache::setDirectory(cache_dir);
+
+        LLControlGroup first("cache1");
+        ensure_equals("parsed from XML", first.loadFromFile(mTestConfigFile.c_str()), 1);
+        LLControlGroup second("cache2");
+        ensure_equals("loaded from cache", second.loadFromFile(mTestConfigFile.c_str()), 1);
+        ensure_equals("cached value", second.getU32("TestSetting"), 12);
+
+        LLSD config;
+        config["TestSetting"]["Comment"] = "Dummy setting used for testing";
+        config["TestSetting"]["Persist"] = 1;
+        config["TestSetting"]["Type"] = "U32";
+        config["TestSetting"]["Value"] = 42;
+        writeSettingsFile(config);
+        LLControlGroup third("cache3");
+        ensure_equals("changed file parsed again", third.loadFromFile(mTestConfigFile.c_str()), 1);
+        ensure_equals("changed value", third.getU32("TestSetting"), 42);
+
+        LLParsedFileCache::setDirectory("");
+        std::string entry;
+        LLDirIterator iter(cache_dir, "*");
+        while (iter.next(entry))
+        {
+            LLFile::remove(cache_dir + "/" + entry);
+        }
+        LLFile::rmdir(cache_dir);
+    }
+
 }
@@ -147,10 +147,7 @@ void AOEngine::clear(bool from_timer)
 void AOEngine::stopAllStandVariants()
 {
     LL_DEBUGS("AOEngine") << "stopping all STAND variants." << LL_ENDL;
-    gAgent.sendAnimationRequest(ANIM_AGENT_STAND_1, ANIM_REQUEST_STOP);
-    gAgent.sendAnimationRequest(ANIM_AGENT_STAND_2, ANIM_REQUEST_STOP);
-    gAgent.sendAnimationRequest(ANIM_AGENT_STAND_3, ANIM_REQUEST_STOP);
-    gAgent.sendAnimationRequest(ANIM_AGENT_STAND_4, ANIM_REQUEST_STOP);
+    gAgent.sendAnimationRequests({ ANIM_AGENT_STAND_1, ANIM_AGENT_STAND_2, ANIM_AGENT_STAND_3, ANIM_AGENT_STAND_4 }, ANIM_REQUEST_STOP);
     gAgentAvatarp->LLCharacter::stopMotion(ANIM_AGENT_STAND_1);
     gAgentAvatarp->LLCharacter::stopMotion(ANIM_AGENT_STAND_2);
     gAgentAvatarp->LLCharacter::stopMotion(ANIM_AGENT_STAND_3);
@@ -160,8 +157,7 @@ void AOEngine::stopAllStandVariants()
 void AOEngine::stopAllSitVariants()
 {
     LL_DEBUGS("AOEngine") << "stopping all SIT variants." << LL_ENDL;
-    gAgent.sendAnimationRequest(ANIM_AGENT_SIT_FEMALE, ANIM_REQUEST_STOP);
-    gAgent.sendAnimationRequest(ANIM_AGENT_SIT_GENERIC, ANIM_REQUEST_STOP);
+    gAgent.sendAnimationRequests({ ANIM_AGENT_SIT_FEMALE, ANIM_AGENT_SIT_GENERIC }, ANIM_REQUEST_STOP);
     gAgentAvatarp->LLCharacter::stopMotion(ANIM_AGENT_SIT_FEMALE);
     gAgentAvatarp->LLCharacter::stopMotion(ANIM_AGENT_SIT_GENERIC);
 
@@ -173,8 +169,7 @@ void AOEngine::stopAllSitVariants()
         return;
     }
 
-    gAgent.sendAnimationRequest(ANIM_AGENT_SIT_GROUND, ANIM_REQUEST_STOP);
-    gAgent.sendAnimationRequest(ANIM_AGENT_SIT_GROUND_CONSTRAINED, ANIM_REQUEST_STOP);
+    gAgent.sendAnimationRequests({ ANIM_AGENT_SIT_GROUND, ANIM_AGENT_SIT_GROUND_CONSTRAINED }, ANIM_REQUEST_STOP);
 
     gAgentAvatarp->LLCharacter::stopMotion(ANIM_AGENT_SIT_GROUND);
     gAgentAvatarp->LLCharacter::stopMotion(ANIM_AGENT_SIT_GROUND_CONSTRAINED);
@@ -382,6 +377,8 @@ void AOEngine::enable(bool enable)
     AOSet::AOState* state = mCurrentSet->getStateByRemapID(mLastMotion);
     if (mEnabled)
     {
+        preloadAnimations(mCurrentSet);
+
         if (state && !state->mAnimations.empty())
         {
             LL_DEBUGS("AOEngine") << "Enabling animation state " << state->mName << LL_ENDL;
@@ -944,7 +941,6 @@ void AOEngine::cycle(eCycleMode cycleMode)
     if (animation.notNull())
     {
         LL_DEBUGS("AOEngine") << "requesting animation start for motion " << gAnimLibrary.animationName(mLastMotion) << ": " << animation << LL_ENDL;
-        gAgent.sendAnimationRequest(animation, ANIM_REQUEST_START);
         mAnimationChangedSignal(state->mAnimations[state->mCurrentAnimation].mInventoryUUID);
     }
     else
@@ -955,9 +951,36 @@ void AOEngine::cycle(eCycleMode cycleMode)
     if (oldAnimation.notNull())
     {
         LL_DEBUGS("AOEngine") << "Cycling state " << state->mName << " - stopping animation " << oldAnimation << LL_ENDL;
-        gAgent.sendAnimationRequest(oldAnimation, ANIM_REQUEST_STOP);
         gAgentAvatarp->LLCharacter::stopMotion(oldAnimation);
     }
+
+    // start the new animation and stop the old one in the same message, so the
+    // simulator never has neither of them playing in between
+    gAgent.sendAnimationRequests(std::vector<LLUUID>{ animation }, std::vector<LLUUID>{ oldAnimation });
+}
+
+void AOEngine::preloadAnimations(AOSet* set)
+{
+    if (!set || !isAgentAvatarValid())
+    {
+        return;
+    }
+
+    // createMotion() fetches and decodes the animation, and the decoded keyframes stay in
+    // the LLKeyframeMotion data cache after the motion instance itself is purged again
+    S32 count = 0;
+    for (S32 index = 0; index < AOSet::AOSTATES_MAX; ++index)
+    {
+        for (const AOSet::AOAnimation& anim : set->getState(index)->mAnimations)
+        {
+            if (anim.mAssetUUID.notNull() && !gAgentAvatarp->findMotion(anim.mAssetUUID))
+            {
+                gAgentAvatarp->createMotion(anim.mAssetUUID);
+                ++count;
+            }
+        }
+    }
+    LL_DEBUGS("AOEngine") << "Preloading " << count << " animations of set " << set->getName() << LL_ENDL;
 }
 
 void AOEngine::updateSortOrder(AOSet::AOState* state)
@@ -1637,6 +1660,7 @@ void AOEngine::selectSet(AOSet* set)
 
     if (mEnabled)
     {
+        preloadAnimations(mCurrentSet);
         LL_DEBUGS("AOEngine") << "enabling with motion " << gAnimLibrary.animationName(mLastMotion) << LL_ENDL;
         gAgent.sendAnimationRequest(override(mLastMotion, true), ANIM_REQUEST_START);
     }
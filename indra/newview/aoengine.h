@@ -168,6 +168,9 @@ class AOEngine
         void stopAllStandVariants();
         void stopAllSitVariants();
 
+        // Load the animations of every state of set, so they play without a fetch the first time
+        void preloadAnimations(AOSet* set);
+
         bool foreignAnimations();
         AOSet::AOState* mapSwimming(const LLUUID& motion) const;
         AOSet::AOState* getStateForMotion(const LLUUID& motion) const;
@@ -119,7 +119,16 @@ AOSet::AOSet(const LLUUID inventoryID)
         mStates[index].mCycleTime = 0;
         mStates[index].mDirty = false;
         mStateNames.emplace_back(stateNameList[0]);
+        mRemapIndex.emplace_back(stateUUIDs[index], index);
     }
+
+    // several states share a remap ID, the first one of them wins like it did with the linear search
+    std::stable_sort(mRemapIndex.begin(), mRemapIndex.end(),
+                     [](const std::pair<LLUUID, S32>& a, const std::pair<LLUUID, S32>& b) { return a.first < b.first; });
+    mRemapIndex.erase(std::unique(mRemapIndex.begin(), mRemapIndex.end(),
+                                  [](const std::pair<LLUUID, S32>& a, const std::pair<LLUUID, S32>& b) { return a.first == b.first; }),
+                      mRemapIndex.end());
+
     stopTimer();
 }
 
@@ -157,12 +166,12 @@ AOSet::AOState* AOSet::getStateByRemapID(const LLUUID& id)
         remap_id = ANIM_AGENT_SIT_GROUND_CONSTRAINED;
     }
 
-    for (S32 index = 0; index < AOSTATES_MAX; ++index)
+    // called for every animation the agent starts or stops, so look it up rather than scan
+    auto it = std::lower_bound(mRemapIndex.begin(), mRemapIndex.end(), remap_id,
+                               [](const std::pair<LLUUID, S32>& entry, const LLUUID& id) { return entry.first < id; });
+    if (it != mRemapIndex.end() && it->first == remap_id)
     {
-        if (mStates[index].mRemapID == remap_id)
-        {
-            return &mStates[index];
-        }
+        return &mStates[it->second];
     }
     return nullptr;
 }
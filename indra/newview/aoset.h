@@ -140,6 +140,9 @@ class AOSet
         bool mDirty;
 
         AOState mStates[AOSTATES_MAX];
+
+        // remap ID -> index in mStates, sorted by ID for getStateByRemapID()
+        std::vector<std::pair<LLUUID, S32>> mRemapIndex;
 };
 
 #endif // AOSET_H
@@ -25,9 +25,15 @@
 in vec4 weight4;
 
 uniform mat3x4 matrixPalette[MAX_JOINTS_PER_MESH_OBJECT];
+uniform int skin_cached; // vertices were already skinned by avatar/skinCacheC.glsl
 
 mat4 getObjectSkinnedTransform()
 {
+    if (skin_cached != 0)
+    {
+        return mat4(1.0);
+    }
+
     int i;
 
     vec4 w = fract(weight4);
@@ -0,0 +1,98 @@
+/**
+ * @file skinCacheC.glsl
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+/*[EXTRA_CODE_HERE]*/
+
+// skins a range of rigged vertices once so every pass that draws them this frame can skip
+// the matrix palette (see LLGPUSkinning and skin_cached in objectSkinV.glsl)
+
+layout(local_size_x = 64) in;
+
+// vertex data of the source LLVertexBuffer, every attribute read here is a vec4
+layout(std430, binding = 0) readonly buffer SourceVertices
+{
+    vec4 src[];
+};
+
+// positions, normals and tangents, each an array of vertex_count vec4s
+layout(std430, binding = 1) writeonly buffer SkinnedVertices
+{
+    vec4 dst[];
+};
+
+// matrix palettes packed the same way as the matrixPalette uniform, 3 vec4s per joint
+layout(std430, binding = 2) readonly buffer Palettes
+{
+    vec4 palette[];
+};
+
+uniform ivec4 src_offsets; // position, normal, tangent, weight4 offsets into src in vec4s, tangent < 0 if absent
+uniform int vertex_count;    // vertex count of the source buffer
+uniform int vertex_start;
+uniform int vertex_end;
+uniform int palette_offset;  // first vec4 of this mesh's palette
+uniform int joint_count;
+
+void main()
+{
+    int v = vertex_start + int(gl_GlobalInvocationID.x);
+    if (v > vertex_end)
+    {
+        return;
+    }
+
+    // same weighting as getObjectSkinnedTransform
+    vec4 weight4 = src[src_offsets.w + v];
+    vec4 w = fract(weight4);
+    vec4 index = clamp(floor(weight4), vec4(0.0), vec4(joint_count - 1));
+
+    w *= 1.0 / (w.x + w.y + w.z + w.w);
+
+    mat3 mat = mat3(0.0);
+    vec3 trans = vec3(0.0);
+
+    for (int i = 0; i < 4; ++i)
+    {
+        int j = palette_offset + int(index[i]) * 3;
+        vec4 c0 = palette[j];
+        vec4 c1 = palette[j + 1];
+        vec4 c2 = palette[j + 2];
+
+        mat += mat3(c0.xyz, c1.xyz, c2.xyz) * w[i];
+        trans += vec3(c0.w, c1.w, c2.w) * w[i];
+    }
+
+    vec4 pos = src[src_offsets.x + v];
+    dst[v] = vec4(mat * pos.xyz + trans, pos.w);
+
+    // normals and tangents are directions, translation doesn't apply
+    dst[vertex_count + v] = vec4(mat * src[src_offsets.y + v].xyz, 0.0);
+
+    if (src_offsets.z >= 0)
+    {
+        vec4 t = src[src_offsets.z + v];
+        dst[vertex_count * 2 + v] = vec4(mat * t.xyz, t.w);
+    }
+}
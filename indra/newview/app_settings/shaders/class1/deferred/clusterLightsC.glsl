@@ -0,0 +1,105 @@
+/**
+ * @file clusterLightsC.glsl
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+/*[EXTRA_CODE_HERE]*/
+
+// bins local lights into view space clusters for clusterLightF.glsl
+// the view frustum is cut into CLUSTER_X by CLUSTER_Y screen tiles and CLUSTER_Z exponentially spaced depth slices,
+// one invocation per cluster tests every light's bounding sphere against the cluster's bounding box
+
+layout(local_size_x = 64) in;
+
+layout(std430, binding = 0) readonly buffer LightData
+{
+    vec4 light_data[]; // pairs of view space position + radius, linear color + falloff
+};
+
+layout(std430, binding = 1) writeonly buffer ClusterCount
+{
+    uint cluster_count[];
+};
+
+layout(std430, binding = 2) writeonly buffer ClusterLights
+{
+    uint cluster_lights[]; // CLUSTER_MAX_LIGHTS slots per cluster
+};
+
+uniform int light_count;
+uniform mat4 inv_proj;
+uniform vec2 cluster_depth; // near and far depth of the cluster grid
+
+vec3 clusterCorner(vec2 ndc, float depth)
+{
+    vec4 p = inv_proj * vec4(ndc, -1.0, 1.0);
+    p.xyz /= p.w;
+    return p.xyz * (depth / -p.z);
+}
+
+void main()
+{
+    uint cluster = gl_GlobalInvocationID.x;
+    if (cluster >= uint(CLUSTER_X * CLUSTER_Y * CLUSTER_Z))
+    {
+        return;
+    }
+
+    uint x = cluster % uint(CLUSTER_X);
+    uint y = (cluster / uint(CLUSTER_X)) % uint(CLUSTER_Y);
+    uint z = cluster / uint(CLUSTER_X * CLUSTER_Y);
+
+    vec2 ndc_min = vec2(x, y) / vec2(CLUSTER_X, CLUSTER_Y) * 2.0 - 1.0;
+    vec2 ndc_max = vec2(x + 1u, y + 1u) / vec2(CLUSTER_X, CLUSTER_Y) * 2.0 - 1.0;
+
+    float ratio = cluster_depth.y / cluster_depth.x;
+    float near_depth = cluster_depth.x * pow(ratio, float(z) / float(CLUSTER_Z));
+    float far_depth = cluster_depth.x * pow(ratio, float(z + 1u) / float(CLUSTER_Z));
+
+    vec3 box_min = vec3(1e30);
+    vec3 box_max = vec3(-1e30);
+
+    for (int i = 0; i < 8; ++i)
+    {
+        vec2 ndc = vec2((i & 1) != 0 ? ndc_max.x : ndc_min.x, (i & 2) != 0 ? ndc_max.y : ndc_min.y);
+        vec3 p = clusterCorner(ndc, (i & 4) != 0 ? far_depth : near_depth);
+        box_min = min(box_min, p);
+        box_max = max(box_max, p);
+    }
+
+    uint count = 0u;
+    uint base = cluster * uint(CLUSTER_MAX_LIGHTS);
+
+    for (int i = 0; i < light_count && count < uint(CLUSTER_MAX_LIGHTS); ++i)
+    {
+        vec4 light = light_data[i * 2];
+        vec3 d = light.xyz - clamp(light.xyz, box_min, box_max);
+        if (dot(d, d) <= light.w * light.w)
+        {
+            cluster_lights[base + count] = uint(i);
+            ++count;
+        }
+    }
+
+    cluster_count[cluster] = count;
+}
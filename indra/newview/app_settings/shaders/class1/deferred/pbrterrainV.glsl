@@ -39,6 +39,9 @@ uniform mat4 modelview_projection_matrix;
 uniform float region_scale;
 #endif
 
+#ifdef TERRAIN_HEIGHTFIELD
+void terrainHeightfieldVertex(out vec3 pos, out vec3 norm, out vec2 tc);
+#else
 in vec3 position;
 in vec3 normal;
 in vec4 tangent;
@@ -46,6 +49,7 @@ in vec4 diffuse_color;
 #if TERRAIN_PAINT_TYPE == TERRAIN_PAINT_TYPE_HEIGHTMAP_WITH_NOISE
 in vec2 texcoord1;
 #endif
+#endif
 
 out vec3 vary_position;
 out vec3 vary_normal;
@@ -80,6 +84,15 @@ vec4 terrain_tangent_space_transform(vec4 vertex_tangent, vec3 vertex_normal, ve
 
 void main()
 {
+#ifdef TERRAIN_HEIGHTFIELD
+    vec3 position;
+    vec3 normal;
+    vec2 texcoord1;
+    terrainHeightfieldVertex(position, normal, texcoord1);
+    // matches gen_terrain_tangents, texture u runs along region x
+    vec4 tangent = vec4(normalize(vec3(1.0, 0.0, 0.0) - normal * normal.x), 1.0);
+#endif
+
     //transform vertex
     gl_Position = modelview_projection_matrix * vec4(position.xyz, 1.0);
     vary_position = (modelview_matrix*vec4(position.xyz, 1.0)).xyz;
@@ -0,0 +1,63 @@
+/**
+ * @file class1/deferred/terrainHeightfieldUtilV.glsl
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+// Displacement of the shared terrain node grid, see LLTerrainHeightfield
+
+uniform sampler2D heightfield_map;  // r: height, g: composition, b: noise, one texel per grid point
+uniform vec3 heightfield_node;      // xy: node origin in region space, z: meters per node grid cell
+uniform vec2 heightfield_morph;     // x: distance where morphing starts, y: 1 / morph distance
+uniform vec3 heightfield_camera;    // region space
+uniform vec2 heightfield_scale;     // x: meters per grid point, y: 1 / texels per edge
+
+in vec3 position;                   // node grid vertex, xy in [0, 16]
+
+vec4 terrainHeightfieldSample(vec2 p)
+{
+    vec2 tc = (p / heightfield_scale.x + 0.5) * heightfield_scale.y;
+    return textureLod(heightfield_map, tc, 0.0);
+}
+
+// Region space position, normal and composition/noise texcoord of this vertex
+void terrainHeightfieldVertex(out vec3 pos, out vec3 norm, out vec2 tc)
+{
+    vec2 grid = position.xy;
+    vec2 p = heightfield_node.xy + grid * heightfield_node.z;
+
+    // move odd vertices onto the next coarser grid as the camera moves away
+    float dist = distance(vec3(p, terrainHeightfieldSample(p).r), heightfield_camera);
+    float morph = clamp((dist - heightfield_morph.x) * heightfield_morph.y, 0.0, 1.0);
+    grid -= fract(grid * 0.5) * 2.0 * morph;
+    p = heightfield_node.xy + grid * heightfield_node.z;
+
+    vec4 texel = terrainHeightfieldSample(p);
+    pos = vec3(p, texel.r);
+    tc = texel.gb;
+
+    // central differences over one node grid cell, smoother at coarse levels like patch normals
+    vec2 d = vec2(max(heightfield_node.z, heightfield_scale.x), 0.0);
+    float dx = terrainHeightfieldSample(p + d.xy).r - terrainHeightfieldSample(p - d.xy).r;
+    float dy = terrainHeightfieldSample(p + d.yx).r - terrainHeightfieldSample(p - d.yx).r;
+    norm = normalize(vec3(-dx, -dy, 2.0 * d.x));
+}
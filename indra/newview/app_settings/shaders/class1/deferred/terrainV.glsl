@@ -28,10 +28,14 @@ uniform mat4 texture_matrix0;
 uniform mat4 modelview_matrix;
 uniform mat4 modelview_projection_matrix;
 
+#ifdef TERRAIN_HEIGHTFIELD
+void terrainHeightfieldVertex(out vec3 pos, out vec3 norm, out vec2 tc);
+#else
 in vec3 position;
 in vec3 normal;
 in vec4 diffuse_color;
 in vec2 texcoord1;
+#endif
 
 out vec3 pos;
 out vec3 vary_normal;
@@ -57,6 +61,13 @@ vec2 texgen_object(vec4 vpos, mat4 mat, vec4 tp0, vec4 tp1)
 
 void main()
 {
+#ifdef TERRAIN_HEIGHTFIELD
+    vec3 position;
+    vec3 normal;
+    vec2 texcoord1;
+    terrainHeightfieldVertex(position, normal, texcoord1);
+#endif
+
     //transform vertex
     vec4 pre_pos = vec4(position.xyz, 1.0);
     vec4 t_pos = modelview_projection_matrix * pre_pos;
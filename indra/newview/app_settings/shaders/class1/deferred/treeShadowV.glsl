@@ -29,12 +29,32 @@ uniform mat4 modelview_projection_matrix;
 in vec3 position;
 in vec2 texcoord0;
 
+#ifdef TREE_INSTANCED
+// rows of the agent space transform of each instance, see LLDrawPoolTree
+layout (std140) uniform TreeInstances
+{
+    vec4 tree_instances[MAX_TREE_INSTANCES*3];
+};
+
+vec3 treeInstanceTransform(vec4 v)
+{
+    int i = gl_InstanceID*3;
+    return vec3(dot(tree_instances[i], v), dot(tree_instances[i+1], v), dot(tree_instances[i+2], v));
+}
+#endif
+
 out vec2 vary_texcoord0;
 
 void main()
 {
+#ifdef TREE_INSTANCED
+    vec3 pos = treeInstanceTransform(vec4(position.xyz, 1.0));
+#else
+    vec3 pos = position.xyz;
+#endif
+
     //transform vertex
-    gl_Position = modelview_projection_matrix*vec4(position.xyz, 1.0);
+    gl_Position = modelview_projection_matrix*vec4(pos, 1.0);
 
     vary_texcoord0 = (texture_matrix0 * vec4(texcoord0,0,1)).xy;
 }
@@ -242,12 +242,24 @@ layout (std140) uniform GLTFNodes
     mat3x4 gltf_nodes[MAX_NODES_PER_GLTF_OBJECT];
 };
 
+// node index of each instance of an instanced draw, four to an ivec4
+layout (std140) uniform GLTFInstances
+{
+    ivec4 gltf_instance_nodes[MAX_GLTF_INSTANCES/4];
+};
+
+// negative when drawing instanced, the node comes from gltf_instance_nodes instead
 uniform int gltf_node_id = 0;
 
 mat4 getGLTFTransform()
 {
     mat4 ret;
-    mat3x4 src = gltf_nodes[gltf_node_id];
+    int node_id = gltf_node_id;
+    if (node_id < 0)
+    {
+        node_id = gltf_instance_nodes[gl_InstanceID >> 2][gl_InstanceID & 3];
+    }
+    mat3x4 src = gltf_nodes[node_id];
 
     ret[0] = vec4(src[0].xyz, 0);
     ret[1] = vec4(src[1].xyz, 0);
@@ -0,0 +1,50 @@
+/**
+ * @file alpharampF.glsl
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+out vec4 frag_color;
+
+uniform sampler2D diffuseMap;
+
+// x: ramp scale, y: ramp bias, z: step threshold (used when x is 0)
+uniform vec3 alpha_ramp;
+
+in vec2 vary_texcoord0;
+in vec4 vertex_color;
+
+void main()
+{
+    float a = texture(diffuseMap, vary_texcoord0.xy).a;
+
+    if (alpha_ramp.x > 0.0)
+    {
+        a = clamp(a * alpha_ramp.x + alpha_ramp.y, 0.0, 1.0);
+    }
+    else
+    {
+        a = step(alpha_ramp.z, a);
+    }
+
+    frag_color = vec4(0, 0, 0, vertex_color.a * a);
+}
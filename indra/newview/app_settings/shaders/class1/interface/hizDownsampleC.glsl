@@ -0,0 +1,65 @@
+/**
+ * @file hizDownsampleC.glsl
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+/*[EXTRA_CODE_HERE]*/
+
+// builds one level of the hierarchical depth buffer used by occlusionCullC.glsl
+// each texel holds the farthest depth of the source texels it covers
+
+layout(local_size_x = 8, local_size_y = 8) in;
+
+uniform sampler2D depthMap; // scene depth for level 0, the previous hi-z level otherwise
+uniform int src_level;
+
+layout(r32f, binding = 0) writeonly uniform image2D hiz_dst;
+
+void main()
+{
+    ivec2 dst = ivec2(gl_GlobalInvocationID.xy);
+    ivec2 dst_size = imageSize(hiz_dst);
+
+    if (any(greaterThanEqual(dst, dst_size)))
+    {
+        return;
+    }
+
+    ivec2 src_size = textureSize(depthMap, src_level);
+    ivec2 src = dst * 2;
+
+    // odd source dimensions fold the leftover row/column into the last texel
+    ivec2 last = src + 1 + ivec2(equal(dst, dst_size - 1)) * (src_size & 1);
+    last = min(last, src_size - 1);
+
+    float depth = 0.0;
+    for (int y = src.y; y <= last.y; ++y)
+    {
+        for (int x = src.x; x <= last.x; ++x)
+        {
+            depth = max(depth, texelFetch(depthMap, ivec2(x, y), src_level).r);
+        }
+    }
+
+    imageStore(hiz_dst, dst, vec4(depth));
+}
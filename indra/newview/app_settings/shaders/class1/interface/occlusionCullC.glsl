@@ -0,0 +1,125 @@
+/**
+ * @file occlusionCullC.glsl
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+/*[EXTRA_CODE_HERE]*/
+
+// tests spatial group bounding boxes against the view frustum and the
+// hierarchical depth buffer built by hizDownsampleC.glsl
+// writes one visibility bit per box, 32 boxes per work group
+
+layout(local_size_x = 32) in;
+
+layout(std430, binding = 0) readonly buffer CullBounds
+{
+    vec4 bounds[]; // center, half size pairs in agent space
+};
+
+layout(std430, binding = 1) writeonly buffer CullVisibility
+{
+    uint visibility[];
+};
+
+uniform mat4 modelview_projection_matrix;
+uniform sampler2D depthMap; // hi-z pyramid
+uniform int box_count;
+uniform int hiz_levels;
+
+shared uint group_mask;
+
+bool isVisible(vec3 center, vec3 size)
+{
+    vec3 rect_min = vec3(1e30);
+    vec3 rect_max = vec3(-1e30);
+
+    for (int i = 0; i < 8; ++i)
+    {
+        vec3 corner = vec3((i & 1) != 0 ? 1.0 : -1.0,
+                           (i & 2) != 0 ? 1.0 : -1.0,
+                           (i & 4) != 0 ? 1.0 : -1.0);
+        vec4 clip = modelview_projection_matrix * vec4(center + size * corner, 1.0);
+
+        if (clip.w <= 0.0)
+        { // box straddles the camera plane, can't be culled
+            return true;
+        }
+
+        vec3 ndc = clip.xyz / clip.w;
+        rect_min = min(rect_min, ndc);
+        rect_max = max(rect_max, ndc);
+    }
+
+    // frustum
+    if (any(lessThan(rect_max.xy, vec2(-1.0))) ||
+        any(greaterThan(rect_min.xy, vec2(1.0))) ||
+        rect_min.z > 1.0)
+    {
+        return false;
+    }
+
+    vec2 uv_min = clamp(rect_min.xy * 0.5 + 0.5, 0.0, 1.0);
+    vec2 uv_max = clamp(rect_max.xy * 0.5 + 0.5, 0.0, 1.0);
+    float nearest = rect_min.z * 0.5 + 0.5;
+
+    // pick the level where the box covers at most 2x2 texels
+    vec2 extent = (uv_max - uv_min) * vec2(textureSize(depthMap, 0));
+    int level = clamp(int(ceil(log2(max(max(extent.x, extent.y), 1.0)))), 0, hiz_levels - 1);
+
+    ivec2 size = textureSize(depthMap, level);
+    ivec2 lo = clamp(ivec2(uv_min * vec2(size)), ivec2(0), size - 1);
+    ivec2 hi = clamp(ivec2(uv_max * vec2(size)), ivec2(0), size - 1);
+
+    float farthest = 0.0;
+    for (int y = lo.y; y <= hi.y; ++y)
+    {
+        for (int x = lo.x; x <= hi.x; ++x)
+        {
+            farthest = max(farthest, texelFetch(depthMap, ivec2(x, y), level).r);
+        }
+    }
+
+    return nearest <= farthest;
+}
+
+void main()
+{
+    uint idx = gl_GlobalInvocationID.x;
+
+    if (gl_LocalInvocationIndex == 0u)
+    {
+        group_mask = 0u;
+    }
+    barrier();
+
+    if (idx < uint(box_count) && isVisible(bounds[idx * 2u].xyz, bounds[idx * 2u + 1u].xyz))
+    {
+        atomicOr(group_mask, 1u << gl_LocalInvocationIndex);
+    }
+    barrier();
+
+    if (gl_LocalInvocationIndex == 0u)
+    {
+        visibility[gl_WorkGroupID.x] = group_mask;
+    }
+}
@@ -0,0 +1,207 @@
+/**
+ * @file clusterLightF.glsl
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+/*[EXTRA_CODE_HERE]*/
+
+#extension GL_ARB_shader_storage_buffer_object : require
+
+// full screen pass that shades every local point light binned by clusterLightsC.glsl
+// per light shading matches multiPointLightF.glsl
+
+out vec4 frag_color;
+
+uniform sampler2D diffuseRect;
+uniform sampler2D specularRect;
+uniform sampler2D emissiveRect; // PBR linear packed Occlusion, Roughness, Metal. See: pbropaqueF.glsl
+uniform sampler2D     lightFunc;
+
+uniform vec2  screen_res;
+uniform vec2  cluster_depth; // near and far depth of the cluster grid
+uniform int   cluster_debug; // show lights per cluster instead of lighting
+
+layout(std430, binding = 0) readonly buffer LightData
+{
+    vec4 light_data[]; // pairs of view space position + radius, linear color + falloff
+};
+
+layout(std430, binding = 1) readonly buffer ClusterCount
+{
+    uint cluster_count[];
+};
+
+layout(std430, binding = 2) readonly buffer ClusterLights
+{
+    uint cluster_lights[];
+};
+
+in vec4 vary_fragcoord;
+
+void calcHalfVectors(vec3 lv, vec3 n, vec3 v, out vec3 h, out vec3 l, out float nh, out float nl, out float nv, out float vh, out float lightDist);
+float calcLegacyDistanceAttenuation(float distance, float falloff);
+vec4 getPosition(vec2 pos_screen);
+vec4 getNorm(vec2 screenpos);
+vec2 getScreenCoord(vec4 clip);
+vec3 srgb_to_linear(vec3 c);
+vec3 hue_to_rgb(float hue);
+
+vec3 pbrPunctual(vec3 diffuseColor, vec3 specularColor,
+                    float perceptualRoughness,
+                    float metallic,
+                    vec3 n, // normal
+                    vec3 v, // surface point to camera
+                    vec3 l); //surface point to light
+
+int getCluster(vec2 tc, float depth)
+{
+    ivec2 tile = clamp(ivec2(tc * vec2(CLUSTER_X, CLUSTER_Y)), ivec2(0), ivec2(CLUSTER_X - 1, CLUSTER_Y - 1));
+    int slice = int(floor(log(depth / cluster_depth.x) / log(cluster_depth.y / cluster_depth.x) * float(CLUSTER_Z)));
+    slice = clamp(slice, 0, CLUSTER_Z - 1);
+    return tile.x + (tile.y + slice * CLUSTER_Y) * CLUSTER_X;
+}
+
+void main()
+{
+    vec3 final_color = vec3(0, 0, 0);
+    vec2 tc          = getScreenCoord(vary_fragcoord);
+    vec3 pos         = getPosition(tc).xyz;
+
+    float depth = -pos.z;
+    if (depth < cluster_depth.x || depth > cluster_depth.y)
+    {
+        discard;
+    }
+
+    int cluster = getCluster(tc, depth);
+    int count = int(cluster_count[cluster]);
+    int base = cluster * CLUSTER_MAX_LIGHTS;
+
+    if (cluster_debug != 0)
+    {
+        float fill = float(count) / float(CLUSTER_MAX_LIGHTS);
+        frag_color.rgb = count > 0 ? hue_to_rgb(0.66 - fill * 0.66) * 0.25 : vec3(0);
+        frag_color.a = 0.0;
+        return;
+    }
+
+    if (count == 0)
+    {
+        discard;
+    }
+
+    vec4 norm = getNorm(tc); // need `norm.w` for GET_GBUFFER_FLAG()
+    vec3 n = norm.xyz;
+
+    vec4 spec    = texture(specularRect, tc);
+    vec3 diffuse = texture(diffuseRect, tc).rgb;
+
+    vec3  h, l, v = -normalize(pos);
+    float nh, nv, vh, lightDist;
+
+    if (GET_GBUFFER_FLAG(GBUFFER_FLAG_HAS_PBR))
+    {
+        vec3 orm = spec.rgb;
+        float perceptualRoughness = orm.g;
+        float metallic = orm.b;
+        vec3 f0 = vec3(0.04);
+        vec3 baseColor = diffuse.rgb;
+
+        vec3 diffuseColor = baseColor.rgb*(vec3(1.0)-f0);
+        diffuseColor *= 1.0 - metallic;
+
+        vec3 specularColor = mix(f0, baseColor.rgb, metallic);
+
+        for (int i = 0; i < count; ++i)
+        {
+            int   light_idx  = int(cluster_lights[base + i]) * 2;
+            vec4  light      = light_data[light_idx];
+            vec4  light_col  = light_data[light_idx + 1];
+            vec3  lv         = light.xyz - pos;
+
+            lightDist = length(lv);
+
+            float dist = lightDist / light.w;
+            if (dist <= 1.0)
+            {
+                lv /= lightDist;
+
+                float dist_atten = calcLegacyDistanceAttenuation(dist, light_col.a);
+
+                vec3 intensity = dist_atten * light_col.rgb * 3.25;
+
+                final_color += intensity*pbrPunctual(diffuseColor, specularColor, perceptualRoughness, metallic, n.xyz, v, lv);
+            }
+        }
+    }
+    else
+    {
+        diffuse = srgb_to_linear(diffuse);
+        spec.rgb = srgb_to_linear(spec.rgb);
+
+        for (int i = 0; i < count; ++i)
+        {
+            int   light_idx = int(cluster_lights[base + i]) * 2;
+            vec4  light     = light_data[light_idx];
+            vec4  light_col = light_data[light_idx + 1];
+            vec3  lv        = light.xyz - pos;
+            float dist      = length(lv);
+            dist /= light.w;
+            if (dist <= 1.0)
+            {
+                float nl = dot(n, lv);
+                if (nl > 0.0)
+                {
+                    float lightDist;
+                    calcHalfVectors(lv, n, v, h, l, nh, nl, nv, vh, lightDist);
+
+                    float dist_atten = calcLegacyDistanceAttenuation(dist, light_col.a);
+
+                    float lit = nl * dist_atten;
+
+                    vec3 col = light_col.rgb * lit * diffuse;
+
+                    if (spec.a > 0.0)
+                    {
+                        lit        = min(nl * 6.0, 1.0) * dist_atten;
+                        float fres = pow(1 - vh, 5) * 0.4 + 0.5;
+
+                        float gtdenom = 2 * nh;
+                        float gt      = max(0, min(gtdenom * nv / vh, gtdenom * nl / vh));
+
+                        if (nh > 0.0)
+                        {
+                            float scol = fres * texture(lightFunc, vec2(nh, spec.a)).r * gt / (nh * nl);
+                            col += lit * scol * light_col.rgb * spec.rgb;
+                        }
+                    }
+
+                    final_color += col;
+                }
+            }
+        }
+    }
+
+    frag_color.rgb = max(final_color, vec3(0));
+    frag_color.a   = 0.0;
+}
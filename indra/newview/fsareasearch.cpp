@@ -40,6 +40,7 @@
 #include "llviewercontrol.h"
 #include "llviewerparcelmgr.h"
 #include <boost/algorithm/string/find.hpp> //for boost::ifind_first
+#include <set>
 #include "llviewerregion.h"
 #include "llselectmgr.h"
 #include "llcallbacklist.h"
@@ -81,6 +82,15 @@ constexpr F32 MIN_DISTANCE_MOVED = 1.0f;
 // timeout to resend object properties request again
 constexpr F32 REQUEST_TIMEOUT = 30.0f;
 
+// Object properties are kept after the floater closes and across region crossings, for
+// as long as we stay connected to the object's region.  Reopening the search or moving
+// on to a neighbor doesn't have to ask the simulator about every object again.
+static std::map<LLUUID, FSObjectProperties>& getObjectDetailsCache()
+{
+    static std::map<LLUUID, FSObjectProperties> object_details;
+    return object_details;
+}
+
 static std::string RLVa_hideNameIfRestricted(std::string_view name)
 {
     if (!gRlvHandler.hasBehaviour(RLV_BHVR_SHOWNAMES))
@@ -144,6 +154,7 @@ private:
 
 FSAreaSearch::FSAreaSearch(const LLSD& key) :
     LLFloater(key),
+    mObjectDetails(getObjectDetailsCache()),
     mActive(false),
     mFilterForSale(false),
     mFilterForSaleMin(0),
@@ -186,6 +197,9 @@ FSAreaSearch::FSAreaSearch(const LLSD& key) :
 
     mParcelChangedObserver = std::make_unique<FSParcelChangeObserver>(this);
     LLViewerParcelMgr::getInstance()->addObserver(mParcelChangedObserver.get());
+
+    // requests sent by an earlier search went unanswered once it closed
+    pruneObjectDetails();
 }
 
 FSAreaSearch::~FSAreaSearch()
@@ -278,6 +292,7 @@ void FSAreaSearch::idle(void* user_data)
     FSAreaSearch* self = (FSAreaSearch*)user_data;
     self->findObjects();
     self->processRequestQueue();
+    self->processPendingNames();
 }
 
 // static
@@ -349,7 +364,7 @@ void FSAreaSearch::checkRegion()
             }
             mLastRegion = region;
             mRequested = 0;
-            mObjectDetails.clear();
+            pruneObjectDetails();
             mRegionRequests.clear();
             mLastPropertiesReceivedTimer.start();
             mPanelList->getResultList()->deleteAllItems();
@@ -360,6 +375,34 @@ void FSAreaSearch::checkRegion()
     }
 }
 
+// Drop the properties of objects in regions we are no longer connected to, and
+// ask again for those that were requested but haven't arrived
+void FSAreaSearch::pruneObjectDetails()
+{
+    std::set<U64> region_handles;
+    for (const auto regionp : LLWorld::getInstance()->getRegionList())
+    {
+        region_handles.insert(regionp->getHandle());
+    }
+
+    for (auto object_it = mObjectDetails.begin(); object_it != mObjectDetails.end(); )
+    {
+        FSObjectProperties& details = object_it->second;
+        if (!region_handles.count(details.region_handle))
+        {
+            object_it = mObjectDetails.erase(object_it);
+            continue;
+        }
+
+        details.listed = false;
+        if (details.request == FSObjectProperties::SENT)
+        {
+            details.request = FSObjectProperties::NEED;
+        }
+        ++object_it;
+    }
+}
+
 void FSAreaSearch::refreshList(bool cache_clear)
 {
     mActive = true;
@@ -444,6 +487,16 @@ void FSAreaSearch::findObjects()
             if (details.request == FSObjectProperties::FINISHED)
             {
                 matchObject(details, objectp);
+
+                // the object changed since its properties arrived, they may have as well
+                if (details.crc != objectp->getCRC())
+                {
+                    details.request = FSObjectProperties::NEED;
+                    details.local_id = objectp->getLocalID();
+                    details.region_handle = objectp->getRegion()->getHandle();
+                    mRequestNeedsSent = true;
+                    mRequested++;
+                }
             }
 
             if (details.request == FSObjectProperties::FAILED)
@@ -725,6 +778,8 @@ void FSAreaSearch::processObjectProperties(LLMessageSystem* msg)
             {
                 // Recieved object properties without requesting it.
                 details.id = object_id;
+                details.local_id = objectp->getLocalID();
+                details.region_handle = objectp->getRegion() ? objectp->getRegion()->getHandle() : 0;
             }
             else
             {
@@ -756,6 +811,9 @@ void FSAreaSearch::processObjectProperties(LLMessageSystem* msg)
             msg->getStringFast(_PREHASH_ObjectData, _PREHASH_TouchName, details.touch_name, i);
             msg->getStringFast(_PREHASH_ObjectData, _PREHASH_SitName, details.sit_name, i);
 
+            details.crc = objectp->getCRC();
+
+            details.texture_ids.clear();
             S32 size = msg->getSizeFast(_PREHASH_ObjectData, i, _PREHASH_TextureID);
             if (size > 0)
             {
@@ -1128,9 +1186,8 @@ void FSAreaSearch::getNameFromUUID(const LLUUID& id, std::string& name, bool gro
         if (!gCacheName->getIfThere(id, name, is_group))
         {
             name = unknown_name;
-            if (std::find(mNamesRequested.begin(), mNamesRequested.end(), id) == mNamesRequested.end())
+            if (mNamesRequested.insert(id).second)
             {
-                mNamesRequested.push_back(id);
                 boost::signals2::connection cb_connection = gCacheName->get(id, group, boost::bind(&FSAreaSearch::callbackLoadFullName, this, _1, _2));
                 mNameCacheConnections.insert(std::make_pair(id, cb_connection)); // mNamesRequested will do the dupe check
             }
@@ -1143,9 +1200,8 @@ void FSAreaSearch::getNameFromUUID(const LLUUID& id, std::string& name, bool gro
         if (!LLAvatarNameCache::get(id, &av_name))
         {
             name = unknown_name;
-            if (std::find(mNamesRequested.begin(), mNamesRequested.end(), id) == mNamesRequested.end())
+            if (mNamesRequested.insert(id).second)
             {
-                mNamesRequested.push_back(id);
                 boost::signals2::connection cb_connection = LLAvatarNameCache::get(id, boost::bind(&FSAreaSearch::avatarNameCacheCallback, this, _1, _2));
                 mNameCacheConnections.insert(std::make_pair(id, cb_connection)); // mNamesRequested will do the dupe check
             }
@@ -1172,6 +1228,19 @@ void FSAreaSearch::callbackLoadFullName(const LLUUID& id, const std::string& ful
         mNameCacheConnections.erase(iter);
     }
 
+    // Names of a busy region come in by the hundred, rematching every waiting object
+    // and walking every result row for each of them froze the viewer. Collect them
+    // for processPendingNames() instead.
+    mPendingNames[id] = full_name;
+}
+
+void FSAreaSearch::processPendingNames()
+{
+    if (mPendingNames.empty())
+    {
+        return;
+    }
+
     LLViewerRegion* our_region = gAgent.getRegion();
 
     for (auto& entry : mObjectDetails)
@@ -1187,7 +1256,8 @@ void FSAreaSearch::callbackLoadFullName(const LLUUID& id, const std::string& ful
         }
     }
 
-    mPanelList->updateName(id, full_name);
+    mPanelList->updateNames(mPendingNames);
+    mPendingNames.clear();
 }
 
 void FSAreaSearch::updateCounterText()
@@ -1581,14 +1651,14 @@ bool FSPanelAreaSearchList::onEnableColumnVisibilityChecked(const LLSD& userdata
     return (mColumnBits[column] & column_config);
 }
 
-void FSPanelAreaSearchList::updateName(const LLUUID& id, const std::string& name)
+void FSPanelAreaSearchList::updateNames(const std::unordered_map<LLUUID, std::string>& names)
 {
     LLScrollListColumn* creator_column = mResultList->getColumn("creator");
     LLScrollListColumn* owner_column = mResultList->getColumn("owner");
     LLScrollListColumn* group_column = mResultList->getColumn("group");
     LLScrollListColumn* last_owner_column = mResultList->getColumn("last_owner");
 
-    // Iterate over the rows in the list, updating the ones with matching id.
+    // Iterate over the rows in the list once, updating the ones with a matching id.
     std::vector<LLScrollListItem*> items = mResultList->getAllData();
 
     for (const auto item : items)
@@ -1596,31 +1666,31 @@ void FSPanelAreaSearchList::updateName(const LLUUID& id, const std::string& name
         const LLUUID& row_id = item->getUUID();
         FSObjectProperties& details = mFSAreaSearch->mObjectDetails[row_id];
 
-        if (creator_column && (id == details.creator_id))
+        if (auto it = names.find(details.creator_id); creator_column && it != names.end())
         {
             LLScrollListText* creator_text = (LLScrollListText*)item->getColumn(creator_column->mIndex);
-            creator_text->setText(name);
+            creator_text->setText(it->second);
             mResultList->setNeedsSort();
         }
 
-        if (owner_column && (id == details.owner_id))
+        if (auto it = names.find(details.owner_id); owner_column && it != names.end())
         {
             LLScrollListText* owner_text = (LLScrollListText*)item->getColumn(owner_column->mIndex);
-            owner_text->setText(RLVa_hideNameIfRestricted(name));
+            owner_text->setText(RLVa_hideNameIfRestricted(it->second));
             mResultList->setNeedsSort();
         }
 
-        if (group_column && (id == details.group_id))
+        if (auto it = names.find(details.group_id); group_column && it != names.end())
         {
             LLScrollListText* group_text = (LLScrollListText*)item->getColumn(group_column->mIndex);
-            group_text->setText(name);
+            group_text->setText(it->second);
             mResultList->setNeedsSort();
         }
 
-        if (last_owner_column && (id == details.last_owner_id))
+        if (auto it = names.find(details.last_owner_id); last_owner_column && it != names.end())
         {
             LLScrollListText* last_owner_text = (LLScrollListText*)item->getColumn(last_owner_column->mIndex);
-            last_owner_text->setText(RLVa_hideNameIfRestricted(name));
+            last_owner_text->setText(RLVa_hideNameIfRestricted(it->second));
             mResultList->setNeedsSort();
         }
     }
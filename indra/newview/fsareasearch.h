@@ -37,6 +37,8 @@
 #include "llviewerobject.h"
 #include "rlvdefines.h"
 #include <boost/regex.hpp>
+#include <unordered_map>
+#include <unordered_set>
 
 class LLAvatarName;
 class LLTextBox;
@@ -81,6 +83,7 @@ struct FSObjectProperties
     bool name_requested;
     U32 local_id;
     U64 region_handle;
+    U32 crc;    // of the last full object update when the properties arrived
 
     typedef enum e_object_properties_request
     {
@@ -94,7 +97,8 @@ struct FSObjectProperties
     FSObjectProperties() :
         request(NEED),
         listed(false),
-        name_requested(false)
+        name_requested(false),
+        crc(0)
     {
     }
 };
@@ -129,7 +133,8 @@ public:
     bool isSearchableObject (LLViewerObject* objectp, LLViewerRegion* our_region);
     void setFindOwnerText(std::string value);
 
-    std::map<LLUUID, FSObjectProperties> mObjectDetails;
+    // Shared by all searches, see getObjectDetailsCache()
+    std::map<LLUUID, FSObjectProperties>& mObjectDetails;
 
     FSPanelAreaSearchAdvanced* getPanelAdvanced() { return mPanelAdvanced; }
     FSPanelAreaSearchList* getPanelList() { return mPanelList; }
@@ -178,6 +183,8 @@ private:
     bool regexTest(std::string_view text);
     void findObjects();
     void processRequestQueue();
+    void processPendingNames();
+    void pruneObjectDetails();
 
     boost::signals2::connection mRlvBehaviorCallbackConnection;
     void updateRlvRestrictions(ERlvBehaviour behavior);
@@ -208,7 +215,9 @@ private:
     LLFrameTimer mLastUpdateTimer;
     LLFrameTimer mLastPropertiesReceivedTimer;
 
-    uuid_vec_t mNamesRequested;
+    std::unordered_set<LLUUID> mNamesRequested;
+    // names that arrived since the last idle, applied in one pass over the results
+    std::unordered_map<LLUUID, std::string> mPendingNames;
 
     typedef std::map<LLUUID, boost::signals2::connection> name_cache_connection_map_t;
     name_cache_connection_map_t mNameCacheConnections;
@@ -287,7 +296,7 @@ public:
     void setCounterText();
     void setCounterText(LLStringUtil::format_map_t args);
     void updateScrollList();
-    void updateName(const LLUUID& id, const std::string& name);
+    void updateNames(const std::unordered_map<LLUUID, std::string>& names);
     static void touchObject(LLViewerObject* objectp);
 
     FSScrollListCtrl* getResultList() { return mResultList; }
@@ -32,6 +32,7 @@
 
 #include "fsfloaterassetblacklist.h"
 #include "llaudioengine.h"
+#include "llcallbacklist.h"
 #include "llfloaterreg.h"
 #include "llsdserialize.h"
 #include "llfilesystem.h"
@@ -39,6 +40,7 @@
 #include "llviewerobjectlist.h"
 
 const LLUUID MAGIC_ID("3c115e51-04f4-523c-9fa6-98aff1034730");
+constexpr F32 SAVE_DELAY = 2.f;
 
 LLAssetType::EType S32toAssetType(S32 assetindex)
 {
@@ -86,8 +88,7 @@ bool FSAssetBlacklist::isBlacklisted(const LLUUID& id, LLAssetType::EType type)
         return false;
     }
 
-    blacklisted_uuid_container_t uuids = it->second;
-    return (uuids.find(id) != uuids.end());
+    return it->second.find(id) != it->second.end();
 }
 
 void FSAssetBlacklist::addNewItemToBlacklist(const LLUUID& id, const std::string& name, const std::string& region, LLAssetType::EType type, bool permanent /*= true*/, bool save /*= true*/)
@@ -155,7 +156,7 @@ void FSAssetBlacklist::removeItemsFromBlacklist(const uuid_vec_t& ids)
 
         if (need_save)
         {
-            saveBlacklist();
+            scheduleSave();
         }
 
         if (!mBlacklistChangedCallback.empty())
@@ -188,7 +189,7 @@ void FSAssetBlacklist::addNewItemToBlacklistData(const LLUUID& id, const LLSD& d
 
     if (save)
     {
-        saveBlacklist();
+        scheduleSave();
     }
 
     if (!mBlacklistChangedCallback.empty())
@@ -299,8 +300,35 @@ void FSAssetBlacklist::loadBlacklist()
     }
 }
 
+void FSAssetBlacklist::cleanupSingleton()
+{
+    if (mSavePending)
+    {
+        saveBlacklist();
+    }
+}
+
+void FSAssetBlacklist::scheduleSave()
+{
+    if (mSavePending)
+    {
+        return;
+    }
+
+    mSavePending = true;
+    doAfterInterval([]()
+    {
+        if (instanceExists() && instance().mSavePending)
+        {
+            instance().saveBlacklist();
+        }
+    }, SAVE_DELAY);
+}
+
 void FSAssetBlacklist::saveBlacklist()
 {
+    mSavePending = false;
+
     llofstream save_file(mBlacklistFileName.c_str());
     LLSD savedata;
 
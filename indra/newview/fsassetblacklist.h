@@ -52,7 +52,7 @@ public:
     void removeItemsFromBlacklist(const uuid_vec_t& ids);
     void saveBlacklist();
 
-    blacklist_data_t getBlacklistData() const { return mBlacklistData; };
+    const blacklist_data_t& getBlacklistData() const { return mBlacklistData; };
 
     enum class eBlacklistOperation
     {
@@ -67,13 +67,18 @@ public:
     }
 
 private:
+    void cleanupSingleton() override;
+
     void loadBlacklist();
+    // Coalesces the saves of several changes in a row into one write of the file
+    void scheduleSave();
     bool removeItem(const LLUUID& id);
     bool addEntryToBlacklistMap(const LLUUID& id, LLAssetType::EType type);
 
     std::string             mBlacklistFileName;
     blacklist_type_map_t    mBlacklistTypeContainer;
     blacklist_data_t        mBlacklistData;
+    bool                    mSavePending{ false };
 
     blacklist_changed_callback_t mBlacklistChangedCallback;
 };
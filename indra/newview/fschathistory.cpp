@@ -1256,6 +1256,7 @@ FSChatHistory::FSChatHistory(const FSChatHistory::Params& p)
     mChatInputLine(NULL),   // <FS_Zi> FIRE-8602: Typing in chat history focuses chat input line
     mIsLastMessageFromLog(false),
     mScrollToBottom(false),
+    mTrimmedLength(0),
     mUnreadChatSources(0)
 {
     mLineSpacingPixels = llclamp(gSavedSettings.getS32("FSFontChatLineSpacingPixels"), 0, 36);
@@ -1360,6 +1361,31 @@ void FSChatHistory::clear()
     // line was appended. -Zi
     setText(std::string(" \n"));    // <FS:Zi> FIRE-8600: TAB out of chat history
     mLastFromID = LLUUID::null;
+    mMessageStarts.clear();
+    mTrimmedLength = 0;
+}
+
+void FSChatHistory::trimHistory()
+{
+    static LLCachedControl<S32> max_messages(gSavedSettings, "FSChatHistoryMaxMessages", 2000);
+    // Removing text reflows what follows it, so let a few messages pile up and
+    // remove them in one go.  Wait while scrolled back, the text would move
+    // under the reader.
+    const S32 max_count = max_messages();
+    if (max_count <= 0 || (S32)mMessageStarts.size() <= max_count + max_count / 10 || !mScrollToBottom)
+    {
+        return;
+    }
+
+    size_t remove_count = mMessageStarts.size() - max_count;
+    S32 begin = mMessageStarts.front() - mTrimmedLength;
+    S32 end = mMessageStarts[remove_count] - mTrimmedLength;
+    mMessageStarts.erase(mMessageStarts.begin(), mMessageStarts.begin() + remove_count);
+    if (end > begin)
+    {
+        removeStringNoUndo(begin, end - begin);
+        mTrimmedLength += end - begin;
+    }
 }
 
 enum e_moderation_options
@@ -1426,6 +1452,9 @@ void FSChatHistory::appendMessage(const LLChat& chat, const LLSD &args, const LL
     bool from_me = chat.mFromID == gAgent.getID();
     setPlainText(use_plain_text_chat_history);
 
+    trimHistory();
+    mMessageStarts.push_back(getLength() + mTrimmedLength);
+
     if (!scrolledToEnd() && !from_me && !chat.mFromName.empty())
     {
         mUnreadChatSources++;
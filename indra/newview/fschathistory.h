@@ -132,12 +132,19 @@ class FSChatHistory : public LLTextEditor   // <FS:Zi> FIRE-8600: TAB out of cha
         }
 
     private:
+        // Drop the oldest messages once there are more than FSChatHistoryMaxMessages
+        void trimHistory();
+
         std::string mLastFromName;
         LLUUID mLastFromID;
         LLDate mLastMessageTime;
         bool mIsLastMessageFromLog;
         bool mScrollToBottom;
 
+        // Document position of each message, plus mTrimmedLength
+        std::deque<S32> mMessageStarts;
+        S32 mTrimmedLength;
+
         std::string mMessageHeaderFilename;
         std::string mMessageSeparatorFilename;
 
@@ -354,6 +354,23 @@ void FSFloaterPerformance::draw()
             {
                 textbox->setVisible(false);
             }
+
+            // show what auto tune took away from the scene
+            std::string lowered_features;
+            for (const std::string& feature : LLPerfStats::Tunables::getLoweredSceneFeatures())
+            {
+                lowered_features += (lowered_features.empty() ? "" : ", ") + getString("autotune_feature_" + feature);
+            }
+            if (lowered_features.empty())
+            {
+                textbox->setToolTip(LLStringUtil::null);
+            }
+            else
+            {
+                LLStringUtil::format_map_t lowered_args;
+                lowered_args["FEATURES"] = lowered_features;
+                textbox->setToolTip(getString("autotune_lowered", lowered_args));
+            }
 // pre-fill the args
             if(!unreliable)
             {
@@ -730,7 +747,8 @@ void FSFloaterPerformance::populateNearbyList()
 
             S32 complexity_short = llmax((S32)avatar->getVisualComplexity() / 1000, 1);
 
-            F32 render_av_gpu_ms = avatar->getGPURenderTime();
+            // the offscreen profile or what the avatar costs in the scene, whichever is higher
+            F32 render_av_gpu_ms = llmax(avatar->getGPURenderTime(), avatar->getGPUSceneTime());
             LLPerfStats::bufferToggleLock.lock();
             auto render_av_geom  = LLPerfStats::StatsRecorder::get(AvType, avatar->getID(),LLPerfStats::StatType_t::RENDER_GEOMETRY);
             auto render_av_shadow  = LLPerfStats::StatsRecorder::get(AvType, avatar->getID(),LLPerfStats::StatType_t::RENDER_SHADOWS);
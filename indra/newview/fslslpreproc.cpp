@@ -554,63 +554,7 @@ public:
     {
         std::string cfilename = filename.substr(1, filename.length() - 2);
         LL_DEBUGS("FSLSLPreprocessor") << cfilename << ":found_include_directive" << LL_ENDL;
-        std::optional<LLUUID> item_id = FSLSLPreprocessor::findInventoryByName(cfilename);
-        if (item_id.has_value())
-        {
-            LLViewerInventoryItem* item = gInventory.getItem(item_id.value());
-            if (item)
-            {
-                std::map<std::string,LLUUID>::iterator it = mProc->cached_assetids.find(cfilename);
-                bool not_cached = (it == mProc->cached_assetids.end());
-                bool changed = true;
-                if (!not_cached)
-                {
-                    changed = (mProc->cached_assetids[cfilename] != item->getAssetUUID());
-                }
-                if (not_cached || changed)
-                {
-                    std::set<std::string>::iterator it = mProc->caching_files.find(cfilename);
-                    if (it == mProc->caching_files.end())
-                    {
-                        if (not_cached)
-                        {
-                            LLStringUtil::format_map_t args;
-                            args["[FILENAME]"] = cfilename;
-                            mProc->display_message(LLTrans::getString("fs_preprocessor_cache_miss", args));
-                        }
-                        else /*if(changed)*/
-                        {
-                            LLStringUtil::format_map_t args;
-                            args["[FILENAME]"] = cfilename;
-                            mProc->display_message(LLTrans::getString("fs_preprocessor_cache_invalidated", args));
-                        }
-                        //one is always true
-                        mProc->caching_files.insert(cfilename);
-                        ProcCacheInfo* info = new ProcCacheInfo;
-                        info->item = item;
-                        info->self = mProc;
-                        LLPermissions perm(((LLInventoryItem*)item)->getPermissions());
-                        gAssetStorage->getInvItemAsset(LLHost(),
-                                                        gAgentID,
-                                                        gAgentSessionID,
-                                                        perm.getOwner(),
-                                                        LLUUID::null,
-                                                        item->getUUID(),
-                                                        LLUUID::null,
-                                                        item->getType(),
-                                                        &FSLSLPreprocessor::FSProcCacheCallback,
-                                                        info,
-                                                        true);
-                        return true;
-                    }
-                }
-            }
-        }
-        else
-        {
-            //todo check on HDD in user defined dir for file in question
-        }
-        return false;
+        return mProc->request_include(cfilename);
     }
 
     template <typename ContextT>
@@ -689,6 +633,85 @@ private:
     std::stack<std::string> mFileStack;
 };
 
+bool FSLSLPreprocessor::request_include(const std::string& name)
+{
+    std::optional<LLUUID> item_id = findInventoryByName(name);
+    if (!item_id.has_value())
+    {
+        //todo check on HDD in user defined dir for file in question
+        return false;
+    }
+
+    LLViewerInventoryItem* item = gInventory.getItem(item_id.value());
+    if (!item)
+    {
+        return false;
+    }
+
+    std::map<std::string, LLUUID>::iterator it = cached_assetids.find(name);
+    bool not_cached = (it == cached_assetids.end());
+    if (!not_cached && it->second == item->getAssetUUID())
+    {
+        return false;
+    }
+    if (caching_files.find(name) != caching_files.end())
+    {
+        return false;
+    }
+
+    LLStringUtil::format_map_t args;
+    args["[FILENAME]"] = name;
+    if (not_cached)
+    {
+        display_message(LLTrans::getString("fs_preprocessor_cache_miss", args));
+    }
+    else
+    {
+        display_message(LLTrans::getString("fs_preprocessor_cache_invalidated", args));
+    }
+
+    caching_files.insert(name);
+    ProcCacheInfo* info = new ProcCacheInfo;
+    info->item = item;
+    info->self = this;
+    LLPermissions perm(((LLInventoryItem*)item)->getPermissions());
+    gAssetStorage->getInvItemAsset(LLHost(),
+                                    gAgentID,
+                                    gAgentSessionID,
+                                    perm.getOwner(),
+                                    LLUUID::null,
+                                    item->getUUID(),
+                                    LLUUID::null,
+                                    item->getType(),
+                                    &FSLSLPreprocessor::FSProcCacheCallback,
+                                    info,
+                                    true);
+    return true;
+}
+
+void FSLSLPreprocessor::prefetch_includes(const std::string& text, std::set<std::string>& visited)
+{
+    // Includes inside comments or inactive #if blocks are fetched too, an unneeded download beats a pass per include
+    static const boost::regex include_regex("^[ \\t]*#[ \\t]*include[ \\t]*[\"<]([^\">\n]+)[\">]");
+
+    for (boost::sregex_iterator it(text.begin(), text.end(), include_regex), end; it != end; ++it)
+    {
+        std::string name = (*it)[1].str();
+        if (!visited.insert(name).second || request_include(name) || caching_files.count(name) || !cached_assetids.count(name))
+        {
+            continue;
+        }
+
+        // Up to date in the cache, look for what it includes in turn
+        llifstream file(gDirUtilp->getExpandedFilename(LL_PATH_CACHE, "lslpreproc", name).c_str());
+        if (file.is_open())
+        {
+            std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            prefetch_includes(content, visited);
+        }
+    }
+}
+
 void cache_script(std::string name, std::string content)
 {
     content += "\n";/*hack!*/
@@ -745,7 +768,11 @@ void FSLSLPreprocessor::FSProcCacheCallback(const LLUUID& iuuid, LLAssetType::ET
                     }
                     item->setAssetUUID(uuid);
                     self->cached_assetids[name] = uuid;
-                    self->start_process();
+                    // includes are fetched in parallel, wait for the last one
+                    if (self->caching_files.empty())
+                    {
+                        self->start_process();
+                    }
                 }
                 else
                 {
@@ -1152,6 +1179,18 @@ void FSLSLPreprocessor::start_process()
         }
     }
 
+    // Fetch every missing include at once, rather than restarting the whole pass for each include wave runs into
+    if (preprocessor_enabled)
+    {
+        std::set<std::string> visited_includes;
+        prefetch_includes(input, visited_includes);
+        if (!caching_files.empty())
+        {
+            mWaving = false;
+            return;
+        }
+    }
+
     // Convert multiline strings for preprocessor
     if (preprocessor_enabled)
     {
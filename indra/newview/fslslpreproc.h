@@ -65,6 +65,10 @@ public:
     void preprocess_script(bool close = false, bool sync = false, bool defcache = false);
     void preprocess_script(const LLUUID& asset_id, LLScriptQueueData* data, LLAssetType::EType type, const std::string& script_data);
     void start_process();
+    // Starts fetching an include that isn't cached or changed since, returns false if there's nothing to fetch
+    bool request_include(const std::string& name);
+    // Requests every include named in text and, recursively, in the cached include files it names
+    void prefetch_includes(const std::string& text, std::set<std::string>& visited);
     void display_message(std::string_view msg);
     void display_error(std::string_view err);
 
@@ -30,6 +30,7 @@
 
 // libs
 #include "llfiltereditor.h"
+#include "llsdutil.h"
 #include "llmenugl.h"
 #include "lluictrlfactory.h"
 #include "llmenubutton.h"
@@ -325,16 +326,61 @@ void FSPanelRadar::updateList(const std::vector<LLSD>& entries, const LLSD& stat
     // Update list
     mRadarList->setCommentText(RlvActions::canShowNearbyAgents() ? LLStringUtil::null : RlvStrings::getString("blocked_nearby"));
 
-    bool needs_sort = mRadarList->isSorted();
-    mRadarList->setNeedsSort(false);
+    static S32 rangeColumnIndex = mRadarList->getColumn("range")->mIndex;
+    static S32 nameColumnIndex = mRadarList->getColumn("name")->mIndex;
+    static S32 voiceLevelColumnIndex = mRadarList->getColumn("voice_level")->mIndex;
+    static S32 flagsColumnIndex = mRadarList->getColumn("flags")->mIndex;
+    static S32 ageColumnIndex = mRadarList->getColumn("age")->mIndex;
+    static S32 notesColumnIndex = mRadarList->getColumn("has_notes")->mIndex;
+
+    // Rows are updated in place rather than rebuilt, so selection, scroll position and
+    // hover state survive and unchanged avatars cost nothing. Someone else emptied the
+    // list if the counts disagree.
+    if ((size_t)mRadarList->getItemCount() != mRowData.size())
+    {
+        mRadarList->clearRows();
+        mRowData.clear();
+    }
 
-    mRadarList->clearRows();
+    std::map<LLUUID, LLScrollListItem*> rows;
+    for (LLScrollListItem* item : mRadarList->getAllData())
+    {
+        rows[item->getUUID()] = item;
+    }
+
+    bool needs_sort = false;
+    uuid_set_t present_ids;
     for (const auto& avdata : entries)
     {
         constexpr char font_name[] = "SANSSERIF_SMALL";
 
-        LLSD entry = avdata["entry"];
-        LLSD options = avdata["options"];
+        const LLSD& entry = avdata["entry"];
+        const LLSD& options = avdata["options"];
+        LLUUID avatar_id = entry["id"].asUUID();
+        present_ids.insert(avatar_id);
+
+        LLScrollListItem* row = nullptr;
+        auto row_it = rows.find(avatar_id);
+        auto data_it = mRowData.find(avatar_id);
+        if (row_it != rows.end() && data_it != mRowData.end())
+        {
+            if (llsd_equals(data_it->second, avdata))
+            {
+                continue;
+            }
+
+            // A cell's color can't be reset once set, replace rows that lost one
+            const LLSD& old_options = data_it->second["options"];
+            if ((old_options.has("name_color") && !options.has("name_color")) ||
+                (old_options.has("age_color") && !options.has("age_color")))
+            {
+                mRadarList->deleteSingleItem(mRadarList->getItemIndex(row_it->second));
+            }
+            else
+            {
+                row = row_it->second;
+            }
+        }
 
         LLSD row_data;
         row_data["value"] = entry["id"];
@@ -395,13 +441,26 @@ void FSPanelRadar::updateList(const std::vector<LLSD>& entries, const LLSD& stat
         row_data["columns"][10]["column"] = "seen_sort";
         row_data["columns"][10]["value"] = entry["seen"].asString() + "_" + entry["name"].asString();
 
-        LLScrollListItem* row = mRadarList->addElement(row_data);
-
-        static S32 rangeColumnIndex = mRadarList->getColumn("range")->mIndex;
-        static S32 nameColumnIndex = mRadarList->getColumn("name")->mIndex;
-        static S32 voiceLevelColumnIndex = mRadarList->getColumn("voice_level")->mIndex;
-        static S32 flagsColumnIndex = mRadarList->getColumn("flags")->mIndex;
-        static S32 ageColumnIndex = mRadarList->getColumn("age")->mIndex;
+        if (row)
+        {
+            for (const auto& column : llsd::inArray(row_data["columns"]))
+            {
+                LLScrollListColumn* list_column = mRadarList->getColumn(column["column"].asString());
+                LLScrollListCell* cell = list_column ? row->getColumn(list_column->mIndex) : nullptr;
+                // the voice level icon is set separately below
+                if (cell && column.has("value") && column["column"].asString() != "voice_level" &&
+                    cell->getValue().asString() != column["value"].asString())
+                {
+                    cell->setValue(column["value"]);
+                    needs_sort = true;
+                }
+            }
+            row->getColumn(notesColumnIndex)->setToolTip(entry["notes"].asString());
+        }
+        else
+        {
+            row = mRadarList->addElement(row_data);
+        }
 
         LLScrollListText* radarRangeCell = (LLScrollListText*)row->getColumn(rangeColumnIndex);
         radarRangeCell->setColor(LLColor4(options["range_color"]));
@@ -414,16 +473,20 @@ void FSPanelRadar::updateList(const std::vector<LLSD>& entries, const LLSD& stat
             radarNameCell->setColor(LLColor4(options["name_color"]));
         }
 
-        if (entry.has("voice_level_icon"))
+        LLScrollListCell* voiceLevelCell = row->getColumn(voiceLevelColumnIndex);
+        std::string voice_level_icon = entry.has("voice_level_icon") ? entry["voice_level_icon"].asString() : LLStringUtil::null;
+        if (voiceLevelCell->getValue().asString() != voice_level_icon)
         {
-            LLScrollListText* voiceLevelCell = (LLScrollListText*)row->getColumn(voiceLevelColumnIndex);
-            voiceLevelCell->setValue(entry["voice_level_icon"].asString());
+            voiceLevelCell->setValue(voice_level_icon);
+            needs_sort = true;
         }
 
-        if (entry.has("flags"))
+        LLScrollListCell* flagsCell = row->getColumn(flagsColumnIndex);
+        std::string flags = entry.has("flags") ? flagsColumnValues[entry["flags"].asInteger()] : LLStringUtil::null;
+        if (flagsCell->getValue().asString() != flags)
         {
-            LLScrollListText* flagsCell = (LLScrollListText*)row->getColumn(flagsColumnIndex);
-            flagsCell->setValue(flagsColumnValues[entry["flags"].asInteger()]);
+            flagsCell->setValue(flags);
+            needs_sort = true;
         }
 
         if (options.has("age_color"))
@@ -431,9 +494,31 @@ void FSPanelRadar::updateList(const std::vector<LLSD>& entries, const LLSD& stat
             LLScrollListText* ageCell = (LLScrollListText*)row->getColumn(ageColumnIndex);
             ageCell->setColor(LLColor4(options["age_color"]));
         }
+
+        mRowData[avatar_id] = avdata;
     }
 
-    mRadarList->setNeedsSort(needs_sort);
+    // Drop avatars that left
+    for (auto it = mRowData.begin(); it != mRowData.end();)
+    {
+        if (present_ids.count(it->first))
+        {
+            ++it;
+            continue;
+        }
+
+        auto row_it = rows.find(it->first);
+        if (row_it != rows.end())
+        {
+            mRadarList->deleteSingleItem(mRadarList->getItemIndex(row_it->second));
+        }
+        it = mRowData.erase(it);
+    }
+
+    if (needs_sort)
+    {
+        mRadarList->setNeedsSort();
+    }
     mRadarList->updateSort();
 
     LLStringUtil::format_map_t name_count_args;
@@ -494,6 +579,7 @@ void FSPanelRadar::onColumnDisplayModeChanged()
     bool current_sort_asc = mRadarList->getSortAscending();
 
     mRadarList->clearRows();
+    mRowData.clear();
     mRadarList->clearColumns();
     mRadarList->updateLayout();
 
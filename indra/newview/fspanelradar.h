@@ -98,6 +98,8 @@ private:
     std::string             mFilterSubStringOrig;
 
     std::map<std::string, U32> mColumnBits;
+    // Last radar data shown in each row, to update only rows that changed
+    std::map<LLUUID, LLSD>  mRowData;
     S32                     mLastResizeDelta;
 
     // Slot connection for FSRadar updates
@@ -95,13 +95,23 @@ void Animation::apply(Asset& asset, float time)
     // convert time to animation loop time
     time = fmod(time, mMaxTime - mMinTime) + mMinTime;
 
+    // find the keys of each sampler once, channels commonly share samplers
+    {
+        LL_PROFILE_ZONE_NAMED_CATEGORY_GLTF("gltfanim - sample");
+
+        for (auto& sampler : mSamplers)
+        {
+            sampler.sample(asset, time);
+        }
+    }
+
     // apply each channel
     {
         LL_PROFILE_ZONE_NAMED_CATEGORY_GLTF("gltfanim - rotation");
 
         for (auto& channel : mRotationChannels)
         {
-            channel.apply(asset, mSamplers[channel.mSampler], time);
+            channel.apply(asset, mSamplers[channel.mSampler]);
         }
     }
 
@@ -110,7 +120,7 @@ void Animation::apply(Asset& asset, float time)
 
         for (auto& channel : mTranslationChannels)
         {
-            channel.apply(asset, mSamplers[channel.mSampler], time);
+            channel.apply(asset, mSamplers[channel.mSampler]);
         }
     }
 
@@ -119,7 +129,7 @@ void Animation::apply(Asset& asset, float time)
 
         for (auto& channel : mScaleChannels)
         {
-            channel.apply(asset, mSamplers[channel.mSampler], time);
+            channel.apply(asset, mSamplers[channel.mSampler]);
         }
     }
 };
@@ -205,9 +215,11 @@ const Animation::Channel& Animation::Channel::operator=(const Value& src)
 
 void Animation::Sampler::getFrameInfo(Asset& asset, F32 time, U32& frameIndex, F32& t)
 {
-    LL_PROFILE_ZONE_SCOPED_CATEGORY_GLTF;
     llassert(mFrameTimes.size() > 1); // if there is only one frame, there is no need to interpolate
 
+    // read before writing frameIndex, which may be mFrameIndex itself
+    U32 cursor = mFrameIndex;
+
     if (time < mMinTime)
     {
         frameIndex = 0;
@@ -215,7 +227,8 @@ void Animation::Sampler::getFrameInfo(Asset& asset, F32 time, U32& frameIndex, F
         return;
     }
 
-    frameIndex = U32(mFrameTimes.size()) - 2;
+    U32 last = U32(mFrameTimes.size()) - 1;
+    frameIndex = last - 1;
     t = 1.f;
 
     if (time > mMaxTime)
@@ -223,24 +236,29 @@ void Animation::Sampler::getFrameInfo(Asset& asset, F32 time, U32& frameIndex, F
         return;
     }
 
-    if (time < mLastFrameTime)
+    // playback usually stays on the same key or moves to the next one
+    U32 idx = llmin(cursor, last - 1);
+    if (time >= mFrameTimes[idx + 1] && (idx + 2 > last || time < mFrameTimes[idx + 2]))
     {
-        mLastFrameIndex = 0;
+        ++idx;
     }
 
-    mLastFrameTime = time;
+    if (idx >= last || time < mFrameTimes[idx] || time >= mFrameTimes[idx + 1])
+    { // skipped ahead or looped, search all keys
+        idx = U32(std::upper_bound(mFrameTimes.begin(), mFrameTimes.end(), time) - mFrameTimes.begin());
+        idx = llclamp(idx, 1U, last) - 1;
+    }
 
-    U32 idx = mLastFrameIndex;
+    F32 span = mFrameTimes[idx + 1] - mFrameTimes[idx];
+    frameIndex = idx;
+    t = span > 0.f ? llclamp((time - mFrameTimes[idx]) / span, 0.f, 1.f) : 1.f;
+}
 
-    for (U32 i = idx; i < (U32)mFrameTimes.size() - 1; i++)
+void Animation::Sampler::sample(Asset& asset, F32 time)
+{
+    if (mFrameTimes.size() > 1)
     {
-        if (time >= mFrameTimes[i] && time < mFrameTimes[i + 1])
-        {
-            frameIndex = i;
-            t = (time - mFrameTimes[i]) / (mFrameTimes[i + 1] - mFrameTimes[i]);
-            mLastFrameIndex = frameIndex;
-            return;
-        }
+        getFrameInfo(asset, time, mFrameIndex, mFrameT);
     }
 }
 
@@ -253,10 +271,10 @@ bool Animation::RotationChannel::prep(Asset& asset, Animation::Sampler& sampler)
     return true;
 }
 
-void Animation::RotationChannel::apply(Asset& asset, Sampler& sampler, F32 time)
+void Animation::RotationChannel::apply(Asset& asset, const Sampler& sampler)
 {
-    U32 frameIndex;
-    F32 t;
+    U32 frameIndex = sampler.mFrameIndex;
+    F32 t = sampler.mFrameT;
 
     Node& node = asset.mNodes[mTarget.mNode];
 
@@ -266,8 +284,6 @@ void Animation::RotationChannel::apply(Asset& asset, Sampler& sampler, F32 time)
     }
     else
     {
-        sampler.getFrameInfo(asset, time, frameIndex, t);
-
         // interpolate
         quat qf = glm::slerp(mRotations[frameIndex], mRotations[frameIndex + 1], t);
 
@@ -286,10 +302,10 @@ bool Animation::TranslationChannel::prep(Asset& asset, Animation::Sampler& sampl
     return true;
 }
 
-void Animation::TranslationChannel::apply(Asset& asset, Sampler& sampler, F32 time)
+void Animation::TranslationChannel::apply(Asset& asset, const Sampler& sampler)
 {
-    U32 frameIndex;
-    F32 t;
+    U32 frameIndex = sampler.mFrameIndex;
+    F32 t = sampler.mFrameT;
 
     Node& node = asset.mNodes[mTarget.mNode];
 
@@ -299,8 +315,6 @@ void Animation::TranslationChannel::apply(Asset& asset, Sampler& sampler, F32 ti
     }
     else
     {
-        sampler.getFrameInfo(asset, time, frameIndex, t);
-
         // interpolate
         const vec3& v0 = mTranslations[frameIndex];
         const vec3& v1 = mTranslations[frameIndex + 1];
@@ -320,10 +334,10 @@ bool Animation::ScaleChannel::prep(Asset& asset, Animation::Sampler& sampler)
     return true;
 }
 
-void Animation::ScaleChannel::apply(Asset& asset, Sampler& sampler, F32 time)
+void Animation::ScaleChannel::apply(Asset& asset, const Sampler& sampler)
 {
-    U32 frameIndex;
-    F32 t;
+    U32 frameIndex = sampler.mFrameIndex;
+    F32 t = sampler.mFrameT;
 
     Node& node = asset.mNodes[mTarget.mNode];
 
@@ -333,8 +347,6 @@ void Animation::ScaleChannel::apply(Asset& asset, Sampler& sampler, F32 time)
     }
     else
     {
-        sampler.getFrameInfo(asset, time, frameIndex, t);
-
         // interpolate
         const vec3& v0 = mScales[frameIndex];
         const vec3& v1 = mScales[frameIndex + 1];
@@ -49,8 +49,10 @@ namespace LL
                 S32 mOutput = INVALID_INDEX;
                 std::string mInterpolation;
 
-                F32 mLastFrameTime = 0.f;
-                U32 mLastFrameIndex = 0;
+                // frame info at the time of the last Animation::apply, shared by every channel
+                // of this sampler, and the starting point of the next search
+                U32 mFrameIndex = 0;
+                F32 mFrameT = 0.f;
 
                 bool prep(Asset& asset);
 
@@ -63,6 +65,9 @@ namespace LL
                 // frameIndex -- index of the closest frame that precedes the specified time
                 // t - interpolant value between the frameIndex and the next frame
                 void getFrameInfo(Asset& asset, F32 time, U32& frameIndex, F32& t);
+
+                // update mFrameIndex and mFrameT for the specified time
+                void sample(Asset& asset, F32 time);
             };
 
             class Channel
@@ -101,7 +106,8 @@ namespace LL
                 // sampler -- Sampler associated with this channel
                 bool prep(Asset& asset, Sampler& sampler);
 
-                void apply(Asset& asset, Sampler& sampler, F32 time);
+                // set the target node from the sampler's current frame info, see Sampler::sample
+                void apply(Asset& asset, const Sampler& sampler);
             };
 
             class TranslationChannel : public Channel
@@ -117,7 +123,8 @@ namespace LL
                 // sampler -- Sampler associated with this channel
                 bool prep(Asset& asset, Sampler& sampler);
 
-                void apply(Asset& asset, Sampler& sampler, F32 time);
+                // set the target node from the sampler's current frame info, see Sampler::sample
+                void apply(Asset& asset, const Sampler& sampler);
             };
 
             class ScaleChannel : public Channel
@@ -133,7 +140,8 @@ namespace LL
                 // sampler -- Sampler associated with this channel
                 bool prep(Asset& asset, Sampler& sampler);
 
-                void apply(Asset& asset, Sampler& sampler, F32 time);
+                // set the target node from the sampler's current frame info, see Sampler::sample
+                void apply(Asset& asset, const Sampler& sampler);
             };
 
             std::string mName;
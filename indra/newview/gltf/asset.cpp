@@ -87,43 +87,59 @@ namespace LL
     }
 }
 
-void Scene::updateTransforms(Asset& asset)
+bool Scene::updateTransforms(Asset& asset, bool all)
 {
     mat4 identity = glm::identity<mat4>();
 
+    bool changed = false;
     for (auto& nodeIndex : mNodes)
     {
         Node& node = asset.mNodes[nodeIndex];
-        node.updateTransforms(asset, identity);
+        changed |= node.updateTransforms(asset, identity, all);
     }
+    return changed;
 }
 
-void Node::updateTransforms(Asset& asset, const mat4& parentMatrix)
+bool Node::updateTransforms(Asset& asset, const mat4& parentMatrix, bool parent_changed)
 {
-    makeMatrixValid();
-    mAssetMatrix = parentMatrix * mMatrix;
+    // setRotation/setTranslation/setScale invalidate mMatrix, so an untouched node under an
+    // untouched parent keeps its asset matrix
+    bool changed = parent_changed || !mMatrixValid;
+    if (changed)
+    {
+        makeMatrixValid();
+        mAssetMatrix = parentMatrix * mMatrix;
 
-    mAssetMatrixInv = glm::inverse(mAssetMatrix);
+        mAssetMatrixInv = glm::inverse(mAssetMatrix);
+    }
 
     S32 my_index = (S32)(this - &asset.mNodes[0]);
 
+    bool child_changed = false;
     for (auto& childIndex : mChildren)
     {
         Node& child = asset.mNodes[childIndex];
         child.mParent = my_index;
-        child.updateTransforms(asset, mAssetMatrix);
+        child_changed |= child.updateTransforms(asset, mAssetMatrix, changed);
     }
+
+    return changed || child_changed;
 }
 
-void Asset::updateTransforms()
+void Asset::updateTransforms(bool all)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_GLTF;
+    bool changed = false;
     for (auto& scene : mScenes)
     {
-        scene.updateTransforms(*this);
+        changed |= scene.updateTransforms(*this, all);
     }
 
-    uploadTransforms();
+    if (changed || mNodesUBO == 0)
+    {
+        uploadTransforms();
+        mSkinPalettesDirty = true;
+    }
 }
 
 void Asset::uploadTransforms()
@@ -364,22 +380,31 @@ void Node::makeTRSValid()
 void Node::setRotation(const quat& q)
 {
     makeTRSValid();
-    mRotation = q;
-    mMatrixValid = false;
+    if (mRotation != q)
+    {
+        mRotation = q;
+        mMatrixValid = false;
+    }
 }
 
 void Node::setTranslation(const vec3& t)
 {
     makeTRSValid();
-    mTranslation = t;
-    mMatrixValid = false;
+    if (mTranslation != t)
+    {
+        mTranslation = t;
+        mMatrixValid = false;
+    }
 }
 
 void Node::setScale(const vec3& s)
 {
     makeTRSValid();
-    mScale = s;
-    mMatrixValid = false;
+    if (mScale != s)
+    {
+        mScale = s;
+        mMatrixValid = false;
+    }
 }
 
 void Node::serialize(object& dst) const
@@ -458,14 +483,30 @@ void Asset::update()
             mAnimations[idx].update(*this, dt*anim_speed);
         }
 
-        updateTransforms();
+        // transforms only change by animation or by an edit, which calls updateTransforms() itself
+        if (mNodesUBO == 0)
+        {
+            updateTransforms();
+        }
+        else if (mAnimations.size() > 0)
+        {
+            updateTransforms(false);
+        }
 
-        for (auto& skin : mSkins)
+        if (mSkinPalettesDirty)
         {
-            skin.uploadMatrixPalette(*this);
+            for (auto& skin : mSkins)
+            {
+                skin.uploadMatrixPalette(*this);
+            }
+            mSkinPalettesDirty = false;
         }
 
-        uploadMaterials();
+        // materials don't change after load
+        if (mMaterialsUBO == 0)
+        {
+            uploadMaterials();
+        }
 
         {
             LL_PROFILE_ZONE_NAMED_CATEGORY_GLTF("gltf - addTextureStats");
@@ -484,6 +525,11 @@ void Asset::update()
 }
 
 bool Asset::prep()
+{
+    return prepData() && prepGL();
+}
+
+bool Asset::prepData()
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_GLTF;
     // check required extensions and fail if not supported
@@ -511,14 +557,6 @@ bool Asset::prep()
         }
     }
 
-    for (auto& image : mImages)
-    {
-        if (!image.prep(*this))
-        {
-            return false;
-        }
-    }
-
     for (auto& mesh : mMeshes)
     {
         if (!mesh.prep(*this))
@@ -543,6 +581,21 @@ bool Asset::prep()
         }
     }
 
+    return true;
+}
+
+bool Asset::prepGL()
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_GLTF;
+
+    for (auto& image : mImages)
+    {
+        if (!image.prep(*this))
+        {
+            return false;
+        }
+    }
+
     // prepare vertex buffers
 
     // material count is number of materials + 1 for default material
@@ -664,9 +717,94 @@ bool Asset::prep()
             }
         }
     }
+
+    buildInstanceRuns();
     return true;
 }
 
+void Asset::buildInstanceRuns()
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_GLTF;
+
+    // every run gets a whole block so it can be bound with glBindBufferRange
+    GLint gl_alignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &gl_alignment);
+    const U32 alignment = llmax(gl_alignment, 1);
+    const U32 block_size = LLGLSLShader::MAX_GLTF_INSTANCES * sizeof(S32);
+
+    // the first block is unused, it is what gets bound when nothing is instanced
+    std::vector<S32> node_ids(block_size / sizeof(S32), 0);
+
+    for (S32 double_sided = 0; double_sided < 2; ++double_sided)
+    {
+        for (U32 variant = 0; variant < LLGLSLShader::NUM_GLTF_VARIANTS; ++variant)
+        {
+            // rigged primitives take their transforms from the skin of their node
+            bool rigged = variant & LLGLSLShader::GLTFVariant::RIGGED;
+
+            for (RenderBatch& rb : mRenderData[double_sided].mBatches[variant])
+            {
+                auto& prims = rb.mPrimitives;
+                rb.mInstanceRuns.clear();
+
+                if (!rigged)
+                { // bring nodes that share a mesh together
+                    std::stable_sort(prims.begin(), prims.end(),
+                        [this](const RenderBatch::PrimitiveData& lhs, const RenderBatch::PrimitiveData& rhs)
+                        {
+                            S32 lhs_mesh = mNodes[lhs.mNodeIndex].mMesh;
+                            S32 rhs_mesh = mNodes[rhs.mNodeIndex].mMesh;
+                            return lhs_mesh != rhs_mesh ? lhs_mesh < rhs_mesh : lhs.mPrimitiveIndex < rhs.mPrimitiveIndex;
+                        });
+                }
+
+                for (U32 i = 0; i < prims.size(); )
+                {
+                    RenderBatch::InstanceRun run;
+                    run.mFirst = i;
+                    run.mCount = 1;
+
+                    if (!rigged)
+                    {
+                        S32 mesh = mNodes[prims[i].mNodeIndex].mMesh;
+                        while (i + run.mCount < prims.size() &&
+                            run.mCount < LLGLSLShader::MAX_GLTF_INSTANCES &&
+                            mNodes[prims[i + run.mCount].mNodeIndex].mMesh == mesh &&
+                            prims[i + run.mCount].mPrimitiveIndex == prims[i].mPrimitiveIndex)
+                        {
+                            ++run.mCount;
+                        }
+                    }
+
+                    if (run.mCount > 1)
+                    {
+                        run.mUBOOffset = (U32)(node_ids.size() * sizeof(S32));
+                        run.mUBOOffset = alignment * ((run.mUBOOffset + alignment - 1) / alignment);
+                        node_ids.resize(run.mUBOOffset / sizeof(S32) + block_size / sizeof(S32), 0);
+
+                        for (U32 j = 0; j < run.mCount; ++j)
+                        {
+                            node_ids[run.mUBOOffset / sizeof(S32) + j] = prims[i + j].mNodeIndex;
+                        }
+                    }
+
+                    rb.mInstanceRuns.push_back(run);
+                    i += run.mCount;
+                }
+            }
+        }
+    }
+
+    if (mInstancesUBO == 0)
+    {
+        glGenBuffers(1, &mInstancesUBO);
+    }
+
+    glBindBuffer(GL_UNIFORM_BUFFER, mInstancesUBO);
+    glBufferData(GL_UNIFORM_BUFFER, node_ids.size() * sizeof(S32), node_ids.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
 Asset::Asset(const Value& src)
 {
     *this = src;
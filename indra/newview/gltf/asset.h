@@ -207,8 +207,10 @@ namespace LL
             const Node& operator=(const Value& src);
             void serialize(boost::json::object& dst) const;
 
-            // update mAssetMatrix and mAssetMatrixInv
-            void updateTransforms(Asset& asset, const mat4& parentMatrix);
+            // update mAssetMatrix and mAssetMatrixInv of this node and its descendants
+            // parent_changed -- if false, only recompute this node if its transform was set since the last update
+            // returns true if this node or any descendant changed
+            bool updateTransforms(Asset& asset, const mat4& parentMatrix, bool parent_changed = true);
 
             // ensure mMatrix is valid -- if mMatrixValid is false and mTRSValid is true, will update mMatrix to match Translation/Rotation/Scale
             void makeMatrixValid();
@@ -217,15 +219,15 @@ namespace LL
             void makeTRSValid();
 
             // Set rotation of this node
-            // SIDE EFFECT: invalidates mMatrix
+            // SIDE EFFECT: invalidates mMatrix if the rotation changed
             void setRotation(const quat& rotation);
 
             // Set translation of this node
-            // SIDE EFFECT: invalidates mMatrix
+            // SIDE EFFECT: invalidates mMatrix if the translation changed
             void setTranslation(const vec3& translation);
 
             // Set scale of this node
-            // SIDE EFFECT: invalidates mMatrix
+            // SIDE EFFECT: invalidates mMatrix if the scale changed
             void setScale(const vec3& scale);
         };
 
@@ -258,7 +260,8 @@ namespace LL
             const Scene& operator=(const Value& src);
             void serialize(boost::json::object& dst) const;
 
-            void updateTransforms(Asset& asset);
+            // returns true if any node transform changed, see Node::updateTransforms
+            bool updateTransforms(Asset& asset, bool all = true);
             void updateRenderTransforms(Asset& asset, const mat4& modelview);
         };
 
@@ -330,8 +333,18 @@ namespace LL
                 S32 mNodeIndex = INVALID_INDEX;
             };
 
+            // consecutive entries of mPrimitives that draw the same primitive of the same mesh
+            // from different nodes, drawn with one instanced draw call when mCount > 1
+            struct InstanceRun
+            {
+                U32 mFirst = 0;         // index into mPrimitives
+                U32 mCount = 0;
+                U32 mUBOOffset = 0;     // offset of this run's node indices in Asset::mInstancesUBO
+            };
+
             LLPointer<LLVertexBuffer> mVertexBuffer;
             std::vector<PrimitiveData> mPrimitives;
+            std::vector<InstanceRun> mInstanceRuns;
         };
 
         class RenderData
@@ -392,9 +405,22 @@ namespace LL
             // UBO for storing material data
             U32 mMaterialsUBO = 0;
 
-            // prepare for first time use
+            // UBO for storing the node indices of instanced draws, see RenderBatch::InstanceRun
+            U32 mInstancesUBO = 0;
+
+            // set when node transforms changed since the skin matrix palettes were last uploaded
+            bool mSkinPalettesDirty = true;
+
+            // prepare for first time use, prepData() followed by prepGL()
             bool prep();
 
+            // Read buffers and convert meshes, animations and skins to the layout we render
+            // from.  Touches nothing outside this asset, so it may run on a worker thread.
+            bool prepData();
+
+            // Fetch images and pack vertex buffers, on the main thread once prepData() succeeded
+            bool prepGL();
+
             // Called periodically (typically once per frame)
             // Any ongoing work (such as animations) should be handled here
             // NOT guaranteed to be called every frame
@@ -403,7 +429,10 @@ namespace LL
             void update();
 
             // update asset-to-node and node-to-asset transforms
-            void updateTransforms();
+            // call after changing any node's transform, update() only recomputes them while animating
+            // all -- if false, only recompute nodes whose translation/rotation/scale were set since
+            //        the last update, along with their descendants
+            void updateTransforms(bool all = true);
 
             // upload matrices to UBO
             void uploadTransforms();
@@ -411,6 +440,9 @@ namespace LL
             // upload materils to UBO
             void uploadMaterials();
 
+            // group the primitives of each batch into instance runs and upload their node indices
+            void buildInstanceRuns();
+
             // return the index of the node that the line segment intersects with, or -1 if no hit
             // input and output values must be in this asset's local coordinate frame
             S32 lineSegmentIntersect(const LLVector4a& start, const LLVector4a& end,
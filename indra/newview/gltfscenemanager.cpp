@@ -46,6 +46,8 @@
 #include "llagentbenefits.h"
 #include "llfilesystem.h"
 #include "llviewercontrol.h"
+#include "llviewerobjectlist.h"
+#include "workqueue.h"
 #include "boost/json.hpp"
 
 #define GLTF_SIM_SUPPORT 1
@@ -368,6 +370,47 @@ void GLTFSceneManager::addGLTFObject(LLViewerObject* obj, LLUUID gltf_id)
     gAssetStorage->getAssetData(gltf_id, LLAssetType::AT_GLTF, onGLTFLoadComplete, obj);
 }
 
+//static
+void GLTFSceneManager::prepAsset(LLViewerObject* obj, const LLUUID& id)
+{
+    // the object is only added to mObjects once its asset is ready, nothing renders,
+    // animates or picks it while the General pool converts the buffers
+    std::shared_ptr<Asset> asset = obj->mGLTFAsset;
+    // look the object up again rather than hold a reference, which is not thread safe
+    LLUUID object_id = obj->getID();
+
+    auto finish = [object_id, asset, id](bool result)
+    {
+        LLPointer<LLViewerObject> objp = gObjectList.findObject(object_id);
+        if (objp.isNull() || objp->isDead() || objp->mGLTFAsset != asset)
+        { // object went away or got another asset meanwhile
+            return;
+        }
+
+        if (result && asset->prepGL())
+        {
+            GLTFSceneManager& mgr = GLTFSceneManager::instance();
+            if (std::find(mgr.mObjects.begin(), mgr.mObjects.end(), objp) == mgr.mObjects.end())
+            {
+                mgr.mObjects.push_back(objp);
+            }
+        }
+        else
+        {
+            LL_WARNS("GLTF") << "Failed to prepare GLTF asset: " << id << LL_ENDL;
+            objp->mGLTFAsset = nullptr;
+        }
+    };
+
+    LL::WorkQueue::ptr_t main_queue = LL::WorkQueue::getInstance("mainloop");
+    LL::WorkQueue::ptr_t general_queue = LL::WorkQueue::getInstance("General");
+    if (!main_queue || !general_queue ||
+        !main_queue->postTo(general_queue, [asset]() { return asset->prepData(); }, finish))
+    {
+        finish(asset->prepData());
+    }
+}
+
 //static
 void GLTFSceneManager::onGLTFBinLoadComplete(const LLUUID& id, LLAssetType::EType asset_type, void* user_data, S32 status, LLExtStat ext_status)
 {
@@ -386,19 +429,7 @@ void GLTFSceneManager::onGLTFBinLoadComplete(const LLUUID& id, LLAssetType::ETyp
 
                 if (obj->mGLTFAsset->mPendingBuffers == 0)
                 {
-                    if (obj->mGLTFAsset->prep())
-                    {
-                        GLTFSceneManager& mgr = GLTFSceneManager::instance();
-                        if (std::find(mgr.mObjects.begin(), mgr.mObjects.end(), obj) == mgr.mObjects.end())
-                        {
-                            GLTFSceneManager::instance().mObjects.push_back(obj);
-                        }
-                    }
-                    else
-                    {
-                        LL_WARNS("GLTF") << "Failed to prepare GLTF asset: " << id << LL_ENDL;
-                        obj->mGLTFAsset = nullptr;
-                    }
+                    prepAsset(obj, id);
                 }
             }
         }
@@ -642,6 +673,7 @@ void GLTFSceneManager::render(Asset& asset, U8 variant)
         bool rigged = variant & LLGLSLShader::GLTFVariant::RIGGED;
 
         bool shader_bound = false;
+        const GLsizeiptr instance_block_size = LLGLSLShader::MAX_GLTF_INSTANCES * sizeof(S32);
 
         for (U32 i = 0; i < batches.size(); ++i)
         {
@@ -664,6 +696,7 @@ void GLTFSceneManager::render(Asset& asset, U8 variant)
                 if (!rigged)
                 {
                     glBindBufferBase(GL_UNIFORM_BUFFER, LLGLSLShader::UB_GLTF_NODES, asset.mNodesUBO);
+                    glBindBufferRange(GL_UNIFORM_BUFFER, LLGLSLShader::UB_GLTF_INSTANCES, asset.mInstancesUBO, 0, instance_block_size);
                 }
 
                 glBindBufferBase(GL_UNIFORM_BUFFER, LLGLSLShader::UB_GLTF_MATERIALS, asset.mMaterialsUBO);
@@ -694,9 +727,11 @@ void GLTFSceneManager::render(Asset& asset, U8 variant)
                 LLGLSLShader::sCurBoundShaderPtr->uniform1i(LLShaderMgr::GLTF_MATERIAL_ID, -1);
             }
 
-            for (auto& pdata : batches[i].mPrimitives)
+            // nodes sharing a mesh are drawn with one instanced draw call per run, see Asset::buildInstanceRuns
+            for (auto& run : batches[i].mInstanceRuns)
             {
                 LL_PROFILE_ZONE_NAMED_CATEGORY_GLTF("GLTF draw call");
+                auto& pdata = batches[i].mPrimitives[run.mFirst];
                 Node& node = asset.mNodes[pdata.mNodeIndex];
                 Mesh& mesh = asset.mMeshes[node.mMesh];
                 Primitive& primitive = mesh.mPrimitives[pdata.mPrimitiveIndex];
@@ -708,11 +743,23 @@ void GLTFSceneManager::render(Asset& asset, U8 variant)
                     Skin& skin = asset.mSkins[node.mSkin];
                     glBindBufferBase(GL_UNIFORM_BUFFER, LLGLSLShader::UB_GLTF_JOINTS, skin.mUBO);
                 }
+                else if (run.mCount > 1)
+                {
+                    LLGLSLShader::sCurBoundShaderPtr->uniform1i(LLShaderMgr::GLTF_NODE_ID, -1);
+                    glBindBufferRange(GL_UNIFORM_BUFFER, LLGLSLShader::UB_GLTF_INSTANCES, asset.mInstancesUBO, run.mUBOOffset, instance_block_size);
+                }
                 else
                 {
                     LLGLSLShader::sCurBoundShaderPtr->uniform1i(LLShaderMgr::GLTF_NODE_ID, pdata.mNodeIndex);
                 }
 
+                if (run.mCount > 1)
+                {
+                    LL_PROFILE_ZONE_NAMED_CATEGORY_GLTF("gltfdc - push vb instanced");
+
+                    primitive.mVertexBuffer->drawInstanced(primitive.mGLMode, primitive.getIndexCount(), primitive.mIndexOffset, run.mCount);
+                }
+                else
                 {
                     LL_PROFILE_ZONE_NAMED_CATEGORY_GLTF("gltfdc - push vb");
 
@@ -83,6 +83,8 @@ namespace LL
         void addGLTFObject(LLViewerObject* object, LLUUID gltf_id);
         static void onGLTFLoadComplete(const LLUUID& id, LLAssetType::EType asset_type, void* user_data, S32 status, LLExtStat ext_status);
         static void onGLTFBinLoadComplete(const LLUUID& id, LLAssetType::EType asset_type, void* user_data, S32 status, LLExtStat ext_status);
+        // Convert obj's asset on the General pool, then upload it and add obj to mObjects on the main thread
+        static void prepAsset(LLViewerObject* obj, const LLUUID& id);
 
         std::vector<LLPointer<LLViewerObject>> mObjects;
 
@@ -70,6 +70,7 @@
 // #include "llpaneltopinfobar.h"
 #include "llparcel.h"
 #include "llperfstats.h"
+#include "llregionprefetch.h"
 #include "llrendersphere.h"
 #include "llscriptruntimeperms.h"
 #include "llsdutil.h"
@@ -1260,6 +1261,8 @@ void LLAgent::setRegion(LLViewerRegion *regionp)
 
         // Pass new region along to metrics components that care about this level of detail.
         LLAppViewer::metricsUpdateRegion(regionp->getHandle());
+
+        LLRegionPrefetch::instance().startRecording(regionp->getHandle());
     }
 
     mRegionp = regionp;
@@ -3923,6 +3926,18 @@ LLQuaternion LLAgent::getHeadRotation()
 }
 
 void LLAgent::sendAnimationRequests(const std::vector<LLUUID> &anim_ids, EAnimRequest request)
+{
+    if (request == ANIM_REQUEST_START)
+    {
+        sendAnimationRequests(anim_ids, std::vector<LLUUID>());
+    }
+    else
+    {
+        sendAnimationRequests(std::vector<LLUUID>(), anim_ids);
+    }
+}
+
+void LLAgent::sendAnimationRequests(const std::vector<LLUUID> &start_ids, const std::vector<LLUUID> &stop_ids)
 {
     if (gAgentID.isNull())
     {
@@ -3937,13 +3952,24 @@ void LLAgent::sendAnimationRequests(const std::vector<LLUUID> &anim_ids, EAnimRe
     msg->addUUIDFast(_PREHASH_AgentID, getID());
     msg->addUUIDFast(_PREHASH_SessionID, getSessionID());
 
-    for (const LLUUID& uuid : anim_ids)
+    for (const LLUUID& uuid : start_ids)
+    {
+        if (uuid.notNull())
+        {
+            msg->nextBlockFast(_PREHASH_AnimationList);
+            msg->addUUIDFast(_PREHASH_AnimID, uuid);
+            msg->addBOOLFast(_PREHASH_StartAnim, true);
+            num_valid_anims++;
+        }
+    }
+
+    for (const LLUUID& uuid : stop_ids)
     {
         if (uuid.notNull())
         {
             msg->nextBlockFast(_PREHASH_AnimationList);
             msg->addUUIDFast(_PREHASH_AnimID, uuid);
-            msg->addBOOLFast(_PREHASH_StartAnim, request == ANIM_REQUEST_START);
+            msg->addBOOLFast(_PREHASH_StartAnim, false);
             num_valid_anims++;
         }
     }
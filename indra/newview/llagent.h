@@ -599,6 +599,8 @@ public:
     void            requestStopMotion(LLMotion* motion);
     void            onAnimStop(const LLUUID& id);
     void            sendAnimationRequests(const std::vector<LLUUID> &anim_ids, EAnimRequest request);
+    // Start and stop animations in one AgentAnimation message
+    void            sendAnimationRequests(const std::vector<LLUUID> &start_ids, const std::vector<LLUUID> &stop_ids);
     void            sendAnimationRequest(const LLUUID &anim_id, EAnimRequest request);
     void            sendAnimationStateReset();
     void            sendRevokePermissions(const LLUUID & target, U32 permissions);
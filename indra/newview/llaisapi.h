@@ -48,6 +48,8 @@ public:
 
     static bool isAvailable();
     static void getCapNames(LLSD& capNames);
+    // Requests refused with 503 or 429 so far, watch for changes
+    static U32 getThrottledCount() { return sThrottledCount; }
 
     static void CreateInventory(const LLUUID& parentId, const LLSD& newInventory, completion_t callback = completion_t());
     static void SlamFolder(const LLUUID& folderId, const LLSD& newInventory, completion_t callback = completion_t());
@@ -105,6 +107,7 @@ private:
 
     typedef std::pair<std::string, LLCoprocedureManager::CoProcedure_t> ais_query_item_t;
     static std::list<ais_query_item_t> sPostponedQuery;
+    static U32 sThrottledCount;
 };
 
 class AISUpdate
@@ -31,6 +31,7 @@
 #include "llappviewer.h"
 #include "llviewercontrol.h"
 #include "llexception.h"
+#include "llregionhandle.h"
 #include "stringize.h"
 
 #include <openssl/x509_vfy.h>
@@ -54,6 +55,7 @@
 
 const F64 LLAppCoreHttp::MAX_THREAD_WAIT_TIME(10.0);
 const long LLAppCoreHttp::PIPELINING_DEPTH(5L);
+const long LLAppCoreHttp::MULTIPLEX_STREAMS(32L);
 
 //  Default and dynamic values for classes
 static const struct
@@ -123,6 +125,26 @@ static const struct
         2,      1,      32,     0,      false,
         "Agent",
         "Agent requests"
+    },
+    { // AP_REGION1
+        6,      1,      16,     0,      true,
+        "CapabilityConcurrency",
+        "region capabilities"
+    },
+    { // AP_REGION2
+        6,      1,      16,     0,      true,
+        "CapabilityConcurrency",
+        "region capabilities"
+    },
+    { // AP_REGION3
+        6,      1,      16,     0,      true,
+        "CapabilityConcurrency",
+        "region capabilities"
+    },
+    { // AP_REGION4
+        6,      1,      16,     0,      true,
+        "CapabilityConcurrency",
+        "region capabilities"
     }
 };
 
@@ -240,6 +262,16 @@ void LLAppCoreHttp::init()
                                                             trace_level, NULL);
     }
 
+    // Threads giving libcurl cycles, policy classes are divided among them
+    status = LLCore::HttpRequest::setStaticPolicyOption(LLCore::HttpRequest::PO_TRANSPORT_THREADS,
+                                                        LLCore::HttpRequest::GLOBAL_POLICY_ID,
+                                                        long(gSavedSettings.getU32("HttpTransportThreads")), NULL);
+    if (! status)
+    {
+        LL_WARNS("Init") << "Failed to set HTTP transport threads.  Reason:  " << status.toString()
+                         << LL_ENDL;
+    }
+
     // Setup default policy and constrain if directed to
     mHttpClasses[AP_DEFAULT].mPolicy = LLCore::HttpRequest::DEFAULT_POLICY_ID;
 
@@ -399,6 +431,16 @@ void LLAppCoreHttp::cleanup()
 }
 
 
+LLAppCoreHttp::policy_t LLAppCoreHttp::getRegionPolicy(U64 region_handle) const
+{
+    // Grid x + 2 * grid y, modulo 4, differs between a region and each of
+    // its eight neighbours
+    U32 x, y;
+    from_region_handle(region_handle, &x, &y);
+    U32 index((x / REGION_WIDTH_U32 + 2 * (y / REGION_WIDTH_U32)) % 4);
+    return mHttpClasses[AP_REGION1 + index].mPolicy;
+}
+
 void LLAppCoreHttp::refreshSettings(bool initial)
 {
     LLCore::HttpStatus status;
@@ -460,6 +502,41 @@ void LLAppCoreHttp::refreshSettings(bool initial)
                     mHttpClasses[app_policy].mPipelined = to_pipeline;
                 }
             }
+
+            // Texture fetches are many small range requests against
+            // one CDN host, the best case for HTTP/2 streams.  Region
+            // capabilities are bursts of small requests to one simulator
+            // at login and teleport; simulators that don't negotiate
+            // HTTP/2 fall back to HTTP/1.1.
+            static const std::string texture_http2("TextureFetchHTTP2");
+            static const std::string capability_http2("CapabilityHTTP2");
+            const std::string* http2_key(NULL);
+            if (app_policy == AP_TEXTURE)
+            {
+                http2_key = &texture_http2;
+            }
+            else if (app_policy >= AP_REGION1 && app_policy <= AP_REGION4)
+            {
+                http2_key = &capability_http2;
+            }
+            if (http2_key
+                && mHttpClasses[app_policy].mPipelined
+                && gSavedSettings.controlExists(*http2_key)
+                && gSavedSettings.getBOOL(*http2_key))
+            {
+                LLCore::HttpHandle handle;
+                handle = mRequest->setPolicyOption(LLCore::HttpRequest::PO_HTTP2_MULTIPLEX,
+                                                   mHttpClasses[app_policy].mPolicy,
+                                                   MULTIPLEX_STREAMS,
+                                                   LLCore::HttpHandler::ptr_t());
+                if (LLCORE_HTTP_HANDLE_INVALID == handle)
+                {
+                    status = mRequest->getStatus();
+                    LL_WARNS("Init") << "Unable to set " << init_data[i].mUsage
+                                     << " HTTP/2 multiplexing.  Reason:  " << status.toString()
+                                     << LL_ENDL;
+                }
+            }
         }
 
         // Get target connection concurrency value
@@ -42,6 +42,7 @@ class LLAppCoreHttp : public LLCore::HttpHandler
 {
 public:
     static const long           PIPELINING_DEPTH;
+    static const long           MULTIPLEX_STREAMS;
 
     typedef LLCore::HttpRequest::policy_t policy_t;
 
@@ -203,6 +204,26 @@ public:
         /// Pipelined:       yes
         AP_AGENT,
 
+        /// Capability requests to one region (seed,
+        /// simulator features and the generic
+        /// LLViewerRegion capability calls).  Regions
+        /// are spread over these classes by grid
+        /// position, @see getRegionPolicy(), so each
+        /// region and its neighbours get their own
+        /// connections instead of queueing on AP_DEFAULT.
+        ///
+        /// Destination:     simhost:12043
+        /// Protocol:        https:
+        /// Transfer size:   KB
+        /// Long poll:       no
+        /// Concurrency:     mid
+        /// Request rate:    mid
+        /// Pipelined:       yes, HTTP/2 with CapabilityHTTP2
+        AP_REGION1,
+        AP_REGION2,
+        AP_REGION3,
+        AP_REGION4,
+
         AP_COUNT                        // Must be last
     };
 
@@ -238,6 +259,10 @@ public:
             return mHttpClasses[policy].mPolicy;
         }
 
+    // Retrieve the policy class for capability requests to the
+    // region at region_handle.
+    policy_t getRegionPolicy(U64 region_handle) const;
+
     // Return whether a policy is using pipelined operations.
     bool isPipelined(EAppPolicy policy) const
         {
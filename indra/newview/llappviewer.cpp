@@ -31,6 +31,12 @@
 // Viewer includes
 #include "llversioninfo.h"
 #include "llfeaturemanager.h"
+#include "llflightrecorder.h"
+#include "llframearena.h"
+#include "llframepacer.h"
+#include "llavatargputimer.h"
+#include "llgpupasstimer.h"
+#include "llscenebenchmark.h"
 #include "lluictrlfactory.h"
 #include "lltexteditor.h"
 #include "llenvironment.h"
@@ -60,6 +66,7 @@
 #include "llslurl.h"
 #include "llstartup.h"
 #include "llfocusmgr.h"
+#include "llframesnapshot.h"
 #include "llurlfloaterdispatchhandler.h"
 #include "llviewerjoystick.h"
 #include "llcalc.h"
@@ -78,6 +85,7 @@
 #include "llviewershadermgr.h"
 #include "llviewermediafocus.h"
 #include "llviewermessage.h"
+#include "llviewermessagecapture.h"
 #include "llviewerobjectlist.h"
 #include "llworldmap.h"
 #include "llmutelist.h"
@@ -122,6 +130,7 @@
 #include "llavatarrenderinfoaccountant.h"
 #include "lllocalbitmaps.h"
 #include "llperfstats.h"
+#include "llparsedfilecache.h"
 #include "llgltfmateriallist.h"
 
 // Linden library includes
@@ -130,6 +139,7 @@
 #include "llexperiencecache.h"
 #include "llimagej2c.h"
 #include "llmemory.h"
+#include "llmemtag.h"
 #include "llprimitive.h"
 #include "llurlaction.h"
 #include "llurlentry.h"
@@ -175,6 +185,7 @@
 #include "llworkerthread.h"
 #include "lltexturecache.h"
 #include "lltexturefetch.h"
+#include "lltexturefetchbenchmark.h"
 #include "llimageworker.h"
 #include "llevents.h"
 
@@ -217,6 +228,7 @@
 #include "llbutton.h"
 #include "llstatusbar.h"
 #include "llsurface.h"
+#include "llterrainheightfield.h"
 #include "llvosky.h"
 #include "llvotree.h"
 #include "llvoavatar.h"
@@ -394,6 +406,11 @@ bool gSimulateMemLeak = false;
 // to have to block due to this WorkQueue being full.
 WorkQueue gMainloopWork("mainloop", 1024*1024);
 
+// The other lanes of main thread work, see LLAppViewer::EMainWorkLane
+static WorkQueue sMainloopUIWork("mainloop-ui", 1024*1024);
+static WorkQueue sMainloopRenderWork("mainloop-render", 1024*1024);
+static WorkQueue sMainloopBackgroundWork("mainloop-background", 1024*1024);
+
 ////////////////////////////////////////////////////////////
 // Internal globals... that should be removed.
 
@@ -602,8 +619,14 @@ static void settings_to_globals()
     LLRender::sNsightDebugSupport = gSavedSettings.getBOOL("RenderNsightDebugSupport");
     LLImageGL::sGlobalUseAnisotropic    = gSavedSettings.getBOOL("RenderAnisotropic");
     LLImageGL::sCompressTextures        = gSavedSettings.getBOOL("RenderCompressTextures");
+    LLImageGL::sBlockCompressTextures   = gSavedSettings.getBOOL("RenderBlockCompressTextures");
+    LLImageGL::sSparseTextures          = gSavedSettings.getBOOL("RenderSparseTextures");
     LLVOVolume::sLODFactor              = llclamp(gSavedSettings.getF32("RenderVolumeLODFactor"), 0.01f, MAX_LOD_FACTOR);
     LLVOVolume::sDistanceFactor         = 1.f-LLVOVolume::sLODFactor * 0.1f;
+    LLVolumeFace::sMeshletMinTriangles  = gSavedSettings.getU32("RenderMeshletMinTriangles");
+    LLVolumeFace::sUseBVH               = gSavedSettings.getBOOL("RenderFaceBVH");
+    LLTerrainHeightfield::sEnabled      = gSavedSettings.getBOOL("RenderTerrainGPUHeightfield");
+    LLVOTree::sInstancing               = gSavedSettings.getBOOL("RenderTreeInstancing");
     LLVolumeImplFlexible::sUpdateFactor = gSavedSettings.getF32("RenderFlexTimeFactor");
     LLVOTree::sTreeFactor               = gSavedSettings.getF32("RenderTreeLODFactor");
     LLVOAvatar::sLODFactor              = llclamp(gSavedSettings.getF32("RenderAvatarLODFactor"), 0.f, MAX_AVATAR_LOD_FACTOR);
@@ -941,6 +964,8 @@ bool LLAppViewer::init()
         LLError::setFatalFunction([rc](const std::string&){ _exit(rc); });
     }
 
+    LLError::setAsyncLogging(gSavedSettings.getBOOL("LogAsync"));
+
     // Initialize the non-LLCurl libcurl library.  Should be called
     // before consumers (LLTextureFetch).
     mAppCoreHttp.init();
@@ -1657,6 +1682,10 @@ bool LLAppViewer::doFrame()
 
             LLTrace::get_frame_recording().nextPeriod();
             LLTrace::BlockTimer::logStats();
+            LLFlightRecorder::getInstance()->endFrame();
+            LLFrameArena::get().endFrame();
+            LLAvatarGPUTimer::endFrame();
+            LLGPUPassTimer::endFrame();
         }
 
         LLTrace::get_thread_recorder()->pullFromChildren();
@@ -1689,7 +1718,9 @@ bool LLAppViewer::doFrame()
                     LL_WARNS() << " Someone took over my signal/exception handler (post messagehandling)!" << LL_ENDL;
                 }
 
+                LLFramePacer::getInstance()->waitForGPU();
                 gViewerWindow->getWindow()->gatherInput();
+                LLFramePacer::getInstance()->markInput();
             }
 
             //memory leaking simulation
@@ -1760,6 +1791,9 @@ bool LLAppViewer::doFrame()
                     idle();
                 }
 
+                // everything rendering needs from this frame's simulation
+                LLFrameSnapshot::publish();
+
                 {
                     LL_PROFILE_ZONE_NAMED_CATEGORY_APP("df resumeMainloopTimeout");
                     resumeMainloopTimeout();
@@ -2307,6 +2341,8 @@ bool LLAppViewer::cleanup()
         LLEnvironment::getInstance()->saveToSettings();
     }
 
+    LLUICtrlFactory::clearXMLCache();
+
     // Must do this after all panels have been deleted because panels that have persistent rects
     // save their rects on delete.
     if(mSaveSettingsOnExit)     // <FS:Zi> Backup Settings
@@ -2443,6 +2479,8 @@ bool LLAppViewer::cleanup()
         gDirUtilp->deleteDirAndContents(user_path);
     }
 
+    LLTextureFetchBenchmark::cleanupClass();
+
     // Delete workers first
     // shotdown all worker threads before deleting them in case of co-dependencies
     mAppCoreHttp.requestStop();
@@ -2570,6 +2608,9 @@ bool LLAppViewer::cleanup()
 
     LL_INFOS() << "Goodbye!" << LL_ENDL;
 
+    // write out the queued lines, the log file may be removed next
+    LLError::setAsyncLogging(false);
+
     removeDumpDir();
 
     // return 0;
@@ -2623,10 +2664,12 @@ bool LLAppViewer::initThreads()
 
     // Image decoding
     LLAppViewer::sImageDecodeThread = new LLImageDecodeThread(enable_threads && true);
+    LLAppViewer::sImageDecodeThread->setMaxCodecThreads(gSavedSettings.getU32("ImageDecodeCodecThreads"));
     LLAppViewer::sTextureCache = new LLTextureCache(enable_threads && true);
     LLAppViewer::sTextureFetch = new LLTextureFetch(LLAppViewer::getTextureCache(),
                                                     enable_threads && true,
                                                     app_metrics_qa_mode);
+    LLTextureFetchBenchmark::initClass();
 
     // general task background thread (LLPerfStats, etc)
     LLAppViewer::instance()->initGeneralThread();
@@ -2956,6 +2999,9 @@ bool tempSetControl(const std::string& name, const std::string& value)
 
 bool LLAppViewer::initConfiguration()
 {
+    // parsed settings and colors are kept in binary, XML is only parsed again when it changed
+    LLParsedFileCache::setDirectory(gDirUtilp->add(gDirUtilp->getOSUserAppDir(), "parsed_cache"));
+
     // Load settings files list
     std::string settings_file_list = gDirUtilp->getExpandedFilename(LL_PATH_APP_SETTINGS, "settings_files.xml");
     LLXMLNodePtr root;
@@ -3298,6 +3344,11 @@ bool LLAppViewer::initConfiguration()
     LLFastTimerView::sAnalyzePerformance = gSavedSettings.getBOOL("AnalyzePerformance");
     gAgentPilot.setReplaySession(gSavedSettings.getBOOL("ReplaySession"));
 
+    if (LLSceneBenchmark::requested())
+    {
+        LLSceneBenchmark::getInstance();
+    }
+
     if (gSavedSettings.getBOOL("DebugSession"))
     {
         gDebugSession = true;
@@ -5087,7 +5138,7 @@ bool LLAppViewer::initCache()
     const std::string cache_dir = gDirUtilp->getExpandedFilename(LL_PATH_CACHE, cache_dir_name);
     // <FS:Beq> Improve cache purge triggering
     // LLDiskCache::initParamSingleton(cache_dir, disk_cache_size, enable_cache_debug_info);
-    LLDiskCache::initParamSingleton(cache_dir, disk_cache_size, enable_cache_debug_info, gSavedSettings.getF32("FSDiskCacheHighWaterPercent"), gSavedSettings.getF32("FSDiskCacheLowWaterPercent"));
+    LLDiskCache::initParamSingleton(cache_dir, disk_cache_size, enable_cache_debug_info, gSavedSettings.getF32("FSDiskCacheHighWaterPercent"), gSavedSettings.getF32("FSDiskCacheLowWaterPercent"), read_only);
     // </FS:Beq>
 
     if (!read_only)
@@ -5117,6 +5168,9 @@ bool LLAppViewer::initCache()
             // purge excessive files from the new file system based cache
             LLDiskCache::getInstance()->purge();
         }
+
+        // only now, packing is left to the purge thread rather than slowing down startup
+        LLDiskCache::getInstance()->setPackMaxFileSize(gSavedSettings.getU32("DiskCachePackMaxFileSize"));
     }
     LLAppViewer::getPurgeDiskCacheThread()->start();
 
@@ -5363,11 +5417,18 @@ void LLAppViewer::saveFinalSnapshot()
 
 void LLAppViewer::loadNameCache()
 {
-    // display names cache
+    // display names cache, binary LLSD since it replaced avatar_name_cache.xml
     std::string filename =
+        gDirUtilp->getExpandedFilename(LL_PATH_CACHE, "avatar_name_cache.llsd");
+    std::string legacy_filename =
         gDirUtilp->getExpandedFilename(LL_PATH_CACHE, "avatar_name_cache.xml");
+    if (!LLFile::isfile(filename) && LLFile::isfile(legacy_filename))
+    {
+        // import the XML cache once, the next save writes the binary one
+        filename = legacy_filename;
+    }
     LL_INFOS("AvNameCache") << filename << LL_ENDL;
-    llifstream name_cache_stream(filename.c_str());
+    llifstream name_cache_stream(filename.c_str(), std::ios::in | std::ios::binary);
     if(name_cache_stream.is_open())
     {
         if ( ! LLAvatarNameCache::getInstance()->importFile(name_cache_stream))
@@ -5376,6 +5437,11 @@ void LLAppViewer::loadNameCache()
             name_cache_stream.close();
             LLFile::remove(filename);
         }
+        else if (filename == legacy_filename)
+        {
+            name_cache_stream.close();
+            LLFile::remove(legacy_filename);
+        }
     }
 
     if (!gCacheName) return;
@@ -5393,8 +5459,8 @@ void LLAppViewer::saveNameCache()
 {
     // display names cache
     std::string filename =
-        gDirUtilp->getExpandedFilename(LL_PATH_CACHE, "avatar_name_cache.xml");
-    llofstream name_cache_stream(filename.c_str());
+        gDirUtilp->getExpandedFilename(LL_PATH_CACHE, "avatar_name_cache.llsd");
+    llofstream name_cache_stream(filename.c_str(), std::ios::out | std::ios::binary);
     if(name_cache_stream.is_open())
     {
         LLAvatarNameCache::getInstance()->exportFile(name_cache_stream);
@@ -5474,24 +5540,15 @@ void LLAppViewer::idle()
     F32 dt_raw = idle_timer.getElapsedTimeAndResetF32();
 
     LLGLTFMaterialList::flushUpdates();
+    gGLTFMaterialList.applyPendingOverrides();
+    LLControlGroup::fireBatchedCallbacks();
 
     static LLCachedControl<U32> downscale_method(gSavedSettings, "RenderDownScaleMethod");
     gGLManager.mDownScaleMethod = downscale_method;
     LLImageGL::updateClass();
 
-    // Service the WorkQueue we use for replies from worker threads.
-    // Use function statics for the timeslice setting so we only have to fetch
-    // and convert MainWorkTime once.
-    static F32 MainWorkTimeRaw = gSavedSettings.getF32("MainWorkTime");
-    static F32Milliseconds MainWorkTimeMs(MainWorkTimeRaw);
-    // MainWorkTime is specified in fractional milliseconds, but std::chrono
-    // uses integer representations. What if we want less than a microsecond?
-    // Use nanoseconds. We're very sure we will never need to specify a
-    // MainWorkTime that would be larger than we could express in
-    // std::chrono::nanoseconds.
-    static std::chrono::nanoseconds MainWorkTimeNanoSec{
-        std::chrono::nanoseconds::rep(MainWorkTimeMs.value() * 1000000)};
-    gMainloopWork.runFor(MainWorkTimeNanoSec);
+    // Service the WorkQueues we use for replies from worker threads.
+    runMainWork();
 
     // Cap out-of-control frame times
     // Too low because in menus, swapping, debugger, etc.
@@ -5533,6 +5590,9 @@ void LLAppViewer::idle()
     // here.
     LLIMProcessing::requestOfflineMessages();
 
+    // Texture pipeline benchmark replay doesn't need a region
+    LLTextureFetchBenchmark::idle();
+
     ///////////////////////////////////
     //
     // Special case idle if still starting up
@@ -5577,6 +5637,11 @@ void LLAppViewer::idle()
             gAgent.autoPilot(&yaw);
         }
 
+        if (LLSceneBenchmark::instanceExists())
+        {
+            LLSceneBenchmark::getInstance()->idle();
+        }
+
         static LLFrameTimer agent_update_timer;
 
         // When appropriate, update agent location to the simulator.
@@ -6096,9 +6161,63 @@ void LLAppViewer::updateNameLookupUrl(const LLViewerRegion * regionp)
     }
 }
 
-void LLAppViewer::postToMainCoro(const LL::WorkQueue::Work& work)
+void LLAppViewer::postToMainCoro(const LL::WorkQueue::Work& work, EMainWorkLane lane)
 {
-    gMainloopWork.post(work);
+    getMainWorkQueue(lane).post(work);
+}
+
+// static
+LL::WorkQueue& LLAppViewer::getMainWorkQueue(EMainWorkLane lane)
+{
+    switch (lane)
+    {
+    case MAIN_WORK_UI:          return sMainloopUIWork;
+    case MAIN_WORK_RENDER:      return sMainloopRenderWork;
+    case MAIN_WORK_BACKGROUND:  return sMainloopBackgroundWork;
+    default:                    return gMainloopWork;
+    }
+}
+
+static LLTrace::BlockTimerStatHandle FTM_MAIN_WORK[LLAppViewer::MAIN_WORK_LANE_COUNT] =
+{
+    LLTrace::BlockTimerStatHandle("Main Work UI"),
+    LLTrace::BlockTimerStatHandle("Main Work Render"),
+    LLTrace::BlockTimerStatHandle("Main Work Streaming"),
+    LLTrace::BlockTimerStatHandle("Main Work Background")
+};
+
+static LLTrace::SampleStatHandle<> MAIN_WORK_BACKLOG[LLAppViewer::MAIN_WORK_LANE_COUNT] =
+{
+    LLTrace::SampleStatHandle<>("mainworkbacklogui", "Main thread UI work waiting"),
+    LLTrace::SampleStatHandle<>("mainworkbacklogrender", "Main thread render work waiting"),
+    LLTrace::SampleStatHandle<>("mainworkbacklogstreaming", "Main thread streaming work waiting"),
+    LLTrace::SampleStatHandle<>("mainworkbacklogbackground", "Main thread background work waiting")
+};
+
+// Serve each lane of main thread work in priority order within its own per frame
+// budget, so a burst of finished fetches or decodes can't starve UI and render work
+// or stretch the frame by more than the sum of the budgets.
+void LLAppViewer::runMainWork()
+{
+    static LLCachedControl<F32> ui_time(gSavedSettings, "MainWorkTimeUI", 0.5f);
+    static LLCachedControl<F32> render_time(gSavedSettings, "MainWorkTimeRender", 1.f);
+    static LLCachedControl<F32> streaming_time(gSavedSettings, "MainWorkTime", 1.f);
+    static LLCachedControl<F32> background_time(gSavedSettings, "MainWorkTimeBackground", 0.5f);
+    const F32 budgets_ms[MAIN_WORK_LANE_COUNT] = { ui_time, render_time, streaming_time, background_time };
+
+    for (S32 lane = 0; lane < MAIN_WORK_LANE_COUNT; ++lane)
+    {
+        LL::WorkQueue& queue = getMainWorkQueue((EMainWorkLane)lane);
+        LLTrace::sample(MAIN_WORK_BACKLOG[lane], (F64)queue.size());
+        if (queue.size() == 0)
+        {
+            continue;
+        }
+
+        LL_RECORD_BLOCK_TIME(FTM_MAIN_WORK[lane]);
+        // Budgets are fractional milliseconds, std::chrono wants integers: use nanoseconds
+        queue.runFor(std::chrono::nanoseconds(std::chrono::nanoseconds::rep(llmax(budgets_ms[lane], 0.f) * 1000000.f)));
+    }
 }
 
 void LLAppViewer::outOfMemorySoftQuit()
@@ -6114,6 +6233,7 @@ void LLAppViewer::outOfMemorySoftQuit()
         gLogoutTimer.reset();
         mQuitRequested = true;
 
+        LLMemTag::logUsage("out of memory");
         LLError::LLUserWarningMsg::showOutOfMemory();
     }
 }
@@ -6239,6 +6359,11 @@ void LLAppViewer::idleNetwork()
         }
 #endif
 
+        if (LLViewerMessageCapture::instanceExists())
+        {
+            LLViewerMessageCapture::getInstance()->idle();
+        }
+
 
 
         // we want to clear the control after sending out all necessary agent updates
@@ -6359,6 +6484,11 @@ void LLAppViewer::disconnectViewer()
     // Also writes cached agent settings to gSavedSettings
     gAgent.cleanup();
 
+    if (LLViewerMessageCapture::instanceExists())
+    {
+        LLViewerMessageCapture::getInstance()->stop();
+    }
+
     // This is where we used to call gObjectList.destroy() and then delete gWorldp.
     // Now we just ask the LLWorld singleton to cleanly shut down.
     if(LLWorld::instanceExists())
@@ -6549,6 +6679,8 @@ void LLAppViewer::handleLoginComplete()
     gLoggedInTime.start();
     initMainloopTimeout("Mainloop Init");
 
+    LLViewerMessageCapture::getInstance()->start();
+
     // Store some data to DebugInfo in case of a freeze.
     gDebugInfo["ClientInfo"]["Name"] = LLVersionInfo::instance().getChannel();
 // [SL:KB] - Patch: Viewer-CrashReporting | Checked: 2011-05-08 (Catznip-2.6.0a) | Added: Catznip-2.6.0a
@@ -236,8 +236,21 @@ public:
 
     void updateNameLookupUrl(const LLViewerRegion* regionp);
 
-    // post given work to the "mainloop" work queue for handling on the main thread
-    void postToMainCoro(const LL::WorkQueue::Work& work);
+    // Lanes of main thread work, served in this order every frame, each within its own
+    // MainWorkTime* budget.  MAIN_WORK_STREAMING is the "mainloop" queue that work goes
+    // to unless its poster picks a lane.
+    enum EMainWorkLane
+    {
+        MAIN_WORK_UI,           // "mainloop-ui", input and UI responses
+        MAIN_WORK_RENDER,       // "mainloop-render", needed to draw the next frame right
+        MAIN_WORK_STREAMING,    // "mainloop", replies from fetch and decode threads
+        MAIN_WORK_BACKGROUND,   // "mainloop-background", anything that can wait
+        MAIN_WORK_LANE_COUNT
+    };
+
+    // post given work to one of the main thread work queues
+    void postToMainCoro(const LL::WorkQueue::Work& work, EMainWorkLane lane = MAIN_WORK_STREAMING);
+    static LL::WorkQueue& getMainWorkQueue(EMainWorkLane lane);
 
     // Attempt a 'soft' quit with disconnect and saving of settings/cache.
     // Intended to be thread safe.
@@ -287,6 +300,7 @@ private:
     bool markerIsSameVersion(const std::string& marker_name) const;
 
     void idle();
+    void runMainWork();
     void idleShutdown();
     // update avatar SLID and display name caches
     void idleNameCache();
@@ -33,6 +33,7 @@
 #include "llinventorymodel.h"
 #include "llstartup.h"
 #include "lltooldraganddrop.h" // pack_permissions_slam
+#include "llviewercontrol.h"
 #include "llviewerinventory.h"
 #include "llviewerregion.h"
 #include "message.h"
@@ -102,6 +103,10 @@ void LLAttachmentsMgr::addAttachmentRequest(const LLUUID& item_id,
     }
 // [/RLVa:KB]
 
+    if (mPendingAttachments.empty())
+    {
+        selfStartPhase("attachment_requests");
+    }
     mPendingAttachments.push_back(attachment);
 
     mAttachmentRequests.addTime(item_id);
@@ -152,6 +157,10 @@ void LLAttachmentsMgr::requestPendingAttachments()
     if (mPendingAttachments.size())
     {
         requestAttachments(mPendingAttachments);
+        if (mPendingAttachments.empty())
+        {
+            selfStopPhase("attachment_requests", false);
+        }
     }
 }
 
@@ -173,8 +182,21 @@ void LLAttachmentsMgr::requestAttachments(attachments_vec_t& attachment_requests
     // <FS:Ansariel> FIRE-6070: Batching attachment requests is most-likely causing issues
     //               when replacing already worn attachments
     //const S32 max_objects_per_request = 5;
-    const S32 max_objects_per_request = 1;
-    S32 obj_count = llmin((S32)attachment_requests.size(),max_objects_per_request);
+    // Replacing requests still go one at a time, but a run of adding requests,
+    // which is what wearing an outfit produces, is batched.
+    static LLCachedControl<U32> batch_size(gSavedSettings, "AttachmentRequestBatchSize", 4);
+    const S32 max_objects_per_request = llmax((S32)batch_size(), 1);
+    S32 obj_count = 0;
+    while (obj_count < llmin((S32)attachment_requests.size(), max_objects_per_request))
+    {
+        if (!attachment_requests[obj_count].mAdd)
+        {
+            // send a replacing request on its own
+            obj_count = obj_count ? obj_count : 1;
+            break;
+        }
+        obj_count++;
+    }
     if (obj_count == 0)
     {
         return;
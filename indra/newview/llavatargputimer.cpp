@@ -0,0 +1,206 @@
+/**
+ * @file llavatargputimer.cpp
+ * @brief GPU time of each avatar's draws in the rendered frame
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llavatargputimer.h"
+
+#include "llgl.h"
+#include "llviewercontrol.h"
+#include "llvoavatar.h"
+#include "pipeline.h"
+
+#include <deque>
+#include <map>
+#include <vector>
+
+namespace
+{
+    struct Mark
+    {
+        LLUUID mAvatar;     // null for time that belongs to no avatar
+        bool mShadow;
+        GLuint mQuery;
+    };
+
+    typedef std::vector<Mark> frame_t;
+
+    // frames still waiting for their timestamps before we drop the oldest
+    const size_t MAX_PENDING_FRAMES = 4;
+    // weight of the newest frame in the per avatar averages
+    const F32 FRAME_WEIGHT = 0.1f;
+
+    frame_t sCurrentFrame;
+    std::deque<frame_t> sPendingFrames;
+    std::vector<GLuint> sFreeQueries;
+}
+
+bool LLAvatarGPUTimer::sEnabled = false;
+const LLVOAvatar* LLAvatarGPUTimer::sCurrentAvatar = NULL;
+
+// static
+void LLAvatarGPUTimer::addMark(const LLVOAvatar* avatar)
+{
+    if (LLPipeline::sImpostorRender)
+    { // impostor and profile renders are accounted for by LLPipeline::profileAvatar()
+        return;
+    }
+
+    GLuint query = 0;
+    if (sFreeQueries.empty())
+    {
+        glGenQueries(1, &query);
+    }
+    else
+    {
+        query = sFreeQueries.back();
+        sFreeQueries.pop_back();
+    }
+    glQueryCounter(query, GL_TIMESTAMP);
+    sCurrentFrame.push_back({ avatar ? avatar->getID() : LLUUID::null, LLPipeline::sShadowRender, query });
+    sCurrentAvatar = avatar;
+}
+
+// static
+void LLAvatarGPUTimer::endFrame()
+{
+    static LLCachedControl<bool> enabled(gSavedSettings, "RenderAvatarGPUTimers", true);
+
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_AVATAR;
+
+    mark(NULL);
+    if (sEnabled)
+    {
+        sPendingFrames.push_back(std::move(sCurrentFrame));
+        sCurrentFrame.clear();
+    }
+
+    bool was_enabled = sEnabled;
+    // timestamp queries need GL 3.3, same as LLPipeline::profileAvatar()
+    sEnabled = enabled && gGLManager.mInited && gGLManager.mGLVersion >= 3.25f;
+
+    readFrames();
+
+    if (was_enabled && !sEnabled)
+    {
+        for (LLCharacter* character : LLCharacter::sInstances)
+        {
+            LLVOAvatar* avatar = (LLVOAvatar*)character;
+            avatar->mGPUSceneTime = 0.f;
+            avatar->mGPUShadowTime = 0.f;
+        }
+    }
+}
+
+// static
+void LLAvatarGPUTimer::readFrames()
+{
+    // queries finish in order, stop at the first frame that isn't ready
+    while (!sPendingFrames.empty())
+    {
+        frame_t& frame = sPendingFrames.front();
+        GLuint available = GL_TRUE;
+        if (!frame.empty())
+        {
+            glGetQueryObjectuiv(frame.back().mQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+        }
+        if (!available && sPendingFrames.size() < MAX_PENDING_FRAMES)
+        {
+            break;
+        }
+
+        if (available && sEnabled)
+        {
+            // ms per avatar, all passes and shadow passes only
+            std::map<LLUUID, std::pair<F32, F32> > times;
+            GLuint64 prev = 0;
+            for (size_t i = 0; i < frame.size(); ++i)
+            {
+                GLuint64 time = 0;
+                glGetQueryObjectui64v(frame[i].mQuery, GL_QUERY_RESULT, &time);
+                if (i > 0 && frame[i - 1].mAvatar.notNull())
+                {
+                    // GPU timestamps are in nanoseconds
+                    F32 ms = (F32)(time - prev) / 1000000.f;
+                    auto& avatar_times = times[frame[i - 1].mAvatar];
+                    avatar_times.first += ms;
+                    if (frame[i - 1].mShadow)
+                    {
+                        avatar_times.second += ms;
+                    }
+                }
+                prev = time;
+            }
+
+            for (LLCharacter* character : LLCharacter::sInstances)
+            {
+                LLVOAvatar* avatar = (LLVOAvatar*)character;
+                if (avatar->isTooSlow())
+                { // like profileAvatar(), keep what made it too slow rather than what it costs with shadows
+                  // and attachments already taken away
+                    continue;
+                }
+                auto it = times.find(avatar->getID());
+                F32 scene_ms = it != times.end() ? it->second.first : 0.f;
+                F32 shadow_ms = it != times.end() ? it->second.second : 0.f;
+                avatar->mGPUSceneTime = lerp(avatar->mGPUSceneTime, scene_ms, FRAME_WEIGHT);
+                avatar->mGPUShadowTime = lerp(avatar->mGPUShadowTime, shadow_ms, FRAME_WEIGHT);
+            }
+        }
+
+        for (const Mark& mark : frame)
+        {
+            sFreeQueries.push_back(mark.mQuery);
+        }
+        sPendingFrames.pop_front();
+    }
+}
+
+// static
+void LLAvatarGPUTimer::destroyGL()
+{
+    for (const frame_t& frame : sPendingFrames)
+    {
+        for (const Mark& mark : frame)
+        {
+            sFreeQueries.push_back(mark.mQuery);
+        }
+    }
+    for (const Mark& mark : sCurrentFrame)
+    {
+        sFreeQueries.push_back(mark.mQuery);
+    }
+    sPendingFrames.clear();
+    sCurrentFrame.clear();
+    sCurrentAvatar = NULL;
+
+    if (!sFreeQueries.empty())
+    {
+        glDeleteQueries((GLsizei)sFreeQueries.size(), sFreeQueries.data());
+        sFreeQueries.clear();
+    }
+}
@@ -0,0 +1,63 @@
+/**
+ * @file llavatargputimer.h
+ * @brief GPU time of each avatar's draws in the rendered frame
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#pragma once
+
+class LLVOAvatar;
+
+// Measures what each avatar costs the GPU in the frame as it is actually rendered, shadow
+// and alpha passes included, as opposed to LLPipeline::profileAvatar() which times one
+// offscreen draw of the avatar.  Draw loops call mark() wherever they switch to another
+// avatar's geometry and mark(NULL) when they are done; a GL timestamp is taken at every
+// switch and the time up to the next one goes to that avatar.  Rigged draws are sorted by
+// avatar, so this is a handful of timestamps per pass rather than one per draw call.
+//
+// Timestamps are read a few frames later, once the GPU got to them, and never waited for.
+// The results end up in LLVOAvatar::getGPUSceneTime().
+class LLAvatarGPUTimer
+{
+public:
+    // Attribute the GPU time from here to the next mark to avatar, NULL for no avatar
+    static void mark(const LLVOAvatar* avatar)
+    {
+        if (sEnabled && avatar != sCurrentAvatar)
+        {
+            addMark(avatar);
+        }
+    }
+
+    // Close the frame, pick up the results of earlier frames and hand them to the avatars
+    static void endFrame();
+
+    static void destroyGL();
+
+private:
+    static void addMark(const LLVOAvatar* avatar);
+    static void readFrames();
+
+    static bool sEnabled;
+    static const LLVOAvatar* sCurrentAvatar;
+};
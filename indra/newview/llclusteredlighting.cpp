@@ -0,0 +1,180 @@
+/**
+ * @file llclusteredlighting.cpp
+ * @brief LLClusteredLighting class implementation
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llclusteredlighting.h"
+
+#include "llgpupasstimer.h"
+#include "llrender.h"
+#include "llviewercamera.h"
+#include "llviewercontrol.h"
+#include "llviewershadermgr.h"
+#include "pipeline.h"
+
+static LLStaticHashedString sLightCount("light_count");
+static LLStaticHashedString sClusterDepth("cluster_depth");
+static LLStaticHashedString sClusterDebug("cluster_debug");
+
+constexpr U32 CLUSTER_GROUP_SIZE = 64;  // local_size_x of clusterLightsC.glsl
+
+LLClusteredLighting::~LLClusteredLighting()
+{
+    cleanup();
+}
+
+//static
+bool LLClusteredLighting::isEnabled()
+{
+#if LL_DARWIN
+    return false;
+#else
+    static LLCachedControl<bool> clustered_lighting(gSavedSettings, "RenderClusteredLighting", false);
+    return clustered_lighting &&
+        gGLManager.mGLVersion >= 4.29f &&
+        gClusterLightsProgram.isComplete() &&
+        gDeferredClusterLightProgram.isComplete();
+#endif
+}
+
+void LLClusteredLighting::cleanup()
+{
+#if !LL_DARWIN
+    if (mLightBuffer)
+    {
+        glDeleteBuffers(1, &mLightBuffer);
+        glDeleteBuffers(1, &mCountBuffer);
+        glDeleteBuffers(1, &mIndexBuffer);
+        mLightBuffer = mCountBuffer = mIndexBuffer = 0;
+    }
+#endif
+    mLights.clear();
+}
+
+bool LLClusteredLighting::addLight(const LLVector4& light, const LLVector4& color)
+{
+    if (mLights.size() >= MAX_LIGHTS * 2)
+    {
+        return false;
+    }
+
+    // view space looks down -z
+    F32 near_depth = -light.mV[2] - light.mV[3];
+    F32 far_depth = -light.mV[2] + light.mV[3];
+
+    if (mLights.empty())
+    {
+        mNearDepth = near_depth;
+        mFarDepth = far_depth;
+    }
+    else
+    {
+        mNearDepth = llmin(mNearDepth, near_depth);
+        mFarDepth = llmax(mFarDepth, far_depth);
+    }
+
+    mLights.push_back(light);
+    mLights.push_back(color);
+    return true;
+}
+
+void LLClusteredLighting::render(LLCamera& camera)
+{
+#if !LL_DARWIN
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_PIPELINE;
+    LL_PROFILE_GPU_ZONE("clustered lights");
+    LL_RECORD_GPU_PASS("clustered lights");
+
+    if (mLights.empty())
+    {
+        return;
+    }
+
+    static LLCachedControl<bool> cluster_debug(gSavedSettings, "RenderClusteredLightingDebug", false);
+
+    // fit the depth slices to the lights, a tight range spreads lights over more slices
+    F32 near_depth = llmax(mNearDepth, camera.getNear());
+    F32 far_depth = llclamp(mFarDepth, near_depth + 1.f, llmax(camera.getFar(), near_depth + 1.f));
+
+    U32 light_count = (U32)mLights.size() / 2;
+    U32 cluster_count = CLUSTER_X * CLUSTER_Y * CLUSTER_Z;
+
+    if (!mLightBuffer)
+    {
+        glGenBuffers(1, &mLightBuffer);
+        glGenBuffers(1, &mCountBuffer);
+        glGenBuffers(1, &mIndexBuffer);
+
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, mCountBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, cluster_count * sizeof(U32), nullptr, GL_DYNAMIC_COPY);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, mIndexBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, cluster_count * CLUSTER_MAX_LIGHTS * sizeof(U32), nullptr, GL_DYNAMIC_COPY);
+    }
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, mLightBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, mLights.size() * sizeof(LLVector4), mLights.data(), GL_STREAM_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, mLightBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, mCountBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, mIndexBuffer);
+
+    {
+        LL_PROFILE_ZONE_NAMED_CATEGORY_PIPELINE("cluster bin");
+        LLGLSLShader* shader = &gClusterLightsProgram;
+        shader->bind();
+        gGL.syncMatrices(); // inv_proj
+        shader->uniform1i(sLightCount, light_count);
+        shader->uniform2f(sClusterDepth, near_depth, far_depth);
+
+        glDispatchCompute((cluster_count + CLUSTER_GROUP_SIZE - 1) / CLUSTER_GROUP_SIZE, 1, 1);
+
+        // cluster lists are read by the fragment shader below
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+        shader->unbind();
+    }
+
+    {
+        LL_PROFILE_ZONE_NAMED_CATEGORY_PIPELINE("cluster shade");
+        LLGLDepthTest depth(GL_FALSE);
+        LLGLSLShader* shader = &gDeferredClusterLightProgram;
+        gPipeline.bindDeferredShader(*shader);
+        shader->uniform2f(sClusterDepth, near_depth, far_depth);
+        shader->uniform1i(sClusterDebug, cluster_debug ? 1 : 0);
+
+        gPipeline.mScreenTriangleVB->setBuffer();
+        gPipeline.mScreenTriangleVB->drawArrays(LLRender::TRIANGLES, 0, 3);
+        gPipeline.unbindDeferredShader(*shader);
+    }
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, 0);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, 0);
+#endif
+
+    mLights.clear();
+}
@@ -0,0 +1,81 @@
+/**
+ * @file llclusteredlighting.h
+ * @brief LLClusteredLighting class declaration
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+
+#pragma once
+
+#include "llgl.h"
+#include "v4math.h"
+
+#include <vector>
+
+class LLCamera;
+
+// Shades local point lights in a single full screen pass instead of one light volume per light.
+// A compute pass bins the lights into view space clusters (screen tiles x exponential depth slices),
+// then clusterLightF.glsl walks only the lights binned into each pixel's cluster.
+// Spot lights and anything that doesn't fit in the light buffer still go through the per-light path.
+class LLClusteredLighting
+{
+public:
+    static constexpr U32 CLUSTER_X = 16;
+    static constexpr U32 CLUSTER_Y = 9;
+    static constexpr U32 CLUSTER_Z = 24;
+    static constexpr U32 CLUSTER_MAX_LIGHTS = 64;   // lights per cluster, extra lights in a cluster are dropped
+    static constexpr U32 MAX_LIGHTS = 1024;         // lights per frame
+
+    LLClusteredLighting() = default;
+    ~LLClusteredLighting();
+
+    // true if clustered lighting is enabled (RenderClusteredLighting) and supported
+    static bool isEnabled();
+
+    // release any GL state and drop queued lights
+    void cleanup();
+
+    // queue a point light for this frame
+    // light is view space position + radius, color is linear color + falloff, as sent to multiPointLightF.glsl
+    // returns false if the light buffer is full and the light must be drawn some other way
+    bool addLight(const LLVector4& light, const LLVector4& color);
+
+    bool hasLights() const { return !mLights.empty(); }
+
+    // bin queued lights and shade them, then clear the queue
+    // must be called with additive blending set up, like the other deferred local light passes
+    void render(LLCamera& camera);
+
+private:
+    GLuint mLightBuffer = 0;
+    GLuint mCountBuffer = 0;
+    GLuint mIndexBuffer = 0;
+
+    // pairs of light + color, see addLight
+    std::vector<LLVector4> mLights;
+
+    // view space depth range covered by queued lights
+    F32 mNearDepth = 0.f;
+    F32 mFarDepth = 0.f;
+};
@@ -116,7 +116,8 @@ void LLConversationItem::postEvent(const std::string& event_type, LLConversation
     LLUUID session_id = (session ? session->getUUID() : LLUUID());
     LLUUID participant_id = (participant ? participant->getUUID() : LLUUID());
     LLSD event(LLSDMap("type", event_type)("session_uuid", session_id)("participant_uuid", participant_id));
-    LLEventPumps::instance().obtain("ConversationsEvents").post(event);
+    static LLCachedEventPump sConversationsEvents("ConversationsEvents");
+    sConversationsEvents.post(event);
 }
 
 // Virtual action callbacks
@@ -53,6 +53,7 @@
 #include "llvocache.h"
 #include "llcontrolavatar.h"
 #include "lldrawpoolavatar.h"
+#include "llslabpool.h"
 
 // <FS:ND> Tentatively ignoring mismatched new/delete from the MemTrackableNonVirtual. I think according to the docs
 // they are properly matched
@@ -96,6 +97,29 @@ void LLDrawable::incrementVisible()
     sCurPixelAngle = (F32) gViewerWindow->getWindowHeightRaw()/LLViewerCamera::getInstance()->getView();
 }
 
+static LLMemTag sDrawableMemTag("Drawables");
+
+static LLSizedSlabPools& get_drawable_pools()
+{
+    // never destroyed, drawables may be released during static destruction
+    static LLSizedSlabPools* pools = new LLSizedSlabPools(&sDrawableMemTag, 1024);
+    return *pools;
+}
+
+//static
+void* LLDrawable::operator new(size_t size)
+{
+    llassert(on_main_thread());
+    return get_drawable_pools().allocate(size);
+}
+
+//static
+void LLDrawable::operator delete(void* ptr, size_t size)
+{
+    llassert(on_main_thread());
+    get_drawable_pools().free(ptr, size);
+}
+
 LLDrawable::LLDrawable(LLViewerObject *vobj, bool new_entry)
 :   LLViewerOctreeEntryData(LLViewerOctreeEntry::LLDRAWABLE),
     mVObjp(vobj)
@@ -864,6 +888,12 @@ void LLDrawable::updateDistance(LLCamera& camera, bool force_update)
         return;
     }
 
+    calcDistance(camera, LLViewerCamera::getInstance()->getOrigin(), force_update);
+    mVObjp->updateLOD();
+}
+
+void LLDrawable::calcDistance(const LLCamera& camera, const LLVector3& viewer_camera_origin, bool force_update)
+{
     //switch LOD with the spatial group to avoid artifacts
     //LLSpatialGroup* sg = getSpatialGroup();
 
@@ -918,10 +948,9 @@ void LLDrawable::updateDistance(LLCamera& camera, bool force_update)
             {
                 const LLVector3* av_box = avatarp->getLastAnimExtents();
             // </FS:Beq pp Rye>
-                LLVector3 cam_pos_from_agent = LLViewerCamera::getInstance()->getOrigin();
+                LLVector3 cam_pos_from_agent = viewer_camera_origin;
                 LLVector3 cam_to_box_offset = point_to_box_offset(cam_pos_from_agent, av_box);
                 mDistanceWRTCamera = llmax(0.01f, ll_round(cam_to_box_offset.magVec(), 0.01f));
-                mVObjp->updateLOD();
                 return;
             }
         }
@@ -932,7 +961,6 @@ void LLDrawable::updateDistance(LLCamera& camera, bool force_update)
 
         pos -= camera.getOrigin();
         mDistanceWRTCamera = ll_round(pos.magVec(), 0.01f);
-        mVObjp->updateLOD();
     }
 }
 
@@ -63,8 +63,12 @@ LL_ALIGN_PREFIX(16)
 class LLDrawable
     : public LLViewerOctreeEntryData
 {
-    LL_ALIGN_NEW;
 public:
+    // Drawables and spatial bridges come from one LLSlabPool per class size.
+    // Threads:  Tmain
+    void* operator new(size_t size);
+    void operator delete(void* ptr, size_t size);
+
     typedef std::vector<LLFace*> face_list_t;
 
     LLDrawable(const LLDrawable& rhs)
@@ -166,6 +170,9 @@ public:
     void updateTexture();
     void updateMaterial();
     virtual void updateDistance(LLCamera& camera, bool force_update);
+    // the distance half of updateDistance() without the LOD update; touches only this
+    // drawable and its faces, so it may run on a worker thread for distinct drawables
+    void calcDistance(const LLCamera& camera, const LLVector3& viewer_camera_origin, bool force_update);
     bool updateGeometry();
     void updateFaceSize(S32 idx);
 
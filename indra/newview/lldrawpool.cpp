@@ -28,6 +28,7 @@
 
 #include "lldrawpool.h"
 #include "llrender.h"
+#include "llavatargputimer.h"
 #include "llfasttimer.h"
 #include "llviewercontrol.h"
 
@@ -479,6 +480,7 @@ void LLRenderPass::pushRiggedBatches(U32 type, bool texture, bool batch_textures
 
             if (pparams->mAvatar.notNull() && (lastAvatar != pparams->mAvatar || lastMeshId != pparams->mSkinInfo->mHash))
             {
+                LLAvatarGPUTimer::mark(pparams->mAvatar);
                 uploadMatrixPalette(*pparams);
                 lastAvatar = pparams->mAvatar;
                 lastMeshId = pparams->mSkinInfo->mHash;
@@ -486,6 +488,7 @@ void LLRenderPass::pushRiggedBatches(U32 type, bool texture, bool batch_textures
 
             pushBatch(*pparams, texture, batch_textures);
         }
+        LLAvatarGPUTimer::mark(NULL);
     }
     else
     {
@@ -507,6 +510,7 @@ void LLRenderPass::pushUntexturedRiggedBatches(U32 type)
 
         if (pparams->mAvatar.notNull() && (lastAvatar != pparams->mAvatar || lastMeshId != pparams->mSkinInfo->mHash))
         {
+            LLAvatarGPUTimer::mark(pparams->mAvatar);
             uploadMatrixPalette(*pparams);
             lastAvatar = pparams->mAvatar;
             lastMeshId = pparams->mSkinInfo->mHash;
@@ -514,6 +518,7 @@ void LLRenderPass::pushUntexturedRiggedBatches(U32 type)
 
         pushUntexturedBatch(*pparams);
     }
+    LLAvatarGPUTimer::mark(NULL);
 }
 
 void LLRenderPass::pushMaskBatches(U32 type, bool texture, bool batch_textures)
@@ -556,6 +561,7 @@ void LLRenderPass::pushRiggedMaskBatches(U32 type, bool texture, bool batch_text
 
         if (lastAvatar != pparams->mAvatar || lastMeshId != pparams->mSkinInfo->mHash)
         {
+            LLAvatarGPUTimer::mark(pparams->mAvatar);
             uploadMatrixPalette(*pparams);
             lastAvatar = pparams->mAvatar;
             lastMeshId = pparams->mSkinInfo->mHash;
@@ -563,6 +569,25 @@ void LLRenderPass::pushRiggedMaskBatches(U32 type, bool texture, bool batch_text
 
         pushBatch(*pparams, texture, batch_textures);
     }
+    LLAvatarGPUTimer::mark(NULL);
+}
+
+// static
+void LLRenderPass::drawGeometry(LLDrawInfo& params)
+{
+    static LLCachedControl<bool> meshlet_culling(gSavedSettings, "RenderMeshletCulling", true);
+    if (params.mMeshletCull.notNull() && meshlet_culling &&
+        !LLPipeline::sShadowRender && // light sees the other side
+        !LLPipeline::sReflectionRender &&
+        !LLPipeline::sRenderingHUDs &&
+        params.mMeshletCull->getIndexCount() == params.mCount)
+    {
+        params.mVertexBuffer->drawMulti(LLRender::TRIANGLES,
+            params.mMeshletCull->getDraws(params.mModelMatrix, LLViewerCamera::getInstance()->getOrigin()));
+        return;
+    }
+
+    params.mVertexBuffer->drawRange(LLRender::TRIANGLES, params.mStart, params.mEnd, params.mCount, params.mOffset);
 }
 
 void LLRenderPass::applyModelMatrix(const LLDrawInfo& params)
@@ -638,7 +663,7 @@ void LLRenderPass::pushBatch(LLDrawInfo& params, bool texture, bool batch_textur
     }
     // </FS:Beq>
     params.mVertexBuffer->setBuffer();
-    params.mVertexBuffer->drawRange(LLRender::TRIANGLES, params.mStart, params.mEnd, params.mCount, params.mOffset);
+    drawGeometry(params);
     if (tex_setup)
     {
         gGL.matrixMode(LLRender::MM_TEXTURE0);
@@ -659,12 +684,17 @@ void LLRenderPass::pushUntexturedBatch(LLDrawInfo& params)
     applyModelMatrix(params);
 
     params.mVertexBuffer->setBuffer();
-    params.mVertexBuffer->drawRange(LLRender::TRIANGLES, params.mStart, params.mEnd, params.mCount, params.mOffset);
+    drawGeometry(params);
 }
 
 // static
 bool LLRenderPass::uploadMatrixPalette(LLDrawInfo& params)
 {
+    if (LLGPUSkinning::setupDraw(params))
+    { // already skinned this frame, no palette needed
+        return true;
+    }
+
     // upload matrix palette to shader
     return uploadMatrixPalette(params.mAvatar, params.mSkinInfo);
 }
@@ -672,6 +702,8 @@ bool LLRenderPass::uploadMatrixPalette(LLDrawInfo& params)
 //static
 bool LLRenderPass::uploadMatrixPalette(LLVOAvatar* avatar, LLMeshSkinInfo* skinInfo)
 {
+    LLGPUSkinning::setupPalette();
+
     if (!avatar)
     {
         return false;
@@ -729,6 +761,12 @@ void LLRenderPass::pushGLTFBatches(U32 type, bool textured)
 void LLRenderPass::pushGLTFBatches(U32 type)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_DRAWPOOL;
+    if (useMultiDraw())
+    {
+        pushMultiGLTFBatches(type, true);
+        return;
+    }
+
     auto* begin = gPipeline.beginRenderMap(type);
     auto* end = gPipeline.endRenderMap(type);
     for (LLCullResult::drawinfo_iterator i = begin; i != end; )
@@ -744,6 +782,12 @@ void LLRenderPass::pushGLTFBatches(U32 type)
 void LLRenderPass::pushUntexturedGLTFBatches(U32 type)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_DRAWPOOL;
+    if (useMultiDraw())
+    {
+        pushMultiGLTFBatches(type, false);
+        return;
+    }
+
     auto* begin = gPipeline.beginRenderMap(type);
     auto* end = gPipeline.endRenderMap(type);
     for (LLCullResult::drawinfo_iterator i = begin; i != end; )
@@ -756,6 +800,87 @@ void LLRenderPass::pushUntexturedGLTFBatches(U32 type)
     }
 }
 
+// static
+bool LLRenderPass::useMultiDraw()
+{
+    static LLCachedControl<bool> multi_draw(gSavedSettings, "RenderMultiDrawBatching", false);
+    return multi_draw;
+}
+
+// true if next can be drawn with the same GL state as first
+static bool can_multi_draw_gltf(const LLDrawInfo& first, const LLDrawInfo& next)
+{
+    return first.mMeshletCull.isNull() && next.mMeshletCull.isNull() &&
+        next.mVertexBuffer == first.mVertexBuffer &&
+        next.mGLTFMaterial == first.mGLTFMaterial &&
+        next.mTexture == first.mTexture &&
+        next.mModelMatrix == first.mModelMatrix &&
+        next.mTextureMatrix == nullptr;
+}
+
+static void add_multi_draw(std::vector<LLVertexBuffer::IndirectDraw>& draws, const LLDrawInfo& params)
+{
+    if (params.mCount)
+    {
+        draws.push_back({ params.mCount, 1, params.mOffset, 0, 0 });
+    }
+}
+
+void LLRenderPass::pushMultiGLTFBatches(U32 type, bool textured)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_DRAWPOOL;
+    static std::vector<LLVertexBuffer::IndirectDraw> draws;
+
+    auto* begin = gPipeline.beginRenderMap(type);
+    auto* end = gPipeline.endRenderMap(type);
+    for (LLCullResult::drawinfo_iterator i = begin; i != end; )
+    {
+        LLDrawInfo& params = **i;
+        LLCullResult::increment_iterator(i, end);
+
+        if (!params.mCount || params.mVertexBuffer.isNull())
+        {
+            continue;
+        }
+
+        if (params.mTextureMatrix)
+        { // texture animations need their own draw call
+            textured ? pushGLTFBatch(params) : pushUntexturedGLTFBatch(params);
+            continue;
+        }
+
+        draws.clear();
+        add_multi_draw(draws, params);
+        while (i != end && can_multi_draw_gltf(params, **i))
+        {
+            add_multi_draw(draws, **i);
+            LLCullResult::increment_iterator(i, end);
+        }
+
+        LL_PROFILE_ZONE_NAMED_CATEGORY_DRAWPOOL("pushMultiGLTFBatch");
+        auto& mat = params.mGLTFMaterial;
+
+        if (textured && mat.notNull())
+        {
+            mat->bind(params.mTexture);
+        }
+
+        LLGLDisable cull_face(mat.notNull() && mat->mDoubleSided ? GL_CULL_FACE : 0);
+
+        applyModelMatrix(params);
+
+        params.mVertexBuffer->setBuffer();
+        if (draws.size() == 1)
+        {
+            drawGeometry(params);
+        }
+        else
+        {
+            params.mVertexBuffer->drawMulti(LLRender::TRIANGLES, draws);
+        }
+    }
+}
+
 // static
 void LLRenderPass::pushGLTFBatch(LLDrawInfo& params)
 {
@@ -773,7 +898,7 @@ void LLRenderPass::pushGLTFBatch(LLDrawInfo& params)
     applyModelMatrix(params);
 
     params.mVertexBuffer->setBuffer();
-    params.mVertexBuffer->drawRange(LLRender::TRIANGLES, params.mStart, params.mEnd, params.mCount, params.mOffset);
+    drawGeometry(params);
 
     teardown_texture_matrix(params);
 }
@@ -788,7 +913,7 @@ void LLRenderPass::pushUntexturedGLTFBatch(LLDrawInfo& params)
     applyModelMatrix(params);
 
     params.mVertexBuffer->setBuffer();
-    params.mVertexBuffer->drawRange(LLRender::TRIANGLES, params.mStart, params.mEnd, params.mCount, params.mOffset);
+    drawGeometry(params);
 }
 
 void LLRenderPass::pushRiggedGLTFBatches(U32 type, bool textured)
@@ -819,6 +944,7 @@ void LLRenderPass::pushRiggedGLTFBatches(U32 type)
 
         pushRiggedGLTFBatch(params, lastAvatar, lastMeshId);
     }
+    LLAvatarGPUTimer::mark(NULL);
 }
 
 void LLRenderPass::pushUntexturedRiggedGLTFBatches(U32 type)
@@ -837,6 +963,7 @@ void LLRenderPass::pushUntexturedRiggedGLTFBatches(U32 type)
 
         pushUntexturedRiggedGLTFBatch(params, lastAvatar, lastMeshId);
     }
+    LLAvatarGPUTimer::mark(NULL);
 }
 
 
@@ -845,6 +972,7 @@ void LLRenderPass::pushRiggedGLTFBatch(LLDrawInfo& params, LLVOAvatar*& lastAvat
 {
     if (params.mAvatar.notNull() && (lastAvatar != params.mAvatar || lastMeshId != params.mSkinInfo->mHash))
     {
+        LLAvatarGPUTimer::mark(params.mAvatar);
         uploadMatrixPalette(params);
         lastAvatar = params.mAvatar;
         lastMeshId = params.mSkinInfo->mHash;
@@ -858,6 +986,7 @@ void LLRenderPass::pushUntexturedRiggedGLTFBatch(LLDrawInfo& params, LLVOAvatar*
 {
     if (params.mAvatar.notNull() && (lastAvatar != params.mAvatar || lastMeshId != params.mSkinInfo->mHash))
     {
+        LLAvatarGPUTimer::mark(params.mAvatar);
         uploadMatrixPalette(params);
         lastAvatar = params.mAvatar;
         lastMeshId = params.mSkinInfo->mHash;
@@ -367,6 +367,13 @@ public:
     // helper function for dispatching to textured or untextured pass based on bool
     void pushGLTFBatches(U32 type, bool textured);
 
+    // true if consecutive compatible draw infos should be merged into multi-draw calls (RenderMultiDrawBatching)
+    static bool useMultiDraw();
+
+    // like pushGLTFBatches, but runs of draw infos sharing a vertex buffer, material and transform
+    // are submitted as a single multi-draw call
+    void pushMultiGLTFBatches(U32 type, bool textured);
+
 
     // rigged variants of above
     void pushRiggedGLTFBatches(U32 type);
@@ -386,6 +393,9 @@ public:
     void pushBumpBatch(LLDrawInfo& params, bool texture, bool batch_textures = false);
     static bool uploadMatrixPalette(LLDrawInfo& params);
     static bool uploadMatrixPalette(LLVOAvatar* avatar, LLMeshSkinInfo* skinInfo);
+    // draw the index range of params less any meshlets facing away from the camera,
+    // vertex buffer must be set
+    static void drawGeometry(LLDrawInfo& params);
     virtual void renderGroup(LLSpatialGroup* group, U32 type, bool texture = true);
     virtual void renderRiggedGroup(LLSpatialGroup* group, U32 type, bool texture = true);
 };
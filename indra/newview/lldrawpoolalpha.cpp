@@ -28,6 +28,7 @@
 
 #include "lldrawpoolalpha.h"
 
+#include "llavatargputimer.h"
 #include "llglheaders.h"
 #include "llviewercontrol.h"
 #include "llcriticaldamp.h"
@@ -555,6 +556,7 @@ void LLDrawPoolAlpha::renderRiggedEmissives(std::vector<LLDrawInfo*>& emissives)
         bool tex_setup = TexSetup(draw, false);
         if (lastAvatar != draw->mAvatar || lastMeshId != draw->mSkinInfo->mHash)
         {
+            LLAvatarGPUTimer::mark(draw->mAvatar);
             if (!uploadMatrixPalette(*draw))
             { // failed to upload matrix palette, skip rendering
                 continue;
@@ -579,6 +581,7 @@ void LLDrawPoolAlpha::renderRiggedPbrEmissives(std::vector<LLDrawInfo*>& emissiv
     {
         if (lastAvatar != draw->mAvatar || lastMeshId != draw->mSkinInfo->mHash)
         {
+            LLAvatarGPUTimer::mark(draw->mAvatar);
             if (!uploadMatrixPalette(*draw))
             { // failed to upload matrix palette, skip rendering
                 continue;
@@ -806,6 +809,8 @@ void LLDrawPoolAlpha::renderAlpha(U32 mask, bool depth_only, bool rigged)
 
                 if (params.mAvatar != nullptr)
                 {
+                    // per draw, rigged emissives in between may have moved the mark to another avatar
+                    LLAvatarGPUTimer::mark(params.mAvatar);
                     if (lastAvatar != params.mAvatar ||
                         lastMeshId != params.mSkinInfo->mHash ||
                         lastAvatarShader != LLGLSLShader::sCurBoundShaderPtr)
@@ -931,6 +936,8 @@ void LLDrawPoolAlpha::renderAlpha(U32 mask, bool depth_only, bool rigged)
         }
     }
 
+    LLAvatarGPUTimer::mark(NULL);
+
     gGL.setSceneBlendType(LLRender::BT_ALPHA);
 
     LLVertexBuffer::unbind();
@@ -943,6 +950,11 @@ void LLDrawPoolAlpha::renderAlpha(U32 mask, bool depth_only, bool rigged)
 
 bool LLDrawPoolAlpha::uploadMatrixPalette(const LLDrawInfo& params)
 {
+    if (LLGPUSkinning::setupDraw(params))
+    {
+        return true;
+    }
+
     if (params.mAvatar.isNull())
     {
         return false;
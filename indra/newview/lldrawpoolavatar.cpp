@@ -35,6 +35,7 @@
 #include "llmatrix4a.h"
 
 #include "llagent.h" //for gAgent.needsRenderAvatar()
+#include "llavatargputimer.h"
 #include "lldrawable.h"
 #include "lldrawpoolbump.h"
 #include "llface.h"
@@ -395,6 +396,7 @@ void LLDrawPoolAvatar::renderShadow(S32 pass)
     }
 
     LLDrawPoolAvatar::sShadowPass = pass;
+    LLAvatarGPUTimer::mark(avatarp);
 
     if (pass == SHADOW_PASS_AVATAR_OPAQUE)
     {
@@ -414,6 +416,8 @@ void LLDrawPoolAvatar::renderShadow(S32 pass)
         avatarp->renderSkinned();
         LLDrawPoolAvatar::sSkipOpaque = false;
     }
+
+    LLAvatarGPUTimer::mark(NULL);
 }
 
 S32 LLDrawPoolAvatar::getNumPasses()
@@ -874,22 +878,24 @@ void LLDrawPoolAvatar::renderAvatars(LLVOAvatar* single_avatar, S32 pass)
         if (impostor || (LLVOAvatar::AOA_NORMAL != avatarp->getOverallAppearance() && !avatarp->needsImpostorUpdate()))
         {
             LL_PROFILE_ZONE_NAMED_CATEGORY_AVATAR("render impostor"); // <FS:Beq/> Tracy markup
-            if (LLPipeline::sRenderDeferred && !LLPipeline::sReflectionRender && avatarp->mImpostor.isComplete())
+            if (LLPipeline::sRenderDeferred && !LLPipeline::sReflectionRender && avatarp->hasImpostor())
             {
+                LLRenderTarget& atlas = gPipeline.mImpostorAtlas.getTarget();
                 // <FS:Ansariel> FIRE-9179: Crash fix
                 //if (normal_channel > -1)
-                U32 num_tex = avatarp->mImpostor.getNumTextures();
+                U32 num_tex = atlas.getNumTextures();
                 if (normal_channel > -1 && num_tex >= 3)
                 // </FS:Ansariel>
                 {
-                    avatarp->mImpostor.bindTexture(2, normal_channel);
+                    // point sampling keeps neighbouring tiles from bleeding in
+                    atlas.bindTexture(2, normal_channel, LLTexUnit::TFO_POINT);
                 }
                 // <FS:Ansariel> FIRE-9179: Crash fix
                 //if (specular_channel > -1)
                 if (specular_channel > -1 && num_tex >= 2)
                 // </FS:Ansariel>
                 {
-                    avatarp->mImpostor.bindTexture(1, specular_channel);
+                    atlas.bindTexture(1, specular_channel, LLTexUnit::TFO_POINT);
                 }
             }
             avatarp->renderImpostor(avatarp->getMutedAVColor(), sDiffuseChannel);
@@ -934,7 +940,9 @@ void LLDrawPoolAvatar::renderAvatars(LLVOAvatar* single_avatar, S32 pass)
     if( !single_avatar || (avatarp == single_avatar) )
     {
         LL_PROFILE_ZONE_NAMED_CATEGORY_AVATAR("renderSkinned"); // <FS:Beq/> Tracy markup
+        LLAvatarGPUTimer::mark(avatarp);
         avatarp->renderSkinned();
+        LLAvatarGPUTimer::mark(NULL);
     }
 }
 
@@ -102,6 +102,24 @@ void LLDrawPoolMaterials::endDeferredPass(S32 pass)
     LLRenderPass::endRenderPass(pass);
 }
 
+// true if next uses exactly the same shader state as first and can share its draw call
+static bool can_multi_draw_material(const LLDrawInfo& first, const LLDrawInfo& next)
+{
+    return first.mMeshletCull.isNull() && next.mMeshletCull.isNull() &&
+        next.mVertexBuffer == first.mVertexBuffer &&
+        next.mTexture == first.mTexture &&
+        next.mNormalMap == first.mNormalMap &&
+        next.mSpecularMap == first.mSpecularMap &&
+        next.mModelMatrix == first.mModelMatrix &&
+        next.mTextureMatrix == nullptr &&
+        next.mAvatar == first.mAvatar &&
+        next.mSkinInfo == first.mSkinInfo &&
+        next.mSpecColor == first.mSpecColor &&
+        next.mEnvIntensity == first.mEnvIntensity &&
+        next.mAlphaMaskCutoff == first.mAlphaMaskCutoff &&
+        next.mFullbright == first.mFullbright;
+}
+
 void LLDrawPoolMaterials::renderDeferred(S32 pass)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_MATERIAL;
@@ -185,6 +203,9 @@ void LLDrawPoolMaterials::renderDeferred(S32 pass)
 
     LLVOAvatar* lastAvatar = nullptr;
 
+    bool multi_draw = LLRenderPass::useMultiDraw();
+    static std::vector<LLVertexBuffer::IndirectDraw> draws;
+
     for (LLCullResult::drawinfo_iterator i = begin; i != end; )
     {
         LL_PROFILE_ZONE_NAMED_CATEGORY_MATERIAL("materials draw loop");
@@ -247,7 +268,7 @@ void LLDrawPoolMaterials::renderDeferred(S32 pass)
         // upload matrix palette to shader
         if (rigged && params.mAvatar.notNull())
         {
-            if (params.mAvatar != lastAvatar)
+            if (params.mAvatar != lastAvatar && !LLGPUSkinning::setupDraw(params))
             {
                 const LLVOAvatar::MatrixPaletteCache& mpc = params.mAvatar->updateSkinInfoMatrixPalette(params.mSkinInfo);
                 U32 count = static_cast<U32>(mpc.mMatrixPalette.size());
@@ -287,7 +308,27 @@ void LLDrawPoolMaterials::renderDeferred(S32 pass)
         }*/
 
         params.mVertexBuffer->setBuffer();
-        params.mVertexBuffer->drawRange(LLRender::TRIANGLES, params.mStart, params.mEnd, params.mCount, params.mOffset);
+
+        if (multi_draw && !tex_setup && i != end && can_multi_draw_material(params, **i))
+        {
+            LL_PROFILE_ZONE_NAMED_CATEGORY_MATERIAL("materials multi draw");
+            draws.clear();
+            draws.push_back({ params.mCount, 1, params.mOffset, 0, 0 });
+            while (i != end && can_multi_draw_material(params, **i))
+            {
+                LLDrawInfo& next = **i;
+                if (next.mCount)
+                {
+                    draws.push_back({ next.mCount, 1, next.mOffset, 0, 0 });
+                }
+                LLCullResult::increment_iterator(i, end);
+            }
+            params.mVertexBuffer->drawMulti(LLRender::TRIANGLES, draws);
+        }
+        else
+        {
+            drawGeometry(params);
+        }
 
         if (tex_setup)
         {
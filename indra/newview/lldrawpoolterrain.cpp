@@ -37,6 +37,7 @@
 #include "llsky.h"
 #include "llsurface.h"
 #include "llsurfacepatch.h"
+#include "llterrainheightfield.h"
 #include "llviewerregion.h"
 #include "llvlcomposition.h"
 #include "llviewerparcelmgr.h"      // for gRenderParcelOwnership
@@ -121,10 +122,27 @@ void LLDrawPoolTerrain::prerender()
     sPBRDetailMode = render_terrain_pbr_detail;
 }
 
+LLViewerRegion* LLDrawPoolTerrain::getRegion() const
+{
+    // Heightfield terrain leaves the faces empty so none are queued for drawing,
+    // fall back to any face using this pool
+    const face_array_t& faces = mDrawFace.empty() ? mReferences : mDrawFace;
+    return faces.empty() ? nullptr : faces[0]->getDrawable()->getVObj()->getRegion();
+}
+
+LLTerrainHeightfield* LLDrawPoolTerrain::getHeightfield() const
+{
+    if (!LLTerrainHeightfield::sEnabled)
+    {
+        return nullptr;
+    }
+    LLViewerRegion* regionp = getRegion();
+    return regionp ? regionp->getLand().getHeightfield() : nullptr;
+}
+
 void LLDrawPoolTerrain::boostTerrainDetailTextures()
 {
-    // Hack! Get the region that this draw pool is rendering from!
-    LLViewerRegion *regionp = mDrawFace[0]->getDrawable()->getVObj()->getRegion();
+    LLViewerRegion *regionp = getRegion();
     LLVLComposition *compp = regionp->getComposition();
     compp->boost();
 }
@@ -145,7 +163,7 @@ void LLDrawPoolTerrain::endDeferredPass(S32 pass)
 void LLDrawPoolTerrain::renderDeferred(S32 pass)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_DRAWPOOL; //LL_RECORD_BLOCK_TIME(FTM_RENDER_TERRAIN);
-    if (mDrawFace.empty())
+    if (mDrawFace.empty() && !getHeightfield())
     {
         return;
     }
@@ -158,7 +176,7 @@ void LLDrawPoolTerrain::renderDeferred(S32 pass)
     // <FS:Ansariel> Use faster LLCachedControls for frequently visited locations
     //if (gSavedSettings.getBOOL("ShowParcelOwners"))
     static LLCachedControl<bool> showParcelOwners(gSavedSettings, "ShowParcelOwners");
-    if (showParcelOwners)
+    if (showParcelOwners && !mDrawFace.empty())
     // </FS:Ansariel>
     {
         hilightParcelOwners();
@@ -171,23 +189,24 @@ void LLDrawPoolTerrain::beginShadowPass(S32 pass)
     LL_PROFILE_ZONE_SCOPED_CATEGORY_DRAWPOOL; //LL_RECORD_BLOCK_TIME(FTM_SHADOW_TERRAIN);
     LLFacePool::beginRenderPass(pass);
     gGL.getTexUnit(0)->unbind(LLTexUnit::TT_TEXTURE);
-    gDeferredShadowProgram.bind();
+    sShader = LLTerrainHeightfield::sEnabled ? &gDeferredTerrainHeightfieldShadowProgram : &gDeferredShadowProgram;
+    sShader->bind();
 
     LLEnvironment& environment = LLEnvironment::instance();
-    gDeferredShadowProgram.uniform1i(LLShaderMgr::SUN_UP_FACTOR, environment.getIsSunUp() ? 1 : 0);
+    sShader->uniform1i(LLShaderMgr::SUN_UP_FACTOR, environment.getIsSunUp() ? 1 : 0);
 }
 
 void LLDrawPoolTerrain::endShadowPass(S32 pass)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_DRAWPOOL; //LL_RECORD_BLOCK_TIME(FTM_SHADOW_TERRAIN);
     LLFacePool::endRenderPass(pass);
-    gDeferredShadowProgram.unbind();
+    sShader->unbind();
 }
 
 void LLDrawPoolTerrain::renderShadow(S32 pass)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_DRAWPOOL; //LL_RECORD_BLOCK_TIME(FTM_SHADOW_TERRAIN);
-    if (mDrawFace.empty())
+    if (mDrawFace.empty() && !getHeightfield())
     {
         return;
     }
@@ -200,6 +219,13 @@ void LLDrawPoolTerrain::renderShadow(S32 pass)
 
 void LLDrawPoolTerrain::drawLoop()
 {
+    LLTerrainHeightfield* heightfield = getHeightfield();
+    if (heightfield)
+    {
+        heightfield->render(LLGLSLShader::sCurBoundShaderPtr, !LLPipeline::sShadowRender);
+        return;
+    }
+
     if (!mDrawFace.empty())
     {
         for (std::vector<LLFace*>::iterator iter = mDrawFace.begin();
@@ -218,15 +244,15 @@ void LLDrawPoolTerrain::drawLoop()
 void LLDrawPoolTerrain::renderFullShader()
 {
     const bool use_local_materials = gLocalTerrainMaterials.makeMaterialsReady(true, false);
-    // Hack! Get the region that this draw pool is rendering from!
-    LLViewerRegion *regionp = mDrawFace[0]->getDrawable()->getVObj()->getRegion();
+    LLViewerRegion *regionp = getRegion();
     LLVLComposition *compp = regionp->getComposition();
     const bool use_textures = !use_local_materials && (compp->getMaterialType() == LLTerrainMaterials::Type::TEXTURE);
+    const bool use_heightfield = getHeightfield() != nullptr;
 
     if (use_textures)
     {
         // Use textures
-        sShader = &gDeferredTerrainProgram;
+        sShader = use_heightfield ? &gDeferredTerrainHeightfieldProgram : &gDeferredTerrainProgram;
         sShader->bind();
         renderFullShaderTextures();
     }
@@ -235,7 +261,7 @@ void LLDrawPoolTerrain::renderFullShader()
         // Use materials
         U32 paint_type = use_local_materials ? gLocalTerrainMaterials.getPaintType() : compp->getPaintType();
         paint_type = llclamp(paint_type, 0, TERRAIN_PAINT_TYPE_COUNT);
-        sShader = &gDeferredPBRTerrainProgram[paint_type];
+        sShader = use_heightfield ? &gDeferredPBRTerrainHeightfieldProgram[paint_type] : &gDeferredPBRTerrainProgram[paint_type];
         sShader->bind();
         renderFullShaderPBR(use_local_materials);
     }
@@ -243,8 +269,7 @@ void LLDrawPoolTerrain::renderFullShader()
 
 void LLDrawPoolTerrain::renderFullShaderTextures()
 {
-    // Hack! Get the region that this draw pool is rendering from!
-    LLViewerRegion *regionp = mDrawFace[0]->getDrawable()->getVObj()->getRegion();
+    LLViewerRegion *regionp = getRegion();
     LLVLComposition *compp = regionp->getComposition();
 
 // [SL:KB] - Patch: Render-TextureToggle (Catznip-4.0)
@@ -350,8 +375,7 @@ void LLDrawPoolTerrain::renderFullShaderTextures()
 // *TODO: Investigate use of bindFast for PBR terrain textures
 void LLDrawPoolTerrain::renderFullShaderPBR(bool use_local_materials)
 {
-    // Hack! Get the region that this draw pool is rendering from!
-    LLViewerRegion *regionp = mDrawFace[0]->getDrawable()->getVObj()->getRegion();
+    LLViewerRegion *regionp = getRegion();
     LLVLComposition *compp = regionp->getComposition();
     LLPointer<LLFetchedGLTFMaterial> (*fetched_materials)[LLVLComposition::ASSET_COUNT] = &compp->mDetailRenderMaterials;
 
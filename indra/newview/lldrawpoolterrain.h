@@ -29,6 +29,9 @@
 
 #include "lldrawpool.h"
 
+class LLTerrainHeightfield;
+class LLViewerRegion;
+
 class LLDrawPoolTerrain : public LLFacePool
 {
     LLPointer<LLViewerTexture> mTexturep;
@@ -70,6 +73,11 @@ public:
     static F32 sPBRDetailScale; // textures per meter
 
 protected:
+    // Hack! Get the region that this draw pool is rendering from!
+    LLViewerRegion* getRegion() const;
+    // Heightfield of the region when terrain is drawn from it rather than from faces
+    LLTerrainHeightfield* getHeightfield() const;
+
     void boostTerrainDetailTextures();
 
     void renderSimple();
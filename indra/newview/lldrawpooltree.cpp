@@ -41,6 +41,7 @@
 #include "llenvironment.h"
 
 S32 LLDrawPoolTree::sDiffTex = 0;
+GLuint LLDrawPoolTree::sInstanceUBO = 0;
 static LLGLSLShader* shader = NULL;
 
 LLDrawPoolTree::LLDrawPoolTree(LLViewerTexture *texturep) :
@@ -57,7 +58,7 @@ void LLDrawPoolTree::beginDeferredPass(S32 pass)
 {
     LL_RECORD_BLOCK_TIME(FTM_RENDER_TREES);
 
-    shader = &gDeferredTreeProgram;
+    shader = LLVOTree::sInstancing ? &gDeferredTreeInstancedProgram : &gDeferredTreeProgram;
     shader->bind();
     shader->setMinimumAlpha(0.5f);
 }
@@ -81,6 +82,12 @@ void LLDrawPoolTree::renderDeferred(S32 pass)
 //    gGL.getTexUnit(sDiffTex)->bindFast(mTexturep);
     mTexturep->addTextureStats(1024.f * 1024.f); // <=== keep Linden tree textures at full res
 
+    if (LLVOTree::sInstancing)
+    {
+        renderInstanced();
+        return;
+    }
+
     for (std::vector<LLFace*>::iterator iter = mDrawFace.begin();
         iter != mDrawFace.end(); iter++)
     {
@@ -100,6 +107,87 @@ void LLDrawPoolTree::renderDeferred(S32 pass)
     }
 }
 
+void LLDrawPoolTree::renderInstanced()
+{
+    LL_PROFILE_ZONE_SCOPED;
+
+    // visible trees sorted by region and shared mesh, every run is drawn with one model
+    // matrix and one vertex buffer
+    struct Instance
+    {
+        LLViewerRegion* mRegion;
+        LLVertexBuffer* mMesh;
+        LLVOTree* mTree;
+    };
+    static std::vector<Instance> instances;
+    instances.clear();
+
+    for (LLFace* face : mDrawFace)
+    {
+        LLVOTree* tree = (LLVOTree*) face->getViewerObject();
+        if (tree && tree->mInstanceMesh.notNull() && tree->getRegion())
+        {
+            instances.push_back({ tree->getRegion(), tree->mInstanceMesh.get(), tree });
+        }
+    }
+
+    std::sort(instances.begin(), instances.end(), [](const Instance& lhs, const Instance& rhs)
+        {
+            return lhs.mRegion != rhs.mRegion ? lhs.mRegion < rhs.mRegion : lhs.mMesh < rhs.mMesh;
+        });
+
+    if (!sInstanceUBO)
+    {
+        glGenBuffers(1, &sInstanceUBO);
+    }
+
+    // three rows of each region space instance transform, always uploaded in full so the
+    // buffer covers the whole uniform block
+    static LLVector4a rows[MAX_INSTANCES * 3];
+
+    size_t i = 0;
+    while (i < instances.size())
+    {
+        const Instance& first = instances[i];
+        U32 count = 0;
+        for (; i < instances.size() && count < MAX_INSTANCES; ++i, ++count)
+        {
+            const Instance& instance = instances[i];
+            if (instance.mRegion != first.mRegion || instance.mMesh != first.mMesh)
+            {
+                break;
+            }
+
+            const LLMatrix4& mat = instance.mTree->mInstanceMatrix;
+            for (U32 r = 0; r < 3; ++r)
+            {
+                rows[count * 3 + r].set(mat.mMatrix[0][r], mat.mMatrix[1][r], mat.mMatrix[2][r], mat.mMatrix[3][r]);
+            }
+        }
+
+        glBindBuffer(GL_UNIFORM_BUFFER, sInstanceUBO);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(rows), rows, GL_STREAM_DRAW);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        glBindBufferBase(GL_UNIFORM_BUFFER, LLGLSLShader::UB_TREE_INSTANCES, sInstanceUBO);
+
+        llassert(gGL.getMatrixMode() == LLRender::MM_MODELVIEW);
+        LLRenderPass::applyModelMatrix(&first.mRegion->mRenderMatrix);
+
+        first.mMesh->setBuffer();
+        first.mMesh->drawInstanced(LLRender::TRIANGLES, first.mMesh->getNumIndices(), 0, count);
+    }
+}
+
+//static
+void LLDrawPoolTree::destroyGL()
+{
+    if (sInstanceUBO)
+    {
+        glDeleteBuffers(1, &sInstanceUBO);
+        sInstanceUBO = 0;
+    }
+}
+
 void LLDrawPoolTree::endDeferredPass(S32 pass)
 {
     LL_RECORD_BLOCK_TIME(FTM_RENDER_TREES);
@@ -124,9 +212,10 @@ void LLDrawPoolTree::beginShadowPass(S32 pass)
 
     LLEnvironment& environment = LLEnvironment::instance();
 
-    gDeferredTreeShadowProgram.bind();
-    gDeferredTreeShadowProgram.uniform1i(LLShaderMgr::SUN_UP_FACTOR, environment.getIsSunUp() ? 1 : 0);
-    gDeferredTreeShadowProgram.setMinimumAlpha(0.5f);
+    shader = LLVOTree::sInstancing ? &gDeferredTreeShadowInstancedProgram : &gDeferredTreeShadowProgram;
+    shader->bind();
+    shader->uniform1i(LLShaderMgr::SUN_UP_FACTOR, environment.getIsSunUp() ? 1 : 0);
+    shader->setMinimumAlpha(0.5f);
 }
 
 void LLDrawPoolTree::renderShadow(S32 pass)
@@ -146,7 +235,7 @@ void LLDrawPoolTree::endShadowPass(S32 pass)
     glPolygonOffset(RenderDeferredSpotShadowOffset, RenderDeferredSpotShadowBias);
     // </FS:PP>
 
-    gDeferredTreeShadowProgram.unbind();
+    shader->unbind();
 }
 
 bool LLDrawPoolTree::verify() const
@@ -61,6 +61,19 @@ public:
     /*virtual*/ LLColor3 getDebugColor() const; // For AGP debug display
 
     static S32 sDiffTex;
+
+    // Trees per instanced draw call (LLVOTree::sInstancing), bounded by the size of the
+    // TreeInstances uniform block
+    static constexpr U32 MAX_INSTANCES = 256;
+
+    // Release the instance transform buffer, it is recreated on next use
+    static void destroyGL();
+
+private:
+    // draw mDrawFace grouped by shared mesh, one instanced call per mesh and MAX_INSTANCES trees
+    void renderInstanced();
+
+    static GLuint sInstanceUBO;
 };
 
 #endif // LL_LLDRAWPOOLTREE_H
@@ -32,6 +32,7 @@
 #include "lldir.h"
 #include "llerror.h"
 #include "m3math.h"
+#include "llmatrix4a.h"
 #include "llrender.h"
 
 #include "llagent.h"        // for gAgent for getRegion for getWaterHeight
@@ -98,10 +99,88 @@ void LLDrawPoolWater::prerender()
     mShaderLevel = LLCubeMap::sUseCubeMaps ? LLViewerShaderMgr::instance()->getShaderLevel(LLViewerShaderMgr::SHADER_WATER) : 0;
 }
 
+void LLDrawPoolWater::updateScreenCoverage()
+{
+    mScreenCoverage = 1.f;
+    mScreenRect[0] = mScreenRect[1] = -1.f;
+    mScreenRect[2] = mScreenRect[3] = 1.f;
+
+    if (gCubeSnapshot || LLViewerCamera::getInstance()->cameraUnderWater())
+    {
+        // probe captures and the view from below always get the full pass
+        return;
+    }
+
+    LLMatrix4a modelview, projection, mvp;
+    modelview.loadu(gGLModelView);
+    projection.loadu(gGLProjection);
+    matMul(modelview, projection, mvp);
+
+    F32 coverage = 0.f;
+    F32 rect[4] = { 1.f, 1.f, -1.f, -1.f };
+
+    for (LLFace* face : mDrawFace)
+    {
+        LLDrawable* drawable = face ? face->getDrawable() : nullptr;
+        if (!drawable)
+        {
+            continue;
+        }
+
+        const LLVector4a* extents = drawable->getSpatialExtents();
+        F32 face_rect[4] = { 1.f, 1.f, -1.f, -1.f };
+        for (U32 i = 0; i < 8; i++)
+        {
+            LLVector4a corner(extents[i & 1][0], extents[(i >> 1) & 1][1], extents[i >> 2][2]);
+            LLVector4a clip;
+            mvp.affineTransform(corner, clip);
+            if (clip[3] <= F_APPROXIMATELY_ZERO)
+            {
+                // reaches behind the camera, its projection is unbounded
+                return;
+            }
+            F32 x = clip[0] / clip[3];
+            F32 y = clip[1] / clip[3];
+            face_rect[0] = llmin(face_rect[0], x);
+            face_rect[1] = llmin(face_rect[1], y);
+            face_rect[2] = llmax(face_rect[2], x);
+            face_rect[3] = llmax(face_rect[3], y);
+        }
+
+        face_rect[0] = llmax(face_rect[0], -1.f);
+        face_rect[1] = llmax(face_rect[1], -1.f);
+        face_rect[2] = llmin(face_rect[2], 1.f);
+        face_rect[3] = llmin(face_rect[3], 1.f);
+        if (face_rect[0] >= face_rect[2] || face_rect[1] >= face_rect[3])
+        {
+            continue;
+        }
+
+        coverage += (face_rect[2] - face_rect[0]) * (face_rect[3] - face_rect[1]) * 0.25f;
+        rect[0] = llmin(rect[0], face_rect[0]);
+        rect[1] = llmin(rect[1], face_rect[1]);
+        rect[2] = llmax(rect[2], face_rect[2]);
+        rect[3] = llmax(rect[3], face_rect[3]);
+    }
+
+    mScreenCoverage = llmin(coverage, 1.f);
+    if (rect[0] < rect[2])
+    {
+        memcpy(mScreenRect, rect, sizeof(rect));
+    }
+}
+
 S32 LLDrawPoolWater::getNumPostDeferredPasses()
 {
     if (LLViewerCamera::getInstance()->getOrigin().mV[2] < 1024.f)
     {
+        static LLCachedControl<F32> min_screen_area(gSavedSettings, "RenderWaterMinScreenArea", 0.001f);
+        updateScreenCoverage();
+        if (mScreenCoverage < min_screen_area)
+        {
+            // a few pixels of water are not worth a screen copy and a full shader pass
+            return 0;
+        }
         return 1;
     }
 
@@ -132,6 +211,17 @@ void LLDrawPoolWater::beginPostDeferredPass(S32 pass)
         gGL.getTexUnit(diff_map)->bind(&src);
         gGL.getTexUnit(depth_map)->bind(&depth_src, true);
 
+        // the water shader only samples the copy around the water, plus a margin for its
+        // distortion, the rest keeps what the water haze pass copied
+        const F32 MARGIN = 0.1f;
+        S32 x0 = (S32)floorf((llmax(mScreenRect[0] - MARGIN, -1.f) * 0.5f + 0.5f) * dst.getWidth());
+        S32 y0 = (S32)floorf((llmax(mScreenRect[1] - MARGIN, -1.f) * 0.5f + 0.5f) * dst.getHeight());
+        S32 x1 = (S32)ceilf((llmin(mScreenRect[2] + MARGIN, 1.f) * 0.5f + 0.5f) * dst.getWidth());
+        S32 y1 = (S32)ceilf((llmin(mScreenRect[3] + MARGIN, 1.f) * 0.5f + 0.5f) * dst.getHeight());
+
+        LLGLEnable scissor(GL_SCISSOR_TEST);
+        glScissor(x0, y0, x1 - x0, y1 - y0);
+
         gPipeline.mScreenTriangleVB->setBuffer();
         gPipeline.mScreenTriangleVB->drawArrays(LLRender::TRIANGLES, 0, 3);
 
@@ -77,6 +77,13 @@ public:
 protected:
     void renderOpaqueLegacyWater();
 
+    // Estimate the screen area of the water faces culled into this pool for the current
+    // camera, from their projected bounding boxes
+    void updateScreenCoverage();
+
+    F32 mScreenCoverage = 1.f;                      // fraction of the screen, overlaps counted twice
+    F32 mScreenRect[4] = { -1.f, -1.f, 1.f, 1.f };  // NDC bounds of all water faces
+
     // <FS:Zi> Render speedup for water parameters
     void onRenderWaterMipNormalChanged();
 
@@ -32,6 +32,7 @@
 
 #include "llsdserialize.h"
 #include "lleventtimer.h"
+#include "llviewermessagecapture.h"
 #include "llviewerregion.h"
 #include "message.h"
 #include "lltrans.h"
@@ -48,6 +49,22 @@ namespace LLEventPolling
 namespace Details
 {
 
+    // Bookkeeping events handled on the "mainloop-background" lane of main thread work
+    // (see LLAppViewer::runMainWork()), so a burst of them waits for a quieter frame.
+    // Everything else keeps the order it arrived in on "mainloop", only messages whose
+    // handlers don't depend on other event queue messages may be listed here.
+    static bool is_background_event(const std::string& msg_name)
+    {
+        static const std::unordered_set<std::string> background_events =
+        {
+            "CoarseLocationUpdate",
+            "DisplayNameUpdate",
+            "NavMeshStatusUpdate",
+            "ObjectPhysicsProperties",
+        };
+        return background_events.count(msg_name) > 0;
+    }
+
     class LLEventPollImpl: public std::enable_shared_from_this<LLEventPollImpl>
     {
     public:
@@ -128,6 +145,10 @@ namespace Details
         else
             LL_WARNS() << "Malformed content? " << ll_pretty_print_sd( content ) << LL_ENDL;
         // <FS:ND>
+        if (LLViewerMessageCapture::instanceExists())
+        {
+            LLViewerMessageCapture::getInstance()->recordEvent(msg_name, message);
+        }
         LLMessageSystem::dispatch(msg_name, message);
     }
 
@@ -177,6 +198,7 @@ namespace Details
 #if 1
         main_queue = LL::WorkQueue::getInstance("mainloop");
 #endif
+        LL::WorkQueue::ptr_t background_queue = LL::WorkQueue::getInstance("mainloop-background");
 
         // continually poll for a server update until we've been flagged as
         // finished
@@ -320,7 +342,12 @@ namespace Details
                     { // shuttle to a sensible spot in the main thread instead
                         // of wherever this coroutine happens to be executing
                         const LLSD& msg = *i;
-                        main_queue->post([this, msg]()
+                        LL::WorkQueue::ptr_t queue = main_queue;
+                        if (background_queue && is_background_event(msg["message"].asString()))
+                        {
+                            queue = background_queue;
+                        }
+                        queue->post([this, msg]()
                             {
                                 handleMessage(msg);
                             });
@@ -60,6 +60,7 @@
 #include "rlvhandler.h"
 // [/RLVa:KB]
 #include "llperfstats.h"
+#include "llslabpool.h"
 
 #if LL_LINUX
 // Work-around spurious used before init warning on Vector4a
@@ -72,6 +73,29 @@
 static LLStaticHashedString sTextureIndexIn("texture_index_in");
 static LLStaticHashedString sColorIn("color_in");
 
+static LLMemTag sFaceMemTag("Faces");
+
+static LLSizedSlabPools& get_face_pools()
+{
+    // never destroyed, faces may be released during static destruction
+    static LLSizedSlabPools* pools = new LLSizedSlabPools(&sFaceMemTag, 1024);
+    return *pools;
+}
+
+//static
+void* LLFace::operator new(size_t size)
+{
+    llassert(on_main_thread());
+    return get_face_pools().allocate(size);
+}
+
+//static
+void LLFace::operator delete(void* ptr, size_t size)
+{
+    llassert(on_main_thread());
+    get_face_pools().free(ptr, size);
+}
+
 bool LLFace::sSafeRenderSelect = true; // false
 
 
@@ -1183,6 +1207,35 @@ void push_for_transform(LLVertexBuffer* buff, U32 source_count, U32 dest_count)
     }
 }
 
+bool LLFace::prepareThreadedGeometry(S32 face_index)
+{
+    const LLTextureEntry* tep = mVObjp.notNull() ? mVObjp->getTE(face_index) : nullptr;
+    if (!tep || mVertexBuffer.isNull())
+    {
+        return false;
+    }
+
+    if (tep->isSelected() || mVertexBufferGLTF.notNull())
+    { // selection highlight creates and destroys a GL buffer
+        return false;
+    }
+
+    if (isState(TEXTURE_ANIM))
+    { // face state changed by getGeometryVolume is read by registerFace
+        return false;
+    }
+
+    if (mVertexBuffer->hasDataType(LLVertexBuffer::TYPE_TANGENT) ||
+        mVertexBuffer->hasDataType(LLVertexBuffer::TYPE_TEXCOORD1) ||
+        tep->getBumpmap() ||
+        tep->getTexGen() != LLTextureEntry::TEX_GEN_DEFAULT)
+    { // tangents are generated on demand and the volume may be shared with other objects
+        mVObjp->getVolume()->genTangents(face_index);
+    }
+
+    return true;
+}
+
 bool LLFace::getGeometryVolume(const LLVolume& volume,
                                 S32 face_index,
                                 const LLMatrix4& mat_vert_in,
@@ -1190,7 +1243,8 @@ bool LLFace::getGeometryVolume(const LLVolume& volume,
                                 U16 index_offset,
                                 bool force_rebuild,
                                 bool no_debug_assert,
-                                bool rebuild_for_gltf)
+                                bool rebuild_for_gltf,
+                                bool show_selected_in_bp)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_FACE;
     llassert(verify());
@@ -1285,7 +1339,7 @@ bool LLFace::getGeometryVolume(const LLVolume& volume,
         // Recursive call the same function with the argument rebuild_for_gltf set to true
         // This call will make geometry in mVertexBuffer but in fact for mVertexBufferGLTF
         mVertexBufferGLTF.swap(mVertexBufferGLTF, mVertexBuffer);
-        getGeometryVolume(volume, face_index, mat_vert_in, mat_norm_in, index_offset, force_rebuild, no_debug_assert, true);
+        getGeometryVolume(volume, face_index, mat_vert_in, mat_norm_in, index_offset, force_rebuild, no_debug_assert, true, show_selected_in_bp);
         mVertexBufferGLTF.swap(mVertexBufferGLTF, mVertexBuffer);
         mVertexBufferGLTF->unmapBuffer();
     }
@@ -1442,8 +1496,7 @@ bool LLFace::getGeometryVolume(const LLVolume& volume,
     LLMaterial* mat = tep ? tep->getMaterialParams().get() : 0;
     // </FS:ND>
     // <FS:Beq> show legacy when editing the fallback materials.
-    static LLCachedControl<bool> showSelectedinBP(gSavedSettings, "FSShowSelectedInBlinnPhong");
-    if( gltf_mat && getViewerObject()->isSelected() && showSelectedinBP )
+    if( gltf_mat && getViewerObject()->isSelected() && show_selected_in_bp )
     {
         gltf_mat = nullptr;
     }
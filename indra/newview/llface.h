@@ -57,8 +57,13 @@ const U8 FACE_DO_NOT_BATCH_TEXTURES = 255;
 
 class alignas(16) LLFace
 {
-    LL_ALIGN_NEW
 public:
+    // Faces come from an LLSlabPool, they are created and destroyed with
+    // their drawables on every rebuild of an object.
+    // Threads:  Tmain
+    void* operator new(size_t size);
+    void operator delete(void* ptr, size_t size);
+
     LLFace(const LLFace& rhs)
     {
         *this = rhs;
@@ -163,7 +168,13 @@ public:
                             U16 index_offset,
                             bool force_rebuild = false,
                             bool no_debug_assert = false,
-                            bool rebuild_for_gltf = false);
+                            bool rebuild_for_gltf = false,
+                            bool show_selected_in_bp = false); // FSShowSelectedInBlinnPhong, read by the caller on the main thread
+
+    // Prepare for a getGeometryVolume call from a worker thread (see RenderThreadedGeometry).
+    // Generates any tangents the call would create lazily on the shared volume.
+    // Returns false if this face must be rebuilt on the main thread.
+    bool prepareThreadedGeometry(S32 face_index);
 
     // For avatar
     U16          getGeometryAvatar(
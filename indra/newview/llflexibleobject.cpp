@@ -42,6 +42,7 @@
 #include "llviewerregion.h"
 #include "llworld.h"
 #include "llvoavatar.h"
+#include "parallelfor.h"
 
 static const F32 SEC_PER_FLEXI_FRAME = 1.f / 60.f; // 60 flexi updates per second
 /*static*/ F32 LLVolumeImplFlexible::sUpdateFactor = 1.0f;
@@ -56,7 +57,10 @@ LLVolumeImplFlexible::LLVolumeImplFlexible(LLViewerObject* vo, LLFlexibleObjectD
         mVO(vo),
         mAttributes(attributes),
         mLastFrameNum(0),
-        mLastUpdatePeriod(0)
+        mLastUpdatePeriod(0),
+        mSimulatedFrame(U32_MAX),
+        mFrameDistance(0.f),
+        mFrameWind(NULL)
 {
     static U32 seed = 0;
     mID = seed++;
@@ -426,9 +430,62 @@ inline S32 log2(S32 x)
     return ret;
 }
 
+//static
+void LLVolumeImplFlexible::simulateQueued()
+{
+    static LLCachedControl<bool> parallel(gSavedSettings, "RenderFlexParallel", true);
+    if (!parallel)
+    {
+        return;
+    }
+
+    LL_PROFILE_ZONE_SCOPED;
+
+    // the flexies doUpdateGeometry() is about to get to, minus the ones it would skip
+    static std::vector<LLVolumeImplFlexible*> batch;
+    batch.clear();
+    for (LLVolumeImplFlexible* flexi : sInstanceList)
+    {
+        LLVOVolume* volume = (LLVOVolume*)flexi->mVO;
+        LLDrawable* drawablep = volume->mDrawable;
+        if (drawablep && !drawablep->isDead() && drawablep->isState(LLDrawable::IN_REBUILD_Q) &&
+            !volume->mLODChanged && !flexi->isHeldByImpostor() &&
+            flexi->prepareFlexibleUpdate())
+        {
+            batch.push_back(flexi);
+        }
+    }
+
+    // each flexi only touches its own sections and path, the rest of the geometry update
+    // stays on the main thread
+    U32 frame = LLFrameTimer::getFrameCount();
+    for (LLVolumeImplFlexible* flexi : batch)
+    {
+        flexi->mSimulatedFrame = frame;
+    }
+    LL::parallel_for("General", batch.size(), [](size_t i)
+    {
+        batch[i]->simulate();
+    }, 4);
+}
+
 void LLVolumeImplFlexible::doFlexibleUpdate()
 {
     LL_PROFILE_ZONE_SCOPED;
+    if (mSimulatedFrame == LLFrameTimer::getFrameCount())
+    {
+        // simulateQueued() already did
+        return;
+    }
+
+    if (prepareFlexibleUpdate())
+    {
+        simulate();
+    }
+}
+
+bool LLVolumeImplFlexible::prepareFlexibleUpdate()
+{
     LLVolume* volume = mVO->getVolume();
     LLPath *path = &volume->getPath();
     if ((mSimulateRes == 0 || !mInitialized) && mVO->mDrawable->isVisible())
@@ -438,14 +495,14 @@ void LLVolumeImplFlexible::doFlexibleUpdate()
 
         if (!force_update || !gPipeline.hasRenderDebugFeatureMask(LLPipeline::RENDER_DEBUG_FEATURE_FLEXIBLE))
         {
-            return; // we did not get updated or initialized, proceeding without can be dangerous
+            return false; // we did not get updated or initialized, proceeding without can be dangerous
         }
     }
 
     if (!mInitialized || !mAttributes)
     {
         //the object is not visible
-        return;
+        return false;
     }
 
     // Fix for MAINT-1894
@@ -454,9 +511,31 @@ void LLVolumeImplFlexible::doFlexibleUpdate()
     // render sections which will then create a length exception in the std::vector::resize() method.
     if (mRenderRes < 0)
     {
-        return;
+        return false;
     }
 
+    S32 num_render_sections = 1<<mRenderRes;
+    if (path->getPathLength() != num_render_sections+1)
+    {
+        ((LLVOVolume*) mVO)->mVolumeChanged = true;
+        volume->resizePath(num_render_sections+1);
+    }
+
+    // everything simulate() needs from outside this object
+    mFramePosition = getFramePosition();
+    mFrameRotation = getFrameRotation();
+    mFrameScale = mVO->mDrawable->getScale();
+    mFrameDistance = mVO->mDrawable->mDistanceWRTCamera;
+    LLViewerRegion* region = gAgent.getRegion();
+    mFrameWind = region ? &region->mWind : NULL;
+    return true;
+}
+
+// Called from worker threads by simulateQueued(), keep to this object's own state
+void LLVolumeImplFlexible::simulate()
+{
+    LL_PROFILE_ZONE_SCOPED;
+    LLPath *path = &mVO->getVolume()->getPath();
     S32 num_sections = 1 << mSimulateRes;
 
     F32 secondsThisFrame = mTimer.getElapsedTimeAndResetF32();
@@ -465,11 +544,11 @@ void LLVolumeImplFlexible::doFlexibleUpdate()
         secondsThisFrame = 0.2f;
     }
 
-    LLVector3 BasePosition = getFramePosition();
-    LLQuaternion BaseRotation = getFrameRotation();
+    LLVector3 BasePosition = mFramePosition;
+    LLQuaternion BaseRotation = mFrameRotation;
     LLQuaternion parentSegmentRotation = BaseRotation;
     LLVector3 anchorDirectionRotated = LLVector3::z_axis * parentSegmentRotation;
-    LLVector3 anchorScale = mVO->mDrawable->getScale();
+    LLVector3 anchorScale = mFrameScale;
 
     F32 section_length = anchorScale.mV[VZ] / (F32)num_sections;
     F32 inv_section_length = 1.f / section_length;
@@ -525,9 +604,9 @@ void LLVolumeImplFlexible::doFlexibleUpdate()
         //------------------------------------------------------------------------------------------
         // wind force
         //------------------------------------------------------------------------------------------
-        if (mAttributes->getWindSensitivity() > 0.001f)
+        if (mAttributes->getWindSensitivity() > 0.001f && mFrameWind)
         {
-            mSection[i].mPosition += gAgent.getRegion()->mWind.getVelocity( mSection[i].mPosition ) * wind_factor;
+            mSection[i].mPosition += mFrameWind->getVelocity( mSection[i].mPosition ) * wind_factor;
         }
 
         //------------------------------------------------------------------------------------------
@@ -666,11 +745,6 @@ void LLVolumeImplFlexible::doFlexibleUpdate()
     // Create points
     llassert(mRenderRes > -1);
     S32 num_render_sections = 1<<mRenderRes;
-    if (path->getPathLength() != num_render_sections+1)
-    {
-        ((LLVOVolume*) mVO)->mVolumeChanged = true;
-        volume->resizePath(num_render_sections+1);
-    }
 
     LLPath::PathPt *new_point;
 
@@ -682,8 +756,8 @@ void LLVolumeImplFlexible::doFlexibleUpdate()
     LLVector3 delta_pos;
     LLQuaternion delta_rot;
 
-    delta_rot = ~getFrameRotation();
-    delta_pos = -getFramePosition()*delta_rot;
+    delta_rot = ~mFrameRotation;
+    delta_pos = -mFramePosition*delta_rot;
 
     // Vertex transform (4x4)
     LLVector3 x_axis = LLVector3(delta_scale.mV[VX], 0.f, 0.f) * delta_rot;
@@ -705,7 +779,7 @@ void LLVolumeImplFlexible::doFlexibleUpdate()
 
         LLVector3 np(new_point->mPos.getF32ptr());
 
-        if (!mUpdated || (np-pos).magVec()/mVO->mDrawable->mDistanceWRTCamera > 0.001f)
+        if (!mUpdated || (np-pos).magVec()/mFrameDistance > 0.001f)
         {
             new_point->mPos.load3((newSection[i].mPosition * rel_xform).mV);
             mUpdated = false;
@@ -751,11 +825,8 @@ void LLVolumeImplFlexible::onSetScale(const LLVector3& scale, bool damped)
     setAttributesOfAllSections((LLVector3*) &scale);
 }
 
-bool LLVolumeImplFlexible::doUpdateGeometry(LLDrawable *drawable)
+bool LLVolumeImplFlexible::isHeldByImpostor() const
 {
-    LL_PROFILE_ZONE_SCOPED;
-    LLVOVolume *volume = (LLVOVolume*)mVO;
-
     if (mVO->isAttachment())
     {   //don't update flexible attachments for impostored avatars unless the
         //impostor is being updated this frame (w00!)
@@ -774,6 +845,18 @@ bool LLVolumeImplFlexible::doUpdateGeometry(LLDrawable *drawable)
             }
         }
     }
+    return false;
+}
+
+bool LLVolumeImplFlexible::doUpdateGeometry(LLDrawable *drawable)
+{
+    LL_PROFILE_ZONE_SCOPED;
+    LLVOVolume *volume = (LLVOVolume*)mVO;
+
+    if (isHeldByImpostor())
+    {
+        return true;
+    }
 
     if (volume->mDrawable.isNull() || volume->mDrawable->isDead())
     {
@@ -76,6 +76,9 @@ private:
 
     public:
         static void updateClass();
+        // Run the simulation of every flexi waiting in the rebuild queue at once, spread
+        // over the General thread pool, before LLPipeline::updateGeom() gets to them
+        static void simulateQueued();
 
         LLVolumeImplFlexible(LLViewerObject* volume, LLFlexibleObjectData* attributes);
         ~LLVolumeImplFlexible();
@@ -99,6 +102,9 @@ private:
         const LLMatrix4& getWorldMatrix(LLXformMatrix* xform) const;
         void updateRelativeXform(bool force_identity);
         void doFlexibleUpdate(); // Called to update the simulation
+        bool prepareFlexibleUpdate(); // Main thread part of doFlexibleUpdate(), false to skip the update
+        void simulate(); // Thread safe part of doFlexibleUpdate()
+        bool isHeldByImpostor() const;
         void doFlexibleRebuild(bool rebuild_volume); // Called to rebuild the geometry
         void preRebuild();
 
@@ -134,6 +140,13 @@ private:
         S32                         mRenderRes;
         U64                         mLastFrameNum;
         U32                         mLastUpdatePeriod;
+        U32                         mSimulatedFrame;
+        // captured by prepareFlexibleUpdate() for simulate()
+        LLVector3                   mFramePosition;
+        LLQuaternion                mFrameRotation;
+        LLVector3                   mFrameScale;
+        F32                         mFrameDistance;
+        LLWind*                     mFrameWind;
         LLVector3                   mCollisionSpherePosition;
         F32                         mCollisionSphereRadius;
         U32                         mID;
@@ -0,0 +1,342 @@
+/**
+ * @file llflightrecorder.cpp
+ * @brief Rolling record of recent frame timings, saved as a Chrome trace
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llflightrecorder.h"
+
+#include "lldir.h"
+#include "llfasttimer.h"
+#include "llfile.h"
+#include "lltimer.h"
+#include "lltracerecording.h"
+#include "llviewercontrol.h"
+#include "workqueue.h"
+
+// Block timers below this are left out, they would only clutter the trace
+static const U32 MIN_EVENT_USEC = 20;
+// GPU frames still waiting for query results before we give up on the oldest
+static const size_t MAX_PENDING_GPU_FRAMES = 8;
+// Don't save hitch after hitch while the viewer is struggling
+static const U64 MIN_HITCH_SAVE_INTERVAL_USEC = 30 * 1000000;
+
+LLFlightRecorder::LLFlightRecorder()
+{
+}
+
+LLFlightRecorder::~LLFlightRecorder()
+{
+}
+
+void LLFlightRecorder::endFrame()
+{
+    static LLCachedControl<bool> enabled(gSavedSettings, "FlightRecorderEnable", true);
+    static LLCachedControl<F32> seconds(gSavedSettings, "FlightRecorderSeconds", 10.f);
+    static LLCachedControl<U32> max_depth(gSavedSettings, "FlightRecorderDepth", 4);
+    static LLCachedControl<F32> hitch_ms(gSavedSettings, "FlightRecorderHitchMs", 500.f);
+
+    U64 now = LLTimer::getTotalTime();
+    U64 frame_start = mLastFrameUsec ? mLastFrameUsec : now;
+    mLastFrameUsec = now;
+
+    if (!enabled)
+    {
+        if (!mFrames.empty())
+        {
+            mFrames.clear();
+        }
+        return;
+    }
+
+    LL_PROFILE_ZONE_SCOPED;
+
+    // drop frames that fell out of the window, keeping their buffers for reuse
+    Frame frame;
+    U64 window = (U64)(llmax((F32)seconds, 1.f) * 1000000.f);
+    while (!mFrames.empty() && now - mFrames.front().mStartUsec > window)
+    {
+        frame = std::move(mFrames.front());
+        mFrames.pop_front();
+    }
+    frame.mEvents.clear();
+    frame.mGPUEvents.clear();
+    frame.mCounters.clear();
+
+    frame.mNumber = mFrameNumber;
+    frame.mStartUsec = frame_start;
+    frame.mDurationUsec = (U32)(now - frame_start);
+
+    // the block timer tree is only maintained while something looks at it
+    LLTrace::BlockTimer::processTimes();
+    recordTimers(frame, LLTrace::BlockTimer::getRootTimeBlock(), 0, 0, max_depth);
+    recordCounters(frame);
+    mFrames.push_back(std::move(frame));
+
+    // close the GPU frame and pick up results of earlier ones
+    markGPU(NULL);
+    mCurrentGPUFrame.mNumber = ++mFrameNumber;
+    readGPUFrames();
+
+    if (hitch_ms > 0.f && mFrames.back().mDurationUsec > (U32)(hitch_ms * 1000.f) &&
+        now - mLastSaveUsec > MIN_HITCH_SAVE_INTERVAL_USEC &&
+        mFrames.size() > 1)
+    {
+        save("hitch");
+    }
+}
+
+void LLFlightRecorder::recordTimers(Frame& frame, LLTrace::BlockTimerStatHandle& timer, U32 start, U32 depth, U32 max_depth)
+{
+    LLTrace::Recording& recording = LLTrace::get_frame_recording().getPrevRecording(1);
+    for (LLTrace::BlockTimerStatHandle* child : timer.getChildren())
+    {
+        U32 duration = (U32)F64Microseconds(recording.getSum(*child)).value();
+        if (duration < MIN_EVENT_USEC)
+        {
+            continue;
+        }
+
+        frame.mEvents.push_back({ child->getName().c_str(), start, duration,
+                                  (U32)recording.getSum(child->callCount()), depth });
+        if (depth + 1 < max_depth)
+        {
+            recordTimers(frame, *child, start, depth + 1, max_depth);
+        }
+        start += duration;
+    }
+}
+
+void LLFlightRecorder::recordCounters(Frame& frame)
+{
+    for (auto& queue : LL::WorkQueueBase::instance_snapshot())
+    {
+        frame.mCounters.push_back({ getCounterName(queue.getKey()), (U32)queue.size() });
+    }
+}
+
+U32 LLFlightRecorder::getCounterName(const std::string& name)
+{
+    for (U32 i = 0; i < mCounterNames.size(); ++i)
+    {
+        if (mCounterNames[i] == name)
+        {
+            return i;
+        }
+    }
+    mCounterNames.push_back(name);
+    return (U32)mCounterNames.size() - 1;
+}
+
+void LLFlightRecorder::markGPU(const char* pass)
+{
+    static LLCachedControl<bool> enabled(gSavedSettings, "FlightRecorderEnable", true);
+    if (!enabled || !gGLManager.mInited)
+    {
+        return;
+    }
+
+    GLuint query = 0;
+    if (mFreeQueries.empty())
+    {
+        glGenQueries(1, &query);
+    }
+    else
+    {
+        query = mFreeQueries.back();
+        mFreeQueries.pop_back();
+    }
+    glQueryCounter(query, GL_TIMESTAMP);
+    mCurrentGPUFrame.mMarks.push_back({ pass, query });
+
+    if (!pass)
+    {
+        mPendingGPUFrames.push_back(std::move(mCurrentGPUFrame));
+        mCurrentGPUFrame = GPUFrame();
+    }
+}
+
+void LLFlightRecorder::readGPUFrames()
+{
+    // queries finish in order, stop at the first frame that isn't ready
+    while (!mPendingGPUFrames.empty())
+    {
+        GPUFrame& gpu_frame = mPendingGPUFrames.front();
+        GLuint available = GL_FALSE;
+        glGetQueryObjectuiv(gpu_frame.mMarks.back().mQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available && mPendingGPUFrames.size() < MAX_PENDING_GPU_FRAMES)
+        {
+            break;
+        }
+
+        Frame* frame = NULL;
+        for (auto it = mFrames.rbegin(); it != mFrames.rend(); ++it)
+        {
+            if (it->mNumber == gpu_frame.mNumber)
+            {
+                frame = &*it;
+                break;
+            }
+        }
+
+        GLuint64 first = 0;
+        GLuint64 prev = 0;
+        for (size_t i = 0; i < gpu_frame.mMarks.size(); ++i)
+        {
+            GLuint64 time = 0;
+            if (available)
+            {
+                glGetQueryObjectui64v(gpu_frame.mMarks[i].mQuery, GL_QUERY_RESULT, &time);
+            }
+            if (i == 0)
+            {
+                first = time;
+            }
+            else if (frame && available && gpu_frame.mMarks[i - 1].mPass)
+            {
+                // GPU timestamps are in nanoseconds, and only meaningful relative to each other
+                frame->mGPUEvents.push_back({ gpu_frame.mMarks[i - 1].mPass, (U32)((prev - first) / 1000),
+                                              (U32)((time - prev) / 1000), 1, 0 });
+            }
+            prev = time;
+            mFreeQueries.push_back(gpu_frame.mMarks[i].mQuery);
+        }
+        mPendingGPUFrames.pop_front();
+    }
+}
+
+void LLFlightRecorder::destroyGL()
+{
+    for (GPUFrame& gpu_frame : mPendingGPUFrames)
+    {
+        for (GPUMark& mark : gpu_frame.mMarks)
+        {
+            mFreeQueries.push_back(mark.mQuery);
+        }
+    }
+    for (GPUMark& mark : mCurrentGPUFrame.mMarks)
+    {
+        mFreeQueries.push_back(mark.mQuery);
+    }
+    mPendingGPUFrames.clear();
+    mCurrentGPUFrame.mMarks.clear();
+
+    if (!mFreeQueries.empty())
+    {
+        glDeleteQueries((GLsizei)mFreeQueries.size(), mFreeQueries.data());
+        mFreeQueries.clear();
+    }
+}
+
+void LLFlightRecorder::save(const std::string& reason)
+{
+    if (mFrames.empty())
+    {
+        return;
+    }
+    mLastSaveUsec = LLTimer::getTotalTime();
+
+    std::string filename = gDirUtilp->getExpandedFilename(LL_PATH_LOGS,
+        llformat("flight_%s_%llu.json", reason.c_str(), (unsigned long long)(mLastSaveUsec / 1000000)));
+    LL_INFOS("FlightRecorder") << "Saving " << mFrames.size() << " frames to " << filename << LL_ENDL;
+
+    // formatting a few seconds of frames takes a while, do it off the main thread
+    auto queue = LL::WorkQueue::getInstance("General");
+    if (!queue || !queue->post([filename, frames = mFrames, names = mCounterNames]()
+                               { writeTrace(filename, frames, names); }))
+    {
+        writeTrace(filename, mFrames, mCounterNames);
+    }
+}
+
+static void write_json_string(llofstream& out, const char* str)
+{
+    out << '"';
+    for (const char* c = str; *c; ++c)
+    {
+        if (*c == '"' || *c == '\\')
+        {
+            out << '\\';
+        }
+        if ((U8)*c >= 0x20)
+        {
+            out << *c;
+        }
+    }
+    out << '"';
+}
+
+// static
+void LLFlightRecorder::writeTrace(const std::string& filename, const std::deque<Frame>& frames,
+                                  const std::vector<std::string>& counter_names)
+{
+    llofstream out(filename.c_str());
+    if (!out.is_open())
+    {
+        LL_WARNS("FlightRecorder") << "Could not write " << filename << LL_ENDL;
+        return;
+    }
+
+    // one process, with the CPU timers and GPU passes as two threads
+    const U64 origin = frames.front().mStartUsec;
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out << "{\"ph\":\"M\",\"pid\":1,\"tid\":1,\"name\":\"thread_name\",\"args\":{\"name\":\"Main thread\"}},\n";
+    out << "{\"ph\":\"M\",\"pid\":1,\"tid\":2,\"name\":\"thread_name\",\"args\":{\"name\":\"GPU\"}}";
+
+    for (const Frame& frame : frames)
+    {
+        U64 start = frame.mStartUsec - origin;
+        out << ",\n{\"ph\":\"X\",\"pid\":1,\"tid\":1,\"name\":\"Frame " << frame.mNumber << "\",\"ts\":" << start
+            << ",\"dur\":" << frame.mDurationUsec << "}";
+
+        for (const Event& event : frame.mEvents)
+        {
+            out << ",\n{\"ph\":\"X\",\"pid\":1,\"tid\":1,\"name\":";
+            write_json_string(out, event.mName);
+            out << ",\"ts\":" << start + event.mStartUsec << ",\"dur\":" << event.mDurationUsec
+                << ",\"args\":{\"calls\":" << event.mCalls << "}}";
+        }
+
+        for (const Event& event : frame.mGPUEvents)
+        {
+            out << ",\n{\"ph\":\"X\",\"pid\":1,\"tid\":2,\"name\":";
+            write_json_string(out, event.mName);
+            out << ",\"ts\":" << start + event.mStartUsec << ",\"dur\":" << event.mDurationUsec << "}";
+        }
+
+        if (!frame.mCounters.empty())
+        {
+            out << ",\n{\"ph\":\"C\",\"pid\":1,\"name\":\"WorkQueue backlog\",\"ts\":" << start << ",\"args\":{";
+            for (size_t i = 0; i < frame.mCounters.size(); ++i)
+            {
+                out << (i ? "," : "");
+                write_json_string(out, counter_names[frame.mCounters[i].mName].c_str());
+                out << ":" << frame.mCounters[i].mValue;
+            }
+            out << "}}";
+        }
+    }
+    out << "\n]}\n";
+}
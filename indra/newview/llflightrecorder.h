@@ -0,0 +1,122 @@
+/**
+ * @file llflightrecorder.h
+ * @brief Rolling record of recent frame timings, saved as a Chrome trace
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#pragma once
+
+#include "llgl.h"
+#include "llsingleton.h"
+
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace LLTrace
+{
+    class BlockTimerStatHandle;
+}
+
+// Keeps the last FlightRecorderSeconds of frames in memory: the block timer tree of each
+// frame down to FlightRecorderDepth, GPU time between the pass markers in display() and
+// the backlog of every WorkQueue.  Unlike a Tracy build this is cheap enough to leave on
+// for everyone, and a frame longer than FlightRecorderHitchMs, or Advanced > Consoles >
+// Save Flight Recording, writes the record to the logs directory as a Chrome trace
+// (chrome://tracing, ui.perfetto.dev).
+//
+// Block timers only give per frame totals, so the events of one frame are laid out one
+// after another under their parent rather than at the times they actually ran.
+class LLFlightRecorder : public LLSingleton<LLFlightRecorder>
+{
+    LLSINGLETON(LLFlightRecorder);
+    ~LLFlightRecorder();
+
+public:
+    // Record the frame that just ended, after the frame recording moved to its next period
+    void endFrame();
+
+    // Timestamp the GPU at the start of a render pass, up to the next marker or frame end
+    void markGPU(const char* pass);
+
+    // Write the record to a new file in the logs directory, in the background
+    void save(const std::string& reason);
+
+    void destroyGL();
+
+private:
+    struct Event
+    {
+        const char* mName;
+        U32 mStartUsec;     // from the start of the frame
+        U32 mDurationUsec;
+        U32 mCalls;
+        U32 mDepth;
+    };
+
+    struct Counter
+    {
+        U32 mName;          // index in mCounterNames
+        U32 mValue;
+    };
+
+    struct Frame
+    {
+        U32 mNumber;
+        U64 mStartUsec;
+        U32 mDurationUsec;
+        std::vector<Event> mEvents;
+        std::vector<Event> mGPUEvents;
+        std::vector<Counter> mCounters;
+    };
+
+    struct GPUMark
+    {
+        const char* mPass;  // NULL for the end of the frame
+        GLuint mQuery;
+    };
+
+    struct GPUFrame
+    {
+        U32 mNumber;
+        std::vector<GPUMark> mMarks;
+    };
+
+    void recordTimers(Frame& frame, LLTrace::BlockTimerStatHandle& timer, U32 start, U32 depth, U32 max_depth);
+    void recordCounters(Frame& frame);
+    void readGPUFrames();
+    U32 getCounterName(const std::string& name);
+
+    static void writeTrace(const std::string& filename, const std::deque<Frame>& frames,
+                           const std::vector<std::string>& counter_names);
+
+    std::deque<Frame> mFrames;
+    std::vector<std::string> mCounterNames;
+    U32 mFrameNumber = 0;
+    U64 mLastFrameUsec = 0;
+    U64 mLastSaveUsec = 0;
+
+    GPUFrame mCurrentGPUFrame;
+    std::deque<GPUFrame> mPendingGPUFrames;
+    std::vector<GLuint> mFreeQueries;
+};
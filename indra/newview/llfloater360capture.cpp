@@ -47,6 +47,7 @@
 #include "llviewerpartsim.h"
 #include "llviewerregion.h"
 #include "llviewerwindow.h"
+#include "parallelfor.h"
 #include "pipeline.h"
 
 #include <iterator>
@@ -361,14 +362,10 @@ bool LLFloater360Capture::writeDataURL(const std::string filename, const std::st
     return false;
 }
 
-// Encode the image from each of the 6 snapshots and save it out to
-// the JavaScript array of data URLs
-void LLFloater360Capture::encodeAndSave(LLPointer<LLImageRaw> raw_image, const std::string filename, const std::string prefix)
+// Encode the image from one of the 6 snapshots. Runs on worker threads,
+// see capture360Images(), so settings are read by the caller.
+LLPointer<LLImageJPEG> LLFloater360Capture::encodeImage(LLImageRaw* raw_image, int jpeg_encode_quality, bool save_debug_image, const std::string prefix)
 {
-    // the default quality for the JPEG encoding is set quite high
-    // but this still seems to be a reasonable compromise for
-    // quality/size and is still much smaller than equivalent PNGs
-    int jpeg_encode_quality = gSavedSettings.getU32("360CaptureJPEGEncodeQuality");
     LLPointer<LLImageJPEG> jpeg_image = new LLImageJPEG(jpeg_encode_quality);
 
     LLImageDataSharedLock lock(raw_image);
@@ -384,7 +381,7 @@ void LLFloater360Capture::encodeAndSave(LLPointer<LLImageRaw> raw_image, const s
     {
         // save individual cube map images as real JPEG files
         // for debugging or curiosity) based on debug settings
-        if (gSavedSettings.getBOOL("360CaptureDebugSaveImage"))
+        if (save_debug_image)
         {
             const std::string jpeg_filename = STRINGIZE(
                                                   gDirUtilp->getLindenUserDir() <<
@@ -399,10 +396,9 @@ void LLFloater360Capture::encodeAndSave(LLPointer<LLImageRaw> raw_image, const s
             LL_INFOS("360Capture") << "Saving debug JPEG image as " << jpeg_filename << LL_ENDL;
             jpeg_image->save(jpeg_filename);
         }
-
-        // actually write the JPEG image to disk as a data URL
-        writeDataURL(filename, prefix, jpeg_image->getData(), jpeg_image->getDataSize());
+        return jpeg_image;
     }
+    return NULL;
 }
 
 // Defer back to the main loop for a single rendered frame to give
@@ -545,9 +541,6 @@ void LLFloater360Capture::capture360Images()
     // because of interest list issues.
     int num_render_passes = gSavedSettings.getU32("360CaptureNumRenderPasses");
 
-    // time the encode process for later optimization
-    auto encode_time_total = 0.0;
-
     // for each of the 6 directions we shoot...
     for (int i = 0; i < 6; i++)
     {
@@ -584,13 +577,6 @@ void LLFloater360Capture::capture360Images()
         gViewerWindow->simpleSnapshot(mRawImages[i],
                                       mSourceImageSize, mSourceImageSize, num_render_passes);
 
-        // encode each image and write to disk while saving how long it took to do so
-        auto t_start = std::chrono::high_resolution_clock::now();
-        encodeAndSave(mRawImages[i], cubemap_js_full_path, prefixes[i]);
-        auto t_end = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(t_end - t_start);
-        encode_time_total += duration.count();
-
         LLViewerStats::instance().getRecording().resume();
         LLAppViewer::instance()->resumeMainloopTimeout();
 
@@ -598,6 +584,34 @@ void LLFloater360Capture::capture360Images()
         LLAppViewer::instance()->pingMainloopTimeout("LLFloater360Capture::capture360Images");
     }
 
+    // encode the 6 images side by side on the General thread pool (this
+    // thread takes its share as well) and write them to disk in order,
+    // saving how long it took to do so
+    auto t_start = std::chrono::high_resolution_clock::now();
+
+    // the default quality for the JPEG encoding is set quite high
+    // but this still seems to be a reasonable compromise for
+    // quality/size and is still much smaller than equivalent PNGs
+    int jpeg_encode_quality = gSavedSettings.getU32("360CaptureJPEGEncodeQuality");
+    bool save_debug_image = gSavedSettings.getBOOL("360CaptureDebugSaveImage");
+    LLPointer<LLImageJPEG> jpeg_images[6];
+    LL::parallel_for("General", 6, [&](size_t i)
+    {
+        jpeg_images[i] = encodeImage(mRawImages[i], jpeg_encode_quality, save_debug_image, prefixes[i]);
+    });
+
+    for (int i = 0; i < 6; i++)
+    {
+        if (jpeg_images[i].notNull())
+        {
+            // actually write the JPEG image to disk as a data URL
+            writeDataURL(cubemap_js_full_path, prefixes[i], jpeg_images[i]->getData(), jpeg_images[i]->getDataSize());
+        }
+    }
+
+    auto t_end = std::chrono::high_resolution_clock::now();
+    auto encode_time_total = std::chrono::duration_cast<std::chrono::duration<double>>(t_end - t_start).count();
+
     // display time to encode all 6 images.  It tends to be a fairly linear
     // time for each so we don't need to worry about displaying the time
     // for each - this gives us plenty to use for optimizing
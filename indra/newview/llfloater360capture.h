@@ -32,6 +32,7 @@
 #include "llmediactrl.h"
 #include "llcharacter.h"
 
+class LLImageJPEG;
 class LLImageRaw;
 class LLTextBox;
 class LLRadioGroup;
@@ -57,7 +58,7 @@ class LLFloater360Capture:
         void writeDataURLHeader(const std::string filename);
         void writeDataURLFooter(const std::string filename);
         bool writeDataURL(const std::string filename, const std::string prefix, U8* data, unsigned int data_len);
-        void encodeAndSave(LLPointer<LLImageRaw> raw_image, const std::string filename, const std::string prefix);
+        LLPointer<LLImageJPEG> encodeImage(LLImageRaw* raw_image, int jpeg_encode_quality, bool save_debug_image, const std::string prefix);
 
         std::vector<LLAnimPauseRequest> mAvatarPauseHandles;
         void freezeWorld(bool enable);
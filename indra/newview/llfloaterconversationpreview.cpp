@@ -62,6 +62,7 @@ LLFloaterConversationPreview::LLFloaterConversationPreview(const LLSD& session_i
     mMutex(),
     mShowHistory(false),
     mMessages(NULL),
+    mIndexedSize(0),
     mHistoryThreadsBusy(false),
     mIsGroup(false),
     mOpened(false)
@@ -134,6 +135,17 @@ void LLFloaterConversationPreview::setPages(std::list<LLSD>* messages, const std
         mMessages = messages;
         mCurrentPage = (mMessages->size() ? (static_cast<int>(mMessages->size()) - 1) / mPageSize : 0);
 
+        LLLoadHistoryThread* loadThread = LLLogChat::getInstance()->getLoadHistoryThread(mSessionID);
+        if (loadThread && !loadThread->getMessageOffsets().empty())
+        {
+            // the thread only loaded the last page, the others are read when shown
+            mLogFileName = loadThread->getLogFileName();
+            mMessageOffsets = loadThread->getMessageOffsets();
+            mIndexedSize = loadThread->getIndexedSize();
+            mPageMessages = *mMessages;
+            mCurrentPage = (static_cast<int>(mMessageOffsets.size()) - 1) / mPageSize;
+        }
+
         mPageSpinner->setEnabled(true);
         mPageSpinner->setMaxValue((F32)(mCurrentPage+1));
         mPageSpinner->set((F32)(mCurrentPage+1));
@@ -175,6 +187,7 @@ void LLFloaterConversationPreview::onOpen(const LLSD& key)
     }
     LLSD load_params;
     load_params["load_all_history"] = true;
+    load_params["page_size"] = mPageSize;
     load_params["cut_off_todays_date"] = false;
     load_params["is_group"] = mIsGroup;
 
@@ -228,17 +241,19 @@ void LLFloaterConversationPreview::showHistory()
 {
     // additional protection to avoid changes of mMessages in setPages
     LLMutexLock lock(&mMutex);
-    if(mMessages == NULL || !mMessages->size() || mCurrentPage * mPageSize >= mMessages->size())
+    const std::list<LLSD>* messages = mMessageOffsets.empty() ? mMessages : &mPageMessages;
+    S32 first_message = mMessageOffsets.empty() ? mCurrentPage * mPageSize : 0;
+    if(messages == NULL || !messages->size() || first_message >= messages->size())
     {
         return;
     }
 
     mChatHistory->clear();
     std::ostringstream message;
-    std::list<LLSD>::const_iterator iter = mMessages->begin();
-    std::advance(iter, mCurrentPage * mPageSize);
+    std::list<LLSD>::const_iterator iter = messages->begin();
+    std::advance(iter, first_message);
 
-    for (int msg_num = 0; iter != mMessages->end() && msg_num < mPageSize; ++iter, ++msg_num)
+    for (int msg_num = 0; iter != messages->end() && msg_num < mPageSize; ++iter, ++msg_num)
     {
         LLSD msg = *iter;
 
@@ -301,6 +316,19 @@ void LLFloaterConversationPreview::onMoreHistoryBtnClick()
     }
 
     mCurrentPage--;
+
+    LLMutexLock lock(&mMutex);
+    size_t first = (size_t)mCurrentPage * mPageSize;
+    if (first < mMessageOffsets.size())
+    {
+        size_t next = first + mPageSize;
+        LLSD load_params;
+        load_params["cut_off_todays_date"] = false;
+        mPageMessages.clear();
+        LLLogChat::loadTranscriptMessages(mLogFileName, mMessageOffsets[first],
+                                          next < mMessageOffsets.size() ? mMessageOffsets[next] : mIndexedSize,
+                                          mPageMessages, load_params);
+    }
     mShowHistory = true;
 }
 
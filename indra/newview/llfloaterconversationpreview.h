@@ -72,6 +72,11 @@ private:
     int             mPageSize;
 
     std::list<LLSD>*    mMessages;
+    // Only the shown page is loaded when the transcript could be indexed
+    std::list<LLSD>     mPageMessages;
+    std::string         mLogFileName;
+    std::vector<U64>    mMessageOffsets;
+    U64                 mIndexedSize;
     std::string     mAccountName;
     std::string     mCompleteName;
     std::string     mChatHistoryFileName;
@@ -1562,6 +1562,16 @@ void LLFloaterModelPreview::addStringToLog(const std::string& message, const LLS
 // static
 void LLFloaterModelPreview::addStringToLog(const std::string& str, bool flash)
     {
+    if (!on_main_thread())
+    {
+        // lods are simplified on the General pool, the log tab is only touched on the main thread
+        LL::WorkQueue::ptr_t main_queue = LL::WorkQueue::getInstance("mainloop");
+        if (main_queue)
+        {
+            main_queue->post([str, flash]() { addStringToLog(str, flash); });
+        }
+        return;
+    }
     if (sInstance)
         {
         sInstance->addStringToLogTab(str, flash);
@@ -1571,10 +1581,7 @@ void LLFloaterModelPreview::addStringToLog(const std::string& str, bool flash)
 // static
 void LLFloaterModelPreview::addStringToLog(const std::ostringstream& strm, bool flash)
             {
-    if (sInstance)
-            {
-        sInstance->addStringToLogTab(strm.str(), flash);
-            }
+    addStringToLog(strm.str(), flash);
         }
 
 void LLFloaterModelPreview::clearAvatarTab()
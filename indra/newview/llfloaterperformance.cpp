@@ -442,7 +442,8 @@ void LLFloaterPerformance::populateNearbyList()
     {
         if (LLVOAvatar::AOA_INVISIBLE != avatar->getOverallAppearance())
         {
-            F32 render_av_gpu_ms = avatar->getGPURenderTime();
+            // the offscreen profile or what the avatar costs in the scene, whichever is higher
+            F32 render_av_gpu_ms = llmax(avatar->getGPURenderTime(), avatar->getGPUSceneTime());
 
             auto is_slow = avatar->isTooSlow();
             LLSD item;
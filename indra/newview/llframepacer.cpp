@@ -0,0 +1,127 @@
+/**
+ * @file llframepacer.cpp
+ * @brief Caps frames queued ahead of the GPU and measures input to present latency
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llframepacer.h"
+
+#include "lltimer.h"
+#include "llviewercontrol.h"
+#include "llviewerstats.h"
+
+// Fences still pending beyond this mean the driver is not signalling them, stop counting
+static const size_t MAX_PENDING_FRAMES = 8;
+// Never stall the main loop longer than this on one frame, whatever the GPU is doing
+static const GLuint64 MAX_WAIT_NSEC = 100 * 1000000;
+
+LLFramePacer::LLFramePacer()
+{
+}
+
+LLFramePacer::~LLFramePacer()
+{
+}
+
+void LLFramePacer::waitForGPU()
+{
+    static LLCachedControl<U32> max_queued(gSavedSettings, "RenderMaxQueuedFrames", 0);
+    if (mPendingFrames.empty())
+    {
+        return;
+    }
+
+    LL_PROFILE_ZONE_SCOPED;
+    readFences(0);
+    // the frame being started counts as queued too
+    while (max_queued > 0 && mPendingFrames.size() >= max_queued)
+    {
+        size_t pending = mPendingFrames.size();
+        readFences(MAX_WAIT_NSEC);
+        if (mPendingFrames.size() == pending)
+        {
+            break;
+        }
+    }
+}
+
+void LLFramePacer::markInput()
+{
+    mInputUsec = LLTimer::getTotalTime();
+}
+
+void LLFramePacer::markSwap()
+{
+    if (!gGLManager.mInited || !mInputUsec)
+    {
+        return;
+    }
+
+    if (mPendingFrames.size() >= MAX_PENDING_FRAMES)
+    {
+        glDeleteSync(mPendingFrames.front().mFence);
+        mPendingFrames.pop_front();
+    }
+
+    GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    if (fence)
+    {
+        mPendingFrames.push_back({ fence, mInputUsec });
+    }
+    // make sure the fence reaches the GPU even if nothing else is submitted before we wait on it
+    glFlush();
+}
+
+void LLFramePacer::readFences(GLuint64 timeout_nsec)
+{
+    // fences signal in order, stop at the first one that isn't done
+    while (!mPendingFrames.empty())
+    {
+        PendingFrame& frame = mPendingFrames.front();
+        GLenum status = glClientWaitSync(frame.mFence, 0, timeout_nsec);
+        if (status == GL_TIMEOUT_EXPIRED)
+        {
+            break;
+        }
+        if (status != GL_WAIT_FAILED)
+        {
+            U64 now = LLTimer::getTotalTime();
+            sample(LLStatViewer::INPUT_LATENCY, F64Microseconds((F64)(now - frame.mInputUsec)));
+        }
+        glDeleteSync(frame.mFence);
+        mPendingFrames.pop_front();
+        // only wait for the oldest frame, the rest are picked up if they are already done
+        timeout_nsec = 0;
+    }
+}
+
+void LLFramePacer::destroyGL()
+{
+    for (PendingFrame& frame : mPendingFrames)
+    {
+        glDeleteSync(frame.mFence);
+    }
+    mPendingFrames.clear();
+}
@@ -0,0 +1,70 @@
+/**
+ * @file llframepacer.h
+ * @brief Caps frames queued ahead of the GPU and measures input to present latency
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#pragma once
+
+#include "llgl.h"
+#include "llsingleton.h"
+
+#include <deque>
+
+// The driver lets the CPU run a few frames ahead of the GPU, and input gathered at the start
+// of a frame only reaches the screen once all of those have been drawn.  A fence after every
+// swap tells us when each frame actually finished on the GPU: waitForGPU() holds the main
+// loop before input is gathered until no more than RenderMaxQueuedFrames are outstanding, so
+// input is sampled as late as the GPU allows, and every signalled fence records the time
+// from gathering input to the GPU finishing that frame as the "inputlatency" stat.
+class LLFramePacer : public LLSingleton<LLFramePacer>
+{
+    LLSINGLETON(LLFramePacer);
+    ~LLFramePacer();
+
+public:
+    // Before gathering input, blocks while too many frames are queued
+    void waitForGPU();
+
+    // Right after gathering input
+    void markInput();
+
+    // Right after swapping buffers
+    void markSwap();
+
+    void destroyGL();
+
+private:
+    struct PendingFrame
+    {
+        GLsync mFence;
+        U64 mInputUsec;
+    };
+
+    // Record and drop every frame whose fence has signalled, waiting up to timeout_nsec
+    // for the oldest one
+    void readFences(GLuint64 timeout_nsec);
+
+    std::deque<PendingFrame> mPendingFrames;
+    U64 mInputUsec = 0;
+};
@@ -0,0 +1,54 @@
+/**
+ * @file llframesnapshot.cpp
+ * @brief Per frame state handed from the idle/simulation side to rendering
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llframesnapshot.h"
+
+#include "llagent.h"
+#include "llappviewer.h"
+#include "llviewercamera.h"
+
+LLFrameSnapshot LLFrameSnapshot::sFrames[2];
+U32 LLFrameSnapshot::sCurrent = 0;
+
+// static
+void LLFrameSnapshot::publish()
+{
+    LL_PROFILE_ZONE_SCOPED;
+
+    const U32 next = sCurrent ^ 1;
+    LLFrameSnapshot& frame = sFrames[next];
+
+    frame.mFrame = sFrames[sCurrent].mFrame + 1;
+    frame.mFrameTime = gFrameTimeSeconds;
+    frame.mFrameInterval = gFrameIntervalSeconds;
+
+    frame.mCameraUnderWater = LLViewerCamera::instanceExists() && LLViewerCamera::getInstance()->cameraUnderWater();
+    frame.mAgentPosition = gAgent.getPositionAgent();
+
+    sCurrent = next;
+}
@@ -0,0 +1,59 @@
+/**
+ * @file llframesnapshot.h
+ * @brief Per frame state handed from the idle/simulation side to rendering
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLFRAMESNAPSHOT_H
+#define LL_LLFRAMESNAPSHOT_H
+
+#include "v3math.h"
+
+// What idle() decided for a frame, published once it is done and read by display().
+//
+// Rendering reads frame timing, camera and agent state from here instead of from the live
+// globals and singletons that message processing, object updates and the agent camera keep
+// changing.  That makes the end of idle the one point where simulation state becomes visible
+// to rendering, which is the hand-off a render thread running a frame behind the simulation
+// would need.  Two slots are kept so the snapshot being read is never the one being written.
+class LLFrameSnapshot
+{
+public:
+    U32 mFrame = 0;                     // idle frames published so far
+    F32 mFrameTime = 0.f;               // gFrameTimeSeconds
+    F32 mFrameInterval = 0.f;           // gFrameIntervalSeconds
+    bool mCameraUnderWater = false;     // world camera as left by the agent camera update
+    LLVector3 mAgentPosition;           // in the agent's region
+
+    // Capture the state idle() left behind, call once per frame after idle()
+    static void publish();
+
+    // Latest published frame
+    static const LLFrameSnapshot& get() { return sFrames[sCurrent]; }
+
+private:
+    static LLFrameSnapshot sFrames[2];
+    static U32 sCurrent;
+};
+
+#endif // LL_LLFRAMESNAPSHOT_H
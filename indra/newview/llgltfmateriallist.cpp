@@ -56,6 +56,8 @@ LLGLTFMaterialList::apply_queue_t LLGLTFMaterialList::sApplyQueue;
 LLSD LLGLTFMaterialList::sUpdates;
 
 const size_t MAX_TASK_UPDATES = 255;
+// sides of an object an override update can address
+const U32 MAX_OVERRIDE_TES = 45;
 
 #ifdef SHOW_ASSERT
 // return true if given data is (probably) valid update message for ModifyMaterialParams capability
@@ -197,9 +199,6 @@ void LLGLTFMaterialList::applyOverrideMessage(LLMessageSystem* msg, const std::s
         const LLSD& tes = data["te"];
         const LLSD& od = data["od"];
 
-        constexpr U32 MAX_TES = 45;
-        bool has_te[MAX_TES] = { false };
-
         if (tes.isArray()) // NOTE: if no "te" array exists, this is a malformed message (null out all overrides will come in as an empty te array)
         {
             LLGLTFOverrideCacheEntry cache;
@@ -207,40 +206,44 @@ void LLGLTFMaterialList::applyOverrideMessage(LLMessageSystem* msg, const std::s
             cache.mObjectId = id;
             cache.mRegionHandle = region->getHandle();
 
-            auto count = llmin(tes.size(), MAX_TES);
+            // each message carries every override of the object, so it replaces any still pending
+            auto pending = mPendingOverrides.find(id);
+            side_override_map_t sides;
+
+            auto count = llmin(tes.size(), (size_t)MAX_OVERRIDE_TES);
             for (size_t i = 0; i < count; ++i)
             {
-                LLGLTFMaterial* mat = new LLGLTFMaterial(); // setTEGLTFMaterialOverride and cache will take ownership
+                LLPointer<LLGLTFMaterial> mat = new LLGLTFMaterial(); // shared by the cache and setTEGLTFMaterialOverride
                 mat->applyOverrideLLSD(od[i]);
 
                 S32 te = tes[i].asInteger();
 
-                has_te[te] = true;
-                cache.mSides[te] = od[i];
-                cache.mGLTFMaterial[te] = mat;
-
-                if (obj)
+                // regions resend unchanged overrides, keep the material the face already has so
+                // setTEGLTFMaterialOverride doesn't clone a render material and rebuild the face
+                LLGLTFMaterial* current = nullptr;
+                if (pending != mPendingOverrides.end())
                 {
-                    obj->setTEGLTFMaterialOverride(te, mat);
-                    if (obj->getTE(te) && obj->getTE(te)->isSelected())
-                    {
-                        handle_gltf_override_message.doSelectionCallbacks(id, te);
-                    }
+                    auto side = pending->second.find((U8)te);
+                    current = side != pending->second.end() ? side->second.get() : nullptr;
+                }
+                else if (obj && obj->getTE(te))
+                {
+                    current = obj->getTE(te)->getGLTFMaterialOverride();
                 }
-            }
 
-            if (obj)
-            { // null out overrides on TEs that shouldn't have them
-                U32 count = llmin(obj->getNumTEs(), MAX_TES);
-                for (U32 i = 0; i < count; ++i)
+                if (current && current->getHash() == mat->getHash())
                 {
-                    LLTextureEntry* te = obj->getTE(i);
-                    if (!has_te[i] && te && te->getGLTFMaterialOverride())
-                    {
-                        obj->setTEGLTFMaterialOverride(i, nullptr);
-                        handle_gltf_override_message.doSelectionCallbacks(id, i);
-                    }
+                    mat = current;
                 }
+
+                cache.mSides[te] = od[i];
+                cache.mGLTFMaterial[te] = mat;
+                sides[(U8)te] = mat;
+            }
+
+            if (obj || pending != mPendingOverrides.end())
+            {
+                mPendingOverrides[id] = std::move(sides);
             }
 
             region->cacheFullUpdateGLTFOverride(cache);
@@ -250,6 +253,46 @@ void LLGLTFMaterialList::applyOverrideMessage(LLMessageSystem* msg, const std::s
     }
 }
 
+void LLGLTFMaterialList::applyPendingOverrides()
+{
+    LL_PROFILE_ZONE_SCOPED;
+
+    for (auto& pending : mPendingOverrides)
+    {
+        const LLUUID& id = pending.first;
+        const side_override_map_t& sides = pending.second;
+
+        // objects that went away since still have their overrides in the region cache
+        LLViewerObject* obj = gObjectList.findObject(id);
+        if (!obj)
+        {
+            continue;
+        }
+
+        U32 count = llmin((U32)obj->getNumTEs(), MAX_OVERRIDE_TES);
+        for (U32 i = 0; i < count; ++i)
+        {
+            LLTextureEntry* te = obj->getTE(i);
+            auto side = sides.find((U8)i);
+            if (side != sides.end())
+            {
+                obj->setTEGLTFMaterialOverride(i, side->second);
+                if (te && te->isSelected())
+                {
+                    handle_gltf_override_message.doSelectionCallbacks(id, i);
+                }
+            }
+            else if (te && te->getGLTFMaterialOverride())
+            { // null out overrides on TEs that shouldn't have them
+                obj->setTEGLTFMaterialOverride(i, nullptr);
+                handle_gltf_override_message.doSelectionCallbacks(id, i);
+            }
+        }
+    }
+
+    mPendingOverrides.clear();
+}
+
 void LLGLTFMaterialList::queueOverrideUpdate(const LLUUID& id, S32 side, LLGLTFMaterial* override_data)
 {
 #if 0
@@ -634,6 +677,19 @@ void LLGLTFMaterialList::removeMaterial(const LLUUID& id)
     mList.erase(id);
 }
 
+LLFetchedGLTFMaterial* LLGLTFMaterialList::internRenderMaterial(LLFetchedGLTFMaterial* render_mat)
+{
+    LL_PROFILE_ZONE_SCOPED;
+    auto iter = mRenderMaterials.emplace(render_mat->getHash(), render_mat).first;
+    return iter->second;
+}
+
+bool LLGLTFMaterialList::isInterned(LLGLTFMaterial* render_mat)
+{
+    auto iter = mRenderMaterials.find(render_mat->getHash());
+    return iter != mRenderMaterials.end() && iter->second.get() == render_mat;
+}
+
 void LLGLTFMaterialList::flushMaterials()
 {
     // Similar variant to what textures use
@@ -693,6 +749,42 @@ void LLGLTFMaterialList::flushMaterials()
         mLastUpdateKey.setNull();
     }
 
+    // drop interned render materials no face uses anymore
+    update_count = llmax((U32)MIN_UPDATE_COUNT, (U32)mRenderMaterials.size() / 20);
+    update_count = llmin(update_count, (U32)mRenderMaterials.size());
+
+    iter = mRenderMaterials.find(mLastRenderUpdateKey);
+    if (iter != mRenderMaterials.end())
+    {
+        ++iter;
+    }
+
+    while (update_count-- > 0 && !mRenderMaterials.empty())
+    {
+        if (iter == mRenderMaterials.end())
+        {
+            iter = mRenderMaterials.begin();
+        }
+
+        if (iter->second->getNumRefs() == 1) // only the list
+        {
+            iter = mRenderMaterials.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+
+    if (iter != mRenderMaterials.end())
+    {
+        mLastRenderUpdateKey = iter->first;
+    }
+    else
+    {
+        mLastRenderUpdateKey.setNull();
+    }
+
     {
         using namespace LLStatViewer;
         sample(NUM_MATERIALS, mList.size());
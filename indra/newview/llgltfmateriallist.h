@@ -32,6 +32,7 @@
 #include "llgltfmaterial.h"
 #include "llpointer.h"
 
+#include <map>
 #include <unordered_map>
 
 class LLFetchedGLTFMaterial;
@@ -50,6 +51,12 @@ public:
 
     void flushMaterials();
 
+    // Return the render material equal in content to render_mat, so faces whose base material
+    // and override combine to the same thing share one instance.  Shared render materials must
+    // not be edited in place, check isInterned() and edit a copy instead.
+    LLFetchedGLTFMaterial* internRenderMaterial(LLFetchedGLTFMaterial* render_mat);
+    bool isInterned(LLGLTFMaterial* render_mat);
+
     // Queue an modification of a material that we want to send to the simulator.  Call "flushUpdates" to flush pending updates.
     //  id - ID of object to modify
     //  side - TexureEntry index to modify, or -1 for all sides
@@ -100,8 +107,13 @@ public:
     void applyQueuedOverrides(LLViewerObject* obj);
 
     // Apply an override update with the given data
+    // The region cache is updated right away, objects get the new overrides in applyPendingOverrides
     void applyOverrideMessage(LLMessageSystem* msg, const std::string& data);
 
+    // Apply the overrides received since the last call, once per object no matter how many
+    // updates arrived for it.  Called once per frame.
+    void applyPendingOverrides();
+
 private:
     friend class LLGLTFMaterialOverrideDispatchHandler;
     // save an override update that we got from the simulator for later (for example, if an override arrived for an unknown object)
@@ -140,8 +152,17 @@ protected:
     typedef std::unordered_map<LLUUID, override_list_t > queued_override_map_t;
     queued_override_map_t mQueuedOverrides;
 
+    // most recent override of each side by object id, waiting for applyPendingOverrides
+    typedef std::map<U8, LLPointer<LLGLTFMaterial> > side_override_map_t;
+    typedef std::unordered_map<LLUUID, side_override_map_t> pending_override_map_t;
+    pending_override_map_t mPendingOverrides;
+
     LLUUID mLastUpdateKey;
 
+    // render materials by content hash, see internRenderMaterial
+    uuid_mat_map_t mRenderMaterials;
+    LLUUID mLastRenderUpdateKey;
+
     struct ModifyMaterialData
     {
         LLUUID object_id;
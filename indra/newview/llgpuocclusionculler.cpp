@@ -0,0 +1,329 @@
+/**
+ * @file llgpuocclusionculler.cpp
+ * @brief LLGPUOcclusionCuller class implementation
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llgpuocclusionculler.h"
+
+#include "llgpupasstimer.h"
+#include "llrender.h"
+#include "llrendertarget.h"
+#include "llspatialpartition.h"
+#include "llviewercontrol.h"
+#include "llviewershadermgr.h"
+#include "pipeline.h"
+
+extern U32 gFrameCount;
+
+static LLStaticHashedString sSrcLevel("src_level");
+static LLStaticHashedString sBoxCount("box_count");
+static LLStaticHashedString sHiZLevels("hiz_levels");
+
+// matches SG_OCCLUSION_FUDGE in llvieweroctree.cpp so both paths cull the same boxes
+constexpr F32 GPU_OCCLUSION_FUDGE = 0.25f;
+
+constexpr U32 CULL_GROUP_SIZE = 32;     // local_size_x of occlusionCullC.glsl
+constexpr U32 HIZ_GROUP_SIZE = 8;       // local_size_x/y of hizDownsampleC.glsl
+
+LLGPUOcclusionCuller::~LLGPUOcclusionCuller()
+{
+    cleanup();
+}
+
+//static
+bool LLGPUOcclusionCuller::isEnabled()
+{
+#if LL_DARWIN
+    return false;
+#else
+    static LLCachedControl<bool> gpu_occlusion(gSavedSettings, "RenderGPUOcclusion", false);
+    return gpu_occlusion &&
+        gGLManager.mGLVersion >= 4.29f &&
+        gHiZDownsampleProgram.isComplete() &&
+        gOcclusionCullProgram.isComplete();
+#endif
+}
+
+//static
+bool LLGPUOcclusionCuller::canCull(LLSpatialGroup* group, LLCamera& camera)
+{
+    // water is depth clamped by the query path to keep it from being culled by the far plane,
+    // and an invalid camera origin needs the whole box drawn -- leave both to occlusion queries
+    U32 type = group->getSpatialPartition()->mDrawableType;
+    return type != LLPipeline::RENDER_TYPE_WATER &&
+        type != LLPipeline::RENDER_TYPE_VOIDWATER &&
+        !camera.getOrigin().isExactlyZero();
+}
+
+void LLGPUOcclusionCuller::cleanup()
+{
+#if !LL_DARWIN
+    for (Batch& batch : mBatches)
+    {
+        if (batch.mFence)
+        {
+            glDeleteSync(batch.mFence);
+            batch.mFence = nullptr;
+        }
+
+        if (batch.mBoundsBuffer)
+        {
+            glDeleteBuffers(1, &batch.mBoundsBuffer);
+            glDeleteBuffers(1, &batch.mVisibilityBuffer);
+            batch.mBoundsBuffer = 0;
+            batch.mVisibilityBuffer = 0;
+        }
+
+        batch.mGroups.clear();
+    }
+
+    if (mHiZ)
+    {
+        LLImageGL::deleteTextures(1, &mHiZ);
+        mHiZ = 0;
+    }
+#endif
+    mHiZWidth = mHiZHeight = mHiZLevels = 0;
+    mNextBatch = 0;
+}
+
+void LLGPUOcclusionCuller::resolve(Batch& batch, const U32* visibility)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_PIPELINE;
+
+    for (U32 i = 0; i < batch.mGroups.size(); ++i)
+    {
+        LLSpatialGroup* group = batch.mGroups[i];
+        if (group->isDead())
+        {
+            continue;
+        }
+
+        LLOcclusionCullingGroup* parent = (LLOcclusionCullingGroup*)group->getParent();
+        if (parent && parent->isOcclusionState(LLOcclusionCullingGroup::OCCLUDED))
+        { // the child is implicitly occluded, same as LLOcclusionCullingGroup::checkOcclusion
+            continue;
+        }
+
+        if (!visibility || (visibility[i / 32] & (1u << (i % 32))))
+        {
+            group->clearOcclusionState(LLOcclusionCullingGroup::OCCLUDED, LLOcclusionCullingGroup::STATE_MODE_DIFF);
+        }
+        else
+        {
+            group->setOcclusionState(LLOcclusionCullingGroup::OCCLUDED, LLOcclusionCullingGroup::STATE_MODE_DIFF);
+        }
+    }
+
+#if !LL_DARWIN
+    if (batch.mFence)
+    {
+        glDeleteSync(batch.mFence);
+        batch.mFence = nullptr;
+    }
+#endif
+    batch.mGroups.clear();
+}
+
+void LLGPUOcclusionCuller::readBack()
+{
+#if !LL_DARWIN
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_PIPELINE;
+    static LLCachedControl<U32> occlusion_timeout(gSavedSettings, "RenderOcclusionTimeout", 4);
+
+    // oldest batch first so newer results win
+    for (U32 i = 0; i < MAX_PENDING; ++i)
+    {
+        Batch& batch = mBatches[(mNextBatch + i) % MAX_PENDING];
+        if (!batch.mFence)
+        {
+            continue;
+        }
+
+        GLenum status = glClientWaitSync(batch.mFence, 0, 0);
+        if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED)
+        {
+            U32 words = (U32)(batch.mGroups.size() + 31) / 32;
+            mVisibility.resize(words);
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, batch.mVisibilityBuffer);
+            glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, words * sizeof(U32), mVisibility.data());
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+            resolve(batch, mVisibility.data());
+        }
+        else if (status == GL_WAIT_FAILED || gFrameCount - batch.mFrame > occlusion_timeout)
+        { // don't stall waiting for results, treat everything as visible like a timed out query
+            resolve(batch, nullptr);
+        }
+    }
+#endif
+}
+
+void LLGPUOcclusionCuller::buildDepthPyramid(LLRenderTarget& depth)
+{
+#if !LL_DARWIN
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_PIPELINE;
+    LL_PROFILE_GPU_ZONE("hi-z build");
+    LL_RECORD_GPU_PASS("hi-z build");
+
+    U32 width = llmax((depth.getWidth() + 1) / 2, 1U);
+    U32 height = llmax((depth.getHeight() + 1) / 2, 1U);
+
+    if (!mHiZ || width != mHiZWidth || height != mHiZHeight)
+    { // (re)allocate immutable storage at half the depth buffer's resolution with a full mip chain
+        if (mHiZ)
+        {
+            LLImageGL::deleteTextures(1, &mHiZ);
+        }
+
+        mHiZWidth = width;
+        mHiZHeight = height;
+        mHiZLevels = 1;
+        for (U32 dim = llmax(width, height); dim > 1; dim /= 2)
+        {
+            mHiZLevels++;
+        }
+
+        LLImageGL::generateTextures(1, &mHiZ);
+        gGL.getTexUnit(0)->bindManual(LLTexUnit::TT_TEXTURE, mHiZ, true);
+        glTexStorage2D(GL_TEXTURE_2D, mHiZLevels, GL_R32F, width, height);
+        gGL.getTexUnit(0)->setTextureFilteringOption(LLTexUnit::TFO_POINT);
+        gGL.getTexUnit(0)->unbind(LLTexUnit::TT_TEXTURE);
+    }
+
+    LLGLSLShader* shader = &gHiZDownsampleProgram;
+    shader->bind();
+
+    S32 channel = shader->getTextureChannel(LLShaderMgr::DEFERRED_DEPTH);
+
+    for (U32 level = 0; level < mHiZLevels; ++level)
+    {
+        if (level == 0)
+        {
+            gGL.getTexUnit(channel)->bind(&depth, true);
+            shader->uniform1i(sSrcLevel, 0);
+        }
+        else
+        {
+            gGL.getTexUnit(channel)->bindManual(LLTexUnit::TT_TEXTURE, mHiZ, true);
+            shader->uniform1i(sSrcLevel, level - 1);
+        }
+
+        U32 w = llmax(mHiZWidth >> level, 1U);
+        U32 h = llmax(mHiZHeight >> level, 1U);
+
+        glBindImageTexture(0, mHiZ, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+        glDispatchCompute((w + HIZ_GROUP_SIZE - 1) / HIZ_GROUP_SIZE, (h + HIZ_GROUP_SIZE - 1) / HIZ_GROUP_SIZE, 1);
+
+        // next level reads this one through texelFetch
+        glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+    }
+
+    glBindImageTexture(0, 0, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+    gGL.getTexUnit(channel)->unbind(LLTexUnit::TT_TEXTURE);
+    shader->unbind();
+#endif
+}
+
+void LLGPUOcclusionCuller::cull(LLCamera& camera, const std::vector<LLSpatialGroup*>& groups, LLRenderTarget& depth)
+{
+#if !LL_DARWIN
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_PIPELINE;
+    LL_PROFILE_GPU_ZONE("gpu occlusion cull");
+    LL_RECORD_GPU_PASS("gpu occlusion cull");
+
+    if (groups.empty())
+    {
+        return;
+    }
+
+    Batch& batch = mBatches[mNextBatch];
+    if (batch.mFence)
+    { // every batch is still in flight, give up on the oldest one
+        resolve(batch, nullptr);
+    }
+
+    buildDepthPyramid(depth);
+
+    U32 count = (U32)groups.size();
+    U32 words = (count + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE;
+
+    LLVector4a fudge;
+    fudge.splat(GPU_OCCLUSION_FUDGE);
+
+    mBounds.resize(count * 2);
+    batch.mGroups.reserve(count);
+    for (U32 i = 0; i < count; ++i)
+    {
+        const LLVector4a* bounds = groups[i]->getBounds();
+        mBounds[i * 2] = bounds[0];
+        mBounds[i * 2 + 1].setAdd(bounds[1], fudge);
+        batch.mGroups.push_back(groups[i]);
+    }
+
+    if (!batch.mBoundsBuffer)
+    {
+        glGenBuffers(1, &batch.mBoundsBuffer);
+        glGenBuffers(1, &batch.mVisibilityBuffer);
+    }
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, batch.mBoundsBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, mBounds.size() * sizeof(LLVector4a), mBounds.data(), GL_STREAM_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, batch.mVisibilityBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, words * sizeof(U32), nullptr, GL_STREAM_READ);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, batch.mBoundsBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, batch.mVisibilityBuffer);
+
+    LLGLSLShader* shader = &gOcclusionCullProgram;
+    shader->bind();
+
+    glh::matrix4f mvp(gGLProjection);
+    mvp.mult_right(glh::matrix4f(gGLModelView));
+    shader->uniformMatrix4fv(LLShaderMgr::MODELVIEW_PROJECTION_MATRIX, 1, GL_FALSE, mvp.m);
+    shader->uniform1i(sBoxCount, count);
+    shader->uniform1i(sHiZLevels, mHiZLevels);
+
+    S32 channel = shader->getTextureChannel(LLShaderMgr::DEFERRED_DEPTH);
+    gGL.getTexUnit(channel)->bindManual(LLTexUnit::TT_TEXTURE, mHiZ, true);
+
+    glDispatchCompute(words, 1, 1);
+
+    // make the visibility words visible to glGetBufferSubData in readBack
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+
+    gGL.getTexUnit(channel)->unbind(LLTexUnit::TT_TEXTURE);
+    shader->unbind();
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, 0);
+
+    batch.mFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    batch.mFrame = gFrameCount;
+
+    mNextBatch = (mNextBatch + 1) % MAX_PENDING;
+#endif
+}
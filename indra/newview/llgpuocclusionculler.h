@@ -0,0 +1,94 @@
+/**
+ * @file llgpuocclusionculler.h
+ * @brief LLGPUOcclusionCuller class declaration
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#pragma once
+
+#include "llgl.h"
+#include "llpointer.h"
+#include "llvector4a.h"
+
+#include <vector>
+
+class LLCamera;
+class LLRenderTarget;
+class LLSpatialGroup;
+
+// Replaces per-group occlusion queries for the world camera with a single compute dispatch.
+// Bounding boxes of all groups that need an occlusion test are checked against the frustum and
+// a hierarchical depth buffer (Hi-Z) built from the opaque depth rendered so far this frame.
+// Results come back as a visibility bitmask that is read without stalling a frame or more later
+// and applied to each group's OCCLUDED state, the same latency as occlusion queries.
+class LLGPUOcclusionCuller
+{
+public:
+    LLGPUOcclusionCuller() = default;
+    ~LLGPUOcclusionCuller();
+
+    // true if GPU occlusion culling is enabled (RenderGPUOcclusion) and supported
+    static bool isEnabled();
+
+    // release any GL state and drop pending results
+    void cleanup();
+
+    // apply finished visibility results to their groups, called from LLPipeline::updateCull
+    void readBack();
+
+    // build the depth pyramid from depth's depth buffer and test bounds of groups against it
+    // groups the compute pass can't handle (see canCull) must still go through LLSpatialGroup::doOcclusion
+    void cull(LLCamera& camera, const std::vector<LLSpatialGroup*>& groups, LLRenderTarget& depth);
+
+    // true if group can be occlusion tested by cull
+    static bool canCull(LLSpatialGroup* group, LLCamera& camera);
+
+private:
+    static constexpr U32 MAX_PENDING = 3;
+
+    struct Batch
+    {
+        GLuint mBoundsBuffer = 0;
+        GLuint mVisibilityBuffer = 0;
+        GLsync mFence = nullptr;
+        U32 mFrame = 0;
+        std::vector<LLPointer<LLSpatialGroup> > mGroups;
+    };
+
+    void buildDepthPyramid(LLRenderTarget& depth);
+
+    // apply visibility of batch to its groups and release it (visibility nullptr marks everything visible)
+    void resolve(Batch& batch, const U32* visibility);
+
+    Batch mBatches[MAX_PENDING];
+    U32 mNextBatch = 0;
+
+    GLuint mHiZ = 0;
+    U32 mHiZWidth = 0;
+    U32 mHiZHeight = 0;
+    U32 mHiZLevels = 0;
+
+    // scratch space for uploads and readback
+    std::vector<LLVector4a> mBounds;
+    std::vector<U32> mVisibility;
+};
@@ -0,0 +1,303 @@
+/**
+ * @file llgpupasstimer.cpp
+ * @brief GPU time of named render passes, in any build
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llgpupasstimer.h"
+
+#include "lldir.h"
+#include "llfile.h"
+#include "llgl.h"
+#include "llviewercontrol.h"
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+
+namespace
+{
+    struct Record
+    {
+        const char* mName;
+        U32 mDepth;
+        GLuint mBegin;
+        GLuint mEnd;
+    };
+
+    struct Frame
+    {
+        U32 mNumber;
+        std::vector<Record> mRecords;
+        GLuint mLastQuery = 0;  // the GPU is done with the frame once this one is available
+    };
+
+    // frames still waiting for their timestamps before we drop the oldest
+    const size_t MAX_PENDING_FRAMES = 4;
+    // weight of the newest frame in the averages
+    const F32 FRAME_WEIGHT = 0.1f;
+    // passes that stopped running are dropped once their average falls below this
+    const F32 MIN_PASS_MS = 0.005f;
+
+    Frame sCurrentFrame;
+    std::deque<Frame> sPendingFrames;
+    std::vector<GLuint> sFreeQueries;
+    U32 sDepth = 0;
+    U32 sFrameNumber = 0;
+
+    std::vector<LLGPUPassTimer::Pass> sPasses;
+    std::vector<LLGPUPassTimer::Pass> sFramePasses;
+    llofstream sLog;
+
+    GLuint get_query()
+    {
+        GLuint query = 0;
+        if (sFreeQueries.empty())
+        {
+            glGenQueries(1, &query);
+        }
+        else
+        {
+            query = sFreeQueries.back();
+            sFreeQueries.pop_back();
+        }
+        return query;
+    }
+
+    void free_queries(Frame& frame)
+    {
+        for (const Record& record : frame.mRecords)
+        {
+            sFreeQueries.push_back(record.mBegin);
+            if (record.mEnd)
+            {
+                sFreeQueries.push_back(record.mEnd);
+            }
+        }
+        frame.mRecords.clear();
+        frame.mLastQuery = 0;
+    }
+
+    bool same_pass(const LLGPUPassTimer::Pass& a, const LLGPUPassTimer::Pass& b)
+    {
+        return a.mDepth == b.mDepth && (a.mName == b.mName || !strcmp(a.mName, b.mName));
+    }
+}
+
+bool LLGPUPassTimer::sEnabled = false;
+bool LLGPUPassTimer::sRequested = false;
+
+// static
+S32 LLGPUPassTimer::begin(const char* name)
+{
+    GLuint query = get_query();
+    glQueryCounter(query, GL_TIMESTAMP);
+    sCurrentFrame.mRecords.push_back({ name, sDepth++, query, 0 });
+    sCurrentFrame.mLastQuery = query;
+    return (S32)sCurrentFrame.mRecords.size() - 1;
+}
+
+// static
+void LLGPUPassTimer::end(S32 index)
+{
+    --sDepth;
+    if ((size_t)index >= sCurrentFrame.mRecords.size())
+    { // GL was torn down while the pass ran
+        return;
+    }
+
+    GLuint query = get_query();
+    glQueryCounter(query, GL_TIMESTAMP);
+    sCurrentFrame.mRecords[index].mEnd = query;
+    sCurrentFrame.mLastQuery = query;
+}
+
+// static
+void LLGPUPassTimer::endFrame()
+{
+    static LLCachedControl<bool> show(gSavedSettings, "DebugShowGPUPasses", false);
+    static LLCachedControl<bool> log(gSavedSettings, "GPUPassTimesLog", false);
+
+    if (sEnabled)
+    {
+        LL_PROFILE_ZONE_SCOPED;
+
+        sCurrentFrame.mNumber = sFrameNumber++;
+        sPendingFrames.push_back(std::move(sCurrentFrame));
+        sCurrentFrame = Frame();
+    }
+
+    // timestamp queries need GL 3.3
+    sEnabled = (show || log || sRequested) && gGLManager.mInited && gGLManager.mGLVersion >= 3.25f;
+
+    if (log && sEnabled && !sLog.is_open())
+    {
+        std::string filename = gDirUtilp->getExpandedFilename(LL_PATH_LOGS, "gpu_passes.csv");
+        sLog.open(filename.c_str(), std::ios::out | std::ios::trunc);
+        if (sLog.is_open())
+        {
+            LL_INFOS("GPUPassTimer") << "Logging GPU pass times to " << filename << LL_ENDL;
+            sLog << "frame,pass,depth,ms\n";
+        }
+    }
+    else if (!log && sLog.is_open())
+    {
+        sLog.close();
+    }
+
+    readFrames();
+
+    if (!sEnabled)
+    {
+        sPasses.clear();
+    }
+}
+
+// static
+void LLGPUPassTimer::readFrames()
+{
+    // queries finish in order, stop at the first frame that isn't ready
+    while (!sPendingFrames.empty())
+    {
+        Frame& frame = sPendingFrames.front();
+        GLuint available = GL_TRUE;
+        if (frame.mLastQuery)
+        {
+            glGetQueryObjectuiv(frame.mLastQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+        }
+        if (!available && sPendingFrames.size() < MAX_PENDING_FRAMES)
+        {
+            break;
+        }
+
+        if (available && sEnabled)
+        {
+            // one entry per pass, a pass that ran several times in the frame is summed
+            sFramePasses.clear();
+            for (const Record& record : frame.mRecords)
+            {
+                if (!record.mEnd)
+                {
+                    continue;
+                }
+                GLuint64 begin_time = 0;
+                GLuint64 end_time = 0;
+                glGetQueryObjectui64v(record.mBegin, GL_QUERY_RESULT, &begin_time);
+                glGetQueryObjectui64v(record.mEnd, GL_QUERY_RESULT, &end_time);
+                // GPU timestamps are in nanoseconds
+                Pass pass = { record.mName, record.mDepth, (F32)(end_time - begin_time) / 1000000.f, true };
+
+                auto it = std::find_if(sFramePasses.begin(), sFramePasses.end(),
+                                       [&pass](const Pass& other) { return same_pass(pass, other); });
+                if (it != sFramePasses.end())
+                {
+                    it->mMs += pass.mMs;
+                }
+                else
+                {
+                    sFramePasses.push_back(pass);
+                }
+            }
+
+            for (Pass& pass : sPasses)
+            {
+                pass.mSeen = false;
+            }
+
+            // new passes go right after the pass that ran before them, which keeps children under
+            // their parent
+            size_t insert_at = 0;
+            for (const Pass& pass : sFramePasses)
+            {
+                auto it = std::find_if(sPasses.begin(), sPasses.end(),
+                                       [&pass](const Pass& other) { return same_pass(pass, other); });
+                if (it == sPasses.end())
+                {
+                    it = sPasses.insert(sPasses.begin() + llmin(insert_at, sPasses.size()), pass);
+                }
+                else
+                {
+                    it->mMs = lerp(it->mMs, pass.mMs, FRAME_WEIGHT);
+                    it->mSeen = true;
+                }
+                insert_at = (it - sPasses.begin()) + 1;
+            }
+
+            for (auto it = sPasses.begin(); it != sPasses.end(); )
+            {
+                if (!it->mSeen)
+                {
+                    it->mMs = lerp(it->mMs, 0.f, FRAME_WEIGHT);
+                    if (it->mMs < MIN_PASS_MS)
+                    {
+                        it = sPasses.erase(it);
+                        continue;
+                    }
+                }
+                ++it;
+            }
+
+            if (sLog.is_open())
+            {
+                logFrame(frame.mNumber, sFramePasses);
+            }
+        }
+
+        free_queries(frame);
+        sPendingFrames.pop_front();
+    }
+}
+
+// static
+void LLGPUPassTimer::logFrame(U32 frame_number, const std::vector<Pass>& passes)
+{
+    for (const Pass& pass : passes)
+    {
+        sLog << frame_number << ",\"" << pass.mName << "\"," << pass.mDepth << "," << llformat("%.3f", pass.mMs) << "\n";
+    }
+}
+
+// static
+const std::vector<LLGPUPassTimer::Pass>& LLGPUPassTimer::getPasses()
+{
+    return sPasses;
+}
+
+// static
+void LLGPUPassTimer::destroyGL()
+{
+    for (Frame& frame : sPendingFrames)
+    {
+        free_queries(frame);
+    }
+    free_queries(sCurrentFrame);
+    sPendingFrames.clear();
+
+    if (!sFreeQueries.empty())
+    {
+        glDeleteQueries((GLsizei)sFreeQueries.size(), sFreeQueries.data());
+        sFreeQueries.clear();
+    }
+}
@@ -0,0 +1,95 @@
+/**
+ * @file llgpupasstimer.h
+ * @brief GPU time of named render passes, in any build
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#pragma once
+
+#include "llpreprocessor.h"
+
+#include <vector>
+
+// Times named render passes on the GPU with timestamp queries.  LL_PROFILE_GPU_ZONE only
+// does anything in a Tracy build, LL_RECORD_GPU_PASS works in every build, so the passes
+// that matter carry both:
+//
+//     LL_PROFILE_GPU_ZONE("glow");
+//     LL_RECORD_GPU_PASS("glow");
+//
+// Passes nest with the scopes they are declared in.  Nothing is recorded unless
+// DebugShowGPUPasses (Advanced > Rendering > Show GPU Pass Times) or GPUPassTimesLog is on,
+// or a benchmark runs, then the results are read a few frames later without waiting for the GPU, averaged for
+// the overlay and, with GPUPassTimesLog, appended to gpu_passes.csv in the logs directory.
+class LLGPUPassTimer
+{
+public:
+    struct Pass
+    {
+        const char* mName;
+        U32 mDepth;
+        F32 mMs;            // averaged over recent frames
+        bool mSeen;         // measured in the latest frame
+    };
+
+    class Scope
+    {
+    public:
+        Scope(const char* name) : mIndex(sEnabled ? begin(name) : -1) {}
+        ~Scope()
+        {
+            if (mIndex >= 0)
+            {
+                end(mIndex);
+            }
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        S32 mIndex;
+    };
+
+    // Close the frame and pick up the results of earlier frames
+    static void endFrame();
+
+    // Passes in the order they ran, children after their parent
+    static const std::vector<Pass>& getPasses();
+
+    // Record passes whatever the settings say, for the benchmark mode
+    static void setRequested(bool requested) { sRequested = requested; }
+
+    static void destroyGL();
+
+private:
+    static S32 begin(const char* name);
+    static void end(S32 index);
+    static void readFrames();
+    static void logFrame(U32 frame_number, const std::vector<Pass>& passes);
+
+    static bool sEnabled;
+    static bool sRequested;
+};
+
+#define LL_RECORD_GPU_PASS(name) LLGPUPassTimer::Scope LL_GLUE_TOKENS(gpu_pass_, __LINE__)(name)
@@ -0,0 +1,335 @@
+/**
+ * @file llgpuskinning.cpp
+ * @brief LLGPUSkinning class implementation
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llgpuskinning.h"
+
+#include "lldrawpool.h"
+#include "llgpupasstimer.h"
+#include "llskinningutil.h"
+#include "llspatialpartition.h"
+#include "llviewercontrol.h"
+#include "llviewershadermgr.h"
+#include "llvoavatar.h"
+#include "pipeline.h"
+
+extern U32 gFrameCount;
+
+static LLStaticHashedString sSkinCached("skin_cached");
+static LLStaticHashedString sSrcOffsets("src_offsets");
+static LLStaticHashedString sVertexCount("vertex_count");
+static LLStaticHashedString sVertexStart("vertex_start");
+static LLStaticHashedString sVertexEnd("vertex_end");
+static LLStaticHashedString sPaletteOffset("palette_offset");
+static LLStaticHashedString sJointCount("joint_count");
+
+constexpr U32 SKIN_GROUP_SIZE = 64; // local_size_x of skinCacheC.glsl
+
+static const U32 sRiggedTypes[] =
+{
+    LLRenderPass::PASS_SIMPLE_RIGGED,
+    LLRenderPass::PASS_FULLBRIGHT_RIGGED,
+    LLRenderPass::PASS_INVISIBLE_RIGGED,
+    LLRenderPass::PASS_INVISI_SHINY_RIGGED,
+    LLRenderPass::PASS_FULLBRIGHT_SHINY_RIGGED,
+    LLRenderPass::PASS_SHINY_RIGGED,
+    LLRenderPass::PASS_BUMP_RIGGED,
+    LLRenderPass::PASS_POST_BUMP_RIGGED,
+    LLRenderPass::PASS_MATERIAL_RIGGED,
+    LLRenderPass::PASS_MATERIAL_ALPHA_RIGGED,
+    LLRenderPass::PASS_MATERIAL_ALPHA_MASK_RIGGED,
+    LLRenderPass::PASS_MATERIAL_ALPHA_EMISSIVE_RIGGED,
+    LLRenderPass::PASS_SPECMAP_RIGGED,
+    LLRenderPass::PASS_SPECMAP_BLEND_RIGGED,
+    LLRenderPass::PASS_SPECMAP_MASK_RIGGED,
+    LLRenderPass::PASS_SPECMAP_EMISSIVE_RIGGED,
+    LLRenderPass::PASS_NORMMAP_RIGGED,
+    LLRenderPass::PASS_NORMMAP_BLEND_RIGGED,
+    LLRenderPass::PASS_NORMMAP_MASK_RIGGED,
+    LLRenderPass::PASS_NORMMAP_EMISSIVE_RIGGED,
+    LLRenderPass::PASS_NORMSPEC_RIGGED,
+    LLRenderPass::PASS_NORMSPEC_BLEND_RIGGED,
+    LLRenderPass::PASS_NORMSPEC_MASK_RIGGED,
+    LLRenderPass::PASS_NORMSPEC_EMISSIVE_RIGGED,
+    LLRenderPass::PASS_GLOW_RIGGED,
+    LLRenderPass::PASS_GLTF_GLOW_RIGGED,
+    LLRenderPass::PASS_ALPHA_MASK_RIGGED,
+    LLRenderPass::PASS_FULLBRIGHT_ALPHA_MASK_RIGGED,
+    LLRenderPass::PASS_GLTF_PBR_RIGGED,
+    LLRenderPass::PASS_GLTF_PBR_ALPHA_MASK_RIGGED
+};
+
+// sort by avatar then mesh so each avatar's palettes are packed together, once per mesh
+struct CompareSkin
+{
+    bool operator()(const LLDrawInfo* lhs, const LLDrawInfo* rhs) const
+    {
+        if (lhs->mAvatar != rhs->mAvatar)
+        {
+            return lhs->mAvatar.get() < rhs->mAvatar.get();
+        }
+        if (lhs->mSkinInfo->mHash != rhs->mSkinInfo->mHash)
+        {
+            return lhs->mSkinInfo->mHash < rhs->mSkinInfo->mHash;
+        }
+        return lhs->mVertexBuffer.get() < rhs->mVertexBuffer.get();
+    }
+};
+
+LLGPUSkinning::~LLGPUSkinning()
+{
+    cleanup();
+}
+
+//static
+bool LLGPUSkinning::isEnabled()
+{
+#if LL_DARWIN
+    return false;
+#else
+    static LLCachedControl<bool> gpu_skinning(gSavedSettings, "RenderGPUSkinning", false);
+    return gpu_skinning &&
+        gGLManager.mGLVersion >= 4.29f &&
+        gSkinCacheProgram.isComplete();
+#endif
+}
+
+void LLGPUSkinning::cleanup()
+{
+    for (auto& entry : mSkinnedBuffers)
+    {
+        entry.second.mSource->setSkinnedBuffer(0, 0);
+        glDeleteBuffers(1, &entry.second.mBuffer);
+    }
+    mSkinnedBuffers.clear();
+
+    if (mPaletteBuffer)
+    {
+        glDeleteBuffers(1, &mPaletteBuffer);
+        mPaletteBuffer = 0;
+    }
+
+    mStamp = 0;
+    LLVertexBuffer::sSkinCacheStamp = 0;
+}
+
+void LLGPUSkinning::releaseIdle()
+{
+    for (auto iter = mSkinnedBuffers.begin(); iter != mSkinnedBuffers.end(); )
+    {
+        SkinnedBuffer& entry = iter->second;
+        // a single reference means only we still hold the vertex buffer
+        if (entry.mSource->getNumRefs() == 1 || gFrameCount - entry.mLastUsed > MAX_IDLE_FRAMES)
+        {
+            entry.mSource->setSkinnedBuffer(0, 0);
+            glDeleteBuffers(1, &entry.mBuffer);
+            iter = mSkinnedBuffers.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+}
+
+void LLGPUSkinning::update()
+{
+#if !LL_DARWIN
+    if (!isEnabled())
+    {
+        if (mStamp)
+        {
+            cleanup();
+        }
+        return;
+    }
+
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_AVATAR;
+    LL_PROFILE_GPU_ZONE("gpu skinning");
+    LL_RECORD_GPU_PASS("gpu skinning");
+
+    // everything skinned in an earlier frame is stale, 0 is never a valid stamp
+    U32 stamp = gFrameCount + 1;
+    if (mStamp != stamp)
+    {
+        mStamp = stamp;
+        LLVertexBuffer::sSkinCacheStamp = stamp;
+        releaseIdle();
+    }
+
+    mPending.clear();
+    for (U32 type : sRiggedTypes)
+    {
+        for (LLCullResult::drawinfo_iterator i = gPipeline.beginRenderMap(type); i != gPipeline.endRenderMap(type); ++i)
+        {
+            LLDrawInfo* params = *i;
+            LLVertexBuffer* buffer = params->mVertexBuffer;
+            if (params->mSkinCacheStamp != stamp &&
+                params->mAvatar.notNull() &&
+                params->mSkinInfo &&
+                buffer &&
+                buffer->getGLBuffer() &&
+                buffer->hasDataType(LLVertexBuffer::TYPE_WEIGHT4) &&
+                buffer->hasDataType(LLVertexBuffer::TYPE_NORMAL))
+            {
+                mPending.push_back(params);
+            }
+        }
+    }
+
+    if (mPending.empty())
+    {
+        return;
+    }
+
+    std::sort(mPending.begin(), mPending.end(), CompareSkin());
+
+    // pack the palettes for this batch into one buffer, -1 marks meshes whose skin isn't loaded yet
+    mPalettes.clear();
+    mPaletteOffsets.resize(mPending.size());
+    for (size_t i = 0; i < mPending.size(); ++i)
+    {
+        LLDrawInfo* params = mPending[i];
+        if (i > 0 &&
+            params->mAvatar == mPending[i - 1]->mAvatar &&
+            params->mSkinInfo->mHash == mPending[i - 1]->mSkinInfo->mHash)
+        {
+            mPaletteOffsets[i] = mPaletteOffsets[i - 1];
+            continue;
+        }
+
+        const LLVOAvatar::MatrixPaletteCache& mpc = params->mAvatar->updateSkinInfoMatrixPalette(params->mSkinInfo);
+        if (mpc.mMatrixPalette.empty())
+        {
+            mPaletteOffsets[i] = -1;
+            continue;
+        }
+
+        mPaletteOffsets[i] = (S32)(mPalettes.size() / 4);
+        mPalettes.insert(mPalettes.end(), mpc.mGLMp.begin(), mpc.mGLMp.end());
+    }
+
+    if (mPalettes.empty())
+    {
+        return;
+    }
+
+    if (!mPaletteBuffer)
+    {
+        glGenBuffers(1, &mPaletteBuffer);
+    }
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, mPaletteBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, mPalettes.size() * sizeof(F32), mPalettes.data(), GL_STREAM_DRAW);
+
+    LLGLSLShader* shader = &gSkinCacheProgram;
+    shader->bind();
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, mPaletteBuffer);
+
+    for (size_t i = 0; i < mPending.size(); ++i)
+    {
+        LLDrawInfo* params = mPending[i];
+        if (mPaletteOffsets[i] < 0)
+        {
+            continue;
+        }
+
+        LLVertexBuffer* buffer = params->mVertexBuffer;
+        U32 num_verts = buffer->getNumVerts();
+
+        SkinnedBuffer& entry = mSkinnedBuffers[buffer];
+        if (!entry.mBuffer || entry.mNumVerts != num_verts)
+        {
+            if (!entry.mBuffer)
+            {
+                glGenBuffers(1, &entry.mBuffer);
+                entry.mSource = buffer;
+            }
+
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, entry.mBuffer);
+            glBufferData(GL_SHADER_STORAGE_BUFFER, num_verts * 3 * sizeof(LLVector4a), nullptr, GL_DYNAMIC_COPY);
+            entry.mNumVerts = num_verts;
+        }
+        entry.mLastUsed = gFrameCount;
+
+        // attribute offsets are 16 byte aligned, address them as vec4s
+        const U32 vec4_size = sizeof(LLVector4a);
+        S32 base = (S32)(buffer->getGLBufferOffset() / vec4_size);
+        S32 tangent = buffer->hasDataType(LLVertexBuffer::TYPE_TANGENT) ? base + (S32)(buffer->getOffset(LLVertexBuffer::TYPE_TANGENT) / vec4_size) : -1;
+
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, buffer->getGLBuffer());
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, entry.mBuffer);
+
+        glUniform4i(shader->getUniformLocation(sSrcOffsets),
+            base + (S32)(buffer->getOffset(LLVertexBuffer::TYPE_VERTEX) / vec4_size),
+            base + (S32)(buffer->getOffset(LLVertexBuffer::TYPE_NORMAL) / vec4_size),
+            tangent,
+            base + (S32)(buffer->getOffset(LLVertexBuffer::TYPE_WEIGHT4) / vec4_size));
+        shader->uniform1i(sVertexCount, num_verts);
+        shader->uniform1i(sVertexStart, params->mStart);
+        shader->uniform1i(sVertexEnd, params->mEnd);
+        shader->uniform1i(sPaletteOffset, mPaletteOffsets[i]);
+        shader->uniform1i(sJointCount, LLSkinningUtil::getMeshJointCount(params->mSkinInfo));
+
+        U32 count = params->mEnd - params->mStart + 1;
+        glDispatchCompute((count + SKIN_GROUP_SIZE - 1) / SKIN_GROUP_SIZE, 1, 1);
+
+        buffer->setSkinnedBuffer(entry.mBuffer, stamp);
+        params->mSkinCacheStamp = stamp;
+    }
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, 0);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, 0);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    shader->unbind();
+
+    // skinned vertices are read as vertex attributes by every pass after this
+    glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+#endif
+}
+
+//static
+bool LLGPUSkinning::setupDraw(const LLDrawInfo& params)
+{
+    U32 stamp = LLVertexBuffer::sSkinCacheStamp;
+    bool skinned = stamp != 0 &&
+        params.mSkinCacheStamp == stamp &&
+        params.mVertexBuffer.notNull() &&
+        params.mVertexBuffer->getSkinnedStamp() == stamp;
+
+    LLVertexBuffer::sUseSkinCache = skinned;
+    LLGLSLShader::sCurBoundShaderPtr->uniform1i(sSkinCached, skinned ? 1 : 0);
+    return skinned;
+}
+
+//static
+void LLGPUSkinning::setupPalette()
+{
+    LLVertexBuffer::sUseSkinCache = false;
+    LLGLSLShader::sCurBoundShaderPtr->uniform1i(sSkinCached, 0);
+}
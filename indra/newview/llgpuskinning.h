@@ -0,0 +1,89 @@
+/**
+ * @file llgpuskinning.h
+ * @brief LLGPUSkinning class declaration
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#pragma once
+
+#include "llgl.h"
+#include "llpointer.h"
+#include "llvertexbuffer.h"
+
+#include <unordered_map>
+#include <vector>
+
+class LLDrawInfo;
+
+// Skins rigged vertices with a compute shader once per frame so shadow, probe and main passes
+// don't each run the matrix palette in their vertex shaders. Skinned positions, normals and
+// tangents go to a buffer kept per rigged LLVertexBuffer, and draws of skinned LLDrawInfos source
+// those attributes from it while the rigged shader skips its palette (see setupDraw).
+// Draws that weren't skinned this frame (alpha, previews, debug) still use the matrix palette.
+class LLGPUSkinning
+{
+public:
+    LLGPUSkinning() = default;
+    ~LLGPUSkinning();
+
+    // true if GPU skinning is enabled (RenderGPUSkinning) and supported
+    static bool isEnabled();
+
+    // release any GL state
+    void cleanup();
+
+    // skin every rigged draw in the current cull result that hasn't been skinned yet this frame
+    // call before a pass renders rigged geometry
+    void update();
+
+    // set up the bound rigged shader and vertex buffer state for drawing params
+    // returns true if params is drawn from the skin cache and needs no matrix palette
+    static bool setupDraw(const LLDrawInfo& params);
+
+    // set up the bound rigged shader to skin with the matrix palette
+    static void setupPalette();
+
+private:
+    // frames a skinned buffer is kept after its vertex buffer stops being drawn
+    static constexpr U32 MAX_IDLE_FRAMES = 8;
+
+    struct SkinnedBuffer
+    {
+        LLPointer<LLVertexBuffer> mSource;
+        GLuint mBuffer = 0;
+        U32 mNumVerts = 0;
+        U32 mLastUsed = 0;
+    };
+
+    void releaseIdle();
+
+    std::unordered_map<const LLVertexBuffer*, SkinnedBuffer> mSkinnedBuffers;
+
+    GLuint mPaletteBuffer = 0;
+    U32 mStamp = 0;
+
+    // scratch space for update
+    std::vector<LLDrawInfo*> mPending;
+    std::vector<S32> mPaletteOffsets;
+    std::vector<F32> mPalettes;
+};
@@ -2418,11 +2418,14 @@ void LLGroupMgr::processCapGroupMembersResponse(const LLSD& response, const std:
         sendGroupTitlesRequest(group_id);
     }
 
-    if (page_size && members_loaded >= page_size && member_count > members_before)
+    // A full page means there may be more, ask for the one after it
+    bool more_pages = page_size && members_loaded >= page_size && member_count > members_before;
+    if (more_pages)
     {
+        U32 next_page_start = page_start + page_size;
         LLCoros::instance().launch("LLGroupMgr::groupMembersRequestCoro", [&]()
             {
-                groupMembersRequestCoro(url, group_id, page_size, page_start, sort_column, sort_descending);
+                groupMembersRequestCoro(url, group_id, page_size, next_page_start, sort_column, sort_descending);
             });
     }
 
@@ -2434,7 +2437,14 @@ void LLGroupMgr::processCapGroupMembersResponse(const LLSD& response, const std:
     }
 
     group_datap->mChanged = true;
-    notifyObservers(GC_MEMBER_DATA);
+
+    // Observers rebuild their member lists from scratch on every notification,
+    // which is quadratic over the pages of a large group. Show the first page
+    // right away and everything else once the last page arrived.
+    if (!page_start || !more_pages)
+    {
+        notifyObservers(GC_MEMBER_DATA);
+    }
 }
 
 void LLGroupMgr::sendGroupRoleChanges(const LLUUID& group_id)
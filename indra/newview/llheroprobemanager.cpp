@@ -28,6 +28,7 @@
 
 #include "llheroprobemanager.h"
 #include "llreflectionmapmanager.h"
+#include "llgpupasstimer.h"
 #include "llviewercamera.h"
 #include "llspatialpartition.h"
 #include "llviewerregion.h"
@@ -60,6 +61,36 @@ static void touch_default_probe(LLReflectionMap* probe)
     }
 }
 
+// true if the mirror can't contribute to the frame, either because its spatial group
+// was occluded last frame or because it covers too few pixels to be worth a cube map
+static bool mirror_hidden(LLVOVolume* vo)
+{
+    static LLCachedControl<F32> sMinPixelArea(gSavedSettings, "RenderHeroProbeMinPixelArea", 16.f);
+
+    if (vo->getPixelArea() < sMinPixelArea)
+    {
+        return true;
+    }
+
+    if (LLPipeline::sUseOcclusion)
+    {
+        LLSpatialGroup* group = vo->mDrawable->getSpatialGroup();
+        if (group && group->isOcclusionState(LLSpatialGroup::OCCLUDED))
+        {
+            return true;
+        }
+
+        LLSpatialBridge* bridge = vo->mDrawable->getSpatialBridge();
+        group = bridge ? bridge->getSpatialGroup() : nullptr;
+        if (group && group->isOcclusionState(LLSpatialGroup::OCCLUDED))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 LLHeroProbeManager::LLHeroProbeManager()
 {
 }
@@ -138,7 +169,7 @@ void LLHeroProbeManager::update()
 
                 size.load3(vo->getScale().mV);
 
-                bool visible = LLViewerCamera::instance().AABBInFrustum(center, size);
+                bool visible = LLViewerCamera::instance().AABBInFrustum(center, size) && !mirror_hidden(vo);
 
                 // <FS:Beq> Check if the reflection normal (Z-Up axis) is facing towards the camera
                 auto reflection_normal = LLVector3(0, 0, 1);
@@ -258,22 +289,63 @@ void LLHeroProbeManager::renderProbes()
             rate = 6;
         }
 
-        S32 face = gFrameCount % 6;
+        static LLCachedControl<bool> sAdaptive(gSavedSettings, "RenderHeroProbeAdaptive", false);
 
-        if (!mProbes.empty() && !mProbes[0].isNull() && !mProbes[0]->mOccluded)
+        // GL_TIME_ELAPSED queries can't nest with shader profiling
+        bool adaptive = sAdaptive && !LLGLSLShader::sProfileEnabled;
+        U32 cycle = gFrameCount;
+        bool due = true;
+
+        if (adaptive)
+        {
+            updateAdaptiveRate();
+            rate = llmax(rate, mAdaptiveRate);
+            due = gFrameCount - mLastUpdateFrame >= mAdaptiveInterval;
+            // count updates rather than frames so skipped frames don't starve any faces
+            cycle = mUpdateCycle;
+        }
+        else
         {
-            LL_PROFILE_ZONE_NUM(gFrameCount % rate);
+            mAdaptiveRate = 1;
+            mAdaptiveInterval = 1;
+        }
+
+        if (!mProbes.empty() && !mProbes[0].isNull() && !mProbes[0]->mOccluded && due)
+        {
+            LL_PROFILE_ZONE_NUM(cycle % rate);
             LL_PROFILE_ZONE_NUM(rate);
 
+            bool timed = adaptive && !mTimerPending;
+            if (timed)
+            {
+                if (!mTimerQuery)
+                {
+                    glGenQueries(1, &mTimerQuery);
+                }
+                glBeginQuery(GL_TIME_ELAPSED, mTimerQuery);
+            }
+
+            U32 faces = 0;
             for (U32 i = 0; i < 6; ++i)
             {
-                if ((gFrameCount % rate) == (i % rate))
+                if ((cycle % rate) == (i % rate))
                 { // update 6/rate faces per frame
                     LL_PROFILE_ZONE_NUM(i);
                     updateProbeFace(mProbes[0], i, mNearestHero->getReflectionProbeIsDynamic() && sDetail > 0, near_clip);
+                    ++faces;
                 }
             }
             generateRadiance(mProbes[0]);
+
+            if (timed)
+            {
+                glEndQuery(GL_TIME_ELAPSED);
+                mTimerPending = true;
+                mTimedFaces = faces;
+            }
+
+            mLastUpdateFrame = gFrameCount;
+            ++mUpdateCycle;
         }
 
         mRenderingMirror = false;
@@ -285,6 +357,54 @@ void LLHeroProbeManager::renderProbes()
     }
 }
 
+void LLHeroProbeManager::updateAdaptiveRate()
+{
+    if (!mTimerPending)
+    {
+        return;
+    }
+
+    GLuint available = GL_FALSE;
+    glGetQueryObjectuiv(mTimerQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available)
+    {
+        return;
+    }
+
+    GLuint64 time_elapsed = 0;
+    glGetQueryObjectui64v(mTimerQuery, GL_QUERY_RESULT, &time_elapsed);
+    mTimerPending = false;
+
+    // radiance generation is folded into the per face cost
+    F32 cost = time_elapsed / 1000000.f / llmax(mTimedFaces, 1U);
+    mFaceCost = mFaceCost < 0.f ? cost : lerp(mFaceCost, cost, 0.1f);
+
+    static LLCachedControl<F32> sTargetMs(gSavedSettings, "RenderHeroProbeTargetMs", 2.f);
+    F32 target = llmax((F32)sTargetMs, 0.1f);
+
+    // rate must be a divisor of 6, use the most faces per update that fit in the target
+    S32 affordable = (S32)(target / llmax(mFaceCost, 0.001f));
+    if (affordable >= 6)
+    {
+        mAdaptiveRate = 1;
+    }
+    else if (affordable >= 3)
+    {
+        mAdaptiveRate = 2;
+    }
+    else if (affordable >= 2)
+    {
+        mAdaptiveRate = 3;
+    }
+    else
+    {
+        mAdaptiveRate = 6;
+    }
+
+    // if even a single face is over budget, spread updates across frames
+    mAdaptiveInterval = llclamp((U32)ceilf(mFaceCost / target), 1U, 8U);
+}
+
 // Do the reflection map update render passes.
 // For every 12 calls of this function, one complete reflection probe radiance map and irradiance map is generated
 // First six passes render the scene with direct lighting only into a scratch space cube map at the end of the cube map array and generate
@@ -441,6 +561,7 @@ void LLHeroProbeManager::generateRadiance(LLReflectionMap* probe)
             for (int i = 0; i < mMipChain.size() / 4; ++i)
             {
                 LL_PROFILE_GPU_ZONE("probe radiance gen");
+                LL_RECORD_GPU_PASS("probe radiance gen");
                 static LLStaticHashedString sMipLevel("mipLevel");
                 static LLStaticHashedString sRoughness("roughness");
                 static LLStaticHashedString sWidth("u_width");
@@ -610,6 +731,14 @@ void LLHeroProbeManager::cleanup()
     mProbes.clear();
 
     mDefaultProbe = nullptr;
+
+    if (mTimerQuery)
+    {
+        glDeleteQueries(1, &mTimerQuery);
+        mTimerQuery = 0;
+    }
+    mTimerPending = false;
+    mFaceCost = -1.f;
 }
 
 void LLHeroProbeManager::doOcclusion()
@@ -119,6 +119,9 @@ private:
     void updateProbeFace(LLReflectionMap* probe, U32 face, bool is_dynamic, F32 near_clip);
     void generateRadiance(LLReflectionMap *probe);
 
+    // read back the last timer query and pick faces per update and frames between updates for RenderHeroProbeTargetMs
+    void updateAdaptiveRate();
+
     // list of active reflection maps
     std::vector<LLPointer<LLReflectionMap>> mProbes;
 
@@ -141,6 +144,16 @@ private:
 
     bool mRenderingMirror = false;
 
+    // adaptive update state (RenderHeroProbeAdaptive)
+    GLuint mTimerQuery = 0;
+    bool mTimerPending = false;
+    U32 mTimedFaces = 0;
+    F32 mFaceCost = -1.f; // smoothed GPU ms per face, -1 until measured
+    S32 mAdaptiveRate = 1; // update 6/mAdaptiveRate faces per update
+    U32 mAdaptiveInterval = 1; // frames between updates
+    U32 mLastUpdateFrame = 0;
+    U32 mUpdateCycle = 0;
+
     std::vector<LLPointer<LLVOVolume>>                       mHeroVOList;
     LLPointer<LLVOVolume>                                 mNearestHero;
 
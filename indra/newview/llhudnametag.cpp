@@ -327,6 +327,10 @@ void LLHUDNameTag::renderText(bool for_select)
 
     F32 y_offset = (F32)mOffsetY;
 
+    // All lines go out together, see hud_render_text_lines()
+    static std::vector<LLHUDTextLine> lines;
+    lines.clear();
+
     // Render label
     {
         for(std::vector<LLHUDTextSegment>::iterator segment_iter = mLabelSegments.begin();
@@ -347,7 +351,7 @@ void LLHUDNameTag::renderText(bool for_select)
             }
 
             LLColor4 label_color(0.f, 0.f, 0.f, alpha_factor);
-            hud_render_text(segment_iter->getText(), render_position, *fontp, segment_iter->mStyle, LLFontGL::NO_SHADOW, x_offset, y_offset, label_color, false);
+            lines.push_back({ &segment_iter->getText(), fontp, segment_iter->mStyle, LLFontGL::NO_SHADOW, x_offset, y_offset, label_color });
         }
     }
 
@@ -392,9 +396,10 @@ void LLHUDNameTag::renderText(bool for_select)
             text_color = segment_iter->mColor;
             text_color.mV[VALPHA] *= alpha_factor;
 
-            hud_render_text(segment_iter->getText(), render_position, *fontp, style, shadow, x_offset, y_offset, text_color, false);
+            lines.push_back({ &segment_iter->getText(), fontp, style, shadow, x_offset, y_offset, text_color });
         }
     }
+    hud_render_text_lines(lines.data(), (U32)lines.size(), render_position, false);
     /// Reset the default color to white.  The renderer expects this to be the default.
     gGL.color4f(1.0f, 1.0f, 1.0f, 1.0f);
     if (for_select)
@@ -57,48 +57,24 @@ void hud_render_text(const LLWString &wstr, const LLVector3 &pos_agent,
                     const F32 x_offset, const F32 y_offset,
                     const LLColor4& color,
                     const bool orthographic)
+{
+    LLHUDTextLine line = { &wstr, &font, style, shadow, x_offset, y_offset, color };
+    hud_render_text_lines(&line, 1, pos_agent, orthographic);
+}
+
+void hud_render_text_lines(const LLHUDTextLine* lines, U32 count, const LLVector3 &pos_agent, const bool orthographic)
 {
     LLViewerCamera* camera = LLViewerCamera::getInstance();
     // Do cheap plane culling
     LLVector3 dir_vec = pos_agent - camera->getOrigin();
     dir_vec /= dir_vec.magVec();
 
-    if (wstr.empty() || (!orthographic && dir_vec * camera->getAtAxis() <= 0.f))
+    if (!count || (!orthographic && dir_vec * camera->getAtAxis() <= 0.f))
     {
         return;
     }
 
-    LLVector3 right_axis;
-    LLVector3 up_axis;
-    if (orthographic)
-    {
-        right_axis.setVec(0.f, -1.f / gViewerWindow->getWorldViewHeightScaled(), 0.f);
-        up_axis.setVec(0.f, 0.f, 1.f / gViewerWindow->getWorldViewHeightScaled());
-    }
-    else
-    {
-        camera->getPixelVectors(pos_agent, up_axis, right_axis);
-    }
-    LLCoordFrame render_frame = *camera;
-    LLQuaternion rot;
-    if (!orthographic)
-    {
-        rot = render_frame.getQuaternion();
-        rot = rot * LLQuaternion(-F_PI_BY_TWO, camera->getYAxis());
-        rot = rot * LLQuaternion(F_PI_BY_TWO, camera->getXAxis());
-    }
-    else
-    {
-        rot = LLQuaternion(-F_PI_BY_TWO, LLVector3(0.f, 0.f, 1.f));
-        rot = rot * LLQuaternion(-F_PI_BY_TWO, LLVector3(0.f, 1.f, 0.f));
-    }
-    F32 angle;
-    LLVector3 axis;
-    rot.getAngleAxis(&angle, axis);
-
-    LLVector3 render_pos = pos_agent + (floorf(x_offset) * right_axis) + (floorf(y_offset) * up_axis);
-
-    //get the render_pos in screen space
+    //get the pos_agent in screen space
 
     F64 winX, winY, winZ;
     LLRect world_view_rect = gViewerWindow->getWorldViewRectRaw();
@@ -117,7 +93,7 @@ void hud_render_text(const LLWString &wstr, const LLVector3 &pos_agent,
         proj[i] = (F64) gGLProjection[i];
     }
 
-    gluProject(render_pos.mV[0], render_pos.mV[1], render_pos.mV[2],
+    gluProject(pos_agent.mV[0], pos_agent.mV[1], pos_agent.mV[2],
                 mdlv, proj, (GLint*) viewport,
                 &winX, &winY, &winZ);
 
@@ -133,12 +109,28 @@ void hud_render_text(const LLWString &wstr, const LLVector3 &pos_agent,
 
     winX -= world_view_rect.mLeft;
     winY -= world_view_rect.mBottom;
-    LLUI::loadIdentity();
-    gGL.loadIdentity();
-    LLUI::translate((F32) winX*1.0f/LLFontGL::sScaleX, (F32) winY*1.0f/(LLFontGL::sScaleY), -(((F32) winZ*2.f)-1.f));
-    F32 right_x;
+    F32 depth = -(((F32) winZ*2.f)-1.f);
 
-    font.render(wstr, 0, 0, 1, color, LLFontGL::LEFT, LLFontGL::BASELINE, style, shadow, static_cast<S32>(wstr.length()), 1000, &right_x, /*use_ellipses*/false, /*use_color*/true);
+    // The offsets are in UI pixels along the camera's pixel vectors, so every line can
+    // share the projection of pos_agent instead of projecting its own position
+    const LLVector2& display_scale = gViewerWindow->getDisplayScale();
+    for (U32 i = 0; i < count; ++i)
+    {
+        const LLHUDTextLine& line = lines[i];
+        if (line.mText->empty())
+        {
+            continue;
+        }
+
+        LLUI::loadIdentity();
+        gGL.loadIdentity();
+        LLUI::translate((F32) (winX + floorf(line.mXOffset) * display_scale.mV[VX])*1.0f/LLFontGL::sScaleX,
+                        (F32) (winY + floorf(line.mYOffset) * display_scale.mV[VY])*1.0f/(LLFontGL::sScaleY), depth);
+        F32 right_x;
+
+        line.mFont->render(*line.mText, 0, 0, 1, line.mColor, LLFontGL::LEFT, LLFontGL::BASELINE, line.mStyle, line.mShadow,
+                           static_cast<S32>(line.mText->length()), 1000, &right_x, /*use_ellipses*/false, /*use_color*/true);
+    }
 
     LLUI::popMatrix();
     gGL.popMatrix();
@@ -43,6 +43,24 @@ void hud_render_text(const LLWString &wstr,
                      const LLColor4& color,
                      const bool orthographic);
 
+struct LLHUDTextLine
+{
+    const LLWString* mText;
+    const LLFontGL* mFont;
+    U8 mStyle;
+    LLFontGL::ShadowType mShadow;
+    F32 mXOffset;   // in UI pixels from pos_agent
+    F32 mYOffset;
+    LLColor4 mColor;
+};
+
+// Same as hud_render_text() for all lines of one label, which share the projection and
+// GL state setup
+void hud_render_text_lines(const LLHUDTextLine* lines,
+                           U32 count,
+                           const LLVector3 &pos_agent,
+                           const bool orthographic);
+
 // Legacy, slower
 void hud_render_utf8text(const std::string &str,
                          const LLVector3 &pos_agent,
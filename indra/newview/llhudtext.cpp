@@ -198,6 +198,10 @@ void LLHUDText::renderText()
 
     F32 y_offset = (F32)mOffsetY;
 
+    // All lines go out together, see hud_render_text_lines()
+    static std::vector<LLHUDTextLine> lines;
+    lines.clear();
+
     // Render label
 
     // Render text
@@ -241,9 +245,10 @@ void LLHUDText::renderText()
             }
             text_color.mV[VALPHA] *= alpha_factor;
 
-            hud_render_text(segment_iter->getText(), render_position, *fontp, style, shadow, x_offset, y_offset, text_color, mOnHUDAttachment);
+            lines.push_back({ &segment_iter->getText(), fontp, style, shadow, x_offset, y_offset, text_color });
         }
     }
+    hud_render_text_lines(lines.data(), (U32)lines.size(), render_position, mOnHUDAttachment);
     /// Reset the default color to white.  The renderer expects this to be the default.
     gGL.color4f(1.0f, 1.0f, 1.0f, 1.0f);
 }
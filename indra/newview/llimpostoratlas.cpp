@@ -0,0 +1,193 @@
+/**
+ * @file llimpostoratlas.cpp
+ * @brief LLImpostorAtlas class implementation
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llimpostoratlas.h"
+
+#include "llviewercontrol.h"
+#include "llvoavatar.h"
+
+extern U32 gFrameCount;
+extern U32 nhpo2(U32 v);
+
+bool LLImpostorAtlas::allocate()
+{
+    static LLCachedControl<U32> atlas_size(gSavedSettings, "RenderImpostorAtlasSize", 2048);
+    static LLCachedControl<U32> tile_size(gSavedSettings, "RenderImpostorTileSize", 128);
+
+    cleanup();
+
+    mSize = llclamp(nhpo2(atlas_size), 256U, 4096U);
+    // avatars are tall, so tiles are twice as high as they are wide
+    mTileWidth = llclamp(nhpo2(tile_size), 16U, mSize / 2);
+    mTileHeight = mTileWidth * 2;
+    mColumns = mSize / mTileWidth;
+
+    if (!mTarget.allocate(mSize, mSize, GL_RGBA, true))
+    {
+        LL_WARNS("AvatarRenderPipeline") << "Failed to allocate " << mSize << "x" << mSize << " impostor atlas" << LL_ENDL;
+        mTarget.release();
+        return false;
+    }
+
+    mTiles.resize(mColumns * (mSize / mTileHeight));
+    return true;
+}
+
+void LLImpostorAtlas::cleanup()
+{
+    for (Tile& tile : mTiles)
+    {
+        if (tile.mAvatar)
+        {
+            tile.mAvatar->mImpostorTile = -1;
+            tile.mAvatar->mNeedsImpostorUpdate = true;
+        }
+    }
+    mTiles.clear();
+    mTarget.release();
+}
+
+bool LLImpostorAtlas::acquireTile(LLVOAvatar* avatar)
+{
+    if (getTile(avatar))
+    {
+        return true;
+    }
+
+    S32 best = -1;
+    for (S32 i = 0; i < (S32)mTiles.size(); ++i)
+    {
+        if (!mTiles[i].mAvatar)
+        {
+            best = i;
+            break;
+        }
+
+        if (best == -1 || mTiles[i].mLastUsed < mTiles[best].mLastUsed)
+        {
+            best = i;
+        }
+    }
+
+    if (best == -1)
+    {
+        return false;
+    }
+
+    Tile& tile = mTiles[best];
+    if (tile.mAvatar)
+    { // evict least recently drawn impostor
+        tile.mAvatar->mImpostorTile = -1;
+        tile.mAvatar->mNeedsImpostorUpdate = true;
+        tile.mAvatar->mLastImpostorUpdateReason = 12;
+    }
+
+    tile = Tile();
+    tile.mAvatar = avatar;
+    tile.mLastUsed = gFrameCount;
+    avatar->mImpostorTile = best;
+    return true;
+}
+
+void LLImpostorAtlas::releaseTile(LLVOAvatar* avatar)
+{
+    if (getTile(avatar))
+    {
+        mTiles[avatar->mImpostorTile] = Tile();
+    }
+    avatar->mImpostorTile = -1;
+}
+
+void LLImpostorAtlas::touchTile(const LLVOAvatar* avatar)
+{
+    if (getTile(avatar))
+    {
+        mTiles[avatar->mImpostorTile].mLastUsed = gFrameCount;
+    }
+}
+
+void LLImpostorAtlas::bindTile(const LLVOAvatar* avatar, U32 width, U32 height)
+{
+    llassert(getTile(avatar));
+    Tile& tile = mTiles[avatar->mImpostorTile];
+    tile.mWidth = llclamp(width, 1U, mTileWidth);
+    tile.mHeight = llclamp(height, 1U, mTileHeight);
+
+    S32 x, y;
+    getTileOrigin(avatar->mImpostorTile, x, y);
+
+    mTarget.bindTarget();
+    glViewport(x, y, tile.mWidth, tile.mHeight);
+}
+
+void LLImpostorAtlas::clearTile(const LLVOAvatar* avatar)
+{
+    const Tile* tile = getTile(avatar);
+    llassert(tile);
+
+    S32 x, y;
+    getTileOrigin(avatar->mImpostorTile, x, y);
+
+    LLGLEnable scissor(GL_SCISSOR_TEST);
+    glScissor(x, y, tile->mWidth, tile->mHeight);
+    mTarget.clear();
+}
+
+void LLImpostorAtlas::getTexCoords(const LLVOAvatar* avatar, LLVector2& tc_min, LLVector2& tc_max) const
+{
+    const Tile* tile = getTile(avatar);
+    if (!tile || !mSize)
+    {
+        tc_min.setVec(0.f, 0.f);
+        tc_max.setVec(0.f, 0.f);
+        return;
+    }
+
+    S32 x, y;
+    getTileOrigin(avatar->mImpostorTile, x, y);
+
+    F32 scale = 1.f / mSize;
+    tc_min.setVec(x * scale, y * scale);
+    tc_max.setVec((x + tile->mWidth) * scale, (y + tile->mHeight) * scale);
+}
+
+const LLImpostorAtlas::Tile* LLImpostorAtlas::getTile(const LLVOAvatar* avatar) const
+{
+    S32 index = avatar->mImpostorTile;
+    if (index >= 0 && index < (S32)mTiles.size() && mTiles[index].mAvatar == avatar)
+    {
+        return &mTiles[index];
+    }
+    return nullptr;
+}
+
+void LLImpostorAtlas::getTileOrigin(S32 index, S32& x, S32& y) const
+{
+    x = (index % mColumns) * mTileWidth;
+    y = (index / mColumns) * mTileHeight;
+}
@@ -0,0 +1,98 @@
+/**
+ * @file llimpostoratlas.h
+ * @brief LLImpostorAtlas class declaration
+ *
+ * $LicenseInfo:firstyear=2024&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2024, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#pragma once
+
+#include "llrendertarget.h"
+#include "v2math.h"
+
+#include <vector>
+
+class LLVOAvatar;
+
+// One render target shared by all avatar impostors, split into fixed-size tiles.
+// Each impostor avatar owns at most one tile; when every tile is taken the one
+// drawn least recently is handed over and its owner is flagged for a new impostor.
+class LLImpostorAtlas
+{
+public:
+    LLImpostorAtlas() = default;
+
+    bool isComplete() const { return mTarget.isComplete(); }
+
+    // allocate the color/depth target using RenderImpostorAtlasSize and RenderImpostorTileSize
+    // caller adds any deferred attachments to getTarget()
+    bool allocate();
+
+    // release the target and take every tile back from its avatar
+    void cleanup();
+
+    LLRenderTarget& getTarget() { return mTarget; }
+
+    // give avatar a tile, evicting the least recently drawn one if the atlas is full
+    // returns false if the atlas has no tiles
+    bool acquireTile(LLVOAvatar* avatar);
+
+    // return avatar's tile to the atlas (if it has one)
+    void releaseTile(LLVOAvatar* avatar);
+
+    // mark avatar's tile as drawn this frame
+    void touchTile(const LLVOAvatar* avatar);
+
+    // bind the atlas and limit the viewport to the first width x height pixels of avatar's tile
+    // width and height are clamped to the tile size
+    void bindTile(const LLVOAvatar* avatar, U32 width, U32 height);
+
+    // clear the region of the tile set up by bindTile
+    void clearTile(const LLVOAvatar* avatar);
+
+    void flush() { mTarget.flush(); }
+
+    // texture coordinates of the region of avatar's tile written by the last bindTile
+    void getTexCoords(const LLVOAvatar* avatar, LLVector2& tc_min, LLVector2& tc_max) const;
+
+    U32 getTileWidth() const { return mTileWidth; }
+    U32 getTileHeight() const { return mTileHeight; }
+
+private:
+    struct Tile
+    {
+        LLVOAvatar* mAvatar = nullptr;
+        U32 mLastUsed = 0;
+        U32 mWidth = 0;
+        U32 mHeight = 0;
+    };
+
+    const Tile* getTile(const LLVOAvatar* avatar) const;
+    void getTileOrigin(S32 index, S32& x, S32& y) const;
+
+    LLRenderTarget mTarget;
+    std::vector<Tile> mTiles;
+    U32 mSize = 0;
+    U32 mTileWidth = 0;
+    U32 mTileHeight = 0;
+    U32 mColumns = 0;
+};
@@ -2396,7 +2396,7 @@ void LLIMProcessing::requestOfflineMessagesCoro(std::string url)
                     S32(local_bin_bucket.size()),
                     local_sender,
                     message_data["asset_id"].asUUID());
-            });
+            }, LLAppViewer::MAIN_WORK_UI);
 
     }
 }
@@ -111,7 +111,12 @@ bool LLInventoryFilter::check(const LLFolderViewModelItem* item)
         return true;
     }
 
-    std::string desc = listener->getSearchableCreatorName();
+    if (!is_folder && !checkAgainstNameIndex(listener))
+    {
+        return false;
+    }
+
+    std::string desc;
     switch(mSearchType)
     {
         case SEARCHTYPE_CREATOR:
@@ -183,6 +188,31 @@ bool LLInventoryFilter::check(const LLFolderViewModelItem* item)
     return passed;
 }
 
+bool LLInventoryFilter::checkAgainstNameIndex(const LLFolderViewModelItemInventory* listener)
+{
+    if (mSearchType != SEARCHTYPE_NAME || mFilterSubString.empty() || !mFilterTokens.empty() || !mExactToken.empty())
+    {
+        return true;
+    }
+
+    LLInventorySearchIndex& index = LLInventorySearchIndex::instance();
+    if (mNameQuery.mSubString != mFilterSubString)
+    {
+        index.query(mFilterSubString, mNameQuery);
+    }
+    if (index.mayMatch(mNameQuery, listener->getUUID()))
+    {
+        return true;
+    }
+
+    // The item name can't contain the string, but the searchable name also has a suffix
+    // like " (worn)" that isn't indexed: only look where a match would reach into it
+    const std::string& searchable_name = listener->getSearchableName();
+    size_t name_length = listener->getDisplayName().size();
+    size_t from = name_length + 1 > mFilterSubString.size() ? name_length + 1 - mFilterSubString.size() : 0;
+    return searchable_name.find(mFilterSubString, from) != std::string::npos;
+}
+
 bool LLInventoryFilter::check(const LLInventoryItem* item)
 {
     const bool passed_string = (mFilterSubString.size() ? item->getName().find(mFilterSubString) != std::string::npos : true);
@@ -30,6 +30,7 @@
 #include "llinventorytype.h"
 #include "llpermissionsflags.h"
 #include "llfolderviewmodel.h"
+#include "llinventorysearchindex.h"
 
 class LLFolderViewItem;
 class LLFolderViewFolder;
@@ -371,6 +372,7 @@ private:
     bool                checkAgainstCreator(const class LLFolderViewModelItemInventory* listener) const;
     bool                checkAgainstSearchVisibility(const class LLFolderViewModelItemInventory* listener) const;
     bool                checkAgainstClipboard(const LLUUID& object_id) const;
+    bool                checkAgainstNameIndex(const class LLFolderViewModelItemInventory* listener);
 
     FilterOps               mFilterOps;
     FilterOps               mDefaultFilterOps;
@@ -401,6 +403,8 @@ private:
     std::vector<std::string> mFilterTokens;
     std::string              mExactToken;
 
+    LLInventorySearchIndex::Query mNameQuery;   // items that may contain mFilterSubString
+
     bool mSingleFolderMode;
 };
 
@@ -60,6 +60,7 @@
 #include "llcallbacklist.h"
 #include "llvoavatarself.h"
 #include "llgesturemgr.h"
+#include "llmemorystream.h"
 #include "llsdserialize.h"
 #include "llsdutil.h"
 #include "bufferarray.h"
@@ -84,6 +85,11 @@
 
 #include <algorithm>
 #include <boost/algorithm/string/join.hpp>
+#ifdef LL_USESYSTEMLIBS
+#include <zlib.h>
+#else
+#include "zlib-ng/zlib.h"
+#endif
 
 #include "aoengine.h"
 #include "fsfloaterwearablefavorites.h"
@@ -104,8 +110,9 @@ S32 LLInventoryModel::sPendingSystemFolders = 0;
 ///----------------------------------------------------------------------------
 
 //bool decompress_file(const char* src_filename, const char* dst_filename);
-static const char PRODUCTION_CACHE_FORMAT_STRING[] = "%s.inv.llsd";
-static const char GRID_CACHE_FORMAT_STRING[] = "%s.%s.inv.llsd";
+// Binary LLSD records, see saveToFile().  Still matched by LLDiskCache::removeOldVFSFiles().
+static const char PRODUCTION_CACHE_FORMAT_STRING[] = "%s.inv.llsdb";
+static const char GRID_CACHE_FORMAT_STRING[] = "%s.%s.inv.llsdb";
 static const char * const LOG_INV("Inventory");
 
 struct InventoryIDPtrLess
@@ -2515,21 +2522,9 @@ void LLInventoryModel::cache(
         items,
         INCLUDE_TRASH,
         can_cache);
-    // Use temporary file to avoid potential conflicts with other
-    // instances (even a 'read only' instance unzips into a file)
-    std::string temp_file = gDirUtilp->getTempFilename();
-    saveToFile(temp_file, categories, items);
     std::string gzip_filename = getInvCacheAddres(agent_id);
     gzip_filename.append(".gz");
-    if(gzip_file(temp_file, gzip_filename))
-    {
-        LL_DEBUGS(LOG_INV) << "Successfully compressed " << temp_file << " to " << gzip_filename << LL_ENDL;
-        LLFile::remove(temp_file);
-    }
-    else
-    {
-        LL_WARNS(LOG_INV) << "Unable to compress " << temp_file << " into " << gzip_filename << LL_ENDL;
-    }
+    saveToFile(gzip_filename, categories, items);
 }
 
 
@@ -2928,41 +2923,16 @@ bool LLInventoryModel::loadSkeleton(
         changed_items_t categories_to_update;
         item_array_t possible_broken_links;
         cat_set_t invalid_categories; // Used to mark categories that weren't successfully loaded.
-        std::string inventory_filename = getInvCacheAddres(owner_id);
         const S32 NO_VERSION = LLViewerInventoryCategory::VERSION_UNKNOWN;
-        std::string gzip_filename(inventory_filename);
+        // read straight from the compressed file, nothing is unpacked to disk
+        std::string gzip_filename = getInvCacheAddres(owner_id);
         gzip_filename.append(".gz");
-        LLFILE* fp = LLFile::fopen(gzip_filename, "rb");
-        bool remove_inventory_file = false;
-        if (LLAppViewer::instance()->isSecondInstance())
-        {
-            // Safeguard viewer against trying to unpack file twice
-            // ex: user logs into two accounts simultaneously, so two
-            // viewers are trying to unpack library into same file
-            //
-            // Would be better to do it in gunzip_file, but it doesn't
-            // have access to llfilesystem
-            inventory_filename = gDirUtilp->getTempFilename();
-            remove_inventory_file = true;
-        }
-        if(fp)
-        {
-            fclose(fp);
-            fp = NULL;
-            if(gunzip_file(gzip_filename, inventory_filename))
-            {
-                // we only want to remove the inventory file if it was
-                // gzipped before we loaded, and we successfully
-                // gunziped it.
-                remove_inventory_file = true;
-            }
-            else
-            {
-                LL_INFOS(LOG_INV) << "Unable to gunzip " << gzip_filename << LL_ENDL;
-            }
-        }
-        bool is_cache_obsolete = false;
-        if (loadFromFile(inventory_filename, categories, items, categories_to_update, is_cache_obsolete))
+        CacheLoad cache_load = takeCacheLoad(owner_id, gzip_filename);
+        categories.swap(cache_load.mCategories);
+        items.swap(cache_load.mItems);
+        categories_to_update.swap(cache_load.mCatsToUpdate);
+        bool is_cache_obsolete = cache_load.mObsolete;
+        if (cache_load.mLoaded)
         {
             // We were able to find a cache of files. So, use what we
             // found to generate a set of categories we should add. We
@@ -3146,11 +3116,6 @@ bool LLInventoryModel::loadSkeleton(
             }
         }
 
-        if(remove_inventory_file)
-        {
-            // clean up the gunzipped file.
-            LLFile::remove(inventory_filename);
-        }
         if(is_cache_obsolete && !LLAppViewer::instance()->isSecondInstance())
         {
             // If out of date, remove the gzipped file too.
@@ -3594,6 +3559,102 @@ bool LLUUIDAndName::operator>(const LLUUIDAndName& rhs) const
     return (mID > rhs.mID);
 }
 
+static gzFile open_gzip_file(const std::string& filename, const char* mode)
+{
+#if LL_WINDOWS
+    return gzopen_w(utf8str_to_utf16str(filename).c_str(), mode);
+#else
+    return gzopen(filename.c_str(), mode);
+#endif
+}
+
+static bool read_gzip_file(const std::string& filename, std::string& contents)
+{
+    gzFile src = open_gzip_file(filename, "rb");
+    if (!src)
+    {
+        return false;
+    }
+
+    const S32 READ_BUFFER_SIZE = 256 * 1024;
+    std::vector<char> buffer(READ_BUFFER_SIZE);
+    S32 bytes = 0;
+    while ((bytes = gzread(src, buffer.data(), READ_BUFFER_SIZE)) > 0)
+    {
+        contents.append(buffer.data(), bytes);
+    }
+    gzclose(src);
+    return bytes == 0;
+}
+
+// Write out what has been serialized so far once there is enough of it to be worth a
+// call into zlib, or all of it when flush is set
+static bool write_gzip_records(gzFile dst, std::ostringstream& records, bool flush)
+{
+    const std::streamoff WRITE_CHUNK_SIZE = 1024 * 1024;
+    if (!flush && records.tellp() < WRITE_CHUNK_SIZE)
+    {
+        return true;
+    }
+
+    const std::string data = records.str();
+    records.str(std::string());
+    return data.empty() || gzwrite(dst, data.data(), (unsigned)data.size()) > 0;
+}
+
+void LLInventoryModel::prefetchCache(const LLUUID& owner_id)
+{
+    if (owner_id.isNull() || mCachePrefetches.count(owner_id))
+    {
+        return;
+    }
+    // loadSkeleton() purges the cache first, nothing to read ahead of it
+    if (LLFile::isfile(gDirUtilp->getExpandedFilename(LL_PATH_CACHE, owner_id.asString() + "_DELETE_INV_GZ")))
+    {
+        return;
+    }
+
+    LL::WorkQueue::ptr_t general_queue = LL::WorkQueue::getInstance("General");
+    if (!general_queue)
+    {
+        return;
+    }
+
+    std::string gzip_filename = getInvCacheAddres(owner_id);
+    gzip_filename.append(".gz");
+    auto promise = std::make_shared<std::promise<CacheLoad> >();
+    std::future<CacheLoad> future = promise->get_future();
+    if (general_queue->post([promise, gzip_filename]()
+                            {
+                                LLTimer timer;
+                                CacheLoad load;
+                                load.mLoaded = loadFromFile(gzip_filename, load.mCategories, load.mItems,
+                                                            load.mCatsToUpdate, load.mObsolete);
+                                LL_INFOS(LOG_INV) << "Read inventory cache " << gzip_filename << " ahead in "
+                                                  << timer.getElapsedTimeF32() << " seconds" << LL_ENDL;
+                                promise->set_value(std::move(load));
+                            }))
+    {
+        mCachePrefetches[owner_id] = std::move(future);
+    }
+}
+
+LLInventoryModel::CacheLoad LLInventoryModel::takeCacheLoad(const LLUUID& owner_id, const std::string& filename)
+{
+    auto it = mCachePrefetches.find(owner_id);
+    if (it != mCachePrefetches.end())
+    {
+        std::future<CacheLoad> future = std::move(it->second);
+        mCachePrefetches.erase(it);
+        LL_PROFILE_ZONE_NAMED("inventory wait for prefetch");
+        return future.get();
+    }
+
+    CacheLoad load;
+    load.mLoaded = loadFromFile(filename, load.mCategories, load.mItems, load.mCatsToUpdate, load.mObsolete);
+    return load;
+}
+
 // static
 bool LLInventoryModel::loadFromFile(const std::string& filename,
                                     LLInventoryModel::cat_array_t& categories,
@@ -3610,9 +3671,9 @@ bool LLInventoryModel::loadFromFile(const std::string& filename,
     }
     LL_INFOS(LOG_INV) << "loading inventory from: (" << filename << ")" << LL_ENDL;
 
-    llifstream file(filename.c_str());
-
-    if (!file.is_open())
+    // gzread() passes files that aren't compressed through unchanged
+    std::string contents;
+    if (!read_gzip_file(filename, contents))
     {
         LL_INFOS(LOG_INV) << "unable to load inventory from: " << filename << LL_ENDL;
         return false;
@@ -3620,14 +3681,12 @@ bool LLInventoryModel::loadFromFile(const std::string& filename,
 
     is_cache_obsolete = true; // Obsolete until proven current
 
-    //U64 lines_count = 0U;
-    std::string line;
-    LLPointer<LLSDParser> parser = new LLSDNotationParser();
-    while (std::getline(file, line))
+    LLMemoryStream stream((const U8*)contents.data(), (S32)contents.size());
+    LLPointer<LLSDParser> parser = new LLSDBinaryParser();
+    while (stream.peek() != std::char_traits<char>::eof())
     {
         LLSD s_item;
-        std::istringstream iss(line);
-        if (parser->parse(iss, s_item, line.length()) == LLSDParser::PARSE_FAILURE)
+        if (parser->parse(stream, s_item, LLSDSerialize::SIZE_UNLIMITED) == LLSDParser::PARSE_FAILURE)
         {
             LL_WARNS(LOG_INV)<< "Parsing inventory cache failed" << LL_ENDL;
             break;
@@ -3685,18 +3744,8 @@ bool LLInventoryModel::loadFromFile(const std::string& filename,
                 }
             }
         }
-
-//      TODO(brad) - figure out how to reenable this without breaking everything else
-//      static constexpr U64 BATCH_SIZE = 512U;
-//      if ((++lines_count % BATCH_SIZE) == 0)
-//      {
-//          // SL-19968 - make sure message system code gets a chance to run every so often
-//          pump_idle_startup_network();
-//      }
     }
 
-    file.close();
-
     return !is_cache_obsolete;
 }
 
@@ -3713,66 +3762,80 @@ bool LLInventoryModel::saveToFile(const std::string& filename,
 
     LL_INFOS(LOG_INV) << "saving inventory to: (" << filename << ")" << LL_ENDL;
 
+    // One binary LLSD record per line of the old text format, compressed as they are
+    // written.  A temporary file keeps other instances from reading a partial cache.
+    std::string temp_filename = filename + ".t";
+    gzFile dst = open_gzip_file(temp_filename, "wb");
+    if (!dst)
+    {
+        LL_WARNS(LOG_INV) << "Failed to open file. Unable to save inventory to: " << filename << LL_ENDL;
+        return false;
+    }
+
+    bool success = true;
+    S32 cat_count = 0;
+    auto it_count = items.size();
     try
     {
-        llofstream fileXML(filename.c_str());
-        if (!fileXML.is_open())
-        {
-            LL_WARNS(LOG_INV) << "Failed to open file. Unable to save inventory to: " << filename << LL_ENDL;
-            return false;
-        }
+        std::ostringstream records;
 
         LLSD cache_ver;
         cache_ver["inv_cache_version"] = sCurrentInvCacheVersion;
+        LLSDSerialize::toBinary(cache_ver, records);
 
-        if (fileXML.fail())
-        {
-            LL_WARNS(LOG_INV) << "Failed to write cache version to file. Unable to save inventory to: " << filename << LL_ENDL;
-            return false;
-        }
-
-        fileXML << LLSDOStreamer<LLSDNotationFormatter>(cache_ver) << std::endl;
-
-        S32 cat_count = 0;
         for (auto& cat : categories)
         {
             if (cat->getVersion() != LLViewerInventoryCategory::VERSION_UNKNOWN)
             {
-                fileXML << LLSDOStreamer<LLSDNotationFormatter>(cat->exportLLSD()) << std::endl;
+                LLSDSerialize::toBinary(cat->exportLLSD(), records);
                 cat_count++;
             }
-
-            if (fileXML.fail())
+            if (!write_gzip_records(dst, records, false))
             {
                 LL_WARNS(LOG_INV) << "Failed to write a folder to file. Unable to save inventory to: " << filename << LL_ENDL;
-                return false;
+                success = false;
+                break;
             }
         }
 
-        auto it_count = items.size();
-        for (auto& item : items)
+        for (auto it = items.begin(); success && it != items.end(); ++it)
         {
-            fileXML << LLSDOStreamer<LLSDNotationFormatter>(item->asLLSD()) << std::endl;
-
-            if (fileXML.fail())
+            LLSDSerialize::toBinary((*it)->asLLSD(), records);
+            if (!write_gzip_records(dst, records, false))
             {
                 LL_WARNS(LOG_INV) << "Failed to write an item to file. Unable to save inventory to: " << filename << LL_ENDL;
-                return false;
+                success = false;
             }
         }
-        fileXML.flush();
-
-        fileXML.close();
 
-        LL_INFOS(LOG_INV) << "Inventory saved: " << cat_count << " categories, " << it_count << " items." << LL_ENDL;
+        success = success && write_gzip_records(dst, records, true);
     }
     catch (...)
     {
         LOG_UNHANDLED_EXCEPTION("");
+        success = false;
+    }
+
+    if (gzclose(dst) != Z_OK)
+    {
+        success = false;
+    }
+    if (success)
+    {
+#if LL_WINDOWS
+        // Rename in windows needs the destination to not exist.
+        LLFile::remove(filename, ENOENT);
+#endif
+        success = LLFile::rename(temp_filename, filename) == 0;
+    }
+    if (!success)
+    {
+        LLFile::remove(temp_filename);
         LL_INFOS(LOG_INV) << "Failed to save inventory to: (" << filename << ")" << LL_ENDL;
         return false;
     }
 
+    LL_INFOS(LOG_INV) << "Inventory saved: " << cat_count << " categories, " << it_count << " items." << LL_ENDL;
     return true;
 }
 
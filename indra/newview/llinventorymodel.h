@@ -27,6 +27,7 @@
 #ifndef LL_LLINVENTORYMODEL_H
 #define LL_LLINVENTORYMODEL_H
 
+#include <future>
 #include <map>
 #include <set>
 #include <string>
@@ -200,6 +201,9 @@ public:
     // Methods to load up inventory skeleton & meat. These are used
     // during authentication. Returns true if everything parsed.
     bool loadSkeleton(const LLSD& options, const LLUUID& owner_id);
+    // Start reading owner_id's inventory cache on the General thread pool, so that
+    // loadSkeleton() finds it already parsed instead of reading it on the main thread
+    void prefetchCache(const LLUUID& owner_id);
     void buildParentChildMap(); // brute force method to rebuild the entire parent-child relations
     void createCommonSystemCategories();
 
@@ -730,6 +734,19 @@ protected:
                            const cat_array_t& categories,
                            const item_array_t& items);
 
+    struct CacheLoad
+    {
+        cat_array_t mCategories;
+        item_array_t mItems;
+        changed_items_t mCatsToUpdate;
+        bool mObsolete = false;
+        bool mLoaded = false;
+    };
+    // Result of prefetchCache() for owner_id if there is one, otherwise loadFromFile()
+    CacheLoad takeCacheLoad(const LLUUID& owner_id, const std::string& filename);
+
+    std::map<LLUUID, std::future<CacheLoad> > mCachePrefetches;
+
     //--------------------------------------------------------------------
     // Message handling functionality
     //--------------------------------------------------------------------
@@ -47,6 +47,12 @@
 #include "llviewermenu.h"
 #include "llviewernetwork.h"
 
+// Adaptive AIS fetch concurrency, see onAISResponse()
+static const F32 AIS_INITIAL_CONCURRENCY = 4.f;
+static const U32 AIS_MAX_CONCURRENCY = 50;
+static const F64 AIS_FAST_RESPONSE_SECONDS = 1.0;
+static const F64 AIS_SLOW_RESPONSE_SECONDS = 5.0;
+
 // History (may be apocryphal)
 //
 // Around V2, an HTTP inventory download mechanism was added
@@ -200,6 +206,9 @@ LLInventoryModelBackgroundFetch::LLInventoryModelBackgroundFetch():
     mRecursiveInventoryFetchStarted(false),
     mRecursiveLibraryFetchStarted(false),
     mRecursiveMarketplaceFetchStarted(false),
+    mFetchConcurrency(AIS_INITIAL_CONCURRENCY),
+    mFetchSlowStart(true),
+    mLastThrottledCount(0),
     mMinTimeBetweenFetches(0.3f)
 {}
 
@@ -340,7 +349,7 @@ void LLInventoryModelBackgroundFetch::start(const LLUUID& id, bool recursive)
         }
         else
         {
-            if (AISAPI::isAvailable())
+            if (AISAPI::isAvailable() && recursive)
             {
                 if (mFetchFolderQueue.empty() || mFetchFolderQueue.back().mUUID != id)
                 {
@@ -352,7 +361,9 @@ void LLInventoryModelBackgroundFetch::start(const LLUUID& id, bool recursive)
             }
             else if (mFetchFolderQueue.empty() || mFetchFolderQueue.front().mUUID != id)
             {
-                    // Specific folder requests go to front of queue.
+                    // Specific folder requests go to front of queue, these are
+                    // usually folders the user just opened, so let them jump
+                    // ahead of the background crawl.
                     mFetchFolderQueue.push_front(FetchQueueInfo(id, recursion_type));
                     gIdleCallbacks.addFunction(&LLInventoryModelBackgroundFetch::backgroundFetchCB, NULL);
             }
@@ -725,6 +736,35 @@ void ais_simple_item_callback(const LLUUID& inv_id)
     LLInventoryModelBackgroundFetch::instance().incrFetchCount(-1);
 }
 
+void LLInventoryModelBackgroundFetch::onAISResponse(F64 request_time, bool success)
+{
+    // Additive increase while AIS keeps up, multiplicative decrease when it
+    // doesn't.  Until the first back off every quick response widens the
+    // window by one, which doubles it per round trip.
+    F64 elapsed = LLTimer::getTotalSeconds() - request_time;
+    if (!success)
+    {
+        backOffFetchConcurrency("failed request");
+    }
+    else if (elapsed > AIS_SLOW_RESPONSE_SECONDS)
+    {
+        mFetchConcurrency = llmax(mFetchConcurrency * 0.75f, 1.f);
+        mFetchSlowStart = false;
+    }
+    else if (elapsed < AIS_FAST_RESPONSE_SECONDS)
+    {
+        mFetchConcurrency += mFetchSlowStart ? 1.f : 1.f / mFetchConcurrency;
+        mFetchConcurrency = llmin(mFetchConcurrency, (F32)AIS_MAX_CONCURRENCY);
+    }
+}
+
+void LLInventoryModelBackgroundFetch::backOffFetchConcurrency(const char* reason)
+{
+    mFetchConcurrency = llmax(mFetchConcurrency * 0.5f, 1.f);
+    mFetchSlowStart = false;
+    LL_DEBUGS(LOG_INV, "AIS3") << "Backing off after " << reason << ", concurrency now " << mFetchConcurrency << LL_ENDL;
+}
+
 void LLInventoryModelBackgroundFetch::onAISContentCalback(
     const LLUUID& request_id,
     const uuid_vec_t& content_ids,
@@ -895,9 +935,21 @@ void LLInventoryModelBackgroundFetch::bulkFetchViaAis()
     }
 
     static LLCachedControl<U32> ais_pool(gSavedSettings, "PoolSizeAIS", 20);
+    static LLCachedControl<bool> adaptive(gSavedSettings, "AISFetchAdaptive", true);
     // Don't have too many requests at once, AIS throttles
     // Reserve one request for actions outside of fetch (like renames)
-    const U32 max_concurrent_fetches = llclamp(ais_pool - 1, 1, 50);
+    U32 max_concurrent_fetches = llclamp(ais_pool - 1, 1, AIS_MAX_CONCURRENCY);
+    if (adaptive)
+    {
+        // any throttled AIS request, fetch or not, means we are pushing too hard
+        U32 throttled = AISAPI::getThrottledCount();
+        if (throttled != mLastThrottledCount)
+        {
+            mLastThrottledCount = throttled;
+            backOffFetchConcurrency("throttling");
+        }
+        max_concurrent_fetches = llclamp((U32)mFetchConcurrency, 1U, max_concurrent_fetches);
+    }
 
     if ((U32)mFetchCount >= max_concurrent_fetches)
     {
@@ -1007,11 +1059,12 @@ void LLInventoryModelBackgroundFetch::bulkFetchViaAis(const FetchQueueInfo& fetc
             mExpectedFolderIds.push_back(cat_id);
             // Lost and found
             // Should it actually be recursive?
-            AISAPI::FetchOrphans([](const LLUUID& response_id)
+            F64 request_time = LLTimer::getTotalSeconds();
+            AISAPI::FetchOrphans([request_time](const LLUUID& response_id)
                                  {
-                                     LLInventoryModelBackgroundFetch::instance().onAISFolderCalback(LLUUID::null,
-                                         response_id,
-                                         FT_DEFAULT);
+                                     LLInventoryModelBackgroundFetch& fetcher = LLInventoryModelBackgroundFetch::instance();
+                                     fetcher.onAISResponse(request_time, response_id.notNull());
+                                     fetcher.onAISFolderCalback(LLUUID::null, response_id, FT_DEFAULT);
                                  });
         }
         else
@@ -1069,9 +1122,12 @@ void LLInventoryModelBackgroundFetch::bulkFetchViaAis(const FetchQueueInfo& fetc
 
                         EFetchType type = fetch_info.mFetchType;
                         LLUUID cat_id = cat->getUUID(); // need a copy for lambda
-                        AISAPI::completion_t cb = [cat_id, children, type](const LLUUID& response_id)
+                        F64 request_time = LLTimer::getTotalSeconds();
+                        AISAPI::completion_t cb = [cat_id, children, type, request_time](const LLUUID& response_id)
                         {
-                            LLInventoryModelBackgroundFetch::instance().onAISContentCalback(cat_id, children, response_id, type);
+                            LLInventoryModelBackgroundFetch& fetcher = LLInventoryModelBackgroundFetch::instance();
+                            fetcher.onAISResponse(request_time, response_id.notNull());
+                            fetcher.onAISContentCalback(cat_id, children, response_id, type);
                         };
 
                         AISAPI::ITEM_TYPE item_type = AISAPI::INVENTORY;
@@ -1108,8 +1164,20 @@ void LLInventoryModelBackgroundFetch::bulkFetchViaAis(const FetchQueueInfo& fetc
                 else if (LLViewerInventoryCategory::VERSION_UNKNOWN == cat->getVersion()
                          || fetch_info.mFetchType == FT_FORCED)
                 {
+                    static LLCachedControl<S32> max_recursive(gSavedSettings, "AISRecursiveFetchMaxDescendents", 250);
+                    EFetchType type = fetch_info.mFetchType;
+                    if (type == FT_RECURSIVE
+                        && cat->getDescendentCount() > max_recursive
+                        && max_recursive > 0)
+                    {
+                        // Descendent count came with the parent or the cache. A
+                        // folder this big is likely to have a subtree AIS refuses
+                        // in one piece, skip straight to the split request rather
+                        // than paying for a failed recursive one first.
+                        type = FT_FOLDER_AND_CONTENT;
+                    }
                     LLViewerInventoryCategory::EFetchType target_state =
-                        fetch_info.mFetchType > FT_CONTENT_RECURSIVE
+                        type > FT_CONTENT_RECURSIVE
                         ? LLViewerInventoryCategory::FETCH_RECURSIVE
                         : LLViewerInventoryCategory::FETCH_NORMAL;
                     // start again if we did a non-recursive fetch before
@@ -1121,11 +1189,13 @@ void LLInventoryModelBackgroundFetch::bulkFetchViaAis(const FetchQueueInfo& fetc
                         cat->setFetching(target_state);
                         mExpectedFolderIds.push_back(cat_id);
 
-                        EFetchType type = fetch_info.mFetchType;
                         LLUUID cat_cb_id = cat_id;
-                        AISAPI::completion_t cb = [cat_cb_id, type](const LLUUID& response_id)
+                        F64 request_time = LLTimer::getTotalSeconds();
+                        AISAPI::completion_t cb = [cat_cb_id, type, request_time](const LLUUID& response_id)
                         {
-                            LLInventoryModelBackgroundFetch::instance().onAISFolderCalback(cat_cb_id, response_id , type);
+                            LLInventoryModelBackgroundFetch& fetcher = LLInventoryModelBackgroundFetch::instance();
+                            fetcher.onAISResponse(request_time, response_id.notNull());
+                            fetcher.onAISFolderCalback(cat_cb_id, response_id , type);
                         };
 
                         AISAPI::ITEM_TYPE item_type = AISAPI::INVENTORY;
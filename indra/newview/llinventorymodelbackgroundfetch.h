@@ -112,6 +112,8 @@ protected:
     void onAISFolderCalback(const LLUUID &request_id, const LLUUID &response_id, EFetchType fetch_type);
     void bulkFetchViaAis();
     void bulkFetchViaAis(const FetchQueueInfo& fetch_info);
+    void onAISResponse(F64 request_time, bool success);
+    void backOffFetchConcurrency(const char* reason);
     void bulkFetch();
 
     void backgroundFetch();
@@ -133,6 +135,11 @@ private:
     S32 mLastFetchCount; // for debug
     S32 mFetchFolderCount;
 
+    // AIS requests allowed in flight, adapted to how quickly AIS answers
+    F32 mFetchConcurrency;
+    bool mFetchSlowStart;
+    U32 mLastThrottledCount;
+
     LLFrameTimer mFetchTimer;
     F32 mMinTimeBetweenFetches;
     fetch_queue_t mFetchFolderQueue;
@@ -0,0 +1,232 @@
+/**
+ * @file llinventorysearchindex.cpp
+ * @brief Trigram index over inventory item names
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llinventorysearchindex.h"
+
+#include "llinventorymodel.h"
+#include "llviewercontrol.h"
+
+#include <algorithm>
+
+LLInventorySearchIndex::LLInventorySearchIndex()
+:   mGeneration(0),
+    mBuilt(false)
+{
+    gInventory.addObserver(this);
+}
+
+LLInventorySearchIndex::~LLInventorySearchIndex()
+{
+    if (gInventory.containsObserver(this))
+    {
+        gInventory.removeObserver(this);
+    }
+}
+
+bool LLInventorySearchIndex::query(const std::string& sub_string, Query& query)
+{
+    static LLCachedControl<bool> enabled(gSavedSettings, "InventorySearchIndex", true);
+
+    query = Query();
+    query.mSubString = sub_string;
+    if (!enabled || sub_string.size() < 3)
+    {
+        return false;
+    }
+    if (!mBuilt)
+    {
+        if (!gInventory.isInventoryUsable())
+        {
+            return false;
+        }
+        build();
+    }
+
+    std::vector<U32> trigrams;
+    getTrigrams(sub_string, trigrams);
+    std::vector<const std::vector<U32>*> postings;
+    for (U32 trigram : trigrams)
+    {
+        auto it = mPostings.find(trigram);
+        if (it == mPostings.end())
+        {
+            // no indexed name contains this part of the string
+            postings.clear();
+            break;
+        }
+        postings.push_back(&it->second);
+    }
+
+    // start from the rarest trigram, the intersection only gets smaller
+    std::sort(postings.begin(), postings.end(),
+              [](const std::vector<U32>* a, const std::vector<U32>* b) { return a->size() < b->size(); });
+    if (!postings.empty())
+    {
+        query.mSlots = *postings.front();
+        std::vector<U32> intersection;
+        for (size_t i = 1; i < postings.size() && !query.mSlots.empty(); ++i)
+        {
+            intersection.clear();
+            std::set_intersection(query.mSlots.begin(), query.mSlots.end(),
+                                  postings[i]->begin(), postings[i]->end(),
+                                  std::back_inserter(intersection));
+            query.mSlots.swap(intersection);
+        }
+    }
+
+    query.mGeneration = mGeneration;
+    query.mValid = true;
+    return true;
+}
+
+bool LLInventorySearchIndex::mayMatch(const Query& query, const LLUUID& id) const
+{
+    if (!query.mValid)
+    {
+        return true;
+    }
+    auto it = mSlots.find(id);
+    if (it == mSlots.end() || mEntries[it->second].mGeneration > query.mGeneration)
+    {
+        // not indexed yet, or renamed since
+        return true;
+    }
+    return std::binary_search(query.mSlots.begin(), query.mSlots.end(), it->second);
+}
+
+void LLInventorySearchIndex::changed(U32 mask)
+{
+    if (!mBuilt || !(mask & (LABEL | ADD | REMOVE | INTERNAL | REBUILD)))
+    {
+        return;
+    }
+
+    for (const LLUUID& id : gInventory.getChangedIDs())
+    {
+        indexItem(id);
+    }
+}
+
+void LLInventorySearchIndex::build()
+{
+    LL_PROFILE_ZONE_SCOPED;
+
+    mBuilt = true;
+    LLInventoryModel::cat_array_t cats;
+    LLInventoryModel::item_array_t items;
+    gInventory.collectDescendents(gInventory.getRootFolderID(), cats, items, LLInventoryModel::INCLUDE_TRASH);
+    if (gInventory.getLibraryRootFolderID().notNull())
+    {
+        gInventory.collectDescendents(gInventory.getLibraryRootFolderID(), cats, items, LLInventoryModel::INCLUDE_TRASH);
+    }
+
+    mEntries.reserve(items.size());
+    for (const LLPointer<LLViewerInventoryItem>& item : items)
+    {
+        indexItem(item->getUUID());
+    }
+    LL_INFOS("Inventory") << "Indexed " << mSlots.size() << " item names for search" << LL_ENDL;
+}
+
+void LLInventorySearchIndex::indexItem(const LLUUID& id)
+{
+    const LLViewerInventoryItem* item = gInventory.getItem(id);
+    // links show the name of their target, which can change without them being notified
+    if (!item || item->getIsLinkType())
+    {
+        removeItem(id);
+        return;
+    }
+
+    std::string name = item->getName();
+    LLStringUtil::toUpper(name);
+
+    auto it = mSlots.find(id);
+    if (it != mSlots.end())
+    {
+        if (mEntries[it->second].mName == name)
+        {
+            return;
+        }
+        removeItem(id);
+    }
+    U32 slot = (U32)mEntries.size();
+    mEntries.push_back({ id, name, ++mGeneration });
+    mSlots[id] = slot;
+
+    // new slots are the highest yet, so appending keeps the postings sorted
+    std::vector<U32> trigrams;
+    getTrigrams(name, trigrams);
+    for (U32 trigram : trigrams)
+    {
+        mPostings[trigram].push_back(slot);
+    }
+}
+
+void LLInventorySearchIndex::removeItem(const LLUUID& id)
+{
+    auto it = mSlots.find(id);
+    if (it == mSlots.end())
+    {
+        return;
+    }
+
+    Entry& entry = mEntries[it->second];
+    std::vector<U32> trigrams;
+    getTrigrams(entry.mName, trigrams);
+    for (U32 trigram : trigrams)
+    {
+        std::vector<U32>& slots = mPostings[trigram];
+        auto slot_it = std::lower_bound(slots.begin(), slots.end(), it->second);
+        if (slot_it != slots.end() && *slot_it == it->second)
+        {
+            slots.erase(slot_it);
+        }
+        if (slots.empty())
+        {
+            mPostings.erase(trigram);
+        }
+    }
+
+    // the slot stays empty, renamed items get a new one
+    entry.mID.setNull();
+    entry.mName.clear();
+    mSlots.erase(it);
+}
+
+// static
+void LLInventorySearchIndex::getTrigrams(const std::string& str, std::vector<U32>& trigrams)
+{
+    trigrams.clear();
+    for (size_t i = 0; i + 3 <= str.size(); ++i)
+    {
+        trigrams.push_back(((U32)(U8)str[i] << 16) | ((U32)(U8)str[i + 1] << 8) | (U32)(U8)str[i + 2]);
+    }
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+}
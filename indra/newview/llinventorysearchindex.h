@@ -0,0 +1,87 @@
+/**
+ * @file llinventorysearchindex.h
+ * @brief Trigram index over inventory item names
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLINVENTORYSEARCHINDEX_H
+#define LL_LLINVENTORYSEARCHINDEX_H
+
+#include "llinventoryobserver.h"
+#include "llsingleton.h"
+#include "lluuid.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Maps every three byte sequence of the upper cased item names in the inventory to the
+// items containing it, so a search string can be narrowed to the few items that may
+// contain it before the folder views walk their items.  Built the first time it is
+// queried and kept up to date from inventory change notifications.
+class LLInventorySearchIndex : public LLSingleton<LLInventorySearchIndex>, public LLInventoryObserver
+{
+    LLSINGLETON(LLInventorySearchIndex);
+    ~LLInventorySearchIndex();
+
+public:
+    struct Query
+    {
+        std::string mSubString;
+        U32 mGeneration = 0;
+        std::vector<U32> mSlots;    // sorted
+        bool mValid = false;
+    };
+
+    // Fill query with the items whose name may contain the upper cased sub_string.
+    // Returns false, and leaves query invalid, if the index can't help with it.
+    bool query(const std::string& sub_string, Query& query);
+
+    // False only if the name of id was indexed before query was made and can't contain
+    // its string
+    bool mayMatch(const Query& query, const LLUUID& id) const;
+
+    /*virtual*/ void changed(U32 mask);
+
+private:
+    struct Entry
+    {
+        LLUUID mID;
+        std::string mName;          // upper cased, as indexed
+        U32 mGeneration;
+    };
+
+    void build();
+    void indexItem(const LLUUID& id);
+    void removeItem(const LLUUID& id);
+
+    static void getTrigrams(const std::string& str, std::vector<U32>& trigrams);
+
+    std::unordered_map<U32, std::vector<U32> > mPostings;   // trigram -> sorted slots
+    std::unordered_map<LLUUID, U32> mSlots;
+    std::vector<Entry> mEntries;
+    U32 mGeneration;
+    bool mBuilt;
+};
+
+#endif // LL_LLINVENTORYSEARCHINDEX_H
@@ -66,6 +66,7 @@
 #include "llviewercontrol.h"
 #include "lltrans.h"
 #include "llviewerdisplay.h"
+#include "workqueue.h"
 
 /*=======================================*/
 /*  Formal declarations, constants, etc. */
@@ -181,6 +182,22 @@ bool LLLocalBitmap::updateSelf(EUpdateType optional_firstupdate)
 {
     bool updated = false;
 
+    if (mDecodeJob)
+    {
+        // a background decode is in flight, nothing else to do until it finished
+        if (!mDecodeJob->mDone.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        std::shared_ptr<DecodeJob> job = std::move(mDecodeJob);
+        if (mLinkStatus == LS_ON)
+        {
+            updated = applyDecodedBitmap(job->mSuccess, job->mRawImage, job->mLastModified, optional_firstupdate);
+        }
+        return updated;
+    }
+
     if (mLinkStatus == LS_ON)
     {
         // verifying that the file exists
@@ -198,81 +215,111 @@ bool LLLocalBitmap::updateSelf(EUpdateType optional_firstupdate)
             if (mLastModified.asString() != new_last_modified.asString())
             {
                 /* loading the image file and decoding it, here is a critical point which,
-                   if fails, invalidates the whole update (or unit creation) process. */
-                LLPointer<LLImageRaw> raw_image = new LLImageRaw();
-                if (decodeBitmap(raw_image))
+                   if fails, invalidates the whole update (or unit creation) process.
+                   unit creation needs to know right away, updates of a large file would
+                   stall the main thread, so those decode in the background. */
+                auto queue = LL::WorkQueue::getInstance("General");
+                if (optional_firstupdate != UT_FIRSTUSE && queue)
                 {
-                    // decode is successful, we can safely proceed.
-                    LLUUID old_id = LLUUID::null;
-                    if ((optional_firstupdate != UT_FIRSTUSE) && !mWorldID.isNull())
+                    auto job = std::make_shared<DecodeJob>();
+                    job->mRawImage = new LLImageRaw();
+                    job->mLastModified = new_last_modified;
+                    if (queue->post([job, filename = mFilename, extension = mExtension]()
+                                    {
+                                        job->mSuccess = decodeBitmap(job->mRawImage, filename, extension);
+                                        job->mDone.store(true, std::memory_order_release);
+                                    }))
                     {
-                        old_id = mWorldID;
+                        mDecodeJob = job;
+                        return false;
                     }
-                    mWorldID.generate();
-                    mLastModified = new_last_modified;
+                }
 
-                    LLPointer<LLViewerFetchedTexture> texture = new LLViewerFetchedTexture
-                        ("file://"+mFilename, FTT_LOCAL_FILE, mWorldID, LL_LOCAL_USE_MIPMAPS);
+                LLPointer<LLImageRaw> raw_image = new LLImageRaw();
+                updated = applyDecodedBitmap(decodeBitmap(raw_image, mFilename, mExtension), raw_image,
+                                             new_last_modified, optional_firstupdate);
+            }
 
-                    texture->createGLTexture(LL_LOCAL_DISCARD_LEVEL, raw_image);
-                    texture->ref();
+        } // end if file exists
 
-                    gTextureList.addImage(texture, TEX_LIST_STANDARD);
+        else
+        {
+            LL_WARNS() << "During the update process, the following file was not found." << "\n"
+                    << "Filename: " << mFilename << "\n"
+                    << "Disabling further update attempts for this file." << LL_ENDL;
 
-                    if (optional_firstupdate != UT_FIRSTUSE)
-                    {
-                        // seek out everything old_id uses and replace it with mWorldID
-                        replaceIDs(old_id, mWorldID);
+            LLSD notif_args;
+            notif_args["FNAME"] = mFilename;
+            LLNotificationsUtil::add("LocalBitmapsUpdateFileNotFound", notif_args);
 
-                        // remove old_id from gimagelist
-                        LLViewerFetchedTexture* image = gTextureList.findImage(old_id, TEX_LIST_STANDARD);
-                        if (image != NULL)
-                        {
-                            gTextureList.deleteImage(image);
-                            image->unref();
-                        }
-                    }
+            mLinkStatus = LS_BROKEN;
+        }
+    }
 
-                    mUpdateRetries = LL_LOCAL_UPDATE_RETRIES;
-                    updated = true;
-                }
+    return updated;
+}
 
-                // if decoding failed, we get here and it will attempt to decode it in the next cycles
-                // until mUpdateRetries runs out. this is done because some software lock the bitmap while writing to it
-                else
-                {
-                    if (mUpdateRetries)
-                    {
-                        mUpdateRetries--;
-                    }
-                    else
-                    {
-                        LL_WARNS() << "During the update process the following file was found" << "\n"
-                                << "but could not be opened or decoded for " << LL_LOCAL_UPDATE_RETRIES << " attempts." << "\n"
-                                << "Filename: " << mFilename << "\n"
-                                << "Disabling further update attempts for this file." << LL_ENDL;
+bool LLLocalBitmap::applyDecodedBitmap(bool decode_successful, LLPointer<LLImageRaw> raw_image,
+                                       const LLSD& new_last_modified, EUpdateType optional_firstupdate)
+{
+    bool updated = false;
 
-                        LLSD notif_args;
-                        notif_args["FNAME"] = mFilename;
-                        notif_args["NRETRIES"] = LL_LOCAL_UPDATE_RETRIES;
-                        LLNotificationsUtil::add("LocalBitmapsUpdateFailedFinal", notif_args);
+    if (decode_successful)
+    {
+        // decode is successful, we can safely proceed.
+        LLUUID old_id = LLUUID::null;
+        if ((optional_firstupdate != UT_FIRSTUSE) && !mWorldID.isNull())
+        {
+            old_id = mWorldID;
+        }
+        mWorldID.generate();
+        mLastModified = new_last_modified;
 
-                        mLinkStatus = LS_BROKEN;
-                    }
-                }
+        LLPointer<LLViewerFetchedTexture> texture = new LLViewerFetchedTexture
+            ("file://"+mFilename, FTT_LOCAL_FILE, mWorldID, LL_LOCAL_USE_MIPMAPS);
+
+        texture->createGLTexture(LL_LOCAL_DISCARD_LEVEL, raw_image);
+        texture->ref();
+
+        gTextureList.addImage(texture, TEX_LIST_STANDARD);
+
+        if (optional_firstupdate != UT_FIRSTUSE)
+        {
+            // seek out everything old_id uses and replace it with mWorldID
+            replaceIDs(old_id, mWorldID);
+
+            // remove old_id from gimagelist
+            LLViewerFetchedTexture* image = gTextureList.findImage(old_id, TEX_LIST_STANDARD);
+            if (image != NULL)
+            {
+                gTextureList.deleteImage(image);
+                image->unref();
             }
+        }
 
-        } // end if file exists
+        mUpdateRetries = LL_LOCAL_UPDATE_RETRIES;
+        updated = true;
+    }
 
+    // if decoding failed, we get here and it will attempt to decode it in the next cycles
+    // until mUpdateRetries runs out. this is done because some software lock the bitmap while writing to it
+    else
+    {
+        if (mUpdateRetries)
+        {
+            mUpdateRetries--;
+        }
         else
         {
-            LL_WARNS() << "During the update process, the following file was not found." << "\n"
+            LL_WARNS() << "During the update process the following file was found" << "\n"
+                    << "but could not be opened or decoded for " << LL_LOCAL_UPDATE_RETRIES << " attempts." << "\n"
                     << "Filename: " << mFilename << "\n"
                     << "Disabling further update attempts for this file." << LL_ENDL;
 
             LLSD notif_args;
             notif_args["FNAME"] = mFilename;
-            LLNotificationsUtil::add("LocalBitmapsUpdateFileNotFound", notif_args);
+            notif_args["NRETRIES"] = LL_LOCAL_UPDATE_RETRIES;
+            LLNotificationsUtil::add("LocalBitmapsUpdateFailedFinal", notif_args);
 
             mLinkStatus = LS_BROKEN;
         }
@@ -316,16 +363,17 @@ void LLLocalBitmap::addGLTFMaterial(LLGLTFMaterial* mat)
     mGLTFMaterialWithLocalTextures.push_back(mat);
 }
 
-bool LLLocalBitmap::decodeBitmap(LLPointer<LLImageRaw> rawimg)
+// static, runs on the General work queue for regular updates
+bool LLLocalBitmap::decodeBitmap(LLPointer<LLImageRaw> rawimg, const std::string& filename, EExtension extension)
 {
     bool decode_successful = false;
 
-    switch (mExtension)
+    switch (extension)
     {
         case ET_IMG_BMP:
         {
             LLPointer<LLImageBMP> bmp_image = new LLImageBMP;
-            if (bmp_image->load(mFilename) && bmp_image->decode(rawimg, 0.0f))
+            if (bmp_image->load(filename) && bmp_image->decode(rawimg, 0.0f))
             {
                 rawimg->biasedScaleToPowerOfTwo(LLViewerFetchedTexture::MAX_IMAGE_SIZE_DEFAULT);
                 decode_successful = true;
@@ -336,7 +384,7 @@ bool LLLocalBitmap::decodeBitmap(LLPointer<LLImageRaw> rawimg)
         case ET_IMG_TGA:
         {
             LLPointer<LLImageTGA> tga_image = new LLImageTGA;
-            if ((tga_image->load(mFilename) && tga_image->decode(rawimg))
+            if ((tga_image->load(filename) && tga_image->decode(rawimg))
             && ((tga_image->getComponents() == 3) || (tga_image->getComponents() == 4)))
             {
                 rawimg->biasedScaleToPowerOfTwo(LLViewerFetchedTexture::MAX_IMAGE_SIZE_DEFAULT);
@@ -348,7 +396,7 @@ bool LLLocalBitmap::decodeBitmap(LLPointer<LLImageRaw> rawimg)
         case ET_IMG_JPG:
         {
             LLPointer<LLImageJPEG> jpeg_image = new LLImageJPEG;
-            if (jpeg_image->load(mFilename) && jpeg_image->decode(rawimg, 0.0f))
+            if (jpeg_image->load(filename) && jpeg_image->decode(rawimg, 0.0f))
             {
                 rawimg->biasedScaleToPowerOfTwo(LLViewerFetchedTexture::MAX_IMAGE_SIZE_DEFAULT);
                 decode_successful = true;
@@ -359,7 +407,7 @@ bool LLLocalBitmap::decodeBitmap(LLPointer<LLImageRaw> rawimg)
         case ET_IMG_PNG:
         {
             LLPointer<LLImagePNG> png_image = new LLImagePNG;
-            if (png_image->load(mFilename) && png_image->decode(rawimg, 0.0f))
+            if (png_image->load(filename) && png_image->decode(rawimg, 0.0f))
             {
                 rawimg->biasedScaleToPowerOfTwo(LLViewerFetchedTexture::MAX_IMAGE_SIZE_DEFAULT);
                 decode_successful = true;
@@ -370,13 +418,12 @@ bool LLLocalBitmap::decodeBitmap(LLPointer<LLImageRaw> rawimg)
         default:
         {
             // separating this into -several- LL_WARNS() calls because in the extremely unlikely case that this happens
-            // accessing mFilename and any other object properties might very well crash the viewer.
+            // accessing the filename might very well crash the viewer.
             // getting here should be impossible, or there's been a pretty serious bug.
+            // the failed decode runs out the update retries and disables further updates.
 
             LL_WARNS() << "During a decode attempt, the following local bitmap had no properly assigned extension." << LL_ENDL;
-            LL_WARNS() << "Filename: " << mFilename << LL_ENDL;
-            LL_WARNS() << "Disabling further update attempts for this file." << LL_ENDL;
-            mLinkStatus = LS_BROKEN;
+            LL_WARNS() << "Filename: " << filename << LL_ENDL;
         }
     }
 
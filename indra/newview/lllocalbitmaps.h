@@ -33,6 +33,9 @@
 #include "llpointer.h"
 #include "llwearabletype.h"
 
+#include <atomic>
+#include <memory>
+
 class LLScrollListCtrl;
 class LLImageRaw;
 class LLViewerObject;
@@ -68,7 +71,8 @@ class LLLocalBitmap
         void addGLTFMaterial(LLGLTFMaterial* mat);
 
     private: /* self update private section */
-        bool decodeBitmap(LLPointer<LLImageRaw> raw);
+        bool applyDecodedBitmap(bool decode_successful, LLPointer<LLImageRaw> raw_image,
+                                const LLSD& new_last_modified, EUpdateType optional_firstupdate);
         void replaceIDs(const LLUUID &old_id, LLUUID new_id);
         std::vector<LLViewerObject*> prepUpdateObjects(LLUUID old_id, U32 channel);
         void updateUserPrims(LLUUID old_id, LLUUID new_id, U32 channel);
@@ -92,6 +96,18 @@ class LLLocalBitmap
             ET_IMG_PNG
         };
 
+        static bool decodeBitmap(LLPointer<LLImageRaw> raw, const std::string& filename, EExtension extension);
+
+        // a regular update decodes on the General work queue, the result is picked up
+        // by a later updateSelf() on the main thread
+        struct DecodeJob
+        {
+            LLPointer<LLImageRaw> mRawImage;
+            LLSD mLastModified;
+            bool mSuccess = false;
+            std::atomic<bool> mDone{ false };
+        };
+
     private: /* members */
         std::string mFilename;
         std::string mShortName;
@@ -102,6 +118,7 @@ class LLLocalBitmap
         EExtension  mExtension;
         ELinkStatus mLinkStatus;
         S32         mUpdateRetries;
+        std::shared_ptr<DecodeJob> mDecodeJob;
         LLLocalTextureChangedSignal mChangedSignal;
 
         // Store a list of accosiated materials
@@ -31,6 +31,7 @@
 #include "llavatarnamecache.h"
 #include "lllogchat.h"
 #include "llregex.h"
+#include "hbxxh.h"
 #include "lltrans.h"
 #include "llviewercontrol.h"
 
@@ -145,6 +146,43 @@ const char* remove_utf8_bom(const char* buf)
     return start;
 }
 
+// Transcript index, see LLLogChat::indexTranscript()
+const U32 TRANSCRIPT_INDEX_MAGIC = 0x58444954;  // "TIDX"
+const U32 TRANSCRIPT_INDEX_VERSION = 1;
+// Bytes before the indexed end that are hashed, to notice a transcript that was
+// replaced rather than appended to
+const U64 TRANSCRIPT_INDEX_CHECK_SIZE = 256;
+const size_t TRANSCRIPT_INDEX_READ_SIZE = 1024 * 1024;
+
+struct TranscriptIndexHeader
+{
+    U32 mMagic;
+    U32 mVersion;
+    U64 mIndexedSize;
+    U64 mCheckHash;
+    U64 mCount;
+};
+
+// Kept in the cache rather than next to the transcripts, which users browse and move around
+std::string transcript_index_file_name(const std::string& log_file_name)
+{
+    return gDirUtilp->getExpandedFilename(LL_PATH_CACHE,
+        llformat("transcript_%016llx.idx", (unsigned long long)HBXXH64::digest(log_file_name)));
+}
+
+U64 transcript_check_hash(llifstream& log_file, U64 end)
+{
+    U64 begin = end > TRANSCRIPT_INDEX_CHECK_SIZE ? end - TRANSCRIPT_INDEX_CHECK_SIZE : 0;
+    std::string check((size_t)(end - begin), '\0');
+    log_file.clear();
+    log_file.seekg((std::streamoff)begin);
+    if (!check.empty() && !log_file.read(&check[0], check.size()))
+    {
+        return 0;
+    }
+    return HBXXH64::digest(check);
+}
+
 class LLLogChatTimeScanner: public LLSingleton<LLLogChatTimeScanner>
 {
     LLSINGLETON(LLLogChatTimeScanner);
@@ -591,6 +629,175 @@ void LLLogChat::loadChatHistory(const std::string& file_name, std::list<LLSD>& m
         << " file mod time " << (F64)stat_data.st_mtime << LL_ENDL;
 }
 
+// static
+bool LLLogChat::indexTranscript(const std::string& log_file_name, std::vector<U64>& offsets, U64& indexed_size)
+{
+    LL_PROFILE_ZONE_SCOPED;
+
+    offsets.clear();
+    indexed_size = 0;
+
+    llifstream log_file(log_file_name.c_str(), std::ios::in | std::ios::binary);
+    if (!log_file.is_open())
+    {
+        return false;
+    }
+    log_file.seekg(0, std::ios::end);
+    U64 file_size = (U64)log_file.tellg();
+
+    // Transcripts are only ever appended to, so continue from the saved index as long
+    // as what it covers is still there
+    std::string index_file_name = transcript_index_file_name(log_file_name);
+    {
+        llifstream index_file(index_file_name.c_str(), std::ios::in | std::ios::binary);
+        TranscriptIndexHeader header;
+        if (index_file.is_open()
+            && index_file.read((char*)&header, sizeof(header))
+            && header.mMagic == TRANSCRIPT_INDEX_MAGIC
+            && header.mVersion == TRANSCRIPT_INDEX_VERSION
+            && header.mIndexedSize <= file_size
+            && header.mCheckHash == transcript_check_hash(log_file, header.mIndexedSize))
+        {
+            offsets.resize((size_t)header.mCount);
+            if (offsets.empty() || index_file.read((char*)offsets.data(), offsets.size() * sizeof(U64)))
+            {
+                indexed_size = header.mIndexedSize;
+            }
+            else
+            {
+                offsets.clear();
+            }
+        }
+    }
+    if (indexed_size == file_size)
+    {
+        return true;
+    }
+
+    // Scan what was written since.  A line starting with a space or an empty line
+    // continues the previous message, like in loadChatHistory().  Only complete lines
+    // are indexed, a message still being written is picked up next time.
+    log_file.clear();
+    log_file.seekg((std::streamoff)indexed_size);
+    U64 old_indexed_size = indexed_size;
+    std::vector<char> buffer(TRANSCRIPT_INDEX_READ_SIZE);
+    U64 pos = indexed_size;
+    U64 line_start = pos;
+    char first = 0;
+    bool at_line_start = true;
+    while (log_file.read(buffer.data(), buffer.size()) || log_file.gcount() > 0)
+    {
+        const char* begin = buffer.data();
+        const char* end = begin + log_file.gcount();
+        const char* p = begin;
+        while (p < end)
+        {
+            if (at_line_start)
+            {
+                line_start = pos + (p - begin);
+                first = *p;
+                at_line_start = false;
+            }
+            const char* newline = (const char*)memchr(p, '\n', end - p);
+            if (!newline)
+            {
+                break;
+            }
+            if (first != ' ' && first != '\n')
+            {
+                offsets.push_back(line_start);
+            }
+            at_line_start = true;
+            p = newline + 1;
+            indexed_size = pos + (p - begin);
+        }
+        pos += end - begin;
+    }
+
+    if (indexed_size != old_indexed_size)
+    {
+        TranscriptIndexHeader header;
+        header.mMagic = TRANSCRIPT_INDEX_MAGIC;
+        header.mVersion = TRANSCRIPT_INDEX_VERSION;
+        header.mIndexedSize = indexed_size;
+        header.mCheckHash = transcript_check_hash(log_file, indexed_size);
+        header.mCount = offsets.size();
+
+        llofstream index_file(index_file_name.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+        if (index_file.is_open())
+        {
+            index_file.write((const char*)&header, sizeof(header));
+            index_file.write((const char*)offsets.data(), offsets.size() * sizeof(U64));
+        }
+    }
+
+    LL_DEBUGS("ChatHistory") << "Indexed " << offsets.size() << " messages in " << log_file_name
+        << ", scanned " << (indexed_size - old_indexed_size) << " new bytes" << LL_ENDL;
+    return true;
+}
+
+// static
+void LLLogChat::loadTranscriptMessages(const std::string& log_file_name, U64 begin, U64 end,
+                                       std::list<LLSD>& messages, const LLSD& load_params)
+{
+    if (end <= begin)
+    {
+        return;
+    }
+
+    llifstream log_file(log_file_name.c_str(), std::ios::in | std::ios::binary);
+    if (!log_file.is_open())
+    {
+        LL_WARNS("ChatHistory") << "Unable to read file " << log_file_name << LL_ENDL;
+        return;
+    }
+    std::string contents((size_t)(end - begin), '\0');
+    log_file.seekg((std::streamoff)begin);
+    if (!log_file.read(&contents[0], contents.size()))
+    {
+        LL_WARNS("ChatHistory") << "Unable to read " << contents.size() << " bytes at " << begin
+            << " from " << log_file_name << LL_ENDL;
+        return;
+    }
+
+    size_t line_start = 0;
+    while (line_start < contents.size())
+    {
+        size_t line_end = contents.find('\n', line_start);
+        if (line_end == std::string::npos)
+        {
+            line_end = contents.size();
+        }
+        std::string line(remove_utf8_bom(contents.c_str() + line_start), contents.c_str() + line_end);
+        line_start = line_end + 1;
+
+        // same handling as loadChatHistory()
+        while (line.size() > 1 && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        if (line.empty())
+        {
+            // old format's multilined messages with new lines used to divide paragraphs
+            append_to_last_message(messages, NEW_LINE);
+        }
+        else if (' ' == line[0])
+        {
+            line.erase(0, MULTI_LINE_PREFIX.length());
+            append_to_last_message(messages, '\n' + line);
+        }
+        else
+        {
+            LLSD item;
+            if (!LLChatLogParser::parse(line, item, load_params))
+            {
+                item[LL_IM_TEXT] = line;
+            }
+            messages.push_back(item);
+        }
+    }
+}
+
 bool LLLogChat::historyThreadsFinished(LLUUID session_id)
 {
     LLMutexLock lock(historyThreadsMutex());
@@ -1273,6 +1480,7 @@ LLLoadHistoryThread::LLLoadHistoryThread(const std::string& file_name, std::list
     mFileName(file_name),
     mLoadParams(load_params),
     mNewLoad(true),
+    mIndexedSize(0),
     mLoadEndSignal(NULL)
 {
 }
@@ -1301,7 +1509,8 @@ void LLLoadHistoryThread::loadHistory(const std::string& file_name, std::list<LL
     }
 
     bool load_all_history = load_params.has("load_all_history") ? load_params["load_all_history"].asBoolean() : false;
-    LLFILE* fptr = LLFile::fopen(LLLogChat::makeLogFileName(file_name), "r");/*Flawfinder: ignore*/
+    mLogFileName = LLLogChat::makeLogFileName(file_name);
+    LLFILE* fptr = LLFile::fopen(mLogFileName, "r");/*Flawfinder: ignore*/
 
     if (!fptr)
     {
@@ -1326,7 +1535,8 @@ void LLLoadHistoryThread::loadHistory(const std::string& file_name, std::list<LL
         }
         if (!fptr)
         {
-            fptr = LLFile::fopen(LLLogChat::oldLogFileName(file_name), "r");/*Flawfinder: ignore*/
+            mLogFileName = LLLogChat::oldLogFileName(file_name);
+            fptr = LLFile::fopen(mLogFileName, "r");/*Flawfinder: ignore*/
             if (!fptr)
             {
                 mNewLoad = false;
@@ -1336,6 +1546,22 @@ void LLLoadHistoryThread::loadHistory(const std::string& file_name, std::list<LL
         }
     }
 
+    // Paged readers only need the offset of every message and the last page, which
+    // doesn't take longer as the transcript grows
+    S32 page_size = load_params.has("page_size") ? load_params["page_size"].asInteger() : 0;
+    if (load_all_history && page_size > 0)
+    {
+        fclose(fptr);
+        if (LLLogChat::indexTranscript(mLogFileName, mMessageOffsets, mIndexedSize) && !mMessageOffsets.empty())
+        {
+            size_t last_page = (mMessageOffsets.size() - 1) / page_size * page_size;
+            LLLogChat::loadTranscriptMessages(mLogFileName, mMessageOffsets[last_page], mIndexedSize, *messages, load_params);
+        }
+        mNewLoad = false;
+        (*mLoadEndSignal)(messages, file_name);
+        return;
+    }
+
     char buffer[LOG_RECALL_SIZE];       /*Flawfinder: ignore*/
 
     char *bptr;
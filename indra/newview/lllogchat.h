@@ -53,6 +53,10 @@ private:
     std::list<LLSD>* mMessages;
     LLSD mLoadParams;
     bool mNewLoad;
+    // Filled instead of loading everything when load_params has "page_size", see loadHistory()
+    std::string mLogFileName;
+    std::vector<U64> mMessageOffsets;
+    U64 mIndexedSize;
 public:
     LLLoadHistoryThread(const std::string& file_name, std::list<LLSD>* messages, const LLSD& load_params);
     ~LLLoadHistoryThread();
@@ -64,6 +68,10 @@ public:
     load_end_signal_t * mLoadEndSignal;
     boost::signals2::connection setLoadEndSignal(const load_end_signal_t::slot_type& cb);
     void removeLoadEndSignal(const load_end_signal_t::slot_type& cb);
+
+    const std::string& getLogFileName() const { return mLogFileName; }
+    const std::vector<U64>& getMessageOffsets() const { return mMessageOffsets; }
+    U64 getIndexedSize() const { return mIndexedSize; }
 };
 
 class LLDeleteHistoryThread : public LLActionThread
@@ -110,6 +118,13 @@ public:
 
     static void loadChatHistory(const std::string& file_name, std::list<LLSD>& messages, const LLSD& load_params = LLSD(), bool is_group = false);
 
+    // Byte offset of every message in a transcript, kept in the cache and only extended
+    // by what was appended since.  indexed_size is where the last complete line ends.
+    static bool indexTranscript(const std::string& log_file_name, std::vector<U64>& offsets, U64& indexed_size);
+    // Parse the messages between two offsets from indexTranscript()
+    static void loadTranscriptMessages(const std::string& log_file_name, U64 begin, U64 end,
+                                       std::list<LLSD>& messages, const LLSD& load_params = LLSD());
+
     typedef boost::signals2::signal<void ()> save_history_signal_t;
     boost::signals2::connection setSaveHistorySignal(const save_history_signal_t::slot_type& cb);
 
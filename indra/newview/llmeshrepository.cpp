@@ -49,6 +49,7 @@
 #include "llsdutil_math.h"
 #include "llsdserialize.h"
 #include "llthread.h"
+#include "threadpool.h"
 #include "llfilesystem.h"
 #include "llviewercontrol.h"
 #include "llviewerinventory.h"
@@ -73,6 +74,7 @@
 #include "llfasttimer.h"
 #include "llcorehttputil.h"
 #include "lltrans.h"
+#include "llregionprefetch.h"
 #include "llstatusbar.h"
 #include "llinventorypanel.h"
 #include "lluploaddialog.h"
@@ -117,6 +119,7 @@
 //   main     Main rendering thread, very sensitive to locking and other stalls
 //   repo     Overseeing worker thread associated with the LLMeshRepoThread class
 //   decom    Worker thread for mesh decomposition requests
+//   decodeN  "MeshDecode" thread pool:  inflates and unpacks LOD and skin data
 //   core     HTTP worker thread:  does the work but doesn't intrude here
 //   uploadN  0-N temporary mesh upload threads (0-1 in practice)
 //
@@ -133,14 +136,18 @@
 //
 //         loadMesh() invoked to request LOD
 //           append LODRequest to mPendingRequests
+//           prefetchMeshHeader() invoked
+//             append HeaderRequest to mHeaderReqQ
 //         ...
 //         other mesh requests may be made
 //         ...
 //         notifyLoadedMeshes() invoked to stage work
-//           append HeaderRequest to mHeaderReqQ
+//           header known: push LODRequest to mLODReqQ
+//           else: append LOD to mPendingLOD
 //         ...
 //                             scan mHeaderReqQ
-//                             issue 4096-byte GET for header
+//                             read header from cache or header index,
+//                             else issue 4096-byte GET for header
 //                             ...
 //                             onCompleted() invoked for GET
 //                               data copied
@@ -156,9 +163,14 @@
 //                             ...
 //                             onCompleted() invoked for GET
 //                               data copied
-//                               lodReceived() invoked
-//                                 unpack data into LLVolume
-//                                 append LoadedMesh to mLoadedQ
+//                               data written to cache
+//                               queueLODDecode() invoked
+//                             ...
+//                                                     decode pool
+//                                                     lodReceived() invoked
+//                                                       unpack data into LLVolume
+//                                                       optimized faces written to cache
+//                                                       append LoadedMesh to mLoadedQ
 //                             ...
 //         notifyLoadedMeshes() invoked again
 //           scan mLoadedQ
@@ -254,16 +266,18 @@
 //     sActiveLODRequests       mMutex        rw.any.mMutex, ro.repo.none [1]
 //     sMaxConcurrentRequests   mMutex        wo.main.none, ro.repo.none, ro.main.mMutex
 //     mMeshHeader              mHeaderMutex  rw.repo.mHeaderMutex, ro.main.mHeaderMutex, ro.main.none [0]
+//     mMeshCostData            mHeaderMutex  rw.repo.mHeaderMutex, ro.main.mHeaderMutex
 //     mSkinRequests            mMutex        rw.repo.mMutex, ro.repo.none [5]
-//     mSkinInfoQ               mMutex        rw.repo.mMutex, rw.main.mMutex [5] (was:  [0])
+//     mSkinInfoQ               mMutex        rw.repo.mMutex, rw.main.mMutex [5] (was:  [0]), wo.decodeN.mMutex
 //     mDecompositionRequests   mMutex        rw.repo.mMutex, ro.repo.none [5]
 //     mPhysicsShapeRequests    mMutex        rw.repo.mMutex, ro.repo.none [5]
 //     mDecompositionQ          mMutex        rw.repo.mMutex, rw.main.mMutex [5] (was:  [0])
 //     mHeaderReqQ              mMutex        ro.repo.none [5], rw.repo.mMutex, rw.any.mMutex
 //     mLODReqQ                 mMutex        ro.repo.none [5], rw.repo.mMutex, rw.any.mMutex
-//     mUnavailableQ            mMutex        rw.repo.none [0], ro.main.none [5], rw.main.mMutex
-//     mLoadedQ                 mMutex        rw.repo.mMutex, ro.main.none [5], rw.main.mMutex
+//     mUnavailableQ            mMutex        rw.repo.none [0], ro.main.none [5], rw.main.mMutex, wo.decodeN.mMutex
+//     mLoadedQ                 mMutex        rw.repo.mMutex, ro.main.none [5], rw.main.mMutex, wo.decodeN.mMutex
 //     mPendingLOD              mMutex        rw.repo.mMutex, rw.any.mMutex
+//     mHeaderIndex             none          rw.repo.none
 //     mGetMeshCapability       mMutex        rw.main.mMutex, ro.repo.mMutex (was:  [0])
 //     mGetMesh2Capability      mMutex        rw.main.mMutex, ro.repo.mMutex (was:  [0])
 //     mGetMeshVersion          mMutex        rw.main.mMutex, ro.repo.mMutex
@@ -568,6 +582,9 @@ U32 LLMeshRepoThread::sMaxConcurrentRequests = 1;
 S32 LLMeshRepoThread::sRequestLowWater = REQUEST2_LOW_WATER_MIN;
 S32 LLMeshRepoThread::sRequestHighWater = REQUEST2_HIGH_WATER_MIN;
 S32 LLMeshRepoThread::sRequestWaterLevel = 0;
+bool LLMeshRepoThread::sUseOptimizedCache = true;
+bool LLMeshRepoThread::sPrefetchHeaders = true;
+U32 LLMeshRepoThread::sHeaderIndexSize = 0;
 
 // Base handler class for all mesh users of llcorehttp.
 // This is roughly equivalent to a Responder class in
@@ -876,6 +893,10 @@ LLMeshRepoThread::LLMeshRepoThread()
     mHttpPolicyClass = app_core_http.getPolicy(LLAppCoreHttp::AP_MESH2);
     mHttpLegacyPolicyClass = app_core_http.getPolicy(LLAppCoreHttp::AP_MESH1); // <FS:Ansariel> [UDP Assets]
     mHttpLargePolicyClass = app_core_http.getPolicy(LLAppCoreHttp::AP_LARGE_MESH);
+
+    // Width can be overridden through the "ThreadPoolSizes" setting
+    mDecodePool.reset(new LL::ThreadPool("MeshDecode", llclamp(std::thread::hardware_concurrency() / 4, 1U, 4U)));
+    mDecodePool->start();
 }
 
 
@@ -889,6 +910,9 @@ LLMeshRepoThread::~LLMeshRepoThread()
     mHttpRequestSet.clear();
     mHttpHeaders.reset();
 
+    // decode tasks push into our queues, stop them first
+    mDecodePool.reset();
+
     while (!mSkinInfoQ.empty())
     {
         delete mSkinInfoQ.front();
@@ -919,6 +943,8 @@ void LLMeshRepoThread::run()
         LL_WARNS(LOG_MESH) << "Convex decomposition unable to be loaded.  Expect severe problems." << LL_ENDL;
     }
 
+    loadHeaderIndex();
+
     while (!LLApp::isExiting())
     {
         // *TODO:  Revise sleep/wake strategy and try to move away
@@ -973,7 +999,7 @@ void LLMeshRepoThread::run()
                     // failed to load before, wait a bit
                     incomplete.push_front(req);
                 }
-                else if (!fetchMeshLOD(req.mMeshParams, req.mLOD, req.canRetry()))
+                else if (!fetchMeshLOD(req.mMeshParams, req.mLOD, req.canRetry(), !req.mSkipCache))
                 {
                     if (req.canRetry())
                     {
@@ -1073,7 +1099,7 @@ void LLMeshRepoThread::run()
                     {
                         incomplete.emplace_back(req);
                     }
-                    else if (!fetchMeshSkinInfo(req.mId, req.canRetry()))
+                    else if (!fetchMeshSkinInfo(req.mId, req.canRetry(), !req.mSkipCache))
                     {
                         if (req.canRetry())
                         {
@@ -1180,6 +1206,8 @@ void LLMeshRepoThread::run()
         // llassert_always(mHttpRequestSet.size() <= sRequestHighWater);
     }
 
+    saveHeaderIndex();
+
     if (mSignal->isLocked())
     { //make sure to let go of the mutex associated with the given signal before shutting down
         mSignal->unlock();
@@ -1252,6 +1280,21 @@ void LLMeshRepoThread::loadMeshLOD(const LLVolumeParams& mesh_params, S32 lod)
     }
 }
 
+void LLMeshRepoThread::prefetchMeshHeader(const LLVolumeParams& mesh_params)
+{ //could be called from any thread
+    const LLUUID& mesh_id = mesh_params.getSculptID();
+    LLMutexLock lock(mMutex);
+    LLMutexLock header_lock(mHeaderMutex);
+    if (mMeshHeader.find(mesh_id) == mMeshHeader.end()
+        && mPendingLOD.find(mesh_id) == mPendingLOD.end())
+    {
+        // An empty pending entry makes loadMeshLOD() wait for this request
+        // instead of issuing its own
+        mHeaderReqQ.push(HeaderRequest(mesh_params));
+        mPendingLOD[mesh_id];
+    }
+}
+
 // Mutex:  must be holding mMutex when called
 // <FS:Ansariel> [UDP Assets]
 //void LLMeshRepoThread::setGetMeshCap(const std::string & mesh_cap)
@@ -1390,7 +1433,7 @@ LLCore::HttpHandle LLMeshRepoThread::getByteRange(const std::string & url, int l
 }
 
 
-bool LLMeshRepoThread::fetchMeshSkinInfo(const LLUUID& mesh_id, bool can_retry)
+bool LLMeshRepoThread::fetchMeshSkinInfo(const LLUUID& mesh_id, bool can_retry, bool use_cache)
 {
 
     if (!mHeaderMutex)
@@ -1425,7 +1468,7 @@ bool LLMeshRepoThread::fetchMeshSkinInfo(const LLUUID& mesh_id, bool can_retry)
         {
             //check cache for mesh skin info
             LLFileSystem file(mesh_id, LLAssetType::AT_MESH);
-            if (file.getSize() >= offset + size)
+            if (use_cache && file.getSize() >= offset + size)
             {
                 U8* buffer = new(std::nothrow) U8[size];
                 if (!buffer)
@@ -1456,12 +1499,10 @@ bool LLMeshRepoThread::fetchMeshSkinInfo(const LLUUID& mesh_id, bool can_retry)
                 }
 
                 if (!zero)
-                { //attempt to parse
-                    if (skinInfoReceived(mesh_id, buffer, size))
-                    {
-                        delete[] buffer;
-                        return true;
-                    }
+                { //parse on the decode pool, falls back to the sim if it fails
+                    queueSkinInfoDecode(mesh_id, buffer, size, true);
+                    delete[] buffer;
+                    return true;
                 }
 
                 delete[] buffer;
@@ -1805,11 +1846,32 @@ bool LLMeshRepoThread::fetchMeshHeader(const LLVolumeParams& mesh_params, bool c
                 LL_DEBUGS(LOG_MESH) << "Mesh/Cache: Mesh header for ID " << mesh_params.getSculptID() << " - was retrieved from the cache." << LL_ENDL;
 
                 // Found mesh in cache
+                indexMeshHeader(mesh_params.getSculptID(), buffer, bytes);
                 return true;
             }
         }
     }
 
+    //asset was purged from the cache, but we may still know its header
+    header_index_map::iterator indexed = mHeaderIndex.find(mesh_params.getSculptID());
+    if (indexed != mHeaderIndex.end())
+    {
+        std::string header = indexed->second;
+        S32 bytes = (S32)header.size();
+        if (headerReceived(mesh_params, (U8*)header.data(), bytes) == MESH_OK)
+        {
+            LL_DEBUGS(LOG_MESH) << "Mesh/Cache: Mesh header for ID " << mesh_params.getSculptID() << " - was retrieved from the header index." << LL_ENDL;
+
+            // LODs fetched from the sim are only cached in an entry that was reserved for them
+            cacheMeshHeader(mesh_params.getSculptID(), (U8*)header.data(), bytes);
+            return true;
+        }
+
+        // bad entry, ask the simulator
+        mHeaderIndex.erase(indexed);
+        mHeaderIndexDirty = true;
+    }
+
     //either cache entry doesn't exist or is corrupt, request header from simulator
     bool retval = true;
     std::string http_url;
@@ -1852,7 +1914,7 @@ bool LLMeshRepoThread::fetchMeshHeader(const LLVolumeParams& mesh_params, bool c
 }
 
 //return false if failed to get mesh lod.
-bool LLMeshRepoThread::fetchMeshLOD(const LLVolumeParams& mesh_params, S32 lod, bool can_retry)
+bool LLMeshRepoThread::fetchMeshLOD(const LLVolumeParams& mesh_params, S32 lod, bool can_retry, bool use_cache)
 {
     if (!mHeaderMutex)
     {
@@ -1882,10 +1944,39 @@ bool LLMeshRepoThread::fetchMeshLOD(const LLVolumeParams& mesh_params, S32 lod,
 
         if (version <= MAX_MESH_VERSION && offset >= 0 && size > 0)
         {
+            //check the optimized tier first, it skips all of the unpack work
+            if (use_cache && sUseOptimizedCache)
+            {
+                LLFileSystem optimized(getOptimizedCacheID(mesh_id, lod), LLAssetType::AT_MESH);
+                S32 optimized_size = optimized.getSize();
+                if (optimized_size > 0)
+                {
+                    auto buffer = std::make_shared<std::vector<U8> >();
+                    try
+                    {
+                        buffer->resize(optimized_size);
+                    }
+                    catch (std::bad_alloc&)
+                    {
+                        buffer.reset();
+                    }
+
+                    if (buffer && optimized.read(buffer->data(), optimized_size))
+                    {
+                        LLMeshRepository::sCacheBytesRead += optimized_size;
+                        ++LLMeshRepository::sCacheReads;
+                        queueOptimizedLODDecode(mesh_params, lod, buffer);
+
+                        LL_DEBUGS(LOG_MESH) << "Mesh/Cache: Mesh body for ID " << mesh_id << " - was retrieved from the optimized cache." << LL_ENDL;
+
+                        return true;
+                    }
+                }
+            }
 
             //check cache for mesh asset
             LLFileSystem file(mesh_id, LLAssetType::AT_MESH);
-            if (file.getSize() >= offset+size)
+            if (use_cache && file.getSize() >= offset+size)
             {
                 U8* buffer = new(std::nothrow) U8[size];
                 if (!buffer)
@@ -1916,15 +2007,13 @@ bool LLMeshRepoThread::fetchMeshLOD(const LLVolumeParams& mesh_params, S32 lod,
                 }
 
                 if (!zero)
-                { //attempt to parse
-                    if (lodReceived(mesh_params, lod, buffer, size) == MESH_OK)
-                    {
-                        delete[] buffer;
+                { //parse on the decode pool, falls back to the sim if it fails
+                    queueLODDecode(mesh_params, lod, buffer, size, true);
+                    delete[] buffer;
 
-                        LL_DEBUGS(LOG_MESH) << "Mesh/Cache: Mesh body for ID " << mesh_id << " - was retrieved from the cache." << LL_ENDL;
+                    LL_DEBUGS(LOG_MESH) << "Mesh/Cache: Mesh body for ID " << mesh_id << " - was retrieved from the cache." << LL_ENDL;
 
-                        return true;
-                    }
+                    return true;
                 }
 
                 delete[] buffer;
@@ -2038,10 +2127,23 @@ EMeshProcessingResult LLMeshRepoThread::headerReceived(const LLVolumeParams& mes
     }
 
     {
+        LLMeshCostData cost_data;
+        bool has_cost_data = !header.m404
+                             && header.mLodSize[0] > 0
+                             && header.mVersion <= MAX_MESH_VERSION
+                             && cost_data.init(header);
 
         {
             LLMutexLock lock(mHeaderMutex);
             mMeshHeader[mesh_id] = { (U32)header_size, header };
+            if (has_cost_data)
+            {
+                mMeshCostData[mesh_id] = cost_data;
+            }
+            else
+            {
+                mMeshCostData.erase(mesh_id);
+            }
             LLMeshRepository::sCacheBytesHeaders += (U32)header_size;
         }
 
@@ -2064,6 +2166,342 @@ EMeshProcessingResult LLMeshRepoThread::headerReceived(const LLVolumeParams& mes
     return MESH_OK;
 }
 
+bool LLMeshRepoThread::cacheMeshHeader(const LLUUID& mesh_id, U8* data, S32 data_size)
+{
+    S32 header_bytes = 0;
+    LLMeshHeader header;
+
+    mHeaderMutex->lock();
+    mesh_header_map::iterator iter = mMeshHeader.find(mesh_id);
+    if (iter != mMeshHeader.end())
+    {
+        header_bytes = (S32)iter->second.first;
+        header = iter->second.second;
+    }
+
+    if (header_bytes <= 0
+        || header.m404
+        || (header.mVersion > MAX_MESH_VERSION))
+    {
+        mHeaderMutex->unlock();
+        return false;
+    }
+
+    S32 lod_bytes = 0;
+
+    for (U32 i = 0; i < LLModel::LOD_PHYSICS; ++i)
+    {
+        // figure out how many bytes we'll need to reserve in the file
+        lod_bytes = llmax(lod_bytes, header.mLodOffset[i]+header.mLodSize[i]);
+    }
+
+    // just in case skin info or decomposition is at the end of the file (which it shouldn't be)
+    lod_bytes = llmax(lod_bytes, header.mSkinOffset+header.mSkinSize);
+    lod_bytes = llmax(lod_bytes, header.mPhysicsConvexOffset + header.mPhysicsConvexSize);
+
+    // Do not unlock mutex untill we are done with LLSD.
+    // LLSD is smart and can work like smart pointer, is not thread safe.
+    mHeaderMutex->unlock();
+
+    S32 bytes = lod_bytes + header_bytes;
+
+
+    // It's possible for the remote asset to have more data than is needed for the local cache
+    // only allocate as much space in the cache as is needed for the local cache
+    data_size = llmin(data_size, bytes);
+
+    LLFileSystem file(mesh_id, LLAssetType::AT_MESH, LLFileSystem::READ_WRITE);
+    if (file.getMaxSize() >= bytes)
+    {
+        LLMeshRepository::sCacheBytesWritten += data_size;
+        ++LLMeshRepository::sCacheWrites;
+
+        file.write(data, data_size);
+
+        S32 remaining = bytes - file.tell();
+        if (remaining > 0)
+        {
+            U8* block = new(std::nothrow) U8[remaining];
+            if (block)
+            {
+                memset(block, 0, remaining);
+                file.write(block, remaining);
+                delete[] block;
+            }
+        }
+    }
+
+    return true;
+}
+
+// Header index file:  magic, version, count, then per mesh its id, the
+// header size and the raw header bytes.  Entries are oldest first.
+static const U32 MESH_HEADER_INDEX_MAGIC = 0x4948534d; // "MSHI"
+static const U32 MESH_HEADER_INDEX_VERSION = 1;
+
+static const LLUUID& get_header_index_id()
+{
+    static const LLUUID id = LLUUID::generateNewID("mesh header index");
+    return id;
+}
+
+// Threads:  Trepo
+void LLMeshRepoThread::loadHeaderIndex()
+{
+    if (sHeaderIndexSize == 0)
+    {
+        return;
+    }
+
+    LLFileSystem file(get_header_index_id(), LLAssetType::AT_MESH);
+    S32 size = file.getSize();
+    if (size <= 0)
+    {
+        return;
+    }
+
+    std::vector<U8> data(size);
+    if (!file.read(data.data(), size))
+    {
+        return;
+    }
+
+    U32 header[3];
+    if (size < (S32)sizeof(header))
+    {
+        return;
+    }
+    memcpy(header, data.data(), sizeof(header));
+    if (header[0] != MESH_HEADER_INDEX_MAGIC || header[1] != MESH_HEADER_INDEX_VERSION)
+    {
+        LL_INFOS(LOG_MESH) << "Discarding mesh header index of unknown format" << LL_ENDL;
+        return;
+    }
+
+    S32 offset = sizeof(header);
+    for (U32 i = 0; i < header[2]; ++i)
+    {
+        LLUUID mesh_id;
+        U32 bytes = 0;
+        if (offset + UUID_BYTES + (S32)sizeof(U32) > size)
+        {
+            break;
+        }
+        memcpy(mesh_id.mData, &data[offset], UUID_BYTES);
+        memcpy(&bytes, &data[offset + UUID_BYTES], sizeof(U32));
+        offset += UUID_BYTES + sizeof(U32);
+        if (bytes == 0 || bytes > (U32)MESH_HEADER_SIZE || offset + (S32)bytes > size)
+        {
+            break;
+        }
+
+        if (mHeaderIndex.emplace(mesh_id, std::string((const char*)&data[offset], bytes)).second)
+        {
+            mHeaderIndexOrder.push_back(mesh_id);
+        }
+        offset += bytes;
+    }
+
+    LL_INFOS(LOG_MESH) << "Loaded " << mHeaderIndex.size() << " entries from the mesh header index" << LL_ENDL;
+}
+
+// Threads:  Trepo
+void LLMeshRepoThread::saveHeaderIndex()
+{
+    if (!mHeaderIndexDirty || sHeaderIndexSize == 0)
+    {
+        return;
+    }
+
+    std::vector<U8> data;
+    U32 header[3] = { MESH_HEADER_INDEX_MAGIC, MESH_HEADER_INDEX_VERSION, 0 };
+    data.resize(sizeof(header));
+    for (const LLUUID& mesh_id : mHeaderIndexOrder)
+    {
+        header_index_map::const_iterator iter = mHeaderIndex.find(mesh_id);
+        if (iter == mHeaderIndex.end())
+        { // dropped as a bad entry
+            continue;
+        }
+        U32 bytes = (U32)iter->second.size();
+        data.insert(data.end(), mesh_id.mData, mesh_id.mData + UUID_BYTES);
+        data.insert(data.end(), (const U8*)&bytes, (const U8*)&bytes + sizeof(U32));
+        data.insert(data.end(), iter->second.begin(), iter->second.end());
+        ++header[2];
+    }
+    memcpy(data.data(), header, sizeof(header));
+
+    LLFileSystem file(get_header_index_id(), LLAssetType::AT_MESH, LLFileSystem::WRITE);
+    file.write(data.data(), (S32)data.size());
+    mHeaderIndexDirty = false;
+}
+
+// Threads:  Trepo
+void LLMeshRepoThread::indexMeshHeader(const LLUUID& mesh_id, const U8* data, S32 data_size)
+{
+    if (sHeaderIndexSize == 0 || mHeaderIndex.find(mesh_id) != mHeaderIndex.end())
+    {
+        return;
+    }
+
+    S32 header_bytes = 0;
+    {
+        LLMutexLock lock(mHeaderMutex);
+        mesh_header_map::iterator iter = mMeshHeader.find(mesh_id);
+        if (iter != mMeshHeader.end() && !iter->second.second.m404)
+        {
+            header_bytes = (S32)iter->second.first;
+        }
+    }
+
+    if (header_bytes <= 0 || header_bytes > data_size)
+    {
+        return;
+    }
+
+    mHeaderIndex.emplace(mesh_id, std::string((const char*)data, header_bytes));
+    mHeaderIndexOrder.push_back(mesh_id);
+    while (mHeaderIndexOrder.size() > sHeaderIndexSize)
+    {
+        mHeaderIndex.erase(mHeaderIndexOrder.front());
+        mHeaderIndexOrder.pop_front();
+    }
+    mHeaderIndexDirty = true;
+}
+
+void LLMeshRepoThread::queueLODDecode(const LLVolumeParams& mesh_params, S32 lod, U8* data, S32 data_size, bool from_cache)
+{
+    if (data == NULL || data_size <= 0)
+    {
+        LLMutexLock lock(mMutex);
+        mUnavailableQ.push_back(LODRequest(mesh_params, lod));
+        return;
+    }
+
+    // The caller's buffer doesn't outlive this call
+    auto buffer = std::make_shared<std::vector<U8> >(data, data + data_size);
+    bool posted = mDecodePool->getQueue().post(
+        [this, mesh_params, lod, buffer, from_cache]()
+        {
+            EMeshProcessingResult result = lodReceived(mesh_params, lod, buffer->data(), (S32)buffer->size());
+            if (result == MESH_OK)
+            {
+                return;
+            }
+
+            LLMutexLock lock(mMutex);
+            if (from_cache)
+            {
+                // Bad cache entry, the sim's copy will overwrite it
+                LL_WARNS(LOG_MESH) << "Error decoding cached mesh LOD.  ID:  " << mesh_params.getSculptID()
+                                   << " LOD: " << lod << ".  Fetching from sim." << LL_ENDL;
+                LODRequest req(mesh_params, lod);
+                req.mSkipCache = true;
+                mLODReqQ.push(req);
+                ++LLMeshRepository::sLODProcessing;
+            }
+            else
+            {
+                LL_WARNS(LOG_MESH) << "Error during mesh LOD processing.  ID:  " << mesh_params.getSculptID()
+                                   << ", Reason: " << result
+                                   << " LOD: " << lod
+                                   << " Data size: " << buffer->size()
+                                   << " Not retrying."
+                                   << LL_ENDL;
+                mUnavailableQ.push_back(LODRequest(mesh_params, lod));
+            }
+        });
+    if (!posted)
+    {
+        LL_DEBUGS(LOG_MESH) << "Mesh decode pool closed, dropping LOD " << lod
+                            << " of " << mesh_params.getSculptID() << LL_ENDL;
+    }
+}
+
+void LLMeshRepoThread::queueSkinInfoDecode(const LLUUID& mesh_id, U8* data, S32 data_size, bool from_cache)
+{
+    auto buffer = std::make_shared<std::vector<U8> >(data, data + llmax(data_size, 0));
+    bool posted = mDecodePool->getQueue().post(
+        [this, mesh_id, buffer, from_cache]()
+        {
+            if (skinInfoReceived(mesh_id, buffer->data(), (S32)buffer->size()))
+            {
+                return;
+            }
+
+            LLMutexLock lock(mMutex);
+            if (from_cache)
+            {
+                LL_WARNS(LOG_MESH) << "Error decoding cached mesh skin info.  ID:  " << mesh_id
+                                   << ".  Fetching from sim." << LL_ENDL;
+                UUIDBasedRequest req(mesh_id);
+                req.mSkipCache = true;
+                mSkinRequests.push_back(req);
+            }
+            else
+            {
+                LL_WARNS(LOG_MESH) << "Error during mesh skin info processing.  ID:  " << mesh_id
+                                   << ", Unknown reason.  Not retrying."
+                                   << LL_ENDL;
+                mSkinUnavailableQ.emplace_back(mesh_id);
+            }
+        });
+    if (!posted)
+    {
+        LL_DEBUGS(LOG_MESH) << "Mesh decode pool closed, dropping skin info of " << mesh_id << LL_ENDL;
+    }
+}
+
+void LLMeshRepoThread::queueOptimizedLODDecode(const LLVolumeParams& mesh_params, S32 lod, std::shared_ptr<std::vector<U8> > buffer)
+{
+    bool posted = mDecodePool->getQueue().post(
+        [this, mesh_params, lod, buffer]()
+        {
+            LLPointer<LLVolume> volume = new LLVolume(mesh_params, LLVolumeLODGroup::getVolumeScaleFromDetail(lod));
+            bool ok = volume->unpackOptimizedFaces(buffer->data(), (S32)buffer->size()) && volume->getNumFaces() > 0;
+
+            LLMutexLock lock(mMutex);
+            if (ok)
+            {
+                LoadedMesh mesh(volume, mesh_params, lod);
+                mLoadedQ.push_back(mesh);
+                // see lodReceived()
+                volume = NULL;
+                mesh.mVolume = NULL;
+            }
+            else
+            {
+                // Stale format or truncated write, rebuild it from the asset
+                LL_DEBUGS(LOG_MESH) << "Discarding optimized cache entry for mesh " << mesh_params.getSculptID()
+                                    << " LOD " << lod << LL_ENDL;
+                LLFileSystem::removeFile(getOptimizedCacheID(mesh_params.getSculptID(), lod), LLAssetType::AT_MESH, ENOENT);
+                mLODReqQ.push(LODRequest(mesh_params, lod));
+                ++LLMeshRepository::sLODProcessing;
+            }
+        });
+    if (!posted)
+    {
+        LL_DEBUGS(LOG_MESH) << "Mesh decode pool closed, dropping LOD " << lod
+                            << " of " << mesh_params.getSculptID() << LL_ENDL;
+    }
+}
+
+// static
+LLUUID LLMeshRepoThread::getOptimizedCacheID(const LLUUID& mesh_id, S32 lod)
+{
+    // One entry per LOD, next to the asset in the mesh cache
+    static const LLUUID lod_salt[LLModel::NUM_LODS] = {
+        LLUUID::generateNewID("optimized mesh lowest"),
+        LLUUID::generateNewID("optimized mesh low"),
+        LLUUID::generateNewID("optimized mesh medium"),
+        LLUUID::generateNewID("optimized mesh high")
+    };
+    LLUUID id;
+    mesh_id.combine(lod_salt[llclamp(lod, 0, LLModel::NUM_LODS - 1)], id);
+    return id;
+}
+
+// Threads:  decodeN
 EMeshProcessingResult LLMeshRepoThread::lodReceived(const LLVolumeParams& mesh_params, S32 lod, U8* data, S32 data_size)
 {
     if (data == NULL || data_size == 0)
@@ -2076,6 +2514,20 @@ EMeshProcessingResult LLMeshRepoThread::lodReceived(const LLVolumeParams& mesh_p
     {
         if (volume->getNumFaces() > 0)
         {
+            if (sUseOptimizedCache)
+            {
+                std::vector<U8> optimized;
+                if (volume->packOptimizedFaces(optimized))
+                {
+                    LLFileSystem file(getOptimizedCacheID(mesh_params.getSculptID(), lod), LLAssetType::AT_MESH, LLFileSystem::WRITE);
+                    if (file.write(optimized.data(), (S32)optimized.size()))
+                    {
+                        LLMeshRepository::sCacheBytesWritten += (U32)optimized.size();
+                        ++LLMeshRepository::sCacheWrites;
+                    }
+                }
+            }
+
             LoadedMesh mesh(volume, mesh_params, lod);
             {
                 LLMutexLock lock(mMutex);
@@ -2094,6 +2546,7 @@ EMeshProcessingResult LLMeshRepoThread::lodReceived(const LLVolumeParams& mesh_p
     return MESH_UNKNOWN;
 }
 
+// Threads:  decodeN
 bool LLMeshRepoThread::skinInfoReceived(const LLUUID& mesh_id, U8* data, S32 data_size)
 {
     LLSD skin;
@@ -3214,6 +3667,7 @@ void LLMeshHandlerBase::onCompleted(LLCore::HttpHandle handle, LLCore::HttpRespo
         LLCore::BufferArray * body(response->getBody());
         S32 body_offset(0);
         U8 * data(NULL);
+        bool data_copied(false);
         auto data_size(body ? body->size() : 0);
 
         if (data_size > 0)
@@ -3266,15 +3720,21 @@ void LLMeshHandlerBase::onCompleted(LLCore::HttpHandle handle, LLCore::HttpRespo
                 goto common_exit;
             }
 
-            // *TODO: Try to get rid of data copying and add interfaces
-            // that support BufferArray directly.  Introduce a two-phase
-            // handler, optional first that takes a body, fallback second
-            // that requires a temporary allocation and data copy.
+            // Bodies of known length arrive in a single block and are
+            // handed over in place, others are copied out.
             body_offset = mOffset - offset;
-            data = new(std::nothrow) U8[data_size - body_offset];
+            data = (U8 *) body->getContiguous(body_offset, data_size - body_offset);
+            if (! data)
+            {
+                data = new(std::nothrow) U8[data_size - body_offset];
+                data_copied = true;
+                if (data)
+                {
+                    body->read(body_offset, (char *) data, data_size - body_offset);
+                }
+            }
             if (data)
             {
-                body->read(body_offset, (char *) data, data_size - body_offset);
                 LLMeshRepository::sBytesReceived += static_cast<U32>(data_size);
             }
             else
@@ -3286,7 +3746,10 @@ void LLMeshHandlerBase::onCompleted(LLCore::HttpHandle handle, LLCore::HttpRespo
 
         processData(body, body_offset, data, static_cast<S32>(data_size) - body_offset);
 
-        delete [] data;
+        if (data_copied)
+        {
+            delete [] data;
+        }
     }
 
     // Release handler
@@ -3356,74 +3819,15 @@ void LLMeshHeaderHandler::processData(LLCore::BufferArray * /* body */, S32 /* b
     }
     else if (data && data_size > 0)
     {
-        // header was successfully retrieved from sim and parsed and is in cache
-        S32 header_bytes = 0;
-        LLMeshHeader header;
-
-        gMeshRepo.mThread->mHeaderMutex->lock();
-        LLMeshRepoThread::mesh_header_map::iterator iter = gMeshRepo.mThread->mMeshHeader.find(mesh_id);
-        if (iter != gMeshRepo.mThread->mMeshHeader.end())
+        // header was successfully retrieved from sim and parsed
+        if (gMeshRepo.mThread->cacheMeshHeader(mesh_id, data, data_size))
         {
-            header_bytes = (S32)iter->second.first;
-            header = iter->second.second;
-        }
-
-        if (header_bytes > 0
-            && !header.m404
-            && (header.mVersion <= MAX_MESH_VERSION))
-        {
-            std::stringstream str;
-
-            S32 lod_bytes = 0;
-
-            for (U32 i = 0; i < LLModel::LOD_PHYSICS; ++i)
-            {
-                // figure out how many bytes we'll need to reserve in the file
-                lod_bytes = llmax(lod_bytes, header.mLodOffset[i]+header.mLodSize[i]);
-            }
-
-            // just in case skin info or decomposition is at the end of the file (which it shouldn't be)
-            lod_bytes = llmax(lod_bytes, header.mSkinOffset+header.mSkinSize);
-            lod_bytes = llmax(lod_bytes, header.mPhysicsConvexOffset + header.mPhysicsConvexSize);
-
-            // Do not unlock mutex untill we are done with LLSD.
-            // LLSD is smart and can work like smart pointer, is not thread safe.
-            gMeshRepo.mThread->mHeaderMutex->unlock();
-
-            S32 bytes = lod_bytes + header_bytes;
-
-
-            // It's possible for the remote asset to have more data than is needed for the local cache
-            // only allocate as much space in the cache as is needed for the local cache
-            data_size = llmin(data_size, bytes);
-
-            LLFileSystem file(mesh_id, LLAssetType::AT_MESH, LLFileSystem::READ_WRITE);
-            if (file.getMaxSize() >= bytes)
-            {
-                LLMeshRepository::sCacheBytesWritten += data_size;
-                ++LLMeshRepository::sCacheWrites;
-
-                file.write(data, data_size);
-
-                S32 remaining = bytes - file.tell();
-                if (remaining > 0)
-                {
-                    U8* block = new(std::nothrow) U8[remaining];
-                    if (block)
-                    {
-                        memset(block, 0, remaining);
-                        file.write(block, remaining);
-                        delete[] block;
-                    }
-                }
-            }
+            gMeshRepo.mThread->indexMeshHeader(mesh_id, data, data_size);
         }
         else
         {
             LL_WARNS(LOG_MESH) << "Trying to cache nonexistent mesh, mesh id: " << mesh_id << LL_ENDL;
 
-            gMeshRepo.mThread->mHeaderMutex->unlock();
-
             // headerReceived() parsed header, but header's data is invalid so none of the LODs will be available
             LLMutexLock lock(gMeshRepo.mThread->mMutex);
             for (int i(0); i < LLVolumeLODGroup::NUM_LODS; ++i)
@@ -3464,10 +3868,11 @@ void LLMeshLODHandler::processData(LLCore::BufferArray * /* body */, S32 /* body
     if ((!MESH_LOD_PROCESS_FAILED)
         && ((data != NULL) == (data_size > 0))) // if we have data but no size or have size but no data, something is wrong
     {
-        EMeshProcessingResult result = gMeshRepo.mThread->lodReceived(mMeshParams, mLOD, data, data_size);
-        if (result == MESH_OK)
+        if (data_size > 0)
         {
-            // good fetch from sim, write to cache
+            // good fetch from sim, write to cache.  Decoding happens on
+            // the decode pool; if it fails, the cached copy fails the
+            // same way and is fetched again next time.
             LLFileSystem file(mMeshParams.getSculptID(), LLAssetType::AT_MESH, LLFileSystem::READ_WRITE);
 
             S32 offset = mOffset;
@@ -3481,17 +3886,7 @@ void LLMeshLODHandler::processData(LLCore::BufferArray * /* body */, S32 /* body
                 ++LLMeshRepository::sCacheWrites;
             }
         }
-        else
-        {
-            LL_WARNS(LOG_MESH) << "Error during mesh LOD processing.  ID:  " << mMeshParams.getSculptID()
-                               << ", Reason: " << result
-                               << " LOD: " << mLOD
-                               << " Data size: " << data_size
-                               << " Not retrying."
-                               << LL_ENDL;
-            LLMutexLock lock(gMeshRepo.mThread->mMutex);
-            gMeshRepo.mThread->mUnavailableQ.push_back(LLMeshRepoThread::LODRequest(mMeshParams, mLOD));
-        }
+        gMeshRepo.mThread->queueLODDecode(mMeshParams, mLOD, data, data_size, false);
     }
     else
     {
@@ -3527,22 +3922,25 @@ void LLMeshSkinInfoHandler::processData(LLCore::BufferArray * /* body */, S32 /*
                                         U8 * data, S32 data_size)
 {
     if ((!MESH_SKIN_INFO_PROCESS_FAILED)
-        && ((data != NULL) == (data_size > 0)) // if we have data but no size or have size but no data, something is wrong
-        && gMeshRepo.mThread->skinInfoReceived(mMeshID, data, data_size))
+        && ((data != NULL) == (data_size > 0))) // if we have data but no size or have size but no data, something is wrong
     {
-        // good fetch from sim, write to cache
-        LLFileSystem file(mMeshID, LLAssetType::AT_MESH, LLFileSystem::READ_WRITE);
+        if (data_size > 0)
+        {
+            // good fetch from sim, write to cache (see LLMeshLODHandler)
+            LLFileSystem file(mMeshID, LLAssetType::AT_MESH, LLFileSystem::READ_WRITE);
 
-        S32 offset = mOffset;
-        S32 size = mRequestedBytes;
+            S32 offset = mOffset;
+            S32 size = mRequestedBytes;
 
-        if (file.getSize() >= offset+size)
-        {
-            LLMeshRepository::sCacheBytesWritten += size;
-            ++LLMeshRepository::sCacheWrites;
-            file.seek(offset);
-            file.write(data, size);
+            if (file.getSize() >= offset+size)
+            {
+                LLMeshRepository::sCacheBytesWritten += size;
+                ++LLMeshRepository::sCacheWrites;
+                file.seek(offset);
+                file.write(data, size);
+            }
         }
+        gMeshRepo.mThread->queueSkinInfoDecode(mMeshID, data, data_size, false);
     }
     else
     {
@@ -3680,6 +4078,15 @@ void LLMeshRepository::init()
 
     metrics_teleport_started_signal = LLViewerMessage::getInstance()->setTeleportStartedCallback(teleport_started);
 
+    // LLMeshCostData::init() is also run by the repo thread as headers arrive,
+    // make sure its cached controls are set up here first
+    LLMeshHeader dummy_header;
+    LLMeshCostData().init(dummy_header);
+
+    LLMeshRepoThread::sUseOptimizedCache = gSavedSettings.getBOOL("MeshOptimizedCache");
+    LLMeshRepoThread::sPrefetchHeaders = gSavedSettings.getBOOL("MeshHeaderPrefetch");
+    LLMeshRepoThread::sHeaderIndexSize = gSavedSettings.getU32("MeshHeaderIndexSize");
+
     mThread = new LLMeshRepoThread();
     mThread->start();
 }
@@ -3785,6 +4192,8 @@ S32 LLMeshRepository::loadMesh(LLVOVolume* vobj, const LLVolumeParams& mesh_para
         return detail;
     }
 
+    bool prefetch_header = false;
+    bool first_request = false;
     {
         LLMutexLock lock(mMeshMutex);
         //add volume to list of loading meshes
@@ -3803,9 +4212,21 @@ S32 LLMeshRepository::loadMesh(LLVOVolume* vobj, const LLVolumeParams& mesh_para
             mLoadingMeshes[detail][mesh_id].push_back(vobj);
             mPendingRequests.push_back(LLMeshRepoThread::LODRequest(mesh_params, detail));
             LLMeshRepository::sLODPending++;
+            prefetch_header = LLMeshRepoThread::sPrefetchHeaders;
+            first_request = true;
         }
     }
 
+    if (first_request)
+    {
+        LLRegionPrefetch::instance().noteMesh(mesh_params.getSculptID());
+    }
+
+    if (prefetch_header && mThread)
+    { //the LOD request waits its turn in mPendingRequests, but the header can be on its way already
+        mThread->prefetchMeshHeader(mesh_params);
+    }
+
     //do a quick search to see if we can't display something while we wait for this mesh to load
     LLVolume* volume = vobj->getVolume();
 
@@ -4995,6 +5416,13 @@ bool LLMeshRepository::getCostData(LLUUID mesh_id, LLMeshCostData& data)
     if (mThread && mesh_id.notNull())
     {
         LLMutexLock lock(mThread->mHeaderMutex);
+        LLMeshRepoThread::mesh_cost_map::iterator cost_iter = mThread->mMeshCostData.find(mesh_id);
+        if (cost_iter != mThread->mMeshCostData.end())
+        {
+            data = cost_iter->second;
+            return true;
+        }
+
         LLMeshRepoThread::mesh_header_map::iterator iter = mThread->mMeshHeader.find(mesh_id);
         if (iter != mThread->mMeshHeader.end() && iter->second.first > 0)
         {
@@ -40,6 +40,7 @@
 #include "httpheaders.h"
 #include "httphandler.h"
 #include "llthread.h"
+#include "threadpool_fwd.h"
 
 #define LLCONVEXDECOMPINTER_STATIC 1
 
@@ -261,6 +262,53 @@ public:
     LLUUID mCreatorId{ LLUUID::null };
 };
 
+// Params related to streaming cost, render cost, and scene complexity tracking.
+class LLMeshCostData
+{
+public:
+    LLMeshCostData();
+
+    bool init(const LLMeshHeader& header);
+
+    // Size for given LOD
+    S32 getSizeByLOD(S32 lod);
+
+    // Sum of all LOD sizes.
+    S32 getSizeTotal();
+
+    // Estimated triangle counts for the given LOD.
+    F32 getEstTrisByLOD(S32 lod);
+
+    // Estimated triangle counts for the largest LOD. Typically this
+    // is also the "high" LOD, but not necessarily.
+    F32 getEstTrisMax();
+
+    // Triangle count as computed by original streaming cost
+    // formula. Triangles in each LOD are weighted based on how
+    // frequently they will be seen.
+    // This was called "unscaled_value" in the original getStreamingCost() functions.
+    F32 getRadiusWeightedTris(F32 radius);
+
+    // Triangle count used by triangle-based cost formula. Based on
+    // triangles in highest LOD plus potentially partial charges for
+    // lower LODs depending on complexity.
+    F32 getEstTrisForStreamingCost();
+
+    // Streaming cost. This should match the server-side calculation
+    // for the corresponding volume.
+    F32 getRadiusBasedStreamingCost(F32 radius);
+
+    // New streaming cost formula, currently only used for animated objects.
+    F32 getTriangleBasedStreamingCost();
+
+private:
+    // From the "size" field of the mesh header. LOD 0=lowest, 3=highest.
+    std::array<S32,4> mSizeByLOD;
+
+    // Estimated triangle counts derived from the LOD sizes. LOD 0=lowest, 3=highest.
+    std::array<F32,4> mEstTrisByLOD;
+};
+
 class LLMeshRepoThread : public LLThread
 {
 public:
@@ -271,6 +319,9 @@ public:
     static S32 sRequestLowWater;
     static S32 sRequestHighWater;
     static S32 sRequestWaterLevel;          // Stats-use only, may read outside of thread
+    static bool sUseOptimizedCache;         // Keep a cache tier of optimized LOD faces, set before start()
+    static bool sPrefetchHeaders;           // Request headers as soon as a mesh is named, set before start()
+    static U32 sHeaderIndexSize;            // Max headers kept in the persistent header index, set before start()
 
     LLMutex*    mMutex;
     LLMutex*    mHeaderMutex;
@@ -280,6 +331,11 @@ public:
     typedef boost::unordered_map<LLUUID, std::pair<U32, LLMeshHeader>> mesh_header_map; // pair is header_size and data
     mesh_header_map mMeshHeader;
 
+    // cost data derived from each valid header as it arrives, so the main
+    // thread doesn't redo it for every complexity update
+    typedef boost::unordered_map<LLUUID, LLMeshCostData> mesh_cost_map;
+    mesh_cost_map mMeshCostData;
+
     class HeaderRequest : public RequestStats
     {
     public:
@@ -302,9 +358,10 @@ public:
         LLVolumeParams  mMeshParams;
         S32 mLOD;
         F32 mScore;
+        bool mSkipCache;    // cached copy failed to decode, go to the sim
 
         LODRequest(const LLVolumeParams&  mesh_params, S32 lod)
-            : RequestStats(), mMeshParams(mesh_params), mLOD(lod), mScore(0.f)
+            : RequestStats(), mMeshParams(mesh_params), mLOD(lod), mScore(0.f), mSkipCache(false)
         {
         }
     };
@@ -321,9 +378,10 @@ public:
     {
     public:
         LLUUID mId;
+        bool mSkipCache;    // cached copy failed to decode, go to the sim
 
         UUIDBasedRequest(const LLUUID& id)
-            : RequestStats(), mId(id)
+            : RequestStats(), mId(id), mSkipCache(false)
         {
         }
 
@@ -381,6 +439,14 @@ public:
     typedef boost::unordered_map<LLUUID, std::vector<S32> > pending_lod_map;
     pending_lod_map mPendingLOD;
 
+    // Raw header bytes of meshes seen before, persisted in the mesh cache
+    // by the repo thread.  A mesh whose asset was purged from the cache
+    // gets its header from here and goes straight to its LOD requests.
+    typedef boost::unordered_map<LLUUID, std::string> header_index_map;
+    header_index_map                    mHeaderIndex;
+    std::deque<LLUUID>                  mHeaderIndexOrder;  // oldest first
+    bool                                mHeaderIndexDirty = false;
+
     // llcorehttp library interface objects.
     LLCore::HttpStatus                  mHttpStatus;
     LLCore::HttpRequest *               mHttpRequest;
@@ -394,6 +460,10 @@ public:
     typedef std::set<LLCore::HttpHandler::ptr_t> http_request_set;
     http_request_set                    mHttpRequestSet;            // Outstanding HTTP requests
 
+    // Inflating and unpacking LOD and skin data runs here so this
+    // thread only coordinates requests.
+    std::unique_ptr<LL::ThreadPool>     mDecodePool;
+
     // <FS:Ansariel> [UDP Assets]
     std::string mLegacyGetMeshCapability;
     std::string mLegacyGetMesh2Capability;
@@ -409,9 +479,37 @@ public:
     void lockAndLoadMeshLOD(const LLVolumeParams& mesh_params, S32 lod);
     void loadMeshLOD(const LLVolumeParams& mesh_params, S32 lod);
 
+    // Queue a header request ahead of any LOD request so the header is
+    // usually known by the time the LOD request clears the throttle.
+    // Could be called from any thread.
+    void prefetchMeshHeader(const LLVolumeParams& mesh_params);
+
     bool fetchMeshHeader(const LLVolumeParams& mesh_params, bool can_retry = true);
-    bool fetchMeshLOD(const LLVolumeParams& mesh_params, S32 lod, bool can_retry = true);
+    bool fetchMeshLOD(const LLVolumeParams& mesh_params, S32 lod, bool can_retry = true, bool use_cache = true);
     EMeshProcessingResult headerReceived(const LLVolumeParams& mesh_params, U8* data, S32 data_size);
+
+    // Reserve the cache entry of a mesh whose header was just received
+    // and write the header to it.  Returns false if the parsed header
+    // says the asset has no usable data.
+    bool cacheMeshHeader(const LLUUID& mesh_id, U8* data, S32 data_size);
+
+    // Header index, see mHeaderIndex.  Threads:  Trepo
+    void loadHeaderIndex();
+    void saveHeaderIndex();
+    void indexMeshHeader(const LLUUID& mesh_id, const U8* data, S32 data_size);
+
+    // Copy LOD or skin info data and decode it on mDecodePool.  Results
+    // go to mLoadedQ/mSkinInfoQ, failures to the unavailable queues, or
+    // back to the request queues bypassing the cache if from_cache.
+    void queueLODDecode(const LLVolumeParams& mesh_params, S32 lod, U8* data, S32 data_size, bool from_cache);
+    void queueSkinInfoDecode(const LLUUID& mesh_id, U8* data, S32 data_size, bool from_cache);
+
+    // Restore a LOD from the optimized cache tier on mDecodePool.  A bad
+    // entry is removed and the LOD requested again the regular way.
+    void queueOptimizedLODDecode(const LLVolumeParams& mesh_params, S32 lod, std::shared_ptr<std::vector<U8> > buffer);
+    static LLUUID getOptimizedCacheID(const LLUUID& mesh_id, S32 lod);
+
+    // Decode pool side of the above
     EMeshProcessingResult lodReceived(const LLVolumeParams& mesh_params, S32 lod, U8* data, S32 data_size);
     bool skinInfoReceived(const LLUUID& mesh_id, U8* data, S32 data_size);
     bool decompositionReceived(const LLUUID& mesh_id, U8* data, S32 data_size);
@@ -429,7 +527,7 @@ public:
 
     //send request for skin info, returns true if header info exists
     //  (should hold onto mesh_id and try again later if header info does not exist)
-    bool fetchMeshSkinInfo(const LLUUID& mesh_id, bool can_retry = true);
+    bool fetchMeshSkinInfo(const LLUUID& mesh_id, bool can_retry = true, bool use_cache = true);
 
     //send request for decomposition, returns true if header info exists
     //  (should hold onto mesh_id and try again later if header info does not exist)
@@ -578,52 +676,6 @@ private:
     LLCore::HttpRequest::policy_t       mHttpPolicyClass;
 };
 
-// Params related to streaming cost, render cost, and scene complexity tracking.
-class LLMeshCostData
-{
-public:
-    LLMeshCostData();
-
-    bool init(const LLMeshHeader& header);
-
-    // Size for given LOD
-    S32 getSizeByLOD(S32 lod);
-
-    // Sum of all LOD sizes.
-    S32 getSizeTotal();
-
-    // Estimated triangle counts for the given LOD.
-    F32 getEstTrisByLOD(S32 lod);
-
-    // Estimated triangle counts for the largest LOD. Typically this
-    // is also the "high" LOD, but not necessarily.
-    F32 getEstTrisMax();
-
-    // Triangle count as computed by original streaming cost
-    // formula. Triangles in each LOD are weighted based on how
-    // frequently they will be seen.
-    // This was called "unscaled_value" in the original getStreamingCost() functions.
-    F32 getRadiusWeightedTris(F32 radius);
-
-    // Triangle count used by triangle-based cost formula. Based on
-    // triangles in highest LOD plus potentially partial charges for
-    // lower LODs depending on complexity.
-    F32 getEstTrisForStreamingCost();
-
-    // Streaming cost. This should match the server-side calculation
-    // for the corresponding volume.
-    F32 getRadiusBasedStreamingCost(F32 radius);
-
-    // New streaming cost formula, currently only used for animated objects.
-    F32 getTriangleBasedStreamingCost();
-
-private:
-    // From the "size" field of the mesh header. LOD 0=lowest, 3=highest.
-    std::array<S32,4> mSizeByLOD;
-
-    // Estimated triangle counts derived from the LOD sizes. LOD 0=lowest, 3=highest.
-    std::array<F32,4> mEstTrisByLOD;
-};
 
 class LLMeshRepository
 {
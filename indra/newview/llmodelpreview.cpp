@@ -60,6 +60,7 @@
 #include "llviewertexturelist.h"
 #include "llvoavatar.h"
 #include "pipeline.h"
+#include "workqueue.h"
 
 // ui controls (from floater)
 #include "llbutton.h"
@@ -69,6 +70,7 @@
 #include "lltextbox.h"
 
 #include <filesystem>
+#include <thread>
 
 #include <boost/algorithm/string.hpp>
 // <AW: opensim-limits>
@@ -2615,6 +2617,248 @@ F32 LLModelPreview::genMeshOptimizerPerFace(LLModel *base_model, LLModel *target
     return (F32)size_indices / (F32)size_new_indices;
 }
 
+// Models of one lod simplify independently of each other, so they are spread over the
+// General pool.  The main thread takes models too and returns once all are done.
+void LLModelPreview::simplifyModels(S32 lod, S32 which_lod, S32 meshopt_mode, U32 lod_mode, F32 indices_decimator, F32 lod_error_threshold, U32 decimation)
+{
+    struct SimplifyJob
+    {
+        std::atomic<U32> mNext{ 0 };
+        std::atomic<U32> mDone{ 0 };
+    };
+    static const U32 MAX_SIMPLIFY_HELPERS = 8;
+
+    const U32 count = (U32)mBaseModel.size();
+    auto job = std::make_shared<SimplifyJob>();
+    // whoever runs this gets the next model nobody started yet; a helper that only starts
+    // after all models were taken returns without touching the preview
+    auto take_models = [this, job, count, lod, which_lod, meshopt_mode, lod_mode, indices_decimator, lod_error_threshold, decimation]()
+    {
+        for (U32 mdl_idx = job->mNext++; mdl_idx < count; mdl_idx = job->mNext++)
+        {
+            simplifyModel(mBaseModel[mdl_idx], mModel[lod][mdl_idx], which_lod, meshopt_mode, lod_mode,
+                          indices_decimator, lod_error_threshold, decimation);
+            job->mDone++;
+        }
+    };
+
+    LL::WorkQueue::ptr_t general_queue = LL::WorkQueue::getInstance("General");
+    if (general_queue)
+    {
+        for (U32 i = 1; i < llmin(count, MAX_SIMPLIFY_HELPERS + 1); ++i)
+        {
+            general_queue->post(take_models);
+        }
+    }
+    take_models();
+
+    while (job->mDone < count)
+    {
+        // the last models are still being simplified by helpers
+        std::this_thread::yield();
+    }
+}
+
+void LLModelPreview::simplifyModel(LLModel* base, LLModel* target_model, S32 which_lod, S32 meshopt_mode, U32 lod_mode, F32 indices_decimator, F32 lod_error_threshold, U32 decimation)
+{
+    S32 model_meshopt_mode = meshopt_mode;
+
+    // Ideally this should run not per model,
+    // but combine all submodels with origin model as well
+    if (model_meshopt_mode == MESH_OPTIMIZER_PRECISE)
+    {
+        // Run meshoptimizer for each face
+        for (S32 face_idx = 0; face_idx < base->getNumVolumeFaces(); ++face_idx)
+        {
+            F32 res = genMeshOptimizerPerFace(base, target_model, face_idx, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_FULL);
+            if (res < 0)
+            {
+                // Mesh optimizer failed and returned an invalid model
+                const LLVolumeFace &face = base->getVolumeFace(face_idx);
+                LLVolumeFace &new_face = target_model->getVolumeFace(face_idx);
+                new_face = face;
+            }
+        }
+    }
+
+    if (model_meshopt_mode == MESH_OPTIMIZER_SLOPPY)
+    {
+        // Run meshoptimizer for each face
+        for (S32 face_idx = 0; face_idx < base->getNumVolumeFaces(); ++face_idx)
+        {
+            if (genMeshOptimizerPerFace(base, target_model, face_idx, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_TOPOLOGY) < 0)
+            {
+                // Sloppy failed and returned an invalid model
+                genMeshOptimizerPerFace(base, target_model, face_idx, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_FULL);
+            }
+        }
+    }
+
+    if (model_meshopt_mode == MESH_OPTIMIZER_AUTO)
+    {
+        // Remove progressively more data if we can't reach the target.
+        F32 allowed_ratio_drift = 1.8f;
+        F32 precise_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_FULL);
+
+        if (precise_ratio < 0 || (precise_ratio * allowed_ratio_drift < indices_decimator))
+        {
+            precise_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_NORMALS);
+        }
+
+        if (precise_ratio < 0 || (precise_ratio * allowed_ratio_drift < indices_decimator))
+        {
+            precise_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_UVS);
+        }
+
+        if (precise_ratio < 0 || (precise_ratio * allowed_ratio_drift < indices_decimator))
+        {
+            // Try sloppy variant if normal one failed to simplify model enough.
+            // Sloppy variant can fail entirely and has issues with precision,
+            // so code needs to do multiple attempts with different decimators.
+            // Todo: this is a bit of a mess, needs to be refined and improved
+
+            F32 last_working_decimator = 0.f;
+            F32 last_working_ratio = F32_MAX;
+
+            F32 sloppy_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_TOPOLOGY);
+
+            if (sloppy_ratio > 0)
+            {
+                // Would be better to do a copy of target_model here, but if
+                // we need to use sloppy decimation, model should be cheap
+                // and fast to generate and it won't affect end result
+                last_working_decimator = indices_decimator;
+                last_working_ratio = sloppy_ratio;
+            }
+
+            // Sloppy has a tendecy to error into lower side, so a request for 100
+            // triangles turns into ~70, so check for significant difference from target decimation
+            F32 sloppy_ratio_drift = 1.4f;
+            if (lod_mode == LIMIT_TRIANGLES
+                && (sloppy_ratio > indices_decimator * sloppy_ratio_drift || sloppy_ratio < 0))
+            {
+                // Apply a correction to compensate.
+
+                // (indices_decimator / res_ratio) by itself is likely to overshoot to a differend
+                // side due to overal lack of precision, and we don't need an ideal result, which
+                // likely does not exist, just a better one, so a partial correction is enough.
+                F32 sloppy_decimator{indices_decimator};
+                // if(sloppy_ratio > 0)
+                // {
+                sloppy_decimator = indices_decimator * (indices_decimator / sloppy_ratio + 1) / 2;
+                // }
+                sloppy_ratio = genMeshOptimizerPerModel(base, target_model, sloppy_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_TOPOLOGY);
+            }
+
+            if (last_working_decimator > 0 && sloppy_ratio < last_working_ratio)
+            {
+                // Compensation didn't work, return back to previous decimator
+                sloppy_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_TOPOLOGY);
+            }
+
+            if (sloppy_ratio < 0)
+            {
+                // Sloppy method didn't work, try with smaller decimation values
+                {
+                    // Find a decimator that does work
+                    F32 sloppy_decimation_step = sqrt((F32)decimation); // example: 27->15->9->5->3
+                    F32 sloppy_decimator = indices_decimator / sloppy_decimation_step;
+                    U64Microseconds end_time = LLTimer::getTotalTime() + U64Seconds(5);
+
+                    while (sloppy_ratio < 0
+                        && sloppy_decimator > precise_ratio
+                        && sloppy_decimator > 1 // precise_ratio isn't supposed to be below 1, but check just in case
+                        && end_time > LLTimer::getTotalTime())
+                    {
+                        sloppy_ratio = genMeshOptimizerPerModel(base, target_model, sloppy_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_TOPOLOGY);
+                        sloppy_decimator = sloppy_decimator / sloppy_decimation_step;
+                    }
+                }
+            }
+
+            if (sloppy_ratio < 0 || sloppy_ratio < precise_ratio)
+            {
+                // Sloppy variant failed to generate triangles or is worse.
+                // Can happen with models that are too simple as is.
+
+                if (precise_ratio < 0)
+                {
+                    // Precise method failed as well, just copy face over
+                    target_model->copyVolumeFaces(base);
+                    precise_ratio = 1.f;
+                }
+                else
+                {
+                    // Fallback to normal method
+                    precise_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_FULL);
+                }
+                // <FS:Beq> Log stuff properly
+                // LL_INFOS() << "Model " << target_model->getName()
+                //     << " lod " << which_lod
+                //     << " resulting ratio " << precise_ratio
+                //     << " simplified using per model method." << LL_ENDL;
+                {
+                    std::ostringstream out;
+                    out << "Model " << target_model->getName()
+                        << " lod " << which_lod
+                        << " resulting ratio " << precise_ratio
+                        << " simplified using per model method.";
+                    LL_INFOS() << out.str() << LL_ENDL;
+                    LLFloaterModelPreview::addStringToLog(out, false);
+                }
+                // </FS:Beq>
+            }
+            else
+            {
+                // <FS:Beq> Log stuff properly
+                // LL_INFOS() << "Model " << target_model->getName()
+                //     << " lod " << which_lod
+                //     << " resulting ratio " << sloppy_ratio
+                //     << " sloppily simplified using per model method." << LL_ENDL;
+                std::ostringstream out;
+                out << "Model " << target_model->getName()
+                    << " lod " << which_lod
+                    << " resulting ratio " << sloppy_ratio
+                    << " sloppily simplified using per model method.";
+                LL_INFOS() << out.str() << LL_ENDL;
+                LLFloaterModelPreview::addStringToLog(out, false);
+                // </FS:Beq>
+            }
+        }
+        else
+        {
+                // <FS:Beq> Log stuff properly
+                // LL_INFOS() << "Model " << target_model->getName()
+                //     << " lod " << which_lod
+                //     << " resulting ratio " << precise_ratio
+                //     << " simplified using per model method." << LL_ENDL;
+                std::ostringstream out;
+                out << "Bad MeshOptimisation result for Model " << target_model->getName()
+                    << " lod " << which_lod
+                    << " resulting ratio " << precise_ratio
+                    << " simplified using per model method.";
+                LL_WARNS() << out.str() << LL_ENDL;
+                LLFloaterModelPreview::addStringToLog(out, true);
+                // </FS:Beq>
+        }
+    }
+
+    //blind copy skin weights and just take closest skin weight to point on
+    //decimated mesh for now (auto-generating LODs with skin weights is still a bit
+    //of an open problem).
+    target_model->mPosition = base->mPosition;
+    target_model->mSkinWeights = base->mSkinWeights;
+    target_model->mSkinInfo = base->mSkinInfo;
+
+    //copy material list
+    target_model->mMaterialList = base->mMaterialList;
+
+    if (!validate_model(target_model))
+    {
+        LL_ERRS() << "Invalid model generated when creating LODs" << LL_ENDL;
+    }
+}
+
 void LLModelPreview::genMeshOptimizerLODs(S32 which_lod, S32 meshopt_mode, U32 decimation, bool enforce_tri_limit)
 {
     // <FS:Beq> Log things properly
@@ -2765,205 +3009,10 @@ void LLModelPreview::genMeshOptimizerLODs(S32 which_lod, S32 meshopt_mode, U32 d
                 LLVolumeFace& dst = target_model->getVolumeFace(i);
                 dst.mNormalizedScale = src.mNormalizedScale;
             }
-
-            S32 model_meshopt_mode = meshopt_mode;
-
-            // Ideally this should run not per model,
-            // but combine all submodels with origin model as well
-            if (model_meshopt_mode == MESH_OPTIMIZER_PRECISE)
-            {
-                // Run meshoptimizer for each face
-                for (S32 face_idx = 0; face_idx < base->getNumVolumeFaces(); ++face_idx)
-                {
-                    F32 res = genMeshOptimizerPerFace(base, target_model, face_idx, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_FULL);
-                    if (res < 0)
-                    {
-                        // Mesh optimizer failed and returned an invalid model
-                        const LLVolumeFace &face = base->getVolumeFace(face_idx);
-                        LLVolumeFace &new_face = target_model->getVolumeFace(face_idx);
-                        new_face = face;
-                    }
-                }
-            }
-
-            if (model_meshopt_mode == MESH_OPTIMIZER_SLOPPY)
-            {
-                // Run meshoptimizer for each face
-                for (S32 face_idx = 0; face_idx < base->getNumVolumeFaces(); ++face_idx)
-                {
-                    if (genMeshOptimizerPerFace(base, target_model, face_idx, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_TOPOLOGY) < 0)
-                    {
-                        // Sloppy failed and returned an invalid model
-                        genMeshOptimizerPerFace(base, target_model, face_idx, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_FULL);
-                    }
-                }
-            }
-
-            if (model_meshopt_mode == MESH_OPTIMIZER_AUTO)
-            {
-                // Remove progressively more data if we can't reach the target.
-                F32 allowed_ratio_drift = 1.8f;
-                F32 precise_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_FULL);
-
-                if (precise_ratio < 0 || (precise_ratio * allowed_ratio_drift < indices_decimator))
-                {
-                    precise_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_NORMALS);
-                }
-
-                if (precise_ratio < 0 || (precise_ratio * allowed_ratio_drift < indices_decimator))
-                {
-                    precise_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_UVS);
-                }
-
-                if (precise_ratio < 0 || (precise_ratio * allowed_ratio_drift < indices_decimator))
-                {
-                    // Try sloppy variant if normal one failed to simplify model enough.
-                    // Sloppy variant can fail entirely and has issues with precision,
-                    // so code needs to do multiple attempts with different decimators.
-                    // Todo: this is a bit of a mess, needs to be refined and improved
-
-                    F32 last_working_decimator = 0.f;
-                    F32 last_working_ratio = F32_MAX;
-
-                    F32 sloppy_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_TOPOLOGY);
-
-                    if (sloppy_ratio > 0)
-                    {
-                        // Would be better to do a copy of target_model here, but if
-                        // we need to use sloppy decimation, model should be cheap
-                        // and fast to generate and it won't affect end result
-                        last_working_decimator = indices_decimator;
-                        last_working_ratio = sloppy_ratio;
-                    }
-
-                    // Sloppy has a tendecy to error into lower side, so a request for 100
-                    // triangles turns into ~70, so check for significant difference from target decimation
-                    F32 sloppy_ratio_drift = 1.4f;
-                    if (lod_mode == LIMIT_TRIANGLES
-                        && (sloppy_ratio > indices_decimator * sloppy_ratio_drift || sloppy_ratio < 0))
-                    {
-                        // Apply a correction to compensate.
-
-                        // (indices_decimator / res_ratio) by itself is likely to overshoot to a differend
-                        // side due to overal lack of precision, and we don't need an ideal result, which
-                        // likely does not exist, just a better one, so a partial correction is enough.
-                        F32 sloppy_decimator{indices_decimator};
-                        // if(sloppy_ratio > 0)
-                        // {
-                        sloppy_decimator = indices_decimator * (indices_decimator / sloppy_ratio + 1) / 2;
-                        // }
-                        sloppy_ratio = genMeshOptimizerPerModel(base, target_model, sloppy_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_TOPOLOGY);
-                    }
-
-                    if (last_working_decimator > 0 && sloppy_ratio < last_working_ratio)
-                    {
-                        // Compensation didn't work, return back to previous decimator
-                        sloppy_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_TOPOLOGY);
-                    }
-
-                    if (sloppy_ratio < 0)
-                    {
-                        // Sloppy method didn't work, try with smaller decimation values
-                        {
-                            // Find a decimator that does work
-                            F32 sloppy_decimation_step = sqrt((F32)decimation); // example: 27->15->9->5->3
-                            F32 sloppy_decimator = indices_decimator / sloppy_decimation_step;
-                            U64Microseconds end_time = LLTimer::getTotalTime() + U64Seconds(5);
-
-                            while (sloppy_ratio < 0
-                                && sloppy_decimator > precise_ratio
-                                && sloppy_decimator > 1 // precise_ratio isn't supposed to be below 1, but check just in case
-                                && end_time > LLTimer::getTotalTime())
-                            {
-                                sloppy_ratio = genMeshOptimizerPerModel(base, target_model, sloppy_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_TOPOLOGY);
-                                sloppy_decimator = sloppy_decimator / sloppy_decimation_step;
-                            }
-                        }
-                    }
-
-                    if (sloppy_ratio < 0 || sloppy_ratio < precise_ratio)
-                    {
-                        // Sloppy variant failed to generate triangles or is worse.
-                        // Can happen with models that are too simple as is.
-
-                        if (precise_ratio < 0)
-                        {
-                            // Precise method failed as well, just copy face over
-                            target_model->copyVolumeFaces(base);
-                            precise_ratio = 1.f;
-                        }
-                        else
-                        {
-                            // Fallback to normal method
-                            precise_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_FULL);
-                        }
-                        // <FS:Beq> Log stuff properly
-                        // LL_INFOS() << "Model " << target_model->getName()
-                        //     << " lod " << which_lod
-                        //     << " resulting ratio " << precise_ratio
-                        //     << " simplified using per model method." << LL_ENDL;
-                        {
-                            std::ostringstream out;
-                            out << "Model " << target_model->getName()
-                                << " lod " << which_lod
-                                << " resulting ratio " << precise_ratio
-                                << " simplified using per model method.";
-                            LL_INFOS() << out.str() << LL_ENDL;
-                            LLFloaterModelPreview::addStringToLog(out, false);
-                        }
-                        // </FS:Beq>
-                    }
-                    else
-                    {
-                        // <FS:Beq> Log stuff properly
-                        // LL_INFOS() << "Model " << target_model->getName()
-                        //     << " lod " << which_lod
-                        //     << " resulting ratio " << sloppy_ratio
-                        //     << " sloppily simplified using per model method." << LL_ENDL;
-                        std::ostringstream out;
-                        out << "Model " << target_model->getName()
-                            << " lod " << which_lod
-                            << " resulting ratio " << sloppy_ratio
-                            << " sloppily simplified using per model method.";
-                        LL_INFOS() << out.str() << LL_ENDL;
-                        LLFloaterModelPreview::addStringToLog(out, false);
-                        // </FS:Beq>
-                    }
-                }
-                else
-                {
-                        // <FS:Beq> Log stuff properly
-                        // LL_INFOS() << "Model " << target_model->getName()
-                        //     << " lod " << which_lod
-                        //     << " resulting ratio " << precise_ratio
-                        //     << " simplified using per model method." << LL_ENDL;
-                        std::ostringstream out;
-                        out << "Bad MeshOptimisation result for Model " << target_model->getName()
-                            << " lod " << which_lod
-                            << " resulting ratio " << precise_ratio
-                            << " simplified using per model method.";
-                        LL_WARNS() << out.str() << LL_ENDL;
-                        LLFloaterModelPreview::addStringToLog(out, true);
-                        // </FS:Beq>
-                }
-            }
-
-            //blind copy skin weights and just take closest skin weight to point on
-            //decimated mesh for now (auto-generating LODs with skin weights is still a bit
-            //of an open problem).
-            target_model->mPosition = base->mPosition;
-            target_model->mSkinWeights = base->mSkinWeights;
-            target_model->mSkinInfo = base->mSkinInfo;
-
-            //copy material list
-            target_model->mMaterialList = base->mMaterialList;
-
-            if (!validate_model(target_model))
-            {
-                LL_ERRS() << "Invalid model generated when creating LODs" << LL_ENDL;
-            }
         }
 
+        simplifyModels(lod, which_lod, meshopt_mode, lod_mode, indices_decimator, lod_error_threshold, decimation);
+
         //rebuild scene based on mBaseScene
         mScene[lod].clear();
         mScene[lod] = mBaseScene;
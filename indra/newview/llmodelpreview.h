@@ -263,6 +263,10 @@ private:
     // Simplifies specified face using mesh optimizer.
     // Returns reached simplification ratio. -1 in case of a failure.
     F32 genMeshOptimizerPerFace(LLModel *base_model, LLModel *target_model, U32 face_idx, F32 indices_ratio, F32 error_threshold, eSimplificationMode simplification_mode);
+    // Simplifies every base model into mModel[lod], several at once
+    void simplifyModels(S32 lod, S32 which_lod, S32 meshopt_mode, U32 lod_mode, F32 indices_decimator, F32 lod_error_threshold, U32 decimation);
+    // Simplifies one base model into target_model, may run on any thread
+    void simplifyModel(LLModel* base, LLModel* target_model, S32 which_lod, S32 meshopt_mode, U32 lod_mode, F32 indices_decimator, F32 lod_error_threshold, U32 decimation);
 
 protected:
     friend class LLModelLoader;
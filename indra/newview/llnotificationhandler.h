@@ -319,6 +319,15 @@ public:
      */
     static LLUUID spawnIMSession(const std::string& name, const LLUUID& from_id);
 
+    /**
+     * Counts a toast for the notification's template and source (its "from_id" or
+     * "object_id"), and returns true while they are over NotificationToastFloodLimit
+     * toasts within NotificationToastFloodSeconds. The notification is then cancelled
+     * like LLScreenChannel::addToast() does with toasts it won't show, and the caller
+     * should not build a toast for it.
+     */
+    static bool suppressFloodedToast(const LLNotificationPtr& notification);
+
     /**
      * Returns name from the notification's substitution.
      *
@@ -196,6 +196,62 @@ void LLHandlerUtil::logToIMP2P(const LLUUID& from_id, const std::string& message
     }
 }
 
+// static
+bool LLHandlerUtil::suppressFloodedToast(const LLNotificationPtr& notification)
+{
+    static LLCachedControl<U32> flood_limit(gSavedSettings, "NotificationToastFloodLimit", 5);
+    static LLCachedControl<F32> flood_seconds(gSavedSettings, "NotificationToastFloodSeconds", 10.f);
+    if (flood_limit == 0 || notification->getPriority() >= NOTIFICATION_PRIORITY_HIGH)
+    {
+        return false;
+    }
+
+    struct FloodEntry
+    {
+        F64 mWindowStart = 0.0;
+        U32 mCount = 0;
+    };
+    typedef std::pair<std::string, LLUUID> flood_key_t;
+    static std::map<flood_key_t, FloodEntry> flood_entries;
+
+    const LLSD& payload = notification->getPayload();
+    LLUUID source = payload.has("from_id") ? payload["from_id"].asUUID() : payload["object_id"].asUUID();
+    F64 now = LLTimer::getElapsedSeconds();
+
+    // forget sources that went quiet, every chatty object would stay here otherwise
+    constexpr size_t MAX_FLOOD_ENTRIES = 256;
+    if (flood_entries.size() > MAX_FLOOD_ENTRIES)
+    {
+        for (auto it = flood_entries.begin(); it != flood_entries.end();)
+        {
+            it = now - it->second.mWindowStart > flood_seconds ? flood_entries.erase(it) : std::next(it);
+        }
+    }
+
+    FloodEntry& entry = flood_entries[flood_key_t(notification->getName(), source)];
+    if (now - entry.mWindowStart > flood_seconds)
+    {
+        entry.mWindowStart = now;
+        entry.mCount = 0;
+    }
+    if (++entry.mCount <= flood_limit)
+    {
+        return false;
+    }
+    if (entry.mCount == flood_limit + 1)
+    {
+        LL_INFOS("Notifications") << "Too many " << notification->getName() << " toasts from " << source
+                                  << ", not showing more for a while" << LL_ENDL;
+    }
+
+    if (!notification->canLogToIM() || !notification->hasFormElements())
+    {
+        // only cancel notification if it isn't being used in IM session
+        LLNotifications::instance().cancel(notification);
+    }
+    return true;
+}
+
 // static
 void LLHandlerUtil::logToIMP2P(const LLNotificationPtr& notification, bool to_file_only)
 {
@@ -136,7 +136,7 @@ bool LLScriptHandler::processNotification(const LLNotificationPtr& notification,
 // [/RLVa:KB]
         LLScriptFloaterManager::getInstance()->onAddNotification(notification->getID());
     }
-    else if (notification->canShowToast())
+    else if (notification->canShowToast() && !LLHandlerUtil::suppressFloodedToast(notification))
     {
         addToastWithNotification(notification);
     }
@@ -122,6 +122,11 @@ bool LLTipHandler::processNotification(const LLNotificationPtr& notification, bo
         }
     }
 
+    if (LLHandlerUtil::suppressFloodedToast(notification))
+    {
+        return false;
+    }
+
     LLToastPanel* notify_box = LLToastPanel::buidPanelFromNotification(notification);
 
     LLToast::Params p;
@@ -1818,18 +1818,20 @@ void LLPanelGroupMembersSubTab::updateMembers()
     if (mMemberProgress == gdatap->mMembers.begin())
     {
         mMembersList->deleteAllItems();
-    }
 
-    // <FS:Ansariel> Clear old callbacks so we don't end up adding people twice
-    for (avatar_name_cache_connection_map_t::iterator it = mAvatarNameCacheConnections.begin(); it != mAvatarNameCacheConnections.end(); ++it)
-    {
-        if (it->second.connected())
+        // <FS:Ansariel> Clear old callbacks so we don't end up adding people twice
+        // Only when starting over: later slices would drop the callbacks of members
+        // whose names are still on their way and never list them.
+        for (avatar_name_cache_connection_map_t::iterator it = mAvatarNameCacheConnections.begin(); it != mAvatarNameCacheConnections.end(); ++it)
         {
-            it->second.disconnect();
+            if (it->second.connected())
+            {
+                it->second.disconnect();
+            }
         }
+        mAvatarNameCacheConnections.clear();
+        // </FS:Ansariel>
     }
-    mAvatarNameCacheConnections.clear();
-    // </FS:Ansariel>
 
     LLGroupMgrGroupData::member_list_t::iterator end = gdatap->mMembers.end();
 
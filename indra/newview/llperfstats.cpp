@@ -27,6 +27,7 @@
 #include "llviewerprecompiledheaders.h"
 #include "llperfstats.h"
 #include "llcontrol.h"
+#include "llsdutil.h"
 #include "pipeline.h"
 #include "llagentcamera.h"
 #include "llviewerwindow.h"
@@ -75,6 +76,107 @@ namespace LLPerfStats
     std::array<StatsRecorder::StatsSummaryArray,2> StatsRecorder::max{ {} };
     std::array<StatsRecorder::StatsSummaryArray,2> StatsRecorder::sum{ {} };
 
+    // Scene features autotune lowers once draw distance is at the user's minimum, least noticeable first.
+    // What each was set to before is kept in AutoTuneSceneFeaturesLowered, so it can still be restored after a relog.
+    struct SceneFeature
+    {
+        const char* setting;
+        S32 loweredValue;
+    };
+
+    static const SceneFeature SCENE_FEATURES[] =
+    {
+        { "RenderMaxPartCount", 1024 },
+        { "RenderScreenSpaceReflections", 0 },
+        { "RenderTransparentWater", 0 },
+        { "RenderReflectionProbeDetail", 0 },
+        { "RenderShadowDetail", 0 },
+    };
+
+    // static
+    U32 Tunables::getSceneFeatureCount()
+    {
+        return LL_ARRAY_SIZE(SCENE_FEATURES);
+    }
+
+    // static
+    std::vector<std::string> Tunables::getLoweredSceneFeatures()
+    {
+        std::vector<std::string> features;
+        for (const auto& entry : llsd::inArray(gSavedSettings.getLLSD("AutoTuneSceneFeaturesLowered")))
+        {
+            if (entry.has("value"))
+            {
+                features.push_back(entry["setting"].asString());
+            }
+        }
+        return features;
+    }
+
+    void Tunables::applySceneFeatureStep(S32 step)
+    {
+        assert_main_thread();
+        LLSD lowered = gSavedSettings.getLLSD("AutoTuneSceneFeaturesLowered");
+        if (!lowered.isArray())
+        {
+            lowered = LLSD::emptyArray();
+        }
+
+        if (step > 0)
+        {
+            // lower one feature, passing over those the user already has at or below what we'd set
+            while (lowered.size() < (S32)getSceneFeatureCount())
+            {
+                const SceneFeature& feature = SCENE_FEATURES[lowered.size()];
+                LLSD entry = LLSD().with("setting", feature.setting);
+                LLControlVariable* control = gSavedSettings.getControl(feature.setting);
+                bool lower = control && control->getValue().asInteger() > feature.loweredValue;
+                if (lower)
+                {
+                    entry["value"] = control->getValue();
+                    control->setValue((control->type() == TYPE_BOOLEAN) ? LLSD(feature.loweredValue != 0) : LLSD(feature.loweredValue));
+                    LL_INFOS("AutoTune") << "Lowered " << feature.setting << " from " << entry["value"] << LL_ENDL;
+                }
+                lowered.append(entry);
+                if (lower)
+                {
+                    break;
+                }
+            }
+        }
+        else if (step < 0)
+        {
+            // restore the last feature lowered, unless the user changed it since
+            while (lowered.size() > 0)
+            {
+                LLSD entry = lowered[lowered.size() - 1];
+                lowered.erase(lowered.size() - 1);
+                if (entry.has("value"))
+                {
+                    LLControlVariable* control = gSavedSettings.getControl(entry["setting"].asString());
+                    const SceneFeature& feature = SCENE_FEATURES[lowered.size()];
+                    if (control && control->getValue().asInteger() == feature.loweredValue)
+                    {
+                        control->setValue(entry["value"]);
+                        LL_INFOS("AutoTune") << "Restored " << feature.setting << " to " << entry["value"] << LL_ENDL;
+                    }
+                    break;
+                }
+            }
+        }
+
+        gSavedSettings.setLLSD("AutoTuneSceneFeaturesLowered", lowered);
+        sceneFeaturesLowered = lowered.size();
+    }
+
+    void Tunables::restoreSceneFeatures()
+    {
+        while (sceneFeaturesLowered > 0)
+        {
+            applySceneFeatureStep(-1);
+        }
+    }
+
     void Tunables::applyUpdates()
     {
         assert_main_thread();
@@ -92,6 +194,7 @@ namespace LLPerfStats
         if( tuningFlag & UserTargetFPS ){ gSavedSettings.setU32("TargetFPS", userTargetFPS); };
         // Note: The Max ART slider is logarithmic and thus we have an intermediate proxy value
         if( tuningFlag & UserARTCutoff ){ gSavedSettings.setF32("RenderAvatarMaxART", userARTCutoffSliderValue); };
+        if( tuningFlag & SceneFeatures ){ applySceneFeatureStep(sceneFeatureStep); };
         resetChanges();
     }
 
@@ -136,6 +239,8 @@ namespace LLPerfStats
         LLPerfStats::tunables.userFPSTuningStrategy = gSavedSettings.getU32("TuningFPSStrategy");
         LLPerfStats::tunables.userTargetFPS = gSavedSettings.getU32("TargetFPS");
         LLPerfStats::tunables.vsyncEnabled = gSavedSettings.getBOOL("RenderVSyncEnable");
+        LLPerfStats::tunables.userSceneFeatureTuning = gSavedSettings.getBOOL("AutoTuneSceneFeatures");
+        LLPerfStats::tunables.sceneFeaturesLowered = gSavedSettings.getLLSD("AutoTuneSceneFeaturesLowered").size();
 
         LLPerfStats::tunables.userAutoTuneLock = gSavedSettings.getBOOL("AutoTuneLock") && gSavedSettings.getU32("KeepAutoTuneLock");
 
@@ -462,6 +567,13 @@ namespace LLPerfStats
                                 LLPerfStats::lastGlobalPrefChange = gFrameCount;
                                 return;
                             }
+                            // then the expensive scene features, one per change
+                            if (tunables.userSceneFeatureTuning && tunables.sceneFeaturesLowered < Tunables::getSceneFeatureCount())
+                            {
+                                LLPerfStats::tunables.updateSceneFeatures(1);
+                                LLPerfStats::lastGlobalPrefChange = gFrameCount;
+                                return;
+                            }
                         }
                     }
                     // if we reach here, we've no more changes to make to tune scenery so we'll resort to agressive Avatar tuning
@@ -539,6 +651,13 @@ namespace LLPerfStats
                 }
                 if (tunables.userFPSTuningStrategy != TUNE_AVATARS_ONLY)
                 {
+                    // scene features were lowered last so they come back first
+                    if (tunables.sceneFeaturesLowered > 0)
+                    {
+                        LLPerfStats::tunables.updateSceneFeatures(-1);
+                        LLPerfStats::lastGlobalPrefChange = gFrameCount;
+                        return;
+                    }
                     if (LLPipeline::RenderFarClip < tunables.userTargetDrawDistance)
                     {
                         LLPerfStats::tunables.updateFarClip( std::min(LLPipeline::RenderFarClip + DD_STEP, tunables.userTargetDrawDistance) );
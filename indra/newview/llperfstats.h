@@ -32,6 +32,8 @@
 #include <array>
 #include <unordered_map>
 #include <mutex>
+#include <string>
+#include <vector>
 #include "lluuid.h"
 #include "llfasttimer.h"
 #include "blockingconcurrentqueue.h" // <FS:Beq/> reinstate faster queues
@@ -142,6 +144,7 @@ namespace LLPerfStats
         static constexpr U32 UserTargetFPS{512};
         static constexpr U32 UserARTCutoff{1024};
         static constexpr U32 UserAutoTuneLock{4096};
+        static constexpr U32 SceneFeatures{8192};
 
         U32 tuningFlag{0}; // bit mask for changed settings
 
@@ -160,6 +163,9 @@ namespace LLPerfStats
         F32 userARTCutoffSliderValue{0};
         bool autoTuneTimeout{true};
         bool vsyncEnabled{true};
+        bool userSceneFeatureTuning{true};
+        S32 sceneFeatureStep{0};        // 1 to lower the next scene feature, -1 to restore the last one lowered
+        U32 sceneFeaturesLowered{0};    // how far down the scene feature list autotune has gone, set from the mainthread
 
         void updateNonImposters(U32 nv){nonImpostors=nv; tuningFlag |= NonImpostors;};
         void updateReflectionDetail(S32 nv){reflectionDetail=nv; tuningFlag |= ReflectionDetail;};
@@ -173,12 +179,19 @@ namespace LLPerfStats
         void updateUserARTCutoffSlider(F32 nv){userARTCutoffSliderValue=nv; tuningFlag |= UserARTCutoff;};
         void updateUserAutoTuneEnabled(bool nv){userAutoTuneEnabled=nv; tuningFlag |= UserAutoTuneEnabled;};
         void updateUserAutoTuneLock(bool nv){userAutoTuneLock=nv; tuningFlag |= UserAutoTuneLock;};
+        void updateSceneFeatures(S32 step){sceneFeatureStep=step; tuningFlag |= SceneFeatures;};
 
         void resetChanges(){tuningFlag=Nothing;};
         void initialiseFromSettings();
         void updateRenderCostLimitFromSettings();
         void updateSettingsFromRenderCostLimit();
         void applyUpdates();
+
+        // Scene features (particles, reflections, water, shadows) autotune lowers once draw distance is at its minimum
+        static U32 getSceneFeatureCount();
+        static std::vector<std::string> getLoweredSceneFeatures();
+        void applySceneFeatureStep(S32 step);
+        void restoreSceneFeatures();
     };
 
     extern Tunables tunables;
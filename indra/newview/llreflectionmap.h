@@ -132,6 +132,15 @@ public:
     // 1 - manual probe
     U32 mPriority = 0;
 
+    // scene inside this probe's influence volume changed since its last update (see LLReflectionMapManager::markDirty)
+    bool mDirty = true;
+
+    // rough fraction of the screen this probe affects, used to rank probes for budgeted updates
+    F32 mCoverage = 0.f;
+
+    // measured GPU time in ms to render one face of this probe, -1 if not measured yet
+    F32 mFaceCost = -1.f;
+
     // occlusion culling state
     GLuint mOcclusionQuery = 0;
     bool mOccluded = false;
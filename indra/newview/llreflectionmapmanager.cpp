@@ -30,6 +30,7 @@
 
 #include <vector>
 
+#include "llgpupasstimer.h"
 #include "llviewercamera.h"
 #include "llspatialpartition.h"
 #include "llviewerregion.h"
@@ -168,6 +169,30 @@ static F32 update_score(LLReflectionMap* p)
     return gFrameTimeSeconds - p->mLastUpdateTime  - p->mDistance*0.1f;
 }
 
+// priority of a probe for budgeted updates (higher is more urgent)
+// probes that cover more of the screen go first, staleness keeps distant probes from starving
+// and incomplete probes get a head start
+static F32 schedule_score(LLReflectionMap* p)
+{
+    F32 score = p->mCoverage * (1.f + (gFrameTimeSeconds - p->mLastUpdateTime) * 0.1f);
+    if (!p->mComplete)
+    {
+        score += 4.f;
+    }
+    return score;
+}
+
+struct CompareScheduleScore
+{
+    bool operator()(LLReflectionMap* lhs, LLReflectionMap* rhs)
+    {
+        return schedule_score(lhs) > schedule_score(rhs);
+    }
+};
+
+// most faces a budgeted update renders in one frame, in case face costs are badly underestimated
+constexpr U32 MAX_BUDGETED_FACES = 12;
+
 // return true if a is higher priority for an update than b
 static bool check_priority(LLReflectionMap* a, LLReflectionMap* b)
 {
@@ -275,15 +300,35 @@ void LLReflectionMapManager::update()
 
     static LLCachedControl<S32> sDetail(gSavedSettings, "RenderReflectionProbeDetail", -1);
     static LLCachedControl<S32> sLevel(gSavedSettings, "RenderReflectionProbeLevel", 3);
+    static LLCachedControl<F32> sBudget(gSavedSettings, "RenderReflectionProbeBudgetMs", 0.f);
 
     bool realtime = sDetail >= (S32)LLReflectionMapManager::DetailLevel::REALTIME;
+    bool budgeted = sBudget > 0.f;
 
     LLReflectionMap* closestDynamic = nullptr;
 
     LLReflectionMap* oldestProbe = nullptr;
     LLReflectionMap* oldestOccluded = nullptr;
 
-    if (mUpdatingProbe != nullptr)
+    readFaceTimings();
+    mUpdateCandidates.clear();
+
+    if (budgeted)
+    { // a lighting change affects every probe
+        LLVector3 sun_dir(gPipeline.mSunDir.mV);
+        LLColor4 sun_diffuse = gPipeline.mSunDiffuse;
+        LLColor4 diffuse_delta = sun_diffuse - mLastSunDiffuse;
+        if (sun_dir * mLastSunDir < 0.9995f || diffuse_delta.magVecSquared() > 0.0001f)
+        {
+            for (auto& probe : mProbes)
+            {
+                probe->mDirty = true;
+            }
+            mLastSunDir = sun_dir;
+            mLastSunDiffuse = sun_diffuse;
+        }
+    }
+    else if (mUpdatingProbe != nullptr)
     {
         did_update = true;
         doProbeUpdate();
@@ -372,7 +417,26 @@ void LLReflectionMapManager::update()
             probe->autoAdjustOrigin();
             probe->mFadeIn = llmin((F32) (probe->mFadeIn + gFrameIntervalSeconds), 1.f);
         }
-        if (probe->mOccluded && probe->mComplete)
+
+        if (budgeted)
+        {
+            if (probe != mDefaultProbe && !probe->mOccluded &&
+                i < mReflectionProbeCount && probe->mCubeIndex != -1 &&
+                (!probe->mComplete || probe->mDirty || probe->getIsDynamic()))
+            { // probes whose surroundings haven't changed are never re-rendered
+                LLVector4a radius;
+                radius.splat(probe->mRadius);
+                F32 coverage = probe->mDistance <= 0.f ? 1.f : probe->mRadius / (probe->mRadius + probe->mDistance);
+                coverage *= coverage;
+                if (!LLViewerCamera::instance().AABBInFrustumNoFarClip(probe->mOrigin, radius))
+                { // off screen probes still light what's on screen, just less of it
+                    coverage *= 0.25f;
+                }
+                probe->mCoverage = coverage;
+                mUpdateCandidates.push_back(probe);
+            }
+        }
+        else if (probe->mOccluded && probe->mComplete)
         {
             if (oldestOccluded == nullptr)
             {
@@ -425,6 +489,14 @@ void LLReflectionMapManager::update()
     }
 
     static LLCachedControl<F32> sUpdatePeriod(gSavedSettings, "RenderDefaultProbeUpdatePeriod", 2.f);
+
+    if (budgeted)
+    {
+        bool default_due = !mDefaultProbe->mComplete || (gFrameTimeSeconds - mDefaultProbe->mLastUpdateTime) >= sUpdatePeriod;
+        doBudgetedUpdates(sBudget, default_due);
+        return;
+    }
+
     if ((gFrameTimeSeconds - mDefaultProbe->mLastUpdateTime) < sUpdatePeriod)
     {
         if (sLevel == 0)
@@ -643,7 +715,7 @@ void LLReflectionMapManager::doProbeUpdate()
     {
         if (debug_updates)
         {
-            mUpdatingProbe->mViewerObject->setDebugText(llformat("%.1f", (F32)gFrameTimeSeconds), LLColor4(1, 1, 1, 1));
+            mUpdatingProbe->mViewerObject->setDebugText(llformat("%.1f\n%.2f ms", (F32)gFrameTimeSeconds, llmax(mUpdatingProbe->mFaceCost, 0.f) * 12.f), LLColor4(1, 1, 1, 1));
         }
         updateNeighbors(mUpdatingProbe);
         mUpdatingFace = 0;
@@ -664,6 +736,156 @@ void LLReflectionMapManager::doProbeUpdate()
     }
 }
 
+void LLReflectionMapManager::doBudgetedUpdates(F32 budget_ms, bool default_due)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_DISPLAY;
+
+    std::sort(mUpdateCandidates.begin(), mUpdateCandidates.end(), CompareScheduleScore());
+
+    if (default_due && mUpdatingProbe != mDefaultProbe)
+    {
+        mUpdateCandidates.insert(mUpdateCandidates.begin(), mDefaultProbe);
+    }
+
+    // GL_TIME_ELAPSED queries can't nest with shader profiling
+    bool timed = !LLGLSLShader::sProfileEnabled;
+
+    F32 spent = 0.f;
+    U32 faces = 0;
+    auto next = mUpdateCandidates.begin();
+
+    while (faces < MAX_BUDGETED_FACES)
+    {
+        if (mUpdatingProbe == nullptr)
+        {
+            if (next == mUpdateCandidates.end())
+            {
+                break;
+            }
+
+            LLReflectionMap* probe = *next++;
+            probe->autoAdjustOrigin();
+            // changes made while the update is in progress mark the probe dirty again
+            probe->mDirty = false;
+
+            sUpdateCount++;
+            mUpdatingProbe = probe;
+        }
+
+        LLReflectionMap* probe = mUpdatingProbe;
+        F32 cost = probe->mFaceCost >= 0.f ? probe->mFaceCost : mAverageFaceCost;
+        if (faces > 0 && spent + cost > budget_ms)
+        {
+            break;
+        }
+
+        GLuint query = 0;
+        if (timed)
+        {
+            if (mFreeTimerQueries.empty())
+            {
+                glGenQueries(1, &query);
+            }
+            else
+            {
+                query = mFreeTimerQueries.back();
+                mFreeTimerQueries.pop_back();
+            }
+            glBeginQuery(GL_TIME_ELAPSED, query);
+        }
+
+        doProbeUpdate();
+
+        if (timed)
+        {
+            glEndQuery(GL_TIME_ELAPSED);
+            mFaceTimings.push_back({ query, probe });
+        }
+
+        spent += cost;
+        ++faces;
+    }
+}
+
+void LLReflectionMapManager::readFaceTimings()
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_DISPLAY;
+
+    // queries finish in order, stop at the first one that isn't ready
+    U32 done = 0;
+    for (; done < mFaceTimings.size(); ++done)
+    {
+        FaceTiming& timing = mFaceTimings[done];
+
+        GLuint available = GL_FALSE;
+        glGetQueryObjectuiv(timing.mQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+        {
+            break;
+        }
+
+        GLuint64 time_elapsed = 0;
+        glGetQueryObjectui64v(timing.mQuery, GL_QUERY_RESULT, &time_elapsed);
+        F32 cost = time_elapsed / 1000000.f;
+
+        LLReflectionMap* probe = timing.mProbe;
+        probe->mFaceCost = probe->mFaceCost < 0.f ? cost : lerp(probe->mFaceCost, cost, 0.25f);
+        mAverageFaceCost = lerp(mAverageFaceCost, cost, 0.1f);
+
+        mFreeTimerQueries.push_back(timing.mQuery);
+    }
+
+    mFaceTimings.erase(mFaceTimings.begin(), mFaceTimings.begin() + done);
+}
+
+void LLReflectionMapManager::markDirty(LLSpatialGroup* group)
+{
+    static LLCachedControl<F32> sBudget(gSavedSettings, "RenderReflectionProbeBudgetMs", 0.f);
+    if (sBudget <= 0.f)
+    {
+        return;
+    }
+
+    LLVector4a center;
+    LLVector4a size;
+
+    LLSpatialBridge* bridge = group->getSpatialPartition()->asBridge();
+    if (bridge)
+    { // bounds of groups in a bridge are in the bridge's local space, use the whole bridge instead
+        const LLVector4a* extents = bridge->getSpatialExtents();
+        center.setAdd(extents[0], extents[1]);
+        center.mul(0.5f);
+        size.setSub(extents[1], extents[0]);
+        size.mul(0.5f);
+    }
+    else
+    {
+        const LLVector4a* bounds = group->getBounds();
+        center = bounds[0];
+        size = bounds[1];
+    }
+
+    for (auto& probe : mProbes)
+    {
+        if (probe == mDefaultProbe || probe->mDirty)
+        {
+            continue;
+        }
+
+        // distance from probe origin to group's bounding box
+        LLVector4a delta;
+        delta.setSub(probe->mOrigin, center);
+        delta.setAbs(delta);
+        delta.sub(size);
+        delta.setMax(delta, LLVector4a::getZero());
+
+        if (delta.dot3(delta).getF32() <= probe->mRadius * probe->mRadius)
+        {
+            probe->mDirty = true;
+        }
+    }
+}
+
 // Do the reflection map update render passes.
 // For every 12 calls of this function, one complete reflection probe radiance map and irradiance map is generated
 // First six passes render the scene with direct lighting only into a scratch space cube map at the end of the cube map array and generate
@@ -834,6 +1056,7 @@ void LLReflectionMapManager::updateProbeFace(LLReflectionMap* probe, U32 face)
             for (int i = 0; i < mMipChain.size(); ++i)
             {
                 LL_PROFILE_GPU_ZONE("probe radiance gen");
+                LL_RECORD_GPU_PASS("probe radiance gen");
                 static LLStaticHashedString sMipLevel("mipLevel");
                 static LLStaticHashedString sRoughness("roughness");
                 static LLStaticHashedString sWidth("u_width");
@@ -890,6 +1113,7 @@ void LLReflectionMapManager::updateProbeFace(LLReflectionMap* probe, U32 face)
             {
                 int i = start_mip;
                 LL_PROFILE_GPU_ZONE("probe irradiance gen");
+                LL_RECORD_GPU_PASS("probe irradiance gen");
                 glViewport(0, 0, mMipChain[i].getWidth(), mMipChain[i].getHeight());
                 for (int cf = 0; cf < 6; ++cf)
                 { // for each cube face
@@ -1486,6 +1710,18 @@ void LLReflectionMapManager::cleanup()
     glDeleteBuffers(1, &mUBO);
     mUBO = 0;
 
+    mUpdateCandidates.clear();
+    for (auto& timing : mFaceTimings)
+    {
+        mFreeTimerQueries.push_back(timing.mQuery);
+    }
+    mFaceTimings.clear();
+    if (!mFreeTimerQueries.empty())
+    {
+        glDeleteQueries((GLsizei)mFreeTimerQueries.size(), mFreeTimerQueries.data());
+        mFreeTimerQueries.clear();
+    }
+
     // note: also called on teleport (not just shutdown), so make sure we're in a good "starting" state
     initCubeFree();
 }
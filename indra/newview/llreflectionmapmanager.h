@@ -109,6 +109,10 @@ public:
     // perform occlusion culling on all active reflection probes
     void doOcclusion();
 
+    // note that geometry in group changed so probes whose influence volume overlaps it are updated again
+    // only tracked when updates are budgeted (RenderReflectionProbeBudgetMs)
+    void markDirty(LLSpatialGroup* group);
+
     // *HACK: "cull" all reflection probes except the default one. Only call
     // this if you don't intend to call updateUniforms directly. Call again
     // with false when done.
@@ -158,6 +162,13 @@ private:
     // perform an update on the currently updating Probe
     void doProbeUpdate();
 
+    // update faces of the highest priority probes in mUpdateCandidates until budget_ms of GPU time is spent
+    // default_due -- true if the default probe should be updated first
+    void doBudgetedUpdates(F32 budget_ms, bool default_due);
+
+    // collect finished face timer queries into each probe's mFaceCost
+    void readFaceTimings();
+
     // update the specified face of the specified probe
     void updateProbeFace(LLReflectionMap* probe, U32 face);
 
@@ -210,5 +221,24 @@ private:
     // if true, only update the default probe
     bool mPaused = false;
     F32 mResumeTime = 0.f;
+
+    // probes that need an update this frame when updates are budgeted
+    std::vector<LLReflectionMap*> mUpdateCandidates;
+
+    // GPU timer queries for face renders that haven't been read back yet
+    struct FaceTiming
+    {
+        GLuint mQuery = 0;
+        LLPointer<LLReflectionMap> mProbe;
+    };
+    std::vector<FaceTiming> mFaceTimings;
+    std::vector<GLuint> mFreeTimerQueries;
+
+    // running average of measured face cost in ms, used for probes that haven't been measured yet
+    F32 mAverageFaceCost = 1.f;
+
+    // lighting the probes were last marked dirty for, a change marks every probe dirty
+    LLVector3 mLastSunDir;
+    LLColor4 mLastSunDiffuse;
 };
 
@@ -0,0 +1,257 @@
+/**
+ * @file llregionprefetch.cpp
+ * @brief Records the assets needed on arrival in a region and prefetches them on the next login
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llregionprefetch.h"
+
+#include "llappviewer.h"
+#include "llcallbacklist.h"
+#include "lldir.h"
+#include "llfilesystem.h"
+#include "llsdserialize.h"
+#include "llsdutil.h"
+#include "llviewercontrol.h"
+#include "llviewernetwork.h"
+#include "llviewertexture.h"
+#include "llviewertexturelist.h"
+#include "workqueue.h"
+
+// Pixel area given to the first texture of a manifest, later ones get less so the
+// fetcher works through them in the recorded order
+static const F32 PREFETCH_TOP_AREA = 512.f * 512.f;
+static const F32 PREFETCH_MIN_AREA = 64.f * 64.f;
+
+LLRegionPrefetch::LLRegionPrefetch()
+{
+}
+
+LLRegionPrefetch::~LLRegionPrefetch()
+{
+}
+
+void LLRegionPrefetch::startRecording(U64 region_handle)
+{
+    finishRecording();
+
+    static LLCachedControl<bool> enabled(gSavedSettings, "RegionPrefetchEnable", true);
+    static LLCachedControl<F32> seconds(gSavedSettings, "RegionPrefetchRecordSeconds", 30.f);
+    if (!enabled || seconds <= 0.f)
+    {
+        return;
+    }
+
+    mRegionHandle = region_handle;
+    mRecording = true;
+    U32 generation = ++mGeneration;
+    doAfterInterval([this, generation]()
+                    {
+                        if (generation == mGeneration)
+                        {
+                            finishRecording();
+                        }
+                    }, seconds);
+}
+
+void LLRegionPrefetch::noteTexture(const LLUUID& id)
+{
+    note(id, LLAssetType::AT_TEXTURE);
+}
+
+void LLRegionPrefetch::noteMesh(const LLUUID& id)
+{
+    note(id, LLAssetType::AT_MESH);
+}
+
+void LLRegionPrefetch::note(const LLUUID& id, LLAssetType::EType type)
+{
+    static LLCachedControl<U32> max_assets(gSavedSettings, "RegionPrefetchMaxAssets", 1000);
+    if (!mRecording || mPrefetching || id.isNull() || mRecorded.size() >= max_assets)
+    {
+        return;
+    }
+    if (mRecordedIDs.insert(id).second)
+    {
+        mRecorded.push_back({ id, type });
+    }
+}
+
+void LLRegionPrefetch::finishRecording()
+{
+    if (!mRecording)
+    {
+        return;
+    }
+    mRecording = false;
+
+    // Textures we prefetched already existed when the region asked for them, so they were
+    // never noted; keep the ones that got used ahead of the new ones
+    LLSD manifest = LLSD::emptyArray();
+    if (mPrefetchedHandle == mRegionHandle)
+    {
+        for (const LLUUID& id : mPrefetched)
+        {
+            LLViewerFetchedTexture* image = gTextureList.findImage(id, TEX_LIST_STANDARD);
+            if (image && image->getBoundRecently() && mRecordedIDs.insert(id).second)
+            {
+                LLSD entry;
+                entry["uuid"] = id;
+                entry["type"] = LLAssetType::lookup(LLAssetType::AT_TEXTURE);
+                manifest.append(entry);
+            }
+        }
+        mPrefetched.clear();
+        mPrefetchedHandle = 0;
+    }
+    for (const Asset& asset : mRecorded)
+    {
+        LLSD entry;
+        entry["uuid"] = asset.mID;
+        entry["type"] = LLAssetType::lookup(asset.mType);
+        manifest.append(entry);
+    }
+    mRecorded.clear();
+    mRecordedIDs.clear();
+
+    if (manifest.size() == 0 || gDirUtilp->getExpandedFilename(LL_PATH_CACHE, "").empty())
+    {
+        return;
+    }
+
+    std::string filename = getManifestName(mRegionHandle);
+    llofstream file(filename.c_str());
+    if (!file.is_open())
+    {
+        LL_WARNS("RegionPrefetch") << "Could not write " << filename << LL_ENDL;
+        return;
+    }
+    LLSDSerialize::toXML(manifest, file);
+    LL_DEBUGS("RegionPrefetch") << "Recorded " << manifest.size() << " assets for region " << mRegionHandle << LL_ENDL;
+}
+
+void LLRegionPrefetch::prefetch(U64 region_handle)
+{
+    static LLCachedControl<bool> enabled(gSavedSettings, "RegionPrefetchEnable", true);
+    if (!enabled || LLAppViewer::instance()->getPurgeCache())
+    {
+        return;
+    }
+
+    LLSD manifest;
+    std::string filename = getManifestName(region_handle);
+    llifstream file(filename.c_str());
+    if (!file.is_open())
+    {
+        return;
+    }
+    if (LLSDSerialize::fromXML(manifest, file) <= 0 || !manifest.isArray())
+    {
+        file.close();
+        LL_WARNS("RegionPrefetch") << "Removing invalid manifest " << filename << LL_ENDL;
+        LLFile::remove(filename);
+        return;
+    }
+    file.close();
+
+    std::vector<LLUUID> textures;
+    std::vector<LLUUID> meshes;
+    for (const LLSD& entry : llsd::inArray(manifest))
+    {
+        LLUUID id = entry["uuid"].asUUID();
+        LLAssetType::EType type = LLAssetType::lookup(entry["type"].asString());
+        if (id.isNull())
+        {
+            continue;
+        }
+        if (type == LLAssetType::AT_TEXTURE && !LLViewerTexture::isInvisiprim(id))
+        {
+            textures.push_back(id);
+        }
+        else if (type == LLAssetType::AT_MESH)
+        {
+            meshes.push_back(id);
+        }
+    }
+
+    // the cache reads come first, they are what the fetches below wait on
+    if (!meshes.empty())
+    {
+        auto queue = LL::WorkQueue::getInstance("General");
+        if (queue)
+        {
+            queue->post([meshes]() { warmMeshes(meshes); });
+        }
+    }
+
+    mPrefetching = true;
+    for (size_t i = 0; i < textures.size(); ++i)
+    {
+        LLViewerFetchedTexture* image = LLViewerTextureManager::getFetchedTexture(textures[i], FTT_DEFAULT, MIPMAP_TRUE,
+                                                                                 LLGLTexture::BOOST_NONE, LLViewerTexture::LOD_TEXTURE);
+        if (image)
+        {
+            F32 area = PREFETCH_TOP_AREA * (F32)(textures.size() - i) / (F32)textures.size();
+            image->addTextureStats(llmax(area, PREFETCH_MIN_AREA));
+        }
+    }
+    mPrefetching = false;
+
+    mPrefetched = std::move(textures);
+    mPrefetchedHandle = region_handle;
+    LL_INFOS("RegionPrefetch") << "Prefetching " << mPrefetched.size() << " textures and " << meshes.size()
+                               << " meshes for region " << region_handle << LL_ENDL;
+}
+
+// static
+void LLRegionPrefetch::warmMeshes(const std::vector<LLUUID>& ids)
+{
+    std::vector<U8> buffer;
+    for (const LLUUID& id : ids)
+    {
+        if (LLApp::isExiting())
+        {
+            return;
+        }
+        LLFileSystem file(id, LLAssetType::AT_MESH);
+        S32 size = file.getSize();
+        if (size > 0)
+        {
+            buffer.resize(size);
+            file.read(buffer.data(), size);
+        }
+    }
+}
+
+// static
+std::string LLRegionPrefetch::getManifestName(U64 region_handle)
+{
+    std::string name = llformat("region_prefetch_%llu.", (unsigned long long)region_handle) + gDirUtilp->getUserName();
+    if (!LLGridManager::getInstance()->isInSLMain())
+    {
+        name += "." + utf8str_tolower(LLGridManager::getInstance()->getGridId());
+    }
+    return gDirUtilp->getExpandedFilename(LL_PATH_CACHE, name + ".xml");
+}
@@ -0,0 +1,84 @@
+/**
+ * @file llregionprefetch.h
+ * @brief Records the assets needed on arrival in a region and prefetches them on the next login
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#pragma once
+
+#include "llassettype.h"
+#include "llsingleton.h"
+#include "lluuid.h"
+
+#include <unordered_set>
+#include <vector>
+
+// Logging in to the last location fetches the same textures and meshes as last time, in
+// whatever order objects happen to arrive.  While recording, the first
+// RegionPrefetchRecordSeconds after arrival in a region, we note every texture and mesh
+// requested, in order, and save that as the region's manifest in the cache directory.
+//
+// On the next login to that region prefetch() runs once caps are granted, while startup
+// is still busy with inventory: textures are requested in the recorded order, highest
+// priority first, and the cached mesh files are read ahead on the General work queue.
+// Meshes can only be requested over HTTP once an object needs them, so for those we
+// only warm the disk cache.
+class LLRegionPrefetch : public LLSingleton<LLRegionPrefetch>
+{
+    LLSINGLETON(LLRegionPrefetch);
+    ~LLRegionPrefetch();
+
+public:
+    // Start recording on arrival in a region, saving whatever was recorded before
+    void startRecording(U64 region_handle);
+
+    void noteTexture(const LLUUID& id);
+    void noteMesh(const LLUUID& id);
+
+    // Request what the manifest of region_handle lists
+    void prefetch(U64 region_handle);
+
+private:
+    struct Asset
+    {
+        LLUUID mID;
+        LLAssetType::EType mType;
+    };
+
+    void note(const LLUUID& id, LLAssetType::EType type);
+    void finishRecording();
+
+    static std::string getManifestName(U64 region_handle);
+    static void warmMeshes(const std::vector<LLUUID>& ids);
+
+    U64 mRegionHandle = 0;
+    bool mRecording = false;
+    U32 mGeneration = 0;            // tells a stale end of recording timer from the current one
+    std::vector<Asset> mRecorded;
+    std::unordered_set<LLUUID> mRecordedIDs;
+
+    // Textures we prefetched for mRegionHandle, kept in the manifest if they were used
+    std::vector<LLUUID> mPrefetched;
+    U64 mPrefetchedHandle = 0;
+    bool mPrefetching = false;
+};
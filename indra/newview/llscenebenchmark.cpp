@@ -0,0 +1,253 @@
+/**
+ * @file llscenebenchmark.cpp
+ * @brief Reproducible scene benchmark run from the command line
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llscenebenchmark.h"
+
+#include "llagent.h"
+#include "llagentpilot.h"
+#include "llappviewer.h"
+#include "lldir.h"
+#include "llfile.h"
+#include "llgl.h"
+#include "llgpupasstimer.h"
+#include "llmemtag.h"
+#include "llmeshrepository.h"
+#include "llsdserialize.h"
+#include "llsdutil_math.h"
+#include "llstartup.h"
+#include "lltexturefetch.h"
+#include "llversioninfo.h"
+#include "llviewercontrol.h"
+#include "llviewerregion.h"
+#include "llviewerstatsrecorder.h"
+
+#include <algorithm>
+
+// downloads still in flight that we count as a quiet scene
+static const S32 QUIET_MAX_REQUESTS = 2;
+
+LLSceneBenchmark::LLSceneBenchmark()
+:   mName(gSavedSettings.getString("BenchmarkName"))
+{
+    LL_INFOS("Benchmark") << "Benchmark '" << mName << "' waiting for login" << LL_ENDL;
+}
+
+LLSceneBenchmark::~LLSceneBenchmark()
+{
+}
+
+// static
+bool LLSceneBenchmark::requested()
+{
+    return !gSavedSettings.getString("BenchmarkName").empty();
+}
+
+void LLSceneBenchmark::idle()
+{
+    static LLCachedControl<F32> settle_seconds(gSavedSettings, "BenchmarkSettleSeconds", 5.f);
+    static LLCachedControl<F32> settle_timeout(gSavedSettings, "BenchmarkSettleTimeout", 120.f);
+    static LLCachedControl<F32> run_seconds(gSavedSettings, "BenchmarkSeconds", 30.f);
+
+    switch (mState)
+    {
+    case WAITING_FOR_LOGIN:
+        if (LLStartUp::getStartupState() == STATE_STARTED && gAgent.getRegion())
+        {
+            LL_INFOS("Benchmark") << "Logged in, waiting for the scene to settle" << LL_ENDL;
+            // object updates while the scene loads are part of what we compare
+            LLViewerStatsRecorder::instance().enableObjectStatsRecording(true, true);
+            mState = SETTLING;
+            mStateTimer.reset();
+            mQuietTimer.reset();
+        }
+        break;
+
+    case SETTLING:
+        if (!isSceneQuiet())
+        {
+            mQuietTimer.reset();
+        }
+        if (mQuietTimer.getElapsedTimeF32() >= settle_seconds || mStateTimer.getElapsedTimeF32() >= settle_timeout)
+        {
+            mSettled = mQuietTimer.getElapsedTimeF32() >= settle_seconds;
+            mSettleSeconds = mStateTimer.getElapsedTimeF32();
+            if (!mSettled)
+            {
+                LL_WARNS("Benchmark") << "Scene still loading after " << mSettleSeconds << " seconds, starting anyway" << LL_ENDL;
+            }
+            startRun();
+        }
+        break;
+
+    case RUNNING:
+        recordFrame();
+        if (mFlyingPath ? !gAgentPilot.isPlaying() : mStateTimer.getElapsedTimeF32() >= run_seconds)
+        {
+            finishRun();
+        }
+        break;
+
+    case DONE:
+        break;
+    }
+}
+
+bool LLSceneBenchmark::isSceneQuiet() const
+{
+    S32 requests = LLMeshRepoThread::sActiveHeaderRequests + LLMeshRepoThread::sActiveLODRequests + (S32)LLMeshRepository::sLODPending;
+    if (LLAppViewer::getTextureFetch())
+    {
+        requests += LLAppViewer::getTextureFetch()->getNumRequests();
+    }
+    return requests <= QUIET_MAX_REQUESTS;
+}
+
+void LLSceneBenchmark::startRun()
+{
+    mState = RUNNING;
+    mStateTimer.reset();
+    mFrameMs.clear();
+    mStartRSS = mPeakRSS = LLMemory::getCurrentRSS();
+    LLGPUPassTimer::setRequested(true);
+
+    // the path loaded from StatsPilotXMLFile at login, once through
+    gAgentPilot.setLoop(false);
+    gAgentPilot.startPlayback();
+    mFlyingPath = gAgentPilot.isPlaying();
+
+    LL_INFOS("Benchmark") << "Scene settled after " << mSettleSeconds << " seconds, "
+                          << (mFlyingPath ? "flying the recorded camera path" : "no camera path, standing still")
+                          << LL_ENDL;
+}
+
+void LLSceneBenchmark::recordFrame()
+{
+    mFrameMs.push_back(F32Milliseconds(gFrameIntervalSeconds).value());
+    // the RSS is a system call, once a second is plenty
+    if (mFrameMs.size() % 60 == 0)
+    {
+        mPeakRSS = llmax(mPeakRSS, LLMemory::getCurrentRSS());
+    }
+}
+
+void LLSceneBenchmark::finishRun()
+{
+    mRunSeconds = mStateTimer.getElapsedTimeF32();
+    mPeakRSS = llmax(mPeakRSS, LLMemory::getCurrentRSS());
+    mState = DONE;
+
+    writeReport();
+
+    LLViewerStatsRecorder::instance().enableObjectStatsRecording(false);
+    LLGPUPassTimer::setRequested(false);
+
+    if (gSavedSettings.getBOOL("BenchmarkQuit"))
+    {
+        LL_INFOS("Benchmark") << "Benchmark done, quitting" << LL_ENDL;
+        LLAppViewer::instance()->forceQuit();
+    }
+}
+
+void LLSceneBenchmark::writeReport()
+{
+    LLSD report;
+    report["name"] = mName;
+    report["version"] = LLVersionInfo::instance().getChannelAndVersion();
+    report["gpu"] = gGLManager.getRawGLString();
+    report["graphics_level"] = (LLSD::Integer)gSavedSettings.getU32("RenderQualityPerformance");
+    if (gAgent.getRegion())
+    {
+        report["region"] = gAgent.getRegion()->getName();
+    }
+    report["position"] = ll_sd_from_vector3(gAgent.getPositionAgent());
+    report["settled"] = mSettled;
+    report["settle_seconds"] = mSettleSeconds;
+    report["camera_path"] = mFlyingPath;
+    report["seconds"] = mRunSeconds;
+    report["frames"] = (LLSD::Integer)mFrameMs.size();
+
+    if (!mFrameMs.empty())
+    {
+        std::vector<F32> sorted(mFrameMs);
+        std::sort(sorted.begin(), sorted.end());
+        auto percentile = [&sorted](F32 p)
+        {
+            return sorted[llmin((size_t)(p * sorted.size()), sorted.size() - 1)];
+        };
+
+        F64 total_ms = 0.0;
+        for (F32 ms : sorted)
+        {
+            total_ms += ms;
+        }
+
+        LLSD& frame_ms = report["frame_ms"];
+        frame_ms["mean"] = total_ms / sorted.size();
+        frame_ms["p50"] = percentile(0.5f);
+        frame_ms["p90"] = percentile(0.9f);
+        frame_ms["p95"] = percentile(0.95f);
+        frame_ms["p99"] = percentile(0.99f);
+        frame_ms["max"] = sorted.back();
+        report["fps"] = total_ms > 0.0 ? sorted.size() * 1000.0 / total_ms : 0.0;
+    }
+
+    LLSD& memory = report["memory_kb"];
+    memory["start"] = (LLSD::Integer)(mStartRSS / 1024);
+    memory["peak"] = (LLSD::Integer)(mPeakRSS / 1024);
+    memory["end"] = (LLSD::Integer)(LLMemory::getCurrentRSS() / 1024);
+    for (U32 i = 0; i < LLMemTag::getTagCount(); ++i)
+    {
+        const LLMemTag* tag = LLMemTag::getTag(i);
+        memory["tags"][tag->getName()] = (LLSD::Integer)(tag->getBytes() / 1024);
+    }
+
+    LLSD& passes = report["gpu_pass_ms"];
+    passes = LLSD::emptyArray();
+    for (const LLGPUPassTimer::Pass& pass : LLGPUPassTimer::getPasses())
+    {
+        LLSD entry;
+        entry["name"] = pass.mName;
+        entry["depth"] = (LLSD::Integer)pass.mDepth;
+        entry["ms"] = pass.mMs;
+        passes.append(entry);
+    }
+
+    std::string filename = gDirUtilp->getExpandedFilename(LL_PATH_LOGS,
+        llformat("benchmark_%s_%llu.xml", LLDir::getScrubbedFileName(mName).c_str(),
+                 (unsigned long long)(LLTimer::getTotalTime() / 1000000)));
+    llofstream out(filename.c_str());
+    if (!out.is_open())
+    {
+        LL_WARNS("Benchmark") << "Could not write " << filename << LL_ENDL;
+        return;
+    }
+    LLSDSerialize::toPrettyXML(report, out);
+
+    LL_INFOS("Benchmark") << "Benchmark '" << mName << "': " << mFrameMs.size() << " frames in " << mRunSeconds
+                          << " seconds, report written to " << filename << LL_ENDL;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file llscenebenchmark.h
+ * @brief Reproducible scene benchmark run from the command line
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#pragma once
+
+#include "llsingleton.h"
+#include "lltimer.h"
+
+#include <string>
+#include <vector>
+
+// Benchmark mode, for comparing builds on the same scene:
+//
+//     firestorm --autologin --benchmark <name> [--set StatsPilotXMLFile <path>] <SLURL>
+//
+// After login it waits until texture and mesh downloads have been quiet for
+// BenchmarkSettleSeconds (or BenchmarkSettleTimeout ran out), then flies the camera path
+// recorded with Advanced > Recorder into StatsPilotXMLFile, or stands still for
+// BenchmarkSeconds without one.  Frame times, memory and GPU pass times of the run are
+// written to benchmark_<name>_<time>.xml in the logs directory, the object update stats of
+// LLViewerStatsRecorder to their usual file, then the viewer quits unless BenchmarkQuit is
+// off.
+class LLSceneBenchmark : public LLSingleton<LLSceneBenchmark>
+{
+    LLSINGLETON(LLSceneBenchmark);
+    ~LLSceneBenchmark();
+
+public:
+    // Started from LLAppViewer::init() when --benchmark names a run
+    static bool requested();
+
+    // Called once a frame from LLAppViewer::idle()
+    void idle();
+
+private:
+    enum EState
+    {
+        WAITING_FOR_LOGIN,
+        SETTLING,
+        RUNNING,
+        DONE
+    };
+
+    bool isSceneQuiet() const;
+    void startRun();
+    void recordFrame();
+    void finishRun();
+    void writeReport();
+
+    EState mState = WAITING_FOR_LOGIN;
+    std::string mName;
+    LLTimer mStateTimer;
+    LLTimer mQuietTimer;
+    bool mSettled = false;
+    bool mFlyingPath = false;
+    F32 mSettleSeconds = 0.f;
+    F32 mRunSeconds = 0.f;
+
+    std::vector<F32> mFrameMs;
+    U64 mStartRSS = 0;
+    U64 mPeakRSS = 0;
+};
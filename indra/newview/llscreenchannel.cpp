@@ -42,6 +42,7 @@
 #include "llfloaterimsession.h"
 #include "llscriptfloater.h"
 #include "llrootview.h"
+#include "llcallbacklist.h"
 
 #include <algorithm>
 
@@ -592,6 +593,28 @@ void LLScreenChannel::modifyToastByNotificationID(LLUUID id, LLPanel* panel)
 //--------------------------------------------------------------------------
 void LLScreenChannel::redrawToasts()
 {
+    // a burst of notifications adds and fades many toasts per frame, arrange them once
+    if (mRedrawPending)
+    {
+        return;
+    }
+    mRedrawPending = true;
+
+    LLHandle<LLScreenChannel> handle = getDerivedHandle<LLScreenChannel>();
+    doOnIdleOneTime([handle]()
+        {
+            if (LLScreenChannel* channel = handle.get())
+            {
+                channel->mRedrawPending = false;
+                channel->arrangeToasts();
+            }
+        });
+}
+
+//--------------------------------------------------------------------------
+void LLScreenChannel::arrangeToasts()
+{
+    LL_PROFILE_ZONE_SCOPED;
     if (!getParent())
     {
         // connect to floater snap region just to get resize events, we don't care about being a proper widget
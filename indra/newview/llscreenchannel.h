@@ -196,7 +196,7 @@ public:
 
     // removes all toasts from a channel
     void        removeToastsFromChannel();
-    // show all toasts in a channel
+    // show all toasts in a channel, laid out once per frame however often this is called
     void        redrawToasts();
     //
     void        loadStoredToastsToChannel();
@@ -284,6 +284,10 @@ private:
     // send signal to observers about destroying of a toast, update channel's Hovering state, close the toast
     void    deleteToast(LLToast* toast);
 
+    // lay out the toasts right away, see redrawToasts()
+    void    arrangeToasts();
+    bool    mRedrawPending = false;
+
     // show-functions depending on allignment of toasts
     void    showToastsBottom();
     void    showToastsCentre();
@@ -172,6 +172,9 @@ void LLScriptEditor::loadKeywords()
     {
         insert_it = mSegments.insert(insert_it, *list_it);
     }
+    mSegmentsFont = getFont();
+    mDirtyStart = S32_MAX;
+    mDirtyEnd = -1;
 }
 
 // <FS:Ansariel> Re-add legacy format support
@@ -199,6 +202,9 @@ void LLScriptEditor::loadKeywords(const std::string& filename,
         {
             insert_it = mSegments.insert(insert_it, *list_it);
         }
+        mSegmentsFont = getFont();
+        mDirtyStart = S32_MAX;
+        mDirtyEnd = -1;
     }
 }
 // </FS:Ansariel>
@@ -215,24 +221,80 @@ void LLScriptEditor::updateSegments()
 
         // HACK:  No non-ascii keywords for now
         segment_vec_t segment_list;
-        mKeywords.findSegments(&segment_list, getWText(), *this, style);
+        const LLWString& wtext = getWText();
+        if (mDirtyEnd >= 0 && mSegmentsFont == getFont())
+        {
+            // Only color the lines that changed, from the last line break before them that
+            // no token ran across, on until the old segments agree again.  Typing in a
+            // long script no longer goes over all of it on every key press.
+            S32 start = 0;
+            size_t line_break = mDirtyStart > 0 ? wtext.rfind('\n', mDirtyStart - 1) : LLWString::npos;
+            while (line_break != LLWString::npos)
+            {
+                if (isLexBreak((S32)line_break))
+                {
+                    start = (S32)line_break + 1;
+                    break;
+                }
+                line_break = line_break > 0 ? wtext.rfind('\n', line_break - 1) : LLWString::npos;
+            }
+
+            mKeywords.findSegments(&segment_list, wtext, *this, style, start, mDirtyEnd,
+                                   [this](S32 pos) { return isLexBreak(pos); });
+        }
+        else
+        {
+            mKeywords.findSegments(&segment_list, wtext, *this, style);
+            clearSegments();
+        }
 
-        clearSegments();
         for (segment_vec_t::iterator list_it = segment_list.begin(); list_it != segment_list.end(); ++list_it)
         {
             insertSegment(*list_it);
         }
+        mSegmentsFont = getFont();
+        mDirtyStart = S32_MAX;
+        mDirtyEnd = -1;
     }
 
     LLTextBase::updateSegments();
 }
 
+void LLScriptEditor::onValueChange(S32 start, S32 end)
+{
+    LLTextEditor::onValueChange(start, end);
+
+    // an earlier change after this one moved along with the text
+    S32 length = getLength();
+    if (mDirtyEnd > start)
+    {
+        mDirtyEnd = llmax(mDirtyEnd + length - mDirtyLength, start);
+    }
+    mDirtyStart = llmin(mDirtyStart, start);
+    mDirtyEnd = llmax(mDirtyEnd, end);
+    mDirtyLength = length;
+}
+
+// True if the line break at pos was colored outside of any token, so that coloring can
+// start right after it or stop at it
+bool LLScriptEditor::isLexBreak(S32 pos) const
+{
+    segment_set_t::const_iterator seg_iter = getSegIterContaining(pos);
+    if (seg_iter == mSegments.end())
+    {
+        return false;
+    }
+    const LLTextSegmentPtr& segment = *seg_iter;
+    return segment->getStart() == pos && segment->getEnd() == pos + 1 && !segment->getToken();
+}
+
 void LLScriptEditor::clearSegments()
 {
     if (!mSegments.empty())
     {
         mSegments.clear();
     }
+    mSegmentsFont = nullptr;
 }
 
 // Most of this is shamelessly copied from LLTextBase
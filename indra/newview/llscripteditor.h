@@ -77,6 +77,8 @@ protected:
 private:
     void    drawLineNumbers();
     /* virtual */ void  updateSegments();
+    /* virtual */ void  onValueChange(S32 start, S32 end);
+    bool    isLexBreak(S32 pos) const;
     /* virtual */ void  drawSelectionBackground();
     // <FS:Ansariel> Doesn't exist
     //void  loadKeywords(const std::string& filename_keywords,
@@ -88,6 +90,12 @@ private:
     LLKeywords  mKeywords;
     bool        mShowLineNumbers;
     bool mUseDefaultFontSize;
+
+    // Text changed since the segments were last updated, see onValueChange()
+    S32         mDirtyStart = S32_MAX;
+    S32         mDirtyEnd = -1;
+    S32         mDirtyLength = 0;
+    const LLFontGL* mSegmentsFont = nullptr;
 };
 
 #endif // LL_SCRIPTEDITOR_H
@@ -654,7 +654,6 @@ LLObjectSelectionHandle LLSelectMgr::selectObjectAndFamily(const std::vector<LLV
         if (!canSelectObject(object)) continue;
 
         object->addThisAndNonJointChildren(objects);
-        addAsFamily(objects);
 
         if( isBatchMode() )
             continue;
@@ -666,6 +665,7 @@ LLObjectSelectionHandle LLSelectMgr::selectObjectAndFamily(const std::vector<LLV
         //object->setAngularVelocity(LLVector3::zero);
         object->resetRot();
     }
+    addAsFamily(objects);
 
     if( isBatchMode() )
     {
@@ -1397,12 +1397,6 @@ LLObjectSelectionHandle LLSelectMgr::selectHighlightedObjects()
         objectp->setAllTESelected(true);
 
         mSelectedObjects->mSelectType = getSelectTypeForObject(objectp);
-
-        // request properties on root objects
-        if (objectp->isRootEdit())
-        {
-            requestObjectPropertiesFamily(objectp);
-        }
     }
 
     // pack up messages to let sim know these objects are selected
@@ -3314,6 +3308,16 @@ void LLSelectMgr::adjustTexturesByScale(bool send_to_sim, bool stretch)
                     }
 
                     LLFetchedGLTFMaterial* render_mat = (LLFetchedGLTFMaterial*)tep->getGLTFRenderMaterial();
+                    if (render_mat && gGLTFMaterialList.isInterned(render_mat))
+                    { // other faces share this one, edit a copy of our own
+                        render_mat = new LLFetchedGLTFMaterial(*render_mat);
+                        tep->setGLTFRenderMaterial(render_mat);
+                        if (object->mDrawable.notNull())
+                        {
+                            gPipeline.markTextured(object->mDrawable);
+                            gPipeline.markRebuild(object->mDrawable, LLDrawable::REBUILD_ALL);
+                        }
+                    }
                     if (render_mat)
                     {
                         render_mat->applyOverride(*material);
@@ -6120,17 +6124,9 @@ void LLSelectMgr::processObjectProperties(LLMessageSystem* msg, void** user_data
         }
 
 
-        // Iterate through nodes at end, since it can be on both the regular AND hover list
-        struct f : public LLSelectedNodeFunctor
-        {
-            LLUUID mID;
-            f(const LLUUID& id) : mID(id) {}
-            virtual bool apply(LLSelectNode* node)
-            {
-                return (node->getObject() && node->getObject()->mID == mID);
-            }
-        } func(id);
-        LLSelectNode* node = LLSelectMgr::getInstance()->getSelection()->getFirstNode(&func);
+        // Look the node up rather than search the selection, a linkset replies with a block per prim
+        LLViewerObject* objectp = gObjectList.findObject(id);
+        LLSelectNode* node = objectp ? LLSelectMgr::getInstance()->getSelection()->findNode(objectp) : NULL;
 
         if (!node)
         {
@@ -8046,6 +8042,7 @@ void LLObjectSelection::cleanupNodes()
         LLSelectNode* node = *curiter;
         if (node->getObject() == NULL || node->getObject()->isDead())
         {
+            mListPositions.erase(node);
             mList.erase(curiter);
             delete node;
         }
@@ -8102,7 +8099,9 @@ void LLObjectSelection::addNode(LLSelectNode *nodep)
     }
     // </FS:Zi>
 
+    eraseNode(nodep);
     mList.push_front(nodep);
+    mListPositions[nodep] = mList.begin();
     mSelectNodeMap[nodep->getObject()] = nodep;
 }
 
@@ -8116,14 +8115,27 @@ void LLObjectSelection::addNodeAtEnd(LLSelectNode *nodep)
     }
     // </FS:Zi>
 
+    eraseNode(nodep);
     mList.push_back(nodep);
+    mListPositions[nodep] = std::prev(mList.end());
     mSelectNodeMap[nodep->getObject()] = nodep;
 }
 
 void LLObjectSelection::moveNodeToFront(LLSelectNode *nodep)
 {
-    mList.remove(nodep);
+    eraseNode(nodep);
     mList.push_front(nodep);
+    mListPositions[nodep] = mList.begin();
+}
+
+void LLObjectSelection::eraseNode(LLSelectNode* nodep)
+{
+    auto found_it = mListPositions.find(nodep);
+    if (found_it != mListPositions.end())
+    {
+        mList.erase(found_it->second);
+        mListPositions.erase(found_it);
+    }
 }
 
 void LLObjectSelection::removeNode(LLSelectNode *nodep)
@@ -8134,13 +8146,14 @@ void LLObjectSelection::removeNode(LLSelectNode *nodep)
         mPrimaryObject = NULL;
     }
     nodep->setObject(NULL); // Will get erased in cleanupNodes()
-    mList.remove(nodep);
+    eraseNode(nodep);
 }
 
 void LLObjectSelection::deleteAllNodes()
 {
     std::for_each(mList.begin(), mList.end(), DeletePointer());
     mList.clear();
+    mListPositions.clear();
     mSelectNodeMap.clear();
     mPrimaryObject = NULL;
 
@@ -47,6 +47,7 @@
 #include "lluicolor.h"
 
 #include <deque>
+#include <unordered_map>
 #include <boost/iterator/filter_iterator.hpp>
 #include <boost/signals2.hpp>
 
@@ -430,7 +431,11 @@ private:
 
 
 private:
+    void eraseNode(LLSelectNode* nodep);
+
     list_t mList;
+    // where each node sits in mList, so large selections don't search the list on every removal
+    std::unordered_map<LLSelectNode*, list_t::iterator> mListPositions;
     const LLObjectSelection &operator=(const LLObjectSelection &);
 
     LLPointer<LLViewerObject> mPrimaryObject;
@@ -33,6 +33,11 @@
 #include "llmeshrepository.h"
 #include "llvolume.h"
 #include "llrigginginfo.h"
+#include "llmatrix4akernels.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
 
 #define DEBUG_SKINNING  LL_DEBUG
 
@@ -173,16 +178,7 @@ void LLSkinningUtil::initSkinningMatrixPalette(
         }
     }
 
-    //NOTE: pointer striders used here as a micro-optimization over vector/array lookups
-    const LLMatrix4a* invBind = &(skin->mInvBindMatrix[0]);
-    const LLMatrix4a* w = world;
-    LLMatrix4a* m = mat;
-    LLMatrix4a* end = m + count;
-
-    while (m < end)
-    {
-        matMulUnsafe(*(invBind++), *(w++), *(m++));
-    }
+    LLMatrix4aKernels::matMulArray(&skin->mInvBindMatrix[0], world, mat, count);
 }
 
 void LLSkinningUtil::checkSkinWeights(LLVector4a* weights, U32 num_vertices, const LLMeshSkinInfo* skin)
@@ -443,6 +439,148 @@ LLQuaternion LLSkinningUtil::getUnscaledQuaternion(const LLMatrix4& mat4)
     return bind_rot;
 }
 
+namespace
+{
+#if defined(__AVX2__)
+    constexpr S32 SKIN_BATCH = 8;
+#else
+    constexpr S32 SKIN_BATCH = 4;
+#endif
+
+    // joint indices and normalized weights of one batch of vertices, [influence][vertex]
+    struct SkinBatch
+    {
+        LL_ALIGN_16(S32 mIndex[4][SKIN_BATCH]);
+        LL_ALIGN_16(F32 mWeight[4][SKIN_BATCH]);
+    };
+
+    // decode up to 4 packed weights (joint index in the integer part, weight in the fraction)
+    // into batch starting at vertex offset, short runs are padded with their last vertex
+    void decode_weights(const LLVector4a* weights, S32 count, __m128i max_idx, SkinBatch& batch, S32 offset)
+    {
+        __m128 w0 = weights[0];
+        __m128 w1 = weights[llmin(1, count - 1)];
+        __m128 w2 = weights[llmin(2, count - 1)];
+        __m128 w3 = weights[llmin(3, count - 1)];
+
+        // wN now holds influence N of all four vertices
+        _MM_TRANSPOSE4_PS(w0, w1, w2, w3);
+        __m128 influence[4] = { w0, w1, w2, w3 };
+
+        __m128i idx[4];
+        __m128 frac[4];
+        __m128 scale = _mm_setzero_ps();
+        for (U32 k = 0; k < 4; ++k)
+        {
+            // weights are positive, truncation is floor
+            idx[k] = _mm_cvttps_epi32(influence[k]);
+            frac[k] = _mm_sub_ps(influence[k], _mm_cvtepi32_ps(idx[k]));
+            scale = _mm_add_ps(scale, frac[k]);
+            // indices fit in 16 bits, see getPerVertexSkinMatrixSSE
+            idx[k] = _mm_min_epi16(idx[k], max_idx);
+        }
+
+        // scale > 0 is enforced in unpackVolumeFaces()
+        __m128 inv_scale = _mm_div_ps(_mm_set1_ps(1.f), scale);
+        for (U32 k = 0; k < 4; ++k)
+        {
+            _mm_store_si128((__m128i*)&batch.mIndex[k][offset], idx[k]);
+            _mm_store_ps(&batch.mWeight[k][offset], _mm_mul_ps(frac[k], inv_scale));
+        }
+    }
+
+    // sum of weight * (matrix * t) over the influences of vertex j
+    inline __m128 skin_vertex(const SkinBatch& batch, S32 j, const LLMatrix4a* mat, __m128 t)
+    {
+        __m128 x = _mm_shuffle_ps(t, t, _MM_SHUFFLE(0, 0, 0, 0));
+        __m128 y = _mm_shuffle_ps(t, t, _MM_SHUFFLE(1, 1, 1, 1));
+        __m128 z = _mm_shuffle_ps(t, t, _MM_SHUFFLE(2, 2, 2, 2));
+
+        __m128 acc = _mm_setzero_ps();
+        for (U32 k = 0; k < 4; ++k)
+        {
+            F32 w = batch.mWeight[k][j];
+            if (w > 0.f)
+            {
+                const LLMatrix4a& m = mat[batch.mIndex[k][j]];
+                __m128 v = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m.mMatrix[0], x), _mm_mul_ps(m.mMatrix[1], y)),
+                                      _mm_add_ps(_mm_mul_ps(m.mMatrix[2], z), m.mMatrix[3]));
+                acc = _mm_add_ps(acc, _mm_mul_ps(v, _mm_set1_ps(w)));
+            }
+        }
+        return acc;
+    }
+
+#if defined(__AVX2__)
+    inline __m256 pack_pair(__m128 lo, __m128 hi)
+    {
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1);
+    }
+
+    // skin_vertex for vertices j and j + 1, one in each half of the 256 bit registers
+    inline void skin_vertex_pair(const SkinBatch& batch, S32 j, const LLMatrix4a* mat, __m128 ta, __m128 tb, LLVector4a& out_a, LLVector4a& out_b)
+    {
+        __m256 x = pack_pair(_mm_shuffle_ps(ta, ta, _MM_SHUFFLE(0, 0, 0, 0)), _mm_shuffle_ps(tb, tb, _MM_SHUFFLE(0, 0, 0, 0)));
+        __m256 y = pack_pair(_mm_shuffle_ps(ta, ta, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_ps(tb, tb, _MM_SHUFFLE(1, 1, 1, 1)));
+        __m256 z = pack_pair(_mm_shuffle_ps(ta, ta, _MM_SHUFFLE(2, 2, 2, 2)), _mm_shuffle_ps(tb, tb, _MM_SHUFFLE(2, 2, 2, 2)));
+
+        __m256 acc = _mm256_setzero_ps();
+        for (U32 k = 0; k < 4; ++k)
+        {
+            F32 wa = batch.mWeight[k][j];
+            F32 wb = batch.mWeight[k][j + 1];
+            if (wa > 0.f || wb > 0.f)
+            {
+                const LLMatrix4a& ma = mat[batch.mIndex[k][j]];
+                const LLMatrix4a& mb = mat[batch.mIndex[k][j + 1]];
+                __m256 v = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(pack_pair(ma.mMatrix[0], mb.mMatrix[0]), x),
+                                                       _mm256_mul_ps(pack_pair(ma.mMatrix[1], mb.mMatrix[1]), y)),
+                                         _mm256_add_ps(_mm256_mul_ps(pack_pair(ma.mMatrix[2], mb.mMatrix[2]), z),
+                                                       pack_pair(ma.mMatrix[3], mb.mMatrix[3])));
+                acc = _mm256_add_ps(acc, _mm256_mul_ps(v, pack_pair(_mm_set1_ps(wa), _mm_set1_ps(wb))));
+            }
+        }
+
+        out_a = _mm256_castps256_ps128(acc);
+        out_b = _mm256_extractf128_ps(acc, 1);
+    }
+#endif
+}
+
+void LLSkinningUtil::skinPositions(const LLVector4a* weights, const LLVector4a* positions, S32 count, const LLMatrix4a* mat,
+                                   U32 max_joints, const LLMatrix4a& bind_shape, LLVector4a* out)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_AVATAR;
+
+    const __m128i max_idx = _mm_set1_epi32(max_joints - 1);
+    SkinBatch batch;
+
+    for (S32 base = 0; base < count; base += SKIN_BATCH)
+    {
+        S32 n = llmin(SKIN_BATCH, count - base);
+
+        for (S32 j = 0; j < n; j += 4)
+        {
+            decode_weights(weights + base + j, n - j, max_idx, batch, j);
+        }
+
+        LLVector4a bound[SKIN_BATCH];
+        LLMatrix4aKernels::affineTransformArray(bind_shape, positions + base, bound, n);
+
+        S32 j = 0;
+#if defined(__AVX2__)
+        for (; j + 1 < n; j += 2)
+        {
+            skin_vertex_pair(batch, j, mat, bound[j], bound[j + 1], out[base + j], out[base + j + 1]);
+        }
+#endif
+        for (; j < n; ++j)
+        {
+            out[base + j] = skin_vertex(batch, j, mat, bound[j]);
+        }
+    }
+}
+
 namespace FSSkinningUtil
 {
     void getPerVertexSkinMatrixSSE( LLVector4a const &weights, const LLMatrix4a* mat, bool handle_bad_scale, LLMatrix4a& final_mat, U32 max_joints )
@@ -66,6 +66,12 @@ namespace LLSkinningUtil
         final_mat.add(src[3]);
     }
 
+    // skin count positions at once: out[i] = (mat blended by weights[i]) * bind_shape * positions[i]
+    // weights are decoded a batch at a time into a structure of arrays and two vertices are transformed
+    // per instruction on AVX2 builds (batches of 8), one per instruction otherwise (batches of 4)
+    void skinPositions(const LLVector4a* weights, const LLVector4a* positions, S32 count, const LLMatrix4a* mat,
+                       U32 max_joints, const LLMatrix4a& bind_shape, LLVector4a* out);
+
     void initJointNums(LLMeshSkinInfo* skin, LLVOAvatar *avatar);
     void updateRiggingInfo(const LLMeshSkinInfo* skin, LLVOAvatar *avatar, LLVolumeFace& vol_face);
     LLQuaternion getUnscaledQuaternion(const LLMatrix4& mat4);
@@ -55,6 +55,7 @@
 #include "llviewertexturelist.h"
 #include "llwindow.h"
 #include "llworld.h"
+#include "workqueue.h"
 #include <boost/filesystem.hpp>
 
 constexpr F32 AUTO_SNAPSHOT_TIME_DELAY = 1.f;
@@ -1112,27 +1113,52 @@ void LLSnapshotLivePreview::saveTexture(bool outfit_snapshot, std::string name)
         mPreviewImage->getComponents());
 
     // Apply the filter to mPreviewImage
+    std::string filter_path;
     if (getFilter() != "")
     {
-        std::string filter_path = LLImageFiltersManager::getInstance()->getFilterPath(getFilter());
+        filter_path = LLImageFiltersManager::getInstance()->getFilterPath(getFilter());
+        if (filter_path == "")
+        {
+            LL_WARNS("Snapshot") << "Couldn't find a path to the following filter : " << getFilter() << LL_ENDL;
+        }
+    }
+
+    // Filtering and encoding a full size snapshot takes long enough to freeze the viewer, do it
+    // on the thread pool and upload from the main loop once the texture is in the cache
+    auto encode = [scaled, formatted, filter_path, new_asset_id]() mutable
+    {
         if (filter_path != "")
         {
             LLImageFilter filter(filter_path);
             filter.executeFilter(scaled);
         }
-        else
+
+        scaled->biasedScaleToPowerOfTwo(MAX_TEXTURE_SIZE);
+        LL_DEBUGS("Snapshot") << "scaled texture to " << scaled->getWidth() << "x" << scaled->getHeight() << LL_ENDL;
+
+        if (scaled->getWidth() * scaled->getHeight() >= 1024 * 1024)
         {
-            LL_WARNS("Snapshot") << "Couldn't find a path to the following filter : " << getFilter() << LL_ENDL;
+            formatted->setCodecThreads(llmax((S32)gSavedSettings.getU32("ImageEncodeCodecThreads"), 1));
+        }
+        if (!formatted->encode(scaled, 0.0f))
+        {
+            return false;
         }
-    }
-
-    scaled->biasedScaleToPowerOfTwo(MAX_TEXTURE_SIZE);
-    LL_DEBUGS("Snapshot") << "scaled texture to " << scaled->getWidth() << "x" << scaled->getHeight() << LL_ENDL;
 
-    if (formatted->encode(scaled, 0.0f))
-    {
         LLFileSystem fmt_file(new_asset_id, LLAssetType::AT_TEXTURE, LLFileSystem::WRITE);
         fmt_file.write(formatted->getData(), formatted->getDataSize());
+        return true;
+    };
+
+    auto upload = [tid, scaled, outfit_snapshot, name](bool encoded)
+    {
+        if (!encoded)
+        {
+            LLNotificationsUtil::add("ErrorEncodingSnapshot");
+            LL_WARNS("Snapshot") << "Error encoding snapshot" << LL_ENDL;
+            return;
+        }
+
         std::string pos_string;
         LLAgentUI::buildLocationString(pos_string, LLAgentUI::LOCATION_FORMAT_FULL);
         std::string who_took_it;
@@ -1152,11 +1178,14 @@ void LLSnapshotLivePreview::saveTexture(bool outfit_snapshot, std::string name)
         upload_new_resource(assetUploadInfo);
 
         gViewerWindow->playSnapshotAnimAndSound();
-    }
-    else
+    };
+
+    LL::WorkQueue::ptr_t main_queue = LL::WorkQueue::getInstance("mainloop");
+    LL::WorkQueue::ptr_t general_queue = LL::WorkQueue::getInstance("General");
+    if (!main_queue || !general_queue ||
+        !main_queue->postTo(general_queue, encode, upload))
     {
-        LLNotificationsUtil::add("ErrorEncodingSnapshot");
-        LL_WARNS("Snapshot") << "Error encoding snapshot" << LL_ENDL;
+        upload(encode());
     }
 
     add(LLStatViewer::SNAPSHOT, 1);
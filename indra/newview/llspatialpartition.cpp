@@ -326,6 +326,11 @@ void LLSpatialGroup::rebuildGeom()
 {
     if (!isDead())
     {
+        if (hasState(LLSpatialGroup::GEOM_DIRTY))
+        {
+            gPipeline.markGroupChanged(this);
+        }
+
         getSpatialPartition()->rebuildGeom(this);
 
         if (hasState(LLSpatialGroup::MESH_DIRTY))
@@ -339,6 +344,11 @@ void LLSpatialGroup::rebuildMesh()
 {
     if (!isDead())
     {
+        if (hasState(LLSpatialGroup::MESH_DIRTY))
+        {
+            gPipeline.markGroupChanged(this);
+        }
+
         getSpatialPartition()->rebuildMesh(this);
     }
 }
@@ -421,6 +431,8 @@ bool LLSpatialGroup::removeObject(LLDrawable *drawablep, bool from_octree)
         return false;
     }
 
+    gPipeline.markGroupChanged(this);
+
     unbound();
     if (mOctreeNode && !from_octree)
     {
@@ -2081,7 +2093,8 @@ void renderNormals(LLDrawable *drawablep)
 
         // Normals &tangent line segments get scaled along with the object. Divide by scale length
         // to keep the as-viewed lengths (relatively) constant with the debug setting length
-        float draw_length = gSavedSettings.getF32("RenderDebugNormalScale") / scale_len;
+        static LLCachedControl<F32> normal_scale(gSavedSettings, "RenderDebugNormalScale");
+        float draw_length = normal_scale / scale_len;
 
         std::vector<LLVolumeFace>* faces = nullptr;
         std::vector<LLFace*>* drawable_faces = nullptr;
@@ -2304,12 +2317,12 @@ void renderPhysicsShape(LLDrawable* drawable, LLVOVolume* volume, bool wireframe
 
     //not allowed to return at this point without rendering *something*
 
-    F32 threshold = gSavedSettings.getF32("ObjectCostHighThreshold");
+    static LLCachedControl<F32> threshold(gSavedSettings, "ObjectCostHighThreshold");
     F32 cost = volume->getObjectCost();
 
-    LLColor4 low = gSavedSettings.getColor4("ObjectCostLowColor");
-    LLColor4 mid = gSavedSettings.getColor4("ObjectCostMidColor");
-    LLColor4 high = gSavedSettings.getColor4("ObjectCostHighColor");
+    static LLCachedControl<LLColor4> low(gSavedSettings, "ObjectCostLowColor");
+    static LLCachedControl<LLColor4> mid(gSavedSettings, "ObjectCostMidColor");
+    static LLCachedControl<LLColor4> high(gSavedSettings, "ObjectCostHighColor");
 
     F32 normalizedCost = 1.f - exp( -(cost / threshold) );
 
@@ -4081,6 +4094,66 @@ LLDrawable* LLSpatialGroup::lineSegmentIntersect(const LLVector4a& start, const
     return drawable;
 }
 
+LLMeshletCull::LLMeshletCull(const std::shared_ptr<const LLVolumeFace::meshlet_list_t>& meshlets,
+                             const LLMatrix4& volume_to_buffer, U32 index_offset)
+:   mMeshlets(meshlets),
+    mBufferToVolume(volume_to_buffer),
+    mIndexOffset(index_offset),
+    mIndexCount(0)
+{
+    mBufferToVolume.invert();
+    for (const LLMeshOptimizer::Meshlet& meshlet : *mMeshlets)
+    {
+        mIndexCount += meshlet.mIndexCount;
+    }
+}
+
+const std::vector<LLVertexBuffer::IndirectDraw>& LLMeshletCull::getDraws(const LLMatrix4* model_matrix, const LLVector3& camera_origin)
+{
+    LLVector3 camera = camera_origin;
+    if (model_matrix)
+    {
+        LLMatrix4 agent_to_buffer = *model_matrix;
+        agent_to_buffer.invert();
+        camera = camera * agent_to_buffer;
+    }
+
+    if (mValid && camera == mCamera)
+    {
+        return mDraws;
+    }
+
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_DRAWPOOL;
+    mValid = true;
+    mCamera = camera;
+    mDraws.clear();
+
+    // back facing is a plane side test, so it holds through the object's
+    // (possibly non-uniform) scale and the test can run in volume space
+    LLVector3 eye = camera * mBufferToVolume;
+    for (const LLMeshOptimizer::Meshlet& meshlet : *mMeshlets)
+    {
+        LLVector3 to_center(meshlet.mCenter[0] - eye.mV[0], meshlet.mCenter[1] - eye.mV[1], meshlet.mCenter[2] - eye.mV[2]);
+        LLVector3 axis(meshlet.mConeAxis);
+        if (to_center * axis >= meshlet.mConeCutoff * to_center.length() + meshlet.mRadius)
+        {
+            continue;
+        }
+
+        U32 first = mIndexOffset + meshlet.mIndexOffset;
+        if (!mDraws.empty() && mDraws.back().mFirstIndex + mDraws.back().mCount == first)
+        {
+            mDraws.back().mCount += meshlet.mIndexCount;
+        }
+        else
+        {
+            mDraws.push_back({ meshlet.mIndexCount, 1, first, 0, 0 });
+        }
+    }
+
+    return mDraws;
+}
+
 LLDrawInfo::LLDrawInfo(U16 start, U16 end, U32 count, U32 offset,
                        LLViewerTexture* texture, LLVertexBuffer* buffer,
                        bool fullbright, U8 bump)
@@ -4133,6 +4206,71 @@ U64 LLDrawInfo::getSkinHash()
     return mSkinInfo ? mSkinInfo->mHash : 0;
 }
 
+U32 LLAlphaGroupOrder::sLastStamp = 0;
+
+// static
+U32 LLAlphaGroupOrder::newStamp()
+{
+    // 0 is what groups start out with
+    if (++sLastStamp == 0)
+    {
+        ++sLastStamp;
+    }
+    return sLastStamp;
+}
+
+bool LLAlphaGroupOrder::cameraMoved(const LLCamera* camera) const
+{
+    static LLCachedControl<F32> sort_distance(gSavedSettings, "RenderAlphaSortDistance", 1.f);
+    // about 10 degrees
+    static const F32 SORT_ANGLE_COS = 0.985f;
+
+    return camera &&
+        (dist_vec_squared(camera->getOrigin(), mOrigin) > sort_distance * sort_distance ||
+         camera->getAtAxis() * mAtAxis < SORT_ANGLE_COS);
+}
+
+bool LLAlphaGroupOrder::restore(LLCullResult::sg_iterator begin, LLCullResult::sg_iterator end)
+{
+    if (mOrder.empty() || (size_t)(end - begin) != mOrder.size())
+    {
+        return false;
+    }
+
+    // Every group must carry our stamp.  Restamping each one as we go catches a group that
+    // is listed twice, so equal counts mean mOrder holds exactly these groups and none of
+    // its pointers can be stale.
+    U32 seen = newStamp();
+    for (LLCullResult::sg_iterator i = begin; i != end; ++i)
+    {
+        if ((*i)->mAlphaOrderStamp != mStamp)
+        {
+            return false;
+        }
+        (*i)->mAlphaOrderStamp = seen;
+    }
+    mStamp = seen;
+
+    std::copy(mOrder.begin(), mOrder.end(), begin);
+    return true;
+}
+
+void LLAlphaGroupOrder::remember(LLCullResult::sg_iterator begin, LLCullResult::sg_iterator end, const LLCamera* camera)
+{
+    mStamp = newStamp();
+    for (LLCullResult::sg_iterator i = begin; i != end; ++i)
+    {
+        (*i)->mAlphaOrderStamp = mStamp;
+    }
+    mOrder.assign(begin, end);
+
+    if (camera)
+    {
+        mOrigin = camera->getOrigin();
+        mAtAxis = camera->getAtAxis();
+    }
+}
+
 LLCullResult::LLCullResult()
 {
     mVisibleGroupsAllocated = 0;
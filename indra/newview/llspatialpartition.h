@@ -71,6 +71,33 @@ void render_hull(LLModel::PhysicsMesh& mesh, const LLColor4& color);
 void render_hull_with_outline(LLModel::PhysicsMesh& mesh, const LLColor4& color, const LLColor4& line_color); // <FS:Beq/> restore physics shape display in edit mode
 //</FS:BEQ>
 
+// Skips the meshlets of a dense face that face away from the camera, see
+// LLVolumeFace::mMeshlets.  Attached to draws of a single unrigged face
+// whose back faces are culled anyway.
+class LLMeshletCull final : public LLRefCount
+{
+public:
+    LLMeshletCull(const std::shared_ptr<const LLVolumeFace::meshlet_list_t>& meshlets,
+                  const LLMatrix4& volume_to_buffer, U32 index_offset);
+
+    // Index ranges of the meshlets that may be visible from camera_origin
+    // (agent space), adjacent ranges merged.  model_matrix maps the vertex
+    // buffer to agent space, null for identity.  Recomputed only when the
+    // camera moves relative to the buffer.
+    const std::vector<LLVertexBuffer::IndirectDraw>& getDraws(const LLMatrix4* model_matrix, const LLVector3& camera_origin);
+
+    U32 getIndexCount() const { return mIndexCount; }
+
+private:
+    std::shared_ptr<const LLVolumeFace::meshlet_list_t> mMeshlets;
+    LLMatrix4 mBufferToVolume;
+    U32 mIndexOffset;
+    U32 mIndexCount;
+    LLVector3 mCamera;          // camera in buffer space at the last cull
+    bool mValid = false;
+    std::vector<LLVertexBuffer::IndirectDraw> mDraws;
+};
+
 /*
     Class that represents a single Draw Call
 
@@ -125,6 +152,8 @@ public:
 
     LLPointer<LLVOAvatar> mAvatar = nullptr;
     LLMeshSkinInfo* mSkinInfo = nullptr;
+    LLPointer<LLMeshletCull> mMeshletCull; // null unless this draws one face with meshlets
+    U32 mSkinCacheStamp = 0; // LLVertexBuffer::sSkinCacheStamp when LLGPUSkinning last skinned this draw
 
     // Material pointer here is likely for debugging only and are immaterial (zing!)
     LLPointer<LLMaterial> mMaterial;
@@ -380,6 +409,8 @@ public:
     //used by LLVOAVatar to set render order in alpha draw pool to preserve legacy render order behavior
     LLVOAvatar* mAvatarp = nullptr;
     U32 mRenderOrder = 0;
+    // which LLAlphaGroupOrder last sorted this group
+    U32 mAlphaOrderStamp = 0;
     // Reflection Probe associated with this node (if any)
     LLPointer<LLReflectionMap> mReflectionProbe = nullptr;
 } LL_ALIGN_POSTFIX(16);
@@ -609,6 +640,68 @@ private:
 
 };
 
+// Remembers the order alpha groups were sorted in.  Culling hands over the visible groups in
+// octree order every frame; while the same groups stay visible and the camera stays near where
+// they were last sorted from scratch, the previous order only needs the few swaps that moving
+// objects and small camera moves cause instead of a full sort.
+class LLAlphaGroupOrder
+{
+public:
+    // camera is where a depth order is sorted from, NULL if the order doesn't depend on it
+    template <typename COMPARE>
+    void sort(LLCullResult::sg_iterator begin, LLCullResult::sg_iterator end, COMPARE compare, const LLCamera* camera)
+    {
+        if (cameraMoved(camera) || !restore(begin, end) || !fixOrder(begin, end, compare))
+        {
+            std::sort(begin, end, compare);
+            remember(begin, end, camera);
+        }
+        else
+        {
+            mOrder.assign(begin, end);
+        }
+    }
+
+private:
+    bool cameraMoved(const LLCamera* camera) const;
+    // put begin..end in the remembered order if they are the groups it holds
+    bool restore(LLCullResult::sg_iterator begin, LLCullResult::sg_iterator end);
+    void remember(LLCullResult::sg_iterator begin, LLCullResult::sg_iterator end, const LLCamera* camera);
+
+    // insertion sort, linear in the number of groups when little changed; gives up once the
+    // order turns out to be too far off for that
+    template <typename COMPARE>
+    static bool fixOrder(LLCullResult::sg_iterator begin, LLCullResult::sg_iterator end, COMPARE compare)
+    {
+        size_t moves_left = (end - begin) * 4 + 16;
+        for (LLCullResult::sg_iterator i = begin + 1; i < end; ++i)
+        {
+            LLSpatialGroup* group = *i;
+            LLCullResult::sg_iterator j = i;
+            while (j > begin && compare(group, *(j - 1)))
+            {
+                *j = *(j - 1);
+                --j;
+                if (--moves_left == 0)
+                {
+                    *j = group;
+                    return false;
+                }
+            }
+            *j = group;
+        }
+        return true;
+    }
+
+    std::vector<LLSpatialGroup*> mOrder;
+    U32 mStamp = 0;
+    LLVector3 mOrigin;
+    LLVector3 mAtAxis;
+
+    static U32 newStamp();
+    static U32 sLastStamp;
+};
+
 
 //spatial partition for water (implemented in LLVOWater.cpp)
 class LLWaterPartition : public LLSpatialPartition
@@ -35,6 +35,7 @@
 #   include <sys/stat.h>        // mkdir()
 #endif
 #include <memory>                   // std::unique_ptr
+#include <boost/algorithm/string.hpp>
 
 #include "llviewermedia_streamingaudio.h"
 #include "llaudioengine.h"
@@ -75,6 +76,7 @@
 #include "llpresetsmanager.h"
 #include "llteleporthistory.h"
 #include "llregionhandle.h"
+#include "llregionprefetch.h"
 #include "llsd.h"
 #include "llsdserialize.h"
 #include "llsdutil_math.h"
@@ -86,6 +88,7 @@
 #include "llxorcipher.h"    // saved password, MAC address
 #include "llwindow.h"
 #include "message.h"
+#include "lltemplatemessagereader.h"
 #include "v3math.h"
 
 #include "llagent.h"
@@ -148,6 +151,7 @@
 #include "lltoolmgr.h"
 #include "lltrans.h"
 #include "llui.h"
+#include "lluictrlfactory.h"
 #include "lluiusage.h"
 #include "llurldispatcher.h"
 #include "llurlentry.h"
@@ -914,6 +918,11 @@ bool idle_startup()
                 msg->mPacketRing.setUseOutThrottle(true);
                 msg->mPacketRing.setOutBandwidth(outBandwidth);
             }
+
+            if (gSavedSettings.getBOOL("NetworkReceiveThread"))
+            {
+                msg->startReceiveThread();
+            }
         }
 
         LL_INFOS("AppInit") << "Message System Initialized." << LL_ENDL;
@@ -1937,6 +1946,10 @@ bool idle_startup()
         // We should have an agent id by this point.
         llassert(!(gAgentID == LLUUID::null));
 
+        // parse the inventory cache while the world and the region handshake come up,
+        // STATE_INVENTORY_SKEL picks it up
+        gInventory.prefetchCache(gAgentID);
+
         // <FS:Ansariel> Force HTTP inventory enabled on Second Life
 #ifdef OPENSIM
         if (LLGridManager::getInstance()->isInSecondLife())
@@ -2138,6 +2151,7 @@ bool idle_startup()
         // These textures are not warrantied to be cached, so needs
         // to hapen with caps granted
         gTextureList.doPrefetchImages();
+        LLRegionPrefetch::instance().prefetch(gFirstSimHandle);
 
         // will init images, should be done with caps, but before gSky.init()
         LLEnvironment::getInstance()->initSingleton();
@@ -2173,6 +2187,7 @@ bool idle_startup()
 
         // Debugging info parameters
         gMessageSystem->setMaxMessageTime( 0.5f );          // Spam if decoding all msgs takes more than 500 ms
+        LLTemplateMessageReader::setZeroCopy(gSavedSettings.getBOOL("NetworkMessageZeroCopy"));
         display_startup();
 
         #ifndef LL_RELEASE_FOR_DOWNLOAD
@@ -2539,6 +2554,7 @@ bool idle_startup()
             if(id.isDefined())
             {
                 gInventory.setLibraryOwnerID(LLUUID(id.asUUID()));
+                gInventory.prefetchCache(gInventory.getLibraryOwnerID());
             }
         }
         display_startup();
@@ -3240,6 +3256,12 @@ bool idle_startup()
         // then the data is cached for the viewer's lifetime)
         LLProductInfoRequestManager::instance();
 
+        // Parse the floaters people open first while they look around, not when they click
+        std::vector<std::string> preload_files;
+        boost::split(preload_files, gSavedSettings.getString("XUIPreloadFiles"), boost::is_any_of(", "), boost::token_compress_on);
+        preload_files.erase(std::remove(preload_files.begin(), preload_files.end(), std::string()), preload_files.end());
+        LLUICtrlFactory::preloadXML(preload_files);
+
         // *FIX:Mani - What do I do here?
         // Need we really clear the Auth response data?
         // Clean up the userauth stuff.
@@ -3950,11 +3972,15 @@ std::string LLStartUp::startupStateToString(EStartupState state)
 // static
 void LLStartUp::setStartupState( EStartupState state )
 {
+    getPhases().stopPhase(getStartupStateString());
+
+    F32 elapsed = 0.f;
+    bool completed = false;
+    getPhases().getPhaseValues(getStartupStateString(), elapsed, completed);
     LL_INFOS("AppInit") << "Startup state changing from " <<
-        getStartupStateString() << " to " <<
+        getStartupStateString() << " (" << elapsed << " s) to " <<
         startupStateToString(state) << LL_ENDL;
 
-    getPhases().stopPhase(getStartupStateString());
     gStartupState = state;
     getPhases().startPhase(getStartupStateString());
 
@@ -44,6 +44,7 @@
 #include "llviewercontrol.h"
 #include "llviewertexture.h"
 #include "llsurfacepatch.h"
+#include "llterrainheightfield.h"
 #include "llvosurfacepatch.h"
 #include "llvowater.h"
 #include "pipeline.h"
@@ -96,6 +97,7 @@ LLSurface::LLSurface(U32 type, LLViewerRegion *regionp) :
     mMaxZ = -10000.f;
 
     mWaterObjp = NULL;
+    mHeightfield = NULL;
 
     // In here temporarily.
     mSurfacePatchUpdateCount = 0;
@@ -109,6 +111,9 @@ LLSurface::LLSurface(U32 type, LLViewerRegion *regionp) :
 
 LLSurface::~LLSurface()
 {
+    delete mHeightfield;
+    mHeightfield = NULL;
+
     delete [] mSurfaceZ;
     mSurfaceZ = NULL;
 
@@ -201,6 +206,10 @@ void LLSurface::create(const S32 grids_per_edge,
 
     mVisiblePatchCount = 0;
 
+    if (LLTerrainHeightfield::sEnabled)
+    {
+        mHeightfield = new LLTerrainHeightfield(this);
+    }
 
     ///////////////////////
     //
@@ -824,15 +833,29 @@ template bool LLSurface::idleUpdate</*PBR=*/true>(F32 max_update_time);
 
 void LLSurface::decompressDCTPatch(LLBitPack &bitpack, LLGroupHeader *gopp, bool b_large_patch)
 {
+    std::vector<LLDecodedTerrainPatch> patches;
+    decodeDCTPatches(bitpack, gopp, b_large_patch, mPatchesPerEdge, patches);
+    applyDecodedPatches(patches);
+}
+
+// static
+void LLSurface::decodeDCTPatches(LLBitPack &bitpack, LLGroupHeader *gopp, bool b_large_patch, S32 patches_per_edge,
+                                 std::vector<LLDecodedTerrainPatch> &patches)
+{
+    LL_PROFILE_ZONE_SCOPED;
 
     LLPatchHeader  ph;
     S32 j, i;
     S32 patch[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE];
-    LLSurfacePatch *patchp;
+    S32 size = gopp->patch_size;
+
+    if (size != NORMAL_PATCH_SIZE && size != LARGE_PATCH_SIZE)
+    {
+        LL_WARNS() << "Received invalid terrain packet - patch size " << size << LL_ENDL;
+        return;
+    }
 
-    init_patch_decompressor(gopp->patch_size);
-    gopp->stride = mGridsPerEdge;
-    set_group_of_patch_header(gopp);
+    init_patch_decompressor(size);
 
     while (1)
     {
@@ -860,10 +883,10 @@ void LLSurface::decompressDCTPatch(LLBitPack &bitpack, LLGroupHeader *gopp, bool
         }
 // </FS:CR> Aurora Sim
 
-        if ((i >= mPatchesPerEdge) || (j >= mPatchesPerEdge))
+        if ((i >= patches_per_edge) || (j >= patches_per_edge))
         {
             LL_WARNS() << "Received invalid terrain packet - patch header patch ID incorrect!"
-                << " patches per edge " << mPatchesPerEdge
+                << " patches per edge " << patches_per_edge
                 << " i " << i
                 << " j " << j
                 << " dc_offset " << ph.dc_offset
@@ -874,11 +897,31 @@ void LLSurface::decompressDCTPatch(LLBitPack &bitpack, LLGroupHeader *gopp, bool
             return;
         }
 
-        patchp = &mPatchList[j*mPatchesPerEdge + i];
+        decode_patch(bitpack, patch);
+
+        patches.emplace_back();
+        LLDecodedTerrainPatch& decoded = patches.back();
+        decoded.mX = i;
+        decoded.mY = j;
+        decoded.mSize = size;
+        decoded.mHeights.resize(size*size);
+        decompress_patch(decoded.mHeights.data(), patch, &ph, size, size);
+    }
+}
 
+void LLSurface::applyDecodedPatches(const std::vector<LLDecodedTerrainPatch> &patches)
+{
+    LL_PROFILE_ZONE_SCOPED;
 
-        decode_patch(bitpack, patch);
-        decompress_patch(patchp->getDataZ(), patch, &ph);
+    for (const LLDecodedTerrainPatch& decoded : patches)
+    {
+        LLSurfacePatch *patchp = &mPatchList[decoded.mY*mPatchesPerEdge + decoded.mX];
+
+        F32 *dst = patchp->getDataZ();
+        for (S32 j = 0; j < decoded.mSize; j++)
+        {
+            memcpy(dst + j*mGridsPerEdge, &decoded.mHeights[j*decoded.mSize], decoded.mSize*sizeof(F32));
+        }
 
         // Update edges for neighbors.  Need to guarantee that this gets done before we generate vertical stats.
         patchp->updateNorthEdge();
@@ -1328,6 +1371,15 @@ void LLSurface::dirtySurfacePatch(LLSurfacePatch *patchp)
 {
     // Put surface patch on dirty surface patch list
     mDirtyPatchList.insert(patchp);
+
+    if (mHeightfield)
+    {
+        // including the shared north and east edges
+        S32 offset = (S32)(patchp->getDataZ() - mSurfaceZ);
+        S32 x = offset % mGridsPerEdge;
+        S32 y = offset / mGridsPerEdge;
+        mHeightfield->dirtyRect(x, y, x + mGridsPerPatchEdge, y + mGridsPerPatchEdge);
+    }
 }
 
 
@@ -60,9 +60,19 @@ const S32 ABOVE_WATERLINE_ALPHA = 32;  // The alpha of water when the land eleva
 
 class LLViewerRegion;
 class LLSurfacePatch;
+class LLTerrainHeightfield;
 class LLBitPack;
 class LLGroupHeader;
 
+// Heights of one land patch decoded from a LayerData packet
+struct LLDecodedTerrainPatch
+{
+    S32 mX;                     // patch coordinates
+    S32 mY;
+    S32 mSize;                  // grid points along an edge
+    std::vector<F32> mHeights;  // mSize x mSize, rows south to north
+};
+
 class LLSurface
 {
 public:
@@ -88,6 +98,11 @@ public:
     void rebuildWater();
 // </FS:CR> Aurora Sim
     virtual void decompressDCTPatch(LLBitPack &bitpack, LLGroupHeader *gopp, bool b_large_patch);
+    // The two halves of decompressDCTPatch:  decoding touches no surface state and may run
+    // on any thread, applying must happen on the main thread, in packet order.
+    static void decodeDCTPatches(LLBitPack &bitpack, LLGroupHeader *gopp, bool b_large_patch, S32 patches_per_edge,
+                                 std::vector<LLDecodedTerrainPatch> &patches);
+    void applyDecodedPatches(const std::vector<LLDecodedTerrainPatch> &patches);
     virtual void updatePatchVisibilities(LLAgent &agent);
 
     inline F32 getZ(const U32 k) const              { return mSurfaceZ[k]; }
@@ -140,6 +155,9 @@ public:
     void dirtySurfacePatch(LLSurfacePatch *patchp);
     LLVOWater *getWaterObj()                        { return mWaterObjp; }
 
+    // Only exists while RenderTerrainGPUHeightfield is enabled
+    LLTerrainHeightfield *getHeightfield() const    { return mHeightfield; }
+
     static void setTextureSize(const S32 texture_size);
 
     friend class LLSurfacePatch;
@@ -198,6 +216,8 @@ protected:
 
     LLPointer<LLVOWater>    mWaterObjp;
 
+    LLTerrainHeightfield    *mHeightfield;
+
     // When we want multiple cameras we'll need one of each these for each camera
     S32 mVisiblePatchCount;
 
@@ -1175,7 +1175,8 @@ void LLSurfacePatch::updateVisibility()
         new_render_level = mVisInfo.mRenderLevel = mSurfacep->getRenderLevel(max_render_stride);
         mVisInfo.mRenderStride = mSurfacep->getRenderStride(new_render_level);
 
-        if ((mVisInfo.mRenderStride != old_render_stride))
+        // Heightfield terrain picks its own LOD on the GPU, patches have no geometry to rebuild
+        if ((mVisInfo.mRenderStride != old_render_stride) && !mSurfacep->getHeightfield())
             // The reason we check !mbIsVisible is because non-visible patches normals
             // are not updated when their data is changed.  When this changes we can get
             // rid of mbIsVisible altogether.
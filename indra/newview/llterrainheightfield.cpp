@@ -0,0 +1,428 @@
+/**
+ * @file llterrainheightfield.cpp
+ * @brief LLTerrainHeightfield class implementation
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llterrainheightfield.h"
+
+#include "lldrawpool.h"
+#include "llrender.h"
+#include "llsurface.h"
+#include "llviewercamera.h"
+#include "llvieweroctree.h"
+#include "llviewerregion.h"
+#include "llviewershadermgr.h"
+#include "llvosurfacepatch.h"
+#include "noise.h"
+
+static LLStaticHashedString sHeightfieldNode("heightfield_node");
+static LLStaticHashedString sHeightfieldMorph("heightfield_morph");
+static LLStaticHashedString sHeightfieldCamera("heightfield_camera");
+static LLStaticHashedString sHeightfieldScale("heightfield_scale");
+
+// Vertices start morphing towards the coarser grid at this fraction of their level's range.
+// Must stay above 0.5 so a level is fully unmorphed where the next finer level ends.
+constexpr F32 MORPH_START = 0.8f;
+
+// Range of the finest level in leaf node widths.  Together with MORPH_START this keeps every
+// vertex of a node at least a node diagonal inside the range where its coarser neighbours start
+// morphing themselves, which is what keeps level transitions free of cracks.
+constexpr F32 MIN_LEAF_RANGE = 4.f;
+
+bool LLTerrainHeightfield::sEnabled = false;
+LLPointer<LLVertexBuffer> LLTerrainHeightfield::sGrid;
+
+LLTerrainHeightfield::LLTerrainHeightfield(LLSurface* surface)
+:   mSurface(surface)
+{
+    mTexSize = mSurface->getGridsPerEdge();
+    mLeavesPerEdge = llmax((mTexSize - 1) / NODE_GRID_SIZE, 1U);
+
+    mLevels = 1;
+    while ((1U << (mLevels - 1)) < mLeavesPerEdge && mLevels < LL_ARRAY_SIZE(mRanges))
+    {
+        mLevels++;
+    }
+
+    mBounds.resize(mLevels);
+    for (U32 level = 0; level < mLevels; ++level)
+    {
+        U32 nodes = getNodesPerEdge(level);
+        mBounds[level].resize(nodes * nodes);
+    }
+
+    dirtyAll();
+}
+
+LLTerrainHeightfield::~LLTerrainHeightfield()
+{
+    if (mTexName)
+    {
+        LLImageGL::deleteTextures(1, &mTexName);
+        mTexName = 0;
+    }
+}
+
+void LLTerrainHeightfield::dirtyRect(S32 x0, S32 y0, S32 x1, S32 y1)
+{
+    mDirtyMin[0] = llmin(mDirtyMin[0], llmax(x0, 0));
+    mDirtyMin[1] = llmin(mDirtyMin[1], llmax(y0, 0));
+    mDirtyMax[0] = llmax(mDirtyMax[0], llmin(x1, (S32)mTexSize - 1));
+    mDirtyMax[1] = llmax(mDirtyMax[1], llmin(y1, (S32)mTexSize - 1));
+}
+
+void LLTerrainHeightfield::dirtyAll()
+{
+    mDirtyMin[0] = mDirtyMin[1] = 0;
+    mDirtyMax[0] = mDirtyMax[1] = (S32)mTexSize - 1;
+}
+
+//static
+void LLTerrainHeightfield::destroyGL()
+{
+    for (auto& heightfield : instance_snapshot())
+    {
+        if (heightfield.mTexName)
+        {
+            LLImageGL::deleteTextures(1, &heightfield.mTexName);
+            heightfield.mTexName = 0;
+        }
+    }
+    sGrid = nullptr;
+}
+
+//static
+void LLTerrainHeightfield::createGrid()
+{
+    constexpr U32 verts_per_edge = NODE_GRID_SIZE + 1;
+
+    sGrid = new LLVertexBuffer(LLVertexBuffer::MAP_VERTEX);
+    if (!sGrid->allocateBuffer(verts_per_edge * verts_per_edge, NODE_GRID_SIZE * NODE_GRID_SIZE * 6))
+    {
+        LL_WARNS("Terrain") << "Failed to allocate terrain heightfield grid" << LL_ENDL;
+        sGrid = nullptr;
+        return;
+    }
+
+    LLStrider<LLVector3> pos;
+    LLStrider<U16> idx;
+    sGrid->getVertexStrider(pos);
+    sGrid->getIndexStrider(idx);
+
+    for (U32 y = 0; y < verts_per_edge; ++y)
+    {
+        for (U32 x = 0; x < verts_per_edge; ++x)
+        {
+            *pos++ = LLVector3((F32)x, (F32)y, 0.f);
+        }
+    }
+
+    for (U32 y = 0; y < NODE_GRID_SIZE; ++y)
+    {
+        for (U32 x = 0; x < NODE_GRID_SIZE; ++x)
+        {
+            U16 sw = (U16)(x + y * verts_per_edge);
+            U16 se = sw + 1;
+            U16 nw = (U16)(sw + verts_per_edge);
+            U16 ne = nw + 1;
+
+            // same diagonal as LLVOSurfacePatch::updateMainGeometry
+            *idx++ = sw;
+            *idx++ = se;
+            *idx++ = ne;
+
+            *idx++ = sw;
+            *idx++ = ne;
+            *idx++ = nw;
+        }
+    }
+
+    sGrid->unmapBuffer();
+}
+
+void LLTerrainHeightfield::updateTexture()
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_DRAWPOOL;
+
+    if (mDirtyMin[0] > mDirtyMax[0] || mDirtyMin[1] > mDirtyMax[1])
+    {
+        return;
+    }
+
+    const S32 x0 = mDirtyMin[0];
+    const S32 y0 = mDirtyMin[1];
+    const S32 width = mDirtyMax[0] - x0 + 1;
+    const S32 height = mDirtyMax[1] - y0 + 1;
+
+    LLViewerRegion* regionp = mSurface->getRegion();
+    const F32 meters_per_grid = mSurface->getMetersPerGrid();
+    const LLVector3d& origin_global = mSurface->getOriginGlobal();
+
+    // matches LLSurfacePatch::eval
+    const F32 xyScale = 4.9215f*7.f;
+    const F32 xyScaleInv = (1.f / xyScale)*(0.2222222222f);
+
+    mStaging.resize(width * height * 4);
+    F32* texel = mStaging.data();
+    for (S32 y = y0; y < y0 + height; ++y)
+    {
+        for (S32 x = x0; x < x0 + width; ++x)
+        {
+            F32 vec[3] = {
+                            (F32)fmod((F32)(origin_global.mdV[0] + x * meters_per_grid)*xyScaleInv, 256.f),
+                            (F32)fmod((F32)(origin_global.mdV[1] + y * meters_per_grid)*xyScaleInv, 256.f),
+                            0.f
+                        };
+
+            *texel++ = mSurface->getZ(x, y);
+            *texel++ = regionp->getCompositionXY(llfloor(x * meters_per_grid), llfloor(y * meters_per_grid));
+            *texel++ = llclamp(noise2(vec)* 0.75f + 0.5f, 0.f, 1.f);
+            *texel++ = 1.f;
+        }
+    }
+
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x0, y0, width, height, GL_RGBA, GL_FLOAT, mStaging.data());
+
+    updateBounds(x0, y0, x0 + width - 1, y0 + height - 1);
+
+    mDirtyMin[0] = mDirtyMin[1] = S32_MAX;
+    mDirtyMax[0] = mDirtyMax[1] = -1;
+}
+
+void LLTerrainHeightfield::updateBounds(S32 x0, S32 y0, S32 x1, S32 y1)
+{
+    const S32 last_leaf = (S32)mLeavesPerEdge - 1;
+    const S32 last_point = (S32)mTexSize - 1;
+
+    // a grid point on a leaf boundary belongs to the leaves on both sides
+    S32 lx0 = llmax(x0 - 1, 0) / (S32)NODE_GRID_SIZE;
+    S32 ly0 = llmax(y0 - 1, 0) / (S32)NODE_GRID_SIZE;
+    S32 lx1 = llmin(x1 / (S32)NODE_GRID_SIZE, last_leaf);
+    S32 ly1 = llmin(y1 / (S32)NODE_GRID_SIZE, last_leaf);
+
+    for (S32 ly = ly0; ly <= ly1; ++ly)
+    {
+        for (S32 lx = lx0; lx <= lx1; ++lx)
+        {
+            F32 min_z = F32_MAX;
+            F32 max_z = -F32_MAX;
+            for (S32 y = ly * NODE_GRID_SIZE; y <= llmin((ly + 1) * (S32)NODE_GRID_SIZE, last_point); ++y)
+            {
+                for (S32 x = lx * NODE_GRID_SIZE; x <= llmin((lx + 1) * (S32)NODE_GRID_SIZE, last_point); ++x)
+                {
+                    F32 z = mSurface->getZ(x, y);
+                    min_z = llmin(min_z, z);
+                    max_z = llmax(max_z, z);
+                }
+            }
+            mBounds[0][lx + ly * mLeavesPerEdge].set(min_z, max_z);
+        }
+    }
+
+    for (U32 level = 1; level < mLevels; ++level)
+    {
+        lx0 >>= 1;
+        ly0 >>= 1;
+        lx1 >>= 1;
+        ly1 >>= 1;
+
+        const U32 nodes = getNodesPerEdge(level);
+        const U32 child_nodes = getNodesPerEdge(level - 1);
+        for (S32 ny = ly0; ny <= ly1; ++ny)
+        {
+            for (S32 nx = lx0; nx <= lx1; ++nx)
+            {
+                LLVector2 bounds(F32_MAX, -F32_MAX);
+                for (U32 child = 0; child < 4; ++child)
+                {
+                    U32 cx = nx * 2 + (child & 1);
+                    U32 cy = ny * 2 + (child >> 1);
+                    if (cx < child_nodes && cy < child_nodes)
+                    {
+                        const LLVector2& child_bounds = mBounds[level - 1][cx + cy * child_nodes];
+                        bounds.mV[0] = llmin(bounds.mV[0], child_bounds.mV[0]);
+                        bounds.mV[1] = llmax(bounds.mV[1], child_bounds.mV[1]);
+                    }
+                }
+                mBounds[level][nx + ny * nodes] = bounds;
+            }
+        }
+    }
+}
+
+void LLTerrainHeightfield::getNodeBounds(const Node& node, LLVector3& min, LLVector3& max) const
+{
+    const F32 leaf_width = NODE_GRID_SIZE * mSurface->getMetersPerGrid();
+    const F32 node_width = leaf_width * (1 << node.mLevel);
+    const U32 nodes = getNodesPerEdge(node.mLevel);
+    const LLVector2& bounds = mBounds[node.mLevel][(node.mX >> node.mLevel) + (node.mY >> node.mLevel) * nodes];
+
+    min.set(node.mX * leaf_width, node.mY * leaf_width, bounds.mV[0]);
+    max.set(min.mV[VX] + node_width, min.mV[VY] + node_width, bounds.mV[1]);
+}
+
+bool LLTerrainHeightfield::selectNode(const Node& node, const LLVector3& camera, bool cull)
+{
+    LLVector3 min, max;
+    getNodeBounds(node, min, max);
+
+    if (node.mLevel + 1 < mLevels && !AABBSphereIntersect(min, max, camera, mRanges[node.mLevel]))
+    {
+        return false;
+    }
+
+    if (cull)
+    {
+        LLVector3 origin = mSurface->getOriginAgent();
+        LLVector4a center;
+        center.load3(((min + max) * 0.5f + origin).mV);
+        LLVector4a radius;
+        radius.load3(((max - min) * 0.5f).mV);
+        if (!LLViewerCamera::getInstance()->AABBInFrustumNoFarClip(center, radius))
+        {
+            return true;
+        }
+    }
+
+    if (node.mLevel == 0 || !AABBSphereIntersect(min, max, camera, mRanges[node.mLevel - 1]))
+    {
+        mSelection.push_back(node);
+        return true;
+    }
+
+    const U32 half = 1 << (node.mLevel - 1);
+    for (U32 child = 0; child < 4; ++child)
+    {
+        Node child_node = { node.mX + (child & 1) * half, node.mY + (child >> 1) * half, node.mLevel - 1 };
+        if (child_node.mX >= mLeavesPerEdge || child_node.mY >= mLeavesPerEdge)
+        {
+            continue;
+        }
+
+        if (!selectNode(child_node, camera, cull))
+        {
+            // The child is beyond the range of its own level, so all its vertices are fully
+            // morphed and it renders at this node's resolution.  Drawing it as a child keeps
+            // the single shared grid.
+            mSelection.push_back(child_node);
+        }
+    }
+
+    return true;
+}
+
+void LLTerrainHeightfield::render(LLGLSLShader* shader, bool cull)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_DRAWPOOL;
+
+    if (!mSurface->getRegion())
+    {
+        return;
+    }
+
+    if (sGrid.isNull())
+    {
+        createGrid();
+        if (sGrid.isNull())
+        {
+            return;
+        }
+    }
+
+    S32 channel = shader->enableTexture(LLShaderMgr::TERRAIN_HEIGHTFIELD);
+    if (channel < 0)
+    {
+        return;
+    }
+
+    LLTexUnit* unit = gGL.getTexUnit(channel);
+    if (!mTexName)
+    {
+        LLImageGL::generateTextures(1, &mTexName);
+        unit->bindManual(LLTexUnit::TT_TEXTURE, mTexName, true);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, mTexSize, mTexSize, 0, GL_RGBA, GL_FLOAT, nullptr);
+        unit->setTextureFilteringOption(LLTexUnit::TFO_BILINEAR);
+        unit->setTextureAddressMode(LLTexUnit::TAM_CLAMP);
+        dirtyAll();
+    }
+    else
+    {
+        unit->bindManual(LLTexUnit::TT_TEXTURE, mTexName, true);
+    }
+
+    updateTexture();
+
+    const F32 meters_per_grid = mSurface->getMetersPerGrid();
+    const F32 leaf_width = NODE_GRID_SIZE * meters_per_grid;
+
+    // RenderTerrainLODFactor scales the ranges, but never below what keeps transitions seamless
+    F32 range = leaf_width * MIN_LEAF_RANGE * llmax(LLVOSurfacePatch::sLODFactor, 1.f);
+    for (U32 level = 0; level < mLevels; ++level)
+    {
+        mRanges[level] = range;
+        range *= 2.f;
+    }
+
+    LLVector3 camera = LLViewerCamera::getInstance()->getOrigin() - mSurface->getOriginAgent();
+
+    mSelection.clear();
+    Node root = { 0, 0, mLevels - 1 };
+    selectNode(root, camera, cull);
+
+    if (!mSelection.empty())
+    {
+        LLRenderPass::applyModelMatrix(&mSurface->getRegion()->mRenderMatrix);
+
+        shader->uniform3fv(sHeightfieldCamera, 1, camera.mV);
+        shader->uniform2f(sHeightfieldScale, meters_per_grid, 1.f / mTexSize);
+
+        sGrid->setBuffer();
+
+        const U32 vertex_count = (NODE_GRID_SIZE + 1) * (NODE_GRID_SIZE + 1);
+        const U32 index_count = NODE_GRID_SIZE * NODE_GRID_SIZE * 6;
+        for (const Node& node : mSelection)
+        {
+            F32 cell = meters_per_grid * (1 << node.mLevel);
+            shader->uniform3f(sHeightfieldNode, node.mX * leaf_width, node.mY * leaf_width, cell);
+
+            if (node.mLevel + 1 < mLevels)
+            {
+                F32 morph_end = mRanges[node.mLevel];
+                F32 morph_start = morph_end * MORPH_START;
+                shader->uniform2f(sHeightfieldMorph, morph_start, 1.f / (morph_end - morph_start));
+            }
+            else
+            {   // nothing coarser to morph to
+                shader->uniform2f(sHeightfieldMorph, F32_MAX, 0.f);
+            }
+
+            sGrid->drawRange(LLRender::TRIANGLES, 0, vertex_count - 1, index_count, 0);
+        }
+    }
+
+    unit->unbind(LLTexUnit::TT_TEXTURE);
+    shader->disableTexture(LLShaderMgr::TERRAIN_HEIGHTFIELD);
+}
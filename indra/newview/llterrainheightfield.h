@@ -0,0 +1,115 @@
+/**
+ * @file llterrainheightfield.h
+ * @brief GPU heightfield rendering of LLSurface terrain
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#pragma once
+
+#include "llgl.h"
+#include "llinstancetracker.h"
+#include "llpointer.h"
+#include "v2math.h"
+#include "v3math.h"
+
+#include <vector>
+
+class LLGLSLShader;
+class LLSurface;
+class LLVertexBuffer;
+
+// Renders the terrain of one LLSurface from a float texture of its height grid instead of
+// per patch vertex buffers (RenderTerrainGPUHeightfield).
+//
+// Each texel holds the height, composition and noise value of one grid point, exactly the
+// values LLSurfacePatch::eval would put in a vertex.  Every frame a quadtree over the region
+// selects nodes by distance to the camera (continuous distance-dependent LOD, "CDLOD"), and
+// each node is drawn as the same shared 16x16 quad grid, scaled to the node and displaced
+// in the vertex shader.  Vertices morph towards the next coarser grid as they approach the
+// end of their level's range, so neighbouring nodes of different levels meet without cracks
+// and LOD changes never rebuild geometry.
+//
+// Patches still own visibility, collision and the height data itself; they only stop
+// generating render geometry while heightfields are enabled.
+class LLTerrainHeightfield : public LLInstanceTracker<LLTerrainHeightfield>
+{
+public:
+    LLTerrainHeightfield(LLSurface* surface);
+    ~LLTerrainHeightfield();
+
+    // Grid points x0,y0 .. x1,y1 (inclusive) changed height or composition
+    void dirtyRect(S32 x0, S32 y0, S32 x1, S32 y1);
+    void dirtyAll();
+
+    // Upload pending changes and draw the terrain with shader, which must be a heightfield
+    // variant of a terrain shader and already bound.  Nodes outside the camera frustum are
+    // skipped unless cull is false (shadow passes).
+    void render(LLGLSLShader* shader, bool cull);
+
+    // Release the GL objects of all heightfields, they are recreated on next use
+    static void destroyGL();
+
+    // RenderTerrainGPUHeightfield, read at startup
+    static bool sEnabled;
+
+    // Quads along each edge of the shared node grid
+    static constexpr U32 NODE_GRID_SIZE = 16;
+
+private:
+    struct Node
+    {
+        U32 mX;         // in leaves, from the region's south west corner
+        U32 mY;
+        U32 mLevel;     // 0 for leaves, nodes of level L span 2^L leaves
+    };
+
+    void updateTexture();
+    void updateBounds(S32 x0, S32 y0, S32 x1, S32 y1);
+
+    // Quadtree selection, returns false if the node is beyond the range of its level
+    // and must be covered by its parent
+    bool selectNode(const Node& node, const LLVector3& camera, bool cull);
+    void getNodeBounds(const Node& node, LLVector3& min, LLVector3& max) const;
+    U32 getNodesPerEdge(U32 level) const { return (mLeavesPerEdge + (1 << level) - 1) >> level; }
+
+    static void createGrid();
+
+    LLSurface* mSurface;
+
+    GLuint mTexName = 0;
+    U32 mTexSize = 0;           // grid points along an edge, including the north/east border
+
+    // Dirty rectangle in grid points, empty when mDirtyMin > mDirtyMax
+    S32 mDirtyMin[2];
+    S32 mDirtyMax[2];
+
+    U32 mLeavesPerEdge = 0;
+    U32 mLevels = 0;
+    std::vector<std::vector<LLVector2> > mBounds;   // min/max height of each node, by level
+
+    F32 mRanges[32];            // distance beyond which each level is too fine
+    std::vector<Node> mSelection;
+    std::vector<F32> mStaging;
+
+    static LLPointer<LLVertexBuffer> sGrid;
+};
@@ -30,7 +30,9 @@
 
 #include "llapr.h"
 #include "lldir.h"
+#include "lldiriterator.h"
 #include "llimage.h"
+#include "llimagebc.h"
 #include "llimagej2c.h" // for version control
 #include "lllfsthread.h"
 #include "llviewercontrol.h"
@@ -39,6 +41,8 @@
 #include "llappviewer.h"
 #include "llmemory.h"
 
+#include <thread>
+
 // Cache organization:
 // cache/texture.entries
 //  Unordered array of Entry structs
@@ -54,6 +58,8 @@ const F32 TEXTURE_CACHE_LRU_SIZE = .10f; // % amount for LRU list (low overhead
 const S32 TEXTURE_FAST_CACHE_ENTRY_OVERHEAD = sizeof(S32) * 4; //w, h, c, level
 const S32 TEXTURE_FAST_CACHE_DATA_SIZE = 16 * 16 * 4;
 const S32 TEXTURE_FAST_CACHE_ENTRY_SIZE = TEXTURE_FAST_CACHE_DATA_SIZE + TEXTURE_FAST_CACHE_ENTRY_OVERHEAD;
+const S32 TEXTURE_FAST_CACHE_MAP_GROWTH = TEXTURE_FAST_CACHE_ENTRY_SIZE * 4096; // grow the mapped fast cache ~4MB at a time
+const U64 HEADER_INDEX_ERASED = ~0ULL;
 const F32 TEXTURE_LAZY_PURGE_TIME_LIMIT = .004f; // 4ms. Would be better to autoadjust, but there is a major cache rework in progress.
 const F32 TEXTURE_PRUNING_MAX_TIME = 15.f;
 
@@ -795,13 +801,19 @@ LLTextureCache::LLTextureCache(bool threaded)
       mHeaderMutex(),
       mListMutex(),
       mFastCacheMutex(),
+      mDecodedMutex(),
       mHeaderAPRFile(NULL),
       mReadOnly(true), //do not allow to change the texture cache until setReadOnly() is called.
       mTexturesSizeTotal(0),
       mDoPurge(false),
+      mDecodedSizeTotal(0),
       mFastCachep(NULL),
       mFastCachePoolp(NULL),
-      mFastCachePadBuffer(NULL)
+      mFastCachePadBuffer(NULL),
+      mHeaderMapped(false),
+      mHeaderMapReaders(0),
+      mMappedEntries(0),
+      mLRUTime(0)
 {
     mHeaderAPRFilePoolp = new LLVolatileAPRPool(); // is_local = true, because this pool is for headers, headers are under own mutex
 }
@@ -810,6 +822,11 @@ LLTextureCache::~LLTextureCache()
 {
     clearDeleteList() ;
     writeUpdatedEntries() ;
+    {
+        LLMutexLock lock(&mHeaderMutex);
+        closeHeaderMap();
+    }
+    mFastCacheMap.close();
     delete mFastCachep;
     delete mFastCachePoolp;
     delete mHeaderAPRFilePoolp;
@@ -875,6 +892,12 @@ std::string LLTextureCache::getTextureFileName(const LLUUID& id)
 //debug
 bool LLTextureCache::isInCache(const LLUUID& id)
 {
+    Entry entry;
+    if (findMappedEntry(id, entry, false) >= 0)
+    {
+        return true;
+    }
+
     LLMutexLock lock(&mHeaderMutex);
     id_map_t::const_iterator iter = mHeaderIDMap.find(id);
 
@@ -926,6 +949,7 @@ bool LLTextureCache::isInLocal(const LLUUID& id)
 F32 LLTextureCache::sHeaderCacheVersion = 1.71f;
 U32 LLTextureCache::sCacheMaxEntries = 1024 * 1024; //~1 million textures.
 S64 LLTextureCache::sCacheMaxTexturesSize = 0; // no limit
+S64 LLTextureCache::sCacheMaxDecodedSize = 0; // disabled
 std::string LLTextureCache::sHeaderCacheEncoderVersion = LLImageJ2C::getEngineInfo();
 
 #if defined(ADDRESS_SIZE)
@@ -940,6 +964,9 @@ const char* old_textures_dirname = "textures";
 //change the location of the texture cache to prevent from being deleted by old version viewers.
 const char* textures_dirname = "texturecache";
 const char* fast_cache_filename = "FastCache.cache";
+const char* decoded_dirname = "decoded";
+const char* decoded_extension = ".dtc";
+const U32 DECODED_CACHE_VERSION = 1;
 
 void LLTextureCache::setDirNames(ELLPath location)
 {
@@ -950,6 +977,7 @@ void LLTextureCache::setDirNames(ELLPath location)
     mHeaderDataFileName = gDirUtilp->getExpandedFilename(location, textures_dirname, cache_filename);
     mTexturesDirName = gDirUtilp->getExpandedFilename(location, textures_dirname);
     mFastCacheFileName =  gDirUtilp->getExpandedFilename(location, textures_dirname, fast_cache_filename);
+    mDecodedDirName = gDirUtilp->getExpandedFilename(location, textures_dirname, decoded_dirname);
 }
 
 void LLTextureCache::purgeCache(ELLPath location, bool remove_dir)
@@ -1005,8 +1033,12 @@ S64 LLTextureCache::initCache(ELLPath location, S64 max_size, bool texture_cache
         sCacheMaxTexturesSize = max_size;
     max_size -= sCacheMaxTexturesSize;
 
+    // The decoded tier has its own budget on top of the j2c cache
+    sCacheMaxDecodedSize = (S64)gSavedSettings.getU32("DecodedTextureCacheSize") * 1024 * 1024;
+
     LL_INFOS("TextureCache") << "Headers: " << sCacheMaxEntries
-            << " Textures size: " << sCacheMaxTexturesSize / (1024 * 1024) << " MB" << LL_ENDL;
+            << " Textures size: " << sCacheMaxTexturesSize / (1024 * 1024) << " MB"
+            << " Decoded size: " << sCacheMaxDecodedSize / (1024 * 1024) << " MB" << LL_ENDL;
 
     setDirNames(location);
 
@@ -1036,12 +1068,20 @@ S64 LLTextureCache::initCache(ELLPath location, S64 max_size, bool texture_cache
             std::string dirname = mTexturesDirName + gDirUtilp->getDirDelimiter() + subdirs[i];
             LLFile::mkdir(dirname);
         }
+        LLFile::mkdir(mDecodedDirName);
     }
     readHeaderCache();
     purgeTextures(true); // calc mTexturesSize and make some room in the texture cache if we need it
 
     llassert_always(getPending() == 0) ; //should not start accessing the texture cache before initialized.
     openFastCache(true);
+    if (gSavedSettings.getBOOL("TextureCacheMemoryMapped"))
+    {
+        LLMutexLock lock(&mHeaderMutex);
+        openHeaderMap();
+        openFastCacheMap();
+    }
+    initDecodedCache();
 
     return max_size; // unused cache space
 }
@@ -1072,11 +1112,346 @@ void LLTextureCache::closeHeaderEntriesFile()
     mHeaderAPRFile = NULL;
 }
 
+//----------------------------------------------------------------------------
+// Memory mapped headers
+//
+// While texture.entries is mapped every entry read and write goes through the
+// mapping. Changes to the cache's bookkeeping still happen under
+// mHeaderMutex, but hits can be looked up without it: mHeaderIndex finds the
+// entry, a per entry seqlock gives a consistent copy of it, and
+// mHeaderMapReaders keeps the mapping alive while that happens.
+
+namespace
+{
+    // Keeps the header map from being closed while a lock-free reader uses it
+    class HeaderMapReader
+    {
+    public:
+        HeaderMapReader(const std::atomic<bool>& mapped, std::atomic<S32>& readers)
+            : mReaders(readers)
+        {
+            ++mReaders;
+            mValid = mapped.load();
+        }
+        ~HeaderMapReader() { --mReaders; }
+        bool isValid() const { return mValid; }
+
+    private:
+        std::atomic<S32>& mReaders;
+        bool mValid;
+    };
+
+    // Writers take an entry's seqlock by making it odd. Lock-free time stamp
+    // updates can race the locked writers, so this has to be a CAS.
+    U32 lock_entry_seq(std::atomic<U32>& seq)
+    {
+        U32 before = seq.load(std::memory_order_relaxed);
+        while ((before & 1) || !seq.compare_exchange_weak(before, before + 1, std::memory_order_acquire))
+        {
+            std::this_thread::yield();
+            before = seq.load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        return before;
+    }
+
+    void unlock_entry_seq(std::atomic<U32>& seq, U32 before)
+    {
+        seq.store(before + 2, std::memory_order_release);
+    }
+
+    void header_index_hash(const LLUUID& id, U32& pos, U32& tag)
+    {
+        // ids are random enough to use their bits directly
+        U32 words[4];
+        memcpy(words, id.mData, sizeof(words));
+        pos = words[0] ^ words[2];
+        tag = (words[1] ^ words[3]) | 1; // never 0, so a live slot is never empty
+    }
+}
+
+void LLTextureCache::HeaderIndex::init(U32 max_entries)
+{
+    U32 size = 1024;
+    while (size < max_entries * 2)
+    {
+        size <<= 1;
+    }
+    mSlots.reset(new std::atomic<U64>[size]);
+    mMask = size - 1;
+    clear();
+}
+
+void LLTextureCache::HeaderIndex::clear()
+{
+    for (U32 i = 0; mSlots && i <= mMask; ++i)
+    {
+        mSlots[i].store(0, std::memory_order_relaxed);
+    }
+    mUsed = 0;
+}
+
+bool LLTextureCache::HeaderIndex::set(const LLUUID& id, S32 idx)
+{
+    if (!mSlots)
+    {
+        return true;
+    }
+
+    U32 pos, tag;
+    header_index_hash(id, pos, tag);
+    U64 value = ((U64)tag << 32) | (U32)idx;
+
+    S32 free_slot = -1;
+    for (U32 i = 0; i <= mMask; ++i)
+    {
+        U32 slot = (pos + i) & mMask;
+        U64 current = mSlots[slot].load(std::memory_order_relaxed);
+        if (current == 0)
+        {
+            if (free_slot < 0)
+            {
+                free_slot = slot;
+                ++mUsed;
+            }
+            break;
+        }
+        if (current == HEADER_INDEX_ERASED)
+        {
+            if (free_slot < 0)
+            {
+                free_slot = slot;
+            }
+        }
+        else if ((U32)(current >> 32) == tag)
+        {
+            mSlots[slot].store(value, std::memory_order_release);
+            return true;
+        }
+    }
+
+    if (free_slot < 0)
+    {
+        return false;
+    }
+    mSlots[free_slot].store(value, std::memory_order_release);
+    return mUsed <= mMask - mMask / 4;
+}
+
+void LLTextureCache::HeaderIndex::erase(const LLUUID& id)
+{
+    if (!mSlots)
+    {
+        return;
+    }
+
+    U32 pos, tag;
+    header_index_hash(id, pos, tag);
+    for (U32 i = 0; i <= mMask; ++i)
+    {
+        U32 slot = (pos + i) & mMask;
+        U64 current = mSlots[slot].load(std::memory_order_relaxed);
+        if (current == 0)
+        {
+            return;
+        }
+        if (current != HEADER_INDEX_ERASED && (U32)(current >> 32) == tag)
+        {
+            mSlots[slot].store(HEADER_INDEX_ERASED, std::memory_order_release);
+            return;
+        }
+    }
+}
+
+S32 LLTextureCache::HeaderIndex::find(const LLUUID& id) const
+{
+    if (!mSlots)
+    {
+        return -1;
+    }
+
+    U32 pos, tag;
+    header_index_hash(id, pos, tag);
+    for (U32 i = 0; i <= mMask; ++i)
+    {
+        U64 current = mSlots[(pos + i) & mMask].load(std::memory_order_acquire);
+        if (current == 0)
+        {
+            return -1;
+        }
+        if (current != HEADER_INDEX_ERASED && (U32)(current >> 32) == tag)
+        {
+            return (S32)(U32)current;
+        }
+    }
+    return -1;
+}
+
+void LLTextureCache::setHeaderID(const LLUUID& id, S32 idx)
+{
+    mHeaderIDMap[id] = idx;
+    if (mHeaderMapped && !mHeaderIndex.set(id, idx))
+    {
+        // Too many erased slots, start over. Lookups miss (and take the
+        // locked path) until this is done.
+        mHeaderIndex.clear();
+        for (id_map_t::const_iterator iter = mHeaderIDMap.begin(); iter != mHeaderIDMap.end(); ++iter)
+        {
+            mHeaderIndex.set(iter->first, iter->second);
+        }
+    }
+}
+
+void LLTextureCache::eraseHeaderID(const LLUUID& id)
+{
+    mHeaderIDMap.erase(id);
+    if (mHeaderMapped)
+    {
+        mHeaderIndex.erase(id);
+    }
+}
+
+//mHeaderMutex is locked before calling this.
+bool LLTextureCache::openHeaderMap()
+{
+    if (mHeaderMapped || mReadOnly)
+    {
+        return false;
+    }
+
+    // flush delayed time stamps, the mapping takes over from here
+    if (!mUpdatedEntryMap.empty())
+    {
+        openHeaderEntriesFile(false, 0);
+        updatedHeaderEntriesFile();
+        closeHeaderEntriesFile();
+    }
+
+    // Map room for every entry we may ever use so the mapping never moves
+    size_t size = sizeof(EntriesInfo) + (size_t)sCacheMaxEntries * sizeof(Entry);
+    if (!mHeaderMap.open(mHeaderEntriesFileName, size))
+    {
+        LL_WARNS("TextureCache") << "Couldn't map " << mHeaderEntriesFileName << ", using file reads" << LL_ENDL;
+        return false;
+    }
+
+    mMappedEntries = (U32)((mHeaderMap.getSize() - sizeof(EntriesInfo)) / sizeof(Entry));
+    mEntrySeqs.reset(new std::atomic<U32>[mMappedEntries]());
+    mHeaderIndex.init(mMappedEntries);
+    for (id_map_t::const_iterator iter = mHeaderIDMap.begin(); iter != mHeaderIDMap.end(); ++iter)
+    {
+        mHeaderIndex.set(iter->first, iter->second);
+    }
+    mHeaderMapped = true;
+
+    LL_INFOS("TextureCache") << "Mapped " << mMappedEntries << " header entries" << LL_ENDL;
+    return true;
+}
+
+//mHeaderMutex is locked before calling this.
+bool LLTextureCache::closeHeaderMap()
+{
+    if (!mHeaderMapped)
+    {
+        return false;
+    }
+
+    mHeaderMapped = false;
+    while (mHeaderMapReaders.load() > 0)
+    {
+        std::this_thread::yield();
+    }
+
+    mHeaderMap.close();
+    mEntrySeqs.reset();
+    mMappedEntries = 0;
+    mHeaderIndex.clear();
+    return true;
+}
+
+void LLTextureCache::readMappedEntry(S32 idx, Entry& entry) const
+{
+    const U8* src = mHeaderMap.getData() + sizeof(EntriesInfo) + (size_t)idx * sizeof(Entry);
+    std::atomic<U32>& seq = mEntrySeqs[idx];
+    while (true)
+    {
+        U32 before = seq.load(std::memory_order_acquire);
+        if (!(before & 1))
+        {
+            memcpy((void*)&entry, src, sizeof(Entry));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq.load(std::memory_order_relaxed) == before)
+            {
+                return;
+            }
+        }
+        std::this_thread::yield();
+    }
+}
+
+void LLTextureCache::writeMappedEntry(S32 idx, const Entry& entry)
+{
+    U8* dst = mHeaderMap.getData() + sizeof(EntriesInfo) + (size_t)idx * sizeof(Entry);
+    U32 before = lock_entry_seq(mEntrySeqs[idx]);
+    memcpy(dst, (const void*)&entry, sizeof(Entry));
+    unlock_entry_seq(mEntrySeqs[idx], before);
+}
+
+// Looks up an entry that is already in the cache without mHeaderMutex.
+// Returns -1 on a miss or if the header isn't mapped, callers then take the
+// locked path, which is also what creates and repairs entries.
+S32 LLTextureCache::findMappedEntry(const LLUUID& id, Entry& entry, bool update_time)
+{
+    HeaderMapReader reader(mHeaderMapped, mHeaderMapReaders);
+    if (!reader.isValid())
+    {
+        return -1;
+    }
+
+    S32 idx = mHeaderIndex.find(id);
+    if (idx < 0 || (U32)idx >= mMappedEntries)
+    {
+        return -1;
+    }
+
+    readMappedEntry(idx, entry);
+    if (entry.mID != id || entry.mImageSize <= entry.mBodySize)
+    {
+        return -1; // recycled or being changed
+    }
+
+    if (update_time)
+    {
+        // Readers no longer take the entry out of mLRU, the LRU recycling in
+        // openAndReadEntry() checks this time stamp instead
+        U32 now = (U32)time(NULL);
+        if (entry.mTime != now)
+        {
+            U8* dst = mHeaderMap.getData() + sizeof(EntriesInfo) + (size_t)idx * sizeof(Entry);
+            U32 before = lock_entry_seq(mEntrySeqs[idx]);
+            Entry current;
+            memcpy((void*)&current, dst, sizeof(Entry));
+            if (current.mID == id)
+            {
+                current.mTime = now;
+                memcpy(dst, (const void*)&current, sizeof(Entry));
+            }
+            unlock_entry_seq(mEntrySeqs[idx], before);
+            entry.mTime = now;
+        }
+    }
+    return idx;
+}
+
 void LLTextureCache::readEntriesHeader()
 {
     // mHeaderEntriesInfo initializes to default values so safe not to read it
     llassert_always(mHeaderAPRFile == NULL);
-    if (LLAPRFile::isExist(mHeaderEntriesFileName, mHeaderAPRFilePoolp))
+    if (mHeaderMapped)
+    {
+        memcpy(&mHeaderEntriesInfo, mHeaderMap.getData(), sizeof(EntriesInfo));
+    }
+    else if (LLAPRFile::isExist(mHeaderEntriesFileName, mHeaderAPRFilePoolp))
     {
         LLAPRFile::readEx(mHeaderEntriesFileName, (U8*)&mHeaderEntriesInfo, 0, sizeof(EntriesInfo),
                           mHeaderAPRFilePoolp);
@@ -1108,7 +1483,11 @@ void LLTextureCache::setEntriesHeader()
 void LLTextureCache::writeEntriesHeader()
 {
     llassert_always(mHeaderAPRFile == NULL);
-    if (!mReadOnly)
+    if (mHeaderMapped)
+    {
+        memcpy(mHeaderMap.getData(), &mHeaderEntriesInfo, sizeof(EntriesInfo));
+    }
+    else if (!mReadOnly)
     {
         LLAPRFile::writeEx(mHeaderEntriesFileName, (U8*)&mHeaderEntriesInfo, 0, sizeof(EntriesInfo),
                            mHeaderAPRFilePoolp);
@@ -1154,6 +1533,17 @@ S32 LLTextureCache::openAndReadEntry(const LLUUID& id, Entry& entry, bool create
                     id_map_t::iterator iter3 = mHeaderIDMap.find(oldid);
                     if (iter3 != mHeaderIDMap.end() && iter3->second >= 0)
                     {
+                        if (mHeaderMapped)
+                        {
+                            // Lock-free reads don't take entries out of the
+                            // LRU, they only update the time stamp
+                            Entry old_entry;
+                            readMappedEntry(iter3->second, old_entry);
+                            if (old_entry.mTime > mLRUTime)
+                            {
+                                continue;
+                            }
+                        }
                         idx = iter3->second;
                         removeCachedTexture(oldid) ;//remove the existing cached texture to release the entry index.
                         break;
@@ -1202,6 +1592,23 @@ S32 LLTextureCache::openAndReadEntry(const LLUUID& id, Entry& entry, bool create
 //mHeaderMutex is locked before calling this.
 void LLTextureCache::writeEntryToHeaderImmediately(S32& idx, Entry& entry, bool write_header)
 {
+    if (mHeaderMapped)
+    {
+        if (idx < 0 || (U32)idx >= mMappedEntries)
+        {
+            clearCorruptedCache() ; //clear the cache.
+            idx = -1 ;//mark the idx invalid.
+            return ;
+        }
+        if (write_header)
+        {
+            memcpy(mHeaderMap.getData(), &mHeaderEntriesInfo, sizeof(EntriesInfo));
+        }
+        writeMappedEntry(idx, entry);
+        mUpdatedEntryMap.erase(idx) ;
+        return ;
+    }
+
     LLAPRFile* aprfile ;
     S32 bytes_written ;
     S32 offset = sizeof(EntriesInfo) + idx * sizeof(Entry);
@@ -1238,6 +1645,18 @@ void LLTextureCache::writeEntryToHeaderImmediately(S32& idx, Entry& entry, bool
 //mHeaderMutex is locked before calling this.
 void LLTextureCache::readEntryFromHeaderImmediately(S32& idx, Entry& entry)
 {
+    if (mHeaderMapped)
+    {
+        if (idx < 0 || (U32)idx >= mMappedEntries)
+        {
+            clearCorruptedCache() ; //clear the cache.
+            idx = -1 ;//mark the idx invalid.
+            return ;
+        }
+        readMappedEntry(idx, entry);
+        return ;
+    }
+
     S32 offset = sizeof(EntriesInfo) + idx * sizeof(Entry);
     LLAPRFile* aprfile = openHeaderEntriesFile(true, offset);
     S32 bytes_read = aprfile->read((void*)&entry, (S32)sizeof(Entry));
@@ -1266,7 +1685,14 @@ void LLTextureCache::updateEntryTimeStamp(S32 idx, Entry& entry)
         if (!mReadOnly)
         {
             entry.mTime = (U32)time(NULL);
-            mUpdatedEntryMap[idx] = entry ;
+            if (mHeaderMapped && (U32)idx < mMappedEntries)
+            {
+                writeMappedEntry(idx, entry);
+            }
+            else
+            {
+                mUpdatedEntryMap[idx] = entry ;
+            }
         }
     }
 }
@@ -1290,7 +1716,7 @@ bool LLTextureCache::updateEntry(S32& idx, Entry& entry, S32 new_image_size, S32
         bool update_header = false ;
         if(entry.mImageSize < 0) //is a brand-new entry
         {
-            mHeaderIDMap[entry.mID] = idx;
+            setHeaderID(entry.mID, idx);
             mTexturesSizeMap[entry.mID] = new_body_size ;
             mTexturesSizeTotal += new_body_size ;
 
@@ -1330,11 +1756,41 @@ U32 LLTextureCache::openAndReadEntries(std::vector<Entry>& entries)
 {
     U32 num_entries = mHeaderEntriesInfo.mEntries;
 
+    // mHeaderIndex is left alone so lock-free lookups keep hitting while the
+    // map is rebuilt, setHeaderID() refreshes it and stale slots fail the
+    // lookup's own check.
     mHeaderIDMap.clear();
     mTexturesSizeMap.clear();
     mFreeList.clear();
     mTexturesSizeTotal = 0;
 
+    if (mHeaderMapped)
+    {
+        if (num_entries > mMappedEntries)
+        {
+            LL_WARNS() << "Corrupted header entries, " << num_entries << " entries in a map of " << mMappedEntries << LL_ENDL;
+            purgeAllTextures(false);
+            return 0;
+        }
+        entries.resize(num_entries);
+        for (U32 idx = 0; idx < num_entries; idx++)
+        {
+            Entry& entry = entries[idx];
+            readMappedEntry(idx, entry);
+            if (entry.mImageSize > entry.mBodySize)
+            {
+                setHeaderID(entry.mID, idx);
+                mTexturesSizeMap[entry.mID] = entry.mBodySize;
+                mTexturesSizeTotal += entry.mBodySize;
+            }
+            else
+            {
+                mFreeList.insert(idx);
+            }
+        }
+        return num_entries;
+    }
+
     LLAPRFile* aprfile = NULL;
     if(mUpdatedEntryMap.empty())
     {
@@ -1365,7 +1821,7 @@ U32 LLTextureCache::openAndReadEntries(std::vector<Entry>& entries)
 //      LL_INFOS() << "ENTRY: " << entry.mTime << " TEX: " << entry.mID << " IDX: " << idx << " Size: " << entry.mImageSize << LL_ENDL;
         if(entry.mImageSize > entry.mBodySize)
         {
-            mHeaderIDMap[entry.mID] = idx;
+            setHeaderID(entry.mID, idx);
             mTexturesSizeMap[entry.mID] = entry.mBodySize;
             mTexturesSizeTotal += entry.mBodySize;
         }
@@ -1383,7 +1839,14 @@ void LLTextureCache::writeEntriesAndClose(const std::vector<Entry>& entries)
     auto num_entries = entries.size();
     llassert_always(num_entries == mHeaderEntriesInfo.mEntries);
 
-    if (!mReadOnly)
+    if (mHeaderMapped)
+    {
+        for (size_t idx = 0; idx < num_entries; idx++)
+        {
+            writeMappedEntry((S32)idx, entries[idx]);
+        }
+    }
+    else if (!mReadOnly)
     {
         LLAPRFile* aprfile = openHeaderEntriesFile(false, (S32)sizeof(EntriesInfo));
         for (size_t idx=0; idx<num_entries; idx++)
@@ -1456,6 +1919,7 @@ void LLTextureCache::readHeaderCache()
     mHeaderMutex.lock();
 
     mLRU.clear(); // always clear the LRU
+    mLRUTime = (U32)time(NULL);
 
     readEntriesHeader();
 
@@ -1580,6 +2044,15 @@ void LLTextureCache::clearCorruptedCache()
 
 void LLTextureCache::purgeAllTextures(bool purge_directories)
 {
+    // the files are about to go away under the mappings
+    bool remap_headers = closeHeaderMap();
+    bool remap_fast_cache = false;
+    {
+        LLMutexLock lock(&mFastCacheMutex);
+        remap_fast_cache = mFastCacheMap.isOpen();
+        mFastCacheMap.close();
+    }
+
     if (!mReadOnly)
     {
 // <FS:ND> Windows can be really slow deleting a huge texture cache.
@@ -1627,6 +2100,7 @@ void LLTextureCache::purgeAllTextures(bool purge_directories)
         if (LLFile::isdir(mTexturesDirName))
         {
         // </FS:Ansariel>
+        purgeAllDecoded(purge_directories);
         gDirUtilp->deleteFilesInDir(mTexturesDirName, mask); // headers, fast cache
         if (purge_directories)
         {
@@ -1641,6 +2115,11 @@ void LLTextureCache::purgeAllTextures(bool purge_directories)
     mTexturesSizeMap.clear();
     mTexturesSizeTotal = 0;
     mFreeList.clear();
+    {
+        LLMutexLock lock(&mDecodedMutex);
+        mDecodedMap.clear();
+        mDecodedSizeTotal = 0;
+    }
     mTexturesSizeTotal = 0;
     mUpdatedEntryMap.clear();
 
@@ -1648,6 +2127,15 @@ void LLTextureCache::purgeAllTextures(bool purge_directories)
     setEntriesHeader();
     writeEntriesHeader();
 
+    if (remap_headers)
+    {
+        openHeaderMap();
+    }
+    if (remap_fast_cache)
+    {
+        openFastCacheMap();
+    }
+
     LL_INFOS() << "The entire texture cache is cleared." << LL_ENDL ;
 }
 
@@ -1886,8 +2374,14 @@ LLTextureCacheWorker* LLTextureCache::getWriter(handle_t handle)
 S32 LLTextureCache::getHeaderCacheEntry(const LLUUID& id, Entry& entry)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
+    S32 idx = findMappedEntry(id, entry, !mReadOnly);
+    if (idx >= 0)
+    {
+        return idx;
+    }
+
     LLMutexLock lock(&mHeaderMutex);
-    S32 idx = openAndReadEntry(id, entry, false);
+    idx = openAndReadEntry(id, entry, false);
     if (idx >= 0)
     {
         updateEntryTimeStamp(idx, entry); // updates time
@@ -2032,6 +2526,13 @@ LLTextureCache::handle_t LLTextureCache::writeToCache(const LLUUID& id,
 LLPointer<LLImageRaw> LLTextureCache::readFromFastCache(const LLUUID& id, S32& discardlevel)
 {
     U32 offset;
+    Entry entry;
+    S32 idx = findMappedEntry(id, entry, false);
+    if (idx >= 0)
+    {
+        offset = idx;
+    }
+    else
     {
         LLMutexLock lock(&mHeaderMutex);
         id_map_t::const_iterator iter = mHeaderIDMap.find(id);
@@ -2046,6 +2547,31 @@ LLPointer<LLImageRaw> LLTextureCache::readFromFastCache(const LLUUID& id, S32& d
 
     U8* data;
     S32 head[4];
+    if (mFastCacheMap.isOpen())
+    {
+        LLMutexLock lock(&mFastCacheMutex);
+
+        // the mapping may have been closed while we waited for the mutex
+        if (!mFastCacheMap.isOpen() || offset + TEXTURE_FAST_CACHE_ENTRY_SIZE > mFastCacheMap.getSize())
+        {
+            return NULL; // not written yet
+        }
+        const U8* src = mFastCacheMap.getData() + offset;
+        memcpy(head, src, TEXTURE_FAST_CACHE_ENTRY_OVERHEAD);
+
+        S32 image_size = head[0] * head[1] * head[2];
+        if(image_size <= 0
+           || image_size > TEXTURE_FAST_CACHE_DATA_SIZE
+           || head[3] < 0) //invalid
+        {
+            return NULL;
+        }
+        discardlevel = head[3];
+
+        data = (U8*)ll_aligned_malloc_16(image_size);
+        memcpy(data, src + TEXTURE_FAST_CACHE_ENTRY_OVERHEAD, image_size);
+    }
+    else
     {
         LLMutexLock lock(&mFastCacheMutex);
 
@@ -2150,6 +2676,22 @@ bool LLTextureCache::writeToFastCache(LLUUID image_id, S32 id, LLPointer<LLImage
     {
         LLMutexLock lock(&mFastCacheMutex);
 
+        if (mFastCacheMap.isOpen())
+        {
+            if (offset + TEXTURE_FAST_CACHE_ENTRY_SIZE > mFastCacheMap.getSize())
+            {
+                size_t size = (size_t)(offset / TEXTURE_FAST_CACHE_MAP_GROWTH + 1) * TEXTURE_FAST_CACHE_MAP_GROWTH;
+                if (!mFastCacheMap.resize(size))
+                {
+                    LL_WARNS() << "Failed to grow the fast cache map to " << size << " bytes" << LL_ENDL;
+                    mFastCacheMap.close();
+                    return false;
+                }
+            }
+            memcpy(mFastCacheMap.getData() + offset, mFastCachePadBuffer, TEXTURE_FAST_CACHE_ENTRY_SIZE);
+            return true;
+        }
+
         openFastCache();
 
         mFastCachep->seek(APR_SET, offset);
@@ -2195,6 +2737,21 @@ void LLTextureCache::openFastCache(bool first_time)
     return;
 }
 
+void LLTextureCache::openFastCacheMap()
+{
+    LLMutexLock lock(&mFastCacheMutex);
+
+    if (mReadOnly || mFastCacheMap.isOpen())
+    {
+        return;
+    }
+    closeFastCache(true);
+    if (!mFastCacheMap.open(mFastCacheFileName, TEXTURE_FAST_CACHE_MAP_GROWTH))
+    {
+        LL_WARNS("TextureCache") << "Couldn't map " << mFastCacheFileName << ", using file reads" << LL_ENDL;
+    }
+}
+
 void LLTextureCache::closeFastCache(bool forced)
 {
     static const F32 timeout = 10.f ; //seconds
@@ -2258,10 +2815,11 @@ void LLTextureCache::removeCachedTexture(const LLUUID& id)
         mTexturesSizeTotal -= mTexturesSizeMap[id] ;
         mTexturesSizeMap.erase(id);
     }
-    mHeaderIDMap.erase(id);
+    eraseHeaderID(id);
     // We are inside header's mutex so mHeaderAPRFilePoolp is safe to use,
     // but getLocalAPRFilePool() is not safe, it might be in use by worker
     LLAPRFile::remove(getTextureFileName(id), mHeaderAPRFilePoolp);
+    removeFromDecodedCache(id);
 }
 
 //called after mHeaderMutex is locked.
@@ -2289,9 +2847,10 @@ void LLTextureCache::removeEntry(S32 idx, Entry& entry, std::string& filename)
 
         entry.mImageSize = -1;
         entry.mBodySize = 0;
-        mHeaderIDMap.erase(entry.mID);
+        eraseHeaderID(entry.mID);
         mTexturesSizeMap.erase(entry.mID);
         mFreeList.insert(idx);
+        removeFromDecodedCache(entry.mID);
     }
 
     if (file_maybe_exists)
@@ -2319,10 +2878,314 @@ bool LLTextureCache::removeFromCache(const LLUUID& id)
         }
 
         unlockHeaders() ;
+
+        removeFromDecodedCache(id);
     }
     return ret ;
 }
 
+//////////////////////////////////////////////////////////////////////////////
+// Decoded cache
+
+namespace
+{
+    struct DecodedHeader
+    {
+        U32 mVersion;
+        S32 mWidth;
+        S32 mHeight;
+        S32 mComponents;
+        S32 mDataSize;          // j2c bytes the image was decoded from
+        S32 mCompressedFormat;  // LLImageBC::EFormat
+        S32 mCompressedSize;
+    };
+}
+
+std::string LLTextureCache::getDecodedFileName(const LLUUID& id, S32 discard)
+{
+    return mDecodedDirName + gDirUtilp->getDirDelimiter() + id.asString() + llformat("_%d", discard) + decoded_extension;
+}
+
+void LLTextureCache::initDecodedCache()
+{
+    LLMutexLock lock(&mDecodedMutex);
+
+    mDecodedMap.clear();
+    mDecodedSizeTotal = 0;
+    if (mReadOnly || sCacheMaxDecodedSize <= 0)
+    {
+        return;
+    }
+
+    // left over from writes that didn't finish
+    gDirUtilp->deleteFilesInDir(mDecodedDirName, "*.tmp");
+
+    U32 now = (U32)time(NULL);
+    LLDirIterator iter(mDecodedDirName, std::string("*") + decoded_extension);
+    std::string filename;
+    while (iter.next(filename))
+    {
+        // <uuid>_<discard>.dtc
+        LLUUID id;
+        S32 discard = -1;
+        size_t sep = filename.find('_');
+        if (sep == UUID_STR_LENGTH - 1 && id.set(filename.substr(0, sep), false))
+        {
+            discard = atoi(filename.c_str() + sep + 1);
+        }
+
+        std::string path = mDecodedDirName + gDirUtilp->getDirDelimiter() + filename;
+        llstat stat_data;
+        if (discard < 0 || discard > MAX_DISCARD_LEVEL || LLFile::stat(path, &stat_data) != 0)
+        {
+            LLFile::remove(path);
+            continue;
+        }
+
+        DecodedEntry& entry = mDecodedMap[std::make_pair(id, discard)];
+        entry.mSize = (S32)stat_data.st_size;
+        entry.mTime = stat_data.st_mtime > 0 ? (U32)stat_data.st_mtime : now;
+        mDecodedSizeTotal += entry.mSize;
+    }
+
+    purgeDecodedCache(sCacheMaxDecodedSize);
+
+    LL_INFOS("TextureCache") << "Decoded cache: " << mDecodedMap.size() << " entries, "
+                             << mDecodedSizeTotal / (1024 * 1024) << " MB" << LL_ENDL;
+}
+
+// mDecodedMutex must be locked
+void LLTextureCache::purgeDecodedCache(S64 max_size)
+{
+    if (mDecodedSizeTotal <= max_size)
+    {
+        return;
+    }
+
+    // Drop the least recently used entries down to 90% of the budget so that
+    // we don't purge again on the very next write
+    S64 target = max_size - max_size / 10;
+
+    typedef std::pair<U32, decoded_map_t::iterator> time_iter_t;
+    std::vector<time_iter_t> entries;
+    entries.reserve(mDecodedMap.size());
+    for (decoded_map_t::iterator iter = mDecodedMap.begin(); iter != mDecodedMap.end(); ++iter)
+    {
+        entries.push_back(std::make_pair(iter->second.mTime, iter));
+    }
+    std::sort(entries.begin(), entries.end(),
+              [](const time_iter_t& a, const time_iter_t& b) { return a.first < b.first; });
+
+    S32 purged = 0;
+    for (const time_iter_t& entry : entries)
+    {
+        if (mDecodedSizeTotal <= target)
+        {
+            break;
+        }
+        LLFile::remove(getDecodedFileName(entry.second->first.first, entry.second->first.second));
+        mDecodedSizeTotal -= entry.second->second.mSize;
+        mDecodedMap.erase(entry.second);
+        ++purged;
+    }
+
+    LL_DEBUGS("TextureCache") << "Purged " << purged << " decoded entries, "
+                              << mDecodedSizeTotal / (1024 * 1024) << " MB left" << LL_ENDL;
+}
+
+void LLTextureCache::purgeAllDecoded(bool purge_directory)
+{
+    LLMutexLock lock(&mDecodedMutex);
+
+    if (LLFile::isdir(mDecodedDirName))
+    {
+        if (purge_directory)
+        {
+            gDirUtilp->deleteDirAndContents(mDecodedDirName);
+        }
+        else
+        {
+            gDirUtilp->deleteFilesInDir(mDecodedDirName, "*");
+        }
+    }
+    mDecodedMap.clear();
+    mDecodedSizeTotal = 0;
+}
+
+void LLTextureCache::removeFromDecodedCache(const LLUUID& id)
+{
+    LLMutexLock lock(&mDecodedMutex);
+
+    decoded_map_t::iterator iter = mDecodedMap.lower_bound(std::make_pair(id, 0));
+    while (iter != mDecodedMap.end() && iter->first.first == id)
+    {
+        LLFile::remove(getDecodedFileName(id, iter->first.second));
+        mDecodedSizeTotal -= iter->second.mSize;
+        iter = mDecodedMap.erase(iter);
+    }
+}
+
+bool LLTextureCache::readFromDecodedCache(const LLUUID& id, S32 discard, S32 data_size,
+                                          LLPointer<LLImageRaw>& raw, LLPointer<LLImageBC>& compressed)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
+
+    if (sCacheMaxDecodedSize <= 0)
+    {
+        return false;
+    }
+
+    // Held for the whole read so a concurrent write or purge can't replace
+    // the file under us
+    LLMutexLock lock(&mDecodedMutex);
+
+    decoded_map_t::iterator iter = mDecodedMap.find(std::make_pair(id, discard));
+    if (iter == mDecodedMap.end())
+    {
+        return false;
+    }
+
+    std::string filename = getDecodedFileName(id, discard);
+    LLFILE* fp = LLFile::fopen(filename, "rb");
+    if (!fp)
+    {
+        mDecodedSizeTotal -= iter->second.mSize;
+        mDecodedMap.erase(iter);
+        return false;
+    }
+
+    DecodedHeader header;
+    bool valid = fread(&header, sizeof(header), 1, fp) == 1
+        && header.mVersion == DECODED_CACHE_VERSION
+        && header.mWidth > 0 && header.mHeight > 0
+        && header.mComponents > 0 && header.mComponents <= 4
+        && header.mCompressedSize >= 0
+        && sizeof(header) + (S64)header.mWidth * header.mHeight * header.mComponents + header.mCompressedSize == (S64)iter->second.mSize;
+
+    if (valid && header.mDataSize < data_size)
+    {
+        // decoded from less data than we have now, let the caller decode
+        fclose(fp);
+        return false;
+    }
+
+    LLPointer<LLImageRaw> image;
+    if (valid)
+    {
+        image = new LLImageRaw(header.mWidth, header.mHeight, header.mComponents);
+        LLImageDataLock lock_image(image);
+        valid = !image->isBufferInvalid()
+            && fread(image->getData(), image->getDataSize(), 1, fp) == 1;
+    }
+
+    LLPointer<LLImageBC> image_bc;
+    if (valid && header.mCompressedSize > 0)
+    {
+        std::vector<U8> data(header.mCompressedSize);
+        valid = fread(data.data(), data.size(), 1, fp) == 1;
+        if (valid)
+        {
+            image_bc = new LLImageBC();
+            if (!image_bc->assign((LLImageBC::EFormat)header.mCompressedFormat, header.mWidth, header.mHeight,
+                                  data.data(), header.mCompressedSize))
+            {
+                image_bc = NULL;
+            }
+        }
+    }
+    fclose(fp);
+
+    if (!valid)
+    {
+        LL_WARNS("TextureCache") << "Removing corrupted decoded cache file " << filename << LL_ENDL;
+        LLFile::remove(filename);
+        mDecodedSizeTotal -= iter->second.mSize;
+        mDecodedMap.erase(iter);
+        return false;
+    }
+
+    iter->second.mTime = (U32)time(NULL);
+    raw = image;
+    compressed = image_bc;
+    return true;
+}
+
+void LLTextureCache::writeToDecodedCache(const LLUUID& id, S32 discard, S32 data_size,
+                                         const LLImageRaw* raw, const LLImageBC* compressed)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
+
+    if (mReadOnly || sCacheMaxDecodedSize <= 0 || !raw || discard < 0 || discard > MAX_DISCARD_LEVEL)
+    {
+        return;
+    }
+
+    LLImageDataSharedLock lock_raw(raw);
+    LLImageDataSharedLock lock_bc(compressed);
+
+    if (raw->isBufferInvalid() || !raw->getData())
+    {
+        return;
+    }
+
+    DecodedHeader header;
+    header.mVersion = DECODED_CACHE_VERSION;
+    header.mWidth = raw->getWidth();
+    header.mHeight = raw->getHeight();
+    header.mComponents = raw->getComponents();
+    header.mDataSize = data_size;
+    header.mCompressedFormat = compressed ? (S32)compressed->getFormat() : (S32)LLImageBC::FORMAT_NONE;
+    header.mCompressedSize = compressed && compressed->getData() ? compressed->getDataSize() : 0;
+
+    S64 size = sizeof(header) + (S64)raw->getDataSize() + header.mCompressedSize;
+    if (size > sCacheMaxDecodedSize / 8)
+    {
+        // A single image shouldn't be able to flush most of the tier
+        return;
+    }
+
+    // Write to a temporary file first so that readers never see a partial entry
+    std::string filename = getDecodedFileName(id, discard);
+    std::string tmp_filename = filename + ".tmp";
+    LLFILE* fp = LLFile::fopen(tmp_filename, "wb");
+    if (!fp)
+    {
+        return;
+    }
+    bool success = fwrite(&header, sizeof(header), 1, fp) == 1
+        && fwrite(raw->getData(), raw->getDataSize(), 1, fp) == 1
+        && (header.mCompressedSize == 0 || fwrite(compressed->getData(), header.mCompressedSize, 1, fp) == 1);
+    success = fclose(fp) == 0 && success;
+    if (!success)
+    {
+        LLFile::remove(tmp_filename);
+        return;
+    }
+
+    LLMutexLock lock(&mDecodedMutex);
+
+    std::pair<LLUUID, S32> key(id, discard);
+    decoded_map_t::iterator iter = mDecodedMap.find(key);
+    if (iter != mDecodedMap.end())
+    {
+        LLFile::remove(filename);
+        mDecodedSizeTotal -= iter->second.mSize;
+        mDecodedMap.erase(iter);
+    }
+    if (LLFile::rename(tmp_filename, filename) != 0)
+    {
+        LLFile::remove(tmp_filename);
+        return;
+    }
+
+    DecodedEntry& entry = mDecodedMap[key];
+    entry.mSize = (S32)size;
+    entry.mTime = (U32)time(NULL);
+    mDecodedSizeTotal += size;
+
+    purgeDecodedCache(sCacheMaxDecodedSize);
+}
+
 //////////////////////////////////////////////////////////////////////////////
 
 LLTextureCache::ReadResponder::ReadResponder()
@@ -28,15 +28,20 @@
 #define LL_LLTEXTURECACHE_H
 
 #include "lldir.h"
+#include "llmappedfile.h"
 #include "llstl.h"
 #include "llstring.h"
 #include "lluuid.h"
 
 #include "llworkerthread.h"
 
+#include <atomic>
+#include <memory>
+
 class LLImageFormatted;
 class LLTextureCacheWorker;
 class LLImageRaw;
+class LLImageBC;
 
 class LLTextureCache : public LLWorkerThread
 {
@@ -133,6 +138,18 @@ public:
 
     bool removeFromCache(const LLUUID& id);
 
+    // Decoded tier, keyed by id and discard level. Holds the raw image a j2c
+    // decode produced (and its block compressed copy, if any) so that later
+    // fetches of the same level can skip the decode. data_size is the number
+    // of j2c bytes the image was decoded from; a read only hits if the entry
+    // was decoded from at least as much data as the caller has now.
+    // Both may be called from any thread.
+    bool readFromDecodedCache(const LLUUID& id, S32 discard, S32 data_size,
+                              LLPointer<LLImageRaw>& raw, LLPointer<LLImageBC>& compressed);
+    void writeToDecodedCache(const LLUUID& id, S32 discard, S32 data_size,
+                             const LLImageRaw* raw, const LLImageBC* compressed);
+    void removeFromDecodedCache(const LLUUID& id);
+
     // For LLTextureCacheWorker::Responder
     LLTextureCacheWorker* getReader(handle_t handle);
     LLTextureCacheWorker* getWriter(handle_t handle);
@@ -144,6 +161,7 @@ public:
     S32 getNumWrites() { return static_cast<S32>(mWriters.size()); }
     S64Bytes getUsage() { return S64Bytes(mTexturesSizeTotal); }
     S64Bytes getMaxUsage() { return S64Bytes(sCacheMaxTexturesSize); }
+    S64Bytes getDecodedUsage() { return S64Bytes(mDecodedSizeTotal); }
     U32 getEntries() { return mHeaderEntriesInfo.mEntries; }
     U32 getMaxEntries() { return sCacheMaxEntries; };
     bool isInCache(const LLUUID& id) ;
@@ -186,16 +204,33 @@ private:
     void lockHeaders() { mHeaderMutex.lock(); }
     void unlockHeaders() { mHeaderMutex.unlock(); }
 
+    // Memory mapped texture.entries, checked by workers without mHeaderMutex.
+    // mHeaderMutex must be locked for open/close.
+    bool openHeaderMap();
+    bool closeHeaderMap();
+    void readMappedEntry(S32 idx, Entry& entry) const;
+    void writeMappedEntry(S32 idx, const Entry& entry);
+    S32 findMappedEntry(const LLUUID& id, Entry& entry, bool update_time);
+    void setHeaderID(const LLUUID& id, S32 idx);
+    void eraseHeaderID(const LLUUID& id);
+
     void openFastCache(bool first_time = false);
+    void openFastCacheMap();
     void closeFastCache(bool forced = false);
     bool writeToFastCache(LLUUID image_id, S32 cache_id, LLPointer<LLImageRaw> raw, S32 discardlevel);
 
+    void initDecodedCache();
+    void purgeDecodedCache(S64 max_size); // mDecodedMutex must be locked
+    void purgeAllDecoded(bool purge_directory);
+    std::string getDecodedFileName(const LLUUID& id, S32 discard);
+
 private:
     // Internal
     LLMutex mWorkersMutex;
     LLMutex mHeaderMutex;
     LLMutex mListMutex;
     LLMutex mFastCacheMutex;
+    LLMutex mDecodedMutex;
     LLAPRFile* mHeaderAPRFile;
     LLVolatileAPRPool* mFastCachePoolp;
 
@@ -231,6 +266,34 @@ private:
     LLAPRFile*   mFastCachep;
     LLFrameTimer mFastCacheTimer;
     U8*          mFastCachePadBuffer;
+    LLMappedFile mFastCacheMap; // used instead of mFastCachep when open, under mFastCacheMutex
+
+    // Open addressed id -> entry index table mirroring mHeaderIDMap so that
+    // hits can be found without mHeaderMutex. Only written with the header
+    // mutex held. A lookup can miss or return a stale index, so callers check
+    // the entry itself and fall back to mHeaderIDMap.
+    class HeaderIndex
+    {
+    public:
+        void init(U32 max_entries);
+        void clear();
+        bool set(const LLUUID& id, S32 idx); // returns false when the table needs a rebuild
+        void erase(const LLUUID& id);
+        S32 find(const LLUUID& id) const;
+
+    private:
+        std::unique_ptr<std::atomic<U64>[]> mSlots;
+        U32 mMask = 0;
+        U32 mUsed = 0; // live and erased slots
+    };
+
+    LLMappedFile mHeaderMap;
+    std::atomic<bool> mHeaderMapped;
+    mutable std::atomic<S32> mHeaderMapReaders;
+    std::unique_ptr<std::atomic<U32>[]> mEntrySeqs; // per entry seqlocks for the mapped entries
+    U32 mMappedEntries;
+    HeaderIndex mHeaderIndex;
+    U32 mLRUTime; // when mLRU was built
 
     // BODIES (TEXTURES minus headers)
     std::string mTexturesDirName;
@@ -239,6 +302,17 @@ private:
     S64 mTexturesSizeTotal;
     LLAtomicBool mDoPurge;
 
+    // DECODED (raw or block compressed, per discard level)
+    std::string mDecodedDirName;
+    struct DecodedEntry
+    {
+        S32 mSize;
+        U32 mTime;
+    };
+    typedef std::map<std::pair<LLUUID, S32>, DecodedEntry> decoded_map_t;
+    decoded_map_t mDecodedMap;
+    S64 mDecodedSizeTotal;
+
     typedef std::map<S32, Entry> idx_entry_map_t;
     idx_entry_map_t mUpdatedEntryMap;
     typedef std::vector<std::pair<S32, Entry> > idx_entry_vector_t;
@@ -250,6 +324,7 @@ private:
     static std::string sHeaderCacheEncoderVersion;
     static U32 sCacheMaxEntries;
     static S64 sCacheMaxTexturesSize;
+    static S64 sCacheMaxDecodedSize;
 };
 
 extern const S32 TEXTURE_CACHE_ENTRY_SIZE;
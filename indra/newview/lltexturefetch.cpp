@@ -42,6 +42,7 @@
 
 #include "llagent.h"
 #include "lltexturecache.h"
+#include "lltexturefetchbenchmark.h"
 #include "llviewercontrol.h"
 #include "llviewertexturelist.h"
 #include "llviewertexture.h"
@@ -243,9 +244,12 @@ static const S32 HTTP_NONPIPE_REQUESTS_LOW_WATER = 20;
 static const S32 HTTP_REQUESTS_RANGE_END_MAX = 20000000;
 
 // stop after 720 seconds, might be overkill, but cap request can keep going forever.
-static const S32 MAX_CAP_MISSING_RETRIES = 720;
+const S32 MAX_CAP_MISSING_RETRIES = 720;
 static const S32 CAP_MISSING_EXPIRATION_DELAY = 1; // seconds
 
+// how much coarser the first pass of a progressive decode is
+static const S32 DECODE_REFINE_LEVELS = 2;
+
 //////////////////////////////////////////////////////////////////////////////
 namespace
 {
@@ -496,6 +500,14 @@ private:
     // Threads:  Ttf
     bool writeToCacheComplete();
 
+    // Threads:  T*
+    // Locks:  Mw
+    // Aux (sculpt/bake) decodes and local files don't go through the decoded cache
+    bool canUseDecodedCache() const
+    {
+        return !mNeedsAux && !mInLocalCache && mFTType != FTT_LOCAL_FILE;
+    }
+
     // Threads:  Ttf
     void recordTextureStart(bool is_http);
 
@@ -552,6 +564,7 @@ private:
     LLPointer<LLImageFormatted> mFormattedImage;
     LLPointer<LLImageRaw>       mRawImage,
                                 mAuxImage;
+    LLPointer<LLImageBC>        mCompressedImage;
     FTType mFTType;
     LLUUID mID;
     LLHost mHost;
@@ -588,6 +601,9 @@ private:
     handle_t mDecodeHandle;
     bool mLoaded;
     bool mDecoded;
+    bool mDecodeCoarse;   // the decode in flight is the coarse pass of a progressive decode
+    bool mDecodeRefining; // coarse pass is done and can be handed out, full level pending
+    bool mDecodedOnce;    // not reset by INIT, refinements after the first decode aren't progressive
     bool mWritten;
     bool mNeedsAux;
     bool mHaveAllData;
@@ -932,6 +948,9 @@ LLTextureFetchWorker::LLTextureFetchWorker(LLTextureFetch* fetcher,
       mSentRequest(UNSENT),
       mDecodeHandle(0),
       mDecoded(false),
+      mDecodeCoarse(false),
+      mDecodeRefining(false),
+      mDecodedOnce(false),
       mWritten(false),
       mNeedsAux(false),
       mHaveAllData(false),
@@ -1097,6 +1116,16 @@ void LLTextureFetchWorker::setDesiredDiscard(S32 discard, S32 size)
 void LLTextureFetchWorker::setImagePriority(F32 priority)
 {
     mImagePriority = priority; //should map to max virtual size, abort if zero
+
+    if (mDecodeHandle != 0 && mState == DECODE_IMAGE_UPDATE)
+    {
+        if (!LLAppViewer::getImageDecodeThread()->setPriority(mDecodeHandle, priority))
+        {
+            // Dropped before it started, doWork() decides what to do next
+            mDecodeHandle = 0;
+            setState(DECODE_IMAGE);
+        }
+    }
 }
 
 // Locks:  Mw
@@ -1154,7 +1183,9 @@ bool LLTextureFetchWorker::doWork(S32 param)
     {
         // <FS:Ansariel> OpenSim compatibility
         //if (mState == INIT || mState == LOAD_FROM_NETWORK)
-        if (mState == INIT || mState == LOAD_FROM_NETWORK || mState == LOAD_FROM_SIMULATOR)
+        if (mState == INIT || mState == LOAD_FROM_NETWORK || mState == LOAD_FROM_SIMULATOR
+            // Also don't decode what nobody wants anymore, unless it still has to be written to the cache
+            || (mState == DECODE_IMAGE && mWriteToCacheState != SHOULD_WRITE))
         // </FS:Ansariel>
         {
             LL_PROFILE_ZONE_NAMED_CATEGORY_THREAD("tfwdw - priority < 0");
@@ -1220,6 +1251,7 @@ bool LLTextureFetchWorker::doWork(S32 param)
         }
         mSkippedStatesTime = 0;
         mRawImage = NULL ;
+        mCompressedImage = NULL;
         mRequestedDiscard = -1;
         mLoadedDiscard = -1;
         mDecodedDiscard = -1;
@@ -1558,6 +1590,7 @@ bool LLTextureFetchWorker::doWork(S32 param)
         LL_PROFILE_ZONE_NAMED_CATEGORY_THREAD("tfwdw - SEND_HTTP_REQ");
         // Also used in llmeshrepository
         static LLCachedControl<bool> disable_range_req(gSavedSettings, "HttpRangeRequestsDisable", false);
+        static LLCachedControl<S32> coalesce_levels(gSavedSettings, "TextureFetchCoalesceLevels", 1);
 
         if (! mCanUseHTTP)
         {
@@ -1600,6 +1633,28 @@ bool LLTextureFetchWorker::doWork(S32 param)
         mRequestedDiscard = mDesiredDiscard;
         mRequestedSize -= cur_size;
         mRequestedOffset = cur_size;
+        if (cur_size > 0 && coalesce_levels > 0 && mDesiredDiscard > 0
+            && mFormattedImage->getCodec() == IMG_CODEC_J2C
+            && mFormattedImage->getWidth() > 0 && mFormattedImage->getComponents() > 0)
+        {
+            // This is a refinement of an image we already have the start
+            // of.  J2C codestreams are progressive, so each finer discard
+            // level is just more of the same stream: extend the range to
+            // cover the next few levels as well, and the refinements that
+            // follow will decode from the data in hand instead of paying
+            // for another request each.
+            S32 target_discard = llmax(mDesiredDiscard - (S32)coalesce_levels, 0);
+            S32 coalesced_size = (target_discard == 0)
+                ? MAX_IMAGE_DATA_SIZE
+                : LLImageJ2C::calcDataSizeJ2C(mFormattedImage->getWidth(),
+                                              mFormattedImage->getHeight(),
+                                              mFormattedImage->getComponents(),
+                                              target_discard);
+            if (coalesced_size > mDesiredSize)
+            {
+                mRequestedSize = coalesced_size - cur_size;
+            }
+        }
         if (mRequestedOffset)
         {
             // Texture fetching often issues 'speculative' loads that
@@ -1959,29 +2014,72 @@ bool LLTextureFetchWorker::doWork(S32 param)
             return true;
         }
         mDecodeTimer.reset();
-        mRawImage = NULL;
-        mAuxImage = NULL;
+        if (!mDecodeRefining)
+        {
+            mRawImage = NULL;
+            mAuxImage = NULL;
+            mCompressedImage = NULL;
+        }
+        // else keep the coarse pass around for getRequestFinished()
         llassert_always(mFormattedImage.notNull());
         S32 discard = mHaveAllData ? 0 : mLoadedDiscard;
         mDecoded  = false;
         setState(DECODE_IMAGE_UPDATE);
-        LL_DEBUGS(LOG_TXT) << mID << ": Decoding. Bytes: " << mFormattedImage->getDataSize() << " Discard: " << discard
-                           << " All Data: " << mHaveAllData << LL_ENDL;
-
-        // In case worked manages to request decode, be shut down,
-        // then init and request decode again with first decode
-        // still in progress, assign a sufficiently unique id
-        mDecodeHandle = LLAppViewer::getImageDecodeThread()->decodeImage(mFormattedImage,
-                                                                       discard,
-                                                                       mNeedsAux,
-                                                                       new DecodeResponder(mFetcher, mID, this));
-        if (mDecodeHandle == 0)
+
+        // Progressive decode: the first time a texture is decoded, decode a
+        // few levels coarser first so there is something to show while the
+        // full level decodes. The decode thread favors coarse levels, so this
+        // also gets every texture up on screen before any of them is sharp.
+        static LLCachedControl<bool> decode_progressive(gSavedSettings, "TextureDecodeProgressive", true);
+        S32 decode_discard = discard;
+        mDecodeCoarse = decode_progressive
+            && !mDecodeRefining
+            && !mDecodedOnce
+            && !mNeedsAux
+            && mFormattedImage->getCodec() == IMG_CODEC_J2C
+            && discard + DECODE_REFINE_LEVELS <= MAX_DISCARD_LEVEL;
+
+        if (canUseDecodedCache()
+            && mFetcher->mTextureCache->readFromDecodedCache(mID, discard, mFormattedImage->getDataSize(),
+                                                             mRawImage, mCompressedImage))
         {
-            // Abort, failed to put into queue.
-            // Happens if viewer is shutting down
-            setState(DONE);
-            LL_DEBUGS(LOG_TXT) << mID << " DECODE_IMAGE abort: failed to post for decoding" << LL_ENDL;
-            return true;
+            // Already decoded this level before, skip the decode thread
+            if (!LLImageGL::sBlockCompressTextures)
+            {
+                mCompressedImage = NULL;
+            }
+            mFormattedImage->setDiscardLevel(discard);
+            mDecodedDiscard = discard;
+            mDecodeCoarse = false;
+            mDecoded = true;
+            LL_DEBUGS(LOG_TXT) << mID << ": Decoded cache hit. Discard: " << discard
+                               << " Raw Image: " << llformat("%dx%d", mRawImage->getWidth(), mRawImage->getHeight()) << LL_ENDL;
+        }
+        else
+        {
+            if (mDecodeCoarse)
+            {
+                decode_discard = discard + DECODE_REFINE_LEVELS;
+            }
+            LL_DEBUGS(LOG_TXT) << mID << ": Decoding. Bytes: " << mFormattedImage->getDataSize() << " Discard: " << decode_discard
+                               << " All Data: " << mHaveAllData << LL_ENDL;
+
+            // In case worked manages to request decode, be shut down,
+            // then init and request decode again with first decode
+            // still in progress, assign a sufficiently unique id
+            mDecodeHandle = LLAppViewer::getImageDecodeThread()->decodeImage(mFormattedImage,
+                                                                           decode_discard,
+                                                                           mNeedsAux,
+                                                                           new DecodeResponder(mFetcher, mID, this),
+                                                                           mImagePriority);
+            if (mDecodeHandle == 0)
+            {
+                // Abort, failed to put into queue.
+                // Happens if viewer is shutting down
+                setState(DONE);
+                LL_DEBUGS(LOG_TXT) << mID << " DECODE_IMAGE abort: failed to post for decoding" << LL_ENDL;
+                return true;
+            }
         }
         // fall though
     }
@@ -1995,6 +2093,8 @@ bool LLTextureFetchWorker::doWork(S32 param)
 
             if (mDecodedDiscard < 0)
             {
+                mDecodeCoarse = false;
+                mDecodeRefining = false;
                 if (mCachedSize > 0 && !mInLocalCache && mRetryAttempt == 0)
                 {
                     // Cache file should be deleted, try again
@@ -2012,11 +2112,23 @@ bool LLTextureFetchWorker::doWork(S32 param)
                     setState(DONE); // failed
                 }
             }
+            else if (mDecodeCoarse)
+            {
+                // getRequestFinished() can hand this out now, go on with the full level
+                LL_DEBUGS(LOG_TXT) << mID << ": Decoded coarse pass. Discard: " << mDecodedDiscard << LL_ENDL;
+                mDecodedOnce = true;
+                mDecodeCoarse = false;
+                mDecodeRefining = true;
+                setState(DECODE_IMAGE);
+                return doWork(param);
+            }
             else
             {
                 llassert_always(mRawImage.notNull());
                 LL_DEBUGS(LOG_TXT) << mID << ": Decoded. Discard: " << mDecodedDiscard
                                    << " Raw Image: " << llformat("%dx%d",mRawImage->getWidth(),mRawImage->getHeight()) << LL_ENDL;
+                mDecodedOnce = true;
+                mDecodeRefining = false;
                 setState(WRITE_TO_CACHE);
             }
             // fall through
@@ -2555,46 +2667,78 @@ void LLTextureFetchWorker::callbackCacheWrite(bool success)
 // Threads:  Tid
 void LLTextureFetchWorker::callbackDecoded(bool success, const std::string &error_message, LLImageRaw* raw, LLImageRaw* aux, S32 decode_id)
 {
-    LLMutexLock lock(&mWorkMutex);                                      // +Mw
-    if (mDecodeHandle == 0)
-    {
-        return; // aborted, ignore
-    }
-    if (mDecodeHandle != decode_id)
+    // We're still on the decode thread here, so do the block compression
+    // before taking the work mutex. Local files get rescaled before upload.
+    LLPointer<LLImageBC> compressed;
+    if (success && raw && LLImageGL::sBlockCompressTextures && mFTType != FTT_LOCAL_FILE)
     {
-        // Queue doesn't support canceling old requests.
-        // This shouldn't normally happen, but in case it's possible that a worked
-        // will request decode, be aborted, reinited then start a new decode
-        LL_DEBUGS(LOG_TXT) << mID << " received obsolete decode's callback" << LL_ENDL;
-        return; // ignore
+        compressed = new LLImageBC();
+        if (!compressed->encode(raw))
+        {
+            compressed = NULL;
+        }
     }
-    if (mState != DECODE_IMAGE_UPDATE)
+
+    // Filled in under the lock, written out once it's released
+    S32 cache_discard = -1;
+    S32 cache_data_size = 0;
+    LLUUID id = mID;
+    LLTextureCache* cache = mFetcher->mTextureCache;
+
     {
-        LL_DEBUGS(LOG_TXT) << "Decode callback for " << mID << " with state = " << mState << LL_ENDL;
+        LLMutexLock lock(&mWorkMutex);                                  // +Mw
+        if (mDecodeHandle == 0)
+        {
+            return; // aborted, ignore
+        }
+        if (mDecodeHandle != decode_id)
+        {
+            // Queue doesn't support canceling old requests.
+            // This shouldn't normally happen, but in case it's possible that a worked
+            // will request decode, be aborted, reinited then start a new decode
+            LL_DEBUGS(LOG_TXT) << mID << " received obsolete decode's callback" << LL_ENDL;
+            return; // ignore
+        }
+        if (mState != DECODE_IMAGE_UPDATE)
+        {
+            LL_DEBUGS(LOG_TXT) << "Decode callback for " << mID << " with state = " << mState << LL_ENDL;
+            mDecodeHandle = 0;
+            return;
+        }
+        llassert_always(mFormattedImage.notNull());
+
         mDecodeHandle = 0;
-        return;
-    }
-    llassert_always(mFormattedImage.notNull());
+        if (success)
+        {
+            llassert_always(raw);
+            mRawImage = raw;
+            mAuxImage = aux;
+            mCompressedImage = compressed;
+            mDecodedDiscard = mFormattedImage->getDiscardLevel();
+            if (!aux && canUseDecodedCache())
+            {
+                cache_discard = mDecodedDiscard;
+                cache_data_size = mFormattedImage->getDataSize();
+            }
+            LL_DEBUGS(LOG_TXT) << mID << ": Decode Finished. Discard: " << mDecodedDiscard
+                               << " Raw Image: " << llformat("%dx%d",mRawImage->getWidth(),mRawImage->getHeight()) << LL_ENDL;
+        }
+        else
+        {
+            LL_WARNS(LOG_TXT) << "DECODE FAILED: " << mID << " Discard: " << (S32)mFormattedImage->getDiscardLevel() << ", reason: " << error_message << LL_ENDL;
+            removeFromCache();
+            mDecodedDiscard = -1; // Redundant, here for clarity and paranoia
+        }
+        mDecoded = true;
+//  LL_INFOS(LOG_TXT) << mID << " : DECODE COMPLETE " << LL_ENDL;
+    }                                                                   // -Mw
 
-    mDecodeHandle = 0;
-    if (success)
+    if (cache_discard >= 0)
     {
-        llassert_always(raw);
-        mRawImage = raw;
-        mAuxImage = aux;
-        mDecodedDiscard = mFormattedImage->getDiscardLevel();
-        LL_DEBUGS(LOG_TXT) << mID << ": Decode Finished. Discard: " << mDecodedDiscard
-                           << " Raw Image: " << llformat("%dx%d",mRawImage->getWidth(),mRawImage->getHeight()) << LL_ENDL;
+        // The worker may be gone by now, don't touch it
+        cache->writeToDecodedCache(id, cache_discard, cache_data_size, raw, compressed);
     }
-    else
-    {
-        LL_WARNS(LOG_TXT) << "DECODE FAILED: " << mID << " Discard: " << (S32)mFormattedImage->getDiscardLevel() << ", reason: " << error_message << LL_ENDL;
-        removeFromCache();
-        mDecodedDiscard = -1; // Redundant, here for clarity and paranoia
-    }
-    mDecoded = true;
-//  LL_INFOS(LOG_TXT) << mID << " : DECODE COMPLETE " << LL_ENDL;
-}                                                                       // -Mw
+}
 
 //////////////////////////////////////////////////////////////////////////////
 
@@ -2861,6 +3005,10 @@ S32 LLTextureFetch::createRequest(FTType f_type, const std::string& url, const L
 
     LL_DEBUGS(LOG_TXT) << "REQUESTED: " << id << " f_type " << fttype_to_string(f_type)
                        << " Discard: " << desired_discard << " size " << desired_size << LL_ENDL;
+    if (f_type == FTT_DEFAULT && LLTextureFetchBenchmark::isRecording())
+    {
+        LLTextureFetchBenchmark::recordRequest(id, w, h, c, desired_discard, priority);
+    }
     return desired_discard;
 }
 
@@ -3049,6 +3197,7 @@ LLTextureFetchWorker* LLTextureFetch::getWorker(const LLUUID& id)
 // Threads:  T*
 bool LLTextureFetch::getRequestFinished(const LLUUID& id, S32& discard_level,
                                         LLPointer<LLImageRaw>& raw, LLPointer<LLImageRaw>& aux,
+                                        LLPointer<LLImageBC>& compressed,
                                         LLCore::HttpStatus& last_http_get_status)
 {
     LL_PROFILE_ZONE_SCOPED;
@@ -3076,6 +3225,7 @@ bool LLTextureFetch::getRequestFinished(const LLUUID& id, S32& discard_level,
             F32 cache_read_time;
             F32 cache_write_time;
             S32 file_size;
+            bool in_cache;
             std::map<S32, F32> logged_state_timers;
             F32 skipped_states_time;
             worker->lockWorkMutex();                                    // +Mw
@@ -3083,12 +3233,14 @@ bool LLTextureFetch::getRequestFinished(const LLUUID& id, S32& discard_level,
             discard_level = worker->mDecodedDiscard;
             raw = worker->mRawImage;
             aux = worker->mAuxImage;
+            compressed = worker->mCompressedImage;
 
             decode_time = worker->mDecodeTime;
             fetch_time = worker->mFetchTime;
             cache_read_time = worker->mCacheReadTime;
             cache_write_time = worker->mCacheWriteTime;
             file_size = worker->mFileSize;
+            in_cache = worker->mInCache;
             worker->mCacheReadTimer.reset();
             worker->mDecodeTimer.reset();
             worker->mCacheWriteTimer.reset();
@@ -3105,6 +3257,11 @@ bool LLTextureFetch::getRequestFinished(const LLUUID& id, S32& discard_level,
             sample(sCacheReadLatency, cache_read_time);
             sample(sCacheWriteLatency, cache_write_time);
 
+            if (LLTextureFetchBenchmark::isReplaying())
+            {
+                LLTextureFetchBenchmark::recordFinished(id, fetch_time, cache_read_time, decode_time, file_size, in_cache);
+            }
+
             static LLCachedControl<F32> min_time_to_log(gSavedSettings, "TextureFetchMinTimeToLog", 2.f);
             if (fetch_time > min_time_to_log)
             {
@@ -3122,12 +3279,13 @@ bool LLTextureFetch::getRequestFinished(const LLUUID& id, S32& discard_level,
             worker->lockWorkMutex();                                    // +Mw
             if ((worker->mDecodedDiscard >= 0) &&
                 (worker->mDecodedDiscard < discard_level || discard_level < 0) &&
-                (worker->mState >= LLTextureFetchWorker::WAIT_ON_WRITE))
+                (worker->mState >= LLTextureFetchWorker::WAIT_ON_WRITE || worker->mDecodeRefining))
             {
                 // Not finished, but data is ready
                 discard_level = worker->mDecodedDiscard;
                 raw = worker->mRawImage;
                 aux = worker->mAuxImage;
+                compressed = worker->mCompressedImage;
             }
             worker->unlockWorkMutex();                                  // -Mw
         }
@@ -95,8 +95,10 @@ public:
 
     // Threads:  T*
     // keep in mind that if fetcher isn't done, it still might need original raw image
+    // compressed is the block compressed copy of raw, if RenderBlockCompressTextures made one
     bool getRequestFinished(const LLUUID& id, S32& discard_level,
                             LLPointer<LLImageRaw>& raw, LLPointer<LLImageRaw>& aux,
+                            LLPointer<LLImageBC>& compressed,
                             LLCore::HttpStatus& last_http_get_status);
 
     // Threads:  T*
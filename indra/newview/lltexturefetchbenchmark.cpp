@@ -0,0 +1,430 @@
+/**
+ * @file lltexturefetchbenchmark.cpp
+ * @brief Records texture requests and replays them as a fetch pipeline benchmark.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "lltexturefetchbenchmark.h"
+
+#include "llappviewer.h"
+#include "llglheaders.h"
+#include "llhost.h"
+#include "llimagegl.h"
+#include "llmutex.h"
+#include "llsdjson.h"
+#include "llsdserialize.h"
+#include "lltexturefetch.h"
+#include "lltimer.h"
+#include "llviewercontrol.h"
+
+#include <algorithm>
+
+bool LLTextureFetchBenchmark::sRecording = false;
+bool LLTextureFetchBenchmark::sReplaying = false;
+
+namespace
+{
+    // A request that hasn't finished after this long counts as failed
+    constexpr F64 REQUEST_TIMEOUT = 60.0;
+
+    struct Recording
+    {
+        LLMutex mMutex;
+        LLSD mRequests = LLSD::emptyArray();
+        std::map<LLUUID, S32> mLastDiscard;
+        LLTimer mTimer;
+        bool mStarted = false;
+        std::string mPath;
+    };
+
+    struct ReplayEntry
+    {
+        LLUUID mID;
+        S32 mWidth;
+        S32 mHeight;
+        S32 mComponents;
+        S32 mDiscard;
+        F32 mPriority;
+        F64 mTime;
+    };
+
+    struct Replay
+    {
+        LLMutex mMutex;
+        std::vector<ReplayEntry> mEntries;
+        size_t mNext = 0;
+        std::map<LLUUID, F64> mPending;     // id -> issue time
+        LLTimer mTimer;
+        bool mStarted = false;
+        std::string mURL;
+        std::string mReportPath;
+
+        std::vector<F32> mFetchMs;
+        std::vector<F32> mCacheReadMs;
+        std::vector<F32> mDecodeMs;
+        std::vector<F32> mUploadMs;
+        U64 mBytes = 0;
+        S32 mCompleted = 0;
+        S32 mFailed = 0;
+        S32 mCacheHits = 0;
+        S32 mCacheMisses = 0;
+    };
+
+    Recording* sRecordingp = nullptr;
+    Replay* sReplayp = nullptr;
+
+    LLSD summarize(std::vector<F32>& samples)
+    {
+        LLSD result = LLSD::emptyMap();
+        result["count"] = (LLSD::Integer)samples.size();
+        if (samples.empty())
+        {
+            return result;
+        }
+
+        std::sort(samples.begin(), samples.end());
+        auto percentile = [&samples](F64 p)
+        {
+            // nearest rank
+            size_t rank = (size_t)ceil(p * samples.size());
+            return (LLSD::Real)samples[llclamp(rank, (size_t)1, samples.size()) - 1];
+        };
+        F64 sum = 0.0;
+        for (F32 sample : samples)
+        {
+            sum += sample;
+        }
+        result["mean"] = sum / samples.size();
+        result["p50"] = percentile(0.50);
+        result["p90"] = percentile(0.90);
+        result["p99"] = percentile(0.99);
+        result["max"] = (LLSD::Real)samples.back();
+        return result;
+    }
+
+    void write_report(Replay& replay)
+    {
+        F64 duration = replay.mTimer.getElapsedTimeF64();
+
+        LLSD report;
+        report["requests"] = (LLSD::Integer)replay.mEntries.size();
+        report["completed"] = replay.mCompleted;
+        report["failed"] = replay.mFailed;
+        report["duration_s"] = duration;
+        report["source"] = replay.mURL.empty() ? "cache" : replay.mURL;
+
+        LLSD& throughput = report["throughput"];
+        throughput["textures_per_s"] = duration > 0.0 ? replay.mCompleted / duration : 0.0;
+        throughput["bytes"] = (LLSD::Real)replay.mBytes;
+        throughput["mbits_per_s"] = duration > 0.0 ? replay.mBytes * 8.0 / (duration * 1000000.0) : 0.0;
+
+        LLSD& cache = report["cache"];
+        S32 lookups = replay.mCacheHits + replay.mCacheMisses;
+        cache["hits"] = replay.mCacheHits;
+        cache["misses"] = replay.mCacheMisses;
+        cache["hit_rate"] = lookups ? (F64)replay.mCacheHits / lookups : 0.0;
+
+        LLSD& latency = report["latency_ms"];
+        latency["fetch"] = summarize(replay.mFetchMs);
+        latency["cache_read"] = summarize(replay.mCacheReadMs);
+        latency["decode"] = summarize(replay.mDecodeMs);
+        latency["upload"] = summarize(replay.mUploadMs);
+
+        llofstream out(replay.mReportPath.c_str());
+        if (!out.is_open())
+        {
+            LL_WARNS("TextureBenchmark") << "Unable to write report to " << replay.mReportPath << LL_ENDL;
+            return;
+        }
+        out << boost::json::serialize(LlsdToJson(report)) << std::endl;
+        LL_INFOS("TextureBenchmark") << "Replay finished: " << replay.mCompleted << " completed, "
+                                     << replay.mFailed << " failed in " << duration << "s, report in "
+                                     << replay.mReportPath << LL_ENDL;
+    }
+
+    bool load_replay(Replay& replay, const std::string& path)
+    {
+        llifstream in(path.c_str());
+        LLSD requests;
+        if (!in.is_open() || LLSDSerialize::fromXML(requests, in) <= 0 || !requests.isArray())
+        {
+            LL_WARNS("TextureBenchmark") << "Unable to read texture request list " << path << LL_ENDL;
+            return false;
+        }
+
+        for (LLSD::array_const_iterator it = requests.beginArray(); it != requests.endArray(); ++it)
+        {
+            const LLSD& request = *it;
+            ReplayEntry entry;
+            entry.mID = request["id"].asUUID();
+            entry.mWidth = request["width"].asInteger();
+            entry.mHeight = request["height"].asInteger();
+            entry.mComponents = request["components"].asInteger();
+            entry.mDiscard = request["discard"].asInteger();
+            entry.mPriority = (F32)request["priority"].asReal();
+            entry.mTime = request["time"].asReal();
+            if (entry.mID.notNull())
+            {
+                replay.mEntries.push_back(entry);
+            }
+        }
+        std::stable_sort(replay.mEntries.begin(), replay.mEntries.end(),
+                         [](const ReplayEntry& a, const ReplayEntry& b) { return a.mTime < b.mTime; });
+        return !replay.mEntries.empty();
+    }
+}
+
+// static
+void LLTextureFetchBenchmark::initClass()
+{
+    std::string record_path = gSavedSettings.getString("TextureFetchBenchmarkRecord");
+    std::string replay_path = gSavedSettings.getString("TextureFetchBenchmarkReplay");
+
+    if (!replay_path.empty())
+    {
+        sReplayp = new Replay;
+        if (!load_replay(*sReplayp, replay_path))
+        {
+            delete sReplayp;
+            sReplayp = nullptr;
+            return;
+        }
+        sReplayp->mURL = gSavedSettings.getString("TextureFetchBenchmarkURL");
+        sReplayp->mReportPath = gSavedSettings.getString("TextureFetchBenchmarkReport");
+        if (sReplayp->mReportPath.empty())
+        {
+            sReplayp->mReportPath = gDirUtilp->getExpandedFilename(LL_PATH_LOGS, "texture_benchmark.json");
+        }
+        sReplaying = true;
+        LL_INFOS("TextureBenchmark") << "Replaying " << sReplayp->mEntries.size() << " texture requests from "
+                                     << replay_path << LL_ENDL;
+    }
+    else if (!record_path.empty())
+    {
+        // Replays aren't recorded, they would only record themselves
+        sRecordingp = new Recording;
+        sRecordingp->mPath = record_path;
+        sRecording = true;
+    }
+}
+
+// static
+void LLTextureFetchBenchmark::cleanupClass()
+{
+    if (sRecordingp)
+    {
+        sRecording = false;
+        llofstream out(sRecordingp->mPath.c_str());
+        if (out.is_open())
+        {
+            LLSDSerialize::toPrettyXML(sRecordingp->mRequests, out);
+            LL_INFOS("TextureBenchmark") << "Recorded " << sRecordingp->mRequests.size() << " texture requests to "
+                                         << sRecordingp->mPath << LL_ENDL;
+        }
+        else
+        {
+            LL_WARNS("TextureBenchmark") << "Unable to write texture request list " << sRecordingp->mPath << LL_ENDL;
+        }
+        delete sRecordingp;
+        sRecordingp = nullptr;
+    }
+
+    if (sReplayp)
+    {
+        if (sReplaying)
+        {
+            // Quit before the replay finished, report what we have
+            sReplaying = false;
+            write_report(*sReplayp);
+        }
+        delete sReplayp;
+        sReplayp = nullptr;
+    }
+}
+
+// static
+void LLTextureFetchBenchmark::idle()
+{
+    LLTextureFetch* fetch = LLAppViewer::getTextureFetch();
+    if (!sReplaying || !fetch)
+    {
+        return;
+    }
+
+    Replay& replay = *sReplayp;
+    if (!replay.mStarted)
+    {
+        replay.mTimer.reset();
+        replay.mStarted = true;
+    }
+    F64 now = replay.mTimer.getElapsedTimeF64();
+
+    // Issue everything that is due
+    while (replay.mNext < replay.mEntries.size() && replay.mEntries[replay.mNext].mTime <= now)
+    {
+        const ReplayEntry& entry = replay.mEntries[replay.mNext++];
+        std::string url;
+        if (!replay.mURL.empty())
+        {
+            url = replay.mURL + "/?texture_id=" + entry.mID.asString();
+        }
+        S32 discard = fetch->createRequest(FTT_DEFAULT, url, entry.mID, LLHost(), entry.mPriority,
+                                           entry.mWidth, entry.mHeight, entry.mComponents, entry.mDiscard,
+                                           false, !url.empty());
+        LLMutexLock lock(&replay.mMutex);
+        if (discard >= 0)
+        {
+            // Refinements of a pending texture keep the original issue time
+            replay.mPending.emplace(entry.mID, now);
+        }
+        else if (!replay.mPending.count(entry.mID))
+        {
+            ++replay.mFailed;
+        }
+    }
+
+    // Collect finished requests.  Copy the ids, getRequestFinished()
+    // calls back into recordFinished() which takes the lock.
+    std::vector<std::pair<LLUUID, F64> > pending;
+    {
+        LLMutexLock lock(&replay.mMutex);
+        pending.assign(replay.mPending.begin(), replay.mPending.end());
+    }
+    for (const auto& item : pending)
+    {
+        const LLUUID& id = item.first;
+        S32 discard = -1;
+        LLPointer<LLImageRaw> raw, aux;
+        LLPointer<LLImageBC> compressed;
+        LLCore::HttpStatus status;
+        bool finished = fetch->getRequestFinished(id, discard, raw, aux, compressed, status);
+        if (finished)
+        {
+            F32 upload_ms = -1.f;
+            if (raw.notNull() && raw->getDataSize() > 0)
+            {
+                LLTimer upload_timer;
+                LLPointer<LLImageGL> image = new LLImageGL(false);
+                image->createGLTexture(0, raw);
+                glFinish();
+                upload_ms = upload_timer.getElapsedTimeF32() * 1000.f;
+            }
+            fetch->deleteRequest(id, false);
+
+            LLMutexLock lock(&replay.mMutex);
+            replay.mPending.erase(id);
+            if (upload_ms >= 0.f)
+            {
+                ++replay.mCompleted;
+                replay.mUploadMs.push_back(upload_ms);
+            }
+            else
+            {
+                ++replay.mFailed;
+            }
+        }
+        else if (now - item.second > REQUEST_TIMEOUT)
+        {
+            fetch->deleteRequest(id, true);
+            LLMutexLock lock(&replay.mMutex);
+            replay.mPending.erase(id);
+            ++replay.mFailed;
+        }
+    }
+
+    if (replay.mNext == replay.mEntries.size() && replay.mPending.empty())
+    {
+        sReplaying = false;
+        write_report(replay);
+        if (gSavedSettings.getBOOL("TextureFetchBenchmarkQuit"))
+        {
+            LLAppViewer::instance()->requestQuit();
+        }
+    }
+}
+
+// static
+void LLTextureFetchBenchmark::recordRequest(const LLUUID& id, S32 w, S32 h, S32 c, S32 discard, F32 priority)
+{
+    if (!sRecordingp)
+    {
+        return;
+    }
+
+    LLMutexLock lock(&sRecordingp->mMutex);
+    auto last = sRecordingp->mLastDiscard.find(id);
+    if (last != sRecordingp->mLastDiscard.end() && last->second == discard)
+    {
+        // Priority updates for the same level don't change what gets fetched
+        return;
+    }
+    sRecordingp->mLastDiscard[id] = discard;
+
+    if (!sRecordingp->mStarted)
+    {
+        sRecordingp->mTimer.reset();
+        sRecordingp->mStarted = true;
+    }
+
+    LLSD request;
+    request["id"] = id;
+    request["width"] = w;
+    request["height"] = h;
+    request["components"] = c;
+    request["discard"] = discard;
+    request["priority"] = priority;
+    request["time"] = sRecordingp->mTimer.getElapsedTimeF64();
+    sRecordingp->mRequests.append(request);
+}
+
+// static
+void LLTextureFetchBenchmark::recordFinished(const LLUUID& id, F32 fetch_time, F32 cache_read_time, F32 decode_time,
+                                             S32 file_size, bool from_cache)
+{
+    if (!sReplaying)
+    {
+        return;
+    }
+
+    Replay& replay = *sReplayp;
+    LLMutexLock lock(&replay.mMutex);
+    if (!replay.mPending.count(id))
+    {
+        // Some other texture the viewer is fetching
+        return;
+    }
+    replay.mFetchMs.push_back(fetch_time * 1000.f);
+    replay.mDecodeMs.push_back(decode_time * 1000.f);
+    replay.mBytes += llmax(file_size, 0);
+    if (from_cache)
+    {
+        ++replay.mCacheHits;
+        replay.mCacheReadMs.push_back(cache_read_time * 1000.f);
+    }
+    else
+    {
+        ++replay.mCacheMisses;
+    }
+}
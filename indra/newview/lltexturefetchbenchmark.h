@@ -0,0 +1,73 @@
+/**
+ * @file lltexturefetchbenchmark.h
+ * @brief Records texture requests and replays them as a fetch pipeline benchmark.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLTEXTUREFETCHBENCHMARK_H
+#define LL_LLTEXTUREFETCHBENCHMARK_H
+
+#include "lluuid.h"
+
+// Reproducible benchmark for the texture fetch pipeline.
+//
+// Record mode (TextureFetchBenchmarkRecord = path) logs every texture
+// request the session makes: UUID, known dimensions, discard level,
+// priority and time since the first request.  The list is written as
+// LLSD XML at shutdown.
+//
+// Replay mode (TextureFetchBenchmarkReplay = path) issues the recorded
+// requests against LLTextureFetch at their recorded offsets, without
+// needing a region: they go to TextureFetchBenchmarkURL (a local HTTP
+// server standing in for the texture capability) or, if that is empty,
+// to the on-disk cache only.  Each finished texture is uploaded once to
+// time the GL side.  When every request has finished or timed out, a
+// JSON report with fetch/decode/upload latency percentiles, throughput
+// and cache hit rates is written to TextureFetchBenchmarkReport, and the
+// viewer quits if TextureFetchBenchmarkQuit is set.
+class LLTextureFetchBenchmark
+{
+public:
+    // Threads:  Tmain
+    static void initClass();
+    static void cleanupClass();
+
+    // Drives a replay.  Call once per main loop iteration.
+    // Threads:  Tmain
+    static void idle();
+
+    // Hooks from LLTextureFetch.
+    // Threads:  T*
+    static void recordRequest(const LLUUID& id, S32 w, S32 h, S32 c, S32 discard, F32 priority);
+    static void recordFinished(const LLUUID& id, F32 fetch_time, F32 cache_read_time, F32 decode_time,
+                               S32 file_size, bool from_cache);
+
+    static bool isRecording() { return sRecording; }
+    static bool isReplaying() { return sReplaying; }
+
+private:
+    static bool sRecording;
+    static bool sReplaying;
+};
+
+#endif // LL_LLTEXTUREFETCHBENCHMARK_H
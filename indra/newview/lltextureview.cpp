@@ -204,6 +204,10 @@ void LLTextureBar::draw()
         mImagep->mMaxVirtualSize,
         mImagep->mDesiredDiscardLevel,
         mImagep->mRequestedDiscardLevel);
+    if (mImagep->mBudgetDiscardLevel > mImagep->mIdealDiscardLevel && mImagep->mIdealDiscardLevel >= 0)
+    { // held back by the streaming budget, show the level it would like
+        tex_str += llformat(" B%d", mImagep->mIdealDiscardLevel);
+    }
 
 
     LLFontGL::getFontMonospace()->renderUTF8(tex_str, 0, title_x1, getRect().getHeight(),
@@ -584,12 +588,28 @@ void LLGLTexMemBar::draw()
     gGL.color4f(0.f, 0.f, 0.f, 0.25f);
     gl_rect_2d(-10, getRect().getHeight() + line_height*2 + 1, getRect().getWidth()+2, getRect().getHeight()+2);
 
-    text = llformat("Est. Free: %d MB Sys Free: %d MB GL Tex: %d MB FBO: %d MB Bias: %.2f Cache: %.1f/%.1f MB",
+    const LLViewerTextureList::StreamingBudgetStats& streaming = gTextureList.getStreamingBudgetStats();
+    std::string bias_text;
+    if (streaming.mActive)
+    {
+        bias_text = llformat("Stream: %d/%d of %d MB Low: %d/%d",
+                             (S32)(streaming.mAssignedBytes / (1024.0 * 1024.0)),
+                             (S32)(streaming.mDesiredBytes / (1024.0 * 1024.0)),
+                             (S32)(streaming.mBudgetBytes / (1024.0 * 1024.0)),
+                             streaming.mNumReduced,
+                             streaming.mNumBudgeted);
+    }
+    else
+    {
+        bias_text = llformat("Bias: %.2f", discard_bias);
+    }
+
+    text = llformat("Est. Free: %d MB Sys Free: %d MB GL Tex: %d MB FBO: %d MB %s Cache: %.1f/%.1f MB",
                     (S32)LLViewerTexture::sFreeVRAMMegabytes,
                     LLMemory::getAvailableMemKB()/1024,
                     LLImageGL::getTextureBytesAllocated() / 1024 / 1024,
                     LLRenderTarget::sBytesAllocated/(1024*1024),
-                    discard_bias,
+                    bias_text.c_str(),
                     cache_usage,
                     cache_max_usage);
     // <FS:Ansariel> Texture memory bars
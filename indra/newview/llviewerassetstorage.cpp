@@ -28,6 +28,8 @@
 
 #include "llviewerassetstorage.h"
 
+#include "lldiskcache.h"
+#include "llfile.h"
 #include "llfilesystem.h"
 #include "message.h"
 
@@ -100,6 +102,75 @@ public:
     bool mWithHTTP;
 };
 
+/**
+ * @brief Spools an HTTP asset download straight into the cache.
+ *
+ * The body is written to a temporary cache entry as it arrives, on the
+ * HTTP transport thread, and renamed to the asset's entry once the
+ * request succeeds, so large animations and meshes are never held whole
+ * in memory.  Same create-then-rename flow as LLTransferTargetVFile.
+ */
+class LLAssetCacheSink : public LLCore::HttpBodySink
+{
+public:
+    LLAssetCacheSink(LLAssetType::EType type)
+        : mType(type),
+          mBytes(0),
+          mCommitted(false)
+    {
+        mTempID.generate();
+    }
+
+    ~LLAssetCacheSink()
+    {
+        mFile.close();
+        if (! mCommitted)
+        {
+            LLFileSystem::removeFile(mTempID, mType, ENOENT);
+        }
+    }
+
+    bool begin(size_t expected) override
+    {
+        // Starts over on retries
+        mBytes = 0;
+        mFile = LLFile::fopen(LLDiskCache::metaDataToFilepath(mTempID, mType), "wb");
+        if (! mFile)
+        {
+            LL_WARNS("ViewerAsset") << "Unable to create cache file for download" << LL_ENDL;
+            return false;
+        }
+        return true;
+    }
+
+    bool write(const char * data, size_t len) override
+    {
+        if (! mFile || fwrite(data, 1, len, mFile) != len)
+        {
+            return false;
+        }
+        mBytes += len;
+        return true;
+    }
+
+    // Moves the finished download to the asset's cache entry
+    bool commit(const LLUUID& asset_id)
+    {
+        mFile.close();
+        mCommitted = mBytes > 0 && LLFileSystem::renameFile(mTempID, mType, asset_id, mType);
+        return mCommitted;
+    }
+
+    S32 getBytes() const { return static_cast<S32>(mBytes); }
+
+private:
+    LLUUID              mTempID;
+    LLAssetType::EType  mType;
+    LLUniqueFile        mFile;
+    size_t              mBytes;
+    bool                mCommitted;
+};
+
 ///----------------------------------------------------------------------------
 /// LLViewerAssetStorage
 ///----------------------------------------------------------------------------
@@ -552,6 +623,8 @@ void LLViewerAssetStorage::assetRequestCoro(
         httpAdapter(new LLCoreHttpUtil::HttpCoroutineAdapter("assetRequestCoro", httpPolicy));
     LLCore::HttpRequest::ptr_t httpRequest(new LLCore::HttpRequest);
     LLCore::HttpOptions::ptr_t httpOpts = LLCore::HttpOptions::ptr_t(new LLCore::HttpOptions);
+    std::shared_ptr<LLAssetCacheSink> sink(std::make_shared<LLAssetCacheSink>(atype));
+    httpOpts->setBodySink(sink);
 
     LLSD result = httpAdapter->getRawAndSuspend(httpRequest, url, httpOpts);
 
@@ -571,44 +644,17 @@ void LLViewerAssetStorage::assetRequestCoro(
         result_code = LL_ERR_ASSET_REQUEST_FAILED;
         ext_status = LLExtStat::NONE;
     }
-    else if (!result.has(LLCoreHttpUtil::HttpCoroutineAdapter::HTTP_RESULTS_RAW))
-    {
-        LL_DEBUGS("ViewerAsset") << "request failed, no data returned!" << LL_ENDL;
-        result_code = LL_ERR_ASSET_REQUEST_FAILED;
-        ext_status = LLExtStat::NONE;
-    }
-    else if (!result[LLCoreHttpUtil::HttpCoroutineAdapter::HTTP_RESULTS_RAW].isBinary())
-    {
-        LL_DEBUGS("ViewerAsset") << "request failed, invalid data format!" << LL_ENDL;
-        result_code = LL_ERR_ASSET_REQUEST_FAILED;
-        ext_status = LLExtStat::NONE;
-    }
     else
     {
         LL_DEBUGS("ViewerAsset") << "request succeeded, url " << url << LL_ENDL;
 
-        const LLSD::Binary &raw = result[LLCoreHttpUtil::HttpCoroutineAdapter::HTTP_RESULTS_RAW].asBinary();
-
-        S32 size = static_cast<S32>(raw.size());
+        // The body went straight to the cache, see LLAssetCacheSink
+        S32 size = sink->getBytes();
         if (size > 0)
         {
             mTotalBytesFetched += size;
-
-            // This create-then-rename flow is modeled on
-            // LLTransferTargetVFile, which is what's used in the UDP
-            // case.
-            LLUUID temp_id;
-            temp_id.generate();
-            LLFileSystem vf(temp_id, atype, LLFileSystem::WRITE);
             req->mBytesFetched = size;
-            if (!vf.write(raw.data(),size))
-            {
-                // TODO asset-http: handle error
-                LL_WARNS("ViewerAsset") << "Failure in vf.write()" << LL_ENDL;
-                result_code = LL_ERR_ASSET_REQUEST_FAILED;
-                ext_status = LLExtStat::CACHE_CORRUPT;
-            }
-            else if (!vf.rename(uuid, atype))
+            if (!sink->commit(uuid))
             {
                 LL_WARNS("ViewerAsset") << "rename failed" << LL_ENDL;
                 result_code = LL_ERR_ASSET_REQUEST_FAILED;
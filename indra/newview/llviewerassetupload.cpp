@@ -402,6 +402,45 @@ LLSD LLNewFileResourceUploadInfo::prepareUpload()
     return LLResourceUploadInfo::prepareUpload();
 }
 
+LLAtomicS32 LLNewFileResourceUploadInfo::sPendingEncodes(0);
+
+void LLNewFileResourceUploadInfo::startPrepare()
+{
+    LLAssetType::EType assetType = LLAssetType::AT_NONE;
+    U32 codec = IMG_CODEC_INVALID;
+    if (mEncode.valid() ||
+        !findAssetTypeAndCodecOfExtension(gDirUtilp->getExtension(getFileName()), assetType, codec) ||
+        assetType != LLAssetType::AT_TEXTURE)
+    {
+        return;
+    }
+
+    mEncodedFilename = gDirUtilp->getTempFilename();
+    ++sPendingEncodes;
+    try
+    {
+        mEncode = LL::postFuture("General",
+            [source = getFileName(), dest = mEncodedFilename, codec = (U8)codec, max_size = mMaxImageSize]()
+            {
+                EncodeResult encoded;
+                encoded.mSuccess = LLViewerTextureList::createUploadFile(source, dest, codec, max_size);
+                if (!encoded.mSuccess)
+                {
+                    // per thread, pick it up before leaving the worker
+                    encoded.mError = LLImage::getLastThreadError();
+                }
+                --sPendingEncodes;
+                return encoded;
+            });
+    }
+    catch (const LL::WorkQueueBase::Closed&)
+    {
+        // no thread pool, exportTempFile() encodes in place
+        --sPendingEncodes;
+        mEncodedFilename.clear();
+    }
+}
+
 LLSD LLNewFileResourceUploadInfo::exportTempFile()
 {
     std::string filename = gDirUtilp->getTempFilename();
@@ -439,13 +478,42 @@ LLSD LLNewFileResourceUploadInfo::exportTempFile()
     }
     else if (assetType == LLAssetType::AT_TEXTURE)
     {
-        // It's an image file, the upload procedure is the same for all
-        if (!LLViewerTextureList::createUploadFile(getFileName(), filename, codec, mMaxImageSize))
+        EncodeResult encoded;
+        if (mEncode.valid())
+        {
+            // started by startPrepare(), we are on the upload coroutine
+            bool show_progress = !mEncode.isReady() && showUploadDialog();
+            if (show_progress)
+            {
+                LLStringUtil::format_map_t args;
+                args["ASSET_NAME"] = getDisplayName();
+                args["COUNT"] = llformat("%d", llmax(sPendingEncodes.CurrentValue(), 1));
+                LLUploadDialog::modalUploadDialog(LLTrans::getString("Asset_Encoding", args));
+            }
+            encoded = mEncode.get();
+            mEncode = LL::WorkFuture<EncodeResult>();
+            filename = mEncodedFilename;
+            if (show_progress)
+            {
+                LLUploadDialog::modalUploadFinished();
+            }
+        }
+        else
+        {
+            // It's an image file, the upload procedure is the same for all
+            encoded.mSuccess = LLViewerTextureList::createUploadFile(getFileName(), filename, codec, mMaxImageSize);
+            if (!encoded.mSuccess)
+            {
+                encoded.mError = LLImage::getLastThreadError();
+            }
+        }
+
+        if (!encoded.mSuccess)
         {
             // <FS:Ansariel> Duplicate error message output
             //errorMessage = llformat("Problem with file %s:\n\n%s\n",
             //    getFileName().c_str(), LLImage::getLastThreadError().c_str());
-            errorMessage = LLImage::getLastThreadError();
+            errorMessage = encoded.mError;
             // </FS:Ansariel>
             errorLabel = "ProblemWithFile";
             error = true;
@@ -877,6 +945,9 @@ LLUUID LLViewerAssetUpload::EnqueueInventoryUpload(const std::string &url, const
 {
     std::string procName("LLViewerAssetUpload::AssetInventoryUploadCoproc(");
 
+    // Uploads run one after another, but their encoding doesn't have to
+    uploadInfo->startPrepare();
+
     LLUUID queueId = LLCoprocedureManager::instance().enqueueCoprocedure("Upload",
         procName + LLAssetType::lookup(uploadInfo->getAssetType()) + ")",
         boost::bind(&LLViewerAssetUpload::AssetInventoryUploadCoproc, _1, _2, url, uploadInfo));
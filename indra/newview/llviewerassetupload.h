@@ -35,6 +35,8 @@
 #include "llcoros.h"
 #include "llcorehttputil.h"
 #include "llimage.h"
+#include "llatomic.h"
+#include "workfuture.h"
 
 //=========================================================================
 class LLResourceUploadInfo
@@ -59,6 +61,8 @@ public:
     virtual ~LLResourceUploadInfo()
     { }
 
+    // Start slow work of prepareUpload() on the thread pool; prepareUpload() waits for it
+    virtual void        startPrepare() {}
     virtual LLSD        prepareUpload();
     virtual LLSD        generatePostBody();
     virtual void        logPreparedUpload();
@@ -157,6 +161,9 @@ public:
         S32 expectedCost,
         bool show_inventory = true);
 
+    // Textures are encoded to J2C on the "General" thread pool, so a bulk upload encodes
+    // several files at once
+    virtual void        startPrepare();
     virtual LLSD        prepareUpload();
 
     std::string         getFileName() const { return mFileName; };
@@ -168,8 +175,20 @@ protected:
     virtual LLSD        exportTempFile();
 
 private:
+    struct EncodeResult
+    {
+        bool        mSuccess = false;
+        std::string mError;
+    };
+
     std::string         mFileName;
     S32                 mMaxImageSize;
+
+    LL::WorkFuture<EncodeResult> mEncode;
+    std::string         mEncodedFilename;
+
+    // started by startPrepare() and not finished yet, for all uploads
+    static LLAtomicS32  sPendingEncodes;
 };
 
 //-------------------------------------------------------------------------
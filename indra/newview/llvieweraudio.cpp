@@ -482,6 +482,9 @@ void audio_update_volume(bool force_update)
 
         gAudiop->setMasterGain ( master_volume );
 
+        static LLCachedControl<U32> decoded_cache_mb(gSavedSettings, "AudioDecodedCacheMB", 32);
+        gAudiop->setDecodedCacheSize((size_t)decoded_cache_mb * 1024 * 1024);
+
         const F32 AUDIO_LEVEL_DOPPLER = 1.f;
         gAudiop->setDopplerFactor(AUDIO_LEVEL_DOPPLER);
 
@@ -1072,6 +1072,11 @@ void handleDiskCacheLowWaterPctChanged(const LLSD& newValue)
 }
 // </FS:Beq>
 
+void handleDiskCachePackMaxFileSizeChanged(const LLSD& newValue)
+{
+    LLDiskCache::getInstance()->setPackMaxFileSize((U32)newValue.asInteger());
+}
+
 void handleTargetFPSChanged(const LLSD& newValue)
 {
     const auto targetFPS = gSavedSettings.getU32("TargetFPS");
@@ -1099,12 +1104,26 @@ void handleAutoTuneFPSChanged(const LLSD& newValue)
 {
     const auto newval = gSavedSettings.getBOOL("AutoTuneFPS");
     LLPerfStats::tunables.userAutoTuneEnabled = newval;
+    if (!newval)
+    {
+        // hand back the scene features autotune took away
+        LLPerfStats::tunables.restoreSceneFeatures();
+    }
     if(newval && LLPerfStats::renderAvatarMaxART_ns == 0) // If we've enabled autotune we override "unlimited" to max
     {
         gSavedSettings.setF32("RenderAvatarMaxART", (F32)log10(LLPerfStats::ART_UNLIMITED_NANOS-1000));//triggers callback to update static var
     }
 }
 
+void handleAutoTuneSceneFeaturesChanged(const LLSD& newValue)
+{
+    LLPerfStats::tunables.userSceneFeatureTuning = newValue.asBoolean();
+    if (!LLPerfStats::tunables.userSceneFeatureTuning)
+    {
+        LLPerfStats::tunables.restoreSceneFeatures();
+    }
+}
+
 void handleRenderAvatarMaxARTChanged(const LLSD& newValue)
 {
     LLPerfStats::tunables.updateRenderCostLimitFromSettings();
@@ -1230,36 +1249,44 @@ void setting_setup_signal_listener(LLControlGroup& group, const std::string& set
     });
 }
 
+// Handlers connected under the same key run once per frame, however many of their settings
+// changed.  They get no new value and must read the settings themselves.
+void setting_setup_batched_listener(LLControlGroup& group, const std::string& setting, const std::string& key, std::function<void(const LLSD& newvalue)> callback)
+{
+    setting_get_control(group, setting);
+    group.connectBatched(setting, key, [callback]() { callback(LLSD()); });
+}
+
 void settings_setup_listeners()
 {
     setting_setup_signal_listener(gSavedSettings, "FirstPersonAvatarVisible", handleRenderAvatarMouselookChanged);
     setting_setup_signal_listener(gSavedSettings, "RenderFarClip", handleRenderFarClipChanged);
     setting_setup_signal_listener(gSavedSettings, "RenderTerrainScale", handleTerrainScaleChanged);
     setting_setup_signal_listener(gSavedSettings, "RenderTerrainPBRScale", handlePBRTerrainScaleChanged);
-    setting_setup_signal_listener(gSavedSettings, "RenderTerrainPBRDetail", handleSetShaderChanged);
-    setting_setup_signal_listener(gSavedSettings, "RenderTerrainPBRPlanarSampleCount", handleSetShaderChanged);
-    setting_setup_signal_listener(gSavedSettings, "RenderTerrainPBRTriplanarBlendFactor", handleSetShaderChanged);
+    setting_setup_batched_listener(gSavedSettings, "RenderTerrainPBRDetail", "SetShaderChanged", handleSetShaderChanged);
+    setting_setup_batched_listener(gSavedSettings, "RenderTerrainPBRPlanarSampleCount", "SetShaderChanged", handleSetShaderChanged);
+    setting_setup_batched_listener(gSavedSettings, "RenderTerrainPBRTriplanarBlendFactor", "SetShaderChanged", handleSetShaderChanged);
     setting_setup_signal_listener(gSavedSettings, "OctreeStaticObjectSizeFactor", handleRepartition);
     setting_setup_signal_listener(gSavedSettings, "OctreeDistanceFactor", handleRepartition);
     setting_setup_signal_listener(gSavedSettings, "OctreeMaxNodeCapacity", handleRepartition);
     setting_setup_signal_listener(gSavedSettings, "OctreeAlphaDistanceFactor", handleRepartition);
     setting_setup_signal_listener(gSavedSettings, "OctreeAttachmentSizeFactor", handleRepartition);
-    setting_setup_signal_listener(gSavedSettings, "RenderMaxTextureIndex", handleSetShaderChanged);
+    setting_setup_batched_listener(gSavedSettings, "RenderMaxTextureIndex", "SetShaderChanged", handleSetShaderChanged);
     setting_setup_signal_listener(gSavedSettings, "RenderUIBuffer", handleWindowResized);
-    setting_setup_signal_listener(gSavedSettings, "RenderDepthOfField", handleReleaseGLBufferChanged);
-    setting_setup_signal_listener(gSavedSettings, "RenderFSAASamples", handleReleaseGLBufferChanged);
-    setting_setup_signal_listener(gSavedSettings, "RenderPostProcessingHDR", handleReleaseGLBufferChanged);
+    setting_setup_batched_listener(gSavedSettings, "RenderDepthOfField", "ReleaseGLBufferChanged", handleReleaseGLBufferChanged);
+    setting_setup_batched_listener(gSavedSettings, "RenderFSAASamples", "ReleaseGLBufferChanged", handleReleaseGLBufferChanged);
+    setting_setup_batched_listener(gSavedSettings, "RenderPostProcessingHDR", "ReleaseGLBufferChanged", handleReleaseGLBufferChanged);
     setting_setup_signal_listener(gSavedSettings, "RenderSpecularResX", handleLUTBufferChanged);
     setting_setup_signal_listener(gSavedSettings, "RenderSpecularResY", handleLUTBufferChanged);
     setting_setup_signal_listener(gSavedSettings, "RenderSpecularExponent", handleLUTBufferChanged);
     setting_setup_signal_listener(gSavedSettings, "RenderAnisotropic", handleAnisotropicChanged);
     setting_setup_signal_listener(gSavedSettings, "RenderShadowResolutionScale", handleShadowsResized);
-    setting_setup_signal_listener(gSavedSettings, "RenderGlow", handleReleaseGLBufferChanged);
-    setting_setup_signal_listener(gSavedSettings, "RenderGlow", handleSetShaderChanged);
-    setting_setup_signal_listener(gSavedSettings, "RenderGlowResolutionPow", handleReleaseGLBufferChanged);
-    setting_setup_signal_listener(gSavedSettings, "RenderGlowHDR", handleReleaseGLBufferChanged);
-    setting_setup_signal_listener(gSavedSettings, "RenderGlowNoise", handleSetShaderChanged);
-    setting_setup_signal_listener(gSavedSettings, "RenderGammaFull", handleSetShaderChanged);
+    setting_setup_batched_listener(gSavedSettings, "RenderGlow", "ReleaseGLBufferChanged", handleReleaseGLBufferChanged);
+    setting_setup_batched_listener(gSavedSettings, "RenderGlow", "SetShaderChanged", handleSetShaderChanged);
+    setting_setup_batched_listener(gSavedSettings, "RenderGlowResolutionPow", "ReleaseGLBufferChanged", handleReleaseGLBufferChanged);
+    setting_setup_batched_listener(gSavedSettings, "RenderGlowHDR", "ReleaseGLBufferChanged", handleReleaseGLBufferChanged);
+    setting_setup_batched_listener(gSavedSettings, "RenderGlowNoise", "SetShaderChanged", handleSetShaderChanged);
+    setting_setup_batched_listener(gSavedSettings, "RenderGammaFull", "SetShaderChanged", handleSetShaderChanged);
     setting_setup_signal_listener(gSavedSettings, "FSOverrideVRAMDetection", handleOverrideVRAMDetectionChanged); // <FS:Beq/> Override VRAM detection support
     setting_setup_signal_listener(gSavedSettings, "RenderVolumeLODFactor", handleVolumeLODChanged);
     setting_setup_signal_listener(gSavedSettings, "RenderAvatarComplexityMode", handleUserImpostorByDistEnabledChanged);
@@ -1273,7 +1300,7 @@ void settings_setup_listeners()
     setting_setup_signal_listener(gSavedSettings, "RenderMaxPartCount", handleMaxPartCountChanged);
     setting_setup_signal_listener(gSavedSettings, "RenderDynamicLOD", handleRenderDynamicLODChanged);
     setting_setup_signal_listener(gSavedSettings, "RenderVSyncEnable", handleVSyncChanged);
-    setting_setup_signal_listener(gSavedSettings, "RenderDeferredNoise", handleReleaseGLBufferChanged);
+    setting_setup_batched_listener(gSavedSettings, "RenderDeferredNoise", "ReleaseGLBufferChanged", handleReleaseGLBufferChanged);
     setting_setup_signal_listener(gSavedSettings, "RenderDebugPipeline", handleRenderDebugPipelineChanged);
     setting_setup_signal_listener(gSavedSettings, "RenderResolutionDivisor", handleRenderResolutionDivisorChanged);
 // [SL:KB] - Patch: Settings-RenderResolutionMultiplier | Checked: Catznip-5.4
@@ -1285,8 +1312,8 @@ void settings_setup_listeners()
     setting_setup_signal_listener(gSavedSettings, "RenderScreenSpaceReflections", handleReflectionProbeDetailChanged);
     setting_setup_signal_listener(gSavedSettings, "RenderMirrors", handleReflectionProbeDetailChanged);
     setting_setup_signal_listener(gSavedSettings, "RenderHeroProbeResolution", handleHeroProbeResolutionChanged);
-    setting_setup_signal_listener(gSavedSettings, "RenderShadowDetail", handleSetShaderChanged);
-    setting_setup_signal_listener(gSavedSettings, "RenderDeferredSSAO", handleSetShaderChanged);
+    setting_setup_batched_listener(gSavedSettings, "RenderShadowDetail", "SetShaderChanged", handleSetShaderChanged);
+    setting_setup_batched_listener(gSavedSettings, "RenderDeferredSSAO", "SetShaderChanged", handleSetShaderChanged);
     setting_setup_signal_listener(gSavedSettings, "RenderPerformanceTest", handleRenderPerfTestChanged);
     setting_setup_signal_listener(gSavedSettings, "ChatConsoleFontSize", handleChatFontSizeChanged);
     setting_setup_signal_listener(gSavedSettings, "ChatPersistTime", handleChatPersistTimeChanged); // <FS:Ansariel> Keep custom chat persist time
@@ -1392,6 +1419,7 @@ void settings_setup_listeners()
     setting_setup_signal_listener(gSavedSettings, "TargetFPS", handleTargetFPSChanged);
     setting_setup_signal_listener(gSavedSettings, "AutoTuneFPS", handleAutoTuneFPSChanged);
     setting_setup_signal_listener(gSavedSettings, "AutoTuneLock", handleAutoTuneLockChanged);
+    setting_setup_signal_listener(gSavedSettings, "AutoTuneSceneFeatures", handleAutoTuneSceneFeaturesChanged);
     setting_setup_signal_listener(gSavedSettings, "RenderAvatarMaxART", handleRenderAvatarMaxARTChanged);
     setting_setup_signal_listener(gSavedSettings, "PerfStatsCaptureEnabled", handlePerformanceStatsEnabledChanged);
     setting_setup_signal_listener(gSavedSettings, "AutoTuneRenderFarClipTarget", handleUserTargetDrawDistanceChanged);
@@ -1419,7 +1447,7 @@ void settings_setup_listeners()
             }
         }
     }
-    setting_setup_signal_listener(gSavedSettings, "TerrainPaintBitDepth", handleSetShaderChanged);
+    setting_setup_batched_listener(gSavedSettings, "TerrainPaintBitDepth", "SetShaderChanged", handleSetShaderChanged);
 
     setting_setup_signal_listener(gSavedPerAccountSettings, "AvatarHoverOffsetZ", handleAvatarHoverOffsetChanged);
 
@@ -1507,6 +1535,7 @@ void settings_setup_listeners()
     setting_setup_signal_listener(gSavedSettings, "FSDiskCacheHighWaterPercent", handleDiskCacheHighWaterPctChanged);
     setting_setup_signal_listener(gSavedSettings, "FSDiskCacheLowWaterPercent", handleDiskCacheLowWaterPctChanged);
     // </FS:Beq>
+    setting_setup_signal_listener(gSavedSettings, "DiskCachePackMaxFileSize", handleDiskCachePackMaxFileSizeChanged);
 
     // <FS:Zi> Handle IME text input getting enabled or disabled
 #if LL_SDL2
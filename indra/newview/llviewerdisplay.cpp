@@ -38,9 +38,13 @@
 #include "llcoord.h"
 #include "llcriticaldamp.h"
 #include "lldir.h"
+#include "llgpupasstimer.h"
 #include "lldynamictexture.h"
 #include "lldrawpoolalpha.h"
 #include "llfeaturemanager.h"
+#include "llflightrecorder.h"
+#include "llframepacer.h"
+#include "llframesnapshot.h"
 //#include "llfirstuse.h"
 #include "llhudmanager.h"
 #include "llimagepng.h"
@@ -205,7 +209,8 @@ void display_update_camera()
     F32 final_far = gAgentCamera.mDrawDistance;
     if (gCubeSnapshot)
     {
-        final_far = gSavedSettings.getF32("RenderReflectionProbeDrawDistance");
+        static LLCachedControl<F32> probe_draw_distance(gSavedSettings, "RenderReflectionProbeDrawDistance");
+        final_far = probe_draw_distance;
     }
     else if (CAMERA_MODE_CUSTOMIZE_AVATAR == gAgentCamera.getCameraMode())
 
@@ -573,7 +578,9 @@ void display(bool rebuild, F32 zoom_factor, int subfield, bool for_snapshot)
     LLAppViewer::instance()->pingMainloopTimeout("Display:TextureStats");
     stop_glerror();
 
-    LLImageGL::updateStats(gFrameTimeSeconds);
+    const LLFrameSnapshot& frame = LLFrameSnapshot::get();
+
+    LLImageGL::updateStats(frame.mFrameTime);
 
 // <FS:CR> Aurora sim
     //LLVOAvatar::sRenderName = gSavedSettings.getS32("AvatarNameTagMode");
@@ -664,8 +671,8 @@ void display(bool rebuild, F32 zoom_factor, int subfield, bool for_snapshot)
             gSavedSettings.setF32("FSSavedRenderFarClip", 0.0f);
         }
 
-        if (gTeleportArrivalTimer.getElapsedTimeF32() >=
-            (F32)gSavedSettings.getU32("FSRenderFarClipSteppingInterval"))
+        static LLCachedControl<U32> stepping_interval(gSavedSettings, "FSRenderFarClipSteppingInterval");
+        if (gTeleportArrivalTimer.getElapsedTimeF32() >= (F32)stepping_interval)
         {
             gTeleportArrivalTimer.reset();
             F32 current = gSavedSettings.getF32("RenderFarClip");
@@ -804,7 +811,7 @@ void display(bool rebuild, F32 zoom_factor, int subfield, bool for_snapshot)
 
         {
             LL_PROFILE_ZONE_NAMED_CATEGORY_DISPLAY("Update Geom");
-            const F32 max_geom_update_time = 0.005f*10.f*gFrameIntervalSeconds.value(); // 50 ms/second update time
+            const F32 max_geom_update_time = 0.005f*10.f*frame.mFrameInterval; // 50 ms/second update time
             gPipeline.createObjects(max_geom_update_time);
             gPipeline.processPartitionQ();
             gPipeline.updateGeom(max_geom_update_time);
@@ -834,7 +841,7 @@ void display(bool rebuild, F32 zoom_factor, int subfield, bool for_snapshot)
 
         static LLCullResult result;
         LLViewerCamera::sCurCameraID = LLViewerCamera::CAMERA_WORLD;
-        LLPipeline::sUnderWaterRender = LLViewerCamera::getInstance()->cameraUnderWater();
+        LLPipeline::sUnderWaterRender = frame.mCameraUnderWater;
         gPipeline.updateCull(*LLViewerCamera::getInstance(), result);
         stop_glerror();
 
@@ -857,9 +864,12 @@ void display(bool rebuild, F32 zoom_factor, int subfield, bool for_snapshot)
 
             if (!for_snapshot)
             {
+                gPipeline.beginSceneTimer();
+
                 if (gFrameCount > 1 && !for_snapshot)
                 { //for some reason, ATI 4800 series will error out if you
                   //try to generate a shadow before the first frame is through
+                    LLFlightRecorder::getInstance()->markGPU("Shadows");
                     gPipeline.generateSunShadow(*LLViewerCamera::getInstance());
                 }
 
@@ -910,7 +920,7 @@ void display(bool rebuild, F32 zoom_factor, int subfield, bool for_snapshot)
 
             {
                 LL_PROFILE_ZONE_NAMED_CATEGORY_DISPLAY("List");
-                F32 max_image_decode_time = 0.050f*gFrameIntervalSeconds.value(); // 50 ms/second decode time
+                F32 max_image_decode_time = 0.050f*frame.mFrameInterval; // 50 ms/second decode time
                 max_image_decode_time = llclamp(max_image_decode_time, 0.002f, 0.005f ); // min 2ms/frame, max 5ms/frame)
                 gTextureList.updateImages(max_image_decode_time);
             }
@@ -1083,6 +1093,7 @@ void display(bool rebuild, F32 zoom_factor, int subfield, bool for_snapshot)
             }
 
             gGL.setColorMask(true, true);
+            LLFlightRecorder::getInstance()->markGPU("Geometry");
             gPipeline.renderGeomDeferred(*LLViewerCamera::getInstance(), true);
         }
 
@@ -1105,6 +1116,7 @@ void display(bool rebuild, F32 zoom_factor, int subfield, bool for_snapshot)
 
         if (LLPipeline::sRenderDeferred)
         {
+            LLFlightRecorder::getInstance()->markGPU("Lighting");
             gPipeline.renderDeferredLighting();
         }
 
@@ -1150,6 +1162,7 @@ void display_cube_face()
 {
     LL_PROFILE_ZONE_NAMED_CATEGORY_DISPLAY("Render Cube Face");
     LL_PROFILE_GPU_ZONE("display cube face");
+    LL_RECORD_GPU_PASS("display cube face");
 
     llassert(!gSnapshot);
     llassert(!gTeleportDisplay);
@@ -1479,6 +1492,7 @@ void render_ui(F32 zoom_factor, int subfield)
     LLPerfStats::RecordSceneTime T ( LLPerfStats::StatType_t::RENDER_UI ); // render time capture - Primary UI stat can have HUD time overlap (TODO)
     LL_PROFILE_ZONE_SCOPED_CATEGORY_UI; //LL_RECORD_BLOCK_TIME(FTM_RENDER_UI);
     LL_PROFILE_GPU_ZONE("ui");
+    LL_RECORD_GPU_PASS("ui");
     LLGLState::checkStates();
 
     glh::matrix4f saved_view = get_current_modelview();
@@ -1500,8 +1514,14 @@ void render_ui(F32 zoom_factor, int subfield)
     }
 
     // apply gamma correction and post effects
+    LLFlightRecorder::getInstance()->markGPU("Post and UI");
     gPipeline.renderFinalize();
 
+    if (!gSnapshot)
+    {
+        gPipeline.endSceneTimer();
+    }
+
     {
         LLGLState::checkStates();
 
@@ -1565,9 +1585,11 @@ void swap()
     LLPerfStats::RecordSceneTime T ( LLPerfStats::StatType_t::RENDER_SWAP ); // render time capture - Swap buffer time - can signify excessive data transfer to/from GPU
     LL_PROFILE_ZONE_NAMED_CATEGORY_DISPLAY("Swap");
     LL_PROFILE_GPU_ZONE("swap");
+    LLFlightRecorder::getInstance()->markGPU("Swap");
     if (gDisplaySwapBuffers)
     {
         gViewerWindow->getWindow()->swapBuffers();
+        LLFramePacer::getInstance()->markSwap();
     }
     gDisplaySwapBuffers = true;
 }
@@ -1627,7 +1649,7 @@ void draw_axes()
     LLGLSUIDefault gls_ui;
     gGL.getTexUnit(0)->unbind(LLTexUnit::TT_TEXTURE);
     // A vertical white line at origin
-    LLVector3 v = gAgent.getPositionAgent();
+    LLVector3 v = LLFrameSnapshot::get().mAgentPosition;
     gGL.begin(LLRender::LINES);
         gGL.color3f(1.0f, 1.0f, 1.0f);
         gGL.vertex3f(0.0f, 0.0f, 0.0f);
@@ -71,6 +71,7 @@
 #include "llclipboard.h"
 #include "llhttpretrypolicy.h"
 #include "llsettingsvo.h"
+#include "llslabpool.h"
 // [RLVa:KB] - Checked: 2014-11-02 (RLVa-1.4.11)
 #include "rlvcommon.h"
 // [/RLVa:KB]
@@ -88,6 +89,43 @@ static const char * const LOG_NOTECARD("copy_inventory_from_notecard");
 static const std::string INV_OWNER_ID("owner_id");
 static const std::string INV_VERSION("version");
 
+// Never destroyed, items may be released during static destruction
+static LLLockedSlabPool& get_item_pool()
+{
+    static LLLockedSlabPool* pool = new LLLockedSlabPool(sizeof(LLViewerInventoryItem), 1024);
+    return *pool;
+}
+
+static LLLockedSlabPool& get_category_pool()
+{
+    static LLLockedSlabPool* pool = new LLLockedSlabPool(sizeof(LLViewerInventoryCategory), 256);
+    return *pool;
+}
+
+//static
+void* LLViewerInventoryItem::operator new(size_t size)
+{
+    return get_item_pool().allocate(size);
+}
+
+//static
+void LLViewerInventoryItem::operator delete(void* ptr, size_t size)
+{
+    get_item_pool().free(ptr, size);
+}
+
+//static
+void* LLViewerInventoryCategory::operator new(size_t size)
+{
+    return get_category_pool().allocate(size);
+}
+
+//static
+void LLViewerInventoryCategory::operator delete(void* ptr, size_t size)
+{
+    get_category_pool().free(ptr, size);
+}
+
 #if 1
 // *TODO$: LLInventoryCallback should be deprecated to conform to the new boost::bind/coroutine model.
 // temp code in transition
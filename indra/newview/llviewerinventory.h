@@ -57,9 +57,14 @@ public:
 protected:
     ~LLViewerInventoryItem( void ); // ref counted
     bool extractSortFieldAndDisplayName(S32* sortField, std::string* displayName) const { return extractSortFieldAndDisplayName(mName, sortField, displayName); }
-    mutable std::string mDisplayName;
 
 public:
+    // Large inventories hold well over a hundred thousand items, so they are allocated
+    // from a slab pool: less heap overhead, and walks over a folder's items touch fewer
+    // pages.
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr, size_t size);
+
     virtual LLAssetType::EType getType() const;
     virtual const LLUUID& getAssetUUID() const;
     virtual const LLUUID& getProtectedAssetUUID() const; // returns LLUUID::null if current agent does not have permission to expose this asset's UUID to the user
@@ -186,6 +191,10 @@ protected:
     ~LLViewerInventoryCategory();
 
 public:
+    // Pooled like items
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr, size_t size);
+
     LLViewerInventoryCategory(const LLUUID& uuid, const LLUUID& parent_uuid,
                               LLFolderType::EType preferred_type,
                               const std::string& name,
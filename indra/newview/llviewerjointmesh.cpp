@@ -74,7 +74,12 @@ extern PFNGLVERTEXBLENDARBPROC glVertexBlendARB;
 //-----------------------------------------------------------------------------
 LLViewerJointMesh::LLViewerJointMesh()
     :
-    LLAvatarJointMesh()
+    LLAvatarJointMesh(),
+    mUploadedMesh(NULL),
+    mUploadedBuffer(NULL),
+    mUploadedVertexOffset(0),
+    mUploadedIndexOffset(0),
+    mUploadedSerial(0)
 {
 }
 
@@ -383,6 +388,45 @@ void LLViewerJointMesh::updateFaceData(LLFace *face, F32 pixel_area, bool damp_w
     {
         const U32 num_verts = mMesh->getNumVertices();
 
+        LLVertexBuffer* buffer = face->getVertexBuffer();
+        LLPolyMesh* reference_mesh = mMesh->getReferenceMesh();
+        const U32 serial = reference_mesh->getVertexSerial();
+
+        if (num_verts && terse_update &&
+            mUploadedMesh == mMesh &&
+            mUploadedBuffer == buffer &&
+            mUploadedVertexOffset == mMesh->mFaceVertexOffset &&
+            mUploadedIndexOffset == mMesh->mFaceIndexOffset)
+        {
+            // indices, tex coords and weights are untouched by terse updates,
+            // so only re-copy the coords and normals morphs have changed
+            if (serial == mUploadedSerial)
+            {
+                return;
+            }
+
+            U32 first = 0;
+            U32 last = num_verts - 1;
+            if (reference_mesh->getDirtyVertices(mUploadedSerial, first, last))
+            {
+                last = llmin(last, num_verts - 1);
+            }
+
+            if (first <= last)
+            {
+                const U32 count = last - first + 1;
+                buffer->getVertexStrider(verticesp, mMesh->mFaceVertexOffset + first, count);
+                buffer->getNormalStrider(normalsp, mMesh->mFaceVertexOffset + first, count);
+
+                LLVector4a::memcpyNonAliased16((F32*) verticesp.get(), (F32*) (mMesh->getCoords() + first), count*4*sizeof(F32));
+                LLVector4a::memcpyNonAliased16((F32*) normalsp.get(), (F32*) (mMesh->getNormals() + first), count*4*sizeof(F32));
+            }
+
+            mUploadedSerial = serial;
+            reference_mesh->clearDirtyVertices();
+            return;
+        }
+
         if (num_verts)
         {
             face->getVertexBuffer()->getIndexStrider(indicesp);
@@ -430,6 +474,21 @@ void LLViewerJointMesh::updateFaceData(LLFace *face, F32 pixel_area, bool damp_w
             {
                 *(idx++) = *(src_idx++)+offset;
             }
+
+            if (hardware_skinning)
+            {
+                mUploadedMesh = mMesh;
+                mUploadedBuffer = buffer;
+                mUploadedVertexOffset = mMesh->mFaceVertexOffset;
+                mUploadedIndexOffset = mMesh->mFaceIndexOffset;
+                mUploadedSerial = serial;
+                reference_mesh->clearDirtyVertices();
+            }
+            else
+            {
+                // software skinning overwrites the vertex buffer every frame
+                mUploadedMesh = NULL;
+            }
         }
     }
 }
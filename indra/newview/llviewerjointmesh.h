@@ -72,6 +72,14 @@ private:
 
     //copy mesh into given face's vertex buffer, applying current animation pose
     static void updateGeometry(LLFace* face, LLPolyMesh* mesh);
+
+    // where this mesh was last uploaded for hardware skinning, so terse
+    // updates only need to copy the vertices morphs have changed since
+    LLPolyMesh*             mUploadedMesh;
+    const LLVertexBuffer*   mUploadedBuffer;
+    U32                     mUploadedVertexOffset;
+    U32                     mUploadedIndexOffset;
+    U32                     mUploadedSerial;
 };
 
 #endif // LL_LLVIEWERJOINTMESH_H
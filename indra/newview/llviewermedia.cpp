@@ -213,8 +213,7 @@ static bool sViewerMediaMuteListObserverInitialized = false;
 
 LLViewerMedia::LLViewerMedia():
 mAnyMediaShowing(false),
-mAnyMediaPlaying(false),
-mSpareBrowserMediaSource(NULL)
+mAnyMediaPlaying(false)
 {
 }
 
@@ -222,11 +221,7 @@ LLViewerMedia::~LLViewerMedia()
 {
     gIdleCallbacks.deleteFunction(LLViewerMedia::onIdle, NULL);
     mTeleportFinishConnection.disconnect();
-    if (mSpareBrowserMediaSource != NULL)
-    {
-        delete mSpareBrowserMediaSource;
-        mSpareBrowserMediaSource = NULL;
-    }
+    destroySpareBrowserMediaSources();
 }
 
 // static
@@ -642,13 +637,21 @@ void LLViewerMedia::updateMedia(void *dummy_arg)
     if(LLApp::isExiting())
     {
         setAllMediaEnabled(false);
+        destroySpareBrowserMediaSources();
         return;
     }
 
-    // HACK: we always try to keep a spare running webkit plugin around to improve launch times.
-    // 2017-04-19 Removed CP - this doesn't appear to buy us much and consumes a lot of resources so
-    // removing it for now.
-    //createSpareBrowserMediaSource();
+    // 2017-04-19 Removed CP - keeping a spare always doesn't buy us much and consumes a lot of
+    // resources.  Only keep spares around while there is in-world media to use them.
+    static LLCachedControl<bool> spare_media_enabled(gSavedSettings, "AudioStreamingMedia", true);
+    if (mAnyMediaShowing && spare_media_enabled)
+    {
+        createSpareBrowserMediaSource();
+    }
+    else
+    {
+        destroySpareBrowserMediaSources();
+    }
 
     mAnyMediaShowing = false;
     mAnyMediaPlaying = false;
@@ -666,11 +669,24 @@ void LLViewerMedia::updateMedia(void *dummy_arg)
         }
     }
 
-    // Let the spare media source actually launch
-    if(mSpareBrowserMediaSource)
+    // Let the spare media sources actually launch
+    if(!mSpareBrowserMediaSources.empty())
     {
         LL_PROFILE_ZONE_NAMED_CATEGORY_MEDIA("media spare idle"); //LL_RECORD_BLOCK_TIME(FTM_MEDIA_SPARE_IDLE);
-        mSpareBrowserMediaSource->idle();
+        for (auto spare_iter = mSpareBrowserMediaSources.begin(); spare_iter != mSpareBrowserMediaSources.end();)
+        {
+            LLPluginClassMedia* spare = *spare_iter;
+            spare->idle();
+            if (spare->isPluginExited())
+            {
+                delete spare;
+                spare_iter = mSpareBrowserMediaSources.erase(spare_iter);
+            }
+            else
+            {
+                ++spare_iter;
+            }
+        }
     }
 
     {
@@ -702,6 +718,7 @@ void LLViewerMedia::updateMedia(void *dummy_arg)
     static LLCachedControl<U32> sPluginInstancesNormal(gSavedSettings, "PluginInstancesNormal");
     static LLCachedControl<U32> sPluginInstancesLow(gSavedSettings, "PluginInstancesLow");
     static LLCachedControl<F32> sPluginInstancesCPULimit(gSavedSettings, "PluginInstancesCPULimit");
+    static LLCachedControl<F32> sPluginUnloadDelay(gSavedSettings, "PluginUnloadDelay", 15.f);
 
     U32 max_instances = sPluginInstancesTotal();
     U32 max_normal = sPluginInstancesNormal();
@@ -725,12 +742,20 @@ void LLViewerMedia::updateMedia(void *dummy_arg)
 
             LLPluginClassMedia::EPriority new_priority = LLPluginClassMedia::PRIORITY_NORMAL;
 
-            if(pimpl->isForcedUnloaded() || (impl_count_total >= (int)max_instances))
+            bool past_limit = false;
+            if(pimpl->isForcedUnloaded())
             {
                 // Never load muted or failed impls.
-                // Hard limit on the number of instances that will be loaded at one time
                 new_priority = LLPluginClassMedia::PRIORITY_UNLOADED;
             }
+            else if(impl_count_total >= (int)max_instances)
+            {
+                // Hard limit on the number of instances that will be loaded at one time,
+                // those that just went past it are suspended for a while first
+                past_limit = true;
+                new_priority = pimpl->unloadPastLimit(sPluginUnloadDelay) ? LLPluginClassMedia::PRIORITY_UNLOADED
+                                                                          : LLPluginClassMedia::PRIORITY_HIDDEN;
+            }
             else if(!pimpl->getVisible())
             {
                 new_priority = LLPluginClassMedia::PRIORITY_HIDDEN;
@@ -804,7 +829,12 @@ void LLViewerMedia::updateMedia(void *dummy_arg)
                 }
             }
 
-            if(!pimpl->getUsedInUI() && (new_priority != LLPluginClassMedia::PRIORITY_UNLOADED))
+            if (!past_limit)
+            {
+                pimpl->mPastLimit = false;
+            }
+
+            if(!pimpl->getUsedInUI() && !past_limit && (new_priority != LLPluginClassMedia::PRIORITY_UNLOADED))
             {
                 // This is a loadable inworld impl -- the last one in the list in this class defines the lowest loadable interest.
                 lowest_interest_loadable = pimpl;
@@ -1461,24 +1491,50 @@ void LLViewerMedia::proxyWindowClosed(const std::string &uuid)
 /////////////////////////////////////////////////////////////////////////////////////////
 void LLViewerMedia::createSpareBrowserMediaSource()
 {
-    // If we don't have a spare browser media source, create one.
+    static LLCachedControl<U32> spare_browsers(gSavedSettings, "PluginSpareBrowsers", 1);
+    while (mSpareBrowserMediaSources.size() > spare_browsers)
+    {
+        delete mSpareBrowserMediaSources.back();
+        mSpareBrowserMediaSources.pop_back();
+    }
+
+    // If we're short of spare browser media sources, create one, launching at most one per frame.
     // However, if PluginAttachDebuggerToPlugins is set then don't spawn a spare
     // SLPlugin process in order to not be confused by an unrelated gdb terminal
     // popping up at the moment we start a media plugin.
-    if (!mSpareBrowserMediaSource && !gSavedSettings.getBOOL("PluginAttachDebuggerToPlugins"))
+    if (mSpareBrowserMediaSources.size() < spare_browsers && !gSavedSettings.getBOOL("PluginAttachDebuggerToPlugins"))
     {
         // The null owner will keep the browser plugin from fully initializing
         // (specifically, it keeps LLPluginClassMedia from negotiating a size change,
         // which keeps MediaPluginWebkit::initBrowserWindow from doing anything until we have some necessary data, like the background color)
-        mSpareBrowserMediaSource = LLViewerMediaImpl::newSourceFromMediaType(HTTP_CONTENT_TEXT_HTML, NULL, 0, 0, 1.0);
+        LLPluginClassMedia* spare = LLViewerMediaImpl::newSourceFromMediaType(HTTP_CONTENT_TEXT_HTML, NULL, 0, 0, 1.0);
+        if (spare)
+        {
+            mSpareBrowserMediaSources.push_back(spare);
+        }
     }
 }
 
+/////////////////////////////////////////////////////////////////////////////////////////
+void LLViewerMedia::destroySpareBrowserMediaSources()
+{
+    for (LLPluginClassMedia* spare : mSpareBrowserMediaSources)
+    {
+        delete spare;
+    }
+    mSpareBrowserMediaSources.clear();
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////
 LLPluginClassMedia* LLViewerMedia::getSpareBrowserMediaSource()
 {
-    LLPluginClassMedia* result = mSpareBrowserMediaSource;
-    mSpareBrowserMediaSource = NULL;
+    if (mSpareBrowserMediaSources.empty())
+    {
+        return NULL;
+    }
+    // the oldest has had the most time to start up
+    LLPluginClassMedia* result = mSpareBrowserMediaSources.front();
+    mSpareBrowserMediaSources.pop_front();
     return result;
 };
 
@@ -1572,6 +1628,7 @@ LLViewerMediaImpl::LLViewerMediaImpl(     const LLUUID& texture_id,
     mIsDisabled(false),
     mIsParcelMedia(false),
     mProximity(-1),
+    mPastLimit(false),
     mProximityDistance(0.0f),
     mMediaAutoPlay(false),
     mInNearbyMediaList(false),
@@ -3822,6 +3879,17 @@ void LLViewerMediaImpl::setPriority(LLPluginClassMedia::EPriority priority)
     // NOTE: loading (or reloading) media sources whose priority has risen above PRIORITY_UNLOADED is done in update().
 }
 
+bool LLViewerMediaImpl::unloadPastLimit(F32 delay)
+{
+    if (!mPastLimit)
+    {
+        mPastLimit = true;
+        mPastLimitTimer.reset();
+    }
+    // nothing to keep if the plugin isn't running
+    return !mMediaSource || mPastLimitTimer.getElapsedTimeF32() >= delay;
+}
+
 void LLViewerMediaImpl::setLowPrioritySizeLimit(int size)
 {
     if(mMediaSource)
@@ -155,7 +155,10 @@ public:
     void proxyWindowOpened(const std::string &target, const std::string &uuid);
     void proxyWindowClosed(const std::string &uuid);
 
+    // Keep up to PluginSpareBrowsers browser plugins launched ahead of time, so media
+    // coming into view doesn't wait for a browser process to start
     void createSpareBrowserMediaSource();
+    void destroySpareBrowserMediaSources();
     LLPluginClassMedia* getSpareBrowserMediaSource();
 
     void setOnlyAudibleMediaTextureID(const LLUUID& texture_id);
@@ -176,7 +179,7 @@ private:
     bool mAnyMediaPlaying;
     LLURL mOpenIDURL;
     std::string mOpenIDCookie;
-    LLPluginClassMedia* mSpareBrowserMediaSource;
+    std::list<LLPluginClassMedia*> mSpareBrowserMediaSources;
     boost::signals2::connection mTeleportFinishConnection;
 };
 
@@ -292,6 +295,10 @@ public:
 
     // returns true if this instance should not be loaded (disabled, muted object, crashed, etc.)
     bool isForcedUnloaded() const;
+    // Whether to unload an impl past the instance limit.  Its plugin is only suspended
+    // until it has been past the limit for delay seconds, so walking back and forth
+    // doesn't relaunch it every time.
+    bool unloadPastLimit(F32 delay);
 
     // returns true if this instance could be playable based on autoplay setting, current load state, etc.
     bool isPlayable() const;
@@ -472,6 +479,8 @@ private:
     bool mIsDisabled;
     bool mIsParcelMedia;
     S32 mProximity;
+    bool mPastLimit;
+    LLFrameTimer mPastLimitTimer;
     F64 mProximityDistance;
     F64 mProximityCamera;
     bool mMediaAutoPlay;
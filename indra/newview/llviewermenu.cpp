@@ -63,6 +63,7 @@
 #include "llenvironment.h"
 #include "llfilepicker.h"
 #include "llfirstuse.h"
+#include "llflightrecorder.h"
 #include "llfloaterabout.h"
 #include "llfloaterbuy.h"
 #include "llfloaterbuycontents.h"
@@ -848,6 +849,16 @@ class LLAdvancedDumpInfoToConsole : public view_listener_t
 };
 
 
+class LLAdvancedSaveFlightRecording : public view_listener_t
+{
+    bool handleEvent(const LLSD& userdata)
+    {
+        LLFlightRecorder::getInstance()->save("manual");
+        return true;
+    }
+};
+
+
 //////////////
 // HUD INFO //
 //////////////
@@ -2588,7 +2599,7 @@ class LLAdvancedPurgeDiskCache : public view_listener_t
 {
     bool handleEvent(const LLSD& userdata)
     {
-        LL::WorkQueue::ptr_t main_queue = LL::WorkQueue::getInstance("mainloop");
+        LL::WorkQueue::ptr_t main_queue = LL::WorkQueue::getInstance("mainloop-ui");
         LL::WorkQueue::ptr_t general_queue = LL::WorkQueue::getInstance("General");
         llassert_always(main_queue);
         llassert_always(general_queue);
@@ -12716,6 +12727,7 @@ void initialize_menus()
     view_listener_t::addMenu(new LLAdvancedToggleConsole(), "Advanced.ToggleConsole");
     view_listener_t::addMenu(new LLAdvancedCheckConsole(), "Advanced.CheckConsole");
     view_listener_t::addMenu(new LLAdvancedDumpInfoToConsole(), "Advanced.DumpInfoToConsole");
+    view_listener_t::addMenu(new LLAdvancedSaveFlightRecording(), "Advanced.SaveFlightRecording");
 
     // Advanced > HUD Info
     view_listener_t::addMenu(new LLAdvancedToggleHUDInfo(), "Advanced.ToggleHUDInfo");
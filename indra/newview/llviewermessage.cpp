@@ -3125,6 +3125,7 @@ void process_chat_from_simulator(LLMessageSystem *msg, void **user_data)
                     std::string strExecuted, strFailed, strRetained, *pstr;
 
                     boost_tokenizer tokens(mesg, boost::char_separator<char>(",", "", boost::drop_empty_tokens));
+                    gRlvHandler.beginCommandBatch();
                     for (boost_tokenizer::iterator itToken = tokens.begin(); itToken != tokens.end(); ++itToken)
                     {
                         std::string strCmd = *itToken;
@@ -3155,6 +3156,7 @@ void process_chat_from_simulator(LLMessageSystem *msg, void **user_data)
                             pstr->append(strCmd);
                         }
                     }
+                    gRlvHandler.endCommandBatch();
 
                     if (RlvForceWear::instanceExists())
                         RlvForceWear::instance().done();
@@ -0,0 +1,143 @@
+/**
+ * @file llviewermessagecapture.cpp
+ * @brief Capture of the messages a session receives, and replay of such a
+ * capture for benchmarking the message handlers
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llviewermessagecapture.h"
+
+#include "lldir.h"
+#include "llmessagecapture.h"
+#include "llviewercontrol.h"
+#include "llviewerregion.h"
+#include "llworld.h"
+#include "message.h"
+
+static U64 region_handle_of(const LLHost& host)
+{
+    LLViewerRegion* regionp = LLWorld::instanceExists() ? LLWorld::getInstance()->getRegion(host) : NULL;
+    return regionp ? regionp->getHandle() : 0;
+}
+
+static LLHost region_host_of(U64 handle)
+{
+    LLViewerRegion* regionp = LLWorld::instanceExists() ? LLWorld::getInstance()->getRegionFromHandle(handle) : NULL;
+    return regionp ? regionp->getHost() : LLHost();
+}
+
+// A bare file name is in the logs directory
+static std::string capture_path(const std::string& filename)
+{
+    if (filename.find_first_of("/\\") != std::string::npos)
+    {
+        return filename;
+    }
+    return gDirUtilp->getExpandedFilename(LL_PATH_LOGS, filename);
+}
+
+LLViewerMessageCapture::LLViewerMessageCapture()
+{
+}
+
+LLViewerMessageCapture::~LLViewerMessageCapture()
+{
+    stop();
+}
+
+void LLViewerMessageCapture::start()
+{
+    stop();
+
+    const std::string replay_file = gSavedSettings.getString("MessageReplayFile");
+    const std::string capture_file = gSavedSettings.getString("MessageCaptureFile");
+    if (!replay_file.empty())
+    {
+        mReplay = std::make_unique<LLMessageReplay>();
+        if (!mReplay->load(capture_path(replay_file)))
+        {
+            mReplay.reset();
+            return;
+        }
+        mReplay->start(region_host_of, gSavedSettings.getBOOL("MessageReplayMaxSpeed"));
+        gMessageSystem->setReplay(mReplay.get());
+    }
+    else if (!capture_file.empty())
+    {
+        mCapture = std::make_unique<LLMessageCapture>(region_handle_of);
+        if (!mCapture->open(capture_path(capture_file)))
+        {
+            mCapture.reset();
+            return;
+        }
+        gMessageSystem->setCapture(mCapture.get());
+    }
+}
+
+void LLViewerMessageCapture::idle()
+{
+    if (!mReplay)
+    {
+        return;
+    }
+
+    mReplay->dispatchEvents();
+    if (mReplay->isDone())
+    {
+        mReplay->logReport();
+        gMessageSystem->setReplay(NULL);
+        mReplay.reset();
+    }
+}
+
+void LLViewerMessageCapture::stop()
+{
+    if (mReplay)
+    {
+        // report what got through before the session ended
+        mReplay->logReport();
+        if (gMessageSystem)
+        {
+            gMessageSystem->setReplay(NULL);
+        }
+        mReplay.reset();
+    }
+    if (mCapture)
+    {
+        if (gMessageSystem)
+        {
+            gMessageSystem->setCapture(NULL);
+        }
+        mCapture.reset();
+    }
+}
+
+void LLViewerMessageCapture::recordEvent(const std::string& name, const LLSD& message)
+{
+    if (mCapture)
+    {
+        mCapture->recordEvent(name, message);
+    }
+}
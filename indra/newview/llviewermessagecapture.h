@@ -0,0 +1,67 @@
+/**
+ * @file llviewermessagecapture.h
+ * @brief Capture of the messages a session receives, and replay of such a
+ * capture for benchmarking the message handlers
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#pragma once
+
+#include "llsingleton.h"
+
+#include <memory>
+#include <string>
+
+class LLMessageCapture;
+class LLMessageReplay;
+class LLSD;
+
+// With MessageCaptureFile set, every UDP packet and event poll message the
+// session receives from login on is written to that file in the logs
+// directory.  With MessageReplayFile set, a later session replays it once
+// logged in: the messages of the regions it is connected to again go
+// through the handlers as if the simulator had sent them, at the recorded
+// pace or with MessageReplayMaxSpeed as fast as the viewer takes them, and
+// the throughput and main thread time per message type go to the log.
+// Replaying into a HeadlessClient session leaves rendering out of it.
+class LLViewerMessageCapture : public LLSingleton<LLViewerMessageCapture>
+{
+    LLSINGLETON(LLViewerMessageCapture);
+    ~LLViewerMessageCapture();
+
+public:
+    // Start capturing or replaying, as the settings say.  Called at login.
+    void start();
+
+    // Once per frame, with the network idle
+    void idle();
+
+    // Called when disconnecting, before the regions go away
+    void stop();
+
+    void recordEvent(const std::string& name, const LLSD& message);
+
+private:
+    std::unique_ptr<LLMessageCapture> mCapture;
+    std::unique_ptr<LLMessageReplay> mReplay;
+};
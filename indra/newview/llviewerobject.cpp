@@ -105,7 +105,9 @@
 #include "llcleanup.h"
 #include "llmeshrepository.h"
 #include "llgltfmateriallist.h"
+#include "lllocalgltfmaterials.h"
 #include "llgl.h"
+#include "llslabpool.h"
 #include "gltf/asset.h"
 // [RLVa:KB] - Checked: 2011-05-22 (RLVa-1.3.1a)
 #include "rlvactions.h"
@@ -264,6 +266,29 @@ LLViewerObject *LLViewerObject::createObject(const LLUUID &id, const LLPCode pco
     return res;
 }
 
+static LLMemTag sViewerObjectMemTag("Viewer objects");
+
+static LLSizedSlabPools& get_object_pools()
+{
+    // never destroyed, objects may be released during static destruction
+    static LLSizedSlabPools* pools = new LLSizedSlabPools(&sViewerObjectMemTag, 1024);
+    return *pools;
+}
+
+//static
+void* LLViewerObject::operator new(size_t size)
+{
+    llassert(on_main_thread());
+    return get_object_pools().allocate(size);
+}
+
+//static
+void LLViewerObject::operator delete(void* ptr, size_t size)
+{
+    llassert(on_main_thread());
+    get_object_pools().free(ptr, size);
+}
+
 LLViewerObject::LLViewerObject(const LLUUID &id, const LLPCode pcode, LLViewerRegion *regionp, bool is_global)
 :   LLPrimitive(),
     mChildList(),
@@ -5714,8 +5739,14 @@ S32 LLViewerObject::setTEGLTFMaterialOverride(U8 te, LLGLTFMaterial* override_ma
     {
         if (override_mat)
         {
-            LLFetchedGLTFMaterial* render_mat = new LLFetchedGLTFMaterial(*src_mat);
+            LLPointer<LLFetchedGLTFMaterial> render_mat = new LLFetchedGLTFMaterial(*src_mat);
             render_mat->applyOverride(*override_mat);
+            // local textures and materials update render materials in place, keep those private
+            if (!src_mat->hasLocalTextures() && !override_mat->hasLocalTextures() &&
+                !dynamic_cast<LLLocalGLTFMaterial*>(src_mat))
+            {
+                render_mat = gGLTFMaterialList.internRenderMaterial(render_mat);
+            }
             tep->setGLTFRenderMaterial(render_mat);
             retval = TEM_CHANGE_TEXTURE;
 
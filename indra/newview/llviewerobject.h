@@ -142,6 +142,12 @@ public:
 
     typedef const child_list_t const_child_list_t;
 
+    // Objects come from one LLSlabPool per class size; avatars, which are
+    // few and large, keep their own aligned operator new.
+    // Threads:  Tmain
+    void* operator new(size_t size);
+    void operator delete(void* ptr, size_t size);
+
     LLViewerObject(const LLUUID &id, const LLPCode pcode, LLViewerRegion *regionp, bool is_global = false);
 
     virtual void markDead();                // Mark this object as dead, and clean up its references
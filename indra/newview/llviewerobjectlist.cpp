@@ -68,6 +68,7 @@
 #include "u64.h"
 #include "llviewertexturelist.h"
 #include "lldatapacker.h"
+#include "parallelfor.h"
 #ifdef LL_USESYSTEMLIBS
 #include <zlib.h>
 #else
@@ -112,6 +113,7 @@ LLViewerObjectList::LLViewerObjectList()
 {
     mCurLazyUpdateIndex = 0;
     mCurBin = 0;
+    mCurNearUpdateIndex = 0;
     mNumDeadObjects = 0;
     mNumOrphans = 0;
     mNumNewObjects = 0;
@@ -154,7 +156,8 @@ void LLViewerObjectList::getUUIDFromLocal(LLUUID &id,
 
     U64 indexid = (((U64)index) << 32) | (U64)local_id;
 
-    id = get_if_there(mIndexAndLocalIDToUUID, indexid, LLUUID::null);
+    const LLUUID* found = mIndexAndLocalIDToUUID.find(indexid);
+    id = found ? *found : LLUUID::null;
 }
 
 U64 LLViewerObjectList::getIndex(const U32 local_id,
@@ -189,16 +192,16 @@ bool LLViewerObjectList::removeFromLocalIDTable(const LLViewerObject* objectp)
 
         U64 indexid = (((U64)index) << 32) | (U64)local_id;
 
-        std::map<U64, LLUUID>::iterator iter = mIndexAndLocalIDToUUID.find(indexid);
-        if (iter == mIndexAndLocalIDToUUID.end())
+        const LLUUID* found = mIndexAndLocalIDToUUID.find(indexid);
+        if (!found)
         {
             return false;
         }
 
         // Found existing entry
-        if (iter->second == objectp->getID())
+        if (*found == objectp->getID())
         {   // Full UUIDs match, so remove the entry
-            mIndexAndLocalIDToUUID.erase(iter);
+            mIndexAndLocalIDToUUID.erase(indexid);
             return true;
         }
         // UUIDs did not match - this would zap a valid entry, so don't erase it
@@ -441,6 +444,97 @@ LLViewerObject* LLViewerObjectList::processObjectUpdateFromCache(LLVOCacheEntry*
     return objectp;
 }
 
+void LLViewerObjectList::decodeObjectUpdates(LLMessageSystem* mesgsys,
+                                             const EObjectUpdateType update_type,
+                                             bool compressed,
+                                             S32 num_objects)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_NETWORK;
+    static LLCachedControl<bool> parallel_decode(gSavedSettings, "ObjectUpdateParallelDecode", true);
+    static LLCachedControl<U32> min_blocks(gSavedSettings, "ObjectUpdateParallelDecodeMinBlocks", 8);
+
+    if (mDecodedUpdates.size() < (size_t)num_objects)
+    {
+        mDecodedUpdates.resize(num_objects);
+    }
+
+    // the message reader is main thread only, copy the raw fields out first
+    for (S32 i = 0; i < num_objects; i++)
+    {
+        DecodedObjectUpdate& update = mDecodedUpdates[i];
+        update.mFullID.setNull();
+        update.mLocalID = 0;
+        update.mFlags = 0;
+        update.mPCode = 0;
+        update.mDataSize = 0;
+        update.mHeaderSize = 0;
+        update.mError.clear();
+
+        if (compressed)
+        {
+            S32 size = mesgsys->getSizeFast(_PREHASH_ObjectData, i, _PREHASH_Data);
+            update.mDataSize = llclamp(size, 0, DecodedObjectUpdate::MAX_DATA_SIZE);
+            mesgsys->getBinaryDataFast(_PREHASH_ObjectData, _PREHASH_Data, update.mData, 0, i, DecodedObjectUpdate::MAX_DATA_SIZE);
+            if (update_type != OUT_TERSE_IMPROVED)
+            {
+                mesgsys->getU32Fast(_PREHASH_ObjectData, _PREHASH_UpdateFlags, update.mFlags, i);
+            }
+        }
+        else if (update_type != OUT_FULL)
+        {
+            mesgsys->getU32Fast(_PREHASH_ObjectData, _PREHASH_ID, update.mLocalID, i);
+        }
+        else
+        {
+            mesgsys->getUUIDFast(_PREHASH_ObjectData, _PREHASH_FullID, update.mFullID, i);
+            mesgsys->getU32Fast(_PREHASH_ObjectData, _PREHASH_ID, update.mLocalID, i);
+        }
+    }
+
+    if (!compressed)
+    {
+        return;
+    }
+
+    // payload headers only depend on their own block
+    auto decode = [this, update_type](size_t i)
+    {
+        DecodedObjectUpdate& update = mDecodedUpdates[i];
+        LLDataPackerBinaryBuffer dp(update.mData, update.mDataSize);
+        try
+        {
+            if (update_type != OUT_TERSE_IMPROVED) // OUT_FULL_COMPRESSED only?
+            {
+                dp.unpackUUID(update.mFullID, "ID");
+                dp.unpackU32(update.mLocalID, "LocalID");
+                dp.unpackU8(update.mPCode, "PCode");
+            }
+            else
+            {
+                dp.unpackU32(update.mLocalID, "LocalID");
+            }
+        }
+        catch (nd::exceptions::xran& ex)
+        {
+            // rethrown when the block is applied, where unpacking used to throw
+            update.mError = ex.what();
+        }
+        update.mHeaderSize = dp.getCurrentSize();
+    };
+
+    if (parallel_decode && (U32)num_objects >= min_blocks)
+    {
+        LL::parallel_for("General", num_objects, decode);
+    }
+    else
+    {
+        for (S32 i = 0; i < num_objects; i++)
+        {
+            decode(i);
+        }
+    }
+}
+
 void LLViewerObjectList::processObjectUpdate(LLMessageSystem *mesgsys,
                                              void **user_data,
                                              const EObjectUpdateType update_type,
@@ -508,32 +602,33 @@ void LLViewerObjectList::processObjectUpdate(LLMessageSystem *mesgsys,
         return;
     }
 
-    U8 compressed_dpbuffer[2048];
-    LLDataPackerBinaryBuffer compressed_dp(compressed_dpbuffer, 2048);
     LLViewerStatsRecorder& recorder = LLViewerStatsRecorder::instance();
 
+    // decode every block before applying them in order, the apply needs the objects
+    decodeObjectUpdates(mesgsys, update_type, compressed, num_objects);
+
     for (i = 0; i < num_objects; i++)
     {
         bool justCreated = false;
         bool update_cache = false; //update object cache if it is a full-update or terse update
 
+        DecodedObjectUpdate& update = mDecodedUpdates[i];
+        LLDataPackerBinaryBuffer compressed_dp(update.mData, update.mDataSize);
+        fullid = update.mFullID;
+        local_id = update.mLocalID;
+        pcode = update.mPCode;
+
         if (compressed)
         {
-            compressed_dp.reset();
-
-            S32 uncompressed_length = mesgsys->getSizeFast(_PREHASH_ObjectData, i, _PREHASH_Data);
-            LL_DEBUGS("ObjectUpdate") << "got binary data from message to compressed_dpbuffer" << LL_ENDL;
-            mesgsys->getBinaryDataFast(_PREHASH_ObjectData, _PREHASH_Data, compressed_dpbuffer, 0, i, 2048);
-            compressed_dp.assignBuffer(compressed_dpbuffer, uncompressed_length);
+            if (!update.mError.empty())
+            {
+                throw nd::exceptions::xran(update.mError);
+            }
+            compressed_dp.shift(update.mHeaderSize);
 
             if (update_type != OUT_TERSE_IMPROVED) // OUT_FULL_COMPRESSED only?
             {
-                U32 flags = 0;
-                mesgsys->getU32Fast(_PREHASH_ObjectData, _PREHASH_UpdateFlags, flags, i);
-
-                compressed_dp.unpackUUID(fullid, "ID");
-                compressed_dp.unpackU32(local_id, "LocalID");
-                compressed_dp.unpackU8(pcode, "PCode");
+                U32 flags = update.mFlags;
 
                 if (pcode == 0)
                 {
@@ -556,7 +651,6 @@ void LLViewerObjectList::processObjectUpdate(LLMessageSystem *mesgsys,
             else //OUT_TERSE_IMPROVED
             {
                 update_cache = true;
-                compressed_dp.unpackU32(local_id, "LocalID");
                 getUUIDFromLocal(fullid,
                                  local_id,
                                  gMessageSystem->getSenderIP(),
@@ -570,8 +664,6 @@ void LLViewerObjectList::processObjectUpdate(LLMessageSystem *mesgsys,
         }
         else if (update_type != OUT_FULL) // !compressed, !OUT_FULL ==> OUT_FULL_CACHED only?
         {
-            mesgsys->getU32Fast(_PREHASH_ObjectData, _PREHASH_ID, local_id, i);
-
             getUUIDFromLocal(fullid,
                             local_id,
                             gMessageSystem->getSenderIP(),
@@ -589,8 +681,6 @@ void LLViewerObjectList::processObjectUpdate(LLMessageSystem *mesgsys,
         else // OUT_FULL only?
         {
             update_cache = true;
-            mesgsys->getUUIDFast(_PREHASH_ObjectData, _PREHASH_FullID, fullid, i);
-            mesgsys->getU32Fast(_PREHASH_ObjectData, _PREHASH_ID, local_id, i);
             LL_DEBUGS("ObjectUpdate") << "Full Update, obj " << local_id << ", global ID " << fullid << " from " << mesgsys->getSender() << LL_ENDL;
         }
         objectp = findObject(fullid);
@@ -856,6 +946,9 @@ void LLViewerObjectList::updateApparentAngles(LLAgent &agent)
         max_value = llmin((S32) mObjects.size(), mCurLazyUpdateIndex + num_updates);
     }
 
+    static LLCachedControl<F32> near_distance(gSavedSettings, "TextureUpdateNearDistance", 32.f);
+    static LLCachedControl<U32> near_budget(gSavedSettings, "TextureUpdateNearBudget", 64);
+
     // Iterate through some of the objects and lazy update their texture priorities
     for (i = mCurLazyUpdateIndex; i < max_value; i++)
     {
@@ -865,6 +958,33 @@ void LLViewerObjectList::updateApparentAngles(LLAgent &agent)
             //  Update distance & gpw
             objectp->setPixelAreaAndAngle(agent); // Also sets the approx. pixel area
             objectp->updateTextures();  // Update the image levels of textures for this object.
+
+            // near volumes also get a turn between sweeps, see below
+            if (objectp->getPCode() == LL_PCODE_VOLUME &&
+                objectp->mDrawable.notNull() && objectp->mDrawable->isVisible() &&
+                objectp->mDrawable->mDistanceWRTCamera < near_distance)
+            {
+                mNextNearObjects.push_back(objectp);
+            }
+        }
+    }
+
+    // A full sweep takes NUM_BINS frames, too slow for what is right in front of the
+    // camera.  Revisit the near objects found by the last sweep, nearest first, up to
+    // TextureUpdateNearBudget of them a frame.  Unless the camera moved this is cheap,
+    // updateTextures() skips objects whose screen space metrics didn't change.
+    U32 near_updates = llmin((U32)mNearObjects.size(), (U32)near_budget);
+    for (U32 n = 0; n < near_updates; ++n)
+    {
+        if (mCurNearUpdateIndex >= mNearObjects.size())
+        {
+            mCurNearUpdateIndex = 0;
+        }
+        objectp = mNearObjects[mCurNearUpdateIndex++];
+        if (!objectp->isDead())
+        {
+            objectp->setPixelAreaAndAngle(agent);
+            objectp->updateTextures();
         }
     }
 
@@ -874,6 +994,18 @@ void LLViewerObjectList::updateApparentAngles(LLAgent &agent)
         // restart
         mCurLazyUpdateIndex = 0;
         mCurBin = 0; // keep in sync with index (mObjects.size() could have changed)
+
+        // objects can lose their drawable during the sweep
+        mNextNearObjects.erase(std::remove_if(mNextNearObjects.begin(), mNextNearObjects.end(),
+                                              [](const LLPointer<LLViewerObject>& objectp)
+                                              { return objectp->isDead() || objectp->mDrawable.isNull(); }),
+                               mNextNearObjects.end());
+        std::sort(mNextNearObjects.begin(), mNextNearObjects.end(),
+                  [](const LLPointer<LLViewerObject>& lhs, const LLPointer<LLViewerObject>& rhs)
+                  { return lhs->mDrawable->mDistanceWRTCamera < rhs->mDrawable->mDistanceWRTCamera; });
+        mNearObjects.swap(mNextNearObjects);
+        mNextNearObjects.clear();
+        mCurNearUpdateIndex = 0;
     }
     else
     {
@@ -1027,6 +1159,8 @@ void LLViewerObjectList::update(LLAgent &agent)
 
     // <FS:Ansariel> Speed up debug settings
     //if (gSavedSettings.getBOOL("FreezeTime"))
+    LLVOAvatar::beginJointUpdates();
+
     if (freezeTime)
     // </FS:Ansariel> Speed up debug settings
     {
@@ -1040,6 +1174,8 @@ void LLViewerObjectList::update(LLAgent &agent)
                 objectp->idleUpdate(agent, frame_time);
             }
         }
+
+        LLVOAvatar::flushJointUpdates();
     }
     else
     {
@@ -1048,9 +1184,16 @@ void LLViewerObjectList::update(LLAgent &agent)
         {
             objectp = *idle_iter;
             llassert(objectp->isActive());
-                objectp->idleUpdate(agent, frame_time);
+            if (objectp->getPCode() == LL_PCODE_VOLUME && !((LLVOVolume*)objectp)->isIdleUpdateDue())
+            {
+                // interpolation uses the time since the last idle update, it catches up next turn
+                continue;
+            }
+            objectp->idleUpdate(agent, frame_time);
         }
 
+        LLVOAvatar::flushJointUpdates();
+
         //update flexible objects
         LLVolumeImplFlexible::updateClass();
 
@@ -1069,6 +1212,9 @@ void LLViewerObjectList::update(LLAgent &agent)
     // update max computed render cost
     LLVOVolume::updateRenderComplexity();
 
+    // build face octrees for picking the selection, free unused ones
+    LLVOVolume::updateFaceOctrees();
+
     // compute all sorts of time-based stats
     // don't factor frames that were paused into the stats
     if (! mWasPaused)
@@ -1606,6 +1752,10 @@ void LLViewerObjectList::killAllObjects()
         mActiveObjects.clear();
     }
 
+    mNearObjects.clear();
+    mNextNearObjects.clear();
+    mCurNearUpdateIndex = 0;
+
     if (!mMapObjects.empty())
     {
         LL_WARNS() << "Some objects still on map object list!" << LL_ENDL;
@@ -1626,6 +1776,12 @@ void LLViewerObjectList::cleanDeadObjects(bool use_timer)
 
     LL_PROFILE_ZONE_SCOPED;
 
+    // don't keep dead objects alive until the next sweep
+    auto is_dead = [](const LLPointer<LLViewerObject>& objectp) { return objectp->isDead(); };
+    mNearObjects.erase(std::remove_if(mNearObjects.begin(), mNearObjects.end(), is_dead), mNearObjects.end());
+    mNextNearObjects.erase(std::remove_if(mNextNearObjects.begin(), mNextNearObjects.end(), is_dead),
+                           mNextNearObjects.end());
+
     // <FS:Beq/> FIRE-30694 DeadObject Spam
     S32 num_divergent = 0;
     S32 num_removed = 0;
@@ -31,6 +31,7 @@
 #include <set>
 
 // common includes
+#include "llflathashmap.h"
 #include "llstring.h"
 #include "lltrace.h"
 
@@ -218,7 +219,7 @@ protected:
     uuid_multiset_t   mDeadObjects;
     // </FS:Beq>
 
-    std::map<LLUUID, LLPointer<LLViewerObject> > mUUIDObjectMap;
+    LLFlatHashMap<LLUUID, LLPointer<LLViewerObject> > mUUIDObjectMap;
 
     //set of objects that need to update their cost
     uuid_set_t   mStaleObjectCost;
@@ -232,14 +233,42 @@ protected:
 
     S32 mCurLazyUpdateIndex;
 
+    // objects near the camera, updated more often than once per sweep, see updateApparentAngles()
+    vobj_list_t mNearObjects;
+    vobj_list_t mNextNearObjects;
+    U32 mCurNearUpdateIndex;
+
     static U32 sSimulatorMachineIndex;
-    std::map<U64, U32> mIPAndPortToIndex;
+    LLFlatHashMap<U64, U32> mIPAndPortToIndex;
 
-    std::map<U64, LLUUID> mIndexAndLocalIDToUUID;
+    // (simulator index << 32 | local ID) to full ID
+    LLFlatHashMap<U64, LLUUID> mIndexAndLocalIDToUUID;
 
     friend class LLViewerObject;
 
 private:
+    // One ObjectData block of an object update message, decoded before any block of
+    // the message is applied
+    struct DecodedObjectUpdate
+    {
+        static const S32 MAX_DATA_SIZE = 2048;
+
+        LLUUID mFullID;
+        U32 mLocalID = 0;
+        U32 mFlags = 0;
+        LLPCode mPCode = 0;
+        S32 mDataSize = 0;      // compressed payload in mData
+        S32 mHeaderSize = 0;    // payload bytes already unpacked into the fields above
+        std::string mError;     // the payload was too short for its header
+        U8 mData[MAX_DATA_SIZE];
+    };
+
+    // Copies the blocks out of the message, then unpacks the compressed payload headers
+    // on the General thread pool for messages with many blocks
+    void decodeObjectUpdates(LLMessageSystem* mesgsys, EObjectUpdateType update_type, bool compressed, S32 num_objects);
+
+    std::vector<DecodedObjectUpdate> mDecodedUpdates;
+
     static void reportObjectCostFailure(LLSD &objectList);
     // <FS:Ansariel> FIRE-5496: Missing LI for objects outside agent's region
     //void fetchObjectCostsCoro(std::string url);
@@ -288,15 +317,8 @@ extern LLViewerObjectList gObjectList;
  */
 inline LLViewerObject *LLViewerObjectList::findObject(const LLUUID &id)
 {
-    auto iter = mUUIDObjectMap.find(id);
-    if(iter != mUUIDObjectMap.end())
-    {
-        return iter->second;
-    }
-    else
-    {
-        return NULL;
-    }
+    LLPointer<LLViewerObject>* objectp = mUUIDObjectMap.find(id);
+    return objectp ? objectp->get() : NULL;
 }
 
 inline LLViewerObject *LLViewerObjectList::getObject(const S32 index)
@@ -452,6 +452,27 @@ void LLViewerOctreeEntryData::resetVisible() const
 //class LLViewerOctreeGroup definitions
 //-----------------------------------------------------------------------------------
 
+static LLSizedSlabPools& get_group_pools()
+{
+    // never destroyed, groups may be released during static destruction
+    static LLSizedSlabPools* pools = new LLSizedSlabPools();
+    return *pools;
+}
+
+//static
+void* LLViewerOctreeGroup::operator new(size_t size)
+{
+    llassert(on_main_thread());
+    return get_group_pools().allocate(size);
+}
+
+//static
+void LLViewerOctreeGroup::operator delete(void* ptr, size_t size)
+{
+    llassert(on_main_thread());
+    get_group_pools().free(ptr, size);
+}
+
 LLViewerOctreeGroup::~LLViewerOctreeGroup()
 {
     //empty here
@@ -1300,6 +1321,7 @@ void LLOcclusionCullingGroup::doOcclusion(LLCamera* camera, const LLVector4a* sh
 //class LLViewerOctreePartition definitions
 //-----------------------------------------------------------------------------------
 LLViewerOctreePartition::LLViewerOctreePartition() :
+    mNodePool(sizeof(OctreeNode)),
     mRegionp(NULL),
     mOcclusionEnabled(true),
     mDrawableType(0),
@@ -1311,6 +1333,7 @@ LLViewerOctreePartition::LLViewerOctreePartition() :
     size.splat(1.f);
 
     mOctree = new OctreeRoot(center,size, NULL);
+    mOctree->setPool(&mNodePool);
 }
 
 LLViewerOctreePartition::~LLViewerOctreePartition()
@@ -1365,18 +1388,88 @@ void LLViewerOctreeCull::traverse(const OctreeNode* n)
         if (mRes)
         { //at least partially in, run on down
             LL_PROFILE_ZONE_NAMED_CATEGORY_OCTREE("PartiallyIn");
+            // children checked from here on are culled together, see batchedAABBInFrustum()
+            if (mBatches.size() <= mDepth)
+            {
+                mBatches.resize(mDepth + 1);
+            }
+            mBatches[mDepth].mParent = n;
+            mBatches[mDepth].mDone = 0;
+            ++mDepth;
             OctreeTraveler::traverse(n);
+            --mDepth;
         }
 
         mRes = 0;
     }
 }
 
+// Children of a node are checked one after the other as the traversal reaches them.
+// The first check of a given type culls all of them at once and keeps the answers
+// for the rest.
+S32 LLViewerOctreeCull::batchedAABBInFrustum(const LLViewerOctreeGroup* group, U32 type)
+{
+    const OctreeNode* parent = group->mOctreeNode ? (const OctreeNode*) group->mOctreeNode->getParent() : NULL;
+    ChildBatch* batch = mDepth ? &mBatches[mDepth - 1] : NULL;
+    if (!batch || !parent || batch->mParent != parent || parent->getChildCount() > 8)
+    {
+        return singleAABBInFrustum(group, type);
+    }
+
+    if (!(batch->mDone & (1 << type)))
+    {
+        LLVector4a centers[8];
+        LLVector4a radii[8];
+        batch->mCount = parent->getChildCount();
+        for (U32 i = 0; i < batch->mCount; i++)
+        {
+            const LLViewerOctreeGroup* child = (const LLViewerOctreeGroup*) parent->getChild(i)->getListener(0);
+            batch->mGroups[i] = child;
+            centers[i] = child->mBounds[0];
+            radii[i] = child->mBounds[1];
+        }
+        bool no_far_clip = type == BATCH_AGENT_NO_FAR_CLIP || type == BATCH_REGION_NO_FAR_CLIP;
+        if (type == BATCH_REGION || type == BATCH_REGION_NO_FAR_CLIP)
+        {
+            mCamera->AABBsInRegionFrustum(centers, radii, batch->mResults[type], batch->mCount, no_far_clip);
+        }
+        else
+        {
+            mCamera->AABBsInFrustum(centers, radii, batch->mResults[type], batch->mCount, NULL, no_far_clip);
+        }
+        batch->mDone |= 1 << type;
+    }
+
+    for (U32 i = 0; i < batch->mCount; i++)
+    {
+        if (batch->mGroups[i] == group)
+        {
+            return batch->mResults[type][i];
+        }
+    }
+
+    // the tree changed under us, check on its own and cull the new children next time
+    batch->mDone = 0;
+    return singleAABBInFrustum(group, type);
+}
+
+S32 LLViewerOctreeCull::singleAABBInFrustum(const LLViewerOctreeGroup* group, U32 type)
+{
+    const LLVector4a* bounds = group->mBounds;
+    switch (type)
+    {
+    case BATCH_AGENT:              return mCamera->AABBInFrustum(bounds[0], bounds[1]);
+    case BATCH_AGENT_NO_FAR_CLIP:  return mCamera->AABBInFrustumNoFarClip(bounds[0], bounds[1]);
+    case BATCH_REGION:             return mCamera->AABBInRegionFrustum(bounds[0], bounds[1]);
+    default:                       return mCamera->AABBInRegionFrustumNoFarClip(bounds[0], bounds[1]);
+    }
+}
+
 //------------------------------------------
 //agent space group culling
 S32 LLViewerOctreeCull::AABBInFrustumNoFarClipGroupBounds(const LLViewerOctreeGroup* group)
 {
-    return mCamera->AABBInFrustumNoFarClip(group->mBounds[0], group->mBounds[1]);
+    return batchedAABBInFrustum(group, BATCH_AGENT_NO_FAR_CLIP);
 }
 
 S32 LLViewerOctreeCull::AABBSphereIntersectGroupExtents(const LLViewerOctreeGroup* group)
@@ -1386,7 +1479,7 @@ S32 LLViewerOctreeCull::AABBSphereIntersectGroupExtents(const LLViewerOctreeGrou
 
 S32 LLViewerOctreeCull::AABBInFrustumGroupBounds(const LLViewerOctreeGroup* group)
 {
-    return mCamera->AABBInFrustum(group->mBounds[0], group->mBounds[1]);
+    return batchedAABBInFrustum(group, BATCH_AGENT);
 }
 //------------------------------------------
 
@@ -1412,12 +1505,12 @@ S32 LLViewerOctreeCull::AABBInFrustumObjectBounds(const LLViewerOctreeGroup* gro
 //local regional space group culling
 S32 LLViewerOctreeCull::AABBInRegionFrustumNoFarClipGroupBounds(const LLViewerOctreeGroup* group)
 {
-    return mCamera->AABBInRegionFrustumNoFarClip(group->mBounds[0], group->mBounds[1]);
+    return batchedAABBInFrustum(group, BATCH_REGION_NO_FAR_CLIP);
 }
 
 S32 LLViewerOctreeCull::AABBInRegionFrustumGroupBounds(const LLViewerOctreeGroup* group)
 {
-    return mCamera->AABBInRegionFrustum(group->mBounds[0], group->mBounds[1]);
+    return batchedAABBInFrustum(group, BATCH_REGION);
 }
 
 S32 LLViewerOctreeCull::AABBRegionSphereIntersectGroupExtents(const LLViewerOctreeGroup* group, const LLVector3& shift)
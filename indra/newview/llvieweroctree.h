@@ -181,8 +181,15 @@ protected:
 class LLViewerOctreeGroup
 :   public OctreeListener
 {
-    LL_ALIGN_NEW
     friend class LLViewerOctreeCull;
+public:
+    // Groups and their subclasses come from one LLSlabPool per class size.
+    // Groups are reference counted and may outlive their partition, so
+    // they share pools rather than using the partition's node pool.
+    // Threads:  Tmain
+    void* operator new(size_t size);
+    void operator delete(void* ptr, size_t size);
+
 protected:
     virtual ~LLViewerOctreeGroup();
 
@@ -356,6 +363,11 @@ protected:
     // MUST call from destructor of any derived classes (SL-17276)
     void cleanup();
 
+    // Backs every node of mOctree but the root.  Members outlive the
+    // destructor's cleanup(), so unloading a region releases all of its
+    // nodes at once.
+    LLSlabPool       mNodePool;
+
 public:
     U32              mPartitionType;
     U32              mDrawableType;
@@ -406,9 +418,38 @@ protected:
     virtual void processGroup(LLViewerOctreeGroup* group);
     virtual void visit(const OctreeNode* branch);
 
+private:
+    enum
+    {
+        BATCH_AGENT = 0,
+        BATCH_AGENT_NO_FAR_CLIP,
+        BATCH_REGION,
+        BATCH_REGION_NO_FAR_CLIP,
+        BATCH_COUNT
+    };
+
+    // Group bounds of all children of one node, culled together with
+    // LLCamera::AABBsInFrustum() the first time one of them is checked
+    struct ChildBatch
+    {
+        const OctreeNode* mParent;
+        U32 mCount;
+        U32 mDone;      // bit per BATCH_* type already culled
+        const LLViewerOctreeGroup* mGroups[8];
+        S32 mResults[BATCH_COUNT][8];
+    };
+
+    S32 batchedAABBInFrustum(const LLViewerOctreeGroup* group, U32 type);
+    S32 singleAABBInFrustum(const LLViewerOctreeGroup* group, U32 type);
+
 protected:
     LLCamera *mCamera;
     S32 mRes;
+
+private:
+    // one batch per level of the current traversal path, indexed by depth
+    std::vector<ChildBatch> mBatches;
+    U32 mDepth = 0;
 };
 
 //scan the octree, output the info of each node for debug use.
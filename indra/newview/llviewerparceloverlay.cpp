@@ -73,7 +73,11 @@ LLViewerParcelOverlay::LLViewerParcelOverlay(LLViewerRegion* region, F32 region_
 // </FS:CR> Aurora Sim
     mDirty( false ),
     mTimeSinceLastUpdate(),
-    mOverlayTextureIdx(-1)
+    mOverlayTextureIdx(-1),
+    mOverlayTextureBegin(0),
+    mOverlayTextureEnd(0),
+    mDirtyCellBegin(0),
+    mDirtyCellEnd(0)
 {
     if (!sColorSetInitialized)
     {
@@ -338,13 +342,20 @@ F32 LLViewerParcelOverlay::getOwnedRatio() const
 
 // Make sure the texture colors match the ownership data.
 // Note: Assumes that the ownership array and
+// Only the rows holding cells changed since the last pass are recolored and
+// uploaded, one row per call.
 void LLViewerParcelOverlay::updateOverlayTexture()
 {
     if (mOverlayTextureIdx < 0)
     {
-        if (!mDirty)
+        if (mDirtyCellBegin >= mDirtyCellEnd)
             return;
-        mOverlayTextureIdx = 0;
+        // whole rows, changes arriving from now on go to the next pass
+        mOverlayTextureBegin = mDirtyCellBegin - mDirtyCellBegin % mParcelGridsPerEdge;
+        mOverlayTextureEnd = llmin(mDirtyCellEnd + mParcelGridsPerEdge - 1 - (mDirtyCellEnd - 1) % mParcelGridsPerEdge,
+                                   mParcelGridsPerEdge * mParcelGridsPerEdge);
+        mDirtyCellBegin = mDirtyCellEnd = 0;
+        mOverlayTextureIdx = mOverlayTextureBegin;
     }
 
     const LLColor4U avail = sAvailColor.get();
@@ -356,7 +367,7 @@ void LLViewerParcelOverlay::updateOverlayTexture()
 
     // Create the base texture.
     U8 *raw = mImageRaw->getData();
-    const S32 COUNT = mParcelGridsPerEdge * mParcelGridsPerEdge;
+    const S32 COUNT = mOverlayTextureEnd;
     S32 max = mOverlayTextureIdx + mParcelGridsPerEdge;
     if (max > COUNT) max = COUNT;
     S32 pixel_index = mOverlayTextureIdx*OVERLAY_IMG_COMPONENTS;
@@ -429,8 +440,15 @@ void LLViewerParcelOverlay::updateOverlayTexture()
         {
             mTexture->createGLTexture(0, mImageRaw);
         }
-        mTexture->setSubImage(mImageRaw, 0, 0, mParcelGridsPerEdge, mParcelGridsPerEdge);
+        S32 first_row = mOverlayTextureBegin / mParcelGridsPerEdge;
+        S32 rows = (mOverlayTextureEnd - mOverlayTextureBegin) / mParcelGridsPerEdge;
+        mTexture->setSubImage(mImageRaw, 0, first_row, mParcelGridsPerEdge, rows);
         mOverlayTextureIdx = -1;
+        // cells that changed during this pass get the next one
+        if (mDirtyCellBegin < mDirtyCellEnd)
+        {
+            mDirty = true;
+        }
     }
     else
     {
@@ -450,10 +468,43 @@ void LLViewerParcelOverlay::uncompressLandOverlay(S32 chunk, U8 *packed_overlay)
     S32 chunk_size = size / mParcelOverLayChunks;
 // <FS:CR> Aurora Sim
 
-    memcpy(mOwnership + chunk*chunk_size, packed_overlay, chunk_size);      /*Flawfinder: ignore*/
+    // The simulator resends the whole overlay when crossing parcels, most of it
+    // the same as what we have. Only cells that actually changed need redrawing.
+    U8* dest = mOwnership + chunk*chunk_size;
+    S32 first = 0;
+    while (first < chunk_size && dest[first] == packed_overlay[first])
+    {
+        ++first;
+    }
+    if (first == chunk_size)
+    {
+        return;
+    }
+    S32 last = chunk_size;
+    while (dest[last - 1] == packed_overlay[last - 1])
+    {
+        --last;
+    }
+
+    memcpy(dest + first, packed_overlay + first, last - first);      /*Flawfinder: ignore*/
 
-    // Force property lines and overlay texture to update
-    setDirty();
+    // Force property lines and the changed part of the overlay texture to update
+    markCellsDirty(chunk*chunk_size + first, chunk*chunk_size + last);
+    mDirty = true;
+}
+
+void LLViewerParcelOverlay::markCellsDirty(S32 begin, S32 end)
+{
+    if (mDirtyCellBegin >= mDirtyCellEnd)
+    {
+        mDirtyCellBegin = begin;
+        mDirtyCellEnd = end;
+    }
+    else
+    {
+        mDirtyCellBegin = llmin(mDirtyCellBegin, begin);
+        mDirtyCellEnd = llmax(mDirtyCellEnd, end);
+    }
 }
 
 void LLViewerParcelOverlay::updatePropertyLines()
@@ -637,6 +688,7 @@ void LLViewerParcelOverlay::addPropertyLine(F32 start_x, F32 start_y, F32 dx, F3
 
 void LLViewerParcelOverlay::setDirty()
 {
+    markCellsDirty(0, mParcelGridsPerEdge * mParcelGridsPerEdge);
     mDirty = true;
 }
 
@@ -105,6 +105,8 @@ private:
 
     void    updateOverlayTexture();
     void    updatePropertyLines();
+    // Add cells [begin, end) to the ones the overlay texture needs to recolor
+    void    markCellsDirty(S32 begin, S32 end);
 
 private:
     // Back pointer to the region that owns this structure.
@@ -127,6 +129,11 @@ private:
     bool            mDirty;
     LLFrameTimer    mTimeSinceLastUpdate;
     S32             mOverlayTextureIdx;
+    // Cells of the texture update in progress, and the ones changed since it started
+    S32             mOverlayTextureBegin;
+    S32             mOverlayTextureEnd;
+    S32             mDirtyCellBegin;
+    S32             mDirtyCellEnd;
 
     struct Edge
     {
@@ -42,6 +42,7 @@
 #include "llspatialpartition.h"
 #include "llvoavatarself.h"
 #include "llvovolume.h"
+#include "parallelfor.h"
 
 const F32 PART_SIM_BOX_SIDE = 16.f;
 
@@ -273,152 +274,174 @@ bool LLViewerPartGroup::addPart(LLViewerPart* part, F32 desired_size)
 }
 
 
-void LLViewerPartGroup::updateParticles(const F32 lastdt)
+// Advance one particle by dt, must not touch anything but the particle itself unless it has a callback
+static void simulate_particle(LLViewerPart* part, const F32 dt, LLViewerRegion* regionp)
 {
-    F32 dt;
+    // Update current time
+    const F32 cur_time = part->mLastUpdateTime + dt;
+    const F32 frac = cur_time / part->mMaxAge;
 
-    LLVector3 gravity(0.f, 0.f, GRAVITY);
-
-    LLViewerPartSim::checkParticleCount(static_cast<U32>(mParticles.size()));
-
-    LLViewerCamera* camera = LLViewerCamera::getInstance();
-    LLViewerRegion *regionp = getRegion();
-    S32 end = (S32) mParticles.size();
-    for (S32 i = 0 ; i < (S32)mParticles.size();)
+    // "Drift" the object based on the source object
+    if (part->mFlags & LLPartData::LL_PART_FOLLOW_SRC_MASK)
     {
-        LLVector3 a(0.f, 0.f, 0.f);
-        LLViewerPart* part = mParticles[i] ;
+        part->mPosAgent = part->mPartSourcep->mPosAgent;
+        part->mPosAgent += part->mPosOffset;
+    }
 
-        dt = lastdt + mSkippedTime - part->mSkipOffset;
-        part->mSkipOffset = 0.f;
+    // Do a custom callback if we have one...
+    if (part->mVPCallback)
+    {
+        (*part->mVPCallback)(*part, dt);
+    }
 
-        // Update current time
-        const F32 cur_time = part->mLastUpdateTime + dt;
-        const F32 frac = cur_time / part->mMaxAge;
+    if (part->mFlags & LLPartData::LL_PART_WIND_MASK)
+    {
+        part->mVelocity *= 1.f - 0.1f*dt;
+        part->mVelocity += 0.1f*dt*regionp->mWind.getVelocity(regionp->getPosRegionFromAgent(part->mPosAgent));
+    }
 
-        // "Drift" the object based on the source object
-        if (part->mFlags & LLPartData::LL_PART_FOLLOW_SRC_MASK)
-        {
-            part->mPosAgent = part->mPartSourcep->mPosAgent;
-            part->mPosAgent += part->mPosOffset;
-        }
+    // Now do interpolation towards a target
+    if (part->mFlags & LLPartData::LL_PART_TARGET_POS_MASK)
+    {
+        F32 remaining = part->mMaxAge - part->mLastUpdateTime;
+        F32 step = dt / remaining;
 
-        // Do a custom callback if we have one...
-        if (part->mVPCallback)
-        {
-            (*part->mVPCallback)(*part, dt);
-        }
+        step = llclamp(step, 0.f, 0.1f);
+        step *= 5.f;
+        // we want a velocity that will result in reaching the target in the
+        // Interpolate towards the target.
+        LLVector3 delta_pos = part->mPartSourcep->mTargetPosAgent - part->mPosAgent;
 
-        if (part->mFlags & LLPartData::LL_PART_WIND_MASK)
-        {
-            part->mVelocity *= 1.f - 0.1f*dt;
-            part->mVelocity += 0.1f*dt*regionp->mWind.getVelocity(regionp->getPosRegionFromAgent(part->mPosAgent));
-        }
+        delta_pos /= remaining;
 
-        // Now do interpolation towards a target
-        if (part->mFlags & LLPartData::LL_PART_TARGET_POS_MASK)
-        {
-            F32 remaining = part->mMaxAge - part->mLastUpdateTime;
-            F32 step = dt / remaining;
+        part->mVelocity *= (1.f - step);
+        part->mVelocity += step*delta_pos;
+    }
 
-            step = llclamp(step, 0.f, 0.1f);
-            step *= 5.f;
-            // we want a velocity that will result in reaching the target in the
-            // Interpolate towards the target.
-            LLVector3 delta_pos = part->mPartSourcep->mTargetPosAgent - part->mPosAgent;
 
-            delta_pos /= remaining;
+    if (part->mFlags & LLPartData::LL_PART_TARGET_LINEAR_MASK)
+    {
+        LLVector3 delta_pos = part->mPartSourcep->mTargetPosAgent - part->mPartSourcep->mPosAgent;
+        part->mPosAgent = part->mPartSourcep->mPosAgent;
+        part->mPosAgent += frac*delta_pos;
+        part->mVelocity = delta_pos;
+    }
+    else
+    {
+        // Do velocity interpolation
+        part->mPosAgent += dt*part->mVelocity;
+        part->mPosAgent += 0.5f*dt*dt*part->mAccel;
+        part->mVelocity += part->mAccel*dt;
+    }
 
-            part->mVelocity *= (1.f - step);
-            part->mVelocity += step*delta_pos;
+    // Do a bounce test
+    if (part->mFlags & LLPartData::LL_PART_BOUNCE_MASK)
+    {
+        // Need to do point vs. plane check...
+        // For now, just check relative to object height...
+        F32 dz = part->mPosAgent.mV[VZ] - part->mPartSourcep->mPosAgent.mV[VZ];
+        if (dz < 0)
+        {
+            part->mPosAgent.mV[VZ] += -2.f*dz;
+            part->mVelocity.mV[VZ] *= -0.75f;
         }
+    }
 
 
-        if (part->mFlags & LLPartData::LL_PART_TARGET_LINEAR_MASK)
-        {
-            LLVector3 delta_pos = part->mPartSourcep->mTargetPosAgent - part->mPartSourcep->mPosAgent;
-            part->mPosAgent = part->mPartSourcep->mPosAgent;
-            part->mPosAgent += frac*delta_pos;
-            part->mVelocity = delta_pos;
-        }
-        else
-        {
-            // Do velocity interpolation
-            part->mPosAgent += dt*part->mVelocity;
-            part->mPosAgent += 0.5f*dt*dt*part->mAccel;
-            part->mVelocity += part->mAccel*dt;
-        }
+    // Reset the offset from the source position
+    if (part->mFlags & LLPartData::LL_PART_FOLLOW_SRC_MASK)
+    {
+        part->mPosOffset = part->mPosAgent;
+        part->mPosOffset -= part->mPartSourcep->mPosAgent;
+    }
 
-        // Do a bounce test
-        if (part->mFlags & LLPartData::LL_PART_BOUNCE_MASK)
-        {
-            // Need to do point vs. plane check...
-            // For now, just check relative to object height...
-            F32 dz = part->mPosAgent.mV[VZ] - part->mPartSourcep->mPosAgent.mV[VZ];
-            if (dz < 0)
-            {
-                part->mPosAgent.mV[VZ] += -2.f*dz;
-                part->mVelocity.mV[VZ] *= -0.75f;
-            }
-        }
+    // Do color interpolation
+    if (part->mFlags & LLPartData::LL_PART_INTERP_COLOR_MASK)
+    {
+        part->mColor.setVec(part->mStartColor);
+        // note: LLColor4's v%k means multiply-alpha-only,
+        //       LLColor4's v*k means multiply-rgb-only
+        part->mColor *= 1.f - frac; // rgb*k
+        part->mColor %= 1.f - frac; // alpha*k
+        part->mColor += frac%(frac*part->mEndColor); // rgb,alpha
+    }
 
+    // Do scale interpolation
+    if (part->mFlags & LLPartData::LL_PART_INTERP_SCALE_MASK)
+    {
+        part->mScale.setVec(part->mStartScale);
+        part->mScale *= 1.f - frac;
+        part->mScale += frac*part->mEndScale;
+    }
 
-        // Reset the offset from the source position
-        if (part->mFlags & LLPartData::LL_PART_FOLLOW_SRC_MASK)
-        {
-            part->mPosOffset = part->mPosAgent;
-            part->mPosOffset -= part->mPartSourcep->mPosAgent;
-        }
+    // Do glow interpolation
+    part->mGlow.mV[3] = (U8) ll_round(lerp(part->mStartGlow, part->mEndGlow, frac)*255.f);
 
-        // Do color interpolation
-        if (part->mFlags & LLPartData::LL_PART_INTERP_COLOR_MASK)
-        {
-            part->mColor.setVec(part->mStartColor);
-            // note: LLColor4's v%k means multiply-alpha-only,
-            //       LLColor4's v*k means multiply-rgb-only
-            part->mColor *= 1.f - frac; // rgb*k
-            part->mColor %= 1.f - frac; // alpha*k
-            part->mColor += frac%(frac*part->mEndColor); // rgb,alpha
-        }
+    // Set the last update time to now.
+    part->mLastUpdateTime = cur_time;
+}
+
+void LLViewerPartGroup::simulateParticles(const F32 lastdt, bool with_callbacks, LLViewerCamera* camera)
+{
+    LL_PROFILE_ZONE_SCOPED;
 
-        // Do scale interpolation
-        if (part->mFlags & LLPartData::LL_PART_INTERP_SCALE_MASK)
+    LLViewerRegion *regionp = getRegion();
+    mFates.resize(mParticles.size());
+    for (size_t i = 0; i < mParticles.size(); ++i)
+    {
+        LLViewerPart* part = mParticles[i];
+        if ((part->mVPCallback != NULL) != with_callbacks)
         {
-            part->mScale.setVec(part->mStartScale);
-            part->mScale *= 1.f - frac;
-            part->mScale += frac*part->mEndScale;
+            continue;
         }
 
-        // Do glow interpolation
-        part->mGlow.mV[3] = (U8) ll_round(lerp(part->mStartGlow, part->mEndGlow, frac)*255.f);
-
-        // Set the last update time to now.
-        part->mLastUpdateTime = cur_time;
+        F32 dt = lastdt + mSkippedTime - part->mSkipOffset;
+        part->mSkipOffset = 0.f;
 
+        simulate_particle(part, dt, regionp);
 
         // Kill dead particles (either flagged dead, or too old)
         if ((part->mLastUpdateTime > part->mMaxAge) || (LLViewerPart::LL_PART_DEAD_MASK == part->mFlags))
         {
-            mParticles[i] = mParticles.back() ;
-            mParticles.pop_back() ;
-            delete part ;
+            mFates[i] = PART_DEAD;
         }
         else
         {
             F32 desired_size = calc_desired_size(camera, part->mPosAgent, part->mScale);
-            if (!posInGroup(part->mPosAgent, desired_size))
-            {
-                // Transfer particles between groups
-                LLViewerPartSim::getInstance()->put(part) ;
-                mParticles[i] = mParticles.back() ;
-                mParticles.pop_back() ;
-            }
-            else
-            {
-                i++ ;
-            }
+            mFates[i] = posInGroup(part->mPosAgent, desired_size) ? PART_KEEP : PART_MOVED;
         }
     }
+}
+
+void LLViewerPartGroup::finishUpdate()
+{
+    LLViewerPartSim::checkParticleCount(static_cast<U32>(mParticles.size()));
+    // particles moved in from groups finished earlier this frame have no fate yet
+    llassert(mFates.size() <= mParticles.size());
+
+    static std::vector<LLViewerPart*> moved;
+    moved.clear();
+
+    S32 end = (S32) mParticles.size();
+    size_t kept = 0;
+    for (size_t i = 0; i < mParticles.size(); ++i)
+    {
+        LLViewerPart* part = mParticles[i];
+        switch (i < mFates.size() ? mFates[i] : PART_KEEP)
+        {
+        case PART_KEEP:
+            mParticles[kept++] = part;
+            break;
+        case PART_DEAD:
+            delete part;
+            break;
+        default:
+            moved.push_back(part);
+            break;
+        }
+    }
+    mParticles.resize(kept);
+    mFates.clear();
 
     S32 removed = end - (S32)mParticles.size();
     if (removed > 0)
@@ -431,11 +454,10 @@ void LLViewerPartGroup::updateParticles(const F32 lastdt)
         LLViewerPartSim::decPartCount(removed);
     }
 
-    // Kill the viewer object if this particle group is empty
-    if (mParticles.empty())
+    // Transfer particles between groups
+    for (LLViewerPart* part : moved)
     {
-        gObjectList.killObject(mVOPartGroupp);
-        mVOPartGroupp = NULL;
+        LLViewerPartSim::getInstance()->put(part);
     }
 
     LLViewerPartSim::checkParticleCount() ;
@@ -749,6 +771,13 @@ void LLViewerPartSim::updateSimulation()
         num_updates++;
     }
 
+    // Groups that are due this frame are simulated concurrently, then finished in order
+    // on the main thread, which is where particles die and move between groups
+    static std::vector<LLViewerPartGroup*> due_groups;
+    static std::vector<F32> due_dt;
+    due_groups.clear();
+    due_dt.clear();
+
     count = (S32) mViewerPartGroups.size();
     for (i = 0; i < count; i++)
     {
@@ -772,15 +801,8 @@ void LLViewerPartSim::updateSimulation()
             {
                 gPipeline.markRebuild(vobj->mDrawable, LLDrawable::REBUILD_ALL);
             }
-            mViewerPartGroups[i]->updateParticles(dt * visirate);
-            mViewerPartGroups[i]->mSkippedTime=0.0f;
-            if (!mViewerPartGroups[i]->getCount())
-            {
-                delete mViewerPartGroups[i];
-                mViewerPartGroups.erase(mViewerPartGroups.begin() + i);
-                i--;
-                count--;
-            }
+            due_groups.push_back(mViewerPartGroups[i]);
+            due_dt.push_back(dt * visirate);
         }
         else
         {
@@ -788,6 +810,54 @@ void LLViewerPartSim::updateSimulation()
         }
 
     }
+
+    LLViewerCamera* camera = LLViewerCamera::getInstance();
+    for (size_t g = 0; g < due_groups.size(); ++g)
+    {
+        due_groups[g]->simulateParticles(due_dt[g], true, camera);
+    }
+
+    static LLCachedControl<bool> parallel_particles(gSavedSettings, "ParticleSimulationThreaded", true);
+    if (parallel_particles && due_groups.size() > 1)
+    {
+        LL::parallel_for("General", due_groups.size(), [camera](size_t g)
+            {
+                due_groups[g]->simulateParticles(due_dt[g], false, camera);
+            });
+    }
+    else
+    {
+        for (size_t g = 0; g < due_groups.size(); ++g)
+        {
+            due_groups[g]->simulateParticles(due_dt[g], false, camera);
+        }
+    }
+
+    // particles moving into a group that was due have been accounted for up to now
+    for (LLViewerPartGroup* groupp : due_groups)
+    {
+        groupp->mSkippedTime = 0.f;
+    }
+
+    for (LLViewerPartGroup* groupp : due_groups)
+    {
+        groupp->finishUpdate();
+    }
+
+    // Kill the groups (and their viewer objects) that ran empty
+    for (group_list_t::iterator iter = mViewerPartGroups.begin(); iter != mViewerPartGroups.end(); )
+    {
+        if (!(*iter)->getCount())
+        {
+            delete *iter;
+            iter = mViewerPartGroups.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+
     if (LLDrawable::getCurrentFrame()%16==0)
     {
         if (sParticleCount > sMaxParticleCount * 0.875f
@@ -32,6 +32,7 @@
 #include "llpartdata.h"
 #include "llviewerpartsource.h"
 
+class LLViewerCamera;
 class LLViewerTexture;
 class LLViewerPart;
 class LLViewerRegion;
@@ -97,7 +98,15 @@ public:
 
     bool addPart(LLViewerPart* part, const F32 desired_size = -1.f);
 
-    void updateParticles(const F32 lastdt);
+    // Advance the particles that have a callback (with_callbacks) or those that don't by
+    // lastdt plus the time this group was skipped.  Without callbacks this only touches the
+    // particles of this group, so groups can be simulated concurrently on the thread pool;
+    // callbacks may look at other objects and must run on the main thread.
+    void simulateParticles(const F32 lastdt, bool with_callbacks, LLViewerCamera* camera);
+
+    // Main thread part of the update after simulateParticles:  delete particles that died,
+    // hand the ones that left the box over to other groups
+    void finishUpdate();
 
     bool posInGroup(const LLVector3 &pos, const F32 desired_size = -1.f);
 
@@ -124,6 +133,14 @@ public:
     bool mHud;
 
 protected:
+    enum EFate : U8
+    {
+        PART_KEEP,
+        PART_DEAD,
+        PART_MOVED,     // no longer in this group's box
+    };
+    std::vector<U8> mFates;     // of each particle by the last simulateParticles
+
     LLVector3 mCenterAgent;
     F32 mBoxRadius;
     F32 mBoxSide;
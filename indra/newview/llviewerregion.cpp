@@ -258,7 +258,7 @@ public:
 
 void LLViewerRegionImpl::requestBaseCapabilitiesCoro(U64 regionHandle)
 {
-    LLCore::HttpRequest::policy_t httpPolicy(LLCore::HttpRequest::DEFAULT_POLICY_ID);
+    LLCore::HttpRequest::policy_t httpPolicy(LLAppViewer::instance()->getAppCoreHttp().getRegionPolicy(regionHandle));
     LLCoreHttpUtil::HttpCoroutineAdapter::ptr_t
         httpAdapter(new LLCoreHttpUtil::HttpCoroutineAdapter("BaseCapabilitiesRequest", httpPolicy));
     LLCore::HttpRequest::ptr_t httpRequest(new LLCore::HttpRequest);
@@ -413,7 +413,7 @@ void LLViewerRegionImpl::requestBaseCapabilitiesCoro(U64 regionHandle)
 
 void LLViewerRegionImpl::requestBaseCapabilitiesCompleteCoro(U64 regionHandle)
 {
-    LLCore::HttpRequest::policy_t httpPolicy(LLCore::HttpRequest::DEFAULT_POLICY_ID);
+    LLCore::HttpRequest::policy_t httpPolicy(LLAppViewer::instance()->getAppCoreHttp().getRegionPolicy(regionHandle));
     LLCoreHttpUtil::HttpCoroutineAdapter::ptr_t
         httpAdapter(new LLCoreHttpUtil::HttpCoroutineAdapter("BaseCapabilitiesRequest", httpPolicy));
     LLCore::HttpRequest::ptr_t httpRequest(new LLCore::HttpRequest);
@@ -547,7 +547,7 @@ void LLViewerRegionImpl::requestBaseCapabilitiesCompleteCoro(U64 regionHandle)
 
 void LLViewerRegionImpl::requestSimulatorFeatureCoro(std::string url, U64 regionHandle)
 {
-    LLCore::HttpRequest::policy_t httpPolicy(LLCore::HttpRequest::DEFAULT_POLICY_ID);
+    LLCore::HttpRequest::policy_t httpPolicy(LLAppViewer::instance()->getAppCoreHttp().getRegionPolicy(regionHandle));
     LLCoreHttpUtil::HttpCoroutineAdapter::ptr_t
         httpAdapter(new LLCoreHttpUtil::HttpCoroutineAdapter("BaseCapabilitiesRequest", httpPolicy));
     LLCore::HttpRequest::ptr_t httpRequest(new LLCore::HttpRequest);
@@ -660,6 +660,7 @@ LLViewerRegion::LLViewerRegion(const U64 &handle,
     mLastVisitedEntry(NULL),
     mInvisibilityCheckHistory(-1),
     mPaused(false),
+    mProxyBlend(0.f),
     mRegionCacheHitCount(0),
     mRegionCacheMissCount(0),
     mInterestListMode(IL_MODE_DEFAULT),
@@ -1529,9 +1530,20 @@ void LLViewerRegion::updateVisibleEntries(F32 max_time)
     //
     //process visible groups
     //
+    if(isProxied())
+    {
+        return; //the terrain stands in for the objects of this region
+    }
+
     //object projected area threshold
-    F32 projection_threshold = LLVOCacheEntry::getSquaredPixelThreshold(mImpl->mVOCachePartition->isFrontCull());
+    F32 projection_threshold = getProxyProjectionThreshold(LLVOCacheEntry::getSquaredPixelThreshold(mImpl->mVOCachePartition->isFrontCull()));
     F32 dist_threshold = mImpl->mVOCachePartition->isFrontCull() ? gAgentCamera.mDrawDistance : LLVOCacheEntry::sRearFarRadius;
+    F32 pressure_radius = LLWorld::getInstance()->getMemoryPressureRadius();
+    if (pressure_radius > 0.f)
+    {
+        // don't load what killInvisibleObjects() would send right back
+        dist_threshold = llmin(dist_threshold, pressure_radius);
+    }
 
     std::set< LLPointer<LLViewerOctreeGroup> >::iterator group_iter = mImpl->mVisibleGroups.begin();
     for(; group_iter != mImpl->mVisibleGroups.end(); ++group_iter)
@@ -1702,6 +1714,8 @@ void LLViewerRegion::idleUpdate(F32 max_update_time)
 
     mLastUpdate = LLViewerOctreeEntryData::getCurrentFrame();
 
+    updateProxyBlend();
+
     static LLCachedControl<bool> pbr_terrain_enabled(gSavedSettings, "RenderTerrainPBREnabled", false);
     static LLCachedControl<bool> pbr_terrain_experimental_normals(gSavedSettings, "RenderTerrainPBRNormalsEnabled", false);
     bool pbr_material = mImpl->mCompositionp && (mImpl->mCompositionp->getMaterialType() == LLTerrainMaterials::Type::PBR);
@@ -1836,6 +1850,10 @@ void LLViewerRegion::killInvisibleObjects(F32 max_time)
     LLVector4a local_origin;
     local_origin.load3((LLViewerCamera::getInstance()->getOrigin() - getOriginAgent()).mV);
     F32 back_threshold = LLVOCacheEntry::sRearFarRadius;
+    // while memory is short, everything beyond this goes whether visible or not
+    F32 pressure_radius = LLWorld::getInstance()->getMemoryPressureRadius();
+    // through the proxy fade small objects go first, all of them once the region is proxied
+    F32 proxy_threshold = mProxyBlend > 0.f ? getProxyProjectionThreshold(LLVOCacheEntry::getSquaredPixelThreshold(true)) : 0.f;
 
     size_t max_update = 64;
     if(!mInvisibilityCheckHistory && isViewerCameraStatic())
@@ -1860,7 +1878,26 @@ void LLViewerRegion::killInvisibleObjects(F32 max_time)
         }
 
         LLVOCacheEntry* vo_entry = *iter;
-        if(!vo_entry->isAnyVisible(camera_origin, local_origin, back_threshold) && vo_entry->mLastCameraUpdated < sLastCameraUpdated)
+        bool beyond_pressure_radius = false;
+        if (pressure_radius > 0.f)
+        {
+            LLVector4a look_at;
+            look_at.setSub(vo_entry->getPositionGroup(), local_origin);
+            F32 radius = pressure_radius + vo_entry->getBinRadius();
+            beyond_pressure_radius = look_at.dot3(look_at).getF32() > radius * radius;
+        }
+        bool below_proxy_threshold = false;
+        if (proxy_threshold > 0.f)
+        {
+            // same measure as LLVOCacheEntry::calcSceneContribution()
+            LLVector4a look_at;
+            look_at.setSub(vo_entry->getPositionGroup(), local_origin);
+            F32 distance = look_at.getLength3().getF32() - LLVOCacheEntry::sNearRadius;
+            F32 rad = vo_entry->getBinRadius();
+            below_proxy_threshold = distance > 0.f && rad * rad / distance < proxy_threshold;
+        }
+        if(beyond_pressure_radius || below_proxy_threshold ||
+           (!vo_entry->isAnyVisible(camera_origin, local_origin, back_threshold) && vo_entry->mLastCameraUpdated < sLastCameraUpdated))
         {
             killObject(vo_entry, delete_list);
         }
@@ -1883,6 +1920,10 @@ void LLViewerRegion::killInvisibleObjects(F32 max_time)
     mInvisibilityCheckHistory <<= 1;
     if(!delete_list.empty())
     {
+        if (pressure_radius > 0.f)
+        {
+            LLWorld::getInstance()->addMemoryPressureDemotions((U32)delete_list.size());
+        }
         mInvisibilityCheckHistory |= 1;
         for (auto drawable : delete_list)
         {
@@ -2181,6 +2222,39 @@ void LLViewerRegion::calculateCenterGlobal()
     mImpl->mCenterGlobal.mdV[VZ] = 0.5 * mImpl->mLandp->getMinZ() + mImpl->mLandp->getMaxZ();
 }
 
+void LLViewerRegion::updateProxyBlend()
+{
+    static LLCachedControl<F32> proxy_distance(gSavedSettings, "RenderRegionProxyDistance", 0.f);
+    static LLCachedControl<F32> fade_distance(gSavedSettings, "RenderRegionProxyFadeDistance", 64.f);
+
+    if (proxy_distance <= 0.f || this == gAgent.getRegion())
+    {
+        mProxyBlend = 0.f;
+        return;
+    }
+
+    // horizontal distance from the camera to the nearest edge of the region
+    const LLVector3d camera = gAgentCamera.getCameraPositionGlobal();
+    const LLVector3d& origin = getOriginGlobal();
+    F64 dx = llmax(origin.mdV[VX] - camera.mdV[VX], camera.mdV[VX] - (origin.mdV[VX] + mWidth), 0.0);
+    F64 dy = llmax(origin.mdV[VY] - camera.mdV[VY], camera.mdV[VY] - (origin.mdV[VY] + mWidth), 0.0);
+    F32 distance = (F32)sqrt(dx * dx + dy * dy);
+
+    mProxyBlend = llclamp((distance - proxy_distance) / llmax((F32)fade_distance, 1.f), 0.f, 1.f);
+}
+
+F32 LLViewerRegion::getProxyProjectionThreshold(F32 projection_threshold) const
+{
+    if (isProxied())
+    {
+        return F32_MAX;
+    }
+    // an object has to be 1 / (1 - blend) times larger to stay, so the region thins out
+    // from its smallest objects up rather than all at once at the proxy distance
+    F32 keep = 1.f - mProxyBlend;
+    return projection_threshold / (keep * keep);
+}
+
 void LLViewerRegion::calculateCameraDistance()
 {
     mCameraDistanceSquared = (F32)(gAgentCamera.getCameraPositionGlobal() - getCenterGlobal()).magVecSquared();
@@ -2925,8 +2999,8 @@ LLViewerRegion::eCacheUpdateResult LLViewerRegion::cacheFullUpdate(LLDataPackerB
     {
         entry->setValid();
 
-        // we've seen this object before
-        if (entry->getCRC() == crc)
+        // we've seen this object before, and still have its body
+        if (entry->getCRC() == crc && entry->getDP())
         {
             LL_DEBUGS("AnimatedObjects") << " got dupe for local_id " << local_id << LL_ENDL;
 
@@ -3057,8 +3131,8 @@ bool LLViewerRegion::probeCache(U32 local_id, U32 crc, U32 flags, U8 &cache_miss
 
     if (entry)
     {
-        // we've seen this object before
-        if (entry->getCRC() == crc)
+        // we've seen this object before, a body lost from the mapped cache counts as a miss
+        if (entry->getCRC() == crc && entry->getDP())
         {
             // Record a hit
             mRegionCacheHitCount++;
@@ -3793,6 +3867,11 @@ void LLViewerRegion::logActiveCapabilities() const
 }
 
 
+LLCore::HttpRequest::policy_t LLViewerRegion::getHttpPolicy() const
+{
+    return LLAppViewer::instance()->getAppCoreHttp().getRegionPolicy(getHandle());
+}
+
 bool LLViewerRegion::requestPostCapability(const std::string &capName, LLSD &postData, httpCallback_t cbSuccess, httpCallback_t cbFailure)
 {
     std::string url = getCapability(capName);
@@ -3804,7 +3883,7 @@ bool LLViewerRegion::requestPostCapability(const std::string &capName, LLSD &pos
         return false;
     }
 
-    LLCoreHttpUtil::HttpCoroutineAdapter::callbackHttpPost(url, gAgent.getAgentPolicy(), postData, cbSuccess, cbFailure);
+    LLCoreHttpUtil::HttpCoroutineAdapter::callbackHttpPost(url, getHttpPolicy(), postData, cbSuccess, cbFailure);
     return true;
 }
 
@@ -3821,7 +3900,7 @@ bool LLViewerRegion::requestGetCapability(const std::string &capName, httpCallba
         return false;
     }
 
-    LLCoreHttpUtil::HttpCoroutineAdapter::callbackHttpGet(url, gAgent.getAgentPolicy(), cbSuccess, cbFailure);
+    LLCoreHttpUtil::HttpCoroutineAdapter::callbackHttpGet(url, getHttpPolicy(), cbSuccess, cbFailure);
     return true;
 }
 
@@ -3837,7 +3916,7 @@ bool LLViewerRegion::requestDelCapability(const std::string &capName, httpCallba
         return false;
     }
 
-    LLCoreHttpUtil::HttpCoroutineAdapter::callbackHttpDel(url, gAgent.getAgentPolicy(), cbSuccess, cbFailure);
+    LLCoreHttpUtil::HttpCoroutineAdapter::callbackHttpDel(url, getHttpPolicy(), cbSuccess, cbFailure);
     return true;
 }
 
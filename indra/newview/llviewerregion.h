@@ -308,7 +308,7 @@ public:
     void logActiveCapabilities() const;
 
     // Utilities to post and get via
-    // HTTP using the agent's policy settings and headers.
+    // HTTP using the region's policy class.
     typedef LLCoreHttpUtil::HttpCoroutineAdapter::completionCallback_t httpCallback_t;
     bool requestPostCapability(const std::string &capName,
                                LLSD              &postData,
@@ -317,6 +317,9 @@ public:
     bool requestGetCapability(const std::string &capName, httpCallback_t cbSuccess = NULL, httpCallback_t cbFailure = NULL);
     bool requestDelCapability(const std::string &capName, httpCallback_t cbSuccess = NULL, httpCallback_t cbFailure = NULL);
 
+    // Policy class for HTTP requests to this region's capabilities
+    LLCore::HttpRequest::policy_t getHttpPolicy() const;
+
     /// implements LLCapabilityProvider
     /*virtual*/ const LLHost& getHost() const;
     const U64       &getHandle() const          { return mHandle; }
@@ -450,6 +453,12 @@ public:
     void addToCreatedList(U32 local_id);
 
     bool isPaused() const {return mPaused;}
+
+    // Region level LOD: 0 while the region is within RenderRegionProxyDistance of the camera,
+    // rising to 1 over RenderRegionProxyFadeDistance.  At 1 the terrain stands in for the
+    // whole region and its objects stay in the object cache.
+    F32  getProxyBlend() const {return mProxyBlend;}
+    bool isProxied() const {return mProxyBlend >= 1.f;}
     S32  getLastUpdate() const {return mLastUpdate;}
 
     std::string getSimHostName();
@@ -468,6 +477,8 @@ private:
     void killInvisibleObjects(F32 max_time);
     void createVisibleObjects(F32 max_time);
     void updateVisibleEntries(F32 max_time); //update visible entries
+    void updateProxyBlend();
+    F32  getProxyProjectionThreshold(F32 projection_threshold) const; //raised through the proxy fade
 
     void addCacheMiss(U32 id, LLViewerRegion::eCacheMissType miss_type);
     void decodeBoundingInfo(LLVOCacheEntry* entry);
@@ -606,6 +617,7 @@ public:
     bool    mReleaseNotesRequested;
     bool    mDead;  //if true, this region is in the process of deleting.
     bool    mPaused; //pause processing the objects in the region
+    F32     mProxyBlend;
 
     typedef enum
     {
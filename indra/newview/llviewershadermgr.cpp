@@ -40,6 +40,9 @@
 #include "llatmosphere.h"
 #include "llworld.h"
 #include "llsky.h"
+#include "llterrainheightfield.h"
+#include "llvotree.h"
+#include "lldrawpooltree.h"
 
 #include "pipeline.h"
 
@@ -96,10 +99,14 @@ LLGLSLShader    gNormalDebugProgram[NORMAL_DEBUG_SHADER_COUNT];
 LLGLSLShader    gSkinnedNormalDebugProgram[NORMAL_DEBUG_SHADER_COUNT];
 LLGLSLShader    gClipProgram;
 LLGLSLShader    gAlphaMaskProgram;
+LLGLSLShader    gAlphaRampProgram;
 LLGLSLShader    gBenchmarkProgram;
 LLGLSLShader    gReflectionProbeDisplayProgram;
 LLGLSLShader    gCopyProgram;
 LLGLSLShader    gCopyDepthProgram;
+LLGLSLShader    gHiZDownsampleProgram;
+LLGLSLShader    gOcclusionCullProgram;
+LLGLSLShader    gSkinCacheProgram;
 LLGLSLShader    gPBRTerrainBakeProgram;
 
 //object shaders
@@ -149,8 +156,12 @@ LLGLSLShader            gDeferredSkinnedDiffuseProgram;
 LLGLSLShader            gDeferredSkinnedBumpProgram;
 LLGLSLShader            gDeferredBumpProgram;
 LLGLSLShader            gDeferredTerrainProgram;
+LLGLSLShader            gDeferredTerrainHeightfieldProgram;
+LLGLSLShader            gDeferredTerrainHeightfieldShadowProgram;
 LLGLSLShader            gDeferredTreeProgram;
 LLGLSLShader            gDeferredTreeShadowProgram;
+LLGLSLShader            gDeferredTreeInstancedProgram;
+LLGLSLShader            gDeferredTreeShadowInstancedProgram;
 LLGLSLShader            gDeferredSkinnedTreeShadowProgram;
 LLGLSLShader            gDeferredAvatarProgram;
 LLGLSLShader            gDeferredAvatarAlphaProgram;
@@ -158,6 +169,8 @@ LLGLSLShader            gDeferredLightProgram;
 LLGLSLShader            gDeferredMultiLightProgram[16];
 LLGLSLShader            gDeferredSpotLightProgram;
 LLGLSLShader            gDeferredMultiSpotLightProgram;
+LLGLSLShader            gDeferredClusterLightProgram;
+LLGLSLShader            gClusterLightsProgram;
 LLGLSLShader            gDeferredSunProgram;
 LLGLSLShader            gHazeProgram;
 LLGLSLShader            gHazeWaterProgram;
@@ -232,6 +245,7 @@ LLGLSLShader            gHUDPBRAlphaProgram;
 LLGLSLShader            gDeferredPBRAlphaProgram;
 LLGLSLShader            gDeferredSkinnedPBRAlphaProgram;
 LLGLSLShader            gDeferredPBRTerrainProgram[TERRAIN_PAINT_TYPE_COUNT];
+LLGLSLShader            gDeferredPBRTerrainHeightfieldProgram[TERRAIN_PAINT_TYPE_COUNT];
 
 LLGLSLShader            gGLTFPBRMetallicRoughnessProgram;
 
@@ -267,6 +281,7 @@ static bool make_gltf_variant(LLGLSLShader& shader, LLGLSLShader& variant, bool
     U32 node_size = 16 * 3;
     U32 max_nodes = gGLManager.mMaxUniformBlockSize / node_size;
     variant.addPermutation("MAX_NODES_PER_GLTF_OBJECT", std::to_string(max_nodes));
+    variant.addPermutation("MAX_GLTF_INSTANCES", std::to_string(LLGLSLShader::MAX_GLTF_INSTANCES));
 
     U32 material_size = 16 * 12;
     U32 max_materials = gGLManager.mMaxUniformBlockSize / material_size;
@@ -448,9 +463,22 @@ void LLViewerShaderMgr::finalizeShaderList()
         mShaderList.push_back(&gDeferredPBRTerrainProgram[paint_type]);
     }
 
+    if (LLTerrainHeightfield::sEnabled)
+    {
+        mShaderList.push_back(&gDeferredTerrainHeightfieldProgram);
+        for (U32 paint_type = 0; paint_type < TERRAIN_PAINT_TYPE_COUNT; ++paint_type)
+        {
+            mShaderList.push_back(&gDeferredPBRTerrainHeightfieldProgram[paint_type]);
+        }
+    }
+
     mShaderList.push_back(&gDeferredDiffuseAlphaMaskProgram);
     mShaderList.push_back(&gDeferredNonIndexedDiffuseAlphaMaskProgram);
     mShaderList.push_back(&gDeferredTreeProgram);
+    if (LLVOTree::sInstancing)
+    {
+        mShaderList.push_back(&gDeferredTreeInstancedProgram);
+    }
 
     // make sure there are no redundancies
     llassert(no_redundant_shaders(mShaderList));
@@ -551,7 +579,10 @@ void LLViewerShaderMgr::setShaders()
     initAttribsAndUniforms();
     gPipeline.releaseGLBuffers();
 
+    // shaders that come back with the same sources and defines keep their programs
+    LLGLSLShader::sRetainPrograms = true;
     unloadShaders();
+    LLGLSLShader::sRetainPrograms = false;
 
     LLPipeline::sRenderGlow = gSavedSettings.getBOOL("RenderGlow");
 
@@ -696,6 +727,8 @@ void LLViewerShaderMgr::setShaders()
 
     finalizeShaderList();
 
+    LLGLSLShader::releaseRetainedPrograms();
+
     reentrance = false;
 }
 
@@ -815,14 +848,11 @@ std::string LLViewerShaderMgr::loadBasicShaders()
     LLGLSLShader::sGlobalDefines = attribs;
 
     // We no longer have to bind the shaders to global glhandles, they are automatically added to a map now.
+    // Vertex and fragment shaders are compiled together, see loadShaderFiles()
+    std::vector<ShaderFileLoad> files;
     for (U32 i = 0; i < shaders.size(); i++)
     {
-        // Note usage of GL_VERTEX_SHADER
-        if (loadShaderFile(shaders[i].first, shaders[i].second, GL_VERTEX_SHADER, &attribs) == 0)
-        {
-            LL_WARNS("Shader") << "Failed to load vertex shader " << shaders[i].first << LL_ENDL;
-            return shaders[i].first;
-        }
+        files.push_back({ shaders[i].first, shaders[i].second, GL_VERTEX_SHADER, -1, 0 });
     }
 
     // Load the Basic Fragment Shaders at the appropriate level.
@@ -859,11 +889,19 @@ std::string LLViewerShaderMgr::loadBasicShaders()
 
     for (U32 i = 0; i < shaders.size(); i++)
     {
-        // Note usage of GL_FRAGMENT_SHADER
-        if (loadShaderFile(shaders[i].first, shaders[i].second, GL_FRAGMENT_SHADER, &attribs, index_channels[i]) == 0)
+        files.push_back({ shaders[i].first, shaders[i].second, GL_FRAGMENT_SHADER, index_channels[i], 0 });
+    }
+
+    if (!loadShaderFiles(files, &attribs))
+    {
+        for (const ShaderFileLoad& file : files)
         {
-            LL_WARNS("Shader") << "Failed to load fragment shader " << shaders[i].first << LL_ENDL;
-            return shaders[i].first;
+            if (!file.mHandle)
+            {
+                LL_WARNS("Shader") << "Failed to load " << (file.mType == GL_VERTEX_SHADER ? "vertex" : "fragment")
+                                   << " shader " << file.mFilename << LL_ENDL;
+                return file.mFilename;
+            }
         }
     }
 
@@ -1069,6 +1107,8 @@ bool LLViewerShaderMgr::loadShadersDeferred()
     {
         gDeferredTreeProgram.unload();
         gDeferredTreeShadowProgram.unload();
+        gDeferredTreeInstancedProgram.unload();
+        gDeferredTreeShadowInstancedProgram.unload();
         gDeferredSkinnedTreeShadowProgram.unload();
         gDeferredDiffuseProgram.unload();
         gDeferredSkinnedDiffuseProgram.unload();
@@ -1080,6 +1120,8 @@ bool LLViewerShaderMgr::loadShadersDeferred()
         gDeferredSkinnedBumpProgram.unload();
         gDeferredImpostorProgram.unload();
         gDeferredTerrainProgram.unload();
+        gDeferredTerrainHeightfieldProgram.unload();
+        gDeferredTerrainHeightfieldShadowProgram.unload();
         gDeferredLightProgram.unload();
         for (U32 i = 0; i < LL_DEFERRED_MULTI_LIGHT_COUNT; ++i)
         {
@@ -1087,6 +1129,8 @@ bool LLViewerShaderMgr::loadShadersDeferred()
         }
         gDeferredSpotLightProgram.unload();
         gDeferredMultiSpotLightProgram.unload();
+        gDeferredClusterLightProgram.unload();
+        gClusterLightsProgram.unload();
         gDeferredSunProgram.unload();
         gDeferredBlurLightProgram.unload();
         gDeferredSoftenProgram.unload();
@@ -1160,6 +1204,7 @@ bool LLViewerShaderMgr::loadShadersDeferred()
         for (U32 paint_type = 0; paint_type < TERRAIN_PAINT_TYPE_COUNT; ++paint_type)
         {
             gDeferredPBRTerrainProgram[paint_type].unload();
+            gDeferredPBRTerrainHeightfieldProgram[paint_type].unload();
         }
 
         // [RLVa:KB] - @setsphere
@@ -1511,6 +1556,23 @@ bool LLViewerShaderMgr::loadShadersDeferred()
             shader->addPermutation("TERRAIN_PLANAR_TEXTURE_SAMPLE_COUNT", llformat("%d", mapping));
             success = success && shader->createShader();
             llassert(success);
+
+            if (success && LLTerrainHeightfield::sEnabled)
+            {
+                LLGLSLShader* heightfield_shader = &gDeferredPBRTerrainHeightfieldProgram[paint_type];
+                heightfield_shader->mName = shader->mName + " heightfield";
+                heightfield_shader->mFeatures = shader->mFeatures;
+                heightfield_shader->mFeatures.isTerrainHeightfield = true;
+                heightfield_shader->mShaderFiles = shader->mShaderFiles;
+                heightfield_shader->mShaderLevel = shader->mShaderLevel;
+                heightfield_shader->clearPermutations();
+                heightfield_shader->addPermutation("TERRAIN_PBR_DETAIL", llformat("%d", detail));
+                heightfield_shader->addPermutation("TERRAIN_PAINT_TYPE", llformat("%d", paint_type));
+                heightfield_shader->addPermutation("TERRAIN_PLANAR_TEXTURE_SAMPLE_COUNT", llformat("%d", mapping));
+                heightfield_shader->addPermutation("TERRAIN_HEIGHTFIELD", "1");
+                success = heightfield_shader->createShader();
+                llassert(success);
+            }
         }
     }
 
@@ -1536,6 +1598,32 @@ bool LLViewerShaderMgr::loadShadersDeferred()
         llassert(success);
     }
 
+    if (success && LLVOTree::sInstancing)
+    {
+        std::string max_instances = std::to_string(LLDrawPoolTree::MAX_INSTANCES);
+
+        gDeferredTreeInstancedProgram.mName = "Deferred Tree Instanced Shader";
+        gDeferredTreeInstancedProgram.mShaderFiles = gDeferredTreeProgram.mShaderFiles;
+        gDeferredTreeInstancedProgram.mShaderLevel = mShaderLevel[SHADER_DEFERRED];
+        gDeferredTreeInstancedProgram.clearPermutations();
+        gDeferredTreeInstancedProgram.addPermutation("TREE_INSTANCED", "1");
+        gDeferredTreeInstancedProgram.addPermutation("MAX_TREE_INSTANCES", max_instances);
+        success = gDeferredTreeInstancedProgram.createShader();
+        llassert(success);
+
+        if (success)
+        {
+            gDeferredTreeShadowInstancedProgram.mName = "Deferred Tree Shadow Instanced Shader";
+            gDeferredTreeShadowInstancedProgram.mShaderFiles = gDeferredTreeShadowProgram.mShaderFiles;
+            gDeferredTreeShadowInstancedProgram.mShaderLevel = mShaderLevel[SHADER_DEFERRED];
+            gDeferredTreeShadowInstancedProgram.clearPermutations();
+            gDeferredTreeShadowInstancedProgram.addPermutation("TREE_INSTANCED", "1");
+            gDeferredTreeShadowInstancedProgram.addPermutation("MAX_TREE_INSTANCES", max_instances);
+            success = gDeferredTreeShadowInstancedProgram.createShader();
+            llassert(success);
+        }
+    }
+
     if (success)
     {
         gDeferredSkinnedTreeShadowProgram.mName = "Deferred Skinned Tree Shadow Shader";
@@ -1634,6 +1722,41 @@ bool LLViewerShaderMgr::loadShadersDeferred()
         llassert(success);
     }
 
+    if (success && gGLManager.mGLVersion >= 4.29f)
+    { // clustered local lights, optional -- LLClusteredLighting falls back to per-light rendering without them
+        auto add_cluster_defines = [](LLGLSLShader& shader)
+        {
+            shader.clearPermutations();
+            shader.addPermutation("CLUSTER_X", llformat("%d", LLClusteredLighting::CLUSTER_X));
+            shader.addPermutation("CLUSTER_Y", llformat("%d", LLClusteredLighting::CLUSTER_Y));
+            shader.addPermutation("CLUSTER_Z", llformat("%d", LLClusteredLighting::CLUSTER_Z));
+            shader.addPermutation("CLUSTER_MAX_LIGHTS", llformat("%d", LLClusteredLighting::CLUSTER_MAX_LIGHTS));
+        };
+
+        gClusterLightsProgram.mName = "Cluster Lights Shader";
+        gClusterLightsProgram.mShaderFiles.clear();
+        gClusterLightsProgram.mShaderFiles.push_back(make_pair("deferred/clusterLightsC.glsl", GL_COMPUTE_SHADER));
+        gClusterLightsProgram.mShaderLevel = mShaderLevel[SHADER_DEFERRED];
+        add_cluster_defines(gClusterLightsProgram);
+
+        gDeferredClusterLightProgram.mName = "Deferred Cluster Light Shader";
+        gDeferredClusterLightProgram.mFeatures.isDeferred = true;
+        gDeferredClusterLightProgram.mFeatures.hasShadows = true;
+        gDeferredClusterLightProgram.mFeatures.hasSrgb = true;
+        gDeferredClusterLightProgram.mShaderFiles.clear();
+        gDeferredClusterLightProgram.mShaderFiles.push_back(make_pair("deferred/multiPointLightV.glsl", GL_VERTEX_SHADER));
+        gDeferredClusterLightProgram.mShaderFiles.push_back(make_pair("deferred/clusterLightF.glsl", GL_FRAGMENT_SHADER));
+        gDeferredClusterLightProgram.mShaderLevel = mShaderLevel[SHADER_DEFERRED];
+        add_cluster_defines(gDeferredClusterLightProgram);
+
+        if (!gClusterLightsProgram.createShader() || !gDeferredClusterLightProgram.createShader())
+        {
+            LL_WARNS() << "Failed to create clustered lighting shaders, using per-light rendering" << LL_ENDL;
+            gClusterLightsProgram.unload();
+            gDeferredClusterLightProgram.unload();
+        }
+    }
+
     if (success)
     {
         std::string fragment;
@@ -2230,6 +2353,33 @@ bool LLViewerShaderMgr::loadShadersDeferred()
         llassert(success);
     }
 
+    if (success && LLTerrainHeightfield::sEnabled)
+    {
+        gDeferredTerrainHeightfieldProgram.mName = "Deferred Terrain Heightfield Shader";
+        gDeferredTerrainHeightfieldProgram.mFeatures = gDeferredTerrainProgram.mFeatures;
+        gDeferredTerrainHeightfieldProgram.mFeatures.isTerrainHeightfield = true;
+        gDeferredTerrainHeightfieldProgram.mShaderFiles.clear();
+        gDeferredTerrainHeightfieldProgram.mShaderFiles.push_back(make_pair("deferred/terrainV.glsl", GL_VERTEX_SHADER));
+        gDeferredTerrainHeightfieldProgram.mShaderFiles.push_back(make_pair("deferred/terrainF.glsl", GL_FRAGMENT_SHADER));
+        gDeferredTerrainHeightfieldProgram.mShaderLevel = mShaderLevel[SHADER_DEFERRED];
+        gDeferredTerrainHeightfieldProgram.clearPermutations();
+        gDeferredTerrainHeightfieldProgram.addPermutation("TERRAIN_HEIGHTFIELD", "1");
+        success = gDeferredTerrainHeightfieldProgram.createShader();
+        llassert(success);
+    }
+
+    if (success && LLTerrainHeightfield::sEnabled)
+    {
+        gDeferredTerrainHeightfieldShadowProgram.mName = "Deferred Terrain Heightfield Shadow Shader";
+        gDeferredTerrainHeightfieldShadowProgram.mFeatures.isTerrainHeightfield = true;
+        gDeferredTerrainHeightfieldShadowProgram.mShaderFiles.clear();
+        gDeferredTerrainHeightfieldShadowProgram.mShaderFiles.push_back(make_pair("deferred/terrainHeightfieldShadowV.glsl", GL_VERTEX_SHADER));
+        gDeferredTerrainHeightfieldShadowProgram.mShaderFiles.push_back(make_pair("deferred/shadowF.glsl", GL_FRAGMENT_SHADER));
+        gDeferredTerrainHeightfieldShadowProgram.mShaderLevel = mShaderLevel[SHADER_DEFERRED];
+        success = gDeferredTerrainHeightfieldShadowProgram.createShader();
+        llassert(success);
+    }
+
     if (success)
     {
         gDeferredAvatarProgram.mName = "Deferred Avatar Shader";
@@ -3021,6 +3171,40 @@ bool LLViewerShaderMgr::loadShadersInterface()
         success = gCopyDepthProgram.createShader();
     }
 
+    if (success && gGLManager.mGLVersion >= 4.29f)
+    { // compute shaders for GPU occlusion culling, optional -- LLGPUOcclusionCuller falls back to occlusion queries without them
+        gHiZDownsampleProgram.mName = "Hi-Z Downsample Shader";
+        gHiZDownsampleProgram.mShaderFiles.clear();
+        gHiZDownsampleProgram.mShaderFiles.push_back(make_pair("interface/hizDownsampleC.glsl", GL_COMPUTE_SHADER));
+        gHiZDownsampleProgram.mShaderLevel = mShaderLevel[SHADER_INTERFACE];
+
+        gOcclusionCullProgram.mName = "Occlusion Cull Shader";
+        gOcclusionCullProgram.mShaderFiles.clear();
+        gOcclusionCullProgram.mShaderFiles.push_back(make_pair("interface/occlusionCullC.glsl", GL_COMPUTE_SHADER));
+        gOcclusionCullProgram.mShaderLevel = mShaderLevel[SHADER_INTERFACE];
+
+        if (!gHiZDownsampleProgram.createShader() || !gOcclusionCullProgram.createShader())
+        {
+            LL_WARNS() << "Failed to create GPU occlusion culling shaders, using occlusion queries" << LL_ENDL;
+            gHiZDownsampleProgram.unload();
+            gOcclusionCullProgram.unload();
+        }
+    }
+
+    if (success && gGLManager.mGLVersion >= 4.29f)
+    { // compute shader for GPU skinning, optional -- rigged meshes fall back to skinning in their vertex shaders
+        gSkinCacheProgram.mName = "Skin Cache Shader";
+        gSkinCacheProgram.mShaderFiles.clear();
+        gSkinCacheProgram.mShaderFiles.push_back(make_pair("avatar/skinCacheC.glsl", GL_COMPUTE_SHADER));
+        gSkinCacheProgram.mShaderLevel = mShaderLevel[SHADER_INTERFACE];
+
+        if (!gSkinCacheProgram.createShader())
+        {
+            LL_WARNS() << "Failed to create GPU skinning shader, skinning in vertex shaders" << LL_ENDL;
+            gSkinCacheProgram.unload();
+        }
+    }
+
     if (gSavedSettings.getBOOL("LocalTerrainPaintEnabled"))
     {
         if (success)
@@ -3060,6 +3244,20 @@ bool LLViewerShaderMgr::loadShadersInterface()
         success = gAlphaMaskProgram.createShader();
     }
 
+    if (success)
+    {
+        gAlphaRampProgram.mName = "Alpha Ramp Shader";
+        gAlphaRampProgram.mShaderFiles.clear();
+        gAlphaRampProgram.mShaderFiles.push_back(make_pair("interface/alphamaskV.glsl", GL_VERTEX_SHADER));
+        gAlphaRampProgram.mShaderFiles.push_back(make_pair("interface/alpharampF.glsl", GL_FRAGMENT_SHADER));
+        gAlphaRampProgram.mShaderLevel = mShaderLevel[SHADER_INTERFACE];
+        if (!gAlphaRampProgram.createShader())
+        {
+            // alpha params fall back to processing on the CPU
+            LL_WARNS() << "Failed to create shader '" << gAlphaRampProgram.mName << "'" << LL_ENDL;
+        }
+    }
+
     if (success)
     {
         gReflectionMipProgram.mName = "Reflection Mip Shader";
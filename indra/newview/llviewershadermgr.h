@@ -174,6 +174,9 @@ extern LLGLSLShader         gBenchmarkProgram;
 extern LLGLSLShader         gReflectionProbeDisplayProgram;
 extern LLGLSLShader         gCopyProgram;
 extern LLGLSLShader         gCopyDepthProgram;
+extern LLGLSLShader         gHiZDownsampleProgram;
+extern LLGLSLShader         gOcclusionCullProgram;
+extern LLGLSLShader         gSkinCacheProgram;
 extern LLGLSLShader         gPBRTerrainBakeProgram;
 
 //output tex0[tc0] - tex1[tc1]
@@ -224,12 +227,18 @@ extern LLGLSLShader         gDeferredNonIndexedDiffuseAlphaMaskNoColorProgram;
 extern LLGLSLShader         gDeferredNonIndexedDiffuseProgram;
 extern LLGLSLShader         gDeferredBumpProgram;
 extern LLGLSLShader         gDeferredTerrainProgram;
+extern LLGLSLShader         gDeferredTerrainHeightfieldProgram;
+extern LLGLSLShader         gDeferredTerrainHeightfieldShadowProgram;
 extern LLGLSLShader         gDeferredTreeProgram;
 extern LLGLSLShader         gDeferredTreeShadowProgram;
+extern LLGLSLShader         gDeferredTreeInstancedProgram;
+extern LLGLSLShader         gDeferredTreeShadowInstancedProgram;
 extern LLGLSLShader         gDeferredLightProgram;
 extern LLGLSLShader         gDeferredMultiLightProgram[LL_DEFERRED_MULTI_LIGHT_COUNT];
 extern LLGLSLShader         gDeferredSpotLightProgram;
 extern LLGLSLShader         gDeferredMultiSpotLightProgram;
+extern LLGLSLShader         gDeferredClusterLightProgram;
+extern LLGLSLShader         gClusterLightsProgram;
 extern LLGLSLShader         gDeferredSunProgram;
 extern LLGLSLShader         gHazeProgram;
 extern LLGLSLShader         gHazeWaterProgram;
@@ -318,4 +327,5 @@ enum TerrainPaintType : U32
     TERRAIN_PAINT_TYPE_COUNT                = 2,
 };
 extern LLGLSLShader         gDeferredPBRTerrainProgram[TERRAIN_PAINT_TYPE_COUNT];
+extern LLGLSLShader         gDeferredPBRTerrainHeightfieldProgram[TERRAIN_PAINT_TYPE_COUNT];
 #endif
@@ -57,6 +57,8 @@
 #include "llworld.h"
 #include "llfeaturemanager.h"
 #include "llviewernetwork.h"
+#include "llframearena.h"
+#include "llmemtag.h"
 #include "llmeshrepository.h" //for LLMeshRepository::sBytesReceived
 #include "llperfstats.h"
 #include "llsdserialize.h"
@@ -140,7 +142,9 @@ LLTrace::CountStatHandle<>  FPS("FPS", "Frames rendered"),
                             FRAMETIME_DOUBLED("frametimedoubled", "Ratio of frames 2x longer than previous"),
                             TEX_BAKES("texbakes", "Number of times avatar textures have been baked"),
                             TEX_REBAKES("texrebakes", "Number of times avatar textures have been forced to rebake"),
-                            NUM_NEW_OBJECTS("numnewobjectsstat", "Number of objects in scene that were not previously in cache");
+                            NUM_NEW_OBJECTS("numnewobjectsstat", "Number of objects in scene that were not previously in cache"),
+                            GROUPS_REBUILT("groupsrebuilt", "Spatial group geometry rebuilds"),
+                            SHADOW_CACHE_REBUILDS("shadowcacherebuilds", "Cached sun shadow cascades re-rendered");
 
 LLTrace::CountStatHandle<LLUnit<F64, LLUnits::Kilotriangles> >
                             TRIANGLES_DRAWN("trianglesdrawnstat");
@@ -202,7 +206,8 @@ LLTrace::SampleStatHandle<> FPS_SAMPLE("fpssample"),
                             SHADER_OBJECTS("shaderobjects", "Object Shaders"),
                             DRAW_DISTANCE("drawdistance", "Draw Distance"),
                             WINDOW_WIDTH("windowwidth", "Window width"),
-                            WINDOW_HEIGHT("windowheight", "Window height");
+                            WINDOW_HEIGHT("windowheight", "Window height"),
+                            REBUILD_QUEUE_DEPTH("rebuildqueuedepth", "Spatial groups waiting for a deferred geometry rebuild");
 
 LLTrace::SampleStatHandle<LLUnit<F32, LLUnits::Percent> >
                             PACKETS_LOST_PERCENT("packetslostpercentstat");
@@ -210,9 +215,17 @@ LLTrace::SampleStatHandle<LLUnit<F32, LLUnits::Percent> >
 static LLTrace::SampleStatHandle<bool>
                             CHAT_BUBBLES("chatbubbles", "Chat Bubbles Enabled");
 
-LLTrace::SampleStatHandle<F64Megabytes > FORMATTED_MEM("formattedmemstat");
+LLTrace::SampleStatHandle<F64Megabytes > FORMATTED_MEM("formattedmemstat"),
+                                        MEM_IMAGES("memimagesstat", "Heap used by image buffers, see LLMemTag"),
+                                        MEM_OBJECT_CACHE("memobjectcachestat", "Heap used by object cache entries, see LLMemTag"),
+                                        MEM_FRAME_ARENA("memframearenastat", "Most memory the frame arenas of all threads held at once, see LLFrameArena");
 LLTrace::SampleStatHandle<F64Kilobytes >    DELTA_BANDWIDTH("deltabandwidth", "Increase/Decrease in bandwidth based on packet loss"),
                                                             MAX_BANDWIDTH("maxbandwidth", "Max bandwidth setting");
+LLTrace::SampleStatHandle<F64Kilobits >     THROTTLE_TOTAL("throttletotal", "Bandwidth per second the simulator may send"),
+                                            THROTTLE_TASK("throttletask", "Share of the throttle for object updates"),
+                                            THROTTLE_TEXTURE("throttletexture", "Share of the throttle for UDP textures"),
+                                            THROTTLE_ASSET("throttleasset", "Share of the throttle for UDP assets"),
+                                            THROTTLE_LAYERS("throttlelayers", "Share of the throttle for land, wind and cloud layers");
 
 
 SimMeasurement<F64Milliseconds >    SIM_FRAME_TIME("simframemsec", "", LL_SIM_STAT_FRAMEMS),
@@ -236,6 +249,7 @@ SimMeasurement<F64Megabytes >   SIM_PHYSICS_MEM("physicsmemoryallocated", "", LL
 LLTrace::SampleStatHandle<F64Milliseconds > FRAMETIME_JITTER("frametimejitter", "Average delta between successive frame times"),
                                             FRAMETIME_SLEW("frametimeslew", "Average delta between frame time and mean"),
                                             FRAMETIME("frametime", "Measured frame time"),
+                                            INPUT_LATENCY("inputlatency", "Time from gathering input to the GPU finishing the frame"),
                                             SIM_PING("simpingstat");
 
 LLTrace::EventStatHandle<LLUnit<F64, LLUnits::Meters> > AGENT_POSITION_SNAP("agentpositionsnap", "agent position corrections");
@@ -334,6 +348,12 @@ void LLViewerStats::updateFrameStats(const F64Seconds time_diff)
         F32 delta_bandwidth = gViewerThrottle.getCurrentBandwidth() - max_bandwidth;
         sample(LLStatViewer::DELTA_BANDWIDTH, F64Bits(delta_bandwidth));
         sample(LLStatViewer::MAX_BANDWIDTH, F64Bits(max_bandwidth));
+
+        sample(LLStatViewer::THROTTLE_TOTAL, F64Kilobits(gViewerThrottle.getCurrentBandwidth() / 1024.f));
+        sample(LLStatViewer::THROTTLE_TASK, F64Kilobits(gViewerThrottle.getThrottle(TC_TASK)));
+        sample(LLStatViewer::THROTTLE_TEXTURE, F64Kilobits(gViewerThrottle.getThrottle(TC_TEXTURE)));
+        sample(LLStatViewer::THROTTLE_ASSET, F64Kilobits(gViewerThrottle.getThrottle(TC_ASSET)));
+        sample(LLStatViewer::THROTTLE_LAYERS, F64Kilobits(gViewerThrottle.getThrottle(TC_LAND) + gViewerThrottle.getThrottle(TC_WIND) + gViewerThrottle.getThrottle(TC_CLOUD)));
     }
 
     mLastTimeDiff = time_diff;
@@ -439,9 +459,21 @@ void update_statistics()
     add(LLStatViewer::LAYERS_NETWORK_DATA_RECEIVED, layer_bits);
     add(LLStatViewer::OBJECT_NETWORK_DATA_RECEIVED, gObjectData);
     add(LLStatViewer::ASSET_UDP_DATA_RECEIVED, F64Bits(gTransferManager.getTransferBitsIn(LLTCT_ASSET)));
+
+    gViewerThrottle.addReceived(TC_LAND, (F32)gVLManager.getLandBits().value());
+    gViewerThrottle.addReceived(TC_WIND, (F32)gVLManager.getWindBits().value());
+    gViewerThrottle.addReceived(TC_CLOUD, (F32)gVLManager.getCloudBits().value());
+    gViewerThrottle.addReceived(TC_TASK, (F32)gObjectData.value());
+    gViewerThrottle.addReceived(TC_ASSET, (F32)gTransferManager.getTransferBitsIn(LLTCT_ASSET));
     gTransferManager.resetTransferBitsIn(LLTCT_ASSET);
 
     sample(LLStatViewer::VISIBLE_AVATARS, LLVOAvatar::sNumVisibleAvatars);
+
+    static const LLMemTag* image_mem_tag = LLMemTag::find("Images");
+    static const LLMemTag* object_cache_mem_tag = LLMemTag::find("Object cache");
+    sample(LLStatViewer::MEM_IMAGES, F64Bytes(image_mem_tag ? (F64)image_mem_tag->getBytes() : 0.0));
+    sample(LLStatViewer::MEM_OBJECT_CACHE, F64Bytes(object_cache_mem_tag ? (F64)object_cache_mem_tag->getBytes() : 0.0));
+    sample(LLStatViewer::MEM_FRAME_ARENA, F64Bytes((F64)LLFrameArena::getPeakBytes()));
     LLWorld *world = LLWorld::getInstance(); // not LLSingleton
     if (world)
     {
@@ -138,7 +138,9 @@ extern LLTrace::CountStatHandle<>           FPS,
                                             FRAMETIME_DOUBLED,
                                             TEX_BAKES,
                                             TEX_REBAKES,
-                                            NUM_NEW_OBJECTS;
+                                            NUM_NEW_OBJECTS,
+                                            GROUPS_REBUILT,
+                                            SHADOW_CACHE_REBUILDS;
 
 extern LLTrace::CountStatHandle<LLUnit<F64, LLUnits::Kilotriangles> > TRIANGLES_DRAWN;
 
@@ -193,14 +195,23 @@ extern LLTrace::SampleStatHandle<>      FPS_SAMPLE,
                                         SHADER_OBJECTS,
                                         DRAW_DISTANCE,
                                         WINDOW_WIDTH,
-                                        WINDOW_HEIGHT;
+                                        WINDOW_HEIGHT,
+                                        REBUILD_QUEUE_DEPTH;
 
 extern LLTrace::SampleStatHandle<LLUnit<F32, LLUnits::Percent> > PACKETS_LOST_PERCENT;
 
-extern LLTrace::SampleStatHandle<F64Megabytes > FORMATTED_MEM;
+extern LLTrace::SampleStatHandle<F64Megabytes > FORMATTED_MEM,
+                                                MEM_IMAGES,
+                                                MEM_OBJECT_CACHE,
+                                                MEM_FRAME_ARENA;
 
 extern LLTrace::SampleStatHandle<F64Kilobytes > DELTA_BANDWIDTH,
                                                                     MAX_BANDWIDTH;
+extern LLTrace::SampleStatHandle<F64Kilobits >  THROTTLE_TOTAL,
+                                                THROTTLE_TASK,
+                                                THROTTLE_TEXTURE,
+                                                THROTTLE_ASSET,
+                                                THROTTLE_LAYERS;
 extern SimMeasurement<F64Milliseconds > SIM_FRAME_TIME,
                                                             SIM_NET_TIME,
                                                             SIM_OTHER_TIME,
@@ -222,6 +233,7 @@ extern SimMeasurement<F64Megabytes >    SIM_PHYSICS_MEM;
 
 extern LLTrace::SampleStatHandle<F64Milliseconds >  FRAMETIME_JITTER,
                                                     FRAMETIME_SLEW,
+                                                    INPUT_LATENCY,
                                                     SIM_PING;
 
 extern LLTrace::EventStatHandle<LLUnit<F64, LLUnits::Meters> > AGENT_POSITION_SNAP;
@@ -54,6 +54,8 @@ extern std::string self_av_string();
 
 // static
 S32 LLViewerTexLayerSetBuffer::sGLByteCount = 0;
+U32 LLViewerTexLayerSetBuffer::sRenderFrame = 0;
+U32 LLViewerTexLayerSetBuffer::sRendersThisFrame = 0;
 
 LLViewerTexLayerSetBuffer::LLViewerTexLayerSetBuffer(LLTexLayerSet* const owner,
                                          S32 width, S32 height) :
@@ -69,6 +71,7 @@ LLViewerTexLayerSetBuffer::LLViewerTexLayerSetBuffer(LLTexLayerSet* const owner,
     mNeedsUpdate(true),
     mNumLowresUpdates(0)
 {
+    mLastRenderTimer.start();
     mGLTexturep->setNeedsAlphaAndPickMask(false);
 
     LLViewerTexLayerSetBuffer::sGLByteCount += getSize();
@@ -131,6 +134,40 @@ void LLViewerTexLayerSetBuffer::restartUpdateTimer()
 
 // virtual
 bool LLViewerTexLayerSetBuffer::needsRender()
+{
+    return isReadyToRender() && hasRenderBudget();
+}
+
+// Dragging an appearance slider requests an update every frame. Composite at
+// most every AvatarCompositeInterval seconds per layer set, and at most
+// AvatarCompositeMaxPerFrame layer sets per frame; the request stays pending,
+// so the latest state is always the one that gets composited.
+bool LLViewerTexLayerSetBuffer::hasRenderBudget() const
+{
+    static LLCachedControl<U32> max_per_frame(gSavedSettings, "AvatarCompositeMaxPerFrame", 2);
+    static LLCachedControl<F32> min_interval(gSavedSettings, "AvatarCompositeInterval", 0.1f);
+
+    if (sRenderFrame != LLFrameTimer::getFrameCount())
+    {
+        sRenderFrame = LLFrameTimer::getFrameCount();
+        sRendersThisFrame = 0;
+    }
+
+    if (max_per_frame > 0 && sRendersThisFrame >= max_per_frame)
+    {
+        return false;
+    }
+
+    // nothing to show yet, don't make the user wait
+    if (!isInitialized())
+    {
+        return true;
+    }
+
+    return mLastRenderTimer.getElapsedTimeF32() >= min_interval;
+}
+
+bool LLViewerTexLayerSetBuffer::isReadyToRender()
 {
     llassert(mTexLayerSet->getAvatarAppearance() == gAgentAvatarp);
     if (!isAgentAvatarValid()) return false;
@@ -178,6 +215,8 @@ void LLViewerTexLayerSetBuffer::preRenderTexLayerSet()
 // virtual
 void LLViewerTexLayerSetBuffer::postRenderTexLayerSet(bool success)
 {
+    mLastRenderTimer.reset();
+    sRendersThisFrame++;
 
     LLTexLayerSetBuffer::postRenderTexLayerSet(success);
     LLViewerDynamicTexture::postRender(success);
@@ -277,7 +316,7 @@ bool LLViewerTexLayerSetBuffer::requestUpdateImmediate()
     mNeedsUpdate = true;
     bool result = false;
 
-    if (needsRender())
+    if (isReadyToRender())
     {
         preRender(false);
         result = render();
@@ -115,6 +115,8 @@ private:
 public:
     /*virtual*/ bool        needsRender();
 protected:
+    bool                    isReadyToRender();
+    bool                    hasRenderBudget() const;
     // Pass these along for tex layer rendering.
     virtual void            preRender(bool clear_depth) { preRenderTexLayerSet(); }
     virtual void            postRender(bool success) { postRenderTexLayerSet(success); }
@@ -161,6 +163,9 @@ private:
     bool                    mNeedsUpdate;                   // Whether we need to locally update our baked textures
     U32                     mNumLowresUpdates;              // Number of times we've locally updated with lowres version of our baked textures
     LLFrameTimer            mNeedsUpdateTimer;              // Tracks time since update was requested and performed.
+    LLFrameTimer            mLastRenderTimer;               // Tracks time since this layer set was last composited.
+    static U32              sRenderFrame;
+    static U32              sRendersThisFrame;
 };
 
 // <FS:Ansariel> [Legacy Bake]
@@ -39,6 +39,7 @@
 #include "llimagebmp.h"
 #include "llimagej2c.h"
 #include "llimagetga.h"
+#include "llmemtag.h"
 #include "llstl.h"
 #include "message.h"
 #include "lltimer.h"
@@ -103,6 +104,8 @@ F32 LLViewerTexture::sCurrentTime = 0.0f;
 constexpr F32 MEMORY_CHECK_WAIT_TIME = 1.0f;
 constexpr F32 MIN_VRAM_BUDGET = 768.f;
 F32 LLViewerTexture::sFreeVRAMMegabytes = MIN_VRAM_BUDGET;
+F32 LLViewerTexture::sTargetVRAMMegabytes = MIN_VRAM_BUDGET;
+bool LLViewerTexture::sInBackground = false;
 
 LLViewerTexture::EDebugTexels LLViewerTexture::sDebugTexelsMode = LLViewerTexture::DEBUG_TEXELS_OFF;
 
@@ -521,17 +524,29 @@ void LLViewerTexture::updateClass()
 
     // try to leave half a GB for everyone else, but keep at least 768MB for ourselves
     F32 target = llmax(budget - 512.f, MIN_VRAM_BUDGET);
+    sTargetVRAMMegabytes = target;
     sFreeVRAMMegabytes = llmax(target - used, 0.f);
 
     F32 over_pct = (used - target) / target;
 
+    static LLCachedControl<bool> streaming_budget(gSavedSettings, "TextureStreamingBudget", true);
+
     bool is_sys_low = isSystemMemoryLow();
     bool is_low = is_sys_low || over_pct > 0.f;
 
     static bool was_low = false;
     static bool was_sys_low = false;
 
-    if (is_low && !was_low)
+    if (streaming_budget)
+    {
+        // LLViewerTextureList::updateStreamingBudget() fits textures into the
+        // target per texture, so there's no bias to ramp up
+        is_low = false;
+        was_low = false;
+        sEvaluationTimer.reset();
+        sDesiredDiscardBias = 1.f;
+    }
+    else if (is_low && !was_low)
     {
         // slam to 1.5 bias the moment we hit low memory (discards off screen textures immediately)
         sDesiredDiscardBias = llmax(sDesiredDiscardBias, 1.5f);
@@ -539,6 +554,7 @@ void LLViewerTexture::updateClass()
         if (is_sys_low)
         { // if we're low on system memory, emergency purge off screen textures to avoid a death spiral
             LL_WARNS() << "Low system memory detected, emergency downrezzing off screen textures" << LL_ENDL;
+            LLMemTag::logUsage("low system memory");
             for (auto& image : gTextureList)
             {
                 gTextureList.updateImageDecodePriority(image, false /*will modify gTextureList otherwise!*/);
@@ -602,6 +618,7 @@ void LLViewerTexture::updateClass()
             sDesiredDiscardBias = 1.f;
         }
     }
+    sInBackground = was_backgrounded;
 
     sDesiredDiscardBias = llclamp(sDesiredDiscardBias, 1.f, 4.f);
 
@@ -1599,7 +1616,8 @@ bool LLViewerFetchedTexture::createTexture(S32 usename/*= 0*/)
         return false;
     }
 
-    bool res = mGLTexturep->createGLTexture(mRawDiscardLevel, mRawImage, usename, true, mBoostLevel);
+    const LLImageBC* compressed = (mCompressedImage.notNull() && mCompressedSource == mRawImage) ? mCompressedImage.get() : nullptr;
+    bool res = mGLTexturep->createGLTexture(mRawDiscardLevel, mRawImage, usename, true, mBoostLevel, false, nullptr, compressed);
 
     return res;
 }
@@ -1950,8 +1968,14 @@ bool LLViewerFetchedTexture::updateFetch()
         if (mRawImage.notNull()) sRawCount--;
         if (mAuxRawImage.notNull()) sAuxCount--;
         // keep in mind that fetcher still might need raw image, don't modify original
+        LLPointer<LLImageBC> compressed;
         bool finished = LLAppViewer::getTextureFetch()->getRequestFinished(getID(), fetch_discard, mRawImage, mAuxRawImage,
-                                                                           mLastHttpGetStatus);
+                                                                           compressed, mLastHttpGetStatus);
+        if (compressed.notNull() && mRawImage.notNull())
+        {
+            mCompressedImage = compressed;
+            mCompressedSource = mRawImage;
+        }
         if (mRawImage.notNull()) sRawCount++;
         if (mAuxRawImage.notNull())
         {
@@ -2758,6 +2782,9 @@ void LLViewerFetchedTexture::destroyRawImage()
         mIsRawImageValid = false;
         mRawDiscardLevel = INVALID_DISCARD_LEVEL;
     }
+
+    mCompressedImage = nullptr;
+    mCompressedSource = nullptr;
 }
 
 void LLViewerFetchedTexture::saveRawImage()
@@ -2971,6 +2998,7 @@ void LLViewerLODTexture::processTextureStats()
     updateVirtualSize();
 
     bool did_downscale = false;
+    mIdealDiscardLevel = -1;
 
     static LLCachedControl<bool> textures_fullres(gSavedSettings,"TextureLoadFullRes", false);
 
@@ -3045,6 +3073,14 @@ void LLViewerLODTexture::processTextureStats()
 
         // Can't go higher than the max discard level
         mDesiredDiscardLevel = llmin(getMaxDiscardLevel() + 1, (S32)discard_level);
+
+        // Give up detail the streaming budget can't fit
+        if (mBoostLevel < LLGLTexture::BOOST_HIGH && !mKnownDrawWidth)
+        {
+            mIdealDiscardLevel = llmin(mMinDesiredDiscardLevel, mDesiredDiscardLevel);
+            mDesiredDiscardLevel = llmax(mDesiredDiscardLevel, mBudgetDiscardLevel);
+        }
+
         // Clamp to min desired discard
         mDesiredDiscardLevel = llmin(mMinDesiredDiscardLevel, mDesiredDiscardLevel);
 
@@ -235,6 +235,10 @@ public:
 
     // estimated free memory for textures, by bias calculation
     static F32 sFreeVRAMMegabytes;
+    // video memory the viewer tries to stay under, in the same units as sFreeVRAMMegabytes
+    static F32 sTargetVRAMMegabytes;
+    // the window has been in the background long enough to free up video memory
+    static bool sInBackground;
 
     enum EDebugTexels
     {
@@ -441,6 +445,11 @@ public:
     bool mCreatePending = false;    // if true, this is in gTextureList.mCreateTextureList
     mutable bool mDownScalePending = false; // if true, this is in gTextureList.mDownScaleQueue
 
+    // Streaming budget, see LLViewerTextureList::updateStreamingBudget()
+    F32 mStreamingVirtualSize = 0.f;    // on screen virtual size from the last decode priority update
+    S8  mIdealDiscardLevel = -1;        // desired discard level before the budget, -1 if not budgeted
+    S8  mBudgetDiscardLevel = 0;        // lowest discard level the budget can fit, 0 if unconstrained
+
     // <FS:Techwolf Lupindo> texture comment decoder
     std::map<std::string,std::string> mComment;
     // </FS:Techwolf Lupindo>
@@ -505,6 +514,11 @@ protected:
     LLPointer<LLImageRaw> mRawImage;
     S32 mRawDiscardLevel = -1;
 
+    // block compressed copy of mCompressedSource from the fetcher, uploaded
+    // in place of mRawImage while mRawImage still is that same image
+    LLPointer<LLImageBC> mCompressedImage;
+    LLPointer<LLImageRaw> mCompressedSource;
+
     // Used ONLY for cloth meshes right now.  Make SURE you know what you're
     // doing if you use it for anything else! - djs
     LLPointer<LLImageRaw> mAuxRawImage;
@@ -71,7 +71,10 @@ void LLViewerTextureAnim::updateClass()
 {
     for (std::vector<LLViewerTextureAnim*>::iterator iter = sInstanceList.begin(); iter != sInstanceList.end(); ++iter)
     {
-        (*iter)->mVObj->animateTextures();
+        if ((*iter)->mVObj->isIdleUpdateDue())
+        {
+            (*iter)->mVObj->animateTextures();
+        }
     }
 }
 
@@ -61,6 +61,8 @@
 #include "llviewerdisplay.h"
 #include "llviewerwindow.h"
 #include "llprogressview.h"
+#include "llregionprefetch.h"
+#include "llviewerthrottle.h"
 
 ////////////////////////////////////////////////////////////////////////////
 
@@ -663,6 +665,11 @@ LLViewerFetchedTexture* LLViewerTextureList::createImage(const LLUUID &image_id,
         //here turn this off
         //if this texture should be set to NO_DELETE, call setNoDelete() afterwards.
         imagep->forceActive() ;
+
+        if (f_type == FTT_DEFAULT && request_from_host.isInvalid())
+        {
+            LLRegionPrefetch::instance().noteTexture(image_id);
+        }
     }
 
     // <FS:Ansariel> Keep Fast Cache option
@@ -838,6 +845,9 @@ void LLViewerTextureList::updateImages(F32 max_time)
         sample(FORMATTED_MEM, F64Bytes(LLImageFormatted::sGlobalFormattedMemory));
     }
 
+    // fit desired discard levels into video memory before fetching
+    updateStreamingBudget();
+
     // make sure each call below gets at least its "fair share" of time
     F32 min_time = max_time * 0.33f;
     F32 remaining_time = max_time;
@@ -901,9 +911,11 @@ void LLViewerTextureList::updateImageDecodePriority(LLViewerFetchedTexture* imag
     static LLCachedControl<F32> bias_distance_scale(gSavedSettings, "TextureBiasDistanceScale", 1.f);
     static LLCachedControl<F32> texture_scale_min(gSavedSettings, "TextureScaleMinAreaFactor", 0.04f);
     static LLCachedControl<F32> texture_scale_max(gSavedSettings, "TextureScaleMaxAreaFactor", 25.f);
+    static LLCachedControl<bool> streaming_budget(gSavedSettings, "TextureStreamingBudget", true);
 
 
     F32 max_vsize = 0.f;
+    F32 streaming_vsize = 0.f;
     bool on_screen = false;
 
     LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
@@ -944,6 +956,15 @@ void LLViewerTextureList::updateImageDecodePriority(LLViewerFetchedTexture* imag
                 { // further reduce by discard bias when off screen or occluded
                     apply_bias = true;
                 }
+                else
+                {
+                    streaming_vsize = llmax(streaming_vsize, vsize);
+                }
+
+                if (streaming_budget)
+                { // the streaming budget ranks off screen and unimportant faces by streaming_vsize instead
+                    apply_bias = false;
+                }
 
                 if (apply_bias)
                 {
@@ -957,6 +978,8 @@ void LLViewerTextureList::updateImageDecodePriority(LLViewerFetchedTexture* imag
         }
     }
 
+    imagep->mStreamingVirtualSize = streaming_vsize;
+
     if (imagep->getType() == LLViewerTexture::LOD_TEXTURE && imagep->getBoostLevel() == LLViewerTexture::BOOST_NONE)
     { // conditionally reset max virtual size for unboosted LOD_TEXTURES
       // this is an alternative to decaying mMaxVirtualSize over time
@@ -1229,6 +1252,190 @@ void LLViewerTextureList::updateImagesUpdateStats()
     }
 }
 
+namespace
+{
+    // Estimated bytes of a texture at a discard level, counted the same way
+    // LLImageGL::getTextureBytesAllocated() counts them (no mips)
+    F64 texture_bytes_at_discard(const LLViewerFetchedTexture* imagep, S32 discard)
+    {
+        F64 width = llmax(imagep->getFullWidth() >> discard, 1);
+        F64 height = llmax(imagep->getFullHeight() >> discard, 1);
+        return width * height * llmax((S32)imagep->getComponents(), 1);
+    }
+
+    // A texture the streaming budget can coarsen, and what it costs
+    struct StreamingCandidate
+    {
+        LLViewerFetchedTexture* mImage;
+        S32 mLevel;             // discard level assigned so far
+        S32 mMaxLevel;          // coarsest level it may be given
+        F32 mTexelScale;        // screen pixels per texel along one axis at discard 0
+        F32 mLinearSize;        // square root of the on screen virtual size
+
+        // Screen-space error at a discard level: how many pixels each texel
+        // is blown up past 1:1, scaled by how big the texture is on screen
+        F32 screenSpaceError(S32 level) const
+        {
+            return mLinearSize * llmax(mTexelScale * (F32)(1 << level) - 1.f, 0.f);
+        }
+    };
+
+    // Cost of dropping a candidate one more discard level, cheapest first
+    struct StreamingStep
+    {
+        F32 mErrorPerByte;
+        F64 mBytesSaved;
+        U32 mCandidate;
+
+        bool operator<(const StreamingStep& rhs) const
+        { // std::priority_queue keeps the largest on top, so reverse the order
+            if (mErrorPerByte != rhs.mErrorPerByte)
+            {
+                return mErrorPerByte > rhs.mErrorPerByte;
+            }
+            return mBytesSaved < rhs.mBytesSaved;
+        }
+    };
+
+    StreamingStep make_streaming_step(const StreamingCandidate& candidate, U32 index)
+    {
+        StreamingStep step;
+        step.mCandidate = index;
+        step.mBytesSaved = texture_bytes_at_discard(candidate.mImage, candidate.mLevel)
+            - texture_bytes_at_discard(candidate.mImage, candidate.mLevel + 1);
+        F32 error = candidate.screenSpaceError(candidate.mLevel + 1) - candidate.screenSpaceError(candidate.mLevel);
+        step.mErrorPerByte = error / (F32)llmax(step.mBytesSaved, 1.0);
+        return step;
+    }
+}
+
+void LLViewerTextureList::updateStreamingBudget()
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
+
+    static LLCachedControl<bool> streaming_budget(gSavedSettings, "TextureStreamingBudget", true);
+    if (!streaming_budget)
+    {
+        if (mStreamingBudgetStats.mActive)
+        { // hand control back to the discard bias
+            for (LLViewerFetchedTexture* imagep : mImageList)
+            {
+                imagep->mBudgetDiscardLevel = 0;
+            }
+            mStreamingBudgetStats = StreamingBudgetStats();
+        }
+        return;
+    }
+
+    constexpr F32 STREAMING_BUDGET_INTERVAL = 0.5f;
+    if (mStreamingBudgetStats.mActive && mStreamingBudgetTimer.getElapsedTimeF32() < STREAMING_BUDGET_INTERVAL)
+    {
+        return;
+    }
+    mStreamingBudgetTimer.reset();
+
+    // Same units as LLViewerTexture::updateClass(), which count each byte
+    // twice to make up for the video memory our metrics miss
+    constexpr F64 BYTES_PER_UNIT = 512.0 * 1024.0;
+    F64 other_units = (LLVertexBuffer::getBytesAllocated() + LLRenderTarget::sBytesAllocated) / BYTES_PER_UNIT;
+    F64 budget = llmax((F64)LLViewerTexture::sTargetVRAMMegabytes - other_units, 0.0) * BYTES_PER_UNIT;
+
+    if (LLViewerTexture::sInBackground)
+    { // free up everything we can while nobody is looking
+        budget = 0.0;
+    }
+    else if (LLViewerTexture::isSystemMemoryLow())
+    { // textures in video memory have a copy in system memory too, so shrink below what we have now
+        budget = llmin(budget, mStreamingBudgetStats.mAssignedBytes * 0.9);
+    }
+
+    std::vector<StreamingCandidate> candidates;
+    candidates.reserve(mImageList.size());
+
+    F64 reserved = 0.0;
+    F64 desired = 0.0;
+    for (LLViewerFetchedTexture* imagep : mImageList)
+    {
+        S32 ideal = imagep->mIdealDiscardLevel;
+        if (ideal < 0 || !imagep->getFullWidth() || !imagep->getFullHeight())
+        { // not budgeted, count what it has now
+            if (imagep->getDiscardLevel() >= 0)
+            {
+                reserved += texture_bytes_at_discard(imagep, imagep->getDiscardLevel());
+            }
+            continue;
+        }
+
+        S32 max_level = imagep->getMaxDiscardLevel();
+        if (ideal > max_level)
+        { // not wanted at all
+            imagep->mBudgetDiscardLevel = 0;
+            continue;
+        }
+
+        StreamingCandidate candidate;
+        candidate.mImage = imagep;
+        candidate.mLevel = ideal;
+        candidate.mMaxLevel = max_level;
+        candidate.mTexelScale = sqrtf(imagep->mStreamingVirtualSize / (F32)(imagep->getFullWidth() * imagep->getFullHeight()));
+        candidate.mLinearSize = sqrtf(imagep->mStreamingVirtualSize);
+        candidates.push_back(candidate);
+
+        desired += texture_bytes_at_discard(imagep, ideal);
+    }
+
+    // Drop detail where it costs the least screen-space error per byte until everything fits
+    F64 total = reserved + desired;
+    if (total > budget)
+    {
+        std::priority_queue<StreamingStep> steps;
+        for (U32 i = 0; i < candidates.size(); ++i)
+        {
+            if (candidates[i].mLevel < candidates[i].mMaxLevel)
+            {
+                steps.push(make_streaming_step(candidates[i], i));
+            }
+        }
+
+        while (total > budget && !steps.empty())
+        {
+            StreamingStep step = steps.top();
+            steps.pop();
+
+            StreamingCandidate& candidate = candidates[step.mCandidate];
+            candidate.mLevel++;
+            total -= step.mBytesSaved;
+
+            if (candidate.mLevel < candidate.mMaxLevel)
+            {
+                steps.push(make_streaming_step(candidate, step.mCandidate));
+            }
+        }
+    }
+
+    U32 reduced = 0;
+    for (const StreamingCandidate& candidate : candidates)
+    {
+        S32 ideal = candidate.mImage->mIdealDiscardLevel;
+        if (candidate.mLevel > ideal)
+        {
+            candidate.mImage->mBudgetDiscardLevel = (S8)candidate.mLevel;
+            ++reduced;
+        }
+        else
+        {
+            candidate.mImage->mBudgetDiscardLevel = 0;
+        }
+    }
+
+    mStreamingBudgetStats.mActive = true;
+    mStreamingBudgetStats.mBudgetBytes = budget;
+    mStreamingBudgetStats.mDesiredBytes = reserved + desired;
+    mStreamingBudgetStats.mAssignedBytes = total;
+    mStreamingBudgetStats.mNumBudgeted = (U32)candidates.size();
+    mStreamingBudgetStats.mNumReduced = reduced;
+}
+
 void LLViewerTextureList::decodeAllImages(F32 max_time)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
@@ -1459,7 +1666,20 @@ LLPointer<LLImageJ2C> LLViewerTextureList::convertToUploadFile(LLPointer<LLImage
         compressedImage->initEncode(*raw_image, block_size, precinct_size, 0);
     }
 
-    if (!compressedImage->encode(raw_image, 0.0f))
+    // Uploads may be encoded on several threads at once, see LLNewFileResourceUploadInfo::startPrepare().
+    // A large image alone gets the configured codec threads, concurrent encodes share them.
+    static LLAtomicS32 encodes_in_flight(0);
+    S32 concurrent = ++encodes_in_flight;
+    static const S32 MIN_CODEC_THREAD_PIXELS = 1024 * 1024;
+    if (raw_image->getWidth() * raw_image->getHeight() >= MIN_CODEC_THREAD_PIXELS)
+    {
+        S32 threads = (S32)gSavedSettings.getU32("ImageEncodeCodecThreads");
+        compressedImage->setCodecThreads(llmax(threads / concurrent, 1));
+    }
+
+    bool encoded = compressedImage->encode(raw_image, 0.0f);
+    --encodes_in_flight;
+    if (!encoded)
     {
         LL_INFOS() << "convertToUploadFile : encode returns with error!!" << LL_ENDL;
         // Clear up the pointer so we don't leak that one
@@ -1498,6 +1718,7 @@ void LLViewerTextureList::receiveImageHeader(LLMessageSystem *msg, void **user_d
     }
     add(LLStatViewer::TEXTURE_NETWORK_DATA_RECEIVED, received_size);
     add(LLStatViewer::TEXTURE_PACKETS, 1);
+    gViewerThrottle.addReceived(TC_TEXTURE, (F32)F32Bits(received_size).value());
 
     U8 codec;
     U16 packets;
@@ -1571,6 +1792,7 @@ void LLViewerTextureList::receiveImagePacket(LLMessageSystem *msg, void **user_d
     }
 
     add(LLStatViewer::TEXTURE_NETWORK_DATA_RECEIVED, F64Bytes(received_size));
+    gViewerThrottle.addReceived(TC_TEXTURE, (F32)F32Bits(received_size).value());
     add(LLStatViewer::TEXTURE_PACKETS, 1);
 
     //llprintline("Start decode, image header...");
@@ -1651,6 +1873,41 @@ void LLUIImageList::cleanUp()
 {
     mUIImages.clear();
     mUITextureList.clear() ;
+    mAtlas.clear();
+}
+
+void LLUIImageList::addToAtlas(LLUIImage* imagep, LLViewerFetchedTexture* texturep)
+{
+    static LLCachedControl<U32> max_size(gSavedSettings, "UIAtlasMaxImageSize", 128);
+
+    // the original image sits in the bottom left of the power of 2 texture
+    S32 width = texturep->getOriginalWidth();
+    S32 height = texturep->getOriginalHeight();
+    LLImageGL* image_gl = texturep->getGLTexture();
+    if (width <= 0 || height <= 0 || width > (S32)max_size || height > (S32)max_size
+        || !image_gl || !image_gl->getHasGLTexture() || image_gl->getUseMipMaps()
+        || image_gl->getComponents() < 3)
+    {
+        return;
+    }
+
+    LLPointer<LLImageRaw> raw = new LLImageRaw;
+    if (!image_gl->readBackRaw(0, raw, false))
+    {
+        return;
+    }
+
+    LLRectf uv_rect;
+    LLGLTexture* page = mAtlas.insert(raw, width, height, uv_rect);
+    if (page)
+    {
+        // the clip region refers to the whole power of 2 texture
+        F32 scale_x = (F32)texturep->getFullWidth() / (F32)width;
+        F32 scale_y = (F32)texturep->getFullHeight() / (F32)height;
+        uv_rect.setLeftTopAndSize(uv_rect.mLeft, uv_rect.mBottom + uv_rect.getHeight() * scale_y,
+                                  uv_rect.getWidth() * scale_x, uv_rect.getHeight() * scale_y);
+        imagep->setAtlasRegion(page, uv_rect);
+    }
 }
 
 LLUIImagePtr LLUIImageList::getUIImageByID(const LLUUID& image_id, S32 priority)
@@ -1821,6 +2078,13 @@ void LLUIImageList::onUIImageLoaded( bool success, LLViewerFetchedTexture *src_v
                         llclamp((F32)scale_rect.mBottom / (F32)imagep->getHeight(), 0.f, 1.f)));
             }
 
+            // only the original image is copied to the atlas, the clip rect can't reach past it
+            if (final && (clip_rect == LLRect::null
+                          || (clip_rect.mRight <= src_vi->getOriginalWidth() && clip_rect.mTop <= src_vi->getOriginalHeight())))
+            {
+                instance->addToAtlas(imagep, src_vi);
+            }
+
             imagep->onImageLoaded();
         }
     }
@@ -35,6 +35,7 @@
 #include <list>
 #include <unordered_set>
 #include "lluiimage.h"
+#include "lltextureatlas.h"
 
 const U32 LL_IMAGE_REZ_LOSSLESS_CUTOFF = 128;
 
@@ -151,7 +152,25 @@ public:
     // - cleans up textures that haven't been referenced in awhile
     void updateImageDecodePriority(LLViewerFetchedTexture* imagep, bool flush_images = true);
 
+    // Outcome of the last streaming budget pass, for the texture console
+    struct StreamingBudgetStats
+    {
+        bool mActive = false;
+        F64 mBudgetBytes = 0.0;     // what textures may use
+        F64 mDesiredBytes = 0.0;    // what they would use at their ideal discard levels
+        F64 mAssignedBytes = 0.0;   // what they use at the levels the budget assigned
+        U32 mNumBudgeted = 0;
+        U32 mNumReduced = 0;        // textures held above their ideal discard level
+    };
+    const StreamingBudgetStats& getStreamingBudgetStats() const { return mStreamingBudgetStats; }
+
 private:
+    // Assign each texture the discard level it can have within the video
+    // memory target. Textures start at the level their texel density asks
+    // for, then the ones where a coarser mip adds the least screen-space
+    // error per byte saved are dropped first until everything fits.
+    void updateStreamingBudget();
+
     F32  updateImagesCreateTextures(F32 max_time);
     F32  updateImagesFetchTextures(F32 max_time);
     void updateImagesUpdateStats();
@@ -248,6 +267,9 @@ private:
     bool mInitialized ;
     LLFrameTimer mForceDecodeTimer;
 
+    LLFrameTimer mStreamingBudgetTimer;
+    StreamingBudgetStats mStreamingBudgetStats;
+
 private:
     static S32 sNumImages;
     static void (*sUUIDCallback)(void**, const LLUUID &);
@@ -282,6 +304,9 @@ private:
 
     LLPointer<LLUIImage> loadUIImage(LLViewerFetchedTexture* imagep, const std::string& name, bool use_mips = false, const LLRect& scale_rect = LLRect::null, const LLRect& clip_rect = LLRect::null, LLUIImage::EScaleStyle = LLUIImage::SCALE_INNER);
 
+    // Copy a small, fully loaded skin image into mAtlas and draw it from there
+    void addToAtlas(LLUIImage* imagep, LLViewerFetchedTexture* texturep);
+
 
     struct LLUIImageLoadData
     {
@@ -297,6 +322,9 @@ private:
     //keep a copy of UI textures to prevent them to be deleted.
     //mGLTexturep of each UI texture equals to some LLUIImage.mImage.
     std::list< LLPointer<LLViewerFetchedTexture> > mUITextureList ;
+
+    // small skin images, so that runs of buttons and icons don't flush a batch per image
+    LLTextureAtlas mAtlas{ 1024 };
 };
 
 const bool GLTEXTURE_TRUE = true;
@@ -33,6 +33,7 @@
 #include "llframetimer.h"
 #include "llviewerstats.h"
 #include "lldatapacker.h"
+#include "llviewerregion.h"
 
 using namespace LLOldEvents;
 
@@ -52,6 +53,24 @@ const LLUnit<F32, LLUnits::Percent> TIGHTEN_THROTTLE_THRESHOLD(3.0f); // packet
 const LLUnit<F32, LLUnits::Percent> EASE_THROTTLE_THRESHOLD(0.5f); // packet loss % per s
 const F32 DYNAMIC_UPDATE_DURATION = 5.0f; // seconds
 
+// Adaptive control (ThrottleAdaptive).  A round trip well above the best one seen
+// on the circuit means packets queue somewhere on the link, which tightens the
+// throttle like packet loss does before any packet is actually dropped.
+const F32 TIGHTEN_PING_FACTOR = 2.0f;
+const F32 TIGHTEN_PING_SLACK = 100.f;   // ms
+const F32 EASE_PING_FACTOR = 1.3f;
+const F32 EASE_PING_SLACK = 30.f;       // ms
+
+// A category receiving close to its share has data queued on the simulator,
+// one receiving little of it is lending bandwidth to nobody
+const F32 SPLIT_SATURATED = 0.8f;
+const F32 SPLIT_IDLE = 0.3f;
+const F32 SPLIT_GROW = 1.25f;
+const F32 SPLIT_SHRINK = 0.85f;
+const F32 SPLIT_MIN_WEIGHT = 0.25f;
+const F32 SPLIT_MAX_WEIGHT = 4.f;
+const F32 SPLIT_RESEND_CHANGE = 0.1f;   // relative change of a category worth a new AgentThrottle
+
 LLViewerThrottle gViewerThrottle;
 
 // static
@@ -197,8 +216,15 @@ public:
 LLViewerThrottle::LLViewerThrottle() :
     mMaxBandwidth(0.f),
     mCurrentBandwidth(0.f),
-    mThrottleFrac(1.f)
+    mThrottleFrac(1.f),
+    mMinPing(0.f)
 {
+    for (S32 i = 0; i < TC_EOF; i++)
+    {
+        mReceivedBits[i] = 0.f;
+        mSplitWeights[i] = 1.f;
+    }
+
     // Need to be pushed on in bandwidth order
     mPresets.push_back(LLViewerThrottleGroup(BW_PRESET_50));
     mPresets.push_back(LLViewerThrottleGroup(BW_PRESET_300));
@@ -294,41 +320,128 @@ void LLViewerThrottle::resetDynamicThrottle()
 
     mCurrentBandwidth = mMaxBandwidth*MAX_FRACTIONAL;
     mCurrent = getThrottleGroup(mCurrentBandwidth / 1024.0f);
+
+    for (S32 i = 0; i < TC_EOF; i++)
+    {
+        mReceivedBits[i] = 0.f;
+        mSplitWeights[i] = 1.f;
+    }
+    mPingHost.invalidate();
 }
 
 void LLViewerThrottle::updateDynamicThrottle()
 {
-    if (mUpdateTimer.getElapsedTimeF32() < DYNAMIC_UPDATE_DURATION)
+    F32 elapsed = mUpdateTimer.getElapsedTimeF32();
+    if (elapsed < DYNAMIC_UPDATE_DURATION)
     {
         return;
     }
     mUpdateTimer.reset();
 
+    static LLCachedControl<bool> adaptive(gSavedSettings, "ThrottleAdaptive", true);
+
     LLUnit<F32, LLUnits::Percent> mean_packets_lost = LLViewerStats::instance().getRecording().getMean(LLStatViewer::PACKETS_LOST_PERCENT);
-    if (mean_packets_lost > TIGHTEN_THROTTLE_THRESHOLD)
+    bool tighten = mean_packets_lost > TIGHTEN_THROTTLE_THRESHOLD;
+    bool ease = mean_packets_lost <= EASE_THROTTLE_THRESHOLD;
+
+    LLCircuitData* cdp = gAgent.getRegion() ? gMessageSystem->mCircuitInfo.findCircuit(gAgent.getRegion()->getHost()) : NULL;
+    if (adaptive && cdp)
     {
-        if (mThrottleFrac <= MIN_FRACTIONAL || mCurrentBandwidth / 1024.0f <= MIN_BANDWIDTH)
+        F32 ping = cdp->getPingDelayAveraged().value();
+        if (mPingHost != cdp->getHost() || ping < mMinPing)
         {
-            return;
+            mPingHost = cdp->getHost();
+            mMinPing = ping;
+        }
+        tighten = tighten || ping > mMinPing * TIGHTEN_PING_FACTOR + TIGHTEN_PING_SLACK;
+        ease = ease && ping <= mMinPing * EASE_PING_FACTOR + EASE_PING_SLACK;
+    }
+
+    F32 throttle_frac = mThrottleFrac;
+    if (tighten)
+    {
+        if (mThrottleFrac > MIN_FRACTIONAL && mCurrentBandwidth / 1024.0f > MIN_BANDWIDTH)
+        {
+            throttle_frac = llmax(MIN_FRACTIONAL, mThrottleFrac - STEP_FRACTIONAL);
+        }
+    }
+    else if (ease)
+    {
+        if (mThrottleFrac < MAX_FRACTIONAL && mCurrentBandwidth / 1024.0f < MAX_BANDWIDTH)
+        {
+            throttle_frac = llmin(MAX_FRACTIONAL, mThrottleFrac + STEP_FRACTIONAL);
         }
-        mThrottleFrac -= STEP_FRACTIONAL;
-        mThrottleFrac = llmax(MIN_FRACTIONAL, mThrottleFrac);
-        mCurrentBandwidth = mMaxBandwidth * mThrottleFrac;
-        mCurrent = getThrottleGroup(mCurrentBandwidth / 1024.0f);
-        mCurrent.sendToSim();
-        LL_INFOS() << "Tightening network throttle to " << mCurrentBandwidth << LL_ENDL;
     }
-    else if (mean_packets_lost <= EASE_THROTTLE_THRESHOLD)
+
+    bool total_changed = throttle_frac != mThrottleFrac;
+    mThrottleFrac = throttle_frac;
+    mCurrentBandwidth = mMaxBandwidth * mThrottleFrac;
+    LLViewerThrottleGroup group = getThrottleGroup(mCurrentBandwidth / 1024.0f);
+
+    bool split_changed = false;
+    if (adaptive)
     {
-        if (mThrottleFrac >= MAX_FRACTIONAL || mCurrentBandwidth / 1024.0f >= MAX_BANDWIDTH)
+        updateSplitWeights(elapsed);
+        group = applySplitWeights(group);
+        for (S32 i = 0; i < TC_EOF; i++)
         {
-            return;
+            if (fabsf(group.mThrottles[i] - mCurrent.mThrottles[i]) > SPLIT_RESEND_CHANGE * llmax(mCurrent.mThrottles[i], 1.f))
+            {
+                split_changed = true;
+            }
         }
-        mThrottleFrac += STEP_FRACTIONAL;
-        mThrottleFrac = llmin(MAX_FRACTIONAL, mThrottleFrac);
-        mCurrentBandwidth = mMaxBandwidth * mThrottleFrac;
-        mCurrent = getThrottleGroup(mCurrentBandwidth/1024.0f);
+    }
+    for (S32 i = 0; i < TC_EOF; i++)
+    {
+        mReceivedBits[i] = 0.f;
+    }
+
+    if (total_changed || split_changed)
+    {
+        mCurrent = group;
         mCurrent.sendToSim();
-        LL_INFOS() << "Easing network throttle to " << mCurrentBandwidth << LL_ENDL;
+        if (total_changed)
+        {
+            LL_INFOS() << (tighten ? "Tightening" : "Easing") << " network throttle to " << mCurrentBandwidth << LL_ENDL;
+        }
+        mCurrent.dump();
+    }
+}
+
+void LLViewerThrottle::updateSplitWeights(F32 elapsed)
+{
+    for (S32 i = 0; i < TC_EOF; i++)
+    {
+        F32 share = mCurrent.mThrottles[i];
+        if (i == TC_RESEND || share <= 0.f)
+        {
+            continue; // resends aren't measured, they keep their preset share
+        }
+
+        F32 used = mReceivedBits[i] / 1024.f / elapsed / share;
+        if (used > SPLIT_SATURATED)
+        {
+            mSplitWeights[i] = llmin(mSplitWeights[i] * SPLIT_GROW, SPLIT_MAX_WEIGHT);
+        }
+        else if (used < SPLIT_IDLE)
+        {
+            mSplitWeights[i] = llmax(mSplitWeights[i] * SPLIT_SHRINK, SPLIT_MIN_WEIGHT);
+        }
+    }
+}
+
+LLViewerThrottleGroup LLViewerThrottle::applySplitWeights(const LLViewerThrottleGroup& group) const
+{
+    // moves bandwidth between categories, the total stays what packet loss and ping allow
+    LLViewerThrottleGroup weighted;
+    for (S32 i = 0; i < TC_EOF; i++)
+    {
+        weighted.mThrottles[i] = group.mThrottles[i] * mSplitWeights[i];
+        weighted.mThrottleTotal += weighted.mThrottles[i];
+    }
+    if (weighted.mThrottleTotal <= 0.f)
+    {
+        return group;
     }
+    return weighted * (group.mThrottleTotal / weighted.mThrottleTotal);
 }
@@ -31,6 +31,7 @@
 
 #include "llstring.h"
 #include "llframetimer.h"
+#include "llhost.h"
 #include "llthrottle.h"
 
 class LLViewerThrottleGroup
@@ -72,8 +73,19 @@ public:
 
     LLViewerThrottleGroup getThrottleGroup(const F32 bandwidth_kbps);
 
+    // UDP data received in a throttle category, measured against its share by the
+    // adaptive split (ThrottleAdaptive)
+    void addReceived(S32 category, F32 bits)    { mReceivedBits[category] += bits; }
+
+    // Share of a category last sent to the simulator, in kbps
+    F32 getThrottle(S32 category) const         { return mCurrent.mThrottles[category]; }
+
     static const std::string sNames[TC_EOF];
 protected:
+    // Grows the weight of categories using up their share and shrinks idle ones
+    void updateSplitWeights(F32 elapsed);
+    LLViewerThrottleGroup applySplitWeights(const LLViewerThrottleGroup& group) const;
+
     F32 mMaxBandwidth;
     F32 mCurrentBandwidth;
 
@@ -83,6 +95,11 @@ protected:
 
     LLFrameTimer mUpdateTimer;
     F32 mThrottleFrac;
+
+    F32 mReceivedBits[TC_EOF];  // since the last update
+    F32 mSplitWeights[TC_EOF];  // multipliers of the preset split, renormalized to its total
+    LLHost mPingHost;           // circuit mMinPing was measured on
+    F32 mMinPing;               // lowest averaged ping in ms, the uncongested round trip
 };
 
 extern LLViewerThrottle gViewerThrottle;
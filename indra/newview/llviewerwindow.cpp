@@ -109,6 +109,10 @@
 #include "llfeaturemanager.h"
 #include "llfilepicker.h"
 #include "llfirstuse.h"
+#include "llflightrecorder.h"
+#include "llframepacer.h"
+#include "llavatargputimer.h"
+#include "llgpupasstimer.h"
 #include "llfloater.h"
 #include "llfloaterbuyland.h"
 #include "llfloatercamera.h"
@@ -742,6 +746,11 @@ public:
             LLRender::sUICalls = LLRender::sUIVerts = 0;
             ypos += y_inc;
 
+            // views searched are what getChild<>() in draw() and refresh() costs, cached lookups are cheap
+            addText(xpos, ypos, llformat("UI Child Lookups Cached/Views Searched: %d/%d", LLView::sChildLookupHits, LLView::sChildLookupSearches));
+            LLView::sChildLookupHits = LLView::sChildLookupSearches = 0;
+            ypos += y_inc;
+
             addText(xpos,ypos, llformat("%d/%d Nodes visible", gPipeline.mNumVisibleNodes, LLSpatialGroup::sNodeCount));
 
             ypos += y_inc;
@@ -834,6 +843,26 @@ public:
             }
         }
 
+        static LLCachedControl<bool> debugShowGPUPasses(gSavedSettings, "DebugShowGPUPasses");
+        if (debugShowGPUPasses)
+        {
+            // lines go up the screen, so the last pass comes first
+            const std::vector<LLGPUPassTimer::Pass>& passes = LLGPUPassTimer::getPasses();
+            F32 total_ms = 0.f;
+            for (auto it = passes.rbegin(); it != passes.rend(); ++it)
+            {
+                addText(xpos + it->mDepth * 10, ypos, llformat("%s: %.2f ms", it->mName, it->mMs));
+                ypos += y_inc;
+                if (it->mDepth == 0)
+                {
+                    total_ms += it->mMs;
+                }
+            }
+            addText(xpos, ypos, passes.empty() ? std::string("GPU passes: waiting for timer queries")
+                                               : llformat("GPU passes: %.2f ms", total_ms));
+            ypos += y_inc;
+        }
+
         //if (gSavedSettings.getBOOL("DebugShowRenderMatrices"))
         static LLCachedControl<bool> debugShowRenderMatrices(gSavedSettings, "DebugShowRenderMatrices");
         if (debugShowRenderMatrices)
@@ -2061,6 +2090,9 @@ LLViewerWindow::LLViewerWindow(const Params& p)
     LL_DEBUGS("Window") << "Loading feature tables." << LL_ENDL;
 
     // Initialize OpenGL Renderer
+    LLVertexBuffer::sUseArena = gSavedSettings.getBOOL("RenderVBOArena");
+    LLVertexBuffer::sArenaBlockSize = llclamp(gSavedSettings.getU32("RenderVBOArenaBlockSize"), 4U, 256U) * 1024 * 1024;
+    LLVertexBuffer::sPackAttributes = gSavedSettings.getBOOL("RenderPackedVertexAttributes");
     LLVertexBuffer::initClass(mWindow);
     LL_INFOS("RenderInit") << "LLVertexBuffer initialization done." << LL_ENDL ;
     if (!gGL.init(true))
@@ -2116,6 +2148,7 @@ LLViewerWindow::LLViewerWindow(const Params& p)
 
     // Init the image list.  Must happen after GL is initialized and before the images that
     // LLViewerWindow needs are requested, as well as before LLViewerMedia starts updating images.
+    LLImageGLThread::sUploadRingMB = gSavedSettings.getU32("RenderGLUploadRingMB");
     LLImageGL::initClass(mWindow, LLViewerTexture::MAX_GL_IMAGE_CATEGORY, false, gSavedSettings.getBOOL("RenderGLMultiThreadedTextures"), gSavedSettings.getBOOL("RenderGLMultiThreadedMedia"));
     gTextureList.init();
     LLViewerTextureManager::init() ;
@@ -3140,6 +3173,14 @@ void LLViewerWindow::draw()
             stop_glerror();
         }
 
+        // Gather the quads of all views into few draw calls
+        static LLCachedControl<bool> render_ui_batching(gSavedSettings, "RenderUIBatching", true);
+        const bool ui_batching = render_ui_batching;
+        if (ui_batching)
+        {
+            gGL.beginUIBatch();
+        }
+
         // Draw all nested UI views.
         // No translation needed, this view is glued to 0,0
         mRootView->draw();
@@ -3163,6 +3204,11 @@ void LLViewerWindow::draw()
             LLUI::popMatrix();
         }
 
+        if (ui_batching)
+        {
+            gGL.endUIBatch();
+        }
+
 
         if( gShowOverlayTitle && !mOverlayTitle.empty() )
         {
@@ -6053,6 +6099,102 @@ bool LLViewerWindow::thumbnailSnapshot(LLImageRaw *raw, S32 preview_width, S32 p
     return rawSnapshot(raw, preview_width, preview_height, false, false, show_ui, show_hud, do_rebuild, no_post, type);
 }
 
+// Reads back snapshot tiles through two pixel pack buffers.  glReadPixels into a buffer
+// returns right away, so the transfer of one tile overlaps the rendering of the next and
+// the copy into the image only waits for a tile that was started a whole tile earlier.
+class LLSnapshotTileReader
+{
+public:
+    ~LLSnapshotTileReader()
+    {
+        finish();
+        for (Tile& tile : mTiles)
+        {
+            if (tile.mBuffer)
+            {
+                glDeleteBuffers(1, &tile.mBuffer);
+            }
+        }
+    }
+
+    // Start reading RGB pixels from the bound framebuffer, to be copied to dst with
+    // dst_stride bytes between rows once the GPU got to them
+    void read(S32 x, S32 y, S32 width, S32 height, U8* dst, S32 dst_stride)
+    {
+        Tile& tile = mTiles[mNext];
+        mNext = (mNext + 1) % 2;
+        copy(tile);
+
+        // rows of the buffer keep GL's default 4 byte pack alignment
+        tile.mPitch = (width * 3 + 3) & ~3;
+        U32 size = tile.mPitch * height;
+        if (!tile.mBuffer)
+        {
+            glGenBuffers(1, &tile.mBuffer);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, tile.mBuffer);
+        if (size > tile.mSize)
+        {
+            glBufferData(GL_PIXEL_PACK_BUFFER, size, NULL, GL_STREAM_READ);
+            tile.mSize = size;
+        }
+        glReadPixels(x, y, width, height, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        tile.mFence.placeFence();
+
+        tile.mWidth = width;
+        tile.mHeight = height;
+        tile.mDst = dst;
+        tile.mDstStride = dst_stride;
+    }
+
+    // Copy every tile still in flight
+    void finish()
+    {
+        copy(mTiles[mNext]);
+        copy(mTiles[(mNext + 1) % 2]);
+    }
+
+private:
+    struct Tile
+    {
+        GLuint mBuffer = 0;
+        U32 mSize = 0;
+        LLGLSyncFence mFence;
+        S32 mWidth = 0;
+        S32 mHeight = 0;
+        S32 mPitch = 0;
+        U8* mDst = NULL;    // NULL when nothing is pending
+        S32 mDstStride = 0;
+    };
+
+    void copy(Tile& tile)
+    {
+        if (!tile.mDst)
+        {
+            return;
+        }
+
+        LL_PROFILE_ZONE_SCOPED_CATEGORY_APP;
+        tile.mFence.wait();
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, tile.mBuffer);
+        const U8* src = (const U8*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, tile.mPitch * tile.mHeight, GL_MAP_READ_BIT);
+        if (src)
+        {
+            for (S32 row = 0; row < tile.mHeight; ++row)
+            {
+                memcpy(tile.mDst + row * tile.mDstStride, src + row * tile.mPitch, tile.mWidth * 3);
+            }
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        tile.mDst = NULL;
+    }
+
+    Tile mTiles[2];
+    U32 mNext = 0;
+};
+
 // Saves the image from the screen to a raw image
 // Since the required size might be bigger than the available screen, this method rerenders the scene in parts (called subimages) and copy
 // the results over to the final raw image.
@@ -6077,6 +6219,7 @@ bool LLViewerWindow::rawSnapshot(LLImageRaw *raw, S32 image_width, S32 image_hei
     // PRE SNAPSHOT
     gSnapshotNoPost = no_post;
     gDisplaySwapBuffers = false;
+    gPipeline.resetDynamicResolution();
 
     glClear(GL_DEPTH_BUFFER_BIT | GL_COLOR_BUFFER_BIT); // stencil buffer is deprecated | GL_STENCIL_BUFFER_BIT);
     setCursor(UI_CURSOR_WAIT);
@@ -6227,6 +6370,12 @@ bool LLViewerWindow::rawSnapshot(LLImageRaw *raw, S32 image_width, S32 image_hei
     F32 depth_conversion_factor_1 = (LLViewerCamera::getInstance()->getFar() + LLViewerCamera::getInstance()->getNear()) / (2.f * LLViewerCamera::getInstance()->getFar() * LLViewerCamera::getInstance()->getNear());
     F32 depth_conversion_factor_2 = (LLViewerCamera::getInstance()->getFar() - LLViewerCamera::getInstance()->getNear()) / (2.f * LLViewerCamera::getInstance()->getFar() * LLViewerCamera::getInstance()->getNear());
 
+    // color tiles are read in one go, and copied out while the next tile renders
+    static LLCachedControl<bool> async_readback(gSavedSettings, "SnapshotAsyncReadback", true);
+    LLSnapshotTileReader tile_reader;
+    bool read_tiles = async_readback && type == LLSnapshotModel::SNAPSHOT_TYPE_COLOR && raw->getComponents() == 3 &&
+                      !LLRender::sNsightDebugSupport;
+
     // Subimages are in fact partial rendering of the final view. This happens when the final view is bigger than the screen.
     // In most common cases, scale_factor is 1 and there's no more than 1 iteration on x and y
     for (int subimage_y = 0; subimage_y < scale_factor; ++subimage_y)
@@ -6261,7 +6410,20 @@ bool LLViewerWindow::rawSnapshot(LLImageRaw *raw, S32 image_width, S32 image_hei
                     swap();
                 }
 
-                for (U32 out_y = 0; out_y < read_height ; out_y++)
+                if (read_tiles)
+                {
+                    S32 output_buffer_offset = (
+                                                (window_width * subimage_x)
+                                                + (raw->getWidth() * window_height * subimage_y)
+                                                - output_buffer_offset_x
+                                                - (output_buffer_offset_y * (raw->getWidth()))
+                                                ) * raw->getComponents();
+                    tile_reader.read(subimage_x_offset, subimage_y_offset, read_width, read_height,
+                                     raw->getData() + output_buffer_offset, raw->getWidth() * raw->getComponents());
+                    LLAppViewer::instance()->pingMainloopTimeout("LLViewerWindow::rawSnapshot");
+                }
+
+                for (U32 out_y = 0; !read_tiles && out_y < read_height ; out_y++)
                 {
                     S32 output_buffer_offset = (
                                                 (out_y * (raw->getWidth())) // ...plus iterated y...
@@ -6355,6 +6517,8 @@ bool LLViewerWindow::rawSnapshot(LLImageRaw *raw, S32 image_width, S32 image_hei
         output_buffer_offset_y += subimage_y_offset;
     }
 
+    tile_reader.finish();
+
     gDisplaySwapBuffers = false;
     gSnapshotNoPost = false;
     gDepthDirty = true;
@@ -6432,6 +6596,7 @@ bool LLViewerWindow::simpleSnapshot(LLImageRaw* raw, S32 image_width, S32 image_
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_APP;
     gDisplaySwapBuffers = false;
+    gPipeline.resetDynamicResolution();
 
     glClear(GL_DEPTH_BUFFER_BIT | GL_COLOR_BUFFER_BIT); // stencil buffer is deprecated | GL_STENCIL_BUFFER_BIT);
     setCursor(UI_CURSOR_WAIT);
@@ -6988,6 +7153,18 @@ void LLViewerWindow::stopGL()
         LLViewerDynamicTexture::destroyGL();
         stop_glerror();
 
+        if (LLFlightRecorder::instanceExists())
+        {
+            LLFlightRecorder::getInstance()->destroyGL();
+        }
+        if (LLFramePacer::instanceExists())
+        {
+            LLFramePacer::getInstance()->destroyGL();
+        }
+
+        LLAvatarGPUTimer::destroyGL();
+        LLGPUPassTimer::destroyGL();
+
         if (gPipeline.isInit())
         {
             gPipeline.destroyGL();
@@ -42,6 +42,9 @@
 #include "noise.h"
 #include "llregionhandle.h" // for from_region_handle
 #include "llviewercontrol.h"
+#include "lldiskcache.h"
+#include "llfilesystem.h"
+#include "hbxxh.h"
 
 
 extern LLColor4U MAX_WATER_COLOR;
@@ -461,9 +464,138 @@ LLVLComposition::LLVLComposition(LLSurface *surfacep, const U32 width, const F32
 
 LLVLComposition::~LLVLComposition()
 {
+    saveCache();
     LLTerrainMaterials::~LLTerrainMaterials();
 }
 
+static const U32 COMPOSITION_CACHE_MAGIC = 0x504d4354; // "TCMP"
+static const U32 COMPOSITION_CACHE_VERSION = 1;
+
+static LLUUID get_composition_cache_id(U64 region_handle)
+{
+    return LLUUID::generateNewID(llformat("terrain composition %llu", region_handle));
+}
+
+bool LLVLComposition::cacheParamsMatch(const F32* params) const
+{
+    return !memcmp(params, mStartHeight, sizeof(mStartHeight)) &&
+           !memcmp(params + CORNER_COUNT, mHeightRange, sizeof(mHeightRange));
+}
+
+U64 LLVLComposition::hashHeights(S32 x_begin, S32 y_begin, S32 x_end, S32 y_end) const
+{
+    // Heights are resolved between grid points, so include the ring around the rectangle
+    const S32 grids = mSurfacep->getGridsPerEdge();
+    x_begin = llmax(x_begin - 1, 0);
+    y_begin = llmax(y_begin - 1, 0);
+    x_end = llmin(x_end + 1, grids);
+    y_end = llmin(y_end + 1, grids);
+
+    HBXXH64 hash;
+    for (S32 j = y_begin; j < y_end; j++)
+    {
+        for (S32 i = x_begin; i < x_end; i++)
+        {
+            F32 z = mSurfacep->getZ(i, j);
+            hash.update(&z, sizeof(z));
+        }
+    }
+    return hash.digest();
+}
+
+void LLVLComposition::loadCache()
+{
+    mCacheLoaded = true;
+    mCacheRegionHandle = mSurfacep->getRegion()->getHandle();
+    memcpy(mCacheParams, mStartHeight, sizeof(mStartHeight));
+    memcpy(mCacheParams + CORNER_COUNT, mHeightRange, sizeof(mHeightRange));
+
+    LLFileSystem file(get_composition_cache_id(mCacheRegionHandle), LLAssetType::AT_UNKNOWN);
+    S32 size = file.getSize();
+    if (size <= 0)
+    {
+        return;
+    }
+
+    std::vector<U8> data(size);
+    if (!file.read(data.data(), size))
+    {
+        return;
+    }
+
+    U32 header[4];
+    F32 params[CORNER_COUNT*2];
+    S32 offset = sizeof(header) + sizeof(params);
+    if (size < offset)
+    {
+        return;
+    }
+    memcpy(header, data.data(), sizeof(header));
+    memcpy(params, data.data() + sizeof(header), sizeof(params));
+    if (header[0] != COMPOSITION_CACHE_MAGIC || header[1] != COMPOSITION_CACHE_VERSION ||
+        header[2] != (U32)mWidth || !cacheParamsMatch(params))
+    {
+        // terrain texture heights changed since, everything must be regenerated
+        mCacheDirty = true;
+        return;
+    }
+
+    for (U32 n = 0; n < header[3]; n++)
+    {
+        S32 rect[4];
+        U64 hash;
+        if (offset + (S32)(sizeof(rect) + sizeof(hash)) > size)
+        {
+            break;
+        }
+        memcpy(rect, &data[offset], sizeof(rect));
+        memcpy(&hash, &data[offset + sizeof(rect)], sizeof(hash));
+        offset += sizeof(rect) + sizeof(hash);
+
+        if (rect[0] < 0 || rect[1] < 0 || rect[2] <= rect[0] || rect[3] <= rect[1] || rect[2] > mWidth || rect[3] > mWidth)
+        {
+            break;
+        }
+        S32 bytes = (rect[2] - rect[0]) * (rect[3] - rect[1]) * sizeof(F32);
+        if (offset + bytes > size)
+        {
+            break;
+        }
+
+        CachedRect& cached = mCachedRects[rect[0] | (rect[1] << 16)];
+        cached.mXEnd = rect[2];
+        cached.mYEnd = rect[3];
+        cached.mHeightsHash = hash;
+        cached.mValues.resize(bytes / sizeof(F32));
+        memcpy(cached.mValues.data(), &data[offset], bytes);
+        offset += bytes;
+    }
+}
+
+void LLVLComposition::saveCache()
+{
+    if (!mCacheDirty || !mCacheLoaded || !LLDiskCache::instanceExists())
+    {
+        return;
+    }
+
+    std::vector<U8> data;
+    U32 header[4] = { COMPOSITION_CACHE_MAGIC, COMPOSITION_CACHE_VERSION, (U32)mWidth, (U32)mCachedRects.size() };
+    data.insert(data.end(), (const U8*)header, (const U8*)header + sizeof(header));
+    data.insert(data.end(), (const U8*)mCacheParams, (const U8*)mCacheParams + sizeof(mCacheParams));
+    for (const auto& [key, cached] : mCachedRects)
+    {
+        S32 rect[4] = { (S32)(key & 0xffff), (S32)(key >> 16), cached.mXEnd, cached.mYEnd };
+        data.insert(data.end(), (const U8*)rect, (const U8*)rect + sizeof(rect));
+        data.insert(data.end(), (const U8*)&cached.mHeightsHash, (const U8*)&cached.mHeightsHash + sizeof(U64));
+        data.insert(data.end(), (const U8*)cached.mValues.data(), (const U8*)(cached.mValues.data() + cached.mValues.size()));
+    }
+
+    LLFileSystem file(get_composition_cache_id(mCacheRegionHandle), LLAssetType::AT_UNKNOWN, LLFileSystem::WRITE);
+    file.write(data.data(), (S32)data.size());
+    mCacheDirty = false;
+}
+
 
 void LLVLComposition::setSurface(LLSurface *surfacep)
 {
@@ -502,6 +634,42 @@ bool LLVLComposition::generateHeights(const F32 x, const F32 y,
     {
         y_end = mWidth;
     }
+    if (x_begin >= x_end || y_begin >= y_end)
+    {
+        return true;
+    }
+
+    // Values from an earlier visit are good as long as the heights under them and the
+    // texture heights are unchanged
+    static LLCachedControl<bool> use_cache(gSavedSettings, "TerrainCompositionCache", true);
+    U64 heights_hash = 0;
+    CachedRect* cached = NULL;
+    if (use_cache)
+    {
+        if (!mCacheLoaded)
+        {
+            loadCache();
+        }
+        if (!cacheParamsMatch(mCacheParams))
+        {
+            memcpy(mCacheParams, mStartHeight, sizeof(mStartHeight));
+            memcpy(mCacheParams + CORNER_COUNT, mHeightRange, sizeof(mHeightRange));
+            mCachedRects.clear();
+        }
+
+        heights_hash = hashHeights(x_begin, y_begin, x_end, y_end);
+        cached = &mCachedRects[x_begin | (y_begin << 16)];
+        if (cached->mXEnd == x_end && cached->mYEnd == y_end && cached->mHeightsHash == heights_hash &&
+            !cached->mValues.empty())
+        {
+            const S32 row = x_end - x_begin;
+            for (S32 j = y_begin; j < y_end; j++)
+            {
+                memcpy(mDatap + x_begin + j*mWidth, &cached->mValues[(j - y_begin)*row], row*sizeof(F32));
+            }
+            return true;
+        }
+    }
 
     LLVector3d origin_global = from_region_handle(mSurfacep->getRegion()->getHandle());
 
@@ -569,6 +737,20 @@ bool LLVLComposition::generateHeights(const F32 x, const F32 y,
             *(mDatap + i + j*mWidth) = scaled_noisy_height;
         }
     }
+
+    if (cached)
+    {
+        const S32 row = x_end - x_begin;
+        cached->mXEnd = x_end;
+        cached->mYEnd = y_end;
+        cached->mHeightsHash = heights_hash;
+        cached->mValues.resize(row*(y_end - y_begin));
+        for (S32 j = y_begin; j < y_end; j++)
+        {
+            memcpy(&cached->mValues[(j - y_begin)*row], mDatap + x_begin + j*mWidth, row*sizeof(F32));
+        }
+        mCacheDirty = true;
+    }
     return true;
 }
 
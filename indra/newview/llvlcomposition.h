@@ -150,9 +150,31 @@ public:
     bool getParamsReady() const { return mParamsReady; }
 
 protected:
+    // Composition values generated for one rectangle on an earlier visit, valid while the
+    // heights under it hash the same
+    struct CachedRect
+    {
+        S32 mXEnd;
+        S32 mYEnd;
+        U64 mHeightsHash;
+        std::vector<F32> mValues;
+    };
+    typedef std::map<U32, CachedRect> cached_rect_map_t;   // by x_begin | y_begin << 16
+
+    bool cacheParamsMatch(const F32* params) const;
+    U64 hashHeights(S32 x_begin, S32 y_begin, S32 x_end, S32 y_end) const;
+    void loadCache();
+    void saveCache();
+
     bool mParamsReady = false;
     LLSurface *mSurfacep;
 
+    bool mCacheLoaded = false;
+    U64 mCacheRegionHandle = 0;
+    F32 mCacheParams[CORNER_COUNT*2] = {};  // start heights and height ranges the cache was made with
+    cached_rect_map_t mCachedRects;
+    bool mCacheDirty = false;
+
     // Final minimap raw images
     LLPointer<LLImageRaw> mRawImages[LLTerrainMaterials::ASSET_COUNT];
 
@@ -35,6 +35,7 @@
 #include "llframetimer.h"
 #include "llsurface.h"
 #include "llbitpack.h"
+#include "workqueue.h"
 
 const   char    LAND_LAYER_CODE                 = 'L';
 const   char    WIND_LAYER_CODE                 = '7';
@@ -59,6 +60,35 @@ LLVLManager::~LLVLManager()
         delete mPacketData[i];
     }
     mPacketData.clear();
+    mLandJobs.clear();
+}
+
+LLVLManager::LandJob::~LandJob()
+{
+    delete mData;
+}
+
+// static
+void LLVLManager::decodeLand(LandJob &job)
+{
+    LLBitPack bit_pack(job.mData->mData, job.mData->mSize);
+    LLGroupHeader goph;
+
+    decode_patch_group_header(bit_pack, &goph);
+    LLSurface::decodeDCTPatches(bit_pack, &goph, AURORA_LAND_LAYER_CODE == job.mData->mType, job.mPatchesPerEdge, job.mPatches);
+}
+
+void LLVLManager::applyDecodedLand()
+{
+    LL_PROFILE_ZONE_SCOPED;
+
+    // Stop at the first job still decoding, later packets may overwrite the same patches
+    while (!mLandJobs.empty() && mLandJobs.front()->mDone.load(std::memory_order_acquire))
+    {
+        LandJob &job = *mLandJobs.front();
+        job.mRegionp->getLand().applyDecodedPatches(job.mPatches);
+        mLandJobs.pop_front();
+    }
 }
 
 void LLVLManager::addLayerData(LLVLData *vl_datap, const S32Bytes mesg_size)
@@ -102,26 +132,48 @@ void LLVLManager::unpackData(const S32 num_packets)
 {
     static LLFrameTimer decode_timer;
 
+    // Land decoded since the last frame goes into the surfaces in one batch
+    applyDecodedLand();
+
+    LL::WorkQueue::ptr_t general_queue = LL::WorkQueue::getInstance("General");
+
     S32 i;
     for (i = 0; i < mPacketData.size(); i++)
     {
         LLVLData *datap = mPacketData[i];
 
+// <FS:CR> Aurora Sim
+        if (LAND_LAYER_CODE == datap->mType || AURORA_LAND_LAYER_CODE == datap->mType)
+// </FS:CR> Aurora Sim
+        {
+            // Decoding a region's worth of patches takes long enough to stall the message
+            // loop on arrival, hand it to the General pool
+            auto job = std::make_shared<LandJob>();
+            job->mData = datap;
+            job->mRegionp = datap->mRegionp;
+            job->mPatchesPerEdge = datap->mRegionp->getLand().getPatchesPerEdge();
+            mPacketData[i] = NULL;
+            mLandJobs.push_back(job);
+
+            if (!general_queue || !general_queue->post([job]()
+                {
+                    decodeLand(*job);
+                    job->mDone.store(true, std::memory_order_release);
+                }))
+            {
+                decodeLand(*job);
+                job->mDone.store(true, std::memory_order_release);
+            }
+            continue;
+        }
+
         LLBitPack bit_pack(datap->mData, datap->mSize);
         LLGroupHeader goph;
 
         decode_patch_group_header(bit_pack, &goph);
-        if (LAND_LAYER_CODE == datap->mType)
-        {
-            datap->mRegionp->getLand().decompressDCTPatch(bit_pack, &goph, false);
-        }
 // <FS:CR> Aurora Sim
-        else if (AURORA_LAND_LAYER_CODE == datap->mType)
-        {
-            datap->mRegionp->getLand().decompressDCTPatch(bit_pack, &goph, true);
-        }
         //else if (WIND_LAYER_CODE == datap->mType)
-        else if (WIND_LAYER_CODE == datap->mType || AURORA_WIND_LAYER_CODE == datap->mType)
+        if (WIND_LAYER_CODE == datap->mType || AURORA_WIND_LAYER_CODE == datap->mType)
 // </FS:CR> Aurora Sim
         {
             datap->mRegionp->mWind.decompress(bit_pack, &goph);
@@ -188,6 +240,19 @@ void LLVLManager::cleanupData(LLViewerRegion *regionp)
             cur++;
         }
     }
+
+    // jobs still decoding finish on their own and are dropped with their last reference
+    for (auto iter = mLandJobs.begin(); iter != mLandJobs.end(); )
+    {
+        if ((*iter)->mRegionp == regionp)
+        {
+            iter = mLandJobs.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
 }
 
 LLVLData::LLVLData(LLViewerRegion *regionp, const S8 type, U8 *data, const S32 size)
@@ -31,8 +31,13 @@
 
 #include "stdtypes.h"
 
+#include <atomic>
+#include <deque>
+#include <memory>
+
 class LLVLData;
 class LLViewerRegion;
+struct LLDecodedTerrainPatch;
 
 class LLVLManager
 {
@@ -53,8 +58,24 @@ public:
 
     void cleanupData(LLViewerRegion *regionp);
 protected:
+    // Land patches of one packet, decoded on the General thread pool
+    struct LandJob
+    {
+        ~LandJob();
+
+        LLVLData *mData = nullptr;
+        LLViewerRegion *mRegionp = nullptr;    // never dereferenced off the main thread
+        S32 mPatchesPerEdge = 0;
+        std::vector<LLDecodedTerrainPatch> mPatches;
+        std::atomic<bool> mDone { false };
+    };
+
+    static void decodeLand(LandJob &job);
+    void applyDecodedLand();
 
     std::vector<LLVLData *> mPacketData;
+    // In arrival order, applied in that order once decoded
+    std::deque<std::shared_ptr<LandJob> > mLandJobs;
     U32Bits mLandBits;
     U32Bits mWindBits;
     U32Bits mCloudBits;
@@ -96,6 +96,7 @@
 #include "llvovolume.h"
 #include "llworld.h"
 #include "pipeline.h"
+#include "parallelfor.h"
 #include "llviewershadermgr.h"
 #include "llsky.h"
 #include "llanimstatelabels.h"
@@ -614,6 +615,9 @@ F32 LLVOAvatar::sRenderDistance = 256.f;
 S32 LLVOAvatar::sNumVisibleAvatars = 0;
 S32 LLVOAvatar::sNumLODChangesThisFrame = 0;
 
+static bool sDeferJointUpdates = false;
+static std::vector<LLPointer<LLVOAvatar> > sPendingJointUpdates;
+
 // const LLUUID LLVOAvatar::sStepSoundOnLand("e8af4a28-aa83-4310-a7c4-c047e15ea0df"); - <FS:PP> Commented out for FIRE-3169: Option to change the default footsteps sound
 const LLUUID LLVOAvatar::sStepSounds[LL_MCODE_END] =
 {
@@ -706,6 +710,7 @@ LLVOAvatar::LLVOAvatar(const LLUUID& id,
     mUpdatePeriod(1),
     mOverallAppearance(AOA_INVISIBLE),
     mVisualComplexityStale(true),
+    mAttachmentCostSweep(0),
     mVisuallyMuteSetting(AV_RENDER_NORMALLY),
     mMutedAVColor(LLColor4::white /* used for "uninitialize" */),
     mFirstFullyVisible(true),
@@ -755,6 +760,8 @@ LLVOAvatar::LLVOAvatar(const LLUUID& id,
 
     mNeedsImpostorUpdate = true;
     mLastImpostorUpdateReason = 0;
+    mImpostorTile = -1;
+    mJointUpdatePending = false;
     mNeedsAnimUpdate = true;
 
     mNeedsExtentUpdate = true;
@@ -894,6 +901,8 @@ LLVOAvatar::~LLVOAvatar()
 {
     sInstances.remove(this);
 
+    gPipeline.mImpostorAtlas.releaseTile(this);
+
     if (!mFullyLoaded)
     {
         debugAvatarRezTime("AvatarRezLeftCloudNotification","left after ruth seconds as cloud");
@@ -1209,10 +1218,11 @@ void LLVOAvatar::destroyGL()
 //static
 void LLVOAvatar::resetImpostors()
 {
+    gPipeline.mImpostorAtlas.cleanup();
+
     for (LLCharacter* character : LLCharacter::sInstances)
     {
         LLVOAvatar* avatar = (LLVOAvatar*)character;
-        avatar->mImpostor.release();
         avatar->mNeedsImpostorUpdate = true;
         avatar->mLastImpostorUpdateReason = 1;
     }
@@ -3053,112 +3063,177 @@ static void override_bbox(LLDrawable* drawable, LLVector4a* extents)
     drawable->movePartition();
 }
 
-void LLVOAvatar::idleUpdateMisc(bool detailed_update)
+void LLVOAvatar::rebuildAttachmentXforms()
+{
+    mAttachmentXforms.clear();
+    for (attachment_map_t::iterator iter = mAttachmentPoints.begin();
+         iter != mAttachmentPoints.end();
+         ++iter)
+    {
+        LLViewerJointAttachment* attachment = iter->second;
+        if (!attachment)
+        {
+            continue;
+        }
+
+        for (const LLPointer<LLViewerObject>& attached_object : attachment->mAttachedObjects)
+        {
+            if (attached_object.notNull())
+            {
+                AttachmentXform& entry = mAttachmentXforms.emplace_back();
+                entry.mObject = attached_object;
+                entry.mAttachment = attachment;
+            }
+        }
+    }
+    mAttachmentXformsDirty = false;
+}
+
+void LLVOAvatar::updateAttachmentXforms(bool visible)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_AVATAR;
-    if (LLVOAvatar::sJointDebug)
+
+    // world matrix drift below this doesn't warrant moving the attachment
+    const F32 ATTACHMENT_XFORM_EPSILON = 0.0001f;
+
+    if (mDrawable.isNull())
     {
-        LL_INFOS() << getFullname() << ": joint touches: " << LLJoint::sNumTouches << " updates: " << LLJoint::sNumUpdates << LL_ENDL;
+        return;
     }
 
-    LLJoint::sNumUpdates = 0;
-    LLJoint::sNumTouches = 0;
+    if (mAttachmentXformsDirty)
+    {
+        rebuildAttachmentXforms();
+    }
 
-    bool visible = isVisible() || mNeedsAnimUpdate;
+    // rigged attachments take their bounds from the avatar, so they need
+    // an update whenever those change even if their joint didn't move
+    const LLVector4a* avatar_extents = mDrawable->getSpatialExtents();
+    LLVector3 avatar_bounds[2] = { LLVector3(avatar_extents[0].getF32ptr()), LLVector3(avatar_extents[1].getF32ptr()) };
+    bool extents_changed = avatar_bounds[0] != mAttachmentXformExtents[0] || avatar_bounds[1] != mAttachmentXformExtents[1];
+    mAttachmentXformExtents[0] = avatar_bounds[0];
+    mAttachmentXformExtents[1] = avatar_bounds[1];
 
-    // update attachments positions
-    if (detailed_update)
+    U32 draw_order = 0;
+    S32 attachment_selected = LLSelectMgr::getInstance()->getSelection()->getObjectCount() && LLSelectMgr::getInstance()->getSelection()->isAttachment();
+    for (AttachmentXform& entry : mAttachmentXforms)
     {
-        U32 draw_order = 0;
-        S32 attachment_selected = LLSelectMgr::getInstance()->getSelection()->getObjectCount() && LLSelectMgr::getInstance()->getSelection()->isAttachment();
-        for (attachment_map_t::iterator iter = mAttachmentPoints.begin();
-             iter != mAttachmentPoints.end();
-             ++iter)
+        LLViewerJointAttachment* attachment = entry.mAttachment;
+        LLViewerObject* attached_object = entry.mObject;
+        if (!attached_object
+            || attached_object->isDead()
+            || !attachment->getValid()
+            || attached_object->mDrawable.isNull())
         {
-            LLViewerJointAttachment* attachment = iter->second;
+            continue;
+        }
 
-            // <FS:Ansariel> Possible crash fix
-            if (!attachment)
+        LLSpatialBridge* bridge = attached_object->mDrawable->getSpatialBridge();
+
+        if (visible || !(bridge && bridge->getRadius() < 2.0f))
+        {
+            bool rigged = bridge && attached_object->mDrawable->isState(LLDrawable::RIGGED | LLDrawable::RIGGED_CHILD);
+
+            // skip attachments nothing has moved: not their attachment point,
+            // not the avatar bounds (if rigged), and not the server
+            const LLMatrix4a& world_matrix = attachment->getWorldMatrix4a();
+            bool moved = attachment_selected
+                || entry.mDrawable != attached_object->mDrawable.get()
+                || (rigged && extents_changed)
+                || attached_object->mDrawable->isState(LLDrawable::ON_MOVE_LIST)
+                || (bridge && bridge->isState(LLDrawable::ON_MOVE_LIST));
+            for (S32 i = 0; i < 4 && !moved; ++i)
             {
-                continue;
+                moved = !world_matrix.mMatrix[i].equals4(entry.mWorldMatrix.mMatrix[i], ATTACHMENT_XFORM_EPSILON);
             }
-            // </FS:Ansariel>
 
-            for (LLViewerJointAttachment::attachedobjs_vec_t::iterator attachment_iter = attachment->mAttachedObjects.begin();
-                 attachment_iter != attachment->mAttachedObjects.end();
-                 ++attachment_iter)
+            if (!moved)
             {
-                LLViewerObject* attached_object = attachment_iter->get();
-                if (!attached_object
-                    || attached_object->isDead()
-                    || !attachment->getValid()
-                    || attached_object->mDrawable.isNull())
+                if (rigged)
                 {
-                    continue;
+                    LLSpatialGroup* group = attached_object->mDrawable->getSpatialGroup();
+                    if (group)
+                    { //keep draw order of group
+                        group->mAvatarp = this;
+                        group->mRenderOrder = draw_order++;
+                    }
                 }
+                continue;
+            }
 
-                LLSpatialBridge* bridge = attached_object->mDrawable->getSpatialBridge();
-
-                if (visible || !(bridge && bridge->getRadius() < 2.0f))
-                {
-                    //override rigged attachments' octree spatial extents with this avatar's bounding box
-                    bool rigged = false;
-                    if (bridge)
-                    {
-                        //transform avatar bounding box into attachment's coordinate frame
-                        LLVector4a extents[2];
-                        bridge->transformExtents(mDrawable->getSpatialExtents(), extents);
+            entry.mWorldMatrix = world_matrix;
+            entry.mDrawable = attached_object->mDrawable.get();
 
-                        if (attached_object->mDrawable->isState(LLDrawable::RIGGED | LLDrawable::RIGGED_CHILD))
-                        {
-                            rigged = true;
-                            override_bbox(attached_object->mDrawable, extents);
-                        }
-                    }
+            //override rigged attachments' octree spatial extents with this avatar's bounding box
+            if (rigged)
+            {
+                //transform avatar bounding box into attachment's coordinate frame
+                LLVector4a extents[2];
+                bridge->transformExtents(mDrawable->getSpatialExtents(), extents);
+                override_bbox(attached_object->mDrawable, extents);
+            }
 
-                    // if selecting any attachments, update all of them as non-damped
-                    if (attachment_selected)
-                    {
-                        gPipeline.updateMoveNormalAsync(attached_object->mDrawable);
-                    }
-                    else
-                    {
-                        // Note: SL-17415; While most objects follow joints,
-                        // some objects get position updates from server
-                        gPipeline.updateMoveDampedAsync(attached_object->mDrawable);
-                    }
+            // if selecting any attachments, update all of them as non-damped
+            if (attachment_selected)
+            {
+                gPipeline.updateMoveNormalAsync(attached_object->mDrawable);
+            }
+            else
+            {
+                // Note: SL-17415; While most objects follow joints,
+                // some objects get position updates from server
+                gPipeline.updateMoveDampedAsync(attached_object->mDrawable);
+            }
 
-                    // override_bbox calls movePartition() and getSpatialPartition(),
-                    // so bridge might no longer be valid, get it again.
-                    // ex: animesh stops being an animesh
-                    bridge = attached_object->mDrawable->getSpatialBridge();
-                    if (bridge)
-                    {
-                        if (!rigged)
-                        {
-                            gPipeline.updateMoveNormalAsync(bridge);
-                        }
-                        else
-                        {
-                            //specialized impl of updateMoveNormalAsync just for rigged attachment SpatialBridge
-                            bridge->setState(LLDrawable::MOVE_UNDAMPED);
-                            bridge->updateMove();
-                            bridge->setState(LLDrawable::EARLY_MOVE);
-
-                            LLSpatialGroup* group = attached_object->mDrawable->getSpatialGroup();
-                            if (group)
-                            { //set draw order of group
-                                group->mAvatarp = this;
-                                group->mRenderOrder = draw_order++;
-                            }
-                        }
+            // override_bbox calls movePartition() and getSpatialPartition(),
+            // so bridge might no longer be valid, get it again.
+            // ex: animesh stops being an animesh
+            bridge = attached_object->mDrawable->getSpatialBridge();
+            if (bridge)
+            {
+                if (!rigged)
+                {
+                    gPipeline.updateMoveNormalAsync(bridge);
+                }
+                else
+                {
+                    //specialized impl of updateMoveNormalAsync just for rigged attachment SpatialBridge
+                    bridge->setState(LLDrawable::MOVE_UNDAMPED);
+                    bridge->updateMove();
+                    bridge->setState(LLDrawable::EARLY_MOVE);
+
+                    LLSpatialGroup* group = attached_object->mDrawable->getSpatialGroup();
+                    if (group)
+                    { //set draw order of group
+                        group->mAvatarp = this;
+                        group->mRenderOrder = draw_order++;
                     }
-
-                    attached_object->updateText();
                 }
             }
+
+            attached_object->updateText();
         }
     }
+}
+
+void LLVOAvatar::idleUpdateMisc(bool detailed_update)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_AVATAR;
+    if (LLVOAvatar::sJointDebug)
+    {
+        LL_INFOS() << getFullname() << ": joint touches: " << LLJoint::sNumTouches << " updates: " << LLJoint::sNumUpdates << LL_ENDL;
+    }
+
+    LLJoint::sNumUpdates = 0;
+    LLJoint::sNumTouches = 0;
+
+    bool visible = isVisible() || mNeedsAnimUpdate;
+
+    // update attachments positions
+    if (detailed_update)
+    {
+        updateAttachmentXforms(visible);
+    }
 
     mNeedsAnimUpdate = false;
 
@@ -3170,13 +3245,17 @@ void LLVOAvatar::idleUpdateMisc(bool detailed_update)
 
         getImpostorValues(ext, angle, distance);
 
+        // base view angle change (scaled by distance and update period) that calls for a new impostor
+        static LLCachedControl<F32> update_angle(gSavedSettings, "RenderImpostorUpdateAngle", 0.35f);
+        const F32 angle_threshold = llmax((F32)update_angle, 0.f) * DEG_TO_RAD * distance * mUpdatePeriod;
+
         for (U32 i = 0; i < 3 && !mNeedsImpostorUpdate; i++)
         {
             F32 cur_angle = angle.mV[i];
             F32 old_angle = mImpostorAngle.mV[i];
             F32 angle_diff = fabsf(cur_angle-old_angle);
 
-            if (angle_diff > F_PI/512.f*distance*mUpdatePeriod)
+            if (angle_diff > angle_threshold)
             {
                 mNeedsImpostorUpdate = true;
                 mLastImpostorUpdateReason = 2;
@@ -4218,7 +4297,7 @@ LLVector3 LLVOAvatar::idleCalcNameTagPosition(const LLVector3 &root_pos_last)
     local_camera_up.scaleVec(avatar_ellipsoid);
     local_camera_at.scaleVec(avatar_ellipsoid);
 
-    LLVector3 head_offset = (mHeadp->getLastWorldPosition() - mRoot->getLastWorldPosition()) * inv_root_rot;
+    LLVector3 head_offset = (mHeadp->getWorldPosition() - mRoot->getWorldPosition()) * inv_root_rot;
 
     if (dist_vec(head_offset, mTargetRootToHeadOffset) > NAMETAG_UPDATE_THRESHOLD)
     {
@@ -4229,7 +4308,7 @@ LLVector3 LLVOAvatar::idleCalcNameTagPosition(const LLVector3 &root_pos_last)
 
     // <FS:Ansariel> Optional legacy nametag position
     //LLVector3 name_position = mRoot->getLastWorldPosition() + (mCurRootToHeadOffset * root_rot);
-    name_position = mRoot->getLastWorldPosition() + (mCurRootToHeadOffset * root_rot);
+    name_position = mRoot->getWorldPosition() + (mCurRootToHeadOffset * root_rot);
     name_position += (local_camera_up * root_rot) - (projected_vec(local_camera_at * root_rot, camera_to_av));
     name_position += pixel_up_vec * NAMETAG_VERTICAL_SCREEN_OFFSET;
     // <FS:Ansariel> Optional legacy nametag position
@@ -5082,6 +5161,9 @@ void LLVOAvatar::updateTimeStep()
         F32 time_quantum = clamp_rescale((F32)sInstances.size(), 10.f, 35.f, 0.f, 0.25f);
         F32 pixel_area_scale = clamp_rescale(mPixelArea, 100, 5000, 1.f, 0.f);
         F32 time_step = time_quantum * pixel_area_scale;
+        // snap to a few discrete steps; changing the step re-quantizes motion timestamps
+        const F32 TIME_STEP_INCREMENT = 0.05f;
+        time_step = ll_round(time_step / TIME_STEP_INCREMENT) * TIME_STEP_INCREMENT;
         // Extrema:
         //   If number of avs is 10 or less, time_step is unmodified (flagged with 0.0).
         //   If area of av is 5000 or greater, time_step is unmodified (flagged with 0.0).
@@ -5094,11 +5176,8 @@ void LLVOAvatar::updateTimeStep()
             stopMotion(ANIM_AGENT_WALK_ADJUST);
             removeAnimationData("Walk Speed");
         }
-        // See SL-763 - playback with altered time step does not
-        // appear to work correctly, odd behavior for distant avatars.
-        // As of 11-2017, LLMotionController::updateMotions() will
-        // ignore the value here. Need to re-enable if it's every
-        // fixed.
+        // Distant avatars evaluate their motions once per time step and
+        // interpolate the pose in between.
         mMotionController.setTimeStep(time_step);
     }
     // <FS:Zi> Optionally disable the usage of timesteps, testing if this affects performance or
@@ -5363,8 +5442,7 @@ bool LLVOAvatar::updateCharacter(LLAgent &agent)
     //--------------------------------------------------------------------
     // change animation time quanta based on avatar render load
     //--------------------------------------------------------------------
-    // SL-763 the time step quantization does not currently work.
-    //updateTimeStep();
+    updateTimeStep();
 
     //--------------------------------------------------------------------
     // Update sitting state based on parent and active animation info.
@@ -5443,8 +5521,29 @@ bool LLVOAvatar::updateCharacter(LLAgent &agent)
     // Generate footstep sounds when feet hit the ground
     updateFootstepSounds();
 
+    static LLCachedControl<bool> flat_skeleton(gSavedSettings, "AvatarFlatSkeleton", true);
+    if (flat_skeleton)
+    {
+        mFlatSkeleton.attach(mRoot);
+    }
+    else if (mFlatSkeleton.getRoot())
+    {
+        mFlatSkeleton.detach();
+    }
+
     // Update child joints as needed.
-    mRoot->updateWorldMatrixChildren();
+    if (sDeferJointUpdates && !isSelf())
+    {
+        if (!mJointUpdatePending)
+        {
+            mJointUpdatePending = true;
+            sPendingJointUpdates.push_back(this);
+        }
+    }
+    else
+    {
+        mRoot->updateWorldMatrixChildren();
+    }
 
     if (visible)
     {
@@ -5455,6 +5554,36 @@ bool LLVOAvatar::updateCharacter(LLAgent &agent)
     return visible;
 }
 
+//static
+void LLVOAvatar::beginJointUpdates()
+{
+    static LLCachedControl<bool> parallel_joints(gSavedSettings, "AvatarParallelJointUpdates", true);
+    sDeferJointUpdates = parallel_joints;
+}
+
+//static
+void LLVOAvatar::flushJointUpdates()
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_AVATAR;
+    sDeferJointUpdates = false;
+
+    // each avatar's joint hierarchy is independent of every other
+    LL::parallel_for("General", sPendingJointUpdates.size(), [](size_t i)
+    {
+        LLVOAvatar* avatar = sPendingJointUpdates[i];
+        if (!avatar->isDead())
+        {
+            avatar->mRoot->updateWorldMatrixChildren();
+        }
+    }, 4);
+
+    for (LLVOAvatar* avatar : sPendingJointUpdates)
+    {
+        avatar->mJointUpdatePending = false;
+    }
+    sPendingJointUpdates.clear();
+}
+
 //-----------------------------------------------------------------------------
 // updateHeadOffset()
 //-----------------------------------------------------------------------------
@@ -5989,11 +6118,15 @@ U32 LLVOAvatar::renderRigid()
 U32 LLVOAvatar::renderImpostor(LLColor4U color, S32 diffuse_channel)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_AVATAR; // <FS:Beq/> Tracy accounting for render tracking
-    if (!mImpostor.isComplete())
+    if (!hasImpostor())
     {
         return 0;
     }
 
+    LLVector2 tc_min, tc_max;
+    gPipeline.mImpostorAtlas.getTexCoords(this, tc_min, tc_max);
+    gPipeline.mImpostorAtlas.touchTile(this);
+
     LLVector3 pos(getRenderPosition()+mImpostorOffset);
     LLVector3 at = (pos - LLViewerCamera::getInstance()->getOrigin());
     at.normalize();
@@ -6036,7 +6169,7 @@ U32 LLVOAvatar::renderImpostor(LLColor4U color, S32 diffuse_channel)
     gGL.flush();
 
     gGL.color4ubv(color.mV);
-    gGL.getTexUnit(diffuse_channel)->bind(&mImpostor);
+    gGL.getTexUnit(diffuse_channel)->bind(&gPipeline.mImpostorAtlas.getTarget());
     // <FS:Ansariel> Remove QUADS rendering mode
     //gGL.begin(LLRender::QUADS);
     //gGL.texCoord2f(0,0);
@@ -6050,18 +6183,18 @@ U32 LLVOAvatar::renderImpostor(LLColor4U color, S32 diffuse_channel)
     //gGL.end();
     gGL.begin(LLRender::TRIANGLES);
     {
-        gGL.texCoord2f(0.f, 0.f);
+        gGL.texCoord2f(tc_min.mV[0], tc_min.mV[1]);
         gGL.vertex3fv((pos + left - up).mV);
-        gGL.texCoord2f(1.f, 0.f);
+        gGL.texCoord2f(tc_max.mV[0], tc_min.mV[1]);
         gGL.vertex3fv((pos - left - up).mV);
-        gGL.texCoord2f(1.f, 1.f);
+        gGL.texCoord2f(tc_max.mV[0], tc_max.mV[1]);
         gGL.vertex3fv((pos - left + up).mV);
 
-        gGL.texCoord2f(0.f, 0.f);
+        gGL.texCoord2f(tc_min.mV[0], tc_min.mV[1]);
         gGL.vertex3fv((pos + left - up).mV);
-        gGL.texCoord2f(1.f, 1.f);
+        gGL.texCoord2f(tc_max.mV[0], tc_max.mV[1]);
         gGL.vertex3fv((pos - left + up).mV);
-        gGL.texCoord2f(0.f, 1.f);
+        gGL.texCoord2f(tc_min.mV[0], tc_max.mV[1]);
         gGL.vertex3fv((pos + left + up).mV);
     }
     gGL.end();
@@ -8249,12 +8382,14 @@ const LLViewerJointAttachment *LLVOAvatar::attachObject(LLViewerObject *viewer_o
         return 0;
     }
 
+    mAttachmentXformsDirty = true;
+
     if (!viewer_object->isAnimatedObject())
     {
         updateAttachmentOverrides();
     }
 
-    updateVisualComplexity();
+    updateVisualComplexity(viewer_object);
 
     if (viewer_object->isSelected())
     {
@@ -8563,11 +8698,12 @@ bool LLVOAvatar::detachObject(LLViewerObject *viewer_object)
         if (attachment && attachment->isObjectAttached(viewer_object))
         // </FS:Ansariel>
         {
-            updateVisualComplexity();
+            updateVisualComplexity(viewer_object);
             bool is_animated_object = viewer_object->isAnimatedObject();
             cleanupAttachedMesh(viewer_object);
 
             attachment->removeObject(viewer_object);
+            mAttachmentXformsDirty = true;
             if (!is_animated_object)
             {
                 updateAttachmentOverrides();
@@ -9441,9 +9577,12 @@ void LLVOAvatar::updateTooSlow()
         }
     }
 
+    // the offscreen profile misses what depends on the view, like the avatar's size on screen
+    // and the overdraw of its alpha layers, so go by whichever is higher
+    F32 scene_ms = mGPUSceneTime - mGPUShadowTime;
     bool exceeds_max_ART =
         ((LLPerfStats::renderAvatarMaxART_ns > 0) &&
-            (mGPURenderTime >= max_art_ms)); // NOTE: don't use getGPURenderTime accessor here to avoid "isTooSlow" feedback loop
+            (llmax(mGPURenderTime, scene_ms) >= max_art_ms)); // NOTE: don't use getGPURenderTime accessor here to avoid "isTooSlow" feedback loop
 
     if (exceeds_max_ART && !ignore_tune)
     {
@@ -9457,7 +9596,10 @@ void LLVOAvatar::updateTooSlow()
             if( (!isSelf() || allowSelfImpostor) && !render_friend_or_exception)
             {
                 // Note: slow rendering Friends still get their shadows zapped.
-                mTooSlowWithoutShadows = (getGPURenderTime()*2.f >= max_art_ms)  // NOTE: assumes shadow rendering doubles render time
+                // NOTE: assumes shadow rendering doubles render time unless the shadows were measured in the scene
+                F32 render_ms = llmax(getGPURenderTime(), scene_ms);
+                F32 shadow_ms = mGPUShadowTime > 0.f ? mGPUShadowTime : render_ms;
+                mTooSlowWithoutShadows = (render_ms + shadow_ms >= max_art_ms)
                     || (compelxity_render_mode == AV_RENDER_ONLY_SHOW_FRIENDS && !mIsControlAvatar);
             }
             if(mTooSlowWithoutShadows)
@@ -11790,6 +11932,11 @@ void LLVOAvatar::updateImpostors()
 {
     LLViewerCamera::sCurCameraID = LLViewerCamera::CAMERA_WORLD;
 
+    static LLCachedControl<U32> max_updates(gSavedSettings, "RenderImpostorMaxUpdatesPerFrame", 8);
+
+    static std::vector<LLVOAvatar*> pending;
+    pending.clear();
+
     for (LLCharacter* character : LLCharacter::sInstances)
     {
         LLVOAvatar* avatar = (LLVOAvatar*)character;
@@ -11798,11 +11945,30 @@ void LLVOAvatar::updateImpostors()
             && avatar->isImpostor()
             && avatar->needsImpostorUpdate())
         {
-            avatar->calcMutedAVColor();
-            gPipeline.generateImpostor(avatar);
+            pending.push_back(avatar);
         }
     }
 
+    if (max_updates > 0 && pending.size() > max_updates)
+    { // avatars without an impostor first, then the stalest ones; the rest wait for a later frame
+        auto stalest = [](const LLVOAvatar* lhs, const LLVOAvatar* rhs)
+        {
+            if (lhs->hasImpostor() != rhs->hasImpostor())
+            {
+                return !lhs->hasImpostor();
+            }
+            return lhs->mLastImpostorUpdateFrameTime < rhs->mLastImpostorUpdateFrameTime;
+        };
+        std::partial_sort(pending.begin(), pending.begin() + max_updates, pending.end(), stalest);
+        pending.resize(max_updates);
+    }
+
+    for (LLVOAvatar* avatar : pending)
+    {
+        avatar->calcMutedAVColor();
+        gPipeline.generateImpostor(avatar);
+    }
+
     LLCharacter::sAllowInstancesChange = true;
 }
 
@@ -12063,14 +12229,111 @@ void LLVOAvatar::idleUpdateDebugInfo()
     }
 }
 
-void LLVOAvatar::updateVisualComplexity()
+void LLVOAvatar::updateVisualComplexity(LLViewerObject* changed_object)
 {
     LL_DEBUGS("AvatarRender") << "avatar " << getID() << " appearance changed" << LL_ENDL;
     // Set the cache time to in the past so it's updated ASAP
     mVisualComplexityStale = true;
+
+    if (!changed_object)
+    {
+        // unknown change, walk everything again
+        mAttachmentCosts.clear();
+        return;
+    }
+
+    attachment_cost_map_t::iterator it = mAttachmentCosts.find(changed_object->getRootEdit()->getID());
+    if (it != mAttachmentCosts.end())
+    {
+        it->second.mStale = true;
+    }
 }
 
 
+// Walk a single top-level object and its children for the costs that
+// accountRenderComplexityForObject() sums up. The result is kept until the
+// object reports a change through updateVisualComplexity().
+void LLVOAvatar::calculateAttachmentCost(LLViewerObject* attached_object,
+                                         LLVOVolume::texture_cost_t& textures,
+                                         AttachmentCost& entry)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_AVATAR;
+
+    entry = AttachmentCost();
+    entry.mSweep = mAttachmentCostSweep;
+    entry.mStale = false;
+
+    entry.mVisibleTriangleCount = attached_object->recursiveGetTriangleCount();
+    entry.mEstTriangleCount = attached_object->recursiveGetEstTrianglesMax();
+    entry.mSurfaceArea = attached_object->recursiveGetScaledSurfaceArea();
+
+    textures.clear();
+    const LLDrawable* drawable = attached_object->mDrawable;
+    if (!drawable)
+    {
+        // not set up yet, try again next time
+        entry.mStale = true;
+        return;
+    }
+
+    const LLVOVolume* volume = drawable->getVOVolume();
+    if (!volume)
+    {
+        return;
+    }
+
+    F32 attachment_total_cost = 0;
+    F32 attachment_volume_cost = 0;
+    F32 attachment_texture_cost = 0;
+    F32 attachment_children_cost = 0;
+    const F32 animated_object_attachment_surcharge = 1000;
+
+    if (volume->isAnimatedObjectFast())
+    {
+        attachment_volume_cost += animated_object_attachment_surcharge;
+    }
+    attachment_volume_cost += volume->getRenderCost(textures);
+
+    const_child_list_t children = volume->getChildren();
+    for (const_child_list_t::const_iterator child_iter = children.begin();
+        child_iter != children.end();
+        ++child_iter)
+    {
+        LLViewerObject* child_obj = *child_iter;
+        LLVOVolume* child = dynamic_cast<LLVOVolume*>(child_obj);
+        if (child)
+        {
+            attachment_children_cost += child->getRenderCost(textures);
+        }
+    }
+
+    for (LLVOVolume::texture_cost_t::iterator volume_texture = textures.begin();
+        volume_texture != textures.end();
+        ++volume_texture)
+    {
+        // add the cost of each individual texture in the linkset
+        attachment_texture_cost += LLVOVolume::getTextureCost(*volume_texture);
+
+        // texture cost depends on its full size, which isn't known until it starts loading
+        if ((*volume_texture)->getFullWidth() <= 0)
+        {
+            entry.mStale = true;
+        }
+    }
+    attachment_total_cost = attachment_volume_cost + attachment_texture_cost + attachment_children_cost;
+    LL_DEBUGS("ARCdetail") << "Attachment costs " << attached_object->getAttachmentItemID()
+        << " total: " << attachment_total_cost
+        << ", volume: " << attachment_volume_cost
+        << ", " << textures.size()
+        << " textures: " << attachment_texture_cost
+        << ", " << volume->numChildren()
+        << " children: " << attachment_children_cost
+        << LL_ENDL;
+
+    entry.mTotalCost = attachment_total_cost;
+    entry.mHasVolume = true;
+}
+
 // Account for the complexity of a single top-level object associated
 // with an avatar. This will be either an attached object or an animated
 // object.
@@ -12089,84 +12352,45 @@ void LLVOAvatar::accountRenderComplexityForObject(
     LL_PROFILE_ZONE_SCOPED_CATEGORY_AVATAR;
     if (attached_object && !attached_object->isHUDAttachment())
     {
-        mAttachmentVisibleTriangleCount += attached_object->recursiveGetTriangleCount();
-        mAttachmentEstTriangleCount += attached_object->recursiveGetEstTrianglesMax();
-        mAttachmentSurfaceArea += attached_object->recursiveGetScaledSurfaceArea();
-
-        textures.clear();
-        const LLDrawable* drawable = attached_object->mDrawable;
-        if (drawable)
+        AttachmentCost& entry = mAttachmentCosts[attached_object->getID()];
+        entry.mSweep = mAttachmentCostSweep;
+        if (entry.mStale)
         {
-            const LLVOVolume* volume = drawable->getVOVolume();
-            if (volume)
-            {
-                F32 attachment_total_cost = 0;
-                F32 attachment_volume_cost = 0;
-                F32 attachment_texture_cost = 0;
-                F32 attachment_children_cost = 0;
-                            const F32 animated_object_attachment_surcharge = 1000;
+            calculateAttachmentCost(attached_object, textures, entry);
+        }
 
-                if (volume->isAnimatedObjectFast())
-                {
-                    attachment_volume_cost += animated_object_attachment_surcharge;
-                }
-                attachment_volume_cost += volume->getRenderCost(textures);
+        mAttachmentVisibleTriangleCount += entry.mVisibleTriangleCount;
+        mAttachmentEstTriangleCount += entry.mEstTriangleCount;
+        mAttachmentSurfaceArea += entry.mSurfaceArea;
 
-                const_child_list_t children = volume->getChildren();
-                for (const_child_list_t::const_iterator child_iter = children.begin();
-                    child_iter != children.end();
-                    ++child_iter)
-                {
-                    LLViewerObject* child_obj = *child_iter;
-                    LLVOVolume* child = dynamic_cast<LLVOVolume*>(child_obj);
-                    if (child)
-                    {
-                        attachment_children_cost += child->getRenderCost(textures);
-                    }
-                }
+        if (entry.mHasVolume)
+        {
+            F32 attachment_total_cost = entry.mTotalCost;
+            // Limit attachment complexity to avoid signed integer flipping of the wearer's ACI
+            cost += (U32)llclamp(attachment_total_cost, MIN_ATTACHMENT_COMPLEXITY, max_attachment_complexity);
 
-                for (LLVOVolume::texture_cost_t::iterator volume_texture = textures.begin();
-                    volume_texture != textures.end();
-                    ++volume_texture)
-                {
-                    // add the cost of each individual texture in the linkset
-                    attachment_texture_cost += LLVOVolume::getTextureCost(*volume_texture);
-                }
-                attachment_total_cost = attachment_volume_cost + attachment_texture_cost + attachment_children_cost;
-                LL_DEBUGS("ARCdetail") << "Attachment costs " << attached_object->getAttachmentItemID()
-                    << " total: " << attachment_total_cost
-                    << ", volume: " << attachment_volume_cost
-                    << ", " << textures.size()
-                    << " textures: " << attachment_texture_cost
-                    << ", " << volume->numChildren()
-                    << " children: " << attachment_children_cost
-                    << LL_ENDL;
-                // Limit attachment complexity to avoid signed integer flipping of the wearer's ACI
-                cost += (U32)llclamp(attachment_total_cost, MIN_ATTACHMENT_COMPLEXITY, max_attachment_complexity);
+            if (isSelf())
+            {
+                LLObjectComplexity object_complexity;
+                object_complexity.objectName = attached_object->getAttachmentItemName();
+                object_complexity.objectId = attached_object->getAttachmentItemID();
+                object_complexity.objectCost = (U32)attachment_total_cost;
+                object_complexity_list.push_back(object_complexity);
+            }
 
-                if (isSelf())
+            // <FS:Ansariel> Show per-item complexity in COF
+            if (isSelf())
+            {
+                if (!attached_object->isTempAttachment())
                 {
-                    LLObjectComplexity object_complexity;
-                    object_complexity.objectName = attached_object->getAttachmentItemName();
-                    object_complexity.objectId = attached_object->getAttachmentItemID();
-                    object_complexity.objectCost = (U32)attachment_total_cost;
-                    object_complexity_list.push_back(object_complexity);
+                    item_complexity.insert(std::make_pair(attached_object->getAttachmentItemID(), (U32)attachment_total_cost));
                 }
-
-                // <FS:Ansariel> Show per-item complexity in COF
-                if (isSelf())
+                else
                 {
-                    if (!attached_object->isTempAttachment())
-                    {
-                        item_complexity.insert(std::make_pair(attached_object->getAttachmentItemID(), (U32)attachment_total_cost));
-                    }
-                    else
-                    {
-                        temp_item_complexity.insert(std::make_pair(attached_object->getID(), (U32)attachment_total_cost));
-                    }
+                    temp_item_complexity.insert(std::make_pair(attached_object->getID(), (U32)attachment_total_cost));
                 }
-                // </FS:Ansariel>
             }
+            // </FS:Ansariel>
         }
     }
     if (isSelf()
@@ -12310,6 +12534,7 @@ void LLVOAvatar::calculateUpdateRenderComplexity()
         mAttachmentVisibleTriangleCount = 0;
         mAttachmentEstTriangleCount = 0.f;
         mAttachmentSurfaceArea = 0.f;
+        ++mAttachmentCostSweep;
 
         // A standalone animated object needs to be accounted for
         // using its associated volume. Attached animated objects
@@ -12355,6 +12580,19 @@ void LLVOAvatar::calculateUpdateRenderComplexity()
             }
         }
 
+        // forget objects that have been detached since the last update
+        for (attachment_cost_map_t::iterator it = mAttachmentCosts.begin(); it != mAttachmentCosts.end();)
+        {
+            if (it->second.mSweep != mAttachmentCostSweep)
+            {
+                it = mAttachmentCosts.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
         if ( cost != mVisualComplexity )
         {
             LL_DEBUGS("AvatarRender") << "Avatar "<< getID()
@@ -12805,6 +13043,11 @@ F32 LLVOAvatar::getGPURenderTime()
     return isVisuallyMuted() ? 0.f : mGPURenderTime;
 }
 
+F32 LLVOAvatar::getGPUSceneTime()
+{
+    return isVisuallyMuted() ? 0.f : mGPUSceneTime;
+}
+
 // static
 F32 LLVOAvatar::getTotalGPURenderTime()
 {
@@ -285,6 +285,12 @@ public:
     void            updateTimeStep();
     void            updateRootPositionAndRotation(LLAgent &agent, F32 speed, bool was_sit_ground_constrained);
 
+    // Between these calls, updateCharacter() queues the joint world matrix updates of
+    // non-self avatars instead of running them; flushJointUpdates() runs the queue on
+    // the General thread pool. Joint getters still update lazily in between.
+    static void     beginJointUpdates();
+    static void     flushJointUpdates();
+
     void            idleUpdateVoiceVisualizer(bool voice_enabled, const LLVector3 &position);
     void            idleUpdateMisc(bool detailed_update);
     virtual void    idleUpdateAppearanceAnimation();
@@ -320,7 +326,9 @@ public:
                                                      // </FS:Ansariel>
     void            calculateUpdateRenderComplexity();
     static const U32 VISUAL_COMPLEXITY_UNKNOWN;
-    void            updateVisualComplexity();
+    // changed_object limits the recalculation to that object's linkset,
+    // NULL recalculates every attachment
+    void            updateVisualComplexity(LLViewerObject* changed_object = NULL);
 
     void placeProfileQuery();
     void readProfileQuery(S32 retries);
@@ -330,6 +338,10 @@ public:
     // or the avatar is visually muted
     F32             getGPURenderTime();
 
+    // get the GPU time in ms this avatar takes in the rendered frame, shadows included
+    // returns 0.f if the avatar is not being drawn or is visually muted
+    F32             getGPUSceneTime();
+
     // get the total GPU render time in ms of all avatars that have been benched
     static F32      getTotalGPURenderTime();
 
@@ -577,6 +589,7 @@ public:
 
 private:
     friend class LLPipeline;
+    friend class LLAvatarGPUTimer;
     AvatarOverallAppearance mOverallAppearance;
     F32         mAttachmentSurfaceArea; //estimated surface area of attachments
     U32         mAttachmentVisibleTriangleCount;
@@ -601,10 +614,33 @@ private:
     // CPU render time in ms
     F32 mCPURenderTime = 0.f;
 
+    // GPU time in ms of this avatar's draws in the rendered frame, averaged over recent
+    // frames, all passes and the shadow passes alone (see LLAvatarGPUTimer)
+    F32 mGPUSceneTime = 0.f;
+    F32 mGPUShadowTime = 0.f;
+
     // the isTooComplex method uses these mutable values to avoid recalculating too frequently
     // DEPRECATED -- obsolete avatar render cost values
     mutable U32  mVisualComplexity;
     mutable bool mVisualComplexityStale;
+
+    // per attachment costs kept between complexity updates, keyed by root object id
+    struct AttachmentCost
+    {
+        F32  mTotalCost = 0.f;
+        U32  mVisibleTriangleCount = 0;
+        F32  mEstTriangleCount = 0.f;
+        F32  mSurfaceArea = 0.f;
+        bool mHasVolume = false;
+        bool mStale = true;
+        U32  mSweep = 0;
+    };
+    typedef std::unordered_map<LLUUID, AttachmentCost> attachment_cost_map_t;
+    attachment_cost_map_t mAttachmentCosts;
+    U32          mAttachmentCostSweep;
+    void         calculateAttachmentCost(LLViewerObject* attached_object,
+                                         LLVOVolume::texture_cost_t& textures,
+                                         AttachmentCost& entry);
     U32          mReportedVisualComplexity; // from other viewers through the simulator
 
     mutable bool        mCachedInMuteList;
@@ -676,7 +712,8 @@ public:
     void        setImpostorDim(const LLVector2& dim);
     static void resetImpostors();
     static void updateImpostors();
-    LLRenderTarget mImpostor;
+    bool        hasImpostor() const { return mImpostorTile >= 0; }
+    S32         mImpostorTile; // tile in gPipeline.mImpostorAtlas, -1 if none
 // [RLVa:KB] - Checked: RLVa-2.4 (@setcam_avdist)
     mutable bool mNeedsImpostorUpdate;
 // [/RLVa:KB]
@@ -693,6 +730,7 @@ private:
     // idleUpdateMisc(). Not clear it serves any purpose.
     bool        mNeedsAnimUpdate;
     bool        mNeedsExtentUpdate;
+    bool        mJointUpdatePending;
     LLVector3   mImpostorAngle;
     F32         mImpostorDistance;
     F32         mImpostorPixelArea;
@@ -1005,6 +1043,23 @@ public:
     S32                                             mLastCloudAttachmentCount;
     LLFrameTimer                                    mLastCloudAttachmentChangeTime;
 
+private:
+    // Attached objects in attachment point order, rebuilt after attach/detach,
+    // so idleUpdateMisc() can update them in one pass and skip the ones whose
+    // attachment point hasn't moved since their last update.
+    struct AttachmentXform
+    {
+        LLMatrix4a                  mWorldMatrix;
+        LLPointer<LLViewerObject>   mObject;
+        LLViewerJointAttachment*    mAttachment = nullptr;
+        const LLDrawable*           mDrawable = nullptr; // identity only
+    };
+    std::vector<AttachmentXform>                    mAttachmentXforms;
+    bool                                            mAttachmentXformsDirty = true;
+    LLVector3                                       mAttachmentXformExtents[2];
+    void                rebuildAttachmentXforms();
+    void                updateAttachmentXforms(bool visible);
+
     //--------------------------------------------------------------------
     // HUD functions
     //--------------------------------------------------------------------
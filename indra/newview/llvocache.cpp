@@ -27,6 +27,7 @@
 #include "llviewerprecompiledheaders.h"
 #include "llvocache.h"
 #include "llregionhandle.h"
+#include "llmemtag.h"
 #include "llviewercontrol.h"
 #include "llviewerobjectlist.h"
 #include "lldrawable.h"
@@ -35,6 +36,9 @@
 #include "llsdserialize.h"
 #include "llagent.h" // <FS:Beq/> For gAgent
 #include "llworld.h" // For LLWorld::getInstance()
+#include "llmappedfile.h"
+#include "workqueue.h"
+#include "llslabpool.h"
 
 //static variables
 U32 LLVOCacheEntry::sMinFrameRange = 0;
@@ -57,6 +61,168 @@ bool check_write(LLAPRFile* apr_file, void* src, S32 n_bytes)
     return apr_file->write(src, n_bytes) == n_bytes ;
 }
 
+// A region's object cache in the mapped format (ObjectCacheMapped): a header, a
+// fixed size index of one record per object keyed by local ID, then the entry
+// bodies.  Reading a region only walks the index; bodies are copied out when an
+// entry is first used, and writing only touches records and bodies that changed.
+class LLVOCacheRegionFile
+{
+public:
+    static const U32 MAGIC = 0x4d434f56; // "VOCM"
+    static const U32 VERSION = 1;
+
+    struct Header
+    {
+        U32 mMagic;
+        U32 mVersion;
+        U8  mRegionID[UUID_BYTES];
+        U32 mRecordCount;   // index capacity
+        U32 mDataEnd;       // file offset past the last body
+        U32 mGarbage;       // body bytes no record points at anymore
+        U32 mPad;
+    };
+
+    struct Record
+    {
+        U32 mLocalID;       // 0 for a free record
+        U32 mCRC;
+        S32 mHitCount;
+        S32 mDupeCount;
+        S32 mCRCChangeCount;
+        U32 mOffset;
+        U32 mSize;
+        U32 mCapacity;      // space reserved at mOffset, a grown body moves to the end
+    };
+
+    bool open(const std::string& filename, const LLUUID& region_id)
+    {
+        if (!mFile.open(filename, 0))
+        {
+            return false;
+        }
+        Header* header = getHeader();
+        if (mFile.getSize() < sizeof(Header)
+            || header->mMagic != MAGIC
+            || header->mVersion != VERSION
+            || !isRegion(region_id)
+            || mFile.getSize() < getDataStart()
+            || header->mDataEnd < getDataStart()
+            || header->mDataEnd > mFile.getSize())
+        {
+            mFile.close();
+            return false;
+        }
+        return true;
+    }
+
+    bool create(const std::string& filename, const LLUUID& region_id, U32 records, U32 data_size)
+    {
+        size_t data_start = sizeof(Header) + records * sizeof(Record);
+        if (!mFile.open(filename, data_start + data_size))
+        {
+            return false;
+        }
+        memset(mFile.getData(), 0, data_start);
+        Header* header = getHeader();
+        header->mMagic = MAGIC;
+        header->mVersion = VERSION;
+        memcpy(header->mRegionID, region_id.mData, UUID_BYTES);
+        header->mRecordCount = records;
+        header->mDataEnd = (U32)data_start;
+        return true;
+    }
+
+    void close() { mFile.close(); }
+    bool isOpen() const { return mFile.isOpen(); }
+    void flush() { mFile.flush(); }
+    bool isRegion(const LLUUID& region_id) const { return memcmp(getHeader()->mRegionID, region_id.mData, UUID_BYTES) == 0; }
+
+    U32 getRecordCount() const { return getHeader()->mRecordCount; }
+    Record* getRecord(U32 index) const { return (Record*)(mFile.getData() + sizeof(Header)) + index; }
+
+    void setRecord(U32 index, U32 local_id, U32 crc, S32 hit_count, S32 dupe_count, S32 crc_change_count)
+    {
+        Record* record = getRecord(index);
+        record->mLocalID = local_id;
+        record->mCRC = crc;
+        record->mHitCount = hit_count;
+        record->mDupeCount = dupe_count;
+        record->mCRCChangeCount = crc_change_count;
+    }
+
+    // Body of the record at index if it still belongs to local_id, NULL otherwise
+    const U8* getBody(U32 index, U32 local_id, S32& size) const
+    {
+        if (!isOpen() || index >= getRecordCount())
+        {
+            return NULL;
+        }
+        const Record* record = getRecord(index);
+        if (record->mLocalID != local_id || !isValid(*record))
+        {
+            return NULL;
+        }
+        size = record->mSize;
+        return mFile.getData() + record->mOffset;
+    }
+
+    bool isValid(const Record& record) const
+    {
+        return record.mSize > 0 && record.mSize <= (U32)MAX_ENTRY_BODY_SIZE
+            && record.mSize <= record.mCapacity
+            && record.mOffset >= getDataStart()
+            && (U64)record.mOffset + record.mCapacity <= getHeader()->mDataEnd;
+    }
+
+    // Copies body into the record at index, moving it to the end of the file if
+    // it outgrew its space
+    bool writeBody(U32 index, const U8* body, U32 size)
+    {
+        Record* record = getRecord(index);
+        if (size > record->mCapacity)
+        {
+            Header* header = getHeader();
+            size_t end = header->mDataEnd;
+            if (end + size > mFile.getSize())
+            {
+                if (!mFile.resize(llmax(end + size, mFile.getSize() + mFile.getSize() / 4)))
+                {
+                    return false;
+                }
+                header = getHeader();
+                record = getRecord(index);
+            }
+            header->mGarbage += record->mCapacity;
+            header->mDataEnd = (U32)(end + size);
+            record->mOffset = (U32)end;
+            record->mCapacity = size;
+        }
+        memcpy(mFile.getData() + record->mOffset, body, size);
+        record->mSize = size;
+        return true;
+    }
+
+    void freeRecord(U32 index)
+    {
+        Record* record = getRecord(index);
+        getHeader()->mGarbage += record->mCapacity;
+        memset(record, 0, sizeof(Record));
+    }
+
+    // True once most of the body area is space no record uses
+    bool needsCompaction() const
+    {
+        const Header* header = getHeader();
+        return header->mGarbage > 65536 && header->mGarbage * 2 > header->mDataEnd - getDataStart();
+    }
+
+private:
+    Header* getHeader() const { return (Header*)mFile.getData(); }
+    size_t getDataStart() const { return sizeof(Header) + getRecordCount() * sizeof(Record); }
+
+    LLMappedFile mFile;
+};
+
 // Material Override Cache needs a version label, so we can upgrade this later.
 const std::string LLGLTFOverrideCacheEntry::VERSION_LABEL = {"GLTFCacheVer"};
 const int LLGLTFOverrideCacheEntry::VERSION = 1;
@@ -157,6 +323,27 @@ LLSD LLGLTFOverrideCacheEntry::toLLSD() const
 // LLVOCacheEntry
 //---------------------------------------------------------------------------
 
+static LLMemTag sCacheEntryMemTag("Object cache entries");
+
+// Never destroyed, entries may be released during static destruction
+static LLLockedSlabPool& get_entry_pool()
+{
+    static LLLockedSlabPool* pool = new LLLockedSlabPool(sizeof(LLVOCacheEntry), 1024, &sCacheEntryMemTag);
+    return *pool;
+}
+
+//static
+void* LLVOCacheEntry::operator new(size_t size)
+{
+    return get_entry_pool().allocate(size);
+}
+
+//static
+void LLVOCacheEntry::operator delete(void* ptr, size_t size)
+{
+    get_entry_pool().free(ptr, size);
+}
+
 LLVOCacheEntry::LLVOCacheEntry(U32 local_id, U32 crc, LLDataPackerBinaryBuffer &dp)
 :   LLViewerOctreeEntryData(LLViewerOctreeEntry::LLVOCACHEENTRY),
     mLocalID(local_id),
@@ -165,6 +352,8 @@ LLVOCacheEntry::LLVOCacheEntry(U32 local_id, U32 crc, LLDataPackerBinaryBuffer &
     mHitCount(0),
     mDupeCount(0),
     mCRCChangeCount(0),
+    mCacheRecord(0),
+    mBodyDirty(true),
     mState(INACTIVE),
     mSceneContrib(0.f),
     mValid(true),
@@ -174,6 +363,7 @@ LLVOCacheEntry::LLVOCacheEntry(U32 local_id, U32 crc, LLDataPackerBinaryBuffer &
     mBuffer = new U8[dp.getBufferSize()];
     mDP.assignBuffer(mBuffer, dp.getBufferSize());
     mDP = dp;
+    accountBuffer();
 }
 
 LLVOCacheEntry::LLVOCacheEntry()
@@ -185,6 +375,8 @@ LLVOCacheEntry::LLVOCacheEntry()
     mDupeCount(0),
     mCRCChangeCount(0),
     mBuffer(NULL),
+    mCacheRecord(0),
+    mBodyDirty(true),
     mState(INACTIVE),
     mSceneContrib(0.f),
     mValid(true),
@@ -197,6 +389,8 @@ LLVOCacheEntry::LLVOCacheEntry()
 LLVOCacheEntry::LLVOCacheEntry(LLAPRFile* apr_file)
 :   LLViewerOctreeEntryData(LLViewerOctreeEntry::LLVOCACHEENTRY),
     mBuffer(NULL),
+    mCacheRecord(0),
+    mBodyDirty(true),
     mUpdateFlags(-1),
     mState(INACTIVE),
     mSceneContrib(0.f),
@@ -206,7 +400,7 @@ LLVOCacheEntry::LLVOCacheEntry(LLAPRFile* apr_file)
 {
     S32 size = -1;
     bool success;
-    static U8 data_buffer[ENTRY_HEADER_SIZE];
+    U8 data_buffer[ENTRY_HEADER_SIZE]; // prefetches read entries on the General pool
 
     mDP.assignBuffer(mBuffer, 0);
 
@@ -259,11 +453,21 @@ LLVOCacheEntry::LLVOCacheEntry(LLAPRFile* apr_file)
         mEntry = NULL;
         mState = INACTIVE;
     }
+    accountBuffer();
 }
 
 LLVOCacheEntry::~LLVOCacheEntry()
 {
     mDP.freeBuffer();
+    accountBuffer();
+}
+
+static LLMemTag sObjectCacheMemTag("Object cache");
+
+void LLVOCacheEntry::accountBuffer()
+{
+    sObjectCacheMemTag.claim(mDP.getBufferSize() - mAccountedBytes);
+    mAccountedBytes = mDP.getBufferSize();
 }
 
 void LLVOCacheEntry::updateEntry(U32 crc, LLDataPackerBinaryBuffer &dp)
@@ -280,6 +484,8 @@ void LLVOCacheEntry::updateEntry(U32 crc, LLDataPackerBinaryBuffer &dp)
     mBuffer = new U8[dp.getBufferSize()];
     mDP.assignBuffer(mBuffer, dp.getBufferSize());
     mDP = dp;
+    mBodyDirty = true;
+    accountBuffer();
 }
 
 void LLVOCacheEntry::setParentID(U32 id)
@@ -310,7 +516,7 @@ void LLVOCacheEntry::removeAllChildren()
 //virtual
 void LLVOCacheEntry::setOctreeEntry(LLViewerOctreeEntry* entry)
 {
-    if(!entry && mDP.getBufferSize() > 0)
+    if(!entry && getDP())
     {
         LLUUID fullid;
         LLViewerObject::unpackUUID(&mDP, fullid, "ID");
@@ -407,6 +613,11 @@ LLVOCacheEntry* LLVOCacheEntry::getChild()
 
 LLDataPackerBinaryBuffer *LLVOCacheEntry::getDP()
 {
+    if (mDP.getBufferSize() == 0 && mCacheFile)
+    {
+        loadBody();
+    }
+
     if (mDP.getBufferSize() == 0)
     {
         //LL_INFOS() << "Not getting cache entry, invalid!" << LL_ENDL;
@@ -416,6 +627,25 @@ LLDataPackerBinaryBuffer *LLVOCacheEntry::getDP()
     return &mDP;
 }
 
+//copy the body out of the mapped cache file on first use
+void LLVOCacheEntry::loadBody()
+{
+    S32 size = 0;
+    const U8* body = mCacheFile->getBody(mCacheRecord, mLocalID, size);
+    if (!body)
+    {
+        LL_WARNS() << "Lost cache entry body for " << mLocalID << LL_ENDL;
+        mCacheFile.reset();
+        return;
+    }
+
+    mBuffer = new U8[size];
+    memcpy(mBuffer, body, size);
+    mDP.assignBuffer(mBuffer, size);
+    mBodyDirty = false;
+    accountBuffer();
+}
+
 void LLVOCacheEntry::recordHit()
 {
     mHitCount++;
@@ -1033,6 +1263,10 @@ S32 LLVOCachePartition::cull(LLCamera &camera, bool do_occlusion)
     {
         return 0;
     }
+    if(mRegionp->isProxied())
+    {
+        return 0; //objects of the region stay in the cache
+    }
 
     ((LLViewerOctreeGroup*)mOctree->getListener(0))->rebound();
 
@@ -1164,6 +1398,7 @@ void LLVOCachePartition::removeOccluder(LLVOCacheGroup* group)
 // Format strings used to construct filename for the object cache
 static const char OBJECT_CACHE_FILENAME[] = "objects_%d_%d.slc";
 static const char OBJECT_CACHE_EXTRAS_FILENAME[] = "objects_%d_%d_extras.slec";
+static const char OBJECT_CACHE_MAPPED_FILENAME[] = "objects_%d_%d.slm";
 
 const U32 MAX_NUM_OBJECT_ENTRIES = 128 ;
 const U32 MIN_ENTRIES_TO_PURGE = 16 ;
@@ -1175,12 +1410,15 @@ const char* header_filename = "object.cache";
 LLVOCache::LLVOCache(bool read_only) :
     mInitialized(false),
     mReadOnly(read_only),
+    mMapped(false),
     mNumEntries(0),
     mCacheSize(1),
     mEnabled(true)
 {
 #ifndef LL_TEST
     mEnabled = gSavedSettings.getBOOL("ObjectCacheEnabled");
+    // read-only caches keep to the legacy files, a mapping would write through
+    mMapped = !read_only && gSavedSettings.getBOOL("ObjectCacheMapped");
 #endif
     mLocalAPRFilePoolp = new LLVolatileAPRPool() ;
 }
@@ -1268,6 +1506,8 @@ void LLVOCache::removeCache(ELLPath location, bool started)
 
     LL_INFOS() << "about to remove the object cache due to settings." << LL_ENDL ;
 
+    closeAllMappedCaches();
+
     std::string mask = "*";
     std::string cache_dir = gDirUtilp->getExpandedFilename(location, object_cache_dirname);
     LL_INFOS() << "Removing cache at " << cache_dir << LL_ENDL;
@@ -1292,6 +1532,8 @@ void LLVOCache::removeCache()
         return ;
     }
 
+    closeAllMappedCaches();
+
     std::string mask = "*";
     LL_INFOS() << "Removing object cache at " << mObjectCacheDirName << LL_ENDL;
     gDirUtilp->deleteFilesInDir(mObjectCacheDirName, mask);
@@ -1358,6 +1600,7 @@ void LLVOCache::clearCacheInMemory()
         mHandleEntryMap.clear();
         mNumEntries = 0 ;
     }
+    mPrefetched.clear();
 
 }
 
@@ -1381,6 +1624,38 @@ std::string LLVOCache::getObjectCacheExtrasFilename(U64 handle)
                llformat(OBJECT_CACHE_EXTRAS_FILENAME, region_x, region_y));
 }
 
+std::string LLVOCache::getObjectCacheMappedFilename(U64 handle)
+{
+    U32 region_x, region_y;
+
+    grid_from_region_handle(handle, &region_x, &region_y);
+    return gDirUtilp->getExpandedFilename(LL_PATH_CACHE, object_cache_dirname,
+               llformat(OBJECT_CACHE_MAPPED_FILENAME, region_x, region_y));
+}
+
+// Entries still holding a closed file just can't load their bodies anymore
+void LLVOCache::closeMappedCache(U64 handle)
+{
+    auto iter = mMappedFiles.find(handle);
+    if (iter != mMappedFiles.end())
+    {
+        std::shared_ptr<LLVOCacheRegionFile> file = iter->second.lock();
+        if (file)
+        {
+            file->close();
+        }
+        mMappedFiles.erase(iter);
+    }
+}
+
+void LLVOCache::closeAllMappedCaches()
+{
+    while (!mMappedFiles.empty())
+    {
+        closeMappedCache(mMappedFiles.begin()->first);
+    }
+}
+
 void LLVOCache::removeFromCache(HeaderEntryInfo* entry)
 {
     if(mReadOnly)
@@ -1394,6 +1669,10 @@ void LLVOCache::removeFromCache(HeaderEntryInfo* entry)
     LL_WARNS("GLTF", "VOCache") << "Removing object cache for handle " << entry->mHandle << "Filename: " << filename << LL_ENDL;
     LLAPRFile::remove(filename, mLocalAPRFilePoolp);
 
+    closeMappedCache(entry->mHandle);
+    LLFile::remove(getObjectCacheMappedFilename(entry->mHandle), ENOENT);
+    mPrefetched.erase(entry->mHandle);
+
     // Note: `removeFromCache` should take responsibility for cleaning up all cache artefacts specfic to the handle/entry.
     // as such this now includes the generic extras
     filename = getObjectCacheExtrasFilename(entry->mHandle);
@@ -1551,6 +1830,106 @@ bool LLVOCache::updateEntry(const HeaderEntryInfo* entry)
 
 // we now return bool to trigger dirty cache
 // this in turn forces a rewrite after a partial read due to corruption.
+// Reads a legacy region object cache file.  Prefetches run this on the General
+// pool with a NULL pool, the global APR file pool is the thread safe one.
+static bool read_objects_file(const std::string& filename, LLUUID& cache_id, LLVOCacheEntry::vocache_entry_map_t& cache_entry_map, LLVolatileAPRPool* pool)
+{
+    LLAPRFile apr_file(filename, APR_READ|APR_BINARY, pool);
+
+    S32 num_entries = 0;
+    if (!check_read(&apr_file, cache_id.mData, UUID_BYTES)
+        || !check_read(&apr_file, &num_entries, sizeof(S32)))
+    {
+        return false;
+    }
+
+    for (S32 i = 0; i < num_entries && apr_file.eof() != APR_EOF; i++)
+    {
+        LLPointer<LLVOCacheEntry> entry = new LLVOCacheEntry(&apr_file);
+        if (!entry->getLocalID())
+        {
+            LL_WARNS() << "Aborting cache file load for " << filename << ", cache file corruption!" << LL_ENDL;
+            return false;
+        }
+        cache_entry_map[entry->getLocalID()] = entry;
+    }
+    return true;
+}
+
+// Reads a region's GLTF override cache file, false if it is unusable and
+// should be removed.  Entries read before a failure are kept.  Also runs on
+// the General pool for prefetches.
+static bool read_extras_file(const std::string& filename, LLUUID& cache_id, std::vector<LLGLTFOverrideCacheEntry>& entries)
+{
+    llifstream in(filename, std::ios::in | std::ios::binary);
+
+    std::string line;
+    std::getline(in, line);
+    if(!in.good())
+    {
+        return false;
+    }
+    // file formats need versions, let's add one. legacy cache files will be considered version 0
+    // This will make it easier to upgrade/revise later.
+    int versionNumber=0;
+    if (line.compare(0, LLGLTFOverrideCacheEntry::VERSION_LABEL.length(), LLGLTFOverrideCacheEntry::VERSION_LABEL) == 0)
+    {
+        std::string versionStr = line.substr(LLGLTFOverrideCacheEntry::VERSION_LABEL.length()+1); // skip the version label and ':'
+        versionNumber = std::stol(versionStr);
+    }
+    // For future versions we may call a legacy handler here, but realistically we'll just consider this cache out of date.
+    // The important thing is to make sure it gets removed.
+    if(versionNumber != LLGLTFOverrideCacheEntry::VERSION)
+    {
+        LL_WARNS() << "Unexpected version number " << versionNumber << " for extras cache " << filename << LL_ENDL;
+        return false;
+    }
+
+    std::getline(in, line);
+    if(!LLUUID::validate(line))
+    {
+        LL_WARNS() << "Failed reading extras cache " << filename << ". invalid uuid line: '" << line << "'" << LL_ENDL;
+        return false;
+    }
+    cache_id.set(line);
+
+    U32 num_entries;  // if removal was enabled during write num_entries might be wrong
+    std::getline(in, line);
+    if(!in.good())
+    {
+        return false;
+    }
+    try
+    {
+        num_entries = std::stol(line);
+    }
+    catch(std::logic_error&)  // either invalid_argument or out_of_range
+    {
+        LL_WARNS() << "Failed reading extras cache " << filename << ". unreadable num_entries" << LL_ENDL;
+        return false;
+    }
+
+    LLSD entry_llsd;
+	LL_PROFILE_ZONE_NUM(num_entries);
+    for (U32 i = 0; i < num_entries && !in.eof(); i++)
+    {
+		LL_PROFILE_ZONE_NAMED_CATEGORY_NETWORK("RegionExtrasReadEntries");
+        static const U32 max_size = 4096;
+        bool success = LLSDSerialize::deserialize(entry_llsd, in, max_size);
+        // check bool(in) this time since eof is not a failure condition here
+        if(!success || !in)
+        {
+            LL_WARNS() << "Failed reading extras cache " << filename << ", entry number " << i << " cache patrtial load only." << LL_ENDL;
+            return false;
+        }
+
+        entries.emplace_back();
+        entries.back().fromLLSD(entry_llsd);
+        entries.back().mLocalId = entry_llsd["local_id"].asInteger();
+    }
+    return true;
+}
+
 bool LLVOCache::readFromCache(U64 handle, const LLUUID& id, LLVOCacheEntry::vocache_entry_map_t& cache_entry_map)
 {
 	LL_PROFILE_ZONE_SCOPED_CATEGORY_NETWORK;
@@ -1568,46 +1947,39 @@ bool LLVOCache::readFromCache(U64 handle, const LLUUID& id, LLVOCacheEntry::voca
         return false; // arguably no a problem, but we'll mark this as dirty anyway.
     }
 
-    bool success = true ;
-    S32 num_entries = 0 ; // lifted out of inner loop.
-    std::string filename; // lifted out of loop
+    // without a mapped cache yet, fall back to the legacy file, the next write converts it
+    if (mMapped && LLFile::isfile(getObjectCacheMappedFilename(handle)))
     {
-		LL_PROFILE_ZONE_NAMED_CATEGORY_NETWORK("VOCache:loadRegionObjectCache");        
-        LLUUID cache_id;
-        getObjectCacheFilename(handle, filename);
-        LLAPRFile apr_file(filename, APR_READ|APR_BINARY, mLocalAPRFilePoolp);
-
-        success = check_read(&apr_file, cache_id.mData, UUID_BYTES);
-
-        if(success)
+        bool success = readFromMappedCache(handle, id, cache_entry_map);
+        if (!success && cache_entry_map.empty())
         {
-            LL_PROFILE_ZONE_NAMED_CATEGORY_NETWORK("VOCache:loadCacheForRegion");
-            if(cache_id != id)
-            {
-                LL_INFOS() << "Cache ID doesn't match for this region, discarding"<< LL_ENDL;
-                success = false ;
-            }
+            removeEntry(iter->second);
+        }
+        return success;
+    }
 
-            if(success)
-            {
-                success = check_read(&apr_file, &num_entries, sizeof(S32)) ;
+    bool success = true ;
+    LLUUID cache_id;
+    std::string filename;
+    getObjectCacheFilename(handle, filename);
+    std::shared_ptr<PrefetchedRegion> prefetched = getPrefetched(handle);
+    if (prefetched && !prefetched->mMapped)
+    {
+        success = prefetched->mObjectsSuccess;
+        cache_id = prefetched->mObjectsID;
+        cache_entry_map.swap(prefetched->mEntries);
+    }
+    else
+    {
+        LL_PROFILE_ZONE_NAMED_CATEGORY_NETWORK("VOCache:loadRegionObjectCache");
+        success = read_objects_file(filename, cache_id, cache_entry_map, mLocalAPRFilePoolp);
+    }
 
-                if(success)
-                {
-                    for (S32 i = 0; i < num_entries && apr_file.eof() != APR_EOF; i++)
-                    {
-                        LLPointer<LLVOCacheEntry> entry = new LLVOCacheEntry(&apr_file);
-                        if (!entry->getLocalID())
-                        {
-                            LL_WARNS() << "Aborting cache file load for " << filename << ", cache file corruption!" << LL_ENDL;
-                            success = false ;
-                            break ;
-                        }
-                        cache_entry_map[entry->getLocalID()] = entry;
-                    }
-                }
-            }
-        }
+    if(cache_id.notNull() && cache_id != id)
+    {
+        LL_INFOS() << "Cache ID doesn't match for this region, discarding"<< LL_ENDL;
+        cache_entry_map.clear();
+        success = false ;
     }
 
     if(!success)
@@ -1618,7 +1990,7 @@ bool LLVOCache::readFromCache(U64 handle, const LLUUID& id, LLVOCacheEntry::voca
         }
     }
 
-    LL_DEBUGS("GLTF", "VOCache") << "Read " << cache_entry_map.size() << " entries from object cache " << filename << ", expected " << num_entries << ", success=" << (success?"True":"False") << LL_ENDL;
+    LL_DEBUGS("GLTF", "VOCache") << "Read " << cache_entry_map.size() << " entries from object cache " << filename << (prefetched ? " (prefetched)" : "") << ", success=" << (success?"True":"False") << LL_ENDL;
     return success;
 }
 
@@ -1652,97 +2024,39 @@ void LLVOCache::readGenericExtrasFromCache(U64 handle, const LLUUID& id, LLVOCac
 	LL_PROFILE_ZONE_TEXT(extra_filename,256);
 	#endif
     // </FS:Beq>
-    llifstream in(filename, std::ios::in | std::ios::binary);
 
-    std::string line;
-    std::getline(in, line);
-    if(!in.good())
-    {
-        LL_WARNS() << "Failed reading extras cache for handle " << handle << LL_ENDL;
-        in.close();
-        removeGenericExtrasForHandle(handle);
-        return;
-    }
-    // file formats need versions, let's add one. legacy cache files will be considered version 0
-    // This will make it easier to upgrade/revise later.
-    int versionNumber=0;
-    if (line.compare(0, LLGLTFOverrideCacheEntry::VERSION_LABEL.length(), LLGLTFOverrideCacheEntry::VERSION_LABEL) == 0)
+    LLUUID cache_id;
+    std::vector<LLGLTFOverrideCacheEntry> entries;
+    bool success;
+    std::shared_ptr<PrefetchedRegion> prefetched = getPrefetched(handle);
+    mPrefetched.erase(handle);
+    if (prefetched)
     {
-        std::string versionStr = line.substr(LLGLTFOverrideCacheEntry::VERSION_LABEL.length()+1); // skip the version label and ':'
-        versionNumber = std::stol(versionStr);
+        success = prefetched->mExtrasSuccess;
+        cache_id = prefetched->mExtrasID;
+        entries.swap(prefetched->mExtras);
     }
-    // For future versions we may call a legacy handler here, but realistically we'll just consider this cache out of date.
-    // The important thing is to make sure it gets removed.
-    if(versionNumber != LLGLTFOverrideCacheEntry::VERSION)
-    {
-        LL_WARNS() << "Unexpected version number " << versionNumber << " for extras cache for handle " << handle << LL_ENDL;
-        in.close();
-        removeGenericExtrasForHandle(handle);
-        return;
-    }
-
-    LL_DEBUGS("VOCache") << "Reading extras cache for handle " << handle << ", version " << versionNumber << LL_ENDL;
-    std::getline(in, line);
-    if(!LLUUID::validate(line))
+    else
     {
-        LL_WARNS() << "Failed reading extras cache for handle" << handle << ". invalid uuid line: '" << line << "'" << LL_ENDL;
-        in.close();
-        removeGenericExtrasForHandle(handle);
-        return;
+        success = read_extras_file(filename, cache_id, entries);
     }
 
-    LLUUID cache_id(line);
-    if(cache_id != id)
+    if (cache_id.notNull() && cache_id != id)
     {
         // if the cache id doesn't match the expected region we should just kill the file.
         LL_WARNS() << "Cache ID doesn't match for this region, deleting it" << LL_ENDL;
-        in.close();
-        removeGenericExtrasForHandle(handle);
-        return;
-    }
-
-    U32 num_entries;  // if removal was enabled during write num_entries might be wrong
-    std::getline(in, line);
-    if(!in.good())
-    {
-        LL_WARNS() << "Failed reading extras cache for handle " << handle << LL_ENDL;
-        in.close();
         removeGenericExtrasForHandle(handle);
         return;
     }
-    try
-    {
-        num_entries = std::stol(line);
-    }
-    catch(std::logic_error&)  // either invalid_argument or out_of_range
+    if (!success)
     {
-        LL_WARNS() << "Failed reading extras cache for handle " << handle << ". unreadable num_entries" << LL_ENDL;
-        in.close();
+        LL_WARNS() << "Failed reading extras cache for handle " << handle << ", " << entries.size() << " entries read" << LL_ENDL;
         removeGenericExtrasForHandle(handle);
-        return;
     }
 
-    LL_DEBUGS("GLTF") << "Beginning reading extras cache for handle " << handle << " from " << getObjectCacheExtrasFilename(handle) << LL_ENDL;
-
-    LLSD entry_llsd;
-	LL_PROFILE_ZONE_NUM(num_entries);
-    for (U32 i = 0; i < num_entries && !in.eof(); i++)
+    for (LLGLTFOverrideCacheEntry& entry : entries)
     {
-		LL_PROFILE_ZONE_NAMED_CATEGORY_NETWORK("RegionExtrasReadEntries");
-        static const U32 max_size = 4096;
-        bool success = LLSDSerialize::deserialize(entry_llsd, in, max_size);
-        // check bool(in) this time since eof is not a failure condition here
-        if(!success || !in)
-        {
-            LL_WARNS() << "Failed reading extras cache for handle " << handle << ", entry number " << i << " cache patrtial load only." << LL_ENDL;
-            in.close();
-            removeGenericExtrasForHandle(handle);
-            break;
-        }
-
-        LLGLTFOverrideCacheEntry entry;
-        entry.fromLLSD(entry_llsd);
-        U32 local_id = entry_llsd["local_id"].asInteger();
+        U32 local_id = entry.mLocalId;
         // only add entries that exist in the primary cache
         // this is a self-healing test that avoids us polluting the cache with entries that are no longer valid based on the main cache.
         if(cache_entry_map.find(local_id)!= cache_entry_map.end())
@@ -1752,7 +2066,7 @@ void LLVOCache::readGenericExtrasFromCache(U64 handle, const LLUUID& id, LLVOCac
             {
                 gObjectList.getUUIDFromLocal( entry.mObjectId, local_id, pRegion->getHost().getAddress(), pRegion->getHost().getPort() );
             }
-            cache_extras_entry_map[local_id] = entry;
+            cache_extras_entry_map[local_id] = std::move(entry);
             loaded++;
         }
         else
@@ -1760,7 +2074,85 @@ void LLVOCache::readGenericExtrasFromCache(U64 handle, const LLUUID& id, LLVOCac
             discarded++;
         }
     }
-    LL_DEBUGS("GLTF") << "Completed reading extras cache for handle " << handle << ", " << loaded << " loaded, " << discarded << " discarded" << LL_ENDL;
+    LL_DEBUGS("GLTF") << "Completed reading extras cache for handle " << handle << (prefetched ? " (prefetched)" : "") << ", " << loaded << " loaded, " << discarded << " discarded" << LL_ENDL;
+}
+
+void LLVOCache::prefetch(U64 handle)
+{
+    static LLCachedControl<bool> prefetch_enabled(gSavedSettings, "ObjectCachePrefetch", true);
+    if (!mEnabled || !mInitialized || !prefetch_enabled
+        || mHandleEntryMap.find(handle) == mHandleEntryMap.end()
+        || mPrefetched.find(handle) != mPrefetched.end())
+    {
+        return;
+    }
+
+    LL::WorkQueue::ptr_t general_queue = LL::WorkQueue::getInstance("General");
+    if (!general_queue)
+    {
+        return;
+    }
+
+    // forget prefetches of regions that went away before their handshake
+    for (auto iter = mPrefetched.begin(); iter != mPrefetched.end();)
+    {
+        if (!LLWorld::getInstance()->getRegionFromHandle(iter->first))
+        {
+            iter = mPrefetched.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+
+    auto prefetched = std::make_shared<PrefetchedRegion>();
+    std::string objects_filename;
+    getObjectCacheFilename(handle, objects_filename);
+    std::string mapped_filename = mMapped ? getObjectCacheMappedFilename(handle) : std::string();
+    std::string extras_filename = getObjectCacheExtrasFilename(handle);
+
+    if (general_queue->post([prefetched, objects_filename, mapped_filename, extras_filename]()
+        {
+            LL_PROFILE_ZONE_NAMED_CATEGORY_NETWORK("VOCache:prefetch");
+            if (!mapped_filename.empty() && LLFile::isfile(mapped_filename))
+            {
+                // the mapped index is cheap to walk, only get the file into the OS cache
+                llifstream in(mapped_filename, std::ios::in | std::ios::binary);
+                static thread_local char buffer[65536];
+                while (in.read(buffer, sizeof(buffer)))
+                {
+                }
+                prefetched->mMapped = true;
+            }
+            else
+            {
+                prefetched->mObjectsSuccess = read_objects_file(objects_filename, prefetched->mObjectsID, prefetched->mEntries, NULL);
+            }
+            prefetched->mExtrasSuccess = read_extras_file(extras_filename, prefetched->mExtrasID, prefetched->mExtras);
+            prefetched->mDone.store(true, std::memory_order_release);
+        }))
+    {
+        mPrefetched[handle] = prefetched;
+    }
+}
+
+std::shared_ptr<LLVOCache::PrefetchedRegion> LLVOCache::getPrefetched(U64 handle)
+{
+    auto iter = mPrefetched.find(handle);
+    if (iter == mPrefetched.end())
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<PrefetchedRegion> prefetched = iter->second;
+    if (!prefetched->mDone.load(std::memory_order_acquire))
+    {
+        // still in the queue or being read, reading the files here beats waiting for it
+        mPrefetched.erase(iter);
+        return nullptr;
+    }
+    return prefetched;
 }
 
 void LLVOCache::purgeEntries(U32 size)
@@ -1796,6 +2188,7 @@ void LLVOCache::writeToCache(U64 handle, const LLUUID& id, const LLVOCacheEntry:
         LL_WARNS() << "Not writing cache for " << filename << " (handle:" << handle << "): Cache is currently in read-only mode." << LL_ENDL;
         return ;
     }
+    mPrefetched.erase(handle);
 
     HeaderEntryInfo* entry;
     handle_entry_map_t::iterator iter = mHandleEntryMap.find(handle) ;
@@ -1838,6 +2231,15 @@ void LLVOCache::writeToCache(U64 handle, const LLUUID& id, const LLVOCacheEntry:
         return ; //nothing changed, no need to update.
     }
 
+    if (mMapped)
+    {
+        if (!writeToMappedCache(handle, id, cache_entry_map, removal_enabled))
+        {
+            removeEntry(entry);
+        }
+        return;
+    }
+
     //write to cache file
     bool success = true ;
     {
@@ -1912,6 +2314,219 @@ void LLVOCache::writeToCache(U64 handle, const LLUUID& id, const LLVOCacheEntry:
     return ;
 }
 
+bool LLVOCache::readFromMappedCache(U64 handle, const LLUUID& id, LLVOCacheEntry::vocache_entry_map_t& cache_entry_map)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_NETWORK;
+    std::string filename = getObjectCacheMappedFilename(handle);
+
+    std::shared_ptr<LLVOCacheRegionFile> file = mMappedFiles[handle].lock();
+    if (!file || !file->isOpen() || !file->isRegion(id))
+    {
+        file = std::make_shared<LLVOCacheRegionFile>();
+        if (!file->open(filename, id))
+        {
+            LL_INFOS() << "Mapped cache " << filename << " doesn't match this region, discarding" << LL_ENDL;
+            mMappedFiles.erase(handle);
+            return false;
+        }
+        mMappedFiles[handle] = file;
+    }
+
+    // only the index is read here, entry bodies stay in the file until first used
+    bool success = true;
+    U32 num_records = file->getRecordCount();
+    for (U32 i = 0; i < num_records; i++)
+    {
+        const LLVOCacheRegionFile::Record* record = file->getRecord(i);
+        if (!record->mLocalID)
+        {
+            continue;
+        }
+        if (!file->isValid(*record))
+        {
+            LL_WARNS() << "Skipping corrupt record " << i << " in " << filename << LL_ENDL;
+            success = false;
+            continue;
+        }
+
+        LLPointer<LLVOCacheEntry> entry = new LLVOCacheEntry();
+        entry->mLocalID = record->mLocalID;
+        entry->mCRC = record->mCRC;
+        entry->mHitCount = record->mHitCount;
+        entry->mDupeCount = record->mDupeCount;
+        entry->mCRCChangeCount = record->mCRCChangeCount;
+        entry->mValid = false;
+        entry->mCacheFile = file;
+        entry->mCacheRecord = i;
+        entry->mBodyDirty = false;
+        cache_entry_map[entry->mLocalID] = entry;
+    }
+
+    LL_DEBUGS("VOCache") << "Read " << cache_entry_map.size() << " entries from mapped object cache " << filename << ", success=" << (success ? "True" : "False") << LL_ENDL;
+    return success;
+}
+
+// Writes only what changed: counters are updated in place, changed bodies are
+// rewritten where they fit and appended where they don't, and records of
+// entries that are gone are freed for reuse.  The file is rebuilt when it
+// runs out of records or is mostly dead space.
+bool LLVOCache::writeToMappedCache(U64 handle, const LLUUID& id, const LLVOCacheEntry::vocache_entry_map_t& cache_entry_map, bool removal_enabled)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_NETWORK;
+    std::shared_ptr<LLVOCacheRegionFile> file = mMappedFiles[handle].lock();
+    if (!file || !file->isOpen() || !file->isRegion(id) || file->needsCompaction())
+    {
+        return rewriteMappedCache(handle, id, cache_entry_map, removal_enabled);
+    }
+
+    auto keep = [&file, removal_enabled](LLVOCacheEntry* entry)
+    {
+        if (removal_enabled && !entry->isValid())
+        {
+            return false;
+        }
+        if (entry->mCacheFile == file && !entry->mBodyDirty)
+        {
+            return true; // unchanged body already in the file
+        }
+        LLDataPackerBinaryBuffer* dp = entry->getDP();
+        return dp && dp->getBufferSize() <= MAX_ENTRY_BODY_SIZE;
+    };
+
+    U32 num_records = file->getRecordCount();
+    std::vector<bool> referenced(num_records, false);
+    U32 new_entries = 0;
+    for (LLVOCacheEntry::vocache_entry_map_t::const_iterator iter = cache_entry_map.begin(); iter != cache_entry_map.end(); ++iter)
+    {
+        LLVOCacheEntry* entry = iter->second;
+        if (!keep(entry))
+        {
+            continue;
+        }
+        if (entry->mCacheFile == file)
+        {
+            referenced[entry->mCacheRecord] = true;
+        }
+        else
+        {
+            new_entries++;
+        }
+    }
+    if (new_entries > (U32)std::count(referenced.begin(), referenced.end(), false))
+    {
+        return rewriteMappedCache(handle, id, cache_entry_map, removal_enabled);
+    }
+
+    U32 next_free = 0;
+    for (LLVOCacheEntry::vocache_entry_map_t::const_iterator iter = cache_entry_map.begin(); iter != cache_entry_map.end(); ++iter)
+    {
+        LLVOCacheEntry* entry = iter->second;
+        if (!keep(entry))
+        {
+            if (entry->mCacheFile == file)
+            {
+                entry->mCacheFile.reset(); // its record is freed below
+            }
+            continue;
+        }
+
+        if (entry->mCacheFile != file)
+        {
+            while (referenced[next_free])
+            {
+                next_free++;
+            }
+            referenced[next_free] = true;
+            file->freeRecord(next_free); // may still hold an entry that was dropped since
+            entry->mCacheFile = file;
+            entry->mCacheRecord = next_free;
+            entry->mBodyDirty = true;
+        }
+
+        file->setRecord(entry->mCacheRecord, entry->mLocalID, entry->mCRC, entry->mHitCount, entry->mDupeCount, entry->mCRCChangeCount);
+        if (entry->mBodyDirty)
+        {
+            LLDataPackerBinaryBuffer* dp = entry->getDP();
+            if (!file->writeBody(entry->mCacheRecord, dp->getBuffer(), dp->getBufferSize()))
+            {
+                LL_WARNS() << "Failed to write cache entry " << entry->mLocalID << " to " << getObjectCacheMappedFilename(handle) << LL_ENDL;
+                return false;
+            }
+            entry->mBodyDirty = false;
+        }
+    }
+
+    for (U32 i = 0; i < num_records; i++)
+    {
+        if (!referenced[i] && file->getRecord(i)->mLocalID)
+        {
+            file->freeRecord(i);
+        }
+    }
+    file->flush();
+
+    LL_DEBUGS("VOCache") << "Updated " << cache_entry_map.size() << " entries, " << new_entries << " new, in mapped object cache " << getObjectCacheMappedFilename(handle) << LL_ENDL;
+    return true;
+}
+
+bool LLVOCache::rewriteMappedCache(U64 handle, const LLUUID& id, const LLVOCacheEntry::vocache_entry_map_t& cache_entry_map, bool removal_enabled)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_NETWORK;
+    std::string filename = getObjectCacheMappedFilename(handle);
+
+    // bodies still in the old file have to be read before it goes away
+    std::vector<LLVOCacheEntry*> entries;
+    U32 data_size = 0;
+    for (LLVOCacheEntry::vocache_entry_map_t::const_iterator iter = cache_entry_map.begin(); iter != cache_entry_map.end(); ++iter)
+    {
+        LLVOCacheEntry* entry = iter->second;
+        LLDataPackerBinaryBuffer* dp = (removal_enabled && !entry->isValid()) ? NULL : entry->getDP();
+        if (dp && dp->getBufferSize() <= MAX_ENTRY_BODY_SIZE)
+        {
+            entries.push_back(entry);
+            data_size += dp->getBufferSize();
+        }
+        entry->mCacheFile.reset();
+    }
+
+    closeMappedCache(handle);
+    LLFile::remove(filename, ENOENT);
+
+    // leave room for the region to grow before the next rebuild
+    std::shared_ptr<LLVOCacheRegionFile> file = std::make_shared<LLVOCacheRegionFile>();
+    U32 num_records = (U32)entries.size() + (U32)entries.size() / 2 + 64;
+    if (!file->create(filename, id, num_records, data_size + data_size / 4 + 4096))
+    {
+        LL_WARNS() << "Failed to create mapped object cache " << filename << LL_ENDL;
+        return false;
+    }
+
+    for (U32 i = 0; i < entries.size(); i++)
+    {
+        LLVOCacheEntry* entry = entries[i];
+        LLDataPackerBinaryBuffer* dp = entry->getDP();
+        file->setRecord(i, entry->mLocalID, entry->mCRC, entry->mHitCount, entry->mDupeCount, entry->mCRCChangeCount);
+        if (!file->writeBody(i, dp->getBuffer(), dp->getBufferSize()))
+        {
+            LL_WARNS() << "Failed to write cache entry " << entry->mLocalID << " to " << filename << LL_ENDL;
+            return false;
+        }
+        entry->mCacheFile = file;
+        entry->mCacheRecord = i;
+        entry->mBodyDirty = false;
+    }
+    file->flush();
+    mMappedFiles[handle] = file;
+
+    // the mapped cache supersedes a legacy cache file of this region
+    std::string legacy_filename;
+    getObjectCacheFilename(handle, legacy_filename);
+    LLFile::remove(legacy_filename, ENOENT);
+
+    LL_DEBUGS("VOCache") << "Wrote " << entries.size() << " entries to mapped object cache " << filename << LL_ENDL;
+    return true;
+}
+
 void LLVOCache::removeGenericExtrasForHandle(U64 handle)
 {
     if(mReadOnly)
@@ -1949,6 +2564,7 @@ void LLVOCache::writeGenericExtrasToCache(U64 handle, const LLUUID& id, const LL
         LL_WARNS() << "Not writing extras cache for handle " << handle << "): Cache is currently in read-only mode." << LL_ENDL;
         return;
     }
+    mPrefetched.erase(handle);
 
     std::string filename = getObjectCacheExtrasFilename(handle);
     llofstream out(filename, std::ios::out | std::ios::binary);
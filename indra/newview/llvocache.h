@@ -34,11 +34,15 @@
 #include "llapr.h"
 #include "llgltfmaterial.h"
 
+#include <atomic>
+#include <memory>
 #include <unordered_map>
+#include <vector>
 
 //---------------------------------------------------------------------------
 // Cache entries
 class LLCamera;
+class LLVOCacheRegionFile;
 
 class LLGLTFOverrideCacheEntry
 {
@@ -58,8 +62,12 @@ public:
 class LLVOCacheEntry
 :   public LLViewerOctreeEntryData
 {
-    LL_ALIGN_NEW
 public:
+    // Entries come from a locked LLSlabPool, cache files are read on the
+    // General thread.
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr, size_t size);
+
     enum
     {
         //low 16-bit state
@@ -164,6 +172,11 @@ public:
 
 private:
     void updateParentBoundingInfo(const LLVOCacheEntry* child);
+    void loadBody();
+    // Keep the "Object cache" LLMemTag in step with mDP
+    void accountBuffer();
+
+    friend class LLVOCache;
 
 public:
     typedef std::map<U32, LLPointer<LLVOCacheEntry> >      vocache_entry_map_t;
@@ -183,6 +196,10 @@ protected:
     S32                         mCRCChangeCount;
     LLDataPackerBinaryBuffer    mDP;
     U8                          *mBuffer;
+    S32                         mAccountedBytes = 0; //size of mDP claimed in the "Object cache" LLMemTag.
+    std::shared_ptr<LLVOCacheRegionFile> mCacheFile; //mapped cache file holding this entry, the body is read from it on first use.
+    U32                         mCacheRecord; //index record of this entry in mCacheFile.
+    bool                        mBodyDirty; //body changed since it was last written to mCacheFile.
 
     F32                         mSceneContrib; //projected scene contributuion of this object.
     U32                         mState; //high 16 bits reserved for special use.
@@ -287,6 +304,20 @@ private:
     typedef std::set<HeaderEntryInfo*, header_entry_less> header_entry_queue_t;
     typedef std::map<U64, HeaderEntryInfo*> handle_entry_map_t;
 
+    // Cache files of a region read by a prefetch, owned by the General pool
+    // until mDone is set
+    struct PrefetchedRegion
+    {
+        std::atomic<bool> mDone { false };
+        bool mMapped = false;           // the objects are in a mapped cache, nothing was parsed
+        bool mObjectsSuccess = false;
+        LLUUID mObjectsID;
+        LLVOCacheEntry::vocache_entry_map_t mEntries;
+        bool mExtrasSuccess = false;
+        LLUUID mExtrasID;
+        std::vector<LLGLTFOverrideCacheEntry> mExtras;
+    };
+
 public:
     // We need this init to be separate from constructor, since we might construct cache, purge it, then init.
     void initCache(ELLPath location, U32 size, U32 cache_version);
@@ -300,6 +331,11 @@ public:
     void removeEntry(U64 handle) ;
     void removeGenericExtrasForHandle(U64 handle);
 
+    // Starts reading the cache files of a region on the General pool ahead of
+    // its handshake, readFromCache() and readGenericExtrasFromCache() then take
+    // the result if it is ready by then (ObjectCachePrefetch)
+    void prefetch(U64 handle);
+
     U32 getCacheEntries() { return mNumEntries; }
     U32 getCacheEntriesMax() { return mCacheSize; }
 
@@ -308,6 +344,14 @@ private:
     // determine the cache filename for the region from the region handle
     void getObjectCacheFilename(U64 handle, std::string& filename);
     std::string getObjectCacheExtrasFilename(U64 handle);
+    std::string getObjectCacheMappedFilename(U64 handle);
+    bool readFromMappedCache(U64 handle, const LLUUID& id, LLVOCacheEntry::vocache_entry_map_t& cache_entry_map);
+    bool writeToMappedCache(U64 handle, const LLUUID& id, const LLVOCacheEntry::vocache_entry_map_t& cache_entry_map, bool removal_enabled);
+    bool rewriteMappedCache(U64 handle, const LLUUID& id, const LLVOCacheEntry::vocache_entry_map_t& cache_entry_map, bool removal_enabled);
+    void closeMappedCache(U64 handle);
+    void closeAllMappedCaches();
+    // a finished prefetch of handle, a pending one is dropped
+    std::shared_ptr<PrefetchedRegion> getPrefetched(U64 handle);
     void removeFromCache(HeaderEntryInfo* entry);
     void readCacheHeader();
     void writeCacheHeader();
@@ -321,6 +365,7 @@ private:
     bool                 mEnabled;
     bool                 mInitialized ;
     bool                 mReadOnly ;
+    bool                 mMapped; //ObjectCacheMapped, region caches use the mapped indexed format.
     HeaderMetaInfo       mMetaInfo;
     U32                  mCacheSize;
     U32                  mNumEntries;
@@ -329,6 +374,8 @@ private:
     LLVolatileAPRPool*   mLocalAPRFilePoolp ;
     header_entry_queue_t mHeaderEntryQueue;
     handle_entry_map_t   mHandleEntryMap;
+    std::map<U64, std::weak_ptr<LLVOCacheRegionFile> > mMappedFiles; //open mapped caches, kept alive by their entries.
+    std::map<U64, std::shared_ptr<PrefetchedRegion> > mPrefetched;
 };
 
 #endif
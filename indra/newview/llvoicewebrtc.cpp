@@ -2669,6 +2669,7 @@ bool LLVoiceWebRTCConnection::connectionStateMachine()
     LL_PROFILE_ZONE_SCOPED_CATEGORY_VOICE;
 
     processIceUpdates();
+    applyParticipantUpdates();
 
     switch (getVoiceConnectionState())
     {
@@ -2872,9 +2873,88 @@ bool LLVoiceWebRTCConnection::connectionStateMachine()
 // 'v'  - boolean - voice activity has been detected.
 
 // llwebrtc callback
+// Power levels of every speaking participant arrive several times a second, so parse
+// them here on the webrtc thread and only hand the main thread the latest state of
+// each participant once per connectionStateMachine() tick.
 void LLVoiceWebRTCConnection::OnDataReceived(const std::string& data, bool binary)
 {
-    LL::WorkQueue::postMaybe(mMainQueue, [=] { LLVoiceWebRTCConnection::OnDataReceivedImpl(data, binary); });
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_VOICE;
+
+    if (binary)
+    {
+        LL_WARNS("Voice") << "Binary data received from data channel." << LL_ENDL;
+        return;
+    }
+
+    boost::system::error_code ec;
+    boost::json::value voice_data_parsed = boost::json::parse(data, ec);
+    if (ec)  // don't collect comments
+    {
+        return;
+    }
+    if (!voice_data_parsed.is_object())
+    {
+        LL_WARNS("Voice") << "Expected object from data channel:" << data << LL_ENDL;
+        return;
+    }
+
+    LLMutexLock lock(&mParticipantUpdatesMutex);
+    for (const auto &participant_elem : voice_data_parsed.as_object())
+    {
+        LLUUID agent_id(std::string(participant_elem.key()));
+        if (agent_id.isNull())
+        {
+            // probably a test client.
+            continue;
+        }
+
+        if (!participant_elem.value().is_object())
+        {
+            continue;
+        }
+
+        const boost::json::object &participant_obj = participant_elem.value().as_object();
+        ParticipantUpdate &update = mParticipantUpdates[agent_id];
+        update.mKey = participant_elem.key();
+
+        if (participant_obj.contains("j") && participant_obj.at("j").is_object())
+        {
+            // a new participant has announced that they're joining.
+            update.mJoined = true;
+            update.mLeft = false;
+            const boost::json::object &join_obj = participant_obj.at("j").as_object();
+            if (join_obj.contains("p") && join_obj.at("p").is_bool())
+            {
+                update.mPrimary |= join_obj.at("p").as_bool();
+            }
+        }
+
+        if (participant_obj.contains("l") && participant_obj.at("l").is_bool() && participant_obj.at("l").as_bool())
+        {
+            // an existing participant is leaving.
+            update.mLeft = true;
+            continue;
+        }
+
+        // we got a 'power' update.
+        if (participant_obj.contains("p") && participant_obj.at("p").is_number())
+        {
+            update.mHasLevel = true;
+            update.mLevel = (F32)participant_obj.at("p").to_number<double>();
+        }
+
+        if (participant_obj.contains("v") && participant_obj.at("v").is_bool())
+        {
+            update.mHasSpeaking = true;
+            update.mIsSpeaking = participant_obj.at("v").as_bool();
+        }
+
+        if (participant_obj.contains("m") && participant_obj.at("m").is_bool())
+        {
+            update.mHasModeratorMuted = true;
+            update.mIsModeratorMuted = participant_obj.at("m").as_bool();
+        }
+    }
 }
 
 //
@@ -2882,139 +2962,105 @@ void LLVoiceWebRTCConnection::OnDataReceived(const std::string& data, bool binar
 // before the webrtc connection itself is shut down, so
 // we shouldn't be getting this callback on a nonexistant
 // this pointer.
-void LLVoiceWebRTCConnection::OnDataReceivedImpl(const std::string &data, bool binary)
+void LLVoiceWebRTCConnection::applyParticipantUpdates()
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_VOICE;
 
-    if (mShutDown)
+    std::map<LLUUID, ParticipantUpdate> updates;
     {
-        return;
+        LLMutexLock lock(&mParticipantUpdatesMutex);
+        if (mParticipantUpdates.empty())
+        {
+            return;
+        }
+        updates.swap(mParticipantUpdates);
     }
 
-    if (binary)
+    if (mShutDown)
     {
-        LL_WARNS("Voice") << "Binary data received from data channel." << LL_ENDL;
         return;
     }
 
-    boost::system::error_code ec;
-    boost::json::value voice_data_parsed = boost::json::parse(data, ec);
-    if (!ec)  // don't collect comments
+    boost::json::object mute;
+    boost::json::object user_gain;
+    for (const auto &entry : updates)
     {
-        if (!voice_data_parsed.is_object())
-        {
-            LL_WARNS("Voice") << "Expected object from data channel:" << data << LL_ENDL;
-            return;
-        }
-        boost::json::object voice_data = voice_data_parsed.as_object();
-        bool new_participant = false;
-        boost::json::object mute;
-        boost::json::object user_gain;
-        for (auto &participant_elem : voice_data)
+        const LLUUID &agent_id = entry.first;
+        const ParticipantUpdate &update = entry.second;
+
+        LLWebRTCVoiceClient::participantStatePtr_t participant =
+            LLWebRTCVoiceClient::getInstance()->findParticipantByID(mChannelID, agent_id);
+
+        if (update.mJoined)
         {
-            boost::json::string participant_id(participant_elem.key());
-            LLUUID agent_id(participant_id.c_str());
-            if (agent_id.isNull())
+            // track incoming participants that are muted so we can mute their connections (or set their volume)
+            bool isMuted = LLMuteList::getInstance()->isMuted(agent_id, LLMute::flagVoiceChat);
+            if (isMuted)
             {
-               // probably a test client.
-               continue;
+                mute[update.mKey] = true;
             }
-
-            if (!participant_elem.value().is_object())
+            F32 volume;
+            if(LLSpeakerVolumeStorage::getInstance()->getSpeakerVolume(agent_id, volume))
             {
-                continue;
+                user_gain[update.mKey] = (uint32_t)(volume * 200);
             }
 
-            boost::json::object participant_obj = participant_elem.value().as_object();
-
-            LLWebRTCVoiceClient::participantStatePtr_t participant =
-                LLWebRTCVoiceClient::getInstance()->findParticipantByID(mChannelID, agent_id);
-            bool joined  = false;
-            bool primary = false;  // we ignore any 'joins' reported about participants
-                                   // that come from voice servers that aren't their primary
-                                   // voice server.  This will happen with cross-region voice
-                                   // where a participant on a neighboring region may be
-                                   // connected to multiple servers.  We don't want to
-                                   // add new identical participants from all of those servers.
-            if (participant_obj.contains("j") &&
-                participant_obj["j"].is_object())
-            {
-                // a new participant has announced that they're joining.
-                joined  = true;
-                if (participant_elem.value().as_object()["j"].as_object().contains("p") &&
-                    participant_elem.value().as_object()["j"].as_object()["p"].is_bool())
-                {
-                    primary = participant_elem.value().as_object()["j"].as_object()["p"].as_bool();
-                }
-
-                // track incoming participants that are muted so we can mute their connections (or set their volume)
-                bool isMuted = LLMuteList::getInstance()->isMuted(agent_id, LLMute::flagVoiceChat);
-                if (isMuted)
-                {
-                    mute[participant_id] = true;
-                }
-                F32 volume;
-                if(LLSpeakerVolumeStorage::getInstance()->getSpeakerVolume(agent_id, volume))
-                {
-                    user_gain[participant_id] = (uint32_t)(volume * 200);
-                }
-            }
-
-            new_participant |= joined;
-            if (!participant && joined && (primary || !isSpatial()))
+            // we ignore any 'joins' reported about participants
+            // that come from voice servers that aren't their primary
+            // voice server.  This will happen with cross-region voice
+            // where a participant on a neighboring region may be
+            // connected to multiple servers.  We don't want to
+            // add new identical participants from all of those servers.
+            if (!participant && (update.mPrimary || !isSpatial()))
             {
                 participant = LLWebRTCVoiceClient::getInstance()->addParticipantByID(mChannelID, agent_id, mRegionID);
             }
+        }
 
-            if (participant)
-            {
-                if (participant_obj.contains("l") && participant_obj["l"].is_bool() && participant_obj["l"].as_bool())
-                {
-                    // an existing participant is leaving.
-                    if (agent_id != gAgentID)
-                    {
-                        LLWebRTCVoiceClient::getInstance()->removeParticipantByID(mChannelID, agent_id, mRegionID);
-                    }
-                }
-                else
-                {
-                    // we got a 'power' update.
-                    if (participant_obj.contains("p") && participant_obj["p"].is_number())
-                    {
-                        participant->mLevel = (F32)participant_obj["p"].as_int64();
-                    }
-
-                    if (participant_obj.contains("v") && participant_obj["v"].is_bool())
-                    {
-                        participant->mIsSpeaking = participant_obj["v"].as_bool();
-                    }
+        if (!participant)
+        {
+            continue;
+        }
 
-                    if (participant_obj.contains("v") && participant_obj["m"].is_bool())
-                    {
-                        participant->mIsModeratorMuted = participant_obj["m"].as_bool();
-                        ;
-                    }
-                }
+        if (update.mLeft)
+        {
+            if (agent_id != gAgentID)
+            {
+                LLWebRTCVoiceClient::getInstance()->removeParticipantByID(mChannelID, agent_id, mRegionID);
             }
+            continue;
         }
 
-        // tell the simulator to set the mute and volume data for this
-        // participant, if there are any updates.
-        boost::json::object root;
-        if (mute.size() > 0)
+        if (update.mHasLevel)
         {
-            root["m"] = mute;
+            participant->mLevel = update.mLevel;
         }
-        if (user_gain.size() > 0)
+        if (update.mHasSpeaking)
         {
-            root["ug"] = user_gain;
+            participant->mIsSpeaking = update.mIsSpeaking;
         }
-        if (root.size() > 0)
+        if (update.mHasModeratorMuted)
         {
-            std::string json_data = boost::json::serialize(root);
-            mWebRTCDataInterface->sendData(json_data, false);
+            participant->mIsModeratorMuted = update.mIsModeratorMuted;
         }
     }
+
+    // tell the simulator to set the mute and volume data for these
+    // participants, if there are any updates.
+    boost::json::object root;
+    if (mute.size() > 0)
+    {
+        root["m"] = mute;
+    }
+    if (user_gain.size() > 0)
+    {
+        root["ug"] = user_gain;
+    }
+    if (root.size() > 0 && mWebRTCDataInterface)
+    {
+        std::string json_data = boost::json::serialize(root);
+        mWebRTCDataInterface->sendData(json_data, false);
+    }
 }
 
 //
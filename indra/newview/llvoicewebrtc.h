@@ -605,7 +605,8 @@ class LLVoiceWebRTCConnection :
     void OnDataChannelReady(llwebrtc::LLWebRTCDataInterface *data_interface) override;
     //@}
 
-    void OnDataReceivedImpl(const std::string &data, bool binary);
+    // Apply the participant updates received since the last tick, on the main thread
+    void applyParticipantUpdates();
 
     void sendJoin();
     void sendData(const std::string &data);
@@ -708,6 +709,25 @@ class LLVoiceWebRTCConnection :
     std::vector<llwebrtc::LLWebRTCIceCandidate> mIceCandidates;
     bool                                        mIceCompleted;
 
+    // What the data channel said about one participant since the last tick,
+    // later messages override earlier ones
+    struct ParticipantUpdate
+    {
+        std::string mKey;               // as the server sent it
+        bool mJoined = false;
+        bool mPrimary = false;
+        bool mLeft = false;
+        bool mHasLevel = false;
+        bool mHasSpeaking = false;
+        bool mHasModeratorMuted = false;
+        F32  mLevel = 0.f;
+        bool mIsSpeaking = false;
+        bool mIsModeratorMuted = false;
+    };
+    // parsed on the webrtc thread, applied by connectionStateMachine()
+    LLMutex                              mParticipantUpdatesMutex;
+    std::map<LLUUID, ParticipantUpdate> mParticipantUpdates;
+
     llwebrtc::LLWebRTCPeerConnectionInterface *mWebRTCPeerConnectionInterface;
     llwebrtc::LLWebRTCAudioInterface *mWebRTCAudioInterface;
     llwebrtc::LLWebRTCDataInterface  *mWebRTCDataInterface;
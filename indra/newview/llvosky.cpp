@@ -52,6 +52,12 @@
 
 #include "llsettingssky.h"
 #include "llenvironment.h"
+#include "lldiskcache.h"
+#include "llfilesystem.h"
+#include "hbxxh.h"
+#include "workqueue.h"
+
+#include <atomic>
 
 #include "lltrace.h"
 #include "llfasttimer.h"
@@ -645,6 +651,169 @@ void LLVOSky::createSkyTexture(const LLSettingsSky::ptr_t &psky, AtmosphericsVar
     }
 }
 
+static const S32 SKYTEX_PIXELS = (S32)(SKYTEX_RESOLUTION * SKYTEX_RESOLUTION);
+// Sky then shiny colors of each face
+static const S32 CUBE_MAP_CACHE_PIXELS = NUM_CUBEMAP_FACES * 2 * SKYTEX_PIXELS;
+static const size_t CUBE_MAP_CACHE_ENTRIES = 4;
+
+static const U32 CUBE_MAP_CACHE_MAGIC = 0x4d43534c; // "LSCM"
+static const U32 CUBE_MAP_CACHE_VERSION = 1;
+// magic, version and key
+static const S32 CUBE_MAP_CACHE_HEADER_SIZE = 2 * sizeof(U32) + sizeof(U64);
+
+static LLUUID get_cube_map_cache_id(U64 key)
+{
+    return LLUUID::generateNewID(llformat("sky cube map %llu", key));
+}
+
+struct LLVOSky::CubeMapJob
+{
+    // Works on copies, the sky object keeps updating its own state meanwhile
+    LLAtmospherics mAtmospherics;
+    AtmosphericsVars mVars;
+    LLSettingsSky::ptr_t mSky;      // only gammaCorrect and getLightTransmittanceFast are used, both const
+    bool mLowEnd = false;
+    U64 mKey = 0;
+    std::vector<LLVector3> mDirs;   // of each face
+    std::vector<LLColor4U> mPixels;
+    std::atomic<bool> mDone { false };
+
+    void build()
+    {
+        LL_PROFILE_ZONE_SCOPED_CATEGORY_ENVIRONMENT;
+        mPixels.resize(CUBE_MAP_CACHE_PIXELS);
+        for (S32 side = 0; side < NUM_CUBEMAP_FACES; side++)
+        {
+            const LLVector3* dirs = &mDirs[side * SKYTEX_PIXELS];
+            LLColor4U* sky = &mPixels[side * 2 * SKYTEX_PIXELS];
+            LLColor4U* shiny = sky + SKYTEX_PIXELS;
+            for (S32 i = 0; i < SKYTEX_PIXELS; i++)
+            {
+                sky[i] = mAtmospherics.calcSkyColorInDir(mSky, mVars, dirs[i], false, mLowEnd);
+                shiny[i] = mAtmospherics.calcSkyColorInDir(mSky, mVars, dirs[i], true, mLowEnd);
+            }
+        }
+    }
+};
+
+U64 LLVOSky::hashCubeMapInputs(bool low_end) const
+{
+    // hazeColor and hazeColorBelowCloud are scratch space of calcSkyColorInDir, not inputs
+    const AtmosphericsVars& vars = m_atmosphericsVars;
+    HBXXH64 hash;
+    auto add = [&hash](const auto& value) { hash.update(&value, sizeof(value)); };
+    add(vars.blue_density);
+    add(vars.blue_horizon);
+    add(vars.haze_density);
+    add(vars.haze_horizon);
+    add(vars.density_multiplier);
+    add(vars.max_y);
+    add(vars.gamma);
+    add(vars.sun_norm);
+    add(vars.sunlight);
+    add(vars.ambient);
+    add(vars.glow);
+    add(vars.cloud_shadow);
+    add(vars.dome_radius);
+    add(vars.dome_offset);
+    add(vars.light_atten);
+    add(vars.total_density);
+    add(m_legacyAtmospherics.getFogColor());
+    add(low_end);
+    return hash.digest();
+}
+
+void LLVOSky::applyCubeMapPixels(const std::vector<LLColor4U>& pixels)
+{
+    llassert((S32)pixels.size() == CUBE_MAP_CACHE_PIXELS);
+    for (S32 side = 0; side < NUM_CUBEMAP_FACES; side++)
+    {
+        const LLColor4U* sky = &pixels[side * 2 * SKYTEX_PIXELS];
+        const LLColor4U* shiny = sky + SKYTEX_PIXELS;
+        for (S32 i = 0; i < SKYTEX_PIXELS; i++)
+        {
+            // LLSkyTex::create() rounds back to exactly these values
+            mSkyTex[side].mSkyData[i] = LLColor4(sky[i]);
+            mShinyTex[side].mSkyData[i] = LLColor4(shiny[i]);
+        }
+    }
+}
+
+void LLVOSky::cacheCubeMapPixels(U64 key, std::vector<LLColor4U>&& pixels)
+{
+    mCubeMapCache.emplace_front(key, std::move(pixels));
+    if (mCubeMapCache.size() > CUBE_MAP_CACHE_ENTRIES)
+    {
+        mCubeMapCache.pop_back();
+    }
+}
+
+void LLVOSky::startCubeMapUpdate(const LLSettingsSky::ptr_t &psky)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_ENVIRONMENT;
+
+    const bool low_end = !gPipeline.canUseWindLightShaders();
+    const U64 key = hashCubeMapInputs(low_end);
+
+    for (auto iter = mCubeMapCache.begin(); iter != mCubeMapCache.end(); ++iter)
+    {
+        if (iter->first == key)
+        {
+            mCubeMapCache.splice(mCubeMapCache.begin(), mCubeMapCache, iter);
+            applyCubeMapPixels(mCubeMapCache.front().second);
+            mCubeMapUpdateStage = NUM_CUBEMAP_FACES;
+            return;
+        }
+    }
+
+    if (LLDiskCache::instanceExists())
+    {
+        LLFileSystem file(get_cube_map_cache_id(key), LLAssetType::AT_UNKNOWN);
+        std::vector<U8> data(CUBE_MAP_CACHE_HEADER_SIZE + CUBE_MAP_CACHE_PIXELS * sizeof(LLColor4U));
+        U32 header[2];
+        U64 file_key;
+        if (file.getSize() == (S32)data.size() && file.read(data.data(), (S32)data.size()))
+        {
+            memcpy(header, data.data(), sizeof(header));
+            memcpy(&file_key, data.data() + sizeof(header), sizeof(file_key));
+            if (header[0] == CUBE_MAP_CACHE_MAGIC && header[1] == CUBE_MAP_CACHE_VERSION && file_key == key)
+            {
+                std::vector<LLColor4U> pixels(CUBE_MAP_CACHE_PIXELS);
+                memcpy(pixels.data(), data.data() + CUBE_MAP_CACHE_HEADER_SIZE, pixels.size() * sizeof(LLColor4U));
+                applyCubeMapPixels(pixels);
+                cacheCubeMapPixels(key, std::move(pixels));
+                mCubeMapUpdateStage = NUM_CUBEMAP_FACES;
+                return;
+            }
+        }
+    }
+
+    auto job = std::make_shared<CubeMapJob>();
+    job->mAtmospherics = m_legacyAtmospherics;
+    job->mVars = m_atmosphericsVars;
+    job->mSky = psky;
+    job->mLowEnd = low_end;
+    job->mKey = key;
+    job->mDirs.resize(NUM_CUBEMAP_FACES * SKYTEX_PIXELS);
+    for (S32 side = 0; side < NUM_CUBEMAP_FACES; side++)
+    {
+        std::copy(mSkyTex[side].mSkyDirs, mSkyTex[side].mSkyDirs + SKYTEX_PIXELS, job->mDirs.begin() + side * SKYTEX_PIXELS);
+    }
+    mCubeMapJob = job;
+    mCubeMapUpdateStage = 0;
+
+    LL::WorkQueue::ptr_t general_queue = LL::WorkQueue::getInstance("General");
+    if (!general_queue || !general_queue->post([job]()
+        {
+            job->build();
+            job->mDone.store(true, std::memory_order_release);
+        }))
+    {
+        job->build();
+        job->mDone.store(true, std::memory_order_release);
+    }
+}
+
 void LLVOSky::updateDirections(LLSettingsSky::ptr_t psky)
 {
     mSun.setDirection(psky->getSunDirection());
@@ -665,6 +834,8 @@ void LLVOSky::forceSkyUpdate()
 
     m_lastAtmosphericsVars = {};
 
+    // a job still building finishes on its own and is dropped with its last reference
+    mCubeMapJob.reset();
     mCubeMapUpdateStage = -1;
 }
 
@@ -715,7 +886,15 @@ bool LLVOSky::updateSky()
         {
             // start updating cube map sides
             updateFog(LLViewerCamera::getInstance()->getFar());
-            mCubeMapUpdateStage = 0;
+            static LLCachedControl<bool> cube_map_cache(gSavedSettings, "SkyCubeMapCache", true);
+            if (cube_map_cache)
+            {
+                startCubeMapUpdate(psky);
+            }
+            else
+            {
+                mCubeMapUpdateStage = 0;
+            }
             mForceUpdate = false;
         }
     }
@@ -778,6 +957,31 @@ bool LLVOSky::updateSky()
         }
         mCubeMapUpdateStage = -1;
     }
+    else if (mCubeMapJob)
+    {
+        // all faces are built at once off the main thread, wait for them at stage 0
+        if (mCubeMapJob->mDone.load(std::memory_order_acquire))
+        {
+            LL_PROFILE_ZONE_NAMED_CATEGORY_ENVIRONMENT("updateSky - apply");
+            std::shared_ptr<CubeMapJob> job = std::move(mCubeMapJob);
+            applyCubeMapPixels(job->mPixels);
+
+            if (LLDiskCache::instanceExists())
+            {
+                U32 header[2] = { CUBE_MAP_CACHE_MAGIC, CUBE_MAP_CACHE_VERSION };
+                std::vector<U8> data;
+                data.insert(data.end(), (const U8*)header, (const U8*)header + sizeof(header));
+                data.insert(data.end(), (const U8*)&job->mKey, (const U8*)&job->mKey + sizeof(job->mKey));
+                data.insert(data.end(), (const U8*)job->mPixels.data(), (const U8*)(job->mPixels.data() + job->mPixels.size()));
+
+                LLFileSystem file(get_cube_map_cache_id(job->mKey), LLAssetType::AT_UNKNOWN, LLFileSystem::WRITE);
+                file.write(data.data(), (S32)data.size());
+            }
+
+            cacheCubeMapPixels(job->mKey, std::move(job->mPixels));
+            mCubeMapUpdateStage = NUM_CUBEMAP_FACES;
+        }
+    }
     // run 0 to 5 faces, each face in own frame
     else if (mCubeMapUpdateStage >= 0 && mCubeMapUpdateStage < NUM_CUBEMAP_FACES && !LLPipeline::sReflectionProbesEnabled)
     {
@@ -38,6 +38,10 @@
 #include "llsettingssky.h"
 #include "lllegacyatmospherics.h"
 
+#include <list>
+#include <memory>
+#include <vector>
+
 const F32 SKY_BOX_MULT          = 16.0f;
 const F32 HEAVENLY_BODY_DIST    = HORIZON_DIST - 20.f;
 const F32 HEAVENLY_BODY_FACTOR  = 0.1f;
@@ -305,6 +309,16 @@ protected:
     void initSkyTextureDirs(const S32 side, const S32 tile);
     void createSkyTexture(const LLSettingsSky::ptr_t &psky, AtmosphericsVars& vars, const S32 side, const S32 tile);
 
+    // Sky and shiny colors of every cube map face, built on the General thread pool
+    struct CubeMapJob;
+
+    // Fill the cube map faces from the cache, or start a job building them (SkyCubeMapCache)
+    void startCubeMapUpdate(const LLSettingsSky::ptr_t &psky);
+    // Hash of everything calcSkyColorInDir reads for the current atmospherics
+    U64 hashCubeMapInputs(bool low_end) const;
+    void applyCubeMapPixels(const std::vector<LLColor4U>& pixels);
+    void cacheCubeMapPixels(U64 key, std::vector<LLColor4U>&& pixels);
+
     LLPointer<LLViewerFetchedTexture> mSunTexturep[2];
     LLPointer<LLViewerFetchedTexture> mMoonTexturep[2];
     LLPointer<LLViewerFetchedTexture> mCloudNoiseTexturep[2];
@@ -357,6 +371,10 @@ protected:
     AtmosphericsVars    m_atmosphericsVars;
     AtmosphericsVars    m_lastAtmosphericsVars;
     LLAtmospherics      m_legacyAtmospherics;
+
+    std::shared_ptr<CubeMapJob> mCubeMapJob;
+    // Most recently used first
+    std::list<std::pair<U64, std::vector<LLColor4U> > > mCubeMapCache;
 };
 
 #endif
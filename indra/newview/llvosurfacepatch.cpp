@@ -204,6 +204,13 @@ bool LLVOSurfacePatch::updateGeometry(LLDrawable *drawable)
         east_stride = render_stride;
     }
 
+    if (mPatchp->getSurface()->getHeightfield())
+    {
+        // drawn by LLTerrainHeightfield, keep the face empty
+        render_stride = 0;
+        length = 0;
+    }
+
     mLastLength = length;
     mLastStride = render_stride;
     mLastNorthStride = north_stride;
@@ -74,6 +74,8 @@ S32 LLVOTree::sLODSlices[sMAX_NUM_TREE_LOD_LEVELS] = {10, 5, 4, 3};
 F32 LLVOTree::sLODAngles[sMAX_NUM_TREE_LOD_LEVELS] = {30.f, 20.f, 15.f, F_ALMOST_ZERO};
 
 F32 LLVOTree::sTreeFactor = 1.f;
+bool LLVOTree::sInstancing = false;
+LLVOTree::instance_mesh_map_t LLVOTree::sInstanceMeshes;
 
 LLVOTree::SpeciesMap LLVOTree::sSpeciesTable;
 S32 LLVOTree::sMaxTreeSpecies = 0;
@@ -283,6 +285,13 @@ void LLVOTree::cleanupClass()
 {
     std::for_each(sSpeciesTable.begin(), sSpeciesTable.end(), DeletePairedPointer());
     sSpeciesTable.clear();
+    destroyInstanceMeshes();
+}
+
+//static
+void LLVOTree::destroyInstanceMeshes()
+{
+    sInstanceMeshes.clear();
 }
 
 U32 LLVOTree::processUpdateMessage(LLMessageSystem *mesgsys,
@@ -382,7 +391,7 @@ void LLVOTree::idleUpdate(LLAgent &agent, const F64 &time)
     trunk_LOD = llmax(trunk_LOD, LLVolumeLODGroup::NUM_LODS - cur_detail - 1);
     trunk_LOD = llmin(trunk_LOD, sMAX_NUM_TREE_LOD_LEVELS);
 
-    if (mReferenceBuffer.isNull())
+    if (!hasMesh())
     {
         gPipeline.markRebuild(mDrawable, LLDrawable::REBUILD_ALL);
     }
@@ -506,6 +515,7 @@ bool LLVOTree::updateGeometry(LLDrawable *drawable)
     if(mTrunkLOD >= sMAX_NUM_TREE_LOD_LEVELS) //do not display the tree.
     {
         mReferenceBuffer = NULL ;
+        mInstanceMesh = NULL;
         LLFace * facep = drawable->getFace(0);
         if (facep)
         {
@@ -514,8 +524,25 @@ bool LLVOTree::updateGeometry(LLDrawable *drawable)
         return true ;
     }
 
+    if (sInstancing)
+    {
+        // only the first tree of a species and LOD needs the reference geometry, to build
+        // the shared mesh, everybody else just moves their instance
+        instance_mesh_map_t::iterator iter = sInstanceMeshes.find((mSpecies << 8) | mTrunkLOD);
+        LLFace* face = drawable->getFace(0);
+        if (iter != sInstanceMeshes.end() && face)
+        {
+            face->mCenterAgent = getPositionAgent();
+            face->mCenterLocal = face->mCenterAgent;
+            mReferenceBuffer = NULL;
+            mInstanceMesh = iter->second;
+            mInstanceMatrix = getInstanceMatrix();
+            return true;
+        }
+    }
+
     if (mDrawable->getFace(0) &&
-        (mReferenceBuffer.isNull() || !mDrawable->getFace(0)->getVertexBuffer()))
+        (mReferenceBuffer.isNull() || (!sInstancing && !mDrawable->getFace(0)->getVertexBuffer())))
     {
         const F32 SRR3 = 0.577350269f; // sqrt(1/3)
         const F32 SRR2 = 0.707106781f; // sqrt(1/2)
@@ -883,7 +910,7 @@ bool LLVOTree::updateGeometry(LLDrawable *drawable)
     return true;
 }
 
-void LLVOTree::updateMesh()
+LLMatrix4 LLVOTree::getInstanceMatrix() const
 {
     LLMatrix4 matrix;
 
@@ -916,6 +943,22 @@ void LLVOTree::updateMesh()
 
     scale_mat *= rot_mat;
 
+    return scale_mat;
+}
+
+void LLVOTree::updateMesh()
+{
+    // instanced meshes are built untransformed, the transform is applied at draw time
+    LLMatrix4 scale_mat;
+    if (sInstancing)
+    {
+        mInstanceMatrix = getInstanceMatrix();
+    }
+    else
+    {
+        scale_mat = getInstanceMatrix();
+    }
+
 //  const F32 THRESH_ANGLE_FOR_BILLBOARD = 15.f;
 //  const F32 BLEND_RANGE_FOR_BILLBOARD = 3.f;
 
@@ -931,8 +974,21 @@ void LLVOTree::updateMesh()
 
     LLFace* facep = mDrawable->getFace(0);
     if (!facep) return;
-    LLVertexBuffer* buff = new LLVertexBuffer(LLDrawPoolTree::VERTEX_DATA_MASK);
-    if (!buff->allocateBuffer(vert_count, index_count))
+    LLPointer<LLVertexBuffer> buff = new LLVertexBuffer(LLDrawPoolTree::VERTEX_DATA_MASK);
+    if (sInstancing)
+    {
+        if (!buff->allocateBuffer(vert_count, index_count))
+        {
+            LL_WARNS() << "Failed to allocate instance mesh of "
+                << vert_count << " vertices and "
+                << index_count << " indices" << LL_ENDL;
+            mReferenceBuffer->unmapBuffer();
+            return;
+        }
+        mInstanceMesh = buff;
+        sInstanceMeshes[(mSpecies << 8) | mTrunkLOD] = buff;
+    }
+    else if (!buff->allocateBuffer(vert_count, index_count))
     {
         LL_WARNS() << "Failed to allocate Vertex Buffer on mesh update to "
             << vert_count << " vertices and "
@@ -947,7 +1003,7 @@ void LLVOTree::updateMesh()
         return;
     }
 
-    facep->setVertexBuffer(buff);
+    facep->setVertexBuffer(sInstancing ? NULL : buff.get());
 
     LLStrider<LLVector3> vertices;
     LLStrider<LLVector3> normals;
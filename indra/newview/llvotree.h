@@ -77,7 +77,10 @@ public:
 
     void updateMesh();
 
-    void destroyVB() { mReferenceBuffer = NULL; }
+    void destroyVB() { mReferenceBuffer = NULL; mInstanceMesh = NULL; }
+
+    // Release the shared instancing meshes, they are rebuilt on demand
+    static void destroyInstanceMeshes();
 
     void appendMesh(LLStrider<LLVector3>& vertices,
                          LLStrider<LLVector3>& normals,
@@ -152,6 +155,7 @@ public:
     };
 
     static F32 sTreeFactor;         // Tree level of detail factor
+    static bool sInstancing;        // RenderTreeInstancing, read at startup
     static const S32 sMAX_NUM_TREE_LOD_LEVELS ;
 
     friend class LLDrawPoolTree;
@@ -187,6 +191,18 @@ protected:
 
     U32 mFrameCount;
 
+    // Instanced rendering (sInstancing):  the tree is drawn from the mesh shared by all trees
+    // of its species and LOD, placed by mInstanceMatrix (region space), instead of from a
+    // vertex buffer of its own
+    LLPointer<LLVertexBuffer> mInstanceMesh;
+    LLMatrix4 mInstanceMatrix;
+
+    typedef std::map<U32, LLPointer<LLVertexBuffer> > instance_mesh_map_t;
+    static instance_mesh_map_t sInstanceMeshes;   // by species << 8 | trunk LOD
+
+    LLMatrix4 getInstanceMatrix() const;
+    bool hasMesh() const { return sInstancing ? mInstanceMesh.notNull() : mReferenceBuffer.notNull(); }
+
     typedef std::map<U32, TreeSpeciesData*> SpeciesMap;
     // <FS:Ansariel> FIRE-7802: Grass and tree selection in build tool
     //static SpeciesMap sSpeciesTable;
@@ -89,6 +89,7 @@
 #include "llavatarappearancedefines.h"
 #include "llgltfmateriallist.h"
 #include "gltfscenemanager.h"
+#include "parallelfor.h"
 // [RLVa:KB] - Checked: RLVa-2.0.0
 #include "rlvactions.h"
 #include "rlvlocks.h"
@@ -97,6 +98,10 @@
 
 const F32 FORCE_SIMPLE_RENDER_AREA = 512.f;
 const F32 FORCE_CULL_AREA = 8.f;
+// Unchanged objects still reevaluate their LOD and texture sizes this often, for the
+// inputs the change detection doesn't see (face extents, FOV ramps and so on)
+const U32 LOD_REFRESH_FRAMES = 16;
+const F32 TEXTURE_REFRESH_SECONDS = 8.f;
 U32 JOINT_COUNT_REQUIRED_FOR_FULLRIG = 1;
 
 bool gAnimateTextures = true;
@@ -237,6 +242,15 @@ LLVOVolume::LLVOVolume(const LLUUID &id, const LLPCode pcode, LLViewerRegion *re
     mLODDistance = 0.0f;
     mLODAdjustedDistance = 0.0f;
     mLODRadius = 0.0f;
+    mLODUpdateDistance = 0.f;
+    mLODUpdateRadius = 0.f;
+    mLODUpdateScale = 0.f;
+    mLODUpdateFrame = 0;
+    mTexUpdateDistance = 0.f;
+    mTexUpdateRadius = 0.f;
+    mTexUpdateCosAngle = 0.f;
+    mTexUpdatePixelAngle = 0.f;
+    mTexUpdateValid = false;
     mTextureAnimp = NULL;
     mVolumeChanged = false;
     mVObjRadius = LLVector3(1,1,0.5f).length();
@@ -830,6 +844,31 @@ void LLVOVolume::animateTextures()
     }
 }
 
+U32 LLVOVolume::getIdleUpdatePeriod() const
+{
+    static LLCachedControl<bool> tiered(gSavedSettings, "ObjectIdleUpdateTiers", true);
+    static LLCachedControl<F32> far_distance(gSavedSettings, "ObjectIdleUpdateFarDistance", 64.f);
+
+    if (!tiered || mDrawable.isNull() || isAttachment() || isSelected())
+    {
+        return 1;
+    }
+
+    bool far_away = dist_vec_squared(mDrawable->getPositionAgent(), LLViewerCamera::getInstance()->getOrigin()) >
+                    far_distance * far_distance;
+    if (mDrawable->isVisible())
+    {
+        return far_away ? 2 : 1;
+    }
+    return far_away ? 8 : 4;
+}
+
+bool LLVOVolume::isIdleUpdateDue() const
+{
+    U32 period = getIdleUpdatePeriod();
+    return period == 1 || (LLFrameTimer::getFrameCount() + mLocalID) % period == 0;
+}
+
 void LLVOVolume::updateTextures()
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
@@ -881,6 +920,7 @@ void LLVOVolume::updateTextureVirtualSize(bool forced)
                     face->setVirtualSize(0.f);
                 }
             }
+            mTexUpdateValid = false;
 
             return ;
         }
@@ -898,16 +938,25 @@ void LLVOVolume::updateTextureVirtualSize(bool forced)
         return;
     }
 
-    mTextureUpdateTimer.reset();
+    // the face sizes only change when the object moves against the camera, leave them
+    // alone while it didn't beyond TextureUpdateTolerance
+    const U64 debug_masks = LLPipeline::RENDER_DEBUG_TEXTURE_PRIORITY | LLPipeline::RENDER_DEBUG_FACE_AREA |
+                            LLPipeline::RENDER_DEBUG_TEXTURE_AREA;
+    bool update_faces = updateTextureMetrics() || forced || isHUDAttachment() ||
+                        gPipeline.hasRenderDebugMask(debug_masks);
 
     F32 old_area = mPixelArea;
-    mPixelArea = 0.f;
+    if (update_faces)
+    {
+        mTextureUpdateTimer.reset();
+        mPixelArea = 0.f;
+    }
 
     const S32 num_faces = mDrawable->getNumFaces();
     F32 min_vsize=999999999.f, max_vsize=0.f;
     LLViewerCamera* camera = LLViewerCamera::getInstance();
     std::stringstream debug_text;
-    for (S32 i = 0; i < num_faces; i++)
+    for (S32 i = 0; update_faces && i < num_faces; i++)
     {
         LLFace* face = mDrawable->getFace(i);
         if (!face) continue;
@@ -1060,6 +1109,61 @@ void LLVOVolume::updateTextureVirtualSize(bool forced)
     }
 }
 
+bool LLVOVolume::updateTextureMetrics()
+{
+    static LLCachedControl<F32> tolerance(gSavedSettings, "TextureUpdateTolerance", 0.05f);
+
+    // same bounds LLFace::calcPixelArea() uses, for the whole object
+    LLVector4a center;
+    LLVector4a size;
+    if (mDrawable->isState(LLDrawable::RIGGED))
+    {
+        LLVOAvatar* avatar = getAvatar();
+        if (!avatar || !avatar->mDrawable)
+        {
+            mTexUpdateValid = false;
+            return true;
+        }
+        const LLVector4a* exts = avatar->mDrawable->getSpatialExtents();
+        center.load3(avatar->getPositionAgent().mV);
+        size.setSub(exts[1], exts[0]);
+    }
+    else
+    {
+        center.load3(getPositionAgent().mV);
+        size.load3(getScale().mV);
+    }
+
+    LLViewerCamera* camera = LLViewerCamera::getInstance();
+    LLVector4a origin;
+    LLVector4a at_axis;
+    origin.load3(camera->getOrigin().mV);
+    at_axis.load3(camera->getXAxis().mV);
+
+    LLVector4a look_at;
+    look_at.setSub(center, origin);
+    F32 distance = look_at.getLength3().getF32();
+    F32 radius = size.getLength3().getF32() * 0.5f;
+    F32 cos_angle = distance > F_ALMOST_ZERO ? look_at.dot3(at_axis).getF32() / distance : 1.f;
+
+    if (mTexUpdateValid &&
+        mTexUpdatePixelAngle == LLDrawable::sCurPixelAngle &&
+        fabsf(distance - mTexUpdateDistance) <= tolerance * mTexUpdateDistance &&
+        fabsf(radius - mTexUpdateRadius) <= tolerance * mTexUpdateRadius &&
+        fabsf(cos_angle - mTexUpdateCosAngle) <= tolerance &&
+        mTextureUpdateTimer.getElapsedTimeF32() < TEXTURE_REFRESH_SECONDS)
+    {
+        return false;
+    }
+
+    mTexUpdateDistance = distance;
+    mTexUpdateRadius = radius;
+    mTexUpdateCosAngle = cos_angle;
+    mTexUpdatePixelAngle = LLDrawable::sCurPixelAngle;
+    mTexUpdateValid = true;
+    return true;
+}
+
 bool LLVOVolume::isActive() const
 {
     return !mStatic;
@@ -1336,12 +1440,12 @@ void LLVOVolume::updateVisualComplexity()
     LLVOAvatar* avatar = getAvatarAncestor();
     if (avatar)
     {
-        avatar->updateVisualComplexity();
+        avatar->updateVisualComplexity(this);
     }
     LLVOAvatar* rigged_avatar = getAvatar();
     if(rigged_avatar && (rigged_avatar != avatar))
     {
-        rigged_avatar->updateVisualComplexity();
+        rigged_avatar->updateVisualComplexity(this);
     }
 }
 
@@ -1645,6 +1749,23 @@ bool LLVOVolume::calcLOD()
         }
     }
 
+    // the detail can only change when the object moved against the camera or the LOD
+    // settings changed, don't bother while neither did beyond LODUpdateTolerance
+    static LLCachedControl<F32> lod_tolerance(gSavedSettings, "LODUpdateTolerance", 0.01f);
+    F32 lod_scale = sDistanceFactor * lod_factor / LLViewerCamera::getInstance()->getDefaultFOV();
+    if (lod_scale == mLODUpdateScale &&
+        fabsf(distance - mLODUpdateDistance) <= lod_tolerance * mLODUpdateDistance &&
+        fabsf(radius - mLODUpdateRadius) <= lod_tolerance * mLODUpdateRadius &&
+        LLFrameTimer::getFrameCount() - mLODUpdateFrame < LOD_REFRESH_FRAMES &&
+        !gPipeline.hasRenderDebugMask(LLPipeline::RENDER_DEBUG_TRIANGLE_COUNT | LLPipeline::RENDER_DEBUG_LOD_INFO))
+    {
+        return false;
+    }
+    mLODUpdateDistance = distance;
+    mLODUpdateRadius = radius;
+    mLODUpdateScale = lod_scale;
+    mLODUpdateFrame = LLFrameTimer::getFrameCount();
+
     distance *= sDistanceFactor;
 
     F32 rampDist = LLVOVolume::sLODFactor * 2;
@@ -1716,6 +1837,7 @@ bool LLVOVolume::calcLOD()
 void LLVOVolume::forceLOD(S32 lod)
 {
     mLOD = lod;
+    mLODUpdateScale = 0.f; // reevaluate on the next update, as before
     gPipeline.markRebuild(mDrawable, LLDrawable::REBUILD_VOLUME);
     mLODChanged = true;
 }
@@ -4513,6 +4635,56 @@ void LLVOVolume::updateRenderComplexity()
     mRenderComplexity_current = 0;
 }
 
+// static
+void LLVOVolume::updateFaceOctrees()
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_VOLUME;
+
+    // Face octrees are only used for picking and are built by the first
+    // raycast against a face.  While the build tools are up, build the
+    // ones of the selection a few at a time so picking it doesn't hitch.
+    if (LLFloater::isVisible(gFloaterTools))
+    {
+        constexpr F64 PREBUILD_BUDGET = 0.002; // seconds per frame
+        F64 start = LLTimer::getTotalSeconds();
+        LLObjectSelectionHandle selection = LLSelectMgr::getInstance()->getSelection();
+        for (LLObjectSelection::iterator iter = selection->begin();
+             iter != selection->end() && (F64)LLTimer::getTotalSeconds() - start < PREBUILD_BUDGET; ++iter)
+        {
+            LLViewerObject* object = (*iter)->getObject();
+            LLVOVolume* vobj = (object && object->mDrawable) ? object->mDrawable->getVOVolume() : nullptr;
+            if (!vobj || vobj->mDrawable->isState(LLDrawable::RIGGED))
+            { // rigged octrees go stale with every pose
+                continue;
+            }
+
+            LLVolume* volume = vobj->getVolume();
+            for (S32 i = 0; volume && i < volume->getNumVolumeFaces(); ++i)
+            {
+                LLVolumeFace& face = volume->getVolumeFace(i);
+                if (LLVolumeFace::sUseBVH)
+                {
+                    face.useBVH();
+                }
+                else
+                {
+                    face.useOctree();
+                }
+            }
+        }
+    }
+
+    static LLFrameTimer evict_timer;
+    static LLCachedControl<F32> idle_time(gSavedSettings, "RenderFaceOctreeIdleTime", 60.f);
+    constexpr F32 EVICT_PERIOD = 10.f;
+    if (idle_time > 0.f && evict_timer.getElapsedTimeF32() > EVICT_PERIOD)
+    {
+        evict_timer.reset();
+        S32 count = LLPrimitive::getVolumeManager()->destroyIdleOctrees((F64)LLTimer::getTotalSeconds() - idle_time());
+        LL_DEBUGS("Volume") << "Freed " << count << " idle face octrees" << LL_ENDL;
+    }
+}
+
 U32 LLVOVolume::getTriangleCount(S32* vcount) const
 {
     U32 count = 0;
@@ -4785,6 +4957,7 @@ void LLVOVolume::markForUpdate()
 
     LLViewerObject::markForUpdate();
     mVolumeChanged = true;
+    mTexUpdateValid = false;
 }
 
 LLVector3 LLVOVolume::agentPositionToVolume(const LLVector3& pos) const
@@ -5168,9 +5341,21 @@ void LLRiggedVolume::update(
     LLSkinningUtil::initSkinningMatrixPalette(mat, maxJoints, skin, avatar);
     const LLMatrix4a bind_shape_matrix = skin->mBindShapeMatrix;
 
+    // anything skinned with a different pose or from different source faces is stale
+    if (copy ||
+        mFaceSkinned.size() != (size_t)volume->getNumVolumeFaces() ||
+        mPalette.size() != maxJoints ||
+        memcmp(mPalette.data(), mat, maxJoints * sizeof(LLMatrix4a)) != 0)
+    {
+        mPalette.assign(mat, mat + maxJoints);
+        mFaceSkinned.assign(volume->getNumVolumeFaces(), false);
+    }
+
     S32 rigged_vert_count = 0;
     S32 rigged_face_count = 0;
     LLVector4a box_min, box_max;
+    box_min.clear();
+    box_max.clear();
     S32 face_begin;
     S32 face_end;
     if (face_index == DO_NOT_UPDATE_FACES)
@@ -5196,6 +5381,15 @@ void LLRiggedVolume::update(
 
         LLVector4a* weight = vol_face.mWeights;
 
+        if (mFaceSkinned[i])
+        { // positions and extents are current, so is any octree
+            if (rebuild_face_octrees)
+            {
+                dst_face.createOctree();
+            }
+            continue;
+        }
+
         if ( weight )
         {
             LLSkinningUtil::checkSkinWeights(weight, dst_face.mNumVertices, skin);
@@ -5232,21 +5426,7 @@ void LLRiggedVolume::update(
                 else
             #endif
                 {
-                    for (S32 j = 0; j < dst_face.mNumVertices; ++j)
-                    {
-                        LLMatrix4a final_mat;
-                        // <FS:ND> Use the SSE2 version
-                        // LLSkinningUtil::getPerVertexSkinMatrix(weight[j].getF32ptr(), mat, false, final_mat, max_joints);
-                        FSSkinningUtil::getPerVertexSkinMatrixSSE(weight[j], mat, false, final_mat, max_joints);
-                        // </FS:ND>
-
-                        LLVector4a& v = vol_face.mPositions[j];
-                        LLVector4a t;
-                        LLVector4a dst;
-                        bind_shape_matrix.affineTransform(v, t);
-                        final_mat.affineTransform(t, dst);
-                        pos[j] = dst;
-                    }
+                    LLSkinningUtil::skinPositions(weight, vol_face.mPositions, dst_face.mNumVertices, mat, max_joints, bind_shape_matrix, pos);
                 }
 
                 //update bounding box
@@ -5274,11 +5454,14 @@ void LLRiggedVolume::update(
                 dst_face.mCenter->setAdd(dst_face.mExtents[0], dst_face.mExtents[1]);
                 dst_face.mCenter->mul(0.5f);
 
+                mFaceSkinned[i] = true;
             }
 
+            // the octree of the old pose is stale, without rebuild_face_octrees
+            // the next raycast builds a new one
+            dst_face.destroyOctree();
             if (rebuild_face_octrees)
             {
-                dst_face.destroyOctree();
                 // <FS:ND> Create a debug log for octree insertions if requested.
                 static LLCachedControl<bool> debugOctree(gSavedSettings,"FSCreateOctreeLog");
                 bool _debugOT( debugOctree );
@@ -5295,10 +5478,13 @@ void LLRiggedVolume::update(
             }
         }
     }
-    mExtraDebugText = llformat("rigged %d/%d - box (%f %f %f) (%f %f %f)",
-                               rigged_face_count, rigged_vert_count,
-                               box_min[0], box_min[1], box_min[2],
-                               box_max[0], box_max[1], box_max[2]);
+    if (rigged_face_count > 0)
+    { // keep the previous text when every face was already current
+        mExtraDebugText = llformat("rigged %d/%d - box (%f %f %f) (%f %f %f)",
+                                   rigged_face_count, rigged_vert_count,
+                                   box_min[0], box_min[1], box_min[2],
+                                   box_max[0], box_max[1], box_max[2]);
+    }
 }
 
 U32 LLVOVolume::getPartitionType() const
@@ -5609,6 +5795,29 @@ void LLVolumeGeometryManager::registerFace(LLSpatialGroup* group, LLFace* facep,
         }
     }
 
+    // dense faces with meshlets get a draw of their own so the meshlets facing
+    // away from the camera can be skipped, unless their back faces are drawn
+    std::shared_ptr<const LLVolumeFace::meshlet_list_t> meshlets;
+    static LLCachedControl<bool> meshlet_culling(gSavedSettings, "RenderMeshletCulling", true);
+    if (meshlet_culling &&
+        !rigged &&
+        type != LLRenderPass::PASS_ALPHA &&
+        !drawable->isState(LLDrawable::ANIMATED_CHILD) &&
+        (gltf_mat == nullptr || !gltf_mat->mDoubleSided))
+    {
+        LLVOVolume* vobj = drawable->getVOVolume();
+        LLVolume* volume = vobj ? vobj->getVolume() : nullptr;
+        S32 te_offset = facep->getTEOffset();
+        if (volume && te_offset >= 0 && te_offset < volume->getNumVolumeFaces())
+        {
+            const LLVolumeFace& vf = volume->getVolumeFace(te_offset);
+            if (vf.mMeshlets && vf.mNumIndices == (S32)facep->getIndicesCount())
+            {
+                meshlets = vf.mMeshlets;
+            }
+        }
+    }
+
     bool batchable = false;
 
     U32 shader_mask = 0xFFFFFFFF; //no shader
@@ -5658,6 +5867,8 @@ void LLVolumeGeometryManager::registerFace(LLSpatialGroup* group, LLFace* facep,
     LLDrawInfo* info = idx >= 0 ? draw_vec[idx] : nullptr;
 
     if (info &&
+        !meshlets &&
+        info->mMeshletCull.isNull() &&
         info->mVertexBuffer == facep->getVertexBuffer() &&
         info->mEnd == facep->getGeomIndex()-1 &&
         (LLPipeline::sTextureBindTest || draw_vec[idx]->mTexture == tex || batchable) &&
@@ -5721,6 +5932,11 @@ void LLVolumeGeometryManager::registerFace(LLSpatialGroup* group, LLFace* facep,
         draw_info->mAvatar = facep->mAvatar;
         draw_info->mSkinInfo = facep->mSkinInfo;
 
+        if (meshlets)
+        {
+            draw_info->mMeshletCull = new LLMeshletCull(meshlets, drawable->getVOVolume()->getRelativeXform(), offset);
+        }
+
         if (gltf_mat)
         {
             // just remember the material ID, render pools will reference the GLTF material
@@ -6359,6 +6575,8 @@ void LLVolumeGeometryManager::rebuildMesh(LLSpatialGroup* group)
 
             group->mBuilt = 1.f;
 
+            static LLCachedControl<bool> showSelectedinBP(gSavedSettings, "FSShowSelectedInBlinnPhong"); // <FS:Beq/>
+
             const U32 MAX_BUFFER_COUNT = 4096;
             LLVertexBuffer* locked_buffer[MAX_BUFFER_COUNT];
 
@@ -6400,7 +6618,9 @@ void LLVolumeGeometryManager::rebuildMesh(LLSpatialGroup* group)
                                     vobj->getRelativeXformInvTrans(), // mat_norm_in
                                     face->getGeomIndex(),             // index_offset
                                     false,                            // force_rebuild
-                                    true))                            // no_debug_assert
+                                    true,                             // no_debug_assert
+                                    false,                            // rebuild_for_gltf
+                                    showSelectedinBP))                // show_selected_in_bp
                                 {   // Something's gone wrong with the vertex buffer accounting,
                                     // rebuild this group with no debug assert because MESH_DIRTY
                                     group->dirtyGeom();
@@ -6543,6 +6763,33 @@ U32 LLVolumeGeometryManager::genDrawInfo(LLSpatialGroup* group, U32 mask, LLFace
 
     bool flexi = false;
 
+    // with RenderThreadedGeometry, vertex data for faces that don't touch GL or shared state is written
+    // by the General thread pool after batching, and buffers are unmapped (uploaded) once that's done
+    static LLCachedControl<bool> threaded_geometry(gSavedSettings, "RenderThreadedGeometry", false);
+    bool threaded = threaded_geometry;
+
+    // <FS:Beq> show legacy when editing the fallback materials.
+    // Read here rather than by the faces, which may be built by the General thread pool
+    static LLCachedControl<bool> showSelectedinBP(gSavedSettings, "FSShowSelectedInBlinnPhong");
+    const bool show_selected_in_bp = showSelectedinBP;
+    // </FS:Beq>
+
+    struct GeometryJob
+    {
+        LLFace* mFace;
+        U32 mTEOffset;
+        U16 mIndexOffset;
+    };
+
+    struct BufferJob
+    {
+        LLVertexBuffer* mBuffer;
+        std::vector<GeometryJob> mFaces;
+    };
+
+    std::vector<BufferJob> buffer_jobs;
+    std::vector<LLVertexBuffer*> pending_unmap;
+
     while (face_iter != end_faces)
     {
         //pull off next face
@@ -6756,22 +7003,35 @@ U32 LLVolumeGeometryManager::genDrawInfo(LLSpatialGroup* group, U32 mask, LLFace
                     LLVOVolume* vobj = drawablep->getVOVolume();
                     LLVolume* volume = vobj->getVolume();
 
-                    if (drawablep->isState(LLDrawable::ANIMATED_CHILD))
-                    {
-                        vobj->updateRelativeXform(true);
-                    }
-
                     U32 te_idx = facep->getTEOffset();
 
-                    if (!facep->getGeometryVolume(*volume, te_idx,
-                        vobj->getRelativeXform(), vobj->getRelativeXformInvTrans(), index_offset,true))
+                    if (threaded &&
+                        !drawablep->isState(LLDrawable::ANIMATED_CHILD) && // needs its relative xform temporarily swapped
+                        facep->prepareThreadedGeometry(te_idx))
                     {
-                        LL_WARNS() << "Failed to get geometry for face!" << LL_ENDL;
+                        if (buffer_jobs.empty() || buffer_jobs.back().mBuffer != buffer.get())
+                        {
+                            buffer_jobs.push_back({ buffer.get(), {} });
+                        }
+                        buffer_jobs.back().mFaces.push_back({ facep, te_idx, index_offset });
                     }
-
-                    if (drawablep->isState(LLDrawable::ANIMATED_CHILD))
+                    else
                     {
-                        vobj->updateRelativeXform(false);
+                        if (drawablep->isState(LLDrawable::ANIMATED_CHILD))
+                        {
+                            vobj->updateRelativeXform(true);
+                        }
+
+                        if (!facep->getGeometryVolume(*volume, te_idx,
+                            vobj->getRelativeXform(), vobj->getRelativeXformInvTrans(), index_offset, true, false, false, show_selected_in_bp))
+                        {
+                            LL_WARNS() << "Failed to get geometry for face!" << LL_ENDL;
+                        }
+
+                        if (drawablep->isState(LLDrawable::ANIMATED_CHILD))
+                        {
+                            vobj->updateRelativeXform(false);
+                        }
                     }
                 }
             }
@@ -6792,8 +7052,7 @@ U32 LLVolumeGeometryManager::genDrawInfo(LLSpatialGroup* group, U32 mask, LLFace
             LLGLTFMaterial* gltf_mat = te->getGLTFRenderMaterial();
 
             // <FS:Beq> show legacy when editing the fallback materials.
-            static LLCachedControl<bool> showSelectedinBP(gSavedSettings, "FSShowSelectedInBlinnPhong");
-            if( gltf_mat && facep->getViewerObject()->isSelected() && showSelectedinBP )
+            if( gltf_mat && facep->getViewerObject()->isSelected() && show_selected_in_bp )
             {
                 gltf_mat = nullptr;
             }
@@ -7131,10 +7390,41 @@ U32 LLVolumeGeometryManager::genDrawInfo(LLSpatialGroup* group, U32 mask, LLFace
 
         if (buffer)
         {
-            buffer->unmapBuffer();
+            if (threaded)
+            {
+                pending_unmap.push_back(buffer);
+            }
+            else
+            {
+                buffer->unmapBuffer();
+            }
         }
     }
 
+    if (!buffer_jobs.empty())
+    {
+        LL_PROFILE_ZONE_NAMED_CATEGORY_VOLUME("genDrawInfo - threaded geometry");
+
+        // one buffer per task so mapped region bookkeeping on each LLVertexBuffer stays single threaded
+        LL::parallel_for("General", buffer_jobs.size(), [&](size_t idx)
+            {
+                for (const GeometryJob& job : buffer_jobs[idx].mFaces)
+                {
+                    LLVOVolume* vobj = job.mFace->getDrawable()->getVOVolume();
+                    if (!job.mFace->getGeometryVolume(*vobj->getVolume(), job.mTEOffset,
+                        vobj->getRelativeXform(), vobj->getRelativeXformInvTrans(), job.mIndexOffset, true, false, false, show_selected_in_bp))
+                    {
+                        LL_WARNS() << "Failed to get geometry for face!" << LL_ENDL;
+                    }
+                }
+            });
+    }
+
+    for (LLVertexBuffer* buffer : pending_unmap)
+    {
+        buffer->unmapBuffer();
+    }
+
     group->mBufferMap[mask].clear();
     for (LLSpatialGroup::buffer_texture_map_t::iterator i = buffer_map[mask].begin(); i != buffer_map[mask].end(); ++i)
     {
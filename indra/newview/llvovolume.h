@@ -75,9 +75,15 @@ public:
         LLVOAvatar* avatar,
         const LLVolume* src_volume,
         FaceIndex face_index = UPDATE_ALL_FACES,
-        bool rebuild_face_octrees = true);
+        bool rebuild_face_octrees = false);
 
     std::string mExtraDebugText;
+
+private:
+    // palette the faces flagged in mFaceSkinned were skinned with, faces are only skinned
+    // again when a query needs them and the pose has changed since
+    std::vector<LLMatrix4a> mPalette;
+    std::vector<bool> mFaceSkinned;
 };
 
 // Base class for implementations of the volume - Primitive, Flexible Object, etc.
@@ -133,6 +139,12 @@ public:
 
                 void    animateTextures();
 
+                // Active volumes out of view or far away are updated only every few frames,
+                // staggered by local ID.  Their motion and texture animations are time based
+                // and catch up on the frame they get their turn.
+                U32     getIdleUpdatePeriod() const;
+                bool    isIdleUpdateDue() const;
+
                 bool    isVisible() const ;
     bool isActive() const override;
     bool isAttachment() const override;
@@ -410,11 +422,12 @@ public:
 
 
     // Rigged volume update (for raycasting)
-    // By default, this updates the bounding boxes of all the faces and builds an octree for precise per-triangle raycasting
+    // By default, this updates the bounding boxes of all the faces.  Octrees for precise per-triangle raycasting
+    // are built by the raycast itself unless rebuild_face_octrees is set.
     void updateRiggedVolume(
         bool force_treat_as_rigged,
         LLRiggedVolume::FaceIndex face_index = LLRiggedVolume::UPDATE_ALL_FACES,
-        bool rebuild_face_octrees = true);
+        bool rebuild_face_octrees = false);
     LLRiggedVolume* getRiggedVolume();
 
     //returns true if volume should be treated as a rigged volume
@@ -449,6 +462,8 @@ public:
 
     static S32 getRenderComplexityMax() {return mRenderComplexity_last;}
     static void updateRenderComplexity();
+    // Prebuild face octrees of the selection, free ones that went unused
+    static void updateFaceOctrees();
     //<FS:Beq> FIRE-21445
     void forceLOD(S32 lod);
     //</FS:Beq>
@@ -465,8 +480,23 @@ private:
     friend class LLFace;
     friend class LLViewerFetchedTexture;
 
+    // Record the camera relative metrics updateTextureVirtualSize() depends on, return
+    // true if they changed enough since the last time to compute the face sizes again
+    bool updateTextureMetrics();
+
     bool        mFaceMappingChanged;
     LLFrameTimer mTextureUpdateTimer;
+    // inputs of the last LOD evaluation, see calcLOD()
+    F32         mLODUpdateDistance;
+    F32         mLODUpdateRadius;
+    F32         mLODUpdateScale;
+    U32         mLODUpdateFrame;
+    // camera relative metrics at the last face size update, see updateTextureMetrics()
+    F32         mTexUpdateDistance;
+    F32         mTexUpdateRadius;
+    F32         mTexUpdateCosAngle;
+    F32         mTexUpdatePixelAngle;
+    bool        mTexUpdateValid;
     S32         mLOD;
     bool        mLODChanged;
     bool        mSculptChanged;
@@ -38,6 +38,7 @@
 #include "lldrawpool.h"
 #include "llglheaders.h"
 #include "llhttpnode.h"
+#include "llmemtag.h"
 #include "llregionhandle.h"
 #include "llsky.h"
 #include "llsurface.h"
@@ -603,6 +604,13 @@ LLViewerRegion* LLWorld::addRegion(const U64 &region_handle, const LLHost &host,
     mActiveRegionList.push_back(regionp);
     mCulledRegionList.push_back(regionp);
 
+    // Neighbours and teleport targets both arrive here well before their handshake,
+    // get their object cache read in the meantime
+    if (LLVOCache::instanceExists())
+    {
+        LLVOCache::getInstance()->prefetch(region_handle);
+    }
+
 
     // Find all the adjacent regions, and attach them.
     // Generate handles for all of the adjacent regions, and attach them in the correct way.
@@ -1129,6 +1137,7 @@ void LLWorld::updateRegions(F32 max_update_time)
         LLViewerRegion::sLastCameraUpdated = LLViewerOctreeEntryData::getCurrentFrame() + 1;
     }
     LLViewerRegion::calcNewObjectCreationThrottle();
+    updateMemoryPressure();
     if(LLViewerRegion::isNewObjectCreationThrottleDisabled())
     {
         max_update_time = llmax(max_update_time, 1.0f); //seconds, loosen the time throttle.
@@ -1188,6 +1197,76 @@ void LLWorld::updateRegions(F32 max_update_time)
     sample(sNumActiveCachedObjects, mNumOfActiveCachedObjects);
 }
 
+void LLWorld::updateMemoryPressure()
+{
+    static LLCachedControl<bool> enabled(gSavedSettings, "MemoryPressureEviction", true);
+    static LLCachedControl<U32> rss_limit_mb(gSavedSettings, "MemoryPressureRSSLimitMB", 0);
+    static LLCachedControl<F32> min_distance(gSavedSettings, "MemoryPressureMinDistance", 64.f);
+
+    // how far the radius moves per check, and how long memory has to be fine before it grows back
+    constexpr F32 CHECK_INTERVAL = 1.f;
+    constexpr F32 SHRINK_FACTOR = 0.75f;
+    constexpr F32 GROW_FACTOR = 1.25f;
+    constexpr F32 RELIEF_DELAY = 10.f;
+
+    if (mMemoryPressureTimer.getElapsedTimeF32() < CHECK_INTERVAL)
+    {
+        return;
+    }
+    mMemoryPressureTimer.reset();
+
+    const LLViewerTextureList::StreamingBudgetStats& texture_stats = gTextureList.getStreamingBudgetStats();
+    U64 rss = LLMemory::getCurrentRSS();
+    const char* reason = NULL;
+    if (LLViewerTexture::isSystemMemoryLow())
+    {
+        reason = "low system memory";
+    }
+    else if (rss_limit_mb > 0 && rss / (1024 * 1024) > rss_limit_mb)
+    {
+        reason = "over MemoryPressureRSSLimitMB";
+    }
+    else if (!LLViewerTexture::sInBackground &&
+             (texture_stats.mActive ? texture_stats.mAssignedBytes > texture_stats.mBudgetBytes
+                                    : LLViewerTexture::sDesiredDiscardBias >= 4.f))
+    { // textures are as small as they go and still don't fit in video memory
+        reason = "low video memory";
+    }
+
+    F32 draw_distance = gAgentCamera.mDrawDistance;
+    F32 floor = llclamp((F32)min_distance, 16.f, draw_distance);
+    if (!enabled || !LLViewerRegion::sVOCacheCullingEnabled)
+    {
+        reason = NULL;
+        mMemoryPressureRadius = 0.f;
+    }
+
+    if (reason)
+    {
+        mMemoryReliefTimer.reset();
+        if (mMemoryPressureRadius <= 0.f)
+        {
+            LL_WARNS("Memory") << "Memory is short (" << reason << "), sending far objects back to the object cache" << LL_ENDL;
+            LLMemTag::logUsage(reason);
+            mMemoryPressureStartRSS = rss;
+            mMemoryPressureDemotions = 0;
+            mMemoryPressureRadius = draw_distance;
+        }
+        mMemoryPressureRadius = llmax(mMemoryPressureRadius * SHRINK_FACTOR, floor);
+    }
+    else if (mMemoryPressureRadius > 0.f && mMemoryReliefTimer.getElapsedTimeF32() > RELIEF_DELAY)
+    {
+        mMemoryPressureRadius *= GROW_FACTOR;
+        mMemoryReliefTimer.reset();
+        if (mMemoryPressureRadius >= draw_distance)
+        {
+            mMemoryPressureRadius = 0.f;
+            LL_INFOS("Memory") << "Memory pressure over, " << mMemoryPressureDemotions << " objects went back to the object cache, resident memory "
+                               << mMemoryPressureStartRSS / (1024 * 1024) << " MB -> " << rss / (1024 * 1024) << " MB" << LL_ENDL;
+        }
+    }
+}
+
 void LLWorld::clearAllVisibleObjects()
 {
     for (region_list_t::iterator iter = mRegionList.begin();
@@ -1902,7 +1981,7 @@ F32 LLWorld::getNearbyAvatarsAndMaxGPUTime(std::vector<LLVOAvatar*> &valid_nearb
                 {
                     gPipeline.profileAvatar(avatar);
                 }
-                nearby_max_complexity = llmax(nearby_max_complexity, avatar->getGPURenderTime());
+                nearby_max_complexity = llmax(nearby_max_complexity, avatar->getGPURenderTime(), avatar->getGPUSceneTime());
                 valid_nearby_avs.push_back(avatar);
             }
         }
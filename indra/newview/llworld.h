@@ -33,6 +33,7 @@
 #define LL_LLWORLD_H
 
 #include "llpatchvertexarray.h"
+#include "llframetimer.h"
 
 #include "llmath.h"
 #include "v3math.h"
@@ -218,6 +219,10 @@ public:
     void getInfo(LLSD& info);
     U32  getNumOfActiveCachedObjects() const {return mNumOfActiveCachedObjects;}
 
+    // Objects farther than this go back to the object cache while memory is short, 0 when it isn't
+    F32  getMemoryPressureRadius() const { return mMemoryPressureRadius; }
+    void addMemoryPressureDemotions(U32 count) { mMemoryPressureDemotions += count; }
+
     void clearAllVisibleObjects();
 public:
     typedef std::list<LLViewerRegion*> region_list_t;
@@ -249,6 +254,7 @@ public:
 private:
     void clearHoleWaterObjects();
     void clearEdgeWaterObjects();
+    void updateMemoryPressure();
 
     region_list_t   mActiveRegionList;
     region_list_t   mRegionList;
@@ -312,6 +318,12 @@ private:
     U32 mNumOfActiveCachedObjects;
     U64MicrosecondsImplicit mSpaceTimeUSec;
 
+    F32 mMemoryPressureRadius = 0.f;
+    LLFrameTimer mMemoryPressureTimer;      // since the last check
+    LLFrameTimer mMemoryReliefTimer;        // since memory was last short
+    U32 mMemoryPressureDemotions = 0;       // objects sent back to the cache this episode
+    U64 mMemoryPressureStartRSS = 0;
+
     ////////////////////////////
     //
     // Data for "Fake" objects
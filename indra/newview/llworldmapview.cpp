@@ -194,6 +194,8 @@ LLWorldMapView::LLWorldMapView() :
     mPanY(0.f),
     mTargetPanX(0.f),
     mTargetPanY(0.f),
+    mLastDrawPanX(0.f),
+    mLastDrawPanY(0.f),
     mPanning(false),
     mMouseDownPanX(0),
     mMouseDownPanY(0),
@@ -793,9 +795,63 @@ void LLWorldMapView::drawMipmap(S32 width, S32 height)
     // Render the current level
     sVisibleTilesLoaded = drawMipmapLevel(width, height, level);
 
+    // Fetch the tiles the view is about to uncover while it's being moved
+    F32 pan_dx = mPanX - mLastDrawPanX;
+    F32 pan_dy = mPanY - mLastDrawPanY;
+    mLastDrawPanX = mPanX;
+    mLastDrawPanY = mPanY;
+    if (pan_dx != 0.f || pan_dy != 0.f)
+    {
+        prefetchMipmapLevel(width, height, level, pan_dx, pan_dy);
+    }
+
     return;
 }
 
+void LLWorldMapView::prefetchMipmapLevel(S32 width, S32 height, S32 level, F32 pan_dx, F32 pan_dy)
+{
+    static LLCachedControl<U32> prefetch_bands(gSavedSettings, "MapTilePrefetchBands", 1);
+    if (!prefetch_bands)
+    {
+        return;
+    }
+
+    // Same tile walk as drawMipmapLevel(), which already covers the partially displayed tiles right and top
+    S32 tile_width = LLWorldMipmap::MAP_TILE_SIZE * (1 << (level - 1));
+    LLVector3d pos_SW = viewPosToGlobal(0, 0);
+    LLVector3d pos_NE = viewPosToGlobal(width, height);
+    pos_NE[VX] += tile_width;
+    pos_NE[VY] += tile_width;
+
+    // Panning moves the map under the view, so the view travels against the pan
+    F64 band = (F64)tile_width * (F64)(U32)prefetch_bands;
+    F64 min_x = pos_SW[VX] - (pan_dx > 0.f ? band : 0.0);
+    F64 max_x = pos_NE[VX] + (pan_dx < 0.f ? band : 0.0);
+    F64 min_y = pos_SW[VY] - (pan_dy > 0.f ? band : 0.0);
+    F64 max_y = pos_NE[VY] + (pan_dy < 0.f ? band : 0.0);
+
+    LLWorldMap* world_map = LLWorldMap::getInstance();
+    U32 grid_x, grid_y;
+    for (F64 index_y = min_y; index_y < max_y; index_y += tile_width)
+    {
+        bool visible_row = index_y >= pos_SW[VY] && index_y < pos_NE[VY];
+        for (F64 index_x = min_x; index_x < max_x; index_x += tile_width)
+        {
+            if (visible_row && index_x >= pos_SW[VX] && index_x < pos_NE[VX])
+            {
+                // drawMipmapLevel() already asked for it
+                continue;
+            }
+            if (index_x < 0.0 || index_y < 0.0)
+            {
+                continue;
+            }
+            LLWorldMipmap::globalToMipmap(index_x, index_y, level, &grid_x, &grid_y);
+            world_map->prefetchObjectsTile(grid_x, grid_y, level);
+        }
+    }
+}
+
 // Return true if all the tiles required to render that level have been fetched or are truly missing
 bool LLWorldMapView::drawMipmapLevel(S32 width, S32 height, S32 level, bool load)
 {
@@ -819,6 +875,8 @@ bool LLWorldMapView::drawMipmapLevel(S32 width, S32 height, S32 level, bool load
 
     // Iterate through the tiles on screen: we just need to ask for one tile every tile_width meters
     LLWorldMap* world_map = LLWorldMap::getInstance(); // <FS:Ansariel> Performance tweak
+    // Every tile is drawn with the same state, only the bound texture changes
+    LLGLSUIDefault gls_ui;
     U32 grid_x, grid_y;
     for (F64 index_y = pos_SW[VY]; index_y < pos_NE[VY]; index_y += tile_width)
     {
@@ -856,7 +914,6 @@ bool LLWorldMapView::drawMipmapLevel(S32 width, S32 height, S32 level, bool load
                     F32 top    = pos_screen[VY];
 
                     // Draw the tile
-                    LLGLSUIDefault gls_ui;
                     gGL.getTexUnit(0)->bind(simimage.get());
                     simimage->setAddressMode(LLTexUnit::TAM_CLAMP);
 
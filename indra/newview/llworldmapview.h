@@ -97,6 +97,7 @@ public:
     void            drawFrustum();
     void            drawMipmap(S32 width, S32 height);
     bool            drawMipmapLevel(S32 width, S32 height, S32 level, bool load = true);
+    void            prefetchMipmapLevel(S32 width, S32 height, S32 level, F32 pan_dx, F32 pan_dy);
 
     static void     cleanupTextures();
 
@@ -169,6 +170,8 @@ public:
     F32 mPanY; // in pixels
     F32 mTargetPanX; // in pixels
     F32 mTargetPanY; // in pixels
+    F32 mLastDrawPanX; // mPanX at the previous drawMipmap(), for the direction of movement
+    F32 mLastDrawPanY;
     static S32      sTrackingArrowX;
     static S32      sTrackingArrowY;
     static bool     sVisibleTilesLoaded;
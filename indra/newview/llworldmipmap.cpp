@@ -186,6 +186,27 @@ LLPointer<LLViewerFetchedTexture> LLWorldMipmap::getObjectsTile(U32 grid_x, U32
     }
 }
 
+void LLWorldMipmap::prefetchObjectsTile(U32 grid_x, U32 grid_y, S32 level)
+{
+    // Check the input data
+    llassert(level <= MAP_LEVELS);
+    llassert(level >= 1);
+
+    U64 handle = convertGridToHandle(grid_x, grid_y);
+    sublevel_tiles_t& level_mipmap = mWorldObjectsMipMap[level-1];
+    sublevel_tiles_t::iterator found = level_mipmap.find(handle);
+    if (found == level_mipmap.end())
+    {
+        // loadObjectsTile() leaves it at BOOST_MAP
+        level_mipmap.insert(sublevel_tiles_t::value_type(handle, loadObjectsTile(grid_x, grid_y, level)));
+    }
+    else if (found->second->getBoostLevel() != LLGLTexture::BOOST_MAP_VISIBLE)
+    {
+        // Keep it fetching through the next equalizeBoostLevels() without outranking visible tiles
+        found->second->setBoostLevel(LLGLTexture::BOOST_MAP);
+    }
+}
+
 //static
 LLPointer<LLViewerFetchedTexture> LLWorldMipmap::loadObjectsTile(U32 grid_x, U32 grid_y, S32 level)
 {
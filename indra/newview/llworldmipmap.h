@@ -67,6 +67,8 @@ public:
     void    dropBoostLevels();
     // Get the tile smart pointer, does the loading if necessary
     LLPointer<LLViewerFetchedTexture> getObjectsTile(U32 grid_x, U32 grid_y, S32 level, bool load = true);
+    // Start loading a tile that isn't on screen yet but is about to be, without marking it visible
+    void    prefetchObjectsTile(U32 grid_x, U32 grid_y, S32 level);
 
     // Helper functions: those are here as they depend solely on the topology of the mipmap though they don't access it
     // Convert sim scale (given in sim width in display pixels) into a mipmap level
@@ -50,6 +50,8 @@
 #include "llagent.h"
 #include "llagentcamera.h"
 #include "llappviewer.h"
+#include "llavatargputimer.h"
+#include "llgpupasstimer.h"
 #include "lltexturecache.h"
 #include "lltexturefetch.h"
 #include "llimageworker.h"
@@ -60,6 +62,7 @@
 #include "lldrawpooltree.h"
 #include "lldrawpoolwater.h"
 #include "llface.h"
+#include "llflexibleobject.h"
 #include "llfeaturemanager.h"
 #include "llfloatertelehub.h"
 #include "llfloaterreg.h"
@@ -100,6 +103,7 @@
 #include "llviewerjoystick.h"
 #include "llviewerdisplay.h"
 #include "llspatialpartition.h"
+#include "llterrainheightfield.h"
 #include "llmutelist.h"
 #include "lltoolpie.h"
 #include "llnotifications.h"
@@ -110,6 +114,7 @@
 // #include "llpanelface.h"  // <FS:Zi> switchable edit texture/materials panel - include not needed
 #include "llpathfindingpathtool.h"
 #include "llscenemonitor.h"
+#include "parallelfor.h"
 #include "llprogressview.h"
 #include "llcleanup.h"
 #include "gltfscenemanager.h"
@@ -320,6 +325,7 @@ bool    LLPipeline::sBakeSunlight = false;
 bool    LLPipeline::sNoAlpha = false;
 bool    LLPipeline::sUseFarClip = true;
 bool    LLPipeline::sShadowRender = false;
+U32     LLPipeline::sShadowCachePass = LLPipeline::SHADOW_CACHE_NONE;
 bool    LLPipeline::sRenderGlow = false;
 bool    LLPipeline::sReflectionRender = false;
 bool    LLPipeline::sDistortionRender = false;
@@ -698,6 +704,10 @@ void LLPipeline::cleanup()
 
     mReflectionMapManager.cleanup();
     mHeroProbeManager.cleanup();
+    mGPUOcclusionCuller.cleanup();
+    mGPUSkinning.cleanup();
+    mImpostorAtlas.cleanup();
+    mClusteredLighting.cleanup();
 }
 
 //============================================================================
@@ -717,6 +727,19 @@ void LLPipeline::destroyGL()
         glDeleteQueries(1, &mMeshDirtyQueryObject);
         mMeshDirtyQueryObject = 0;
     }
+
+    for (const SceneTimer& timer : mSceneTimers)
+    {
+        mFreeSceneQueries.push_back(timer.mStart);
+        mFreeSceneQueries.push_back(timer.mEnd);
+    }
+    mSceneTimers.clear();
+    mSceneTimerOpen = false;
+    if (!mFreeSceneQueries.empty())
+    {
+        glDeleteQueries((GLsizei)mFreeSceneQueries.size(), mFreeSceneQueries.data());
+        mFreeSceneQueries.clear();
+    }
 }
 
 void LLPipeline::requestResizeScreenTexture()
@@ -752,10 +775,10 @@ void LLPipeline::resizeScreenTexture()
             scaledResX /= RenderResolutionDivisor;
             scaledResY /= RenderResolutionDivisor;
         }
-        else if (RenderResolutionMultiplier > 0.f && RenderResolutionMultiplier < 1.f)
+        else if (getResolutionScale() < 1.f)
         {
-            scaledResX = (GLuint)(scaledResX * RenderResolutionMultiplier);
-            scaledResY = (GLuint)(scaledResY * RenderResolutionMultiplier);
+            scaledResX = (GLuint)(scaledResX * getResolutionScale());
+            scaledResY = (GLuint)(scaledResY * getResolutionScale());
         }
 // [/SL:KB]
 
@@ -773,6 +796,127 @@ void LLPipeline::resizeScreenTexture()
     }
 }
 
+F32 LLPipeline::getResolutionScale(bool dynamic) const
+{
+    F32 scale = (RenderResolutionMultiplier > 0.f && RenderResolutionMultiplier < 1.f) ? RenderResolutionMultiplier : 1.f;
+    return dynamic ? scale * mDynamicResolutionScale : scale;
+}
+
+// Results of scene timers that are more than this many frames behind are dropped
+static const size_t MAX_PENDING_SCENE_TIMERS = 4;
+// Scale steps, so small swings in GPU time don't reallocate the screen buffers
+static const F32 DYNAMIC_RESOLUTION_STEP = 0.05f;
+// Reallocating the screen buffers costs a frame, don't do it more often than this
+static const F64 DYNAMIC_RESOLUTION_INTERVAL = 2.0;
+
+void LLPipeline::beginSceneTimer()
+{
+    static LLCachedControl<bool> dynamic_resolution(gSavedSettings, "RenderDynamicResolution", false);
+    if (mSceneTimerOpen)
+    {
+        // the last frame didn't get to endSceneTimer(), start over
+        glQueryCounter(mSceneTimers.back().mStart, GL_TIMESTAMP);
+        return;
+    }
+    if (!dynamic_resolution || mSceneTimers.size() >= MAX_PENDING_SCENE_TIMERS)
+    {
+        return;
+    }
+
+    if (mFreeSceneQueries.size() < 2)
+    {
+        GLuint queries[2];
+        glGenQueries(2, queries);
+        mFreeSceneQueries.insert(mFreeSceneQueries.end(), queries, queries + 2);
+    }
+    SceneTimer timer;
+    timer.mStart = mFreeSceneQueries.back();
+    mFreeSceneQueries.pop_back();
+    timer.mEnd = mFreeSceneQueries.back();
+    mFreeSceneQueries.pop_back();
+
+    // timestamps rather than GL_TIME_ELAPSED, which can't nest with shader profiling
+    glQueryCounter(timer.mStart, GL_TIMESTAMP);
+    mSceneTimers.push_back(timer);
+    mSceneTimerOpen = true;
+}
+
+void LLPipeline::endSceneTimer()
+{
+    if (mSceneTimerOpen)
+    {
+        glQueryCounter(mSceneTimers.back().mEnd, GL_TIMESTAMP);
+        mSceneTimerOpen = false;
+    }
+    updateDynamicResolution();
+}
+
+void LLPipeline::updateDynamicResolution()
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_DISPLAY;
+    static LLCachedControl<bool> dynamic_resolution(gSavedSettings, "RenderDynamicResolution", false);
+    static LLCachedControl<F32> target_ms(gSavedSettings, "RenderDynamicResolutionTargetMs", 14.f);
+    static LLCachedControl<F32> min_scale(gSavedSettings, "RenderDynamicResolutionMin", 0.5f);
+
+    // timers finish in order, stop at the first one that isn't ready
+    while (mSceneTimers.size() > (mSceneTimerOpen ? 1 : 0))
+    {
+        const SceneTimer& timer = mSceneTimers.front();
+        GLuint available = GL_FALSE;
+        glGetQueryObjectuiv(timer.mEnd, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+        {
+            break;
+        }
+
+        GLuint64 start = 0;
+        GLuint64 end = 0;
+        glGetQueryObjectui64v(timer.mStart, GL_QUERY_RESULT, &start);
+        glGetQueryObjectui64v(timer.mEnd, GL_QUERY_RESULT, &end);
+        F32 ms = (end - start) / 1000000.f;
+        mSceneGPUMs = mSceneGPUMs > 0.f ? lerp(mSceneGPUMs, ms, 0.1f) : ms;
+
+        mFreeSceneQueries.push_back(timer.mStart);
+        mFreeSceneQueries.push_back(timer.mEnd);
+        mSceneTimers.pop_front();
+    }
+
+    F32 scale = mDynamicResolutionScale;
+    if (!dynamic_resolution)
+    {
+        scale = 1.f;
+    }
+    else if (mSceneGPUMs > 0.f && LLTimer::getElapsedSeconds() - mDynamicResolutionChangeTime > DYNAMIC_RESOLUTION_INTERVAL &&
+             (mSceneGPUMs > target_ms * 1.1f || mSceneGPUMs < target_ms * 0.75f))
+    {
+        // GPU time mostly follows the pixel count, which goes with the square of the scale
+        scale *= sqrtf(target_ms / mSceneGPUMs);
+        scale = llclamp(ll_round(scale / DYNAMIC_RESOLUTION_STEP) * DYNAMIC_RESOLUTION_STEP, llclamp((F32)min_scale, 0.25f, 1.f), 1.f);
+    }
+
+    if (scale != mDynamicResolutionScale)
+    {
+        LL_DEBUGS("Pipeline") << "Scene GPU time " << mSceneGPUMs << " ms, resolution scale " << mDynamicResolutionScale
+                              << " -> " << scale << LL_ENDL;
+        mDynamicResolutionScale = scale;
+        mDynamicResolutionChangeTime = LLTimer::getElapsedSeconds();
+        // measure again at the new resolution
+        mSceneGPUMs = 0.f;
+        gResizeScreenTexture = true;
+    }
+}
+
+void LLPipeline::resetDynamicResolution()
+{
+    mDynamicResolutionChangeTime = LLTimer::getElapsedSeconds();
+    mSceneGPUMs = 0.f;
+    if (mDynamicResolutionScale < 1.f)
+    {
+        mDynamicResolutionScale = 1.f;
+        resizeScreenTexture();
+    }
+}
+
 bool LLPipeline::allocateScreenBuffer(U32 resX, U32 resY)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_DISPLAY;
@@ -898,10 +1042,10 @@ bool LLPipeline::allocateScreenBuffer(U32 resX, U32 resY, U32 samples)
         resY /= res_mod;
     }
 // [SL:KB] - Patch: Settings-RenderResolutionMultiplier | Checked: Catznip-5.4
-    else if (RenderResolutionMultiplier > 0.f && RenderResolutionMultiplier < 1.f)
+    else if (getResolutionScale(mRT == &mMainRT) < 1.f)
     {
-        resX = (GLuint)(resX * RenderResolutionMultiplier);
-        resY = (GLuint)(resY * RenderResolutionMultiplier);
+        resX = (GLuint)(resX * getResolutionScale(mRT == &mMainRT));
+        resY = (GLuint)(resY * getResolutionScale(mRT == &mMainRT));
     }
 // [/SL:KB]
 
@@ -1238,6 +1382,12 @@ void LLPipeline::releaseGLBuffers()
     }
 
     mHeroProbeManager.cleanup(); // release hero probes
+    mGPUOcclusionCuller.cleanup();
+    mGPUSkinning.cleanup();
+    mClusteredLighting.cleanup();
+    LLTerrainHeightfield::destroyGL();
+    LLVOTree::destroyInstanceMeshes();
+    LLDrawPoolTree::destroyGL();
 
     releaseScreenBuffers();
 
@@ -1292,6 +1442,12 @@ void LLPipeline::releaseSunShadowTarget(U32 index)
 {
     llassert(index < 4);
     mRT->shadow[index].release();
+
+    if (mRT == &mMainRT)
+    {
+        mSunShadowCache[index].mDepth.release();
+        mSunShadowCache[index].mValid = false;
+    }
 }
 
 void LLPipeline::releaseSunShadowTargets()
@@ -2442,6 +2598,11 @@ void LLPipeline::updateCull(LLCamera& camera, LLCullResult& result, bool hud_att
 
     grabReferences(result);
 
+    if (LLViewerCamera::sCurCameraID == LLViewerCamera::CAMERA_WORLD && !sShadowRender && !gCubeSnapshot)
+    { // pick up GPU occlusion results from previous frames before traversing
+        mGPUOcclusionCuller.readBack();
+    }
+
     sCull->clear();
 
     for (LLWorld::region_list_t::const_iterator iter = LLWorld::getInstance()->getRegionList().begin();
@@ -2609,6 +2770,27 @@ void LLPipeline::doOcclusion(LLCamera& camera)
 
         LLGLDisable cull(GL_CULL_FACE);
 
+        bool gpu_cull = LLGPUOcclusionCuller::isEnabled() && LLViewerCamera::sCurCameraID == LLViewerCamera::CAMERA_WORLD && !sShadowRender;
+        auto use_gpu_cull = [&](LLSpatialGroup* group)
+        {
+            return gpu_cull && group->getSpatialPartition()->isOcclusionEnabled() && LLGPUOcclusionCuller::canCull(group, camera);
+        };
+
+        if (gpu_cull)
+        { // test everything the compute pass can handle in one dispatch instead of one query per group
+            mGPUCullGroups.clear();
+            for (LLCullResult::sg_iterator iter = sCull->beginOcclusionGroups(); iter != sCull->endOcclusionGroups(); ++iter)
+            {
+                LLSpatialGroup* group = *iter;
+                if (!group->isDead() && use_gpu_cull(group))
+                {
+                    mGPUCullGroups.push_back(group);
+                }
+            }
+
+            mGPUOcclusionCuller.cull(camera, mGPUCullGroups, mRT->deferredScreen);
+        }
+
         gOcclusionCubeProgram.bind();
 
         if (mCubeVB.isNull())
@@ -2622,7 +2804,10 @@ void LLPipeline::doOcclusion(LLCamera& camera)
             LLSpatialGroup* group = *iter;
             if (!group->isDead())
             {
-                group->doOcclusion(&camera);
+                if (!use_gpu_cull(group))
+                {
+                    group->doOcclusion(&camera);
+                }
                 group->clearOcclusionState(LLSpatialGroup::ACTIVE_OCCLUSION);
             }
         }
@@ -2758,6 +2943,7 @@ void LLPipeline::rebuildPriorityGroups()
         group->rebuildGeom();
         group->clearState(LLSpatialGroup::IN_BUILD_Q1);
     }
+    add(LLStatViewer::GROUPS_REBUILT, mGroupQ1.size());
 
     mGroupSaveQ1 = mGroupQ1;
     mGroupQ1.clear();
@@ -2765,6 +2951,91 @@ void LLPipeline::rebuildPriorityGroups()
 
 }
 
+void LLPipeline::rebuildGroups(F32 max_ms)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_PIPELINE;
+    LL_PROFILE_GPU_ZONE("rebuildGroups");
+
+    assertInitialized();
+
+    gMeshRepo.notifyLoadedMeshes();
+
+    // HUDs first since they're always in your face, then groups on screen this frame, then by projected size
+    auto importance = [](LLSpatialGroup* group)
+    {
+        if (group->isHUDGroup())
+        {
+            return F32_MAX;
+        }
+        return group->isVisible() ? group->mPixelArea + 1.f : 0.f;
+    };
+
+    mRebuildQueue.clear();
+
+    for (LLCullResult::sg_iterator i = sCull->beginDrawableGroups(); i != sCull->endDrawableGroups(); ++i)
+    {
+        LLSpatialGroup* group = *i;
+        if (!group->isDead() &&
+            group->hasState(LLSpatialGroup::GEOM_DIRTY) &&
+            !group->hasState(LLSpatialGroup::IN_BUILD_Q1) &&
+            (!sUseOcclusion || !group->isOcclusionState(LLSpatialGroup::OCCLUDED)))
+        {
+            mRebuildQueue.push_back({ group, importance(group), false });
+        }
+    }
+
+    mGroupQ1Locked = true;
+
+    for (LLSpatialGroup* group : mGroupQ1)
+    {
+        mRebuildQueue.push_back({ group, importance(group), true });
+    }
+
+    std::stable_sort(mRebuildQueue.begin(), mRebuildQueue.end(),
+        [](const RebuildEntry& lhs, const RebuildEntry& rhs)
+        {
+            return lhs.mImportance > rhs.mImportance;
+        });
+
+    LLTimer timer;
+    F32 max_seconds = max_ms * 0.001f;
+    U32 rebuilt = 0;
+
+    mGroupSaveQ1.clear();
+    LLSpatialGroup::sg_vector_t deferred;
+
+    for (const RebuildEntry& entry : mRebuildQueue)
+    {
+        LLSpatialGroup* group = entry.mGroup;
+
+        // always make some progress, even if a single group blows the budget
+        bool out_of_time = rebuilt > 0 && timer.getElapsedTimeF32() > max_seconds;
+
+        if (out_of_time && !group->isDead())
+        { // leave it for a later frame, visible groups come back on their own through the cull
+            if (entry.mFromQ1)
+            {
+                deferred.push_back(group);
+            }
+            continue;
+        }
+
+        group->rebuildGeom();
+        ++rebuilt;
+
+        if (entry.mFromQ1)
+        {
+            group->clearState(LLSpatialGroup::IN_BUILD_Q1);
+            mGroupSaveQ1.push_back(group);
+        }
+    }
+
+    add(LLStatViewer::GROUPS_REBUILT, rebuilt);
+
+    mGroupQ1.swap(deferred);
+    mGroupQ1Locked = false;
+}
+
 void LLPipeline::updateGeom(F32 max_dtime)
 {
     LLTimer update_timer;
@@ -2782,6 +3053,9 @@ void LLPipeline::updateGeom(F32 max_dtime)
     // for now, only LLVOVolume does this to throttle LOD changes
     LLVOVolume::preUpdateGeom();
 
+    // simulate flexies in parallel up front, their geometry updates below pick up the results
+    LLVolumeImplFlexible::simulateQueued();
+
     // Iterate through all drawables on the priority build queue,
     for (LLDrawable::drawable_list_t::iterator iter = mBuildQ1.begin();
          iter != mBuildQ1.end();)
@@ -3141,6 +3415,7 @@ void LLPipeline::stateSort(LLCamera& camera, LLCullResult &result)
     }
     {
         LL_PROFILE_ZONE_NAMED_CATEGORY_PIPELINE("StateSort: visible groups");
+    mStateSortGroups.clear();
     for (LLCullResult::sg_iterator iter = sCull->beginVisibleGroups(); iter != sCull->endVisibleGroups(); ++iter)
     {
         LLSpatialGroup* group = *iter;
@@ -3156,13 +3431,22 @@ void LLPipeline::stateSort(LLCamera& camera, LLCullResult &result)
         else
         {
             group->setVisible();
-            stateSort(group, camera);
+            mStateSortGroups.push_back(group);
+        }
+    }
 
-            { //rebuild mesh as soon as we know it's visible
-                group->rebuildMesh();
-            }
+    calcStateSortDistances(camera);
+
+    for (LLSpatialGroup* group : mStateSortGroups)
+    {
+        stateSort(group, camera);
+
+        { //rebuild mesh as soon as we know it's visible
+            group->rebuildMesh();
         }
-    }}
+    }
+    mDistancesPrecomputed = false;
+    }
 
     {
         LL_PROFILE_ZONE_NAMED_CATEGORY_DRAWABLE("stateSort"); // LL_RECORD_BLOCK_TIME(FTM_STATESORT_DRAWABLE);
@@ -3180,6 +3464,59 @@ void LLPipeline::stateSort(LLCamera& camera, LLCullResult &result)
     postSort(camera);
 }
 
+// Compute camera distances for the drawables of every group gathered in mStateSortGroups
+// on the "General" thread pool so that stateSort(LLDrawable*) only has to apply the LOD
+// changes, which touch shared pipeline state and must stay on the main thread.
+void LLPipeline::calcStateSortDistances(LLCamera& camera)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_PIPELINE;
+
+    mDistancesPrecomputed = false;
+
+    static LLCachedControl<bool> parallel_state_sort(gSavedSettings, "RenderParallelStateSort", true);
+    static LLCachedControl<U32> min_drawables(gSavedSettings, "RenderParallelStateSortMinDrawables", 256);
+    if (!parallel_state_sort || gShiftFrame ||
+        LLViewerCamera::sCurCameraID != LLViewerCamera::CAMERA_WORLD || gCubeSnapshot)
+    {
+        return;
+    }
+
+    mStateSortDrawables.clear();
+    for (LLSpatialGroup* group : mStateSortGroups)
+    {
+        if (!group->changeLOD())
+        {
+            continue;
+        }
+
+        for (LLSpatialGroup::element_iter i = group->getDataBegin(); i != group->getDataEnd(); ++i)
+        {
+            LLDrawable* drawablep = (LLDrawable*)(*i)->getDrawable();
+            // same selection as the updateDistance calls in stateSort(LLDrawable*)
+            if (drawablep && !drawablep->isDead() && !drawablep->isSpatialBridge() &&
+                hasRenderType(drawablep->getRenderType()) &&
+                (!drawablep->isActive() || drawablep->isAvatar()))
+            {
+                mStateSortDrawables.push_back(drawablep);
+            }
+        }
+    }
+
+    if (mStateSortDrawables.size() < min_drawables)
+    {
+        return;
+    }
+
+    const LLVector3 viewer_camera_origin = LLViewerCamera::getInstance()->getOrigin();
+    LL::parallel_for("General", mStateSortDrawables.size(),
+        [this, &camera, &viewer_camera_origin](size_t i)
+        {
+            mStateSortDrawables[i]->calcDistance(camera, viewer_camera_origin, false);
+        }, 32);
+
+    mDistancesPrecomputed = true;
+}
+
 void LLPipeline::stateSort(LLSpatialGroup* group, LLCamera& camera)
 {
     if (group->changeLOD())
@@ -3270,7 +3607,11 @@ void LLPipeline::stateSort(LLDrawable* drawablep, LLCamera& camera)
     {
         //if (drawablep->isVisible()) isVisible() check here is redundant, if it wasn't visible, it wouldn't be here
         {
-            if (!drawablep->isActive())
+            if (mDistancesPrecomputed && !drawablep->isSpatialBridge() && (!drawablep->isActive() || drawablep->isAvatar()))
+            { // distance already computed by calcStateSortDistances
+                drawablep->getVObj()->updateLOD();
+            }
+            else if (!drawablep->isActive())
             {
                 bool force_update = false;
                 drawablep->updateDistance(camera, force_update);
@@ -3525,24 +3866,39 @@ void LLPipeline::postSort(LLCamera &camera)
 
     if (!gCubeSnapshot)
     {
-        // rebuild drawable geometry
-        for (LLCullResult::sg_iterator i = sCull->beginDrawableGroups(); i != sCull->endDrawableGroups(); ++i)
+        static LLCachedControl<F32> rebuild_budget(gSavedSettings, "RenderRebuildBudgetMs", 0.f);
+        if (rebuild_budget > 0.f)
         {
-            LLSpatialGroup *group = *i;
-            if (group->isDead())
-            {
-                continue;
-            }
-            if (!sUseOcclusion || !group->isOcclusionState(LLSpatialGroup::OCCLUDED))
+            sCull->assertDrawMapsEmpty();
+            rebuildGroups(rebuild_budget);
+        }
+        else
+        {
+            // rebuild drawable geometry
+            for (LLCullResult::sg_iterator i = sCull->beginDrawableGroups(); i != sCull->endDrawableGroups(); ++i)
             {
-                group->rebuildGeom();
+                LLSpatialGroup *group = *i;
+                if (group->isDead())
+                {
+                    continue;
+                }
+                if (!sUseOcclusion || !group->isOcclusionState(LLSpatialGroup::OCCLUDED))
+                {
+                    if (group->hasState(LLSpatialGroup::GEOM_DIRTY))
+                    {
+                        add(LLStatViewer::GROUPS_REBUILT, 1);
+                    }
+                    group->rebuildGeom();
+                }
             }
+            LL_PUSH_CALLSTACKS();
+            // rebuild groups
+            sCull->assertDrawMapsEmpty();
+
+            rebuildPriorityGroups();
         }
-        LL_PUSH_CALLSTACKS();
-        // rebuild groups
-        sCull->assertDrawMapsEmpty();
 
-        rebuildPriorityGroups();
+        sample(LLStatViewer::REBUILD_QUEUE_DEPTH, mGroupQ1.size());
     }
 
     LL_PUSH_CALLSTACKS();
@@ -3571,6 +3927,12 @@ void LLPipeline::postSort(LLCamera &camera)
             group->rebuildGeom();
         }
 
+        if (sShadowCachePass != SHADOW_CACHE_NONE &&
+            group->getSpatialPartition()->isBridge() != (sShadowCachePass == SHADOW_CACHE_DYNAMIC))
+        { // cached sun shadows render static and dynamic casters in separate passes
+            continue;
+        }
+
         for (LLSpatialGroup::draw_map_t::iterator j = group->mDrawMap.begin(); j != group->mDrawMap.end(); ++j)
         {
             LLSpatialGroup::drawmap_elem_t &src_vec = j->second;
@@ -3668,11 +4030,23 @@ void LLPipeline::postSort(LLCamera &camera)
         LL_PROFILE_ZONE_NAMED_CATEGORY_PIPELINE("sort alpha groups");
     if (!sShadowRender)
     {
-        // order alpha groups by distance
-        std::sort(sCull->beginAlphaGroups(), sCull->endAlphaGroups(), LLSpatialGroup::CompareDepthGreater());
+        if (!gCubeSnapshot && !sReflectionRender && !sImpostorRender)
+        {
+            // order alpha groups by distance, starting from last frame's order since the main view
+            // sees mostly the same groups from frame to frame
+            mAlphaGroupOrder.sort(sCull->beginAlphaGroups(), sCull->endAlphaGroups(), LLSpatialGroup::CompareDepthGreater(), &camera);
+
+            // order rigged alpha groups by avatar attachment order
+            mRiggedAlphaGroupOrder.sort(sCull->beginRiggedAlphaGroups(), sCull->endRiggedAlphaGroups(), LLSpatialGroup::CompareRenderOrder(), NULL);
+        }
+        else
+        {
+            // order alpha groups by distance
+            std::sort(sCull->beginAlphaGroups(), sCull->endAlphaGroups(), LLSpatialGroup::CompareDepthGreater());
 
-        // order rigged alpha groups by avatar attachment order
-        std::sort(sCull->beginRiggedAlphaGroups(), sCull->endRiggedAlphaGroups(), LLSpatialGroup::CompareRenderOrder());
+            // order rigged alpha groups by avatar attachment order
+            std::sort(sCull->beginRiggedAlphaGroups(), sCull->endRiggedAlphaGroups(), LLSpatialGroup::CompareRenderOrder());
+        }
     }
     }
 
@@ -3952,6 +4326,7 @@ void LLPipeline::renderGeomDeferred(LLCamera& camera, bool do_occlusion)
     LLAppViewer::instance()->pingMainloopTimeout("Pipeline:RenderGeomDeferred");
     LL_PROFILE_ZONE_SCOPED_CATEGORY_DRAWPOOL; //LL_RECORD_BLOCK_TIME(FTM_RENDER_GEOMETRY);
     LL_PROFILE_GPU_ZONE("renderGeomDeferred");
+    LL_RECORD_GPU_PASS("renderGeomDeferred");
 
     llassert(!sRenderingHUDs);
 
@@ -3983,6 +4358,9 @@ void LLPipeline::renderGeomDeferred(LLCamera& camera, bool do_occlusion)
 
     setupHWLights();
 
+    // skin rigged meshes once for this pass and everything else drawn from this cull result
+    mGPUSkinning.update();
+
     {
         LL_PROFILE_ZONE_NAMED_CATEGORY_DRAWPOOL("deferred pools");
 
@@ -4091,6 +4469,7 @@ void LLPipeline::renderGeomPostDeferred(LLCamera& camera)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_DRAWPOOL;
     LL_PROFILE_GPU_ZONE("renderGeomPostDeferred");
+    LL_RECORD_GPU_PASS("renderGeomPostDeferred");
 
     if (gUseWireframe)
     {
@@ -4409,7 +4788,12 @@ void LLPipeline::renderDebug()
 
                 if ( pathfindingConsole->getVisible() || gAgentCamera.cameraMouselook() )
                 {
-                    F32 ambiance = gSavedSettings.getF32("PathfindingAmbiance");
+                    static LLCachedControl<F32> ambiance(gSavedSettings, "PathfindingAmbiance");
+                    static LLCachedControl<F32> line_offset(gSavedSettings, "PathfindingLineOffset");
+                    static LLCachedControl<F32> line_width(gSavedSettings, "PathfindingLineWidth");
+                    static LLCachedControl<F32> xray_tint(gSavedSettings, "PathfindingXRayTint");
+                    static LLCachedControl<F32> xray_opacity(gSavedSettings, "PathfindingXRayOpacity");
+                    static LLCachedControl<bool> xray_wireframe(gSavedSettings, "PathfindingXRayWireframe");
 
                     gPathfindingProgram.bind();
 
@@ -4539,18 +4923,18 @@ void LLPipeline::renderDebug()
                                 LLGLEnable lineOffset(GL_POLYGON_OFFSET_LINE);
                                 glPolygonMode( GL_FRONT_AND_BACK, GL_LINE );
 
-                                F32 offset = gSavedSettings.getF32("PathfindingLineOffset");
+                                F32 offset = line_offset;
 
                                 if (pathfindingConsole->isRenderXRay())
                                 {
-                                    gPathfindingProgram.uniform1f(sTint, gSavedSettings.getF32("PathfindingXRayTint"));
-                                    gPathfindingProgram.uniform1f(sAlphaScale, gSavedSettings.getF32("PathfindingXRayOpacity"));
+                                    gPathfindingProgram.uniform1f(sTint, xray_tint);
+                                    gPathfindingProgram.uniform1f(sAlphaScale, xray_opacity);
                                     LLGLEnable blend(GL_BLEND);
                                     LLGLDepthTest depth(GL_TRUE, GL_FALSE, GL_GREATER);
 
                                     glPolygonOffset(offset, -offset);
 
-                                    if (gSavedSettings.getBOOL("PathfindingXRayWireframe"))
+                                    if (xray_wireframe)
                                     { //draw hidden wireframe as darker and less opaque
                                         gPathfindingProgram.uniform1f(sAmbiance, 1.f);
                                         llPathingLibInstance->renderNavMeshShapesVBO( render_order[i] );
@@ -4570,7 +4954,7 @@ void LLPipeline::renderDebug()
                                     gPathfindingProgram.uniform1f(sTint, 1.f);
                                     gPathfindingProgram.uniform1f(sAlphaScale, 1.f);
 
-                                    gGL.setLineWidth(gSavedSettings.getF32("PathfindingLineWidth")); // <FS> Line width OGL core profile fix by Rye Mutt
+                                    gGL.setLineWidth(line_width); // <FS> Line width OGL core profile fix by Rye Mutt
                                     LLGLDisable blendOut(GL_BLEND);
                                     llPathingLibInstance->renderNavMeshShapesVBO( render_order[i] );
                                     gGL.flush();
@@ -4586,12 +4970,10 @@ void LLPipeline::renderDebug()
 
                     if ( pathfindingConsole->isRenderNavMesh() && pathfindingConsole->isRenderXRay() )
                     {   //render navmesh xray
-                        F32 ambiance = gSavedSettings.getF32("PathfindingAmbiance");
-
                         LLGLEnable lineOffset(GL_POLYGON_OFFSET_LINE);
                         LLGLEnable polyOffset(GL_POLYGON_OFFSET_FILL);
 
-                        F32 offset = gSavedSettings.getF32("PathfindingLineOffset");
+                        F32 offset = line_offset;
                         glPolygonOffset(offset, -offset);
 
                         LLGLEnable blend(GL_BLEND);
@@ -4600,10 +4982,10 @@ void LLPipeline::renderDebug()
                         gGL.setLineWidth(2.0f); // <FS> Line width OGL core profile fix by Rye Mutt
                         LLGLEnable cull(GL_CULL_FACE);
 
-                        gPathfindingProgram.uniform1f(sTint, gSavedSettings.getF32("PathfindingXRayTint"));
-                        gPathfindingProgram.uniform1f(sAlphaScale, gSavedSettings.getF32("PathfindingXRayOpacity"));
+                        gPathfindingProgram.uniform1f(sTint, xray_tint);
+                        gPathfindingProgram.uniform1f(sAlphaScale, xray_opacity);
 
-                        if (gSavedSettings.getBOOL("PathfindingXRayWireframe"))
+                        if (xray_wireframe)
                         { //draw hidden wireframe as darker and less opaque
                             glPolygonMode( GL_FRONT_AND_BACK, GL_LINE );
                             gPathfindingProgram.uniform1f(sAmbiance, 1.f);
@@ -4618,8 +5000,8 @@ void LLPipeline::renderDebug()
 
                         //render edges
                         gPathfindingNoNormalsProgram.bind();
-                        gPathfindingNoNormalsProgram.uniform1f(sTint, gSavedSettings.getF32("PathfindingXRayTint"));
-                        gPathfindingNoNormalsProgram.uniform1f(sAlphaScale, gSavedSettings.getF32("PathfindingXRayOpacity"));
+                        gPathfindingNoNormalsProgram.uniform1f(sTint, xray_tint);
+                        gPathfindingNoNormalsProgram.uniform1f(sAlphaScale, xray_opacity);
                         llPathingLibInstance->renderNavMeshEdges();
                         gPathfindingProgram.bind();
 
@@ -6815,6 +7197,7 @@ void LLPipeline::renderAlphaObjects(bool rigged)
                 LLGLSLShader::sCurBoundShaderPtr->setMinimumAlpha(ALPHA_BLEND_CUTOFF);
                 if (lastAvatar != pparams->mAvatar || lastMeshId != pparams->mSkinInfo->mHash)
                 {
+                    LLAvatarGPUTimer::mark(pparams->mAvatar);
                     mSimplePool->uploadMatrixPalette(*pparams);
                     lastAvatar = pparams->mAvatar;
                     lastMeshId = pparams->mSkinInfo->mHash;
@@ -6843,6 +7226,7 @@ void LLPipeline::renderAlphaObjects(bool rigged)
             }
         }
     }
+    LLAvatarGPUTimer::mark(NULL);
 
     gGL.loadMatrix(gGLModelView);
     gGLLastMatrix = NULL;
@@ -6969,6 +7353,7 @@ void LLPipeline::generateLuminance(LLRenderTarget* src, LLRenderTarget* dst)
     // luminance sample and mipmap generation
     {
         LL_PROFILE_GPU_ZONE("luminance sample");
+        LL_RECORD_GPU_PASS("luminance sample");
 
         dst->bindTarget();
 
@@ -7015,6 +7400,7 @@ void LLPipeline::generateExposure(LLRenderTarget* src, LLRenderTarget* dst, bool
     // exposure sample
     {
         LL_PROFILE_GPU_ZONE("exposure sample");
+        LL_RECORD_GPU_PASS("exposure sample");
 
         if (use_history)
         {
@@ -7105,6 +7491,7 @@ void LLPipeline::gammaCorrect(LLRenderTarget* src, LLRenderTarget* dst) {
     // gamma correct lighting
     {
         LL_PROFILE_GPU_ZONE("gamma correct");
+        LL_RECORD_GPU_PASS("gamma correct");
 
         static LLCachedControl<bool> buildNoPost(gSavedSettings, "RenderDisablePostProcessing", false);
 
@@ -7156,6 +7543,7 @@ void LLPipeline::copyScreenSpaceReflections(LLRenderTarget* src, LLRenderTarget*
     if (RenderScreenSpaceReflections && !gCubeSnapshot)
     {
         LL_PROFILE_GPU_ZONE("ssr copy");
+        LL_RECORD_GPU_PASS("ssr copy");
         LLGLDepthTest depth(GL_TRUE, GL_TRUE, GL_ALWAYS);
 
         LLRenderTarget& depth_src = mRT->deferredScreen;
@@ -7182,6 +7570,7 @@ void LLPipeline::generateGlow(LLRenderTarget* src)
     if (sRenderGlow)
     {
         LL_PROFILE_GPU_ZONE("glow");
+        LL_RECORD_GPU_PASS("glow");
         mGlow[2].bindTarget();
         mGlow[2].clear();
 
@@ -7301,6 +7690,7 @@ void LLPipeline::applyFXAA(LLRenderTarget* src, LLRenderTarget* dst)
         if (multisample)
         {
             LL_PROFILE_GPU_ZONE("aa");
+            LL_RECORD_GPU_PASS("aa");
             // bake out texture2D with RGBL for FXAA shader
             mFXAAMap.bindTarget();
 
@@ -7467,6 +7857,7 @@ void LLPipeline::renderDoF(LLRenderTarget* src, LLRenderTarget* dst)
         if (dof_enabled)
         {
             LL_PROFILE_GPU_ZONE("dof");
+            LL_RECORD_GPU_PASS("dof");
             LLGLDisable blend(GL_BLEND);
 
             // depth of field focal plane calculations
@@ -7682,6 +8073,7 @@ void LLPipeline::renderFinalize()
 
     LL_RECORD_BLOCK_TIME(FTM_RENDER_BLOOM);
     LL_PROFILE_GPU_ZONE("renderFinalize");
+    LL_RECORD_GPU_PASS("renderFinalize");
 
     gGL.color4f(1, 1, 1, 1);
     LLGLDepthTest depth(GL_FALSE);
@@ -8113,6 +8505,7 @@ void LLPipeline::renderDeferredLighting()
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_PIPELINE;
     LL_PROFILE_GPU_ZONE("renderDeferredLighting");
+    LL_RECORD_GPU_PASS("renderDeferredLighting");
     if (!sCull)
     {
         return;
@@ -8162,6 +8555,7 @@ void LLPipeline::renderDeferredLighting()
         if (RenderDeferredSSAO || RenderShadowDetail > 0)
         {
             LL_PROFILE_GPU_ZONE("sun program");
+            LL_RECORD_GPU_PASS("sun program");
             deferred_light_target->bindTarget();
             {  // paint shadow/SSAO light map (direct lighting lightmap)
                 LL_PROFILE_ZONE_NAMED_CATEGORY_PIPELINE("renderDeferredLighting - sun shadow");
@@ -8211,6 +8605,7 @@ void LLPipeline::renderDeferredLighting()
             // soften direct lighting lightmap
             LL_PROFILE_ZONE_NAMED_CATEGORY_PIPELINE("renderDeferredLighting - soften shadow");
             LL_PROFILE_GPU_ZONE("soften shadow");
+            LL_RECORD_GPU_PASS("soften shadow");
             // blur lightmap
             screen_target->bindTarget();
             glClearColor(1, 1, 1, 1);
@@ -8279,6 +8674,7 @@ void LLPipeline::renderDeferredLighting()
 
             LL_PROFILE_ZONE_NAMED_CATEGORY_PIPELINE("renderDeferredLighting - atmospherics");
             LL_PROFILE_GPU_ZONE("atmospherics");
+            LL_RECORD_GPU_PASS("atmospherics");
             bindDeferredShader(soften_shader);
 
             static LLCachedControl<F32> ssao_scale(gSavedSettings, "RenderSSAOIrradianceScale", 0.5f);
@@ -8312,9 +8708,11 @@ void LLPipeline::renderDeferredLighting()
         if (local_light_count > 0)
         {
             gGL.setSceneBlendType(LLRender::BT_ADD);
-            std::list<LLVector4>        fullscreen_lights;
-            LLDrawable::drawable_list_t spot_lights;
-            LLDrawable::drawable_list_t fullscreen_spot_lights;
+            // also runs for every reflection probe face, give the lists back each time
+            LLFrameArena::Scope arena_scope;
+            LLFrameVector<LLVector4>    fullscreen_lights;
+            LLFrameVector<LLDrawable*>  spot_lights;
+            LLFrameVector<LLDrawable*>  fullscreen_spot_lights;
 
             if (!gCubeSnapshot)
             {
@@ -8324,13 +8722,14 @@ void LLPipeline::renderDeferredLighting()
                 }
             }
 
-            std::list<LLVector4> light_colors;
+            LLFrameVector<LLVector4> light_colors;
 
             LLVertexBuffer::unbind();
 
             {
                 LL_PROFILE_ZONE_NAMED_CATEGORY_PIPELINE("renderDeferredLighting - local lights");
                 LL_PROFILE_GPU_ZONE("local lights");
+                LL_RECORD_GPU_PASS("local lights");
                 bindDeferredShader(gDeferredLightProgram);
 
                 if (mCubeVB.isNull())
@@ -8340,6 +8739,9 @@ void LLPipeline::renderDeferredLighting()
 
                 mCubeVB->setBuffer();
 
+                // point lights go to one clustered pass when available, spot lights keep their own path
+                bool clustered = LLClusteredLighting::isEnabled();
+
                 LLGLDepthTest depth(GL_TRUE, GL_FALSE);
                 // mNearbyLights already includes distance calculation and excludes muted avatars.
                 // It is calculated from mLights
@@ -8401,6 +8803,18 @@ void LLPipeline::renderDeferredLighting()
 
                     sVisibleLightCount++;
 
+                    if (clustered && !volume->isLightSpotlight())
+                    {
+                        glh::vec3f tc(c);
+                        mat.mult_matrix_vec(tc);
+
+                        if (mClusteredLighting.addLight(LLVector4(tc.v[0], tc.v[1], tc.v[2], s),
+                            LLVector4(col.mV[0], col.mV[1], col.mV[2], volume->getLightFalloff(DEFERRED_LIGHT_FALLOFF))))
+                        {
+                            continue;
+                        }
+                    }
+
                     if (camera->getOrigin().mV[0] > c[0] + s + 0.2f || camera->getOrigin().mV[0] < c[0] - s - 0.2f ||
                         camera->getOrigin().mV[1] > c[1] + s + 0.2f || camera->getOrigin().mV[1] < c[1] - s - 0.2f ||
                         camera->getOrigin().mV[2] > c[2] + s + 0.2f || camera->getOrigin().mV[2] < c[2] - s - 0.2f)
@@ -8443,10 +8857,17 @@ void LLPipeline::renderDeferredLighting()
                 unbindDeferredShader(gDeferredLightProgram);
             }
 
+            if (mClusteredLighting.hasLights())
+            {
+                LL_PROFILE_ZONE_NAMED_CATEGORY_PIPELINE("renderDeferredLighting - clustered lights");
+                mClusteredLighting.render(*camera);
+            }
+
             if (!spot_lights.empty())
             {
                 LL_PROFILE_ZONE_NAMED_CATEGORY_PIPELINE("renderDeferredLighting - projectors");
                 LL_PROFILE_GPU_ZONE("projectors");
+                LL_RECORD_GPU_PASS("projectors");
                 LLGLDepthTest depth(GL_TRUE, GL_FALSE);
                 bindDeferredShader(gDeferredSpotLightProgram);
 
@@ -8454,9 +8875,8 @@ void LLPipeline::renderDeferredLighting()
 
                 gDeferredSpotLightProgram.enableTexture(LLShaderMgr::DEFERRED_PROJECTION);
 
-                for (LLDrawable::drawable_list_t::iterator iter = spot_lights.begin(); iter != spot_lights.end(); ++iter)
+                for (LLDrawable* drawablep : spot_lights)
                 {
-                    LLDrawable *drawablep = *iter;
 
                     LLVOVolume *volume = drawablep->getVOVolume();
 
@@ -8488,6 +8908,7 @@ void LLPipeline::renderDeferredLighting()
                 LL_PROFILE_ZONE_NAMED_CATEGORY_PIPELINE("renderDeferredLighting - fullscreen lights");
                 LLGLDepthTest depth(GL_FALSE);
                 LL_PROFILE_GPU_ZONE("fullscreen lights");
+                LL_RECORD_GPU_PASS("fullscreen lights");
 
                 U32 count = 0;
 
@@ -8497,16 +8918,14 @@ void LLPipeline::renderDeferredLighting()
 
                 F32 far_z = 0.f;
 
-                while (!fullscreen_lights.empty())
+                for (size_t i = 0; i < fullscreen_lights.size(); ++i)
                 {
-                    light[count] = fullscreen_lights.front();
-                    fullscreen_lights.pop_front();
-                    col[count] = light_colors.front();
-                    light_colors.pop_front();
+                    light[count] = fullscreen_lights[i];
+                    col[count] = light_colors[i];
 
                     far_z = llmin(light[count].mV[2] - light[count].mV[3], far_z);
                     count++;
-                    if (count == max_count || fullscreen_lights.empty())
+                    if (count == max_count || i + 1 == fullscreen_lights.size())
                     {
                         U32 idx = count - 1;
                         bindDeferredShader(gDeferredMultiLightProgram[idx]);
@@ -8528,9 +8947,8 @@ void LLPipeline::renderDeferredLighting()
 
                 mScreenTriangleVB->setBuffer();
 
-                for (LLDrawable::drawable_list_t::iterator iter = fullscreen_spot_lights.begin(); iter != fullscreen_spot_lights.end(); ++iter)
+                for (LLDrawable* drawablep : fullscreen_spot_lights)
                 {
-                    LLDrawable* drawablep = *iter;
                     LLVOVolume* volume = drawablep->getVOVolume();
                     LLVector3   center = drawablep->getPositionAgent();
                     F32* c = center.mV;
@@ -8660,6 +9078,7 @@ void LLPipeline::doAtmospherics()
         LLGLSLShader& haze_shader = gHazeProgram;
 
         LL_PROFILE_GPU_ZONE("haze");
+        LL_RECORD_GPU_PASS("haze");
         bindDeferredShader(haze_shader, nullptr, &mWaterDis);
 
         LLEnvironment& environment = LLEnvironment::instance();
@@ -8725,6 +9144,7 @@ void LLPipeline::doWaterHaze()
         LLGLSLShader& haze_shader = gHazeWaterProgram;
 
         LL_PROFILE_GPU_ZONE("haze");
+        LL_RECORD_GPU_PASS("haze");
         bindDeferredShader(haze_shader, nullptr, &mWaterDis);
 
         haze_shader.uniform4fv(LLShaderMgr::WATER_WATERPLANE, 1, LLDrawPoolAlpha::sWaterPlane.mV);
@@ -9183,6 +9603,8 @@ void LLPipeline::renderShadow(glh::matrix4f& view, glh::matrix4f& proj, LLCamera
 
     stateSort(shadow_cam, result);
 
+    mGPUSkinning.update();
+
     //generate shadow map
     gGL.matrixMode(LLRender::MM_PROJECTION);
     gGL.pushMatrix();
@@ -9347,7 +9769,133 @@ void LLPipeline::renderShadow(glh::matrix4f& view, glh::matrix4f& proj, LLCamera
     LLPipeline::sShadowRender = false;
 }
 
-bool LLPipeline::getVisiblePointCloud(LLCamera& camera, LLVector3& min, LLVector3& max, std::vector<LLVector3>& fp, LLVector3 light_dir)
+void LLPipeline::copyShadowDepth(LLRenderTarget& src, LLRenderTarget& dst)
+{
+    LL_PROFILE_GPU_ZONE("copy shadow depth");
+
+    dst.bindTarget();
+
+    LLGLDepthTest depth(GL_TRUE, GL_TRUE, GL_ALWAYS);
+    gGL.setColorMask(false, false);
+
+    gCopyDepthProgram.bind();
+
+    S32 depth_map = gCopyDepthProgram.getTextureChannel(LLShaderMgr::DEFERRED_DEPTH);
+    gGL.getTexUnit(depth_map)->bind(&src, true);
+    // shadow maps may still be set up for shadow samplers
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_NONE);
+
+    mScreenTriangleVB->setBuffer();
+    mScreenTriangleVB->drawArrays(LLRender::TRIANGLES, 0, 3);
+
+    gGL.getTexUnit(depth_map)->unbind(LLTexUnit::TT_TEXTURE);
+    gCopyDepthProgram.unbind();
+
+    dst.flush();
+}
+
+void LLPipeline::markGroupChanged(LLSpatialGroup* group)
+{
+    mReflectionMapManager.markDirty(group);
+
+    static LLCachedControl<bool> shadow_cache(gSavedSettings, "RenderShadowCache", false);
+    if (!shadow_cache || RenderShadowDetail <= 0 || group->getSpatialPartition()->isBridge())
+    { // casters in bridges are redrawn every frame anyway
+        return;
+    }
+
+    const LLVector4a* bounds = group->getBounds();
+    mShadowCasterDirtyBounds.push_back(bounds[0]);
+    mShadowCasterDirtyBounds.push_back(bounds[1]);
+}
+
+static bool shadow_cache_matches(const glh::matrix4f& view, const glh::matrix4f& proj, const LLPipeline::SunShadowCache& cache, F32 threshold)
+{
+    glh::matrix4f a = proj * view;
+    glh::matrix4f b = cache.mProjection * cache.mView;
+
+    for (U32 i = 0; i < 16; ++i)
+    {
+        if (fabsf(a.m[i] - b.m[i]) > threshold)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool LLPipeline::renderCachedSunShadow(U32 index, glh::matrix4f& view, glh::matrix4f& proj, LLCamera& shadow_cam, LLCullResult& result)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_PIPELINE;
+
+    LLRenderTarget& shadow = mRT->shadow[index];
+    SunShadowCache& cache = mSunShadowCache[index];
+
+    if (cache.mDepth.getWidth() != shadow.getWidth() || cache.mDepth.getHeight() != shadow.getHeight())
+    {
+        cache.mValid = false;
+        if (!cache.mDepth.allocate(shadow.getWidth(), shadow.getHeight(), 0, true))
+        {
+            cache.mDepth.release();
+            return false;
+        }
+    }
+
+    if (!cache.mValid)
+    {
+        LL_PROFILE_GPU_ZONE("shadow cache rebuild");
+
+        shadow.bindTarget();
+        shadow.getViewport(gGLViewport);
+        shadow.clear();
+
+        sShadowCachePass = SHADOW_CACHE_STATIC;
+        pushRenderTypeMask();
+        clearRenderTypeMask(LLPipeline::RENDER_TYPE_AVATAR,
+                            LLPipeline::RENDER_TYPE_CONTROL_AV,
+                            END_RENDER_TYPES);
+        renderShadow(view, proj, shadow_cam, result, true);
+        popRenderTypeMask();
+
+        shadow.flush();
+
+        copyShadowDepth(shadow, cache.mDepth);
+
+        cache.mView = view;
+        cache.mProjection = proj;
+        cache.mCamera = shadow_cam;
+        cache.mValid = true;
+
+        add(LLStatViewer::SHADOW_CACHE_REBUILDS, 1);
+    }
+    else
+    {
+        copyShadowDepth(cache.mDepth, shadow);
+    }
+
+    // composite dynamic casters on top of the static depth
+    shadow.bindTarget();
+    shadow.getViewport(gGLViewport);
+
+    sShadowCachePass = SHADOW_CACHE_DYNAMIC;
+    pushRenderTypeMask();
+    clearRenderTypeMask(LLPipeline::RENDER_TYPE_TERRAIN,
+                        LLPipeline::RENDER_TYPE_TREE,
+                        LLPipeline::RENDER_TYPE_GRASS,
+                        LLPipeline::RENDER_TYPE_WATER,
+                        LLPipeline::RENDER_TYPE_VOIDWATER,
+                        END_RENDER_TYPES);
+    renderShadow(view, proj, shadow_cam, result, true);
+    popRenderTypeMask();
+    sShadowCachePass = SHADOW_CACHE_NONE;
+
+    shadow.flush();
+
+    return true;
+}
+
+bool LLPipeline::getVisiblePointCloud(LLCamera& camera, LLVector3& min, LLVector3& max, LLFrameVector<LLVector3>& fp, LLVector3 light_dir)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_PIPELINE;
     //get point cloud of intersection of frust and min, max
@@ -9367,7 +9915,7 @@ bool LLPipeline::getVisiblePointCloud(LLCamera& camera, LLVector3& min, LLVector
         LLPlane(max, LLVector3(0,0,1))};
 
     //potential points
-    std::vector<LLVector3> pp;
+    LLFrameVector<LLVector3> pp;
 
     //add corners of AABB
     pp.push_back(LLVector3(min.mV[0], min.mV[1], min.mV[2]));
@@ -9580,11 +10128,13 @@ void LLPipeline::generateSunShadow(LLCamera& camera)
 {
     if (!sRenderDeferred || RenderShadowDetail <= 0)
     {
+        mShadowCasterDirtyBounds.clear();
         return;
     }
 
     LL_PROFILE_ZONE_SCOPED_CATEGORY_PIPELINE; //LL_RECORD_BLOCK_TIME(FTM_GEN_SUN_SHADOW);
     LL_PROFILE_GPU_ZONE("generateSunShadow");
+    LL_RECORD_GPU_PASS("generateSunShadow");
 
     LLDisableOcclusionCulling no_occlusion;
 
@@ -9726,7 +10276,8 @@ void LLPipeline::generateSunShadow(LLCamera& camera)
     F32 near_clip = 0.f;
     {
         //get visible point cloud
-        std::vector<LLVector3> fp;
+        LLFrameArena::Scope arena_scope;
+        LLFrameVector<LLVector3> fp;
 
         main_camera.calcAgentFrustumPlanes(main_camera.mAgentFrustum);
 
@@ -9810,6 +10361,32 @@ void LLPipeline::generateSunShadow(LLCamera& camera)
     // convenience array of 4 near clip plane distances
     F32 dist[] = { near_clip, mSunClipPlanes.mV[0], mSunClipPlanes.mV[1], mSunClipPlanes.mV[2], mSunClipPlanes.mV[3] };
 
+    static LLCachedControl<bool> shadow_cache(gSavedSettings, "RenderShadowCache", false);
+    static LLCachedControl<F32> shadow_cache_threshold(gSavedSettings, "RenderShadowCacheThreshold", 0.001f);
+    bool use_shadow_cache = shadow_cache && !gCubeSnapshot;
+
+    if (!gCubeSnapshot)
+    { // drop cached cascades that contain a static caster that changed, reflection probe shadows don't use the cache
+        for (U32 j = 0; j < 4; ++j)
+        {
+            SunShadowCache& cache = mSunShadowCache[j];
+            if (!use_shadow_cache || gShiftFrame)
+            {
+                cache.mValid = false;
+            }
+
+            for (U32 i = 0; cache.mValid && i < mShadowCasterDirtyBounds.size(); i += 2)
+            {
+                if (cache.mCamera.AABBInFrustum(mShadowCasterDirtyBounds[i], mShadowCasterDirtyBounds[i + 1]))
+                {
+                    cache.mValid = false;
+                }
+            }
+        }
+
+        mShadowCasterDirtyBounds.clear();
+    }
+
     if (mSunDiffuse == LLColor4::black)
     { //sun diffuse is totally black shadows don't matter
         skipRenderingShadows();
@@ -9825,6 +10402,8 @@ void LLPipeline::generateSunShadow(LLCamera& camera)
 
             LLViewerCamera::sCurCameraID = (LLViewerCamera::eCameraID)(LLViewerCamera::CAMERA_SUN_SHADOW0+j);
 
+            LLFrameArena::Scope arena_scope;
+
             //restore render matrices
             set_current_modelview(saved_view);
             set_current_projection(saved_proj);
@@ -9866,7 +10445,7 @@ void LLPipeline::generateSunShadow(LLCamera& camera)
                 mShadowCamera[j] = shadow_cam;
             }
 
-            std::vector<LLVector3> fp;
+            LLFrameVector<LLVector3> fp;
 
             if (!gPipeline.getVisiblePointCloud(shadow_cam, min, max, fp, lightDir)
                 || j > RenderShadowSplits)
@@ -9896,7 +10475,7 @@ void LLPipeline::generateSunShadow(LLCamera& camera)
             {
                 mShadowExtents[j][0] = min;
                 mShadowExtents[j][1] = max;
-                mShadowFrustPoints[j] = fp;
+                mShadowFrustPoints[j].assign(fp.begin(), fp.end());
             }
 
 
@@ -9906,7 +10485,8 @@ void LLPipeline::generateSunShadow(LLCamera& camera)
             //get a temporary view projection
             view[j] = look(camera.getOrigin(), lightDir, -up);
 
-            std::vector<LLVector3> wpf;
+            LLFrameVector<LLVector3> wpf;
+            wpf.reserve(fp.size());
 
             for (U32 i = 0; i < fp.size(); i++)
             {
@@ -10138,6 +10718,19 @@ void LLPipeline::generateSunShadow(LLCamera& camera)
                 }
             }
 
+            if (use_shadow_cache && mSunShadowCache[j].mValid)
+            {
+                if (shadow_cache_matches(view[j], proj[j], mSunShadowCache[j], shadow_cache_threshold))
+                { // keep rendering with the cached projection so the cached depth still lines up
+                    view[j] = mSunShadowCache[j].mView;
+                    proj[j] = mSunShadowCache[j].mProjection;
+                }
+                else
+                {
+                    mSunShadowCache[j].mValid = false;
+                }
+            }
+
             //shadow_cam.setFar(128.f);
             shadow_cam.setOriginAndLookAt(eye, up, center);
 
@@ -10172,16 +10765,19 @@ void LLPipeline::generateSunShadow(LLCamera& camera)
 
             stop_glerror();
 
-            mRT->shadow[j].bindTarget();
-            mRT->shadow[j].getViewport(gGLViewport);
-            mRT->shadow[j].clear();
-
             {
                 static LLCullResult result[4];
-                renderShadow(view[j], proj[j], shadow_cam, result[j], true);
-            }
+                if (!use_shadow_cache || !renderCachedSunShadow(j, view[j], proj[j], shadow_cam, result[j]))
+                {
+                    mRT->shadow[j].bindTarget();
+                    mRT->shadow[j].getViewport(gGLViewport);
+                    mRT->shadow[j].clear();
+
+                    renderShadow(view[j], proj[j], shadow_cam, result[j], true);
 
-            mRT->shadow[j].flush();
+                    mRT->shadow[j].flush();
+                }
+            }
 
             if (!gPipeline.hasRenderDebugMask(LLPipeline::RENDER_DEBUG_SHADOW_FRUSTA) && !gCubeSnapshot)
             {
@@ -10497,6 +11093,28 @@ void LLPipeline::generateImpostor(LLVOAvatar* avatar, bool preview_avatar, bool
 
     assertInitialized();
 
+    if (!preview_avatar && !for_profile)
+    {
+        if (!mImpostorAtlas.isComplete())
+        {
+            if (!mImpostorAtlas.allocate() || (LLPipeline::sRenderDeferred && !addDeferredAttachments(mImpostorAtlas.getTarget(), true)))
+            {
+                LL_WARNS_ONCE("AvatarRenderPipeline") << "Failed to allocate impostor atlas" << LL_ENDL;
+                mImpostorAtlas.cleanup();
+                return;
+            }
+
+            gGL.getTexUnit(0)->bind(&mImpostorAtlas.getTarget());
+            gGL.getTexUnit(0)->setTextureFilteringOption(LLTexUnit::TFO_POINT);
+            gGL.getTexUnit(0)->unbind(LLTexUnit::TT_TEXTURE);
+        }
+
+        if (!mImpostorAtlas.acquireTile(avatar))
+        {
+            return;
+        }
+    }
+
     // previews can't be muted or impostered
     bool visually_muted = !for_profile && !preview_avatar && avatar->isVisuallyMuted();
     LL_DEBUGS_ONCE("AvatarRenderPipeline") << "Avatar " << avatar->getID()
@@ -10695,30 +11313,13 @@ void LLPipeline::generateImpostor(LLVOAvatar* avatar, bool preview_avatar, bool
         F32 pa = gViewerWindow->getWindowHeightRaw() / (RAD_TO_DEG * viewer_camera->getView());
 
         //get resolution based on angle width and height of impostor (double desired resolution to prevent aliasing)
-        resY = llmin(nhpo2((U32) (fov*pa)), (U32) 512);
-        resX = llmin(nhpo2((U32) (atanf(tdim.mV[0]/distance)*2.f*RAD_TO_DEG*pa)), (U32) 512);
+        //capped at the atlas tile size
+        resY = llmin(nhpo2((U32) (fov*pa)), mImpostorAtlas.getTileHeight());
+        resX = llmin(nhpo2((U32) (atanf(tdim.mV[0]/distance)*2.f*RAD_TO_DEG*pa)), mImpostorAtlas.getTileWidth());
 
         if (!for_profile)
         {
-            if (!avatar->mImpostor.isComplete())
-            {
-                avatar->mImpostor.allocate(resX, resY, GL_RGBA, true);
-
-                if (LLPipeline::sRenderDeferred)
-                {
-                    addDeferredAttachments(avatar->mImpostor, true);
-                }
-
-                gGL.getTexUnit(0)->bind(&avatar->mImpostor);
-                gGL.getTexUnit(0)->setTextureFilteringOption(LLTexUnit::TFO_POINT);
-                gGL.getTexUnit(0)->unbind(LLTexUnit::TT_TEXTURE);
-            }
-            else if (resX != avatar->mImpostor.getWidth() || resY != avatar->mImpostor.getHeight())
-            {
-                avatar->mImpostor.resize(resX, resY);
-            }
-
-            avatar->mImpostor.bindTarget();
+            mImpostorAtlas.bindTile(avatar, resX, resY);
         }
     }
 
@@ -10737,7 +11338,7 @@ void LLPipeline::generateImpostor(LLVOAvatar* avatar, bool preview_avatar, bool
     }
     else
     {
-        avatar->mImpostor.clear();
+        mImpostorAtlas.clearTile(avatar);
         renderGeomDeferred(camera);
 
         renderGeomPostDeferred(camera);
@@ -10837,7 +11438,7 @@ void LLPipeline::generateImpostor(LLVOAvatar* avatar, bool preview_avatar, bool
 
     if (!preview_avatar && !for_profile)
     {
-        avatar->mImpostor.flush();
+        mImpostorAtlas.flush();
         avatar->setImpostorDim(tdim);
     }
 
@@ -29,6 +29,7 @@
 
 #include "llcamera.h"
 #include "llerror.h"
+#include "llframearena.h"
 #include "lldrawpool.h"
 #include "llspatialpartition.h"
 #include "m4math.h"
@@ -40,7 +41,12 @@
 #include "llrendertarget.h"
 #include "llreflectionmapmanager.h"
 #include "llheroprobemanager.h"
+#include "llgpuocclusionculler.h"
+#include "llgpuskinning.h"
+#include "llimpostoratlas.h"
+#include "llclusteredlighting.h"
 
+#include <deque>
 #include <stack>
 
 class LLViewerTexture;
@@ -104,6 +110,15 @@ public:
     void resizeScreenTexture();
     void resizeShadowTexture();
 
+    // Fraction of the window the scene render targets cover, from RenderResolutionMultiplier
+    // and, for the main view, RenderDynamicResolution
+    F32 getResolutionScale(bool dynamic = true) const;
+    // Time the scene on the GPU, see updateDynamicResolution()
+    void beginSceneTimer();
+    void endSceneTimer();
+    // Back to full resolution right away, before a snapshot
+    void resetDynamicResolution();
+
     void releaseGLBuffers();
     void releaseLUTBuffers();
     void releaseScreenBuffers();
@@ -257,7 +272,7 @@ public:
     void updateMove();
     bool visibleObjectsInFrustum(LLCamera& camera);
     bool getVisibleExtents(LLCamera& camera, LLVector3 &min, LLVector3& max);
-    bool getVisiblePointCloud(LLCamera& camera, LLVector3 &min, LLVector3& max, std::vector<LLVector3>& fp, LLVector3 light_dir = LLVector3(0,0,0));
+    bool getVisiblePointCloud(LLCamera& camera, LLVector3 &min, LLVector3& max, LLFrameVector<LLVector3>& fp, LLVector3 light_dir = LLVector3(0,0,0));
 
     // Populate given LLCullResult with results of a frustum cull of the entire scene against the given LLCamera
     void updateCull(LLCamera& camera, LLCullResult& result, bool hud_attachments = false);
@@ -267,7 +282,8 @@ public:
     void updateGeom(F32 max_dtime);
     void updateGL();
     void rebuildPriorityGroups();
-    void rebuildGroups();
+    // rebuild dirty visible groups and mGroupQ1 in order of importance, deferring whatever doesn't fit in max_ms to later frames
+    void rebuildGroups(F32 max_ms);
     void clearRebuildGroups();
     void clearRebuildDrawables();
 
@@ -276,6 +292,7 @@ public:
     static F32 calcPixelArea(const LLVector4a& center, const LLVector4a& size, LLCamera &camera);
 
     void stateSort(LLCamera& camera, LLCullResult& result);
+    void calcStateSortDistances(LLCamera& camera);
     void stateSort(LLSpatialGroup* group, LLCamera& camera);
     void stateSort(LLSpatialBridge* bridge, LLCamera& camera, bool fov_changed = false);
     void stateSort(LLDrawable* drawablep, LLCamera& camera);
@@ -342,6 +359,14 @@ public:
     void renderHighlight(const LLViewerObject* obj, F32 fade);
 
     void renderShadow(glh::matrix4f& view, glh::matrix4f& proj, LLCamera& camera, LLCullResult& result, bool depth_clamp);
+
+    // render sun shadow cascade index into mRT->shadow[index], reusing cached static caster depth when it's still valid
+    // returns false if the cache couldn't be allocated and the cascade must be rendered normally
+    bool renderCachedSunShadow(U32 index, glh::matrix4f& view, glh::matrix4f& proj, LLCamera& camera, LLCullResult& result);
+    void copyShadowDepth(LLRenderTarget& src, LLRenderTarget& dst);
+
+    // note that geometry in group changed so cached sun shadow cascades and reflection probes that contain it are re-rendered
+    void markGroupChanged(LLSpatialGroup* group);
     void renderSelectedFaces(const LLColor4& color);
     void renderHighlights();
     void renderVignette(LLRenderTarget* src, LLRenderTarget* dst);
@@ -466,6 +491,10 @@ public:
 
     LLReflectionMapManager mReflectionMapManager;
     LLHeroProbeManager mHeroProbeManager;
+    LLGPUOcclusionCuller mGPUOcclusionCuller;
+    LLGPUSkinning mGPUSkinning;
+    LLImpostorAtlas mImpostorAtlas;
+    LLClusteredLighting mClusteredLighting;
 
 private:
     void unloadShaders();
@@ -652,6 +681,14 @@ public:
 
     S32                      mNumVisibleFaces;
 
+    // scratch lists for the parallel distance pass in stateSort (see RenderParallelStateSort)
+    std::vector<LLSpatialGroup*> mStateSortGroups;
+    std::vector<LLDrawable*> mStateSortDrawables;
+    bool                     mDistancesPrecomputed = false;
+
+    // scratch list of groups handed to mGPUOcclusionCuller in doOcclusion
+    std::vector<LLSpatialGroup*> mGPUCullGroups;
+
     S32                     mPoissonOffset;
 
     static S32              sCompiles;
@@ -666,6 +703,14 @@ public:
     static bool             sNoAlpha;
     static bool             sUseFarClip;
     static bool             sShadowRender;
+
+    enum eShadowCachePass
+    {
+        SHADOW_CACHE_NONE = 0,  // render every shadow caster
+        SHADOW_CACHE_STATIC,    // render only casters that aren't in a spatial bridge (no avatars, attachments or moving objects)
+        SHADOW_CACHE_DYNAMIC,   // render only casters in spatial bridges and avatars
+    };
+    static U32              sShadowCachePass;
     static bool             sDynamicLOD;
     static bool             sPickAvatar;
     static bool             sReflectionRender;
@@ -774,6 +819,20 @@ public:
     glh::matrix4f           mSunShadowMatrix[6];
     glh::matrix4f           mShadowModelview[6];
     glh::matrix4f           mShadowProjection[6];
+
+    // static caster depth of each sun shadow cascade, see RenderShadowCache
+    struct SunShadowCache
+    {
+        LLRenderTarget mDepth;
+        glh::matrix4f mView;
+        glh::matrix4f mProjection;
+        LLCamera mCamera;   // cull camera the cached depth was rendered with
+        bool mValid = false;
+    };
+    SunShadowCache          mSunShadowCache[4];
+
+    // bounds (center, size) of static shadow casters that changed since the last sun shadow pass
+    std::vector<LLVector4a> mShadowCasterDirtyBounds;
     glh::matrix4f           mReflectionModelView;
 
     LLPointer<LLDrawable>   mShadowSpotLight[2];
@@ -870,9 +929,36 @@ protected:
 
     LLSpatialGroup::sg_vector_t     mGroupSaveQ1; // a place to save mGroupQ1 until it is safe to unref
 
+    struct RebuildEntry
+    {
+        LLSpatialGroup* mGroup;
+        F32 mImportance;
+        bool mFromQ1;
+    };
+    std::vector<RebuildEntry>       mRebuildQueue; // scratch list for rebuildGroups
+
     LLSpatialGroup::sg_vector_t     mMeshDirtyGroup; //groups that need rebuildMesh called
+
+    // last frame's alpha group order in the main view
+    LLAlphaGroupOrder               mAlphaGroupOrder;
+    LLAlphaGroupOrder               mRiggedAlphaGroupOrder;
     U32 mMeshDirtyQueryObject;
 
+    // Lower or raise the scene resolution when its GPU time strays from the target
+    void updateDynamicResolution();
+
+    struct SceneTimer
+    {
+        GLuint mStart;
+        GLuint mEnd;
+    };
+    std::deque<SceneTimer>          mSceneTimers;   // waiting for their results
+    std::vector<GLuint>             mFreeSceneQueries;
+    bool mSceneTimerOpen = false;                   // the last timer has no end yet
+    F32 mDynamicResolutionScale = 1.f;
+    F32 mSceneGPUMs = 0.f;                          // running average, 0 until measured
+    F64 mDynamicResolutionChangeTime = 0.0;
+
     // <FS:ND> A vector is much better suited for the use case of mPartitionQ
     // LLDrawable::drawable_list_t      mPartitionQ; //drawables that need to update their spatial partition radius
     LLDrawable::drawable_vector_t   mPartitionQ; //drawables that need to update their spatial partition radius
@@ -796,6 +796,7 @@ void RlvFloaterConsole::onInput(LLUICtrl* pCtrl, const LLSD& sdParam)
         std::string strExecuted, strFailed, strRetained, *pstr;
 
         boost_tokenizer tokens(strInput, boost::char_separator<char>(",", "", boost::drop_empty_tokens));
+        gRlvHandler.beginCommandBatch();
         for (std::string strCmd : tokens)
         {
             ERlvCmdRet eRet = gRlvHandler.processCommand(gAgent.getID(), strCmd, true);
@@ -820,6 +821,7 @@ void RlvFloaterConsole::onInput(LLUICtrl* pCtrl, const LLSD& sdParam)
                 pstr->append(", ");
             pstr->append(strCmd);
         }
+        gRlvHandler.endCommandBatch();
 
         if (!strExecuted.empty())
             m_pOutputText->appendText("INFO: @" + strExecuted, true);
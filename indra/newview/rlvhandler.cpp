@@ -214,12 +214,49 @@ void RlvHandler::cleanup()
 // Behaviour related functions
 //
 
+const RlvHandler::RlvBehaviourIndex& RlvHandler::getBehaviourIndex(ERlvBehaviour eBhvr) const
+{
+    static const RlvBehaviourIndex s_EmptyIndex;
+    if (eBhvr >= RLV_BHVR_COUNT)
+        return s_EmptyIndex;
+
+    if (m_fBhvrIndexDirty)
+    {
+        m_BhvrIndex.assign(RLV_BHVR_COUNT, RlvBehaviourIndex());
+        for (const auto& objEntry : m_Objects)
+        {
+            const RlvObject* pRlvObj = &objEntry.second;
+            for (const RlvCommand& rlvCmd : pRlvObj->getCommandList())
+            {
+                ERlvBehaviour eCmdBhvr = rlvCmd.getBehaviourType();
+                if (eCmdBhvr >= RLV_BHVR_COUNT)
+                    continue;
+
+                // An object's commands are visited together so it can only be a duplicate of the last entry
+                RlvBehaviourIndex& bhvrIndex = m_BhvrIndex[eCmdBhvr];
+                auto addObject = [pRlvObj](std::vector<const RlvObject*>& objects)
+                {
+                    if ( (objects.empty()) || (objects.back() != pRlvObj) )
+                        objects.push_back(pRlvObj);
+                };
+                addObject(bhvrIndex.m_AnyOption);
+                if (rlvCmd.getOption().empty())
+                {
+                    addObject(bhvrIndex.m_NoOption);
+                    if (rlvCmd.isStrict())
+                        addObject(bhvrIndex.m_StrictNoOption);
+                }
+            }
+        }
+        m_fBhvrIndexDirty = false;
+    }
+    return m_BhvrIndex[eBhvr];
+}
+
 bool RlvHandler::findBehaviour(ERlvBehaviour eBhvr, std::list<const RlvObject*>& lObjects) const
 {
-    lObjects.clear();
-    for (const auto& objEntry : m_Objects)
-        if (objEntry.second.hasBehaviour(eBhvr, false))
-            lObjects.push_back(&objEntry.second);
+    const std::vector<const RlvObject*>& objects = getBehaviourIndex(eBhvr).m_NoOption;
+    lObjects.assign(objects.begin(), objects.end());
     return !lObjects.empty();
 }
 
@@ -233,8 +270,8 @@ bool RlvHandler::hasBehaviour(const LLUUID& idRlvObj, ERlvBehaviour eBhvr, const
 
 bool RlvHandler::hasBehaviourExcept(ERlvBehaviour eBhvr, const std::string& strOption, const LLUUID& idObj) const
 {
-    for (rlv_object_map_t::const_iterator itObj = m_Objects.begin(); itObj != m_Objects.end(); ++itObj)
-        if ( (idObj != itObj->second.getObjectID()) && (itObj->second.hasBehaviour(eBhvr, strOption, false)) )
+    for (const RlvObject* pRlvObj : getBehaviourIndex(eBhvr).m_AnyOption)
+        if ( (idObj != pRlvObj->getObjectID()) && (pRlvObj->hasBehaviour(eBhvr, strOption, false)) )
             return true;
     return false;
 }
@@ -242,25 +279,16 @@ bool RlvHandler::hasBehaviourExcept(ERlvBehaviour eBhvr, const std::string& strO
 // Checked: 2011-04-11 (RLVa-1.3.0h) | Added: RLVa-1.3.0h
 bool RlvHandler::hasBehaviourRoot(const LLUUID& idObjRoot, ERlvBehaviour eBhvr, const std::string& strOption) const
 {
-    for (rlv_object_map_t::const_iterator itObj = m_Objects.begin(); itObj != m_Objects.end(); ++itObj)
-        if ( (idObjRoot == itObj->second.getRootID()) && (itObj->second.hasBehaviour(eBhvr, strOption, false)) )
+    for (const RlvObject* pRlvObj : getBehaviourIndex(eBhvr).m_AnyOption)
+        if ( (idObjRoot == pRlvObj->getRootID()) && (pRlvObj->hasBehaviour(eBhvr, strOption, false)) )
             return true;
     return false;
 }
 
 bool RlvHandler::ownsBehaviour(const LLUUID& idObj, ERlvBehaviour eBhvr) const
 {
-    bool fHasBhvr = false;
-    for (const auto& objEntry : m_Objects)
-    {
-        if (objEntry.second.hasBehaviour(eBhvr, false))
-        {
-            if (objEntry.first != idObj)
-                return false;
-            fHasBhvr = true;
-        }
-    }
-    return fHasBhvr;
+    const std::vector<const RlvObject*>& objects = getBehaviourIndex(eBhvr).m_NoOption;
+    return (1 == objects.size()) && (objects.front()->getObjectID() == idObj);
 }
 
 // ============================================================================
@@ -282,11 +310,9 @@ bool RlvHandler::isException(ERlvBehaviour eBhvr, const RlvExceptionOption& varO
     if (ERlvExceptionCheck::Strict == eCheckType)
     {
         // If we're "strict checking" then we need the UUID of every object that currently has 'eBhvr' restricted
-        for (const auto& objEntry : m_Objects)
-        {
-            if (objEntry.second.hasBehaviour(eBhvr, !hasBehaviour(RLV_BHVR_PERMISSIVE)))
-                objList.push_back(objEntry.first);
-        }
+        const RlvBehaviourIndex& bhvrIndex = getBehaviourIndex(eBhvr);
+        for (const RlvObject* pRlvObj : (!hasBehaviour(RLV_BHVR_PERMISSIVE)) ? bhvrIndex.m_StrictNoOption : bhvrIndex.m_NoOption)
+            objList.push_back(pRlvObj->getObjectID());
     }
 
     for (rlv_exception_map_t::const_iterator itException = m_Exceptions.lower_bound(eBhvr), endException = m_Exceptions.upper_bound(eBhvr); itException != endException; ++itException)
@@ -508,12 +534,14 @@ ERlvCmdRet RlvHandler::processCommand(std::reference_wrapper<const RlvCommand> r
                 {
                     // Add the command to an existing object
                     rlvCmd = itObj->second.addCommand(rlvCmd, fAdded);
+                    dirtyBehaviourIndex();
                 }
                 else
                 {
                     // Create a new RLV object and then add the command to it (and grab its reference)
                     itObj = m_Objects.insert(std::pair<LLUUID, RlvObject>(idCurObj, RlvObject(idCurObj))).first;
                     rlvCmd = itObj->second.addCommand(rlvCmd, fAdded);
+                    dirtyBehaviourIndex();
                 }
 
                 RLV_DEBUGS << "\t- " << ( (fAdded) ? "adding behaviour" : "skipping duplicate" ) << RLV_ENDL;
@@ -531,6 +559,7 @@ ERlvCmdRet RlvHandler::processCommand(std::reference_wrapper<const RlvCommand> r
                             RLV_DEBUGS << "\t- command list empty => removing " << idCurObj << RLV_ENDL;
                             m_Objects.erase(itObj);
                         }
+                        dirtyBehaviourIndex();
                     }
 //                  notifyBehaviourObservers(rlvCmd, !fFromObj);
                 }
@@ -545,6 +574,8 @@ ERlvCmdRet RlvHandler::processCommand(std::reference_wrapper<const RlvCommand> r
                 rlv_object_map_t::iterator itObj = m_Objects.find(idCurObj); bool fRemoved = false;
                 if (itObj != m_Objects.end())
                     fRemoved = itObj->second.removeCommand(rlvCmd);
+                if (fRemoved)
+                    dirtyBehaviourIndex();
 
                 RLV_DEBUGS << "\t- " << ( (fRemoved) ? "removing behaviour"
                                                      : "skipping remove (unset behaviour or unknown object)") << RLV_ENDL;
@@ -558,6 +589,7 @@ ERlvCmdRet RlvHandler::processCommand(std::reference_wrapper<const RlvCommand> r
                         RLV_DEBUGS << "\t- command list empty => removing " << idCurObj << RLV_ENDL;
                         RlvBehaviourDictionary::instance().clearModifiers(idCurObj);
                         m_Objects.erase(itObj);
+                        dirtyBehaviourIndex();
                     }
                 }
                 else
@@ -602,9 +634,47 @@ ERlvCmdRet RlvHandler::processCommand(const LLUUID& idObj, const std::string& st
     return processCommand(std::ref(rlvCmd), fFromObj);
 }
 
+void RlvHandler::beginCommandBatch()
+{
+    if (0 == m_nCommandBatch++)
+        gRlvAttachmentLocks.deferLockedHUDUpdate(true);
+}
+
+void RlvHandler::endCommandBatch()
+{
+    RLV_ASSERT(m_nCommandBatch > 0);
+    if ( (m_nCommandBatch > 0) && (0 == --m_nCommandBatch) )
+    {
+        gRlvAttachmentLocks.deferLockedHUDUpdate(false);
+
+        // Observers could process more commands
+        std::vector<std::pair<ERlvBehaviour, ERlvParamType>> batchedBehaviours;
+        batchedBehaviours.swap(m_BatchedBehaviours);
+        for (const auto& bhvrEntry : batchedBehaviours)
+            m_OnBehaviour(bhvrEntry.first, bhvrEntry.second);
+    }
+}
+
+void RlvHandler::notifyBehaviourObservers(ERlvBehaviour eBhvr, ERlvParamType eType)
+{
+    if (0 == m_nCommandBatch)
+    {
+        m_OnBehaviour(eBhvr, eType);
+        return;
+    }
+
+    // Observers look at the current state when notified so only the last change to a behaviour matters
+    auto itBhvr = std::find_if(m_BatchedBehaviours.begin(), m_BatchedBehaviours.end(), [eBhvr](const auto& bhvrEntry) { return bhvrEntry.first == eBhvr; });
+    if (m_BatchedBehaviours.end() != itBhvr)
+        itBhvr->second = eType;
+    else
+        m_BatchedBehaviours.emplace_back(eBhvr, eType);
+}
+
 // Checked: 2010-02-27 (RLVa-1.2.0a) | Modified: RLVa-1.1.0f
 void RlvHandler::processRetainedCommands(ERlvBehaviour eBhvrFilter /*=RLV_BHVR_UNKNOWN*/, ERlvParamType eTypeFilter /*=RLV_TYPE_UNKNOWN*/)
 {
+    beginCommandBatch();
     rlv_command_list_t::iterator itCmd = m_Retained.begin(), itCurCmd;
     while (itCmd != m_Retained.end())
     {
@@ -618,6 +688,7 @@ void RlvHandler::processRetainedCommands(ERlvBehaviour eBhvrFilter /*=RLV_BHVR_U
             m_Retained.erase(itCurCmd);
         }
     }
+    endCommandBatch();
 }
 
 ERlvCmdRet RlvHandler::processClearCommand(const RlvCommand& rlvCmd)
@@ -628,6 +699,7 @@ ERlvCmdRet RlvHandler::processClearCommand(const RlvCommand& rlvCmd)
     if (itObj != m_Objects.end())   // No sense in clearing if we don't have any commands for this object
     {
         const RlvObject& rlvObj = itObj->second; bool fContinue = true;
+        beginCommandBatch();
         for (rlv_command_list_t::const_iterator itCmd = rlvObj.m_Commands.begin(), itCurCmd;
                 ((fContinue) && (itCmd != rlvObj.m_Commands.end())); )
         {
@@ -640,6 +712,7 @@ ERlvCmdRet RlvHandler::processClearCommand(const RlvCommand& rlvCmd)
                 processCommand(rlvCmd.getObjectID(), strCmdRem.append("=y"), false);
             }
         }
+        endCommandBatch();
     }
 
     // Let our observers know about clear commands
@@ -1734,7 +1807,7 @@ ERlvCmdRet RlvHandler::processAddRemCommand(const RlvCommand& rlvCmd)
             m_Behaviours[eBhvr]--;
         }
 
-        m_OnBehaviour(eBhvr, eType);
+        notifyBehaviourObservers(eBhvr, eType);
         if ( ((RLV_TYPE_ADD == eType) && (1 == m_Behaviours[eBhvr])) || ((RLV_TYPE_REMOVE == eType) && (0 == m_Behaviours[eBhvr])) )
             m_OnBehaviourToggle(eBhvr, eType);
     }
@@ -1769,7 +1842,7 @@ ERlvCmdRet RlvCommandHandlerBaseImpl<RLV_TYPE_ADDREM>::processCommand(const RlvC
             gRlvHandler.m_Behaviours[eBhvr]--;
         }
 
-        gRlvHandler.m_OnBehaviour(eBhvr, rlvCmd.getParamType());
+        gRlvHandler.notifyBehaviourObservers(eBhvr, rlvCmd.getParamType());
         if (fHasBhvr != gRlvHandler.hasBehaviour(eBhvr))
         {
             if (pToggleHandlerFunc)
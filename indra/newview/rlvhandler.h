@@ -127,6 +127,10 @@ public:
     ERlvCmdRet processCommand(const LLUUID& idObj, const std::string& strCommand, bool fFromObj);
     void       processRetainedCommands(ERlvBehaviour eBhvrFilter = RLV_BHVR_UNKNOWN, ERlvParamType eTypeFilter = RLV_TYPE_UNKNOWN);
     bool       processIMQuery(const LLUUID& idSender, const std::string& strCommand);
+    // Commands processed between these (e.g. one comma separated chat line) notify behaviour observers and refresh the
+    // locked HUD state once when the outermost batch ends rather than after every command (calls can be nested)
+    void       beginCommandBatch();
+    void       endCommandBatch();
 
     // Returns a pointer to the currently executing command (do *not* save this pointer)
     const RlvCommand* getCurrentCommand() const { return (!m_CurCommandStack.empty()) ? &m_CurCommandStack.top().get() : nullptr; }
@@ -164,6 +168,7 @@ public:
     void removeCommandHandler(RlvExtCommandHandler* pHandler);
 protected:
     void clearCommandHandlers();
+    void notifyBehaviourObservers(ERlvBehaviour eBhvr, ERlvParamType eType);
     bool notifyCommandHandlers(rlvExtCommandHandler f, const RlvCommand& rlvCmd, ERlvCmdRet& eRet, bool fNotifyAll) const;
 
     // Externally invoked event handlers
@@ -248,6 +253,18 @@ protected:
     rlv_exception_map_t   m_Exceptions;             // Map of currently active restriction exceptions (ERlvBehaviour -> RlvException)
     S16                   m_Behaviours[RLV_BHVR_COUNT];
 
+    // Objects holding each behaviour, so queries don't have to walk every object's command list
+    struct RlvBehaviourIndex
+    {
+        std::vector<const RlvObject*> m_AnyOption;       // Holds the behaviour with any option
+        std::vector<const RlvObject*> m_NoOption;        // Holds the behaviour without an option
+        std::vector<const RlvObject*> m_StrictNoOption;  // Holds the strict version of the behaviour without an option
+    };
+    const RlvBehaviourIndex& getBehaviourIndex(ERlvBehaviour eBhvr) const;
+    void                  dirtyBehaviourIndex() { m_fBhvrIndexDirty = true; }
+    mutable std::vector<RlvBehaviourIndex> m_BhvrIndex;
+    mutable bool          m_fBhvrIndexDirty = true;
+
     rlv_command_list_t    m_Retained;
     RlvGCTimer*           m_pGCTimer;
 
@@ -255,6 +272,8 @@ protected:
     std::stack<LLUUID>    m_CurObjectStack;         // Convenience (see @tpto)
 
     rlv_behaviour_signal_t m_OnBehaviour;
+    S32                    m_nCommandBatch = 0;
+    std::vector<std::pair<ERlvBehaviour, ERlvParamType>> m_BatchedBehaviours; // Behaviour signals held back until the batch ends
     rlv_behaviour_signal_t m_OnBehaviourToggle;
     rlv_command_signal_t   m_OnCommand;
     mutable std::list<RlvExtCommandHandler*> m_CommandHandlers;
@@ -386,6 +386,13 @@ void RlvAttachmentLocks::removeAttachmentPointLock(S32 idxAttachPt, const LLUUID
 // Checked: 2010-08-22 (RLVa-1.2.1a) | Modified: RLVa-1.2.1a
 void RlvAttachmentLocks::updateLockedHUD()
 {
+    if (m_fDeferHUDUpdate)
+    {
+        m_fPendingHUDUpdate = true;
+        return;
+    }
+    m_fPendingHUDUpdate = false;
+
     if (!isAgentAvatarValid())
         return;
 
@@ -408,6 +415,13 @@ void RlvAttachmentLocks::updateLockedHUD()
     }
 }
 
+void RlvAttachmentLocks::deferLockedHUDUpdate(bool fDefer)
+{
+    m_fDeferHUDUpdate = fDefer;
+    if ( (!fDefer) && (m_fPendingHUDUpdate) )
+        updateLockedHUD();
+}
+
 // Checked: 2010-03-11 (RLVa-1.2.0a) | Added: RLVa-1.2.0a
 bool RlvAttachmentLocks::verifyAttachmentLocks()
 {
@@ -91,6 +91,8 @@ public:
 
     // Refreshes locked HUD attachment state
     void updateLockedHUD();
+    // While deferred lock changes only mark the locked HUD state stale, it's refreshed once when deferral ends
+    void deferLockedHUDUpdate(bool fDefer);
     // Iterates over all current attachment and attachment point locks and verifies their status (returns true if verification succeeded)
     bool verifyAttachmentLocks();
 
@@ -129,6 +131,8 @@ private:
     rlv_attachobjlock_map_t m_AttachObjRem;     // Map of attachments that can't be detached (idAttachObj -> idObj)
 
     bool m_fHasLockedHUD;
+    bool m_fDeferHUDUpdate = false;
+    bool m_fPendingHUDUpdate = false;
 };
 
 extern RlvAttachmentLocks gRlvAttachmentLocks;
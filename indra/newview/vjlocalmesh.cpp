@@ -569,12 +569,38 @@ void LLLocalMeshFile::reloadLocalMeshObjects(bool initial_load)
     // if we are here we can assume at least mFilenames[3] is present
     // here we'll define a lambda to call through std::async, accessible through mAsyncFuture.
     // the lamnda returns bool if change happened, individual lod logs, and their status.
-    auto lambda_loadfiles = [&]() mutable -> LLLocalMeshLoaderReply
+    // it only ever fills mPendingObjectList, mLoadedObjectList keeps rendering until
+    // reloadLocalMeshObjectsCallback swaps the new objects in on the main thread.
+    auto lambda_loadfiles = [this]() -> LLLocalMeshLoaderReply
     {
         bool change_happened = false;
         std::vector<std::string> log;
         std::array<bool, 4> lod_success = {false, false, false, false};
 
+        // lower lods are parsed into the objects LOD3 creates, so if any file changed,
+        // every lod is parsed again into a fresh set of objects.
+        bool any_modified = false;
+        for (signed int lod_idx = LOCAL_LOD_HIGH; lod_idx >= LOCAL_LOD_LOWEST; --lod_idx)
+        {
+            if (!mFilenames[lod_idx].empty() && updateLastModified(static_cast<LLLocalMeshFileLOD>(lod_idx)))
+            {
+                any_modified = true;
+            }
+        }
+
+        if (!any_modified)
+        {
+            log.push_back("[ LLLocalMeshFile ] No file was modified, skipping.");
+
+            LLLocalMeshLoaderReply result;
+            result.mChanged = false;
+            result.mLog = log;
+            result.mStatus = mLoadedSuccessfully;
+            return result;
+        }
+
+        mPendingObjectList.clear();
+
         // iterate over every lod
         // we're counting back because LOD3 is most likely to have showstopper problems,
         // so i'd rather not load other lods if LOD3 is found to be broken.
@@ -590,23 +616,8 @@ void LLLocalMeshFile::reloadLocalMeshObjects(bool initial_load)
                 continue;
             }
 
-            // has the file been modified since we last checked?
-            bool file_modified = updateLastModified(current_lod);
-            if (!file_modified)
-            {
-                log.push_back("[ LLLocalMeshFile ] File for LOD " + std::to_string(lod_idx) + " was not modified, skipping.");
-                lod_success[lod_idx] = mLoadedSuccessfully[lod_idx];
-                continue;
-            }
-
             // up until here, skipping loading a lod is fine, after here - it's a sign of an error.
 
-            // clear the old objects, if any.
-            if (lod_idx == LLLocalMeshFileLOD::LOCAL_LOD_HIGH)
-            {
-                mLoadedObjectList.clear();
-            }
-
             log.push_back("[ LLLocalMeshFile ] Attempting to load file for LOD " + std::to_string(lod_idx));
             switch (mExtension)
             {
@@ -646,7 +657,7 @@ void LLLocalMeshFile::reloadLocalMeshObjects(bool initial_load)
 
 
         // just in case, recheck if we actually ended up loading anything
-        auto& object_list = getObjectVector();
+        auto& object_list = getPendingObjectVector();
         if (object_list.empty())
         {
             log.push_back("[ LLLocalMeshFile ] ERROR, no objects loaded, stopping.");
@@ -711,6 +722,8 @@ void LLLocalMeshFile::reloadLocalMeshObjectsCallback()
         mLocalMeshFileStatus = LLLocalMeshFileStatus::STATUS_ACTIVE;
         if (reply.mChanged)
         {
+            // the loader thread is done with the new objects, replace the old ones in one go
+            mLoadedObjectList.swap(mPendingObjectList);
             updateVObjects();
         }
     }
@@ -719,6 +732,8 @@ void LLLocalMeshFile::reloadLocalMeshObjectsCallback()
         mLocalMeshFileStatus = LLLocalMeshFileStatus::STATUS_ERROR;
     }
 
+    // either the old objects after a swap, or a failed load
+    mPendingObjectList.clear();
     mLocalMeshFileNeedsUIUpdate = true;
 }
 
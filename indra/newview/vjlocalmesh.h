@@ -188,6 +188,8 @@ class LLLocalMeshFile
         void reloadLocalMeshObjectsCallback();
         bool updateLastModified(LLLocalMeshFileLOD lod);
         std::vector<std::unique_ptr<LLLocalMeshObject>>& getObjectVector() { return mLoadedObjectList; };
+        // filled by the loader thread, swapped in on the main thread once loading succeeded
+        std::vector<std::unique_ptr<LLLocalMeshObject>>& getPendingObjectVector() { return mPendingObjectList; };
 
         // info getters
         bool notifyNeedsUIUpdate();
@@ -216,6 +218,7 @@ class LLLocalMeshFile
 
         std::future<LLLocalMeshLoaderReply> mAsyncFuture;
         std::vector<std::unique_ptr<LLLocalMeshObject>> mLoadedObjectList;
+        std::vector<std::unique_ptr<LLLocalMeshObject>> mPendingObjectList;
         std::vector<LLUUID> mSavedObjectSculptIDs;
 };
 
@@ -0,0 +1,270 @@
+/**
+ * @file   llbenchmark.cpp
+ * @date   2026-10-15
+ * @brief  Runner and entry point for the benchmark programs, see
+ *         llbenchmark.h.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+#include "llbenchmark.h"
+
+#include "lldate.h"
+#include "llerrorcontrol.h"
+#include "llprocessor.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/*****************************************************************************
+*   Usage:
+*
+*   <program> [--filter=<text>] [--min-time=<seconds>] [--repetitions=<n>]
+*             [--json=<file>]
+*
+*   --filter       only run benchmarks whose name contains <text>
+*   --min-time     time a run has to take before its result is used (0.5)
+*   --repetitions  how many such runs to average (3)
+*   --json         also write the results to <file>, in the JSON format of
+*                  Google Benchmark so its tools can compare two releases
+*****************************************************************************/
+
+namespace
+{
+    struct Benchmark
+    {
+        const char* mName;
+        llbenchmark::function_t mFunction;
+    };
+
+    struct Result
+    {
+        std::string mName;
+        U64 mIterations;
+        F64 mMeanNs;        // per iteration
+        F64 mMinNs;
+        F64 mItemsPerSecond;
+        F64 mBytesPerSecond;
+    };
+
+    // function static, registrars run during static initialization
+    std::vector<Benchmark>& get_benchmarks()
+    {
+        static std::vector<Benchmark> benchmarks;
+        return benchmarks;
+    }
+
+    const U64 MAX_ITERATIONS = 1000000000;
+
+    Result run(const Benchmark& benchmark, F64 min_seconds, U32 repetitions)
+    {
+        // grow the run until it is long enough to time, aiming a bit past
+        // min_seconds with each guess
+        U64 iterations = 1;
+        F64 seconds = 0.0;
+        while (true)
+        {
+            llbenchmark::State state(iterations);
+            benchmark.mFunction(state);
+            seconds = std::chrono::duration<F64>(state.getElapsed()).count();
+            if (seconds >= min_seconds || iterations >= MAX_ITERATIONS)
+            {
+                break;
+            }
+            F64 factor = seconds > 0.0 ? min_seconds * 1.4 / seconds : 10.0;
+            iterations = llclamp((U64)((F64)iterations * llclamp(factor, 2.0, 10.0)), iterations + 1, MAX_ITERATIONS);
+        }
+
+        Result result{ benchmark.mName, iterations, 0.0, 0.0, 0.0, 0.0 };
+        for (U32 i = 0; i < repetitions; ++i)
+        {
+            llbenchmark::State state(iterations);
+            benchmark.mFunction(state);
+            seconds = std::chrono::duration<F64>(state.getElapsed()).count();
+            F64 ns = seconds * 1e9 / (F64)iterations;
+            result.mMeanNs += ns / repetitions;
+            result.mMinNs = i ? llmin(result.mMinNs, ns) : ns;
+            if (seconds > 0.0)
+            {
+                result.mItemsPerSecond += (F64)state.getItemsProcessed() / seconds / repetitions;
+                result.mBytesPerSecond += (F64)state.getBytesProcessed() / seconds / repetitions;
+            }
+        }
+        return result;
+    }
+
+    void print(const Result& result)
+    {
+        std::cout << std::left << std::setw(40) << result.mName << std::right
+                  << std::setw(14) << std::fixed << std::setprecision(1) << result.mMeanNs << " ns"
+                  << std::setw(14) << result.mMinNs << " ns"
+                  << std::setw(12) << result.mIterations;
+        if (result.mItemsPerSecond > 0.0)
+        {
+            std::cout << std::setw(12) << std::setprecision(2) << result.mItemsPerSecond / 1e6 << " M items/s";
+        }
+        if (result.mBytesPerSecond > 0.0)
+        {
+            std::cout << std::setw(12) << std::setprecision(1) << result.mBytesPerSecond / (1024.0 * 1024.0) << " MB/s";
+        }
+        std::cout << std::endl;
+    }
+
+    std::string json_string(const std::string& str)
+    {
+        std::string out("\"");
+        for (char c : str)
+        {
+            if (c == '"' || c == '\\')
+            {
+                out += '\\';
+            }
+            if ((U8)c >= 0x20)
+            {
+                out += c;
+            }
+        }
+        return out + '"';
+    }
+
+    bool write_json(const std::string& filename, const std::string& program, const std::vector<Result>& results)
+    {
+        std::ofstream out(filename.c_str());
+        if (!out.is_open())
+        {
+            return false;
+        }
+
+        out << std::setprecision(6) << std::fixed;
+        out << "{\n  \"context\": {\n"
+            << "    \"date\": " << json_string(LLDate::now().asString()) << ",\n"
+            << "    \"executable\": " << json_string(program) << ",\n"
+            << "    \"cpu_brand\": " << json_string(LLProcessorInfo().getCPUBrandName()) << ",\n"
+#if LL_DEBUG
+            << "    \"library_build_type\": \"debug\"\n"
+#else
+            << "    \"library_build_type\": \"release\"\n"
+#endif
+            << "  },\n  \"benchmarks\": [";
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const Result& result = results[i];
+            out << (i ? ",\n" : "\n")
+                << "    {\n      \"name\": " << json_string(result.mName) << ",\n"
+                << "      \"run_type\": \"aggregate\",\n"
+                << "      \"aggregate_name\": \"mean\",\n"
+                << "      \"iterations\": " << result.mIterations << ",\n"
+                << "      \"real_time\": " << result.mMeanNs << ",\n"
+                << "      \"cpu_time\": " << result.mMeanNs << ",\n"
+                << "      \"min_time\": " << result.mMinNs << ",\n";
+            if (result.mItemsPerSecond > 0.0)
+            {
+                out << "      \"items_per_second\": " << result.mItemsPerSecond << ",\n";
+            }
+            if (result.mBytesPerSecond > 0.0)
+            {
+                out << "      \"bytes_per_second\": " << result.mBytesPerSecond << ",\n";
+            }
+            out << "      \"time_unit\": \"ns\"\n    }";
+        }
+        out << "\n  ]\n}\n";
+        return true;
+    }
+
+    bool get_option(const char* arg, const char* name, std::string& value)
+    {
+        size_t len = strlen(name);
+        if (strncmp(arg, name, len) == 0 && arg[len] == '=')
+        {
+            value = arg + len + 1;
+            return true;
+        }
+        return false;
+    }
+}
+
+llbenchmark::Registrar::Registrar(const char* name, function_t func)
+{
+    get_benchmarks().push_back({ name, func });
+}
+
+int main(int argc, char** argv)
+{
+    std::string filter;
+    std::string json;
+    F64 min_seconds = 0.5;
+    U32 repetitions = 3;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string value;
+        if (get_option(argv[i], "--filter", filter) ||
+            get_option(argv[i], "--json", json))
+        {
+            continue;
+        }
+
+        if (get_option(argv[i], "--min-time", value))
+        {
+            min_seconds = llmax(atof(value.c_str()), 0.001);
+        }
+        else if (get_option(argv[i], "--repetitions", value))
+        {
+            repetitions = llmax(atoi(value.c_str()), 1);
+        }
+        else
+        {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--filter=<text>] [--min-time=<seconds>] [--repetitions=<n>] [--json=<file>]" << std::endl;
+            return 1;
+        }
+    }
+
+    // benchmarks shouldn't spend their time formatting log lines
+    LLError::initForApplication(".", ".", false);
+    LLError::setDefaultLevel(LLError::LEVEL_WARN);
+
+    std::cout << std::left << std::setw(40) << "Benchmark" << std::right
+              << std::setw(17) << "Mean" << std::setw(17) << "Min" << std::setw(12) << "Iterations" << std::endl;
+
+    std::vector<Result> results;
+    for (const Benchmark& benchmark : get_benchmarks())
+    {
+        if (filter.empty() || std::string(benchmark.mName).find(filter) != std::string::npos)
+        {
+            results.push_back(run(benchmark, min_seconds, repetitions));
+            print(results.back());
+        }
+    }
+
+    if (!json.empty() && !write_json(json, argv[0], results))
+    {
+        std::cerr << "Could not write " << json << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,124 @@
+/**
+ * @file   llbenchmark.h
+ * @date   2026-10-15
+ * @brief  Minimal harness for the performance benchmarks of llcommon and
+ *         llmath, in the style of Google Benchmark.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#if ! defined(LL_LLBENCHMARK_H)
+#define LL_LLBENCHMARK_H
+
+#include "stdtypes.h"
+#include <atomic>
+#include <chrono>
+
+/**
+ * A benchmark is a function taking an llbenchmark::State&, registered with
+ * LL_BENCHMARK(). Set up the workload first, then repeat the code to measure
+ * while keepRunning() returns true:
+ *
+ *     static void uuid_hash(llbenchmark::State& state)
+ *     {
+ *         LLUUID id;
+ *         id.generate();
+ *         while (state.keepRunning())
+ *         {
+ *             llbenchmark::doNotOptimize(hash_value(id));
+ *         }
+ *     }
+ *     LL_BENCHMARK(uuid_hash);
+ *
+ * The runner (llbenchmark.cpp) calls each benchmark with more and more
+ * iterations until one run takes long enough to time, then repeats that
+ * run a few times and reports the time per iteration. Benchmarks are only
+ * built with LL_BENCHMARKS and never run as part of the build, the numbers
+ * mean nothing on a loaded build machine.
+ */
+namespace llbenchmark
+{
+    class State
+    {
+    public:
+        State(U64 iterations): mMaxIterations(iterations) {}
+
+        bool keepRunning()
+        {
+            if (mIterations == 0)
+            {
+                mStart = std::chrono::steady_clock::now();
+            }
+            if (mIterations < mMaxIterations)
+            {
+                ++mIterations;
+                return true;
+            }
+            mElapsed += std::chrono::steady_clock::now() - mStart;
+            return false;
+        }
+
+        /// Leave per iteration setup out of the measurement. Costs a clock
+        /// read or two, keep it out of very short loops.
+        void pauseTiming()  { mElapsed += std::chrono::steady_clock::now() - mStart; }
+        void resumeTiming() { mStart = std::chrono::steady_clock::now(); }
+
+        U64 getIterations() const { return mMaxIterations; }
+
+        /// Work done by the whole run, reported as a rate next to the time
+        void setItemsProcessed(U64 items) { mItems = items; }
+        void setBytesProcessed(U64 bytes) { mBytes = bytes; }
+
+        std::chrono::steady_clock::duration getElapsed() const { return mElapsed; }
+        U64 getItemsProcessed() const { return mItems; }
+        U64 getBytesProcessed() const { return mBytes; }
+
+    private:
+        const U64 mMaxIterations;
+        U64 mIterations = 0;
+        U64 mItems = 0;
+        U64 mBytes = 0;
+        std::chrono::steady_clock::time_point mStart;
+        std::chrono::steady_clock::duration mElapsed{ 0 };
+    };
+
+    typedef void (*function_t)(State&);
+
+    struct Registrar
+    {
+        Registrar(const char* name, function_t func);
+    };
+
+    /// Keep the compiler from optimizing away a result that is otherwise
+    /// unused, or from hoisting its computation out of the loop
+    template <typename T>
+    inline void doNotOptimize(const T& value)
+    {
+        static const volatile void* sink;
+        sink = &value;
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+    }
+}
+
+#define LL_BENCHMARK(FUNC) static llbenchmark::Registrar sRegister_##FUNC(#FUNC, FUNC)
+
+#endif /* ! defined(LL_LLBENCHMARK_H) */